@@ -17,6 +17,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -107,6 +108,31 @@ void litert_lm_engine_delete(LiteRtLmEngine* engine);
 // @return A pointer to the created session, or NULL on failure.
 LiteRtLmSession* litert_lm_engine_create_session(LiteRtLmEngine* engine);
 
+// What a streamed response does when its callback falls behind.
+typedef enum {
+  // The decoding waits for the callback.
+  kStreamBackpressureBlock,
+  // The decoding goes on, and the next chunks are merged until the callback
+  // catches up.
+  kStreamBackpressureCoalesce,
+  // The response is cancelled, and its stream ends with an error.
+  kStreamBackpressureCancel,
+} StreamBackpressurePolicy;
+
+// Creates a LiteRT LM Session whose streamed responses are delivered from a
+// thread of their own, through a buffer of at most `max_pending_chunks`
+// chunks, so that a slow callback does not stall the decoding. The caller is
+// responsible for destroying the session using `litert_lm_session_delete`.
+//
+// @param engine The engine to create the session from.
+// @param max_pending_chunks The maximum number of chunks waiting for the
+//   callback, at least 1.
+// @param policy What to do when that many chunks are waiting.
+// @return A pointer to the created session, or NULL on failure.
+LiteRtLmSession* litert_lm_engine_create_session_with_stream_backpressure(
+    LiteRtLmEngine* engine, int max_pending_chunks,
+    StreamBackpressurePolicy policy);
+
 // Destroys a LiteRT LM Session.
 //
 // @param session The session to destroy.
@@ -195,6 +221,72 @@ double litert_lm_benchmark_info_get_prefill_tokens_per_sec_at(
 double litert_lm_benchmark_info_get_decode_tokens_per_sec_at(
     const LiteRtLmBenchmarkInfo* benchmark_info, int index);
 
+// The latencies of the decode steps kept as histograms.
+typedef enum {
+  // The time between two consecutive steps producing text.
+  kLatencyInterToken,
+  // The time of the executor to decode and sample a step.
+  kLatencyExecutorStep,
+  // The time spent in the streaming callback.
+  kLatencyCallback,
+} LatencyMetric;
+
+// Returns a percentile of a decode step latency in seconds, over the decode
+// turns of the session.
+//
+// @param benchmark_info The benchmark info object.
+// @param metric The latency to get the percentile of.
+// @param percentile The percentile in [0, 100], e.g. 99 for the p99.
+// @return The latency in seconds, or 0 if none was recorded.
+double litert_lm_benchmark_info_get_latency_percentile(
+    const LiteRtLmBenchmarkInfo* benchmark_info, LatencyMetric metric,
+    double percentile);
+
+// Returns a percentile of a decode step latency in seconds, over the decode
+// turns of all the sessions of the engine. Requires the benchmark to be
+// enabled in the engine settings.
+//
+// @param engine The engine to get the latency of.
+// @param metric The latency to get the percentile of.
+// @param percentile The percentile in [0, 100], e.g. 99 for the p99.
+// @return The latency in seconds, or a negative value on failure.
+double litert_lm_engine_get_latency_percentile(const LiteRtLmEngine* engine,
+                                               LatencyMetric metric,
+                                               double percentile);
+
+// The counters and gauges of an engine since it was created, maintained
+// whether or not the benchmark is enabled.
+typedef struct {
+  // The number of sessions alive.
+  int num_sessions;
+  // The number of session tasks scheduled and not done yet.
+  int num_queued_tasks;
+  // The number of tokens prefilled, not counting the cached prefixes.
+  int64_t num_prefilled_tokens;
+  // The number of decode steps, each decoding one token per candidate.
+  int64_t num_decode_steps;
+  // The number of turns cancelled.
+  int64_t num_cancellations;
+  // The fraction of the kv-cache in use, or a negative value if the engine
+  // does not page its kv-cache.
+  double kv_cache_utilization;
+  // The lookups of the caches shared by the sessions, 0 when disabled.
+  int64_t prefix_cache_hits;
+  int64_t prefix_cache_misses;
+  int64_t embedding_cache_hits;
+  int64_t embedding_cache_misses;
+  int64_t token_id_cache_hits;
+  int64_t token_id_cache_misses;
+} LiteRtLmEngineMetrics;
+
+// Reads the metrics of the engine, cheap enough to be scraped periodically.
+//
+// @param engine The engine to get the metrics of.
+// @param metrics The metrics to fill.
+// @return 0 on success, non-zero on failure.
+int litert_lm_engine_get_metrics(const LiteRtLmEngine* engine,
+                                 LiteRtLmEngineMetrics* metrics);
+
 // Callback for streaming responses.
 // `callback_data` is a pointer to user-defined data passed to the stream
 // function. `chunk` is the piece of text from the stream. It's only valid for
@@ -206,7 +298,9 @@ typedef void (*LiteRtLmStreamCallback)(void* callback_data, const char* chunk,
 
 // Generates content from the input prompt and streams the response via a
 // callback. This is a non-blocking call that will invoke the callback from a
-// background thread for each chunk.
+// background thread for each chunk. The decoding waits for the callback,
+// unless the session was created with
+// `litert_lm_engine_create_session_with_stream_backpressure`.
 //
 // @param session The session to use for generation.
 // @param inputs An array of InputData structs representing the multimodal
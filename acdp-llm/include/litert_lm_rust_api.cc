@@ -1,13 +1,30 @@
 #include "litert_lm_rust_api.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <cstring>
+#include <cstdlib>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
 
+#include "runtime/components/tokenizer.h"
+#include "runtime/core/completion_queue.h"
+#include "runtime/engine/batch_tokenizer.h"
 #include "runtime/engine/engine.h"
+#include "runtime/engine/engine_creation.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/executor/executor_settings_base.h"
+#include "runtime/executor/llm_executor_settings.h"
 #include "runtime/conversation/conversation.h"
 #include "runtime/conversation/io_types.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 
 using namespace litert::lm;
 
@@ -28,6 +45,386 @@ static int StatusToInt(const absl::Status& status) {
   return LITERT_LM_ERROR;
 }
 
+// Helper to convert the backend enum
+static Backend ToBackend(LiteRtLmBackend backend) {
+  return backend == LITERT_LM_BACKEND_GPU ? Backend::GPU : Backend::CPU;
+}
+
+// Helper to update the advanced settings of the main executor
+template <typename UpdateFn>
+static void UpdateAdvancedSettings(EngineSettings& settings, UpdateFn update) {
+  auto& executor_settings = settings.GetMutableMainExecutorSettings();
+  AdvancedSettings advanced_settings =
+      executor_settings.GetAdvancedSettings().value_or(AdvancedSettings());
+  update(advanced_settings);
+  executor_settings.SetAdvancedSettings(advanced_settings);
+}
+
+// Helper to create the engine settings of a model
+static int CreateEngineSettings(
+    const char* model_path,
+    LiteRtLmBackend backend,
+    std::optional<EngineSettings>& out_settings) {
+  // Create model assets
+  auto model_assets = ModelAssets::Create(model_path);
+  if (!model_assets.ok()) {
+    SetError("Failed to create model assets: " + std::string(model_assets.status().message()));
+    return LITERT_LM_ERROR_MODEL_LOAD_FAILED;
+  }
+
+  // Create engine settings
+  auto engine_settings = EngineSettings::CreateDefault(
+      model_assets.value(),
+      ToBackend(backend));
+
+  if (!engine_settings.ok()) {
+    SetError("Failed to create engine settings: " + std::string(engine_settings.status().message()));
+    return LITERT_LM_ERROR_MODEL_LOAD_FAILED;
+  }
+  out_settings = std::move(engine_settings.value());
+  return LITERT_LM_OK;
+}
+
+// Helper to convert the status of an engine creation to int
+static int CreationStatusToInt(const absl::Status& status) {
+  if (status.ok()) {
+    return LITERT_LM_OK;
+  }
+  return absl::IsCancelled(status) ? LITERT_LM_ERROR_CANCELLED
+                                   : LITERT_LM_ERROR_MODEL_LOAD_FAILED;
+}
+
+// Helper to extract the text of a response message, false if it has none
+static bool GetResponseText(const JsonMessage& message, std::string& text) {
+  if (!message.contains("content")) {
+    return false;
+  }
+  const auto& content = message["content"];
+  if (content.is_string()) {
+    text = content.get<std::string>();
+    return true;
+  }
+  if (!content.is_array()) {
+    return false;
+  }
+  // Concatenate text from all parts
+  for (const auto& part : content) {
+    if (part.contains("type") && part["type"] == "text" &&
+        part.contains("text")) {
+      text += part["text"].get<std::string>();
+    }
+  }
+  return true;
+}
+
+// Storage of the bytes of LiteRtLmBuffers, freed with the last reference
+struct BufferStorage {
+  std::atomic<int> num_refs = 1;
+  std::string bytes;
+};
+
+static void RetainBufferStorage(void* owner) {
+  static_cast<BufferStorage*>(owner)->num_refs.fetch_add(
+      1, std::memory_order_relaxed);
+}
+
+static void ReleaseBufferStorage(void* owner) {
+  auto* storage = static_cast<BufferStorage*>(owner);
+  if (storage->num_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete storage;
+  }
+}
+
+// Helper to hand bytes over to a buffer without copying them
+static LiteRtLmBuffer CreateBuffer(std::string bytes) {
+  if (bytes.empty()) {
+    return LiteRtLmBuffer{};
+  }
+  auto* storage = new BufferStorage();
+  storage->bytes = std::move(bytes);
+  return LiteRtLmBuffer{
+      .data = storage->bytes.data(),
+      .size = storage->bytes.size(),
+      .owner = storage,
+      .retain = RetainBufferStorage,
+      .release = ReleaseBufferStorage,
+  };
+}
+
+// Helper to create an engine from its settings
+static int CreateEngine(
+    EngineSettings engine_settings,
+    LiteRtLmEnginePtr* out_engine) {
+  auto engine = Engine::CreateEngine(std::move(engine_settings));
+  if (!engine.ok()) {
+    SetError("Failed to create engine: " + std::string(engine.status().message()));
+    return LITERT_LM_ERROR_MODEL_LOAD_FAILED;
+  }
+
+  // Transfer ownership to caller
+  *out_engine = engine.value().release();
+  return LITERT_LM_OK;
+}
+
+// Helper to start creating an engine from its settings
+static void StartEngineCreation(
+    EngineSettings engine_settings,
+    LiteRtLmCreationCallback callback,
+    void* user_data,
+    LiteRtLmEngineCreationPtr* out_creation) {
+  EngineCreation::ProgressCallback progress_callback;
+  EngineCreation::DoneCallback done_callback;
+  if (callback) {
+    progress_callback = [callback, user_data](EngineCreationPhase phase) {
+      callback(user_data, static_cast<LiteRtLmCreationPhase>(phase),
+               LITERT_LM_OK);
+    };
+    done_callback = [callback, user_data](const absl::Status& status) {
+      callback(user_data, LITERT_LM_CREATION_PHASE_DONE,
+               CreationStatusToInt(status));
+    };
+  }
+
+  // Start creating the engine
+  auto creation = EngineCreation::Start(
+      std::move(engine_settings), std::move(progress_callback),
+      std::move(done_callback));
+
+  // Transfer ownership to caller
+  *out_creation = creation.release();
+}
+
+// ============================================================================
+// Engine Settings API
+// ============================================================================
+
+int LiteRtLmEngineSettings_Create(
+    const char* model_path,
+    LiteRtLmBackend backend,
+    LiteRtLmEngineSettingsPtr* out_settings) {
+
+  if (!model_path || !out_settings) {
+    SetError("Invalid arguments: model_path or out_settings is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  try {
+    std::optional<EngineSettings> engine_settings;
+    int status = CreateEngineSettings(model_path, backend, engine_settings);
+    if (status != LITERT_LM_OK) {
+      return status;
+    }
+
+    // Transfer ownership to caller
+    *out_settings = new EngineSettings(std::move(engine_settings.value()));
+    return LITERT_LM_OK;
+
+  } catch (const std::exception& e) {
+    SetError(std::string("Exception in LiteRtLmEngineSettings_Create: ") + e.what());
+    return LITERT_LM_ERROR;
+  }
+}
+
+void LiteRtLmEngineSettings_Destroy(LiteRtLmEngineSettingsPtr settings) {
+  if (settings) {
+    delete static_cast<EngineSettings*>(settings);
+  }
+}
+
+void LiteRtLmEngineSettings_SetMaxNumTokens(
+    LiteRtLmEngineSettingsPtr settings,
+    int max_num_tokens) {
+  if (settings) {
+    static_cast<EngineSettings*>(settings)
+        ->GetMutableMainExecutorSettings()
+        .SetMaxNumTokens(max_num_tokens);
+  }
+}
+
+int LiteRtLmEngineSettings_SetPrefillBatchSizes(
+    LiteRtLmEngineSettingsPtr settings,
+    const int32_t* prefill_batch_sizes,
+    int num_prefill_batch_sizes) {
+
+  if (!settings || (!prefill_batch_sizes && num_prefill_batch_sizes > 0) ||
+      num_prefill_batch_sizes < 0) {
+    SetError("Invalid arguments: settings or prefill_batch_sizes is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  std::set<int> batch_sizes;
+  for (int i = 0; i < num_prefill_batch_sizes; ++i) {
+    if (prefill_batch_sizes[i] <= 0) {
+      SetError("Invalid arguments: prefill batch sizes must be positive");
+      return LITERT_LM_ERROR_INVALID_ARGS;
+    }
+    batch_sizes.insert(prefill_batch_sizes[i]);
+  }
+  UpdateAdvancedSettings(
+      *static_cast<EngineSettings*>(settings),
+      [&batch_sizes](AdvancedSettings& advanced_settings) {
+        advanced_settings.prefill_batch_sizes = std::move(batch_sizes);
+      });
+  return LITERT_LM_OK;
+}
+
+int LiteRtLmEngineSettings_SetNumCpuThreads(
+    LiteRtLmEngineSettingsPtr settings,
+    int num_cpu_threads) {
+
+  if (!settings || num_cpu_threads <= 0) {
+    SetError("Invalid arguments: settings is null or num_cpu_threads is not positive");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  auto& executor_settings =
+      static_cast<EngineSettings*>(settings)->GetMutableMainExecutorSettings();
+  auto cpu_config = executor_settings.MutableBackendConfig<CpuConfig>();
+  if (!cpu_config.ok()) {
+    return StatusToInt(cpu_config.status());
+  }
+  cpu_config->number_of_threads = num_cpu_threads;
+  executor_settings.SetBackendConfig(*cpu_config);
+  return LITERT_LM_OK;
+}
+
+int LiteRtLmEngineSettings_SetGpuExternalTensorMode(
+    LiteRtLmEngineSettingsPtr settings,
+    int external_tensor_mode) {
+
+  if (!settings) {
+    SetError("Invalid arguments: settings is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  auto& executor_settings =
+      static_cast<EngineSettings*>(settings)->GetMutableMainExecutorSettings();
+  auto gpu_config = executor_settings.MutableBackendConfig<GpuConfig>();
+  if (!gpu_config.ok()) {
+    return StatusToInt(gpu_config.status());
+  }
+  gpu_config->external_tensor_mode = external_tensor_mode != 0;
+  executor_settings.SetBackendConfig(*gpu_config);
+  return LITERT_LM_OK;
+}
+
+void LiteRtLmEngineSettings_SetCacheDir(
+    LiteRtLmEngineSettingsPtr settings,
+    const char* cache_dir) {
+  if (settings && cache_dir) {
+    static_cast<EngineSettings*>(settings)
+        ->GetMutableMainExecutorSettings()
+        .SetCacheDir(cache_dir);
+  }
+}
+
+void LiteRtLmEngineSettings_SetSamplerBackend(
+    LiteRtLmEngineSettingsPtr settings,
+    LiteRtLmBackend sampler_backend) {
+  if (settings) {
+    static_cast<EngineSettings*>(settings)
+        ->GetMutableMainExecutorSettings()
+        .SetSamplerBackend(ToBackend(sampler_backend));
+  }
+}
+
+void LiteRtLmEngineSettings_SetNumOutputCandidates(
+    LiteRtLmEngineSettingsPtr settings,
+    int num_output_candidates) {
+  if (settings && num_output_candidates > 0) {
+    UpdateAdvancedSettings(
+        *static_cast<EngineSettings*>(settings),
+        [num_output_candidates](AdvancedSettings& advanced_settings) {
+          advanced_settings.num_output_candidates = num_output_candidates;
+        });
+  }
+}
+
+void LiteRtLmEngineSettings_EnableBenchmark(
+    LiteRtLmEngineSettingsPtr settings,
+    int num_prefill_tokens,
+    int num_decode_tokens) {
+  if (settings) {
+    auto& benchmark_params =
+        static_cast<EngineSettings*>(settings)->GetMutableBenchmarkParams();
+    benchmark_params.set_num_prefill_tokens(std::max(num_prefill_tokens, 0));
+    benchmark_params.set_num_decode_tokens(std::max(num_decode_tokens, 0));
+  }
+}
+
+// ============================================================================
+// Session Config API
+// ============================================================================
+
+int LiteRtLmSessionConfig_Create(LiteRtLmSessionConfigPtr* out_config) {
+  if (!out_config) {
+    SetError("Invalid arguments: out_config is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  // Transfer ownership to caller
+  *out_config = new SessionConfig(SessionConfig::CreateDefault());
+  return LITERT_LM_OK;
+}
+
+void LiteRtLmSessionConfig_Destroy(LiteRtLmSessionConfigPtr config) {
+  if (config) {
+    delete static_cast<SessionConfig*>(config);
+  }
+}
+
+void LiteRtLmSessionConfig_SetNumOutputCandidates(
+    LiteRtLmSessionConfigPtr config,
+    int num_output_candidates) {
+  if (config && num_output_candidates > 0) {
+    static_cast<SessionConfig*>(config)->SetNumOutputCandidates(
+        num_output_candidates);
+  }
+}
+
+void LiteRtLmSessionConfig_SetSamplerBackend(
+    LiteRtLmSessionConfigPtr config,
+    LiteRtLmBackend sampler_backend) {
+  if (config) {
+    static_cast<SessionConfig*>(config)->SetSamplerBackend(
+        ToBackend(sampler_backend));
+  }
+}
+
+void LiteRtLmSessionConfig_SetPriority(
+    LiteRtLmSessionConfigPtr config,
+    int priority) {
+  if (config) {
+    static_cast<SessionConfig*>(config)->SetPriority(priority);
+  }
+}
+
+void LiteRtLmSessionConfig_SetStreamBackpressure(
+    LiteRtLmSessionConfigPtr config,
+    int max_pending_chunks,
+    LiteRtLmStreamBackpressure backpressure) {
+  if (!config) {
+    return;
+  }
+  SessionConfig* session_config = static_cast<SessionConfig*>(config);
+  session_config->SetPipelinedCallbacks(true);
+  session_config->SetCallbackQueueCapacity(max_pending_chunks);
+  switch (backpressure) {
+    case LITERT_LM_STREAM_BACKPRESSURE_COALESCE:
+      session_config->SetCallbackBackpressurePolicy(
+          CallbackBackpressurePolicy::kCoalesce);
+      break;
+    case LITERT_LM_STREAM_BACKPRESSURE_CANCEL:
+      session_config->SetCallbackBackpressurePolicy(
+          CallbackBackpressurePolicy::kCancel);
+      break;
+    default:
+      session_config->SetCallbackBackpressurePolicy(
+          CallbackBackpressurePolicy::kBlock);
+      break;
+  }
+}
+
 // ============================================================================
 // Engine API
 // ============================================================================
@@ -43,41 +440,35 @@ int LiteRtLmEngine_Create(
   }
 
   try {
-    // Create model assets
-    auto model_assets = ModelAssets::Create(model_path);
-    if (!model_assets.ok()) {
-      SetError("Failed to create model assets: " + std::string(model_assets.status().message()));
-      return LITERT_LM_ERROR_MODEL_LOAD_FAILED;
+    std::optional<EngineSettings> engine_settings;
+    int status = CreateEngineSettings(model_path, backend, engine_settings);
+    if (status != LITERT_LM_OK) {
+      return status;
     }
 
-    // Determine backend
-    Backend litert_backend = (backend == LITERT_LM_BACKEND_GPU)
-        ? Backend::GPU
-        : Backend::CPU;
+    return CreateEngine(std::move(engine_settings.value()), out_engine);
 
-    // Create engine settings
-    auto engine_settings = EngineSettings::CreateDefault(
-        model_assets.value(),
-        litert_backend);
+  } catch (const std::exception& e) {
+    SetError(std::string("Exception in LiteRtLmEngine_Create: ") + e.what());
+    return LITERT_LM_ERROR;
+  }
+}
 
-    if (!engine_settings.ok()) {
-      SetError("Failed to create engine settings: " + std::string(engine_settings.status().message()));
-      return LITERT_LM_ERROR_MODEL_LOAD_FAILED;
-    }
+int LiteRtLmEngine_CreateWithSettings(
+    LiteRtLmEngineSettingsPtr settings,
+    LiteRtLmEnginePtr* out_engine) {
 
-    // Create engine
-    auto engine = Engine::CreateEngine(engine_settings.value());
-    if (!engine.ok()) {
-      SetError("Failed to create engine: " + std::string(engine.status().message()));
-      return LITERT_LM_ERROR_MODEL_LOAD_FAILED;
-    }
+  if (!settings || !out_engine) {
+    SetError("Invalid arguments: settings or out_engine is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
 
-    // Transfer ownership to caller
-    *out_engine = engine.value().release();
-    return LITERT_LM_OK;
+  try {
+    // The settings are copied to stay reusable.
+    return CreateEngine(*static_cast<EngineSettings*>(settings), out_engine);
 
   } catch (const std::exception& e) {
-    SetError(std::string("Exception in LiteRtLmEngine_Create: ") + e.what());
+    SetError(std::string("Exception in LiteRtLmEngine_CreateWithSettings: ") + e.what());
     return LITERT_LM_ERROR;
   }
 }
@@ -88,6 +479,131 @@ void LiteRtLmEngine_Destroy(LiteRtLmEnginePtr engine) {
   }
 }
 
+int LiteRtLmEngine_GetMetrics(
+    LiteRtLmEnginePtr engine,
+    LiteRtLmMetrics* out_metrics) {
+
+  if (!engine || !out_metrics) {
+    SetError("Invalid arguments: engine or out_metrics is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  auto metrics = static_cast<Engine*>(engine)->GetMetrics();
+  if (!metrics.ok()) {
+    return StatusToInt(metrics.status());
+  }
+
+  *out_metrics = LiteRtLmMetrics{};
+  out_metrics->num_sessions = metrics->num_sessions;
+  out_metrics->num_queued_tasks = metrics->num_queued_tasks;
+  out_metrics->num_prefilled_tokens = metrics->num_prefilled_tokens;
+  out_metrics->num_decode_steps = metrics->num_decode_steps;
+  out_metrics->num_cancellations = metrics->num_cancellations;
+  out_metrics->kv_cache_utilization =
+      metrics->kv_cache_utilization.value_or(-1.0);
+  if (metrics->prefix_cache) {
+    out_metrics->prefix_cache_hits = metrics->prefix_cache->num_hits;
+    out_metrics->prefix_cache_misses = metrics->prefix_cache->num_misses;
+  }
+  if (metrics->embedding_cache) {
+    out_metrics->embedding_cache_hits = metrics->embedding_cache->num_hits;
+    out_metrics->embedding_cache_misses = metrics->embedding_cache->num_misses;
+  }
+  if (metrics->token_id_cache) {
+    out_metrics->token_id_cache_hits = metrics->token_id_cache->num_hits;
+    out_metrics->token_id_cache_misses = metrics->token_id_cache->num_misses;
+  }
+  return LITERT_LM_OK;
+}
+
+// ============================================================================
+// Asynchronous Engine Creation API
+// ============================================================================
+
+int LiteRtLmEngine_CreateAsync(
+    const char* model_path,
+    LiteRtLmBackend backend,
+    LiteRtLmCreationCallback callback,
+    void* user_data,
+    LiteRtLmEngineCreationPtr* out_creation) {
+
+  if (!model_path || !out_creation) {
+    SetError("Invalid arguments: model_path or out_creation is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  try {
+    std::optional<EngineSettings> engine_settings;
+    int status = CreateEngineSettings(model_path, backend, engine_settings);
+    if (status != LITERT_LM_OK) {
+      return status;
+    }
+
+    StartEngineCreation(std::move(engine_settings.value()), callback,
+                        user_data, out_creation);
+    return LITERT_LM_OK;
+
+  } catch (const std::exception& e) {
+    SetError(std::string("Exception in LiteRtLmEngine_CreateAsync: ") + e.what());
+    return LITERT_LM_ERROR;
+  }
+}
+
+int LiteRtLmEngine_CreateAsyncWithSettings(
+    LiteRtLmEngineSettingsPtr settings,
+    LiteRtLmCreationCallback callback,
+    void* user_data,
+    LiteRtLmEngineCreationPtr* out_creation) {
+
+  if (!settings || !out_creation) {
+    SetError("Invalid arguments: settings or out_creation is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  try {
+    // The settings are copied to stay reusable.
+    StartEngineCreation(*static_cast<EngineSettings*>(settings), callback,
+                        user_data, out_creation);
+    return LITERT_LM_OK;
+
+  } catch (const std::exception& e) {
+    SetError(std::string("Exception in LiteRtLmEngine_CreateAsyncWithSettings: ") + e.what());
+    return LITERT_LM_ERROR;
+  }
+}
+
+void LiteRtLmEngineCreation_Cancel(LiteRtLmEngineCreationPtr creation) {
+  if (creation) {
+    static_cast<EngineCreation*>(creation)->Cancel();
+  }
+}
+
+int LiteRtLmEngineCreation_Wait(
+    LiteRtLmEngineCreationPtr creation,
+    LiteRtLmEnginePtr* out_engine) {
+
+  if (!creation || !out_engine) {
+    SetError("Invalid arguments: creation or out_engine is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  auto engine = static_cast<EngineCreation*>(creation)->Wait();
+  if (!engine.ok()) {
+    SetError("Failed to create engine: " + std::string(engine.status().message()));
+    return CreationStatusToInt(engine.status());
+  }
+
+  // Transfer ownership to caller
+  *out_engine = engine.value().release();
+  return LITERT_LM_OK;
+}
+
+void LiteRtLmEngineCreation_Destroy(LiteRtLmEngineCreationPtr creation) {
+  if (creation) {
+    delete static_cast<EngineCreation*>(creation);
+  }
+}
+
 // ============================================================================
 // Conversation API
 // ============================================================================
@@ -104,6 +620,16 @@ int LiteRtLmConversation_CreateWithSystem(
     const char* system_instruction,
     LiteRtLmConversationPtr* out_conversation) {
 
+  return LiteRtLmConversation_CreateWithConfig(
+      engine, nullptr, system_instruction, out_conversation);
+}
+
+int LiteRtLmConversation_CreateWithConfig(
+    LiteRtLmEnginePtr engine,
+    LiteRtLmSessionConfigPtr session_config,
+    const char* system_instruction,
+    LiteRtLmConversationPtr* out_conversation) {
+
   if (!engine || !out_conversation) {
     SetError("Invalid arguments: engine or out_conversation is null");
     return LITERT_LM_ERROR_INVALID_ARGS;
@@ -112,8 +638,11 @@ int LiteRtLmConversation_CreateWithSystem(
   try {
     Engine* eng = static_cast<Engine*>(engine);
 
-    // Create default conversation config
-    auto config = ConversationConfig::CreateDefault(*eng);
+    // Create the conversation config, from the session config if provided
+    auto config = session_config
+        ? ConversationConfig::CreateFromSessionConfig(
+              *eng, *static_cast<SessionConfig*>(session_config))
+        : ConversationConfig::CreateDefault(*eng);
     if (!config.ok()) {
       SetError("Failed to create conversation config: " + std::string(config.status().message()));
       return LITERT_LM_ERROR;
@@ -175,21 +704,10 @@ int LiteRtLmConversation_SendMessage(
       return LITERT_LM_ERROR_GENERATION_FAILED;
     }
 
-    // Extract response text
+    // Extract response text, handling both string and array content formats
     std::string response_text;
-    auto& response_msg = std::get<JsonMessage>(response.value());
-
-    // Handle both string and array content formats
-    if (response_msg["content"].is_string()) {
-      response_text = response_msg["content"].get<std::string>();
-    } else if (response_msg["content"].is_array()) {
-      // Concatenate text from all parts
-      for (const auto& part : response_msg["content"]) {
-        if (part["type"] == "text" && part.contains("text")) {
-          response_text += part["text"].get<std::string>();
-        }
-      }
-    } else {
+    if (!GetResponseText(std::get<JsonMessage>(response.value()),
+                         response_text)) {
       SetError("Invalid response format: content is neither string nor array");
       return LITERT_LM_ERROR_GENERATION_FAILED;
     }
@@ -209,19 +727,676 @@ int LiteRtLmConversation_SendMessage(
   }
 }
 
-void LiteRtLmConversation_Destroy(LiteRtLmConversationPtr conversation) {
-  if (conversation) {
-    delete static_cast<Conversation*>(conversation);
+int LiteRtLmConversation_SendMessageBuffer(
+    LiteRtLmConversationPtr conversation,
+    const char* role,
+    const char* content,
+    LiteRtLmBuffer* out_response) {
+
+  if (!conversation || !role || !content || !out_response) {
+    SetError("Invalid arguments: conversation, role, content, or out_response is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  try {
+    Conversation* conv = static_cast<Conversation*>(conversation);
+
+    // Build message
+    JsonMessage message{
+      {"role", role},
+      {"content", content}
+    };
+
+    // Send message (blocking)
+    auto response = conv->SendMessage(message);
+    if (!response.ok()) {
+      SetError("Failed to send message: " + std::string(response.status().message()));
+      return LITERT_LM_ERROR_GENERATION_FAILED;
+    }
+
+    // Extract response text, handling both string and array content formats
+    std::string response_text;
+    if (!GetResponseText(std::get<JsonMessage>(response.value()),
+                         response_text)) {
+      SetError("Invalid response format: content is neither string nor array");
+      return LITERT_LM_ERROR_GENERATION_FAILED;
+    }
+
+    // Hand the response text over without a copy
+    *out_response = CreateBuffer(std::move(response_text));
+    return LITERT_LM_OK;
+
+  } catch (const std::exception& e) {
+    SetError(std::string("Exception in LiteRtLmConversation_SendMessageBuffer: ") + e.what());
+    return LITERT_LM_ERROR_GENERATION_FAILED;
   }
 }
 
-// ============================================================================
-// Utility Functions
-// ============================================================================
+int LiteRtLmConversation_SendMessageStream(
+    LiteRtLmConversationPtr conversation,
+    const char* role,
+    const char* content,
+    LiteRtLmMessageStreamCallback callback,
+    void* user_data) {
 
-void LiteRtLm_FreeString(char* str) {
-  if (str) {
-    free(str);
+  if (!conversation || !role || !content || !callback) {
+    SetError("Invalid arguments: conversation, role, content, or callback is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  try {
+    Conversation* conv = static_cast<Conversation*>(conversation);
+
+    // Build message
+    JsonMessage message{
+      {"role", role},
+      {"content", content}
+    };
+
+    // Forward the chunks as they are generated. Nothing is forwarded after
+    // the final call, e.g. a second error of the same response.
+    auto status = conv->SendMessageAsync(
+        message,
+        [callback, user_data, is_done = false](
+            absl::StatusOr<Message> chunk) mutable {
+          if (is_done) {
+            return;
+          }
+          if (!chunk.ok()) {
+            is_done = true;
+            const std::string error(chunk.status().message());
+            callback(user_data, nullptr, 1, error.c_str());
+            return;
+          }
+          const auto& chunk_msg = std::get<JsonMessage>(chunk.value());
+          // An empty message ends the response.
+          if (chunk_msg.is_null()) {
+            is_done = true;
+            callback(user_data, nullptr, 1, nullptr);
+            return;
+          }
+          // The chunks of tool calls have no text.
+          std::string chunk_text;
+          if (GetResponseText(chunk_msg, chunk_text) && !chunk_text.empty()) {
+            callback(user_data, chunk_text.c_str(), 0, nullptr);
+          }
+        });
+    if (!status.ok()) {
+      SetError("Failed to send message: " + std::string(status.message()));
+      return LITERT_LM_ERROR_GENERATION_FAILED;
+    }
+
+    return LITERT_LM_OK;
+
+  } catch (const std::exception& e) {
+    SetError(std::string("Exception in LiteRtLmConversation_SendMessageStream: ") + e.what());
+    return LITERT_LM_ERROR_GENERATION_FAILED;
+  }
+}
+
+// Helper to create the callback pushing the chunks of a response to a
+// completion queue
+static absl::AnyInvocable<void(absl::StatusOr<Message>)>
+CreateCompletionCallback(CompletionQueue* completion_queue, uint64_t tag) {
+  // Push the chunks as they are generated. Nothing is pushed after the
+  // final completion, e.g. a second error of the same response.
+  return [completion_queue, tag, is_done = false](
+             absl::StatusOr<Message> chunk) mutable {
+    if (is_done) {
+      return;
+    }
+    if (!chunk.ok()) {
+      is_done = true;
+      completion_queue->Push(
+          {.tag = tag, .is_final = true, .status = chunk.status()});
+      return;
+    }
+    const auto& chunk_msg = std::get<JsonMessage>(chunk.value());
+    // An empty message ends the response.
+    if (chunk_msg.is_null()) {
+      is_done = true;
+      completion_queue->Push({.tag = tag, .is_final = true});
+      return;
+    }
+    // The chunks of tool calls have no text.
+    std::string chunk_text;
+    if (GetResponseText(chunk_msg, chunk_text) && !chunk_text.empty()) {
+      completion_queue->Push({.tag = tag, .text = std::move(chunk_text)});
+    }
+  };
+}
+
+// Helper to send a message whose response is pushed to a completion queue
+static int SubmitMessage(
+    Conversation* conv,
+    const char* role,
+    const char* content,
+    CompletionQueue* completion_queue,
+    uint64_t tag) {
+  // Build message
+  JsonMessage message{
+    {"role", role},
+    {"content", content}
+  };
+
+  auto status = conv->SendMessageAsync(
+      message, CreateCompletionCallback(completion_queue, tag));
+  if (!status.ok()) {
+    SetError("Failed to send message: " + std::string(status.message()));
+    return LITERT_LM_ERROR_GENERATION_FAILED;
+  }
+
+  return LITERT_LM_OK;
+}
+
+int LiteRtLmConversation_SubmitMessage(
+    LiteRtLmConversationPtr conversation,
+    const char* role,
+    const char* content,
+    LiteRtLmCompletionQueuePtr queue,
+    uint64_t tag) {
+
+  if (!conversation || !role || !content || !queue) {
+    SetError("Invalid arguments: conversation, role, content, or queue is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  try {
+    return SubmitMessage(static_cast<Conversation*>(conversation), role,
+                         content, static_cast<CompletionQueue*>(queue), tag);
+
+  } catch (const std::exception& e) {
+    SetError(std::string("Exception in LiteRtLmConversation_SubmitMessage: ") + e.what());
+    return LITERT_LM_ERROR_GENERATION_FAILED;
+  }
+}
+
+int LiteRtLmConversation_SubmitMessages(
+    const LiteRtLmSubmission* submissions,
+    int num_submissions,
+    LiteRtLmCompletionQueuePtr queue,
+    int* out_statuses) {
+
+  if ((!submissions && num_submissions > 0) || num_submissions < 0 ||
+      !queue) {
+    SetError("Invalid arguments: submissions or queue is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  CompletionQueue* completion_queue = static_cast<CompletionQueue*>(queue);
+  int first_error = LITERT_LM_OK;
+  for (int i = 0; i < num_submissions; ++i) {
+    const LiteRtLmSubmission& submission = submissions[i];
+    int status;
+    if (!submission.conversation || !submission.role || !submission.content) {
+      SetError("Invalid arguments: conversation, role, or content is null");
+      status = LITERT_LM_ERROR_INVALID_ARGS;
+    } else {
+      try {
+        status = SubmitMessage(
+            static_cast<Conversation*>(submission.conversation),
+            submission.role, submission.content, completion_queue,
+            submission.tag);
+      } catch (const std::exception& e) {
+        SetError(std::string("Exception in LiteRtLmConversation_SubmitMessages: ") + e.what());
+        status = LITERT_LM_ERROR_GENERATION_FAILED;
+      }
+    }
+    if (out_statuses) {
+      out_statuses[i] = status;
+    }
+    if (first_error == LITERT_LM_OK) {
+      first_error = status;
+    }
+  }
+  return first_error;
+}
+
+// Helper to copy token ids to an array allocated for the caller
+static int32_t* CopyTokenIds(const std::vector<int>& token_ids) {
+  if (token_ids.empty()) {
+    return nullptr;
+  }
+  int32_t* copy =
+      static_cast<int32_t*>(malloc(token_ids.size() * sizeof(int32_t)));
+  if (copy) {
+    std::copy(token_ids.begin(), token_ids.end(), copy);
+  }
+  return copy;
+}
+
+// Helper to copy token ids passed by the caller
+static bool GetTokenIds(const int32_t* token_ids, int num_tokens,
+                        std::vector<int>& ids) {
+  if (!token_ids || num_tokens <= 0) {
+    return false;
+  }
+  ids.assign(token_ids, token_ids + num_tokens);
+  return true;
+}
+
+int LiteRtLmConversation_TokenizeMessage(
+    LiteRtLmConversationPtr conversation,
+    const char* role,
+    const char* content,
+    int32_t** out_token_ids,
+    int* out_num_tokens) {
+
+  if (!conversation || !role || !content || !out_token_ids ||
+      !out_num_tokens) {
+    SetError("Invalid arguments: conversation, role, content, out_token_ids, or out_num_tokens is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  try {
+    Conversation* conv = static_cast<Conversation*>(conversation);
+
+    // Build message
+    JsonMessage message{
+      {"role", role},
+      {"content", content}
+    };
+
+    auto token_ids = conv->TokenizeMessage(message);
+    if (!token_ids.ok()) {
+      SetError("Failed to tokenize message: " + std::string(token_ids.status().message()));
+      return StatusToInt(token_ids.status());
+    }
+
+    *out_token_ids = CopyTokenIds(*token_ids);
+    if (!*out_token_ids && !token_ids->empty()) {
+      SetError("Failed to allocate token ids");
+      return LITERT_LM_ERROR;
+    }
+    *out_num_tokens = static_cast<int>(token_ids->size());
+    return LITERT_LM_OK;
+
+  } catch (const std::exception& e) {
+    SetError(std::string("Exception in LiteRtLmConversation_TokenizeMessage: ") + e.what());
+    return LITERT_LM_ERROR;
+  }
+}
+
+int LiteRtLmConversation_SendTokenizedMessage(
+    LiteRtLmConversationPtr conversation,
+    const char* role,
+    const char* content,
+    const int32_t* token_ids,
+    int num_tokens,
+    char** out_response) {
+
+  std::vector<int> ids;
+  if (!conversation || !role || !content || !out_response ||
+      !GetTokenIds(token_ids, num_tokens, ids)) {
+    SetError("Invalid arguments: conversation, role, content, token_ids, or out_response is null or empty");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  try {
+    Conversation* conv = static_cast<Conversation*>(conversation);
+
+    // Build message
+    JsonMessage message{
+      {"role", role},
+      {"content", content}
+    };
+
+    // Send message (blocking)
+    auto response = conv->SendTokenizedMessage(message, std::move(ids));
+    if (!response.ok()) {
+      SetError("Failed to send message: " + std::string(response.status().message()));
+      return LITERT_LM_ERROR_GENERATION_FAILED;
+    }
+
+    // Extract response text, handling both string and array content formats
+    std::string response_text;
+    if (!GetResponseText(std::get<JsonMessage>(response.value()),
+                         response_text)) {
+      SetError("Invalid response format: content is neither string nor array");
+      return LITERT_LM_ERROR_GENERATION_FAILED;
+    }
+
+    // Allocate and copy response string
+    *out_response = strdup(response_text.c_str());
+    if (!*out_response) {
+      SetError("Failed to allocate memory for response");
+      return LITERT_LM_ERROR;
+    }
+
+    return LITERT_LM_OK;
+
+  } catch (const std::exception& e) {
+    SetError(std::string("Exception in LiteRtLmConversation_SendTokenizedMessage: ") + e.what());
+    return LITERT_LM_ERROR_GENERATION_FAILED;
+  }
+}
+
+int LiteRtLmConversation_SubmitTokenizedMessage(
+    LiteRtLmConversationPtr conversation,
+    const char* role,
+    const char* content,
+    const int32_t* token_ids,
+    int num_tokens,
+    LiteRtLmCompletionQueuePtr queue,
+    uint64_t tag) {
+
+  std::vector<int> ids;
+  if (!conversation || !role || !content || !queue ||
+      !GetTokenIds(token_ids, num_tokens, ids)) {
+    SetError("Invalid arguments: conversation, role, content, token_ids, or queue is null or empty");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  try {
+    Conversation* conv = static_cast<Conversation*>(conversation);
+
+    // Build message
+    JsonMessage message{
+      {"role", role},
+      {"content", content}
+    };
+
+    auto status = conv->SendTokenizedMessageAsync(
+        message, std::move(ids),
+        CreateCompletionCallback(static_cast<CompletionQueue*>(queue), tag));
+    if (!status.ok()) {
+      SetError("Failed to send message: " + std::string(status.message()));
+      return LITERT_LM_ERROR_GENERATION_FAILED;
+    }
+
+    return LITERT_LM_OK;
+
+  } catch (const std::exception& e) {
+    SetError(std::string("Exception in LiteRtLmConversation_SubmitTokenizedMessage: ") + e.what());
+    return LITERT_LM_ERROR_GENERATION_FAILED;
+  }
+}
+
+void LiteRtLmConversation_Cancel(LiteRtLmConversationPtr conversation) {
+  if (conversation) {
+    static_cast<Conversation*>(conversation)->CancelProcess();
+  }
+}
+
+void LiteRtLmConversation_Destroy(LiteRtLmConversationPtr conversation) {
+  if (conversation) {
+    delete static_cast<Conversation*>(conversation);
+  }
+}
+
+// ============================================================================
+// Completion Queue API
+// ============================================================================
+
+int LiteRtLmCompletionQueue_Create(LiteRtLmCompletionQueuePtr* out_queue) {
+  if (!out_queue) {
+    SetError("Invalid arguments: out_queue is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  auto queue = CompletionQueue::Create();
+  if (!queue.ok()) {
+    return StatusToInt(queue.status());
+  }
+
+  // Transfer ownership to caller
+  *out_queue = queue.value().release();
+  return LITERT_LM_OK;
+}
+
+int LiteRtLmCompletionQueue_GetFd(LiteRtLmCompletionQueuePtr queue) {
+  if (!queue) {
+    SetError("Invalid arguments: queue is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+  return static_cast<CompletionQueue*>(queue)->GetFd();
+}
+
+int LiteRtLmCompletionQueue_Poll(
+    LiteRtLmCompletionQueuePtr queue,
+    LiteRtLmCompletion* out_completions,
+    int max_completions) {
+
+  if (!queue || !out_completions || max_completions <= 0) {
+    SetError("Invalid arguments: queue or out_completions is null, or max_completions is not positive");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  std::vector<Completion> completions;
+  static_cast<CompletionQueue*>(queue)->Poll(completions, max_completions);
+  for (size_t i = 0; i < completions.size(); ++i) {
+    Completion& completion = completions[i];
+    LiteRtLmCompletion& out = out_completions[i];
+    out = LiteRtLmCompletion{};
+    out.tag = completion.tag;
+    out.is_final = completion.is_final;
+    // The text generated by the engine is handed over without a copy.
+    out.chunk = CreateBuffer(std::move(completion.text));
+    if (completion.status.ok()) {
+      out.status = LITERT_LM_OK;
+    } else {
+      out.status = absl::IsCancelled(completion.status)
+                       ? LITERT_LM_ERROR_CANCELLED
+                       : LITERT_LM_ERROR_GENERATION_FAILED;
+      out.error_message =
+          strdup(std::string(completion.status.message()).c_str());
+    }
+  }
+  return static_cast<int>(completions.size());
+}
+
+void LiteRtLmCompletionQueue_Destroy(LiteRtLmCompletionQueuePtr queue) {
+  if (queue) {
+    delete static_cast<CompletionQueue*>(queue);
+  }
+}
+
+// ============================================================================
+// Tokenizer API
+// ============================================================================
+
+// Helper to view the texts of a batch
+static bool GetTexts(const char* const* texts, int num_texts,
+                     std::vector<absl::string_view>& views) {
+  if ((!texts && num_texts > 0) || num_texts < 0) {
+    return false;
+  }
+  views.reserve(num_texts);
+  for (int i = 0; i < num_texts; ++i) {
+    if (!texts[i]) {
+      return false;
+    }
+    views.emplace_back(texts[i]);
+  }
+  return true;
+}
+
+int LiteRtLmEngine_TextToTokenIds(
+    LiteRtLmEnginePtr engine,
+    const char* text,
+    int32_t** out_token_ids,
+    int* out_num_tokens) {
+
+  if (!engine || !text || !out_token_ids || !out_num_tokens) {
+    SetError("Invalid arguments: engine, text, out_token_ids, or out_num_tokens is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  try {
+    auto tokenizer = static_cast<Engine*>(engine)->GetTokenizer();
+    if (!tokenizer.ok()) {
+      return StatusToInt(tokenizer.status());
+    }
+    auto token_ids = (*tokenizer)->TextToTokenIds(text);
+    if (!token_ids.ok()) {
+      return StatusToInt(token_ids.status());
+    }
+
+    *out_token_ids = CopyTokenIds(*token_ids);
+    if (!*out_token_ids && !token_ids->empty()) {
+      SetError("Failed to allocate token ids");
+      return LITERT_LM_ERROR;
+    }
+    *out_num_tokens = static_cast<int>(token_ids->size());
+    return LITERT_LM_OK;
+
+  } catch (const std::exception& e) {
+    SetError(std::string("Exception in LiteRtLmEngine_TextToTokenIds: ") + e.what());
+    return LITERT_LM_ERROR;
+  }
+}
+
+int LiteRtLmEngine_CountTokens(
+    LiteRtLmEnginePtr engine,
+    const char* text,
+    int* out_num_tokens) {
+
+  if (!engine || !text || !out_num_tokens) {
+    SetError("Invalid arguments: engine, text, or out_num_tokens is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  try {
+    auto tokenizer = static_cast<Engine*>(engine)->GetTokenizer();
+    if (!tokenizer.ok()) {
+      return StatusToInt(tokenizer.status());
+    }
+    auto token_ids = (*tokenizer)->TextToTokenIds(text);
+    if (!token_ids.ok()) {
+      return StatusToInt(token_ids.status());
+    }
+
+    *out_num_tokens = static_cast<int>(token_ids->size());
+    return LITERT_LM_OK;
+
+  } catch (const std::exception& e) {
+    SetError(std::string("Exception in LiteRtLmEngine_CountTokens: ") + e.what());
+    return LITERT_LM_ERROR;
+  }
+}
+
+int LiteRtLmTokenizer_Create(
+    LiteRtLmEnginePtr engine,
+    int num_threads,
+    LiteRtLmTokenizerPtr* out_tokenizer) {
+
+  if (!engine || !out_tokenizer) {
+    SetError("Invalid arguments: engine or out_tokenizer is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  try {
+    auto tokenizer = static_cast<Engine*>(engine)->GetTokenizer();
+    if (!tokenizer.ok()) {
+      return StatusToInt(tokenizer.status());
+    }
+    auto batch_tokenizer = BatchTokenizer::Create(**tokenizer, num_threads);
+    if (!batch_tokenizer.ok()) {
+      return StatusToInt(batch_tokenizer.status());
+    }
+
+    // Transfer ownership to caller
+    *out_tokenizer = batch_tokenizer->release();
+    return LITERT_LM_OK;
+
+  } catch (const std::exception& e) {
+    SetError(std::string("Exception in LiteRtLmTokenizer_Create: ") + e.what());
+    return LITERT_LM_ERROR;
+  }
+}
+
+int LiteRtLmTokenizer_TextToTokenIds(
+    LiteRtLmTokenizerPtr tokenizer,
+    const char* const* texts,
+    int num_texts,
+    int32_t** out_token_ids,
+    int64_t* out_offsets) {
+
+  std::vector<absl::string_view> views;
+  if (!tokenizer || !out_token_ids || !out_offsets ||
+      !GetTexts(texts, num_texts, views)) {
+    SetError("Invalid arguments: tokenizer, texts, out_token_ids, or out_offsets is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  try {
+    auto token_ids =
+        static_cast<BatchTokenizer*>(tokenizer)->TextToTokenIds(views);
+    if (!token_ids.ok()) {
+      return StatusToInt(token_ids.status());
+    }
+
+    // Concatenate the token ids of the texts
+    out_offsets[0] = 0;
+    for (int i = 0; i < num_texts; ++i) {
+      out_offsets[i + 1] = out_offsets[i] + (*token_ids)[i].size();
+    }
+    std::vector<int> all_token_ids;
+    all_token_ids.reserve(out_offsets[num_texts]);
+    for (const std::vector<int>& ids : *token_ids) {
+      all_token_ids.insert(all_token_ids.end(), ids.begin(), ids.end());
+    }
+    *out_token_ids = CopyTokenIds(all_token_ids);
+    if (!*out_token_ids && !all_token_ids.empty()) {
+      SetError("Failed to allocate token ids");
+      return LITERT_LM_ERROR;
+    }
+    return LITERT_LM_OK;
+
+  } catch (const std::exception& e) {
+    SetError(std::string("Exception in LiteRtLmTokenizer_TextToTokenIds: ") + e.what());
+    return LITERT_LM_ERROR;
+  }
+}
+
+int LiteRtLmTokenizer_CountTokens(
+    LiteRtLmTokenizerPtr tokenizer,
+    const char* const* texts,
+    int num_texts,
+    int32_t* out_num_tokens) {
+
+  std::vector<absl::string_view> views;
+  if (!tokenizer || (!out_num_tokens && num_texts > 0) ||
+      !GetTexts(texts, num_texts, views)) {
+    SetError("Invalid arguments: tokenizer, texts, or out_num_tokens is null");
+    return LITERT_LM_ERROR_INVALID_ARGS;
+  }
+
+  try {
+    auto num_tokens =
+        static_cast<BatchTokenizer*>(tokenizer)->CountTokens(views);
+    if (!num_tokens.ok()) {
+      return StatusToInt(num_tokens.status());
+    }
+
+    std::copy(num_tokens->begin(), num_tokens->end(), out_num_tokens);
+    return LITERT_LM_OK;
+
+  } catch (const std::exception& e) {
+    SetError(std::string("Exception in LiteRtLmTokenizer_CountTokens: ") + e.what());
+    return LITERT_LM_ERROR;
+  }
+}
+
+void LiteRtLmTokenizer_Destroy(LiteRtLmTokenizerPtr tokenizer) {
+  if (tokenizer) {
+    delete static_cast<BatchTokenizer*>(tokenizer);
+  }
+}
+
+// ============================================================================
+// Utility Functions
+// ============================================================================
+
+void LiteRtLm_FreeString(char* str) {
+  if (str) {
+    free(str);
+  }
+}
+
+void LiteRtLm_FreeTokenIds(int32_t* token_ids) {
+  if (token_ids) {
+    free(token_ids);
   }
 }
 
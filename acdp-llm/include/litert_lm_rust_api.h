@@ -1,6 +1,9 @@
 #ifndef LITERT_LM_RUST_API_H_
 #define LITERT_LM_RUST_API_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -8,6 +11,11 @@ extern "C" {
 // Opaque pointers for C API
 typedef void* LiteRtLmEnginePtr;
 typedef void* LiteRtLmConversationPtr;
+typedef void* LiteRtLmEngineCreationPtr;
+typedef void* LiteRtLmCompletionQueuePtr;
+typedef void* LiteRtLmEngineSettingsPtr;
+typedef void* LiteRtLmSessionConfigPtr;
+typedef void* LiteRtLmTokenizerPtr;
 
 // Backend types
 typedef enum {
@@ -15,6 +23,13 @@ typedef enum {
   LITERT_LM_BACKEND_GPU = 1,
 } LiteRtLmBackend;
 
+// What a streamed response does when its callback falls behind
+typedef enum {
+  LITERT_LM_STREAM_BACKPRESSURE_BLOCK = 0,
+  LITERT_LM_STREAM_BACKPRESSURE_COALESCE = 1,
+  LITERT_LM_STREAM_BACKPRESSURE_CANCEL = 2,
+} LiteRtLmStreamBackpressure;
+
 // Status codes
 typedef enum {
   LITERT_LM_OK = 0,
@@ -23,8 +38,174 @@ typedef enum {
   LITERT_LM_ERROR_NOT_INITIALIZED = -3,
   LITERT_LM_ERROR_MODEL_LOAD_FAILED = -4,
   LITERT_LM_ERROR_GENERATION_FAILED = -5,
+  LITERT_LM_ERROR_CANCELLED = -6,
 } LiteRtLmStatus;
 
+// Bytes returned by the library without a copy, pointing into storage shared
+// by the buffers of the same bytes and freed with the last of them. Released
+// with `release(owner)`, and shared with `retain(owner)` which must be matched
+// by one more release. An empty buffer has NULL data, owner and functions.
+typedef struct {
+  const char* data;
+  size_t size;
+  void* owner;
+  void (*retain)(void* owner);
+  void (*release)(void* owner);
+} LiteRtLmBuffer;
+
+// ============================================================================
+// Engine Settings API
+// ============================================================================
+
+/**
+ * Create the default settings of an engine, to tune before creating engines
+ * with LiteRtLmEngine_CreateWithSettings.
+ *
+ * @param model_path Path to the .litertlm model file
+ * @param backend Backend of the main executor (CPU or GPU)
+ * @param out_settings Output pointer for the created settings
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmEngineSettings_Create(
+    const char* model_path,
+    LiteRtLmBackend backend,
+    LiteRtLmEngineSettingsPtr* out_settings);
+
+/**
+ * Destroy engine settings. The engines created with them are not affected.
+ *
+ * @param settings Settings to destroy
+ */
+void LiteRtLmEngineSettings_Destroy(LiteRtLmEngineSettingsPtr settings);
+
+/**
+ * Set the maximum number of tokens of the context, the model default if not
+ * set.
+ */
+void LiteRtLmEngineSettings_SetMaxNumTokens(
+    LiteRtLmEngineSettingsPtr settings,
+    int max_num_tokens);
+
+/**
+ * Set the numbers of tokens the prefill runs at once, the model default if not
+ * set.
+ *
+ * @param settings Engine settings
+ * @param prefill_batch_sizes Array of the batch sizes
+ * @param num_prefill_batch_sizes Size of the array
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmEngineSettings_SetPrefillBatchSizes(
+    LiteRtLmEngineSettingsPtr settings,
+    const int32_t* prefill_batch_sizes,
+    int num_prefill_batch_sizes);
+
+/**
+ * Set the number of threads of the CPU backend.
+ *
+ * @return Status code (0 = success, negative = error, e.g. not a CPU backend)
+ */
+int LiteRtLmEngineSettings_SetNumCpuThreads(
+    LiteRtLmEngineSettingsPtr settings,
+    int num_cpu_threads);
+
+/**
+ * Set whether the GPU backend binds external tensors instead of copying them.
+ *
+ * @return Status code (0 = success, negative = error, e.g. not a GPU backend)
+ */
+int LiteRtLmEngineSettings_SetGpuExternalTensorMode(
+    LiteRtLmEngineSettingsPtr settings,
+    int external_tensor_mode);
+
+/**
+ * Set the directory of the compiled model caches, ":nocache" to disable them.
+ */
+void LiteRtLmEngineSettings_SetCacheDir(
+    LiteRtLmEngineSettingsPtr settings,
+    const char* cache_dir);
+
+/**
+ * Set the backend of the sampler, the backend of the executor if not set.
+ */
+void LiteRtLmEngineSettings_SetSamplerBackend(
+    LiteRtLmEngineSettingsPtr settings,
+    LiteRtLmBackend sampler_backend);
+
+/**
+ * Set the number of output candidates the executor is prepared for.
+ */
+void LiteRtLmEngineSettings_SetNumOutputCandidates(
+    LiteRtLmEngineSettingsPtr settings,
+    int num_output_candidates);
+
+/**
+ * Benchmark the engine, with synthetic prompts of `num_prefill_tokens` and
+ * `num_decode_tokens` if positive, or the real ones otherwise.
+ */
+void LiteRtLmEngineSettings_EnableBenchmark(
+    LiteRtLmEngineSettingsPtr settings,
+    int num_prefill_tokens,
+    int num_decode_tokens);
+
+// ============================================================================
+// Session Config API
+// ============================================================================
+
+/**
+ * Create the default config of the sessions, to tune before creating
+ * conversations with LiteRtLmConversation_CreateWithConfig.
+ *
+ * @param out_config Output pointer for the created config
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmSessionConfig_Create(LiteRtLmSessionConfigPtr* out_config);
+
+/**
+ * Destroy a session config. The conversations created with it are not
+ * affected.
+ *
+ * @param config Config to destroy
+ */
+void LiteRtLmSessionConfig_Destroy(LiteRtLmSessionConfigPtr config);
+
+/**
+ * Set the number of output candidates of each response.
+ */
+void LiteRtLmSessionConfig_SetNumOutputCandidates(
+    LiteRtLmSessionConfigPtr config,
+    int num_output_candidates);
+
+/**
+ * Set the backend of the sampler, the one of the engine if not set.
+ */
+void LiteRtLmSessionConfig_SetSamplerBackend(
+    LiteRtLmSessionConfigPtr config,
+    LiteRtLmBackend sampler_backend);
+
+/**
+ * Set the priority of the requests of the session, the higher the sooner.
+ */
+void LiteRtLmSessionConfig_SetPriority(
+    LiteRtLmSessionConfigPtr config,
+    int priority);
+
+/**
+ * Bound the chunks of a streamed response waiting for its callback, which is
+ * then called from a thread of its own so that a slow callback does not stall
+ * the decoding. When `max_pending_chunks` chunks are waiting, the decoding
+ * waits (BLOCK), the next chunks are merged until the callback catches up
+ * (COALESCE), or the response is cancelled and ends with an error (CANCEL).
+ *
+ * @param config Session config
+ * @param max_pending_chunks The maximum number of chunks waiting, at least 1
+ * @param backpressure What to do when that many chunks are waiting
+ */
+void LiteRtLmSessionConfig_SetStreamBackpressure(
+    LiteRtLmSessionConfigPtr config,
+    int max_pending_chunks,
+    LiteRtLmStreamBackpressure backpressure);
+
 // ============================================================================
 // Engine API
 // ============================================================================
@@ -42,6 +223,17 @@ int LiteRtLmEngine_Create(
     LiteRtLmBackend backend,
     LiteRtLmEnginePtr* out_engine);
 
+/**
+ * Create a new LiteRT-LM Engine from tuned settings.
+ *
+ * @param settings Engine settings, which may be destroyed or reused after
+ * @param out_engine Output pointer for the created engine
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmEngine_CreateWithSettings(
+    LiteRtLmEngineSettingsPtr settings,
+    LiteRtLmEnginePtr* out_engine);
+
 /**
  * Destroy an engine and free resources.
  *
@@ -49,6 +241,132 @@ int LiteRtLmEngine_Create(
  */
 void LiteRtLmEngine_Destroy(LiteRtLmEnginePtr engine);
 
+// Counters and gauges of an engine since it was created.
+typedef struct {
+  int32_t num_sessions;
+  int32_t num_queued_tasks;
+  int64_t num_prefilled_tokens;
+  int64_t num_decode_steps;
+  int64_t num_cancellations;
+  // Negative if the engine does not page its kv-cache.
+  double kv_cache_utilization;
+  // 0 for the caches which are disabled.
+  int64_t prefix_cache_hits;
+  int64_t prefix_cache_misses;
+  int64_t embedding_cache_hits;
+  int64_t embedding_cache_misses;
+  int64_t token_id_cache_hits;
+  int64_t token_id_cache_misses;
+} LiteRtLmMetrics;
+
+/**
+ * Read the metrics of an engine, cheap enough to be scraped periodically.
+ *
+ * @param engine Engine to read the metrics of
+ * @param out_metrics Output metrics
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmEngine_GetMetrics(
+    LiteRtLmEnginePtr engine,
+    LiteRtLmMetrics* out_metrics);
+
+// ============================================================================
+// Asynchronous Engine Creation API
+// ============================================================================
+
+// Phases of an asynchronous engine creation, in the order they complete.
+// The phases of the executors the model does not have are skipped.
+typedef enum {
+  LITERT_LM_CREATION_PHASE_MODEL_MAPPING = 0,
+  LITERT_LM_CREATION_PHASE_TOKENIZER = 1,
+  LITERT_LM_CREATION_PHASE_MAIN_EXECUTOR = 2,
+  LITERT_LM_CREATION_PHASE_VISION_EXECUTOR = 3,
+  LITERT_LM_CREATION_PHASE_AUDIO_EXECUTOR = 4,
+  LITERT_LM_CREATION_PHASE_DRAFT_EXECUTOR = 5,
+  LITERT_LM_CREATION_PHASE_DONE = 6,
+} LiteRtLmCreationPhase;
+
+/**
+ * Callback reporting the progress of an asynchronous engine creation. It is
+ * called on a background thread, never concurrently.
+ *
+ * @param user_data User data passed to LiteRtLmEngine_CreateAsync
+ * @param phase The phase completed, LITERT_LM_CREATION_PHASE_DONE once the
+ *   creation is done, successfully or not
+ * @param status LITERT_LM_OK, or the status of the creation with
+ *   LITERT_LM_CREATION_PHASE_DONE
+ */
+typedef void (*LiteRtLmCreationCallback)(void* user_data,
+                                         LiteRtLmCreationPhase phase,
+                                         int status);
+
+/**
+ * Start creating a new LiteRT-LM Engine on a background thread. Returns
+ * immediately; the engine is then returned by LiteRtLmEngineCreation_Wait.
+ *
+ * @param model_path Path to the .litertlm model file
+ * @param backend Backend to use (CPU or GPU)
+ * @param callback Progress callback (can be NULL)
+ * @param user_data User data passed to the callback
+ * @param out_creation Output pointer for the pending creation (must be
+ *   destroyed with LiteRtLmEngineCreation_Destroy)
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmEngine_CreateAsync(
+    const char* model_path,
+    LiteRtLmBackend backend,
+    LiteRtLmCreationCallback callback,
+    void* user_data,
+    LiteRtLmEngineCreationPtr* out_creation);
+
+/**
+ * Start creating a new LiteRT-LM Engine from tuned settings on a background
+ * thread, see LiteRtLmEngine_CreateAsync.
+ *
+ * @param settings Engine settings, which may be destroyed or reused after
+ * @param callback Progress callback (can be NULL)
+ * @param user_data User data passed to the callback
+ * @param out_creation Output pointer for the pending creation
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmEngine_CreateAsyncWithSettings(
+    LiteRtLmEngineSettingsPtr settings,
+    LiteRtLmCreationCallback callback,
+    void* user_data,
+    LiteRtLmEngineCreationPtr* out_creation);
+
+/**
+ * Request the cancellation of an engine creation. The creation stops when
+ * its current phase, e.g. a model compilation, completes, and is then done
+ * with LITERT_LM_ERROR_CANCELLED.
+ *
+ * @param creation Pending creation
+ */
+void LiteRtLmEngineCreation_Cancel(LiteRtLmEngineCreationPtr creation);
+
+/**
+ * Wait for an engine creation to be done and return the engine. Does not
+ * block once the callback got LITERT_LM_CREATION_PHASE_DONE, and may be
+ * called from the callback then.
+ *
+ * @param creation Pending creation
+ * @param out_engine Output pointer for the created engine (must be destroyed
+ *   with LiteRtLmEngine_Destroy)
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmEngineCreation_Wait(
+    LiteRtLmEngineCreationPtr creation,
+    LiteRtLmEnginePtr* out_engine);
+
+/**
+ * Destroy a pending creation, cancelling it if not done and waiting for it to
+ * stop. Must not be called from the callback. An engine created and not
+ * returned by LiteRtLmEngineCreation_Wait is destroyed.
+ *
+ * @param creation Pending creation to destroy
+ */
+void LiteRtLmEngineCreation_Destroy(LiteRtLmEngineCreationPtr creation);
+
 // ============================================================================
 // Conversation API
 // ============================================================================
@@ -77,6 +395,22 @@ int LiteRtLmConversation_CreateWithSystem(
     const char* system_instruction,
     LiteRtLmConversationPtr* out_conversation);
 
+/**
+ * Create a new Conversation with a session config.
+ *
+ * @param engine Engine to use
+ * @param config Session config (can be NULL for the default), which may be
+ *   destroyed or reused after
+ * @param system_instruction System instruction for the conversation (can be NULL)
+ * @param out_conversation Output pointer for the created conversation
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmConversation_CreateWithConfig(
+    LiteRtLmEnginePtr engine,
+    LiteRtLmSessionConfigPtr config,
+    const char* system_instruction,
+    LiteRtLmConversationPtr* out_conversation);
+
 /**
  * Send a message to the conversation (blocking).
  *
@@ -92,6 +426,189 @@ int LiteRtLmConversation_SendMessage(
     const char* content,
     char** out_response);
 
+/**
+ * Send a message to the conversation (blocking) and return the response text
+ * without copying it.
+ *
+ * @param conversation Conversation instance
+ * @param role Message role ("user", "model", "system")
+ * @param content Message content (text)
+ * @param out_response Output buffer of the response text, not NUL-terminated
+ *   (must be released)
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmConversation_SendMessageBuffer(
+    LiteRtLmConversationPtr conversation,
+    const char* role,
+    const char* content,
+    LiteRtLmBuffer* out_response);
+
+/**
+ * Callback receiving a response of LiteRtLmConversation_SendMessageStream as
+ * it is generated. It is called on a background thread, never concurrently.
+ *
+ * @param user_data User data passed to LiteRtLmConversation_SendMessageStream
+ * @param chunk The text generated since the previous call, or NULL on the
+ *   final call (only valid for the duration of the call)
+ * @param is_final Non-zero on the last call of the response
+ * @param error_message The error on the final call if the generation failed
+ *   or was cancelled, NULL otherwise
+ */
+typedef void (*LiteRtLmMessageStreamCallback)(void* user_data,
+                                              const char* chunk,
+                                              int is_final,
+                                              const char* error_message);
+
+/**
+ * Send a message to the conversation and stream the response (non-blocking).
+ * The callback is called with each chunk of text, then once with is_final set.
+ * The conversation must not be destroyed before that final call.
+ *
+ * @param conversation Conversation instance
+ * @param role Message role ("user", "model", "system")
+ * @param content Message content (text)
+ * @param callback Callback receiving the response
+ * @param user_data User data passed to the callback
+ * @return Status code (0 = success, negative = error). The callback is not
+ *   called if the message could not be sent.
+ */
+int LiteRtLmConversation_SendMessageStream(
+    LiteRtLmConversationPtr conversation,
+    const char* role,
+    const char* content,
+    LiteRtLmMessageStreamCallback callback,
+    void* user_data);
+
+/**
+ * Cancel the response being generated. A streamed response then ends with a
+ * final call reporting the cancellation.
+ *
+ * @param conversation Conversation instance
+ */
+void LiteRtLmConversation_Cancel(LiteRtLmConversationPtr conversation);
+
+/**
+ * Send a message to the conversation and push the response, as it is
+ * generated, to a completion queue (non-blocking). No code of the caller runs
+ * on the threads generating the response. The conversation and the queue must
+ * not be destroyed before the final completion of the message is polled.
+ *
+ * @param conversation Conversation instance
+ * @param role Message role ("user", "model", "system")
+ * @param content Message content (text)
+ * @param queue Completion queue receiving the response
+ * @param tag Tag of the completions of the response
+ * @return Status code (0 = success, negative = error). Nothing is pushed if
+ *   the message could not be sent.
+ */
+int LiteRtLmConversation_SubmitMessage(
+    LiteRtLmConversationPtr conversation,
+    const char* role,
+    const char* content,
+    LiteRtLmCompletionQueuePtr queue,
+    uint64_t tag);
+
+/**
+ * A message to submit with LiteRtLmConversation_SubmitMessages.
+ */
+typedef struct {
+  LiteRtLmConversationPtr conversation;
+  // Message role ("user", "model", "system")
+  const char* role;
+  // Message content (text)
+  const char* content;
+  // Tag of the completions of the response
+  uint64_t tag;
+} LiteRtLmSubmission;
+
+/**
+ * Send messages to several conversations at once and push their responses to
+ * a completion queue, see LiteRtLmConversation_SubmitMessage. The messages
+ * are all enqueued before this returns, so that the engine sees them
+ * together. A conversation may appear more than once, its messages are then
+ * answered in order.
+ *
+ * @param submissions Messages to submit
+ * @param num_submissions Number of messages
+ * @param queue Completion queue receiving the responses
+ * @param out_statuses Output array of the status of each submission (can be
+ *   NULL), nothing is pushed for the messages which could not be sent
+ * @return Status code (0 = all sent, negative = the first error)
+ */
+int LiteRtLmConversation_SubmitMessages(
+    const LiteRtLmSubmission* submissions,
+    int num_submissions,
+    LiteRtLmCompletionQueuePtr queue,
+    int* out_statuses);
+
+/**
+ * Render and tokenize a message as the next message of a conversation,
+ * without sending it, e.g. for a router to count and hash the tokens of the
+ * turn. The token ids can then be sent with
+ * LiteRtLmConversation_SendTokenizedMessage or
+ * LiteRtLmConversation_SubmitTokenizedMessage, until the history changes.
+ *
+ * @param conversation Conversation instance
+ * @param role Message role ("user", "model", "system")
+ * @param content Message content (text)
+ * @param out_token_ids Output pointer for the token ids of the turn (must be
+ *   freed with LiteRtLm_FreeTokenIds)
+ * @param out_num_tokens Output number of token ids
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmConversation_TokenizeMessage(
+    LiteRtLmConversationPtr conversation,
+    const char* role,
+    const char* content,
+    int32_t** out_token_ids,
+    int* out_num_tokens);
+
+/**
+ * Send a message tokenized by LiteRtLmConversation_TokenizeMessage (blocking).
+ * The token ids are prefilled without rendering and tokenizing the message
+ * again, the message is only added to the history.
+ *
+ * @param conversation Conversation instance
+ * @param role Message role ("user", "model", "system")
+ * @param content Message content (text)
+ * @param token_ids Token ids of the message
+ * @param num_tokens Number of token ids, at least 1
+ * @param out_response Output pointer for the response text (must be freed with LiteRtLm_FreeString)
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmConversation_SendTokenizedMessage(
+    LiteRtLmConversationPtr conversation,
+    const char* role,
+    const char* content,
+    const int32_t* token_ids,
+    int num_tokens,
+    char** out_response);
+
+/**
+ * Send a message tokenized by LiteRtLmConversation_TokenizeMessage and push
+ * the response to a completion queue (non-blocking), see
+ * LiteRtLmConversation_SubmitMessage and
+ * LiteRtLmConversation_SendTokenizedMessage.
+ *
+ * @param conversation Conversation instance
+ * @param role Message role ("user", "model", "system")
+ * @param content Message content (text)
+ * @param token_ids Token ids of the message
+ * @param num_tokens Number of token ids, at least 1
+ * @param queue Completion queue receiving the response
+ * @param tag Tag of the completions of the response
+ * @return Status code (0 = success, negative = error). Nothing is pushed if
+ *   the message could not be sent.
+ */
+int LiteRtLmConversation_SubmitTokenizedMessage(
+    LiteRtLmConversationPtr conversation,
+    const char* role,
+    const char* content,
+    const int32_t* token_ids,
+    int num_tokens,
+    LiteRtLmCompletionQueuePtr queue,
+    uint64_t tag);
+
 /**
  * Destroy a conversation and free resources.
  *
@@ -99,6 +616,158 @@ int LiteRtLmConversation_SendMessage(
  */
 void LiteRtLmConversation_Destroy(LiteRtLmConversationPtr conversation);
 
+// ============================================================================
+// Completion Queue API
+// ============================================================================
+
+// A part of a response submitted with LiteRtLmConversation_SubmitMessage.
+typedef struct {
+  uint64_t tag;
+  // The text generated since the previous completion of the response, not
+  // NUL-terminated, or an empty buffer (must be released).
+  LiteRtLmBuffer chunk;
+  // Non-zero on the last completion of the response.
+  int32_t is_final;
+  // On the last completion: LITERT_LM_OK, LITERT_LM_ERROR_CANCELLED or
+  // LITERT_LM_ERROR_GENERATION_FAILED.
+  int32_t status;
+  // The error if the status is not LITERT_LM_OK, or NULL (must be freed with
+  // LiteRtLm_FreeString).
+  char* error_message;
+} LiteRtLmCompletion;
+
+/**
+ * Create a completion queue. Its completions are pushed without locks from
+ * the threads generating the responses, and a file descriptor becomes
+ * readable when there are completions to poll, e.g. for an event loop to
+ * wait on.
+ *
+ * @param out_queue Output pointer for the created queue
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmCompletionQueue_Create(LiteRtLmCompletionQueuePtr* out_queue);
+
+/**
+ * Get the file descriptor readable while there may be completions to poll. It
+ * is owned by the queue and must not be read or closed.
+ *
+ * @param queue Completion queue
+ * @return The file descriptor, negative on error
+ */
+int LiteRtLmCompletionQueue_GetFd(LiteRtLmCompletionQueuePtr queue);
+
+/**
+ * Poll the completions of a queue without blocking. Must not be called
+ * concurrently on the same queue. The file descriptor stays readable if
+ * completions are left.
+ *
+ * @param queue Completion queue
+ * @param out_completions Output array of the completions, in their order
+ * @param max_completions Size of the output array
+ * @return The number of completions polled, negative on error
+ */
+int LiteRtLmCompletionQueue_Poll(
+    LiteRtLmCompletionQueuePtr queue,
+    LiteRtLmCompletion* out_completions,
+    int max_completions);
+
+/**
+ * Destroy a completion queue, dropping the completions not polled.
+ *
+ * @param queue Completion queue to destroy
+ */
+void LiteRtLmCompletionQueue_Destroy(LiteRtLmCompletionQueuePtr queue);
+
+// ============================================================================
+// Tokenizer API
+// ============================================================================
+
+/**
+ * Tokenize a text with the tokenizer of an engine, without creating a
+ * conversation.
+ *
+ * @param engine Engine instance
+ * @param text Text to tokenize
+ * @param out_token_ids Output pointer for the token ids (must be freed with
+ *   LiteRtLm_FreeTokenIds)
+ * @param out_num_tokens Output number of token ids
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmEngine_TextToTokenIds(
+    LiteRtLmEnginePtr engine,
+    const char* text,
+    int32_t** out_token_ids,
+    int* out_num_tokens);
+
+/**
+ * Count the tokens of a text with the tokenizer of an engine, without
+ * creating a conversation.
+ *
+ * @param engine Engine instance
+ * @param text Text to tokenize
+ * @param out_num_tokens Output number of tokens
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmEngine_CountTokens(
+    LiteRtLmEnginePtr engine,
+    const char* text,
+    int* out_num_tokens);
+
+/**
+ * Create a tokenizer of batches of texts, running on its own threads, from
+ * the tokenizer of an engine. The engine must outlive it.
+ *
+ * @param engine Engine instance
+ * @param num_threads Number of threads tokenizing a batch
+ * @param out_tokenizer Output pointer for the created tokenizer
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmTokenizer_Create(
+    LiteRtLmEnginePtr engine,
+    int num_threads,
+    LiteRtLmTokenizerPtr* out_tokenizer);
+
+/**
+ * Tokenize a batch of texts. The token ids of all the texts are returned in
+ * one array, those of text i being in [out_offsets[i], out_offsets[i + 1]).
+ *
+ * @param tokenizer Tokenizer instance
+ * @param texts Texts to tokenize
+ * @param num_texts Number of texts
+ * @param out_token_ids Output pointer for the token ids (must be freed with
+ *   LiteRtLm_FreeTokenIds)
+ * @param out_offsets Output array of num_texts + 1 offsets
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmTokenizer_TextToTokenIds(
+    LiteRtLmTokenizerPtr tokenizer,
+    const char* const* texts,
+    int num_texts,
+    int32_t** out_token_ids,
+    int64_t* out_offsets);
+
+/**
+ * Count the tokens of each text of a batch.
+ *
+ * @param tokenizer Tokenizer instance
+ * @param texts Texts to tokenize
+ * @param num_texts Number of texts
+ * @param out_num_tokens Output array of num_texts token counts
+ * @return Status code (0 = success, negative = error)
+ */
+int LiteRtLmTokenizer_CountTokens(
+    LiteRtLmTokenizerPtr tokenizer,
+    const char* const* texts,
+    int num_texts,
+    int32_t* out_num_tokens);
+
+/**
+ * Destroy a tokenizer of batches.
+ *
+ * @param tokenizer Tokenizer to destroy
+ */
+void LiteRtLmTokenizer_Destroy(LiteRtLmTokenizerPtr tokenizer);
+
 // ============================================================================
 // Utility Functions
 // ============================================================================
@@ -110,6 +779,13 @@ void LiteRtLmConversation_Destroy(LiteRtLmConversationPtr conversation);
  */
 void LiteRtLm_FreeString(char* str);
 
+/**
+ * Free token ids allocated by the library.
+ *
+ * @param token_ids Token ids to free
+ */
+void LiteRtLm_FreeTokenIds(int32_t* token_ids);
+
 /**
  * Get the last error message.
  *
@@ -0,0 +1,73 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/conversation/constraint_cache.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/components/constrained_decoding/constraint.h"
+
+namespace litert::lm {
+
+// static
+ConstraintCache& ConstraintCache::GetDefault() {
+  static ConstraintCache* const cache = new ConstraintCache();
+  return *cache;
+}
+
+absl::StatusOr<std::shared_ptr<Constraint>> ConstraintCache::GetOrCreate(
+    absl::string_view key, CreateConstraintFn create) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (auto it = constraints_.find(key); it != constraints_.end()) {
+      if (std::shared_ptr<Constraint> constraint = it->second.lock()) {
+        return constraint;
+      }
+    }
+  }
+  // Compiling a constraint may take a while, so it is done without the lock.
+  absl::StatusOr<std::unique_ptr<Constraint>> created = create();
+  if (!created.ok()) {
+    return created.status();
+  }
+  std::shared_ptr<Constraint> constraint = std::move(created).value();
+  absl::MutexLock lock(&mutex_);
+  // Forget the constraints freed since.
+  absl::erase_if(constraints_, [](const auto& entry) {
+    return entry.second.expired();
+  });
+  auto [it, inserted] = constraints_.try_emplace(key, constraint);
+  if (!inserted) {
+    // Another conversation created the same constraint meanwhile.
+    return it->second.lock();
+  }
+  return constraint;
+}
+
+int ConstraintCache::GetNumConstraints() const {
+  absl::MutexLock lock(&mutex_);
+  int num_constraints = 0;
+  for (const auto& [key, constraint] : constraints_) {
+    num_constraints += !constraint.expired();
+  }
+  return num_constraints;
+}
+
+}  // namespace litert::lm
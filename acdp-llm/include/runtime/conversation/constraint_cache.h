@@ -0,0 +1,70 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_CONSTRAINT_CACHE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_CONSTRAINT_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/functional/function_ref.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/components/constrained_decoding/constraint.h"
+
+namespace litert::lm {
+
+// A cache of the constraints compiled from tool schemas, shared by the
+// conversations decoding with the same tools. Compiling a constraint builds
+// its grammar over the whole vocabulary, and the token masks it computes for
+// the grammar states are reused by every conversation sharing it, instead of
+// being computed again for each one.
+//
+// The cache only keeps weak references: a constraint is freed with the last
+// conversation using it. The constraints are used by concurrent decodes, whose
+// state lives in their own constrained decoders. The cache is thread-safe.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(std::shared_ptr<Constraint> constraint,
+//                    ConstraintCache::GetDefault().GetOrCreate(key, [&]() {
+//                      return processor.CreateConstraint(tools);
+//                    }));
+class ConstraintCache {
+ public:
+  using CreateConstraintFn =
+      absl::FunctionRef<absl::StatusOr<std::unique_ptr<Constraint>>()>;
+
+  // Returns the process-wide cache.
+  static ConstraintCache& GetDefault();
+
+  // Returns the live constraint of `key`, or the one created with `create`.
+  // The errors of `create` are returned and not cached.
+  absl::StatusOr<std::shared_ptr<Constraint>> GetOrCreate(
+      absl::string_view key, CreateConstraintFn create);
+
+  // Returns the number of live constraints in the cache.
+  int GetNumConstraints() const;
+
+ private:
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::weak_ptr<Constraint>> constraints_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_CONSTRAINT_CACHE_H_
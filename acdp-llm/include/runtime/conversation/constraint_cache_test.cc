@@ -0,0 +1,102 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/conversation/constraint_cache.h"
+
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "runtime/components/constrained_decoding/constraint.h"
+#include "runtime/components/constrained_decoding/fake_constraint.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::StatusIs;
+
+absl::StatusOr<std::unique_ptr<Constraint>> CreateFakeConstraint(
+    int* num_created) {
+  ++*num_created;
+  return std::make_unique<FakeConstraint>(std::vector<int>{1, 2},
+                                          /*vocabulary_size=*/10);
+}
+
+TEST(ConstraintCacheTest, SharesTheConstraintsOfTheSameKey) {
+  ConstraintCache cache;
+  int num_created = 0;
+  ASSERT_OK_AND_ASSIGN(
+      auto constraint,
+      cache.GetOrCreate("tools", [&]() {
+        return CreateFakeConstraint(&num_created);
+      }));
+  ASSERT_OK_AND_ASSIGN(
+      auto same_constraint,
+      cache.GetOrCreate("tools", [&]() {
+        return CreateFakeConstraint(&num_created);
+      }));
+  ASSERT_OK_AND_ASSIGN(
+      auto other_constraint,
+      cache.GetOrCreate("other tools", [&]() {
+        return CreateFakeConstraint(&num_created);
+      }));
+  EXPECT_EQ(constraint, same_constraint);
+  EXPECT_NE(constraint, other_constraint);
+  EXPECT_EQ(num_created, 2);
+  EXPECT_EQ(cache.GetNumConstraints(), 2);
+}
+
+TEST(ConstraintCacheTest, FreesTheConstraintsNoLongerUsed) {
+  ConstraintCache cache;
+  int num_created = 0;
+  {
+    ASSERT_OK_AND_ASSIGN(
+        auto constraint,
+        cache.GetOrCreate("tools", [&]() {
+          return CreateFakeConstraint(&num_created);
+        }));
+    EXPECT_EQ(cache.GetNumConstraints(), 1);
+  }
+  EXPECT_EQ(cache.GetNumConstraints(), 0);
+  ASSERT_OK_AND_ASSIGN(
+      auto constraint,
+      cache.GetOrCreate("tools", [&]() {
+        return CreateFakeConstraint(&num_created);
+      }));
+  EXPECT_EQ(num_created, 2);
+}
+
+TEST(ConstraintCacheTest, DoesNotCacheTheErrors) {
+  ConstraintCache cache;
+  EXPECT_THAT(
+      cache.GetOrCreate("tools",
+                        []() -> absl::StatusOr<std::unique_ptr<Constraint>> {
+                          return absl::UnimplementedError("Not implemented.");
+                        }),
+      StatusIs(absl::StatusCode::kUnimplemented));
+  int num_created = 0;
+  ASSERT_OK_AND_ASSIGN(
+      auto constraint,
+      cache.GetOrCreate("tools", [&]() {
+        return CreateFakeConstraint(&num_created);
+      }));
+  EXPECT_EQ(num_created, 1);
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -14,6 +14,7 @@
 
 #include "runtime/conversation/conversation.h"
 
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
@@ -21,25 +22,36 @@
 #include <variant>
 #include <vector>
 
+#include "absl/cleanup/cleanup.h"  // from @com_google_absl
 #include "absl/functional/any_invocable.h"  // from @com_google_absl
 #include "absl/log/absl_log.h"  // from @com_google_absl
 #include "absl/memory/memory.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/ascii.h"  // from @com_google_absl
 #include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/strings/strip.h"  // from @com_google_absl
 #include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/synchronization/notification.h"  // from @com_google_absl
 #include "nlohmann/json.hpp"  // from @nlohmann_json
 #include "runtime/components/prompt_template.h"
+#include "runtime/components/tokenizer.h"
+#include "runtime/conversation/constraint_cache.h"
+#include "runtime/conversation/formatted_tools_cache.h"
 #include "runtime/conversation/internal_callback_util.h"
 #include "runtime/conversation/io_types.h"
 #include "runtime/conversation/model_data_processor/config_registry.h"
 #include "runtime/conversation/model_data_processor/model_data_processor.h"
 #include "runtime/conversation/model_data_processor/model_data_processor_factory.h"
+#include "runtime/conversation/prompt_template_cache.h"
+#include "runtime/conversation/response_cache.h"
 #include "runtime/engine/engine.h"
 #include "runtime/engine/engine_settings.h"
 #include "runtime/engine/io_types.h"
 #include "runtime/proto/llm_model_type.pb.h"
+#include "runtime/proto/sampler_params.pb.h"
 #include "runtime/util/status_macros.h"
 
 namespace litert::lm {
@@ -95,47 +107,131 @@ absl::StatusOr<ConversationConfig> ConversationConfig::CreateFromSessionConfig(
   }
   return ConversationConfig(
       session_config_copy, preface.value_or(JsonPreface()),
-      PromptTemplate(session_config_copy.GetJinjaPromptTemplate()),
+      PromptTemplateCache::GetDefault().GetOrCreate(
+          session_config_copy.GetJinjaPromptTemplate()),
       processor_config
   );
 }
 
-absl::StatusOr<std::string> Conversation::GetSingleTurnText(
-    const Message& message) const {
-  PromptTemplateInput old_tmpl_input;
-  if (std::holds_alternative<JsonPreface>(preface_)) {
-    auto json_preface = std::get<JsonPreface>(preface_);
+namespace {
 
-    if (json_preface.messages.is_array()) {
-      for (auto& message : json_preface.messages) {
-        ASSIGN_OR_RETURN(
-            nlohmann::ordered_json message_tmpl_input,
-            model_data_processor_->MessageToTemplateInput(message));
-        old_tmpl_input.messages.push_back(message_tmpl_input);
-      }
+// Returns the key of the tools formatted by the processor of the config. The
+// formatting only depends on the processor type, and on the order of the keys
+// in the tools, which the key keeps.
+std::string GetFormattedToolsCacheKey(
+    const DataProcessorConfig& processor_config,
+    const nlohmann::ordered_json& tools) {
+  return nlohmann::ordered_json::array({processor_config.index(), tools})
+      .dump();
+}
+
+// The request of a key in flight in a response cache, run by a conversation.
+// Finished with an error if dropped before its response is complete, e.g.
+// when the session drops its callback, so that the identical requests
+// subscribed to it never wait forever.
+class InFlightResponse {
+ public:
+  InFlightResponse(std::shared_ptr<ResponseCache> response_cache, size_t key)
+      : response_cache_(std::move(response_cache)), key_(key) {}
+
+  ~InFlightResponse() {
+    Finish(absl::AbortedError(
+        "The identical request in flight ended without a response."));
+  }
+
+  // Passes `chunk` of the response to the subscribers, until finished.
+  void Publish(const Message& chunk) {
+    if (!finished_) {
+      response_cache_->Publish(key_, chunk);
+    }
+  }
+
+  // Ends the request with its complete `response` or its error, once.
+  void Finish(absl::StatusOr<Message> response) {
+    if (!finished_) {
+      finished_ = true;
+      response_cache_->Finish(key_, std::move(response));
     }
+  }
 
-    if (json_preface.tools.is_null()) {
-      old_tmpl_input.tools = nullptr;
+ private:
+  const std::shared_ptr<ResponseCache> response_cache_;
+  const size_t key_;
+  bool finished_ = false;
+};
+
+}  // namespace
+
+absl::Status Conversation::UpdateHistoryTemplateInput() {
+  // The history only shrinks when a message is cancelled.
+  if (num_converted_history_messages_ > history_.size()) {
+    history_tmpl_input_.reset();
+  }
+  if (!history_tmpl_input_.has_value()) {
+    PromptTemplateInput tmpl_input;
+    if (std::holds_alternative<JsonPreface>(preface_)) {
+      auto json_preface = std::get<JsonPreface>(preface_);
+
+      if (json_preface.messages.is_array()) {
+        for (auto& message : json_preface.messages) {
+          ASSIGN_OR_RETURN(
+              nlohmann::ordered_json message_tmpl_input,
+              model_data_processor_->MessageToTemplateInput(message));
+          tmpl_input.messages.push_back(message_tmpl_input);
+        }
+      }
+
+      if (json_preface.tools.is_null()) {
+        tmpl_input.tools = nullptr;
+      } else {
+        if (formatted_tools_ == nullptr) {
+          ASSIGN_OR_RETURN(
+              formatted_tools_,
+              FormattedToolsCache::GetDefault().GetOrCreate(
+                  GetFormattedToolsCacheKey(config_.GetProcessorConfig(),
+                                            json_preface.tools),
+                  [&]() {
+                    return model_data_processor_->FormatTools(
+                        json_preface.tools);
+                  }));
+        }
+        tmpl_input.tools = *formatted_tools_;
+      }
+      tmpl_input.extra_context = json_preface.extra_context;
     } else {
-      ASSIGN_OR_RETURN(old_tmpl_input.tools,
-                       model_data_processor_->FormatTools(json_preface.tools));
+      return absl::UnimplementedError("Preface type is not supported yet");
     }
-    old_tmpl_input.extra_context = json_preface.extra_context;
-  } else {
-    return absl::UnimplementedError("Preface type is not supported yet");
+    history_tmpl_input_ = std::move(tmpl_input);
+    num_converted_history_messages_ = 0;
+    rendered_history_.reset();
   }
-  absl::MutexLock lock(history_mutex_);  // NOLINT
-  for (const auto& history_msg : history_) {
+  for (; num_converted_history_messages_ < history_.size();
+       ++num_converted_history_messages_) {
+    const auto& history_msg = history_[num_converted_history_messages_];
     if (std::holds_alternative<nlohmann::ordered_json>(history_msg)) {
       ASSIGN_OR_RETURN(nlohmann::ordered_json message_tmpl_input,
                        model_data_processor_->MessageToTemplateInput(
                            std::get<nlohmann::ordered_json>(history_msg)));
-      old_tmpl_input.messages.push_back(message_tmpl_input);
+      history_tmpl_input_->messages.push_back(message_tmpl_input);
+      rendered_history_.reset();
     } else {
       return absl::UnimplementedError("Message type is not supported yet");
     }
   }
+  return absl::OkStatus();
+}
+
+void Conversation::InvalidateHistoryTemplateInput() {
+  history_tmpl_input_.reset();
+  num_converted_history_messages_ = 0;
+  rendered_history_.reset();
+}
+
+absl::StatusOr<std::string> Conversation::GetSingleTurnText(
+    const Message& message, std::string* prompt) {
+  absl::MutexLock lock(history_mutex_);  // NOLINT
+  RETURN_IF_ERROR(UpdateHistoryTemplateInput());
+  PromptTemplateInput& tmpl_input = *history_tmpl_input_;
 
   if (!std::holds_alternative<nlohmann::ordered_json>(message)) {
     return absl::InvalidArgumentError("Json message is required for now.");
@@ -145,38 +241,165 @@ absl::StatusOr<std::string> Conversation::GetSingleTurnText(
   nlohmann::ordered_json messages =
       json_message.is_array() ? json_message
                               : nlohmann::ordered_json::array({json_message});
-  if (history_.empty()) {
-    PromptTemplateInput new_tmpl_input = std::move(old_tmpl_input);
-    for (const auto& message : messages) {
-      ASSIGN_OR_RETURN(nlohmann::ordered_json message_tmpl_input,
-                       model_data_processor_->MessageToTemplateInput(message));
-      new_tmpl_input.messages.push_back(message_tmpl_input);
-    }
-    new_tmpl_input.add_generation_prompt = true;
-    return prompt_template_.Apply(new_tmpl_input);
+  if (!history_.empty() && !rendered_history_.has_value()) {
+    tmpl_input.add_generation_prompt = false;
+    ASSIGN_OR_RETURN(rendered_history_, prompt_template_.Apply(tmpl_input));
   }
 
-  old_tmpl_input.add_generation_prompt = false;
-  ASSIGN_OR_RETURN(const std::string old_string,
-                   prompt_template_.Apply(old_tmpl_input));
-
-  PromptTemplateInput new_tmpl_input = std::move(old_tmpl_input);
+  // The new messages are only appended for the rendering, they are converted
+  // again once they are part of the history.
+  const size_t num_history_messages = tmpl_input.messages.size();
+  absl::Cleanup remove_new_messages = [&tmpl_input, num_history_messages] {
+    if (tmpl_input.messages.size() > num_history_messages) {
+      tmpl_input.messages.erase(
+          tmpl_input.messages.begin() + num_history_messages,
+          tmpl_input.messages.end());
+    }
+  };
   for (const auto& message : messages) {
     ASSIGN_OR_RETURN(nlohmann::ordered_json message_tmpl_input,
                      model_data_processor_->MessageToTemplateInput(message));
-    new_tmpl_input.messages.push_back(message_tmpl_input);
+    tmpl_input.messages.push_back(message_tmpl_input);
   }
-  new_tmpl_input.add_generation_prompt = true;
-  ASSIGN_OR_RETURN(const std::string& new_string,
-                   prompt_template_.Apply(new_tmpl_input));
+  tmpl_input.add_generation_prompt = true;
+  ASSIGN_OR_RETURN(std::string new_string, prompt_template_.Apply(tmpl_input));
+  if (prompt != nullptr) {
+    *prompt = new_string;
+  }
+  if (history_.empty()) {
+    return new_string;
+  }
+
+  const std::string& old_string = *rendered_history_;
   if (new_string.substr(0, old_string.size()) != old_string) {
     return absl::InternalError(absl::StrCat(
         "The new rendered template string does not start with the previous "
         "rendered template string. \nold_string: ",
         old_string, "\nnew_string: ", new_string));
   }
-  return {new_string.substr(old_string.size(),
-                            new_string.size() - old_string.size())};
+  return {new_string.substr(
+      prefilled_history_size_.value_or(old_string.size()))};
+}
+
+std::optional<size_t> Conversation::GetResponseCacheKey(
+    absl::string_view prompt, const std::vector<InputData>& session_inputs,
+    const std::optional<DataProcessorArguments>& args) const {
+  if (config_.GetResponseCache() == nullptr ||
+      (args.has_value() && !std::holds_alternative<std::monostate>(*args))) {
+    return std::nullopt;
+  }
+  for (const auto& input : session_inputs) {
+    if (!std::holds_alternative<InputText>(input)) {
+      return std::nullopt;
+    }
+  }
+  const SessionConfig& session_config = config_.GetSessionConfig();
+  return ResponseCache::ComputeKey(
+      config_.GetResponseCacheModelId(),
+      absl::StrCat(session_config.GetSamplerParams().SerializeAsString(), "/",
+                   session_config.GetNumOutputCandidates()),
+      prompt);
+}
+
+namespace {
+
+// Returns whether the sessions of `session_config` generate the same response
+// to the same prompt: with greedy sampling or a fixed seed.
+bool IsDeterministic(const SessionConfig& session_config) {
+  const proto::SamplerParameters& sampler_params =
+      session_config.GetSamplerParams();
+  return sampler_params.type() == proto::SamplerParameters::GREEDY ||
+         sampler_params.k() == 1 || sampler_params.has_seed();
+}
+
+// Returns the key of the constraint created from `tools` for the tokenizer,
+// which depends on the fields of the processor config used for tool calls.
+std::string GetConstraintCacheKey(const Tokenizer& tokenizer,
+                                  const DataProcessorConfig& processor_config,
+                                  const nlohmann::ordered_json& tools) {
+  nlohmann::ordered_json key = nlohmann::ordered_json::array(
+      {absl::StrFormat("%p", &tokenizer), processor_config.index()});
+  if (const auto* config =
+          std::get_if<GenericDataProcessorConfig>(&processor_config)) {
+    key.push_back(config->model_role);
+  } else if (const auto* config =
+                 std::get_if<Gemma3DataProcessorConfig>(&processor_config)) {
+    key.push_back(config->code_fence_start);
+    key.push_back(config->code_fence_end);
+    key.push_back(config->syntax_type);
+    key.push_back(config->escape_fence_strings);
+    key.push_back(config->tool_code_regex);
+  } else if (const auto* config =
+                 std::get_if<Qwen3DataProcessorConfig>(&processor_config)) {
+    key.push_back(config->code_fence_start);
+    key.push_back(config->code_fence_end);
+    key.push_back(config->escape_fence_strings);
+    key.push_back(config->tool_code_regex);
+  }
+  key.push_back(tools);
+  return key.dump();
+}
+
+// Returns the reasoning budget options of `config`, with the markers of the
+// reasoning of its processor config.
+std::optional<DecodeConfig::ReasoningBudgetOptions> GetReasoningBudgetOptions(
+    const ConversationConfig& config) {
+  std::optional<DecodeConfig::ReasoningBudgetOptions> options =
+      config.GetReasoningBudgetOptions();
+  if (!options.has_value()) {
+    return std::nullopt;
+  }
+  if (const auto* processor_config =
+          std::get_if<Qwen3DataProcessorConfig>(&config.GetProcessorConfig())) {
+    options->reasoning_start = processor_config->reasoning_start;
+    options->reasoning_end = processor_config->reasoning_end;
+  }
+  return options;
+}
+
+// Returns `text` without its reasoning, the span from `reasoning_start` to
+// `reasoning_end` it starts with, if any.
+std::string StripReasoning(absl::string_view text,
+                           absl::string_view reasoning_start,
+                           absl::string_view reasoning_end) {
+  absl::string_view stripped = absl::StripLeadingAsciiWhitespace(text);
+  if (!absl::ConsumePrefix(&stripped, reasoning_start)) {
+    return std::string(text);
+  }
+  const size_t end = stripped.find(reasoning_end);
+  if (end == absl::string_view::npos) {
+    return std::string(text);
+  }
+  return std::string(absl::StripLeadingAsciiWhitespace(
+      stripped.substr(end + reasoning_end.size())));
+}
+
+}  // namespace
+
+Message Conversation::ToHistoryMessage(const Message& message) const {
+  const std::optional<DecodeConfig::ReasoningBudgetOptions> options =
+      GetReasoningBudgetOptions(config_);
+  if (!options.has_value() || !options->strip_reasoning ||
+      !std::holds_alternative<nlohmann::ordered_json>(message)) {
+    return message;
+  }
+  nlohmann::ordered_json json_message =
+      std::get<nlohmann::ordered_json>(message);
+  if (!json_message.is_object() || !json_message.contains("content")) {
+    return message;
+  }
+  nlohmann::ordered_json& content = json_message["content"];
+  if (content.is_string()) {
+    content = StripReasoning(content.get<std::string>(),
+                             options->reasoning_start, options->reasoning_end);
+  } else if (content.is_array() && !content.empty() &&
+             content[0].contains("text") && content[0]["text"].is_string()) {
+    // The reasoning starts the first part of the response.
+    content[0]["text"] =
+        StripReasoning(content[0]["text"].get<std::string>(),
+                       options->reasoning_start, options->reasoning_end);
+  }
+  return json_message;
 }
 
 absl::StatusOr<DecodeConfig> Conversation::CreateDecodeConfig() {
@@ -186,8 +409,13 @@ absl::StatusOr<DecodeConfig> Conversation::CreateDecodeConfig() {
       constraint_ == nullptr && std::holds_alternative<JsonPreface>(preface_)) {
     auto json_preface = std::get<JsonPreface>(preface_);
     if (!json_preface.tools.is_null()) {
-      auto constraint =
-          model_data_processor_->CreateConstraint(json_preface.tools);
+      auto constraint = ConstraintCache::GetDefault().GetOrCreate(
+          GetConstraintCacheKey(session_->GetTokenizer(),
+                                config_.GetProcessorConfig(),
+                                json_preface.tools),
+          [&]() {
+            return model_data_processor_->CreateConstraint(json_preface.tools);
+          });
       if (constraint.ok()) {
         constraint_ = std::move(constraint.value());
       } else if (!absl::IsUnimplemented(constraint.status())) {
@@ -196,6 +424,7 @@ absl::StatusOr<DecodeConfig> Conversation::CreateDecodeConfig() {
     }
   }
   decode_config.SetConstraint(constraint_.get());
+  decode_config.SetReasoningBudgetOptions(GetReasoningBudgetOptions(config_));
   return decode_config;
 }
 
@@ -213,42 +442,243 @@ absl::StatusOr<std::unique_ptr<Conversation>> Conversation::Create(
 
   auto conversation = absl::WrapUnique(new Conversation(
       std::move(session), std::move(model_data_processor), config.GetPreface(),
-      config.GetPromptTemplate(), config));
+      config));
   return conversation;
 }
 
+absl::StatusOr<std::unique_ptr<Conversation>> Conversation::Fork() {
+  ASSIGN_OR_RETURN(std::unique_ptr<Engine::Session> session,
+                   session_->Fork());
+  ASSIGN_OR_RETURN(
+      std::unique_ptr<ModelDataProcessor> model_data_processor,
+      CreateModelDataProcessor(config_.GetProcessorConfig(),
+                               session->GetTokenizer(), config_.GetPreface()));
+  auto child = absl::WrapUnique(new Conversation(
+      std::move(session), std::move(model_data_processor), preface_, config_));
+  child->constraint_ = constraint_;
+  absl::MutexLock lock(history_mutex_);  // NOLINT
+  absl::MutexLock child_lock(child->history_mutex_);  // NOLINT
+  child->history_ = history_;
+  child->formatted_tools_ = formatted_tools_;
+  child->history_tmpl_input_ = history_tmpl_input_;
+  child->num_converted_history_messages_ = num_converted_history_messages_;
+  child->rendered_history_ = rendered_history_;
+  child->prefilled_history_size_ = prefilled_history_size_;
+  return child;
+}
+
+absl::StatusOr<std::vector<std::unique_ptr<Conversation>>> Conversation::Fork(
+    int num_children) {
+  std::vector<std::unique_ptr<Conversation>> children;
+  children.reserve(num_children);
+  for (int i = 0; i < num_children; ++i) {
+    ASSIGN_OR_RETURN(auto child, Fork());
+    children.push_back(std::move(child));
+  }
+  return children;
+}
+
 absl::StatusOr<Message> Conversation::SendMessage(
     const Message& message, std::optional<DataProcessorArguments> args) {
   if (!std::holds_alternative<nlohmann::ordered_json>(message)) {
     return absl::InvalidArgumentError("Json message is required for now.");
   }
-  auto json_message = std::get<nlohmann::ordered_json>(message);
-  ASSIGN_OR_RETURN(const std::string& single_turn_text,
-                   GetSingleTurnText(message));
+  const auto& json_message = std::get<nlohmann::ordered_json>(message);
+  std::string prompt;
+  ASSIGN_OR_RETURN(
+      const std::string& single_turn_text,
+      GetSingleTurnText(message, config_.GetResponseCache() != nullptr
+                                     ? &prompt
+                                     : nullptr));
   absl::MutexLock lock(history_mutex_);  // NOLINT
-  if (json_message.is_array()) {
-    for (const auto& message : json_message) {
-      history_.push_back(message);
-    }
-  } else {
-    history_.push_back(json_message);
-  }
+  AppendToHistory(message);
   ASSIGN_OR_RETURN(
-      const auto session_inputs,
+      auto session_inputs,
       model_data_processor_->ToInputDataVector(
           single_turn_text, nlohmann::ordered_json::array({json_message}),
           args.value_or(std::monostate())));
-  RETURN_IF_ERROR(session_->RunPrefill(session_inputs));
+  const std::optional<size_t> response_key =
+      GetResponseCacheKey(prompt, session_inputs, args);
+  bool in_flight = false;
+  if (response_key.has_value()) {
+    ResponseCache& response_cache = *config_.GetResponseCache();
+    std::optional<absl::StatusOr<Message>> response =
+        response_cache.Lookup(*response_key);
+    if (!response.has_value() && IsDeterministic(config_.GetSessionConfig())) {
+      // Waits for the identical request in flight, if any.
+      absl::Notification done;
+      if (response_cache.SubscribeOrStart(
+              *response_key,
+              {.done_callback = [&](absl::StatusOr<Message> message) {
+                response = std::move(message);
+                done.Notify();
+              }})) {
+        done.WaitForNotification();
+      } else {
+        in_flight = true;
+      }
+    }
+    if (response.has_value()) {
+      RETURN_IF_ERROR(response->status());
+      prefilled_history_size_ = prompt.size() - single_turn_text.size();
+      history_.Append(**response);
+      return **std::move(response);
+    }
+  }
+  absl::Status prefill_status = session_->RunPrefill(std::move(session_inputs));
+  absl::StatusOr<Message> assistant_message =
+      prefill_status.ok() ? DecodeMessage(args)
+                          : absl::StatusOr<Message>(prefill_status);
+  if (prefill_status.ok()) {
+    prefilled_history_size_.reset();
+  }
+  if (assistant_message.ok()) {
+    history_.Append(ToHistoryMessage(*assistant_message));
+  }
+  if (response_key.has_value() && assistant_message.ok()) {
+    config_.GetResponseCache()->Insert(*response_key, *assistant_message);
+  }
+  if (in_flight) {
+    if (assistant_message.ok()) {
+      // Streamed to the subscribers as a single chunk.
+      config_.GetResponseCache()->Publish(*response_key, *assistant_message);
+    }
+    config_.GetResponseCache()->Finish(*response_key, assistant_message);
+  }
+  return assistant_message;
+}
+
+absl::StatusOr<Message> Conversation::DecodeMessage(
+    const std::optional<DataProcessorArguments>& args) {
   ASSIGN_OR_RETURN(auto decode_config, CreateDecodeConfig());
   ASSIGN_OR_RETURN(const Responses& responses,
                    session_->RunDecode(decode_config));
-  ASSIGN_OR_RETURN(const Message assistant_message,
-                   model_data_processor_->ToMessage(
-                       responses, args.value_or(std::monostate())));
-  history_.push_back(assistant_message);
+  return model_data_processor_->ToMessage(responses,
+                                          args.value_or(std::monostate()));
+}
+
+void Conversation::AppendToHistory(const Message& message) {
+  const auto& json_message = std::get<nlohmann::ordered_json>(message);
+  if (json_message.is_array()) {
+    for (const auto& message : json_message) {
+      history_.Append(Message(message));
+    }
+  } else {
+    history_.Append(std::make_shared<const Message>(message));
+  }
+}
+
+absl::StatusOr<std::vector<int>> Conversation::TokenizeMessage(
+    const Message& message) {
+  ASSIGN_OR_RETURN(const std::string single_turn_text,
+                   GetSingleTurnText(message));
+  return session_->TextToPrefillTokenIds(single_turn_text);
+}
+
+absl::StatusOr<std::vector<InputData>> Conversation::TokenIdsToSessionInputs(
+    std::vector<int> token_ids) const {
+  if (token_ids.empty()) {
+    return absl::InvalidArgumentError("The message has no token ids.");
+  }
+  ASSIGN_OR_RETURN(auto ids_buffer,
+                   session_->GetTokenizer().TokenIdsToTensorBuffer(token_ids));
+  std::vector<InputData> session_inputs;
+  session_inputs.emplace_back(InputText(std::move(ids_buffer)));
+  return session_inputs;
+}
+
+absl::StatusOr<Message> Conversation::SendTokenizedMessage(
+    const Message& message, std::vector<int> token_ids) {
+  if (!std::holds_alternative<nlohmann::ordered_json>(message)) {
+    return absl::InvalidArgumentError("Json message is required for now.");
+  }
+  ASSIGN_OR_RETURN(auto session_inputs,
+                   TokenIdsToSessionInputs(std::move(token_ids)));
+  absl::MutexLock lock(history_mutex_);  // NOLINT
+  AppendToHistory(message);
+  RETURN_IF_ERROR(session_->RunPrefill(std::move(session_inputs)));
+  prefilled_history_size_.reset();
+  ASSIGN_OR_RETURN(Message assistant_message, DecodeMessage(std::nullopt));
+  history_.Append(ToHistoryMessage(assistant_message));
   return assistant_message;
 }
 
+absl::Status Conversation::SendTokenizedMessageAsync(
+    const Message& message, std::vector<int> token_ids,
+    absl::AnyInvocable<void(absl::StatusOr<Message>)> user_callback) {
+  if (!std::holds_alternative<nlohmann::ordered_json>(message)) {
+    return absl::InvalidArgumentError("Json message is required for now.");
+  }
+  if (config_.GetInputPreparationPool() == nullptr) {
+    return SendTokenizedMessageAsyncInternal(message, std::move(token_ids),
+                                             std::move(user_callback));
+  }
+  // Queued behind the messages being prepared, to keep the messages in order.
+  return SchedulePreparation([this, message, token_ids = std::move(token_ids),
+                              user_callback =
+                                  std::move(user_callback)]() mutable {
+    auto shared_callback =
+        std::make_shared<absl::AnyInvocable<void(absl::StatusOr<Message>)>>(
+            std::move(user_callback));
+    absl::Status status = SendTokenizedMessageAsyncInternal(
+        message, std::move(token_ids),
+        [shared_callback](absl::StatusOr<Message> message) {
+          (*shared_callback)(std::move(message));
+        });
+    if (!status.ok()) {
+      (*shared_callback)(status);
+    }
+  });
+}
+
+absl::Status Conversation::SendTokenizedMessageAsyncInternal(
+    const Message& message, std::vector<int> token_ids,
+    absl::AnyInvocable<void(absl::StatusOr<Message>)> user_callback) {
+  ASSIGN_OR_RETURN(auto session_inputs,
+                   TokenIdsToSessionInputs(std::move(token_ids)));
+  ASSIGN_OR_RETURN(auto decode_config, CreateDecodeConfig());
+  {
+    absl::MutexLock lock(history_mutex_);  // NOLINT
+    AppendToHistory(message);
+  }
+
+  absl::AnyInvocable<void(Message)> complete_message_callback =
+      [this](const Message& complete_message) {
+        absl::MutexLock lock(this->history_mutex_);  // NOLINT
+        this->history_.Append(this->ToHistoryMessage(complete_message));
+      };
+
+  absl::AnyInvocable<void()> cancel_callback = [this]() {
+    absl::MutexLock lock(&this->history_mutex_);  // NOLINT
+    this->history_.RemoveLast();
+    this->InvalidateHistoryTemplateInput();
+  };
+
+  RETURN_IF_ERROR(session_->GenerateContentStream(
+      std::move(session_inputs),
+      CreateInternalCallback(*model_data_processor_, std::monostate(),
+                             std::move(user_callback),
+                             std::move(cancel_callback),
+                             std::move(complete_message_callback)),
+      decode_config));
+  absl::MutexLock lock(history_mutex_);  // NOLINT
+  prefilled_history_size_.reset();
+  return absl::OkStatus();
+}
+
+Conversation::~Conversation() {
+  {
+    // The preparations refer to the conversation.
+    absl::MutexLock lock(&preparation_mutex_);
+    preparation_mutex_.Await(absl::Condition(
+        +[](bool* preparing) { return !*preparing; }, &preparing_));
+  }
+  // So do the subscriptions to the identical requests in flight.
+  if (config_.GetResponseCache() != nullptr) {
+    config_.GetResponseCache()->Unsubscribe(this);
+  }
+}
+
 absl::Status Conversation::SendMessageAsync(
     const Message& message,
     absl::AnyInvocable<void(absl::StatusOr<Message>)> user_callback,
@@ -256,35 +686,176 @@ absl::Status Conversation::SendMessageAsync(
   if (!std::holds_alternative<nlohmann::ordered_json>(message)) {
     return absl::InvalidArgumentError("Json message is required for now.");
   }
-  auto json_message = std::get<nlohmann::ordered_json>(message);
-  ASSIGN_OR_RETURN(const std::string& single_turn_text,
-                   GetSingleTurnText(message));
-  {
-    absl::MutexLock lock(history_mutex_);  // NOLINT
-    if (json_message.is_array()) {
-      for (const auto& message : json_message) {
-        history_.push_back(message);
+  if (config_.GetInputPreparationPool() == nullptr) {
+    return PrepareAndSendMessageAsync(message, std::move(user_callback),
+                                      std::move(args));
+  }
+  return SchedulePreparation(
+      [this, message, user_callback = std::move(user_callback),
+       args = std::move(args)]() mutable {
+        // The callback is only invoked once the message is sent, so it still
+        // receives the errors of the preparation.
+        auto shared_callback = std::make_shared<
+            absl::AnyInvocable<void(absl::StatusOr<Message>)>>(
+            std::move(user_callback));
+        absl::Status status = PrepareAndSendMessageAsync(
+            message,
+            [shared_callback](absl::StatusOr<Message> message) {
+              (*shared_callback)(std::move(message));
+            },
+            std::move(args));
+        if (!status.ok()) {
+          (*shared_callback)(status);
+        }
+      });
+}
+
+absl::Status Conversation::SchedulePreparation(
+    absl::AnyInvocable<void()> preparation) {
+  absl::MutexLock lock(&preparation_mutex_);
+  pending_preparations_.push_back(std::move(preparation));
+  if (preparing_) {
+    // Picked up by the running preparations, in order.
+    return absl::OkStatus();
+  }
+  absl::Status status = config_.GetInputPreparationPool()->Schedule(
+      [this]() { RunPreparations(); });
+  if (!status.ok()) {
+    pending_preparations_.pop_back();
+    return status;
+  }
+  preparing_ = true;
+  return absl::OkStatus();
+}
+
+void Conversation::RunPreparations() {
+  while (true) {
+    absl::AnyInvocable<void()> preparation;
+    {
+      absl::MutexLock lock(&preparation_mutex_);
+      if (pending_preparations_.empty()) {
+        preparing_ = false;
+        return;
       }
-    } else {
-      history_.push_back(json_message);
+      preparation = std::move(pending_preparations_.front());
+      pending_preparations_.pop_front();
     }
+    preparation();
+  }
+}
+
+absl::Status Conversation::PrepareAndSendMessageAsync(
+    const Message& message,
+    absl::AnyInvocable<void(absl::StatusOr<Message>)> user_callback,
+    std::optional<DataProcessorArguments> args) {
+  const auto& json_message = std::get<nlohmann::ordered_json>(message);
+  std::string prompt;
+  ASSIGN_OR_RETURN(
+      const std::string& single_turn_text,
+      GetSingleTurnText(message, config_.GetResponseCache() != nullptr
+                                     ? &prompt
+                                     : nullptr));
+  {
+    absl::MutexLock lock(history_mutex_);  // NOLINT
+    AppendToHistory(message);
   }
 
   ASSIGN_OR_RETURN(
-      const auto session_inputs,
+      auto session_inputs,
       model_data_processor_->ToInputDataVector(
           single_turn_text, nlohmann::ordered_json::array({json_message}),
           args.value_or(std::monostate())));
 
+  const std::optional<size_t> response_key =
+      GetResponseCacheKey(prompt, session_inputs, args);
+  if (response_key.has_value()) {
+    if (std::optional<Message> response =
+            config_.GetResponseCache()->Lookup(*response_key)) {
+      {
+        absl::MutexLock lock(history_mutex_);  // NOLINT
+        prefilled_history_size_ = prompt.size() - single_turn_text.size();
+        history_.Append(*response);
+      }
+      // Replayed as a stream of one chunk, the complete message.
+      user_callback(*std::move(response));
+      user_callback(Message(JsonMessage()));
+      return absl::OkStatus();
+    }
+  }
+
+  ASSIGN_OR_RETURN(auto decode_config, CreateDecodeConfig());
+
+  std::shared_ptr<InFlightResponse> in_flight;
+  absl::AnyInvocable<void(const Message&)> complete_in_flight;
+  if (response_key.has_value() && IsDeterministic(config_.GetSessionConfig())) {
+    // Subscribes to the identical request in flight, if any.
+    auto shared_callback =
+        std::make_shared<absl::AnyInvocable<void(absl::StatusOr<Message>)>>(
+            std::move(user_callback));
+    const size_t prefilled_history_size =
+        prompt.size() - single_turn_text.size();
+    if (config_.GetResponseCache()->SubscribeOrStart(
+            *response_key,
+            {.chunk_callback =
+                 [shared_callback](const Message& chunk) {
+                   (*shared_callback)(chunk);
+                 },
+             .done_callback =
+                 [this, shared_callback, prefilled_history_size](
+                     absl::StatusOr<Message> response) {
+                   if (!response.ok()) {
+                     (*shared_callback)(response.status());
+                     return;
+                   }
+                   {
+                     absl::MutexLock lock(this->history_mutex_);  // NOLINT
+                     this->prefilled_history_size_ = prefilled_history_size;
+                     this->history_.Append(*response);
+                   }
+                   (*shared_callback)(Message(JsonMessage()));
+                 },
+             .owner = this})) {
+      return absl::OkStatus();
+    }
+    // Publishes the chunks to the subscribers until the request is finished
+    // with the complete message, or with its error. Finished on every path,
+    // when the callbacks are dropped at the latest.
+    in_flight = std::make_shared<InFlightResponse>(
+        config_.GetSharedResponseCache(), *response_key);
+    user_callback = [in_flight, shared_callback](
+                        absl::StatusOr<Message> message) {
+      if (message.ok()) {
+        in_flight->Publish(*message);
+      } else {
+        in_flight->Finish(message.status());
+      }
+      (*shared_callback)(std::move(message));
+    };
+    complete_in_flight = [in_flight](const Message& complete_message) {
+      in_flight->Finish(complete_message);
+    };
+  }
+
   absl::AnyInvocable<void(Message)> complete_message_callback =
-      [this](const Message& complete_message) {
-        absl::MutexLock lock(this->history_mutex_);  // NOLINT
-        this->history_.push_back(complete_message);
+      [this, response_key, complete_in_flight = std::move(complete_in_flight)](
+          const Message& complete_message) mutable {
+        {
+          absl::MutexLock lock(this->history_mutex_);  // NOLINT
+          this->history_.Append(this->ToHistoryMessage(complete_message));
+        }
+        if (response_key.has_value()) {
+          this->config_.GetResponseCache()->Insert(*response_key,
+                                                   complete_message);
+        }
+        if (complete_in_flight) {
+          complete_in_flight(complete_message);
+        }
       };
 
   absl::AnyInvocable<void()> cancel_callback = [this]() {
     absl::MutexLock lock(&this->history_mutex_);  // NOLINT
-    this->history_.pop_back();
+    this->history_.RemoveLast();
+    this->InvalidateHistoryTemplateInput();
   };
 
   absl::AnyInvocable<void(absl::StatusOr<Responses>)> internal_callback =
@@ -293,9 +864,19 @@ absl::Status Conversation::SendMessageAsync(
           std::move(user_callback), std::move(cancel_callback),
           std::move(complete_message_callback));
 
-  ASSIGN_OR_RETURN(auto decode_config, CreateDecodeConfig());
-  RETURN_IF_ERROR(session_->GenerateContentStream(
-      session_inputs, std::move(internal_callback), decode_config));
+  if (absl::Status status = session_->GenerateContentStream(
+          std::move(session_inputs), std::move(internal_callback),
+          decode_config);
+      !status.ok()) {
+    if (in_flight != nullptr) {
+      in_flight->Finish(status);
+    }
+    return status;
+  }
+  {
+    absl::MutexLock lock(history_mutex_);  // NOLINT
+    prefilled_history_size_.reset();
+  }
   return absl::OkStatus();
 };
 
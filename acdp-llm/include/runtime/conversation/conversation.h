@@ -15,6 +15,8 @@
 #ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_CONVERSATION_H_
 #define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_CONVERSATION_H_
 
+#include <cstddef>
+#include <deque>
 #include <memory>
 #include <optional>
 #include <string>
@@ -25,15 +27,20 @@
 #include "absl/functional/any_invocable.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
 #include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "nlohmann/json.hpp"  // from @nlohmann_json
 #include "runtime/components/constrained_decoding/constraint.h"
 #include "runtime/components/prompt_template.h"
 #include "runtime/conversation/io_types.h"
+#include "runtime/conversation/message_history.h"
 #include "runtime/conversation/model_data_processor/config_registry.h"
 #include "runtime/conversation/model_data_processor/model_data_processor.h"
+#include "runtime/conversation/response_cache.h"
 #include "runtime/engine/engine.h"
 #include "runtime/engine/engine_settings.h"
 #include "runtime/engine/io_types.h"
+#include "runtime/framework/threadpool.h"
 
 namespace litert::lm {
 
@@ -90,19 +97,82 @@ class ConversationConfig {
   // Returns the Preface used for creating the ConversationConfig.
   const Preface& GetPreface() const { return preface_; }
 
-  // Returns the PromptTemplate used for creating the ConversationConfig.
-  const PromptTemplate& GetPromptTemplate() const { return prompt_template_; }
+  // Returns the PromptTemplate used for creating the ConversationConfig. The
+  // template is shared with the other configs of the same template source.
+  const PromptTemplate& GetPromptTemplate() const { return *prompt_template_; }
 
   // Returns the DataProcessorConfig used for creating the ConversationConfig.
   const DataProcessorConfig& GetProcessorConfig() const {
     return processor_config_;
   }
 
+  // Enables the response cache for the conversations created with the
+  // config: the responses to the text turns already answered are served from
+  // `response_cache` without running the model. `model_id` tells the models
+  // apart in the cache keys, e.g. the model path, when the cache is shared by
+  // several engines. With greedy sampling or a fixed seed, the turns
+  // identical to one being answered wait for its response instead of running
+  // the model again. The cache is disabled by default.
+  void SetResponseCache(std::shared_ptr<ResponseCache> response_cache,
+                        std::string model_id) {
+    response_cache_ = std::move(response_cache);
+    response_cache_model_id_ = std::move(model_id);
+  }
+
+  // Returns the response cache of the conversations, nullptr if disabled.
+  ResponseCache* GetResponseCache() const { return response_cache_.get(); }
+
+  // Returns the ownership of the response cache shared with the
+  // conversations, nullptr if disabled.
+  const std::shared_ptr<ResponseCache>& GetSharedResponseCache() const {
+    return response_cache_;
+  }
+
+  // Prepares the inputs of the messages sent with SendMessageAsync() on
+  // `pool` instead of the caller thread: the rendering of the prompt
+  // template, and the loading and preprocessing of the text, images and
+  // audios. The caller gets back to its next request right away, so the
+  // preparation of the next messages overlaps with the decode of the
+  // current ones. The pool can be shared by many conversations. Disabled by
+  // default.
+  void SetInputPreparationPool(std::shared_ptr<ThreadPool> pool) {
+    input_preparation_pool_ = std::move(pool);
+  }
+
+  // Returns the pool preparing the inputs of the messages, nullptr if they
+  // are prepared on the caller thread.
+  ThreadPool* GetInputPreparationPool() const {
+    return input_preparation_pool_.get();
+  }
+
+  // Caps the reasoning of the thinking models in the conversations created
+  // with the config, see DecodeConfig::ReasoningBudgetOptions. The markers of
+  // the reasoning are taken from the processor config of the model when it
+  // has some. When `options` strips the reasoning, it is also dropped from the
+  // history, while the messages returned keep it. Disabled by default.
+  void SetReasoningBudgetOptions(
+      std::optional<DecodeConfig::ReasoningBudgetOptions> options) {
+    reasoning_budget_options_ = std::move(options);
+  }
+
+  // Returns the reasoning budget options of the conversations, std::nullopt
+  // if the reasoning is not capped.
+  const std::optional<DecodeConfig::ReasoningBudgetOptions>&
+  GetReasoningBudgetOptions() const {
+    return reasoning_budget_options_;
+  }
+
+  // Returns the id of the model in the response cache keys.
+  const std::string& GetResponseCacheModelId() const {
+    return response_cache_model_id_;
+  }
+
  private:
-  explicit ConversationConfig(SessionConfig session_config, Preface preface,
-                              PromptTemplate prompt_template,
-                              DataProcessorConfig processor_config
-                              )
+  explicit ConversationConfig(
+      SessionConfig session_config, Preface preface,
+      std::shared_ptr<const PromptTemplate> prompt_template,
+      DataProcessorConfig processor_config
+      )
       : session_config_(std::move(session_config)),
         preface_(std::move(preface)),
         prompt_template_(std::move(prompt_template)),
@@ -111,8 +181,13 @@ class ConversationConfig {
 
   SessionConfig session_config_;
   Preface preface_;
-  PromptTemplate prompt_template_;
+  std::shared_ptr<const PromptTemplate> prompt_template_;
   DataProcessorConfig processor_config_;
+  std::shared_ptr<ResponseCache> response_cache_;
+  std::string response_cache_model_id_;
+  std::shared_ptr<ThreadPool> input_preparation_pool_;
+  std::optional<DecodeConfig::ReasoningBudgetOptions>
+      reasoning_budget_options_;
 };
 
 // A multi-turn centric stateful Conversation API for high-level user
@@ -167,6 +242,10 @@ class Conversation {
   static absl::StatusOr<std::unique_ptr<Conversation>> Create(
       const Engine& engine, const ConversationConfig& config);
 
+  // Waits for the preparations of the messages still on the input preparation
+  // pool, if any.
+  ~Conversation();
+
   // Sends a message to the LLM and returns the complete message.
   // Args:
   // - `message`: The message to be sent to the LLM. If `message` is an array,
@@ -196,46 +275,83 @@ class Conversation {
   //      with absl::CancelledError.
   //    - When an error occurs, the user_callback will be invoked with the error
   //      status.
+  //    When the response is served from the response cache, the user_callback
+  //    is invoked with the whole message, then with the empty message, before
+  //    this method returns.
   // - `args`: The optional arguments for the corresponding model data
   //    processor. Most of the time, the users don't need to provide this
   //    argument.
   // Returns :
   // - absl::OkStatus if the message is sent and processing successfully,
   //   otherwise the error status.
+  //   With the input preparation pool of the config, the method returns once
+  //   the message is queued for its preparation, and the errors of the
+  //   preparation are reported to the user_callback. The messages are still
+  //   sent in order.
   absl::Status SendMessageAsync(
       const Message& message,
       absl::AnyInvocable<void(absl::StatusOr<Message>)> user_callback,
       std::optional<DataProcessorArguments> args = std::nullopt);
 
+  // Returns the token ids prefilled for `message` as the next message of the
+  // conversation: the rendering of its turn by the prompt template,
+  // tokenized by the session. Changes nothing, the message is not sent. Only
+  // text messages are supported. The ids stay valid until the history
+  // changes, i.e. until the message is sent or the pending response is done.
+  absl::StatusOr<std::vector<int>> TokenizeMessage(const Message& message);
+
+  // Same as SendMessage() and SendMessageAsync(), but prefills `token_ids`,
+  // returned by TokenizeMessage() for `message`, instead of rendering and
+  // tokenizing the message again, e.g. when a router already tokenized it.
+  // `message` is only added to the history. The response cache is bypassed.
+  absl::StatusOr<Message> SendTokenizedMessage(const Message& message,
+                                               std::vector<int> token_ids);
+  absl::Status SendTokenizedMessageAsync(
+      const Message& message, std::vector<int> token_ids,
+      absl::AnyInvocable<void(absl::StatusOr<Message>)> user_callback);
+
   // Returns the history of the conversation.
-  // Note: the return value is a copy of the history, which may be expensive
-  // for large history.
-  std::vector<Message> GetHistory() const {
+  // Note: the return value is a snapshot sharing the messages with the
+  // conversation, which stays unchanged as the conversation goes on. It is
+  // cheap to take and to copy regardless of the size of the history.
+  MessageHistory GetHistory() const {
     absl::MutexLock lock(&history_mutex_);  // NOLINT
-    return history_;
+    return history_.Snapshot();
   }
 
-  // Provides safe access to the conversation history without copying.
-  // The provided visitor function is executed while the history mutex is held.
+  // Provides access to a snapshot of the conversation history, see
+  // GetHistory(). The provided visitor function is executed while the history
+  // mutex is held.
   // Args:
-  // - visitor: The visitor function takes a const reference to the history
-  //  vector.
+  // - visitor: The visitor function takes a const reference to the history.
   //
   // Example usage:
   //
   //   Message assistant_message;
   //   conversation->AccessHistory(
-  //       [&assistant_message](const std::vector<Message>& history) {
-  //         // Copy the last message to assistant_message. So we don't need to
-  //         // copy the whole history, if we only need the last message.
+  //       [&assistant_message](const MessageHistory& history) {
+  //         // Copy the last message to assistant_message.
   //         assistant_message = history.back();
   //       });
-  void AccessHistory(absl::AnyInvocable<void(const std::vector<Message>&) const>
-                         visitor) const {
+  void AccessHistory(
+      absl::AnyInvocable<void(const MessageHistory&) const> visitor) const {
     absl::MutexLock lock(&history_mutex_);  // NOLINT
-    visitor(history_);
+    visitor(history_.Snapshot());
   }
 
+  // Creates a conversation continuing from the current state of this one, see
+  // Engine::Session::Fork(). Both conversations continue independently. The
+  // child shares the messages of the history so far with the parent, and
+  // starts from the prompt template inputs and rendering cached by it, so
+  // that neither the history nor the context is replayed. Must not be called
+  // while a message is being processed.
+  absl::StatusOr<std::unique_ptr<Conversation>> Fork();
+
+  // Creates `num_children` forks of the conversation, e.g. to explore several
+  // continuations of the same context.
+  absl::StatusOr<std::vector<std::unique_ptr<Conversation>>> Fork(
+      int num_children);
+
   // Returns the configuration used for creating the Conversation.
   const ConversationConfig& GetConfig() const { return config_; }
 
@@ -254,27 +370,116 @@ class Conversation {
   explicit Conversation(
       std::unique_ptr<Engine::Session> session,
       std::unique_ptr<ModelDataProcessor> model_data_processor, Preface preface,
-      PromptTemplate prompt_template, ConversationConfig config)
+      ConversationConfig config)
       : session_(std::move(session)),
         model_data_processor_(std::move(model_data_processor)),
         preface_(preface),
-        prompt_template_(std::move(prompt_template)),
-        config_(config) {}
+        config_(config),
+        prompt_template_(config_.GetPromptTemplate()) {}
+
+  // Returns the text of `message` rendered with the prompt template after the
+  // preface and the history. The template inputs of the preface and the
+  // history messages, and the rendering of the history, are cached across
+  // the turns, so that a turn only converts its new messages. The text
+  // starts with the turns served from the response cache since the last
+  // prefill, which the session has not seen yet. If `prompt` is not null, it
+  // receives the whole rendering, preface and history included.
+  absl::StatusOr<std::string> GetSingleTurnText(const Message& message,
+                                                std::string* prompt = nullptr);
 
-  absl::StatusOr<std::string> GetSingleTurnText(const Message& message) const;
+  // Returns the key of the response to `prompt` in the response cache, or
+  // std::nullopt if the response cache is disabled or the turn is not
+  // cacheable: the key only covers the text, so the turns with non-text
+  // inputs or processor arguments are not cached.
+  std::optional<size_t> GetResponseCacheKey(
+      absl::string_view prompt, const std::vector<InputData>& session_inputs,
+      const std::optional<DataProcessorArguments>& args) const;
+
+  // Converts the history messages added since the last call into
+  // `history_tmpl_input_`.
+  absl::Status UpdateHistoryTemplateInput()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(history_mutex_);
+
+  // Drops the cached template input, after the history lost a message.
+  void InvalidateHistoryTemplateInput()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(history_mutex_);
 
   absl::StatusOr<DecodeConfig> CreateDecodeConfig();
 
+  // Decodes the response to the turn prefilled into the session.
+  absl::StatusOr<Message> DecodeMessage(
+      const std::optional<DataProcessorArguments>& args);
+
+  // Returns the inputs of the session prefilling `token_ids`.
+  absl::StatusOr<std::vector<InputData>> TokenIdsToSessionInputs(
+      std::vector<int> token_ids) const;
+
+  // Adds `message`, a message or an array of messages, to the history.
+  void AppendToHistory(const Message& message)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(history_mutex_);
+
+  // Sends the tokenized message on the calling thread, see
+  // SendTokenizedMessageAsync().
+  absl::Status SendTokenizedMessageAsyncInternal(
+      const Message& message, std::vector<int> token_ids,
+      absl::AnyInvocable<void(absl::StatusOr<Message>)> user_callback);
+
+  // Returns `message`, the response of the model, as kept in the history:
+  // without its reasoning if the reasoning budget strips it.
+  Message ToHistoryMessage(const Message& message) const;
+
+  // Prepares the inputs of `message` and sends them to the session, on the
+  // calling thread.
+  absl::Status PrepareAndSendMessageAsync(
+      const Message& message,
+      absl::AnyInvocable<void(absl::StatusOr<Message>)> user_callback,
+      std::optional<DataProcessorArguments> args);
+
+  // Queues `preparation` to run on the input preparation pool after the
+  // preparations queued before it.
+  absl::Status SchedulePreparation(absl::AnyInvocable<void()> preparation);
+
+  // Runs the queued preparations, on the input preparation pool.
+  void RunPreparations();
+
   std::unique_ptr<Engine::Session> session_;
   std::unique_ptr<ModelDataProcessor> model_data_processor_;
   Preface preface_;
-  PromptTemplate prompt_template_;
   // The constraint is currently created from the tools defined in the preface,
-  // if any.
-  std::unique_ptr<Constraint> constraint_;
+  // if any, and shared with the conversations using the same tools.
+  std::shared_ptr<Constraint> constraint_;
   const ConversationConfig config_;
+  // The template of `config_`, shared with the other conversations.
+  const PromptTemplate& prompt_template_;
   mutable absl::Mutex history_mutex_;
-  std::vector<Message> history_ ABSL_GUARDED_BY(history_mutex_);
+  // The messages of the history, each stored once and shared with the
+  // snapshots returned by GetHistory().
+  MessageHistoryBuilder history_ ABSL_GUARDED_BY(history_mutex_);
+  // The tools of the preface formatted by the processor, shared with the
+  // conversations using the same tools.
+  std::shared_ptr<const nlohmann::ordered_json> formatted_tools_
+      ABSL_GUARDED_BY(history_mutex_);
+  // The template input of the preface and of the first
+  // `num_converted_history_messages_` messages of the history.
+  std::optional<PromptTemplateInput> history_tmpl_input_
+      ABSL_GUARDED_BY(history_mutex_);
+  size_t num_converted_history_messages_ ABSL_GUARDED_BY(history_mutex_) = 0;
+  // The rendering of `history_tmpl_input_` without the generation prompt.
+  // std::nullopt until rendered.
+  std::optional<std::string> rendered_history_ ABSL_GUARDED_BY(history_mutex_);
+  // The size of the rendering the session has prefilled, when the last turns
+  // were served from the response cache. These turns are prefilled with the
+  // next turn run by the session. std::nullopt when the session is up to
+  // date.
+  std::optional<size_t> prefilled_history_size_
+      ABSL_GUARDED_BY(history_mutex_);
+  absl::Mutex preparation_mutex_;
+  // The preparations of the messages sent, run one at a time so that the
+  // messages reach the session in order.
+  std::deque<absl::AnyInvocable<void()>> pending_preparations_
+      ABSL_GUARDED_BY(preparation_mutex_);
+  // Whether a task of the pool is running the preparations.
+  bool preparing_ ABSL_GUARDED_BY(preparation_mutex_) = false;
 };
 }  // namespace litert::lm
 
@@ -36,10 +36,13 @@
 #include "runtime/components/prompt_template.h"
 #include "runtime/components/tokenizer.h"
 #include "runtime/conversation/io_types.h"
+#include "runtime/conversation/message_history.h"
+#include "runtime/conversation/response_cache.h"
 #include "runtime/engine/engine.h"
 #include "runtime/engine/engine_settings.h"
 #include "runtime/engine/io_types.h"
 #include "runtime/executor/executor_settings_base.h"
+#include "runtime/framework/threadpool.h"
 #include "runtime/util/test_utils.h"  // NOLINT
 
 namespace litert::lm {
@@ -97,6 +100,8 @@ class MockSession : public Engine::Session {
   MOCK_METHOD(absl::StatusOr<Responses>, RunDecode, (), (override));
   MOCK_METHOD(absl::StatusOr<Responses>, RunDecode,
               (const DecodeConfig& decode_config), (override));
+  MOCK_METHOD(absl::StatusOr<std::vector<int>>, TextToPrefillTokenIds,
+              (absl::string_view text), (override));
   MOCK_METHOD(
       absl::Status, RunDecodeAsync,
       (absl::AnyInvocable<void(absl::StatusOr<Responses>)> user_callback),
@@ -110,6 +115,7 @@ class MockSession : public Engine::Session {
   MOCK_METHOD(void, CancelProcess, (), (override));
   MOCK_METHOD(const SessionConfig&, GetSessionConfig, (), (const, override));
   MOCK_METHOD(const Tokenizer&, GetTokenizer, (), (const, override));
+  MOCK_METHOD(absl::StatusOr<std::unique_ptr<Session>>, Fork, (), (override));
 };
 
 class MockEngine : public Engine {
@@ -315,6 +321,313 @@ TEST(ConversationTest, SendSingleMessage) {
               testing::ElementsAre(user_message, assistant_message));
 }
 
+TEST(ConversationTest, ForkContinuesFromTheParent) {
+  auto parent_session = std::make_unique<MockSession>();
+  MockSession* parent_session_ptr = parent_session.get();
+  auto child_session = std::make_unique<MockSession>();
+  MockSession* child_session_ptr = child_session.get();
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.SetStartTokenId(0);
+  session_config.GetMutableStopTokenIds().push_back({1});
+  *session_config.GetMutableLlmModelType().mutable_gemma3() = {};
+  session_config.GetMutableJinjaPromptTemplate() = kTestJinjaPromptTemplate;
+  auto mock_tokenizer = std::make_unique<MockTokenizer>();
+  for (MockSession* mock_session_ptr :
+       {parent_session_ptr, child_session_ptr}) {
+    EXPECT_CALL(*mock_session_ptr, GetSessionConfig())
+        .WillRepeatedly(testing::ReturnRef(session_config));
+    EXPECT_CALL(*mock_session_ptr, GetTokenizer())
+        .WillRepeatedly(testing::ReturnRef(*mock_tokenizer));
+  }
+  EXPECT_CALL(*parent_session_ptr, Fork())
+      .WillOnce(testing::Return(std::move(child_session)));
+
+  auto mock_engine = std::make_unique<MockEngine>();
+  EXPECT_CALL(*mock_engine, CreateSession(testing::_))
+      .WillOnce(testing::Return(std::move(parent_session)));
+  ASSERT_OK_AND_ASSIGN(auto model_assets,
+                       ModelAssets::Create(GetTestdataPath(kTestLlmPath)));
+  ASSERT_OK_AND_ASSIGN(auto engine_settings, EngineSettings::CreateDefault(
+                                                 model_assets, Backend::CPU));
+  EXPECT_CALL(*mock_engine, GetEngineSettings())
+      .WillRepeatedly(testing::ReturnRef(engine_settings));
+  ASSERT_OK_AND_ASSIGN(auto conversation_config,
+                       ConversationConfig::CreateFromSessionConfig(
+                           *mock_engine, session_config));
+  ASSERT_OK_AND_ASSIGN(auto conversation,
+                       Conversation::Create(*mock_engine, conversation_config));
+
+  JsonMessage user_message = {{"role", "user"}, {"content", "How are you?"}};
+  EXPECT_CALL(*parent_session_ptr, RunPrefill(testing::_))
+      .WillOnce(testing::Return(absl::OkStatus()));
+  EXPECT_CALL(*parent_session_ptr, RunDecode(testing::_))
+      .WillOnce(
+          testing::Return(Responses(TaskState::kProcessing, {"I am good."})));
+  ASSERT_OK_AND_ASSIGN(const Message response,
+                       conversation->SendMessage(user_message));
+
+  ASSERT_OK_AND_ASSIGN(auto child, conversation->Fork());
+  EXPECT_EQ(&child->GetHistory()[0], &conversation->GetHistory()[0]);
+
+  // The child only prefills its new turn, the context is forked.
+  JsonMessage next_user_message = {{"role", "user"}, {"content", "foo"}};
+  EXPECT_CALL(
+      *child_session_ptr,
+      RunPrefill(testing::ElementsAre(testing::VariantWith<InputText>(
+          testing::Property(
+              &InputText::GetRawTextString,
+              testing::AllOf(
+                  testing::Not(testing::HasSubstr("How are you?")),
+                  testing::EndsWith("<start_of_turn>user\n"
+                                    "foo<end_of_turn>\n")))))))
+      .WillOnce(testing::Return(absl::OkStatus()));
+  EXPECT_CALL(*child_session_ptr, RunDecode(testing::_))
+      .WillOnce(testing::Return(Responses(TaskState::kProcessing, {"bar"})));
+  ASSERT_OK_AND_ASSIGN(const Message child_response,
+                       child->SendMessage(next_user_message));
+
+  EXPECT_THAT(child->GetHistory(),
+              testing::ElementsAre(user_message, std::get<JsonMessage>(response),
+                                   next_user_message,
+                                   std::get<JsonMessage>(child_response)));
+  EXPECT_THAT(conversation->GetHistory(),
+              testing::ElementsAre(user_message,
+                                   std::get<JsonMessage>(response)));
+}
+
+TEST(ConversationTest, SendMessageWithResponseCache) {
+  // Set up two mock Sessions.
+  auto mock_session_1 = std::make_unique<MockSession>();
+  MockSession* mock_session_1_ptr = mock_session_1.get();
+  auto mock_session_2 = std::make_unique<MockSession>();
+  MockSession* mock_session_2_ptr = mock_session_2.get();
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.SetStartTokenId(0);
+  session_config.GetMutableStopTokenIds().push_back({1});
+  *session_config.GetMutableLlmModelType().mutable_gemma3() = {};
+  session_config.GetMutableJinjaPromptTemplate() = kTestJinjaPromptTemplate;
+  auto mock_tokenizer = std::make_unique<MockTokenizer>();
+  for (MockSession* mock_session_ptr :
+       {mock_session_1_ptr, mock_session_2_ptr}) {
+    EXPECT_CALL(*mock_session_ptr, GetSessionConfig())
+        .WillRepeatedly(testing::ReturnRef(session_config));
+    EXPECT_CALL(*mock_session_ptr, GetTokenizer())
+        .WillRepeatedly(testing::ReturnRef(*mock_tokenizer));
+  }
+
+  // Set up mock Engine.
+  auto mock_engine = std::make_unique<MockEngine>();
+  EXPECT_CALL(*mock_engine, CreateSession(testing::_))
+      .WillOnce(testing::Return(std::move(mock_session_1)))
+      .WillOnce(testing::Return(std::move(mock_session_2)));
+  ASSERT_OK_AND_ASSIGN(auto model_assets,
+                       ModelAssets::Create(GetTestdataPath(kTestLlmPath)));
+  ASSERT_OK_AND_ASSIGN(auto engine_settings, EngineSettings::CreateDefault(
+                                                 model_assets, Backend::CPU));
+  EXPECT_CALL(*mock_engine, GetEngineSettings())
+      .WillRepeatedly(testing::ReturnRef(engine_settings));
+
+  // Create two Conversations sharing a response cache.
+  ASSERT_OK_AND_ASSIGN(auto conversation_config,
+                       ConversationConfig::CreateFromSessionConfig(
+                           *mock_engine, session_config));
+  auto response_cache = std::make_shared<ResponseCache>(
+      ResponseCache::kDefaultMaxNumEntries, ResponseCache::kDefaultTtl);
+  conversation_config.SetResponseCache(response_cache,
+                                       std::string(kTestLlmPath));
+  ASSERT_OK_AND_ASSIGN(auto conversation_1,
+                       Conversation::Create(*mock_engine, conversation_config));
+  ASSERT_OK_AND_ASSIGN(auto conversation_2,
+                       Conversation::Create(*mock_engine, conversation_config));
+
+  // The first conversation runs the model and fills the cache.
+  JsonMessage user_message = {{"role", "user"}, {"content", "How are you?"}};
+  EXPECT_CALL(*mock_session_1_ptr, RunPrefill(testing::_))
+      .WillOnce(testing::Return(absl::OkStatus()));
+  EXPECT_CALL(*mock_session_1_ptr, RunDecode(testing::_))
+      .WillOnce(
+          testing::Return(Responses(TaskState::kProcessing, {"I am good."})));
+  ASSERT_OK_AND_ASSIGN(const Message response_1,
+                       conversation_1->SendMessage(user_message));
+  EXPECT_EQ(response_cache->GetNumEntries(), 1);
+
+  // The second conversation is served from the cache.
+  EXPECT_CALL(*mock_session_2_ptr, RunPrefill(testing::_)).Times(0);
+  ASSERT_OK_AND_ASSIGN(const Message response_2,
+                       conversation_2->SendMessage(user_message));
+  EXPECT_EQ(response_2, response_1);
+  EXPECT_EQ(response_cache->GetNumHits(), 1);
+  EXPECT_THAT(conversation_2->GetHistory(),
+              testing::ElementsAre(user_message, std::get<JsonMessage>(
+                                                     response_1)));
+
+  // The next turn of the second conversation prefills the turn served from
+  // the cache too.
+  JsonMessage next_user_message = {{"role", "user"}, {"content", "foo"}};
+  EXPECT_CALL(
+      *mock_session_2_ptr,
+      RunPrefill(testing::ElementsAre(testing::VariantWith<InputText>(
+          testing::Property(
+              &InputText::GetRawTextString,
+              testing::AllOf(
+                  testing::StartsWith("<start_of_turn>user\n"
+                                      "How are you?<end_of_turn>\n"),
+                  testing::HasSubstr("I am good."),
+                  testing::EndsWith("<start_of_turn>user\n"
+                                    "foo<end_of_turn>\n")))))))
+      .WillOnce(testing::Return(absl::OkStatus()));
+  EXPECT_CALL(*mock_session_2_ptr, RunDecode(testing::_))
+      .WillOnce(testing::Return(Responses(TaskState::kProcessing, {"bar"})));
+  ASSERT_OK(conversation_2->SendMessage(next_user_message));
+  EXPECT_EQ(response_cache->GetNumEntries(), 2);
+}
+
+TEST(ConversationTest, SendMessageAsyncCoalescesIdenticalRequestsInFlight) {
+  // Set up two mock Sessions with greedy sampling.
+  auto mock_session_1 = std::make_unique<MockSession>();
+  MockSession* mock_session_1_ptr = mock_session_1.get();
+  auto mock_session_2 = std::make_unique<MockSession>();
+  MockSession* mock_session_2_ptr = mock_session_2.get();
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.SetStartTokenId(0);
+  session_config.GetMutableStopTokenIds().push_back({1});
+  *session_config.GetMutableLlmModelType().mutable_gemma3() = {};
+  session_config.GetMutableJinjaPromptTemplate() = kTestJinjaPromptTemplate;
+  session_config.GetMutableSamplerParams().set_type(
+      proto::SamplerParameters::GREEDY);
+  auto mock_tokenizer = std::make_unique<MockTokenizer>();
+  for (MockSession* mock_session_ptr :
+       {mock_session_1_ptr, mock_session_2_ptr}) {
+    EXPECT_CALL(*mock_session_ptr, GetSessionConfig())
+        .WillRepeatedly(testing::ReturnRef(session_config));
+    EXPECT_CALL(*mock_session_ptr, GetTokenizer())
+        .WillRepeatedly(testing::ReturnRef(*mock_tokenizer));
+  }
+
+  // Set up mock Engine.
+  auto mock_engine = std::make_unique<MockEngine>();
+  EXPECT_CALL(*mock_engine, CreateSession(testing::_))
+      .WillOnce(testing::Return(std::move(mock_session_1)))
+      .WillOnce(testing::Return(std::move(mock_session_2)));
+  ASSERT_OK_AND_ASSIGN(auto model_assets,
+                       ModelAssets::Create(GetTestdataPath(kTestLlmPath)));
+  ASSERT_OK_AND_ASSIGN(auto engine_settings, EngineSettings::CreateDefault(
+                                                 model_assets, Backend::CPU));
+  EXPECT_CALL(*mock_engine, GetEngineSettings())
+      .WillRepeatedly(testing::ReturnRef(engine_settings));
+
+  // Create two Conversations sharing a response cache without entry budget,
+  // which only coalesces the requests.
+  ASSERT_OK_AND_ASSIGN(auto conversation_config,
+                       ConversationConfig::CreateFromSessionConfig(
+                           *mock_engine, session_config));
+  auto response_cache = std::make_shared<ResponseCache>(
+      /*max_num_entries=*/0, ResponseCache::kDefaultTtl);
+  conversation_config.SetResponseCache(response_cache,
+                                       std::string(kTestLlmPath));
+  ASSERT_OK_AND_ASSIGN(auto conversation_1,
+                       Conversation::Create(*mock_engine, conversation_config));
+  ASSERT_OK_AND_ASSIGN(auto conversation_2,
+                       Conversation::Create(*mock_engine, conversation_config));
+
+  // The first conversation runs the model, which responds once the second
+  // conversation sent the same message.
+  absl::AnyInvocable<void(absl::StatusOr<Responses>)> model_callback;
+  EXPECT_CALL(*mock_session_1_ptr,
+              GenerateContentStream(testing::_, testing::_, testing::_))
+      .WillOnce(
+          [&model_callback](
+              const std::vector<InputData>& contents,
+              absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
+              const DecodeConfig& decode_config) {
+            model_callback = std::move(callback);
+            return absl::OkStatus();
+          });
+  EXPECT_CALL(*mock_session_2_ptr,
+              GenerateContentStream(testing::_, testing::_, testing::_))
+      .Times(0);
+
+  JsonMessage user_message = {{"role", "user"}, {"content", "How are you?"}};
+  Message assistant_message_1 =
+      JsonMessage(nlohmann::ordered_json::parse(R"json({
+    "role": "assistant",
+    "content": [{"type": "text", "text": "I am good."}]
+  })json"));
+  Message assistant_message_2 = assistant_message_1;
+  absl::Notification done_1;
+  absl::Notification done_2;
+  EXPECT_OK(conversation_1->SendMessageAsync(
+      user_message, CreateTestMessageCallback(assistant_message_1, done_1)));
+  EXPECT_OK(conversation_2->SendMessageAsync(
+      user_message, CreateTestMessageCallback(assistant_message_2, done_2)));
+  EXPECT_EQ(response_cache->GetNumCoalesced(), 1);
+
+  ASSERT_NE(model_callback, nullptr);
+  model_callback(Responses(TaskState::kProcessing, {"I am good."}));
+  model_callback(Responses(TaskState::kDone));
+  done_1.WaitForNotification();
+  done_2.WaitForNotification();
+  EXPECT_EQ(conversation_2->GetHistory().size(), 2);
+}
+
+TEST(ConversationTest, SendTokenizedMessage) {
+  // Set up mock Session.
+  auto mock_session = std::make_unique<MockSession>();
+  MockSession* mock_session_ptr = mock_session.get();
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.SetStartTokenId(0);
+  session_config.GetMutableStopTokenIds().push_back({1});
+  *session_config.GetMutableLlmModelType().mutable_gemma3() = {};
+  session_config.GetMutableJinjaPromptTemplate() = kTestJinjaPromptTemplate;
+  EXPECT_CALL(*mock_session_ptr, GetSessionConfig())
+      .WillRepeatedly(testing::ReturnRef(session_config));
+  auto mock_tokenizer = std::make_unique<MockTokenizer>();
+  EXPECT_CALL(*mock_session_ptr, GetTokenizer())
+      .WillRepeatedly(testing::ReturnRef(*mock_tokenizer));
+
+  // Set up mock Engine.
+  auto mock_engine = std::make_unique<MockEngine>();
+  EXPECT_CALL(*mock_engine, CreateSession(testing::_))
+      .WillOnce(testing::Return(std::move(mock_session)));
+  ASSERT_OK_AND_ASSIGN(auto model_assets,
+                       ModelAssets::Create(GetTestdataPath(kTestLlmPath)));
+  ASSERT_OK_AND_ASSIGN(auto engine_settings, EngineSettings::CreateDefault(
+                                                 model_assets, Backend::CPU));
+  EXPECT_CALL(*mock_engine, GetEngineSettings())
+      .WillRepeatedly(testing::ReturnRef(engine_settings));
+
+  // Create Conversation.
+  ASSERT_OK_AND_ASSIGN(auto conversation_config,
+                       ConversationConfig::CreateFromSessionConfig(
+                           *mock_engine, session_config));
+  ASSERT_OK_AND_ASSIGN(auto conversation,
+                       Conversation::Create(*mock_engine, conversation_config));
+
+  // The message is tokenized from its rendered turn, without being sent.
+  JsonMessage user_message = {{"role", "user"}, {"content", "How are you?"}};
+  EXPECT_CALL(*mock_session_ptr,
+              TextToPrefillTokenIds(testing::HasSubstr("How are you?")))
+      .WillOnce(testing::Return(std::vector<int>{2, 90, 547}));
+  ASSERT_OK_AND_ASSIGN(std::vector<int> token_ids,
+                       conversation->TokenizeMessage(user_message));
+  EXPECT_THAT(token_ids, testing::ElementsAre(2, 90, 547));
+  EXPECT_TRUE(conversation->GetHistory().empty());
+
+  // The token ids are prefilled as they are.
+  EXPECT_CALL(*mock_session_ptr,
+              RunPrefill(testing::ElementsAre(testing::VariantWith<InputText>(
+                  testing::Property(&InputText::IsTensorBuffer, true)))))
+      .WillOnce(testing::Return(absl::OkStatus()));
+  EXPECT_CALL(*mock_session_ptr, RunDecode(testing::_))
+      .WillOnce(
+          testing::Return(Responses(TaskState::kProcessing, {"I am good."})));
+  ASSERT_OK(conversation->SendTokenizedMessage(user_message, token_ids));
+  EXPECT_EQ(conversation->GetHistory().size(), 2);
+
+  EXPECT_THAT(conversation->SendTokenizedMessage(user_message, {}),
+              testing::status::StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 TEST(ConversationTest, SendMultipleMessages) {
   // Set up mock Session.
   auto mock_session = std::make_unique<MockSession>();
@@ -609,6 +922,88 @@ TEST(ConversationTest, SendSingleMessageAsync) {
       testing::ElementsAre(user_message, assistant_message_for_confirm));
 }
 
+TEST(ConversationTest, SendMessageAsyncWithInputPreparationPool) {
+  // Set up mock Session.
+  auto mock_session = std::make_unique<MockSession>();
+  MockSession* mock_session_ptr = mock_session.get();
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.SetStartTokenId(0);
+  session_config.GetMutableStopTokenIds().push_back({1});
+  *session_config.GetMutableLlmModelType().mutable_gemma3() = {};
+  session_config.GetMutableJinjaPromptTemplate() = kTestJinjaPromptTemplate;
+  EXPECT_CALL(*mock_session_ptr, GetSessionConfig())
+      .WillRepeatedly(testing::ReturnRef(session_config));
+  auto mock_tokenizer = std::make_unique<MockTokenizer>();
+  EXPECT_CALL(*mock_session_ptr, GetTokenizer())
+      .WillRepeatedly(testing::ReturnRef(*mock_tokenizer));
+
+  // Set up mock Engine.
+  auto mock_engine = std::make_unique<MockEngine>();
+  EXPECT_CALL(*mock_engine, CreateSession(testing::_))
+      .WillOnce(testing::Return(std::move(mock_session)));
+  ASSERT_OK_AND_ASSIGN(auto model_assets,
+                       ModelAssets::Create(GetTestdataPath(kTestLlmPath)));
+  ASSERT_OK_AND_ASSIGN(auto engine_settings, EngineSettings::CreateDefault(
+                                                 model_assets, Backend::CPU));
+  EXPECT_CALL(*mock_engine, GetEngineSettings())
+      .WillRepeatedly(testing::ReturnRef(engine_settings));
+
+  // Create Conversation, preparing its inputs on a pool.
+  ASSERT_OK_AND_ASSIGN(auto conversation_config,
+                       ConversationConfig::CreateFromSessionConfig(
+                           *mock_engine, session_config));
+  conversation_config.SetInputPreparationPool(std::make_shared<ThreadPool>(
+      /*name_prefix=*/"input_preparation", /*max_num_threads=*/2));
+  ASSERT_OK_AND_ASSIGN(auto conversation,
+                       Conversation::Create(*mock_engine, conversation_config));
+
+  // The messages reach the session in the order they were sent.
+  JsonMessage user_message_1 = {{"role", "user"}, {"content", "Hello"}};
+  JsonMessage user_message_2 = {{"role", "user"}, {"content", "Bye"}};
+  testing::InSequence sequence;
+  for (absl::string_view text : {"Hello", "Bye"}) {
+    EXPECT_CALL(*mock_session_ptr,
+                GenerateContentStream(
+                    testing::ElementsAre(testing::VariantWith<InputText>(
+                        testing::Property(&InputText::GetRawTextString,
+                                          testing::HasSubstr(text)))),
+                    testing::_, testing::_))
+        .WillOnce(
+            [](const std::vector<InputData>& contents,
+               absl::AnyInvocable<void(absl::StatusOr<Responses>)>
+                   user_callback,
+               const DecodeConfig& decode_config) {
+              user_callback(Responses(TaskState::kProcessing, {"Hi."}));
+              user_callback(Responses(TaskState::kDone));
+              return absl::OkStatus();
+            });
+  }
+
+  Message assistant_message = JsonMessage(nlohmann::ordered_json::parse(R"({
+    "role": "assistant",
+    "content": [
+      {
+        "type": "text",
+        "text": "Hi."
+      }
+    ]
+  })"));
+  Message assistant_message_1 = assistant_message;
+  Message assistant_message_2 = assistant_message;
+  absl::Notification done_1;
+  absl::Notification done_2;
+  EXPECT_OK(conversation->SendMessageAsync(
+      user_message_1, CreateTestMessageCallback(assistant_message_1, done_1)));
+  EXPECT_OK(conversation->SendMessageAsync(
+      user_message_2, CreateTestMessageCallback(assistant_message_2, done_2)));
+  done_1.WaitForNotification();
+  done_2.WaitForNotification();
+
+  EXPECT_THAT(conversation->GetHistory(),
+              testing::ElementsAre(user_message_1, assistant_message,
+                                   user_message_2, assistant_message));
+}
+
 TEST(ConversationTest, SendMultipleMessagesAsync) {
   // Set up mock Session.
   auto mock_session = std::make_unique<MockSession>();
@@ -950,7 +1345,7 @@ TEST(ConversationAccessHistoryTest, AccessHistory) {
   // Access the history with visitor function, and copy the last message.
   Message last_message;
   conversation->AccessHistory(
-      [&last_message](const std::vector<Message>& history_view) {
+      [&last_message](const MessageHistory& history_view) {
         // Copy the last message to last_message. So we don't need to
         // copy the whole history, if we only need the last message.
         last_message = history_view.back();
@@ -0,0 +1,74 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/conversation/formatted_tools_cache.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "nlohmann/json.hpp"  // from @nlohmann_json
+
+namespace litert::lm {
+
+// static
+FormattedToolsCache& FormattedToolsCache::GetDefault() {
+  static FormattedToolsCache* const cache = new FormattedToolsCache();
+  return *cache;
+}
+
+absl::StatusOr<std::shared_ptr<const nlohmann::ordered_json>>
+FormattedToolsCache::GetOrCreate(absl::string_view key, FormatToolsFn format) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (auto it = formatted_tools_.find(key); it != formatted_tools_.end()) {
+      if (std::shared_ptr<const nlohmann::ordered_json> formatted_tools =
+              it->second.lock()) {
+        return formatted_tools;
+      }
+    }
+  }
+  absl::StatusOr<nlohmann::ordered_json> formatted = format();
+  if (!formatted.ok()) {
+    return formatted.status();
+  }
+  auto formatted_tools = std::make_shared<const nlohmann::ordered_json>(
+      std::move(formatted).value());
+  absl::MutexLock lock(&mutex_);
+  // Forget the formatted tools freed since.
+  absl::erase_if(formatted_tools_, [](const auto& entry) {
+    return entry.second.expired();
+  });
+  auto [it, inserted] = formatted_tools_.try_emplace(key, formatted_tools);
+  if (!inserted) {
+    // Another conversation formatted the same tools meanwhile.
+    return it->second.lock();
+  }
+  return formatted_tools;
+}
+
+int FormattedToolsCache::GetNumFormattedTools() const {
+  absl::MutexLock lock(&mutex_);
+  int num_formatted_tools = 0;
+  for (const auto& [key, formatted_tools] : formatted_tools_) {
+    num_formatted_tools += !formatted_tools.expired();
+  }
+  return num_formatted_tools;
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,69 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_FORMATTED_TOOLS_CACHE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_FORMATTED_TOOLS_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/functional/function_ref.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "nlohmann/json.hpp"  // from @nlohmann_json
+
+namespace litert::lm {
+
+// A cache of the tools formatted for the prompt template by the model data
+// processors, shared read-only by the conversations using the same tools.
+// The tools of a preface are formatted once instead of once per conversation,
+// and again after each cancelled message.
+//
+// The cache only keeps weak references: the formatted tools are freed with the
+// last conversation using them. The cache is thread-safe.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(
+//       std::shared_ptr<const nlohmann::ordered_json> formatted_tools,
+//       FormattedToolsCache::GetDefault().GetOrCreate(key, [&]() {
+//         return processor.FormatTools(tools);
+//       }));
+class FormattedToolsCache {
+ public:
+  using FormatToolsFn =
+      absl::FunctionRef<absl::StatusOr<nlohmann::ordered_json>()>;
+
+  // Returns the process-wide cache.
+  static FormattedToolsCache& GetDefault();
+
+  // Returns the live formatted tools of `key`, or the ones formatted with
+  // `format`. The errors of `format` are returned and not cached.
+  absl::StatusOr<std::shared_ptr<const nlohmann::ordered_json>> GetOrCreate(
+      absl::string_view key, FormatToolsFn format);
+
+  // Returns the number of live formatted tools in the cache.
+  int GetNumFormattedTools() const;
+
+ private:
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::weak_ptr<const nlohmann::ordered_json>>
+      formatted_tools_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_FORMATTED_TOOLS_CACHE_H_
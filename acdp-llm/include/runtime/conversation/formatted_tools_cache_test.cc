@@ -0,0 +1,98 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/conversation/formatted_tools_cache.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "nlohmann/json.hpp"  // from @nlohmann_json
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::StatusIs;
+
+absl::StatusOr<nlohmann::ordered_json> FormatFakeTools(int* num_formatted) {
+  ++*num_formatted;
+  return nlohmann::ordered_json::array({"def tool_name(x: int)"});
+}
+
+TEST(FormattedToolsCacheTest, SharesTheFormattedToolsOfTheSameKey) {
+  FormattedToolsCache cache;
+  int num_formatted = 0;
+  ASSERT_OK_AND_ASSIGN(
+      auto formatted_tools,
+      cache.GetOrCreate("tools", [&]() {
+        return FormatFakeTools(&num_formatted);
+      }));
+  ASSERT_OK_AND_ASSIGN(
+      auto same_formatted_tools,
+      cache.GetOrCreate("tools", [&]() {
+        return FormatFakeTools(&num_formatted);
+      }));
+  ASSERT_OK_AND_ASSIGN(
+      auto other_formatted_tools,
+      cache.GetOrCreate("other tools", [&]() {
+        return FormatFakeTools(&num_formatted);
+      }));
+  EXPECT_EQ(formatted_tools, same_formatted_tools);
+  EXPECT_NE(formatted_tools, other_formatted_tools);
+  EXPECT_EQ(*formatted_tools,
+            nlohmann::ordered_json::array({"def tool_name(x: int)"}));
+  EXPECT_EQ(num_formatted, 2);
+  EXPECT_EQ(cache.GetNumFormattedTools(), 2);
+}
+
+TEST(FormattedToolsCacheTest, FreesTheFormattedToolsNoLongerUsed) {
+  FormattedToolsCache cache;
+  int num_formatted = 0;
+  {
+    ASSERT_OK_AND_ASSIGN(
+        auto formatted_tools,
+        cache.GetOrCreate("tools", [&]() {
+          return FormatFakeTools(&num_formatted);
+        }));
+    EXPECT_EQ(cache.GetNumFormattedTools(), 1);
+  }
+  EXPECT_EQ(cache.GetNumFormattedTools(), 0);
+  ASSERT_OK_AND_ASSIGN(
+      auto formatted_tools,
+      cache.GetOrCreate("tools", [&]() {
+        return FormatFakeTools(&num_formatted);
+      }));
+  EXPECT_EQ(num_formatted, 2);
+}
+
+TEST(FormattedToolsCacheTest, DoesNotCacheTheErrors) {
+  FormattedToolsCache cache;
+  EXPECT_THAT(cache.GetOrCreate(
+                  "tools",
+                  []() -> absl::StatusOr<nlohmann::ordered_json> {
+                    return absl::InvalidArgumentError("Tools must be an array.");
+                  }),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  int num_formatted = 0;
+  ASSERT_OK_AND_ASSIGN(
+      auto formatted_tools,
+      cache.GetOrCreate("tools", [&]() {
+        return FormatFakeTools(&num_formatted);
+      }));
+  EXPECT_EQ(num_formatted, 1);
+}
+
+}  // namespace
+}  // namespace litert::lm
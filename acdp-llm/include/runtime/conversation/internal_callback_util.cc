@@ -15,10 +15,10 @@
 
 #include "runtime/conversation/internal_callback_util.h"
 
-#include <algorithm>
 #include <cstddef>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/functional/any_invocable.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
@@ -33,22 +33,54 @@
 namespace litert::lm {
 namespace {
 
-// Returns the number of overlapping characters between the suffix of string
-// `a` and the prefix of string `b`.
-size_t SuffixPrefixOverlap(absl::string_view a, absl::string_view b) {
-  if (a.empty() || b.empty()) {
-    return 0;
+// Matches a code fence in a stream of characters, one character at a time,
+// with the Knuth-Morris-Pratt failure table. Each character takes amortized
+// constant work, so the text is scanned only once however it is chunked.
+class CodeFenceMatcher {
+ public:
+  explicit CodeFenceMatcher(absl::string_view fence)
+      : fence_(fence), failure_(fence.size(), 0) {
+    size_t length = 0;
+    for (size_t i = 1; i < fence_.size(); ++i) {
+      while (length > 0 && fence_[i] != fence_[length]) {
+        length = failure_[length - 1];
+      }
+      if (fence_[i] == fence_[length]) {
+        ++length;
+      }
+      failure_[i] = length;
+    }
   }
 
-  size_t max_overlap = std::min(a.length(), b.length());
-
-  for (size_t len = max_overlap; len > 0; --len) {
-    if (a.substr(a.length() - len) == b.substr(0, len)) {
-      return len;
+  // Feeds the next character. Returns true if it completes the fence, in
+  // which case the matcher starts over.
+  bool Feed(char c) {
+    if (fence_.empty()) {
+      return false;
+    }
+    while (num_matched_ > 0 && fence_[num_matched_] != c) {
+      num_matched_ = failure_[num_matched_ - 1];
+    }
+    if (fence_[num_matched_] == c) {
+      ++num_matched_;
+    }
+    if (num_matched_ == fence_.size()) {
+      num_matched_ = 0;
+      return true;
     }
+    return false;
   }
 
-  return 0;
+  // Returns the length of the longest suffix of the characters fed so far
+  // that is a prefix of the fence, i.e. a possibly split fence.
+  size_t num_matched() const { return num_matched_; }
+
+  void Reset() { num_matched_ = 0; }
+
+ private:
+  std::string fence_;
+  std::vector<size_t> failure_;
+  size_t num_matched_ = 0;
 };
 
 void SendMessage(
@@ -71,12 +103,14 @@ void SendCompleteMessage(
     absl::AnyInvocable<void(absl::StatusOr<Message>)>& user_callback,
     absl::string_view accumulated_response_text,
     const ModelDataProcessor& model_data_processor,
-    DataProcessorArguments processor_args, int cursor,
+    DataProcessorArguments processor_args, size_t cursor,
     absl::AnyInvocable<void(Message)>& complete_message_callback) {
   if (cursor < accumulated_response_text.size()) {
     SendMessage(user_callback, accumulated_response_text.substr(cursor),
                 model_data_processor, processor_args);
   }
+  // The tool calls are only parsed once here, over the whole text, while the
+  // chunks above are each parsed on their own.
   const auto& complete_message = model_data_processor.ToMessage(
       Responses(TaskState::kProcessing,
                 {std::string(accumulated_response_text)}),
@@ -103,9 +137,12 @@ absl::AnyInvocable<void(absl::StatusOr<Responses>)> CreateInternalCallback(
           user_callback = std::move(user_callback),
           cancel_callback = std::move(cancel_callback),
           complete_message_callback = std::move(complete_message_callback),
-          accumulated_response_text = std::string(), cursor = 0,
-          inside_tool_call =
-              false](absl::StatusOr<Responses> responses) mutable {
+          accumulated_response_text = std::string(), cursor = size_t{0},
+          inside_tool_call = false,
+          start_matcher =
+              CodeFenceMatcher(model_data_processor.CodeFenceStart()),
+          end_matcher = CodeFenceMatcher(model_data_processor.CodeFenceEnd())](
+             absl::StatusOr<Responses> responses) mutable {
     if (!responses.ok()) {
       // If the error is due to maximum kv-cache size reached, then we should
       // trigger the user callback with an OK status to indicate the inference
@@ -143,80 +180,60 @@ absl::AnyInvocable<void(absl::StatusOr<Responses>)> CreateInternalCallback(
         return;
       }
 
+      const size_t scan_start = accumulated_response_text.size();
       accumulated_response_text += responses->GetTexts()[0];
+      const absl::string_view text = accumulated_response_text;
 
       absl::string_view code_fence_start =
           model_data_processor.CodeFenceStart();
       absl::string_view code_fence_end = model_data_processor.CodeFenceEnd();
 
-      while (cursor < accumulated_response_text.size()) {
+      // Only the new characters are scanned, the matchers carry the partial
+      // fences over from the previous chunks.
+      for (size_t pos = scan_start; pos < text.size(); ++pos) {
         if (!inside_tool_call) {
-          size_t code_fence_start_pos =
-              accumulated_response_text.find(code_fence_start, cursor);
-          if (!code_fence_start.empty() &&
-              code_fence_start_pos != std::string::npos) {
-            // The text from the cursor up to the code fence is normal text.
-            SendMessage(user_callback,
-                        absl::string_view(accumulated_response_text)
-                            .substr(cursor, code_fence_start_pos - cursor),
-                        model_data_processor, processor_args);
-
-            // Move cursor up to code_fence_start.
-            cursor = code_fence_start_pos;
-            inside_tool_call = true;
-          } else {
-            // code_fence_start not found, but we still need to check
-            // if there's a partial match at the end of the string.
-            size_t overlap = SuffixPrefixOverlap(
-                accumulated_response_text.substr(cursor), code_fence_start);
-
-            if (overlap > 0) {
-              // There's a partial match of the code fence at the end of the
-              // string.
-              size_t possible_start_pos =
-                  accumulated_response_text.size() - overlap;
-
-              // Call the callback with text up to the potential start of the
-              // code fence.
-              SendMessage(user_callback,
-                          accumulated_response_text.substr(
-                              cursor, possible_start_pos - cursor),
-                          model_data_processor, processor_args);
-
-              // Move cursor up to potential start of code fence.
-              cursor = possible_start_pos;
-              break;
-            } else {
-              // Remaining string is text.
-              SendMessage(user_callback,
-                          accumulated_response_text.substr(cursor),
-                          model_data_processor, processor_args);
-
-              cursor = accumulated_response_text.size();
-            }
+          if (!start_matcher.Feed(text[pos])) {
+            continue;
           }
-        }
-
-        if (inside_tool_call) {
-          // Look for code fence end.
-          size_t code_fence_end_pos = accumulated_response_text.find(
-              code_fence_end, cursor + code_fence_start.size());
-          if (code_fence_end_pos != std::string::npos) {
-            SendMessage(user_callback,
-                        accumulated_response_text.substr(
-                            cursor, code_fence_end_pos + code_fence_end.size() -
-                                        cursor),
-                        model_data_processor, processor_args);
-
-            // Move cursor to end of tool code block.
-            cursor = code_fence_end_pos + code_fence_end.size();
-            inside_tool_call = false;
-          } else {
-            // We're inside a tool call but the code fence end has not been
-            // found. Break for the next token.
-            break;
+          // The text from the cursor up to the code fence is normal text.
+          const size_t code_fence_start_pos =
+              pos + 1 - code_fence_start.size();
+          SendMessage(user_callback,
+                      text.substr(cursor, code_fence_start_pos - cursor),
+                      model_data_processor, processor_args);
+
+          // Move cursor up to code_fence_start.
+          cursor = code_fence_start_pos;
+          inside_tool_call = true;
+          end_matcher.Reset();
+          if (!code_fence_end.empty()) {
+            continue;
           }
+        } else if (!end_matcher.Feed(text[pos])) {
+          // We're inside a tool call but the code fence end has not been
+          // found.
+          continue;
         }
+        SendMessage(user_callback, text.substr(cursor, pos + 1 - cursor),
+                    model_data_processor, processor_args);
+
+        // Move cursor to end of tool code block.
+        cursor = pos + 1;
+        inside_tool_call = false;
+        start_matcher.Reset();
+      }
+
+      if (!inside_tool_call) {
+        // Send the remaining text, but hold back a partial match of the code
+        // fence at the end of the string for the next chunk.
+        const size_t possible_start_pos =
+            text.size() - start_matcher.num_matched();
+        SendMessage(user_callback,
+                    text.substr(cursor, possible_start_pos - cursor),
+                    model_data_processor, processor_args);
+
+        // Move cursor up to potential start of code fence.
+        cursor = possible_start_pos;
       }
     }
   };
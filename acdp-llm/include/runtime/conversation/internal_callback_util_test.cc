@@ -15,6 +15,7 @@
 #include "runtime/conversation/internal_callback_util.h"
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -399,6 +400,32 @@ TEST_F(InternalCallbackTest, OnNextTextOnBothSidesOfSplitCodeFenceEnd) {
                                    TextMessage("text")));
 }
 
+TEST_F(InternalCallbackTest, ToolCallStreamedOneCharacterAtATime) {
+  auto user_callback = CreateUserMessageCallback(output_, done_, status_);
+  auto callback = CreateInternalCallback(
+      *model_data_processor_, processor_args_, std::move(user_callback));
+
+  for (char c : absl::string_view("Hi```tool_code\ntool_name(x=1)\n```")) {
+    callback(Responses(TaskState::kProcessing, {std::string(1, c)}));
+  }
+
+  EXPECT_THAT(output_, ElementsAre(TextMessage("H"), TextMessage("i"),
+                                   nlohmann::ordered_json::parse(R"json({
+                "role": "assistant",
+                "tool_calls": [
+                  {
+                    "type": "function",
+                    "function": {
+                      "name": "tool_name",
+                      "arguments": {
+                        "x": 1
+                      }
+                    }
+                  }
+                ]
+              })json")));
+}
+
 TEST_F(InternalCallbackTest, ParallelToolCalls) {
   auto user_callback = CreateUserMessageCallback(output_, done_, status_);
   auto callback = CreateInternalCallback(
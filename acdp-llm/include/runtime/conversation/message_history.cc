@@ -0,0 +1,76 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/conversation/message_history.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "runtime/conversation/io_types.h"
+
+namespace litert::lm {
+namespace {
+
+constexpr size_t kMinCapacity = 16;
+
+}  // namespace
+
+void MessageHistoryBuilder::Append(Message message) {
+  Append(std::make_shared<const Message>(std::move(message)));
+}
+
+void MessageHistoryBuilder::Append(std::shared_ptr<const Message> message) {
+  if (arena_ == nullptr || size_ == arena_->capacity) {
+    // Doubled, so that the appends only move the pointers to the messages
+    // a constant number of times on average.
+    Reallocate(std::max(kMinCapacity, 2 * size_));
+  } else if (!ClaimNextSlot()) {
+    Reallocate(arena_->capacity);
+  }
+  arena_->messages[size_++] = std::move(message);
+}
+
+void MessageHistoryBuilder::RemoveLast() {
+  --size_;
+  if (arena_.use_count() == 1) {
+    arena_->messages[size_].reset();
+    arena_->num_claimed = size_;
+  }
+  // Otherwise a snapshot or a fork may see the slot, the next append moves to
+  // a new arena instead of claiming it again.
+}
+
+bool MessageHistoryBuilder::ClaimNextSlot() {
+  size_t num_claimed = size_;
+  return arena_->num_claimed.compare_exchange_strong(num_claimed, size_ + 1);
+}
+
+void MessageHistoryBuilder::Reallocate(size_t capacity) {
+  // The slot of the coming append is claimed with the arena.
+  auto arena = std::make_shared<internal::MessageArena>(capacity, size_ + 1);
+  if (arena_ != nullptr) {
+    // The snapshots keep their own reference to the messages.
+    const bool shared = arena_.use_count() > 1;
+    for (size_t i = 0; i < size_; ++i) {
+      arena->messages[i] = shared ? arena_->messages[i]
+                                  : std::move(arena_->messages[i]);
+    }
+  }
+  arena_ = std::move(arena);
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,192 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MESSAGE_HISTORY_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MESSAGE_HISTORY_H_
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "runtime/conversation/io_types.h"
+
+namespace litert::lm {
+
+namespace internal {
+
+// The append-only storage of the messages of a history. The slots below the
+// size of a snapshot are never written again, so the snapshots read them
+// without a lock while the history appends to the slots above. The forks of a
+// history share the arena until they diverge: the first of them to append
+// claims the next slot, the others move to an arena of their own.
+struct MessageArena {
+  MessageArena(size_t capacity, size_t num_claimed)
+      : capacity(capacity),
+        messages(std::make_unique<std::shared_ptr<const Message>[]>(capacity)),
+        num_claimed(num_claimed) {}
+
+  const size_t capacity;
+  std::unique_ptr<std::shared_ptr<const Message>[]> messages;
+  // The number of slots claimed by the histories sharing the arena.
+  std::atomic<size_t> num_claimed;
+};
+
+}  // namespace internal
+
+// An immutable snapshot of the messages of a conversation, cheap to copy: it
+// shares the messages with the conversation instead of copying them, and
+// stays valid and unchanged while the conversation goes on.
+class MessageHistory {
+ public:
+  class const_iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = Message;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Message*;
+    using reference = const Message&;
+
+    const_iterator() = default;
+
+    reference operator*() const { return **message_; }
+    pointer operator->() const { return message_->get(); }
+    reference operator[](difference_type n) const { return *message_[n]; }
+    const_iterator& operator++() {
+      ++message_;
+      return *this;
+    }
+    const_iterator operator++(int) { return const_iterator(message_++); }
+    const_iterator& operator--() {
+      --message_;
+      return *this;
+    }
+    const_iterator operator--(int) { return const_iterator(message_--); }
+    const_iterator& operator+=(difference_type n) {
+      message_ += n;
+      return *this;
+    }
+    const_iterator& operator-=(difference_type n) {
+      message_ -= n;
+      return *this;
+    }
+    friend const_iterator operator+(const_iterator it, difference_type n) {
+      return it += n;
+    }
+    friend const_iterator operator+(difference_type n, const_iterator it) {
+      return it += n;
+    }
+    friend const_iterator operator-(const_iterator it, difference_type n) {
+      return it -= n;
+    }
+    friend difference_type operator-(const_iterator a, const_iterator b) {
+      return a.message_ - b.message_;
+    }
+    friend auto operator<=>(const const_iterator&,
+                            const const_iterator&) = default;
+
+   private:
+    friend class MessageHistory;
+    explicit const_iterator(const std::shared_ptr<const Message>* message)
+        : message_(message) {}
+
+    const std::shared_ptr<const Message>* message_ = nullptr;
+  };
+  using iterator = const_iterator;
+  using value_type = Message;
+  using size_type = size_t;
+  using const_reference = const Message&;
+
+  MessageHistory() = default;
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const Message& operator[](size_t index) const {
+    return *arena_->messages[index];
+  }
+  const Message& front() const { return (*this)[0]; }
+  const Message& back() const { return (*this)[size_ - 1]; }
+
+  const_iterator begin() const {
+    return const_iterator(arena_ != nullptr ? arena_->messages.get()
+                                            : nullptr);
+  }
+  const_iterator end() const { return begin() + size_; }
+
+  // Returns the message at `index`, shared with the conversation.
+  std::shared_ptr<const Message> Share(size_t index) const {
+    return arena_->messages[index];
+  }
+
+  // Returns a copy of the messages.
+  std::vector<Message> ToVector() const {
+    return std::vector<Message>(begin(), end());
+  }
+
+ private:
+  friend class MessageHistoryBuilder;
+  MessageHistory(std::shared_ptr<const internal::MessageArena> arena,
+                 size_t size)
+      : arena_(std::move(arena)), size_(size) {}
+
+  std::shared_ptr<const internal::MessageArena> arena_;
+  size_t size_ = 0;
+};
+
+// Appends the messages of a conversation to an append-only arena and hands
+// out MessageHistory snapshots of them. A message is stored once, and never
+// copied again by the appends or the snapshots. Removing the last message
+// only moves the messages to a new arena if a snapshot still sees it.
+//
+// A copy of the builder forks the history: the copies share the messages so
+// far, and each appends its own messages from then on.
+//
+// The class is not thread-safe, but its copies and the snapshots can be used
+// concurrently.
+class MessageHistoryBuilder {
+ public:
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const Message& operator[](size_t index) const {
+    return *arena_->messages[index];
+  }
+
+  // Appends `message`, moved into the arena.
+  void Append(Message message);
+  // Appends `message`, shared with the caller.
+  void Append(std::shared_ptr<const Message> message);
+
+  // Removes the last message.
+  void RemoveLast();
+
+  // Returns a snapshot of the current messages.
+  MessageHistory Snapshot() const { return MessageHistory(arena_, size_); }
+
+ private:
+  // Claims the slot `size_` of the arena, unless a fork claimed it first.
+  bool ClaimNextSlot();
+
+  // Moves the first `size_` messages to a new arena of `capacity` slots.
+  void Reallocate(size_t capacity);
+
+  std::shared_ptr<internal::MessageArena> arena_;
+  size_t size_ = 0;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MESSAGE_HISTORY_H_
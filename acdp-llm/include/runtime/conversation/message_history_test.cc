@@ -0,0 +1,97 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/conversation/message_history.h"
+
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "runtime/conversation/io_types.h"
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+Message CreateMessage(int index) {
+  return JsonMessage{{"role", "user"}, {"content", index}};
+}
+
+TEST(MessageHistoryTest, SnapshotSeesTheMessagesAppendedBefore) {
+  MessageHistoryBuilder builder;
+  EXPECT_THAT(builder.Snapshot(), IsEmpty());
+  builder.Append(CreateMessage(0));
+  MessageHistory snapshot = builder.Snapshot();
+  // Past the initial capacity, so that the arena grows.
+  for (int i = 1; i < 100; ++i) {
+    builder.Append(CreateMessage(i));
+  }
+  EXPECT_THAT(snapshot, ElementsAre(CreateMessage(0)));
+  MessageHistory full_snapshot = builder.Snapshot();
+  ASSERT_EQ(full_snapshot.size(), 100);
+  EXPECT_EQ(full_snapshot.back(), CreateMessage(99));
+  EXPECT_EQ(full_snapshot.ToVector().size(), 100);
+}
+
+TEST(MessageHistoryTest, SnapshotsShareTheMessages) {
+  MessageHistoryBuilder builder;
+  auto message = std::make_shared<const Message>(CreateMessage(0));
+  builder.Append(message);
+  MessageHistory snapshot = builder.Snapshot();
+  MessageHistory copy = snapshot;
+  EXPECT_EQ(snapshot.Share(0), message);
+  EXPECT_EQ(&copy[0], message.get());
+}
+
+TEST(MessageHistoryTest, RemoveLastKeepsTheSnapshots) {
+  MessageHistoryBuilder builder;
+  builder.Append(CreateMessage(0));
+  builder.Append(CreateMessage(1));
+  MessageHistory snapshot = builder.Snapshot();
+  builder.RemoveLast();
+  builder.Append(CreateMessage(2));
+  EXPECT_THAT(snapshot, ElementsAre(CreateMessage(0), CreateMessage(1)));
+  EXPECT_THAT(builder.Snapshot(),
+              ElementsAre(CreateMessage(0), CreateMessage(2)));
+
+  builder.RemoveLast();
+  builder.RemoveLast();
+  EXPECT_TRUE(builder.empty());
+  EXPECT_THAT(builder.Snapshot(), IsEmpty());
+}
+
+TEST(MessageHistoryTest, ForksShareTheMessagesAndDiverge) {
+  MessageHistoryBuilder parent;
+  parent.Append(CreateMessage(0));
+  MessageHistoryBuilder first_child = parent;
+  MessageHistoryBuilder second_child = parent;
+  first_child.Append(CreateMessage(1));
+  second_child.Append(CreateMessage(2));
+  parent.Append(CreateMessage(3));
+
+  EXPECT_EQ(&first_child.Snapshot()[0], &parent.Snapshot()[0]);
+  EXPECT_THAT(parent.Snapshot(),
+              ElementsAre(CreateMessage(0), CreateMessage(3)));
+  EXPECT_THAT(first_child.Snapshot(),
+              ElementsAre(CreateMessage(0), CreateMessage(1)));
+  EXPECT_THAT(second_child.Snapshot(),
+              ElementsAre(CreateMessage(0), CreateMessage(2)));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,214 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/conversation/model_data_processor/audio_trimming.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+
+namespace litert::lm {
+namespace {
+
+constexpr uint16_t kWaveFormatPcm = 1;
+constexpr uint16_t kWaveFormatIeeeFloat = 3;
+constexpr uint16_t kWaveFormatExtensible = 0xFFFE;
+
+uint16_t ReadUint16(absl::string_view bytes, size_t offset) {
+  return static_cast<uint16_t>(static_cast<uint8_t>(bytes[offset])) |
+         static_cast<uint16_t>(static_cast<uint8_t>(bytes[offset + 1])) << 8;
+}
+
+uint32_t ReadUint32(absl::string_view bytes, size_t offset) {
+  return static_cast<uint32_t>(ReadUint16(bytes, offset)) |
+         static_cast<uint32_t>(ReadUint16(bytes, offset + 2)) << 16;
+}
+
+void AppendUint32(uint32_t value, std::string& bytes) {
+  for (int i = 0; i < 4; ++i) {
+    bytes.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+// The chunks of a WAV audio used by the trimming.
+struct WavChunks {
+  // The "fmt " chunk, with its header.
+  absl::string_view format_chunk;
+  absl::string_view samples;
+  uint16_t format;
+  uint16_t num_channels;
+  uint32_t sample_rate;
+  uint16_t block_align;
+  uint16_t bits_per_sample;
+};
+
+// Returns false if `bytes` are not a WAV audio.
+bool ParseWav(absl::string_view bytes, WavChunks& wav) {
+  if (bytes.size() < 12 || bytes.substr(0, 4) != "RIFF" ||
+      bytes.substr(8, 4) != "WAVE") {
+    return false;
+  }
+  bool has_format = false;
+  bool has_samples = false;
+  size_t offset = 12;
+  while (offset + 8 <= bytes.size() && !(has_format && has_samples)) {
+    absl::string_view id = bytes.substr(offset, 4);
+    // The size of the samples is not known to the writers of the streams, so
+    // it may exceed the bytes.
+    size_t size = std::min<size_t>(ReadUint32(bytes, offset + 4),
+                                   bytes.size() - offset - 8);
+    if (id == "fmt " && size >= 16) {
+      wav.format_chunk = bytes.substr(offset, 8 + size);
+      wav.format = ReadUint16(bytes, offset + 8);
+      wav.num_channels = ReadUint16(bytes, offset + 10);
+      wav.sample_rate = ReadUint32(bytes, offset + 12);
+      wav.block_align = ReadUint16(bytes, offset + 20);
+      wav.bits_per_sample = ReadUint16(bytes, offset + 22);
+      if (wav.format == kWaveFormatExtensible && size >= 26) {
+        wav.format = ReadUint16(bytes, offset + 32);
+      }
+      has_format = true;
+    } else if (id == "data") {
+      wav.samples = bytes.substr(offset + 8, size);
+      has_samples = true;
+    }
+    // The chunks are aligned to 2 bytes.
+    offset += 8 + size + (size & 1);
+  }
+  return has_format && has_samples;
+}
+
+// Returns the mean square of the samples of a frame, in [0, 1].
+double GetMeanSquare(const WavChunks& wav, absl::string_view frame) {
+  double sum = 0;
+  size_t num_samples = 0;
+  if (wav.format == kWaveFormatPcm) {
+    for (size_t i = 0; i + 2 <= frame.size(); i += 2, ++num_samples) {
+      double sample = static_cast<int16_t>(ReadUint16(frame, i)) / 32768.0;
+      sum += sample * sample;
+    }
+  } else {
+    for (size_t i = 0; i + 4 <= frame.size(); i += 4, ++num_samples) {
+      uint32_t bits = ReadUint32(frame, i);
+      float sample;
+      std::memcpy(&sample, &bits, sizeof(sample));
+      sum += static_cast<double>(sample) * sample;
+    }
+  }
+  return num_samples == 0 ? 0 : sum / num_samples;
+}
+
+}  // namespace
+
+absl::StatusOr<std::string> TrimAudioSilence(
+    absl::string_view audio_bytes, const AudioTrimmingConfig& config) {
+  if (config.frame_ms <= 0 || config.padding_ms < 0 ||
+      config.max_pause_ms < 0) {
+    return absl::InvalidArgumentError(
+        "The frame length must be positive, and the padding and the pauses "
+        "non-negative.");
+  }
+  WavChunks wav;
+  if (!ParseWav(audio_bytes, wav) || wav.num_channels == 0 ||
+      wav.sample_rate == 0 ||
+      !((wav.format == kWaveFormatPcm && wav.bits_per_sample == 16) ||
+        (wav.format == kWaveFormatIeeeFloat && wav.bits_per_sample == 32)) ||
+      wav.block_align != wav.num_channels * wav.bits_per_sample / 8) {
+    return std::string(audio_bytes);
+  }
+
+  const size_t frame_size =
+      std::max<size_t>(1, static_cast<size_t>(wav.sample_rate) *
+                              config.frame_ms / 1000) *
+      wav.block_align;
+  const double threshold =
+      std::pow(10.0, config.silence_threshold_dbfs / 10.0);
+  std::vector<bool> is_voiced;
+  for (size_t offset = 0; offset < wav.samples.size(); offset += frame_size) {
+    is_voiced.push_back(
+        GetMeanSquare(wav, wav.samples.substr(offset, frame_size)) >=
+        threshold);
+  }
+  const auto first_voiced = std::find(is_voiced.begin(), is_voiced.end(), true);
+  if (first_voiced == is_voiced.end()) {
+    return std::string(audio_bytes);
+  }
+  const int first = first_voiced - is_voiced.begin();
+  const int last =
+      is_voiced.rend() - std::find(is_voiced.rbegin(), is_voiced.rend(), true) -
+      1;
+
+  // The frames kept, as the [begin, end) ranges.
+  const int num_frames = is_voiced.size();
+  const int padding_frames =
+      (config.padding_ms + config.frame_ms - 1) / config.frame_ms;
+  const int max_pause_frames = config.max_pause_ms / config.frame_ms;
+  std::vector<std::pair<int, int>> kept_frames;
+  int begin = std::max(0, first - padding_frames);
+  for (int frame = first; frame <= last;) {
+    if (is_voiced[frame]) {
+      ++frame;
+      continue;
+    }
+    int pause_end = frame;
+    while (!is_voiced[pause_end]) ++pause_end;
+    if (pause_end - frame > max_pause_frames) {
+      // The middle of the pause is cut, keeping its edges.
+      kept_frames.emplace_back(begin, frame + max_pause_frames / 2);
+      begin = pause_end - (max_pause_frames - max_pause_frames / 2);
+    }
+    frame = pause_end;
+  }
+  kept_frames.emplace_back(begin,
+                           std::min(num_frames, last + 1 + padding_frames));
+
+  std::string samples;
+  for (const auto& [begin, end] : kept_frames) {
+    absl::string_view range = wav.samples.substr(
+        static_cast<size_t>(begin) * frame_size,
+        static_cast<size_t>(end - begin) * frame_size);
+    samples.append(range.data(), range.size());
+  }
+  if (samples.size() == wav.samples.size()) {
+    return std::string(audio_bytes);
+  }
+
+  std::string trimmed;
+  const size_t format_padding = wav.format_chunk.size() & 1;
+  const size_t samples_padding = samples.size() & 1;
+  trimmed.reserve(12 + wav.format_chunk.size() + format_padding + 8 +
+                  samples.size() + samples_padding);
+  trimmed.append("RIFF");
+  AppendUint32(4 + wav.format_chunk.size() + format_padding + 8 +
+                   samples.size() + samples_padding,
+               trimmed);
+  trimmed.append("WAVE");
+  trimmed.append(wav.format_chunk.data(), wav.format_chunk.size());
+  trimmed.append(format_padding, '\0');
+  trimmed.append("data");
+  AppendUint32(samples.size(), trimmed);
+  trimmed.append(samples);
+  trimmed.append(samples_padding, '\0');
+  return trimmed;
+}
+
+}  // namespace litert::lm
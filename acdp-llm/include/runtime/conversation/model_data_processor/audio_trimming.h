@@ -0,0 +1,54 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MODEL_DATA_PROCESSOR_AUDIO_TRIMMING_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MODEL_DATA_PROCESSOR_AUDIO_TRIMMING_H_
+
+#include <string>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// Config of TrimAudioSilence().
+struct AudioTrimmingConfig {
+  // The length of the frames whose energy is compared to the threshold.
+  int frame_ms = 20;
+  // The frames with an RMS level below this level, relative to the full scale
+  // of the samples, are silent.
+  float silence_threshold_dbfs = -45.0f;
+  // The silence kept before and after the speech, so that the onsets and the
+  // fading ends of the words are not cut.
+  int padding_ms = 100;
+  // The pauses inside the speech are shortened to this length.
+  int max_pause_ms = 300;
+};
+
+// Removes the leading and trailing silence of a WAV audio, and shortens its
+// long internal pauses, with an energy-based voice activity detection. Meant
+// to be applied before the spectrogram of the audio is computed, so that the
+// silence costs no audio tokens, e.g. for the voice commands which are often
+// more than half silence.
+//
+// Supports the 16-bit integer and the 32-bit float PCM WAV audio, with any
+// number of channels. The other audio, e.g. compressed, and the audio that is
+// silent throughout are returned unchanged. The chunks of the WAV audio other
+// than its format and its samples are dropped.
+absl::StatusOr<std::string> TrimAudioSilence(absl::string_view audio_bytes,
+                                             const AudioTrimmingConfig& config);
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MODEL_DATA_PROCESSOR_AUDIO_TRIMMING_H_
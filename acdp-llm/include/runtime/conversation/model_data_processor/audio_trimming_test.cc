@@ -0,0 +1,122 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/conversation/model_data_processor/audio_trimming.h"
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::IsOkAndHolds;
+using ::testing::status::StatusIs;
+
+constexpr int kSampleRate = 16000;
+
+void AppendLittleEndian(uint32_t value, int num_bytes, std::string& bytes) {
+  for (int i = 0; i < num_bytes; ++i) {
+    bytes.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+// Returns a mono 16-bit PCM WAV audio of `samples`.
+std::string CreateWav(const std::vector<int16_t>& samples) {
+  std::string wav = "RIFF";
+  AppendLittleEndian(36 + samples.size() * 2, 4, wav);
+  wav += "WAVEfmt ";
+  AppendLittleEndian(16, 4, wav);
+  AppendLittleEndian(/*format=*/1, 2, wav);
+  AppendLittleEndian(/*num_channels=*/1, 2, wav);
+  AppendLittleEndian(kSampleRate, 4, wav);
+  AppendLittleEndian(kSampleRate * 2, 4, wav);
+  AppendLittleEndian(/*block_align=*/2, 2, wav);
+  AppendLittleEndian(/*bits_per_sample=*/16, 2, wav);
+  wav += "data";
+  AppendLittleEndian(samples.size() * 2, 4, wav);
+  for (int16_t sample : samples) {
+    AppendLittleEndian(static_cast<uint16_t>(sample), 2, wav);
+  }
+  return wav;
+}
+
+void AppendSilence(int duration_ms, std::vector<int16_t>& samples) {
+  samples.insert(samples.end(), kSampleRate * duration_ms / 1000, 0);
+}
+
+void AppendTone(int duration_ms, std::vector<int16_t>& samples) {
+  for (int i = 0; i < kSampleRate * duration_ms / 1000; ++i) {
+    samples.push_back(8000 * std::sin(2 * M_PI * 440 * i / kSampleRate));
+  }
+}
+
+// Returns the duration of the samples of a mono 16-bit WAV audio.
+int GetDurationMs(absl::string_view wav) {
+  const uint32_t size = static_cast<uint8_t>(wav[40]) |
+                        static_cast<uint8_t>(wav[41]) << 8 |
+                        static_cast<uint8_t>(wav[42]) << 16 |
+                        static_cast<uint8_t>(wav[43]) << 24;
+  EXPECT_EQ(wav.size(), 44 + size);
+  return size / 2 * 1000 / kSampleRate;
+}
+
+TEST(AudioTrimmingTest, TrimsTheSilenceAroundAndInsideTheSpeech) {
+  std::vector<int16_t> samples;
+  AppendSilence(1000, samples);
+  AppendTone(500, samples);
+  AppendSilence(1000, samples);
+  AppendTone(500, samples);
+  AppendSilence(1000, samples);
+  ASSERT_OK_AND_ASSIGN(
+      std::string trimmed,
+      TrimAudioSilence(CreateWav(samples),
+                       {.padding_ms = 100, .max_pause_ms = 300}));
+  // The padding, the tone, the shortened pause, the tone and the padding.
+  EXPECT_EQ(GetDurationMs(trimmed), 100 + 500 + 300 + 500 + 100);
+}
+
+TEST(AudioTrimmingTest, KeepsTheShortPauses) {
+  std::vector<int16_t> samples;
+  AppendTone(500, samples);
+  AppendSilence(200, samples);
+  AppendTone(500, samples);
+  const std::string wav = CreateWav(samples);
+  EXPECT_THAT(TrimAudioSilence(wav, {.padding_ms = 100, .max_pause_ms = 300}),
+              IsOkAndHolds(wav));
+}
+
+TEST(AudioTrimmingTest, ReturnsTheSilentAndTheNonWavAudioUnchanged) {
+  std::vector<int16_t> samples;
+  AppendSilence(1000, samples);
+  const std::string wav = CreateWav(samples);
+  EXPECT_THAT(TrimAudioSilence(wav, {}), IsOkAndHolds(wav));
+  EXPECT_THAT(TrimAudioSilence("ID3 not a wav", {}),
+              IsOkAndHolds("ID3 not a wav"));
+}
+
+TEST(AudioTrimmingTest, RejectsTheInvalidConfig) {
+  EXPECT_THAT(TrimAudioSilence("", {.frame_ms = 0}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace litert::lm
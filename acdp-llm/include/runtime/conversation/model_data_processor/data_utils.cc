@@ -16,12 +16,14 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/escaping.h"  // from @com_google_absl
 #include "nlohmann/json.hpp"  // from @nlohmann_json
 #include "runtime/util/memory_mapped_file.h"
+#include "runtime/util/status_macros.h"  // NOLINT
 
 namespace litert::lm {
 
@@ -39,12 +41,12 @@ absl::StatusOr<std::unique_ptr<MemoryMappedFile>> LoadItemData(
       return MemoryMappedFile::Create(item["path"].get<std::string>());
     }
     if (item.contains("blob")) {
-      std::string blob_b64 = item["blob"].get<std::string>();
       std::string blob;
-      if (!absl::Base64Unescape(blob_b64, &blob)) {
+      if (!absl::Base64Unescape(item["blob"].get_ref<const std::string&>(),
+                                &blob)) {
         return absl::InvalidArgumentError("Failed to decode base64 blob.");
       }
-      return InMemoryFile::Create(blob);
+      return InMemoryFile::Create(std::move(blob));
     }
     return absl::InvalidArgumentError(
         "Audio or image item must contain a path or blob.");
@@ -55,4 +57,30 @@ absl::StatusOr<std::unique_ptr<MemoryMappedFile>> LoadItemData(
                                   item["type"].get<std::string>());
 }
 
+absl::StatusOr<std::string> LoadMediaItemBytes(const ordered_json& item) {
+  if (!item.contains("type")) {
+    return absl::InvalidArgumentError("Item must contain a type.");
+  }
+  if (item["type"] != "image" && item["type"] != "audio") {
+    return absl::UnimplementedError("Unsupported item type: " +
+                                    item["type"].get<std::string>());
+  }
+  if (item.contains("path")) {
+    ASSIGN_OR_RETURN(std::unique_ptr<MemoryMappedFile> file,
+                     MemoryMappedFile::Create(item["path"].get<std::string>()));
+    return std::string(static_cast<const char*>(file->data()),
+                       file->length());
+  }
+  if (item.contains("blob")) {
+    std::string bytes;
+    if (!absl::Base64Unescape(item["blob"].get_ref<const std::string&>(),
+                              &bytes)) {
+      return absl::InvalidArgumentError("Failed to decode base64 blob.");
+    }
+    return bytes;
+  }
+  return absl::InvalidArgumentError(
+      "Audio or image item must contain a path or blob.");
+}
+
 }  // namespace litert::lm
@@ -16,6 +16,7 @@
 #define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MODEL_DATA_PROCESSOR_DATA_UTILS_H_
 
 #include <memory>
+#include <string>
 
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "nlohmann/json_fwd.hpp"  // from @nlohmann_json
@@ -56,6 +57,14 @@ namespace litert::lm {
 absl::StatusOr<std::unique_ptr<MemoryMappedFile>> LoadItemData(
     const nlohmann::ordered_json& item);
 
+// Loads the encoded bytes of the image or audio `item`, see LoadItemData(),
+// into the string to hand over to InputImage or InputAudio. A blob is decoded
+// from the JSON string straight into the returned string, and a file is
+// copied into it once, so that the bytes are not held by a MemoryMappedFile
+// and by the input at the same time.
+absl::StatusOr<std::string> LoadMediaItemBytes(
+    const nlohmann::ordered_json& item);
+
 }  // namespace litert::lm
 
 #endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MODEL_DATA_PROCESSOR_DATA_UTILS_H_
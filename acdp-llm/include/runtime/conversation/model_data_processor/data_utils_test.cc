@@ -138,5 +138,31 @@ TEST(DataUtilsTest, LoadItemData_ToolResponseItem) {
   EXPECT_EQ(memory_mapped_file, nullptr);
 }
 
+TEST(DataUtilsTest, LoadMediaItemBytes_ImageItemWithPath) {
+  auto path = std::filesystem::path(::testing::TempDir()) / "test_image.jpg";
+  WriteFile(path.string(), "image_contents");
+  EXPECT_THAT(LoadMediaItemBytes({
+                  {"type", "image"},
+                  {"path", path.string()},
+              }),
+              testing::status::IsOkAndHolds("image_contents"));
+}
+
+TEST(DataUtilsTest, LoadMediaItemBytes_AudioItemWithBlob) {
+  EXPECT_THAT(LoadMediaItemBytes({
+                  {"type", "audio"},
+                  {"blob", "YXVkaW9fY29udGVudHM="},
+              }),
+              testing::status::IsOkAndHolds("audio_contents"));
+}
+
+TEST(DataUtilsTest, LoadMediaItemBytes_TextItem) {
+  EXPECT_THAT(LoadMediaItemBytes({
+                  {"type", "text"},
+                  {"text", "some text"},
+              }),
+              testing::status::StatusIs(absl::StatusCode::kUnimplemented));
+}
+
 }  // namespace
 }  // namespace litert::lm
@@ -15,6 +15,7 @@
 #include "runtime/conversation/model_data_processor/gemma3_data_processor.h"
 
 #include <deque>
+#include <future>  // NOLINT
 #include <memory>
 #include <optional>
 #include <string>
@@ -29,18 +30,19 @@
 #include "nlohmann/json_fwd.hpp"  // from @nlohmann_json
 #include "litert/cc/litert_layout.h"  // from @litert
 #include "runtime/components/preprocessor/audio_preprocessor.h"
-#include "runtime/components/preprocessor/audio_preprocessor_miniaudio.h"
 #include "runtime/components/preprocessor/image_preprocessor.h"
-#include "runtime/components/preprocessor/stb_image_preprocessor.h"
 #include "runtime/components/tool_use/parser_utils.h"
 #include "runtime/components/tool_use/python_tool_format_utils.h"
 #include "runtime/conversation/io_types.h"
+#include "runtime/conversation/model_data_processor/audio_trimming.h"
 #include "runtime/conversation/model_data_processor/data_utils.h"
 #include "runtime/conversation/model_data_processor/gemma3_data_processor_config.h"
+#include "runtime/conversation/model_data_processor/shared_preprocessors.h"
 #include "runtime/engine/io_types.h"
-#include "runtime/util/memory_mapped_file.h"
+#include "runtime/framework/threadpool.h"
 #include "runtime/util/status_macros.h"
 #include "re2/re2.h"  // from @com_googlesource_code_re2
+#include "stb_image.h"  // from @stb
 
 namespace litert::lm {
 namespace {
@@ -55,6 +57,31 @@ bool IsAudio(absl::string_view part) {
   return part == "<start_of_audio>" || part == "<audio_soft_token>";
 }
 
+// Returns the resolution tier of `config` an image of `image_bytes` is
+// resized to, or the full resolution of `config` if no tier covers the image
+// or its size can't be read from its header.
+ImagePreprocessParameter GetImagePreprocessParameter(
+    const Gemma3DataProcessorConfig& config, absl::string_view image_bytes) {
+  ImageResolution resolution = {.height = config.image_tensor_height,
+                                .width = config.image_tensor_width};
+  int height, width, channels;
+  if (!config.image_resolution_tiers.empty() &&
+      stbi_info_from_memory(
+          reinterpret_cast<const stbi_uc*>(image_bytes.data()),
+          image_bytes.size(), &width, &height, &channels)) {
+    for (const ImageResolution& tier : config.image_resolution_tiers) {
+      if (height <= tier.height && width <= tier.width &&
+          tier.height * tier.width < resolution.height * resolution.width) {
+        resolution = tier;
+      }
+    }
+  }
+  ImagePreprocessParameter image_params;
+  image_params.SetTargetDimensions(
+      Dimensions({1, resolution.height, resolution.width, 3}));
+  return image_params;
+}
+
 bool HasToolCalls(const ordered_json& message) {
   return message.contains("tool_calls") && message["tool_calls"].is_array();
 }
@@ -68,12 +95,13 @@ bool IsToolMessage(const ordered_json& message) {
 absl::StatusOr<std::unique_ptr<Gemma3DataProcessor>>
 Gemma3DataProcessor::Create(Gemma3DataProcessorConfig config,
                             std::optional<Preface> preface) {
-  ASSIGN_OR_RETURN(auto audio_preprocessor,
-                   AudioPreprocessorMiniAudio::Create(
-                       AudioPreprocessorConfig::CreateDefaultUsmConfig()));
+  // The preprocessors are shared with the other processors, instead of being
+  // created again for each conversation.
+  std::shared_ptr<ImagePreprocessor> image_preprocessor =
+      GetSharedImagePreprocessor(config.use_vectorized_image_preprocessor);
   return absl::WrapUnique(new Gemma3DataProcessor(
-      config, preface, std::make_unique<StbImagePreprocessor>(),
-      std::move(audio_preprocessor)));
+      config, preface, std::move(image_preprocessor),
+      &AudioPreprocessorPool::GetDefault()));
 }
 
 absl::StatusOr<ordered_json> Gemma3DataProcessor::MessageToTemplateInput(
@@ -158,35 +186,50 @@ Gemma3DataProcessor::ToInputDataVectorImpl(
     const std::string& rendered_template_prompt, const ordered_json& messages,
     const Gemma3DataProcessorArguments& args) const {
   std::vector<InputData> input_data;
-  std::deque<std::unique_ptr<MemoryMappedFile>> image_files;
-  std::deque<std::unique_ptr<MemoryMappedFile>> audio_files;
+  std::deque<std::string> audio_bytes;
+  // The images are decoded and resized concurrently on the shared thread
+  // pool, while the prompt is split and the audio is preprocessed. Each task
+  // owns the encoded bytes of its image, released once the image is
+  // preprocessed, and the preprocessor, so that it may outlive the conversion
+  // if it fails early.
+  std::deque<std::future<absl::StatusOr<InputImage>>> preprocessed_images;
   // Find all images and audio contained in the messages.
   for (const auto& message : messages) {
     if (message.contains("content") && message["content"].is_array()) {
       for (const auto& item : message["content"]) {
-        if (item.is_string()) {
+        if (item.is_string() || item.value("type", "") == "text" ||
+            item.value("type", "") == "tool_response") {
           continue;
         }
-        ASSIGN_OR_RETURN(std::unique_ptr<MemoryMappedFile> mmap_file,
-                         LoadItemData(item));
+        ASSIGN_OR_RETURN(std::string bytes, LoadMediaItemBytes(item));
         if (item["type"] == "image") {
-          image_files.push_back(std::move(mmap_file));
-        } else if (item["type"] == "audio") {
-          audio_files.push_back(std::move(mmap_file));
+          ImagePreprocessParameter image_params =
+              GetImagePreprocessParameter(config_, bytes);
+          auto promise =
+              std::make_shared<std::promise<absl::StatusOr<InputImage>>>();
+          preprocessed_images.push_back(promise->get_future());
+          RETURN_IF_ERROR(GetSharedImagePreprocessingThreadPool().Schedule(
+              [promise, image_preprocessor = image_preprocessor_,
+               image_params = std::move(image_params),
+               bytes = std::move(bytes)]() mutable {
+                promise->set_value(image_preprocessor->Preprocess(
+                    InputImage(std::move(bytes)), image_params));
+              }));
+        } else {
+          audio_bytes.push_back(std::move(bytes));
         }
       }
     }
   }
 
+  // Leased on the first audio, and returned to the pool with the conversion.
+  AudioPreprocessorPool::Lease audio_preprocessor;
   RE2 re_delimiter(
       "(<start_of_image>|<image_soft_token>|<start_of_audio>|<audio_soft_token>"
       ")");
   absl::string_view prompt_view(rendered_template_prompt);
   const char* start = prompt_view.data();
   std::string part;
-  ImagePreprocessParameter image_params;
-  image_params.SetTargetDimensions(Dimensions(
-      {1, config_.image_tensor_height, config_.image_tensor_width, 3}));
   // Replace the placeholders with the actual data. Note for Gemma3N the
   // placeholders in the prompt are <image_soft_token> and <audio_soft_token>,
   // while for Gemma3 the placeholders in the prompt are <start_of_image> and
@@ -197,41 +240,43 @@ Gemma3DataProcessor::ToInputDataVectorImpl(
     if (IsImage(part)) {
       input_data.emplace_back(
           InputText(std::string(text_part) + "\n\n<start_of_image>\n\n"));
-      if (image_files.empty()) {
+      if (preprocessed_images.empty()) {
         return absl::InvalidArgumentError(
             "Provided less images than expected in the prompt.");
       }
-      auto image_file = std::move(image_files.front());
-      image_files.pop_front();
       ASSIGN_OR_RETURN(auto preprocessed_image,
-                       image_preprocessor_->Preprocess(
-                           InputImage(std::string(
-                               static_cast<const char*>(image_file->data()),
-                               image_file->length())),
-                           image_params));
+                       preprocessed_images.front().get());
+      preprocessed_images.pop_front();
       input_data.emplace_back(InputImage(std::move(preprocessed_image)));
     } else if (IsAudio(part)) {
       input_data.emplace_back(
           InputText(std::string(text_part) + "\n\n<start_of_audio>\n\n"));
-      if (audio_files.empty()) {
+      if (audio_bytes.empty()) {
         return absl::InvalidArgumentError(
             "Provided less audio than expected in the prompt.");
       }
-      auto audio_file = std::move(audio_files.front());
-      audio_files.pop_front();
+      std::string audio = std::move(audio_bytes.front());
+      audio_bytes.pop_front();
+      if (config_.audio_trimming.has_value()) {
+        ASSIGN_OR_RETURN(audio,
+                         TrimAudioSilence(audio, *config_.audio_trimming));
+      }
+      if (audio_preprocessor == nullptr) {
+        ASSIGN_OR_RETURN(audio_preprocessor,
+                         audio_preprocessor_pool_->Acquire());
+      }
       ASSIGN_OR_RETURN(auto preprocessed_audio,
-                       audio_preprocessor_->Preprocess(InputAudio(std::string(
-                           static_cast<const char*>(audio_file->data()),
-                           audio_file->length()))));
-      audio_preprocessor_->Reset();
+                       audio_preprocessor->Preprocess(
+                           InputAudio(std::move(audio))));
+      audio_preprocessor->Reset();
       input_data.emplace_back(InputAudio(std::move(preprocessed_audio)));
     }
   }
-  if (!image_files.empty()) {
+  if (!preprocessed_images.empty()) {
     return absl::InvalidArgumentError(
         "Provided more images than expected in the prompt.");
   }
-  if (!audio_files.empty()) {
+  if (!audio_bytes.empty()) {
     return absl::InvalidArgumentError(
         "Provided more audio than expected in the prompt.");
   }
@@ -24,11 +24,11 @@
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
 #include "nlohmann/json.hpp"  // from @nlohmann_json
-#include "runtime/components/preprocessor/audio_preprocessor.h"
 #include "runtime/components/preprocessor/image_preprocessor.h"
 #include "runtime/conversation/io_types.h"
 #include "runtime/conversation/model_data_processor/gemma3_data_processor_config.h"
 #include "runtime/conversation/model_data_processor/model_data_processor.h"
+#include "runtime/conversation/model_data_processor/shared_preprocessors.h"
 #include "runtime/engine/io_types.h"
 
 namespace litert::lm {
@@ -66,12 +66,12 @@ class Gemma3DataProcessor
   explicit Gemma3DataProcessor(
       const Gemma3DataProcessorConfig& config = Gemma3DataProcessorConfig(),
       std::optional<Preface> preface = std::nullopt,
-      std::unique_ptr<ImagePreprocessor> image_preprocessor = nullptr,
-      std::unique_ptr<AudioPreprocessor> audio_preprocessor = nullptr)
+      std::shared_ptr<ImagePreprocessor> image_preprocessor = nullptr,
+      AudioPreprocessorPool* audio_preprocessor_pool = nullptr)
       : config_(config),
         preface_(preface),
         image_preprocessor_(std::move(image_preprocessor)),
-        audio_preprocessor_(std::move(audio_preprocessor)) {};
+        audio_preprocessor_pool_(audio_preprocessor_pool) {};
 
   absl::StatusOr<std::vector<InputData>> ToInputDataVectorImpl(
       const std::string& rendered_template_prompt,
@@ -84,8 +84,10 @@ class Gemma3DataProcessor
 
   Gemma3DataProcessorConfig config_;
   std::optional<Preface> preface_;
-  std::unique_ptr<ImagePreprocessor> image_preprocessor_;
-  std::unique_ptr<AudioPreprocessor> audio_preprocessor_;
+  // Shared with the other processors.
+  std::shared_ptr<ImagePreprocessor> image_preprocessor_;
+  // The audio preprocessors are leased for each conversion.
+  AudioPreprocessorPool* audio_preprocessor_pool_;
 };
 
 }  // namespace litert::lm
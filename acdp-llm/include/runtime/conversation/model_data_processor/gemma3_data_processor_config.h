@@ -15,10 +15,20 @@
 #ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MODEL_DATA_PROCESSOR_GEMMA3_ARGUMENTS_H_
 #define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MODEL_DATA_PROCESSOR_GEMMA3_ARGUMENTS_H_
 
+#include <optional>
 #include <string>
+#include <vector>
+
+#include "runtime/conversation/model_data_processor/audio_trimming.h"
 
 namespace litert::lm {
 
+// A resolution the images may be resized to before the vision encoder.
+struct ImageResolution {
+  int height;
+  int width;
+};
+
 // Config for Gemma3DataProcessor.
 struct Gemma3DataProcessorConfig {
   // The string for beginning of image token.
@@ -28,11 +38,23 @@ struct Gemma3DataProcessorConfig {
 
   int image_tensor_height = 768;
   int image_tensor_width = 768;
+  // The lower resolutions the images may be resized to instead. An image is
+  // resized to the smallest of them covering its own size, and to the full
+  // resolution above when none does, so the small images, e.g. icons, take
+  // fewer vision tokens. The vision encoder must accept all of them.
+  std::vector<ImageResolution> image_resolution_tiers;
+  // Whether to resize and normalize the images with the vectorized kernels
+  // of VectorizedImagePreprocessor instead of StbImagePreprocessor, e.g. for
+  // the large screenshots on CPU-only devices.
+  bool use_vectorized_image_preprocessor = false;
 
   // The string for beginning of audio token.
   std::string boa_token = "<start_of_audio>";
   // The string for end of audio token.
   std::string eoa_token = "<end_of_audio>";
+  // If set, the silence of the WAV audio is trimmed before its spectrogram is
+  // computed, see TrimAudioSilence(), so that it takes no audio tokens.
+  std::optional<AudioTrimmingConfig> audio_trimming;
 
   // Tool call parsing configuration.
   std::string code_fence_start = "```tool_code\n";
@@ -28,6 +28,7 @@
 #include <gtest/gtest.h>
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/escaping.h"  // from @com_google_absl
 #include "absl/strings/str_cat.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
 #include "nlohmann/json.hpp"  // from @nlohmann_json
@@ -38,6 +39,7 @@
 #include "runtime/components/preprocessor/stb_image_preprocessor.h"
 #include "runtime/components/prompt_template.h"
 #include "runtime/conversation/io_types.h"
+#include "runtime/conversation/model_data_processor/audio_trimming.h"
 #include "runtime/conversation/model_data_processor/gemma3_data_processor_config.h"
 #include "runtime/engine/io_types.h"
 #include "runtime/util/convert_tensor_buffer.h"
@@ -192,6 +194,42 @@ TEST(Gemma3DataProcessorTest, ToInputDataVectorTextAndImage) {
                                       HasInputText(&expected_text2)));
 }
 
+TEST(Gemma3DataProcessorTest, ToInputDataVectorResizesSmallImagesToTier) {
+  ASSERT_OK_AND_ASSIGN(
+      auto processor,
+      Gemma3DataProcessor::Create(/*Gemma3DataProcessorConfig=*/{
+          .image_tensor_height = 224,
+          .image_tensor_width = 128,
+          .image_resolution_tiers = {{.height = 64, .width = 64},
+                                     {.height = 32, .width = 32}}}));
+  const std::string rendered_template_prompt =
+      "<start_of_turn>user\n<start_of_image><end_of_turn>";
+
+  // A 16x16 binary PPM image, covered by both tiers.
+  const std::string image_bytes =
+      absl::StrCat("P6\n16 16\n255\n", std::string(16 * 16 * 3, '\x80'));
+  const nlohmann::ordered_json message = {
+      {"role", "user"},
+      {"content",
+       {{{"type", "image"}, {"blob", absl::Base64Escape(image_bytes)}}}}};
+  ASSERT_OK_AND_ASSIGN(
+      const std::vector<InputData> input_data,
+      processor->ToInputDataVector(rendered_template_prompt,
+                                   json::array({message}), {}));
+
+  InputText expected_text1("<start_of_turn>user\n\n\n<start_of_image>\n\n");
+  StbImagePreprocessor image_preprocessor;
+  ImagePreprocessParameter image_params;
+  image_params.SetTargetDimensions(Dimensions({1, 32, 32, 3}));
+  ASSERT_OK_AND_ASSIGN(
+      InputImage expected_image,
+      image_preprocessor.Preprocess(InputImage(image_bytes), image_params));
+  InputText expected_text2("<end_of_turn>");
+  EXPECT_THAT(input_data, ElementsAre(HasInputText(&expected_text1),
+                                      HasInputImage(&expected_image),
+                                      HasInputText(&expected_text2)));
+}
+
 TEST(Gemma3DataProcessorTest, ToInputDataVectorNonArrayContent) {
   ASSERT_OK_AND_ASSIGN(auto processor, Gemma3DataProcessor::Create());
   const std::string rendered_template_prompt =
@@ -912,6 +950,41 @@ TEST(Gemma3DataProcessorTest, ToInputDataVectorTextAndAudio) {
                                       HasInputText(&expected_text2)));
 }
 
+TEST(Gemma3DataProcessorTest, ToInputDataVectorTrimsTheAudioSilence) {
+  const AudioTrimmingConfig audio_trimming = {.max_pause_ms = 100};
+  ASSERT_OK_AND_ASSIGN(auto processor,
+                       Gemma3DataProcessor::Create(
+                           /*Gemma3DataProcessorConfig=*/{
+                               .audio_trimming = audio_trimming}));
+  const std::string rendered_template_prompt =
+      "<start_of_turn>user\n<start_of_audio><end_of_turn>";
+
+  std::string audio_path = (std::filesystem::path(::testing::SrcDir()) /
+                            kTestdataDir / "audio_sample.wav")
+                               .string();
+  const nlohmann::ordered_json message = {
+      {"role", "user"},
+      {"content", {{{"type", "audio"}, {"path", audio_path}}}}};
+  ASSERT_OK_AND_ASSIGN(
+      const std::vector<InputData> input_data,
+      processor->ToInputDataVector(rendered_template_prompt,
+                                   json::array({message}), {}));
+
+  InputText expected_text1("<start_of_turn>user\n\n\n<start_of_audio>\n\n");
+  ASSERT_OK_AND_ASSIGN(std::string trimmed_audio,
+                       TrimAudioSilence(ReadFile(audio_path), audio_trimming));
+  ASSERT_OK_AND_ASSIGN(auto audio_preprocessor,
+                       AudioPreprocessorMiniAudio::Create(
+                           AudioPreprocessorConfig::CreateDefaultUsmConfig()));
+  ASSERT_OK_AND_ASSIGN(
+      InputAudio expected_audio,
+      audio_preprocessor->Preprocess(InputAudio(std::move(trimmed_audio))));
+  InputText expected_text2("<end_of_turn>");
+  EXPECT_THAT(input_data, ElementsAre(HasInputText(&expected_text1),
+                                      HasInputAudio(&expected_audio),
+                                      HasInputText(&expected_text2)));
+}
+
 TEST(Gemma3DataProcessorTest, PromptTemplateToInputDataVectorTextAndAudio) {
   const std::string test_file_path =
       GetTestdataPath("google-gemma-3n-e2b-it.jinja");
@@ -159,7 +159,7 @@ absl::StatusOr<std::unique_ptr<ModelDataProcessor>> CreateModelDataProcessor(
   } else if (std::holds_alternative<Qwen3DataProcessorConfig>(config)) {
     ABSL_LOG(INFO) << "Creating Qwen3DataProcessor";
     return Qwen3DataProcessor::Create(
-        std::get<Qwen3DataProcessorConfig>(config), preface);
+        std::get<Qwen3DataProcessorConfig>(config), preface, &tokenizer);
   } else if (std::holds_alternative<GenericDataProcessorConfig>(config)) {
     ABSL_LOG(INFO) << "Creating GenericDataProcessor";
     return GenericDataProcessor::Create(
@@ -22,22 +22,28 @@
 #include <vector>
 
 #include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
 #include "nlohmann/json_fwd.hpp"  // from @nlohmann_json
+#include "runtime/components/constrained_decoding/constraint.h"
+#include "runtime/components/tokenizer.h"
 #include "runtime/components/tool_use/parser_utils.h"
 #include "runtime/conversation/io_types.h"
 #include "runtime/conversation/model_data_processor/model_data_processor.h"
 #include "runtime/conversation/model_data_processor/qwen3_data_processor_config.h"
+#include "runtime/conversation/model_data_processor/qwen3_tool_call_constraint.h"
+#include "runtime/core/token_text_table.h"
 #include "runtime/engine/io_types.h"
 #include "runtime/util/status_macros.h"
 
 namespace litert::lm {
 
 absl::StatusOr<std::unique_ptr<ModelDataProcessor>> Qwen3DataProcessor::Create(
-    Qwen3DataProcessorConfig config, std::optional<Preface> preface) {
+    Qwen3DataProcessorConfig config, std::optional<Preface> preface,
+    const Tokenizer* tokenizer) {
   return absl::WrapUnique(
-      new Qwen3DataProcessor(std::move(config), std::move(preface)));
+      new Qwen3DataProcessor(std::move(config), std::move(preface), tokenizer));
 }
 
 absl::StatusOr<nlohmann::ordered_json>
@@ -89,6 +95,26 @@ absl::StatusOr<Message> Qwen3DataProcessor::ToMessageImpl(
   return message;
 }
 
+absl::StatusOr<std::unique_ptr<Constraint>>
+Qwen3DataProcessor::CreateConstraint(
+    const nlohmann::ordered_json& tools) const {
+  if (tokenizer_ == nullptr) {
+    return absl::UnimplementedError(
+        "Constrained tool calls need the tokenizer of the model.");
+  }
+  // Decoding the tokens one by one does not change the tokenizer.
+  ASSIGN_OR_RETURN(auto table,
+                   TokenTextTable::Build(const_cast<Tokenizer&>(*tokenizer_),
+                                         config_.vocabulary_size));
+  std::vector<std::string> token_texts(config_.vocabulary_size);
+  for (int token_id = 0; token_id < config_.vocabulary_size; ++token_id) {
+    token_texts[token_id] = std::string(table->GetText(token_id));
+  }
+  return Qwen3ToolCallConstraint::Create(
+      tools, config_.code_fence_start, config_.code_fence_end,
+      std::move(token_texts), config_.vocabulary_size);
+}
+
 absl::string_view Qwen3DataProcessor::CodeFenceStart() const {
   return config_.code_fence_start;
 }
@@ -24,6 +24,8 @@
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
 #include "nlohmann/json_fwd.hpp"  // from @nlohmann_json
+#include "runtime/components/constrained_decoding/constraint.h"
+#include "runtime/components/tokenizer.h"
 #include "runtime/conversation/io_types.h"
 #include "runtime/conversation/model_data_processor/model_data_processor.h"
 #include "runtime/conversation/model_data_processor/qwen3_data_processor_config.h"
@@ -39,9 +41,12 @@ class Qwen3DataProcessor
     : public TypeSafeModelDataProcessor<Qwen3DataProcessorConfig,
                                         Qwen3DataProcessorArguments> {
  public:
+  // `tokenizer`, which must outlive the processor, is only needed by
+  // CreateConstraint().
   static absl::StatusOr<std::unique_ptr<ModelDataProcessor>> Create(
       Qwen3DataProcessorConfig config,
-      std::optional<Preface> preface = std::nullopt);
+      std::optional<Preface> preface = std::nullopt,
+      const Tokenizer* tokenizer = nullptr);
 
   // Return the same tools as the input for generic models.
   absl::StatusOr<nlohmann::ordered_json> FormatTools(
@@ -53,6 +58,11 @@ class Qwen3DataProcessor
   absl::StatusOr<nlohmann::ordered_json> MessageToTemplateInput(
       const nlohmann::ordered_json& message) const override;
 
+  // Returns a Qwen3ToolCallConstraint, restricting the tool calls to the
+  // names of `tools` and to JSON arguments.
+  absl::StatusOr<std::unique_ptr<Constraint>> CreateConstraint(
+      const nlohmann::ordered_json& tools) const override;
+
   // No-op for generic models.
   absl::string_view CodeFenceStart() const override;
 
@@ -64,8 +74,11 @@ class Qwen3DataProcessor
 
  private:
   explicit Qwen3DataProcessor(Qwen3DataProcessorConfig config,
-                              std::optional<Preface> preface)
-      : config_(std::move(config)), preface_(std::move(preface)) {};
+                              std::optional<Preface> preface,
+                              const Tokenizer* tokenizer)
+      : config_(std::move(config)),
+        preface_(std::move(preface)),
+        tokenizer_(tokenizer) {};
 
   absl::StatusOr<std::vector<InputData>> ToInputDataVectorImpl(
       const std::string& rendered_template_prompt,
@@ -78,6 +91,7 @@ class Qwen3DataProcessor
 
   Qwen3DataProcessorConfig config_;
   std::optional<Preface> preface_;
+  const Tokenizer* tokenizer_;
 };
 
 }  // namespace litert::lm
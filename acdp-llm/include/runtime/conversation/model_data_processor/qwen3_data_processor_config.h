@@ -23,6 +23,12 @@ struct Qwen3DataProcessorConfig {
   std::string code_fence_end = "</tool_call>";
   bool escape_fence_strings = true;
   std::string tool_code_regex = "";
+  // The number of tokens of the model, the size of the bitmasks of the
+  // constrained tool calls.
+  int vocabulary_size = 151936;
+  // The markers of the reasoning the model writes before its response.
+  std::string reasoning_start = "<think>";
+  std::string reasoning_end = "</think>";
 };
 
 struct Qwen3DataProcessorArguments {};
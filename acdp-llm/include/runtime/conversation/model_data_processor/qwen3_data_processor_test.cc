@@ -20,6 +20,7 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
 #include "nlohmann/json_fwd.hpp"  // from @nlohmann_json
 #include "runtime/conversation/io_types.h"
 #include "runtime/conversation/model_data_processor/qwen3_data_processor_config.h"
@@ -31,6 +32,7 @@ namespace {
 
 using json = nlohmann::ordered_json;
 using ::testing::ElementsAre;
+using ::testing::status::StatusIs;
 
 MATCHER_P(HasInputText, text_input, "") {
   if (!std::holds_alternative<InputText>(arg)) {
@@ -135,5 +137,14 @@ TEST(Qwen3DataProcessorTest, CodeFence) {
   EXPECT_EQ(processor->CodeFenceEnd(), "</tool_call>");
 }
 
+TEST(Qwen3DataProcessorTest, CreateConstraintWithoutTokenizer) {
+  ASSERT_OK_AND_ASSIGN(auto processor,
+                       Qwen3DataProcessor::Create(Qwen3DataProcessorConfig{}));
+  EXPECT_THAT(processor->CreateConstraint(json::parse(
+                  R"json([{"type": "function",
+                           "function": {"name": "func1"}}])json")),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
 }  // namespace
 }  // namespace litert::lm
@@ -0,0 +1,656 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/conversation/model_data_processor/qwen3_tool_call_constraint.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/match.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "nlohmann/json.hpp"  // from @nlohmann_json
+#include "runtime/components/constrained_decoding/bitmap.h"
+#include "runtime/components/constrained_decoding/constraint.h"
+#include "runtime/util/status_macros.h"
+
+namespace litert::lm {
+namespace {
+
+// The bitmasks memoized at most, beyond which they are dropped. A tool call
+// reaches a few dozen states, one per position in its skeleton and per kind
+// of JSON token.
+constexpr int kMaxNumBitmasks = 1024;
+
+// The nesting of the JSON arguments allowed at most.
+constexpr int kMaxJsonDepth = 32;
+
+// The elements of a tool call, in order, each one after optional whitespace.
+enum class Element : uint8_t {
+  kOpenBrace,     // {
+  kNameKey,       // "name"
+  kNameColon,     // :
+  kName,          // "<tool name>"
+  kComma,         // ,
+  kArgumentsKey,  // "arguments"
+  kArgumentsColon,  // :
+  kArguments,     // {<JSON object>}
+  kCloseBrace,    // }
+  kCodeFenceEnd,  // </tool_call>
+};
+
+// The states of the JSON arguments, between and within their tokens.
+enum class Json : uint8_t {
+  kValue,             // Before a value.
+  kKeyOrObjectEnd,    // After "{".
+  kKey,               // After "," in an object.
+  kColon,             // After a key.
+  kValueOrArrayEnd,   // After "[".
+  kAfterValue,        // After a value, before "," or the end of a container.
+  kString,            // Within a string.
+  kEscape,            // After "\" in a string.
+  kUnicode,           // Within "\uXXXX", `aux` hex digits read.
+  kNumberSign,        // After "-".
+  kNumberZero,        // After a leading "0".
+  kNumberInteger,     // Within the integer digits.
+  kNumberFractionStart,  // After ".".
+  kNumberFraction,    // Within the fraction digits.
+  kNumberExponentStart,  // After "e".
+  kNumberExponentSign,   // After "e+" or "e-".
+  kNumberExponent,    // Within the exponent digits.
+  kLiteral,           // Within true, false or null, see `literal`.
+};
+
+constexpr absl::string_view kLiterals[] = {"true", "false", "null"};
+
+bool IsWhitespace(char c) {
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+bool IsHexDigit(char c) {
+  return IsDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+absl::string_view LiteralOf(Element element) {
+  switch (element) {
+    case Element::kOpenBrace:
+      return "{";
+    case Element::kNameKey:
+      return "\"name\"";
+    case Element::kNameColon:
+    case Element::kArgumentsColon:
+      return ":";
+    case Element::kComma:
+      return ",";
+    case Element::kArgumentsKey:
+      return "\"arguments\"";
+    case Element::kCloseBrace:
+      return "}";
+    default:
+      return "";
+  }
+}
+
+}  // namespace
+
+// The state of the grammar after some text. Two matches with the same Key()
+// allow the same tokens.
+struct Qwen3ToolCallConstraint::Match {
+  // Whether the text is within a tool call, else the number of characters of
+  // the code fence start matched so far.
+  bool in_call = false;
+  int fence_start_matched = 0;
+
+  // The element of the tool call being matched, and the characters matched
+  // within it: of its literal, of the code fence end, or of the name.
+  Element element = Element::kOpenBrace;
+  int matched = 0;
+  std::string name;
+
+  // The JSON arguments: the open containers, '{' or '[', and the state within
+  // the innermost one.
+  std::string containers;
+  Json json = Json::kValue;
+  bool in_key = false;
+  int literal = 0;
+  int aux = 0;
+
+  std::string Key() const {
+    // The text outside of the tool calls allows every token.
+    if (!in_call) {
+      return "t";
+    }
+    return absl::StrCat("c", static_cast<int>(element), ",", matched, ",",
+                        name, ",", containers, ",", static_cast<int>(json),
+                        ",", in_key, ",", literal, ",", aux);
+  }
+};
+
+namespace {
+
+using Match = Qwen3ToolCallConstraint::Match;
+
+// The grammar of the tool calls, applied to a match one character at a time.
+class Grammar {
+ public:
+  Grammar(absl::Span<const std::string> tool_names,
+          absl::string_view code_fence_start, absl::string_view code_fence_end)
+      : tool_names_(tool_names),
+        code_fence_start_(code_fence_start),
+        code_fence_end_(code_fence_end),
+        fence_start_failure_(code_fence_start.size(), 0) {
+    // The failure function of Knuth-Morris-Pratt, to find the code fence
+    // start anywhere in the text.
+    for (int i = 1, k = 0; i < code_fence_start_.size(); ++i) {
+      while (k > 0 && code_fence_start_[i] != code_fence_start_[k]) {
+        k = fence_start_failure_[k - 1];
+      }
+      if (code_fence_start_[i] == code_fence_start_[k]) {
+        ++k;
+      }
+      fence_start_failure_[i] = k;
+    }
+  }
+
+  // Advances `match` by `c`, returns false if the grammar does not allow it.
+  bool Advance(Match& match, char c) const {
+    if (!match.in_call) {
+      AdvanceText(match, c);
+      return true;
+    }
+    switch (match.element) {
+      case Element::kName:
+        return AdvanceName(match, c);
+      case Element::kArguments:
+        return AdvanceArguments(match, c);
+      case Element::kCodeFenceEnd:
+        if (match.matched == 0 && IsWhitespace(c)) {
+          return true;
+        }
+        if (code_fence_end_[match.matched] != c) {
+          return false;
+        }
+        if (++match.matched == code_fence_end_.size()) {
+          match = Match();
+        }
+        return true;
+      default: {
+        absl::string_view literal = LiteralOf(match.element);
+        if (match.matched == 0 && IsWhitespace(c)) {
+          return true;
+        }
+        if (literal[match.matched] != c) {
+          return false;
+        }
+        if (++match.matched == literal.size()) {
+          NextElement(match);
+        }
+        return true;
+      }
+    }
+  }
+
+ private:
+  static void NextElement(Match& match) {
+    match.element = static_cast<Element>(static_cast<int>(match.element) + 1);
+    match.matched = 0;
+  }
+
+  void AdvanceText(Match& match, char c) const {
+    int k = match.fence_start_matched;
+    while (k > 0 && code_fence_start_[k] != c) {
+      k = fence_start_failure_[k - 1];
+    }
+    if (code_fence_start_[k] == c) {
+      ++k;
+    }
+    if (k == code_fence_start_.size()) {
+      match = Match();
+      match.in_call = true;
+      return;
+    }
+    match.fence_start_matched = k;
+  }
+
+  // Matches the quoted name of one of the tools.
+  bool AdvanceName(Match& match, char c) const {
+    if (match.matched == 0) {
+      if (IsWhitespace(c)) {
+        return true;
+      }
+      if (c != '"') {
+        return false;
+      }
+      match.matched = 1;
+      return true;
+    }
+    if (c == '"') {
+      for (const std::string& tool_name : tool_names_) {
+        if (tool_name == match.name) {
+          match.name.clear();
+          NextElement(match);
+          return true;
+        }
+      }
+      return false;
+    }
+    match.name.push_back(c);
+    for (const std::string& tool_name : tool_names_) {
+      if (absl::StartsWith(tool_name, match.name)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Matches a JSON object. The values are not checked against the parameters
+  // of the tool, only their syntax is.
+  bool AdvanceArguments(Match& match, char c) const {
+    switch (match.json) {
+      case Json::kValue:
+        if (match.containers.empty()) {
+          // The arguments are an object.
+          if (IsWhitespace(c)) {
+            return true;
+          }
+          if (c != '{') {
+            return false;
+          }
+          match.containers.push_back('{');
+          match.json = Json::kKeyOrObjectEnd;
+          return true;
+        }
+        return StartValue(match, c);
+      case Json::kKeyOrObjectEnd:
+        if (c == '}') {
+          return EndContainer(match, '{');
+        }
+        [[fallthrough]];
+      case Json::kKey:
+        if (IsWhitespace(c)) {
+          return true;
+        }
+        if (c != '"') {
+          return false;
+        }
+        match.json = Json::kString;
+        match.in_key = true;
+        return true;
+      case Json::kColon:
+        if (IsWhitespace(c)) {
+          return true;
+        }
+        if (c != ':') {
+          return false;
+        }
+        match.json = Json::kValue;
+        return true;
+      case Json::kValueOrArrayEnd:
+        if (c == ']') {
+          return EndContainer(match, '[');
+        }
+        return StartValue(match, c);
+      case Json::kAfterValue:
+        if (IsWhitespace(c)) {
+          return true;
+        }
+        if (c == ',') {
+          match.json =
+              match.containers.back() == '{' ? Json::kKey : Json::kValue;
+          return true;
+        }
+        if (c == '}') {
+          return EndContainer(match, '{');
+        }
+        if (c == ']') {
+          return EndContainer(match, '[');
+        }
+        return false;
+      case Json::kString:
+        if (c == '"') {
+          match.json = match.in_key ? Json::kColon : Json::kAfterValue;
+          match.in_key = false;
+          return true;
+        }
+        if (c == '\\') {
+          match.json = Json::kEscape;
+          return true;
+        }
+        // The control characters must be escaped, the bytes of the UTF-8
+        // characters are taken as they come.
+        return static_cast<unsigned char>(c) >= 0x20;
+      case Json::kEscape:
+        if (c == 'u') {
+          match.json = Json::kUnicode;
+          match.aux = 0;
+          return true;
+        }
+        if (absl::string_view("\"\\/bfnrt").find(c) ==
+            absl::string_view::npos) {
+          return false;
+        }
+        match.json = Json::kString;
+        return true;
+      case Json::kUnicode:
+        if (!IsHexDigit(c)) {
+          return false;
+        }
+        if (++match.aux == 4) {
+          match.json = Json::kString;
+          match.aux = 0;
+        }
+        return true;
+      case Json::kNumberSign:
+        if (!IsDigit(c)) {
+          return false;
+        }
+        match.json = c == '0' ? Json::kNumberZero : Json::kNumberInteger;
+        return true;
+      case Json::kNumberInteger:
+        if (IsDigit(c)) {
+          return true;
+        }
+        [[fallthrough]];
+      case Json::kNumberZero:
+        if (c == '.') {
+          match.json = Json::kNumberFractionStart;
+          return true;
+        }
+        if (c == 'e' || c == 'E') {
+          match.json = Json::kNumberExponentStart;
+          return true;
+        }
+        return EndNumber(match, c);
+      case Json::kNumberFractionStart:
+        if (!IsDigit(c)) {
+          return false;
+        }
+        match.json = Json::kNumberFraction;
+        return true;
+      case Json::kNumberFraction:
+        if (IsDigit(c)) {
+          return true;
+        }
+        if (c == 'e' || c == 'E') {
+          match.json = Json::kNumberExponentStart;
+          return true;
+        }
+        return EndNumber(match, c);
+      case Json::kNumberExponentStart:
+        if (c == '+' || c == '-') {
+          match.json = Json::kNumberExponentSign;
+          return true;
+        }
+        [[fallthrough]];
+      case Json::kNumberExponentSign:
+        if (!IsDigit(c)) {
+          return false;
+        }
+        match.json = Json::kNumberExponent;
+        return true;
+      case Json::kNumberExponent:
+        if (IsDigit(c)) {
+          return true;
+        }
+        return EndNumber(match, c);
+      case Json::kLiteral: {
+        absl::string_view literal = kLiterals[match.literal];
+        if (literal[match.aux] != c) {
+          return false;
+        }
+        if (++match.aux == literal.size()) {
+          match.json = Json::kAfterValue;
+          match.literal = 0;
+          match.aux = 0;
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool StartValue(Match& match, char c) const {
+    if (IsWhitespace(c)) {
+      return true;
+    }
+    if (c == '{' || c == '[') {
+      if (match.containers.size() >= kMaxJsonDepth) {
+        return false;
+      }
+      match.containers.push_back(c);
+      match.json = c == '{' ? Json::kKeyOrObjectEnd : Json::kValueOrArrayEnd;
+      return true;
+    }
+    if (c == '"') {
+      match.json = Json::kString;
+      return true;
+    }
+    if (c == '-') {
+      match.json = Json::kNumberSign;
+      return true;
+    }
+    if (IsDigit(c)) {
+      match.json = c == '0' ? Json::kNumberZero : Json::kNumberInteger;
+      return true;
+    }
+    for (int i = 0; i < std::size(kLiterals); ++i) {
+      if (kLiterals[i][0] == c) {
+        match.json = Json::kLiteral;
+        match.literal = i;
+        match.aux = 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Ends a number on the character following it.
+  bool EndNumber(Match& match, char c) const {
+    match.json = Json::kAfterValue;
+    return AdvanceArguments(match, c);
+  }
+
+  bool EndContainer(Match& match, char container) const {
+    if (match.containers.back() != container) {
+      return false;
+    }
+    match.containers.pop_back();
+    match.json = Json::kAfterValue;
+    if (match.containers.empty()) {
+      match.json = Json::kValue;
+      NextElement(match);
+    }
+    return true;
+  }
+
+  absl::Span<const std::string> tool_names_;
+  absl::string_view code_fence_start_;
+  absl::string_view code_fence_end_;
+  std::vector<int> fence_start_failure_;
+};
+
+class MatchState : public Constraint::State {
+ public:
+  explicit MatchState(Match match) : match_(std::move(match)) {}
+
+  const Match& match() const { return match_; }
+
+ private:
+  Match match_;
+};
+
+class MaskBitmap : public Bitmap {
+ public:
+  explicit MaskBitmap(std::shared_ptr<const std::vector<uint32_t>> words)
+      : words_(std::move(words)) {}
+
+  bool Get(int index) const override {
+    return index >= 0 && index / 32 < words_->size() &&
+           ((*words_)[index / 32] >> (index % 32)) & 1;
+  }
+
+ private:
+  std::shared_ptr<const std::vector<uint32_t>> words_;
+};
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<Qwen3ToolCallConstraint>>
+Qwen3ToolCallConstraint::Create(const nlohmann::ordered_json& tools,
+                                absl::string_view code_fence_start,
+                                absl::string_view code_fence_end,
+                                std::vector<std::string> token_texts,
+                                int vocabulary_size) {
+  if (code_fence_start.empty() || code_fence_end.empty()) {
+    return absl::InvalidArgumentError("The code fences must not be empty.");
+  }
+  if (vocabulary_size <= 0 || token_texts.size() > vocabulary_size) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid vocabulary size: ", vocabulary_size));
+  }
+  if (!tools.is_array() || tools.empty()) {
+    return absl::InvalidArgumentError("Tools must be a non-empty array.");
+  }
+  std::vector<std::string> tool_names;
+  for (const auto& tool : tools) {
+    // The tools are either functions or OpenAI style {"type": "function",
+    // "function": {...}}.
+    const auto& function = tool.contains("function") ? tool["function"] : tool;
+    if (!function.contains("name") || !function["name"].is_string() ||
+        function["name"].get<std::string>().empty()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Tool without a name: ", tool.dump()));
+    }
+    tool_names.push_back(function["name"].get<std::string>());
+  }
+  return absl::WrapUnique(new Qwen3ToolCallConstraint(
+      std::move(tool_names), std::string(code_fence_start),
+      std::string(code_fence_end), std::move(token_texts), vocabulary_size));
+}
+
+Qwen3ToolCallConstraint::Qwen3ToolCallConstraint(
+    std::vector<std::string> tool_names, std::string code_fence_start,
+    std::string code_fence_end, std::vector<std::string> token_texts,
+    int vocabulary_size)
+    : tool_names_(std::move(tool_names)),
+      code_fence_start_(std::move(code_fence_start)),
+      code_fence_end_(std::move(code_fence_end)),
+      token_texts_(std::move(token_texts)),
+      vocabulary_size_(vocabulary_size) {}
+
+std::unique_ptr<Constraint::State> Qwen3ToolCallConstraint::Start() const {
+  return std::make_unique<MatchState>(Match());
+}
+
+bool Qwen3ToolCallConstraint::IsEnded(const State& state) const {
+  // The text after the tool calls is free, the turn ends with its end token.
+  return false;
+}
+
+absl::StatusOr<std::unique_ptr<Constraint::State>>
+Qwen3ToolCallConstraint::ComputeNext(const State& state, int token) const {
+  Match match = static_cast<const MatchState&>(state).match();
+  if (token < 0 || token >= vocabulary_size_) {
+    return absl::InvalidArgumentError(absl::StrCat("Invalid token: ", token));
+  }
+  absl::string_view text =
+      token < token_texts_.size() ? token_texts_[token] : "";
+  if (match.in_call && text.empty()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Token ", token, " is not allowed in a tool call."));
+  }
+  Grammar grammar(tool_names_, code_fence_start_, code_fence_end_);
+  for (char c : text) {
+    if (!grammar.Advance(match, c)) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Token ", token, " is not allowed in a tool call."));
+    }
+  }
+  return std::make_unique<MatchState>(std::move(match));
+}
+
+absl::StatusOr<std::unique_ptr<Bitmap>> Qwen3ToolCallConstraint::ComputeBitmap(
+    const State& state) const {
+  ASSIGN_OR_RETURN(auto bitmask,
+                   GetBitmask(static_cast<const MatchState&>(state).match()));
+  return std::make_unique<MaskBitmap>(std::move(bitmask));
+}
+
+absl::Status Qwen3ToolCallConstraint::FillTokenBitmask(
+    absl::Span<const int> token_ids, absl::Span<uint32_t> bitmask) const {
+  RET_CHECK_EQ(bitmask.size(), (vocabulary_size_ + 31) / 32);
+  std::unique_ptr<State> state = Start();
+  for (int token_id : token_ids) {
+    ASSIGN_OR_RETURN(state, ComputeNext(*state, token_id));
+  }
+  ASSIGN_OR_RETURN(auto words,
+                   GetBitmask(static_cast<const MatchState&>(*state).match()));
+  std::copy(words->begin(), words->end(), bitmask.begin());
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::shared_ptr<const std::vector<uint32_t>>>
+Qwen3ToolCallConstraint::GetBitmask(const Match& match) const {
+  const std::string key = match.Key();
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = bitmasks_.find(key);
+    if (it != bitmasks_.end()) {
+      return it->second;
+    }
+  }
+  // Computed out of the lock: the concurrent decodes reaching the same new
+  // state compute the same bitmask.
+  Grammar grammar(tool_names_, code_fence_start_, code_fence_end_);
+  auto words =
+      std::make_shared<std::vector<uint32_t>>((vocabulary_size_ + 31) / 32);
+  for (int token = 0; token < vocabulary_size_; ++token) {
+    absl::string_view text =
+        token < token_texts_.size() ? token_texts_[token] : "";
+    bool allowed = !match.in_call || !text.empty();
+    if (allowed && match.in_call) {
+      Match next = match;
+      for (char c : text) {
+        if (!grammar.Advance(next, c)) {
+          allowed = false;
+          break;
+        }
+      }
+    }
+    if (allowed) {
+      (*words)[token / 32] |= 1u << (token % 32);
+    }
+  }
+  absl::MutexLock lock(&mutex_);
+  if (bitmasks_.size() >= kMaxNumBitmasks) {
+    bitmasks_.clear();
+  }
+  bitmasks_.emplace(key, words);
+  return words;
+}
+
+}  // namespace litert::lm
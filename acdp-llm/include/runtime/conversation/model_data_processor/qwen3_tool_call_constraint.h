@@ -0,0 +1,105 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MODEL_DATA_PROCESSOR_QWEN3_TOOL_CALL_CONSTRAINT_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MODEL_DATA_PROCESSOR_QWEN3_TOOL_CALL_CONSTRAINT_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "nlohmann/json.hpp"  // from @nlohmann_json
+#include "runtime/components/constrained_decoding/bitmap.h"
+#include "runtime/components/constrained_decoding/constraint.h"
+#include "runtime/core/constraint_extensions.h"
+
+namespace litert::lm {
+
+// Constrains the tool calls of Qwen3 to its JSON format,
+//   <tool_call>
+//   {"name": "<tool name>", "arguments": {<JSON object>}}
+//   </tool_call>
+// the name being one of the tools and the arguments well-formed JSON. The
+// text outside of the code fences is not constrained, and the turn can only
+// end outside of them.
+//
+// The grammar is matched on the texts of the tokens, one character at a time.
+// The bitmask of the tokens allowed in a state of the grammar is computed once
+// and reused by the decodes sharing the constraint, e.g. through the
+// ConstraintCache: the states within a JSON string or between two tool calls
+// are the same whatever the text, so a few states cover most of the steps.
+class Qwen3ToolCallConstraint : public Constraint,
+                                public TokenBitmaskConstraint {
+ public:
+  // Creates the constraint of the tool calls of `tools`, in the format of
+  // Qwen3DataProcessor::FormatTools. `token_texts` holds the text of each
+  // token of the model, empty for the special tokens, which are only allowed
+  // outside of the code fences.
+  static absl::StatusOr<std::unique_ptr<Qwen3ToolCallConstraint>> Create(
+      const nlohmann::ordered_json& tools, absl::string_view code_fence_start,
+      absl::string_view code_fence_end, std::vector<std::string> token_texts,
+      int vocabulary_size);
+
+  // Constraint:
+  std::unique_ptr<State> Start() const override;
+  bool IsEnded(const State& state) const override;
+  int GetVocabularySize() const override { return vocabulary_size_; }
+  absl::StatusOr<std::unique_ptr<State>> ComputeNext(
+      const State& state, int token) const override;
+  absl::StatusOr<std::unique_ptr<Bitmap>> ComputeBitmap(
+      const State& state) const override;
+
+  // TokenBitmaskConstraint:
+  absl::Status FillTokenBitmask(absl::Span<const int> token_ids,
+                                absl::Span<uint32_t> bitmask) const override;
+
+  // The state of the grammar after some text, see the .cc file.
+  struct Match;
+
+ private:
+  Qwen3ToolCallConstraint(std::vector<std::string> tool_names,
+                          std::string code_fence_start,
+                          std::string code_fence_end,
+                          std::vector<std::string> token_texts,
+                          int vocabulary_size);
+
+  // Returns the bitmask of the tokens allowed in `match`, memoized.
+  absl::StatusOr<std::shared_ptr<const std::vector<uint32_t>>> GetBitmask(
+      const Match& match) const;
+
+  const std::vector<std::string> tool_names_;
+  const std::string code_fence_start_;
+  const std::string code_fence_end_;
+  const std::vector<std::string> token_texts_;
+  const int vocabulary_size_;
+
+  mutable absl::Mutex mutex_;
+  // The bitmasks of the states reached so far, keyed by Match::Key().
+  mutable absl::flat_hash_map<std::string,
+                              std::shared_ptr<const std::vector<uint32_t>>>
+      bitmasks_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MODEL_DATA_PROCESSOR_QWEN3_TOOL_CALL_CONSTRAINT_H_
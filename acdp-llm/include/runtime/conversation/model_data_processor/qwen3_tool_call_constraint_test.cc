@@ -0,0 +1,164 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/conversation/model_data_processor/qwen3_tool_call_constraint.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "nlohmann/json.hpp"  // from @nlohmann_json
+#include "runtime/util/status_macros.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using json = nlohmann::ordered_json;
+using ::testing::Contains;
+using ::testing::ElementsAre;
+using ::testing::Not;
+using ::testing::status::IsOkAndHolds;
+using ::testing::status::StatusIs;
+
+// A toy vocabulary splitting a tool call the way a BPE tokenizer would.
+const std::vector<std::string>& TokenTexts() {
+  static const auto* const kTokenTexts = new std::vector<std::string>{
+      "",              // 0: the end of turn, a special token.
+      "Hello",         // 1
+      "<tool_call>",   // 2
+      "\n",            // 3
+      "{\"",           // 4
+      "name",          // 5
+      "\":",           // 6
+      " \"",           // 7
+      "get",           // 8
+      "_weather",      // 9
+      "\",",           // 10
+      " \"arguments",  // 11
+      " {\"",          // 12
+      "city",          // 13
+      "\": ",          // 14
+      "\"Paris",       // 15
+      "\"}}",          // 16
+      "</tool_call>",  // 17
+      "}",             // 18
+      "]",             // 19
+      "1",             // 20
+      "\"",            // 21
+      "x",             // 22
+      "{",             // 23
+  };
+  return *kTokenTexts;
+}
+
+// The prefix of a tool call up to its arguments.
+const std::vector<int> kCallPrefix = {2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 6};
+
+absl::StatusOr<std::unique_ptr<Qwen3ToolCallConstraint>> CreateConstraint() {
+  const json tools = json::parse(R"json([{
+    "type": "function",
+    "function": {
+      "name": "get_weather",
+      "parameters": {"type": "object",
+                     "properties": {"city": {"type": "string"}}}
+    }
+  }])json");
+  return Qwen3ToolCallConstraint::Create(tools, "<tool_call>", "</tool_call>",
+                                         TokenTexts(), TokenTexts().size());
+}
+
+absl::StatusOr<std::vector<int>> AllowedTokens(
+    const Qwen3ToolCallConstraint& constraint, std::vector<int> token_ids) {
+  std::vector<uint32_t> bitmask((constraint.GetVocabularySize() + 31) / 32);
+  RETURN_IF_ERROR(
+      constraint.FillTokenBitmask(token_ids, absl::MakeSpan(bitmask)));
+  std::vector<int> allowed;
+  for (int token = 0; token < constraint.GetVocabularySize(); ++token) {
+    if ((bitmask[token / 32] >> (token % 32)) & 1) {
+      allowed.push_back(token);
+    }
+  }
+  return allowed;
+}
+
+std::vector<int> Concat(std::vector<int> a, const std::vector<int>& b) {
+  a.insert(a.end(), b.begin(), b.end());
+  return a;
+}
+
+TEST(Qwen3ToolCallConstraintTest, AllowsEveryTokenOutsideOfToolCalls) {
+  ASSERT_OK_AND_ASSIGN(auto constraint, CreateConstraint());
+  ASSERT_OK_AND_ASSIGN(auto allowed, AllowedTokens(*constraint, {1, 3}));
+  EXPECT_EQ(allowed.size(), TokenTexts().size());
+}
+
+TEST(Qwen3ToolCallConstraintTest, ConstrainsTheToolCallSkeleton) {
+  ASSERT_OK_AND_ASSIGN(auto constraint, CreateConstraint());
+  EXPECT_THAT(AllowedTokens(*constraint, {1, 2, 3, 4}),
+              IsOkAndHolds(ElementsAre(5)));
+  EXPECT_THAT(AllowedTokens(*constraint, {2, 3, 4, 5, 6, 7}),
+              IsOkAndHolds(ElementsAre(8)));
+  EXPECT_THAT(AllowedTokens(*constraint, {2, 3, 4, 5, 6, 7, 8, 9}),
+              IsOkAndHolds(ElementsAre(10, 21)));
+  // The arguments are an object.
+  EXPECT_THAT(AllowedTokens(*constraint, kCallPrefix),
+              IsOkAndHolds(ElementsAre(3, 4, 12, 23)));
+}
+
+TEST(Qwen3ToolCallConstraintTest, ConstrainsTheArgumentsToJson) {
+  ASSERT_OK_AND_ASSIGN(auto constraint, CreateConstraint());
+  ASSERT_OK_AND_ASSIGN(
+      auto allowed,
+      AllowedTokens(*constraint, Concat(kCallPrefix, {12, 13, 14, 20})));
+  EXPECT_THAT(allowed, Contains(18));
+  EXPECT_THAT(allowed, Contains(20));
+  EXPECT_THAT(allowed, Not(Contains(19)));
+  EXPECT_THAT(allowed, Not(Contains(0)));
+}
+
+TEST(Qwen3ToolCallConstraintTest, AllowsEveryTokenAfterTheToolCall) {
+  ASSERT_OK_AND_ASSIGN(auto constraint, CreateConstraint());
+  EXPECT_THAT(AllowedTokens(*constraint,
+                            Concat(kCallPrefix, {12, 13, 14, 15, 16, 3})),
+              IsOkAndHolds(ElementsAre(3, 17)));
+  ASSERT_OK_AND_ASSIGN(
+      auto allowed,
+      AllowedTokens(*constraint,
+                    Concat(kCallPrefix, {12, 13, 14, 15, 16, 3, 17})));
+  EXPECT_EQ(allowed.size(), TokenTexts().size());
+}
+
+TEST(Qwen3ToolCallConstraintTest, RejectsUnknownToolName) {
+  ASSERT_OK_AND_ASSIGN(auto constraint, CreateConstraint());
+  EXPECT_THAT(AllowedTokens(*constraint, {2, 3, 4, 5, 6, 7, 22}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(Qwen3ToolCallConstraintTest, FailsWithoutTools) {
+  EXPECT_THAT(Qwen3ToolCallConstraint::Create(json::array(), "<tool_call>",
+                                              "</tool_call>", TokenTexts(),
+                                              TokenTexts().size()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,117 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/conversation/model_data_processor/shared_preprocessors.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/components/preprocessor/audio_preprocessor.h"
+#include "runtime/components/preprocessor/audio_preprocessor_miniaudio.h"
+#include "runtime/components/preprocessor/image_preprocessor.h"
+#include "runtime/components/preprocessor/stb_image_preprocessor.h"
+#include "runtime/core/vectorized_image_preprocessor.h"
+#include "runtime/framework/threadpool.h"
+#include "runtime/util/status_macros.h"
+
+namespace litert::lm {
+namespace {
+
+// The number of idle audio preprocessors kept by the default pool, enough for
+// the audio conversions of a few concurrent conversations.
+constexpr int kDefaultMaxNumIdleAudioPreprocessors = 4;
+
+// The number of threads preprocessing the images, shared by all the
+// conversions.
+constexpr int kNumImagePreprocessingThreads = 4;
+
+}  // namespace
+
+std::shared_ptr<ImagePreprocessor> GetSharedImagePreprocessor(
+    bool use_vectorized_image_preprocessor) {
+  static const auto* const stb_image_preprocessor =
+      new std::shared_ptr<ImagePreprocessor>(
+          std::make_shared<StbImagePreprocessor>());
+  static const auto* const vectorized_image_preprocessor =
+      new std::shared_ptr<ImagePreprocessor>(
+          std::make_shared<VectorizedImagePreprocessor>());
+  return use_vectorized_image_preprocessor ? *vectorized_image_preprocessor
+                                           : *stb_image_preprocessor;
+}
+
+ThreadPool& GetSharedImagePreprocessingThreadPool() {
+  static ThreadPool* const thread_pool =
+      new ThreadPool(/*name_prefix=*/"image_preprocessing",
+                     /*max_num_threads=*/kNumImagePreprocessingThreads);
+  return *thread_pool;
+}
+
+void AudioPreprocessorPool::Releaser::operator()(
+    AudioPreprocessor* preprocessor) const {
+  pool_->Release(std::unique_ptr<AudioPreprocessor>(preprocessor));
+}
+
+AudioPreprocessorPool::AudioPreprocessorPool(CreateFn create,
+                                             int max_num_idle_preprocessors)
+    : create_(std::move(create)),
+      max_num_idle_preprocessors_(max_num_idle_preprocessors) {}
+
+// static
+AudioPreprocessorPool& AudioPreprocessorPool::GetDefault() {
+  static AudioPreprocessorPool* const pool = new AudioPreprocessorPool(
+      []() -> absl::StatusOr<std::unique_ptr<AudioPreprocessor>> {
+        ASSIGN_OR_RETURN(
+            auto preprocessor,
+            AudioPreprocessorMiniAudio::Create(
+                AudioPreprocessorConfig::CreateDefaultUsmConfig()));
+        return preprocessor;
+      },
+      kDefaultMaxNumIdleAudioPreprocessors);
+  return *pool;
+}
+
+absl::StatusOr<AudioPreprocessorPool::Lease> AudioPreprocessorPool::Acquire() {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!idle_preprocessors_.empty()) {
+      std::unique_ptr<AudioPreprocessor> preprocessor =
+          std::move(idle_preprocessors_.back());
+      idle_preprocessors_.pop_back();
+      return Lease(preprocessor.release(), Releaser(this));
+    }
+  }
+  // Creating a preprocessor computes its filterbanks, so it is done without
+  // the lock.
+  ASSIGN_OR_RETURN(std::unique_ptr<AudioPreprocessor> preprocessor, create_());
+  return Lease(preprocessor.release(), Releaser(this));
+}
+
+int AudioPreprocessorPool::GetNumIdlePreprocessors() const {
+  absl::MutexLock lock(&mutex_);
+  return idle_preprocessors_.size();
+}
+
+void AudioPreprocessorPool::Release(
+    std::unique_ptr<AudioPreprocessor> preprocessor) {
+  // The next lease starts a new stream.
+  preprocessor->Reset();
+  absl::MutexLock lock(&mutex_);
+  if (idle_preprocessors_.size() < max_num_idle_preprocessors_) {
+    idle_preprocessors_.push_back(std::move(preprocessor));
+  }
+}
+
+}  // namespace litert::lm
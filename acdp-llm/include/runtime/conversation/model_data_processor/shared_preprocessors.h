@@ -0,0 +1,101 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MODEL_DATA_PROCESSOR_SHARED_PREPROCESSORS_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MODEL_DATA_PROCESSOR_SHARED_PREPROCESSORS_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/components/preprocessor/audio_preprocessor.h"
+#include "runtime/components/preprocessor/image_preprocessor.h"
+#include "runtime/framework/threadpool.h"
+
+namespace litert::lm {
+
+// Returns the process-wide image preprocessor, shared by the model data
+// processors. The image preprocessors keep no state between the images, and
+// already preprocess the images of a message concurrently.
+std::shared_ptr<ImagePreprocessor> GetSharedImagePreprocessor(
+    bool use_vectorized_image_preprocessor);
+
+// Returns the process-wide thread pool the model data processors preprocess
+// the images of a message on. The conversions of the concurrent conversations
+// share its few threads, instead of starting a thread per image.
+ThreadPool& GetSharedImagePreprocessingThreadPool();
+
+// A pool of audio preprocessors, leased by the model data processors for the
+// duration of a conversion. Unlike the image preprocessors, an audio
+// preprocessor keeps the state of the stream it is preprocessing until it is
+// reset, so it is never used by two conversions at the same time. The
+// preprocessors and their filterbanks are created once per concurrent
+// conversion instead of once per conversation. The pool is thread-safe.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(AudioPreprocessorPool::Lease audio_preprocessor,
+//                    AudioPreprocessorPool::GetDefault().Acquire());
+//   ASSIGN_OR_RETURN(auto preprocessed_audio,
+//                    audio_preprocessor->Preprocess(audio));
+class AudioPreprocessorPool {
+ public:
+  using CreateFn = absl::AnyInvocable<
+      absl::StatusOr<std::unique_ptr<AudioPreprocessor>>() const>;
+
+  // Resets the leased preprocessor and returns it to its pool.
+  class Releaser {
+   public:
+    explicit Releaser(AudioPreprocessorPool* pool = nullptr) : pool_(pool) {}
+    void operator()(AudioPreprocessor* preprocessor) const;
+
+   private:
+    AudioPreprocessorPool* pool_;
+  };
+  using Lease = std::unique_ptr<AudioPreprocessor, Releaser>;
+
+  // The pool keeps at most `max_num_idle_preprocessors` preprocessors
+  // created with `create` between the leases. The pool must outlive its
+  // leases.
+  AudioPreprocessorPool(CreateFn create, int max_num_idle_preprocessors);
+
+  AudioPreprocessorPool(const AudioPreprocessorPool&) = delete;
+  AudioPreprocessorPool& operator=(const AudioPreprocessorPool&) = delete;
+
+  // Returns the process-wide pool of the MiniAudio preprocessors with the
+  // default USM config.
+  static AudioPreprocessorPool& GetDefault();
+
+  // Leases an idle preprocessor, or a new one when all are leased. The errors
+  // of creating it are returned.
+  absl::StatusOr<Lease> Acquire();
+
+  // Returns the number of the idle preprocessors kept in the pool.
+  int GetNumIdlePreprocessors() const;
+
+ private:
+  void Release(std::unique_ptr<AudioPreprocessor> preprocessor);
+
+  const CreateFn create_;
+  const int max_num_idle_preprocessors_;
+  mutable absl::Mutex mutex_;
+  std::vector<std::unique_ptr<AudioPreprocessor>> idle_preprocessors_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_MODEL_DATA_PROCESSOR_SHARED_PREPROCESSORS_H_
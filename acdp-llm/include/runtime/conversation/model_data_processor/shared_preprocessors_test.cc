@@ -0,0 +1,94 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/conversation/model_data_processor/shared_preprocessors.h"
+
+#include <memory>
+#include <utility>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "runtime/components/preprocessor/audio_preprocessor.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::StatusIs;
+
+class FakeAudioPreprocessor : public AudioPreprocessor {
+ public:
+  explicit FakeAudioPreprocessor(int* num_resets) : num_resets_(num_resets) {}
+
+  absl::StatusOr<InputAudio> Preprocess(
+      const InputAudio& input_audio) override {
+    return absl::UnimplementedError("Not implemented.");
+  }
+
+  void Reset() override { ++*num_resets_; }
+
+ private:
+  int* num_resets_;
+};
+
+TEST(SharedPreprocessorsTest, SharesTheImagePreprocessors) {
+  EXPECT_EQ(GetSharedImagePreprocessor(/*use_vectorized_image_preprocessor=*/
+                                       false),
+            GetSharedImagePreprocessor(false));
+  EXPECT_EQ(GetSharedImagePreprocessor(true), GetSharedImagePreprocessor(true));
+  EXPECT_NE(GetSharedImagePreprocessor(true),
+            GetSharedImagePreprocessor(false));
+}
+
+TEST(AudioPreprocessorPoolTest, ReusesTheReleasedPreprocessors) {
+  int num_created = 0;
+  int num_resets = 0;
+  AudioPreprocessorPool pool(
+      [&]() -> absl::StatusOr<std::unique_ptr<AudioPreprocessor>> {
+        ++num_created;
+        return std::make_unique<FakeAudioPreprocessor>(&num_resets);
+      },
+      /*max_num_idle_preprocessors=*/1);
+  AudioPreprocessor* first_preprocessor;
+  {
+    ASSERT_OK_AND_ASSIGN(auto lease, pool.Acquire());
+    first_preprocessor = lease.get();
+    // A preprocessor is only leased once at a time.
+    ASSERT_OK_AND_ASSIGN(auto other_lease, pool.Acquire());
+    EXPECT_NE(other_lease.get(), first_preprocessor);
+  }
+  EXPECT_EQ(num_created, 2);
+  EXPECT_EQ(num_resets, 2);
+  // Only one of the released preprocessors is kept.
+  EXPECT_EQ(pool.GetNumIdlePreprocessors(), 1);
+  ASSERT_OK_AND_ASSIGN(auto lease, pool.Acquire());
+  EXPECT_EQ(num_created, 2);
+  EXPECT_EQ(pool.GetNumIdlePreprocessors(), 0);
+}
+
+TEST(AudioPreprocessorPoolTest, ReturnsTheErrorsOfCreatingAPreprocessor) {
+  AudioPreprocessorPool pool(
+      []() -> absl::StatusOr<std::unique_ptr<AudioPreprocessor>> {
+        return absl::InternalError("Failed to create.");
+      },
+      /*max_num_idle_preprocessors=*/1);
+  EXPECT_THAT(pool.Acquire(), StatusIs(absl::StatusCode::kInternal));
+  EXPECT_EQ(pool.GetNumIdlePreprocessors(), 0);
+}
+
+}  // namespace
+}  // namespace litert::lm
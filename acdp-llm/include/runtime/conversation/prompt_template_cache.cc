@@ -0,0 +1,69 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/conversation/prompt_template_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/components/prompt_template.h"
+
+namespace litert::lm {
+
+// static
+PromptTemplateCache& PromptTemplateCache::GetDefault() {
+  static PromptTemplateCache* const cache = new PromptTemplateCache();
+  return *cache;
+}
+
+std::shared_ptr<const PromptTemplate> PromptTemplateCache::GetOrCreate(
+    absl::string_view source) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (auto it = templates_.find(source); it != templates_.end()) {
+      if (std::shared_ptr<const PromptTemplate> prompt_template =
+              it->second.lock()) {
+        return prompt_template;
+      }
+    }
+  }
+  // Parsing a template may take a while, so it is done without the lock.
+  auto prompt_template =
+      std::make_shared<const PromptTemplate>(std::string(source));
+  absl::MutexLock lock(&mutex_);
+  // Forget the templates freed since.
+  absl::erase_if(templates_, [](const auto& entry) {
+    return entry.second.expired();
+  });
+  auto [it, inserted] = templates_.try_emplace(source, prompt_template);
+  if (!inserted) {
+    // Another config parsed the same template meanwhile.
+    return it->second.lock();
+  }
+  return prompt_template;
+}
+
+int PromptTemplateCache::GetNumTemplates() const {
+  absl::MutexLock lock(&mutex_);
+  int num_templates = 0;
+  for (const auto& [source, prompt_template] : templates_) {
+    num_templates += !prompt_template.expired();
+  }
+  return num_templates;
+}
+
+}  // namespace litert::lm
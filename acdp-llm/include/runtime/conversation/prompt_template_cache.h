@@ -0,0 +1,59 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_PROMPT_TEMPLATE_CACHE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_PROMPT_TEMPLATE_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/components/prompt_template.h"
+
+namespace litert::lm {
+
+// A cache of the prompt templates parsed from their Jinja sources, shared
+// read-only by the conversations rendering with the same template, e.g. all
+// the conversations of an engine using the template of the model metadata.
+// A template is parsed once instead of once per conversation config.
+//
+// The cache only keeps weak references: a template is freed with the last
+// config or conversation using it. The cache is thread-safe.
+//
+// Example usage:
+//   std::shared_ptr<const PromptTemplate> prompt_template =
+//       PromptTemplateCache::GetDefault().GetOrCreate(template_source);
+class PromptTemplateCache {
+ public:
+  // Returns the process-wide cache.
+  static PromptTemplateCache& GetDefault();
+
+  // Returns the live template parsed from `source`, or a newly parsed one.
+  std::shared_ptr<const PromptTemplate> GetOrCreate(absl::string_view source);
+
+  // Returns the number of live templates in the cache.
+  int GetNumTemplates() const;
+
+ private:
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::weak_ptr<const PromptTemplate>>
+      templates_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_PROMPT_TEMPLATE_CACHE_H_
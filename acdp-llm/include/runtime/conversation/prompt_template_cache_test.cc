@@ -0,0 +1,51 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/conversation/prompt_template_cache.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace litert::lm {
+namespace {
+
+constexpr char kTemplate[] =
+    "{% for message in messages %}{{ message.content }}{% endfor %}";
+constexpr char kOtherTemplate[] =
+    "{% for message in messages %}{{ message.role }}{% endfor %}";
+
+TEST(PromptTemplateCacheTest, SharesTheTemplatesOfTheSameSource) {
+  PromptTemplateCache cache;
+  auto prompt_template = cache.GetOrCreate(kTemplate);
+  auto same_prompt_template = cache.GetOrCreate(kTemplate);
+  auto other_prompt_template = cache.GetOrCreate(kOtherTemplate);
+  EXPECT_EQ(prompt_template, same_prompt_template);
+  EXPECT_NE(prompt_template, other_prompt_template);
+  EXPECT_EQ(prompt_template->GetTemplateSource(), kTemplate);
+  EXPECT_EQ(cache.GetNumTemplates(), 2);
+}
+
+TEST(PromptTemplateCacheTest, FreesTheTemplatesNoLongerUsed) {
+  PromptTemplateCache cache;
+  {
+    auto prompt_template = cache.GetOrCreate(kTemplate);
+    EXPECT_EQ(cache.GetNumTemplates(), 1);
+  }
+  EXPECT_EQ(cache.GetNumTemplates(), 0);
+  auto prompt_template = cache.GetOrCreate(kTemplate);
+  EXPECT_EQ(cache.GetNumTemplates(), 1);
+}
+
+}  // namespace
+}  // namespace litert::lm
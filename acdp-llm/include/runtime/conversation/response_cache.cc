@@ -0,0 +1,191 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/conversation/response_cache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"  // from @com_google_absl
+#include "absl/hash/hash.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/conversation/io_types.h"
+
+namespace litert::lm {
+
+ResponseCache::ResponseCache(int max_num_entries, absl::Duration ttl)
+    : max_num_entries_(max_num_entries), ttl_(ttl) {}
+
+// static
+size_t ResponseCache::ComputeKey(absl::string_view model_id,
+                                 absl::string_view sampler_params,
+                                 absl::string_view prompt) {
+  return absl::HashOf(model_id, sampler_params, prompt);
+}
+
+std::optional<Message> ResponseCache::Lookup(size_t key, absl::Time now) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return std::nullopt;
+  }
+  if (now >= it->second->expiration_time) {
+    entries_.erase(it->second);
+    index_.erase(it);
+    return std::nullopt;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  ++num_hits_;
+  return it->second->response;
+}
+
+void ResponseCache::Insert(size_t key, Message response, absl::Time now) {
+  if (max_num_entries_ <= 0) {
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  if (auto it = index_.find(key); it != index_.end()) {
+    entries_.erase(it->second);
+    index_.erase(it);
+  }
+  if (entries_.size() >= max_num_entries_) {
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+  }
+  entries_.push_front(Entry{key, std::move(response), now + ttl_});
+  index_[key] = entries_.begin();
+}
+
+int ResponseCache::GetNumEntries() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+int ResponseCache::GetNumHits() const {
+  absl::MutexLock lock(&mutex_);
+  return num_hits_;
+}
+
+bool ResponseCache::SubscribeOrStart(size_t key, Subscriber subscriber) {
+  absl::MutexLock lock(&mutex_);
+  auto [it, inserted] = in_flight_requests_.try_emplace(key);
+  if (inserted) {
+    return false;
+  }
+  if (subscriber.chunk_callback) {
+    for (const Message& chunk : it->second.chunks) {
+      subscriber.chunk_callback(chunk);
+    }
+  }
+  it->second.subscribers.push_back(
+      std::make_shared<Subscriber>(std::move(subscriber)));
+  ++num_coalesced_;
+  return true;
+}
+
+void ResponseCache::Publish(size_t key, const Message& chunk) {
+  std::vector<std::shared_ptr<Subscriber>> subscribers;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = in_flight_requests_.find(key);
+    if (it == in_flight_requests_.end()) {
+      return;
+    }
+    it->second.chunks.push_back(chunk);
+    subscribers = it->second.subscribers;
+    StartInvoking(subscribers);
+  }
+  InvokeSubscribers(subscribers, [&](Subscriber& subscriber) {
+    if (subscriber.chunk_callback) {
+      subscriber.chunk_callback(chunk);
+    }
+  });
+}
+
+void ResponseCache::Finish(size_t key, absl::StatusOr<Message> response) {
+  std::vector<std::shared_ptr<Subscriber>> subscribers;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = in_flight_requests_.find(key);
+    if (it == in_flight_requests_.end()) {
+      return;
+    }
+    subscribers = std::move(it->second.subscribers);
+    in_flight_requests_.erase(it);
+    StartInvoking(subscribers);
+  }
+  // Outside of the lock, the subscribers may send their next requests.
+  InvokeSubscribers(subscribers, [&](Subscriber& subscriber) {
+    subscriber.done_callback(response);
+  });
+}
+
+void ResponseCache::StartInvoking(
+    const std::vector<std::shared_ptr<Subscriber>>& subscribers) {
+  for (const std::shared_ptr<Subscriber>& subscriber : subscribers) {
+    ++num_invoking_callbacks_[subscriber->owner];
+  }
+}
+
+void ResponseCache::InvokeSubscribers(
+    const std::vector<std::shared_ptr<Subscriber>>& subscribers,
+    absl::FunctionRef<void(Subscriber&)> invoke) {
+  for (const std::shared_ptr<Subscriber>& subscriber : subscribers) {
+    invoke(*subscriber);
+    absl::MutexLock lock(&mutex_);
+    if (--num_invoking_callbacks_[subscriber->owner] == 0) {
+      num_invoking_callbacks_.erase(subscriber->owner);
+      callbacks_invoked_.SignalAll();
+    }
+  }
+}
+
+void ResponseCache::Unsubscribe(const void* owner) {
+  absl::MutexLock lock(&mutex_);
+  for (auto& [key, request] : in_flight_requests_) {
+    std::vector<std::shared_ptr<Subscriber>>& subscribers = request.subscribers;
+    subscribers.erase(
+        std::remove_if(subscribers.begin(), subscribers.end(),
+                       [owner](const std::shared_ptr<Subscriber>& subscriber) {
+                         return subscriber->owner == owner;
+                       }),
+        subscribers.end());
+  }
+  // The callbacks of the chunks and responses published before.
+  while (num_invoking_callbacks_.contains(owner)) {
+    callbacks_invoked_.Wait(&mutex_);
+  }
+}
+
+int ResponseCache::GetNumCoalesced() const {
+  absl::MutexLock lock(&mutex_);
+  return num_coalesced_;
+}
+
+int ResponseCache::Clear() {
+  absl::MutexLock lock(&mutex_);
+  const int num_entries = entries_.size();
+  index_.clear();
+  entries_.clear();
+  return num_entries;
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,168 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_RESPONSE_CACHE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_RESPONSE_CACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/functional/function_ref.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/conversation/io_types.h"
+
+namespace litert::lm {
+
+// An exact-match cache of the responses of the conversations, e.g. for the
+// repeated queries of a FAQ or of a test suite. A response is keyed by the
+// whole rendered prompt, preface and history included, by the sampler
+// parameters and by the model, so that a hit is only served for the same
+// conversation state. A hit returns the stored response without running the
+// model, so with a sampling temperature the response is not sampled again.
+//
+// The least recently used entries are evicted to stay within the entry
+// budget, and the entries expire after the time to live. The cache can be
+// shared by the conversations of several engines, see ConversationConfig::
+// SetResponseCache().
+//
+// The cache also coalesces the identical requests in flight: the first
+// request of a key runs the model, and the identical requests arriving before
+// it is done subscribe to its response instead of generating it again, see
+// SubscribeOrStart(). A cache without entry budget only coalesces. The class
+// is thread-safe.
+class ResponseCache {
+ public:
+  // Creates a cache of up to `max_num_entries` responses, each kept for
+  // `ttl` after its insertion.
+  ResponseCache(int max_num_entries, absl::Duration ttl);
+
+  ResponseCache(const ResponseCache&) = delete;
+  ResponseCache& operator=(const ResponseCache&) = delete;
+
+  // Returns the key of the response to `prompt` generated by the model of
+  // `model_id` with the serialized `sampler_params`.
+  static size_t ComputeKey(absl::string_view model_id,
+                           absl::string_view sampler_params,
+                           absl::string_view prompt);
+
+  // Returns the live response of `key`, or std::nullopt on a miss.
+  std::optional<Message> Lookup(size_t key, absl::Time now = absl::Now());
+
+  // Stores `response` as the response of `key`, replacing the previous one.
+  void Insert(size_t key, Message response, absl::Time now = absl::Now());
+
+  // Returns the number of stored responses, expired ones included until
+  // they are looked up or evicted.
+  int GetNumEntries() const;
+
+  // Returns the number of lookups served from the cache.
+  int GetNumHits() const;
+
+  // The callbacks of a request subscribed to an identical one in flight.
+  struct Subscriber {
+    // Receives the chunks of the response published so far, with the cache
+    // locked: it must not call into the cache then. Then receives the next
+    // ones as they are published. Optional.
+    absl::AnyInvocable<void(const Message&)> chunk_callback;
+    // Receives the complete response, or the error of the request.
+    absl::AnyInvocable<void(absl::StatusOr<Message>)> done_callback;
+    // The object the callbacks refer to, if any, see Unsubscribe().
+    const void* owner = nullptr;
+  };
+
+  // Subscribes `subscriber` to the request of `key` in flight and returns
+  // true. If there is none, registers the caller as the request of `key` in
+  // flight and returns false: the caller then runs the model, Publish()es
+  // the chunks of the response and Finish()es the request.
+  bool SubscribeOrStart(size_t key, Subscriber subscriber);
+
+  // Passes `chunk` of the response of the request of `key` in flight to its
+  // subscribers. Does nothing if the request is not in flight.
+  void Publish(size_t key, const Message& chunk);
+
+  // Ends the request of `key` in flight with its complete `response` or its
+  // error, passed to its subscribers.
+  void Finish(size_t key, absl::StatusOr<Message> response);
+
+  // Drops the subscribers of `owner` from the requests in flight, and waits
+  // for the invocations of their callbacks in progress, so that `owner` can
+  // be destroyed. Must not be called from these callbacks.
+  void Unsubscribe(const void* owner);
+
+  // Returns the number of requests subscribed to an identical one in flight.
+  int GetNumCoalesced() const;
+
+  // Drops all the responses and returns their number.
+  int Clear();
+
+  static constexpr int kDefaultMaxNumEntries = 128;
+  static constexpr absl::Duration kDefaultTtl = absl::Minutes(10);
+
+ private:
+  struct Entry {
+    size_t key;
+    Message response;
+    absl::Time expiration_time;
+  };
+
+  struct InFlightRequest {
+    // The chunks published so far, replayed to the late subscribers.
+    std::vector<Message> chunks;
+    // Shared with the callbacks invoked outside of the lock.
+    std::vector<std::shared_ptr<Subscriber>> subscribers;
+  };
+
+  // Counts the callbacks of `subscribers` about to be invoked, waited for by
+  // Unsubscribe().
+  void StartInvoking(
+      const std::vector<std::shared_ptr<Subscriber>>& subscribers)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Invokes `invoke` on each of `subscribers`, counted by StartInvoking(),
+  // outside of the lock.
+  void InvokeSubscribers(
+      const std::vector<std::shared_ptr<Subscriber>>& subscribers,
+      absl::FunctionRef<void(Subscriber&)> invoke) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  const int max_num_entries_;
+  const absl::Duration ttl_;
+
+  mutable absl::Mutex mutex_;
+  // The entries, most recently used first.
+  std::list<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<size_t, std::list<Entry>::iterator> index_
+      ABSL_GUARDED_BY(mutex_);
+  int num_hits_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::flat_hash_map<size_t, InFlightRequest> in_flight_requests_
+      ABSL_GUARDED_BY(mutex_);
+  int num_coalesced_ ABSL_GUARDED_BY(mutex_) = 0;
+  // The number of callbacks being invoked per owner.
+  absl::flat_hash_map<const void*, int> num_invoking_callbacks_
+      ABSL_GUARDED_BY(mutex_);
+  absl::CondVar callbacks_invoked_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CONVERSATION_RESPONSE_CACHE_H_
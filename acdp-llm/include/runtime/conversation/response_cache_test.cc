@@ -0,0 +1,166 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/conversation/response_cache.h"
+
+#include <optional>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/conversation/io_types.h"
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::Optional;
+
+const absl::Time kNow = absl::FromUnixSeconds(1000);
+
+Message TextMessage(const char* text) {
+  return JsonMessage{{"role", "assistant"}, {"content", text}};
+}
+
+TEST(ResponseCacheTest, KeysTellTheModelsParamsAndPromptsApart) {
+  const size_t key = ResponseCache::ComputeKey("model", "params", "prompt");
+  EXPECT_EQ(ResponseCache::ComputeKey("model", "params", "prompt"), key);
+  EXPECT_NE(ResponseCache::ComputeKey("other model", "params", "prompt"), key);
+  EXPECT_NE(ResponseCache::ComputeKey("model", "other params", "prompt"), key);
+  EXPECT_NE(ResponseCache::ComputeKey("model", "params", "other prompt"), key);
+}
+
+TEST(ResponseCacheTest, ReturnsTheStoredResponses) {
+  ResponseCache cache(/*max_num_entries=*/2, absl::Minutes(1));
+  EXPECT_EQ(cache.Lookup(1, kNow), std::nullopt);
+  cache.Insert(1, TextMessage("one"), kNow);
+  EXPECT_THAT(cache.Lookup(1, kNow), Optional(Eq(TextMessage("one"))));
+  cache.Insert(1, TextMessage("uno"), kNow);
+  EXPECT_THAT(cache.Lookup(1, kNow), Optional(Eq(TextMessage("uno"))));
+  EXPECT_EQ(cache.GetNumEntries(), 1);
+  EXPECT_EQ(cache.GetNumHits(), 2);
+}
+
+TEST(ResponseCacheTest, EvictsTheLeastRecentlyUsedResponses) {
+  ResponseCache cache(/*max_num_entries=*/2, absl::Minutes(1));
+  cache.Insert(1, TextMessage("one"), kNow);
+  cache.Insert(2, TextMessage("two"), kNow);
+  EXPECT_NE(cache.Lookup(1, kNow), std::nullopt);
+  cache.Insert(3, TextMessage("three"), kNow);
+  EXPECT_EQ(cache.GetNumEntries(), 2);
+  EXPECT_NE(cache.Lookup(1, kNow), std::nullopt);
+  EXPECT_EQ(cache.Lookup(2, kNow), std::nullopt);
+  EXPECT_NE(cache.Lookup(3, kNow), std::nullopt);
+}
+
+TEST(ResponseCacheTest, ExpiresTheResponsesAfterTheTtl) {
+  ResponseCache cache(/*max_num_entries=*/2, absl::Minutes(1));
+  cache.Insert(1, TextMessage("one"), kNow);
+  EXPECT_NE(cache.Lookup(1, kNow + absl::Seconds(59)), std::nullopt);
+  EXPECT_EQ(cache.Lookup(1, kNow + absl::Minutes(1)), std::nullopt);
+  EXPECT_EQ(cache.GetNumEntries(), 0);
+}
+
+TEST(ResponseCacheTest, ClearDropsAllTheResponses) {
+  ResponseCache cache(/*max_num_entries=*/2, absl::Minutes(1));
+  cache.Insert(1, TextMessage("one"), kNow);
+  cache.Insert(2, TextMessage("two"), kNow);
+  EXPECT_EQ(cache.Clear(), 2);
+  EXPECT_EQ(cache.GetNumEntries(), 0);
+  EXPECT_EQ(cache.Lookup(1, kNow), std::nullopt);
+}
+
+TEST(ResponseCacheTest, StoresNothingWithoutEntryBudget) {
+  ResponseCache cache(/*max_num_entries=*/0, absl::Minutes(1));
+  cache.Insert(1, TextMessage("one"), kNow);
+  EXPECT_EQ(cache.GetNumEntries(), 0);
+}
+
+TEST(ResponseCacheTest, SubscribersReceiveTheResponseOfTheRequestInFlight) {
+  ResponseCache cache(/*max_num_entries=*/0, absl::Minutes(1));
+  EXPECT_FALSE(cache.SubscribeOrStart(1, {}));
+  cache.Publish(1, TextMessage("Once"));
+
+  std::vector<Message> chunks;
+  std::optional<absl::StatusOr<Message>> response;
+  EXPECT_TRUE(cache.SubscribeOrStart(
+      1, {.chunk_callback = [&](const Message& chunk) {
+            chunks.push_back(chunk);
+          },
+          .done_callback = [&](absl::StatusOr<Message> message) {
+            response = message;
+          }}));
+  EXPECT_THAT(chunks, ElementsAre(TextMessage("Once")));
+  cache.Publish(1, TextMessage(" upon"));
+  EXPECT_THAT(chunks, ElementsAre(TextMessage("Once"), TextMessage(" upon")));
+  EXPECT_EQ(response, std::nullopt);
+
+  cache.Finish(1, TextMessage("Once upon"));
+  ASSERT_TRUE(response.has_value());
+  ASSERT_TRUE(response->ok());
+  EXPECT_EQ(**response, TextMessage("Once upon"));
+  EXPECT_EQ(cache.GetNumCoalesced(), 1);
+
+  // The next request of the key runs the model again.
+  EXPECT_FALSE(cache.SubscribeOrStart(1, {}));
+}
+
+TEST(ResponseCacheTest, SubscribersReceiveTheErrorOfTheRequestInFlight) {
+  ResponseCache cache(/*max_num_entries=*/2, absl::Minutes(1));
+  EXPECT_FALSE(cache.SubscribeOrStart(1, {}));
+  absl::Status status;
+  EXPECT_TRUE(cache.SubscribeOrStart(
+      1, {.done_callback = [&](absl::StatusOr<Message> message) {
+        status = message.status();
+      }}));
+  // A request of another key is not coalesced.
+  EXPECT_FALSE(cache.SubscribeOrStart(2, {}));
+  cache.Finish(1, absl::InternalError("Decode failed."));
+  EXPECT_EQ(status, absl::InternalError("Decode failed."));
+}
+
+TEST(ResponseCacheTest, UnsubscribedOwnersReceiveNothing) {
+  ResponseCache cache(/*max_num_entries=*/0, absl::Minutes(1));
+  EXPECT_FALSE(cache.SubscribeOrStart(1, {}));
+  int owner = 0;
+  int num_chunks = 0;
+  bool done = false;
+  EXPECT_TRUE(cache.SubscribeOrStart(
+      1, {.chunk_callback = [&](const Message&) { ++num_chunks; },
+          .done_callback = [&](absl::StatusOr<Message>) { done = true; },
+          .owner = &owner}));
+  // The published chunks are passed outside of the lock.
+  int num_other_chunks = 0;
+  EXPECT_TRUE(cache.SubscribeOrStart(
+      1, {.chunk_callback = [&](const Message&) {
+            num_other_chunks = cache.GetNumCoalesced();
+          },
+          .done_callback = [](absl::StatusOr<Message>) {}}));
+  cache.Publish(1, TextMessage("Once"));
+  EXPECT_EQ(num_chunks, 1);
+  EXPECT_EQ(num_other_chunks, 2);
+
+  cache.Unsubscribe(&owner);
+  cache.Publish(1, TextMessage(" upon"));
+  cache.Finish(1, TextMessage("Once upon"));
+  EXPECT_EQ(num_chunks, 1);
+  EXPECT_FALSE(done);
+}
+
+}  // namespace
+}  // namespace litert::lm
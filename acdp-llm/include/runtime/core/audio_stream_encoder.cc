@@ -0,0 +1,178 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/audio_stream_encoder.h"
+
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "litert/c/litert_tensor_buffer_types.h"  // from @litert
+#include "litert/cc/litert_layout.h"  // from @litert
+#include "litert/cc/litert_macros.h"  // from @litert
+#include "litert/cc/litert_ranked_tensor_type.h"  // from @litert
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/core/embedding_cache.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/executor/llm_executor_io_types.h"
+#include "runtime/util/executor_data_util.h"
+#include "runtime/util/status_macros.h"  // IWYU pragma: keep
+#include "runtime/util/tensor_buffer_util.h"
+
+namespace litert::lm {
+namespace {
+
+// Concatenates the spectrograms along their frame dimension, the second to
+// last one.
+absl::StatusOr<TensorBuffer> ConcatenateSpectrograms(
+    std::vector<TensorBuffer>& spectrograms) {
+  if (spectrograms.size() == 1) {
+    LITERT_ASSIGN_OR_RETURN(auto spectrogram, spectrograms[0].Duplicate());
+    return spectrogram;
+  }
+  std::vector<int> dims = TensorBufferDims(spectrograms[0]);
+  if (dims.size() < 2) {
+    return absl::InvalidArgumentError(
+        "The spectrograms must have at least 2 dimensions.");
+  }
+  const int frame_dim = dims.size() - 2;
+  int num_frames = 0;
+  size_t total_size = 0;
+  for (const auto& spectrogram : spectrograms) {
+    std::vector<int> chunk_dims = TensorBufferDims(spectrogram);
+    const int chunk_num_frames = chunk_dims.at(frame_dim);
+    chunk_dims[frame_dim] = dims[frame_dim];
+    if (chunk_dims != dims) {
+      return absl::InvalidArgumentError(
+          "The spectrograms of the chunks must only differ in the number of "
+          "frames.");
+    }
+    num_frames += chunk_num_frames;
+    LITERT_ASSIGN_OR_RETURN(size_t size, spectrogram.PackedSize());
+    total_size += size;
+  }
+  dims[frame_dim] = num_frames;
+  LITERT_ASSIGN_OR_RETURN(auto tensor_type, spectrograms[0].TensorType());
+  LITERT_ASSIGN_OR_RETURN(
+      auto combined,
+      TensorBuffer::CreateManaged(
+          kLiteRtTensorBufferTypeHostMemory,
+          ::litert::RankedTensorType(
+              tensor_type.ElementType(),
+              ::litert::Layout(::litert::Dimensions(dims.begin(),
+                                                    dims.end()))),
+          total_size));
+  LITERT_ASSIGN_OR_RETURN(auto combined_lock_and_addr,
+                          ::litert::TensorBufferScopedLock::Create(
+                              combined, TensorBuffer::LockMode::kWrite));
+  char* combined_ptr = static_cast<char*>(combined_lock_and_addr.second);
+  for (auto& spectrogram : spectrograms) {
+    LITERT_ASSIGN_OR_RETURN(size_t size, spectrogram.PackedSize());
+    LITERT_ASSIGN_OR_RETURN(auto lock_and_addr,
+                            ::litert::TensorBufferScopedLock::Create(
+                                spectrogram, TensorBuffer::LockMode::kRead));
+    memcpy(combined_ptr, lock_and_addr.second, size);
+    combined_ptr += size;
+  }
+  return combined;
+}
+
+}  // namespace
+
+AudioStreamEncoder::~AudioStreamEncoder() {
+  // The tasks refer to the stream.
+  WaitForEncoding().IgnoreError();
+}
+
+absl::Status AudioStreamEncoder::PushAudio(InputAudio audio_chunk) {
+  if (finished_) {
+    return absl::FailedPreconditionError("The audio stream is finished.");
+  }
+  if (!audio_chunk.IsTensorBuffer()) {
+    ASSIGN_OR_RETURN(audio_chunk, preprocess_(audio_chunk));
+  }
+  ASSIGN_OR_RETURN(const auto* spectrogram,
+                   audio_chunk.GetPreprocessedAudioTensor());
+  LITERT_ASSIGN_OR_RETURN(auto task_spectrogram, spectrogram->Duplicate());
+  LITERT_ASSIGN_OR_RETURN(auto kept_spectrogram, spectrogram->Duplicate());
+  {
+    absl::MutexLock lock(&mutex_);
+    RETURN_IF_ERROR(status_);
+    ++num_pending_chunks_;
+  }
+  auto status = schedule_(
+      [this, spectrogram = std::move(task_spectrogram)]() mutable {
+        absl::StatusOr<ExecutorAudioData> audio_data;
+        {
+          absl::MutexLock lock(&mutex_);
+          // The chunks after a failed one are not encoded.
+          if (!status_.ok()) {
+            --num_pending_chunks_;
+            return;
+          }
+        }
+        audio_data = encode_(spectrogram);
+        absl::MutexLock lock(&mutex_);
+        if (audio_data.ok()) {
+          audio_data_.push_back(*std::move(audio_data));
+        } else {
+          status_ = audio_data.status();
+        }
+        --num_pending_chunks_;
+      });
+  if (!status.ok()) {
+    absl::MutexLock lock(&mutex_);
+    --num_pending_chunks_;
+    return status;
+  }
+  spectrograms_.push_back(std::move(kept_spectrogram));
+  return absl::OkStatus();
+}
+
+absl::StatusOr<InputAudio> AudioStreamEncoder::Finish() {
+  if (finished_) {
+    return absl::FailedPreconditionError("The audio stream is finished.");
+  }
+  finished_ = true;
+  if (spectrograms_.empty()) {
+    return absl::FailedPreconditionError("No audio was pushed to the stream.");
+  }
+  RETURN_IF_ERROR(WaitForEncoding());
+  ASSIGN_OR_RETURN(auto spectrogram, ConcatenateSpectrograms(spectrograms_));
+  spectrograms_.clear();
+  std::vector<ExecutorAudioData> audio_data;
+  {
+    absl::MutexLock lock(&mutex_);
+    audio_data = std::move(audio_data_);
+  }
+  ASSIGN_OR_RETURN(auto combined_audio_data,
+                   CombineExecutorAudioData(audio_data));
+  ASSIGN_OR_RETURN(auto key, EmbeddingCache::ComputeKey(spectrogram));
+  RETURN_IF_ERROR(embedding_cache_.InsertAudio(key, combined_audio_data));
+  return InputAudio(std::move(spectrogram));
+}
+
+absl::Status AudioStreamEncoder::WaitForEncoding() {
+  absl::MutexLock lock(&mutex_);
+  mutex_.Await(absl::Condition(
+      +[](int* num_pending_chunks) { return *num_pending_chunks == 0; },
+      &num_pending_chunks_));
+  return status_;
+}
+
+}  // namespace litert::lm
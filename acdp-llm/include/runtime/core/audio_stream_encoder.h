@@ -0,0 +1,91 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_AUDIO_STREAM_ENCODER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_AUDIO_STREAM_ENCODER_H_
+
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/core/embedding_cache.h"
+#include "runtime/engine/engine.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/executor/llm_executor_io_types.h"
+
+namespace litert::lm {
+
+// The AudioStream of SessionBasic. Each chunk is preprocessed when pushed,
+// then encoded by a task of the session, so that the audio encoder runs in
+// order with the other work of the session. Finish() concatenates the
+// spectrograms and the embeddings of the chunks, and caches the embeddings
+// under the key of the whole spectrogram, which the session then finds when
+// prefilling it.
+//
+// The chunks are encoded independently, so the embeddings differ from the
+// ones of the whole audio at the chunk boundaries, as with a streaming
+// encoder. The methods must be called from a single thread.
+class AudioStreamEncoder : public AudioStream {
+ public:
+  // Returns the spectrogram of the next chunk of raw audio.
+  using PreprocessFn =
+      absl::AnyInvocable<absl::StatusOr<InputAudio>(const InputAudio&)>;
+  // Returns the embeddings of a spectrogram.
+  using EncodeFn = absl::AnyInvocable<absl::StatusOr<ExecutorAudioData>(
+      const TensorBuffer&)>;
+  // Schedules a task, to run after the previously scheduled ones.
+  using ScheduleFn =
+      absl::AnyInvocable<absl::Status(absl::AnyInvocable<void()>)>;
+
+  AudioStreamEncoder(PreprocessFn preprocess, EncodeFn encode,
+                     ScheduleFn schedule, EmbeddingCache& embedding_cache)
+      : preprocess_(std::move(preprocess)),
+        encode_(std::move(encode)),
+        schedule_(std::move(schedule)),
+        embedding_cache_(embedding_cache) {}
+
+  // Waits for the chunks being encoded.
+  ~AudioStreamEncoder() override;
+
+  absl::Status PushAudio(InputAudio audio_chunk) override;
+
+  absl::StatusOr<InputAudio> Finish() override;
+
+ private:
+  // Waits for the chunks being encoded, and returns the first error.
+  absl::Status WaitForEncoding();
+
+  PreprocessFn preprocess_;
+  EncodeFn encode_;
+  ScheduleFn schedule_;
+  EmbeddingCache& embedding_cache_;
+  bool finished_ = false;
+  // The spectrograms of the pushed chunks.
+  std::vector<TensorBuffer> spectrograms_;
+
+  absl::Mutex mutex_;
+  int num_pending_chunks_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::Status status_ ABSL_GUARDED_BY(mutex_);
+  // The embeddings of the encoded chunks, in order.
+  std::vector<ExecutorAudioData> audio_data_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_AUDIO_STREAM_ENCODER_H_
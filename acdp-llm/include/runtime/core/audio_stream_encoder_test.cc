@@ -0,0 +1,138 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/audio_stream_encoder.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "litert/cc/litert_macros.h"  // from @litert
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/core/embedding_cache.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/executor/llm_executor_io_types.h"
+#include "runtime/util/convert_tensor_buffer.h"
+#include "runtime/util/status_macros.h"  // IWYU pragma: keep
+#include "runtime/util/tensor_buffer_util.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::status::StatusIs;
+
+// A spectrogram of a frame of 2 bins per byte of the audio.
+absl::StatusOr<InputAudio> FakePreprocess(const InputAudio& audio) {
+  ASSIGN_OR_RETURN(auto bytes, audio.GetRawAudioBytes());
+  std::vector<float> frames;
+  for (const char byte : bytes) {
+    frames.push_back(byte);
+    frames.push_back(-byte);
+  }
+  LITERT_ASSIGN_OR_RETURN(
+      auto spectrogram,
+      CopyToTensorBuffer<float>(
+          absl::MakeConstSpan(frames),
+          {1, static_cast<int>(bytes.size()), 2}));
+  return InputAudio(std::move(spectrogram));
+}
+
+// An embedding of 1 value per frame of the spectrogram.
+absl::StatusOr<ExecutorAudioData> FakeEncode(const TensorBuffer& spectrogram) {
+  const int num_frames = TensorBufferDims(spectrogram)[1];
+  LITERT_ASSIGN_OR_RETURN(
+      auto embeddings,
+      CopyToTensorBuffer<float>(
+          absl::MakeConstSpan(std::vector<float>(num_frames, 1.0f)),
+          {1, num_frames, 1}));
+  return ExecutorAudioData(std::move(embeddings),
+                           /*per_layer_embeddings=*/std::nullopt, num_frames);
+}
+
+absl::Status RunNow(absl::AnyInvocable<void()> task) {
+  task();
+  return absl::OkStatus();
+}
+
+class AudioStreamEncoderTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_OK_AND_ASSIGN(cache_, EmbeddingCache::Create(1024));
+  }
+
+  std::unique_ptr<EmbeddingCache> cache_;
+};
+
+TEST_F(AudioStreamEncoderTest, CachesTheEmbeddingsOfTheWholeAudio) {
+  int num_encoded_chunks = 0;
+  AudioStreamEncoder stream(
+      &FakePreprocess,
+      [&](const TensorBuffer& spectrogram) {
+        ++num_encoded_chunks;
+        return FakeEncode(spectrogram);
+      },
+      &RunNow, *cache_);
+  ASSERT_OK(stream.PushAudio(InputAudio(std::string("abc"))));
+  ASSERT_OK(stream.PushAudio(InputAudio(std::string("de"))));
+  EXPECT_EQ(num_encoded_chunks, 2);
+
+  ASSERT_OK_AND_ASSIGN(InputAudio audio, stream.Finish());
+  ASSERT_OK_AND_ASSIGN(const auto* spectrogram,
+                       audio.GetPreprocessedAudioTensor());
+  EXPECT_THAT(TensorBufferDims(*spectrogram), ElementsAre(1, 5, 2));
+  auto frames = CopyFromTensorBuffer<float>(*spectrogram);
+  ASSERT_TRUE(frames.HasValue());
+  EXPECT_THAT(*frames, ElementsAre('a', -'a', 'b', -'b', 'c', -'c', 'd', -'d',
+                                   'e', -'e'));
+
+  ASSERT_OK_AND_ASSIGN(auto key, EmbeddingCache::ComputeKey(*spectrogram));
+  ASSERT_OK_AND_ASSIGN(auto audio_data, cache_->LookupAudio(key));
+  ASSERT_TRUE(audio_data.has_value());
+  EXPECT_EQ(audio_data->GetValidTokens(), 5);
+}
+
+TEST_F(AudioStreamEncoderTest, FailsOnEncodingErrors) {
+  AudioStreamEncoder stream(
+      &FakePreprocess,
+      [](const TensorBuffer&) -> absl::StatusOr<ExecutorAudioData> {
+        return absl::InternalError("Encoding failed.");
+      },
+      &RunNow, *cache_);
+  ASSERT_OK(stream.PushAudio(InputAudio(std::string("abc"))));
+  EXPECT_THAT(stream.PushAudio(InputAudio(std::string("de"))),
+              StatusIs(absl::StatusCode::kInternal));
+  EXPECT_THAT(stream.Finish(), StatusIs(absl::StatusCode::kInternal));
+  EXPECT_EQ(cache_->GetNumEntries(), 0);
+}
+
+TEST_F(AudioStreamEncoderTest, FailsOnceFinished) {
+  AudioStreamEncoder stream(&FakePreprocess, &FakeEncode, &RunNow, *cache_);
+  EXPECT_THAT(stream.Finish(),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  EXPECT_THAT(stream.PushAudio(InputAudio(std::string("abc"))),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+}  // namespace
+}  // namespace litert::lm
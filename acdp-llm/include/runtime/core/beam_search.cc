@@ -0,0 +1,169 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/beam_search.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_check.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/core/logits_kernels.h"
+#include "runtime/core/stop_sequence_matcher.h"
+
+namespace litert::lm {
+
+BeamSearch::BeamSearch(int beam_width,
+                       const AhoCorasickAutomaton& stop_token_automaton,
+                       float length_penalty)
+    : beam_width_(beam_width),
+      stop_token_automaton_(stop_token_automaton),
+      length_penalty_(length_penalty),
+      beams_(beam_width) {
+  ABSL_CHECK_GT(beam_width, 0);
+}
+
+absl::Status BeamSearch::Step(absl::Span<const float> logits) {
+  if (IsDone()) {
+    return absl::FailedPreconditionError("The beam search is done.");
+  }
+  if (logits.empty() || logits.size() % beam_width_ != 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The logits of size ", logits.size(),
+                     " are not of shape [", beam_width_, ", vocab_size]."));
+  }
+  const int vocab_size = logits.size() / beam_width_;
+  const int num_expanded_beams = nodes_.empty() ? 1 : beam_width_;
+  // The best extensions of a beam are among its top 2 * beam_width tokens,
+  // even if beam_width of them end a hypothesis.
+  const int num_tokens_per_beam = std::min(2 * beam_width_, vocab_size);
+  const LogitsKernels& kernels = LogitsKernels::Get();
+  extensions_.clear();
+  for (int beam = 0; beam < num_expanded_beams; ++beam) {
+    const absl::Span<const float> beam_logits =
+        logits.subspan(beam * vocab_size, vocab_size);
+    const float log_sum_exp =
+        kernels.ComputeLogSumExp(beam_logits, /*temperature=*/1.0f);
+    for (int token_id : kernels.SelectTopK(beam_logits, num_tokens_per_beam)) {
+      extensions_.push_back(
+          {beams_[beam].log_prob + beam_logits[token_id] - log_sum_exp, beam,
+           token_id});
+    }
+  }
+  // Stable, so that the ties keep the order of the beams and the tokens.
+  std::stable_sort(extensions_.begin(), extensions_.end(),
+                   [](const Extension& a, const Extension& b) {
+                     return a.log_prob > b.log_prob;
+                   });
+
+  next_beams_.clear();
+  parent_indices_.clear();
+  next_token_ids_.clear();
+  for (const Extension& extension : extensions_) {
+    if (static_cast<int>(next_beams_.size()) == beam_width_) {
+      break;
+    }
+    const Beam& parent = beams_[extension.beam];
+    nodes_.push_back({extension.token_id, parent.node});
+    const Beam beam = {
+        .node = static_cast<int>(nodes_.size()) - 1,
+        .num_tokens = parent.num_tokens + 1,
+        .log_prob = extension.log_prob,
+        .stop_state =
+            stop_token_automaton_.Next(parent.stop_state, extension.token_id),
+    };
+    if (stop_token_automaton_.GetMatchLength(beam.stop_state) > 0) {
+      AddHypothesis(beam);
+      continue;
+    }
+    next_beams_.push_back(beam);
+    parent_indices_.push_back(extension.beam);
+    next_token_ids_.push_back(extension.token_id);
+  }
+  if (next_beams_.empty()) {
+    // Every extension ended a hypothesis.
+    has_live_beams_ = false;
+    return absl::OkStatus();
+  }
+  // Rare: most extensions ended a hypothesis. The missing beams follow the
+  // best one, but can not be extended.
+  while (static_cast<int>(next_beams_.size()) < beam_width_) {
+    Beam padding = next_beams_.front();
+    padding.log_prob = -std::numeric_limits<float>::infinity();
+    next_beams_.push_back(padding);
+    parent_indices_.push_back(parent_indices_.front());
+    next_token_ids_.push_back(next_token_ids_.front());
+  }
+  std::swap(beams_, next_beams_);
+  return absl::OkStatus();
+}
+
+bool BeamSearch::IsDone() const {
+  return !has_live_beams_ ||
+         static_cast<int>(hypotheses_.size()) >= beam_width_;
+}
+
+std::vector<BeamSearch::Hypothesis> BeamSearch::GetHypotheses() const {
+  std::vector<Hypothesis> hypotheses = hypotheses_;
+  if (has_live_beams_) {
+    for (const Beam& beam : beams_) {
+      if (std::isfinite(beam.log_prob)) {
+        hypotheses.push_back({GetTokenIds(beam.node), GetScore(beam)});
+      }
+    }
+  }
+  std::stable_sort(hypotheses.begin(), hypotheses.end(),
+                   [](const Hypothesis& a, const Hypothesis& b) {
+                     return a.score > b.score;
+                   });
+  if (static_cast<int>(hypotheses.size()) > beam_width_) {
+    hypotheses.resize(beam_width_);
+  }
+  return hypotheses;
+}
+
+std::vector<int> BeamSearch::GetTokenIds(int node) const {
+  std::vector<int> token_ids;
+  for (; node >= 0; node = nodes_[node].parent) {
+    token_ids.push_back(nodes_[node].token_id);
+  }
+  std::reverse(token_ids.begin(), token_ids.end());
+  return token_ids;
+}
+
+float BeamSearch::GetScore(const Beam& beam) const {
+  return beam.log_prob /
+         std::pow(static_cast<float>(std::max(beam.num_tokens, 1)),
+                  length_penalty_);
+}
+
+void BeamSearch::AddHypothesis(const Beam& beam) {
+  Hypothesis hypothesis = {GetTokenIds(beam.node), GetScore(beam)};
+  auto it = std::upper_bound(hypotheses_.begin(), hypotheses_.end(),
+                             hypothesis.score,
+                             [](float score, const Hypothesis& other) {
+                               return score > other.score;
+                             });
+  hypotheses_.insert(it, std::move(hypothesis));
+  if (static_cast<int>(hypotheses_.size()) > beam_width_) {
+    hypotheses_.pop_back();
+  }
+}
+
+}  // namespace litert::lm
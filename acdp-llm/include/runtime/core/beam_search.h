@@ -0,0 +1,127 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_BEAM_SEARCH_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_BEAM_SEARCH_H_
+
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/core/stop_sequence_matcher.h"
+
+namespace litert::lm {
+
+// Beam search over the output candidates of a decode. Every step extends the
+// `beam_width` live beams with their most likely tokens and keeps the best
+// extensions by log-probability. The extensions ending with a stop token
+// sequence are set aside as finished hypotheses, and the search is done once
+// `beam_width` hypotheses have finished.
+//
+// Beam i is decoded by output candidate i: after each step, candidate i
+// continues the context of candidate GetParentIndices()[i] with the token
+// GetNextTokenIds()[i], see BeamSearchLlmExecutor. The tokens of the beams are
+// kept as a tree of their common prefixes, so that a step does not copy them.
+//
+// Example usage:
+//   BeamSearch beam_search(beam_width, stop_sequences.GetTokenAutomaton());
+//   while (!beam_search.IsDone()) {
+//     // Decode the logits of the candidates, of shape [beam_width, vocab].
+//     RETURN_IF_ERROR(beam_search.Step(logits));
+//     RETURN_IF_ERROR(executor.ReorderCandidates(
+//         beam_search.GetParentIndices()));
+//     // Feed beam_search.GetNextTokenIds() to the next decode.
+//   }
+//   std::vector<BeamSearch::Hypothesis> results = beam_search.GetHypotheses();
+class BeamSearch {
+ public:
+  struct Hypothesis {
+    // The decoded tokens, ending with the stop token sequence if finished.
+    std::vector<int> token_ids;
+    // The log-probability of the tokens divided by their number raised to the
+    // length penalty.
+    float score;
+  };
+
+  // `stop_token_automaton` must outlive the search. A length penalty above 0
+  // favors the longer hypotheses, below 0 the shorter ones.
+  BeamSearch(int beam_width, const AhoCorasickAutomaton& stop_token_automaton,
+             float length_penalty = 1.0f);
+
+  BeamSearch(const BeamSearch&) = delete;
+  BeamSearch& operator=(const BeamSearch&) = delete;
+
+  // Advances the search with the logits of the beams, of shape
+  // [beam_width, vocab_size]. The first step only reads the logits of beam 0,
+  // since the beams all start from the same context.
+  absl::Status Step(absl::Span<const float> logits);
+
+  // Returns the beam each beam continues after the last step.
+  absl::Span<const int> GetParentIndices() const { return parent_indices_; }
+
+  // Returns the token each beam was extended with by the last step, i.e. the
+  // input of the next decode.
+  absl::Span<const int> GetNextTokenIds() const { return next_token_ids_; }
+
+  bool IsDone() const;
+
+  // Returns the `beam_width` best hypotheses, from the best. The live beams
+  // stand in for the hypotheses not finished yet, e.g. at the end of the
+  // context.
+  std::vector<Hypothesis> GetHypotheses() const;
+
+ private:
+  // A decoded token, in the tree of the beam prefixes.
+  struct Node {
+    int token_id;
+    // The node of the previous token, or -1 for the first one.
+    int parent;
+  };
+  struct Beam {
+    // The node of the last token, or -1 before the first step.
+    int node = -1;
+    int num_tokens = 0;
+    float log_prob = 0.0f;
+    int stop_state = AhoCorasickAutomaton::kRootState;
+  };
+  struct Extension {
+    float log_prob;
+    int beam;
+    int token_id;
+  };
+
+  // Returns the tokens ending with `node`.
+  std::vector<int> GetTokenIds(int node) const;
+  float GetScore(const Beam& beam) const;
+  // Adds a finished hypothesis, keeping the `beam_width` best ones.
+  void AddHypothesis(const Beam& beam);
+
+  const int beam_width_;
+  const AhoCorasickAutomaton& stop_token_automaton_;
+  const float length_penalty_;
+  std::vector<Beam> beams_;
+  std::vector<Node> nodes_;
+  // The finished hypotheses, from the best.
+  std::vector<Hypothesis> hypotheses_;
+  std::vector<int> parent_indices_;
+  std::vector<int> next_token_ids_;
+  // Reused across the steps.
+  std::vector<Extension> extensions_;
+  std::vector<Beam> next_beams_;
+  bool has_live_beams_ = true;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_BEAM_SEARCH_H_
@@ -0,0 +1,128 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/beam_search.h"
+
+#include <cmath>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "runtime/core/stop_sequence_matcher.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::FloatNear;
+using ::testing::status::StatusIs;
+
+constexpr int kStopTokenId = 3;
+
+// Returns the logits of the given probabilities of the tokens, one row per
+// beam.
+std::vector<float> ToLogits(const std::vector<std::vector<float>>& probs) {
+  std::vector<float> logits;
+  for (const auto& beam_probs : probs) {
+    for (float prob : beam_probs) {
+      logits.push_back(std::log(prob));
+    }
+  }
+  return logits;
+}
+
+TEST(BeamSearchTest, ExpandsOnlyTheFirstBeamOnTheFirstStep) {
+  const AhoCorasickAutomaton stop_tokens(
+      std::vector<std::vector<int>>{{kStopTokenId}});
+  BeamSearch beam_search(/*beam_width=*/2, stop_tokens);
+  EXPECT_OK(beam_search.Step(ToLogits(
+      {{0.1f, 0.5f, 0.4f, 0.0f}, {0.9f, 0.05f, 0.05f, 0.0f}})));
+  EXPECT_THAT(beam_search.GetParentIndices(), ElementsAre(0, 0));
+  EXPECT_THAT(beam_search.GetNextTokenIds(), ElementsAre(1, 2));
+  EXPECT_FALSE(beam_search.IsDone());
+}
+
+TEST(BeamSearchTest, KeepsTheBestSequencesOverTheBestTokens) {
+  const AhoCorasickAutomaton stop_tokens(
+      std::vector<std::vector<int>>{{kStopTokenId}});
+  BeamSearch beam_search(/*beam_width=*/2, stop_tokens);
+  EXPECT_OK(beam_search.Step(ToLogits(
+      {{0.1f, 0.5f, 0.4f, 0.0f}, {0.1f, 0.5f, 0.4f, 0.0f}})));
+  // Token 1 is more likely, but token 2 has a much more likely continuation.
+  EXPECT_OK(beam_search.Step(ToLogits(
+      {{0.4f, 0.3f, 0.3f, 0.0f}, {0.9f, 0.05f, 0.05f, 0.0f}})));
+  EXPECT_THAT(beam_search.GetParentIndices(), ElementsAre(1, 0));
+  EXPECT_THAT(beam_search.GetNextTokenIds(), ElementsAre(0, 0));
+
+  std::vector<BeamSearch::Hypothesis> hypotheses =
+      beam_search.GetHypotheses();
+  ASSERT_EQ(hypotheses.size(), 2);
+  EXPECT_THAT(hypotheses[0].token_ids, ElementsAre(2, 0));
+  EXPECT_THAT(hypotheses[0].score,
+              FloatNear(std::log(0.4f * 0.9f) / 2, 1e-5f));
+  EXPECT_THAT(hypotheses[1].token_ids, ElementsAre(1, 0));
+  EXPECT_THAT(hypotheses[1].score,
+              FloatNear(std::log(0.5f * 0.4f) / 2, 1e-5f));
+}
+
+TEST(BeamSearchTest, SetsTheFinishedHypothesesAside) {
+  const AhoCorasickAutomaton stop_tokens(
+      std::vector<std::vector<int>>{{kStopTokenId}});
+  BeamSearch beam_search(/*beam_width=*/2, stop_tokens);
+  EXPECT_OK(beam_search.Step(ToLogits(
+      {{0.05f, 0.2f, 0.25f, 0.5f}, {0.05f, 0.2f, 0.25f, 0.5f}})));
+  // The stop token ends the most likely hypothesis, the beams go on with the
+  // next ones.
+  EXPECT_THAT(beam_search.GetParentIndices(), ElementsAre(0, 0));
+  EXPECT_THAT(beam_search.GetNextTokenIds(), ElementsAre(2, 1));
+  EXPECT_FALSE(beam_search.IsDone());
+
+  EXPECT_OK(beam_search.Step(ToLogits(
+      {{0.1f, 0.1f, 0.1f, 0.7f}, {0.1f, 0.1f, 0.1f, 0.7f}})));
+  EXPECT_TRUE(beam_search.IsDone());
+  std::vector<BeamSearch::Hypothesis> hypotheses =
+      beam_search.GetHypotheses();
+  ASSERT_EQ(hypotheses.size(), 2);
+  EXPECT_THAT(hypotheses[0].token_ids, ElementsAre(kStopTokenId));
+  EXPECT_THAT(hypotheses[1].token_ids, ElementsAre(2, kStopTokenId));
+  EXPECT_THAT(beam_search.Step(ToLogits({{0.5f, 0.5f}, {0.5f, 0.5f}})),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST(BeamSearchTest, AppliesTheLengthPenalty) {
+  const AhoCorasickAutomaton stop_tokens(
+      std::vector<std::vector<int>>{{kStopTokenId}});
+  BeamSearch beam_search(/*beam_width=*/1, stop_tokens,
+                         /*length_penalty=*/0.0f);
+  EXPECT_OK(beam_search.Step(ToLogits({{0.5f, 0.5f, 0.0f, 0.0f}})));
+  EXPECT_OK(beam_search.Step(ToLogits({{0.5f, 0.5f, 0.0f, 0.0f}})));
+  std::vector<BeamSearch::Hypothesis> hypotheses =
+      beam_search.GetHypotheses();
+  ASSERT_EQ(hypotheses.size(), 1);
+  EXPECT_THAT(hypotheses[0].token_ids, ElementsAre(0, 0));
+  EXPECT_THAT(hypotheses[0].score, FloatNear(std::log(0.25f), 1e-5f));
+}
+
+TEST(BeamSearchTest, RejectsTheLogitsOfAnotherShape) {
+  const AhoCorasickAutomaton stop_tokens(
+      std::vector<std::vector<int>>{{kStopTokenId}});
+  BeamSearch beam_search(/*beam_width=*/2, stop_tokens);
+  EXPECT_THAT(beam_search.Step({0.1f, 0.2f, 0.3f}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace litert::lm
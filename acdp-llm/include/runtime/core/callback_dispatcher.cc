@@ -0,0 +1,176 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/callback_dispatcher.h"
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/io_types.h"
+
+namespace litert::lm {
+
+CallbackDispatcher::CallbackDispatcher(
+    Callback callback, size_t capacity, CallbackBackpressurePolicy policy,
+    absl::AnyInvocable<void()> on_overflow)
+    : callback_(std::move(callback)),
+      queue_(capacity),
+      policy_(policy),
+      on_overflow_(std::move(on_overflow)),
+      thread_([this]() { Consume(); }) {}
+
+CallbackDispatcher::~CallbackDispatcher() {
+  Flush();
+  stopped_.store(true);
+  Wake(consumer_waiting_);
+  thread_.join();
+}
+
+void CallbackDispatcher::Dispatch(absl::StatusOr<Responses> responses) {
+  const bool is_final =
+      !responses.ok() || responses->GetTaskState() != TaskState::kProcessing;
+  if (policy_ == CallbackBackpressurePolicy::kBlock) {
+    Push(responses);
+    return;
+  }
+  if (is_final) {
+    PushCoalesced(/*wait=*/true);
+    // Responses were dropped, which the user is told instead of the
+    // cancellation that followed or the end of the stream.
+    if (has_overflowed_ &&
+        (responses.ok() || absl::IsCancelled(responses.status()))) {
+      responses = absl::ResourceExhaustedError(
+          "The streaming callback fell too far behind the decode loop.");
+    }
+    Push(responses);
+    return;
+  }
+  if (has_overflowed_) {
+    return;
+  }
+  if (!PushCoalesced(/*wait=*/false)) {
+    Coalesce(*std::move(responses));
+    return;
+  }
+  if (queue_.TryPush(responses)) {
+    ++num_dispatched_;
+    Wake(consumer_waiting_);
+    return;
+  }
+  if (policy_ == CallbackBackpressurePolicy::kCoalesce) {
+    coalesced_responses_ = std::move(responses);
+    return;
+  }
+  has_overflowed_ = true;
+  if (on_overflow_ != nullptr) {
+    on_overflow_();
+  }
+}
+
+CallbackDispatcher::Callback CallbackDispatcher::AsCallback() {
+  return [this](absl::StatusOr<Responses> responses) {
+    Dispatch(std::move(responses));
+  };
+}
+
+void CallbackDispatcher::Flush() {
+  PushCoalesced(/*wait=*/true);
+  Wait(producer_waiting_,
+       absl::Condition(this, &CallbackDispatcher::IsFlushed));
+}
+
+void CallbackDispatcher::Push(absl::StatusOr<Responses>& responses) {
+  while (!queue_.TryPush(responses)) {
+    Wait(producer_waiting_,
+         absl::Condition(this, &CallbackDispatcher::CanPush));
+  }
+  ++num_dispatched_;
+  Wake(consumer_waiting_);
+}
+
+bool CallbackDispatcher::PushCoalesced(bool wait) {
+  if (!coalesced_responses_.has_value()) {
+    return true;
+  }
+  if (wait) {
+    Push(*coalesced_responses_);
+  } else if (queue_.TryPush(*coalesced_responses_)) {
+    ++num_dispatched_;
+    Wake(consumer_waiting_);
+  } else {
+    return false;
+  }
+  coalesced_responses_.reset();
+  return true;
+}
+
+void CallbackDispatcher::Coalesce(Responses responses) {
+  std::vector<std::string>& texts = (*coalesced_responses_)->GetMutableTexts();
+  for (int i = 0; i < texts.size() && i < responses.GetTexts().size(); ++i) {
+    texts[i] += responses.GetTexts()[i];
+  }
+  if (!responses.GetScores().empty()) {
+    (*coalesced_responses_)->GetMutableScores() =
+        std::move(responses.GetMutableScores());
+  }
+}
+
+void CallbackDispatcher::Consume() {
+  while (true) {
+    std::optional<absl::StatusOr<Responses>> responses = queue_.TryPop();
+    if (!responses.has_value()) {
+      if (stopped_.load()) {
+        return;
+      }
+      Wait(consumer_waiting_,
+           absl::Condition(this, &CallbackDispatcher::CanPop));
+      continue;
+    }
+    callback_(*std::move(responses));
+    num_delivered_.fetch_add(1);
+    Wake(producer_waiting_);
+  }
+}
+
+void CallbackDispatcher::Wait(std::atomic<bool>& waiting,
+                              const absl::Condition& condition) {
+  absl::MutexLock lock(&mutex_);
+  waiting.store(true);
+  // The flag must be visible to the other thread before the condition is
+  // checked, or both threads could miss each other's update.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  mutex_.Await(condition);
+  waiting.store(false);
+}
+
+void CallbackDispatcher::Wake(const std::atomic<bool>& waiting) {
+  // Pairs with the fence in Wait: either the waiting thread sees the update,
+  // or this thread sees the flag and releases the mutex to re-evaluate the
+  // condition.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiting.load()) {
+    absl::MutexLock lock(&mutex_);
+  }
+}
+
+}  // namespace litert::lm
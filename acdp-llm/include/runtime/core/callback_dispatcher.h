@@ -0,0 +1,135 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_CALLBACK_DISPATCHER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_CALLBACK_DISPATCHER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <thread>  // NOLINT
+
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/core/spsc_queue.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/io_types.h"
+
+namespace litert::lm {
+
+// Invokes a streaming callback from a dedicated thread, so that the decode
+// loop can run the next step while the previous responses are converted and
+// delivered to the user. The responses are passed through a lock-free queue;
+// the threads only synchronize when the queue is empty or full.
+//
+// Dispatch must always be called from the same thread. The callback is
+// invoked one response at a time, in the dispatch order.
+//
+// When the callback falls `capacity` responses behind, the backpressure
+// policy decides whether the decode loop waits for it, merges the next
+// responses until there is room, or gives up on the stream. The final
+// response and the errors are always delivered.
+//
+// Example usage:
+//   CallbackDispatcher dispatcher(std::move(callback));
+//   RETURN_IF_ERROR(DecodeStreaming(..., dispatcher.AsCallback(), ...));
+//   // The destructor delivers the remaining responses.
+class CallbackDispatcher {
+ public:
+  using Callback = absl::AnyInvocable<void(absl::StatusOr<Responses>)>;
+
+  // The maximum number of responses waiting for the callback. The decode loop
+  // blocks when the callback falls that far behind.
+  static constexpr size_t kDefaultCapacity = 64;
+
+  // `on_overflow` is called once, from the dispatching thread, when the
+  // queue overflows with CallbackBackpressurePolicy::kCancel, to stop the
+  // decode loop.
+  explicit CallbackDispatcher(
+      Callback callback, size_t capacity = kDefaultCapacity,
+      CallbackBackpressurePolicy policy = CallbackBackpressurePolicy::kBlock,
+      absl::AnyInvocable<void()> on_overflow = nullptr);
+
+  CallbackDispatcher(const CallbackDispatcher&) = delete;
+  CallbackDispatcher& operator=(const CallbackDispatcher&) = delete;
+
+  // Delivers the remaining responses and stops the callback thread.
+  ~CallbackDispatcher();
+
+  // Queues the responses for the callback.
+  void Dispatch(absl::StatusOr<Responses> responses);
+
+  // Returns a callback queuing the responses. It must not outlive the
+  // dispatcher.
+  Callback AsCallback();
+
+  // Waits until the callback has been invoked with all the dispatched
+  // responses.
+  void Flush();
+
+  // Returns whether the stream was given up on with
+  // CallbackBackpressurePolicy::kCancel.
+  bool HasOverflowed() const { return has_overflowed_; }
+
+ private:
+  // Queues the responses, waiting for room if the queue is full.
+  void Push(absl::StatusOr<Responses>& responses);
+  // Pushes the responses merged by CallbackBackpressurePolicy::kCoalesce,
+  // waiting for room if `wait` is true. Returns whether none are left.
+  bool PushCoalesced(bool wait);
+  // Appends the texts of a step to the merged responses.
+  void Coalesce(Responses responses);
+
+  // Runs the callback on the queued responses until the dispatcher stops.
+  void Consume();
+
+  // Blocks until `condition` holds, flagging the thread as waiting so that
+  // the other thread wakes it up.
+  void Wait(std::atomic<bool>& waiting, const absl::Condition& condition);
+  // Wakes up the other thread if it is waiting.
+  void Wake(const std::atomic<bool>& waiting);
+
+  bool CanPush() const { return !queue_.IsFull(); }
+  bool CanPop() const { return !queue_.IsEmpty() || stopped_.load(); }
+  bool IsFlushed() const { return num_delivered_.load() == num_dispatched_; }
+
+  Callback callback_;
+  SpscQueue<absl::StatusOr<Responses>> queue_;
+  const CallbackBackpressurePolicy policy_;
+  absl::AnyInvocable<void()> on_overflow_;
+
+  // Only accessed by the producer: the responses merged while the queue is
+  // full, and whether the stream was given up on.
+  std::optional<absl::StatusOr<Responses>> coalesced_responses_;
+  bool has_overflowed_ = false;
+
+  // Only locked by a thread going to sleep, and by the other thread to wake
+  // it up.
+  absl::Mutex mutex_;
+  std::atomic<bool> producer_waiting_ = false;
+  std::atomic<bool> consumer_waiting_ = false;
+
+  std::atomic<bool> stopped_ = false;
+  // Only accessed by the producer.
+  uint64_t num_dispatched_ = 0;
+  std::atomic<uint64_t> num_delivered_ = 0;
+
+  std::thread thread_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_CALLBACK_DISPATCHER_H_
@@ -0,0 +1,160 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/callback_dispatcher.h"
+
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_join.h"  // from @com_google_absl
+#include "absl/synchronization/notification.h"  // from @com_google_absl
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/io_types.h"
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+Responses TextResponses(const std::string& text) {
+  return Responses(TaskState::kProcessing, {text});
+}
+
+TEST(CallbackDispatcherTest, DeliversInOrderOnAnotherThread) {
+  std::vector<std::string> texts;
+  std::thread::id callback_thread_id;
+  {
+    CallbackDispatcher dispatcher(
+        [&](absl::StatusOr<Responses> responses) {
+          callback_thread_id = std::this_thread::get_id();
+          if (!responses.ok()) {
+            texts.push_back(responses.status().ToString());
+          } else if (responses->GetTaskState() == TaskState::kDone) {
+            texts.push_back("done");
+          } else {
+            texts.push_back(responses->GetTexts()[0]);
+          }
+        },
+        /*capacity=*/2);
+    auto callback = dispatcher.AsCallback();
+    for (int i = 0; i < 100; ++i) {
+      callback(TextResponses(absl::StrCat(i)));
+    }
+    callback(Responses(TaskState::kDone));
+  }
+  ASSERT_EQ(texts.size(), 101);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(texts[i], absl::StrCat(i));
+  }
+  EXPECT_EQ(texts.back(), "done");
+  EXPECT_NE(callback_thread_id, std::this_thread::get_id());
+}
+
+TEST(CallbackDispatcherTest, DispatchDoesNotWaitForTheCallback) {
+  absl::Notification release_callback;
+  std::vector<std::string> texts;
+  CallbackDispatcher dispatcher(
+      [&](absl::StatusOr<Responses> responses) {
+        release_callback.WaitForNotification();
+        texts.push_back(responses->GetTexts()[0]);
+      },
+      /*capacity=*/4);
+  dispatcher.Dispatch(TextResponses("a"));
+  dispatcher.Dispatch(TextResponses("b"));
+  EXPECT_THAT(texts, IsEmpty());
+
+  release_callback.Notify();
+  dispatcher.Flush();
+  EXPECT_THAT(texts, ElementsAre("a", "b"));
+}
+
+TEST(CallbackDispatcherTest, DeliversErrors) {
+  absl::Status status;
+  {
+    CallbackDispatcher dispatcher([&](absl::StatusOr<Responses> responses) {
+      status = responses.status();
+    });
+    dispatcher.Dispatch(absl::CancelledError("Process cancelled."));
+  }
+  EXPECT_EQ(status.code(), absl::StatusCode::kCancelled);
+}
+
+TEST(CallbackDispatcherTest, CoalescesWhileTheCallbackIsBehind) {
+  absl::Notification release_callback;
+  std::vector<std::string> texts;
+  absl::Status status;
+  {
+    CallbackDispatcher dispatcher(
+        [&](absl::StatusOr<Responses> responses) {
+          release_callback.WaitForNotification();
+          if (responses.ok() &&
+              responses->GetTaskState() == TaskState::kProcessing) {
+            texts.push_back(responses->GetTexts()[0]);
+          }
+          status = responses.status();
+        },
+        /*capacity=*/1, CallbackBackpressurePolicy::kCoalesce);
+    // Once "a" and "b" wait for the callback, the next texts are merged
+    // without waiting.
+    dispatcher.Dispatch(TextResponses("a"));
+    dispatcher.Dispatch(TextResponses("b"));
+    dispatcher.Dispatch(TextResponses("c"));
+    dispatcher.Dispatch(TextResponses("d"));
+    release_callback.Notify();
+    dispatcher.Dispatch(Responses(TaskState::kDone));
+  }
+  ASSERT_GE(texts.size(), 2);
+  EXPECT_EQ(absl::StrJoin(texts, ""), "abcd");
+  EXPECT_TRUE(status.ok());
+}
+
+TEST(CallbackDispatcherTest, CancelsWhenTheCallbackIsBehind) {
+  absl::Notification release_callback;
+  std::vector<std::string> texts;
+  absl::Status status;
+  int num_overflows = 0;
+  {
+    CallbackDispatcher dispatcher(
+        [&](absl::StatusOr<Responses> responses) {
+          release_callback.WaitForNotification();
+          if (responses.ok() &&
+              responses->GetTaskState() == TaskState::kProcessing) {
+            texts.push_back(responses->GetTexts()[0]);
+          }
+          status = responses.status();
+        },
+        /*capacity=*/1, CallbackBackpressurePolicy::kCancel,
+        [&]() { ++num_overflows; });
+    dispatcher.Dispatch(TextResponses("a"));
+    dispatcher.Dispatch(TextResponses("b"));
+    dispatcher.Dispatch(TextResponses("c"));
+    dispatcher.Dispatch(TextResponses("d"));
+    EXPECT_TRUE(dispatcher.HasOverflowed());
+    release_callback.Notify();
+    dispatcher.Dispatch(absl::CancelledError("Process cancelled."));
+  }
+  EXPECT_EQ(num_overflows, 1);
+  EXPECT_THAT(texts, ::testing::Not(::testing::Contains("d")));
+  EXPECT_EQ(status.code(), absl::StatusCode::kResourceExhausted);
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,57 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/candidate_pruner.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/types/span.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+CandidatePruner::CandidatePruner(const Options& options,
+                                 int num_output_candidates)
+    : options_(options), pruned_(num_output_candidates, false) {}
+
+absl::Span<const int> CandidatePruner::Update(int num_decode_steps,
+                                              absl::Span<const float> scores) {
+  newly_pruned_.clear();
+  if (num_decode_steps < options_.min_num_decode_steps) {
+    return newly_pruned_;
+  }
+  ranking_.clear();
+  for (int i = 0; i < static_cast<int>(pruned_.size()); ++i) {
+    if (!pruned_[i]) {
+      ranking_.push_back(i);
+    }
+  }
+  // Stable, so that the ties keep the lower candidates.
+  std::stable_sort(ranking_.begin(), ranking_.end(), [&](int a, int b) {
+    return scores[a] > scores[b];
+  });
+  for (int rank = 1; rank < static_cast<int>(ranking_.size()); ++rank) {
+    const int candidate = ranking_[rank];
+    const bool over_limit = options_.max_num_candidates > 0 &&
+                            rank >= options_.max_num_candidates;
+    if (over_limit ||
+        scores[candidate] < scores[ranking_[0]] - options_.score_margin) {
+      pruned_[candidate] = true;
+      newly_pruned_.push_back(candidate);
+    }
+  }
+  return newly_pruned_;
+}
+
+}  // namespace litert::lm
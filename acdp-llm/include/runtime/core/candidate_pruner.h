@@ -0,0 +1,62 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_CANDIDATE_PRUNER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_CANDIDATE_PRUNER_H_
+
+#include <vector>
+
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/engine/io_types.h"
+
+namespace litert::lm {
+
+// Picks the output candidates to drop from a decode, following
+// DecodeConfig::CandidatePruningOptions. The best candidate is never pruned,
+// and a pruned candidate stays pruned for the rest of the decode.
+//
+// Example usage:
+//   CandidatePruner pruner(options, num_output_candidates);
+//   // After each decode step:
+//   for (int candidate : pruner.Update(num_decode_steps, scores)) {
+//     // Stop decoding the candidate.
+//   }
+class CandidatePruner {
+ public:
+  using Options = DecodeConfig::CandidatePruningOptions;
+
+  CandidatePruner(const Options& options, int num_output_candidates);
+
+  CandidatePruner(const CandidatePruner&) = delete;
+  CandidatePruner& operator=(const CandidatePruner&) = delete;
+
+  // Updates the pruning with the scores of the candidates after
+  // `num_decode_steps` steps, the average log-probabilities of their tokens.
+  // Returns the candidates pruned by the call, valid until the next call.
+  absl::Span<const int> Update(int num_decode_steps,
+                               absl::Span<const float> scores);
+
+  bool IsPruned(int candidate) const { return pruned_[candidate]; }
+
+ private:
+  const Options options_;
+  std::vector<bool> pruned_;
+  // Reused across the calls.
+  std::vector<int> ranking_;
+  std::vector<int> newly_pruned_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_CANDIDATE_PRUNER_H_
@@ -0,0 +1,70 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/candidate_pruner.h"
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::UnorderedElementsAre;
+
+TEST(CandidatePrunerTest, PrunesTheCandidatesBehindTheMargin) {
+  CandidatePruner::Options options;
+  options.score_margin = 1.0f;
+  CandidatePruner pruner(options, /*num_output_candidates=*/3);
+  EXPECT_THAT(pruner.Update(/*num_decode_steps=*/1, {-1.5f, -1.0f, -2.5f}),
+              ElementsAre(2));
+  EXPECT_TRUE(pruner.IsPruned(2));
+  // The pruned candidates stay pruned.
+  EXPECT_THAT(pruner.Update(/*num_decode_steps=*/2, {-1.5f, -1.0f, 0.0f}),
+              IsEmpty());
+  EXPECT_FALSE(pruner.IsPruned(0));
+  EXPECT_FALSE(pruner.IsPruned(1));
+  EXPECT_TRUE(pruner.IsPruned(2));
+}
+
+TEST(CandidatePrunerTest, KeepsTheBestCandidates) {
+  CandidatePruner::Options options;
+  options.max_num_candidates = 2;
+  options.min_num_decode_steps = 4;
+  CandidatePruner pruner(options, /*num_output_candidates=*/4);
+  EXPECT_THAT(pruner.Update(/*num_decode_steps=*/3, {-4.0f, -3.0f, -2.0f,
+                                                     -1.0f}),
+              IsEmpty());
+  EXPECT_THAT(pruner.Update(/*num_decode_steps=*/4, {-1.0f, -3.0f, -2.0f,
+                                                     -1.0f}),
+              UnorderedElementsAre(1, 2));
+}
+
+TEST(CandidatePrunerTest, NeverPrunesTheBestCandidate) {
+  CandidatePruner::Options options;
+  options.score_margin = 0.0f;
+  options.max_num_candidates = 1;
+  CandidatePruner pruner(options, /*num_output_candidates=*/2);
+  EXPECT_THAT(pruner.Update(/*num_decode_steps=*/1, {-1.0f, -1.0f}),
+              ElementsAre(1));
+  EXPECT_THAT(pruner.Update(/*num_decode_steps=*/2, {-5.0f, 0.0f}),
+              IsEmpty());
+  EXPECT_FALSE(pruner.IsPruned(0));
+}
+
+}  // namespace
+}  // namespace litert::lm
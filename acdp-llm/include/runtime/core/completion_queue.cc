@@ -0,0 +1,136 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/completion_queue.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+#if !defined(_WIN32)
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#endif
+
+namespace litert::lm {
+
+absl::StatusOr<std::unique_ptr<CompletionQueue>> CompletionQueue::Create() {
+#if defined(__linux__)
+  // An eventfd is one descriptor both written and read.
+  const int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (fd < 0) {
+    return absl::InternalError(
+        absl::StrCat("Failed to create an eventfd: ", strerror(errno)));
+  }
+  return std::unique_ptr<CompletionQueue>(new CompletionQueue(fd, fd));
+#elif !defined(_WIN32)
+  int fds[2];
+  if (pipe(fds) != 0) {
+    return absl::InternalError(
+        absl::StrCat("Failed to create a pipe: ", strerror(errno)));
+  }
+  for (int fd : fds) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+  return std::unique_ptr<CompletionQueue>(new CompletionQueue(fds[0], fds[1]));
+#else
+  return absl::UnimplementedError(
+      "Completion queues are not supported on this platform.");
+#endif
+}
+
+CompletionQueue::CompletionQueue(int read_fd, int write_fd)
+    : read_fd_(read_fd), write_fd_(write_fd) {
+  Node* stub = new Node();
+  newest_.store(stub, std::memory_order_relaxed);
+  oldest_ = stub;
+}
+
+CompletionQueue::~CompletionQueue() {
+  while (oldest_ != nullptr) {
+    Node* next = oldest_->next.load(std::memory_order_acquire);
+    delete oldest_;
+    oldest_ = next;
+  }
+#if !defined(_WIN32)
+  close(read_fd_);
+  if (write_fd_ != read_fd_) {
+    close(write_fd_);
+  }
+#endif
+}
+
+void CompletionQueue::Push(Completion completion) {
+  Node* node = new Node();
+  node->completion = std::move(completion);
+  Node* previous = newest_.exchange(node, std::memory_order_acq_rel);
+  // Poll does not see the node before it is linked here, but the signal
+  // below comes after the link, so it is polled then.
+  previous->next.store(node, std::memory_order_release);
+  Signal();
+}
+
+size_t CompletionQueue::Poll(std::vector<Completion>& completions,
+                             size_t max_completions) {
+  // Cleared first, so that the completions pushed from now on signal again.
+  if (signalled_.exchange(false, std::memory_order_acq_rel)) {
+#if !defined(_WIN32)
+    uint64_t buffer[64];
+    while (read(read_fd_, buffer, sizeof(buffer)) > 0) {
+    }
+#endif
+  }
+  size_t num_polled = 0;
+  while (num_polled < max_completions) {
+    Node* next = oldest_->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      break;
+    }
+    completions.push_back(*std::move(next->completion));
+    next->completion.reset();
+    delete oldest_;
+    oldest_ = next;
+    ++num_polled;
+  }
+  if (oldest_->next.load(std::memory_order_acquire) != nullptr) {
+    Signal();
+  }
+  return num_polled;
+}
+
+void CompletionQueue::Signal() {
+  if (signalled_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+#if !defined(_WIN32)
+  const uint64_t one = 1;
+  // Fails only if the descriptor is already readable.
+  (void)write(write_fd_, &one, sizeof(one));
+#endif
+}
+
+}  // namespace litert::lm
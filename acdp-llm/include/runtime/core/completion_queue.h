@@ -0,0 +1,104 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_COMPLETION_QUEUE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_COMPLETION_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// A part of the response to a request submitted to a CompletionQueue.
+struct Completion {
+  // The tag the request was submitted with.
+  uint64_t tag = 0;
+  // The text generated since the previous completion of the request.
+  std::string text;
+  // Whether this is the last completion of the request.
+  bool is_final = false;
+  // The status of the request, on its last completion.
+  absl::Status status;
+};
+
+// Collects the completions of asynchronous requests for an event loop, so
+// that the threads running the requests never call into the loop. The
+// completions are pushed through a lock-free queue, and a file descriptor
+// becomes readable when there are completions to poll, for the loop to wait
+// on, e.g. with epoll.
+//
+// Push may be called from any thread, Poll from one thread at a time.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(auto queue, CompletionQueue::Create());
+//   // Register queue->GetFd() with the event loop, then on readability:
+//   std::vector<Completion> completions;
+//   queue->Poll(completions, /*max_completions=*/64);
+class CompletionQueue {
+ public:
+  // Returns Unimplemented on the platforms without pipes.
+  static absl::StatusOr<std::unique_ptr<CompletionQueue>> Create();
+
+  CompletionQueue(const CompletionQueue&) = delete;
+  CompletionQueue& operator=(const CompletionQueue&) = delete;
+
+  // Closes the file descriptors and drops the completions not polled.
+  ~CompletionQueue();
+
+  // Returns the file descriptor readable while there may be completions to
+  // poll. It must not be read or closed by the caller.
+  int GetFd() const { return read_fd_; }
+
+  // Queues a completion and makes the file descriptor readable. Never blocks.
+  void Push(Completion completion);
+
+  // Moves up to `max_completions` completions, in their push order, to the
+  // back of `completions` and returns their number. The file descriptor stays
+  // readable if completions are left.
+  size_t Poll(std::vector<Completion>& completions, size_t max_completions);
+
+ private:
+  // A node of the queue, linked from the oldest to the newest.
+  struct Node {
+    std::atomic<Node*> next = nullptr;
+    std::optional<Completion> completion;
+  };
+
+  CompletionQueue(int read_fd, int write_fd);
+
+  // Makes the file descriptor readable unless it already is.
+  void Signal();
+
+  const int read_fd_;
+  const int write_fd_;
+  // Whether the file descriptor was made readable since the last poll, to
+  // write it once per poll.
+  std::atomic<bool> signalled_ = false;
+  // The producers swap the newest node and then link it to the previous one.
+  // The oldest node is a consumed one, only touched by Poll.
+  alignas(64) std::atomic<Node*> newest_;
+  alignas(64) Node* oldest_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_COMPLETION_QUEUE_H_
@@ -0,0 +1,111 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/completion_queue.h"
+
+#include <poll.h>
+
+#include <cstdint>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+bool IsReadable(int fd) {
+  pollfd poll_fd = {.fd = fd, .events = POLLIN};
+  return poll(&poll_fd, 1, /*timeout=*/0) == 1;
+}
+
+TEST(CompletionQueueTest, PollsInPushOrder) {
+  ASSERT_OK_AND_ASSIGN(auto queue, CompletionQueue::Create());
+  EXPECT_FALSE(IsReadable(queue->GetFd()));
+
+  queue->Push({.tag = 1, .text = "Hello"});
+  queue->Push({.tag = 2, .text = "Hi"});
+  queue->Push({.tag = 1,
+               .is_final = true,
+               .status = absl::CancelledError("Cancelled.")});
+  EXPECT_TRUE(IsReadable(queue->GetFd()));
+
+  std::vector<Completion> completions;
+  EXPECT_EQ(queue->Poll(completions, /*max_completions=*/8), 3);
+  ASSERT_EQ(completions.size(), 3);
+  EXPECT_EQ(completions[0].tag, 1);
+  EXPECT_EQ(completions[0].text, "Hello");
+  EXPECT_FALSE(completions[0].is_final);
+  EXPECT_EQ(completions[1].tag, 2);
+  EXPECT_EQ(completions[1].text, "Hi");
+  EXPECT_TRUE(completions[2].is_final);
+  EXPECT_TRUE(absl::IsCancelled(completions[2].status));
+  EXPECT_FALSE(IsReadable(queue->GetFd()));
+}
+
+TEST(CompletionQueueTest, StaysReadableWhileCompletionsAreLeft) {
+  ASSERT_OK_AND_ASSIGN(auto queue, CompletionQueue::Create());
+  queue->Push({.tag = 1, .text = "a"});
+  queue->Push({.tag = 1, .text = "b"});
+
+  std::vector<Completion> completions;
+  EXPECT_EQ(queue->Poll(completions, /*max_completions=*/1), 1);
+  EXPECT_TRUE(IsReadable(queue->GetFd()));
+  EXPECT_EQ(queue->Poll(completions, /*max_completions=*/1), 1);
+  EXPECT_FALSE(IsReadable(queue->GetFd()));
+  EXPECT_EQ(queue->Poll(completions, /*max_completions=*/1), 0);
+  ASSERT_EQ(completions.size(), 2);
+  EXPECT_EQ(completions[1].text, "b");
+}
+
+TEST(CompletionQueueTest, CollectsFromManyThreads) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumCompletions = 1000;
+  ASSERT_OK_AND_ASSIGN(auto queue, CompletionQueue::Create());
+  std::vector<std::thread> producers;
+  for (int tag = 0; tag < kNumThreads; ++tag) {
+    producers.emplace_back([&queue, tag]() {
+      for (int i = 0; i < kNumCompletions; ++i) {
+        queue->Push({.tag = static_cast<uint64_t>(tag),
+                     .text = std::to_string(i),
+                     .is_final = i + 1 == kNumCompletions});
+      }
+    });
+  }
+
+  std::vector<int> next_text(kNumThreads, 0);
+  int num_final = 0;
+  while (num_final < kNumThreads) {
+    pollfd poll_fd = {.fd = queue->GetFd(), .events = POLLIN};
+    ASSERT_EQ(poll(&poll_fd, 1, /*timeout=*/10000), 1);
+    std::vector<Completion> completions;
+    queue->Poll(completions, /*max_completions=*/64);
+    for (const Completion& completion : completions) {
+      // The completions of each thread keep their order.
+      ASSERT_EQ(completion.text, std::to_string(next_text[completion.tag]++));
+      num_final += completion.is_final;
+    }
+  }
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+  EXPECT_THAT(next_text, ::testing::Each(kNumCompletions));
+}
+
+}  // namespace
+}  // namespace litert::lm
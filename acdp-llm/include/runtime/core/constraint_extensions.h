@@ -0,0 +1,80 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_CONSTRAINT_EXTENSIONS_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_CONSTRAINT_EXTENSIONS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/components/constrained_decoding/constraint.h"
+
+namespace litert::lm {
+
+// This file contains optional capability interfaces that a Constraint
+// implementation may inherit from in addition to Constraint. Like the executor
+// extensions, they are detected at runtime with GetConstraintExtension<T>(),
+// and the decoding falls back to the plain Constraint API without them.
+
+// Returns `constraint` as the extension interface T, or nullptr if the
+// constraint is null or does not implement it.
+template <typename T>
+T* GetConstraintExtension(Constraint* constraint) {
+  return dynamic_cast<T*>(constraint);
+}
+
+// A constraint that knows the tokens it forces, i.e. the runs of tokens for
+// which its grammar admits a single continuation, such as fixed JSON keys or
+// the code fences of the tool calls. The decode loop appends them to the
+// context in a single model invocation ("jump-forward decoding") instead of
+// decoding them one at a time.
+class JumpForwardConstraint {
+ public:
+  virtual ~JumpForwardConstraint() = default;
+
+  // Returns, in order, up to `max_num_tokens` tokens forced after `token_ids`,
+  // the tokens decoded since the constraint started, or none if the next
+  // token is not forced. Across the calls of a decode, `token_ids` only grows
+  // by appending, so implementations may cache the state of the last prefix.
+  // Must be thread-safe, since a constraint is shared by concurrent decodes.
+  virtual absl::StatusOr<std::vector<int>> GetForcedTokens(
+      absl::Span<const int> token_ids, int max_num_tokens) const = 0;
+};
+
+// A constraint that computes the tokens it allows as a packed bitmask, bit
+// `token_id % 32` of word `token_id / 32` being set for the allowed tokens, as
+// LogitsKernels::ApplyTokenBitmask takes. With an executor implementing
+// TokenBitmaskLlmExecutor, the decode loop hands the bitmasks to the sampler
+// of the executor instead of reading back the logits to mask them on the
+// host.
+class TokenBitmaskConstraint {
+ public:
+  virtual ~TokenBitmaskConstraint() = default;
+
+  // Writes to `bitmask` the tokens allowed after `token_ids`, the tokens
+  // decoded since the constraint started. `bitmask` covers the vocabulary of
+  // the model, (vocabulary size + 31) / 32 words. Implementations should
+  // memoize the bitmasks of the states they reach, the tool-call grammars
+  // coming back to the same states. Must be thread-safe, since a constraint is
+  // shared by concurrent decodes.
+  virtual absl::Status FillTokenBitmask(absl::Span<const int> token_ids,
+                                        absl::Span<uint32_t> bitmask) const = 0;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_CONSTRAINT_EXTENSIONS_H_
@@ -0,0 +1,64 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/context_compactor.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+
+// static
+absl::StatusOr<std::unique_ptr<ContextCompactor>> ContextCompactor::Create(
+    ContextEvictionLlmExecutor* executor, int max_num_tokens,
+    int num_sink_tokens, int num_eviction_tokens) {
+  if (num_sink_tokens < 0 || num_eviction_tokens < 1 ||
+      num_sink_tokens + num_eviction_tokens >= max_num_tokens) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Can not keep ", num_sink_tokens, " sink tokens and evict ",
+        num_eviction_tokens, " tokens at once in a context of ",
+        max_num_tokens, " tokens."));
+  }
+  return absl::WrapUnique(new ContextCompactor(
+      executor, max_num_tokens, num_sink_tokens, num_eviction_tokens));
+}
+
+absl::StatusOr<int> ContextCompactor::MakeRoom(int current_step,
+                                               int num_new_tokens) {
+  // The context is full once it reaches max_num_tokens, so the new tokens
+  // must leave at least one free position.
+  const int num_needed_tokens =
+      current_step + num_new_tokens - (max_num_tokens_ - 1);
+  if (num_needed_tokens <= 0) {
+    return 0;
+  }
+  const int num_evictable_tokens = current_step - num_sink_tokens_;
+  if (num_needed_tokens > num_evictable_tokens) {
+    return 0;
+  }
+  const int num_tokens = std::min(
+      std::max(num_needed_tokens, num_eviction_tokens_), num_evictable_tokens);
+  RETURN_IF_ERROR(executor_.EvictTokens(num_sink_tokens_, num_tokens));
+  num_evicted_tokens_ += num_tokens;
+  return num_tokens;
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,78 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_CONTEXT_COMPACTOR_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_CONTEXT_COMPACTOR_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "absl/base/nullability.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+
+namespace litert::lm {
+
+// Implements ContextOverflowPolicy::kSlidingWindow: when new tokens would not
+// fit in the context, the first `num_sink_tokens` tokens are kept and the
+// oldest tokens following them are evicted, at least `num_eviction_tokens` at
+// a time so that the evictions stay rare.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(auto compactor, ContextCompactor::Create(
+//       eviction_executor, max_num_tokens, /*num_sink_tokens=*/4,
+//       /*num_eviction_tokens=*/256));
+//   // Before appending `num_tokens` tokens to the context:
+//   ASSIGN_OR_RETURN(int num_evicted_tokens,
+//                    compactor->MakeRoom(current_step, num_tokens));
+class ContextCompactor {
+ public:
+  // The executor must outlive the compactor. `max_num_tokens` is the maximum
+  // context length of the executor.
+  static absl::StatusOr<std::unique_ptr<ContextCompactor>> Create(
+      ContextEvictionLlmExecutor* absl_nonnull executor, int max_num_tokens,
+      int num_sink_tokens, int num_eviction_tokens);
+
+  ContextCompactor(const ContextCompactor&) = delete;
+  ContextCompactor& operator=(const ContextCompactor&) = delete;
+
+  // Evicts tokens from the context of `current_step` tokens if needed so that
+  // `num_new_tokens` more tokens fit in it. Returns the number of evicted
+  // tokens, 0 if the tokens already fit or if they would not fit even after
+  // evicting all the tokens but the sinks.
+  absl::StatusOr<int> MakeRoom(int current_step, int num_new_tokens);
+
+  int GetMaxNumTokens() const { return max_num_tokens_; }
+
+  // Returns the total number of tokens evicted so far.
+  int64_t GetNumEvictedTokens() const { return num_evicted_tokens_; }
+
+ private:
+  ContextCompactor(ContextEvictionLlmExecutor* executor, int max_num_tokens,
+                   int num_sink_tokens, int num_eviction_tokens)
+      : executor_(*executor),
+        max_num_tokens_(max_num_tokens),
+        num_sink_tokens_(num_sink_tokens),
+        num_eviction_tokens_(num_eviction_tokens) {}
+
+  ContextEvictionLlmExecutor& executor_;
+  const int max_num_tokens_;
+  const int num_sink_tokens_;
+  const int num_eviction_tokens_;
+  int64_t num_evicted_tokens_ = 0;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_CONTEXT_COMPACTOR_H_
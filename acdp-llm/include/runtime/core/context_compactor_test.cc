@@ -0,0 +1,105 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/context_compactor.h"
+
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::Pair;
+using ::testing::status::IsOkAndHolds;
+using ::testing::status::StatusIs;
+
+// Records the evictions.
+class FakeEvictionExecutor : public ContextEvictionLlmExecutor {
+ public:
+  absl::Status EvictTokens(int start, int num_tokens) override {
+    evictions.emplace_back(start, num_tokens);
+    return absl::OkStatus();
+  }
+
+  std::vector<std::pair<int, int>> evictions;
+};
+
+TEST(ContextCompactorTest, CreateFailsWithoutRoomForTheWindow) {
+  FakeEvictionExecutor executor;
+  EXPECT_THAT(ContextCompactor::Create(&executor, /*max_num_tokens=*/100,
+                                       /*num_sink_tokens=*/50,
+                                       /*num_eviction_tokens=*/50),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ContextCompactor::Create(&executor, /*max_num_tokens=*/100,
+                                       /*num_sink_tokens=*/4,
+                                       /*num_eviction_tokens=*/0),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ContextCompactorTest, DoesNothingWhileTheTokensFit) {
+  FakeEvictionExecutor executor;
+  ASSERT_OK_AND_ASSIGN(auto compactor,
+                       ContextCompactor::Create(&executor,
+                                                /*max_num_tokens=*/100,
+                                                /*num_sink_tokens=*/4,
+                                                /*num_eviction_tokens=*/10));
+  EXPECT_THAT(compactor->MakeRoom(/*current_step=*/0, /*num_new_tokens=*/99),
+              IsOkAndHolds(0));
+  EXPECT_THAT(compactor->MakeRoom(/*current_step=*/98, /*num_new_tokens=*/1),
+              IsOkAndHolds(0));
+  EXPECT_THAT(executor.evictions, IsEmpty());
+}
+
+TEST(ContextCompactorTest, EvictsAfterTheSinks) {
+  FakeEvictionExecutor executor;
+  ASSERT_OK_AND_ASSIGN(auto compactor,
+                       ContextCompactor::Create(&executor,
+                                                /*max_num_tokens=*/100,
+                                                /*num_sink_tokens=*/4,
+                                                /*num_eviction_tokens=*/10));
+  // A decode step evicts the minimum number of tokens.
+  EXPECT_THAT(compactor->MakeRoom(/*current_step=*/99, /*num_new_tokens=*/1),
+              IsOkAndHolds(10));
+  // A long prefill evicts as many tokens as needed.
+  EXPECT_THAT(compactor->MakeRoom(/*current_step=*/89, /*num_new_tokens=*/30),
+              IsOkAndHolds(20));
+  EXPECT_THAT(executor.evictions, ElementsAre(Pair(4, 10), Pair(4, 20)));
+  EXPECT_EQ(compactor->GetNumEvictedTokens(), 30);
+}
+
+TEST(ContextCompactorTest, EvictsAtMostTheTokensAfterTheSinks) {
+  FakeEvictionExecutor executor;
+  ASSERT_OK_AND_ASSIGN(auto compactor,
+                       ContextCompactor::Create(&executor,
+                                                /*max_num_tokens=*/100,
+                                                /*num_sink_tokens=*/4,
+                                                /*num_eviction_tokens=*/10));
+  EXPECT_THAT(compactor->MakeRoom(/*current_step=*/10, /*num_new_tokens=*/95),
+              IsOkAndHolds(6));
+  // The tokens do not fit even without any token but the sinks.
+  EXPECT_THAT(compactor->MakeRoom(/*current_step=*/10, /*num_new_tokens=*/99),
+              IsOkAndHolds(0));
+  EXPECT_THAT(executor.evictions, ElementsAre(Pair(4, 6)));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,293 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/continuous_batching_scheduler.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/components/constrained_decoding/constrained_decoder.h"
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+
+ContinuousBatchingScheduler::Slot::~Slot() {
+  auto status = scheduler_.ReleaseSlot(id_);
+  if (!status.ok()) {
+    ABSL_LOG(ERROR) << "Failed to release slot " << id_ << ": " << status;
+  }
+}
+
+absl::Status ContinuousBatchingScheduler::Slot::RunExclusive(
+    absl::AnyInvocable<absl::Status()> fn) {
+  return scheduler_.RunExclusive(id_, std::move(fn));
+}
+
+absl::Status ContinuousBatchingScheduler::Slot::DecodeStep(
+    litert::TensorBuffer& output_tokens,
+    ConstrainedDecoder* constrained_decoder,
+    const LogitsProcessor* logits_processor) {
+  return scheduler_.DecodeStep(id_, output_tokens, constrained_decoder,
+                               logits_processor);
+}
+
+void ContinuousBatchingScheduler::Slot::EndDecode() {
+  scheduler_.EndDecode(id_);
+}
+
+int ContinuousBatchingScheduler::Slot::GetCurrentStep() const {
+  return scheduler_.GetCurrentStep(id_);
+}
+
+void ContinuousBatchingScheduler::Slot::SetLoraAdapter(int lora_id) {
+  scheduler_.SetLoraAdapter(id_, lora_id);
+}
+
+// static
+absl::StatusOr<std::unique_ptr<ContinuousBatchingScheduler>>
+ContinuousBatchingScheduler::Create(SlotBatchedLlmExecutor* executor,
+                                    absl::Duration max_batch_wait,
+                                    int prefill_chunk_size) {
+  if (executor->GetMaxNumSlots() <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The executor must support at least one slot, got ",
+                     executor->GetMaxNumSlots()));
+  }
+  if (max_batch_wait < absl::ZeroDuration()) {
+    return absl::InvalidArgumentError("max_batch_wait must not be negative.");
+  }
+  if (prefill_chunk_size < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("prefill_chunk_size must not be negative, got ",
+                     prefill_chunk_size));
+  }
+  return absl::WrapUnique(new ContinuousBatchingScheduler(
+      executor, max_batch_wait, prefill_chunk_size));
+}
+
+absl::StatusOr<std::unique_ptr<ContinuousBatchingScheduler::Slot>>
+ContinuousBatchingScheduler::AcquireSlot() {
+  absl::MutexLock lock(&mutex_);
+  mutex_.Await(
+      absl::Condition(this, &ContinuousBatchingScheduler::ExecutorIdle));
+  if (static_cast<int>(slots_.size()) >= executor_.GetMaxNumSlots()) {
+    return absl::ResourceExhaustedError(
+        absl::StrCat("All ", executor_.GetMaxNumSlots(),
+                     " slots of the executor are in use."));
+  }
+  ASSIGN_OR_RETURN(int slot, executor_.AllocateSlot());
+  if (slots_.contains(slot)) {
+    return absl::InternalError(
+        absl::StrCat("The executor allocated slot ", slot, " twice."));
+  }
+  slots_[slot] = SlotState();
+  return absl::WrapUnique(new Slot(this, slot));
+}
+
+ContinuousBatchingScheduler::Stats ContinuousBatchingScheduler::GetStats()
+    const {
+  absl::MutexLock lock(&mutex_);
+  return stats_;
+}
+
+absl::Status ContinuousBatchingScheduler::ReleaseSlot(int slot) {
+  absl::MutexLock lock(&mutex_);
+  EndDecodeLocked(slot);
+  mutex_.Await(
+      absl::Condition(this, &ContinuousBatchingScheduler::ExecutorIdle));
+  slots_.erase(slot);
+  // The executor is idle and the mutex is held, so the release can not race
+  // with any batch.
+  return executor_.ReleaseSlot(slot);
+}
+
+absl::Status ContinuousBatchingScheduler::RunExclusive(
+    int slot, absl::AnyInvocable<absl::Status()> fn) {
+  {
+    absl::MutexLock lock(&mutex_);
+    // A slot running exclusive work is not part of the decode batches.
+    EndDecodeLocked(slot);
+    ++num_waiting_exclusive_tasks_;
+    mutex_.Await(
+        absl::Condition(this, &ContinuousBatchingScheduler::CanRunExclusive));
+    --num_waiting_exclusive_tasks_;
+    executor_busy_ = true;
+    last_run_was_exclusive_ = true;
+  }
+  absl::Status status = executor_.SelectSlot(slot);
+  if (status.ok()) {
+    status = fn();
+  }
+  absl::StatusOr<int> current_step = executor_.GetSlotCurrentStep(slot);
+  absl::MutexLock lock(&mutex_);
+  executor_busy_ = false;
+  if (current_step.ok()) {
+    slots_[slot].current_step = *current_step;
+  }
+  return status;
+}
+
+absl::Status ContinuousBatchingScheduler::DecodeStep(
+    int slot, litert::TensorBuffer& output_tokens,
+    ConstrainedDecoder* constrained_decoder,
+    const LogitsProcessor* logits_processor) {
+  PendingDecode pending;
+  pending.request.slot = slot;
+  pending.request.output_tokens = &output_tokens;
+  pending.request.constrained_decoder = constrained_decoder;
+  pending.request.logits_processor = logits_processor;
+  DecodeWaitArg wait_arg{this, &pending};
+
+  absl::MutexLock lock(&mutex_);
+  SlotState& state = slots_[slot];
+  pending.request.lora_id = state.lora_id;
+  if (!state.decoding) {
+    state.decoding = true;
+    ++num_decoding_slots_;
+  }
+  pending_decodes_.push_back(&pending);
+  while (!pending.done) {
+    if (!CanRunBatch()) {
+      // Either the executor is running a batch, which may contain this step,
+      // or an exclusive task is running or has its turn next.
+      mutex_.Await(absl::Condition(
+          &ContinuousBatchingScheduler::DecodeDoneOrCanRunBatch, &wait_arg));
+      continue;
+    }
+    // Lead the next batch. Give the other decoding slots a chance to join
+    // before issuing it.
+    mutex_.AwaitWithTimeout(
+        absl::Condition(this,
+                        &ContinuousBatchingScheduler::BatchFullOrCannotRun),
+        max_batch_wait_);
+    if (pending.done || !CanRunBatch()) {
+      continue;
+    }
+    RunBatchLocked();
+  }
+  return pending.status;
+}
+
+void ContinuousBatchingScheduler::EndDecode(int slot) {
+  absl::MutexLock lock(&mutex_);
+  EndDecodeLocked(slot);
+}
+
+int ContinuousBatchingScheduler::GetCurrentStep(int slot) const {
+  absl::MutexLock lock(&mutex_);
+  auto it = slots_.find(slot);
+  return it == slots_.end() ? 0 : it->second.current_step;
+}
+
+void ContinuousBatchingScheduler::SetLoraAdapter(int slot, int lora_id) {
+  absl::MutexLock lock(&mutex_);
+  slots_[slot].lora_id = lora_id;
+}
+
+void ContinuousBatchingScheduler::EndDecodeLocked(int slot) {
+  auto it = slots_.find(slot);
+  if (it != slots_.end() && it->second.decoding) {
+    it->second.decoding = false;
+    --num_decoding_slots_;
+  }
+}
+
+void ContinuousBatchingScheduler::RunBatchLocked() {
+  std::vector<PendingDecode*> batch;
+  batch.swap(pending_decodes_);
+  executor_busy_ = true;
+  last_run_was_exclusive_ = false;
+
+  const bool split_by_adapter =
+      lora_executor_ != nullptr && !lora_executor_->SupportsMixedLoraBatches();
+  if (split_by_adapter) {
+    std::stable_sort(batch.begin(), batch.end(),
+                     [](const PendingDecode* a, const PendingDecode* b) {
+                       return a->request.lora_id < b->request.lora_id;
+                     });
+  }
+  std::vector<SlotDecodeRequest> requests;
+  requests.reserve(batch.size());
+  for (const PendingDecode* pending : batch) {
+    requests.push_back(pending->request);
+  }
+
+  mutex_.Unlock();
+  // The [begin, end) ranges of the requests issued by each DecodeSlots call,
+  // with their status.
+  std::vector<std::pair<int, int>> sub_batches;
+  std::vector<absl::Status> statuses;
+  for (int begin = 0; begin < requests.size();) {
+    int end = requests.size();
+    absl::Status status;
+    if (split_by_adapter) {
+      end = begin + 1;
+      while (end < requests.size() &&
+             requests[end].lora_id == requests[begin].lora_id) {
+        ++end;
+      }
+      status = lora_executor_->SelectLoraAdapter(requests[begin].lora_id);
+    }
+    if (status.ok()) {
+      status = executor_.DecodeSlots(
+          absl::MakeConstSpan(requests).subspan(begin, end - begin));
+    }
+    sub_batches.emplace_back(begin, end);
+    statuses.push_back(std::move(status));
+    begin = end;
+  }
+  std::vector<absl::StatusOr<int>> current_steps;
+  current_steps.reserve(requests.size());
+  for (const SlotDecodeRequest& request : requests) {
+    current_steps.push_back(executor_.GetSlotCurrentStep(request.slot));
+  }
+  mutex_.Lock();
+
+  for (int j = 0; j < sub_batches.size(); ++j) {
+    for (int i = sub_batches[j].first; i < sub_batches[j].second; ++i) {
+      batch[i]->status = statuses[j];
+      batch[i]->done = true;
+      if (current_steps[i].ok()) {
+        slots_[requests[i].slot].current_step = *current_steps[i];
+      }
+    }
+  }
+  executor_busy_ = false;
+  stats_.num_decode_batches += sub_batches.size();
+  stats_.num_lora_split_batches += sub_batches.size() - 1;
+  stats_.num_batched_decode_steps += batch.size();
+  stats_.max_batch_size =
+      std::max(stats_.max_batch_size, static_cast<int>(batch.size()));
+}
+
+// static
+bool ContinuousBatchingScheduler::DecodeDoneOrCanRunBatch(DecodeWaitArg* arg) {
+  arg->scheduler->mutex_.AssertHeld();
+  return arg->pending->done || arg->scheduler->CanRunBatch();
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,240 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_CONTINUOUS_BATCHING_SCHEDULER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_CONTINUOUS_BATCHING_SCHEDULER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/base/nullability.h"  // from @com_google_absl
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/components/constrained_decoding/constrained_decoder.h"
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/core/logits_processor.h"
+
+namespace litert::lm {
+
+// ContinuousBatchingScheduler shares one SlotBatchedLlmExecutor between
+// several concurrently running sessions. Every session owns a context slot of
+// the executor and:
+// - runs its decode steps through Slot::DecodeStep. The scheduler merges the
+//   decode steps of all the sessions that are in their decode loop into a
+//   single SlotBatchedLlmExecutor::DecodeSlots call per step.
+// - runs all the other executor work (prefill, scoring, custom sampling, ...)
+//   through Slot::RunExclusive. The work is admitted between two batched
+//   decode steps, so new prefills do not have to wait for the running
+//   generations to finish. Sessions split long prefills into chunks of
+//   Slot::GetPrefillChunkSize() tokens, each run as its own exclusive task,
+//   so that a long prompt delays the decode steps of the other sessions by
+//   one chunk at most.
+//
+// Sessions using different LoRA adapters, see Slot::SetLoraAdapter, share the
+// batches when the executor supports mixed-adapter batches, see
+// LoraLlmExecutor::SupportsMixedLoraBatches. Otherwise every batch is issued
+// as one DecodeSlots call per adapter.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(auto slot, scheduler->AcquireSlot());
+//   RETURN_IF_ERROR(slot->RunExclusive(
+//       [&]() { return executor.Prefill(inputs, params); }));
+//   while (...) {
+//     RETURN_IF_ERROR(
+//         slot->DecodeStep(output_tokens, /*constrained_decoder=*/nullptr));
+//   }
+//   slot->EndDecode();
+class ContinuousBatchingScheduler {
+ public:
+  // The default time the first session arriving at a decode step waits for
+  // the other decoding sessions to join the batch.
+  static constexpr absl::Duration kDefaultMaxBatchWait = absl::Milliseconds(2);
+
+  // Counters describing how well the decode steps were batched.
+  struct Stats {
+    // The number of DecodeSlots calls issued to the executor.
+    int64_t num_decode_batches = 0;
+    // The total number of slot decode steps over all the batches.
+    int64_t num_batched_decode_steps = 0;
+    // The number of extra DecodeSlots calls issued because batches had to be
+    // split by LoRA adapter.
+    int64_t num_lora_split_batches = 0;
+    // The largest batch issued so far.
+    int max_batch_size = 0;
+  };
+
+  // A context slot of the executor, owned by a single session. Releases the
+  // slot on destruction. The methods of a Slot must not be called
+  // concurrently with each other.
+  class Slot {
+   public:
+    ~Slot();
+
+    Slot(const Slot&) = delete;
+    Slot& operator=(const Slot&) = delete;
+
+    // Returns the id of the slot in the executor.
+    int id() const { return id_; }
+
+    // Runs `fn` with the executor targeting this slot, once no other work is
+    // running on the executor. `fn` may use the regular LlmExecutor API.
+    absl::Status RunExclusive(absl::AnyInvocable<absl::Status()> fn);
+
+    // Runs one decode step for this slot, writing the sampled token ids into
+    // `output_tokens` ([num_output_candidates, 1]). Blocks until the batch the
+    // step was merged into is done.
+    absl::Status DecodeStep(
+        litert::TensorBuffer& output_tokens,
+        ConstrainedDecoder* constrained_decoder,
+        const LogitsProcessor* logits_processor = nullptr);
+
+    // Marks the end of the decode loop of this slot, so that the following
+    // batches no longer wait for it to join.
+    void EndDecode();
+
+    // Returns the number of tokens processed so far by the slot, as of the
+    // end of the last executor call that touched it.
+    int GetCurrentStep() const;
+
+    // Returns the maximum number of tokens to prefill per exclusive task, or
+    // 0 if prefills should not be split.
+    int GetPrefillChunkSize() const { return scheduler_.prefill_chunk_size_; }
+
+    // Sets the LoRA adapter the decode steps of this slot run with,
+    // LoraLlmExecutor::kNoLoraAdapter for the base model. The exclusive tasks
+    // must select the adapter themselves.
+    void SetLoraAdapter(int lora_id);
+
+   private:
+    friend class ContinuousBatchingScheduler;
+    Slot(ContinuousBatchingScheduler* scheduler, int id)
+        : scheduler_(*scheduler), id_(id) {}
+
+    ContinuousBatchingScheduler& scheduler_;
+    const int id_;
+  };
+
+  // Creates a scheduler on top of `executor`, which must outlive the
+  // scheduler and every slot acquired from it.
+  // - max_batch_wait: The maximum time a decode step waits for the other
+  //   decoding sessions before the batch is issued without them.
+  // - prefill_chunk_size: The maximum number of tokens the sessions prefill
+  //   per exclusive task. 0 disables the chunking.
+  static absl::StatusOr<std::unique_ptr<ContinuousBatchingScheduler>> Create(
+      SlotBatchedLlmExecutor* absl_nonnull executor,
+      absl::Duration max_batch_wait = kDefaultMaxBatchWait,
+      int prefill_chunk_size = 0);
+
+  // Acquires a free slot. Returns a ResourceExhausted error if all the slots
+  // of the executor are in use.
+  absl::StatusOr<std::unique_ptr<Slot>> AcquireSlot();
+
+  // Returns the maximum number of slots, i.e. the maximum number of sessions
+  // that can be served concurrently.
+  int GetMaxNumSlots() const { return executor_.GetMaxNumSlots(); }
+
+  Stats GetStats() const;
+
+ private:
+  // A decode step waiting to be merged into a batch.
+  struct PendingDecode {
+    SlotDecodeRequest request;
+    absl::Status status;
+    bool done = false;
+  };
+
+  struct SlotState {
+    // Whether the slot is in its decode loop, i.e. expected to join the next
+    // batch.
+    bool decoding = false;
+    int current_step = 0;
+    int lora_id = LoraLlmExecutor::kNoLoraAdapter;
+  };
+
+  // Argument of the condition a decode step waits on.
+  struct DecodeWaitArg {
+    ContinuousBatchingScheduler* scheduler;
+    PendingDecode* pending;
+  };
+
+  ContinuousBatchingScheduler(SlotBatchedLlmExecutor* executor,
+                              absl::Duration max_batch_wait,
+                              int prefill_chunk_size)
+      : executor_(*executor),
+        lora_executor_(dynamic_cast<LoraLlmExecutor*>(executor)),
+        max_batch_wait_(max_batch_wait),
+        prefill_chunk_size_(prefill_chunk_size) {}
+
+  absl::Status ReleaseSlot(int slot);
+  absl::Status RunExclusive(int slot, absl::AnyInvocable<absl::Status()> fn);
+  absl::Status DecodeStep(int slot, litert::TensorBuffer& output_tokens,
+                          ConstrainedDecoder* constrained_decoder,
+                          const LogitsProcessor* logits_processor);
+  void EndDecode(int slot);
+  int GetCurrentStep(int slot) const;
+  void SetLoraAdapter(int slot, int lora_id);
+
+  void EndDecodeLocked(int slot) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Issues all the pending decode steps as one batch, split by adapter if the
+  // executor can not mix the LoRA adapters. The mutex is released while the
+  // executor runs.
+  void RunBatchLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  bool ExecutorIdle() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !executor_busy_;
+  }
+  // When both exclusive tasks and decode steps are waiting for the executor,
+  // they take turns so that neither of them can starve the other.
+  bool CanRunExclusive() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !executor_busy_ &&
+           (pending_decodes_.empty() || !last_run_was_exclusive_);
+  }
+  bool CanRunBatch() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !executor_busy_ &&
+           (num_waiting_exclusive_tasks_ == 0 || last_run_was_exclusive_);
+  }
+  bool BatchFullOrCannotRun() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !CanRunBatch() ||
+           static_cast<int>(pending_decodes_.size()) >= num_decoding_slots_;
+  }
+  static bool DecodeDoneOrCanRunBatch(DecodeWaitArg* arg);
+
+  SlotBatchedLlmExecutor& executor_;
+  // The LoRA extension of the executor, null if not implemented.
+  LoraLlmExecutor* const lora_executor_;
+  const absl::Duration max_batch_wait_;
+  const int prefill_chunk_size_;
+
+  mutable absl::Mutex mutex_;
+  // Whether a batch or an exclusive task is running on the executor.
+  bool executor_busy_ ABSL_GUARDED_BY(mutex_) = false;
+  // Whether the last work run on the executor was an exclusive task.
+  bool last_run_was_exclusive_ ABSL_GUARDED_BY(mutex_) = false;
+  int num_waiting_exclusive_tasks_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::flat_hash_map<int, SlotState> slots_ ABSL_GUARDED_BY(mutex_);
+  int num_decoding_slots_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::vector<PendingDecode*> pending_decodes_ ABSL_GUARDED_BY(mutex_);
+  Stats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_CONTINUOUS_BATCHING_SCHEDULER_H_
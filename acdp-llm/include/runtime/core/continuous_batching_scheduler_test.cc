@@ -0,0 +1,442 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/continuous_batching_scheduler.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/notification.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "litert/test/matchers.h"  // from @litert
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/util/convert_tensor_buffer.h"
+#include "runtime/util/lora_data.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::Contains;
+using ::testing::Each;
+using ::testing::ElementsAre;
+using ::testing::Gt;
+using ::testing::Lt;
+using ::testing::UnorderedElementsAre;
+using ::testing::status::StatusIs;
+
+// A fake executor keeping a token counter per slot. Every decode step of a
+// slot writes `slot * 1000 + step` as the sampled token.
+class FakeSlotBatchedExecutor : public SlotBatchedLlmExecutor {
+ public:
+  explicit FakeSlotBatchedExecutor(
+      int max_num_slots, absl::Duration step_latency = absl::ZeroDuration())
+      : step_latency_(step_latency),
+        in_use_(max_num_slots, false),
+        steps_(max_num_slots, 0) {}
+
+  int GetMaxNumSlots() const override { return in_use_.size(); }
+
+  absl::StatusOr<int> AllocateSlot() override {
+    for (int i = 0; i < in_use_.size(); ++i) {
+      if (!in_use_[i]) {
+        in_use_[i] = true;
+        steps_[i] = 0;
+        return i;
+      }
+    }
+    return absl::ResourceExhaustedError("No free slot.");
+  }
+
+  absl::Status ReleaseSlot(int slot) override {
+    in_use_[slot] = false;
+    return absl::OkStatus();
+  }
+
+  absl::Status SelectSlot(int slot) override {
+    selected_slot_ = slot;
+    return absl::OkStatus();
+  }
+
+  absl::Status DecodeSlots(
+      absl::Span<const SlotDecodeRequest> requests) override {
+    EXPECT_EQ(num_calls_in_flight_.fetch_add(1), 0);
+    absl::SleepFor(step_latency_);
+    absl::Status status = decode_status_;
+    for (const auto& request : requests) {
+      ++steps_[request.slot];
+      std::vector<int> token = {request.slot * 1000 + steps_[request.slot]};
+      if (!request.output_tokens->Write<int>(absl::MakeConstSpan(token))) {
+        status = absl::InternalError("Failed to write the output tokens.");
+      }
+    }
+    num_calls_in_flight_.fetch_sub(1);
+    return status;
+  }
+
+  absl::StatusOr<int> GetSlotCurrentStep(int slot) const override {
+    return steps_[slot];
+  }
+
+  // Simulates a prefill of `num_tokens` through the regular LlmExecutor API,
+  // which targets the selected slot.
+  absl::Status Prefill(int num_tokens) {
+    EXPECT_EQ(num_calls_in_flight_.fetch_add(1), 0);
+    absl::SleepFor(step_latency_);
+    steps_[selected_slot_] += num_tokens;
+    num_calls_in_flight_.fetch_sub(1);
+    return absl::OkStatus();
+  }
+
+  void SetDecodeStatus(absl::Status status) {
+    decode_status_ = std::move(status);
+  }
+
+ private:
+  const absl::Duration step_latency_;
+  std::vector<bool> in_use_;
+  std::vector<int> steps_;
+  int selected_slot_ = -1;
+  absl::Status decode_status_;
+  std::atomic<int> num_calls_in_flight_{0};
+};
+
+// A fake executor additionally recording the adapters of every DecodeSlots
+// call.
+class FakeLoraSlotBatchedExecutor : public FakeSlotBatchedExecutor,
+                                    public LoraLlmExecutor {
+ public:
+  FakeLoraSlotBatchedExecutor(int max_num_slots, bool supports_mixed_batches)
+      : FakeSlotBatchedExecutor(max_num_slots,
+                                /*step_latency=*/absl::Milliseconds(10)),
+        supports_mixed_batches_(supports_mixed_batches) {}
+
+  int GetMaxNumLoraAdapters() const override { return 0; }
+
+  absl::StatusOr<size_t> LoadLoraAdapter(int lora_id,
+                                         LoraData& lora) override {
+    return 0;
+  }
+
+  absl::Status UnloadLoraAdapter(int lora_id) override {
+    return absl::OkStatus();
+  }
+
+  absl::Status SelectLoraAdapter(int lora_id) override {
+    selected_lora_id_ = lora_id;
+    return absl::OkStatus();
+  }
+
+  bool SupportsMixedLoraBatches() const override {
+    return supports_mixed_batches_;
+  }
+
+  absl::Status DecodeSlots(
+      absl::Span<const SlotDecodeRequest> requests) override {
+    std::vector<int> lora_ids;
+    for (const auto& request : requests) {
+      if (!supports_mixed_batches_) {
+        EXPECT_EQ(request.lora_id, selected_lora_id_);
+      }
+      lora_ids.push_back(request.lora_id);
+    }
+    decoded_lora_ids_.push_back(std::move(lora_ids));
+    return FakeSlotBatchedExecutor::DecodeSlots(requests);
+  }
+
+  // The adapters of the requests of every DecodeSlots call.
+  const std::vector<std::vector<int>>& decoded_lora_ids() const {
+    return decoded_lora_ids_;
+  }
+
+ private:
+  const bool supports_mixed_batches_;
+  int selected_lora_id_ = kNoLoraAdapter;
+  std::vector<std::vector<int>> decoded_lora_ids_;
+};
+
+// Runs `num_steps` decode steps concurrently on every slot.
+void DecodeOnAllSlots(
+    std::vector<std::unique_ptr<ContinuousBatchingScheduler::Slot>>& slots,
+    int num_steps) {
+  std::vector<std::thread> threads;
+  for (auto& slot : slots) {
+    threads.emplace_back([&slot, num_steps]() {
+      auto output_tokens = CreateTensorBuffer<int>({1, 1});
+      ASSERT_TRUE(output_tokens);
+      for (int step = 0; step < num_steps; ++step) {
+        ASSERT_OK(slot->DecodeStep(*output_tokens,
+                                   /*constrained_decoder=*/nullptr));
+      }
+      slot->EndDecode();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(ContinuousBatchingSchedulerTest, CreateFailsWithoutSlots) {
+  FakeSlotBatchedExecutor executor(/*max_num_slots=*/0);
+  EXPECT_THAT(ContinuousBatchingScheduler::Create(&executor),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ContinuousBatchingSchedulerTest, CreateFailsWithNegativePrefillChunkSize) {
+  FakeSlotBatchedExecutor executor(/*max_num_slots=*/2);
+  EXPECT_THAT(ContinuousBatchingScheduler::Create(
+                  &executor, ContinuousBatchingScheduler::kDefaultMaxBatchWait,
+                  /*prefill_chunk_size=*/-1),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ContinuousBatchingSchedulerTest, SlotReturnsThePrefillChunkSize) {
+  FakeSlotBatchedExecutor executor(/*max_num_slots=*/2);
+  ASSERT_OK_AND_ASSIGN(
+      auto scheduler,
+      ContinuousBatchingScheduler::Create(
+          &executor, ContinuousBatchingScheduler::kDefaultMaxBatchWait,
+          /*prefill_chunk_size=*/128));
+  ASSERT_OK_AND_ASSIGN(auto slot, scheduler->AcquireSlot());
+  EXPECT_EQ(slot->GetPrefillChunkSize(), 128);
+}
+
+TEST(ContinuousBatchingSchedulerTest, AcquireSlotFailsWhenAllSlotsAreInUse) {
+  FakeSlotBatchedExecutor executor(/*max_num_slots=*/2);
+  ASSERT_OK_AND_ASSIGN(auto scheduler,
+                       ContinuousBatchingScheduler::Create(&executor));
+  EXPECT_EQ(scheduler->GetMaxNumSlots(), 2);
+
+  ASSERT_OK_AND_ASSIGN(auto slot_0, scheduler->AcquireSlot());
+  ASSERT_OK_AND_ASSIGN(auto slot_1, scheduler->AcquireSlot());
+  EXPECT_NE(slot_0->id(), slot_1->id());
+  EXPECT_THAT(scheduler->AcquireSlot(),
+              StatusIs(absl::StatusCode::kResourceExhausted));
+
+  // Releasing a slot makes it available again.
+  slot_0.reset();
+  EXPECT_OK(scheduler->AcquireSlot());
+}
+
+TEST(ContinuousBatchingSchedulerTest, RunExclusiveTargetsTheSlot) {
+  FakeSlotBatchedExecutor executor(/*max_num_slots=*/2);
+  ASSERT_OK_AND_ASSIGN(auto scheduler,
+                       ContinuousBatchingScheduler::Create(&executor));
+  ASSERT_OK_AND_ASSIGN(auto slot_0, scheduler->AcquireSlot());
+  ASSERT_OK_AND_ASSIGN(auto slot_1, scheduler->AcquireSlot());
+
+  EXPECT_OK(slot_1->RunExclusive([&]() { return executor.Prefill(5); }));
+  EXPECT_EQ(slot_0->GetCurrentStep(), 0);
+  EXPECT_EQ(slot_1->GetCurrentStep(), 5);
+}
+
+TEST(ContinuousBatchingSchedulerTest, RunExclusivePropagatesError) {
+  FakeSlotBatchedExecutor executor(/*max_num_slots=*/1);
+  ASSERT_OK_AND_ASSIGN(auto scheduler,
+                       ContinuousBatchingScheduler::Create(&executor));
+  ASSERT_OK_AND_ASSIGN(auto slot, scheduler->AcquireSlot());
+
+  EXPECT_THAT(slot->RunExclusive([]() { return absl::AbortedError("test"); }),
+              StatusIs(absl::StatusCode::kAborted));
+}
+
+TEST(ContinuousBatchingSchedulerTest, DecodeStepWritesOutputTokens) {
+  FakeSlotBatchedExecutor executor(/*max_num_slots=*/1);
+  ASSERT_OK_AND_ASSIGN(auto scheduler,
+                       ContinuousBatchingScheduler::Create(&executor));
+  ASSERT_OK_AND_ASSIGN(auto slot, scheduler->AcquireSlot());
+  LITERT_ASSERT_OK_AND_ASSIGN(auto output_tokens,
+                              CreateTensorBuffer<int>({1, 1}));
+
+  EXPECT_OK(slot->RunExclusive([&]() { return executor.Prefill(3); }));
+  EXPECT_OK(slot->DecodeStep(output_tokens, /*constrained_decoder=*/nullptr));
+  slot->EndDecode();
+
+  EXPECT_THAT(*CopyFromTensorBuffer<int>(output_tokens), ElementsAre(4));
+  EXPECT_EQ(slot->GetCurrentStep(), 4);
+  const auto stats = scheduler->GetStats();
+  EXPECT_EQ(stats.num_decode_batches, 1);
+  EXPECT_EQ(stats.num_batched_decode_steps, 1);
+  EXPECT_EQ(stats.max_batch_size, 1);
+}
+
+TEST(ContinuousBatchingSchedulerTest, DecodeStepPropagatesError) {
+  FakeSlotBatchedExecutor executor(/*max_num_slots=*/1);
+  executor.SetDecodeStatus(absl::InternalError("decode failed"));
+  ASSERT_OK_AND_ASSIGN(auto scheduler,
+                       ContinuousBatchingScheduler::Create(&executor));
+  ASSERT_OK_AND_ASSIGN(auto slot, scheduler->AcquireSlot());
+  LITERT_ASSERT_OK_AND_ASSIGN(auto output_tokens,
+                              CreateTensorBuffer<int>({1, 1}));
+
+  EXPECT_THAT(
+      slot->DecodeStep(output_tokens, /*constrained_decoder=*/nullptr),
+      StatusIs(absl::StatusCode::kInternal));
+}
+
+TEST(ContinuousBatchingSchedulerTest, ConcurrentDecodeStepsAreBatched) {
+  constexpr int kNumSlots = 4;
+  constexpr int kNumSteps = 8;
+  FakeSlotBatchedExecutor executor(kNumSlots,
+                                   /*step_latency=*/absl::Milliseconds(10));
+  ASSERT_OK_AND_ASSIGN(
+      auto scheduler,
+      ContinuousBatchingScheduler::Create(
+          &executor, /*max_batch_wait=*/absl::Seconds(5)));
+
+  std::vector<std::unique_ptr<ContinuousBatchingScheduler::Slot>> slots;
+  for (int i = 0; i < kNumSlots; ++i) {
+    ASSERT_OK_AND_ASSIGN(auto slot, scheduler->AcquireSlot());
+    slots.push_back(std::move(slot));
+  }
+
+  std::vector<std::vector<int>> decoded_tokens(kNumSlots);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumSlots; ++i) {
+    threads.emplace_back([&, i]() {
+      auto output_tokens = CreateTensorBuffer<int>({1, 1});
+      ASSERT_TRUE(output_tokens);
+      for (int step = 0; step < kNumSteps; ++step) {
+        ASSERT_OK(slots[i]->DecodeStep(*output_tokens,
+                                       /*constrained_decoder=*/nullptr));
+        decoded_tokens[i].push_back(
+            CopyFromTensorBuffer<int>(*output_tokens)->at(0));
+      }
+      slots[i]->EndDecode();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < kNumSlots; ++i) {
+    const int token_base = slots[i]->id() * 1000;
+    std::vector<int> expected_tokens;
+    for (int step = 1; step <= kNumSteps; ++step) {
+      expected_tokens.push_back(token_base + step);
+    }
+    EXPECT_EQ(decoded_tokens[i], expected_tokens);
+    EXPECT_EQ(slots[i]->GetCurrentStep(), kNumSteps);
+  }
+  const auto stats = scheduler->GetStats();
+  EXPECT_EQ(stats.num_batched_decode_steps, kNumSlots * kNumSteps);
+  EXPECT_THAT(stats.num_decode_batches, Lt(kNumSlots * kNumSteps));
+  EXPECT_THAT(stats.max_batch_size, Gt(1));
+}
+
+TEST(ContinuousBatchingSchedulerTest, ExclusiveWorkIsAdmittedBetweenSteps) {
+  constexpr int kNumSteps = 20;
+  FakeSlotBatchedExecutor executor(/*max_num_slots=*/2,
+                                   /*step_latency=*/absl::Milliseconds(5));
+  ASSERT_OK_AND_ASSIGN(auto scheduler,
+                       ContinuousBatchingScheduler::Create(&executor));
+  ASSERT_OK_AND_ASSIGN(auto decoding_slot, scheduler->AcquireSlot());
+  ASSERT_OK_AND_ASSIGN(auto prefilling_slot, scheduler->AcquireSlot());
+
+  std::atomic<int> num_decoded_steps = 0;
+  absl::Notification first_step_done;
+  std::thread decode_thread([&]() {
+    auto output_tokens = CreateTensorBuffer<int>({1, 1});
+    ASSERT_TRUE(output_tokens);
+    for (int step = 0; step < kNumSteps; ++step) {
+      ASSERT_OK(decoding_slot->DecodeStep(*output_tokens,
+                                          /*constrained_decoder=*/nullptr));
+      num_decoded_steps.fetch_add(1);
+      if (step == 0) {
+        first_step_done.Notify();
+      }
+    }
+    decoding_slot->EndDecode();
+  });
+
+  first_step_done.WaitForNotification();
+  EXPECT_OK(
+      prefilling_slot->RunExclusive([&]() { return executor.Prefill(7); }));
+  // The prefill does not wait for the running generation to finish.
+  EXPECT_THAT(num_decoded_steps.load(), Lt(kNumSteps));
+  decode_thread.join();
+
+  EXPECT_EQ(prefilling_slot->GetCurrentStep(), 7);
+  EXPECT_EQ(decoding_slot->GetCurrentStep(), kNumSteps);
+}
+
+TEST(ContinuousBatchingSchedulerTest, BatchesAreSplitByLoraAdapter) {
+  constexpr int kNumSteps = 4;
+  FakeLoraSlotBatchedExecutor executor(/*max_num_slots=*/3,
+                                       /*supports_mixed_batches=*/false);
+  ASSERT_OK_AND_ASSIGN(
+      auto scheduler,
+      ContinuousBatchingScheduler::Create(
+          &executor, /*max_batch_wait=*/absl::Seconds(5)));
+  std::vector<std::unique_ptr<ContinuousBatchingScheduler::Slot>> slots;
+  for (int lora_id : {0, LoraLlmExecutor::kNoLoraAdapter, 0}) {
+    ASSERT_OK_AND_ASSIGN(auto slot, scheduler->AcquireSlot());
+    slot->SetLoraAdapter(lora_id);
+    slots.push_back(std::move(slot));
+  }
+
+  DecodeOnAllSlots(slots, kNumSteps);
+
+  // Every call decodes a single adapter, selected by the scheduler.
+  for (const auto& lora_ids : executor.decoded_lora_ids()) {
+    EXPECT_THAT(lora_ids, Each(lora_ids[0]));
+  }
+  const auto stats = scheduler->GetStats();
+  EXPECT_EQ(stats.num_batched_decode_steps, 3 * kNumSteps);
+  EXPECT_THAT(stats.num_lora_split_batches, Gt(0));
+  EXPECT_THAT(stats.max_batch_size, Gt(2));
+  for (const auto& slot : slots) {
+    EXPECT_EQ(slot->GetCurrentStep(), kNumSteps);
+  }
+}
+
+TEST(ContinuousBatchingSchedulerTest, MixedLoraBatchesAreNotSplit) {
+  constexpr int kNumSteps = 4;
+  FakeLoraSlotBatchedExecutor executor(/*max_num_slots=*/3,
+                                       /*supports_mixed_batches=*/true);
+  ASSERT_OK_AND_ASSIGN(
+      auto scheduler,
+      ContinuousBatchingScheduler::Create(
+          &executor, /*max_batch_wait=*/absl::Seconds(5)));
+  std::vector<std::unique_ptr<ContinuousBatchingScheduler::Slot>> slots;
+  for (int lora_id : {0, LoraLlmExecutor::kNoLoraAdapter, 1}) {
+    ASSERT_OK_AND_ASSIGN(auto slot, scheduler->AcquireSlot());
+    slot->SetLoraAdapter(lora_id);
+    slots.push_back(std::move(slot));
+  }
+
+  DecodeOnAllSlots(slots, kNumSteps);
+
+  // Once all the slots are decoding, their adapters share the calls.
+  EXPECT_THAT(executor.decoded_lora_ids(),
+              Contains(UnorderedElementsAre(
+                  0, LoraLlmExecutor::kNoLoraAdapter, 1)));
+  const auto stats = scheduler->GetStats();
+  EXPECT_EQ(stats.num_batched_decode_steps, 3 * kNumSteps);
+  EXPECT_EQ(stats.num_lora_split_batches, 0);
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,122 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/decode_replay_recorder.h"
+
+#include <cstdint>
+#include <fstream>
+#include <ios>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/engine/engine_settings.h"
+#include "runtime/proto/decode_replay.pb.h"
+#include "runtime/util/model_cache.h"
+
+namespace litert::lm {
+
+// static
+absl::StatusOr<std::unique_ptr<DecodeReplayRecorder>>
+DecodeReplayRecorder::Create(absl::string_view path,
+                             const SessionConfig& session_config) {
+  if (path.empty()) {
+    return absl::InvalidArgumentError("The replay file path is empty.");
+  }
+  proto::DecodeReplay recording;
+  *recording.mutable_sampler_params() = session_config.GetSamplerParams();
+  recording.set_num_output_candidates(session_config.GetNumOutputCandidates());
+  recording.set_use_beam_search(session_config.GetUseBeamSearch());
+  return absl::WrapUnique(
+      new DecodeReplayRecorder(std::string(path), std::move(recording)));
+}
+
+// static
+absl::StatusOr<proto::DecodeReplay> DecodeReplayRecorder::Load(
+    absl::string_view path) {
+  std::ifstream file{std::string(path), std::ios::binary};
+  if (!file.is_open()) {
+    return absl::NotFoundError(
+        absl::StrCat("The replay file ", path, " does not exist."));
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  proto::DecodeReplay recording;
+  if (!recording.ParseFromString(contents.str())) {
+    return absl::DataLossError(
+        absl::StrCat("The replay file ", path, " is invalid."));
+  }
+  return recording;
+}
+
+void DecodeReplayRecorder::StartTurn() {
+  absl::MutexLock lock(&mutex_);
+  turn_start_time_ = absl::Now();
+  response_times_us_.clear();
+}
+
+void DecodeReplayRecorder::RecordResponse() {
+  absl::MutexLock lock(&mutex_);
+  response_times_us_.push_back(
+      absl::ToInt64Microseconds(absl::Now() - turn_start_time_));
+}
+
+absl::Status DecodeReplayRecorder::EndPrefill(absl::Span<const int> token_ids,
+                                              bool has_multimodal_inputs) {
+  proto::SessionTurn turn;
+  turn.mutable_prefill()->mutable_token_ids()->Add(token_ids.begin(),
+                                                   token_ids.end());
+  turn.mutable_prefill()->set_has_multimodal_inputs(has_multimodal_inputs);
+  absl::MutexLock lock(&mutex_);
+  return EndTurn(std::move(turn));
+}
+
+absl::Status DecodeReplayRecorder::EndDecode(int num_steps,
+                                             bool has_constraint) {
+  proto::SessionTurn turn;
+  turn.mutable_decode()->set_num_steps(num_steps);
+  turn.mutable_decode()->set_has_constraint(has_constraint);
+  absl::MutexLock lock(&mutex_);
+  turn.mutable_decode()->mutable_response_times_us()->Add(
+      response_times_us_.begin(), response_times_us_.end());
+  response_times_us_.clear();
+  return EndTurn(std::move(turn));
+}
+
+proto::DecodeReplay DecodeReplayRecorder::GetRecording() const {
+  absl::MutexLock lock(&mutex_);
+  return recording_;
+}
+
+absl::Status DecodeReplayRecorder::EndTurn(proto::SessionTurn turn) {
+  const absl::Time now = absl::Now();
+  turn.set_start_time_us(
+      absl::ToInt64Microseconds(turn_start_time_ - start_time_));
+  turn.set_duration_us(absl::ToInt64Microseconds(now - turn_start_time_));
+  *recording_.add_turns() = std::move(turn);
+  // Rewritten whole, so that the file is complete whenever the process ends.
+  return WriteFileAtomically(path_, recording_.SerializeAsString());
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,97 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_DECODE_REPLAY_RECORDER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_DECODE_REPLAY_RECORDER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/engine/engine_settings.h"
+#include "runtime/proto/decode_replay.pb.h"
+
+namespace litert::lm {
+
+// Records the workload of a session: the token ids it prefilled, its sampler
+// parameters and seed, whether its decodes were constrained, and the timings
+// of its turns and streamed responses. The recording is rewritten to its file
+// after every turn, in the binary proto format, so that a slow production
+// request can be replayed offline against the same model, see
+// ReplayDecodeRecording().
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(auto recorder,
+//                    DecodeReplayRecorder::Create(path, session_config));
+//   recorder->StartTurn();
+//   ... prefill ...
+//   RETURN_IF_ERROR(recorder->EndPrefill(
+//       token_ids, /*has_multimodal_inputs=*/false));
+//
+// The class is thread-safe.
+class DecodeReplayRecorder {
+ public:
+  // Creates a recorder writing to `path` the workload of a session created
+  // with `session_config`.
+  static absl::StatusOr<std::unique_ptr<DecodeReplayRecorder>> Create(
+      absl::string_view path, const SessionConfig& session_config);
+
+  // Reads a recording written by a recorder.
+  static absl::StatusOr<proto::DecodeReplay> Load(absl::string_view path);
+
+  // Marks the start of a prefill or decode turn.
+  void StartTurn();
+
+  // Records a response streamed by the current decode turn.
+  void RecordResponse();
+
+  // Ends the current turn, a prefill of `token_ids` or a decode of
+  // `num_steps` steps, and writes the recording.
+  absl::Status EndPrefill(absl::Span<const int> token_ids,
+                          bool has_multimodal_inputs);
+  absl::Status EndDecode(int num_steps, bool has_constraint);
+
+  // Returns the recording so far.
+  proto::DecodeReplay GetRecording() const;
+
+ private:
+  DecodeReplayRecorder(std::string path, proto::DecodeReplay recording)
+      : path_(std::move(path)),
+        start_time_(absl::Now()),
+        recording_(std::move(recording)) {}
+
+  // Adds the current turn, ending now, and writes the recording.
+  absl::Status EndTurn(proto::SessionTurn turn)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const std::string path_;
+  const absl::Time start_time_;
+  mutable absl::Mutex mutex_;
+  proto::DecodeReplay recording_ ABSL_GUARDED_BY(mutex_);
+  absl::Time turn_start_time_ ABSL_GUARDED_BY(mutex_);
+  std::vector<int64_t> response_times_us_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_DECODE_REPLAY_RECORDER_H_
@@ -0,0 +1,86 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/decode_replay_recorder.h"
+
+#include <filesystem>  // NOLINT
+#include <fstream>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "runtime/engine/engine_settings.h"
+#include "runtime/proto/decode_replay.pb.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::status::StatusIs;
+
+TEST(DecodeReplayRecorderTest, RecordsTheTurnsOfTheSession) {
+  auto path = std::filesystem::path(::testing::TempDir()) / "session.replay";
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.GetMutableSamplerParams().set_type(
+      proto::SamplerParameters::TOP_K);
+  session_config.GetMutableSamplerParams().set_k(40);
+  session_config.GetMutableSamplerParams().set_seed(7);
+  ASSERT_OK_AND_ASSIGN(auto recorder, DecodeReplayRecorder::Create(
+                                          path.string(), session_config));
+
+  recorder->StartTurn();
+  ASSERT_OK(recorder->EndPrefill(std::vector<int>{2, 10, 11},
+                                 /*has_multimodal_inputs=*/false));
+  recorder->StartTurn();
+  recorder->RecordResponse();
+  recorder->RecordResponse();
+  ASSERT_OK(recorder->EndDecode(/*num_steps=*/2, /*has_constraint=*/true));
+
+  // The file is complete after every turn.
+  ASSERT_OK_AND_ASSIGN(proto::DecodeReplay recording,
+                       DecodeReplayRecorder::Load(path.string()));
+  EXPECT_EQ(recording.sampler_params().k(), 40);
+  EXPECT_EQ(recording.sampler_params().seed(), 7);
+  EXPECT_EQ(recording.num_output_candidates(), 1);
+  ASSERT_EQ(recording.turns_size(), 2);
+  EXPECT_THAT(recording.turns(0).prefill().token_ids(), ElementsAre(2, 10, 11));
+  EXPECT_FALSE(recording.turns(0).prefill().has_multimodal_inputs());
+  EXPECT_EQ(recording.turns(1).decode().num_steps(), 2);
+  EXPECT_TRUE(recording.turns(1).decode().has_constraint());
+  ASSERT_EQ(recording.turns(1).decode().response_times_us_size(), 2);
+  EXPECT_LE(recording.turns(1).decode().response_times_us(0),
+            recording.turns(1).decode().response_times_us(1));
+  EXPECT_LE(recording.turns(0).start_time_us(),
+            recording.turns(1).start_time_us());
+}
+
+TEST(DecodeReplayRecorderTest, CreateFailsWithoutPath) {
+  EXPECT_THAT(
+      DecodeReplayRecorder::Create("", SessionConfig::CreateDefault()),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(DecodeReplayRecorderTest, LoadFailsWithAnInvalidFile) {
+  auto path = std::filesystem::path(::testing::TempDir()) / "invalid.replay";
+  EXPECT_THAT(DecodeReplayRecorder::Load(path.string()),
+              StatusIs(absl::StatusCode::kNotFound));
+  std::ofstream(path) << "not a recording";
+  EXPECT_THAT(DecodeReplayRecorder::Load(path.string()),
+              StatusIs(absl::StatusCode::kDataLoss));
+}
+
+}  // namespace
+}  // namespace litert::lm
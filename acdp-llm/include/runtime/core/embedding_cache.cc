@@ -0,0 +1,229 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/embedding_cache.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "absl/hash/hash.h"  // from @com_google_absl
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "litert/c/litert_tensor_buffer_types.h"  // from @litert
+#include "litert/cc/litert_macros.h"  // from @litert
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/executor/llm_executor_io_types.h"
+#include "runtime/util/status_macros.h"  // IWYU pragma: keep
+#include "runtime/util/tensor_buffer_util.h"
+
+namespace litert::lm {
+namespace {
+
+// Copies `tensor` to a new host memory tensor buffer, so that the cached
+// embeddings do not pin the buffers of the encoder.
+absl::StatusOr<TensorBuffer> CopyToHostMemory(const TensorBuffer& tensor) {
+  LITERT_ASSIGN_OR_RETURN(auto tensor_type, tensor.TensorType());
+  LITERT_ASSIGN_OR_RETURN(size_t packed_size, tensor.PackedSize());
+  LITERT_ASSIGN_OR_RETURN(
+      auto copy, TensorBuffer::CreateManaged(kLiteRtTensorBufferTypeHostMemory,
+                                             tensor_type, packed_size));
+  LITERT_ASSIGN_OR_RETURN(auto copy_lock_and_addr,
+                          ::litert::TensorBufferScopedLock::Create(
+                              copy, TensorBuffer::LockMode::kWrite));
+  // Locking for reading does not modify the tensor buffer.
+  LITERT_ASSIGN_OR_RETURN(auto tensor_lock_and_addr,
+                          ::litert::TensorBufferScopedLock::Create(
+                              const_cast<TensorBuffer&>(tensor),
+                              TensorBuffer::LockMode::kRead));
+  memcpy(copy_lock_and_addr.second, tensor_lock_and_addr.second, packed_size);
+  return copy;
+}
+
+absl::StatusOr<size_t> GetPackedSize(const TensorBuffer& tensor) {
+  LITERT_ASSIGN_OR_RETURN(size_t packed_size, tensor.PackedSize());
+  return packed_size;
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<EmbeddingCache>> EmbeddingCache::Create(
+    size_t max_size_bytes) {
+  if (max_size_bytes == 0) {
+    return absl::InvalidArgumentError(
+        "The embedding cache size must be positive.");
+  }
+  return absl::WrapUnique(new EmbeddingCache(max_size_bytes));
+}
+
+absl::StatusOr<EmbeddingCache::Key> EmbeddingCache::ComputeKey(
+    const TensorBuffer& input) {
+  LITERT_ASSIGN_OR_RETURN(size_t packed_size, input.PackedSize());
+  LITERT_ASSIGN_OR_RETURN(auto lock_and_addr,
+                          ::litert::TensorBufferScopedLock::Create(
+                              const_cast<TensorBuffer&>(input),
+                              TensorBuffer::LockMode::kRead));
+  const absl::string_view bytes(static_cast<const char*>(lock_and_addr.second),
+                                packed_size);
+  // The dimensions tell apart the inputs of the same bytes, e.g. the same
+  // pixels in another shape.
+  const auto dims = TensorBufferDims(input);
+  Key key;
+  key.hash = absl::HashOf(bytes, dims);
+  key.fingerprint = std::hash<std::string_view>()(
+      std::string_view(bytes.data(), bytes.size()));
+  key.size_in_bytes = packed_size;
+  return key;
+}
+
+absl::StatusOr<std::optional<ExecutorVisionData>> EmbeddingCache::LookupVision(
+    const Key& key) {
+  absl::MutexLock lock(&mutex_);
+  const Entry* entry = FindEntry(key, /*is_audio=*/false);
+  if (entry == nullptr) {
+    return std::nullopt;
+  }
+  LITERT_ASSIGN_OR_RETURN(auto embeddings, entry->embeddings.Duplicate());
+  std::optional<TensorBuffer> per_layer_embeddings;
+  if (entry->per_layer_embeddings.has_value()) {
+    LITERT_ASSIGN_OR_RETURN(per_layer_embeddings,
+                            entry->per_layer_embeddings->Duplicate());
+  }
+  return ExecutorVisionData(std::move(embeddings),
+                            std::move(per_layer_embeddings));
+}
+
+absl::StatusOr<std::optional<ExecutorAudioData>> EmbeddingCache::LookupAudio(
+    const Key& key) {
+  absl::MutexLock lock(&mutex_);
+  const Entry* entry = FindEntry(key, /*is_audio=*/true);
+  if (entry == nullptr) {
+    return std::nullopt;
+  }
+  LITERT_ASSIGN_OR_RETURN(auto embeddings, entry->embeddings.Duplicate());
+  std::optional<TensorBuffer> per_layer_embeddings;
+  if (entry->per_layer_embeddings.has_value()) {
+    LITERT_ASSIGN_OR_RETURN(per_layer_embeddings,
+                            entry->per_layer_embeddings->Duplicate());
+  }
+  return ExecutorAudioData(std::move(embeddings),
+                           std::move(per_layer_embeddings),
+                           entry->num_valid_tokens);
+}
+
+absl::Status EmbeddingCache::InsertVision(const Key& key,
+                                          const ExecutorVisionData& data) {
+  Entry entry;
+  entry.key = key;
+  ASSIGN_OR_RETURN(const auto* embeddings, data.GetEmbeddingsPtr());
+  ASSIGN_OR_RETURN(entry.embeddings, CopyToHostMemory(*embeddings));
+  if (auto per_layer_embeddings = data.GetPerLayerEmbeddingsPtr();
+      per_layer_embeddings.ok()) {
+    ASSIGN_OR_RETURN(entry.per_layer_embeddings,
+                     CopyToHostMemory(**per_layer_embeddings));
+  }
+  return Insert(std::move(entry));
+}
+
+absl::Status EmbeddingCache::InsertAudio(const Key& key,
+                                         const ExecutorAudioData& data) {
+  Entry entry;
+  entry.key = key;
+  entry.is_audio = true;
+  entry.num_valid_tokens = data.GetValidTokens();
+  ASSIGN_OR_RETURN(const auto* embeddings, data.GetEmbeddingsPtr());
+  ASSIGN_OR_RETURN(entry.embeddings, CopyToHostMemory(*embeddings));
+  if (auto per_layer_embeddings = data.GetPerLayerEmbeddingsPtr();
+      per_layer_embeddings.ok()) {
+    ASSIGN_OR_RETURN(entry.per_layer_embeddings,
+                     CopyToHostMemory(**per_layer_embeddings));
+  }
+  return Insert(std::move(entry));
+}
+
+int EmbeddingCache::GetNumEntries() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+size_t EmbeddingCache::GetSizeInBytes() const {
+  absl::MutexLock lock(&mutex_);
+  return size_in_bytes_;
+}
+
+int64_t EmbeddingCache::GetNumHits() const {
+  absl::MutexLock lock(&mutex_);
+  return num_hits_;
+}
+
+int64_t EmbeddingCache::GetNumMisses() const {
+  absl::MutexLock lock(&mutex_);
+  return num_misses_;
+}
+
+size_t EmbeddingCache::Clear() {
+  absl::MutexLock lock(&mutex_);
+  index_.clear();
+  entries_.clear();
+  return std::exchange(size_in_bytes_, 0);
+}
+
+const EmbeddingCache::Entry* EmbeddingCache::FindEntry(const Key& key,
+                                                       bool is_audio) {
+  auto it = index_.find(key);
+  if (it == index_.end() || it->second->is_audio != is_audio) {
+    ++num_misses_;
+    return nullptr;
+  }
+  ++num_hits_;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return &entries_.front();
+}
+
+absl::Status EmbeddingCache::Insert(Entry entry) {
+  ASSIGN_OR_RETURN(entry.size_in_bytes, GetPackedSize(entry.embeddings));
+  if (entry.per_layer_embeddings.has_value()) {
+    ASSIGN_OR_RETURN(size_t per_layer_size,
+                     GetPackedSize(*entry.per_layer_embeddings));
+    entry.size_in_bytes += per_layer_size;
+  }
+  if (entry.size_in_bytes > max_size_bytes_) {
+    return absl::OkStatus();
+  }
+  absl::MutexLock lock(&mutex_);
+  if (auto it = index_.find(entry.key); it != index_.end()) {
+    size_in_bytes_ -= it->second->size_in_bytes;
+    entries_.erase(it->second);
+    index_.erase(it);
+  }
+  while (size_in_bytes_ + entry.size_in_bytes > max_size_bytes_) {
+    size_in_bytes_ -= entries_.back().size_in_bytes;
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+  }
+  size_in_bytes_ += entry.size_in_bytes;
+  entries_.push_front(std::move(entry));
+  index_[entries_.front().key] = entries_.begin();
+  return absl::OkStatus();
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,150 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_EMBEDDING_CACHE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_EMBEDDING_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/executor/llm_executor_io_types.h"
+
+namespace litert::lm {
+
+// An engine-wide cache of the embeddings computed by the vision and audio
+// encoders, keyed by the content of the preprocessed image and audio tensors.
+// An image or audio clip sent again, e.g. the same screenshot re-sent across
+// the turns of an agent, or the same document in several conversations, is
+// encoded once.
+//
+// The cached embeddings are copied to the host memory when inserted, and
+// shared with the returned data on a hit, which must not be written. The
+// least recently used entries are evicted to stay within the memory budget.
+//
+// The class is thread-safe.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(auto key, EmbeddingCache::ComputeKey(image_tensor));
+//   ASSIGN_OR_RETURN(auto vision_data, cache->LookupVision(key));
+//   if (!vision_data.has_value()) {
+//     ASSIGN_OR_RETURN(vision_data, vision_executor->Encode(image_tensor));
+//     RETURN_IF_ERROR(cache->InsertVision(key, *vision_data));
+//   }
+class EmbeddingCache {
+ public:
+  // The content of an encoder input.
+  struct Key {
+    // Two independent hashes of the content, which make a collision
+    // negligible without keeping the inputs.
+    uint64_t hash = 0;
+    uint64_t fingerprint = 0;
+    size_t size_in_bytes = 0;
+
+    bool operator==(const Key& other) const {
+      return hash == other.hash && fingerprint == other.fingerprint &&
+             size_in_bytes == other.size_in_bytes;
+    }
+
+    template <typename H>
+    friend H AbslHashValue(H h, const Key& key) {
+      return H::combine(std::move(h), key.hash, key.fingerprint,
+                        key.size_in_bytes);
+    }
+  };
+
+  // Creates a cache holding embeddings of up to `max_size_bytes` in total.
+  static absl::StatusOr<std::unique_ptr<EmbeddingCache>> Create(
+      size_t max_size_bytes);
+
+  // Returns the key of the preprocessed image or audio `input`.
+  static absl::StatusOr<Key> ComputeKey(const TensorBuffer& input);
+
+  // Returns the embeddings cached for the image of `key`, or std::nullopt.
+  absl::StatusOr<std::optional<ExecutorVisionData>> LookupVision(
+      const Key& key);
+
+  // Caches the embeddings of the image of `key`. Embeddings larger than the
+  // memory budget are dropped.
+  absl::Status InsertVision(const Key& key, const ExecutorVisionData& data);
+
+  // Returns the embeddings cached for the audio of `key`, or std::nullopt.
+  absl::StatusOr<std::optional<ExecutorAudioData>> LookupAudio(
+      const Key& key);
+
+  // Caches the embeddings of the audio of `key`. Embeddings larger than the
+  // memory budget are dropped.
+  absl::Status InsertAudio(const Key& key, const ExecutorAudioData& data);
+
+  // Returns the number of cached embeddings.
+  int GetNumEntries() const;
+
+  // Returns the memory used by the cached embeddings.
+  size_t GetSizeInBytes() const;
+
+  // Returns the numbers of lookups which found and did not find embeddings
+  // since the cache was created.
+  int64_t GetNumHits() const;
+  int64_t GetNumMisses() const;
+
+  // Drops all the embeddings, e.g. under memory pressure, and returns the
+  // memory they used.
+  size_t Clear();
+
+ private:
+  struct Entry {
+    Key key;
+    // Whether the entry holds the embeddings of an audio, whose key space is
+    // separate from the images, if only for the valid tokens.
+    bool is_audio = false;
+    TensorBuffer embeddings;
+    std::optional<TensorBuffer> per_layer_embeddings;
+    int num_valid_tokens = 0;
+    size_t size_in_bytes = 0;
+  };
+
+  explicit EmbeddingCache(size_t max_size_bytes)
+      : max_size_bytes_(max_size_bytes) {}
+
+  // Moves the entry of `key` to the front and returns it, nullptr if absent.
+  // Counts the lookup as a hit or a miss.
+  const Entry* FindEntry(const Key& key, bool is_audio)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  absl::Status Insert(Entry entry);
+
+  const size_t max_size_bytes_;
+
+  mutable absl::Mutex mutex_;
+  // The entries, most recently used first.
+  std::list<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<Key, std::list<Entry>::iterator> index_
+      ABSL_GUARDED_BY(mutex_);
+  size_t size_in_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t num_hits_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t num_misses_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_EMBEDDING_CACHE_H_
@@ -0,0 +1,136 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/embedding_cache.h"
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/executor/llm_executor_io_types.h"
+#include "runtime/util/convert_tensor_buffer.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::status::StatusIs;
+
+TensorBuffer CreateTensor(std::vector<float> data,
+                          ::litert::Dimensions dims) {
+  auto tensor = CopyToTensorBuffer<float>(absl::MakeConstSpan(data),
+                                          std::move(dims));
+  EXPECT_TRUE(tensor.HasValue());
+  return std::move(*tensor);
+}
+
+TEST(EmbeddingCacheTest, CreateFailsWithoutMemory) {
+  EXPECT_THAT(EmbeddingCache::Create(/*max_size_bytes=*/0),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(EmbeddingCacheTest, KeysFollowTheContent) {
+  ASSERT_OK_AND_ASSIGN(
+      auto key1, EmbeddingCache::ComputeKey(CreateTensor({1, 2, 3, 4}, {4})));
+  ASSERT_OK_AND_ASSIGN(
+      auto key2, EmbeddingCache::ComputeKey(CreateTensor({1, 2, 3, 4}, {4})));
+  ASSERT_OK_AND_ASSIGN(
+      auto key3, EmbeddingCache::ComputeKey(CreateTensor({1, 2, 3, 5}, {4})));
+  ASSERT_OK_AND_ASSIGN(
+      auto key4,
+      EmbeddingCache::ComputeKey(CreateTensor({1, 2, 3, 4}, {2, 2})));
+  EXPECT_EQ(key1, key2);
+  EXPECT_FALSE(key1 == key3);
+  EXPECT_FALSE(key1 == key4);
+}
+
+TEST(EmbeddingCacheTest, LookupReturnsTheInsertedEmbeddings) {
+  ASSERT_OK_AND_ASSIGN(auto cache,
+                       EmbeddingCache::Create(/*max_size_bytes=*/1024));
+  ASSERT_OK_AND_ASSIGN(
+      auto image_key,
+      EmbeddingCache::ComputeKey(CreateTensor({1, 2, 3, 4}, {4})));
+  ASSERT_OK_AND_ASSIGN(auto vision_data, cache->LookupVision(image_key));
+  EXPECT_FALSE(vision_data.has_value());
+
+  ASSERT_OK(cache->InsertVision(
+      image_key, ExecutorVisionData(CreateTensor({5, 6}, {1, 1, 1, 2}),
+                                    /*per_layer_embeddings=*/std::nullopt)));
+  ASSERT_OK_AND_ASSIGN(vision_data, cache->LookupVision(image_key));
+  ASSERT_TRUE(vision_data.has_value());
+  ASSERT_OK_AND_ASSIGN(const auto* embeddings,
+                       vision_data->GetEmbeddingsPtr());
+  auto values = CopyFromTensorBuffer<float>(*embeddings);
+  ASSERT_TRUE(values.HasValue());
+  EXPECT_THAT(*values, ElementsAre(5, 6));
+  // The images and audios are cached apart.
+  ASSERT_OK_AND_ASSIGN(auto audio_data, cache->LookupAudio(image_key));
+  EXPECT_FALSE(audio_data.has_value());
+
+  ASSERT_OK(cache->InsertAudio(
+      image_key, ExecutorAudioData(CreateTensor({7, 8}, {1, 1, 2}),
+                                   /*per_layer_embeddings=*/std::nullopt,
+                                   /*valid_tokens=*/1)));
+  ASSERT_OK_AND_ASSIGN(audio_data, cache->LookupAudio(image_key));
+  ASSERT_TRUE(audio_data.has_value());
+  EXPECT_EQ(audio_data->GetValidTokens(), 1);
+  EXPECT_EQ(cache->GetNumEntries(), 1);
+  EXPECT_EQ(cache->GetNumHits(), 2);
+  EXPECT_EQ(cache->GetNumMisses(), 2);
+}
+
+TEST(EmbeddingCacheTest, EvictsTheLeastRecentlyUsedEmbeddings) {
+  // Room for two embeddings of 2 floats.
+  ASSERT_OK_AND_ASSIGN(auto cache,
+                       EmbeddingCache::Create(/*max_size_bytes=*/16));
+  std::vector<EmbeddingCache::Key> keys;
+  for (float i = 0; i < 3; ++i) {
+    ASSERT_OK_AND_ASSIGN(auto key,
+                         EmbeddingCache::ComputeKey(CreateTensor({i}, {1})));
+    keys.push_back(key);
+  }
+  ASSERT_OK(cache->InsertVision(
+      keys[0], ExecutorVisionData(CreateTensor({0, 0}, {1, 1, 1, 2}),
+                                  /*per_layer_embeddings=*/std::nullopt)));
+  ASSERT_OK(cache->InsertVision(
+      keys[1], ExecutorVisionData(CreateTensor({1, 1}, {1, 1, 1, 2}),
+                                  /*per_layer_embeddings=*/std::nullopt)));
+  // Uses the first embeddings, so that the second ones are evicted.
+  ASSERT_OK_AND_ASSIGN(auto vision_data, cache->LookupVision(keys[0]));
+  EXPECT_TRUE(vision_data.has_value());
+  ASSERT_OK(cache->InsertVision(
+      keys[2], ExecutorVisionData(CreateTensor({2, 2}, {1, 1, 1, 2}),
+                                  /*per_layer_embeddings=*/std::nullopt)));
+  EXPECT_EQ(cache->GetNumEntries(), 2);
+  EXPECT_EQ(cache->GetSizeInBytes(), 16);
+  ASSERT_OK_AND_ASSIGN(vision_data, cache->LookupVision(keys[1]));
+  EXPECT_FALSE(vision_data.has_value());
+  ASSERT_OK_AND_ASSIGN(vision_data, cache->LookupVision(keys[0]));
+  EXPECT_TRUE(vision_data.has_value());
+
+  // The embeddings over the budget are not cached.
+  ASSERT_OK(cache->InsertVision(
+      keys[1], ExecutorVisionData(CreateTensor({1, 1, 1, 1, 1}, {1, 1, 1, 5}),
+                                  /*per_layer_embeddings=*/std::nullopt)));
+  EXPECT_EQ(cache->GetNumEntries(), 2);
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,41 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/encoder_scheduler.h"
+
+#include <memory>
+#include <vector>
+
+#include "runtime/framework/threadpool.h"
+
+namespace litert::lm {
+
+EncoderScheduler::EncoderScheduler(const std::vector<Stream>& streams) {
+  for (Stream stream : streams) {
+    if (stream == Stream::kVision && vision_thread_ == nullptr) {
+      vision_thread_ = std::make_unique<ThreadPool>(
+          /*name_prefix=*/"vision_encoder", /*max_num_threads=*/1);
+    } else if (stream == Stream::kAudio && audio_thread_ == nullptr) {
+      audio_thread_ = std::make_unique<ThreadPool>(
+          /*name_prefix=*/"audio_encoder", /*max_num_threads=*/1);
+    }
+  }
+}
+
+ThreadPool* EncoderScheduler::GetThread(Stream stream) const {
+  return stream == Stream::kVision ? vision_thread_.get()
+                                   : audio_thread_.get();
+}
+
+}  // namespace litert::lm
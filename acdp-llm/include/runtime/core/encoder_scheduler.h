@@ -0,0 +1,95 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_ENCODER_SCHEDULER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_ENCODER_SCHEDULER_H_
+
+#include <future>  // NOLINT
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "runtime/executor/llm_executor_io_types.h"
+#include "runtime/framework/threadpool.h"
+
+namespace litert::lm {
+
+// The encodings of the images and the audios of a prefill, in the order of
+// the contents, scheduled on the streams of an EncoderScheduler. Empty for the
+// encoders without a stream, which the prefill runs itself.
+struct ScheduledEncodings {
+  std::vector<std::future<absl::StatusOr<ExecutorVisionData>>> images;
+  std::vector<std::future<absl::StatusOr<ExecutorAudioData>>> audios;
+};
+
+// Runs the vision and audio encodings of the sessions on threads of their
+// own, one per encoder ("stream"), instead of in the prefill tasks of the
+// sessions on the worker thread of the engine. A session schedules the
+// encodings of its contents as soon as it receives them, so that the encoders
+// run on their accelerators while the main executor prefills and decodes for
+// the other sessions, and its prefill task picks the embeddings up once done.
+// The encodings of a stream run one at a time, in order.
+//
+// Only the encoders placed on another backend than the main executor should
+// get a stream: on the device of the main executor, they would only contend
+// with it.
+//
+// The class is thread-safe.
+class EncoderScheduler {
+ public:
+  enum class Stream { kVision, kAudio };
+
+  // Creates the threads of `streams`.
+  explicit EncoderScheduler(const std::vector<Stream>& streams);
+
+  EncoderScheduler(const EncoderScheduler&) = delete;
+  EncoderScheduler& operator=(const EncoderScheduler&) = delete;
+
+  // Returns whether the encodings of `stream` run on a thread of their own.
+  bool HasStream(Stream stream) const { return GetThread(stream) != nullptr; }
+
+  // Runs `encode` on the thread of `stream` after the encodings scheduled on
+  // it before, and returns its result once done. The result is an error if
+  // the scheduler has no such stream.
+  template <typename T>
+  std::future<absl::StatusOr<T>> Schedule(
+      Stream stream, absl::AnyInvocable<absl::StatusOr<T>() &&> encode) {
+    auto promise = std::make_shared<std::promise<absl::StatusOr<T>>>();
+    std::future<absl::StatusOr<T>> result = promise->get_future();
+    ThreadPool* thread = GetThread(stream);
+    absl::Status status =
+        thread == nullptr
+            ? absl::FailedPreconditionError("The encoder has no stream.")
+            : thread->Schedule([promise, encode = std::move(encode)]() mutable {
+                promise->set_value(std::move(encode)());
+              });
+    if (!status.ok()) {
+      promise->set_value(status);
+    }
+    return result;
+  }
+
+ private:
+  ThreadPool* GetThread(Stream stream) const;
+
+  std::unique_ptr<ThreadPool> vision_thread_;
+  std::unique_ptr<ThreadPool> audio_thread_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_ENCODER_SCHEDULER_H_
@@ -0,0 +1,92 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/encoder_scheduler.h"
+
+#include <future>  // NOLINT
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/notification.h"  // from @com_google_absl
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::status::StatusIs;
+using Stream = EncoderScheduler::Stream;
+
+TEST(EncoderSchedulerTest, RunsTheEncodingsOfAStreamInOrder) {
+  EncoderScheduler scheduler({Stream::kVision});
+  EXPECT_TRUE(scheduler.HasStream(Stream::kVision));
+  EXPECT_FALSE(scheduler.HasStream(Stream::kAudio));
+
+  std::vector<int> order;
+  std::vector<std::future<absl::StatusOr<int>>> results;
+  for (int i = 0; i < 3; ++i) {
+    results.push_back(scheduler.Schedule<int>(
+        Stream::kVision, [i, &order]() -> absl::StatusOr<int> {
+          order.push_back(i);
+          return i * 10;
+        }));
+  }
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK_AND_ASSIGN(int result, results[i].get());
+    EXPECT_EQ(result, i * 10);
+  }
+  EXPECT_THAT(order, ElementsAre(0, 1, 2));
+}
+
+TEST(EncoderSchedulerTest, RunsTheStreamsConcurrently) {
+  EncoderScheduler scheduler({Stream::kVision, Stream::kAudio});
+  absl::Notification audio_started;
+  // The vision encoding only completes once the audio one has started.
+  std::future<absl::StatusOr<int>> vision_result = scheduler.Schedule<int>(
+      Stream::kVision, [&audio_started]() -> absl::StatusOr<int> {
+        audio_started.WaitForNotification();
+        return 1;
+      });
+  std::future<absl::StatusOr<int>> audio_result = scheduler.Schedule<int>(
+      Stream::kAudio, [&audio_started]() -> absl::StatusOr<int> {
+        audio_started.Notify();
+        return 2;
+      });
+  ASSERT_OK_AND_ASSIGN(int vision, vision_result.get());
+  ASSERT_OK_AND_ASSIGN(int audio, audio_result.get());
+  EXPECT_EQ(vision, 1);
+  EXPECT_EQ(audio, 2);
+}
+
+TEST(EncoderSchedulerTest, FailsWithoutTheStream) {
+  EncoderScheduler scheduler({Stream::kAudio});
+  std::future<absl::StatusOr<int>> result = scheduler.Schedule<int>(
+      Stream::kVision, []() -> absl::StatusOr<int> { return 1; });
+  EXPECT_THAT(result.get(),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST(EncoderSchedulerTest, ReturnsTheErrorOfTheEncoding) {
+  EncoderScheduler scheduler({Stream::kVision});
+  std::future<absl::StatusOr<int>> result = scheduler.Schedule<int>(
+      Stream::kVision,
+      []() -> absl::StatusOr<int> { return absl::InternalError("failed"); });
+  EXPECT_THAT(result.get(), StatusIs(absl::StatusCode::kInternal));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -14,6 +14,7 @@
 
 // TODO(b/417209286): Remove this once the model assets are stored in the
 // litertlm file format.
+#include <cstddef>
 #include <filesystem>  // NOLINT: Required for path manipulation.
 #include <memory>
 #include <optional>
@@ -22,6 +23,8 @@
 #include <vector>
 
 #include "absl/base/no_destructor.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
 #include "absl/log/absl_check.h"  // from @com_google_absl
 #include "absl/log/absl_log.h"  // from @com_google_absl
 #include "absl/log/check.h"  // from @com_google_absl
@@ -29,12 +32,34 @@
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/str_cat.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
 #include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
 #include "litert/cc/litert_environment.h"  // from @litert
 #include "litert/cc/litert_macros.h"  // from @litert
 #include "runtime/components/model_resources.h"
+#include "runtime/components/tokenizer.h"
+#include "runtime/core/continuous_batching_scheduler.h"
+#include "runtime/core/embedding_cache.h"
+#include "runtime/core/encoder_scheduler.h"
+#include "runtime/core/kv_cache_block_allocator.h"
+#include "runtime/core/lazy_executor.h"
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/core/lora_registry.h"
+#include "runtime/core/memory_governor.h"
+#include "runtime/core/model_manifest.h"
+#include "runtime/core/prefix_kv_cache.h"
+#include "runtime/core/priority_task_scheduler.h"
+#include "runtime/core/prompt_token_budget.h"
+#include "runtime/core/resident_context_pool.h"
+#include "runtime/core/sampler_backend_selector.h"
 #include "runtime/core/session_factory.h"
+#include "runtime/core/session_registry.h"
+#include "runtime/core/shared_session_resources.h"
+#include "runtime/core/token_id_cache.h"
+#include "runtime/core/token_text_table.h"
 #include "runtime/engine/engine.h"
+#include "runtime/engine/engine_creation.h"
 #include "runtime/engine/engine_settings.h"
 #include "runtime/engine/io_types.h"
 #include "runtime/executor/audio_executor.h"
@@ -43,6 +68,7 @@
 #include "runtime/executor/executor_settings_base.h"
 #include "runtime/executor/litert_compiled_model_executor_utils.h"
 #include "runtime/executor/llm_executor.h"
+#include "runtime/executor/llm_executor_io_types.h"
 #include "runtime/executor/llm_executor_settings.h"
 #include "runtime/executor/llm_litert_compiled_model_executor.h"
 #include "runtime/executor/magic_number_configs_helper.h"
@@ -51,9 +77,16 @@
 #include "runtime/executor/vision_litert_compiled_model_executor.h"
 #include "runtime/framework/threadpool.h"
 #include "runtime/proto/llm_metadata.pb.h"
+#include "runtime/proto/model_manifest.pb.h"
 #include "runtime/proto/sampler_params.pb.h"
+#include "runtime/util/convert_tensor_buffer.h"
 #include "runtime/util/file_format_util.h"
+#include "runtime/util/litert_lm_loader.h"
+#include "runtime/util/lora_data.h"
+#include "runtime/util/memory_mapped_file.h"
+#include "runtime/util/model_cache.h"
 #include "runtime/util/status_macros.h"  // NOLINT
+#include "runtime/util/thread_affinity.h"
 
 #if !defined(LITERT_DISABLE_NPU)
 #include "runtime/executor/llm_litert_npu_compiled_model_executor.h"
@@ -62,60 +95,291 @@
 namespace litert::lm {
 namespace {
 
-// Gets the singleton Environment, initializing it on the first call
-// with the provided settings. This ensure we maintain the same LiteRT
-// environment during the whole application lifetime. This is required for GPU
-// LiteRT environment. See b/454383477 for more details.
+// Creates the LiteRT environment of the main executor of `engine_settings`.
+absl::StatusOr<Environment> CreateEnvironment(
+    const EngineSettings& engine_settings, ModelResources& model_resources,
+    MagicNumberConfigsHelper& helper) {
+  std::vector<Environment::Option> env_options;
+  const auto& main_executor_settings = engine_settings.GetMainExecutorSettings();
+
+  if ((main_executor_settings.GetBackend() == Backend::CPU) ||
+      (main_executor_settings.GetBackend() == Backend::GPU)) {
+    if (!main_executor_settings
+             .GetAdvancedSettings() ||  // Default is true.
+        main_executor_settings.GetAdvancedSettings()
+            ->configure_magic_numbers) {
+      env_options = helper.GetLiteRtEnvOptions(model_resources,
+                                               main_executor_settings);
+    }
+  } else {
+#if defined(LITERT_DISABLE_NPU)
+    return absl::InvalidArgumentError(
+        "Only CPU and GPU backends are supported.");
+#else
+    std::string model_path(
+        main_executor_settings.GetModelAssets().GetPath().value_or(""));
+    std::filesystem::path path(model_path);
+    // Note: Existence check for path was here, but it's better to check
+    // before calling this function if needed.
+    static const absl::NoDestructor<std::string> kDispatchLibraryPath(
+        path.parent_path().string());
+    if (!kDispatchLibraryPath->empty()) {
+      ABSL_LOG(INFO) << "Setting dispatch library path: "
+                     << *kDispatchLibraryPath;
+      env_options.push_back(::litert::Environment::Option{
+          ::litert::Environment::OptionTag::DispatchLibraryDir,
+          absl::string_view(*kDispatchLibraryPath)});
+    } else {
+      ABSL_LOG(INFO) << "No dispatch library path provided.";
+    }
+#endif  // defined(LITERT_DISABLE_NPU)
+  }
+  LITERT_ASSIGN_OR_RETURN(auto env, Environment::Create(env_options));
+  return std::move(env);
+}
+
+// Gets the Environment of the backend of the main executor, initializing it
+// on the first call for that backend with the provided settings. This ensure
+// we maintain the same LiteRT environment during the whole application
+// lifetime. This is required for GPU LiteRT environment. See b/454383477 for
+// more details. Keeping one environment per backend lets the engines of a
+// process, e.g. the ones of an EnginePool, use different accelerators.
 absl::StatusOr<Environment&> GetEnvironment(
     const EngineSettings& engine_settings, ModelResources& model_resources) {
   // Helper must be available until LlmLiteRtCompiledModelExecutor::Create() is
   // called. Since env is used multiple times, it should also be static.
   static absl::NoDestructor<MagicNumberConfigsHelper> helper;
-  static absl::NoDestructor<absl::StatusOr<Environment>> kEnvironment(
-      [&]() -> absl::StatusOr<Environment> {
-        std::vector<Environment::Option> env_options;
-        const auto& main_executor_settings =
-            engine_settings.GetMainExecutorSettings();
-
-        if ((main_executor_settings.GetBackend() == Backend::CPU) ||
-            (main_executor_settings.GetBackend() == Backend::GPU)) {
-          if (!main_executor_settings
-                   .GetAdvancedSettings() ||  // Default is true.
-              main_executor_settings.GetAdvancedSettings()
-                  ->configure_magic_numbers) {
-            env_options = helper->GetLiteRtEnvOptions(model_resources,
-                                                      main_executor_settings);
-          }
-        } else {
-#if defined(LITERT_DISABLE_NPU)
-          return absl::InvalidArgumentError(
-              "Only CPU and GPU backends are supported.");
-#else
-          std::string model_path(
-              main_executor_settings.GetModelAssets().GetPath().value_or(""));
-          std::filesystem::path path(model_path);
-          // Note: Existence check for path was here, but it's better to check
-          // before calling this function if needed.
-          static const absl::NoDestructor<std::string> kDispatchLibraryPath(
-              path.parent_path().string());
-          if (!kDispatchLibraryPath->empty()) {
-            ABSL_LOG(INFO) << "Setting dispatch library path: "
-                           << *kDispatchLibraryPath;
-            env_options.push_back(::litert::Environment::Option{
-                ::litert::Environment::OptionTag::DispatchLibraryDir,
-                absl::string_view(*kDispatchLibraryPath)});
-          } else {
-            ABSL_LOG(INFO) << "No dispatch library path provided.";
-          }
-#endif  // defined(LITERT_DISABLE_NPU)
+  static absl::NoDestructor<absl::Mutex> mutex;
+  // Not moved once created, the engines keep referring to them.
+  static absl::NoDestructor<absl::flat_hash_map<
+      Backend, std::unique_ptr<absl::StatusOr<Environment>>>>
+      environments;
+  absl::MutexLock lock(mutex.get());
+  auto& environment =
+      (*environments)[engine_settings.GetMainExecutorSettings().GetBackend()];
+  if (environment == nullptr) {
+    environment = std::make_unique<absl::StatusOr<Environment>>(
+        CreateEnvironment(engine_settings, model_resources, *helper));
+  }
+  if (!environment->ok()) {
+    return environment->status();
+  }
+  return **environment;
+}
+
+// Points the cache of the executor at the directory of its model and backend
+// under the engine cache directory, unless the executor has its own.
+absl::Status SetModelCacheDir(absl::string_view cache_dir,
+                              LlmExecutorSettings& executor_settings) {
+  if (cache_dir.empty() || !executor_settings.GetCacheDir().empty()) {
+    return absl::OkStatus();
+  }
+  ASSIGN_OR_RETURN(auto scoped_file,
+                   executor_settings.GetModelAssets().GetOrCreateScopedFile());
+  ASSIGN_OR_RETURN(std::string fingerprint,
+                   ComputeModelFingerprint(*scoped_file));
+  ASSIGN_OR_RETURN(
+      std::string model_cache_dir,
+      GetModelCacheDir(cache_dir, fingerprint,
+                       absl::StrCat(executor_settings.GetBackend())));
+  ABSL_LOG(INFO) << "Caching the compiled model in " << model_cache_dir;
+  executor_settings.SetCacheDir(model_cache_dir);
+  return absl::OkStatus();
+}
+
+// A step of the engine creation, timed as an init phase and reported as a
+// creation phase.
+struct InitTask {
+  std::string phase_name;
+  EngineCreationPhase creation_phase;
+  absl::AnyInvocable<absl::Status()> run;
+};
+
+// Returns a Cancelled error if the creation reported to `progress` is
+// cancelled.
+absl::Status CompleteCreationPhase(EngineCreationProgress* progress,
+                                   EngineCreationPhase phase) {
+  return progress == nullptr ? absl::OkStatus()
+                             : progress->CompletePhase(phase);
+}
+
+// Records the growth of the resident memory of the process over the phases of
+// the engine creation, which run one after the other. Nothing is recorded
+// where the resident memory can not be read.
+class CreationMemoryRecorder {
+ public:
+  CreationMemoryRecorder() : last_resident_bytes_(ReadResidentBytes()) {}
+
+  // Ends the phase started at the end of the previous one.
+  void EndPhase(absl::string_view name) {
+    if (!last_resident_bytes_.has_value()) {
+      return;
+    }
+    const std::optional<size_t> resident_bytes = ReadResidentBytes();
+    if (!resident_bytes.has_value()) {
+      return;
+    }
+    phases_.push_back(
+        {.name = std::string(name),
+         .resident_bytes_growth = static_cast<int64_t>(*resident_bytes) -
+                                  static_cast<int64_t>(*last_resident_bytes_)});
+    last_resident_bytes_ = resident_bytes;
+  }
+
+  std::vector<EngineMemoryUsage::CreationPhase> GetPhases() && {
+    return std::move(phases_);
+  }
+
+ private:
+  static std::optional<size_t> ReadResidentBytes() {
+    absl::StatusOr<size_t> resident_bytes =
+        MemoryGovernor::GetResidentMemoryBytes();
+    if (!resident_bytes.ok()) {
+      return std::nullopt;
+    }
+    return *resident_bytes;
+  }
+
+  std::optional<size_t> last_resident_bytes_;
+  std::vector<EngineMemoryUsage::CreationPhase> phases_;
+};
+
+// Runs the `tasks`, concurrently on a startup thread pool if `parallel`,
+// reports each of them to `progress` and records it as an init phase of
+// `benchmark_info` and of `memory_recorder`, or all of them as one phase of
+// `memory_recorder` when concurrent. Returns the first error of the tasks in
+// their order.
+absl::Status RunInitTasks(std::vector<InitTask> tasks, bool parallel,
+                          EngineCreationProgress* progress,
+                          std::optional<BenchmarkInfo>& benchmark_info,
+                          CreationMemoryRecorder& memory_recorder) {
+  struct InitTaskResult {
+    absl::Status status;
+    absl::Time start_time;
+    absl::Time end_time;
+  };
+  std::vector<InitTaskResult> results(tasks.size());
+  {
+    std::unique_ptr<ThreadPool> thread_pool;
+    if (parallel && tasks.size() > 1) {
+      thread_pool = std::make_unique<ThreadPool>(
+          /*name_prefix=*/"engine_init",
+          /*max_num_threads=*/static_cast<int>(tasks.size()));
+    }
+    for (size_t i = 0; i < tasks.size(); ++i) {
+      auto run = [&task = tasks[i], &result = results[i], progress]() {
+        result.start_time = absl::Now();
+        result.status = task.run();
+        result.end_time = absl::Now();
+        if (result.status.ok()) {
+          result.status =
+              CompleteCreationPhase(progress, task.creation_phase);
         }
-        LITERT_ASSIGN_OR_RETURN(auto env, Environment::Create(env_options));
-        return std::move(env);
-      }());
-  if (!kEnvironment->ok()) {
-    return kEnvironment->status();
+      };
+      if (thread_pool == nullptr) {
+        run();
+        RETURN_IF_ERROR(results[i].status);
+        memory_recorder.EndPhase(tasks[i].phase_name);
+      } else {
+        RETURN_IF_ERROR(thread_pool->Schedule(std::move(run)));
+      }
+    }
+    if (thread_pool != nullptr) {
+      RETURN_IF_ERROR(thread_pool->WaitUntilDone(absl::InfiniteDuration()));
+      memory_recorder.EndPhase("Executors initialization");
+    }
   }
-  return **kEnvironment;
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    RETURN_IF_ERROR(results[i].status);
+    if (benchmark_info.has_value()) {
+      RETURN_IF_ERROR(benchmark_info->RecordInitPhase(
+          tasks[i].phase_name, results[i].start_time, results[i].end_time));
+    }
+  }
+  return absl::OkStatus();
+}
+
+// The text prefilled by the warm-up when the engine has no prompt hint.
+constexpr absl::string_view kDefaultWarmUpText =
+    "Warm up the model with a short prompt.";
+
+// Runs a throwaway prefill of `text` and `num_decode_steps` decode steps on
+// `executor`, which then runs the first request as fast as the next ones,
+// and resets it. The prompt is truncated to leave room for the decode steps
+// within `max_num_tokens`.
+absl::Status WarmUpExecutor(LlmExecutor& executor, Tokenizer& tokenizer,
+                            absl::string_view text, int num_decode_steps,
+                            int max_num_tokens) {
+  ASSIGN_OR_RETURN(std::vector<int> token_ids,
+                   tokenizer.TextToTokenIds(
+                       text.empty() ? kDefaultWarmUpText : text));
+  const int max_num_prompt_tokens = max_num_tokens - num_decode_steps;
+  if (token_ids.empty() || max_num_prompt_tokens <= 0) {
+    return absl::OkStatus();
+  }
+  if (static_cast<int>(token_ids.size()) > max_num_prompt_tokens) {
+    token_ids.resize(max_num_prompt_tokens);
+  }
+  const int num_prompt_tokens = token_ids.size();
+  LITERT_ASSIGN_OR_RETURN(
+      auto token_ids_buffer,
+      CopyToTensorBuffer<int>(absl::MakeConstSpan(token_ids),
+                              {1, num_prompt_tokens}));
+  ExecutorInputs inputs;
+  inputs.SetTextData(ExecutorTextData(std::move(token_ids_buffer)));
+  ExecutorPrefillParams params;
+  params.SetWaitForCompletion(true);
+  RETURN_IF_ERROR(executor.Prefill(inputs, params));
+
+  // The sampler is otherwise created by the first decode step.
+  if (auto* compiled_model_executor =
+          dynamic_cast<LlmLiteRtCompiledModelExecutor*>(&executor);
+      compiled_model_executor != nullptr) {
+    compiled_model_executor->InitializeSampler().IgnoreError();
+  }
+  LITERT_ASSIGN_OR_RETURN(auto output_tokens,
+                          CreateTensorBuffer<int>({1, 1}));
+  for (int i = 0; i < num_decode_steps; ++i) {
+    RETURN_IF_ERROR(executor.Decode(output_tokens));
+  }
+  return executor.Reset();
+}
+
+// Returns the scheduler running the encoders placed on another backend than
+// the main executor on threads of their own, or nullptr if there is none.
+std::unique_ptr<EncoderScheduler> CreateEncoderScheduler(
+    const EngineSettings& engine_settings) {
+  const Backend main_backend =
+      engine_settings.GetMainExecutorSettings().GetBackend();
+  std::vector<EncoderScheduler::Stream> streams;
+  if (engine_settings.GetVisionExecutorSettings().has_value() &&
+      engine_settings.GetVisionExecutorSettings()->GetBackend() !=
+          main_backend) {
+    streams.push_back(EncoderScheduler::Stream::kVision);
+  }
+  if (engine_settings.GetAudioExecutorSettings().has_value() &&
+      engine_settings.GetAudioExecutorSettings()->GetBackend() !=
+          main_backend) {
+    streams.push_back(EncoderScheduler::Stream::kAudio);
+  }
+  if (streams.empty()) {
+    return nullptr;
+  }
+  return std::make_unique<EncoderScheduler>(streams);
+}
+
+// Creates the thread the sessions encode the audio of the turns mixing images
+// and audio on, while they encode the images, or returns nullptr without both
+// encoders. A single thread is enough, as the audio encoder runs one encoding
+// at a time.
+std::unique_ptr<ThreadPool> CreateAudioEncodingThreadPool(
+    const EngineSettings& engine_settings) {
+  if (!engine_settings.GetVisionExecutorSettings().has_value() ||
+      !engine_settings.GetAudioExecutorSettings().has_value()) {
+    return nullptr;
+  }
+  return std::make_unique<ThreadPool>(/*name_prefix=*/"audio_encoding",
+                                      /*max_num_threads=*/1);
 }
 
 }  // namespace
@@ -123,50 +387,256 @@ absl::StatusOr<Environment&> GetEnvironment(
 class EngineImpl : public Engine {
  public:
   ~EngineImpl() override {
-    ABSL_QCHECK_OK(WaitUntilDone(Engine::kDefaultTimeout));
+    if (auto status = WaitUntilDone(Engine::kDefaultTimeout); !status.ok()) {
+      // The tasks refer to the engine, cancel them rather than leaving them
+      // dangling.
+      ABSL_LOG(ERROR) << "Cancelling the tasks still running: " << status;
+      session_registry_.StartDraining();
+      status = WaitUntilDone(absl::InfiniteDuration());
+      if (!status.ok()) {
+        ABSL_LOG(ERROR) << "Failed to wait for the cancelled tasks: " << status;
+      }
+    }
   }
   explicit EngineImpl(EngineSettings engine_settings,
                       std::unique_ptr<ModelResources> litert_model_resources,
                       std::unique_ptr<LlmExecutor> executor,
                       std::unique_ptr<VisionExecutor> vision_executor,
                       std::unique_ptr<AudioExecutor> audio_executor,
+                      std::unique_ptr<LazyExecutor<VisionExecutor>>
+                          lazy_vision_executor,
+                      std::unique_ptr<LazyExecutor<AudioExecutor>>
+                          lazy_audio_executor,
+                      std::unique_ptr<ModelResources> draft_model_resources,
+                      std::unique_ptr<LlmExecutor> draft_executor,
                       std::optional<BenchmarkInfo> benchmark_info,
-                      std::unique_ptr<ThreadPool> worker_thread_pool)
+                      std::unique_ptr<ContinuousBatchingScheduler>
+                          batching_scheduler,
+                      std::unique_ptr<ResidentContextPool>
+                          resident_context_pool,
+                      std::unique_ptr<PrefixKvCache> prefix_kv_cache,
+                      std::unique_ptr<KvCacheBlockAllocator>
+                          kv_cache_block_allocator,
+                      std::unique_ptr<TokenIdCache> token_id_cache,
+                      std::unique_ptr<TokenTextTable> token_text_table,
+                      std::unique_ptr<EmbeddingCache> embedding_cache,
+                      std::unique_ptr<LoraRegistry> lora_registry,
+                      std::unique_ptr<ThreadAffinity> thread_affinity,
+                      std::unique_ptr<ThreadPool> worker_thread_pool,
+                      std::unique_ptr<MemoryGovernor> memory_governor,
+                      std::vector<EngineMemoryUsage::CreationPhase>
+                          creation_memory_phases,
+                      size_t kv_cache_bytes)
       : engine_settings_(std::move(engine_settings)),
+        session_config_defaults_(
+            SessionConfigDefaults::Create(engine_settings_)),
         litert_model_resources_(std::move(litert_model_resources)),
         executor_(std::move(executor)),
         vision_executor_(std::move(vision_executor)),
         audio_executor_(std::move(audio_executor)),
+        lazy_vision_executor_(std::move(lazy_vision_executor)),
+        lazy_audio_executor_(std::move(lazy_audio_executor)),
+        draft_model_resources_(std::move(draft_model_resources)),
+        draft_executor_(std::move(draft_executor)),
         stop_token_ids_(),
         sampler_params_(),
         benchmark_info_(std::move(benchmark_info)),
-        worker_thread_pool_(std::move(worker_thread_pool)) {}
+        batching_scheduler_(std::move(batching_scheduler)),
+        resident_context_pool_(std::move(resident_context_pool)),
+        prefix_kv_cache_(std::move(prefix_kv_cache)),
+        kv_cache_block_allocator_(std::move(kv_cache_block_allocator)),
+        token_id_cache_(std::move(token_id_cache)),
+        token_text_table_(std::move(token_text_table)),
+        embedding_cache_(std::move(embedding_cache)),
+        lora_registry_(std::move(lora_registry)),
+        thread_affinity_(std::move(thread_affinity)),
+        worker_thread_pool_(std::move(worker_thread_pool)),
+        task_scheduler_(worker_thread_pool_.get(),
+                        PriorityTaskScheduler::kDefaultAgingInterval,
+                        thread_affinity_.get()),
+        encoder_scheduler_(CreateEncoderScheduler(engine_settings_)),
+        audio_encoding_thread_pool_(
+            CreateAudioEncodingThreadPool(engine_settings_)),
+        prompt_token_budget_(
+            engine_settings_.GetMainExecutorSettings().GetMaxNumTokens()),
+        memory_governor_(std::move(memory_governor)),
+        creation_memory_phases_(std::move(creation_memory_phases)),
+        kv_cache_bytes_(kv_cache_bytes) {}
   // Method to create the Session.
   absl::StatusOr<std::unique_ptr<Session>> CreateSession(
       const SessionConfig& session_config) const override {
     SessionConfig config = session_config;
     // TODO(b/418794726): Move this logics to be part of the SessionConfig
     // class.
-    RETURN_IF_ERROR(config.MaybeUpdateAndValidate(engine_settings_));
+    RETURN_IF_ERROR(config.MaybeUpdateAndValidate(*session_config_defaults_));
+    if (session_registry_.IsDraining()) {
+      return absl::UnavailableError("The engine is draining.");
+    }
 
     ABSL_CHECK(litert_model_resources_ != nullptr);
     ASSIGN_OR_RETURN(auto* tokenizer, litert_model_resources_->GetTokenizer());
+    SharedSessionResources shared_resources;
+    shared_resources.batching_scheduler = batching_scheduler_.get();
+    shared_resources.resident_context_pool = resident_context_pool_.get();
+    shared_resources.draft_executor = draft_executor_.get();
+    shared_resources.prefix_kv_cache = prefix_kv_cache_.get();
+    shared_resources.kv_cache_block_allocator =
+        kv_cache_block_allocator_.get();
+    shared_resources.token_id_cache = token_id_cache_.get();
+    shared_resources.token_text_table = token_text_table_.get();
+    shared_resources.embedding_cache = embedding_cache_.get();
+    shared_resources.lazy_vision_executor = lazy_vision_executor_.get();
+    shared_resources.lazy_audio_executor = lazy_audio_executor_.get();
+    shared_resources.lora_registry = lora_registry_.get();
+    shared_resources.task_scheduler = &task_scheduler_;
+    shared_resources.sampler_backend_selector = &sampler_backend_selector_;
+    shared_resources.encoder_scheduler = encoder_scheduler_.get();
+    shared_resources.audio_encoding_thread_pool =
+        audio_encoding_thread_pool_.get();
+    if (batching_scheduler_ != nullptr) {
+      shared_resources.vision_encoder_mutex = &vision_encoder_mutex_;
+      shared_resources.audio_encoder_mutex = &audio_encoder_mutex_;
+    }
+    shared_resources.prompt_token_budget = &prompt_token_budget_;
+    shared_resources.load_counters = &load_counters_;
+    shared_resources.session_registry = &session_registry_;
+    shared_resources.engine_role = engine_settings_.GetEngineRole();
     return InitializeSession(executor_.get(), tokenizer,
                              /*vision_executor=*/vision_executor_.get(),
                              /*audio_executor=*/audio_executor_.get(), config,
-                             benchmark_info_, worker_thread_pool_.get());
+                             benchmark_info_, worker_thread_pool_.get(),
+                             shared_resources);
   }
   absl::Status WaitUntilDone(absl::Duration timeout) override {
     return worker_thread_pool_->WaitUntilDone(timeout);
   }
 
+  absl::Status Drain(absl::Duration timeout) override {
+    ABSL_LOG(INFO) << "Draining the engine with "
+                   << session_registry_.GetNumSessions() << " live sessions.";
+    session_registry_.StartDraining();
+    return WaitUntilDone(timeout);
+  }
+
   const EngineSettings& GetEngineSettings() const override {
     return engine_settings_;
   }
 
+  absl::StatusOr<Tokenizer*> GetTokenizer() const override {
+    ABSL_CHECK(litert_model_resources_ != nullptr);
+    return litert_model_resources_->GetTokenizer();
+  }
+
+  absl::StatusOr<EngineLoad> GetLoad() const override {
+    EngineLoad load;
+    load.num_sessions = load_counters_.num_sessions.load();
+    load.num_queued_tasks = load_counters_.num_queued_tasks.load();
+    if (kv_cache_block_allocator_ != nullptr) {
+      load.num_free_kv_cache_tokens =
+          kv_cache_block_allocator_->GetNumFreeBlocks() *
+          kv_cache_block_allocator_->GetBlockSize();
+    }
+    return load;
+  }
+
+  absl::StatusOr<EngineMetrics> GetMetrics() const override {
+    EngineMetrics metrics;
+    metrics.num_sessions = load_counters_.num_sessions.load();
+    metrics.num_queued_tasks = load_counters_.num_queued_tasks.load();
+    metrics.num_prefilled_tokens = load_counters_.num_prefilled_tokens.load();
+    metrics.num_decode_steps = load_counters_.num_decode_steps.load();
+    metrics.num_cancellations = load_counters_.num_cancellations.load();
+    if (kv_cache_block_allocator_ != nullptr &&
+        kv_cache_block_allocator_->GetNumBlocks() > 0) {
+      metrics.kv_cache_utilization =
+          1.0 - static_cast<double>(
+                    kv_cache_block_allocator_->GetNumFreeBlocks()) /
+                    kv_cache_block_allocator_->GetNumBlocks();
+    }
+    if (prefix_kv_cache_ != nullptr) {
+      metrics.prefix_cache = {.num_hits = prefix_kv_cache_->GetNumHits(),
+                              .num_misses = prefix_kv_cache_->GetNumMisses()};
+    }
+    if (embedding_cache_ != nullptr) {
+      metrics.embedding_cache = {
+          .num_hits = embedding_cache_->GetNumHits(),
+          .num_misses = embedding_cache_->GetNumMisses()};
+    }
+    if (token_id_cache_ != nullptr) {
+      metrics.token_id_cache = {.num_hits = token_id_cache_->GetNumHits(),
+                                .num_misses = token_id_cache_->GetNumMisses()};
+    }
+    return metrics;
+  }
+
+  absl::Status NotifyMemoryPressure() override {
+    memory_governor_->NotifyMemoryPressure();
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<MemorySheddingStats> GetMemorySheddingStats() const override {
+    return memory_governor_->GetStats();
+  }
+
+  absl::StatusOr<EngineMemoryUsage> GetMemoryUsage() const override {
+    EngineMemoryUsage usage;
+    usage.resident_bytes =
+        MemoryGovernor::GetResidentMemoryBytes().value_or(0);
+    usage.creation_phases = creation_memory_phases_;
+    usage.kv_cache_bytes = kv_cache_bytes_;
+    if (prefix_kv_cache_ != nullptr) {
+      usage.prefix_cache_bytes = prefix_kv_cache_->GetSizeInBytes();
+    }
+    if (embedding_cache_ != nullptr) {
+      usage.embedding_cache_bytes = embedding_cache_->GetSizeInBytes();
+    }
+    if (lora_registry_ != nullptr) {
+      usage.lora_adapter_bytes = lora_registry_->GetSizeInBytes();
+    }
+    usage.vision_executor_loaded =
+        vision_executor_ != nullptr ||
+        (lazy_vision_executor_ != nullptr && lazy_vision_executor_->IsCreated());
+    usage.audio_executor_loaded =
+        audio_executor_ != nullptr ||
+        (lazy_audio_executor_ != nullptr && lazy_audio_executor_->IsCreated());
+    usage.num_sessions = session_registry_.GetNumSessions();
+    return usage;
+  }
+
+  absl::StatusOr<DecodeLatencyHistograms> GetDecodeLatencyHistograms()
+      const override {
+    if (!benchmark_info_.has_value()) {
+      return absl::FailedPreconditionError(
+          "The benchmark is not enabled in the engine settings.");
+    }
+    return benchmark_info_->GetSharedDecodeLatencyHistograms();
+  }
+
+  absl::Status RegisterLoraAdapter(absl::string_view id,
+                                   absl::string_view file_path) override {
+    if (lora_registry_ == nullptr) {
+      return absl::FailedPreconditionError(
+          "The executor does not support LoRA adapters.");
+    }
+    return lora_registry_->Register(
+        id, [file_path = std::string(file_path)]() {
+          return LoraData::CreateFromFilePath(file_path);
+        });
+  }
+
+  absl::Status UnregisterLoraAdapter(absl::string_view id) override {
+    if (lora_registry_ == nullptr) {
+      return absl::FailedPreconditionError(
+          "The executor does not support LoRA adapters.");
+    }
+    return lora_registry_->Unregister(id);
+  }
+
  private:
   // Stored engine settings.
   EngineSettings engine_settings_;
+  // The defaults of the session configs, read from `engine_settings_` once.
+  std::shared_ptr<const SessionConfigDefaults> session_config_defaults_;
   // Model resources, which must outlive `executor_`.
   std::unique_ptr<ModelResources> litert_model_resources_;
   // Shared executor for all sessions.
@@ -175,6 +645,14 @@ class EngineImpl : public Engine {
   std::unique_ptr<VisionExecutor> vision_executor_;
   // shared audio executor for all sessions.
   std::unique_ptr<AudioExecutor> audio_executor_;
+  // The vision and audio executors created on first use instead, when the
+  // engine creates them lazily.
+  std::unique_ptr<LazyExecutor<VisionExecutor>> lazy_vision_executor_;
+  std::unique_ptr<LazyExecutor<AudioExecutor>> lazy_audio_executor_;
+  // Model resources of the draft model, which must outlive `draft_executor_`.
+  std::unique_ptr<ModelResources> draft_model_resources_;
+  // Draft executor for speculative decoding. nullptr if not enabled.
+  std::unique_ptr<LlmExecutor> draft_executor_;
   // Default stop token ids for all sessions loaded from the model file.
   std::vector<std::vector<int>> stop_token_ids_;
   proto::SamplerParameters sampler_params_;
@@ -182,13 +660,98 @@ class EngineImpl : public Engine {
   // Benchmark info for the engine.
   std::optional<BenchmarkInfo> benchmark_info_;
 
+  // Batches the decode steps of the concurrent sessions. nullptr if the
+  // executor does not support multiple resident contexts.
+  std::unique_ptr<ContinuousBatchingScheduler> batching_scheduler_;
+
+  // Keeps the contexts of several sessions resident when the executor can,
+  // but does not batch them. nullptr otherwise.
+  std::unique_ptr<ResidentContextPool> resident_context_pool_;
+
+  // The kv-cache snapshots of the prompt prefixes shared by the sessions.
+  // nullptr if disabled or not supported by the executor.
+  std::unique_ptr<PrefixKvCache> prefix_kv_cache_;
+
+  // The blocks of the paged kv-cache, handed out to the sessions as their
+  // contexts grow. nullptr if the executor does not page its kv-cache.
+  std::unique_ptr<KvCacheBlockAllocator> kv_cache_block_allocator_;
+
+  // The token ids of the texts prefilled by the sessions. nullptr if
+  // disabled.
+  std::unique_ptr<TokenIdCache> token_id_cache_;
+
+  // The texts of the tokens of the tokenizer, looked up by the decode loops.
+  // nullptr if the executor does not report its vocabulary size.
+  std::unique_ptr<TokenTextTable> token_text_table_;
+
+  // The embeddings of the images and audios encoded by the sessions. nullptr
+  // if disabled.
+  std::unique_ptr<EmbeddingCache> embedding_cache_;
+
+  // The LoRA adapters selected by the sessions. nullptr if the executor does
+  // not support them. Destroyed after the sessions, which must not outlive
+  // the engine, and before the executor.
+  std::unique_ptr<LoraRegistry> lora_registry_;
+
+  // The cpus and the NUMA node the threads of the engine are bound to.
+  // nullptr if not bound.
+  std::unique_ptr<ThreadAffinity> thread_affinity_;
+
   // Thread pool for the engine to execute the works.
   std::unique_ptr<ThreadPool> worker_thread_pool_;
+
+  // Orders the tasks of the sessions on `worker_thread_pool_` by priority.
+  // The destructor waits for the pool to be idle before destroying it.
+  mutable PriorityTaskScheduler task_scheduler_;
+
+  // Runs the encoders placed on another backend than the main executor on
+  // threads of their own, next to the tasks of `task_scheduler_`. nullptr if
+  // the encoders share the backend of the main executor.
+  std::unique_ptr<EncoderScheduler> encoder_scheduler_;
+
+  // Encodes the audio of the turns mixing images and audio while the images
+  // are encoded. nullptr without both encoders.
+  std::unique_ptr<ThreadPool> audio_encoding_thread_pool_;
+
+  // Serialize the encodings of the sessions running on concurrent threads
+  // with the batching scheduler, see SharedSessionResources.
+  mutable absl::Mutex vision_encoder_mutex_;
+  mutable absl::Mutex audio_encoder_mutex_;
+
+  // The number of tokens the sessions count per image, learned from their
+  // encodings, to reject the prompts too long before encoding them.
+  mutable PromptTokenBudget prompt_token_budget_;
+
+  // The sampling costs measured by the sessions selecting their sampler
+  // backend automatically.
+  mutable SamplerBackendSelector sampler_backend_selector_;
+
+  // The load reported by the sessions, which the const CreateSession() hands
+  // to them.
+  mutable SessionLoadCounters load_counters_;
+  // The live sessions, cancelled by Drain().
+  mutable SessionRegistry session_registry_;
+
+  // Sheds the caches and the lazy executors above, so it is destroyed before
+  // them.
+  std::unique_ptr<MemoryGovernor> memory_governor_;
+
+  // The memory taken by the phases of the engine creation, and the kv-cache
+  // of the executor contexts, for GetMemoryUsage().
+  const std::vector<EngineMemoryUsage::CreationPhase> creation_memory_phases_;
+  const size_t kv_cache_bytes_;
 };
 
 // Method to create Engine.
 absl::StatusOr<std::unique_ptr<Engine>> Engine::CreateEngine(
     EngineSettings engine_settings, absl::string_view input_prompt_as_hint) {
+  return CreateEngine(std::move(engine_settings), input_prompt_as_hint,
+                      /*progress=*/nullptr);
+}
+
+absl::StatusOr<std::unique_ptr<Engine>> Engine::CreateEngine(
+    EngineSettings engine_settings, absl::string_view input_prompt_as_hint,
+    EngineCreationProgress* progress) {
   std::optional<BenchmarkInfo> benchmark_info;
   if (engine_settings.IsBenchmarkEnabled()) {
     benchmark_info = std::make_optional<BenchmarkInfo>(
@@ -196,14 +759,77 @@ absl::StatusOr<std::unique_ptr<Engine>> Engine::CreateEngine(
     RETURN_IF_ERROR(
         benchmark_info->TimeInitPhaseStart("Executor initialization"));
   }
+  CreationMemoryRecorder memory_recorder;
   const auto& model_assets =
       engine_settings.GetMutableMainExecutorSettings().GetModelAssets();
 
+  // The threads created from then on, by the executors and the engine,
+  // inherit the binding of the creating thread, as do the pages of the model
+  // faulted in while loading it.
+  std::unique_ptr<ThreadAffinity> thread_affinity;
+  std::unique_ptr<ScopedThreadAffinity> scoped_thread_affinity;
+  if (!engine_settings.GetCpuAffinity().empty() ||
+      engine_settings.GetNumaNode() >= 0) {
+    ASSIGN_OR_RETURN(ThreadAffinity affinity,
+                     ThreadAffinity::Create(engine_settings.GetCpuAffinity(),
+                                            engine_settings.GetNumaNode()));
+    thread_affinity = std::make_unique<ThreadAffinity>(std::move(affinity));
+    ASSIGN_OR_RETURN(scoped_thread_affinity,
+                     ScopedThreadAffinity::Create(*thread_affinity));
+  }
+  if (engine_settings.GetNumaNode() >= 0) {
+    MappingOptions mapping_options =
+        engine_settings.GetMappingOptions().value_or(
+            MemoryMappedFile::GetDefaultMappingOptions());
+    mapping_options.numa_node = engine_settings.GetNumaNode();
+    engine_settings.SetMappingOptions(mapping_options);
+  }
+  if (engine_settings.GetMappingOptions().has_value()) {
+    // The model resources map the model files with the default options.
+    MemoryMappedFile::SetDefaultMappingOptions(
+        engine_settings.GetMappingOptions().value());
+  }
+  if (engine_settings.GetModelVerificationMode().has_value()) {
+    // As do the loaders of the .litertlm files with the verification mode.
+    LitertLmLoader::SetDefaultVerificationMode(
+        engine_settings.GetModelVerificationMode().value());
+  }
   ASSIGN_OR_RETURN(auto model_resources,
                    BuildLiteRtCompiledModelResources(model_assets));
   ASSIGN_OR_RETURN(auto scoped_file, model_assets.GetOrCreateScopedFile());
-  ASSIGN_OR_RETURN(auto file_format,
-                   GetFileFormat(/*model_path=*/"", scoped_file));
+
+  std::string cache_dir = engine_settings.GetCacheDir();
+  if (cache_dir.empty() &&
+      !engine_settings.GetSharedMemoryCacheName().empty()) {
+    ASSIGN_OR_RETURN(cache_dir, GetSharedMemoryCacheDir(
+                                    engine_settings.GetSharedMemoryCacheName()));
+  }
+  // With a cache directory, the file format and the metadata of the model
+  // come from its manifest, built by the first engine loading the model.
+  std::string manifest_path;
+  absl::StatusOr<proto::ModelManifest> manifest =
+      absl::NotFoundError("No cache directory.");
+  if (!cache_dir.empty()) {
+    ASSIGN_OR_RETURN(std::string fingerprint,
+                     ComputeModelFingerprint(*scoped_file));
+    ASSIGN_OR_RETURN(manifest_path,
+                     GetModelManifestPath(cache_dir, fingerprint));
+    manifest = LoadModelManifest(manifest_path);
+    if (!manifest.ok() && !absl::IsNotFound(manifest.status())) {
+      ABSL_LOG(WARNING) << "Building the model manifest again: "
+                        << manifest.status();
+    }
+  }
+  FileFormat file_format;
+  if (manifest.ok()) {
+    file_format = static_cast<FileFormat>(manifest->file_format());
+  } else {
+    ASSIGN_OR_RETURN(file_format,
+                     GetFileFormat(/*model_path=*/"", scoped_file));
+  }
+  RETURN_IF_ERROR(
+      CompleteCreationPhase(progress, EngineCreationPhase::kModelMapping));
+  memory_recorder.EndPhase("Model mapping");
 
   // TODO(b/397975034): factor out the tokenizer creation logic once the
   // model loading mechanism of the new file format is determined.
@@ -222,40 +848,78 @@ absl::StatusOr<std::unique_ptr<Engine>> Engine::CreateEngine(
         benchmark_info->TimeInitPhaseEnd("Tokenizer initialization"));
   }
 
-  ASSIGN_OR_RETURN(auto* llm_metadata, model_resources->GetLlmMetadata());
+  if (!manifest.ok()) {
+    ASSIGN_OR_RETURN(auto* llm_metadata, model_resources->GetLlmMetadata());
+    manifest = BuildModelManifest(file_format, llm_metadata, *tokenizer);
+    if (!manifest_path.empty()) {
+      // The manifest is only built again by the next engines.
+      if (auto status = SaveModelManifest(*manifest, manifest_path);
+          !status.ok()) {
+        ABSL_LOG(WARNING) << "Failed to write the model manifest to "
+                          << manifest_path << ": " << status;
+      }
+    }
+  }
 
-  // Update and load the parameters from the model file and convert the
-  // tokens to ids.
+  // Update and load the parameters from the model file. The tokens of the
+  // metadata of the manifest are already converted to ids.
   RETURN_IF_ERROR(engine_settings.MaybeUpdateAndValidate(
-      *tokenizer, llm_metadata, input_prompt_as_hint));
+      *tokenizer,
+      manifest->has_llm_metadata() ? &manifest->llm_metadata() : nullptr,
+      input_prompt_as_hint));
+  RETURN_IF_ERROR(
+      CompleteCreationPhase(progress, EngineCreationPhase::kTokenizer));
+  memory_recorder.EndPhase("Tokenizer initialization");
+
+  RETURN_IF_ERROR(SetModelCacheDir(
+      cache_dir, engine_settings.GetMutableMainExecutorSettings()));
+  if (engine_settings.GetMutableDraftExecutorSettings().has_value()) {
+    RETURN_IF_ERROR(SetModelCacheDir(
+        cache_dir, *engine_settings.GetMutableDraftExecutorSettings()));
+  }
 
-  std::unique_ptr<LlmExecutor> executor;
   ASSIGN_OR_RETURN(auto& env,
                    GetEnvironment(engine_settings, *model_resources));
+  // Each executor compiles its own model, so that they may be created
+  // concurrently once the settings are validated.
+  std::vector<InitTask> init_tasks;
+  std::unique_ptr<LlmExecutor> executor;
   if ((engine_settings.GetMainExecutorSettings().GetBackend() ==
        Backend::CPU) ||
       (engine_settings.GetMainExecutorSettings().GetBackend() ==
        Backend::GPU)) {
-    const auto& main_executor_settings =
-        engine_settings.GetMainExecutorSettings();
-    ASSIGN_OR_RETURN(executor,
-                     LlmLiteRtCompiledModelExecutor::Create(
-                         main_executor_settings, env, *model_resources));
+    init_tasks.push_back({"LLM executor initialization",
+                          EngineCreationPhase::kMainExecutor, [&]() {
+      ASSIGN_OR_RETURN(executor,
+                       LlmLiteRtCompiledModelExecutor::Create(
+                           engine_settings.GetMainExecutorSettings(), env,
+                           *model_resources));
+      return absl::OkStatus();
+    }});
   } else {
 #if defined(LITERT_DISABLE_NPU)
     return absl::InvalidArgumentError(
         "Only CPU and GPU backends are supported.");
 #else
-    ASSIGN_OR_RETURN(executor,
-                     LlmLiteRtNpuCompiledModelExecutor::Create(
-                         engine_settings.GetMainExecutorSettings(),
-                         *model_resources, env, benchmark_info.has_value()));
+    init_tasks.push_back({"LLM executor initialization",
+                          EngineCreationPhase::kMainExecutor, [&]() {
+      ASSIGN_OR_RETURN(executor,
+                       LlmLiteRtNpuCompiledModelExecutor::Create(
+                           engine_settings.GetMainExecutorSettings(),
+                           *model_resources, env, benchmark_info.has_value()));
+      return absl::OkStatus();
+    }});
 #endif  // defined(LITERT_DISABLE_NPU)
   }
 
   // TODO - b/436674053: Modularize the executor creation logic into a
   // separate executor class, and have unit test for it.
+  // Lazily, the vision and audio executors are only created by the sessions
+  // getting an image or an audio.
+  const bool lazy_multimodal_executors =
+      engine_settings.GetLazyMultimodalExecutors();
   std::unique_ptr<VisionExecutor> vision_executor;
+  std::unique_ptr<LazyExecutor<VisionExecutor>> lazy_vision_executor;
   if (engine_settings.GetVisionExecutorSettings().has_value()) {
     ASSIGN_OR_RETURN(
         auto vision_executor_settings,
@@ -264,11 +928,29 @@ absl::StatusOr<std::unique_ptr<Engine>> Engine::CreateEngine(
             /*encoder_backend=*/
             engine_settings.GetVisionExecutorSettings()->GetBackend(),
             /*adapter_backend=*/Backend::CPU));
-    ASSIGN_OR_RETURN(vision_executor, VisionLiteRtCompiledModelExecutor::Create(
-                                          vision_executor_settings, env));
+    auto create_vision_executor =
+        [settings = std::move(vision_executor_settings),
+         &env]() -> absl::StatusOr<std::unique_ptr<VisionExecutor>> {
+      return VisionLiteRtCompiledModelExecutor::Create(settings, env);
+    };
+    if (lazy_multimodal_executors) {
+      lazy_vision_executor = std::make_unique<LazyExecutor<VisionExecutor>>(
+          std::move(create_vision_executor),
+          engine_settings.GetMultimodalExecutorIdleTimeout());
+    } else {
+      init_tasks.push_back(
+          {"Vision executor initialization",
+           EngineCreationPhase::kVisionExecutor,
+           [&, create_vision_executor =
+                   std::move(create_vision_executor)]() mutable {
+             ASSIGN_OR_RETURN(vision_executor, create_vision_executor());
+             return absl::OkStatus();
+           }});
+    }
   }
 
   std::unique_ptr<AudioExecutor> audio_executor;
+  std::unique_ptr<LazyExecutor<AudioExecutor>> lazy_audio_executor;
   if (engine_settings.GetAudioExecutorSettings().has_value()) {
     ASSIGN_OR_RETURN(
         auto audio_executor_settings,
@@ -276,24 +958,310 @@ absl::StatusOr<std::unique_ptr<Engine>> Engine::CreateEngine(
             engine_settings.GetMainExecutorSettings().GetModelAssets(),
             engine_settings.GetMainExecutorSettings().GetMaxNumTokens(),
             engine_settings.GetAudioExecutorSettings()->GetBackend()));
-    ASSIGN_OR_RETURN(audio_executor, AudioLiteRtCompiledModelExecutor::Create(
-                                         audio_executor_settings, env));
+    auto create_audio_executor =
+        [settings = std::move(audio_executor_settings),
+         &env]() -> absl::StatusOr<std::unique_ptr<AudioExecutor>> {
+      return AudioLiteRtCompiledModelExecutor::Create(settings, env);
+    };
+    if (lazy_multimodal_executors) {
+      lazy_audio_executor = std::make_unique<LazyExecutor<AudioExecutor>>(
+          std::move(create_audio_executor),
+          engine_settings.GetMultimodalExecutorIdleTimeout());
+    } else {
+      init_tasks.push_back(
+          {"Audio executor initialization",
+           EngineCreationPhase::kAudioExecutor,
+           [&, create_audio_executor =
+                   std::move(create_audio_executor)]() mutable {
+             ASSIGN_OR_RETURN(audio_executor, create_audio_executor());
+             return absl::OkStatus();
+           }});
+    }
+  }
+
+  // The draft model is loaded from its own model assets and must share the
+  // tokenizer of the main model.
+  std::unique_ptr<ModelResources> draft_model_resources;
+  std::unique_ptr<LlmExecutor> draft_executor;
+  if (engine_settings.GetDraftExecutorSettings().has_value() &&
+      engine_settings.GetEngineRole() == EngineRole::kPrefill) {
+    ABSL_LOG(WARNING) << "The sessions of a prefill engine do not decode, "
+                         "the draft model is not loaded.";
+  } else if (engine_settings.GetDraftExecutorSettings().has_value()) {
+    const auto& draft_executor_settings =
+        engine_settings.GetDraftExecutorSettings().value();
+    if (draft_executor_settings.GetBackend() != Backend::CPU &&
+        draft_executor_settings.GetBackend() != Backend::GPU) {
+      return absl::InvalidArgumentError(
+          "Only CPU and GPU backends are supported for the draft model.");
+    }
+    init_tasks.push_back({"Draft executor initialization",
+                          EngineCreationPhase::kDraftExecutor, [&]() {
+      const auto& draft_executor_settings =
+          engine_settings.GetDraftExecutorSettings().value();
+      ASSIGN_OR_RETURN(draft_model_resources,
+                       BuildLiteRtCompiledModelResources(
+                           draft_executor_settings.GetModelAssets()));
+      ASSIGN_OR_RETURN(draft_executor,
+                       LlmLiteRtCompiledModelExecutor::Create(
+                           draft_executor_settings, env,
+                           *draft_model_resources));
+      return absl::OkStatus();
+    }});
   }
+  RETURN_IF_ERROR(RunInitTasks(
+      std::move(init_tasks),
+      engine_settings.GetParallelExecutorInitialization(), progress,
+      benchmark_info, memory_recorder));
 
   if (benchmark_info.has_value()) {
     RETURN_IF_ERROR(
         benchmark_info->TimeInitPhaseEnd("Executor initialization"));
   }
 
-  // Creating the thread pool of a single thread to execute the works.
+  // Before the batching scheduler and the paged kv-cache, which size the
+  // contexts after the kv-cache.
+  const KvCacheDataType kv_cache_data_type =
+      engine_settings.GetKvCacheDataType();
+  if (kv_cache_data_type != KvCacheDataType::kFloat) {
+    auto* quantized_executor =
+        GetExecutorExtension<QuantizedKvCacheLlmExecutor>(*executor);
+    if (quantized_executor == nullptr) {
+      return absl::UnimplementedError(
+          "The executor does not support quantized kv-caches.");
+    }
+    RETURN_IF_ERROR(quantized_executor->SetKvCacheDataType(kv_cache_data_type));
+    const size_t kv_cache_size_bytes =
+        quantized_executor->GetKvCacheSizeInBytes(kv_cache_data_type);
+    const size_t kv_cache_float_size_bytes =
+        quantized_executor->GetKvCacheSizeInBytes(KvCacheDataType::kFloat);
+    ABSL_LOG(INFO) << "The kv-cache is stored as " << kv_cache_data_type
+                   << ", " << kv_cache_size_bytes
+                   << " bytes per context instead of "
+                   << kv_cache_float_size_bytes << ".";
+    if (benchmark_info.has_value()) {
+      benchmark_info->SetKvCacheSizes(kv_cache_size_bytes,
+                                      kv_cache_float_size_bytes);
+    }
+  }
+
+  // Before the batching scheduler, which takes over the contexts of the
+  // executor.
+  if (engine_settings.GetNumWarmUpDecodeSteps() > 0) {
+    if (benchmark_info.has_value()) {
+      RETURN_IF_ERROR(benchmark_info->TimeInitPhaseStart("Warm-up"));
+    }
+    RETURN_IF_ERROR(WarmUpExecutor(
+        *executor, *tokenizer, input_prompt_as_hint,
+        engine_settings.GetNumWarmUpDecodeSteps(),
+        engine_settings.GetMainExecutorSettings().GetMaxNumTokens()));
+    if (benchmark_info.has_value()) {
+      RETURN_IF_ERROR(benchmark_info->TimeInitPhaseEnd("Warm-up"));
+    }
+    RETURN_IF_ERROR(
+        CompleteCreationPhase(progress, EngineCreationPhase::kWarmUp));
+    memory_recorder.EndPhase("Warm-up");
+  }
+
+  // If the executor keeps several contexts resident, the sessions run
+  // concurrently and their decode steps are merged into batched executor
+  // calls. Otherwise, all the works are serialized on a single thread.
+  std::unique_ptr<ContinuousBatchingScheduler> batching_scheduler;
+  int num_worker_threads = 1;
+  auto* slot_batched_executor =
+      GetExecutorExtension<SlotBatchedLlmExecutor>(*executor);
+  if (slot_batched_executor != nullptr &&
+      slot_batched_executor->GetMaxNumSlots() > 1) {
+    ASSIGN_OR_RETURN(batching_scheduler,
+                     ContinuousBatchingScheduler::Create(
+                         slot_batched_executor,
+                         ContinuousBatchingScheduler::kDefaultMaxBatchWait,
+                         engine_settings.GetPrefillChunkSize()));
+    num_worker_threads = batching_scheduler->GetMaxNumSlots();
+    ABSL_LOG(INFO) << "Continuous batching is enabled with "
+                   << num_worker_threads << " slots.";
+    // The draft executor keeps a single context, so it can not follow the
+    // concurrent sessions.
+    if (draft_executor != nullptr) {
+      ABSL_LOG(WARNING) << "Speculative decoding is not supported with "
+                           "continuous batching, the draft model is unused.";
+      draft_executor.reset();
+      draft_model_resources.reset();
+    }
+  }
+
+  // Without batching, the executor may still keep the contexts of several
+  // sessions resident, so that interleaving their turns switches between
+  // the contexts instead of prefilling them again.
+  std::unique_ptr<ResidentContextPool> resident_context_pool;
+  auto* multi_context_executor =
+      GetExecutorExtension<MultiContextLlmExecutor>(*executor);
+  if (batching_scheduler == nullptr && multi_context_executor != nullptr &&
+      multi_context_executor->GetMaxNumContexts() > 1) {
+    ASSIGN_OR_RETURN(resident_context_pool,
+                     ResidentContextPool::Create(multi_context_executor));
+    ABSL_LOG(INFO) << "Resident contexts are enabled for "
+                   << resident_context_pool->GetMaxNumContexts()
+                   << " sessions.";
+    // Like the batching, the draft executor can not follow the context
+    // switches.
+    if (draft_executor != nullptr) {
+      ABSL_LOG(WARNING) << "Speculative decoding is not supported with "
+                           "resident contexts, the draft model is unused.";
+      draft_executor.reset();
+      draft_model_resources.reset();
+    }
+  }
+
+  // The kv-cache of every context the executor keeps resident.
+  size_t kv_cache_bytes = 0;
+  if (auto* quantized_executor =
+          GetExecutorExtension<QuantizedKvCacheLlmExecutor>(*executor);
+      quantized_executor != nullptr) {
+    kv_cache_bytes =
+        quantized_executor->GetKvCacheSizeInBytes(kv_cache_data_type) *
+        (batching_scheduler != nullptr ? batching_scheduler->GetMaxNumSlots()
+         : resident_context_pool != nullptr
+             ? multi_context_executor->GetMaxNumContexts()
+             : 1);
+  }
+
+  std::unique_ptr<PrefixKvCache> prefix_kv_cache;
+  const size_t prefix_cache_max_size_bytes =
+      engine_settings.GetPrefixCacheMaxSizeBytes();
+  if (prefix_cache_max_size_bytes > 0) {
+    if (engine_settings.GetEngineRole() == EngineRole::kDecode) {
+      // The prompts are prefilled by the prefill engines.
+      ABSL_LOG(INFO) << "The prefix cache is disabled on a decode engine.";
+    } else if (GetExecutorExtension<KvCacheSnapshotLlmExecutor>(*executor) !=
+               nullptr) {
+      ASSIGN_OR_RETURN(prefix_kv_cache,
+                       PrefixKvCache::Create(prefix_cache_max_size_bytes));
+    } else {
+      ABSL_LOG(WARNING) << "The executor does not support kv-cache "
+                           "snapshots, the prefix cache is disabled.";
+    }
+  }
+
+  // A paged kv-cache is only shared by the sessions when they own their
+  // context slots, otherwise they all use the single context of the executor.
+  std::unique_ptr<KvCacheBlockAllocator> kv_cache_block_allocator;
+  auto* paged_executor =
+      GetExecutorExtension<PagedKvCacheLlmExecutor>(*executor);
+  if (paged_executor != nullptr && batching_scheduler != nullptr) {
+    ASSIGN_OR_RETURN(kv_cache_block_allocator,
+                     KvCacheBlockAllocator::Create(
+                         paged_executor->GetNumKvCacheBlocks(),
+                         paged_executor->GetKvCacheBlockSize()));
+    ABSL_LOG(INFO) << "Paged kv-cache is enabled with "
+                   << kv_cache_block_allocator->GetNumBlocks()
+                   << " blocks of "
+                   << kv_cache_block_allocator->GetBlockSize() << " tokens.";
+  }
+
+  std::unique_ptr<TokenIdCache> token_id_cache;
+  if (engine_settings.GetTokenIdCacheMaxNumEntries() > 0) {
+    token_id_cache = std::make_unique<TokenIdCache>(
+        engine_settings.GetTokenIdCacheMaxNumEntries());
+  }
+
+  // The table is kept next to the compiled model, so that it is built once
+  // per model rather than on every engine creation.
+  std::unique_ptr<TokenTextTable> token_text_table;
+  if (absl::StatusOr<int> vocab_size = executor->GetVocabSize();
+      vocab_size.ok()) {
+    const std::string& model_cache_dir =
+        engine_settings.GetMainExecutorSettings().GetCacheDir();
+    absl::StatusOr<std::unique_ptr<TokenTextTable>> table =
+        TokenTextTable::LoadOrBuild(
+            *tokenizer, *vocab_size,
+            model_cache_dir.empty()
+                ? ""
+                : (std::filesystem::path(model_cache_dir) /
+                   "token_text_table.bin")
+                      .string());
+    if (table.ok()) {
+      token_text_table = *std::move(table);
+    } else {
+      ABSL_LOG(WARNING) << "Decoding without a token text table: "
+                        << table.status();
+    }
+  }
+
+  std::unique_ptr<EmbeddingCache> embedding_cache;
+  if (engine_settings.GetEmbeddingCacheMaxSizeBytes() > 0) {
+    ASSIGN_OR_RETURN(embedding_cache,
+                     EmbeddingCache::Create(
+                         engine_settings.GetEmbeddingCacheMaxSizeBytes()));
+  }
+
+  std::unique_ptr<LoraRegistry> lora_registry;
+  if (auto* lora_executor = GetExecutorExtension<LoraLlmExecutor>(*executor);
+      lora_executor != nullptr) {
+    ASSIGN_OR_RETURN(lora_registry,
+                     LoraRegistry::Create(
+                         lora_executor,
+                         engine_settings.GetLoraAdaptersMaxSizeBytes()));
+  }
+
+  memory_recorder.EndPhase("Caches");
+
+  // Under memory pressure, the kv-cache snapshots go first, as the largest
+  // entries, and the executors last, as the slowest to create again. The
+  // engine owns the shed resources, which outlive the governor.
+  std::vector<MemoryGovernor::Action> shedding_actions;
+  if (prefix_kv_cache != nullptr) {
+    shedding_actions.push_back(
+        [cache = prefix_kv_cache.get()](MemorySheddingStats& stats) {
+          stats.prefix_cache_bytes_dropped += cache->Clear();
+        });
+  }
+  if (embedding_cache != nullptr) {
+    shedding_actions.push_back(
+        [cache = embedding_cache.get()](MemorySheddingStats& stats) {
+          stats.embedding_cache_bytes_dropped += cache->Clear();
+        });
+  }
+  if (token_id_cache != nullptr) {
+    shedding_actions.push_back(
+        [cache = token_id_cache.get()](MemorySheddingStats& stats) {
+          stats.num_token_id_cache_entries_dropped += cache->Clear();
+        });
+  }
+  if (lazy_vision_executor != nullptr) {
+    shedding_actions.push_back(
+        [executor = lazy_vision_executor.get()](MemorySheddingStats& stats) {
+          stats.num_executors_evicted += executor->EvictIfUnused() ? 1 : 0;
+        });
+  }
+  if (lazy_audio_executor != nullptr) {
+    shedding_actions.push_back(
+        [executor = lazy_audio_executor.get()](MemorySheddingStats& stats) {
+          stats.num_executors_evicted += executor->EvictIfUnused() ? 1 : 0;
+        });
+  }
+  ASSIGN_OR_RETURN(auto memory_governor,
+                   MemoryGovernor::Create(
+                       std::move(shedding_actions),
+                       engine_settings.GetMaxResidentMemoryBytes()));
+
   auto worker_thread_pool =
       std::make_unique<ThreadPool>(/*name_prefix=*/"engine",
-                                   /*max_num_threads=*/1);
+                                   /*max_num_threads=*/num_worker_threads);
   auto llm_impl = std::make_unique<EngineImpl>(
       std::move(engine_settings), std::move(model_resources),
       std::move(executor), std::move(vision_executor),
-      std::move(audio_executor), std::move(benchmark_info),
-      std::move(worker_thread_pool));
+      std::move(audio_executor), std::move(lazy_vision_executor),
+      std::move(lazy_audio_executor), std::move(draft_model_resources),
+      std::move(draft_executor), std::move(benchmark_info),
+      std::move(batching_scheduler), std::move(resident_context_pool),
+      std::move(prefix_kv_cache),
+      std::move(kv_cache_block_allocator), std::move(token_id_cache),
+      std::move(token_text_table), std::move(embedding_cache),
+      std::move(lora_registry), std::move(thread_affinity),
+      std::move(worker_thread_pool),
+      std::move(memory_governor), std::move(memory_recorder).GetPhases(),
+      kv_cache_bytes);
 
   return llm_impl;
 };
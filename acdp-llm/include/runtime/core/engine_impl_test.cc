@@ -89,6 +89,105 @@ TEST(EngineTest, CreateEngine_WithoutCache) {
   EXPECT_FALSE(responses->GetTexts()[0].empty());
 }
 
+TEST(EngineTest, CreateEngine_WithWarmUp) {
+  auto task_path =
+      std::filesystem::path(::testing::SrcDir()) /
+      "litert_lm/runtime/testdata/test_lm_new_metadata.task";
+  auto model_assets = ModelAssets::Create(task_path.string());
+  ASSERT_OK(model_assets);
+  auto engine_settings =
+      EngineSettings::CreateDefault(*model_assets, Backend::CPU);
+  ASSERT_OK(engine_settings);
+  engine_settings->GetMutableMainExecutorSettings().SetMaxNumTokens(
+      kMaxNumTokens);
+  engine_settings->GetMutableMainExecutorSettings().SetCacheDir(":nocache");
+  engine_settings->SetNumWarmUpDecodeSteps(2);
+
+  absl::StatusOr<std::unique_ptr<Engine>> llm =
+      Engine::CreateEngine(*engine_settings, "Hello world!");
+  ABSL_CHECK_OK(llm);
+
+  // The warm-up leaves the executor reset for the first session.
+  absl::StatusOr<std::unique_ptr<Engine::Session>> session =
+      (*llm)->CreateSession(SessionConfig::CreateDefault());
+  ABSL_CHECK_OK(session);
+
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText("Hello world!"));
+  ABSL_CHECK_OK((*session)->RunPrefill(inputs));
+
+  auto responses = (*session)->RunDecode();
+  EXPECT_OK(responses);
+  EXPECT_EQ(responses->GetTexts().size(), 1);
+  EXPECT_FALSE(responses->GetTexts()[0].empty());
+}
+
+TEST(EngineTest, CreateEngine_ReportsMemoryUsage) {
+  auto task_path =
+      std::filesystem::path(::testing::SrcDir()) /
+      "litert_lm/runtime/testdata/test_lm_new_metadata.task";
+  auto model_assets = ModelAssets::Create(task_path.string());
+  ASSERT_OK(model_assets);
+  auto engine_settings =
+      EngineSettings::CreateDefault(*model_assets, Backend::CPU);
+  ASSERT_OK(engine_settings);
+  engine_settings->GetMutableMainExecutorSettings().SetMaxNumTokens(
+      kMaxNumTokens);
+  engine_settings->GetMutableMainExecutorSettings().SetCacheDir(":nocache");
+
+  ASSERT_OK_AND_ASSIGN(auto llm, Engine::CreateEngine(*engine_settings));
+  ASSERT_OK_AND_ASSIGN(auto session,
+                       llm->CreateSession(SessionConfig::CreateDefault()));
+
+  ASSERT_OK_AND_ASSIGN(EngineMemoryUsage usage, llm->GetMemoryUsage());
+  EXPECT_EQ(usage.num_sessions, 1);
+  EXPECT_FALSE(usage.vision_executor_loaded);
+  EXPECT_FALSE(usage.audio_executor_loaded);
+#if defined(__linux__)
+  EXPECT_GT(usage.resident_bytes, 0);
+  ASSERT_FALSE(usage.creation_phases.empty());
+  EXPECT_EQ(usage.creation_phases.front().name, "Model mapping");
+  EXPECT_EQ(usage.creation_phases.back().name, "Caches");
+#endif  // defined(__linux__)
+
+  session.reset();
+  ASSERT_OK_AND_ASSIGN(usage, llm->GetMemoryUsage());
+  EXPECT_EQ(usage.num_sessions, 0);
+}
+
+TEST(EngineTest, CreateEngine_ReportsMetrics) {
+  auto task_path =
+      std::filesystem::path(::testing::SrcDir()) /
+      "litert_lm/runtime/testdata/test_lm_new_metadata.task";
+  auto model_assets = ModelAssets::Create(task_path.string());
+  ASSERT_OK(model_assets);
+  auto engine_settings =
+      EngineSettings::CreateDefault(*model_assets, Backend::CPU);
+  ASSERT_OK(engine_settings);
+  engine_settings->GetMutableMainExecutorSettings().SetMaxNumTokens(
+      kMaxNumTokens);
+  engine_settings->GetMutableMainExecutorSettings().SetCacheDir(":nocache");
+
+  ASSERT_OK_AND_ASSIGN(auto llm, Engine::CreateEngine(*engine_settings));
+  ASSERT_OK_AND_ASSIGN(auto session,
+                       llm->CreateSession(SessionConfig::CreateDefault()));
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText("Hello world!"));
+  ASSERT_OK(session->RunPrefill(inputs));
+  ASSERT_OK(session->RunDecode());
+
+  ASSERT_OK_AND_ASSIGN(EngineMetrics metrics, llm->GetMetrics());
+  EXPECT_EQ(metrics.num_sessions, 1);
+  EXPECT_EQ(metrics.num_queued_tasks, 0);
+  EXPECT_GT(metrics.num_prefilled_tokens, 0);
+  EXPECT_GT(metrics.num_decode_steps, 0);
+  EXPECT_EQ(metrics.num_cancellations, 0);
+
+  session->CancelProcess();
+  ASSERT_OK_AND_ASSIGN(metrics, llm->GetMetrics());
+  EXPECT_EQ(metrics.num_cancellations, 1);
+}
+
 TEST(EngineTest, CreateEngine_WithCache) {
   auto cache_path = std::filesystem::path(::testing::TempDir()) /
                     absl::StrCat("cache-", std::rand());
@@ -38,6 +38,7 @@
 #include "runtime/components/tokenizer.h"
 #include "runtime/core/session_factory.h"
 #include "runtime/engine/engine.h"
+#include "runtime/engine/engine_creation.h"
 #include "runtime/engine/engine_settings.h"
 #include "runtime/engine/io_types.h"
 #include "runtime/executor/audio_executor.h"
@@ -138,6 +139,8 @@ class EngineImpl : public Engine {
       std::optional<BenchmarkInfo> benchmark_info,
       std::unique_ptr<ThreadPool> worker_thread_pool)
       : engine_settings_(std::move(engine_settings)),
+        session_config_defaults_(
+            SessionConfigDefaults::Create(engine_settings_)),
         model_resources_(std::move(model_resources)),
         executor_(std::move(executor)),
         task_tokenizer_(std::move(task_tokenizer)),
@@ -152,7 +155,7 @@ class EngineImpl : public Engine {
   absl::StatusOr<std::unique_ptr<Session>> CreateSession(
       const SessionConfig& session_config) const override {
     auto config = session_config;
-    RETURN_IF_ERROR(config.MaybeUpdateAndValidate(engine_settings_));
+    RETURN_IF_ERROR(config.MaybeUpdateAndValidate(*session_config_defaults_));
     // For the TfLite executors, we use the built-in sampling logic instead of
     // the sampler component. Setting the type to unspecified to disable the
     // sampler component.
@@ -172,9 +175,15 @@ class EngineImpl : public Engine {
     return engine_settings_;
   }
 
+  absl::StatusOr<Tokenizer*> GetTokenizer() const override {
+    return tokenizer_;
+  }
+
  private:
   // Stored engine settings.
   EngineSettings engine_settings_;
+  // The defaults of the session configs, read from `engine_settings_` once.
+  std::shared_ptr<const SessionConfigDefaults> session_config_defaults_;
 
   // Model resources, which must outlive `executor_`.
   std::unique_ptr<oi::ExecutorModelResources> model_resources_;
@@ -210,7 +219,18 @@ class EngineImpl : public Engine {
 // Method to create Engine.
 absl::StatusOr<std::unique_ptr<Engine>> Engine::CreateEngine(
     EngineSettings engine_settings, absl::string_view input_prompt_as_hint) {
+  return CreateEngine(std::move(engine_settings), input_prompt_as_hint,
+                      /*progress=*/nullptr);
+}
+
+absl::StatusOr<std::unique_ptr<Engine>> Engine::CreateEngine(
+    EngineSettings engine_settings, absl::string_view input_prompt_as_hint,
+    EngineCreationProgress* progress) {
   ABSL_LOG(INFO) << "Constructing legacy EngineImpl...";
+  auto complete_phase = [progress](EngineCreationPhase phase) {
+    return progress == nullptr ? absl::OkStatus()
+                               : progress->CompletePhase(phase);
+  };
   std::optional<BenchmarkInfo> benchmark_info;
   if (engine_settings.IsBenchmarkEnabled()) {
     benchmark_info = std::make_optional<BenchmarkInfo>(
@@ -225,6 +245,7 @@ absl::StatusOr<std::unique_ptr<Engine>> Engine::CreateEngine(
   ASSIGN_OR_RETURN(
       auto model_resources,
       oi::BuildModelResources(/*model_path=*/"", scoped_model_file));
+  RETURN_IF_ERROR(complete_phase(EngineCreationPhase::kModelMapping));
 
   proto::LlmMetadata llm_metadata;
   std::unique_ptr<Tokenizer> task_tokenizer;
@@ -261,9 +282,11 @@ absl::StatusOr<std::unique_ptr<Engine>> Engine::CreateEngine(
   // to ids.
   RETURN_IF_ERROR(engine_settings.MaybeUpdateAndValidate(
       *tokenizer, &llm_metadata, input_prompt_as_hint));
+  RETURN_IF_ERROR(complete_phase(EngineCreationPhase::kTokenizer));
 
   ASSIGN_OR_RETURN(auto executor,
                    BuildExecutor(*model_resources, engine_settings));
+  RETURN_IF_ERROR(complete_phase(EngineCreationPhase::kMainExecutor));
 
   ASSIGN_OR_RETURN(auto& lrt_env, GetEnvironment());
 
@@ -278,6 +301,7 @@ absl::StatusOr<std::unique_ptr<Engine>> Engine::CreateEngine(
             /*adapter_backend=*/Backend::CPU));
     ASSIGN_OR_RETURN(vision_executor, VisionLiteRtCompiledModelExecutor::Create(
                                           vision_executor_settings, lrt_env));
+    RETURN_IF_ERROR(complete_phase(EngineCreationPhase::kVisionExecutor));
   }
 
   std::unique_ptr<AudioExecutor> audio_executor;
@@ -291,6 +315,7 @@ absl::StatusOr<std::unique_ptr<Engine>> Engine::CreateEngine(
 
     ASSIGN_OR_RETURN(audio_executor, AudioLiteRtCompiledModelExecutor::Create(
                                          audio_executor_settings, lrt_env));
+    RETURN_IF_ERROR(complete_phase(EngineCreationPhase::kAudioExecutor));
   }
 
   if (benchmark_info.has_value()) {
@@ -0,0 +1,301 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/image_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LITERT_LM_IMAGE_KERNELS_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define LITERT_LM_IMAGE_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace litert::lm {
+namespace {
+
+constexpr int kDstChannels = 3;
+
+void ScalarWeightedSumRows(const uint8_t* const* rows, const float* weights,
+                           int num_rows, int size, float* out) {
+  for (int i = 0; i < size; ++i) {
+    float sum = 0.0f;
+    for (int k = 0; k < num_rows; ++k) {
+      sum += weights[k] * rows[k][i];
+    }
+    out[i] = sum;
+  }
+}
+
+constexpr ImageKernels::Primitives kScalarPrimitives = {
+    &ScalarWeightedSumRows};
+
+#if defined(LITERT_LM_IMAGE_KERNELS_X86)
+
+#define LITERT_LM_TARGET_AVX2 __attribute__((target("avx2,fma")))
+
+LITERT_LM_TARGET_AVX2 void Avx2WeightedSumRows(const uint8_t* const* rows,
+                                               const float* weights,
+                                               int num_rows, int size,
+                                               float* out) {
+  int i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m256 sum = _mm256_setzero_ps();
+    for (int k = 0; k < num_rows; ++k) {
+      const __m256 pixels = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(rows[k] + i))));
+      sum = _mm256_fmadd_ps(_mm256_set1_ps(weights[k]), pixels, sum);
+    }
+    _mm256_storeu_ps(out + i, sum);
+  }
+  for (; i < size; ++i) {
+    float sum = 0.0f;
+    for (int k = 0; k < num_rows; ++k) {
+      sum += weights[k] * rows[k][i];
+    }
+    out[i] = sum;
+  }
+}
+
+constexpr ImageKernels::Primitives kAvx2Primitives = {&Avx2WeightedSumRows};
+
+#endif
+
+#if defined(LITERT_LM_IMAGE_KERNELS_NEON)
+
+void NeonWeightedSumRows(const uint8_t* const* rows, const float* weights,
+                         int num_rows, int size, float* out) {
+  int i = 0;
+  for (; i + 8 <= size; i += 8) {
+    float32x4_t sum_lo = vdupq_n_f32(0.0f);
+    float32x4_t sum_hi = vdupq_n_f32(0.0f);
+    for (int k = 0; k < num_rows; ++k) {
+      const uint16x8_t pixels = vmovl_u8(vld1_u8(rows[k] + i));
+      sum_lo = vmlaq_n_f32(
+          sum_lo, vcvtq_f32_u32(vmovl_u16(vget_low_u16(pixels))), weights[k]);
+      sum_hi = vmlaq_n_f32(
+          sum_hi, vcvtq_f32_u32(vmovl_u16(vget_high_u16(pixels))),
+          weights[k]);
+    }
+    vst1q_f32(out + i, sum_lo);
+    vst1q_f32(out + i + 4, sum_hi);
+  }
+  ScalarWeightedSumRows(rows, weights, num_rows, size - i, out + i);
+}
+
+constexpr ImageKernels::Primitives kNeonPrimitives = {&NeonWeightedSumRows};
+
+#endif
+
+bool IsSupported(ImageKernelIsa isa) {
+  switch (isa) {
+    case ImageKernelIsa::kScalar:
+      return true;
+    case ImageKernelIsa::kNeon:
+#if defined(LITERT_LM_IMAGE_KERNELS_NEON)
+      return true;
+#else
+      return false;
+#endif
+    case ImageKernelIsa::kAvx2:
+#if defined(LITERT_LM_IMAGE_KERNELS_X86)
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+// The source pixels an output pixel is resampled from along one axis: the
+// `weights.size()` pixels from `first`.
+struct ResampleTaps {
+  int first = 0;
+  std::vector<float> weights;
+};
+
+// Returns the taps of the `dst_size` output pixels of a linear resampling of
+// `src_size` pixels, scaled by `scale`. The pixels past the edges repeat the
+// edge pixels.
+std::vector<ResampleTaps> ComputeResampleTaps(int src_size, int dst_size,
+                                              float scale) {
+  const float ratio = static_cast<float>(src_size) / dst_size;
+  // The triangle filter is widened to the ratio when downscaling, so that it
+  // averages all the source pixels instead of skipping some.
+  const float radius = std::max(ratio, 1.0f);
+  std::vector<ResampleTaps> all_taps(dst_size);
+  for (int i = 0; i < dst_size; ++i) {
+    const float center = (i + 0.5f) * ratio - 0.5f;
+    const int begin = static_cast<int>(std::floor(center - radius)) + 1;
+    const int end = static_cast<int>(std::ceil(center + radius)) - 1;
+    ResampleTaps& taps = all_taps[i];
+    taps.first = std::clamp(begin, 0, src_size - 1);
+    float total_weight = 0.0f;
+    for (int j = begin; j <= end; ++j) {
+      const float weight = 1.0f - std::abs(j - center) / radius;
+      if (weight <= 0.0f) {
+        continue;
+      }
+      // The clamped indices are non-decreasing, so that the taps stay
+      // contiguous.
+      const size_t tap = std::clamp(j, 0, src_size - 1) - taps.first;
+      if (tap >= taps.weights.size()) {
+        taps.weights.resize(tap + 1, 0.0f);
+      }
+      taps.weights[tap] += weight;
+      total_weight += weight;
+    }
+    for (float& weight : taps.weights) {
+      weight *= scale / total_weight;
+    }
+  }
+  return all_taps;
+}
+
+}  // namespace
+
+std::ostream& operator<<(std::ostream& os, ImageKernelIsa isa) {
+  switch (isa) {
+    case ImageKernelIsa::kScalar:
+      return os << "SCALAR";
+    case ImageKernelIsa::kNeon:
+      return os << "NEON";
+    case ImageKernelIsa::kAvx2:
+      return os << "AVX2";
+  }
+  return os << "UNKNOWN";
+}
+
+// static
+const ImageKernels* ImageKernels::GetForIsa(ImageKernelIsa isa) {
+  if (!IsSupported(isa)) {
+    return nullptr;
+  }
+  switch (isa) {
+    case ImageKernelIsa::kScalar: {
+      static const ImageKernels* const kernels =
+          new ImageKernels(isa, kScalarPrimitives);
+      return kernels;
+    }
+#if defined(LITERT_LM_IMAGE_KERNELS_NEON)
+    case ImageKernelIsa::kNeon: {
+      static const ImageKernels* const kernels =
+          new ImageKernels(isa, kNeonPrimitives);
+      return kernels;
+    }
+#endif
+#if defined(LITERT_LM_IMAGE_KERNELS_X86)
+    case ImageKernelIsa::kAvx2: {
+      static const ImageKernels* const kernels =
+          new ImageKernels(isa, kAvx2Primitives);
+      return kernels;
+    }
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+// static
+const ImageKernels& ImageKernels::Get() {
+  static const ImageKernels* const kernels = []() {
+    for (const ImageKernelIsa isa :
+         {ImageKernelIsa::kAvx2, ImageKernelIsa::kNeon}) {
+      if (const ImageKernels* kernels = GetForIsa(isa); kernels != nullptr) {
+        return kernels;
+      }
+    }
+    return GetForIsa(ImageKernelIsa::kScalar);
+  }();
+  return *kernels;
+}
+
+absl::Status ImageKernels::ResizeAndNormalize(absl::Span<const uint8_t> src,
+                                              int src_height, int src_width,
+                                              int src_channels, int dst_height,
+                                              int dst_width,
+                                              absl::Span<float> dst) const {
+  if (src_height <= 0 || src_width <= 0 || dst_height <= 0 || dst_width <= 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Cannot resize an image of ", src_height, "x", src_width, " to ",
+        dst_height, "x", dst_width, "."));
+  }
+  if (src_channels < 1 || src_channels > 4) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Unsupported number of image channels: ", src_channels, "."));
+  }
+  const size_t src_row_size = static_cast<size_t>(src_width) * src_channels;
+  if (src.size() != src_row_size * src_height) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The image of size ", src.size(), " does not match ",
+                     src_height, "x", src_width, "x", src_channels, "."));
+  }
+  if (dst.size() != static_cast<size_t>(dst_height) * dst_width *
+                        kDstChannels) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "The output of size ", dst.size(), " does not match ", dst_height,
+        "x", dst_width, "x", kDstChannels, "."));
+  }
+
+  // The normalization to [0, 1] is folded into the vertical weights.
+  const std::vector<ResampleTaps> vertical_taps =
+      ComputeResampleTaps(src_height, dst_height, /*scale=*/1.0f / 255.0f);
+  const std::vector<ResampleTaps> horizontal_taps =
+      ComputeResampleTaps(src_width, dst_width, /*scale=*/1.0f);
+  // The source channel of each output channel.
+  int channel_map[kDstChannels] = {0, 0, 0};
+  if (src_channels >= kDstChannels) {
+    channel_map[1] = 1;
+    channel_map[2] = 2;
+  }
+
+  // The rows are resampled vertically first, which is vectorized over the
+  // whole source row, then horizontally, over the fewer output pixels.
+  std::vector<float> row(src_row_size);
+  std::vector<const uint8_t*> src_rows;
+  float* out = dst.data();
+  for (const ResampleTaps& taps : vertical_taps) {
+    src_rows.clear();
+    for (int k = 0; k < taps.weights.size(); ++k) {
+      src_rows.push_back(src.data() + (taps.first + k) * src_row_size);
+    }
+    primitives_.weighted_sum_rows(src_rows.data(), taps.weights.data(),
+                                  src_rows.size(), src_row_size, row.data());
+    for (const ResampleTaps& pixel_taps : horizontal_taps) {
+      const float* pixels = row.data() + pixel_taps.first * src_channels;
+      for (int c = 0; c < kDstChannels; ++c) {
+        float sum = 0.0f;
+        for (int k = 0; k < pixel_taps.weights.size(); ++k) {
+          sum += pixel_taps.weights[k] *
+                 pixels[k * src_channels + channel_map[c]];
+        }
+        *out++ = sum;
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,82 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_IMAGE_KERNELS_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_IMAGE_KERNELS_H_
+
+#include <cstdint>
+#include <ostream>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// The instruction sets the image kernels are vectorized for.
+enum class ImageKernelIsa {
+  kScalar,
+  kNeon,
+  kAvx2,
+};
+std::ostream& operator<<(std::ostream& os, ImageKernelIsa isa);
+
+// Vectorized CPU kernels turning decoded images into the float tensors of the
+// vision encoders. As with LogitsKernels, the instruction set is picked at
+// runtime among the ones supported by the CPU.
+//
+// Example usage:
+//   std::vector<float> pixels(768 * 768 * 3);
+//   RETURN_IF_ERROR(ImageKernels::Get().ResizeAndNormalize(
+//       image, height, width, channels, 768, 768, absl::MakeSpan(pixels)));
+class ImageKernels {
+ public:
+  // Returns the kernels of the best instruction set supported by the CPU.
+  static const ImageKernels& Get();
+
+  // Returns the kernels of `isa`, or nullptr if the CPU or the build does not
+  // support it.
+  static const ImageKernels* GetForIsa(ImageKernelIsa isa);
+
+  ImageKernelIsa GetIsa() const { return isa_; }
+
+  // Resizes the interleaved 8-bit image `src` of [src_height, src_width,
+  // src_channels] to the RGB floats in [0, 1] `dst` of [dst_height,
+  // dst_width, 3]. The images of 1 or 2 channels are gray, the alpha channel
+  // is dropped. The resampling is linear, with a filter widened when
+  // downscaling, so that every source pixel contributes.
+  absl::Status ResizeAndNormalize(absl::Span<const uint8_t> src,
+                                  int src_height, int src_width,
+                                  int src_channels, int dst_height,
+                                  int dst_width, absl::Span<float> dst) const;
+
+  // The primitives the kernels are built on, one implementation per
+  // instruction set.
+  struct Primitives {
+    // Sets out[i] to the sum of weights[k] * rows[k][i] over the `num_rows`
+    // rows, for i in [0, size).
+    void (*weighted_sum_rows)(const uint8_t* const* rows, const float* weights,
+                              int num_rows, int size, float* out);
+  };
+
+ private:
+  ImageKernels(ImageKernelIsa isa, const Primitives& primitives)
+      : isa_(isa), primitives_(primitives) {}
+
+  const ImageKernelIsa isa_;
+  const Primitives primitives_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_IMAGE_KERNELS_H_
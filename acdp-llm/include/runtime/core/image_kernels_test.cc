@@ -0,0 +1,167 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/image_kernels.h"
+
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::FloatNear;
+using ::testing::status::StatusIs;
+
+std::vector<uint8_t> RandomImage(int size, int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::vector<uint8_t> image(size);
+  for (uint8_t& pixel : image) {
+    pixel = distribution(generator);
+  }
+  return image;
+}
+
+class ImageKernelsTest : public testing::TestWithParam<ImageKernelIsa> {
+ protected:
+  void SetUp() override {
+    kernels_ = ImageKernels::GetForIsa(GetParam());
+    if (kernels_ == nullptr) {
+      GTEST_SKIP() << GetParam() << " is not supported.";
+    }
+  }
+
+  const ImageKernels* kernels_ = nullptr;
+};
+
+TEST_P(ImageKernelsTest, KeepsThePixelsOfTheSameSize) {
+  const std::vector<uint8_t> image = {0, 51, 102, 153, 204, 255};
+  std::vector<float> pixels(6);
+  ASSERT_OK(kernels_->ResizeAndNormalize(image, /*src_height=*/1,
+                                         /*src_width=*/2, /*src_channels=*/3,
+                                         /*dst_height=*/1, /*dst_width=*/2,
+                                         absl::MakeSpan(pixels)));
+  EXPECT_THAT(pixels,
+              ElementsAre(FloatNear(0.0f, 1e-6), FloatNear(0.2f, 1e-6),
+                          FloatNear(0.4f, 1e-6), FloatNear(0.6f, 1e-6),
+                          FloatNear(0.8f, 1e-6), FloatNear(1.0f, 1e-6)));
+}
+
+TEST_P(ImageKernelsTest, AveragesThePixelsWhenDownscaling) {
+  // A 2x2 gray image to a single RGB pixel.
+  const std::vector<uint8_t> image = {0, 255, 255, 0};
+  std::vector<float> pixels(3);
+  ASSERT_OK(kernels_->ResizeAndNormalize(image, /*src_height=*/2,
+                                         /*src_width=*/2, /*src_channels=*/1,
+                                         /*dst_height=*/1, /*dst_width=*/1,
+                                         absl::MakeSpan(pixels)));
+  EXPECT_THAT(pixels,
+              ElementsAre(FloatNear(0.5f, 1e-6), FloatNear(0.5f, 1e-6),
+                          FloatNear(0.5f, 1e-6)));
+}
+
+TEST_P(ImageKernelsTest, InterpolatesWhenUpscaling) {
+  const std::vector<uint8_t> image = {0, 0, 0, 255, 255, 255};
+  std::vector<float> pixels(4 * 3);
+  ASSERT_OK(kernels_->ResizeAndNormalize(image, /*src_height=*/1,
+                                         /*src_width=*/2, /*src_channels=*/3,
+                                         /*dst_height=*/1, /*dst_width=*/4,
+                                         absl::MakeSpan(pixels)));
+  for (int c = 0; c < 3; ++c) {
+    EXPECT_NEAR(pixels[c], 0.0f, 1e-6);
+    EXPECT_NEAR(pixels[3 + c], 0.25f, 1e-6);
+    EXPECT_NEAR(pixels[6 + c], 0.75f, 1e-6);
+    EXPECT_NEAR(pixels[9 + c], 1.0f, 1e-6);
+  }
+}
+
+TEST_P(ImageKernelsTest, DropsTheAlphaChannel) {
+  const std::vector<uint8_t> image = {255, 0, 51, 7};
+  std::vector<float> pixels(3);
+  ASSERT_OK(kernels_->ResizeAndNormalize(image, /*src_height=*/1,
+                                         /*src_width=*/1, /*src_channels=*/4,
+                                         /*dst_height=*/1, /*dst_width=*/1,
+                                         absl::MakeSpan(pixels)));
+  EXPECT_THAT(pixels,
+              ElementsAre(FloatNear(1.0f, 1e-6), FloatNear(0.0f, 1e-6),
+                          FloatNear(0.2f, 1e-6)));
+}
+
+TEST_P(ImageKernelsTest, MatchesTheScalarKernels) {
+  const ImageKernels* scalar_kernels =
+      ImageKernels::GetForIsa(ImageKernelIsa::kScalar);
+  // Covers the vector bodies and the scalar tails.
+  for (const int src_size : {5, 37, 300}) {
+    for (const int dst_size : {3, 64}) {
+      const std::vector<uint8_t> image =
+          RandomImage(src_size * src_size * 3, src_size);
+      std::vector<float> pixels(dst_size * dst_size * 3);
+      std::vector<float> expected_pixels(pixels.size());
+      ASSERT_OK(kernels_->ResizeAndNormalize(image, src_size, src_size, 3,
+                                             dst_size, dst_size,
+                                             absl::MakeSpan(pixels)));
+      ASSERT_OK(scalar_kernels->ResizeAndNormalize(
+          image, src_size, src_size, 3, dst_size, dst_size,
+          absl::MakeSpan(expected_pixels)));
+      for (int i = 0; i < pixels.size(); ++i) {
+        ASSERT_NEAR(pixels[i], expected_pixels[i], 1e-5)
+            << absl::StrCat("src_size=", src_size, " dst_size=", dst_size,
+                            " i=", i);
+      }
+    }
+  }
+}
+
+TEST_P(ImageKernelsTest, FailsOnMismatchedSizes) {
+  const std::vector<uint8_t> image(2 * 2 * 3);
+  std::vector<float> pixels(3);
+  EXPECT_THAT(kernels_->ResizeAndNormalize(image, 2, 3, 3, 1, 1,
+                                           absl::MakeSpan(pixels)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(kernels_->ResizeAndNormalize(image, 2, 2, 3, 1, 2,
+                                           absl::MakeSpan(pixels)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(kernels_->ResizeAndNormalize(image, 2, 2, 3, 0, 1,
+                                           absl::MakeSpan(pixels)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ImageKernelsTest, ImageKernelsTest,
+    testing::Values(ImageKernelIsa::kScalar, ImageKernelIsa::kNeon,
+                    ImageKernelIsa::kAvx2),
+    [](const testing::TestParamInfo<ImageKernelIsa>& info) {
+      std::stringstream name;
+      name << info.param;
+      return name.str();
+    });
+
+TEST(ImageKernelsDispatchTest, PicksASupportedIsa) {
+  const ImageKernels& kernels = ImageKernels::Get();
+  EXPECT_EQ(ImageKernels::GetForIsa(kernels.GetIsa()), &kernels);
+  EXPECT_NE(ImageKernels::GetForIsa(ImageKernelIsa::kScalar), nullptr);
+}
+
+}  // namespace
+}  // namespace litert::lm
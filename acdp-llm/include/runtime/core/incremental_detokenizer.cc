@@ -0,0 +1,140 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/incremental_detokenizer.h"
+
+#include <cstdint>
+#include <string>
+
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/core/token_text_table.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+// The progress of a sequence of byte-fallback tokens towards a UTF-8
+// character.
+enum class ByteSequence { kIncomplete, kComplete, kInvalid };
+
+// Appends the character of `token_ids` to `output` if they are the complete
+// byte-fallback tokens of a UTF-8 character.
+ByteSequence AssembleBytes(const TokenTextTable& table,
+                           absl::Span<const int> token_ids,
+                           std::string& output) {
+  char bytes[IncrementalDetokenizer::kMaxPendingTokens];
+  for (int i = 0; i < token_ids.size(); ++i) {
+    if (table.GetKind(token_ids[i]) != TokenTextTable::Kind::kByte) {
+      return ByteSequence::kInvalid;
+    }
+    bytes[i] = table.GetText(token_ids[i])[0];
+    if (i > 0 && (bytes[i] & 0xC0) != 0x80) {
+      return ByteSequence::kInvalid;
+    }
+  }
+  const uint8_t lead = bytes[0];
+  const int length = lead < 0x80                ? 1
+                     : (lead & 0xE0) == 0xC0 ? 2
+                     : (lead & 0xF0) == 0xE0 ? 3
+                     : (lead & 0xF8) == 0xF0 ? 4
+                                             : 0;
+  if (length == 0 || token_ids.size() > length) {
+    return ByteSequence::kInvalid;
+  }
+  if (token_ids.size() < length) {
+    return ByteSequence::kIncomplete;
+  }
+  output.append(bytes, length);
+  return ByteSequence::kComplete;
+}
+
+}  // namespace
+
+IncrementalDetokenizer::IncrementalDetokenizer(
+    Tokenizer* tokenizer, int num_output_candidates,
+    const TokenTextTable* token_text_table)
+    : tokenizer_(*tokenizer),
+      token_text_table_(token_text_table),
+      pending_token_ids_(num_output_candidates * kMaxPendingTokens),
+      num_pending_tokens_(num_output_candidates),
+      texts_(num_output_candidates) {
+  sequence_.reserve(kMaxPendingTokens);
+}
+
+absl::Status IncrementalDetokenizer::Decode(absl::Span<const int> token_ids) {
+  if (token_ids.size() != texts_.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected one token for each of the ", texts_.size(),
+                     " candidates, got ", token_ids.size(), " tokens."));
+  }
+  for (int i = 0; i < texts_.size(); ++i) {
+    std::string& text = texts_[i];
+    int& num_pending = num_pending_tokens_[i];
+    text.clear();
+    if (num_pending == 0 && token_text_table_ != nullptr &&
+        token_text_table_->GetKind(token_ids[i]) ==
+            TokenTextTable::Kind::kText) {
+      const absl::string_view table_text =
+          token_text_table_->GetText(token_ids[i]);
+      text.append(table_text.data(), table_text.size());
+      continue;
+    }
+    if (num_pending == 0) {
+      const auto it = token_texts_.find(token_ids[i]);
+      if (it != token_texts_.end()) {
+        text.append(it->second);
+        continue;
+      }
+    }
+    if (num_pending == kMaxPendingTokens) {
+      ABSL_LOG(WARNING) << "Dropping an incomplete BPE sequence of "
+                        << num_pending << " tokens.";
+      num_pending = 0;
+    }
+    int* pending = &pending_token_ids_[i * kMaxPendingTokens];
+    pending[num_pending++] = token_ids[i];
+    if (token_text_table_ != nullptr) {
+      const ByteSequence byte_sequence = AssembleBytes(
+          *token_text_table_, absl::MakeConstSpan(pending, num_pending), text);
+      if (byte_sequence == ByteSequence::kIncomplete) {
+        continue;
+      }
+      if (byte_sequence == ByteSequence::kComplete) {
+        num_pending = 0;
+        continue;
+      }
+    }
+    sequence_.assign(pending, pending + num_pending);
+    absl::StatusOr<std::string> decoded =
+        tokenizer_.TokenIdsToText(sequence_);
+    if (Tokenizer::IsIncompleteBpeSequence(decoded)) {
+      continue;
+    }
+    RETURN_IF_ERROR(decoded.status());
+    AppendWithSpaces(*decoded, text);
+    if (num_pending == 1) {
+      token_texts_.emplace(token_ids[i], text);
+    }
+    num_pending = 0;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,96 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_INCREMENTAL_DETOKENIZER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_INCREMENTAL_DETOKENIZER_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/base/nullability.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/core/token_text_table.h"
+
+namespace litert::lm {
+
+// Turns the tokens decoded one step at a time into text deltas, one per output
+// candidate. The tokens of an incomplete BPE (or UTF-8) sequence are held back
+// until the sequence completes, and the SentencePiece "▁" meta symbol is
+// mapped to a space.
+//
+// The held back tokens of all the candidates share one flat buffer of
+// kMaxPendingTokens tokens per candidate, and the texts are kept in
+// per-candidate strings reused across the steps. The texts of the tokens
+// decoding on their own are looked up in the TokenTextTable of the tokenizer,
+// if provided, where the byte-fallback tokens are assembled into characters
+// too. Otherwise they are memoized. Either way, the common step neither calls
+// the tokenizer nor allocates.
+//
+// Example usage:
+//   IncrementalDetokenizer detokenizer(&tokenizer, num_output_candidates);
+//   // After each decode step:
+//   RETURN_IF_ERROR(detokenizer.Decode(next_token_ids));
+//   absl::string_view delta = detokenizer.GetDelta(candidate);
+class IncrementalDetokenizer {
+ public:
+  // The maximum number of tokens held back per candidate. A longer incomplete
+  // sequence can not be valid UTF-8, its tokens are dropped.
+  static constexpr int kMaxPendingTokens = 8;
+
+  // The tokenizer and the table, optional, must outlive the detokenizer.
+  IncrementalDetokenizer(Tokenizer* absl_nonnull tokenizer,
+                         int num_output_candidates,
+                         const TokenTextTable* token_text_table = nullptr);
+
+  IncrementalDetokenizer(const IncrementalDetokenizer&) = delete;
+  IncrementalDetokenizer& operator=(const IncrementalDetokenizer&) = delete;
+
+  // Decodes the next token of each candidate, `token_ids[i]` being the token
+  // of candidate i.
+  absl::Status Decode(absl::Span<const int> token_ids);
+
+  // Returns the text completed by the last Decode for the candidate, empty
+  // while its BPE sequence is incomplete. The view is valid until the next
+  // Decode.
+  absl::string_view GetDelta(int candidate) const { return texts_[candidate]; }
+
+  // Returns if the candidate has tokens held back for an incomplete BPE
+  // sequence.
+  bool HasPendingTokens(int candidate) const {
+    return num_pending_tokens_[candidate] > 0;
+  }
+
+ private:
+  Tokenizer& tokenizer_;
+  const TokenTextTable* token_text_table_;
+  // The tokens of the current BPE sequence of candidate i start at
+  // i * kMaxPendingTokens.
+  std::vector<int> pending_token_ids_;
+  std::vector<int> num_pending_tokens_;
+  // The text of the last completed sequence of each candidate.
+  std::vector<std::string> texts_;
+  // The sequence passed to the tokenizer, reused across the calls.
+  std::vector<int> sequence_;
+  // The texts of the single tokens decoded so far, with the meta symbols
+  // mapped. Bounded by the vocabulary size.
+  absl::flat_hash_map<int, std::string> token_texts_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_INCREMENTAL_DETOKENIZER_H_
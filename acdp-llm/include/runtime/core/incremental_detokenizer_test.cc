@@ -0,0 +1,165 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/incremental_detokenizer.h"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/core/token_text_table.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Return;
+using ::testing::status::StatusIs;
+
+class MockTokenizer : public Tokenizer {
+ public:
+  MOCK_METHOD(absl::StatusOr<std::vector<int>>, TextToTokenIds,
+              (absl::string_view text), (override));
+  MOCK_METHOD(absl::StatusOr<std::string>, TokenIdsToText,
+              (const std::vector<int>& token_ids), (override));
+  MOCK_METHOD(absl::StatusOr<int>, TokenToId, (absl::string_view token),
+              (override));
+  MOCK_METHOD(TokenizerType, GetTokenizerType, (), (const, override));
+};
+
+TEST(IncrementalDetokenizerTest, MapsTheMetaSymbolsToSpaces) {
+  MockTokenizer tokenizer;
+  EXPECT_CALL(tokenizer, TokenIdsToText(std::vector<int>{1}))
+      .WillOnce(Return("▁Hello"));
+  EXPECT_CALL(tokenizer, TokenIdsToText(std::vector<int>{2}))
+      .WillOnce(Return("▁big▁world"));
+  IncrementalDetokenizer detokenizer(&tokenizer, /*num_output_candidates=*/1);
+
+  EXPECT_OK(detokenizer.Decode({1}));
+  EXPECT_EQ(detokenizer.GetDelta(0), " Hello");
+  EXPECT_OK(detokenizer.Decode({2}));
+  EXPECT_EQ(detokenizer.GetDelta(0), " big world");
+}
+
+TEST(IncrementalDetokenizerTest, HoldsBackIncompleteSequences) {
+  MockTokenizer tokenizer;
+  EXPECT_CALL(tokenizer, TokenIdsToText(std::vector<int>{224}))
+      .WillOnce(Return(absl::DataLossError("Incomplete BPE sequence")));
+  EXPECT_CALL(tokenizer, TokenIdsToText(std::vector<int>{224, 24}))
+      .WillOnce(Return("é"));
+  EXPECT_CALL(tokenizer, TokenIdsToText(std::vector<int>{8}))
+      .WillOnce(Return("!"));
+  IncrementalDetokenizer detokenizer(&tokenizer, /*num_output_candidates=*/1);
+
+  EXPECT_OK(detokenizer.Decode({224}));
+  EXPECT_TRUE(detokenizer.HasPendingTokens(0));
+  EXPECT_EQ(detokenizer.GetDelta(0), "");
+  EXPECT_OK(detokenizer.Decode({24}));
+  EXPECT_FALSE(detokenizer.HasPendingTokens(0));
+  EXPECT_EQ(detokenizer.GetDelta(0), "é");
+  EXPECT_OK(detokenizer.Decode({8}));
+  EXPECT_EQ(detokenizer.GetDelta(0), "!");
+}
+
+TEST(IncrementalDetokenizerTest, DecodesTheCandidatesIndependently) {
+  MockTokenizer tokenizer;
+  EXPECT_CALL(tokenizer, TokenIdsToText(std::vector<int>{224}))
+      .WillOnce(Return(absl::DataLossError("Incomplete BPE sequence")));
+  EXPECT_CALL(tokenizer, TokenIdsToText(std::vector<int>{5}))
+      .WillOnce(Return("a"));
+  IncrementalDetokenizer detokenizer(&tokenizer, /*num_output_candidates=*/2);
+
+  EXPECT_OK(detokenizer.Decode({224, 5}));
+  EXPECT_TRUE(detokenizer.HasPendingTokens(0));
+  EXPECT_EQ(detokenizer.GetDelta(0), "");
+  EXPECT_FALSE(detokenizer.HasPendingTokens(1));
+  EXPECT_EQ(detokenizer.GetDelta(1), "a");
+}
+
+TEST(IncrementalDetokenizerTest, MemoizesTheTextsOfSingleTokens) {
+  MockTokenizer tokenizer;
+  EXPECT_CALL(tokenizer, TokenIdsToText(std::vector<int>{1}))
+      .WillOnce(Return("▁Hello"));
+  IncrementalDetokenizer detokenizer(&tokenizer, /*num_output_candidates=*/2);
+
+  EXPECT_OK(detokenizer.Decode({1, 1}));
+  EXPECT_EQ(detokenizer.GetDelta(0), " Hello");
+  EXPECT_EQ(detokenizer.GetDelta(1), " Hello");
+  EXPECT_OK(detokenizer.Decode({1, 1}));
+  EXPECT_EQ(detokenizer.GetDelta(0), " Hello");
+  EXPECT_EQ(detokenizer.GetDelta(1), " Hello");
+}
+
+TEST(IncrementalDetokenizerTest, DropsOverlongIncompleteSequences) {
+  MockTokenizer tokenizer;
+  EXPECT_CALL(tokenizer, TokenIdsToText)
+      .WillRepeatedly(Return(absl::DataLossError("Incomplete BPE sequence")));
+  IncrementalDetokenizer detokenizer(&tokenizer, /*num_output_candidates=*/1);
+
+  for (int i = 0; i <= IncrementalDetokenizer::kMaxPendingTokens; ++i) {
+    EXPECT_OK(detokenizer.Decode({224}));
+    EXPECT_TRUE(detokenizer.HasPendingTokens(0));
+    EXPECT_EQ(detokenizer.GetDelta(0), "");
+  }
+}
+
+TEST(IncrementalDetokenizerTest, LooksUpTheTokenTextTable) {
+  ::testing::StrictMock<MockTokenizer> tokenizer;
+  EXPECT_CALL(tokenizer, TokenToId)
+      .WillRepeatedly(Return(absl::NotFoundError("Unknown token")));
+  EXPECT_CALL(tokenizer, TokenToId(Eq("<0xC3>"))).WillRepeatedly(Return(1));
+  EXPECT_CALL(tokenizer, TokenToId(Eq("<0xA9>"))).WillRepeatedly(Return(2));
+  EXPECT_CALL(tokenizer, TokenIdsToText(std::vector<int>{0}))
+      .WillOnce(Return("▁Hello"));
+  EXPECT_CALL(tokenizer, TokenIdsToText(std::vector<int>{1}))
+      .WillOnce(Return(absl::DataLossError("Incomplete BPE sequence")));
+  EXPECT_CALL(tokenizer, TokenIdsToText(std::vector<int>{2}))
+      .WillOnce(Return(absl::DataLossError("Incomplete BPE sequence")));
+  ASSERT_OK_AND_ASSIGN(auto table,
+                       TokenTextTable::Build(tokenizer, /*num_tokens=*/3));
+  // The tokenizer is not called once the table is built.
+  ::testing::Mock::VerifyAndClearExpectations(&tokenizer);
+  IncrementalDetokenizer detokenizer(&tokenizer, /*num_output_candidates=*/1,
+                                     table.get());
+
+  EXPECT_OK(detokenizer.Decode({0}));
+  EXPECT_EQ(detokenizer.GetDelta(0), " Hello");
+  EXPECT_OK(detokenizer.Decode({1}));
+  EXPECT_TRUE(detokenizer.HasPendingTokens(0));
+  EXPECT_EQ(detokenizer.GetDelta(0), "");
+  EXPECT_OK(detokenizer.Decode({2}));
+  EXPECT_FALSE(detokenizer.HasPendingTokens(0));
+  EXPECT_EQ(detokenizer.GetDelta(0), "é");
+}
+
+TEST(IncrementalDetokenizerTest, DecodeFails) {
+  MockTokenizer tokenizer;
+  EXPECT_CALL(tokenizer, TokenIdsToText(std::vector<int>{1}))
+      .WillOnce(Return(absl::InternalError("Unknown token")));
+  IncrementalDetokenizer detokenizer(&tokenizer, /*num_output_candidates=*/1);
+
+  EXPECT_THAT(detokenizer.Decode({1}),
+              StatusIs(absl::StatusCode::kInternal));
+  EXPECT_THAT(detokenizer.Decode({1, 2}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,114 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/kv_cache_block_allocator.h"
+
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+
+// static
+absl::StatusOr<std::unique_ptr<KvCacheBlockAllocator>>
+KvCacheBlockAllocator::Create(int num_blocks, int block_size) {
+  if (num_blocks <= 0 || block_size <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid kv-cache pool of ", num_blocks,
+                     " blocks of size ", block_size, "."));
+  }
+  return absl::WrapUnique(new KvCacheBlockAllocator(num_blocks, block_size));
+}
+
+KvCacheBlockAllocator::KvCacheBlockAllocator(int num_blocks, int block_size)
+    : num_blocks_(num_blocks), block_size_(block_size) {
+  free_block_ids_.reserve(num_blocks);
+  // Allocate() takes from the back, so the blocks are handed out in order.
+  for (int block_id = num_blocks - 1; block_id >= 0; --block_id) {
+    free_block_ids_.push_back(block_id);
+  }
+}
+
+absl::StatusOr<std::vector<int>> KvCacheBlockAllocator::Allocate(
+    int num_blocks) {
+  absl::MutexLock lock(&mutex_);
+  if (num_blocks > free_block_ids_.size()) {
+    return absl::ResourceExhaustedError(
+        absl::StrCat("The kv-cache pool has ", free_block_ids_.size(),
+                     " free blocks, ", num_blocks, " are needed."));
+  }
+  std::vector<int> block_ids(free_block_ids_.rbegin(),
+                             free_block_ids_.rbegin() + num_blocks);
+  free_block_ids_.resize(free_block_ids_.size() - num_blocks);
+  return block_ids;
+}
+
+void KvCacheBlockAllocator::Free(absl::Span<const int> block_ids) {
+  absl::MutexLock lock(&mutex_);
+  free_block_ids_.insert(free_block_ids_.end(), block_ids.rbegin(),
+                         block_ids.rend());
+}
+
+int KvCacheBlockAllocator::GetNumFreeBlocks() const {
+  absl::MutexLock lock(&mutex_);
+  return free_block_ids_.size();
+}
+
+KvCacheBlockTable::~KvCacheBlockTable() { allocator_.Free(block_ids_); }
+
+absl::Status KvCacheBlockTable::Reserve(int num_tokens) {
+  if (max_num_tokens_ > 0 && num_tokens > max_num_tokens_) {
+    return absl::ResourceExhaustedError(
+        absl::StrCat("The context of ", num_tokens,
+                     " tokens exceeds the maximum number of tokens of the "
+                     "session: ",
+                     max_num_tokens_));
+  }
+  const int num_missing_blocks = GetNumBlocksFor(num_tokens) -
+                                 static_cast<int>(block_ids_.size());
+  if (num_missing_blocks <= 0) {
+    return absl::OkStatus();
+  }
+  ASSIGN_OR_RETURN(std::vector<int> block_ids,
+                   allocator_.Allocate(num_missing_blocks));
+  block_ids_.insert(block_ids_.end(), block_ids.begin(), block_ids.end());
+  return absl::OkStatus();
+}
+
+void KvCacheBlockTable::Shrink(int num_tokens) {
+  const int num_blocks = GetNumBlocksFor(num_tokens);
+  if (num_blocks >= block_ids_.size()) {
+    return;
+  }
+  allocator_.Free(absl::MakeConstSpan(block_ids_).subspan(num_blocks));
+  block_ids_.resize(num_blocks);
+}
+
+int KvCacheBlockTable::GetCapacity() const {
+  return block_ids_.size() * allocator_.GetBlockSize();
+}
+
+int KvCacheBlockTable::GetNumBlocksFor(int num_tokens) const {
+  const int block_size = allocator_.GetBlockSize();
+  return (num_tokens + block_size - 1) / block_size;
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,120 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_KV_CACHE_BLOCK_ALLOCATOR_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_KV_CACHE_BLOCK_ALLOCATOR_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/base/nullability.h"  // from @com_google_absl
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// Hands out the fixed-size blocks of a paged kv-cache pool, see
+// PagedKvCacheLlmExecutor. Instead of reserving the kv-cache of the maximum
+// context length for every session, the sessions take blocks as their
+// contexts grow and return them when they are destroyed, so that the pool can
+// hold many mostly short contexts at once.
+//
+// The class is thread-safe.
+class KvCacheBlockAllocator {
+ public:
+  // Creates an allocator of `num_blocks` blocks of `block_size` tokens each.
+  static absl::StatusOr<std::unique_ptr<KvCacheBlockAllocator>> Create(
+      int num_blocks, int block_size);
+
+  KvCacheBlockAllocator(const KvCacheBlockAllocator&) = delete;
+  KvCacheBlockAllocator& operator=(const KvCacheBlockAllocator&) = delete;
+
+  // Returns the ids of `num_blocks` free blocks. Returns a ResourceExhausted
+  // error, without allocating any block, if fewer blocks are free.
+  absl::StatusOr<std::vector<int>> Allocate(int num_blocks);
+
+  // Returns blocks obtained from Allocate() to the pool.
+  void Free(absl::Span<const int> block_ids);
+
+  int GetNumBlocks() const { return num_blocks_; }
+  int GetBlockSize() const { return block_size_; }
+  int GetNumFreeBlocks() const;
+
+ private:
+  KvCacheBlockAllocator(int num_blocks, int block_size);
+
+  const int num_blocks_;
+  const int block_size_;
+
+  mutable absl::Mutex mutex_;
+  // The ids of the free blocks. The most recently freed blocks are reused
+  // first.
+  std::vector<int> free_block_ids_ ABSL_GUARDED_BY(mutex_);
+};
+
+// The blocks backing the context of one session, in context order. The
+// blocks return to the allocator when the table is destroyed. The table
+// starts empty and grows with the context, up to the maximum number of tokens
+// of the session, so that a short session never takes the blocks of the
+// maximum context length of the engine.
+//
+// The class is not thread-safe: it is used by the executor while it processes
+// the context of the session.
+class KvCacheBlockTable {
+ public:
+  // The allocator must outlive the table. `max_num_tokens` bounds the context
+  // of the session, 0 for no bound other than the pool.
+  explicit KvCacheBlockTable(KvCacheBlockAllocator* absl_nonnull allocator,
+                             int max_num_tokens = 0)
+      : allocator_(*allocator), max_num_tokens_(max_num_tokens) {}
+  ~KvCacheBlockTable();
+
+  KvCacheBlockTable(const KvCacheBlockTable&) = delete;
+  KvCacheBlockTable& operator=(const KvCacheBlockTable&) = delete;
+
+  // Grows the table to hold at least `num_tokens` tokens. Returns a
+  // ResourceExhausted error, leaving the table unchanged, if `num_tokens`
+  // exceeds the maximum number of tokens of the table or the pool does not
+  // have enough free blocks.
+  absl::Status Reserve(int num_tokens);
+
+  // Returns the blocks not needed to hold the first `num_tokens` tokens to
+  // the pool, e.g. after the context was rolled back.
+  void Shrink(int num_tokens);
+
+  // Returns the ids of the blocks of the table. Block i holds the tokens
+  // [i * block_size, (i + 1) * block_size) of the context.
+  absl::Span<const int> GetBlockIds() const { return block_ids_; }
+
+  // Returns the number of tokens the table holds without growing.
+  int GetCapacity() const;
+
+  // Returns the maximum number of tokens of the table, 0 if unbounded.
+  int GetMaxNumTokens() const { return max_num_tokens_; }
+
+ private:
+  // Returns the number of blocks needed to hold `num_tokens` tokens.
+  int GetNumBlocksFor(int num_tokens) const;
+
+  KvCacheBlockAllocator& allocator_;
+  const int max_num_tokens_;
+  std::vector<int> block_ids_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_KV_CACHE_BLOCK_ALLOCATOR_H_
@@ -0,0 +1,124 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/kv_cache_block_allocator.h"
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::status::StatusIs;
+
+TEST(KvCacheBlockAllocatorTest, CreateFailsWithAnEmptyPool) {
+  EXPECT_THAT(KvCacheBlockAllocator::Create(/*num_blocks=*/0,
+                                            /*block_size=*/16),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(KvCacheBlockAllocator::Create(/*num_blocks=*/4,
+                                            /*block_size=*/0),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(KvCacheBlockAllocatorTest, AllocateAndFree) {
+  ASSERT_OK_AND_ASSIGN(auto allocator, KvCacheBlockAllocator::Create(
+                                           /*num_blocks=*/4,
+                                           /*block_size=*/16));
+  ASSERT_OK_AND_ASSIGN(std::vector<int> blocks, allocator->Allocate(3));
+  EXPECT_THAT(blocks, ElementsAre(0, 1, 2));
+  EXPECT_EQ(allocator->GetNumFreeBlocks(), 1);
+
+  // Nothing is allocated when the pool is short of blocks.
+  EXPECT_THAT(allocator->Allocate(2),
+              StatusIs(absl::StatusCode::kResourceExhausted));
+  EXPECT_EQ(allocator->GetNumFreeBlocks(), 1);
+
+  allocator->Free(blocks);
+  EXPECT_EQ(allocator->GetNumFreeBlocks(), 4);
+  ASSERT_OK_AND_ASSIGN(blocks, allocator->Allocate(4));
+  EXPECT_EQ(allocator->GetNumFreeBlocks(), 0);
+}
+
+TEST(KvCacheBlockTableTest, ReserveGrowsOnDemand) {
+  ASSERT_OK_AND_ASSIGN(auto allocator, KvCacheBlockAllocator::Create(
+                                           /*num_blocks=*/4,
+                                           /*block_size=*/16));
+  KvCacheBlockTable table(allocator.get());
+  EXPECT_THAT(table.GetBlockIds(), IsEmpty());
+
+  EXPECT_OK(table.Reserve(1));
+  EXPECT_EQ(table.GetCapacity(), 16);
+  EXPECT_OK(table.Reserve(16));
+  EXPECT_EQ(table.GetCapacity(), 16);
+  EXPECT_OK(table.Reserve(40));
+  EXPECT_EQ(table.GetCapacity(), 48);
+  EXPECT_THAT(table.GetBlockIds(), ElementsAre(0, 1, 2));
+
+  EXPECT_THAT(table.Reserve(80),
+              StatusIs(absl::StatusCode::kResourceExhausted));
+  EXPECT_EQ(table.GetCapacity(), 48);
+}
+
+TEST(KvCacheBlockTableTest, ReserveStopsAtTheMaxNumTokens) {
+  ASSERT_OK_AND_ASSIGN(auto allocator, KvCacheBlockAllocator::Create(
+                                           /*num_blocks=*/4,
+                                           /*block_size=*/16));
+  KvCacheBlockTable table(allocator.get(), /*max_num_tokens=*/24);
+  EXPECT_EQ(table.GetMaxNumTokens(), 24);
+
+  EXPECT_OK(table.Reserve(24));
+  EXPECT_EQ(table.GetCapacity(), 32);
+  EXPECT_THAT(table.Reserve(25),
+              StatusIs(absl::StatusCode::kResourceExhausted));
+  EXPECT_EQ(table.GetCapacity(), 32);
+  EXPECT_EQ(allocator->GetNumFreeBlocks(), 2);
+}
+
+TEST(KvCacheBlockTableTest, ShrinkReturnsTheUnusedBlocks) {
+  ASSERT_OK_AND_ASSIGN(auto allocator, KvCacheBlockAllocator::Create(
+                                           /*num_blocks=*/4,
+                                           /*block_size=*/16));
+  KvCacheBlockTable table(allocator.get());
+  EXPECT_OK(table.Reserve(64));
+  EXPECT_EQ(allocator->GetNumFreeBlocks(), 0);
+
+  table.Shrink(17);
+  EXPECT_THAT(table.GetBlockIds(), ElementsAre(0, 1));
+  EXPECT_EQ(allocator->GetNumFreeBlocks(), 2);
+  table.Shrink(40);
+  EXPECT_THAT(table.GetBlockIds(), ElementsAre(0, 1));
+}
+
+TEST(KvCacheBlockTableTest, DestructionReturnsTheBlocks) {
+  ASSERT_OK_AND_ASSIGN(auto allocator, KvCacheBlockAllocator::Create(
+                                           /*num_blocks=*/4,
+                                           /*block_size=*/16));
+  {
+    KvCacheBlockTable table1(allocator.get());
+    KvCacheBlockTable table2(allocator.get());
+    EXPECT_OK(table1.Reserve(32));
+    EXPECT_OK(table2.Reserve(32));
+    EXPECT_EQ(allocator->GetNumFreeBlocks(), 0);
+  }
+  EXPECT_EQ(allocator->GetNumFreeBlocks(), 4);
+}
+
+}  // namespace
+}  // namespace litert::lm
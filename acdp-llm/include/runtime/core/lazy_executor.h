@@ -0,0 +1,157 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LAZY_EXECUTOR_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LAZY_EXECUTOR_H_
+
+#include <memory>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/util/status_macros.h"  // IWYU pragma: keep
+
+namespace litert::lm {
+
+// Creates an executor on its first use rather than with the engine, e.g. the
+// vision or audio executor of an engine mostly serving text. With a finite
+// idle timeout, the executor is destroyed once unused for that long, and
+// created again on the next use.
+//
+// Example usage:
+//   LazyExecutor<VisionExecutor> lazy_executor(
+//       [&]() -> absl::StatusOr<std::unique_ptr<VisionExecutor>> {
+//         return VisionLiteRtCompiledModelExecutor::Create(settings, env);
+//       },
+//       /*idle_timeout=*/absl::Minutes(5));
+//   ASSIGN_OR_RETURN(std::shared_ptr<VisionExecutor> executor,
+//                    lazy_executor.Get());
+//   ASSIGN_OR_RETURN(auto image_data, executor->Encode(image_tensor));
+template <typename T>
+class LazyExecutor {
+ public:
+  using Factory = absl::AnyInvocable<absl::StatusOr<std::unique_ptr<T>>()>;
+
+  explicit LazyExecutor(Factory factory,
+                        absl::Duration idle_timeout = absl::InfiniteDuration())
+      : factory_(std::move(factory)), idle_timeout_(idle_timeout) {
+    if (idle_timeout_ != absl::InfiniteDuration()) {
+      eviction_thread_ = std::thread([this]() { EvictWhenIdle(); });
+    }
+  }
+
+  LazyExecutor(const LazyExecutor&) = delete;
+  LazyExecutor& operator=(const LazyExecutor&) = delete;
+
+  ~LazyExecutor() {
+    {
+      absl::MutexLock lock(&mutex_);
+      stopped_ = true;
+    }
+    if (eviction_thread_.joinable()) {
+      eviction_thread_.join();
+    }
+  }
+
+  // Returns the executor, creating it on the first call or after it was
+  // evicted. It is not evicted while a returned pointer is alive. The calls
+  // are serialized while the executor is created, and a failed creation is
+  // attempted again by the next call.
+  absl::StatusOr<std::shared_ptr<T>> Get() {
+    absl::MutexLock lock(&mutex_);
+    last_use_time_ = absl::Now();
+    if (executor_ == nullptr) {
+      ASSIGN_OR_RETURN(std::unique_ptr<T> executor, factory_());
+      executor_ = std::move(executor);
+      ++num_creations_;
+    }
+    return executor_;
+  }
+
+  // Returns the number of times the executor was created, for the tests and
+  // the logs.
+  int GetNumCreations() const {
+    absl::MutexLock lock(&mutex_);
+    return num_creations_;
+  }
+
+  // Returns true if the executor currently exists.
+  bool IsCreated() const {
+    absl::MutexLock lock(&mutex_);
+    return executor_ != nullptr;
+  }
+
+  // Destroys the executor now unless a pointer returned by Get() is alive,
+  // e.g. under memory pressure, whatever the idle timeout. Returns true if it
+  // was destroyed.
+  bool EvictIfUnused() {
+    absl::MutexLock lock(&mutex_);
+    if (executor_ == nullptr || executor_.use_count() > 1) {
+      return false;
+    }
+    executor_.reset();
+    return true;
+  }
+
+ private:
+  // Destroys the executor once it has not been used for the idle timeout,
+  // until the LazyExecutor is destroyed.
+  void EvictWhenIdle() {
+    absl::MutexLock lock(&mutex_);
+    while (!stopped_) {
+      if (executor_ == nullptr) {
+        mutex_.Await(absl::Condition(this, &LazyExecutor::HasWork));
+        continue;
+      }
+      const absl::Time deadline = last_use_time_ + idle_timeout_;
+      if (absl::Now() < deadline) {
+        mutex_.AwaitWithDeadline(absl::Condition(&stopped_), deadline);
+        continue;
+      }
+      if (executor_.use_count() > 1) {
+        // Still used since the last call, so idle from now on at most.
+        last_use_time_ = absl::Now();
+        continue;
+      }
+      ABSL_LOG(INFO) << "Evicting the executor idle for " << idle_timeout_;
+      executor_.reset();
+    }
+  }
+
+  bool HasWork() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return stopped_ || executor_ != nullptr;
+  }
+
+  Factory factory_ ABSL_GUARDED_BY(mutex_);
+  const absl::Duration idle_timeout_;
+
+  mutable absl::Mutex mutex_;
+  std::shared_ptr<T> executor_ ABSL_GUARDED_BY(mutex_);
+  absl::Time last_use_time_ ABSL_GUARDED_BY(mutex_);
+  int num_creations_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool stopped_ ABSL_GUARDED_BY(mutex_) = false;
+
+  std::thread eviction_thread_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LAZY_EXECUTOR_H_
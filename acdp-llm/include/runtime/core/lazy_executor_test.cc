@@ -0,0 +1,107 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/core/lazy_executor.h"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+struct FakeExecutor {
+  int id;
+};
+
+LazyExecutor<FakeExecutor>::Factory CreateFactory(int& num_calls) {
+  return [&num_calls]() -> absl::StatusOr<std::unique_ptr<FakeExecutor>> {
+    return std::make_unique<FakeExecutor>(FakeExecutor{.id = ++num_calls});
+  };
+}
+
+TEST(LazyExecutorTest, CreatesTheExecutorOnFirstUse) {
+  int num_calls = 0;
+  LazyExecutor<FakeExecutor> lazy_executor(CreateFactory(num_calls));
+  EXPECT_FALSE(lazy_executor.IsCreated());
+  EXPECT_EQ(num_calls, 0);
+
+  ASSERT_OK_AND_ASSIGN(auto executor, lazy_executor.Get());
+  EXPECT_EQ(executor->id, 1);
+  ASSERT_OK_AND_ASSIGN(auto same_executor, lazy_executor.Get());
+  EXPECT_EQ(same_executor.get(), executor.get());
+  EXPECT_TRUE(lazy_executor.IsCreated());
+  EXPECT_EQ(lazy_executor.GetNumCreations(), 1);
+}
+
+TEST(LazyExecutorTest, RetriesAFailedCreation) {
+  int num_calls = 0;
+  LazyExecutor<FakeExecutor> lazy_executor(
+      [&num_calls]() -> absl::StatusOr<std::unique_ptr<FakeExecutor>> {
+        if (++num_calls == 1) {
+          return absl::UnavailableError("Not yet.");
+        }
+        return std::make_unique<FakeExecutor>(FakeExecutor{.id = num_calls});
+      });
+  EXPECT_FALSE(lazy_executor.Get().ok());
+  EXPECT_FALSE(lazy_executor.IsCreated());
+  ASSERT_OK_AND_ASSIGN(auto executor, lazy_executor.Get());
+  EXPECT_EQ(executor->id, 2);
+}
+
+TEST(LazyExecutorTest, EvictsTheIdleExecutor) {
+  int num_calls = 0;
+  LazyExecutor<FakeExecutor> lazy_executor(
+      CreateFactory(num_calls), /*idle_timeout=*/absl::Milliseconds(20));
+  {
+    ASSERT_OK_AND_ASSIGN(auto executor, lazy_executor.Get());
+    // Not evicted while used.
+    absl::SleepFor(absl::Milliseconds(60));
+    EXPECT_TRUE(lazy_executor.IsCreated());
+  }
+  const absl::Time deadline = absl::Now() + absl::Seconds(10);
+  while (lazy_executor.IsCreated() && absl::Now() < deadline) {
+    absl::SleepFor(absl::Milliseconds(5));
+  }
+  EXPECT_FALSE(lazy_executor.IsCreated());
+
+  ASSERT_OK_AND_ASSIGN(auto executor, lazy_executor.Get());
+  EXPECT_EQ(executor->id, 2);
+  EXPECT_EQ(lazy_executor.GetNumCreations(), 2);
+}
+
+TEST(LazyExecutorTest, EvictsTheUnusedExecutorOnDemand) {
+  int num_calls = 0;
+  LazyExecutor<FakeExecutor> lazy_executor(CreateFactory(num_calls));
+  EXPECT_FALSE(lazy_executor.EvictIfUnused());
+  {
+    ASSERT_OK_AND_ASSIGN(auto executor, lazy_executor.Get());
+    EXPECT_FALSE(lazy_executor.EvictIfUnused());
+    EXPECT_TRUE(lazy_executor.IsCreated());
+  }
+  EXPECT_TRUE(lazy_executor.EvictIfUnused());
+  EXPECT_FALSE(lazy_executor.IsCreated());
+
+  ASSERT_OK_AND_ASSIGN(auto executor, lazy_executor.Get());
+  EXPECT_EQ(executor->id, 2);
+}
+
+}  // namespace
+}  // namespace litert::lm
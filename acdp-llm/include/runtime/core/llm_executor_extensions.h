@@ -0,0 +1,486 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LLM_EXECUTOR_EXTENSIONS_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LLM_EXECUTOR_EXTENSIONS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/components/constrained_decoding/constrained_decoder.h"
+#include "runtime/core/kv_cache_block_allocator.h"
+#include "runtime/core/logits_processor.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/executor/llm_executor.h"
+#include "runtime/executor/llm_executor_io_types.h"
+#include "runtime/util/lora_data.h"
+
+namespace litert::lm {
+
+// This file contains optional capability interfaces that an LlmExecutor
+// implementation may inherit from in addition to LlmExecutor. The core runtime
+// detects them at runtime with GetExecutorExtension<T>() and falls back to the
+// plain LlmExecutor API when an executor does not implement them, so executors
+// only need to opt in to the features they can support efficiently.
+
+// Returns `executor` as the extension interface T, or nullptr if the executor
+// does not implement it.
+template <typename T>
+T* GetExecutorExtension(LlmExecutor& executor) {
+  return dynamic_cast<T*>(&executor);
+}
+
+// One entry of a batched decode step, see SlotBatchedLlmExecutor::DecodeSlots.
+struct SlotDecodeRequest {
+  // The context slot to advance by one token.
+  int slot = -1;
+  // The buffer receiving the sampled token ids of the slot. The shape is
+  // [num_output_candidates, 1]. Not owned.
+  litert::TensorBuffer* output_tokens = nullptr;
+  // Optional constrained decoder of the slot. Not owned.
+  ConstrainedDecoder* constrained_decoder = nullptr;
+  // Optional logits processor of the slot, applied before sampling as with
+  // LogitsProcessingLlmExecutor. Not owned.
+  const LogitsProcessor* logits_processor = nullptr;
+  // The LoRA adapter to decode the slot with, see LoraLlmExecutor. -1
+  // (LoraLlmExecutor::kNoLoraAdapter) for the base model.
+  int lora_id = -1;
+};
+
+// An executor that keeps several independent KV-cache contexts ("slots")
+// resident at the same time and can advance all of them with a single batched
+// model invocation. Used by the ContinuousBatchingScheduler to merge the decode
+// steps of concurrent sessions.
+//
+// None of the methods need to be thread-safe: the scheduler guarantees that at
+// most one call into the executor is in flight at any time.
+class SlotBatchedLlmExecutor {
+ public:
+  virtual ~SlotBatchedLlmExecutor() = default;
+
+  // Returns the maximum number of slots that can be resident at once.
+  virtual int GetMaxNumSlots() const = 0;
+
+  // Allocates an empty slot and returns its id. Returns a ResourceExhausted
+  // error if all the slots are in use.
+  virtual absl::StatusOr<int> AllocateSlot() = 0;
+
+  // Resets and frees the slot so that it can be allocated again.
+  virtual absl::Status ReleaseSlot(int slot) = 0;
+
+  // Makes `slot` the context targeted by the subsequent calls of the regular
+  // LlmExecutor API (Prefill, Decode, DecodeLogits, GetCurrentStep, ...).
+  virtual absl::Status SelectSlot(int slot) = 0;
+
+  // Runs one decode step for every request, sampling one token per output
+  // candidate of each slot. The requests always refer to distinct slots.
+  virtual absl::Status DecodeSlots(
+      absl::Span<const SlotDecodeRequest> requests) = 0;
+
+  // Returns the number of tokens processed so far by the slot.
+  virtual absl::StatusOr<int> GetSlotCurrentStep(int slot) const = 0;
+};
+
+// An executor that keeps several independent KV-cache contexts resident at the
+// same time without batching them: the regular LlmExecutor API targets one
+// context at a time. Lets the sessions of an engine take turns on the
+// executor without resetting it and prefilling their context again, see
+// ResidentContextPool. An executor batching its contexts implements
+// SlotBatchedLlmExecutor instead.
+//
+// The executor starts with context 0 selected, the default context shared by
+// the sessions without a resident context of their own.
+class MultiContextLlmExecutor {
+ public:
+  virtual ~MultiContextLlmExecutor() = default;
+
+  static constexpr int kDefaultContext = 0;
+
+  // Returns the number of contexts that can be resident at once, the default
+  // context included.
+  virtual int GetMaxNumContexts() const = 0;
+
+  // Allocates an empty context other than the default one and returns its
+  // id. Returns a ResourceExhausted error if all the contexts are in use.
+  virtual absl::StatusOr<int> AllocateContext() = 0;
+
+  // Resets and frees the context so that it can be allocated again. The
+  // default context is selected if `context` was.
+  virtual absl::Status ReleaseContext(int context) = 0;
+
+  // Makes `context` the context targeted by the subsequent calls of the
+  // regular LlmExecutor API, without copying any kv-cache.
+  virtual absl::Status SelectContext(int context) = 0;
+};
+
+// An executor that can append several tokens to its context in a single model
+// invocation and drop tokens from the end of its context. Both the main and
+// the draft executors must implement it to be used for speculative decoding,
+// see SpeculativeDecoder.
+//
+// Unlike the regular decode API, PredictNextTokens attends to all the given
+// tokens. The pending token left by a regular Prefill (the last prefilled
+// token, which the executor has not attended to yet) is not part of the
+// context, so callers pass it first.
+class SpeculativeLlmExecutor {
+ public:
+  virtual ~SpeculativeLlmExecutor() = default;
+
+  // Appends `token_ids` to the context in a single model invocation and
+  // returns, for every token, the id of the most likely next token (argmax).
+  // The returned vector has the same size as `token_ids`.
+  virtual absl::StatusOr<std::vector<int>> PredictNextTokens(
+      absl::Span<const int> token_ids) = 0;
+
+  // Drops the last `num_tokens` tokens from the context.
+  virtual absl::Status RollbackTokens(int num_tokens) = 0;
+};
+
+// An executor that can run whole token sequences in a single model invocation
+// and return the logits at every position, e.g. to score candidate texts
+// without decoding them token by token, see ScoreTokenSequences.
+class PrefillLogitsLlmExecutor {
+ public:
+  virtual ~PrefillLogitsLlmExecutor() = default;
+
+  // Runs every sequence of `token_ids` after the current context,
+  // independently of each other, in a single batched model invocation, and
+  // returns for each sequence the logits predicted after each of its tokens,
+  // of shape [token_ids[i].size(), vocab_size]. The context is left
+  // unchanged. As with PredictNextTokens, the pending token left by a regular
+  // Prefill is not part of the context, so callers start the sequences with
+  // it.
+  virtual absl::StatusOr<std::vector<litert::TensorBuffer>> PrefillLogits(
+      absl::Span<const std::vector<int>> token_ids) = 0;
+};
+
+// An executor that can return the hidden states of its last layer, after the
+// final norm, e.g. to embed texts with the weights already loaded for
+// generation instead of a separate embedding model, see EmbedTokenSequences.
+class HiddenStatesLlmExecutor {
+ public:
+  virtual ~HiddenStatesLlmExecutor() = default;
+
+  // Returns the size of a hidden state.
+  virtual int GetHiddenSize() const = 0;
+
+  // Runs every sequence of `token_ids` from an empty context, independently
+  // of each other, in a single batched model invocation, and returns for each
+  // sequence the hidden states of its tokens, of shape
+  // [token_ids[i].size(), GetHiddenSize()]. The context is left unchanged.
+  virtual absl::StatusOr<std::vector<litert::TensorBuffer>> PrefillHiddenStates(
+      absl::Span<const std::vector<int>> token_ids) = 0;
+};
+
+// An executor whose prefill can stop midway, e.g. between the invocations of
+// its prefill signatures or through the cancellation hook of its backend, so
+// that a cancelled session releases the executor without waiting for a long
+// prompt, see Prefill() of the pipeline.
+class CancellablePrefillLlmExecutor {
+ public:
+  virtual ~CancellablePrefillLlmExecutor() = default;
+
+  // Same as LlmExecutor::Prefill, but polls `cancelled` while it runs and
+  // returns a Cancelled error soon after it is set. The tokens prefilled until
+  // then stay in the context. `cancelled` outlives the call, including its
+  // asynchronous part when the params do not wait for the completion.
+  virtual absl::Status PrefillCancellable(
+      const ExecutorInputs& inputs, const ExecutorPrefillParams& params,
+      const std::atomic<bool>& cancelled) = 0;
+};
+
+// An immutable copy of the context of an executor, see
+// KvCacheSnapshotLlmExecutor.
+class KvCacheSnapshot {
+ public:
+  virtual ~KvCacheSnapshot() = default;
+
+  // Returns the number of tokens in the snapshot.
+  virtual int GetNumTokens() const = 0;
+
+  // Returns the memory used by the snapshot.
+  virtual size_t GetSizeInBytes() const = 0;
+
+  // Returns the token left pending by the last Prefill when the snapshot was
+  // saved, or -1 if there was none. The pending token is not part of the
+  // restored context.
+  virtual int GetPendingTokenId() const = 0;
+};
+
+// An executor that can copy its context out and back in, e.g. to let new
+// sessions share the kv-cache of a common prompt prefix, see PrefixKvCache.
+//
+// Only the tokens the executor attended to are part of a snapshot, the pending
+// token left by a regular Prefill is not. With SlotBatchedLlmExecutor, both
+// methods act on the selected slot.
+class KvCacheSnapshotLlmExecutor {
+ public:
+  virtual ~KvCacheSnapshotLlmExecutor() = default;
+
+  // Copies the current context. Waits for the in-flight prefill, if any.
+  virtual absl::StatusOr<std::unique_ptr<KvCacheSnapshot>> SaveKvCache() = 0;
+
+  // Replaces the current context with the first `num_tokens` tokens of
+  // `snapshot`, which was saved by an executor of the same model, and drops
+  // the pending token. The next Prefill appends to the restored tokens.
+  virtual absl::Status RestoreKvCache(const KvCacheSnapshot& snapshot,
+                                      int num_tokens) = 0;
+
+  // Returns the contents of `snapshot`, including its pending token, in a
+  // layout private to the executor, e.g. to persist it across processes.
+  virtual absl::StatusOr<std::string> SerializeKvCache(
+      const KvCacheSnapshot& snapshot) {
+    return absl::UnimplementedError("SerializeKvCache is not implemented.");
+  }
+
+  // Creates a snapshot from the output of SerializeKvCache() of an executor
+  // of the same model and settings. `data` stays valid and unchanged for the
+  // lifetime of the returned snapshot, which may therefore use it in place,
+  // e.g. when it is memory mapped, instead of copying it.
+  virtual absl::StatusOr<std::unique_ptr<KvCacheSnapshot>> DeserializeKvCache(
+      absl::string_view data) {
+    return absl::UnimplementedError("DeserializeKvCache is not implemented.");
+  }
+
+  // Copies `snapshot`, saved by `source`, an executor of the same model and
+  // settings such as the executor of another engine, into a snapshot of this
+  // executor without going through host memory, e.g. device to device.
+  // `source` is only used to read `snapshot`. Returns an Unimplemented error
+  // if the executor can not reach the memory of `source`, in which case the
+  // snapshot goes through SerializeKvCache() and DeserializeKvCache().
+  virtual absl::StatusOr<std::unique_ptr<KvCacheSnapshot>> ImportKvCache(
+      const KvCacheSnapshot& snapshot, KvCacheSnapshotLlmExecutor& source) {
+    return absl::UnimplementedError("ImportKvCache is not implemented.");
+  }
+};
+
+// An executor timing its invocations by signature, e.g. the NPU executor,
+// whose prefill and decode the pipeline otherwise only times as a whole. The
+// sessions report the stats in their BenchmarkInfo.
+class ProfiledLlmExecutor {
+ public:
+  virtual ~ProfiledLlmExecutor() = default;
+
+  // Returns the stats of the invocations since the executor was created, by
+  // signature name, across the sessions sharing the executor. Empty if the
+  // executor was created without profiling, e.g. without the benchmark.
+  virtual std::map<std::string, ExecutorInvocationStats> GetInvocationStats()
+      const = 0;
+};
+
+// An executor that can drop tokens from the middle of its context, e.g. to
+// keep a sliding window over a context longer than the kv-cache, see
+// ContextCompactor. The tokens following the dropped ones move down so that
+// the context stays contiguous; executors using rotary position embeddings
+// re-rotate the keys of the moved tokens to their new positions.
+class ContextEvictionLlmExecutor {
+ public:
+  virtual ~ContextEvictionLlmExecutor() = default;
+
+  // Drops the tokens [start, start + num_tokens) from the context. The
+  // pending token left by a regular Prefill stays pending.
+  virtual absl::Status EvictTokens(int start, int num_tokens) = 0;
+};
+
+// An executor whose kv-cache is a pool of fixed-size blocks shared by its
+// contexts, instead of one allocation of the maximum context length per
+// context. The engine hands the blocks out to the sessions with a
+// KvCacheBlockAllocator sized after the pool, so the pool can hold more
+// contexts than it could at their maximum length.
+//
+// With SlotBatchedLlmExecutor, SetKvCacheBlockTable acts on the selected
+// slot.
+class PagedKvCacheLlmExecutor {
+ public:
+  virtual ~PagedKvCacheLlmExecutor() = default;
+
+  // Returns the number of blocks of the pool.
+  virtual int GetNumKvCacheBlocks() const = 0;
+
+  // Returns the number of tokens held by a block.
+  virtual int GetKvCacheBlockSize() const = 0;
+
+  // Backs the current context with the blocks of `block_table`, which must
+  // outlive its use, or unbinds the current table if nullptr. The executor
+  // calls block_table->Reserve() before its context outgrows the capacity of
+  // the table, failing the executor call with the ResourceExhausted error of
+  // Reserve() when the pool is exhausted, and may call Shrink() when the
+  // context is reset or rolled back.
+  virtual absl::Status SetKvCacheBlockTable(KvCacheBlockTable* block_table) = 0;
+};
+
+// An executor that can store its kv-cache quantized, with a scale per head
+// and token next to the quantized keys and values, so that a context takes
+// less memory and more sessions fit on the device. The decode steps
+// dequantize the keys and values as they read them, which trades a little
+// compute for the memory bandwidth saved.
+class QuantizedKvCacheLlmExecutor {
+ public:
+  virtual ~QuantizedKvCacheLlmExecutor() = default;
+
+  // Stores the kv-cache as `data_type` from now on, reallocating it empty.
+  // Called by the engine before any session is created. Fails with
+  // InvalidArgument if the data type is not supported.
+  virtual absl::Status SetKvCacheDataType(KvCacheDataType data_type) = 0;
+
+  // Returns the memory of the kv-cache of a context at its maximum length if
+  // stored as `data_type`, scales included.
+  virtual size_t GetKvCacheSizeInBytes(KvCacheDataType data_type) const = 0;
+};
+
+// An executor that can reorder the contexts of its output candidates, e.g. to
+// decode the beams of a beam search as the candidates, see BeamSearch.
+class BeamSearchLlmExecutor {
+ public:
+  virtual ~BeamSearchLlmExecutor() = default;
+
+  // Makes the context of candidate i a copy of the context of candidate
+  // `parent_indices[i]`, for each of the output candidates. The beams of a
+  // search mostly share their prefixes, so implementations should share the
+  // kv-cache of the common tokens between the candidates, e.g. with
+  // copy-on-write blocks, rather than copying it.
+  virtual absl::Status ReorderCandidates(
+      absl::Span<const int> parent_indices) = 0;
+};
+
+// An executor that can leave some of its output candidates out of the decode
+// steps, e.g. the candidates which have stopped or have been pruned, so that
+// the steps only compute the logits of the remaining ones, see
+// CandidatePruner.
+class CandidateMaskingLlmExecutor {
+ public:
+  virtual ~CandidateMaskingLlmExecutor() = default;
+
+  // Sets the candidates computed by the next decode steps, in increasing
+  // order, all of them by default. The inputs of the other candidates are
+  // ignored and their logits are unspecified. Prefills still apply to all the
+  // candidates.
+  virtual absl::Status SetActiveCandidates(
+      absl::Span<const int> candidates) = 0;
+};
+
+// An executor that can apply a LogitsProcessor to the logits it samples on
+// the device, e.g. by scattering the adjustments of each candidate into its
+// logits and masking min-p in its sampling kernel, so that the logits are not
+// read back to the host, see DecodeConfig::LogitsProcessingOptions. The
+// decode loops require it to process the logits with internal sampling. With
+// SlotBatchedLlmExecutor, DecodeSlots applies the processor of each request.
+class LogitsProcessingLlmExecutor {
+ public:
+  virtual ~LogitsProcessingLlmExecutor() = default;
+
+  // Same as LlmExecutor::Decode, but applies `logits_processor` to the logits
+  // before sampling them, after the constraint if any. The caller updates the
+  // processor with the sampled tokens.
+  virtual absl::Status DecodeWithLogitsProcessor(
+      litert::TensorBuffer& output_tokens, const ExecutorDecodeParams& params,
+      const LogitsProcessor& logits_processor) = 0;
+};
+
+// An executor that can mask the logits with the token bitmasks of a
+// TokenBitmaskConstraint inside its sampler, e.g. by uploading the bitmasks
+// and skipping the disallowed tokens in its sampling kernel, so that the
+// constrained decoding samples on the device without reading back the logits.
+// The decode loops use it with internal sampling when the constraint
+// implements TokenBitmaskConstraint.
+class TokenBitmaskLlmExecutor {
+ public:
+  virtual ~TokenBitmaskLlmExecutor() = default;
+
+  // Same as LlmExecutor::Decode, but only samples the tokens allowed by
+  // `token_bitmasks`: the bitmask of each output candidate in turn,
+  // (vocabulary size + 31) / 32 words each, see TokenBitmaskConstraint.
+  virtual absl::Status DecodeWithTokenBitmasks(
+      litert::TensorBuffer& output_tokens, const ExecutorDecodeParams& params,
+      absl::Span<const uint32_t> token_bitmasks) = 0;
+};
+
+// An executor that can run several decode steps back to back on the device,
+// feeding each sampled token to the next step without reading it back in
+// between, so that the host synchronizes once per batch of steps instead of
+// once per token. The decode loops use it with internal sampling of a single
+// output candidate when no constraint or logits processor is set.
+class MultiStepDecodeLlmExecutor {
+ public:
+  virtual ~MultiStepDecodeLlmExecutor() = default;
+
+  // Same as output_tokens.size() calls to LlmExecutor::Decode with a single
+  // output candidate, writing the token sampled by each step in turn. May
+  // stop early, e.g. on a stop token id, and returns the number of steps run.
+  virtual absl::StatusOr<int> DecodeSteps(absl::Span<int> output_tokens) = 0;
+
+  // Undoes the last `num_steps` steps of DecodeSteps: drops the tokens they
+  // appended to the context, so that the token sampled by the last step kept
+  // is the pending one again.
+  virtual absl::Status RollbackSteps(int num_steps) = 0;
+};
+
+// An executor that can hold the weights of several LoRA adapters of its model
+// next to the base weights and switch between them without reloading the base
+// model or recompiling the graph, e.g. by binding the adapter weights to the
+// LoRA inputs of the compiled model. The engine keeps the adapters resident
+// with a LoraRegistry.
+//
+// The registry loads and unloads the adapters from the threads of the
+// sessions acquiring them, so LoadLoraAdapter and UnloadLoraAdapter must be
+// safe to call concurrently with the other methods. An adapter is never
+// unloaded while selected. With SlotBatchedLlmExecutor, SelectLoraAdapter
+// applies to the regular LlmExecutor API, while DecodeSlots decodes every
+// request with its SlotDecodeRequest::lora_id, see SupportsMixedLoraBatches.
+class LoraLlmExecutor {
+ public:
+  // The id selecting the base model, without any adapter.
+  static constexpr int kNoLoraAdapter = -1;
+
+  virtual ~LoraLlmExecutor() = default;
+
+  // Returns the maximum number of adapters loaded at once, 0 if unlimited.
+  virtual int GetMaxNumLoraAdapters() const = 0;
+
+  // Loads the weights of `lora` as the adapter `lora_id`, in
+  // [0, GetMaxNumLoraAdapters()) when limited, and returns the memory they
+  // use. `lora` is kept alive until the adapter is unloaded.
+  virtual absl::StatusOr<size_t> LoadLoraAdapter(int lora_id,
+                                                 LoraData& lora) = 0;
+
+  // Frees the weights of the adapter `lora_id`.
+  virtual absl::Status UnloadLoraAdapter(int lora_id) = 0;
+
+  // Makes the subsequent calls run with the adapter `lora_id`, or with the
+  // base model if kNoLoraAdapter.
+  virtual absl::Status SelectLoraAdapter(int lora_id) = 0;
+
+  // Returns whether SlotBatchedLlmExecutor::DecodeSlots can decode requests
+  // with different adapters in one invocation, each row of the batch applying
+  // the low-rank update of its own adapter (gathered per-row LoRA matmuls,
+  // as in S-LoRA or Punica). Otherwise the ContinuousBatchingScheduler splits
+  // the batches by adapter and selects the adapter before each DecodeSlots
+  // call.
+  virtual bool SupportsMixedLoraBatches() const { return false; }
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LLM_EXECUTOR_EXTENSIONS_H_
@@ -0,0 +1,719 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/logits_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LITERT_LM_LOGITS_KERNELS_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define LITERT_LM_LOGITS_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace litert::lm {
+namespace {
+
+// The range of the inputs of the vectorized exp, outside of which expf
+// underflows to a denormal or overflows.
+constexpr float kMinExpInput = -87.3f;
+constexpr float kMaxExpInput = 88.3f;
+constexpr float kLog2E = 1.44269504088896341f;
+// ln(2) split in two, so that n * kLn2Hi is exact for the exponents in range.
+constexpr float kLn2Hi = 0.693359375f;
+constexpr float kLn2Lo = -2.12194440e-4f;
+// The minimax polynomial of (exp(r) - 1 - r) / r^2 on [-ln(2)/2, ln(2)/2].
+constexpr float kExpC0 = 1.9875691500e-4f;
+constexpr float kExpC1 = 1.3981999507e-3f;
+constexpr float kExpC2 = 8.3334519073e-3f;
+constexpr float kExpC3 = 4.1665795894e-2f;
+constexpr float kExpC4 = 1.6666665459e-1f;
+constexpr float kExpC5 = 5.0000001201e-1f;
+
+float ScalarMax(const float* data, int size) {
+  return *std::max_element(data, data + size);
+}
+
+float ScalarSumExp(const float* data, int size, float scale, float offset) {
+  float sum = 0.0f;
+  for (int i = 0; i < size; ++i) {
+    sum += std::exp(data[i] * scale + offset);
+  }
+  return sum;
+}
+
+int ScalarFindGreater(const float* data, int begin, int size,
+                      float threshold) {
+  for (int i = begin; i < size; ++i) {
+    if (data[i] > threshold) {
+      return i;
+    }
+  }
+  return size;
+}
+
+void ScalarMask(const uint32_t* bitmask, float* data, int size,
+                float masked_value) {
+  for (int i = 0; i < size; i += 32) {
+    const uint32_t word = bitmask[i / 32];
+    // Most words of a permissive grammar state allow all their tokens.
+    if (word == ~uint32_t{0}) {
+      continue;
+    }
+    const int end = std::min(i + 32, size);
+    for (int j = i; j < end; ++j) {
+      if (((word >> (j - i)) & 1) == 0) {
+        data[j] = masked_value;
+      }
+    }
+  }
+}
+
+void ScalarMaskBelow(float* data, int size, float threshold,
+                     float masked_value) {
+  for (int i = 0; i < size; ++i) {
+    if (data[i] < threshold) {
+      data[i] = masked_value;
+    }
+  }
+}
+
+constexpr LogitsKernels::Primitives kScalarPrimitives = {
+    &ScalarMax, &ScalarSumExp, &ScalarFindGreater, &ScalarMask,
+    &ScalarMaskBelow};
+
+#if defined(LITERT_LM_LOGITS_KERNELS_X86)
+
+#define LITERT_LM_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define LITERT_LM_TARGET_AVX512 __attribute__((target("avx512f")))
+
+LITERT_LM_TARGET_AVX2 inline __m256 Avx2Exp(__m256 x) {
+  x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(kMinExpInput)),
+                    _mm256_set1_ps(kMaxExpInput));
+  // exp(x) = 2^n * exp(r), with r = x - n * ln(2).
+  const __m256 n =
+      _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(kLog2E)),
+                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(kLn2Hi), x);
+  r = _mm256_fnmadd_ps(n, _mm256_set1_ps(kLn2Lo), r);
+  __m256 p = _mm256_set1_ps(kExpC0);
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpC1));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpC2));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpC3));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpC4));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpC5));
+  p = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), r);
+  p = _mm256_add_ps(p, _mm256_set1_ps(1.0f));
+  const __m256i exponent = _mm256_slli_epi32(
+      _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+  return _mm256_mul_ps(p, _mm256_castsi256_ps(exponent));
+}
+
+LITERT_LM_TARGET_AVX2 inline float Avx2ReduceAdd(__m256 v) {
+  __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v),
+                          _mm256_extractf128_ps(v, 1));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+  return _mm_cvtss_f32(sum);
+}
+
+LITERT_LM_TARGET_AVX2 float Avx2Max(const float* data, int size) {
+  int i = 0;
+  float max = data[0];
+  if (size >= 8) {
+    __m256 max_v = _mm256_loadu_ps(data);
+    for (i = 8; i + 8 <= size; i += 8) {
+      max_v = _mm256_max_ps(max_v, _mm256_loadu_ps(data + i));
+    }
+    __m128 m = _mm_max_ps(_mm256_castps256_ps128(max_v),
+                          _mm256_extractf128_ps(max_v, 1));
+    m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_max_ss(m, _mm_movehdup_ps(m));
+    max = _mm_cvtss_f32(m);
+  }
+  for (; i < size; ++i) {
+    max = std::max(max, data[i]);
+  }
+  return max;
+}
+
+LITERT_LM_TARGET_AVX2 float Avx2SumExp(const float* data, int size,
+                                       float scale, float offset) {
+  const __m256 scale_v = _mm256_set1_ps(scale);
+  const __m256 offset_v = _mm256_set1_ps(offset);
+  // Two accumulators hide the latency of the additions.
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  int i = 0;
+  for (; i + 16 <= size; i += 16) {
+    sum0 = _mm256_add_ps(sum0, Avx2Exp(_mm256_fmadd_ps(
+                                   _mm256_loadu_ps(data + i), scale_v,
+                                   offset_v)));
+    sum1 = _mm256_add_ps(sum1, Avx2Exp(_mm256_fmadd_ps(
+                                   _mm256_loadu_ps(data + i + 8), scale_v,
+                                   offset_v)));
+  }
+  for (; i + 8 <= size; i += 8) {
+    sum0 = _mm256_add_ps(sum0, Avx2Exp(_mm256_fmadd_ps(
+                                   _mm256_loadu_ps(data + i), scale_v,
+                                   offset_v)));
+  }
+  return Avx2ReduceAdd(_mm256_add_ps(sum0, sum1)) +
+         ScalarSumExp(data + i, size - i, scale, offset);
+}
+
+LITERT_LM_TARGET_AVX2 int Avx2FindGreater(const float* data, int begin,
+                                          int size, float threshold) {
+  const __m256 threshold_v = _mm256_set1_ps(threshold);
+  int i = begin;
+  for (; i + 8 <= size; i += 8) {
+    const int mask = _mm256_movemask_ps(
+        _mm256_cmp_ps(_mm256_loadu_ps(data + i), threshold_v, _CMP_GT_OQ));
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return ScalarFindGreater(data, i, size, threshold);
+}
+
+LITERT_LM_TARGET_AVX2 void Avx2Mask(const uint32_t* bitmask, float* data,
+                                    int size, float masked_value) {
+  // Lane j of a byte of the word checks bit j.
+  const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  const __m256 masked_value_v = _mm256_set1_ps(masked_value);
+  int i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const uint32_t word = bitmask[i / 32];
+    if (word == ~uint32_t{0}) {
+      continue;
+    }
+    for (int j = 0; j < 32; j += 8) {
+      const __m256i byte = _mm256_set1_epi32((word >> j) & 0xff);
+      const __m256 allowed = _mm256_castsi256_ps(
+          _mm256_cmpeq_epi32(_mm256_and_si256(byte, bits), bits));
+      _mm256_storeu_ps(data + i + j,
+                       _mm256_blendv_ps(masked_value_v,
+                                        _mm256_loadu_ps(data + i + j),
+                                        allowed));
+    }
+  }
+  ScalarMask(bitmask + i / 32, data + i, size - i, masked_value);
+}
+
+LITERT_LM_TARGET_AVX2 void Avx2MaskBelow(float* data, int size,
+                                         float threshold, float masked_value) {
+  const __m256 threshold_v = _mm256_set1_ps(threshold);
+  const __m256 masked_value_v = _mm256_set1_ps(masked_value);
+  int i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const __m256 x = _mm256_loadu_ps(data + i);
+    _mm256_storeu_ps(data + i,
+                     _mm256_blendv_ps(x, masked_value_v,
+                                      _mm256_cmp_ps(x, threshold_v,
+                                                    _CMP_LT_OQ)));
+  }
+  ScalarMaskBelow(data + i, size - i, threshold, masked_value);
+}
+
+constexpr LogitsKernels::Primitives kAvx2Primitives = {
+    &Avx2Max, &Avx2SumExp, &Avx2FindGreater, &Avx2Mask, &Avx2MaskBelow};
+
+LITERT_LM_TARGET_AVX512 inline __m512 Avx512Exp(__m512 x) {
+  x = _mm512_min_ps(_mm512_max_ps(x, _mm512_set1_ps(kMinExpInput)),
+                    _mm512_set1_ps(kMaxExpInput));
+  const __m512 n =
+      _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps(kLog2E)),
+                           _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m512 r = _mm512_fnmadd_ps(n, _mm512_set1_ps(kLn2Hi), x);
+  r = _mm512_fnmadd_ps(n, _mm512_set1_ps(kLn2Lo), r);
+  __m512 p = _mm512_set1_ps(kExpC0);
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpC1));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpC2));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpC3));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpC4));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpC5));
+  p = _mm512_fmadd_ps(p, _mm512_mul_ps(r, r), r);
+  p = _mm512_add_ps(p, _mm512_set1_ps(1.0f));
+  const __m512i exponent = _mm512_slli_epi32(
+      _mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127)), 23);
+  return _mm512_mul_ps(p, _mm512_castsi512_ps(exponent));
+}
+
+LITERT_LM_TARGET_AVX512 float Avx512Max(const float* data, int size) {
+  int i = 0;
+  float max = data[0];
+  if (size >= 16) {
+    __m512 max_v = _mm512_loadu_ps(data);
+    for (i = 16; i + 16 <= size; i += 16) {
+      max_v = _mm512_max_ps(max_v, _mm512_loadu_ps(data + i));
+    }
+    max = _mm512_reduce_max_ps(max_v);
+  }
+  for (; i < size; ++i) {
+    max = std::max(max, data[i]);
+  }
+  return max;
+}
+
+LITERT_LM_TARGET_AVX512 float Avx512SumExp(const float* data, int size,
+                                           float scale, float offset) {
+  const __m512 scale_v = _mm512_set1_ps(scale);
+  const __m512 offset_v = _mm512_set1_ps(offset);
+  __m512 sum0 = _mm512_setzero_ps();
+  __m512 sum1 = _mm512_setzero_ps();
+  int i = 0;
+  for (; i + 32 <= size; i += 32) {
+    sum0 = _mm512_add_ps(sum0, Avx512Exp(_mm512_fmadd_ps(
+                                   _mm512_loadu_ps(data + i), scale_v,
+                                   offset_v)));
+    sum1 = _mm512_add_ps(sum1, Avx512Exp(_mm512_fmadd_ps(
+                                   _mm512_loadu_ps(data + i + 16), scale_v,
+                                   offset_v)));
+  }
+  for (; i + 16 <= size; i += 16) {
+    sum0 = _mm512_add_ps(sum0, Avx512Exp(_mm512_fmadd_ps(
+                                   _mm512_loadu_ps(data + i), scale_v,
+                                   offset_v)));
+  }
+  return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1)) +
+         ScalarSumExp(data + i, size - i, scale, offset);
+}
+
+LITERT_LM_TARGET_AVX512 int Avx512FindGreater(const float* data, int begin,
+                                              int size, float threshold) {
+  const __m512 threshold_v = _mm512_set1_ps(threshold);
+  int i = begin;
+  for (; i + 16 <= size; i += 16) {
+    const __mmask16 mask = _mm512_cmp_ps_mask(_mm512_loadu_ps(data + i),
+                                              threshold_v, _CMP_GT_OQ);
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return ScalarFindGreater(data, i, size, threshold);
+}
+
+LITERT_LM_TARGET_AVX512 void Avx512Mask(const uint32_t* bitmask, float* data,
+                                        int size, float masked_value) {
+  // The halves of a word are the store masks of the disallowed tokens.
+  const __m512 masked_value_v = _mm512_set1_ps(masked_value);
+  int i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const uint32_t disallowed = ~bitmask[i / 32];
+    if (disallowed == 0) {
+      continue;
+    }
+    _mm512_mask_storeu_ps(data + i, static_cast<__mmask16>(disallowed),
+                          masked_value_v);
+    _mm512_mask_storeu_ps(data + i + 16,
+                          static_cast<__mmask16>(disallowed >> 16),
+                          masked_value_v);
+  }
+  ScalarMask(bitmask + i / 32, data + i, size - i, masked_value);
+}
+
+LITERT_LM_TARGET_AVX512 void Avx512MaskBelow(float* data, int size,
+                                             float threshold,
+                                             float masked_value) {
+  const __m512 threshold_v = _mm512_set1_ps(threshold);
+  const __m512 masked_value_v = _mm512_set1_ps(masked_value);
+  int i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __mmask16 below = _mm512_cmp_ps_mask(_mm512_loadu_ps(data + i),
+                                               threshold_v, _CMP_LT_OQ);
+    _mm512_mask_storeu_ps(data + i, below, masked_value_v);
+  }
+  ScalarMaskBelow(data + i, size - i, threshold, masked_value);
+}
+
+constexpr LogitsKernels::Primitives kAvx512Primitives = {
+    &Avx512Max, &Avx512SumExp, &Avx512FindGreater, &Avx512Mask,
+    &Avx512MaskBelow};
+
+#elif defined(LITERT_LM_LOGITS_KERNELS_NEON)
+
+inline float32x4_t NeonExp(float32x4_t x) {
+  x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(kMinExpInput)),
+                vdupq_n_f32(kMaxExpInput));
+  const float32x4_t n = vrndnq_f32(vmulq_f32(x, vdupq_n_f32(kLog2E)));
+  float32x4_t r = vfmsq_f32(x, n, vdupq_n_f32(kLn2Hi));
+  r = vfmsq_f32(r, n, vdupq_n_f32(kLn2Lo));
+  float32x4_t p = vdupq_n_f32(kExpC0);
+  p = vfmaq_f32(vdupq_n_f32(kExpC1), p, r);
+  p = vfmaq_f32(vdupq_n_f32(kExpC2), p, r);
+  p = vfmaq_f32(vdupq_n_f32(kExpC3), p, r);
+  p = vfmaq_f32(vdupq_n_f32(kExpC4), p, r);
+  p = vfmaq_f32(vdupq_n_f32(kExpC5), p, r);
+  p = vfmaq_f32(r, p, vmulq_f32(r, r));
+  p = vaddq_f32(p, vdupq_n_f32(1.0f));
+  const int32x4_t exponent =
+      vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23);
+  return vmulq_f32(p, vreinterpretq_f32_s32(exponent));
+}
+
+float NeonMax(const float* data, int size) {
+  int i = 0;
+  float max = data[0];
+  if (size >= 4) {
+    float32x4_t max_v = vld1q_f32(data);
+    for (i = 4; i + 4 <= size; i += 4) {
+      max_v = vmaxq_f32(max_v, vld1q_f32(data + i));
+    }
+    max = vmaxvq_f32(max_v);
+  }
+  for (; i < size; ++i) {
+    max = std::max(max, data[i]);
+  }
+  return max;
+}
+
+float NeonSumExp(const float* data, int size, float scale, float offset) {
+  const float32x4_t scale_v = vdupq_n_f32(scale);
+  const float32x4_t offset_v = vdupq_n_f32(offset);
+  float32x4_t sum0 = vdupq_n_f32(0.0f);
+  float32x4_t sum1 = vdupq_n_f32(0.0f);
+  int i = 0;
+  for (; i + 8 <= size; i += 8) {
+    sum0 = vaddq_f32(
+        sum0, NeonExp(vfmaq_f32(offset_v, vld1q_f32(data + i), scale_v)));
+    sum1 = vaddq_f32(
+        sum1, NeonExp(vfmaq_f32(offset_v, vld1q_f32(data + i + 4), scale_v)));
+  }
+  for (; i + 4 <= size; i += 4) {
+    sum0 = vaddq_f32(
+        sum0, NeonExp(vfmaq_f32(offset_v, vld1q_f32(data + i), scale_v)));
+  }
+  return vaddvq_f32(vaddq_f32(sum0, sum1)) +
+         ScalarSumExp(data + i, size - i, scale, offset);
+}
+
+int NeonFindGreater(const float* data, int begin, int size, float threshold) {
+  const float32x4_t threshold_v = vdupq_n_f32(threshold);
+  int i = begin;
+  for (; i + 4 <= size; i += 4) {
+    if (vmaxvq_u32(vcgtq_f32(vld1q_f32(data + i), threshold_v)) != 0) {
+      return ScalarFindGreater(data, i, i + 4, threshold);
+    }
+  }
+  return ScalarFindGreater(data, i, size, threshold);
+}
+
+void NeonMask(const uint32_t* bitmask, float* data, int size,
+              float masked_value) {
+  // Lane j of a nibble of the word checks bit j.
+  constexpr uint32_t kBits[4] = {1, 2, 4, 8};
+  const uint32x4_t bits = vld1q_u32(kBits);
+  const float32x4_t masked_value_v = vdupq_n_f32(masked_value);
+  int i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const uint32_t word = bitmask[i / 32];
+    if (word == ~uint32_t{0}) {
+      continue;
+    }
+    for (int j = 0; j < 32; j += 4) {
+      const uint32x4_t allowed =
+          vtstq_u32(vdupq_n_u32((word >> j) & 0xf), bits);
+      vst1q_f32(data + i + j, vbslq_f32(allowed, vld1q_f32(data + i + j),
+                                        masked_value_v));
+    }
+  }
+  ScalarMask(bitmask + i / 32, data + i, size - i, masked_value);
+}
+
+void NeonMaskBelow(float* data, int size, float threshold,
+                   float masked_value) {
+  const float32x4_t threshold_v = vdupq_n_f32(threshold);
+  const float32x4_t masked_value_v = vdupq_n_f32(masked_value);
+  int i = 0;
+  for (; i + 4 <= size; i += 4) {
+    const float32x4_t x = vld1q_f32(data + i);
+    vst1q_f32(data + i,
+              vbslq_f32(vcltq_f32(x, threshold_v), masked_value_v, x));
+  }
+  ScalarMaskBelow(data + i, size - i, threshold, masked_value);
+}
+
+constexpr LogitsKernels::Primitives kNeonPrimitives = {
+    &NeonMax, &NeonSumExp, &NeonFindGreater, &NeonMask, &NeonMaskBelow};
+
+#endif
+
+bool IsSupported(LogitsKernelIsa isa) {
+  switch (isa) {
+    case LogitsKernelIsa::kScalar:
+      return true;
+    case LogitsKernelIsa::kNeon:
+#if defined(LITERT_LM_LOGITS_KERNELS_NEON)
+      return true;
+#else
+      return false;
+#endif
+    case LogitsKernelIsa::kAvx2:
+#if defined(LITERT_LM_LOGITS_KERNELS_X86)
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+      return false;
+#endif
+    case LogitsKernelIsa::kAvx512:
+#if defined(LITERT_LM_LOGITS_KERNELS_X86)
+      return __builtin_cpu_supports("avx512f");
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+absl::Status ValidateTemperature(float temperature) {
+  if (!(temperature > 0.0f)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Temperature must be positive, got ", temperature, "."));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+std::ostream& operator<<(std::ostream& os, LogitsKernelIsa isa) {
+  switch (isa) {
+    case LogitsKernelIsa::kScalar:
+      return os << "SCALAR";
+    case LogitsKernelIsa::kNeon:
+      return os << "NEON";
+    case LogitsKernelIsa::kAvx2:
+      return os << "AVX2";
+    case LogitsKernelIsa::kAvx512:
+      return os << "AVX512";
+  }
+  return os << "UNKNOWN";
+}
+
+// static
+const LogitsKernels* LogitsKernels::GetForIsa(LogitsKernelIsa isa) {
+  if (!IsSupported(isa)) {
+    return nullptr;
+  }
+  switch (isa) {
+    case LogitsKernelIsa::kScalar: {
+      static const LogitsKernels* const kernels =
+          new LogitsKernels(isa, kScalarPrimitives);
+      return kernels;
+    }
+#if defined(LITERT_LM_LOGITS_KERNELS_NEON)
+    case LogitsKernelIsa::kNeon: {
+      static const LogitsKernels* const kernels =
+          new LogitsKernels(isa, kNeonPrimitives);
+      return kernels;
+    }
+#endif
+#if defined(LITERT_LM_LOGITS_KERNELS_X86)
+    case LogitsKernelIsa::kAvx2: {
+      static const LogitsKernels* const kernels =
+          new LogitsKernels(isa, kAvx2Primitives);
+      return kernels;
+    }
+    case LogitsKernelIsa::kAvx512: {
+      static const LogitsKernels* const kernels =
+          new LogitsKernels(isa, kAvx512Primitives);
+      return kernels;
+    }
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+// static
+const LogitsKernels& LogitsKernels::Get() {
+  static const LogitsKernels* const kernels = []() {
+    for (const LogitsKernelIsa isa :
+         {LogitsKernelIsa::kAvx512, LogitsKernelIsa::kAvx2,
+          LogitsKernelIsa::kNeon}) {
+      if (const LogitsKernels* kernels = GetForIsa(isa); kernels != nullptr) {
+        return kernels;
+      }
+    }
+    return GetForIsa(LogitsKernelIsa::kScalar);
+  }();
+  return *kernels;
+}
+
+float LogitsKernels::ComputeLogSumExp(absl::Span<const float> logits,
+                                      float temperature) const {
+  const float scale = 1.0f / temperature;
+  // Subtracting the maximum keeps the exponentials in range.
+  const float max = primitives_.max(logits.data(), logits.size()) * scale;
+  return max + std::log(primitives_.sum_exp(logits.data(), logits.size(),
+                                            scale, -max));
+}
+
+void LogitsKernels::ComputeLogSoftmax(absl::Span<const float> logits,
+                                      float temperature,
+                                      absl::Span<float> log_probs) const {
+  const float scale = 1.0f / temperature;
+  const float log_sum_exp = ComputeLogSumExp(logits, temperature);
+  for (int i = 0; i < logits.size(); ++i) {
+    log_probs[i] = logits[i] * scale - log_sum_exp;
+  }
+}
+
+absl::StatusOr<std::vector<float>> LogitsKernels::ComputeLogLikelihoods(
+    absl::Span<const float> logits, absl::Span<const int> token_ids,
+    float temperature) const {
+  if (auto status = ValidateTemperature(temperature); !status.ok()) {
+    return status;
+  }
+  if (token_ids.empty() || logits.size() % token_ids.size() != 0 ||
+      logits.size() == 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The logits of size ", logits.size(),
+                     " do not match the batch size ", token_ids.size(), "."));
+  }
+  const int vocab_size = logits.size() / token_ids.size();
+  std::vector<float> log_likelihoods(token_ids.size());
+  for (int i = 0; i < token_ids.size(); ++i) {
+    if (token_ids[i] < 0 || token_ids[i] >= vocab_size) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Token id ", token_ids[i], " is out of the vocabulary ",
+                       "of size ", vocab_size, "."));
+    }
+    const absl::Span<const float> row =
+        logits.subspan(i * vocab_size, vocab_size);
+    log_likelihoods[i] = row[token_ids[i]] / temperature -
+                         ComputeLogSumExp(row, temperature);
+  }
+  return log_likelihoods;
+}
+
+absl::Status LogitsKernels::ApplyTokenBitmask(
+    absl::Span<const uint32_t> bitmask, absl::Span<float> logits) const {
+  if (bitmask.size() < (logits.size() + 31) / 32) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The bitmask of ", bitmask.size(), " words does not ",
+                     "cover the ", logits.size(), " logits."));
+  }
+  primitives_.mask(bitmask.data(), logits.data(), logits.size(),
+                   std::numeric_limits<float>::lowest());
+  return absl::OkStatus();
+}
+
+absl::Status LogitsKernels::ApplyMinP(float min_p, float temperature,
+                                      absl::Span<float> logits) const {
+  if (!(min_p >= 0.0f && min_p <= 1.0f)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("min_p must be in [0, 1], got ", min_p, "."));
+  }
+  if (auto status = ValidateTemperature(temperature); !status.ok()) {
+    return status;
+  }
+  if (min_p == 0.0f || logits.empty()) {
+    return absl::OkStatus();
+  }
+  // p_i >= min_p * p_max if (logit_i - max) / temperature >= log(min_p).
+  const float threshold = primitives_.max(logits.data(), logits.size()) +
+                          temperature * std::log(min_p);
+  primitives_.mask_below(logits.data(), logits.size(), threshold,
+                         std::numeric_limits<float>::lowest());
+  return absl::OkStatus();
+}
+
+std::vector<int> LogitsKernels::SelectTopK(absl::Span<const float> logits,
+                                           int k) const {
+  k = std::min<int>(k, logits.size());
+  if (k <= 0) {
+    return {};
+  }
+  // A heap of the top k so far, whose front is the k-th largest logit, the
+  // one of the highest index among equal ones.
+  const auto is_better = [](const std::pair<float, int>& a,
+                            const std::pair<float, int>& b) {
+    return a.first > b.first || (a.first == b.first && a.second < b.second);
+  };
+  std::vector<std::pair<float, int>> top_k;
+  top_k.reserve(k);
+  for (int i = 0; i < k; ++i) {
+    top_k.emplace_back(logits[i], i);
+  }
+  std::make_heap(top_k.begin(), top_k.end(), is_better);
+  // Most logits are below the k-th largest so far, the vectorized search
+  // skips them.
+  const int size = logits.size();
+  for (int i = primitives_.find_greater(logits.data(), k, size,
+                                        top_k.front().first);
+       i < size; i = primitives_.find_greater(logits.data(), i + 1, size,
+                                              top_k.front().first)) {
+    std::pop_heap(top_k.begin(), top_k.end(), is_better);
+    top_k.back() = {logits[i], i};
+    std::push_heap(top_k.begin(), top_k.end(), is_better);
+  }
+  std::sort_heap(top_k.begin(), top_k.end(), is_better);
+  std::vector<int> indices(k);
+  for (int i = 0; i < k; ++i) {
+    indices[i] = top_k[i].second;
+  }
+  return indices;
+}
+
+absl::StatusOr<std::vector<int>> LogitsKernels::SelectTopP(
+    absl::Span<const float> logits, float p, float temperature,
+    int max_k) const {
+  if (auto status = ValidateTemperature(temperature); !status.ok()) {
+    return status;
+  }
+  if (!(p > 0.0f && p <= 1.0f)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Top-p must be in (0, 1], got ", p, "."));
+  }
+  if (logits.empty()) {
+    return absl::InvalidArgumentError("The logits must not be empty.");
+  }
+  const int limit =
+      max_k > 0 ? std::min<int>(max_k, logits.size()) : logits.size();
+  const float log_sum_exp = ComputeLogSumExp(logits, temperature);
+  // The nucleus is usually small: select a few candidates and only widen the
+  // selection if their probabilities fall short of p.
+  constexpr int kInitialNumCandidates = 64;
+  int k = std::min(limit, kInitialNumCandidates);
+  while (true) {
+    std::vector<int> top_k = SelectTopK(logits, k);
+    float cumulative_probability = 0.0f;
+    for (int i = 0; i < top_k.size(); ++i) {
+      cumulative_probability +=
+          std::exp(logits[top_k[i]] / temperature - log_sum_exp);
+      if (cumulative_probability >= p) {
+        top_k.resize(i + 1);
+        return top_k;
+      }
+    }
+    if (k == limit) {
+      return top_k;
+    }
+    k = std::min(limit, k * 4);
+  }
+}
+
+}  // namespace litert::lm
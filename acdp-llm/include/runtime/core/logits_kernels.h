@@ -0,0 +1,128 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LOGITS_KERNELS_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LOGITS_KERNELS_H_
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// The instruction sets the logits kernels are vectorized for.
+enum class LogitsKernelIsa {
+  kScalar,
+  kNeon,
+  kAvx2,
+  kAvx512,
+};
+std::ostream& operator<<(std::ostream& os, LogitsKernelIsa isa);
+
+// Vectorized CPU kernels over the logits of a vocabulary, for scoring and
+// sampling on the host. The instruction set is picked at runtime among the
+// ones supported by the CPU, so a single binary runs the fastest kernels
+// everywhere.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(std::vector<float> log_likelihoods,
+//                    LogitsKernels::Get().ComputeLogLikelihoods(
+//                        logits, token_ids, temperature));
+class LogitsKernels {
+ public:
+  // Returns the kernels of the best instruction set supported by the CPU.
+  static const LogitsKernels& Get();
+
+  // Returns the kernels of `isa`, or nullptr if the CPU or the build does not
+  // support it.
+  static const LogitsKernels* GetForIsa(LogitsKernelIsa isa);
+
+  LogitsKernelIsa GetIsa() const { return isa_; }
+
+  // Returns log(sum(exp(logits / temperature))), computed without overflow.
+  // The logits must not be empty.
+  float ComputeLogSumExp(absl::Span<const float> logits,
+                         float temperature) const;
+
+  // Computes the log-softmax of `logits / temperature` into `log_probs`, of
+  // the same size. The logits must not be empty.
+  void ComputeLogSoftmax(absl::Span<const float> logits, float temperature,
+                         absl::Span<float> log_probs) const;
+
+  // Returns, for each entry of the batch, the log-likelihood of its token
+  // under the softmax of its logits. The logits are of shape
+  // [token_ids.size(), vocab_size].
+  absl::StatusOr<std::vector<float>> ComputeLogLikelihoods(
+      absl::Span<const float> logits, absl::Span<const int> token_ids,
+      float temperature) const;
+
+  // Returns the indices of the `k` largest logits, from the largest. Ties
+  // keep the lower indices.
+  std::vector<int> SelectTopK(absl::Span<const float> logits, int k) const;
+
+  // Returns the indices of the smallest set of largest logits whose
+  // probabilities under the softmax of `logits / temperature` sum up to at
+  // least `p`, from the largest, and at most `max_k` of them if positive.
+  absl::StatusOr<std::vector<int>> SelectTopP(absl::Span<const float> logits,
+                                              float p, float temperature,
+                                              int max_k = 0) const;
+
+  // Masks out the logits of the tokens not allowed by `bitmask`, by setting
+  // them to the lowest float. Token i is allowed if bit i % 32 of word i / 32
+  // is set, as in the token bitmasks of the constrained decoding. Fails if the
+  // bitmask does not cover all the logits.
+  absl::Status ApplyTokenBitmask(absl::Span<const uint32_t> bitmask,
+                                 absl::Span<float> logits) const;
+
+  // Masks out the logits of the tokens whose probability under the softmax of
+  // `logits / temperature` is below `min_p` times the probability of the most
+  // likely token, by setting them to the lowest float (min-p sampling). A
+  // `min_p` of 0 keeps all the logits.
+  absl::Status ApplyMinP(float min_p, float temperature,
+                         absl::Span<float> logits) const;
+
+  // The primitives the kernels are built on, one implementation per
+  // instruction set.
+  struct Primitives {
+    // Returns the maximum of `size` > 0 values.
+    float (*max)(const float* data, int size);
+    // Returns the sum of exp(data[i] * scale + offset).
+    float (*sum_exp)(const float* data, int size, float scale, float offset);
+    // Returns the first index in [begin, size) whose value is greater than
+    // `threshold`, or `size` if none.
+    int (*find_greater)(const float* data, int begin, int size,
+                        float threshold);
+    // Sets the values whose bit is not set in `bitmask` to `masked_value`.
+    void (*mask)(const uint32_t* bitmask, float* data, int size,
+                 float masked_value);
+    // Sets the values lower than `threshold` to `masked_value`.
+    void (*mask_below)(float* data, int size, float threshold,
+                       float masked_value);
+  };
+
+ private:
+  LogitsKernels(LogitsKernelIsa isa, const Primitives& primitives)
+      : isa_(isa), primitives_(primitives) {}
+
+  const LogitsKernelIsa isa_;
+  const Primitives primitives_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LOGITS_KERNELS_H_
@@ -0,0 +1,236 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/logits_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::FloatNear;
+using ::testing::status::StatusIs;
+
+std::vector<float> RandomLogits(int size, int seed) {
+  std::mt19937 generator(seed);
+  std::normal_distribution<float> distribution(0.0f, 4.0f);
+  std::vector<float> logits(size);
+  for (float& logit : logits) {
+    logit = distribution(generator);
+  }
+  return logits;
+}
+
+double ReferenceLogSumExp(const std::vector<float>& logits,
+                          float temperature) {
+  const double max = *std::max_element(logits.begin(), logits.end());
+  double sum = 0.0;
+  for (const float logit : logits) {
+    sum += std::exp((logit - max) / temperature);
+  }
+  return max / temperature + std::log(sum);
+}
+
+class LogitsKernelsTest : public testing::TestWithParam<LogitsKernelIsa> {
+ protected:
+  void SetUp() override {
+    kernels_ = LogitsKernels::GetForIsa(GetParam());
+    if (kernels_ == nullptr) {
+      GTEST_SKIP() << GetParam() << " is not supported.";
+    }
+  }
+
+  const LogitsKernels* kernels_ = nullptr;
+};
+
+TEST_P(LogitsKernelsTest, ComputesTheLogSumExp) {
+  // Covers the vector bodies and the scalar tails.
+  for (const int size : {1, 5, 16, 37, 1000, 262144}) {
+    for (const float temperature : {1.0f, 0.5f, 2.0f}) {
+      const std::vector<float> logits = RandomLogits(size, size);
+      EXPECT_NEAR(kernels_->ComputeLogSumExp(logits, temperature),
+                  ReferenceLogSumExp(logits, temperature), 1e-3)
+          << absl::StrCat("size=", size, " temperature=", temperature);
+    }
+  }
+}
+
+TEST_P(LogitsKernelsTest, ComputesTheLogSoftmax) {
+  const std::vector<float> logits = {1.0f, 2.0f, 3.0f, -100.0f, 1000.0f};
+  std::vector<float> log_probs(logits.size());
+  kernels_->ComputeLogSoftmax(logits, /*temperature=*/1.0f,
+                              absl::MakeSpan(log_probs));
+  EXPECT_THAT(log_probs,
+              ElementsAre(FloatNear(-999.0f, 1e-3), FloatNear(-998.0f, 1e-3),
+                          FloatNear(-997.0f, 1e-3), FloatNear(-1100.0f, 1e-3),
+                          FloatNear(0.0f, 1e-5)));
+}
+
+TEST_P(LogitsKernelsTest, ComputesTheLogLikelihoods) {
+  const std::vector<float> logits = {0.0f, 0.0f, 0.0f, 0.0f,
+                                     0.0f, 0.0f, 0.0f, 10.0f};
+  ASSERT_OK_AND_ASSIGN(std::vector<float> log_likelihoods,
+                       kernels_->ComputeLogLikelihoods(
+                           logits, /*token_ids=*/{2, 3}, /*temperature=*/1.0f));
+  const float log_sum_exp = std::log(3.0f + std::exp(10.0f));
+  EXPECT_THAT(log_likelihoods,
+              ElementsAre(FloatNear(std::log(0.25f), 1e-5),
+                          FloatNear(10.0f - log_sum_exp, 1e-5)));
+}
+
+TEST_P(LogitsKernelsTest, ComputeLogLikelihoodsFailsWithInvalidInputs) {
+  const std::vector<float> logits(6, 0.0f);
+  EXPECT_THAT(kernels_->ComputeLogLikelihoods(logits, {0, 1, 2, 3}, 1.0f),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(kernels_->ComputeLogLikelihoods(logits, {0, 3}, 1.0f),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(kernels_->ComputeLogLikelihoods(logits, {0}, 0.0f),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_P(LogitsKernelsTest, SelectsTheTopK) {
+  const std::vector<float> logits = RandomLogits(100000, /*seed=*/1);
+  std::vector<int> expected(logits.size());
+  std::iota(expected.begin(), expected.end(), 0);
+  std::stable_sort(expected.begin(), expected.end(),
+                   [&](int a, int b) { return logits[a] > logits[b]; });
+  for (const int k : {1, 40, 1000}) {
+    EXPECT_EQ(kernels_->SelectTopK(logits, k),
+              std::vector<int>(expected.begin(), expected.begin() + k));
+  }
+  EXPECT_EQ(kernels_->SelectTopK(logits, 200000).size(), logits.size());
+  EXPECT_TRUE(kernels_->SelectTopK(logits, 0).empty());
+}
+
+TEST_P(LogitsKernelsTest, SelectTopKKeepsTheLowerIndicesOfTies) {
+  const std::vector<float> logits = {1.0f, 3.0f, 2.0f, 3.0f, 1.0f,
+                                     3.0f, 0.0f, 2.0f, 0.0f, 3.0f};
+  EXPECT_THAT(kernels_->SelectTopK(logits, 3), ElementsAre(1, 3, 5));
+  EXPECT_THAT(kernels_->SelectTopK(logits, 5), ElementsAre(1, 3, 5, 9, 2));
+}
+
+TEST_P(LogitsKernelsTest, SelectsTheTopP) {
+  // The probabilities are about 0.665, 0.245, 0.090 and 0.
+  const std::vector<float> logits = {0.0f, 2.0f, -100.0f, 1.0f};
+  std::vector<int> top_p;
+  ASSERT_OK_AND_ASSIGN(top_p, kernels_->SelectTopP(logits, /*p=*/0.5f,
+                                                   /*temperature=*/1.0f));
+  EXPECT_THAT(top_p, ElementsAre(1));
+  ASSERT_OK_AND_ASSIGN(top_p, kernels_->SelectTopP(logits, /*p=*/0.9f,
+                                                   /*temperature=*/1.0f));
+  EXPECT_THAT(top_p, ElementsAre(1, 3));
+  ASSERT_OK_AND_ASSIGN(top_p, kernels_->SelectTopP(logits, /*p=*/0.95f,
+                                                   /*temperature=*/1.0f));
+  EXPECT_THAT(top_p, ElementsAre(1, 3, 0));
+  ASSERT_OK_AND_ASSIGN(top_p, kernels_->SelectTopP(logits, /*p=*/0.95f,
+                                                   /*temperature=*/1.0f,
+                                                   /*max_k=*/2));
+  EXPECT_THAT(top_p, ElementsAre(1, 3));
+  EXPECT_THAT(kernels_->SelectTopP(logits, /*p=*/0.0f, /*temperature=*/1.0f),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_P(LogitsKernelsTest, SelectTopPWidensTheSelection) {
+  // Uniform logits need all the candidates.
+  const std::vector<float> logits(1000, 0.0f);
+  ASSERT_OK_AND_ASSIGN(std::vector<int> top_p,
+                       kernels_->SelectTopP(logits, /*p=*/0.5f,
+                                            /*temperature=*/1.0f));
+  EXPECT_NEAR(top_p.size(), 500, 1);
+}
+
+TEST_P(LogitsKernelsTest, AppliesTheTokenBitmask) {
+  // Covers the words allowing all, some and none of their tokens, and the
+  // scalar tails.
+  for (const int size : {5, 32, 100, 1000}) {
+    std::vector<uint32_t> bitmask((size + 31) / 32);
+    for (int i = 0; i < bitmask.size(); ++i) {
+      const uint32_t some = 0x9249249Au + i;
+      bitmask[i] = i % 3 == 0 ? ~uint32_t{0} : (i % 3 == 1 ? 0 : some);
+    }
+    const std::vector<float> logits = RandomLogits(size, size);
+    std::vector<float> masked_logits = logits;
+    ASSERT_OK(kernels_->ApplyTokenBitmask(bitmask,
+                                          absl::MakeSpan(masked_logits)));
+    for (int i = 0; i < size; ++i) {
+      const bool allowed = (bitmask[i / 32] >> (i % 32)) & 1;
+      EXPECT_EQ(masked_logits[i],
+                allowed ? logits[i] : std::numeric_limits<float>::lowest())
+          << absl::StrCat("size=", size, " i=", i);
+    }
+  }
+}
+
+TEST_P(LogitsKernelsTest, ApplyTokenBitmaskFailsWithAShortBitmask) {
+  std::vector<float> logits(33, 0.0f);
+  const std::vector<uint32_t> bitmask = {~uint32_t{0}};
+  EXPECT_THAT(kernels_->ApplyTokenBitmask(bitmask, absl::MakeSpan(logits)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_P(LogitsKernelsTest, AppliesMinP) {
+  for (const int size : {5, 16, 100, 1000}) {
+    const std::vector<float> logits = RandomLogits(size, size);
+    const float max = *std::max_element(logits.begin(), logits.end());
+    std::vector<float> masked_logits = logits;
+    ASSERT_OK(kernels_->ApplyMinP(/*min_p=*/0.1f, /*temperature=*/2.0f,
+                                  absl::MakeSpan(masked_logits)));
+    for (int i = 0; i < size; ++i) {
+      const bool kept = std::exp((logits[i] - max) / 2.0f) >= 0.1f;
+      EXPECT_EQ(masked_logits[i],
+                kept ? logits[i] : std::numeric_limits<float>::lowest())
+          << absl::StrCat("size=", size, " i=", i);
+    }
+  }
+}
+
+TEST_P(LogitsKernelsTest, ApplyMinPFailsWithAnInvalidMinP) {
+  std::vector<float> logits(8, 0.0f);
+  EXPECT_THAT(kernels_->ApplyMinP(/*min_p=*/1.5f, /*temperature=*/1.0f,
+                                  absl::MakeSpan(logits)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    LogitsKernelsTest, LogitsKernelsTest,
+    testing::Values(LogitsKernelIsa::kScalar, LogitsKernelIsa::kNeon,
+                    LogitsKernelIsa::kAvx2, LogitsKernelIsa::kAvx512),
+    [](const testing::TestParamInfo<LogitsKernelIsa>& info) {
+      std::stringstream name;
+      name << info.param;
+      return name.str();
+    });
+
+TEST(LogitsKernelsDispatchTest, PicksASupportedIsa) {
+  const LogitsKernels& kernels = LogitsKernels::Get();
+  EXPECT_EQ(LogitsKernels::GetForIsa(kernels.GetIsa()), &kernels);
+  EXPECT_NE(LogitsKernels::GetForIsa(LogitsKernelIsa::kScalar), nullptr);
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,136 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/logits_processor.h"
+
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/core/logits_kernels.h"
+
+namespace litert::lm {
+
+// static
+absl::StatusOr<std::unique_ptr<LogitsProcessor>> LogitsProcessor::Create(
+    const Options& options, int num_output_candidates, float temperature) {
+  if (num_output_candidates <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The number of output candidates must be positive, got ",
+                     num_output_candidates, "."));
+  }
+  if (!(options.repetition_penalty > 0.0f)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The repetition penalty must be positive, got ",
+                     options.repetition_penalty, "."));
+  }
+  if (!(options.min_p >= 0.0f && options.min_p <= 1.0f)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("min_p must be in [0, 1], got ", options.min_p, "."));
+  }
+  for (const auto& [token_id, bias] : options.logit_bias) {
+    if (token_id < 0) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Invalid token id of the logit bias: ", token_id));
+    }
+  }
+  return std::unique_ptr<LogitsProcessor>(
+      new LogitsProcessor(options, num_output_candidates, temperature));
+}
+
+LogitsProcessor::LogitsProcessor(const Options& options,
+                                 int num_output_candidates, float temperature)
+    : options_(options),
+      temperature_(temperature),
+      candidates_(num_output_candidates) {
+  for (CandidateState& candidate : candidates_) {
+    for (const auto& [token_id, bias] : options_.logit_bias) {
+      candidate.indices[token_id] = candidate.adjustments.size();
+      candidate.adjustments.push_back(GetAdjustment(token_id, /*count=*/0));
+      candidate.counts.push_back(0);
+    }
+  }
+}
+
+LogitsProcessor::TokenAdjustment LogitsProcessor::GetAdjustment(
+    int token_id, int count) const {
+  TokenAdjustment adjustment = {.token_id = token_id};
+  if (auto it = options_.logit_bias.find(token_id);
+      it != options_.logit_bias.end()) {
+    adjustment.offset = it->second;
+  }
+  if (count > 0) {
+    adjustment.positive_scale = 1.0f / options_.repetition_penalty;
+    adjustment.negative_scale = options_.repetition_penalty;
+    adjustment.offset -=
+        options_.frequency_penalty * count + options_.presence_penalty;
+  }
+  return adjustment;
+}
+
+absl::Status LogitsProcessor::Apply(absl::Span<float> logits) const {
+  const int num_candidates = candidates_.size();
+  if (logits.empty() || logits.size() % num_candidates != 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The ", logits.size(), " logits are not a multiple of ",
+                     "the ", num_candidates, " output candidates."));
+  }
+  const int vocab_size = logits.size() / num_candidates;
+  const LogitsKernels& kernels = LogitsKernels::Get();
+  for (int i = 0; i < num_candidates; ++i) {
+    absl::Span<float> candidate_logits =
+        logits.subspan(i * vocab_size, vocab_size);
+    for (const TokenAdjustment& adjustment : candidates_[i].adjustments) {
+      if (adjustment.token_id >= vocab_size) {
+        continue;
+      }
+      float& logit = candidate_logits[adjustment.token_id];
+      logit = logit * (logit > 0.0f ? adjustment.positive_scale
+                                    : adjustment.negative_scale) +
+              adjustment.offset;
+    }
+    // Greedy sampling always picks a token kept by min-p.
+    if (options_.min_p > 0.0f && temperature_ > 0.0f) {
+      if (auto status =
+              kernels.ApplyMinP(options_.min_p, temperature_, candidate_logits);
+          !status.ok()) {
+        return status;
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+void LogitsProcessor::Update(absl::Span<const int> token_ids) {
+  for (int i = 0; i < token_ids.size() && i < candidates_.size(); ++i) {
+    const int token_id = token_ids[i];
+    if (token_id < 0) {
+      continue;
+    }
+    CandidateState& candidate = candidates_[i];
+    auto [it, inserted] =
+        candidate.indices.try_emplace(token_id, candidate.adjustments.size());
+    if (inserted) {
+      candidate.adjustments.push_back({});
+      candidate.counts.push_back(0);
+    }
+    const int count = ++candidate.counts[it->second];
+    candidate.adjustments[it->second] = GetAdjustment(token_id, count);
+  }
+}
+
+}  // namespace litert::lm
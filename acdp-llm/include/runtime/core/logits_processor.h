@@ -0,0 +1,113 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LOGITS_PROCESSOR_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LOGITS_PROCESSOR_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/engine/io_types.h"
+
+namespace litert::lm {
+
+// Applies the transformations of DecodeConfig::LogitsProcessingOptions to the
+// logits of the output candidates before sampling, all of them in one pass
+// per candidate. The penalties and the biases are kept as a sparse list of
+// adjustments per candidate, updated with the tokens sampled by each step, so
+// that a step only touches the penalized and the biased tokens instead of
+// scanning the vocabulary once per transformation. Min-p is then a single
+// vectorized pass over the logits, see LogitsKernels::ApplyMinP.
+//
+// The executors sampling on the device apply the same adjustments and min-p
+// themselves, see LogitsProcessingLlmExecutor.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(auto processor,
+//                    LogitsProcessor::Create(options, num_output_candidates,
+//                                            temperature));
+//   // At each decode step:
+//   RETURN_IF_ERROR(processor->Apply(logits));
+//   // Sample `token_ids` from the logits, then:
+//   processor->Update(token_ids);
+class LogitsProcessor {
+ public:
+  using Options = DecodeConfig::LogitsProcessingOptions;
+
+  // The transformation of the logit of a token: multiplied by
+  // `positive_scale` if positive, by `negative_scale` otherwise, then
+  // `offset` added.
+  struct TokenAdjustment {
+    int token_id = 0;
+    float positive_scale = 1.0f;
+    float negative_scale = 1.0f;
+    float offset = 0.0f;
+  };
+
+  // Creates the processor of `num_output_candidates` candidates, sampled at
+  // `temperature`, which min-p is relative to. A non-positive temperature
+  // stands for greedy sampling, which min-p does not change.
+  static absl::StatusOr<std::unique_ptr<LogitsProcessor>> Create(
+      const Options& options, int num_output_candidates, float temperature);
+
+  LogitsProcessor(const LogitsProcessor&) = delete;
+  LogitsProcessor& operator=(const LogitsProcessor&) = delete;
+
+  // Applies the processing to `logits`, of shape
+  // [num_output_candidates, vocab_size], in place. The adjustments of the
+  // tokens out of the vocabulary are ignored.
+  absl::Status Apply(absl::Span<float> logits) const;
+
+  // Records the tokens sampled by a decode step, one per candidate, for the
+  // penalties of the next steps.
+  void Update(absl::Span<const int> token_ids);
+
+  // Returns the adjustments of the logits of the candidate, one per penalized
+  // or biased token, in no particular order. Valid until the next Update().
+  absl::Span<const TokenAdjustment> GetAdjustments(int candidate) const {
+    return candidates_[candidate].adjustments;
+  }
+
+  float GetMinP() const { return options_.min_p; }
+
+  float GetTemperature() const { return temperature_; }
+
+ private:
+  // The adjustments of a candidate, and the number of times each of their
+  // tokens has been sampled.
+  struct CandidateState {
+    std::vector<TokenAdjustment> adjustments;
+    std::vector<int> counts;
+    // The index of the adjustment of each token.
+    absl::flat_hash_map<int, int> indices;
+  };
+
+  LogitsProcessor(const Options& options, int num_output_candidates,
+                  float temperature);
+
+  // Returns the adjustment of a token sampled `count` times.
+  TokenAdjustment GetAdjustment(int token_id, int count) const;
+
+  const Options options_;
+  const float temperature_;
+  std::vector<CandidateState> candidates_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LOGITS_PROCESSOR_H_
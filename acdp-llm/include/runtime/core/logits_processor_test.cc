@@ -0,0 +1,109 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/logits_processor.h"
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/engine/io_types.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::FloatEq;
+using ::testing::status::StatusIs;
+
+TEST(LogitsProcessorTest, AppliesThePenaltiesOfTheSampledTokens) {
+  LogitsProcessor::Options options;
+  options.repetition_penalty = 2.0f;
+  options.frequency_penalty = 0.5f;
+  options.presence_penalty = 1.0f;
+  ASSERT_OK_AND_ASSIGN(auto processor,
+                       LogitsProcessor::Create(options,
+                                               /*num_output_candidates=*/2,
+                                               /*temperature=*/1.0f));
+  processor->Update({1, 2});
+  processor->Update({1, 3});
+  std::vector<float> logits = {4.0f, 4.0f, -4.0f, 4.0f,   // Candidate 0.
+                               4.0f, 4.0f, -4.0f, 4.0f};  // Candidate 1.
+  ASSERT_OK(processor->Apply(absl::MakeSpan(logits)));
+  // Token 1 of candidate 0 was sampled twice: 4 / 2 - 2 * 0.5 - 1.
+  // Tokens 2 and 3 of candidate 1 were sampled once: -4 * 2 - 0.5 - 1 and
+  // 4 / 2 - 0.5 - 1.
+  EXPECT_THAT(logits, ElementsAre(FloatEq(4.0f), FloatEq(0.0f), FloatEq(-4.0f),
+                                  FloatEq(4.0f), FloatEq(4.0f), FloatEq(4.0f),
+                                  FloatEq(-9.5f), FloatEq(0.5f)));
+}
+
+TEST(LogitsProcessorTest, AppliesTheLogitBiasAndMinP) {
+  LogitsProcessor::Options options;
+  options.logit_bias = {{0, 2.0f}, {5, 1.0f}};
+  options.min_p = 0.5f;
+  ASSERT_OK_AND_ASSIGN(auto processor,
+                       LogitsProcessor::Create(options,
+                                               /*num_output_candidates=*/1,
+                                               /*temperature=*/1.0f));
+  // Token 5 is out of the vocabulary.
+  EXPECT_EQ(processor->GetAdjustments(0).size(), 2);
+  std::vector<float> logits = {0.0f, 2.0f, 1.0f};
+  ASSERT_OK(processor->Apply(absl::MakeSpan(logits)));
+  // Only the tokens within log(2) of the best logit are kept.
+  constexpr float kMasked = std::numeric_limits<float>::lowest();
+  EXPECT_THAT(logits,
+              ElementsAre(FloatEq(2.0f), FloatEq(2.0f), FloatEq(kMasked)));
+}
+
+TEST(LogitsProcessorTest, GreedySamplingIgnoresMinP) {
+  LogitsProcessor::Options options;
+  options.min_p = 0.9f;
+  ASSERT_OK_AND_ASSIGN(auto processor,
+                       LogitsProcessor::Create(options,
+                                               /*num_output_candidates=*/1,
+                                               /*temperature=*/0.0f));
+  std::vector<float> logits = {0.0f, 2.0f, 1.0f};
+  ASSERT_OK(processor->Apply(absl::MakeSpan(logits)));
+  EXPECT_THAT(logits, ElementsAre(0.0f, 2.0f, 1.0f));
+}
+
+TEST(LogitsProcessorTest, FailsWithInvalidOptionsOrLogits) {
+  LogitsProcessor::Options options;
+  options.repetition_penalty = 0.0f;
+  EXPECT_THAT(LogitsProcessor::Create(options, /*num_output_candidates=*/1,
+                                      /*temperature=*/1.0f),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  options.repetition_penalty = 1.0f;
+  options.min_p = 2.0f;
+  EXPECT_THAT(LogitsProcessor::Create(options, /*num_output_candidates=*/1,
+                                      /*temperature=*/1.0f),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  ASSERT_OK_AND_ASSIGN(auto processor,
+                       LogitsProcessor::Create(LogitsProcessor::Options(),
+                                               /*num_output_candidates=*/2,
+                                               /*temperature=*/1.0f));
+  std::vector<float> logits(3, 0.0f);
+  EXPECT_THAT(processor->Apply(absl::MakeSpan(logits)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace litert::lm
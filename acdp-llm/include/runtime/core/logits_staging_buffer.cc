@@ -0,0 +1,60 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/logits_staging_buffer.h"
+
+#include <cstddef>
+#include <vector>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "litert/cc/litert_macros.h"  // from @litert
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/util/convert_tensor_buffer.h"
+
+namespace litert::lm {
+
+absl::StatusOr<absl::Span<const float>> LogitsStagingBuffer::Stage(
+    litert::TensorBuffer& logits) {
+  if (auto logits_span = ReferTensorBufferAsSpan<float>(logits)) {
+    return absl::Span<const float>(*logits_span);
+  }
+  return Copy(logits);
+}
+
+absl::StatusOr<absl::Span<const float>> LogitsStagingBuffer::Copy(
+    litert::TensorBuffer& logits) {
+  LITERT_ASSIGN_OR_RETURN(size_t logits_size, logits.PackedSize());
+  std::vector<float>& slot = NextSlot(logits_size / sizeof(float));
+  LITERT_RETURN_IF_ERROR(logits.Read(absl::MakeSpan(slot)));
+  return absl::Span<const float>(slot);
+}
+
+size_t LogitsStagingBuffer::GetCapacityInBytes() const {
+  size_t capacity = 0;
+  for (const std::vector<float>& slot : slots_) {
+    capacity += slot.capacity() * sizeof(float);
+  }
+  return capacity;
+}
+
+std::vector<float>& LogitsStagingBuffer::NextSlot(size_t num_floats) {
+  std::vector<float>& slot = slots_[next_slot_];
+  next_slot_ = (next_slot_ + 1) % kNumSlots;
+  // Keeps the capacity, the vocabulary size does not change across steps.
+  slot.resize(num_floats);
+  return slot;
+}
+
+}  // namespace litert::lm
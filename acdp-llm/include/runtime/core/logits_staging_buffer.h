@@ -0,0 +1,72 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LOGITS_STAGING_BUFFER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LOGITS_STAGING_BUFFER_H_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+
+namespace litert::lm {
+
+// Host memory receiving the logits of the executor when they are not
+// host-accessible, e.g. on GPU, reused across the decode steps so that the
+// readback does not allocate. The staging memory alternates between two
+// slots: the logits of a step stay valid while the logits of the next step
+// are read back, so that a step can be consumed while the next one runs.
+//
+// Example usage:
+//   LogitsStagingBuffer staging_buffer;
+//   // After each decode step:
+//   ASSIGN_OR_RETURN(absl::Span<const float> logits,
+//                    staging_buffer.Stage(output_logits));
+class LogitsStagingBuffer {
+ public:
+  static constexpr int kNumSlots = 2;
+
+  LogitsStagingBuffer() = default;
+  LogitsStagingBuffer(const LogitsStagingBuffer&) = delete;
+  LogitsStagingBuffer& operator=(const LogitsStagingBuffer&) = delete;
+
+  // Returns the logits in host memory: in place if they are host-accessible,
+  // otherwise read back into the next slot. In place, the logits are valid as
+  // long as `logits` is unchanged; staged, until the slot is reused two calls
+  // later.
+  absl::StatusOr<absl::Span<const float>> Stage(
+      litert::TensorBuffer& logits);
+
+  // Same as Stage(), but always copies the logits into the next slot, e.g.
+  // when the executor overwrites its output buffer in the next step.
+  absl::StatusOr<absl::Span<const float>> Copy(
+      litert::TensorBuffer& logits);
+
+  // Returns the memory allocated for the slots, in bytes.
+  size_t GetCapacityInBytes() const;
+
+ private:
+  // Returns the next slot, resized to hold `num_floats` values.
+  std::vector<float>& NextSlot(size_t num_floats);
+
+  std::array<std::vector<float>, kNumSlots> slots_;
+  int next_slot_ = 0;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LOGITS_STAGING_BUFFER_H_
@@ -0,0 +1,72 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/logits_staging_buffer.h"
+
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/types/span.h"  // from @com_google_absl
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "litert/test/matchers.h"  // from @litert
+#include "runtime/util/convert_tensor_buffer.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+
+litert::TensorBuffer CreateLogits(const std::vector<float>& data) {
+  auto buffer = CopyToTensorBuffer<float>(
+      data, {1, static_cast<int>(data.size())});
+  return std::move(*buffer);
+}
+
+TEST(LogitsStagingBufferTest, StagesHostLogitsInPlace) {
+  LogitsStagingBuffer staging_buffer;
+  auto logits = CreateLogits({1.0f, 2.0f});
+  ASSERT_OK_AND_ASSIGN(absl::Span<const float> staged,
+                       staging_buffer.Stage(logits));
+  EXPECT_THAT(staged, ElementsAre(1.0f, 2.0f));
+  LITERT_ASSERT_OK_AND_ASSIGN(auto logits_span,
+                              ReferTensorBufferAsSpan<float>(logits));
+  EXPECT_EQ(staged.data(), logits_span.data());
+  EXPECT_EQ(staging_buffer.GetCapacityInBytes(), 0);
+}
+
+TEST(LogitsStagingBufferTest, KeepsThePreviousStepWhileCopying) {
+  LogitsStagingBuffer staging_buffer;
+  auto logits = CreateLogits({1.0f, 2.0f, 3.0f});
+  ASSERT_OK_AND_ASSIGN(absl::Span<const float> first,
+                       staging_buffer.Copy(logits));
+  const std::vector<float> next_logits = {4.0f, 5.0f, 6.0f};
+  LITERT_ASSERT_OK(logits.Write<float>(next_logits));
+  ASSERT_OK_AND_ASSIGN(absl::Span<const float> second,
+                       staging_buffer.Copy(logits));
+  EXPECT_THAT(first, ElementsAre(1.0f, 2.0f, 3.0f));
+  EXPECT_THAT(second, ElementsAre(4.0f, 5.0f, 6.0f));
+
+  // The third step reuses the memory of the first one.
+  ASSERT_OK_AND_ASSIGN(absl::Span<const float> third,
+                       staging_buffer.Copy(logits));
+  EXPECT_EQ(third.data(), first.data());
+  EXPECT_EQ(staging_buffer.GetCapacityInBytes(),
+            LogitsStagingBuffer::kNumSlots * 3 * sizeof(float));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,191 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/core/lora_registry.h"
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/nullability.h"  // from @com_google_absl
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/util/lora_data.h"
+#include "runtime/util/status_macros.h"
+
+namespace litert::lm {
+
+// static
+absl::StatusOr<std::unique_ptr<LoraRegistry>> LoraRegistry::Create(
+    LoraLlmExecutor* absl_nonnull executor, size_t max_size_bytes) {
+  if (executor->GetMaxNumLoraAdapters() < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The maximum number of LoRA adapters must not be "
+                     "negative, got ",
+                     executor->GetMaxNumLoraAdapters()));
+  }
+  return absl::WrapUnique(new LoraRegistry(*executor, max_size_bytes));
+}
+
+LoraRegistry::~LoraRegistry() {
+  absl::MutexLock lock(&mutex_);
+  for (auto& [id, entry] : entries_) {
+    if (entry.adapter == nullptr) {
+      continue;
+    }
+    if (auto status = Unload(entry); !status.ok()) {
+      ABSL_LOG(ERROR) << "Failed to unload the LoRA adapter " << id << ": "
+                      << status;
+    }
+  }
+}
+
+absl::Status LoraRegistry::Register(absl::string_view id, LoadFn load) {
+  absl::MutexLock lock(&mutex_);
+  auto [it, inserted] = entries_.try_emplace(id);
+  if (!inserted) {
+    return absl::AlreadyExistsError(
+        absl::StrCat("The LoRA adapter ", id, " is already registered."));
+  }
+  it->second.load = std::move(load);
+  return absl::OkStatus();
+}
+
+absl::Status LoraRegistry::Unregister(absl::string_view id) {
+  absl::MutexLock lock(&mutex_);
+  auto it = entries_.find(id);
+  if (it == entries_.end()) {
+    return absl::NotFoundError(
+        absl::StrCat("The LoRA adapter ", id, " is not registered."));
+  }
+  if (it->second.adapter != nullptr) {
+    if (it->second.adapter.use_count() > 1) {
+      return absl::FailedPreconditionError(
+          absl::StrCat("The LoRA adapter ", id, " is used by a session."));
+    }
+    RETURN_IF_ERROR(Unload(it->second));
+  }
+  entries_.erase(it);
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::shared_ptr<const LoraRegistry::Adapter>>
+LoraRegistry::Acquire(absl::string_view id) {
+  absl::MutexLock lock(&mutex_);
+  auto it = entries_.find(id);
+  if (it == entries_.end()) {
+    return absl::NotFoundError(
+        absl::StrCat("The LoRA adapter ", id, " is not registered."));
+  }
+  Entry& entry = it->second;
+  if (entry.adapter != nullptr) {
+    lru_.splice(lru_.begin(), lru_, entry.lru_it);
+    return entry.adapter;
+  }
+
+  constexpr int kUnlimited = std::numeric_limits<int>::max();
+  if (max_num_adapters_ > 0) {
+    RETURN_IF_ERROR(EvictUnusedAdapters(max_num_adapters_ - 1,
+                                        std::numeric_limits<size_t>::max()));
+    if (static_cast<int>(lru_.size()) >= max_num_adapters_) {
+      return absl::ResourceExhaustedError(absl::StrCat(
+          "All the ", max_num_adapters_,
+          " LoRA adapters of the executor are used, can not load ", id, "."));
+    }
+  }
+  int lora_id = 0;
+  while (lora_id < static_cast<int>(used_lora_ids_.size()) &&
+         used_lora_ids_[lora_id]) {
+    ++lora_id;
+  }
+  ASSIGN_OR_RETURN(std::unique_ptr<LoraData> data, entry.load());
+  ASSIGN_OR_RETURN(size_t size_in_bytes,
+                   executor_.LoadLoraAdapter(lora_id, *data));
+  if (lora_id == static_cast<int>(used_lora_ids_.size())) {
+    used_lora_ids_.push_back(true);
+  } else {
+    used_lora_ids_[lora_id] = true;
+  }
+  entry.adapter = std::shared_ptr<Adapter>(
+      new Adapter(it->first, lora_id, std::move(data), size_in_bytes));
+  entry.lru_it = lru_.insert(lru_.begin(), it->first);
+  size_in_bytes_ += size_in_bytes;
+  ABSL_LOG(INFO) << "Loaded the LoRA adapter " << id << " as " << lora_id
+                 << ", " << size_in_bytes << " bytes.";
+
+  // Referenced first, so that the new adapter is kept.
+  std::shared_ptr<const Adapter> adapter = entry.adapter;
+  if (max_size_bytes_ > 0) {
+    RETURN_IF_ERROR(EvictUnusedAdapters(kUnlimited, max_size_bytes_));
+  }
+  return adapter;
+}
+
+bool LoraRegistry::IsRegistered(absl::string_view id) const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.contains(id);
+}
+
+int LoraRegistry::GetNumLoadedAdapters() const {
+  absl::MutexLock lock(&mutex_);
+  return lru_.size();
+}
+
+size_t LoraRegistry::GetSizeInBytes() const {
+  absl::MutexLock lock(&mutex_);
+  return size_in_bytes_;
+}
+
+absl::Status LoraRegistry::Unload(Entry& entry) {
+  const int lora_id = entry.adapter->lora_id();
+  RETURN_IF_ERROR(executor_.UnloadLoraAdapter(lora_id));
+  used_lora_ids_[lora_id] = false;
+  size_in_bytes_ -= entry.adapter->size_in_bytes();
+  lru_.erase(entry.lru_it);
+  entry.adapter.reset();
+  return absl::OkStatus();
+}
+
+absl::Status LoraRegistry::EvictUnusedAdapters(int max_num_adapters,
+                                               size_t max_size_bytes) {
+  // The adapters after `it` are all used.
+  auto it = lru_.end();
+  while (it != lru_.begin() &&
+         (static_cast<int>(lru_.size()) > max_num_adapters ||
+          size_in_bytes_ > max_size_bytes)) {
+    const auto candidate = std::prev(it);
+    Entry& entry = entries_.find(*candidate)->second;
+    if (entry.adapter.use_count() > 1) {
+      it = candidate;
+      continue;
+    }
+    ABSL_LOG(INFO) << "Unloading the least recently used LoRA adapter "
+                   << *candidate << ".";
+    // Erases `candidate` from `lru_`, `it` stays valid.
+    RETURN_IF_ERROR(Unload(entry));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,154 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LORA_REGISTRY_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LORA_REGISTRY_H_
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"  // from @com_google_absl
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/util/lora_data.h"
+
+namespace litert::lm {
+
+// An engine-wide registry of the LoRA adapters of the base model, e.g. the
+// fine-tunes of the tenants served by the engine. The adapters are loaded in
+// the executor on their first use by a session and stay resident after it,
+// so that switching between them needs neither reloading the base model nor
+// recompiling the graph. The least recently used adapters no session uses are
+// unloaded to stay within the memory budget and the number of adapters the
+// executor holds at once.
+//
+// The class is thread-safe. Loading an adapter blocks the other calls.
+//
+// Example usage:
+//   RETURN_IF_ERROR(registry->Register("tenant_a", [] {
+//     return LoraData::CreateFromFilePath("/path/to/tenant_a.tflite");
+//   }));
+//   ASSIGN_OR_RETURN(auto adapter, registry->Acquire("tenant_a"));
+//   RETURN_IF_ERROR(lora_executor->SelectLoraAdapter(adapter->lora_id()));
+class LoraRegistry {
+ public:
+  // Loads the data of an adapter, called again if the adapter is reloaded.
+  using LoadFn =
+      absl::AnyInvocable<absl::StatusOr<std::unique_ptr<LoraData>>()>;
+
+  // An adapter loaded in the executor, which stays loaded while referenced.
+  class Adapter {
+   public:
+    const std::string& id() const { return id_; }
+    // The id of the adapter in the executor.
+    int lora_id() const { return lora_id_; }
+    size_t size_in_bytes() const { return size_in_bytes_; }
+
+   private:
+    friend class LoraRegistry;
+
+    Adapter(std::string id, int lora_id, std::unique_ptr<LoraData> data,
+            size_t size_in_bytes)
+        : id_(std::move(id)),
+          lora_id_(lora_id),
+          data_(std::move(data)),
+          size_in_bytes_(size_in_bytes) {}
+
+    const std::string id_;
+    const int lora_id_;
+    // Kept alive while the executor holds the weights.
+    const std::unique_ptr<LoraData> data_;
+    const size_t size_in_bytes_;
+  };
+
+  // Creates a registry loading the adapters in `executor`, which must outlive
+  // it, keeping up to `max_size_bytes` of unused adapters resident, 0 for no
+  // limit.
+  static absl::StatusOr<std::unique_ptr<LoraRegistry>> Create(
+      LoraLlmExecutor* absl_nonnull executor, size_t max_size_bytes);
+
+  ~LoraRegistry();
+
+  // Registers the adapter of `id`, loaded with `load` when first acquired.
+  // Fails with AlreadyExists if `id` is registered.
+  absl::Status Register(absl::string_view id, LoadFn load);
+
+  // Unregisters the adapter of `id` and unloads it. Fails with
+  // FailedPrecondition while a session uses it.
+  absl::Status Unregister(absl::string_view id);
+
+  // Returns the adapter of `id`, loading it if needed. The adapter stays
+  // loaded until the returned reference is released. Fails with NotFound if
+  // `id` is not registered, and with ResourceExhausted if the executor holds
+  // the maximum number of adapters, all in use.
+  absl::StatusOr<std::shared_ptr<const Adapter>> Acquire(absl::string_view id);
+
+  // Whether an adapter of `id` is registered.
+  bool IsRegistered(absl::string_view id) const;
+
+  // Returns the number of adapters loaded in the executor.
+  int GetNumLoadedAdapters() const;
+
+  // Returns the memory used by the loaded adapters.
+  size_t GetSizeInBytes() const;
+
+ private:
+  struct Entry {
+    LoadFn load;
+    // Set while the adapter is loaded.
+    std::shared_ptr<Adapter> adapter;
+    // The position of the loaded adapter in `lru_`.
+    std::list<std::string>::iterator lru_it;
+  };
+
+  LoraRegistry(LoraLlmExecutor& executor, size_t max_size_bytes)
+      : executor_(executor),
+        max_size_bytes_(max_size_bytes),
+        max_num_adapters_(executor.GetMaxNumLoraAdapters()) {}
+
+  // Unloads the adapter of `entry`, which no session uses.
+  absl::Status Unload(Entry& entry) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Unloads the least recently used adapters no session uses until at most
+  // `max_num_adapters` adapters of at most `max_size_bytes` are loaded, or
+  // all the remaining ones are used.
+  absl::Status EvictUnusedAdapters(int max_num_adapters, size_t max_size_bytes)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  LoraLlmExecutor& executor_;
+  const size_t max_size_bytes_;
+  const int max_num_adapters_;
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  // The ids of the loaded adapters, most recently acquired first.
+  std::list<std::string> lru_ ABSL_GUARDED_BY(mutex_);
+  // Whether each executor adapter id is used.
+  std::vector<bool> used_lora_ids_ ABSL_GUARDED_BY(mutex_);
+  size_t size_in_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_LORA_REGISTRY_H_
@@ -0,0 +1,214 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/core/lora_registry.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "litert/cc/litert_buffer_ref.h"  // from @litert
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/util/lora_data.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::UnorderedElementsAre;
+using ::testing::status::StatusIs;
+
+constexpr size_t kAdapterSize = 100;
+
+class FakeLoraData : public LoraData {
+ public:
+  absl::StatusOr<int> GetLoRARank() override { return 8; }
+  absl::StatusOr<std::unique_ptr<BufferRef<uint8_t>>> ReadTensor(
+      absl::string_view name) override {
+    return absl::NotFoundError(name);
+  }
+  bool HasTensor(absl::string_view name) const override { return false; }
+};
+
+class FakeLoraExecutor : public LoraLlmExecutor {
+ public:
+  explicit FakeLoraExecutor(int max_num_lora_adapters = 0)
+      : max_num_lora_adapters_(max_num_lora_adapters) {}
+
+  int GetMaxNumLoraAdapters() const override { return max_num_lora_adapters_; }
+
+  absl::StatusOr<size_t> LoadLoraAdapter(int lora_id,
+                                         LoraData& lora) override {
+    if (loaded_.contains(lora_id)) {
+      return absl::InternalError("The adapter is already loaded.");
+    }
+    loaded_[lora_id] = &lora;
+    return kAdapterSize;
+  }
+
+  absl::Status UnloadLoraAdapter(int lora_id) override {
+    if (loaded_.erase(lora_id) == 0) {
+      return absl::InternalError("The adapter is not loaded.");
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status SelectLoraAdapter(int lora_id) override {
+    return absl::OkStatus();
+  }
+
+  int GetNumLoaded() const { return loaded_.size(); }
+
+ private:
+  const int max_num_lora_adapters_;
+  absl::flat_hash_map<int, LoraData*> loaded_;
+};
+
+// Registers the adapters of `ids`, counting their loads in `num_loads`.
+void RegisterAdapters(LoraRegistry& registry,
+                      const std::vector<std::string>& ids,
+                      absl::flat_hash_map<std::string, int>& num_loads) {
+  for (const std::string& id : ids) {
+    ASSERT_OK(registry.Register(
+        id, [&num_loads, id]() -> absl::StatusOr<std::unique_ptr<LoraData>> {
+          ++num_loads[id];
+          return std::make_unique<FakeLoraData>();
+        }));
+  }
+}
+
+TEST(LoraRegistryTest, LoadsTheAdaptersOnce) {
+  FakeLoraExecutor executor;
+  ASSERT_OK_AND_ASSIGN(auto registry,
+                       LoraRegistry::Create(&executor, /*max_size_bytes=*/0));
+  absl::flat_hash_map<std::string, int> num_loads;
+  RegisterAdapters(*registry, {"a", "b"}, num_loads);
+  EXPECT_TRUE(registry->IsRegistered("a"));
+  EXPECT_FALSE(registry->IsRegistered("c"));
+  EXPECT_EQ(registry->GetNumLoadedAdapters(), 0);
+
+  ASSERT_OK_AND_ASSIGN(auto a, registry->Acquire("a"));
+  ASSERT_OK_AND_ASSIGN(auto b, registry->Acquire("b"));
+  ASSERT_OK_AND_ASSIGN(auto a_again, registry->Acquire("a"));
+  EXPECT_EQ(a->id(), "a");
+  EXPECT_EQ(a_again.get(), a.get());
+  EXPECT_NE(a->lora_id(), b->lora_id());
+  EXPECT_EQ(num_loads["a"], 1);
+  EXPECT_EQ(registry->GetNumLoadedAdapters(), 2);
+  EXPECT_EQ(registry->GetSizeInBytes(), 2 * kAdapterSize);
+  EXPECT_EQ(executor.GetNumLoaded(), 2);
+}
+
+TEST(LoraRegistryTest, FailsOnUnknownOrDuplicateAdapters) {
+  FakeLoraExecutor executor;
+  ASSERT_OK_AND_ASSIGN(auto registry,
+                       LoraRegistry::Create(&executor, /*max_size_bytes=*/0));
+  absl::flat_hash_map<std::string, int> num_loads;
+  RegisterAdapters(*registry, {"a"}, num_loads);
+  EXPECT_THAT(registry->Register(
+                  "a",
+                  []() -> absl::StatusOr<std::unique_ptr<LoraData>> {
+                    return std::make_unique<FakeLoraData>();
+                  }),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+  EXPECT_THAT(registry->Acquire("b"), StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_THAT(registry->Unregister("b"),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST(LoraRegistryTest, EvictsTheLeastRecentlyUsedAdapters) {
+  FakeLoraExecutor executor;
+  ASSERT_OK_AND_ASSIGN(
+      auto registry,
+      LoraRegistry::Create(&executor, /*max_size_bytes=*/2 * kAdapterSize));
+  absl::flat_hash_map<std::string, int> num_loads;
+  RegisterAdapters(*registry, {"a", "b", "c"}, num_loads);
+  ASSERT_OK(registry->Acquire("a"));
+  ASSERT_OK(registry->Acquire("b"));
+  // Makes "b" the least recently used.
+  ASSERT_OK(registry->Acquire("a"));
+  ASSERT_OK(registry->Acquire("c"));
+  EXPECT_EQ(registry->GetNumLoadedAdapters(), 2);
+  EXPECT_EQ(registry->GetSizeInBytes(), 2 * kAdapterSize);
+
+  ASSERT_OK(registry->Acquire("a"));
+  ASSERT_OK(registry->Acquire("b"));
+  EXPECT_EQ(num_loads["a"], 1);
+  EXPECT_EQ(num_loads["b"], 2);
+  EXPECT_EQ(executor.GetNumLoaded(), 2);
+}
+
+TEST(LoraRegistryTest, KeepsTheUsedAdapters) {
+  FakeLoraExecutor executor;
+  ASSERT_OK_AND_ASSIGN(
+      auto registry,
+      LoraRegistry::Create(&executor, /*max_size_bytes=*/kAdapterSize));
+  absl::flat_hash_map<std::string, int> num_loads;
+  RegisterAdapters(*registry, {"a", "b", "c"}, num_loads);
+  ASSERT_OK_AND_ASSIGN(auto a, registry->Acquire("a"));
+  ASSERT_OK_AND_ASSIGN(auto b, registry->Acquire("b"));
+  // Over the budget while both are used.
+  EXPECT_EQ(registry->GetSizeInBytes(), 2 * kAdapterSize);
+  EXPECT_THAT(registry->Unregister("a"),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+
+  a.reset();
+  b.reset();
+  ASSERT_OK(registry->Acquire("c"));
+  EXPECT_EQ(registry->GetNumLoadedAdapters(), 1);
+  EXPECT_EQ(executor.GetNumLoaded(), 1);
+}
+
+TEST(LoraRegistryTest, ReusesTheIdsOfTheExecutor) {
+  FakeLoraExecutor executor(/*max_num_lora_adapters=*/2);
+  ASSERT_OK_AND_ASSIGN(auto registry,
+                       LoraRegistry::Create(&executor, /*max_size_bytes=*/0));
+  absl::flat_hash_map<std::string, int> num_loads;
+  RegisterAdapters(*registry, {"a", "b", "c"}, num_loads);
+  ASSERT_OK_AND_ASSIGN(auto a, registry->Acquire("a"));
+  ASSERT_OK_AND_ASSIGN(auto b, registry->Acquire("b"));
+  EXPECT_THAT(registry->Acquire("c"),
+              StatusIs(absl::StatusCode::kResourceExhausted));
+
+  const int lora_id = a->lora_id();
+  a.reset();
+  ASSERT_OK_AND_ASSIGN(auto c, registry->Acquire("c"));
+  EXPECT_EQ(c->lora_id(), lora_id);
+  EXPECT_THAT(std::vector<int>({b->lora_id(), c->lora_id()}),
+              UnorderedElementsAre(0, 1));
+}
+
+TEST(LoraRegistryTest, UnregisterUnloadsTheAdapter) {
+  FakeLoraExecutor executor;
+  ASSERT_OK_AND_ASSIGN(auto registry,
+                       LoraRegistry::Create(&executor, /*max_size_bytes=*/0));
+  absl::flat_hash_map<std::string, int> num_loads;
+  RegisterAdapters(*registry, {"a"}, num_loads);
+  ASSERT_OK(registry->Acquire("a"));
+  ASSERT_OK(registry->Unregister("a"));
+  EXPECT_FALSE(registry->IsRegistered("a"));
+  EXPECT_EQ(registry->GetSizeInBytes(), 0);
+  EXPECT_EQ(executor.GetNumLoaded(), 0);
+}
+
+}  // namespace
+}  // namespace litert::lm
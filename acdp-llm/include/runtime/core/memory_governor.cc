@@ -0,0 +1,137 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/core/memory_governor.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif  // defined(__linux__)
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/util/status_macros.h"  // IWYU pragma: keep
+
+namespace litert::lm {
+
+// static
+absl::StatusOr<std::unique_ptr<MemoryGovernor>> MemoryGovernor::Create(
+    std::vector<Action> actions, size_t max_resident_memory_bytes,
+    absl::Duration poll_interval, ResidentMemoryReader reader) {
+  if (max_resident_memory_bytes > 0) {
+    if (poll_interval <= absl::ZeroDuration()) {
+      return absl::InvalidArgumentError("The poll interval must be positive.");
+    }
+    // Fails early where the resident memory can not be read.
+    RETURN_IF_ERROR(reader().status());
+  }
+  return absl::WrapUnique(new MemoryGovernor(std::move(actions),
+                                             max_resident_memory_bytes,
+                                             poll_interval, std::move(reader)));
+}
+
+MemoryGovernor::MemoryGovernor(std::vector<Action> actions,
+                               size_t max_resident_memory_bytes,
+                               absl::Duration poll_interval,
+                               ResidentMemoryReader reader)
+    : max_resident_memory_bytes_(max_resident_memory_bytes),
+      poll_interval_(poll_interval),
+      actions_(std::move(actions)),
+      reader_(std::move(reader)) {
+  if (max_resident_memory_bytes_ > 0) {
+    watch_thread_ = std::thread([this]() { WatchResidentMemory(); });
+  }
+}
+
+MemoryGovernor::~MemoryGovernor() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stopped_ = true;
+  }
+  if (watch_thread_.joinable()) {
+    watch_thread_.join();
+  }
+}
+
+void MemoryGovernor::NotifyMemoryPressure() {
+  absl::MutexLock lock(&mutex_);
+  ++stats_.num_memory_pressure_signals;
+  ABSL_LOG(WARNING) << "Shedding the caches under memory pressure.";
+  for (Action& action : actions_) {
+    action(stats_);
+  }
+}
+
+MemorySheddingStats MemoryGovernor::GetStats() const {
+  absl::MutexLock lock(&mutex_);
+  return stats_;
+}
+
+// static
+absl::StatusOr<size_t> MemoryGovernor::GetResidentMemoryBytes() {
+#if defined(__linux__)
+  // The second field is the number of resident pages.
+  std::ifstream statm("/proc/self/statm");
+  size_t num_pages = 0;
+  size_t num_resident_pages = 0;
+  if (!(statm >> num_pages >> num_resident_pages)) {
+    return absl::InternalError("Failed to read /proc/self/statm.");
+  }
+  return num_resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+  return absl::UnimplementedError(
+      "The resident memory is only read on Linux and Android.");
+#endif  // defined(__linux__)
+}
+
+void MemoryGovernor::WatchResidentMemory() {
+  absl::MutexLock lock(&mutex_);
+  while (!mutex_.AwaitWithTimeout(absl::Condition(&stopped_), poll_interval_)) {
+    if (!IsOverLimit()) {
+      continue;
+    }
+    ++stats_.num_memory_limit_exceeded;
+    ABSL_LOG(WARNING) << "Shedding the caches over the resident memory limit "
+                      << "of " << max_resident_memory_bytes_ << " bytes.";
+    for (Action& action : actions_) {
+      action(stats_);
+      if (!IsOverLimit()) {
+        break;
+      }
+    }
+  }
+}
+
+bool MemoryGovernor::IsOverLimit() {
+  absl::StatusOr<size_t> resident_memory_bytes = reader_();
+  if (!resident_memory_bytes.ok()) {
+    ABSL_LOG(WARNING) << "Failed to read the resident memory: "
+                      << resident_memory_bytes.status();
+    return false;
+  }
+  return *resident_memory_bytes > max_resident_memory_bytes_;
+}
+
+}  // namespace litert::lm
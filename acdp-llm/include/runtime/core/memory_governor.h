@@ -0,0 +1,110 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_MEMORY_GOVERNOR_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_MEMORY_GOVERNOR_H_
+
+#include <cstddef>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+
+namespace litert::lm {
+
+// Sheds the memory an engine can do without, e.g. its caches and its unused
+// executors, when the resident memory of the process exceeds a limit or when
+// the OS signals memory pressure, rather than letting the process get killed.
+//
+// The shedding actions run in order, the ones releasing the most memory for
+// the least recomputation first. Over the limit, the shedding stops as soon
+// as the resident memory is back under it. Under memory pressure, all the
+// actions run. Each action records what it released in the stats.
+//
+// The class is thread-safe.
+//
+// Example usage:
+//   std::vector<MemoryGovernor::Action> actions;
+//   actions.push_back([&](MemorySheddingStats& stats) {
+//     stats.prefix_cache_bytes_dropped += prefix_kv_cache->Clear();
+//   });
+//   ASSIGN_OR_RETURN(auto governor,
+//                    MemoryGovernor::Create(std::move(actions),
+//                                           /*max_resident_memory_bytes=*/
+//                                           1 << 30));
+//   ...
+//   governor->NotifyMemoryPressure();
+class MemoryGovernor {
+ public:
+  using Action = absl::AnyInvocable<void(MemorySheddingStats& stats)>;
+  using ResidentMemoryReader = absl::AnyInvocable<absl::StatusOr<size_t>()>;
+
+  // Creates a governor shedding with `actions`. If `max_resident_memory_bytes`
+  // is not 0, the resident memory read by `reader` is checked every
+  // `poll_interval` on a background thread.
+  static absl::StatusOr<std::unique_ptr<MemoryGovernor>> Create(
+      std::vector<Action> actions, size_t max_resident_memory_bytes,
+      absl::Duration poll_interval = kDefaultPollInterval,
+      ResidentMemoryReader reader = GetResidentMemoryBytes);
+
+  ~MemoryGovernor();
+
+  MemoryGovernor(const MemoryGovernor&) = delete;
+  MemoryGovernor& operator=(const MemoryGovernor&) = delete;
+
+  // Runs all the actions on the calling thread.
+  void NotifyMemoryPressure();
+
+  MemorySheddingStats GetStats() const;
+
+  // Returns the resident memory of the process. Only supported on Linux and
+  // Android.
+  static absl::StatusOr<size_t> GetResidentMemoryBytes();
+
+  static constexpr absl::Duration kDefaultPollInterval = absl::Seconds(1);
+
+ private:
+  MemoryGovernor(std::vector<Action> actions,
+                 size_t max_resident_memory_bytes, absl::Duration poll_interval,
+                 ResidentMemoryReader reader);
+
+  // Sheds until the resident memory is under the limit, every poll interval,
+  // until the governor is destroyed.
+  void WatchResidentMemory();
+
+  // Returns true if the resident memory is over the limit.
+  bool IsOverLimit() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const size_t max_resident_memory_bytes_;
+  const absl::Duration poll_interval_;
+
+  mutable absl::Mutex mutex_;
+  std::vector<Action> actions_ ABSL_GUARDED_BY(mutex_);
+  ResidentMemoryReader reader_ ABSL_GUARDED_BY(mutex_);
+  MemorySheddingStats stats_ ABSL_GUARDED_BY(mutex_);
+  bool stopped_ ABSL_GUARDED_BY(mutex_) = false;
+
+  std::thread watch_thread_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_MEMORY_GOVERNOR_H_
@@ -0,0 +1,108 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/core/memory_governor.h"
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::StatusIs;
+
+TEST(MemoryGovernorTest, MemoryPressureRunsAllTheActions) {
+  std::vector<MemoryGovernor::Action> actions;
+  actions.push_back([](MemorySheddingStats& stats) {
+    stats.prefix_cache_bytes_dropped += 100;
+  });
+  actions.push_back(
+      [](MemorySheddingStats& stats) { ++stats.num_executors_evicted; });
+  ASSERT_OK_AND_ASSIGN(auto governor,
+                       MemoryGovernor::Create(std::move(actions),
+                                              /*max_resident_memory_bytes=*/0));
+  governor->NotifyMemoryPressure();
+  governor->NotifyMemoryPressure();
+
+  const MemorySheddingStats stats = governor->GetStats();
+  EXPECT_EQ(stats.num_memory_pressure_signals, 2);
+  EXPECT_EQ(stats.num_memory_limit_exceeded, 0);
+  EXPECT_EQ(stats.prefix_cache_bytes_dropped, 200);
+  EXPECT_EQ(stats.num_executors_evicted, 2);
+}
+
+TEST(MemoryGovernorTest, ShedsUntilUnderTheLimit) {
+  std::atomic<size_t> resident_memory_bytes = 1000;
+  std::vector<MemoryGovernor::Action> actions;
+  actions.push_back([&](MemorySheddingStats& stats) {
+    resident_memory_bytes -= 300;
+    stats.prefix_cache_bytes_dropped += 300;
+  });
+  actions.push_back([&](MemorySheddingStats& stats) {
+    resident_memory_bytes -= 100;
+    stats.embedding_cache_bytes_dropped += 100;
+  });
+  ASSERT_OK_AND_ASSIGN(
+      auto governor,
+      MemoryGovernor::Create(
+          std::move(actions), /*max_resident_memory_bytes=*/800,
+          /*poll_interval=*/absl::Milliseconds(1),
+          [&]() -> absl::StatusOr<size_t> { return resident_memory_bytes; }));
+  const absl::Time deadline = absl::Now() + absl::Seconds(10);
+  while (governor->GetStats().num_memory_limit_exceeded == 0 &&
+         absl::Now() < deadline) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  // Back under the limit after the first action.
+  absl::SleepFor(absl::Milliseconds(20));
+  const MemorySheddingStats stats = governor->GetStats();
+  EXPECT_EQ(stats.num_memory_limit_exceeded, 1);
+  EXPECT_EQ(stats.prefix_cache_bytes_dropped, 300);
+  EXPECT_EQ(stats.embedding_cache_bytes_dropped, 0);
+  EXPECT_EQ(resident_memory_bytes, 700);
+}
+
+TEST(MemoryGovernorTest, FailsIfTheResidentMemoryCanNotBeRead) {
+  EXPECT_THAT(MemoryGovernor::Create(
+                  /*actions=*/{}, /*max_resident_memory_bytes=*/800,
+                  MemoryGovernor::kDefaultPollInterval,
+                  []() -> absl::StatusOr<size_t> {
+                    return absl::UnimplementedError("Not supported.");
+                  }),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+TEST(MemoryGovernorTest, ReadsTheResidentMemory) {
+#if defined(__linux__)
+  ASSERT_OK_AND_ASSIGN(size_t resident_memory_bytes,
+                       MemoryGovernor::GetResidentMemoryBytes());
+  EXPECT_GT(resident_memory_bytes, 0);
+#else
+  GTEST_SKIP() << "Only supported on Linux and Android.";
+#endif  // defined(__linux__)
+}
+
+}  // namespace
+}  // namespace litert::lm
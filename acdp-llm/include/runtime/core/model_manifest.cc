@@ -0,0 +1,96 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/model_manifest.h"
+
+#include <filesystem>  // NOLINT: Required for path manipulation.
+#include <fstream>
+#include <string>
+#include <system_error>  // NOLINT
+
+#include "absl/base/nullability.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/executor/executor_settings_base.h"
+#include "runtime/proto/llm_metadata.pb.h"
+#include "runtime/proto/model_manifest.pb.h"
+#include "runtime/util/metadata_util.h"
+#include "runtime/util/model_cache.h"
+
+namespace litert::lm {
+namespace {
+
+// Bumped whenever the fields of the manifest change meaning, so that the
+// manifests of the previous versions are built again.
+constexpr int kVersion = 1;
+
+}  // namespace
+
+proto::ModelManifest BuildModelManifest(
+    FileFormat file_format,
+    const proto::LlmMetadata* absl_nullable llm_metadata,
+    Tokenizer& tokenizer) {
+  proto::ModelManifest manifest;
+  manifest.set_version(kVersion);
+  manifest.set_file_format(static_cast<int>(file_format));
+  if (llm_metadata != nullptr) {
+    *manifest.mutable_llm_metadata() = *llm_metadata;
+    ConvertLlmMetadataTokensToIds(tokenizer, *manifest.mutable_llm_metadata());
+  }
+  return manifest;
+}
+
+absl::StatusOr<std::string> GetModelManifestPath(
+    absl::string_view cache_dir, absl::string_view fingerprint) {
+  if (cache_dir.empty()) {
+    return absl::InvalidArgumentError("The cache directory is empty.");
+  }
+  const std::filesystem::path model_dir =
+      std::filesystem::path(std::string(cache_dir)) / std::string(fingerprint);
+  std::error_code error;
+  std::filesystem::create_directories(model_dir, error);
+  if (error) {
+    return absl::InternalError(absl::StrCat(
+        "Failed to create ", model_dir.string(), ": ", error.message()));
+  }
+  return (model_dir / "manifest.binarypb").string();
+}
+
+absl::StatusOr<proto::ModelManifest> LoadModelManifest(
+    absl::string_view path) {
+  std::ifstream file{std::string(path), std::ios::binary};
+  if (!file) {
+    return absl::NotFoundError(absl::StrCat("No model manifest at ", path));
+  }
+  proto::ModelManifest manifest;
+  if (!manifest.ParseFromIstream(&file)) {
+    return absl::DataLossError(
+        absl::StrCat("Corrupted model manifest at ", path));
+  }
+  if (manifest.version() != kVersion) {
+    return absl::DataLossError(absl::StrCat(
+        "Unsupported model manifest version: ", manifest.version()));
+  }
+  return manifest;
+}
+
+absl::Status SaveModelManifest(const proto::ModelManifest& manifest,
+                               absl::string_view path) {
+  return WriteFileAtomically(path, manifest.SerializeAsString());
+}
+
+}  // namespace litert::lm
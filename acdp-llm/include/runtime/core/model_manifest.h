@@ -0,0 +1,76 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_MODEL_MANIFEST_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_MODEL_MANIFEST_H_
+
+#include <string>
+
+#include "absl/base/nullability.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/executor/executor_settings_base.h"
+#include "runtime/proto/llm_metadata.pb.h"
+#include "runtime/proto/model_manifest.pb.h"
+
+namespace litert::lm {
+
+// The manifest of a model gathers what the engine creation reads from the
+// model file before building the executors: the file format, sniffed from
+// the header of the file, and the LlmMetadata, parsed from its section, with
+// the start and stop tokens converted to their ids by the tokenizer. It is
+// built in one pass by the first engine loading the model, and kept under
+// the fingerprint of the model in the cache directory, see
+// GetModelManifestPath(), so that the next engines read it instead.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(std::string path,
+//                    GetModelManifestPath(cache_dir, fingerprint));
+//   absl::StatusOr<proto::ModelManifest> manifest = LoadModelManifest(path);
+//   if (!manifest.ok()) {
+//     ASSIGN_OR_RETURN(manifest, BuildModelManifest(file_format, metadata,
+//                                                   tokenizer));
+//     RETURN_IF_ERROR(SaveModelManifest(*manifest, path));
+//   }
+
+// Builds the manifest of a model of `file_format` and `llm_metadata`, if
+// any, converting its start and stop tokens with `tokenizer`.
+proto::ModelManifest BuildModelManifest(
+    FileFormat file_format,
+    const proto::LlmMetadata* absl_nullable llm_metadata,
+    Tokenizer& tokenizer);
+
+// Returns the path of the manifest of the model of `fingerprint`, see
+// ComputeModelFingerprint(), under `cache_dir`,
+// `<cache_dir>/<fingerprint>/manifest.binarypb`, creating its directory if
+// needed. The manifest does not depend on the backend, so it is shared by
+// the model cache directories of the backends.
+absl::StatusOr<std::string> GetModelManifestPath(absl::string_view cache_dir,
+                                                 absl::string_view fingerprint);
+
+// Reads the manifest written by SaveModelManifest() at `path`. Returns a
+// NotFound error if there is none, and a DataLoss error if it is corrupted or
+// was written by another version of the runtime.
+absl::StatusOr<proto::ModelManifest> LoadModelManifest(absl::string_view path);
+
+// Writes `manifest` to `path`, atomically for the engines reading it
+// concurrently.
+absl::Status SaveModelManifest(const proto::ModelManifest& manifest,
+                               absl::string_view path);
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_MODEL_MANIFEST_H_
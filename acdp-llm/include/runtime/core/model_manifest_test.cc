@@ -0,0 +1,128 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/model_manifest.h"
+
+#include <filesystem>  // NOLINT: Required for path manipulation.
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/executor/executor_settings_base.h"
+#include "runtime/proto/llm_metadata.pb.h"
+#include "runtime/proto/model_manifest.pb.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::status::StatusIs;
+
+// A vocabulary with "<bos>" and "<eos>" as single tokens, where any other
+// text is tokenized to [3, 4].
+class FakeTokenizer : public Tokenizer {
+ public:
+  absl::StatusOr<std::vector<int>> TextToTokenIds(
+      absl::string_view text) override {
+    return std::vector<int>{3, 4};
+  }
+
+  absl::StatusOr<int> TokenToId(absl::string_view token) override {
+    if (token == "<bos>") {
+      return 2;
+    }
+    if (token == "<eos>") {
+      return 1;
+    }
+    return absl::NotFoundError("Not a token.");
+  }
+
+  absl::StatusOr<std::string> TokenIdsToText(
+      const std::vector<int>& token_ids) override {
+    return absl::UnimplementedError("Not needed.");
+  }
+
+  TokenizerType GetTokenizerType() const override {
+    return TokenizerType::kUnspecified;
+  }
+};
+
+proto::LlmMetadata CreateLlmMetadata() {
+  proto::LlmMetadata metadata;
+  metadata.mutable_start_token()->set_token_str("<bos>");
+  metadata.add_stop_tokens()->set_token_str("<eos>");
+  metadata.add_stop_tokens()->set_token_str("<end_of_turn>");
+  metadata.set_jinja_prompt_template("{{ messages }}");
+  return metadata;
+}
+
+TEST(ModelManifestTest, ConvertsTheTokensOfTheMetadataToIds) {
+  FakeTokenizer tokenizer;
+  const proto::LlmMetadata metadata = CreateLlmMetadata();
+  proto::ModelManifest manifest =
+      BuildModelManifest(FileFormat::LITERT_LM, &metadata, tokenizer);
+  EXPECT_EQ(manifest.file_format(), static_cast<int>(FileFormat::LITERT_LM));
+  ASSERT_TRUE(manifest.has_llm_metadata());
+  const proto::LlmMetadata& llm_metadata = manifest.llm_metadata();
+  EXPECT_THAT(llm_metadata.start_token().token_ids().ids(), ElementsAre(2));
+  ASSERT_EQ(llm_metadata.stop_tokens_size(), 2);
+  EXPECT_THAT(llm_metadata.stop_tokens(0).token_ids().ids(), ElementsAre(1));
+  EXPECT_THAT(llm_metadata.stop_tokens(1).token_ids().ids(),
+              ElementsAre(3, 4));
+  EXPECT_EQ(llm_metadata.jinja_prompt_template(), "{{ messages }}");
+
+  EXPECT_FALSE(BuildModelManifest(FileFormat::TASK, /*llm_metadata=*/nullptr,
+                                  tokenizer)
+                   .has_llm_metadata());
+}
+
+TEST(ModelManifestTest, LoadsTheSavedManifest) {
+  FakeTokenizer tokenizer;
+  const proto::LlmMetadata metadata = CreateLlmMetadata();
+  const proto::ModelManifest manifest =
+      BuildModelManifest(FileFormat::LITERT_LM, &metadata, tokenizer);
+  ASSERT_OK_AND_ASSIGN(
+      std::string path,
+      GetModelManifestPath(::testing::TempDir(), "saved-fingerprint"));
+  EXPECT_THAT(LoadModelManifest(path),
+              StatusIs(absl::StatusCode::kNotFound));
+
+  ASSERT_OK(SaveModelManifest(manifest, path));
+  ASSERT_OK_AND_ASSIGN(proto::ModelManifest loaded_manifest,
+                       LoadModelManifest(path));
+  EXPECT_EQ(loaded_manifest.SerializeAsString(), manifest.SerializeAsString());
+}
+
+TEST(ModelManifestTest, RejectsTheManifestsOfOtherVersions) {
+  proto::ModelManifest manifest;
+  manifest.set_version(1000);
+  ASSERT_OK_AND_ASSIGN(
+      std::string path,
+      GetModelManifestPath(::testing::TempDir(), "versioned-fingerprint"));
+  ASSERT_OK(SaveModelManifest(manifest, path));
+  EXPECT_THAT(LoadModelManifest(path), StatusIs(absl::StatusCode::kDataLoss));
+
+  std::ofstream(path, std::ios::binary | std::ios::trunc) << "\xff\xff";
+  EXPECT_THAT(LoadModelManifest(path), StatusIs(absl::StatusCode::kDataLoss));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,257 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmarks of the host work of a decode step, independent of the
+// hardware the model runs on: the executor is a FakeLlmExecutor returning
+// scripted tokens, and the tokenizer maps each token id to a word, so that
+// only the stop token detection, the detokenization, the streaming callbacks
+// and the input preparation are measured.
+//
+// Example usage:
+//   bazel run -c opt //runtime/core:per_token_benchmark -- \
+//     --benchmark_filter=BM_Decode
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "absl/log/absl_check.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/numbers.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_split.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "nlohmann/json.hpp"  // from @nlohmann_json
+#include "runtime/components/stop_token_detector.h"
+#include "runtime/components/tokenizer.h"
+#include "runtime/conversation/internal_callback_util.h"
+#include "runtime/conversation/io_types.h"
+#include "runtime/conversation/model_data_processor/config_registry.h"
+#include "runtime/conversation/model_data_processor/gemma3_data_processor.h"
+#include "runtime/conversation/model_data_processor/gemma3_data_processor_config.h"
+#include "runtime/core/incremental_detokenizer.h"
+#include "runtime/core/pipeline.h"
+#include "runtime/core/session_basic.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/executor/fake_llm_executor.h"
+#include "runtime/executor/llm_executor_io_types.h"
+#include "runtime/framework/threadpool.h"
+#include "runtime/util/convert_tensor_buffer.h"
+#include "runtime/util/executor_data_util.h"
+
+namespace litert::lm {
+namespace {
+
+constexpr int kVocabSize = 2560;
+constexpr int kStopTokenId = 1;
+// The number of tokens of a response of the streaming benchmarks.
+constexpr int kResponseTokens = 256;
+
+// Returns the token of the decode step `step`, never the stop token.
+int GetToken(int step) { return 2 + step % (kVocabSize - 2); }
+
+// Maps each token id to a word with the SentencePiece meta space, and back.
+class WordTokenizer : public Tokenizer {
+ public:
+  absl::StatusOr<std::vector<int>> TextToTokenIds(
+      absl::string_view text) override {
+    std::vector<int> token_ids;
+    for (absl::string_view word : absl::StrSplit(text, ' ')) {
+      token_ids.push_back(GetToken(word.size()));
+    }
+    return token_ids;
+  }
+
+  absl::StatusOr<int> TokenToId(absl::string_view token) override {
+    int id;
+    return absl::SimpleAtoi(token, &id) ? id : 0;
+  }
+
+  absl::StatusOr<std::string> TokenIdsToText(
+      const std::vector<int>& token_ids) override {
+    std::string text;
+    for (int token_id : token_ids) {
+      absl::StrAppend(&text, "▁w", token_id);
+    }
+    return text;
+  }
+
+  TokenizerType GetTokenizerType() const override {
+    return TokenizerType::kUnspecified;
+  }
+};
+
+// The stop token detection of a decode step, for `range(0)` candidates and
+// stop sequences of `range(1)` tokens which never match.
+void BM_StopTokenDetectorProcessTokens(benchmark::State& state) {
+  const int num_candidates = state.range(0);
+  const int stop_sequence_length = state.range(1);
+  StopTokenDetector detector(num_candidates);
+  ABSL_CHECK_OK(detector.AddStopTokenSequence({kStopTokenId}));
+  ABSL_CHECK_OK(detector.AddStopTokenSequence(
+      std::vector<int>(stop_sequence_length, kStopTokenId)));
+  std::vector<int> tokens(num_candidates);
+  int step = 0;
+  for (auto _ : state) {
+    for (int& token : tokens) {
+      token = GetToken(step);
+    }
+    ABSL_CHECK_OK(detector.ProcessTokens(tokens));
+    ++step;
+  }
+  state.SetItemsProcessed(state.iterations() * num_candidates);
+}
+BENCHMARK(BM_StopTokenDetectorProcessTokens)
+    ->ArgsProduct({{1, 4}, {1, 8}});
+
+// The detokenization of a decode step, including the merging of the pending
+// BPE tokens and the mapping of the meta space, for `range(0)` candidates.
+void BM_IncrementalDetokenizerDecode(benchmark::State& state) {
+  const int num_candidates = state.range(0);
+  WordTokenizer tokenizer;
+  IncrementalDetokenizer detokenizer(&tokenizer, num_candidates);
+  std::vector<int> tokens(num_candidates);
+  int step = 0;
+  size_t num_bytes = 0;
+  for (auto _ : state) {
+    for (int& token : tokens) {
+      token = GetToken(step);
+    }
+    ABSL_CHECK_OK(detokenizer.Decode(tokens));
+    num_bytes += detokenizer.GetDelta(0).size();
+    ++step;
+  }
+  state.SetItemsProcessed(state.iterations() * num_candidates);
+  state.SetBytesProcessed(num_bytes);
+}
+BENCHMARK(BM_IncrementalDetokenizerDecode)->Arg(1)->Arg(4);
+
+// The conversation callback of a streamed response of kResponseTokens
+// chunks, scanning the text for the code fences of the tool calls.
+void BM_InternalCallback(benchmark::State& state) {
+  JsonPreface preface{.tools = nlohmann::ordered_json::parse(R"json([{
+      "name": "tool_name",
+      "parameters": { "properties": { "x": { "type": "integer" } } }
+    }])json")};
+  auto processor = Gemma3DataProcessor::Create(Gemma3DataProcessorConfig(),
+                                               preface);
+  ABSL_CHECK_OK(processor);
+  std::vector<std::string> chunks;
+  for (int i = 0; i < kResponseTokens; ++i) {
+    chunks.push_back(absl::StrCat(" w", GetToken(i)));
+  }
+  for (auto _ : state) {
+    auto callback = CreateInternalCallback(
+        **processor, DataProcessorArguments(),
+        [](absl::StatusOr<Message> message) {
+          benchmark::DoNotOptimize(message);
+        });
+    for (const std::string& chunk : chunks) {
+      callback(Responses(TaskState::kProcessing, {chunk}));
+    }
+    callback(Responses(TaskState::kDone));
+  }
+  state.SetItemsProcessed(state.iterations() * kResponseTokens);
+}
+BENCHMARK(BM_InternalCallback);
+
+// The combination of the embeddings of `range(0)` images of 256 tokens each.
+void BM_CombineExecutorVisionData(benchmark::State& state) {
+  const int num_images = state.range(0);
+  constexpr int kNumTokens = 256;
+  constexpr int kFeatureDim = 256;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<ExecutorVisionData> images;
+    for (int i = 0; i < num_images; ++i) {
+      auto embeddings =
+          CreateTensorBuffer<float>({1, 1, kNumTokens, kFeatureDim});
+      ABSL_CHECK(embeddings.HasValue());
+      images.emplace_back(std::move(*embeddings), std::nullopt);
+    }
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(CombineExecutorVisionData(images));
+  }
+  state.SetItemsProcessed(state.iterations() * num_images * kNumTokens);
+}
+BENCHMARK(BM_CombineExecutorVisionData)->Arg(2)->Arg(8);
+
+// The decode loop of `range(0)` steps of a single candidate, with the fake
+// executor standing in for the model, i.e. the host overhead per step.
+void BM_Decode(benchmark::State& state) {
+  const int num_steps = state.range(0);
+  WordTokenizer tokenizer;
+  StopTokenDetector detector(/*batch_size=*/1);
+  ABSL_CHECK_OK(detector.AddStopTokenSequence({kStopTokenId}));
+  std::vector<std::vector<int>> decode_tokens;
+  for (int i = 0; i < num_steps; ++i) {
+    decode_tokens.push_back({GetToken(i)});
+  }
+  decode_tokens.push_back({kStopTokenId});
+  for (auto _ : state) {
+    state.PauseTiming();
+    FakeLlmExecutor executor(kVocabSize, /*prefill_tokens_set=*/{},
+                             decode_tokens);
+    std::optional<BenchmarkInfo> benchmark_info;
+    state.ResumeTiming();
+    auto responses =
+        Decode(executor, tokenizer, detector, /*num_output_candidates=*/1,
+               /*constraint=*/nullptr, benchmark_info);
+    ABSL_CHECK_OK(responses);
+  }
+  state.SetItemsProcessed(state.iterations() * num_steps);
+}
+BENCHMARK(BM_Decode)->Arg(64)->Arg(512);
+
+// The prompt templates applied to a text input of a turn.
+void BM_ApplyPromptTemplates(benchmark::State& state) {
+  WordTokenizer tokenizer;
+  FakeLlmExecutor executor(kVocabSize, /*prefill_tokens_set=*/{},
+                           /*decode_tokens_set=*/{});
+  ThreadPool worker_thread_pool(/*name_prefix=*/"benchmark",
+                                /*max_num_threads=*/1);
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.GetMutableStopTokenIds() = {{kStopTokenId}};
+  session_config.SetStartTokenId(0);
+  session_config.SetSamplerBackend(Backend::CPU);
+  session_config.GetMutablePromptTemplates().mutable_user()->set_prefix(
+      "<start_of_turn>user\n");
+  session_config.GetMutablePromptTemplates().mutable_user()->set_suffix(
+      "<end_of_turn>\n");
+  session_config.GetMutablePromptTemplates().mutable_model()->set_prefix(
+      "<start_of_turn>model\n");
+  auto session = SessionBasic::Create(
+      &executor, &tokenizer, /*vision_executor=*/nullptr,
+      /*audio_executor=*/nullptr, session_config, std::nullopt,
+      &worker_thread_pool);
+  ABSL_CHECK_OK(session);
+  const std::string prompt(state.range(0), 'a');
+  for (auto _ : state) {
+    std::vector<InputData> contents;
+    contents.emplace_back(InputText(prompt));
+    auto templated = (*session)->ApplyPromptTemplates(std::move(contents));
+    ABSL_CHECK_OK(templated);
+    benchmark::DoNotOptimize(templated);
+  }
+  state.SetBytesProcessed(state.iterations() * prompt.size());
+}
+BENCHMARK(BM_ApplyPromptTemplates)->Arg(64)->Arg(4096);
+
+}  // namespace
+}  // namespace litert::lm
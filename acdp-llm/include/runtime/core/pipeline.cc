@@ -16,32 +16,53 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdint>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <queue>
+#include <set>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "absl/base/nullability.h"  // from @com_google_absl
+#include "absl/cleanup/cleanup.h"  // from @com_google_absl
 #include "absl/functional/any_invocable.h"  // from @com_google_absl
 #include "absl/log/absl_log.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/str_cat.h"  // from @com_google_absl
 #include "absl/strings/str_format.h"  // from @com_google_absl
-#include "absl/strings/str_replace.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
 #include "absl/types/span.h"  // from @com_google_absl
 #include "litert/cc/litert_macros.h"  // from @litert
 #include "litert/cc/litert_tensor_buffer.h"  // from @litert
 #include "runtime/components/constrained_decoding/constrained_decoder.h"
 #include "runtime/components/constrained_decoding/constraint.h"
 #include "runtime/components/sampler.h"
-#include "runtime/components/scoring_cpu_util.h"
 #include "runtime/components/stop_token_detector.h"
 #include "runtime/components/tokenizer.h"
+#include "runtime/core/beam_search.h"
+#include "runtime/core/candidate_pruner.h"
+#include "runtime/core/constraint_extensions.h"
+#include "runtime/core/context_compactor.h"
+#include "runtime/core/continuous_batching_scheduler.h"
+#include "runtime/core/incremental_detokenizer.h"
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/core/logits_kernels.h"
+#include "runtime/core/logits_processor.h"
+#include "runtime/core/logits_staging_buffer.h"
+#include "runtime/core/prefill_planner.h"
+#include "runtime/core/reasoning_budget.h"
+#include "runtime/core/sequence_scorer.h"
+#include "runtime/core/speculative_decoder.h"
+#include "runtime/core/stop_sequence_matcher.h"
+#include "runtime/core/token_text_table.h"
 #include "runtime/engine/io_types.h"
 #include "runtime/executor/llm_executor.h"
 #include "runtime/executor/llm_executor_io_types.h"
@@ -50,6 +71,7 @@
 #include "runtime/proto/sampler_params.pb.h"
 #include "runtime/util/convert_tensor_buffer.h"
 #include "runtime/util/status_macros.h"  //NOLINT
+#include "runtime/util/trace_recorder.h"
 
 namespace litert::lm {
 namespace {
@@ -58,7 +80,12 @@ namespace {
 // returned by the model. We should remove this default value once all Executors
 // are compliant with the max number of tokens.
 constexpr int kDefaultMaxNumTokens = 4096;
-int TryGetMaxNumTokens(const LlmExecutor& executor) {
+// Returns `max_num_tokens`, the maximum of the session, or the one of the
+// executor if 0.
+int TryGetMaxNumTokens(const LlmExecutor& executor, int max_num_tokens) {
+  if (max_num_tokens > 0) {
+    return max_num_tokens;
+  }
   auto settings = executor.GetExecutorSettings();
   if (!settings.ok()) {
     // If the executor settings are not available, we will use the default
@@ -70,6 +97,42 @@ int TryGetMaxNumTokens(const LlmExecutor& executor) {
   return settings->GetMaxNumTokens();
 }
 
+// Returns the prefill signature sizes of the executor, empty if unknown.
+std::set<int> TryGetPrefillSizes(const LlmExecutor& executor) {
+  auto settings = executor.GetExecutorSettings();
+  if (!settings.ok() || !settings->GetAdvancedSettings().has_value()) {
+    return {};
+  }
+  return settings->GetAdvancedSettings()->prefill_batch_sizes;
+}
+
+// Makes room in the context for `num_new_tokens` more tokens with the sliding
+// window of the session, if any.
+absl::Status MaybeCompactContext(
+    ContextCompactor* context_compactor, int current_step, int num_new_tokens,
+    ContinuousBatchingScheduler::Slot* batching_slot) {
+  if (context_compactor == nullptr) {
+    return absl::OkStatus();
+  }
+  auto make_room = [&]() -> absl::Status {
+    return context_compactor->MakeRoom(current_step, num_new_tokens).status();
+  };
+  // The executor may be serving other sessions in between the batched decode
+  // steps, so the eviction has to wait for its turn.
+  return batching_slot != nullptr ? batching_slot->RunExclusive(make_room)
+                                  : make_room();
+}
+
+// The maximum number of tokens forced by a constraint that are appended in a
+// single step of jump-forward decoding, which keeps the streaming responses
+// flowing through long forced spans.
+constexpr int kMaxNumJumpForwardTokens = 32;
+
+// The maximum number of decode steps run back to back by a
+// MultiStepDecodeLlmExecutor. Bounds the steps rolled back after a stop, and
+// the delay of the streamed text.
+constexpr int kMaxNumMultiStepDecodeSteps = 8;
+
 // Check whether the decoding loop should stop.
 bool ShouldStop(bool hit_stop_tokens, int benchmark_decode_token_count,
                 int num_decoded_steps, int current_step, int max_num_tokens) {
@@ -98,16 +161,72 @@ class DecodeOneStep {
                 Tokenizer* absl_nonnull tokenizer, int num_output_candidates,
                 const StopTokenDetector& stop_token_detector,
                 std::optional<BenchmarkInfo>& benchmark_info,
-                std::optional<Sampler*> sampler, Constraint* constraint)
+                std::optional<Sampler*> sampler, Constraint* constraint,
+                ContinuousBatchingScheduler::Slot* batching_slot = nullptr,
+                const StopSequences* stop_sequences = nullptr,
+                LogitsStagingBuffer* logits_staging_buffer = nullptr,
+                const TokenTextTable* token_text_table = nullptr,
+                LogitsProcessor* logits_processor = nullptr,
+                ReasoningBudget* reasoning_budget = nullptr)
       : executor_(*executor),
-        tokenizer_(*tokenizer),
         num_output_candidates_(num_output_candidates),
         sampler_(sampler),
+        batching_slot_(batching_slot),
+        logits_processor_(logits_processor),
+        reasoning_budget_(num_output_candidates == 1 ? reasoning_budget
+                                                     : nullptr),
         benchmark_info_(benchmark_info),
-        stop_token_detector_(stop_token_detector) {
+        stop_token_detector_(stop_token_detector),
+        detokenizer_(tokenizer, num_output_candidates, token_text_table),
+        logits_staging_buffer_(logits_staging_buffer != nullptr
+                                   ? *logits_staging_buffer
+                                   : owned_logits_staging_buffer_) {
     if (constraint != nullptr) {
       constrained_decoder_ = std::make_unique<ConstrainedDecoder>(
           constraint, num_output_candidates_);
+      // The forced tokens are appended by the decode loop itself, which only
+      // happens with external sampling.
+      if (sampler_.has_value() && num_output_candidates_ == 1) {
+        jump_forward_constraint_ =
+            GetConstraintExtension<JumpForwardConstraint>(constraint);
+        jump_forward_executor_ =
+            GetExecutorExtension<SpeculativeLlmExecutor>(executor_);
+      }
+    }
+    if (logits_processor_ != nullptr && !sampler_.has_value()) {
+      logits_processing_executor_ =
+          GetExecutorExtension<LogitsProcessingLlmExecutor>(executor_);
+    }
+    // The batched decode steps and the logits processors take the constrained
+    // decoder instead.
+    if (constraint != nullptr && !sampler_.has_value() &&
+        batching_slot_ == nullptr && logits_processor_ == nullptr) {
+      token_bitmask_constraint_ =
+          GetConstraintExtension<TokenBitmaskConstraint>(constraint);
+      token_bitmask_executor_ =
+          GetExecutorExtension<TokenBitmaskLlmExecutor>(executor_);
+      if (token_bitmask_constraint_ == nullptr ||
+          token_bitmask_executor_ == nullptr) {
+        token_bitmask_constraint_ = nullptr;
+        token_bitmask_executor_ = nullptr;
+      } else {
+        bitmask_token_ids_.resize(num_output_candidates_);
+      }
+    }
+    if (reasoning_budget_ != nullptr) {
+      if (sampler_.has_value()) {
+        reasoning_jump_executor_ =
+            GetExecutorExtension<SpeculativeLlmExecutor>(executor_);
+      } else if (batching_slot_ == nullptr) {
+        reasoning_bitmask_executor_ =
+            GetExecutorExtension<TokenBitmaskLlmExecutor>(executor_);
+      }
+    }
+    if (!sampler_.has_value() && num_output_candidates_ == 1 &&
+        constraint == nullptr && batching_slot_ == nullptr &&
+        logits_processor_ == nullptr && reasoning_budget_ == nullptr) {
+      multi_step_executor_ =
+          GetExecutorExtension<MultiStepDecodeLlmExecutor>(executor_);
     }
     if (!sampler_.has_value()) {  // Internal sampling setup
       auto output_tokens = CreateTensorBuffer<int>({num_output_candidates_, 1});
@@ -117,8 +236,10 @@ class DecodeOneStep {
       scores_tensor_ = std::move(*scores_tensor);
     }
     result_text_ = std::vector<std::string>(num_output_candidates_, "");
-    bpe_partial_token_ids_ =
-        std::vector<std::vector<int>>(num_output_candidates_);
+    pruned_ = std::vector<bool>(num_output_candidates_, false);
+    if (stop_sequences != nullptr) {
+      stop_sequence_matcher_.emplace(*stop_sequences, num_output_candidates_);
+    }
     pending_stop_tokens_ =
         std::vector<std::queue<std::string>>(num_output_candidates_);
   }
@@ -127,39 +248,230 @@ class DecodeOneStep {
   // candidates have been found.
   // For external sampling, `decoded_ids` must be provided and will be updated.
   // For internal sampling, `decoded_ids` is ignored.
+  // With a JumpForwardConstraint, the step also emits the up to
+  // `max_num_forced_tokens` tokens forced after the sampled one.
   absl::StatusOr<bool> Run(
-      std::optional<litert::TensorBuffer*> decoded_ids = std::nullopt) {
+      std::optional<litert::TensorBuffer*> decoded_ids = std::nullopt,
+      int max_num_forced_tokens = 0) {
+    ScopedTraceSlice trace("decode", "DecodeOneStep");
+    if (reasoning_budget_ != nullptr &&
+        !reasoning_budget_->GetForcedTokens().empty()) {
+      return EndReasoning(decoded_ids, max_num_forced_tokens);
+    }
     ASSIGN_OR_RETURN(litert::TensorBuffer * next_tokens_buffer,
                      DecodeAndSample(decoded_ids));
+    num_tokens_in_last_step_ = 1;
+    if (token_bitmask_executor_ != nullptr) {
+      LITERT_ASSIGN_OR_RETURN(
+          auto next_tokens_span,
+          ReferTensorBufferAsSpan<int>(*next_tokens_buffer));
+      for (int i = 0; i < num_output_candidates_; ++i) {
+        bitmask_token_ids_[i].push_back(next_tokens_span[i]);
+      }
+    }
+    ASSIGN_OR_RETURN(bool all_done, ProcessNextTokens(*next_tokens_buffer));
+    if (jump_forward_constraint_ == nullptr ||
+        jump_forward_executor_ == nullptr) {
+      return all_done;
+    }
+    LITERT_ASSIGN_OR_RETURN(auto next_tokens_span,
+                            ReferTensorBufferAsSpan<int>(*next_tokens_buffer));
+    constrained_token_ids_.push_back(next_tokens_span[0]);
+    if (all_done || max_num_forced_tokens <= 0) {
+      return all_done;
+    }
+    return JumpForward(*next_tokens_buffer, max_num_forced_tokens);
+  }
 
-    // Post-processing the next tokens.
-    ASSIGN_OR_RETURN(auto token_ids,
-                     tokenizer_.TensorBufferToTokenIds(*next_tokens_buffer));
+  // Runs one step of speculative decoding, which emits one or more tokens, and
+  // returns if the stop has been found. The tokens are post-processed one by
+  // one, so the stop tokens and the BPE sequences are handled exactly as with
+  // regular decoding, and the tokens following a stop are discarded. Only
+  // supports a single output candidate with internal sampling.
+  absl::StatusOr<bool> RunSpeculative(SpeculativeDecoder& speculative_decoder) {
+    ScopedTraceSlice trace("decode", "DecodeOneStepSpeculative");
+    if (benchmark_info_.has_value()) {
+      benchmark_info_->TimeMarkDelta(BenchmarkMark::kExecutorDecodeSpeculative);
+    }
+    ASSIGN_OR_RETURN(std::vector<int> token_ids, speculative_decoder.Step());
+    if (benchmark_info_.has_value()) {
+      benchmark_info_->TimeMarkDelta(BenchmarkMark::kExecutorDecodeSpeculative);
+    }
+    std::string step_text;
+    num_tokens_in_last_step_ = 0;
+    for (const int token_id : token_ids) {
+      LITERT_RETURN_IF_ERROR(
+          output_tokens_.Write<int>(absl::MakeConstSpan(&token_id, 1)));
+      ASSIGN_OR_RETURN(bool all_done, ProcessNextTokens(output_tokens_));
+      step_text += result_text_[0];
+      ++num_tokens_in_last_step_;
+      if (all_done) {
+        RETURN_IF_ERROR(
+            speculative_decoder.DiscardAfter(num_tokens_in_last_step_));
+        break;
+      }
+    }
+    result_text_[0] = std::move(step_text);
+    return AllDone();
+  }
 
-    // Merge BPE partial token ids with the next token ids if any.
-    ASSIGN_OR_RETURN(
-        token_ids, tokenizer_.MergeTokenIds(bpe_partial_token_ids_, token_ids));
+  // Returns if RunMultiStep is supported.
+  bool SupportsMultiStep() const { return multi_step_executor_ != nullptr; }
 
-    // Regardless of BPE, we always process the next tokens to detect stop
-    // tokens.
+  // Runs up to `max_num_steps` decode steps in a single executor call and
+  // returns if the stop has been found. The tokens are post-processed one by
+  // one as with RunSpeculative, and the steps following a stop are rolled
+  // back.
+  absl::StatusOr<bool> RunMultiStep(int max_num_steps) {
+    ScopedTraceSlice trace("decode", "DecodeOneStepMultiStep");
+    multi_step_token_ids_.resize(max_num_steps);
+    if (benchmark_info_.has_value()) {
+      benchmark_info_->TimeMarkDelta(BenchmarkMark::kExecutorDecodeAndSample);
+    }
+    ASSIGN_OR_RETURN(int num_steps, multi_step_executor_->DecodeSteps(
+                                        absl::MakeSpan(multi_step_token_ids_)));
+    if (benchmark_info_.has_value()) {
+      benchmark_info_->TimeMarkDelta(BenchmarkMark::kExecutorDecodeAndSample);
+    }
+    std::string step_text;
+    num_tokens_in_last_step_ = 0;
+    for (int i = 0; i < num_steps; ++i) {
+      LITERT_RETURN_IF_ERROR(output_tokens_.Write<int>(
+          absl::MakeConstSpan(&multi_step_token_ids_[i], 1)));
+      ASSIGN_OR_RETURN(bool all_done, ProcessNextTokens(output_tokens_));
+      step_text += result_text_[0];
+      ++num_tokens_in_last_step_;
+      if (all_done) {
+        break;
+      }
+    }
+    if (num_tokens_in_last_step_ < num_steps) {
+      RETURN_IF_ERROR(multi_step_executor_->RollbackSteps(
+          num_steps - num_tokens_in_last_step_));
+    }
+    result_text_[0] = std::move(step_text);
+    return AllDone();
+  }
+
+  // Returns the number of tokens decoded by the last Run, RunSpeculative or
+  // RunMultiStep.
+  int GetNumTokensInLastStep() const { return num_tokens_in_last_step_; }
+
+  absl::Span<float> GetScores() { return scores_span_; }
+
+  const std::vector<std::string>& GetResultText() const { return result_text_; }
+
+  // Drops the candidate from the decode: its next tokens are ignored, and it
+  // counts as done.
+  void PruneCandidate(int candidate) { pruned_[candidate] = true; }
+
+  // Returns if the candidate has found a stop or has been pruned.
+  bool IsCandidateDone(int candidate) const {
+    return pruned_[candidate] ||
+           stop_token_detector_.GetStopTokensFound()[candidate] ||
+           (stop_sequence_matcher_.has_value() &&
+            stop_sequence_matcher_->IsStopFound(candidate));
+  }
+
+  // Returns if all candidates are done.
+  bool AllDone() const {
+    for (int i = 0; i < num_output_candidates_; ++i) {
+      if (!IsCandidateDone(i)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // This function is only supported for external sampling.
+  // It computes the log likelihoods of the ids of a batch from the logits of
+  // a single decode, under each of the temperatures.
+  // temperatures: The temperatures the logits are scaled with.
+  // step_input_ids: The ids corresponding to the input text for the batch.
+  // decoded_ids: The decoded id tensor buffer in which the sampled ids are
+  //              written so that the model uses reference text future step.
+  // Returns: One vector of log likelihoods of `step_input_ids` per entry of
+  //          `temperatures`, in the same order.
+  absl::StatusOr<std::vector<std::vector<float>>> RunScoreStep(
+      absl::Span<const float> temperatures,
+      const std::vector<int>& step_input_ids,
+      litert::TensorBuffer& decoded_ids) {
+    LITERT_ASSIGN_OR_RETURN(auto duplicate_decoded_ids,
+                            decoded_ids.Duplicate());
+    const ExecutorInputs inputs(
+        ExecutorTextData(std::move(duplicate_decoded_ids)),
+        /*vision_data=*/std::nullopt,
+        /*audio_data=*/std::nullopt);
+    // Decoding section.
+    if (benchmark_info_.has_value()) {
+      benchmark_info_->TimeMarkDelta(BenchmarkMark::kExecutorDecode);
+    }
+    ASSIGN_OR_RETURN(auto output_logits, executor_.DecodeLogits(inputs));
+    if (benchmark_info_.has_value()) {
+      benchmark_info_->TimeMarkDelta(BenchmarkMark::kExecutorDecode);
+    }
+    decoded_ids.Write<int>(step_input_ids);
+    // Downloads the data into the reused staging memory if it is not in host
+    // memory.
+    ASSIGN_OR_RETURN(absl::Span<const float> logits_data,
+                     logits_staging_buffer_.Stage(output_logits));
+    std::vector<std::vector<float>> log_likelihoods;
+    log_likelihoods.reserve(temperatures.size());
+    for (const float temperature : temperatures) {
+      ASSIGN_OR_RETURN(log_likelihoods.emplace_back(),
+                       LogitsKernels::Get().ComputeLogLikelihoods(
+                           logits_data, step_input_ids, temperature));
+    }
+    return log_likelihoods;
+  }
+
+ private:
+  // Post-processes the next tokens: detects the stop tokens, handles the
+  // partial BPE sequences and the partial stop tokens, and updates the result
+  // texts. Returns if all stops for all candidates have been found.
+  absl::StatusOr<bool> ProcessNextTokens(
+      litert::TensorBuffer& next_tokens_buffer) {
     LITERT_ASSIGN_OR_RETURN(
         auto next_tokens_span,
-        ReferTensorBufferAsSpan<int>(*next_tokens_buffer));
+        ReferTensorBufferAsSpan<int>(next_tokens_buffer));
+    // Regardless of BPE, we always process the next tokens to detect stop
+    // tokens.
     RETURN_IF_ERROR(stop_token_detector_.ProcessTokens(next_tokens_span));
+    if (logits_processor_ != nullptr) {
+      logits_processor_->Update(next_tokens_span);
+    }
+    if (reasoning_budget_ != nullptr) {
+      reasoning_budget_->Update(next_tokens_span[0]);
+    }
+    {
+      ScopedTraceSlice trace("tokenizer", "Detokenize");
+      RETURN_IF_ERROR(detokenizer_.Decode(next_tokens_span));
+    }
 
-    auto decoded_result =
-        tokenizer_.TokenIdsToTexts(num_output_candidates_, token_ids);
     for (int i = 0; i < num_output_candidates_; ++i) {
-      result_text_[i] = "";
-      if (Tokenizer::IsIncompleteBpeSequence(decoded_result.value()[i])) {
-        bpe_partial_token_ids_[i] = token_ids[i];
-      } else if (!stop_token_detector_.GetStopTokensFound()[i]) {
-        bpe_partial_token_ids_[i].clear();
+      // Keeps the capacity of the result text from the previous steps.
+      result_text_[i].clear();
+      if (pruned_[i]) {
+        continue;
+      }
+      if (stop_sequence_matcher_.has_value()) {
+        // The matcher holds back the text of the partial stop sequences, and
+        // never releases the text of a found one.
+        const absl::string_view text = stop_sequence_matcher_->Process(
+            i, next_tokens_span[i], detokenizer_.GetDelta(i));
+        result_text_[i].append(text.data(), text.size());
+        continue;
+      }
+      if (detokenizer_.HasPendingTokens(i)) {
+        continue;
+      }
+      if (!stop_token_detector_.GetStopTokensFound()[i]) {
+        const absl::string_view delta = detokenizer_.GetDelta(i);
 
         // Handle partial stop tokens.
         int max_length = stop_token_detector_.MaxPartialStopTokenLength(i);
         if (max_length > 0) {
-          pending_stop_tokens_[i].push(decoded_result.value()[i].value());
+          pending_stop_tokens_[i].emplace(delta);
         }
         // We only need the latest max_length tokens for partial stop tokens.
         // Add the extra ones to the result text tand we could keep only the
@@ -172,7 +484,7 @@ class DecodeOneStep {
         // No partial stop token is found - add the current token to the result
         // text directly - this is the most common case.
         if (max_length == 0) {
-          result_text_[i] += decoded_result.value()[i].value();
+          result_text_[i].append(delta.data(), delta.size());
         }
       }
     }
@@ -182,55 +494,182 @@ class DecodeOneStep {
           scores_span_, ReferTensorBufferAsSpan<float>(scores_tensor_));
     }
 
-    return stop_token_detector_.AllDone();
+    return AllDone();
   }
 
-  absl::Span<float> GetScores() { return scores_span_; }
-
-  const std::vector<std::string>& GetResultText() const { return result_text_; }
+  // Emits the tokens forced by the constraint after the sampled token in
+  // `decoded_ids`, and appends the sampled token and all the forced ones but
+  // the last in a single executor invocation. The last forced token is left in
+  // `decoded_ids` as the input of the next step. Returns if all stops have
+  // been found.
+  absl::StatusOr<bool> JumpForward(litert::TensorBuffer& decoded_ids,
+                                   int max_num_forced_tokens) {
+    LITERT_ASSIGN_OR_RETURN(auto decoded_ids_span,
+                            ReferTensorBufferAsSpan<int>(decoded_ids));
+    const int sampled_token_id = decoded_ids_span[0];
+    ASSIGN_OR_RETURN(std::vector<int> forced_token_ids,
+                     jump_forward_constraint_->GetForcedTokens(
+                         constrained_token_ids_, max_num_forced_tokens));
+    if (forced_token_ids.empty()) {
+      return false;
+    }
+    // The forced tokens are post-processed one by one, like the tokens of a
+    // speculative step, and the ones following a stop are dropped.
+    std::string step_text = std::move(result_text_[0]);
+    bool all_done = false;
+    int num_forced_tokens = 0;
+    for (const int token_id : forced_token_ids) {
+      LITERT_RETURN_IF_ERROR(
+          decoded_ids.Write<int>(absl::MakeConstSpan(&token_id, 1)));
+      ASSIGN_OR_RETURN(all_done, ProcessNextTokens(decoded_ids));
+      step_text += result_text_[0];
+      ++num_forced_tokens;
+      if (all_done) {
+        break;
+      }
+    }
+    result_text_[0] = std::move(step_text);
+    num_tokens_in_last_step_ += num_forced_tokens;
 
-  // This function is only supported for external sampling.
-  // It computes the log likelihoods for the sampled ids corresponding to the
-  // ids of a batch and returns it as a vector of floats.
-  // step_input_ids: The ids corresponding to the input text for the batch.
-  // decoded_ids: The decoded id tensor buffer in which the sampled ids are
-  //              written so that the model uses reference text future step.
-  // Returns: A vector of log likelihoods for the sampled ids.
-  absl::StatusOr<std::vector<float>> RunScoreStep(
-      const float temperature, const std::vector<int>& step_input_ids,
-      litert::TensorBuffer& decoded_ids) {
-    LITERT_ASSIGN_OR_RETURN(auto duplicate_decoded_ids,
-                            decoded_ids.Duplicate());
-    const ExecutorInputs inputs(
-        ExecutorTextData(std::move(duplicate_decoded_ids)),
-        /*vision_data=*/std::nullopt,
-        /*audio_data=*/std::nullopt);
-    // Decoding section.
+    std::vector<int> appended_token_ids = {sampled_token_id};
+    appended_token_ids.insert(appended_token_ids.end(),
+                              forced_token_ids.begin(),
+                              forced_token_ids.begin() + num_forced_tokens - 1);
     if (benchmark_info_.has_value()) {
-      RETURN_IF_ERROR(benchmark_info_->TimeMarkDelta("executor_decode"));
+      benchmark_info_->TimeMarkDelta(BenchmarkMark::kExecutorJumpForward);
     }
-    ASSIGN_OR_RETURN(auto output_logits, executor_.DecodeLogits(inputs));
+    RETURN_IF_ERROR(
+        jump_forward_executor_->PredictNextTokens(appended_token_ids)
+            .status());
     if (benchmark_info_.has_value()) {
-      RETURN_IF_ERROR(benchmark_info_->TimeMarkDelta("executor_decode"));
+      benchmark_info_->TimeMarkDelta(BenchmarkMark::kExecutorJumpForward);
     }
-    decoded_ids.Write<int>(step_input_ids);
-    auto logits_data_or = ReferTensorBufferAsSpan<float>(output_logits);
-    absl::Span<float> logits_data;
-    std::vector<float> logits_data_buffer;
-    // Download the data if it is not in host memory.
-    if (!logits_data_or) {
-      LITERT_ASSIGN_OR_RETURN(auto logits_size, output_logits.PackedSize());
-      logits_data_buffer.resize(logits_size / sizeof(float));
+    // The constraint state follows the appended tokens, the next step updates
+    // it with the last forced one.
+    for (const int token_id : appended_token_ids) {
       LITERT_RETURN_IF_ERROR(
-          output_logits.Read(absl::MakeSpan(logits_data_buffer)));
-      logits_data = absl::MakeSpan(logits_data_buffer);
-    } else {
-      logits_data = *logits_data_or;
+          decoded_ids.Write<int>(absl::MakeConstSpan(&token_id, 1)));
+      RETURN_IF_ERROR(constrained_decoder_->UpdateConstraintState(decoded_ids));
     }
-    return ComputeLogLikelihood(logits_data, step_input_ids, temperature);
+    const int last_token_id = forced_token_ids[num_forced_tokens - 1];
+    LITERT_RETURN_IF_ERROR(
+        decoded_ids.Write<int>(absl::MakeConstSpan(&last_token_id, 1)));
+    constrained_token_ids_.insert(
+        constrained_token_ids_.end(), forced_token_ids.begin(),
+        forced_token_ids.begin() + num_forced_tokens);
+    return all_done;
+  }
+
+  // Emits the tokens ending the reasoning once it is over budget, instead of
+  // sampling. With external sampling, the forced tokens replace the sampled
+  // one, which the executor has not attended to yet, and are appended in a
+  // single executor invocation when it implements SpeculativeLlmExecutor.
+  // With internal sampling, the executor samples the next forced token
+  // through a bitmask allowing only it. Returns if all stops have been found.
+  absl::StatusOr<bool> EndReasoning(
+      std::optional<litert::TensorBuffer*> decoded_ids,
+      int max_num_forced_tokens) {
+    const absl::Span<const int> forced_tokens =
+        reasoning_budget_->GetForcedTokens();
+    const std::vector<int> forced_token_ids(forced_tokens.begin(),
+                                            forced_tokens.end());
+    num_tokens_in_last_step_ = 1;
+    if (!sampler_.has_value()) {
+      if (reasoning_bitmask_executor_ == nullptr) {
+        return absl::FailedPreconditionError(
+            "Ending the reasoning with internal sampling requires an executor "
+            "implementing TokenBitmaskLlmExecutor, and no batching slot.");
+      }
+      if (forced_token_bitmask_.empty()) {
+        ASSIGN_OR_RETURN(const int vocab_size, executor_.GetVocabSize());
+        forced_token_bitmask_.resize((vocab_size + 31) / 32);
+      }
+      std::fill(forced_token_bitmask_.begin(), forced_token_bitmask_.end(), 0);
+      const int token_id = forced_token_ids[0];
+      forced_token_bitmask_[token_id / 32] = 1u << (token_id % 32);
+      RETURN_IF_ERROR(reasoning_bitmask_executor_->DecodeWithTokenBitmasks(
+          output_tokens_, ExecutorDecodeParams(), forced_token_bitmask_));
+      if (token_bitmask_executor_ != nullptr) {
+        bitmask_token_ids_[0].push_back(token_id);
+      }
+      return ProcessNextTokens(output_tokens_);
+    }
+
+    litert::TensorBuffer& next_tokens = *decoded_ids.value();
+    // The forced tokens are certain.
+    const float score = 0.0f;
+    if (reasoning_jump_executor_ == nullptr ||
+        max_num_forced_tokens < static_cast<int>(forced_token_ids.size())) {
+      RETURN_IF_ERROR(DecodeAndSample(decoded_ids).status());
+      LITERT_RETURN_IF_ERROR(next_tokens.Write<int>(
+          absl::MakeConstSpan(forced_token_ids.data(), 1)));
+      LITERT_RETURN_IF_ERROR(
+          scores_tensor_.Write<float>(absl::MakeConstSpan(&score, 1)));
+      if (jump_forward_constraint_ != nullptr) {
+        constrained_token_ids_.push_back(forced_token_ids[0]);
+      }
+      return ProcessNextTokens(next_tokens);
+    }
+
+    LITERT_ASSIGN_OR_RETURN(auto next_tokens_span,
+                            ReferTensorBufferAsSpan<int>(next_tokens));
+    std::vector<int> appended_token_ids = {next_tokens_span[0]};
+    if (constrained_decoder_) {
+      RETURN_IF_ERROR(constrained_decoder_->UpdateConstraintState(next_tokens));
+    }
+    LITERT_RETURN_IF_ERROR(
+        scores_tensor_.Write<float>(absl::MakeConstSpan(&score, 1)));
+    // The forced tokens are post-processed one by one, like the tokens of a
+    // jump-forward step, and the ones following a stop are dropped.
+    std::string step_text;
+    bool all_done = false;
+    int num_forced_tokens = 0;
+    for (const int token_id : forced_token_ids) {
+      LITERT_RETURN_IF_ERROR(
+          next_tokens.Write<int>(absl::MakeConstSpan(&token_id, 1)));
+      ASSIGN_OR_RETURN(all_done, ProcessNextTokens(next_tokens));
+      step_text += result_text_[0];
+      ++num_forced_tokens;
+      if (all_done) {
+        break;
+      }
+    }
+    result_text_[0] = std::move(step_text);
+    num_tokens_in_last_step_ = num_forced_tokens;
+
+    appended_token_ids.insert(appended_token_ids.end(),
+                              forced_token_ids.begin(),
+                              forced_token_ids.begin() + num_forced_tokens - 1);
+    if (benchmark_info_.has_value()) {
+      benchmark_info_->TimeMarkDelta(BenchmarkMark::kExecutorJumpForward);
+    }
+    RETURN_IF_ERROR(
+        reasoning_jump_executor_->PredictNextTokens(appended_token_ids)
+            .status());
+    if (benchmark_info_.has_value()) {
+      benchmark_info_->TimeMarkDelta(BenchmarkMark::kExecutorJumpForward);
+    }
+    // The constraint state follows the appended forced tokens, the next step
+    // updates it with the last one, left in `decoded_ids`.
+    if (constrained_decoder_) {
+      for (int i = 1; i < appended_token_ids.size(); ++i) {
+        LITERT_RETURN_IF_ERROR(next_tokens.Write<int>(
+            absl::MakeConstSpan(&appended_token_ids[i], 1)));
+        RETURN_IF_ERROR(
+            constrained_decoder_->UpdateConstraintState(next_tokens));
+      }
+    }
+    const int last_token_id = forced_token_ids[num_forced_tokens - 1];
+    LITERT_RETURN_IF_ERROR(
+        next_tokens.Write<int>(absl::MakeConstSpan(&last_token_id, 1)));
+    if (jump_forward_constraint_ != nullptr) {
+      constrained_token_ids_.insert(
+          constrained_token_ids_.end(), forced_token_ids.begin(),
+          forced_token_ids.begin() + num_forced_tokens);
+    }
+    return all_done;
   }
 
- private:
   // Runs the core decoding and sampling step, for either internal or external
   // sampling. Returns a pointer to the tensor buffer containing the next token
   // IDs.
@@ -248,43 +687,66 @@ class DecodeOneStep {
       // Update constraint state based on the current token id before the
       // decode.
       if (constrained_decoder_) {
-        LITERT_ASSIGN_OR_RETURN(auto last_token_ids,
-                                decoded_ids.value()->Duplicate());
         RETURN_IF_ERROR(
-            constrained_decoder_->UpdateConstraintState(last_token_ids));
+            constrained_decoder_->UpdateConstraintState(*decoded_ids.value()));
       }
       // Decoding section.
       if (benchmark_info_.has_value()) {
-        RETURN_IF_ERROR(benchmark_info_->TimeMarkDelta("executor_decode"));
+        benchmark_info_->TimeMarkDelta(BenchmarkMark::kExecutorDecode);
       }
       ASSIGN_OR_RETURN(auto output_logits, executor_.DecodeLogits(inputs));
       if (benchmark_info_.has_value()) {
-        RETURN_IF_ERROR(benchmark_info_->TimeMarkDelta("executor_decode"));
+        benchmark_info_->TimeMarkDelta(BenchmarkMark::kExecutorDecode);
       }
       // If constrained decoding is enabled, masks the logits based on the
       // constraint state.
       if (constrained_decoder_) {
+        ScopedTraceSlice trace("decode", "MaskLogits");
         RETURN_IF_ERROR(constrained_decoder_->MaskLogits(output_logits));
       }
+      if (logits_processor_ != nullptr) {
+        ScopedTraceSlice trace("decode", "ProcessLogits");
+        RETURN_IF_ERROR(ApplyLogitsProcessor(output_logits));
+      }
 
       // Samping section.
       if (benchmark_info_.has_value()) {
-        RETURN_IF_ERROR(benchmark_info_->TimeMarkDelta("sampling"));
+        benchmark_info_->TimeMarkDelta(BenchmarkMark::kSampling);
       }
       RETURN_IF_ERROR(sampler_.value()->SampleToIdAndScoreBuffer(
           output_logits, *decoded_ids.value(), &scores_tensor_));
       if (benchmark_info_.has_value()) {
-        RETURN_IF_ERROR(benchmark_info_->TimeMarkDelta("sampling"));
+        benchmark_info_->TimeMarkDelta(BenchmarkMark::kSampling);
       }
 
       return decoded_ids.value();
     } else {  // Internal sampling path
+      if (logits_processor_ != nullptr &&
+          logits_processing_executor_ == nullptr) {
+        return absl::UnimplementedError(
+            "Processing the logits requires the CPU sampler backend or an "
+            "executor implementing LogitsProcessingLlmExecutor.");
+      }
       // Benchmark executor_decode_and_sample section.
       if (benchmark_info_.has_value()) {
-        RETURN_IF_ERROR(
-            benchmark_info_->TimeMarkDelta("executor_decode_and_sample"));
+        benchmark_info_->TimeMarkDelta(BenchmarkMark::kExecutorDecodeAndSample);
       }
-      if (constrained_decoder_) {
+      if (batching_slot_ != nullptr) {
+        RETURN_IF_ERROR(batching_slot_->DecodeStep(
+            output_tokens_, constrained_decoder_.get(), logits_processor_));
+      } else if (token_bitmask_executor_ != nullptr) {
+        ScopedTraceSlice trace("decode", "FillTokenBitmasks");
+        RETURN_IF_ERROR(FillTokenBitmasks());
+        RETURN_IF_ERROR(token_bitmask_executor_->DecodeWithTokenBitmasks(
+            output_tokens_, ExecutorDecodeParams(), token_bitmasks_));
+      } else if (logits_processor_ != nullptr) {
+        auto decode_params = ExecutorDecodeParams();
+        if (constrained_decoder_) {
+          decode_params.SetConstraintDecoder(constrained_decoder_.get());
+        }
+        RETURN_IF_ERROR(logits_processing_executor_->DecodeWithLogitsProcessor(
+            output_tokens_, decode_params, *logits_processor_));
+      } else if (constrained_decoder_) {
         auto decode_params = ExecutorDecodeParams();
         decode_params.SetConstraintDecoder(constrained_decoder_.get());
         RETURN_IF_ERROR(executor_.Decode(output_tokens_, decode_params));
@@ -292,20 +754,96 @@ class DecodeOneStep {
         RETURN_IF_ERROR(executor_.Decode(output_tokens_));
       }
       if (benchmark_info_.has_value()) {
-        RETURN_IF_ERROR(
-            benchmark_info_->TimeMarkDelta("executor_decode_and_sample"));
+        benchmark_info_->TimeMarkDelta(BenchmarkMark::kExecutorDecodeAndSample);
       }
       return &output_tokens_;
     }
   }
 
+  // Fills `token_bitmasks_` with the tokens the constraint allows next for
+  // each of the output candidates.
+  absl::Status FillTokenBitmasks() {
+    if (num_bitmask_words_ == 0) {
+      ASSIGN_OR_RETURN(const int vocab_size, executor_.GetVocabSize());
+      num_bitmask_words_ = (vocab_size + 31) / 32;
+      token_bitmasks_.resize(num_output_candidates_ * num_bitmask_words_);
+    }
+    for (int i = 0; i < num_output_candidates_; ++i) {
+      RETURN_IF_ERROR(token_bitmask_constraint_->FillTokenBitmask(
+          bitmask_token_ids_[i],
+          absl::MakeSpan(token_bitmasks_)
+              .subspan(i * num_bitmask_words_, num_bitmask_words_)));
+    }
+    return absl::OkStatus();
+  }
+
+  // Applies the logits processor to the logits of the step before sampling,
+  // in place if they are in host memory, otherwise through a copy written
+  // back.
+  absl::Status ApplyLogitsProcessor(litert::TensorBuffer& logits) {
+    if (auto logits_span = ReferTensorBufferAsSpan<float>(logits)) {
+      return logits_processor_->Apply(*logits_span);
+    }
+    LITERT_ASSIGN_OR_RETURN(size_t logits_size, logits.PackedSize());
+    host_logits_.resize(logits_size / sizeof(float));
+    LITERT_RETURN_IF_ERROR(logits.Read(absl::MakeSpan(host_logits_)));
+    RETURN_IF_ERROR(logits_processor_->Apply(absl::MakeSpan(host_logits_)));
+    LITERT_RETURN_IF_ERROR(logits.Write<float>(host_logits_));
+    return absl::OkStatus();
+  }
+
   LlmExecutor& executor_;
-  Tokenizer& tokenizer_;
   const int num_output_candidates_;
   std::optional<Sampler*> sampler_;
+  // Only used for internal sampling.
+  ContinuousBatchingScheduler::Slot* batching_slot_;
+  // Processes the logits before sampling, if provided. With internal
+  // sampling, the executor applies it.
+  LogitsProcessor* logits_processor_;
+  LogitsProcessingLlmExecutor* logits_processing_executor_ = nullptr;
+  // Ends the reasoning once over budget, if provided, only for a single output
+  // candidate. With external sampling, the forced tokens are appended by the
+  // executor implementing SpeculativeLlmExecutor, if any. With internal
+  // sampling, the executor samples them through `forced_token_bitmask_`.
+  ReasoningBudget* reasoning_budget_;
+  SpeculativeLlmExecutor* reasoning_jump_executor_ = nullptr;
+  TokenBitmaskLlmExecutor* reasoning_bitmask_executor_ = nullptr;
+  std::vector<uint32_t> forced_token_bitmask_;
+  // Receives the logits of the processor when they are not in host memory.
+  std::vector<float> host_logits_;
   std::unique_ptr<ConstrainedDecoder> constrained_decoder_;
+  // Set when the constraint and the executor support jump-forward decoding,
+  // only for external sampling with a single output candidate.
+  JumpForwardConstraint* jump_forward_constraint_ = nullptr;
+  SpeculativeLlmExecutor* jump_forward_executor_ = nullptr;
+  // The tokens emitted so far under the constraint, for jump-forward decoding.
+  std::vector<int> constrained_token_ids_;
+  // Set when the constraint and the executor support masking the logits with
+  // token bitmasks in the sampler of the executor, only for internal sampling
+  // without a batching slot or a logits processor.
+  TokenBitmaskConstraint* token_bitmask_constraint_ = nullptr;
+  TokenBitmaskLlmExecutor* token_bitmask_executor_ = nullptr;
+  // The tokens decoded so far by each candidate, and the bitmasks of the
+  // tokens allowed next, `num_bitmask_words_` words per candidate.
+  std::vector<std::vector<int>> bitmask_token_ids_;
+  std::vector<uint32_t> token_bitmasks_;
+  int num_bitmask_words_ = 0;
+  // Set when the executor can run several decode steps in a single call, only
+  // for internal sampling of a single candidate without a constraint, a
+  // batching slot or a logits processor.
+  MultiStepDecodeLlmExecutor* multi_step_executor_ = nullptr;
+  // Receives the tokens of the steps run by the multi-step executor.
+  std::vector<int> multi_step_token_ids_;
   std::optional<BenchmarkInfo> benchmark_info_;
   StopTokenDetector stop_token_detector_;
+  // Handles the partial BPE sequences and the "▁" mapping.
+  IncrementalDetokenizer detokenizer_;
+  // Matches the stop sequences of the session, if provided.
+  std::optional<StopSequenceMatcher> stop_sequence_matcher_;
+  // Receives the logits downloaded for scoring, the one of the session if
+  // provided.
+  LogitsStagingBuffer owned_logits_staging_buffer_;
+  LogitsStagingBuffer& logits_staging_buffer_;
 
   // For internal sampling.
   // Holds the output token IDs. Dim: {num_output_candidates, 1}
@@ -317,21 +855,54 @@ class DecodeOneStep {
   absl::Span<float> scores_span_;
 
   // Common state
-  std::vector<std::vector<int>> bpe_partial_token_ids_;
+  int num_tokens_in_last_step_ = 0;
   std::vector<std::queue<std::string>> pending_stop_tokens_;
   std::vector<std::string> result_text_;
+  // The candidates dropped from the decode.
+  std::vector<bool> pruned_;
 };
 
-absl::StatusOr<Responses> DecodeLoop(
+// The decode loop, specialized at compile time on whether the responses are
+// streamed and whether the sampling is done by an external sampler, so that
+// the common case of a streamed decode sampled by the executor runs without
+// the branches of the others.
+template <bool kIsStreaming, bool kIsCustomSampling>
+absl::StatusOr<Responses> DecodeLoopImpl(
     LlmExecutor& executor, Tokenizer& tokenizer,
     const StopTokenDetector& stop_token_detector, int num_output_candidates,
     std::optional<BenchmarkInfo>& benchmark_info,
     std::optional<Sampler*> sampler, Constraint* constraint,
     std::optional<litert::TensorBuffer*> decoded_ids,
     std::optional<absl::AnyInvocable<void(absl::StatusOr<Responses>)>> callback,
-    std::atomic<bool>* cancelled) {
-  const bool is_streaming = callback.has_value();
-  const bool is_custom_sampling = sampler.has_value();
+    std::atomic<bool>* cancelled,
+    ContinuousBatchingScheduler::Slot* batching_slot,
+    SpeculativeDecoder* speculative_decoder,
+    ContextCompactor* context_compactor,
+    const StopSequences* stop_sequences,
+    const DecodeConfig::CandidatePruningOptions* candidate_pruning_options,
+    const TokenTextTable* token_text_table,
+    LogitsProcessor* logits_processor, ReasoningBudget* reasoning_budget,
+    int max_num_tokens) {
+  constexpr bool is_streaming = kIsStreaming;
+  constexpr bool is_custom_sampling = kIsCustomSampling;
+  // A speculative step may write up to max_num_draft_tokens + 1 tokens into
+  // the kv-cache, so keep the room for it.
+  const int num_reserved_tokens =
+      speculative_decoder != nullptr
+          ? speculative_decoder->GetMaxNumDraftTokens()
+          : 0;
+  // The executor may be serving other sessions in between the batched decode
+  // steps, so the progress of this session is tracked by its slot.
+  auto get_current_step = [&executor, batching_slot]() {
+    return batching_slot != nullptr ? batching_slot->GetCurrentStep()
+                                    : executor.GetCurrentStep().value();
+  };
+  // Let the next batches go without this session once the loop is over.
+  absl::Cleanup end_decode = [batching_slot]() {
+    if (batching_slot != nullptr) {
+      batching_slot->EndDecode();
+    }
+  };
 
   int benchmark_decode_token_count = 0;
   if (benchmark_info.has_value()) {
@@ -356,10 +927,76 @@ absl::StatusOr<Responses> DecodeLoop(
   std::vector<int> num_decoded_tokens(num_output_candidates);
 
   int num_decode_steps = 0;
-  const int max_num_tokens = TryGetMaxNumTokens(executor);
+  max_num_tokens = TryGetMaxNumTokens(executor, max_num_tokens);
   DecodeOneStep run_one_step(&executor, &tokenizer, num_output_candidates,
                              stop_token_detector, benchmark_info, sampler,
-                             constraint);
+                             constraint, batching_slot, stop_sequences,
+                             /*logits_staging_buffer=*/nullptr,
+                             token_text_table, logits_processor,
+                             reasoning_budget);
+
+  // The candidates are pruned by their scores, which only the custom sampling
+  // provides.
+  std::optional<CandidatePruner> candidate_pruner;
+  if (candidate_pruning_options != nullptr && is_custom_sampling &&
+      num_output_candidates > 1) {
+    candidate_pruner.emplace(*candidate_pruning_options,
+                             num_output_candidates);
+  }
+  // With pruning, the candidates done with the decode are also left out of
+  // the next steps by the executors supporting it.
+  auto* masking_executor =
+      candidate_pruner.has_value()
+          ? GetExecutorExtension<CandidateMaskingLlmExecutor>(executor)
+          : nullptr;
+  std::vector<int> active_candidates(num_output_candidates);
+  std::iota(active_candidates.begin(), active_candidates.end(), 0);
+  absl::Cleanup unmask_candidates = [&]() {
+    if (masking_executor == nullptr ||
+        static_cast<int>(active_candidates.size()) == num_output_candidates) {
+      return;
+    }
+    active_candidates.resize(num_output_candidates);
+    std::iota(active_candidates.begin(), active_candidates.end(), 0);
+    auto status = masking_executor->SetActiveCandidates(active_candidates);
+    if (!status.ok()) {
+      ABSL_LOG(WARNING) << "Failed to reactivate the candidates: " << status;
+    }
+  };
+  // Prunes the candidates after a step and returns if all candidates are
+  // done.
+  std::vector<float> average_scores(num_output_candidates);
+  auto prune_candidates = [&]() -> absl::StatusOr<bool> {
+    for (int j = 0; j < num_output_candidates; ++j) {
+      average_scores[j] = num_decoded_tokens[j] > 0
+                              ? accumulated_scores[j] / num_decoded_tokens[j]
+                              : 0.0f;
+    }
+    for (int candidate :
+         candidate_pruner->Update(num_decode_steps, average_scores)) {
+      run_one_step.PruneCandidate(candidate);
+    }
+    if (run_one_step.AllDone()) {
+      return true;
+    }
+    if (masking_executor != nullptr) {
+      std::vector<int> next_active_candidates;
+      for (int candidate : active_candidates) {
+        if (!run_one_step.IsCandidateDone(candidate)) {
+          next_active_candidates.push_back(candidate);
+        }
+      }
+      if (next_active_candidates.size() < active_candidates.size()) {
+        RETURN_IF_ERROR(
+            masking_executor->SetActiveCandidates(next_active_candidates));
+        active_candidates = std::move(next_active_candidates);
+      }
+    }
+    return false;
+  };
+
+  // The end of the last step producing text, for the inter-token latencies.
+  std::optional<std::chrono::steady_clock::time_point> last_text_time;
   while (true) {
     if (cancelled != nullptr && cancelled->load()) {
       if (benchmark_info.has_value()) {
@@ -367,28 +1004,54 @@ absl::StatusOr<Responses> DecodeLoop(
         RETURN_IF_ERROR(benchmark_info->TimeDecodeTurnEnd(
             num_decode_steps * num_output_candidates));
       }
-      if (is_streaming) {
+      if constexpr (is_streaming) {
         callback.value()(absl::CancelledError("Process cancelled."));
       }
       return absl::CancelledError("Process cancelled.");
     }
-    absl::StatusOr<bool> all_done = run_one_step.Run(decoded_ids);
+    // The forced tokens of a step must fit in the context together with the
+    // input of the next step. Benchmarks decode one token per step.
+    const int max_num_forced_tokens =
+        benchmark_decode_token_count > 0
+            ? 0
+            : std::min(kMaxNumJumpForwardTokens,
+                       max_num_tokens - num_reserved_tokens -
+                           get_current_step() - 2);
+    // The steps run back to back must fit in the context. The sliding window
+    // and the benchmarks take one step at a time.
+    const int max_num_multi_steps =
+        run_one_step.SupportsMultiStep() && speculative_decoder == nullptr &&
+                context_compactor == nullptr &&
+                benchmark_decode_token_count == 0
+            ? std::min(kMaxNumMultiStepDecodeSteps,
+                       max_num_tokens - get_current_step())
+            : 0;
+    std::chrono::steady_clock::time_point step_start_time;
+    if (benchmark_info.has_value()) {
+      step_start_time = std::chrono::steady_clock::now();
+    }
+    absl::StatusOr<bool> all_done =
+        speculative_decoder != nullptr
+            ? run_one_step.RunSpeculative(*speculative_decoder)
+        : max_num_multi_steps > 1
+            ? run_one_step.RunMultiStep(max_num_multi_steps)
+            : run_one_step.Run(decoded_ids, max_num_forced_tokens);
     if (!all_done.ok()) {
-      if (is_streaming) {
+      if constexpr (is_streaming) {
         callback.value()(all_done.status());
       }
       return all_done.status();
     }
-    num_decode_steps++;
+    num_decode_steps += run_one_step.GetNumTokensInLastStep();
     std::vector<std::string> step_texts;
     std::vector<float> step_scores;
-    if (is_streaming) {
+    if constexpr (is_streaming) {
       step_texts.resize(num_output_candidates);
       step_scores.resize(num_output_candidates);
     }
     bool any_updates = false;
     for (int j = 0; j < num_output_candidates; ++j) {
-      std::string output_text = run_one_step.GetResultText()[j];
+      const std::string& output_text = run_one_step.GetResultText()[j];
       if (output_text.empty()) {
         // No output text for this candidate - could be due to
         // 1. early stopping.
@@ -397,30 +1060,72 @@ absl::StatusOr<Responses> DecodeLoop(
         continue;
       }
       any_updates = true;
-      // The tokenizer may return a token with a special character "▁" that
-      // should be replaced with a space.
-      std::string result_text = absl::StrReplaceAll(output_text, {{"▁", " "}});
-      if (is_streaming) {
-        step_texts[j] = result_text;
-        if (is_custom_sampling) {
+      if constexpr (is_custom_sampling) {
+        accumulated_scores[j] += run_one_step.GetScores()[j];
+        num_decoded_tokens[j]++;
+      }
+      if constexpr (is_streaming) {
+        step_texts[j] = output_text;
+        if constexpr (is_custom_sampling) {
           step_scores[j] = run_one_step.GetScores()[j];
         }
       } else {
-        final_texts[j] += result_text;
-        if (is_custom_sampling) {
-          accumulated_scores[j] += run_one_step.GetScores()[j];
-          num_decoded_tokens[j]++;
+        final_texts[j] += output_text;
+      }
+    }
+
+    if (benchmark_info.has_value()) {
+      const auto step_end_time = std::chrono::steady_clock::now();
+      benchmark_info->RecordExecutorStepLatency(
+          absl::FromChrono(step_end_time - step_start_time));
+      if (any_updates) {
+        if (last_text_time.has_value()) {
+          benchmark_info->RecordInterTokenLatency(
+              absl::FromChrono(step_end_time - *last_text_time));
         }
+        last_text_time = step_end_time;
       }
     }
 
-    if (is_streaming && any_updates && !*all_done) {
-      callback.value()(Responses(TaskState::kProcessing, std::move(step_texts),
-                                 std::move(step_scores)));
+    if constexpr (is_streaming) {
+      if (any_updates && !*all_done) {
+        ScopedTraceSlice trace("callback", "Callback");
+        std::chrono::steady_clock::time_point callback_start_time;
+        if (benchmark_info.has_value()) {
+          callback_start_time = std::chrono::steady_clock::now();
+        }
+        callback.value()(Responses(TaskState::kProcessing,
+                                   std::move(step_texts),
+                                   std::move(step_scores)));
+        if (benchmark_info.has_value()) {
+          benchmark_info->RecordCallbackLatency(absl::FromChrono(
+              std::chrono::steady_clock::now() - callback_start_time));
+        }
+      }
+    }
+    if (candidate_pruner.has_value() && !*all_done) {
+      all_done = prune_candidates();
+      if (!all_done.ok()) {
+        if constexpr (is_streaming) {
+          callback.value()(all_done.status());
+        }
+        return all_done.status();
+      }
     }
 
+    if (!*all_done) {
+      auto status = MaybeCompactContext(context_compactor, get_current_step(),
+                                        num_reserved_tokens + 1, batching_slot);
+      if (!status.ok()) {
+        if constexpr (is_streaming) {
+          callback.value()(status);
+        }
+        return status;
+      }
+    }
     if (ShouldStop(*all_done, benchmark_decode_token_count, num_decode_steps,
-                   executor.GetCurrentStep().value(), max_num_tokens)) {
+                   get_current_step() + num_reserved_tokens,
+                   max_num_tokens)) {
       break;
     }
   }
@@ -430,25 +1135,37 @@ absl::StatusOr<Responses> DecodeLoop(
                                                       num_output_candidates));
   }
 
-  if (is_custom_sampling) {
+  if (is_custom_sampling || speculative_decoder != nullptr) {
     // For external sampling, the sampled tokens are provided by the sampler. We
     // must run one prefill to add the stop token as pending token in the LLM
-    // Executor when stop condition is met.
-    LITERT_ASSIGN_OR_RETURN(auto duplicated_decoded_ids,
-                                 decoded_ids.value()->Duplicate());
+    // Executor when stop condition is met. The same applies to the last token
+    // emitted by speculative decoding.
+    litert::TensorBuffer pending_token_ids;
+    if constexpr (is_custom_sampling) {
+      LITERT_ASSIGN_OR_RETURN(pending_token_ids,
+                              decoded_ids.value()->Duplicate());
+    } else {
+      const std::vector<int> pending_token_id = {
+          speculative_decoder->GetPendingTokenId()};
+      LITERT_ASSIGN_OR_RETURN(
+          pending_token_ids, CopyToTensorBuffer<int>(pending_token_id, {1, 1}));
+    }
     ExecutorInputs inputs;
-    inputs.SetTextData(ExecutorTextData(std::move(duplicated_decoded_ids)));
+    inputs.SetTextData(ExecutorTextData(std::move(pending_token_ids)));
     std::optional<BenchmarkInfo> unused_benchmark_info;
     auto status = Prefill(executor, inputs, /*wait_for_completion=*/true,
-                          unused_benchmark_info);
+                          unused_benchmark_info, /*cancelled=*/nullptr,
+                          max_num_tokens);
     if (!status.ok()) {
-      if (is_streaming) callback.value()(status.status());
+      if constexpr (is_streaming) {
+        callback.value()(status.status());
+      }
       return status.status();
     }
   }
 
-  if (is_streaming) {
-    if (executor.GetCurrentStep().value() >= max_num_tokens) {
+  if constexpr (is_streaming) {
+    if (get_current_step() >= max_num_tokens) {
       callback.value()(absl::InternalError(absl::StrFormat(
           "Maximum kv-cache size reached.(%d) Please exit and re-start.",
           max_num_tokens)));
@@ -459,9 +1176,10 @@ absl::StatusOr<Responses> DecodeLoop(
   }
 
   // Finalize scores for non-streaming custom sampling.
-  if (is_custom_sampling) {
+  if constexpr (is_custom_sampling) {
     for (int j = 0; j < num_output_candidates; ++j) {
-      if (num_decoded_tokens[j] > 0) {
+      if (num_decoded_tokens[j] > 0 &&
+          !(candidate_pruner.has_value() && candidate_pruner->IsPruned(j))) {
         final_scores[j] = accumulated_scores[j] / num_decoded_tokens[j];
       } else {
         final_scores[j] = -std::numeric_limits<float>::infinity();
@@ -472,22 +1190,82 @@ absl::StatusOr<Responses> DecodeLoop(
                    std::move(final_scores));
 }
 
+absl::StatusOr<Responses> DecodeLoop(
+    LlmExecutor& executor, Tokenizer& tokenizer,
+    const StopTokenDetector& stop_token_detector, int num_output_candidates,
+    std::optional<BenchmarkInfo>& benchmark_info,
+    std::optional<Sampler*> sampler, Constraint* constraint,
+    std::optional<litert::TensorBuffer*> decoded_ids,
+    std::optional<absl::AnyInvocable<void(absl::StatusOr<Responses>)>> callback,
+    std::atomic<bool>* cancelled,
+    ContinuousBatchingScheduler::Slot* batching_slot = nullptr,
+    SpeculativeDecoder* speculative_decoder = nullptr,
+    ContextCompactor* context_compactor = nullptr,
+    const StopSequences* stop_sequences = nullptr,
+    const DecodeConfig::CandidatePruningOptions* candidate_pruning_options =
+        nullptr,
+    const TokenTextTable* token_text_table = nullptr,
+    LogitsProcessor* logits_processor = nullptr,
+    ReasoningBudget* reasoning_budget = nullptr, int max_num_tokens = 0) {
+  // Instantiates the loop for the streaming and custom sampling flags, passed
+  // as std::bool_constant.
+  auto decode_loop = [&](auto is_streaming, auto is_custom_sampling) {
+    return DecodeLoopImpl<decltype(is_streaming)::value,
+                          decltype(is_custom_sampling)::value>(
+        executor, tokenizer, stop_token_detector, num_output_candidates,
+        benchmark_info, sampler, constraint, decoded_ids, std::move(callback),
+        cancelled, batching_slot, speculative_decoder, context_compactor,
+        stop_sequences, candidate_pruning_options, token_text_table,
+        logits_processor, reasoning_budget, max_num_tokens);
+  };
+  if (callback.has_value()) {
+    if (sampler.has_value()) {
+      return decode_loop(std::true_type(), std::true_type());
+    }
+    return decode_loop(std::true_type(), std::false_type());
+  }
+  if (sampler.has_value()) {
+    return decode_loop(std::false_type(), std::true_type());
+  }
+  return decode_loop(std::false_type(), std::false_type());
+}
+
 }  // namespace
 
 absl::StatusOr<Responses> ScoreCustomSampling(
     LlmExecutor& executor, Tokenizer& tokenizer,
     const std::vector<absl::string_view>& target_texts, const float temperature,
-    litert::TensorBuffer& decoded_ids) {
+    litert::TensorBuffer& decoded_ids,
+    LogitsStagingBuffer* logits_staging_buffer, int max_num_tokens) {
+  ASSIGN_OR_RETURN(
+      std::vector<Responses> responses,
+      ScoreCustomSampling(executor, tokenizer, target_texts,
+                          absl::MakeConstSpan(&temperature, 1), decoded_ids,
+                          logits_staging_buffer, max_num_tokens));
+  return std::move(responses[0]);
+}
+
+absl::StatusOr<std::vector<Responses>> ScoreCustomSampling(
+    LlmExecutor& executor, Tokenizer& tokenizer,
+    const std::vector<absl::string_view>& target_texts,
+    absl::Span<const float> temperatures, litert::TensorBuffer& decoded_ids,
+    LogitsStagingBuffer* logits_staging_buffer, int max_num_tokens) {
+  if (temperatures.empty()) {
+    return absl::InvalidArgumentError("No temperature to score with.");
+  }
+  // Returns the responses of the scores of each temperature.
+  auto to_responses = [](std::vector<std::vector<float>> scores) {
+    std::vector<Responses> responses;
+    responses.reserve(scores.size());
+    for (std::vector<float>& temperature_scores : scores) {
+      responses.emplace_back(TaskState::kDone,
+                             /*response_texts=*/std::vector<std::string>(),
+                             std::move(temperature_scores));
+    }
+    return responses;
+  };
   const int num_output_candidates = target_texts.size();
-  const int max_num_tokens = TryGetMaxNumTokens(executor);
-  std::optional<BenchmarkInfo> benchmark_info;
-  // Create a dummy StopTokenDetector as it's not used in ScoreCustomSampling.
-  StopTokenDetector dummy_stop_token_detector(num_output_candidates);
-  DecodeOneStep run_one_step(&executor, &tokenizer,
-                             /*num_output_candidates=*/num_output_candidates,
-                             dummy_stop_token_detector, benchmark_info,
-                             /*sampler=*/std::nullopt,
-                             /*constraint=*/nullptr);
+  max_num_tokens = TryGetMaxNumTokens(executor, max_num_tokens);
   std::vector<std::vector<int>> ids_for_each_target_in_batch;
   ids_for_each_target_in_batch.reserve(target_texts.size());
   int max_num_tokens_of_target_texts = 0;
@@ -504,9 +1282,37 @@ absl::StatusOr<Responses> ScoreCustomSampling(
                      max_num_tokens_of_target_texts, " >= ", max_num_tokens));
   }
 
-  // The scores for each candidate. The scores are accumulated over the course
-  // of the decoding process.
-  std::vector<float> scores(num_output_candidates);
+  // Scores all the targets in a single invocation when the executor returns
+  // the logits of every position.
+  if (auto* prefill_logits_executor =
+          GetExecutorExtension<PrefillLogitsLlmExecutor>(executor);
+      prefill_logits_executor != nullptr) {
+    LITERT_ASSIGN_OR_RETURN(auto decoded_ids_span,
+                            ReferTensorBufferAsSpan<int>(decoded_ids));
+    RET_CHECK(!decoded_ids_span.empty()) << "decoded_ids must not be empty.";
+    ASSIGN_OR_RETURN(
+        std::vector<std::vector<float>> scores,
+        ScoreTokenSequences(*prefill_logits_executor,
+                            /*pending_token_id=*/decoded_ids_span[0],
+                            ids_for_each_target_in_batch, temperatures,
+                            logits_staging_buffer));
+    return to_responses(std::move(scores));
+  }
+
+  std::optional<BenchmarkInfo> benchmark_info;
+  // Create a dummy StopTokenDetector as it's not used in ScoreCustomSampling.
+  StopTokenDetector dummy_stop_token_detector(num_output_candidates);
+  DecodeOneStep run_one_step(&executor, &tokenizer,
+                             /*num_output_candidates=*/num_output_candidates,
+                             dummy_stop_token_detector, benchmark_info,
+                             /*sampler=*/std::nullopt,
+                             /*constraint=*/nullptr, /*batching_slot=*/nullptr,
+                             /*stop_sequences=*/nullptr, logits_staging_buffer);
+
+  // The scores for each temperature and candidate. The scores are accumulated
+  // over the course of the decoding process.
+  std::vector<std::vector<float>> scores(
+      temperatures.size(), std::vector<float>(num_output_candidates));
   // We support multiple targets by padding the targets with a null token which
   // does not exist in the vocabulary and thus does not contribute to the
   // perplexity.
@@ -524,24 +1330,28 @@ absl::StatusOr<Responses> ScoreCustomSampling(
       }
     }
     ASSIGN_OR_RETURN(
-        std::vector<float> step_log_likelihoods,
+        std::vector<std::vector<float>> step_log_likelihoods,
         run_one_step.RunScoreStep(
-            temperature, decoded_ids_for_each_target_in_batch, decoded_ids));
-    for (int j = 0; j < num_output_candidates; ++j) {
-      const int size_of_jth_target = ids_for_each_target_in_batch[j].size();
-      // Only add the log likelihood of the non-padded tokens to the score.
-      if (i < size_of_jth_target) {
-        scores[j] += step_log_likelihoods[j];
+            temperatures, decoded_ids_for_each_target_in_batch, decoded_ids));
+    for (int t = 0; t < temperatures.size(); ++t) {
+      for (int j = 0; j < num_output_candidates; ++j) {
+        const int size_of_jth_target = ids_for_each_target_in_batch[j].size();
+        // Only add the log likelihood of the non-padded tokens to the score.
+        if (i < size_of_jth_target) {
+          scores[t][j] += step_log_likelihoods[t][j];
+        }
       }
     }
   }
-  return Responses(TaskState::kDone, /*response_texts=*/{}, std::move(scores));
+  return to_responses(std::move(scores));
 }
 
 absl::StatusOr<int> Prefill(LlmExecutor& executor, ExecutorInputs& inputs,
                             bool wait_for_completion,
-                            std::optional<BenchmarkInfo>& benchmark_info) {
-  const int max_num_tokens = TryGetMaxNumTokens(executor);
+                            std::optional<BenchmarkInfo>& benchmark_info,
+                            std::atomic<bool>* cancelled, int max_num_tokens) {
+  ScopedTraceSlice trace("prefill", "Prefill");
+  max_num_tokens = TryGetMaxNumTokens(executor, max_num_tokens);
   ASSIGN_OR_RETURN(auto text_data, inputs.GetTextDataPtr());
   RET_CHECK(text_data != nullptr) << "text_data must not be null.";
   LITERT_ASSIGN_OR_RETURN(auto token_id_tensor_type,
@@ -563,26 +1373,75 @@ absl::StatusOr<int> Prefill(LlmExecutor& executor, ExecutorInputs& inputs,
   ExecutorPrefillParams params;
   // Wait for prefill to complete if benchmark mode is enabled.
   params.SetWaitForCompletion(wait_for_completion | benchmark_info.has_value());
+
+  // Text prompts are split along the prefill signatures that pad them the
+  // least. The multimodal embeddings are placed by the executor, so the
+  // multimodal prompts are prefilled whole.
+  const bool is_text_only =
+      !inputs.GetVisionDataPtr().ok() && !inputs.GetAudioDataPtr().ok();
+  const PrefillPlan plan =
+      PlanPrefill(ids_buffer_span.size(),
+                  is_text_only ? TryGetPrefillSizes(executor) : std::set<int>());
+  auto* cancellable_executor =
+      cancelled != nullptr
+          ? GetExecutorExtension<CancellablePrefillLlmExecutor>(executor)
+          : nullptr;
+  // Runs one chunk of the prefill, giving up on the cancellation.
+  auto prefill_chunk = [&](const ExecutorInputs& chunk_inputs) -> absl::Status {
+    if (cancelled != nullptr && cancelled->load()) {
+      return absl::CancelledError("Process cancelled.");
+    }
+    if (cancellable_executor != nullptr) {
+      return cancellable_executor->PrefillCancellable(chunk_inputs, params,
+                                                      *cancelled);
+    }
+    return executor.Prefill(chunk_inputs, params);
+  };
   if (benchmark_info.has_value()) {
     RETURN_IF_ERROR(benchmark_info->TimePrefillTurnStart());
   }
-  RETURN_IF_ERROR(executor.Prefill(inputs, params));
+  if (plan.signature_sizes.size() <= 1) {
+    RETURN_IF_ERROR(prefill_chunk(inputs));
+  } else {
+    const absl::Span<const int> token_ids = ids_buffer_span;
+    int start = 0;
+    for (int signature_size : plan.signature_sizes) {
+      const absl::Span<const int> chunk =
+          token_ids.subspan(start, signature_size);
+      const int num_chunk_tokens = chunk.size();
+      LITERT_ASSIGN_OR_RETURN(
+          auto chunk_token_ids,
+          CopyToTensorBuffer<int>(chunk, {1, num_chunk_tokens}));
+      ExecutorInputs chunk_inputs;
+      chunk_inputs.SetTextData(ExecutorTextData(std::move(chunk_token_ids)));
+      RETURN_IF_ERROR(prefill_chunk(chunk_inputs));
+      start += num_chunk_tokens;
+    }
+  }
   if (benchmark_info.has_value()) {
     RETURN_IF_ERROR(benchmark_info->TimePrefillTurnEnd(ids_buffer_span.size()));
+    benchmark_info->AddPrefillPaddingTokens(plan.num_padding_tokens);
   }
   return last_token_id;
 }
 
-absl::StatusOr<Responses> Decode(LlmExecutor& executor, Tokenizer& tokenizer,
-                                 const StopTokenDetector& stop_token_detector,
-                                 int num_output_candidates,
-                                 Constraint* constraint,
-                                 std::optional<BenchmarkInfo>& benchmark_info,
-                                 std::atomic<bool>* cancelled) {
-  return DecodeLoop(
-      executor, tokenizer, stop_token_detector, num_output_candidates,
-      benchmark_info, /*sampler=*/std::nullopt, constraint,
-      /*decoded_ids=*/std::nullopt, /*callback=*/std::nullopt, cancelled);
+absl::StatusOr<Responses> Decode(
+    LlmExecutor& executor, Tokenizer& tokenizer,
+    const StopTokenDetector& stop_token_detector, int num_output_candidates,
+    Constraint* constraint, std::optional<BenchmarkInfo>& benchmark_info,
+    std::atomic<bool>* cancelled,
+    ContinuousBatchingScheduler::Slot* batching_slot,
+    ContextCompactor* context_compactor, const StopSequences* stop_sequences,
+    const TokenTextTable* token_text_table, LogitsProcessor* logits_processor,
+    ReasoningBudget* reasoning_budget, int max_num_tokens) {
+  return DecodeLoop(executor, tokenizer, stop_token_detector,
+                    num_output_candidates, benchmark_info,
+                    /*sampler=*/std::nullopt, constraint,
+                    /*decoded_ids=*/std::nullopt, /*callback=*/std::nullopt,
+                    cancelled, batching_slot, /*speculative_decoder=*/nullptr,
+                    context_compactor, stop_sequences,
+                    /*candidate_pruning_options=*/nullptr, token_text_table,
+                    logits_processor, reasoning_budget, max_num_tokens);
 }
 
 absl::Status DecodeStreaming(
@@ -590,7 +1449,11 @@ absl::Status DecodeStreaming(
     const StopTokenDetector& stop_token_detector, int num_output_candidates,
     Constraint* constraint, std::optional<BenchmarkInfo>& benchmark_info,
     absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
-    std::atomic<bool>* cancelled) {
+    std::atomic<bool>* cancelled,
+    ContinuousBatchingScheduler::Slot* batching_slot,
+    ContextCompactor* context_compactor, const StopSequences* stop_sequences,
+    const TokenTextTable* token_text_table, LogitsProcessor* logits_processor,
+    ReasoningBudget* reasoning_budget, int max_num_tokens) {
   if (callback == nullptr) {
     return absl::InvalidArgumentError(
         "Callback must not be null for streaming.");
@@ -599,7 +1462,51 @@ absl::Status DecodeStreaming(
                     num_output_candidates, benchmark_info,
                     /*sampler=*/std::nullopt, constraint,
                     /*decoded_ids=*/std::nullopt, std::move(callback),
-                    cancelled)
+                    cancelled, batching_slot, /*speculative_decoder=*/nullptr,
+                    context_compactor, stop_sequences,
+                    /*candidate_pruning_options=*/nullptr, token_text_table,
+                    logits_processor, reasoning_budget, max_num_tokens)
+      .status();
+}
+
+absl::StatusOr<Responses> DecodeSpeculative(
+    LlmExecutor& executor, Tokenizer& tokenizer,
+    const StopTokenDetector& stop_token_detector,
+    SpeculativeDecoder& speculative_decoder,
+    std::optional<BenchmarkInfo>& benchmark_info, std::atomic<bool>* cancelled,
+    const StopSequences* stop_sequences, int max_num_tokens) {
+  return DecodeLoop(executor, tokenizer, stop_token_detector,
+                    /*num_output_candidates=*/1, benchmark_info,
+                    /*sampler=*/std::nullopt, /*constraint=*/nullptr,
+                    /*decoded_ids=*/std::nullopt, /*callback=*/std::nullopt,
+                    cancelled, /*batching_slot=*/nullptr, &speculative_decoder,
+                    /*context_compactor=*/nullptr, stop_sequences,
+                    /*candidate_pruning_options=*/nullptr,
+                    /*token_text_table=*/nullptr, /*logits_processor=*/nullptr,
+                    /*reasoning_budget=*/nullptr, max_num_tokens);
+}
+
+absl::Status DecodeSpeculativeStreaming(
+    LlmExecutor& executor, Tokenizer& tokenizer,
+    const StopTokenDetector& stop_token_detector,
+    SpeculativeDecoder& speculative_decoder,
+    std::optional<BenchmarkInfo>& benchmark_info,
+    absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
+    std::atomic<bool>* cancelled, const StopSequences* stop_sequences,
+    int max_num_tokens) {
+  if (callback == nullptr) {
+    return absl::InvalidArgumentError(
+        "Callback must not be null for streaming.");
+  }
+  return DecodeLoop(executor, tokenizer, stop_token_detector,
+                    /*num_output_candidates=*/1, benchmark_info,
+                    /*sampler=*/std::nullopt, /*constraint=*/nullptr,
+                    /*decoded_ids=*/std::nullopt, std::move(callback),
+                    cancelled, /*batching_slot=*/nullptr, &speculative_decoder,
+                    /*context_compactor=*/nullptr, stop_sequences,
+                    /*candidate_pruning_options=*/nullptr,
+                    /*token_text_table=*/nullptr, /*logits_processor=*/nullptr,
+                    /*reasoning_budget=*/nullptr, max_num_tokens)
       .status();
 }
 
@@ -608,10 +1515,18 @@ absl::StatusOr<Responses> DecodeCustomSampling(
     const StopTokenDetector& stop_token_detector, int num_output_candidates,
     Sampler& sampler, litert::TensorBuffer& decoded_ids, Constraint* constraint,
     std::optional<BenchmarkInfo>& benchmark_info,
-    std::atomic<bool>* cancelled) {
+    std::atomic<bool>* cancelled, ContextCompactor* context_compactor,
+    const StopSequences* stop_sequences,
+    const DecodeConfig::CandidatePruningOptions* candidate_pruning_options,
+    const TokenTextTable* token_text_table, LogitsProcessor* logits_processor,
+    ReasoningBudget* reasoning_budget, int max_num_tokens) {
   return DecodeLoop(executor, tokenizer, stop_token_detector,
                     num_output_candidates, benchmark_info, &sampler, constraint,
-                    &decoded_ids, /*callback=*/std::nullopt, cancelled);
+                    &decoded_ids, /*callback=*/std::nullopt, cancelled,
+                    /*batching_slot=*/nullptr, /*speculative_decoder=*/nullptr,
+                    context_compactor, stop_sequences,
+                    candidate_pruning_options, token_text_table,
+                    logits_processor, reasoning_budget, max_num_tokens);
 }
 
 absl::Status DecodeCustomSamplingStreaming(
@@ -620,15 +1535,128 @@ absl::Status DecodeCustomSamplingStreaming(
     Sampler& sampler, litert::TensorBuffer& decoded_ids, Constraint* constraint,
     std::optional<BenchmarkInfo>& benchmark_info,
     absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
-    std::atomic<bool>* cancelled) {
+    std::atomic<bool>* cancelled, ContextCompactor* context_compactor,
+    const StopSequences* stop_sequences,
+    const DecodeConfig::CandidatePruningOptions* candidate_pruning_options,
+    const TokenTextTable* token_text_table, LogitsProcessor* logits_processor,
+    ReasoningBudget* reasoning_budget, int max_num_tokens) {
   if (callback == nullptr) {
     return absl::InvalidArgumentError(
         "Callback must not be null for streaming.");
   }
   return DecodeLoop(executor, tokenizer, stop_token_detector,
                     num_output_candidates, benchmark_info, &sampler, constraint,
-                    &decoded_ids, std::move(callback), cancelled)
+                    &decoded_ids, std::move(callback), cancelled,
+                    /*batching_slot=*/nullptr, /*speculative_decoder=*/nullptr,
+                    context_compactor, stop_sequences,
+                    candidate_pruning_options, token_text_table,
+                    logits_processor, reasoning_budget, max_num_tokens)
       .status();
 }
 
+absl::StatusOr<Responses> DecodeBeamSearch(
+    LlmExecutor& executor, Tokenizer& tokenizer,
+    const StopSequences& stop_sequences, int beam_width,
+    litert::TensorBuffer& decoded_ids,
+    std::optional<BenchmarkInfo>& benchmark_info, std::atomic<bool>* cancelled,
+    LogitsStagingBuffer* logits_staging_buffer, int max_num_tokens) {
+  auto* beam_search_executor =
+      GetExecutorExtension<BeamSearchLlmExecutor>(executor);
+  if (beam_search_executor == nullptr) {
+    return absl::UnimplementedError(
+        "Beam search requires an executor supporting candidate reordering.");
+  }
+  LogitsStagingBuffer owned_logits_staging_buffer;
+  if (logits_staging_buffer == nullptr) {
+    logits_staging_buffer = &owned_logits_staging_buffer;
+  }
+  if (benchmark_info.has_value()) {
+    RETURN_IF_ERROR(benchmark_info->TimeDecodeTurnStart());
+  }
+
+  BeamSearch beam_search(beam_width, stop_sequences.GetTokenAutomaton());
+  int num_decode_steps = 0;
+  max_num_tokens = TryGetMaxNumTokens(executor, max_num_tokens);
+  // Whether `decoded_ids` holds tokens not yet in the kv-cache.
+  bool has_pending_tokens = true;
+  // Keeps the room for the final prefill of the pending tokens.
+  while (!beam_search.IsDone() &&
+         executor.GetCurrentStep().value() < max_num_tokens - 1) {
+    if (cancelled != nullptr && cancelled->load()) {
+      if (benchmark_info.has_value()) {
+        RETURN_IF_ERROR(benchmark_info->TimeDecodeTurnEnd(num_decode_steps *
+                                                          beam_width));
+      }
+      return absl::CancelledError("Process cancelled.");
+    }
+    LITERT_ASSIGN_OR_RETURN(auto duplicate_decoded_ids,
+                            decoded_ids.Duplicate());
+    const ExecutorInputs inputs(
+        ExecutorTextData(std::move(duplicate_decoded_ids)),
+        /*vision_data=*/std::nullopt,
+        /*audio_data=*/std::nullopt);
+    if (benchmark_info.has_value()) {
+      benchmark_info->TimeMarkDelta(BenchmarkMark::kExecutorDecode);
+    }
+    ASSIGN_OR_RETURN(auto output_logits, executor.DecodeLogits(inputs));
+    if (benchmark_info.has_value()) {
+      benchmark_info->TimeMarkDelta(BenchmarkMark::kExecutorDecode);
+    }
+    ASSIGN_OR_RETURN(absl::Span<const float> logits_data,
+                     logits_staging_buffer->Stage(output_logits));
+    RETURN_IF_ERROR(beam_search.Step(logits_data));
+    if (beam_search.GetNextTokenIds().empty()) {
+      // Every beam ended with the step, whose input tokens are now in the
+      // kv-cache.
+      has_pending_tokens = false;
+      break;
+    }
+    // The beams sharing a parent share the kv-cache of their prefix.
+    RETURN_IF_ERROR(beam_search_executor->ReorderCandidates(
+        beam_search.GetParentIndices()));
+    decoded_ids.Write<int>(beam_search.GetNextTokenIds());
+    ++num_decode_steps;
+  }
+  if (benchmark_info.has_value()) {
+    RETURN_IF_ERROR(
+        benchmark_info->TimeDecodeTurnEnd(num_decode_steps * beam_width));
+  }
+
+  // As with the custom sampling, the last tokens of the beams are left
+  // pending in the executor.
+  if (has_pending_tokens) {
+    LITERT_ASSIGN_OR_RETURN(litert::TensorBuffer pending_token_ids,
+                            decoded_ids.Duplicate());
+    ExecutorInputs inputs;
+    inputs.SetTextData(ExecutorTextData(std::move(pending_token_ids)));
+    std::optional<BenchmarkInfo> unused_benchmark_info;
+    RETURN_IF_ERROR(Prefill(executor, inputs, /*wait_for_completion=*/true,
+                            unused_benchmark_info, /*cancelled=*/nullptr,
+                            max_num_tokens)
+                        .status());
+  }
+
+  std::vector<std::string> texts;
+  std::vector<float> scores;
+  for (const BeamSearch::Hypothesis& hypothesis :
+       beam_search.GetHypotheses()) {
+    IncrementalDetokenizer detokenizer(&tokenizer, /*num_output_candidates=*/1);
+    StopSequenceMatcher stop_sequence_matcher(stop_sequences,
+                                              /*num_output_candidates=*/1);
+    std::string text;
+    for (int token_id : hypothesis.token_ids) {
+      RETURN_IF_ERROR(detokenizer.Decode({token_id}));
+      absl::StrAppend(&text, stop_sequence_matcher.Process(
+                                 /*candidate=*/0, token_id,
+                                 detokenizer.GetDelta(/*candidate=*/0)));
+      if (stop_sequence_matcher.IsStopFound(/*candidate=*/0)) {
+        break;
+      }
+    }
+    texts.push_back(std::move(text));
+    scores.push_back(hypothesis.score);
+  }
+  return Responses(TaskState::kDone, std::move(texts), std::move(scores));
+}
+
 }  // namespace litert::lm
@@ -25,11 +25,20 @@
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
 #include "litert/cc/litert_tensor_buffer.h"  // from @litert
 #include "runtime/components/constrained_decoding/constraint.h"
 #include "runtime/components/sampler.h"
 #include "runtime/components/stop_token_detector.h"
 #include "runtime/components/tokenizer.h"
+#include "runtime/core/context_compactor.h"
+#include "runtime/core/continuous_batching_scheduler.h"
+#include "runtime/core/logits_processor.h"
+#include "runtime/core/logits_staging_buffer.h"
+#include "runtime/core/reasoning_budget.h"
+#include "runtime/core/speculative_decoder.h"
+#include "runtime/core/stop_sequence_matcher.h"
+#include "runtime/core/token_text_table.h"
 #include "runtime/engine/io_types.h"
 #include "runtime/executor/llm_executor.h"
 #include "runtime/executor/llm_executor_io_types.h"
@@ -44,27 +53,65 @@ namespace litert::lm {
 // - wait_for_completion: If true, wait for the prefill to complete before
 //   returning.
 // - benchmark_info: Optional benchmark info to record performance metrics.
+// - cancelled: Optional pointer to an atomic boolean. If the boolean is set to
+//   true, the prefill stops before its next chunk, or within the running chunk
+//   if the executor implements CancellablePrefillLlmExecutor, and returns a
+//   Cancelled error. The tokens prefilled until then stay in the context.
+// - max_num_tokens: Optional maximum number of tokens of the context of the
+//   session, at most the one of the executor. 0 for the one of the executor.
 // Returns the last token id of the prefill ids. It is used for
 //   the next decode process to determine the token id to start from.
 absl::StatusOr<int> Prefill(LlmExecutor& executor, ExecutorInputs& inputs,
                             bool wait_for_completion,
-                            std::optional<BenchmarkInfo>& benchmark_info);
+                            std::optional<BenchmarkInfo>& benchmark_info,
+                            std::atomic<bool>* cancelled = nullptr,
+                            int max_num_tokens = 0);
 
 // Runs the pipeline to decode the input prompt.
 // - executor: The executor that call the core LLM model.
 // - tokenizer: The tokenizer to decode the token ids into text.
 // - stop_token_ids: The token ids to stop the decoding process.
 // - num_output_candidates: The number of output candidates to generate.
-// - constraint: The constraint to constrain the decoding process.
+// - constraint: The constraint to constrain the decoding process. Without a
+//   batching slot or a logits processor, the token bitmasks of a
+//   TokenBitmaskConstraint are applied by the sampler of an executor
+//   implementing TokenBitmaskLlmExecutor.
 // - benchmark_info: The benchmark info to record the performance metrics.
 // - cancelled: A pointer to an atomic boolean. If the boolean is set to true,
 //   the decoding process will be cancelled.
-absl::StatusOr<Responses> Decode(LlmExecutor& executor, Tokenizer& tokenizer,
-                                 const StopTokenDetector& stop_token_detector,
-                                 int num_output_candidates,
-                                 Constraint* constraint,
-                                 std::optional<BenchmarkInfo>& benchmark_info,
-                                 std::atomic<bool>* cancelled = nullptr);
+// - batching_slot: Optional context slot of the continuous batching scheduler.
+//   If provided, the decode steps are run through the scheduler so that they
+//   can be batched with the decode steps of the other sessions.
+// - context_compactor: Optional sliding window of the context. If provided,
+//   the oldest tokens are evicted when the context is full instead of ending
+//   the decoding.
+// - stop_sequences: Optional stop sequences of the session, matched on both
+//   the token ids and the decoded text. If provided, the text of the partial
+//   stop sequences is held back by them instead of by `stop_token_detector`.
+// - token_text_table: Optional texts of the tokens of `tokenizer`, looked up
+//   instead of decoding every token with the tokenizer.
+// - logits_processor: Optional processing of the logits before sampling,
+//   updated with the decoded tokens. With internal sampling, it requires an
+//   executor implementing LogitsProcessingLlmExecutor.
+// - reasoning_budget: Optional budget of the reasoning of a single output
+//   candidate, updated with the decoded tokens. Once over budget, the end
+//   marker of the reasoning is sampled through a single-token bitmask, which
+//   requires an executor implementing TokenBitmaskLlmExecutor and no
+//   batching slot.
+// - max_num_tokens: Optional maximum number of tokens of the context of the
+//   session, at most the one of the executor. The decoding ends when the
+//   context reaches it. 0 for the one of the executor.
+absl::StatusOr<Responses> Decode(
+    LlmExecutor& executor, Tokenizer& tokenizer,
+    const StopTokenDetector& stop_token_detector, int num_output_candidates,
+    Constraint* constraint, std::optional<BenchmarkInfo>& benchmark_info,
+    std::atomic<bool>* cancelled = nullptr,
+    ContinuousBatchingScheduler::Slot* batching_slot = nullptr,
+    ContextCompactor* context_compactor = nullptr,
+    const StopSequences* stop_sequences = nullptr,
+    const TokenTextTable* token_text_table = nullptr,
+    LogitsProcessor* logits_processor = nullptr,
+    ReasoningBudget* reasoning_budget = nullptr, int max_num_tokens = 0);
 
 // Runs the pipeline to decode the input prompt. The function is similar to
 // Decode, but it outputs the result using the callback to achieve streaming
@@ -72,12 +119,66 @@ absl::StatusOr<Responses> Decode(LlmExecutor& executor, Tokenizer& tokenizer,
 // - callback: The inference callback to receive the intermediate results.
 // - cancelled: A pointer to an atomic boolean. If the boolean is set to true,
 //   the decoding process will be cancelled.
+// - batching_slot: Optional context slot of the continuous batching scheduler.
+// - context_compactor: Optional sliding window of the context.
+// - stop_sequences: Optional stop sequences of the session.
+// - token_text_table: Optional texts of the tokens of `tokenizer`.
+// - logits_processor: Optional processing of the logits before sampling.
+// - reasoning_budget: Optional budget of the reasoning.
+// - max_num_tokens: Optional maximum number of tokens of the context.
 absl::Status DecodeStreaming(
     LlmExecutor& executor, Tokenizer& tokenizer,
     const StopTokenDetector& stop_token_detector, int num_output_candidates,
     Constraint* constraint, std::optional<BenchmarkInfo>& benchmark_info,
     absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
-    std::atomic<bool>* cancelled = nullptr);
+    std::atomic<bool>* cancelled = nullptr,
+    ContinuousBatchingScheduler::Slot* batching_slot = nullptr,
+    ContextCompactor* context_compactor = nullptr,
+    const StopSequences* stop_sequences = nullptr,
+    const TokenTextTable* token_text_table = nullptr,
+    LogitsProcessor* logits_processor = nullptr,
+    ReasoningBudget* reasoning_budget = nullptr, int max_num_tokens = 0);
+
+// Runs the pipeline to decode the input prompt with greedy speculative
+// decoding, generating a single output candidate. The output is the same as
+// greedy decoding, but every step may emit several tokens for the cost of one
+// invocation of the main model.
+// - executor: The main executor, which the speculative decoder verifies the
+//   draft tokens with.
+// - tokenizer: The tokenizer to decode the token ids into text.
+// - stop_token_ids: The token ids to stop the decoding process.
+// - speculative_decoder: The speculative decoder, which must be in sync with
+//   the tokens prefilled into the executor.
+// - benchmark_info: The benchmark info to record the performance metrics.
+// - cancelled: A pointer to an atomic boolean. If the boolean is set to true,
+//   the decoding process will be cancelled.
+// - stop_sequences: Optional stop sequences of the session.
+// - max_num_tokens: Optional maximum number of tokens of the context of the
+//   session, at most the one of the executor. 0 for the one of the executor.
+absl::StatusOr<Responses> DecodeSpeculative(
+    LlmExecutor& executor, Tokenizer& tokenizer,
+    const StopTokenDetector& stop_token_detector,
+    SpeculativeDecoder& speculative_decoder,
+    std::optional<BenchmarkInfo>& benchmark_info,
+    std::atomic<bool>* cancelled = nullptr,
+    const StopSequences* stop_sequences = nullptr, int max_num_tokens = 0);
+
+// Runs the pipeline to decode the input prompt with speculative decoding. The
+// function is similar to DecodeSpeculative, but it outputs the result using the
+// callback to achieve streaming behavior.
+// - callback: The inference callback to receive the intermediate results.
+// - cancelled: A pointer to an atomic boolean. If the boolean is set to true,
+//   the decoding process will be cancelled.
+// - stop_sequences: Optional stop sequences of the session.
+// - max_num_tokens: Optional maximum number of tokens of the context.
+absl::Status DecodeSpeculativeStreaming(
+    LlmExecutor& executor, Tokenizer& tokenizer,
+    const StopTokenDetector& stop_token_detector,
+    SpeculativeDecoder& speculative_decoder,
+    std::optional<BenchmarkInfo>& benchmark_info,
+    absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
+    std::atomic<bool>* cancelled = nullptr,
+    const StopSequences* stop_sequences = nullptr, int max_num_tokens = 0);
 
 // Runs the pipeline to decode the input prompt.
 // - executor: The executor that call the core LLM model.
@@ -85,18 +186,42 @@ absl::Status DecodeStreaming(
 // - stop_token_ids: The token ids to stop the decoding process.
 // - num_output_candidates: The number of output candidates to generate.
 // - sampler: The sampler to sample the token ids from the logits.
-// - constraint: The constraint to constrain the decoding process.
+// - constraint: The constraint to constrain the decoding process. With a
+//   single output candidate, the tokens forced by a JumpForwardConstraint are
+//   appended in one invocation of an executor implementing
+//   SpeculativeLlmExecutor, instead of being decoded one by one.
 // - decoded_ids: The decoded token ids from the external sampling process.
 //   The supported shape is [num_output_candidates, 1].
 // - benchmark_info: The benchmark info to record the performance metrics.
 // - cancelled: A pointer to an atomic boolean. If the boolean is set to true,
 //   the decoding process will be cancelled.
+// - context_compactor: Optional sliding window of the context.
+// - stop_sequences: Optional stop sequences of the session.
+// - candidate_pruning_options: Optional pruning of the candidates falling
+//   behind the best ones. If provided, the candidates done with the decode are
+//   also left out of the next steps by an executor implementing
+//   CandidateMaskingLlmExecutor.
+// - token_text_table: Optional texts of the tokens of `tokenizer`.
+// - logits_processor: Optional processing of the logits before sampling.
+// - reasoning_budget: Optional budget of the reasoning of a single output
+//   candidate. Once over budget, the end marker of the reasoning replaces the
+//   sampled token, its tokens but the last being appended in a single
+//   invocation of an executor implementing SpeculativeLlmExecutor.
+// - max_num_tokens: Optional maximum number of tokens of the context of the
+//   session, at most the one of the executor. 0 for the one of the executor.
 absl::StatusOr<Responses> DecodeCustomSampling(
     LlmExecutor& executor, Tokenizer& tokenizer,
     const StopTokenDetector& stop_token_detector, int num_output_candidates,
     Sampler& sampler, litert::TensorBuffer& decoded_ids, Constraint* constraint,
     std::optional<BenchmarkInfo>& benchmark_info,
-    std::atomic<bool>* cancelled = nullptr);
+    std::atomic<bool>* cancelled = nullptr,
+    ContextCompactor* context_compactor = nullptr,
+    const StopSequences* stop_sequences = nullptr,
+    const DecodeConfig::CandidatePruningOptions* candidate_pruning_options =
+        nullptr,
+    const TokenTextTable* token_text_table = nullptr,
+    LogitsProcessor* logits_processor = nullptr,
+    ReasoningBudget* reasoning_budget = nullptr, int max_num_tokens = 0);
 
 // Runs the pipeline to decode the input prompt. The function is similar to
 // DecodeCustomSampling, but it outputs the result using the callback to
@@ -104,13 +229,54 @@ absl::StatusOr<Responses> DecodeCustomSampling(
 // - callback: The inference callback to receive the intermediate results.
 // - cancelled: A pointer to an atomic boolean. If the boolean is set to true,
 //   the decoding process will be cancelled.
+// - context_compactor: Optional sliding window of the context.
+// - stop_sequences: Optional stop sequences of the session.
+// - candidate_pruning_options: Optional pruning of the candidates.
+// - token_text_table: Optional texts of the tokens of `tokenizer`.
+// - logits_processor: Optional processing of the logits before sampling.
+// - reasoning_budget: Optional budget of the reasoning.
+// - max_num_tokens: Optional maximum number of tokens of the context.
 absl::Status DecodeCustomSamplingStreaming(
     LlmExecutor& executor, Tokenizer& tokenizer,
     const StopTokenDetector& stop_token_detector, int num_output_candidates,
     Sampler& sampler, litert::TensorBuffer& decoded_ids, Constraint* constraint,
     std::optional<BenchmarkInfo>& benchmark_info,
     absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
-    std::atomic<bool>* cancelled = nullptr);
+    std::atomic<bool>* cancelled = nullptr,
+    ContextCompactor* context_compactor = nullptr,
+    const StopSequences* stop_sequences = nullptr,
+    const DecodeConfig::CandidatePruningOptions* candidate_pruning_options =
+        nullptr,
+    const TokenTextTable* token_text_table = nullptr,
+    LogitsProcessor* logits_processor = nullptr,
+    ReasoningBudget* reasoning_budget = nullptr, int max_num_tokens = 0);
+
+// Runs the pipeline to decode the input prompt with beam search. The output
+// candidates are the `beam_width` best hypotheses, from the best, scored by
+// their log-probability per token.
+// - executor: The executor that calls the core LLM model. It must implement
+//   BeamSearchLlmExecutor and decode `beam_width` output candidates.
+// - tokenizer: The tokenizer to decode the token ids into text.
+// - stop_sequences: The stop sequences of the session. The stop token
+//   sequences end the hypotheses, and the stop strings truncate their texts.
+// - beam_width: The number of beams, i.e. of output candidates.
+// - decoded_ids: The pending token ids of the candidates, all the same. The
+//   supported shape is [beam_width, 1].
+// - benchmark_info: The benchmark info to record the performance metrics.
+// - cancelled: A pointer to an atomic boolean. If the boolean is set to true,
+//   the decoding process will be cancelled.
+// - logits_staging_buffer: Optional host memory reused to download the
+//   logits, e.g. the one of the session.
+// - max_num_tokens: Optional maximum number of tokens of the context of the
+//   session, at most the one of the executor. 0 for the one of the executor.
+absl::StatusOr<Responses> DecodeBeamSearch(
+    LlmExecutor& executor, Tokenizer& tokenizer,
+    const StopSequences& stop_sequences, int beam_width,
+    litert::TensorBuffer& decoded_ids,
+    std::optional<BenchmarkInfo>& benchmark_info,
+    std::atomic<bool>* cancelled = nullptr,
+    LogitsStagingBuffer* logits_staging_buffer = nullptr,
+    int max_num_tokens = 0);
 
 // Runs the pipeline to score the input prompt.
 // - executor: The executor that calls the core LLM model.
@@ -120,10 +286,30 @@ absl::Status DecodeCustomSamplingStreaming(
 // - temperature: The temperature to use for softmax calculations.
 // - decoded_ids: The decoded token ids from the external sampling process.
 //   The supported shape is [num_output_candidates, 1].
+// - logits_staging_buffer: Optional host memory reused to download the
+//   logits, e.g. the one of the session.
+// - max_num_tokens: Optional maximum number of tokens of the context of the
+//   session, at most the one of the executor. 0 for the one of the executor.
+// If the executor implements PrefillLogitsLlmExecutor, the targets are scored
+// against the shared context in a single invocation, starting after the first
+// decoded id, and the context is left unchanged. Any number of targets is
+// supported then. Otherwise, the targets are decoded token by token.
 absl::StatusOr<Responses> ScoreCustomSampling(
     LlmExecutor& executor, Tokenizer& tokenizer,
     const std::vector<absl::string_view>& target_text, float temperature,
-    litert::TensorBuffer& decoded_ids);
+    litert::TensorBuffer& decoded_ids,
+    LogitsStagingBuffer* logits_staging_buffer = nullptr,
+    int max_num_tokens = 0);
+
+// Same as above, but scores the targets under each of `temperatures` from the
+// logits of the same invocations, e.g. for a calibration sweep. Returns the
+// responses of the scores of each temperature, in their order.
+absl::StatusOr<std::vector<Responses>> ScoreCustomSampling(
+    LlmExecutor& executor, Tokenizer& tokenizer,
+    const std::vector<absl::string_view>& target_text,
+    absl::Span<const float> temperatures, litert::TensorBuffer& decoded_ids,
+    LogitsStagingBuffer* logits_staging_buffer = nullptr,
+    int max_num_tokens = 0);
 }  // namespace litert::lm
 
 #endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_PIPELINE_H_
@@ -14,7 +14,9 @@
 
 #include "runtime/core/pipeline.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <filesystem>  // NOLINT: Required for path manipulation.
 #include <limits>
 #include <memory>
@@ -31,10 +33,13 @@
 #include "absl/strings/string_view.h"  // from @com_google_absl
 #include "absl/time/clock.h"  // from @com_google_absl
 #include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
 #include "runtime/components/constrained_decoding/fake_constraint.h"
 #include "runtime/components/sentencepiece_tokenizer.h"
 #include "runtime/components/stop_token_detector.h"
 #include "runtime/components/tokenizer.h"
+#include "runtime/core/constraint_extensions.h"
+#include "runtime/core/llm_executor_extensions.h"
 #include "runtime/components/top_p_cpu_sampler.h"
 #include "runtime/engine/io_types.h"
 #include "runtime/executor/fake_llm_executor.h"
@@ -46,6 +51,7 @@
 namespace litert::lm {
 namespace {
 
+using ::testing::StartsWith;
 using ::testing::status::StatusIs;
 
 constexpr char kTestdataDir[] =
@@ -206,6 +212,25 @@ TEST_F(PipelineTest, DecodeReachMaxNumTokens) {
   EXPECT_EQ(responses->GetTexts()[0], " How's");
 }
 
+TEST_F(PipelineTest, DecodeReachSessionMaxNumTokens) {
+  std::optional<BenchmarkInfo> benchmark_info;
+  constexpr int kNumOutputCandidates = 1;
+  StopTokenDetector stop_token_detector(kNumOutputCandidates);
+  EXPECT_OK(stop_token_detector.AddStopTokenSequence({2294}));
+  // The session stops at its own maximum number of tokens, below the one of
+  // the executor.
+  auto responses = Decode(
+      *executor_, *tokenizer_, stop_token_detector, kNumOutputCandidates,
+      /*constraint=*/nullptr, benchmark_info, /*cancelled=*/nullptr,
+      /*batching_slot=*/nullptr, /*context_compactor=*/nullptr,
+      /*stop_sequences=*/nullptr, /*token_text_table=*/nullptr,
+      /*logits_processor=*/nullptr, /*reasoning_budget=*/nullptr,
+      /*max_num_tokens=*/3);
+  EXPECT_OK(responses);
+  EXPECT_EQ(responses->GetTexts().size(), 1);
+  EXPECT_EQ(responses->GetTexts()[0], " How's");
+}
+
 TEST_F(PipelineTest, DecodeWithMultipleOutputCandidates) {
   constexpr int kNumOutputCandidates = 3;
   // Rebuild the executor with multiple output candidates with the same prefill
@@ -259,6 +284,142 @@ TEST_F(PipelineTest, DecodeWithConstrainedDecoding) {
   EXPECT_EQ(responses->GetTexts()[0], " How's it");
 }
 
+// A constraint allowing, after the decoded tokens, only the next one of
+// `expected_token_ids`.
+class FakeTokenBitmaskConstraint : public FakeConstraint,
+                                   public TokenBitmaskConstraint {
+ public:
+  FakeTokenBitmaskConstraint(std::vector<int> expected_token_ids,
+                             int vocabulary_size)
+      : FakeConstraint(expected_token_ids, vocabulary_size),
+        expected_token_ids_(std::move(expected_token_ids)) {}
+
+  absl::Status FillTokenBitmask(absl::Span<const int> token_ids,
+                                absl::Span<uint32_t> bitmask) const override {
+    std::fill(bitmask.begin(), bitmask.end(), 0);
+    if (token_ids.size() < expected_token_ids_.size()) {
+      const int token_id = expected_token_ids_[token_ids.size()];
+      bitmask[token_id / 32] |= uint32_t{1} << (token_id % 32);
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  const std::vector<int> expected_token_ids_;
+};
+
+// Counts the decode steps masked with token bitmasks, and the tokens they
+// returned which the bitmasks do not allow.
+class FakeTokenBitmaskLlmExecutor : public FakeLlmExecutor,
+                                    public TokenBitmaskLlmExecutor {
+ public:
+  using FakeLlmExecutor::FakeLlmExecutor;
+
+  absl::Status DecodeWithTokenBitmasks(
+      litert::TensorBuffer& output_tokens, const ExecutorDecodeParams& params,
+      absl::Span<const uint32_t> token_bitmasks) override {
+    auto status = Decode(output_tokens, params);
+    if (!status.ok()) {
+      return status;
+    }
+    auto token_ids = ReferTensorBufferAsSpan<int>(output_tokens);
+    if (!token_ids) {
+      return absl::InternalError("Failed to read the output tokens.");
+    }
+    const int token_id = (*token_ids)[0];
+    if (!((token_bitmasks[token_id / 32] >> (token_id % 32)) & 1)) {
+      ++num_disallowed_tokens;
+    }
+    ++num_masked_decodes;
+    return absl::OkStatus();
+  }
+
+  int num_masked_decodes = 0;
+  int num_disallowed_tokens = 0;
+};
+
+TEST_F(PipelineTest, DecodeWithTokenBitmasksInExecutor) {
+  // " How's it" followed by the stop token.
+  const std::vector<int> expected_token_ids = {224, 24, 8, 66, 0};
+  FakeTokenBitmaskConstraint constraint(expected_token_ids,
+                                        /*vocabulary_size=*/2560);
+  std::vector<std::vector<int>> prefill_tokens = {{2}};
+  std::vector<std::vector<int>> decode_tokens = {
+      {224}, {24}, {8}, {66}, {0}};
+  FakeTokenBitmaskLlmExecutor executor(
+      /*vocab_size=*/2560, prefill_tokens, decode_tokens, /*batch_size=*/1);
+
+  std::optional<BenchmarkInfo> benchmark_info;
+  constexpr int kNumOutputCandidates = 1;
+  StopTokenDetector stop_token_detector(kNumOutputCandidates);
+  EXPECT_OK(stop_token_detector.AddStopTokenSequence({0}));
+  ASSERT_OK_AND_ASSIGN(
+      Responses responses,
+      Decode(executor, *tokenizer_, stop_token_detector, kNumOutputCandidates,
+             &constraint, benchmark_info));
+  EXPECT_EQ(responses.GetTexts()[0], " How's it");
+  EXPECT_EQ(executor.num_masked_decodes,
+            static_cast<int>(expected_token_ids.size()));
+  EXPECT_EQ(executor.num_disallowed_tokens, 0);
+}
+
+// Runs the steps of DecodeSteps one by one, and counts the calls and the
+// steps rolled back.
+class FakeMultiStepLlmExecutor : public FakeLlmExecutor,
+                                 public MultiStepDecodeLlmExecutor {
+ public:
+  using FakeLlmExecutor::FakeLlmExecutor;
+
+  absl::StatusOr<int> DecodeSteps(absl::Span<int> output_tokens) override {
+    auto step_tokens = CreateTensorBuffer<int>({1, 1});
+    if (!step_tokens) {
+      return absl::InternalError("Failed to create the step tokens.");
+    }
+    for (int& token_id : output_tokens) {
+      auto status = Decode(*step_tokens);
+      if (!status.ok()) {
+        return status;
+      }
+      auto token_ids = ReferTensorBufferAsSpan<int>(*step_tokens);
+      if (!token_ids) {
+        return absl::InternalError("Failed to read the output tokens.");
+      }
+      token_id = (*token_ids)[0];
+    }
+    ++num_multi_step_decodes;
+    return output_tokens.size();
+  }
+
+  absl::Status RollbackSteps(int num_steps) override {
+    num_rolled_back_steps += num_steps;
+    return absl::OkStatus();
+  }
+
+  int num_multi_step_decodes = 0;
+  int num_rolled_back_steps = 0;
+};
+
+TEST_F(PipelineTest, DecodeWithMultiStepExecutor) {
+  std::vector<std::vector<int>> prefill_tokens = {{2}};
+  std::vector<std::vector<int>> decode_tokens = {{224}, {24}, {8},    {66},
+                                                 {246}, {18}, {2295}, {2294}};
+  FakeMultiStepLlmExecutor executor(/*vocab_size=*/2560, prefill_tokens,
+                                    decode_tokens);
+
+  std::optional<BenchmarkInfo> benchmark_info;
+  constexpr int kNumOutputCandidates = 1;
+  StopTokenDetector stop_token_detector(kNumOutputCandidates);
+  EXPECT_OK(stop_token_detector.AddStopTokenSequence({2295}));
+  ASSERT_OK_AND_ASSIGN(
+      Responses responses,
+      Decode(executor, *tokenizer_, stop_token_detector, kNumOutputCandidates,
+             /*constraint=*/nullptr, benchmark_info));
+  // The 8 steps run in a single call, and the one after "?" is rolled back.
+  EXPECT_EQ(responses.GetTexts()[0], " How's it going");
+  EXPECT_EQ(executor.num_multi_step_decodes, 1);
+  EXPECT_EQ(executor.num_rolled_back_steps, 1);
+}
+
 TEST_F(PipelineTest, DecodeStreaming) {
   std::optional<BenchmarkInfo> benchmark_info;
 
@@ -447,6 +608,29 @@ TEST_F(PipelineCustomSamplingTest, Prefill) {
   EXPECT_EQ(*last_prefill_token_id, 2294);
 }
 
+TEST_F(PipelineCustomSamplingTest, PrefillCancelled) {
+  const std::string prompt = "Hello World!";
+  std::optional<BenchmarkInfo> benchmark_info;
+  ASSERT_OK_AND_ASSIGN(std::vector<int> token_ids,
+                       tokenizer_->TextToTokenIds(prompt));
+  // Prepend the bos token id.
+  token_ids.insert(token_ids.begin(), 2);
+  ASSERT_OK_AND_ASSIGN(auto token_ids_buffer,
+                       tokenizer_->TokenIdsToTensorBuffer(token_ids));
+  ExecutorTextData text_data(std::move(token_ids_buffer));
+  ExecutorInputs inputs(std::move(text_data), std::nullopt, std::nullopt);
+
+  auto executor = CreateFakeLlmExecutor(
+      // "Hello World!" prepended with the bos token id (2).
+      /*prefill_tokens=*/{{2, 90, 547, 58, 735, 210, 466, 2294}});
+  std::atomic<bool> cancelled = true;
+  EXPECT_THAT(Prefill(executor, inputs, /*wait_for_completion=*/true,
+                      benchmark_info, &cancelled),
+              StatusIs(absl::StatusCode::kCancelled));
+  ASSERT_OK_AND_ASSIGN(int current_step, executor.GetCurrentStep());
+  EXPECT_EQ(current_step, 0);
+}
+
 TEST_F(PipelineCustomSamplingTest, PrefillTooLong) {
   auto executor = CreateFakeLlmExecutor(
       // "Hello World!" prepended with the bos token id (2).
@@ -516,6 +700,52 @@ TEST_F(PipelineCustomSamplingTest, DecodeCustomSampling) {
   EXPECT_EQ(responses->GetScores()[1], 0.0f);
 }
 
+TEST_F(PipelineCustomSamplingTest, DecodeCustomSamplingWithCandidatePruning) {
+  auto sampler_or = TopPSampler::Create(/*k=*/1, /*p=*/0.5, /*temperature=*/1.0,
+                                        /*batch_size=*/2, /*seed=*/1);
+  EXPECT_TRUE(sampler_or.ok());
+  std::unique_ptr<TopPSampler> sampler = std::move(sampler_or.value());
+
+  auto decoded_ids = CreateTensorBuffer<int>({2, 1});
+  std::optional<BenchmarkInfo> benchmark_info;
+  StopTokenDetector stop_token_detector(2);
+  EXPECT_OK(stop_token_detector.AddStopTokenSequence({0}));
+
+  auto executor = CreateFakeLlmExecutor(
+      /*prefill_tokens=*/{{0, 0}},
+      // " How's it going?!" and " Hello World!" followed by the stop token id
+      // (0).
+      /*decode_tokens=*/{{224, 90},
+                         {24, 547},
+                         {8, 58},
+                         {66, 735},
+                         {246, 210},
+                         {18, 466},
+                         {2295, 2294},
+                         {2294, 0},
+                         {0, 0}});
+
+  // The scores are tied, so the second candidate is pruned.
+  DecodeConfig::CandidatePruningOptions candidate_pruning_options;
+  candidate_pruning_options.max_num_candidates = 1;
+  candidate_pruning_options.min_num_decode_steps = 2;
+  ASSERT_OK_AND_ASSIGN(
+      Responses responses,
+      DecodeCustomSampling(executor, *tokenizer_, stop_token_detector,
+                           /*num_output_candidates=*/2, *sampler, *decoded_ids,
+                           /*constraint=*/nullptr, benchmark_info,
+                           /*cancelled=*/nullptr,
+                           /*context_compactor=*/nullptr,
+                           /*stop_sequences=*/nullptr,
+                           &candidate_pruning_options));
+  ASSERT_EQ(responses.GetTexts().size(), 2);
+  EXPECT_EQ(responses.GetTexts()[0], " How's it going?!");
+  EXPECT_THAT(responses.GetTexts()[1], StartsWith(" Hello"));
+  EXPECT_NE(responses.GetTexts()[1], " Hello World!");
+  EXPECT_EQ(responses.GetScores()[0], 0.0f);
+  EXPECT_EQ(responses.GetScores()[1], -std::numeric_limits<float>::infinity());
+}
+
 TEST_F(PipelineCustomSamplingTest,
        DecodeCustomSamplingWithConstrainedDecoding) {
   auto sampler_or = TopPSampler::Create(/*k=*/1, /*p=*/0.5, /*temperature=*/1.0,
@@ -590,6 +820,33 @@ TEST_F(PipelineCustomSamplingTest, ScoreCustomSamplingSingleBatch) {
   EXPECT_EQ(responses->GetScores()[0], 0.0f);
 }
 
+TEST_F(PipelineCustomSamplingTest, ScoreCustomSamplingWithTemperatures) {
+  auto decoded_ids = CreateTensorBuffer<int>(/*dimensions=*/{1, 1});
+  auto executor = CreateFakeLlmExecutor(
+      /*prefill_tokens=*/{{}},
+      /*decode_tokens=*/{{90}, {547}, {58}, {735}, {210}, {466}, {2294}, {0}},
+      /*vocab_size=*/2560,
+      /*batch_size=*/1);
+
+  const std::vector<float> temperatures = {1.0f, 2.0f};
+  auto responses = ScoreCustomSampling(
+      executor, *tokenizer_, std::vector<absl::string_view>{"Hello World!"},
+      temperatures, *decoded_ids);
+  ASSERT_OK(responses);
+  // The responses of each temperature, scored from the same decode steps.
+  ASSERT_EQ(responses->size(), 2);
+  ASSERT_EQ((*responses)[0].GetScores().size(), 1);
+  ASSERT_EQ((*responses)[1].GetScores().size(), 1);
+  EXPECT_EQ((*responses)[0].GetScores()[0], 0.0f);
+  EXPECT_LE((*responses)[1].GetScores()[0], 0.0f);
+
+  EXPECT_THAT(ScoreCustomSampling(
+                  executor, *tokenizer_,
+                  std::vector<absl::string_view>{"Hello World!"},
+                  absl::Span<const float>(), *decoded_ids),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 TEST_F(PipelineCustomSamplingTest, ScoreCustomSamplingMultiBatch) {
   auto decoded_ids = CreateTensorBuffer<int>(/*dimensions=*/{2, 1});
   StopTokenDetector stop_token_detector(/*batch_size=*/2);
@@ -0,0 +1,75 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/prefill_planner.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <set>
+#include <vector>
+
+namespace litert::lm {
+namespace {
+
+// The best decomposition covering a number of tokens.
+struct Cover {
+  int num_signature_tokens = std::numeric_limits<int>::max();
+  int num_runs = 0;
+  // The signature of the last run, 0 for none.
+  int last_size = 0;
+
+  bool operator<(const Cover& other) const {
+    return num_signature_tokens != other.num_signature_tokens
+               ? num_signature_tokens < other.num_signature_tokens
+               : num_runs < other.num_runs;
+  }
+};
+
+}  // namespace
+
+PrefillPlan PlanPrefill(int num_tokens, const std::set<int>& prefill_sizes) {
+  PrefillPlan plan;
+  if (num_tokens <= 0) {
+    return plan;
+  }
+  if (prefill_sizes.empty() || *prefill_sizes.begin() <= 0) {
+    plan.signature_sizes.push_back(num_tokens);
+    return plan;
+  }
+  // covers[t] is the best decomposition covering t tokens. Covering more
+  // tokens than left by a run pads the run.
+  std::vector<Cover> covers(num_tokens + 1);
+  covers[0].num_signature_tokens = 0;
+  for (int t = 1; t <= num_tokens; ++t) {
+    for (int size : prefill_sizes) {
+      const Cover& rest = covers[std::max(0, t - size)];
+      const Cover cover = {rest.num_signature_tokens + size,
+                           rest.num_runs + 1, size};
+      if (cover < covers[t]) {
+        covers[t] = cover;
+      }
+    }
+  }
+  plan.num_padding_tokens =
+      covers[num_tokens].num_signature_tokens - num_tokens;
+  for (int t = num_tokens; t > 0; t -= covers[t].last_size) {
+    plan.signature_sizes.push_back(covers[t].last_size);
+  }
+  std::sort(plan.signature_sizes.begin(), plan.signature_sizes.end(),
+            std::greater<int>());
+  return plan;
+}
+
+}  // namespace litert::lm
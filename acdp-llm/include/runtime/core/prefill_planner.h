@@ -0,0 +1,40 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_PREFILL_PLANNER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_PREFILL_PLANNER_H_
+
+#include <set>
+#include <vector>
+
+namespace litert::lm {
+
+// The decomposition of a prompt into the prefill signatures of a model.
+struct PrefillPlan {
+  // The number of tokens of the signatures to run, the largest first, so that
+  // only the last one is padded.
+  std::vector<int> signature_sizes;
+  // The number of tokens of the signatures run in excess of the prompt.
+  int num_padding_tokens = 0;
+};
+
+// Decomposes a prompt of `num_tokens` tokens into the prefill signatures of
+// `prefill_sizes` with the fewest padding tokens, then with the fewest
+// signature runs, e.g. 600 tokens into 512+128 rather than 1024 padded. With
+// no `prefill_sizes`, the whole prompt is one run of unknown padding.
+PrefillPlan PlanPrefill(int num_tokens, const std::set<int>& prefill_sizes);
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_PREFILL_PLANNER_H_
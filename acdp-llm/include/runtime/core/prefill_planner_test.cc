@@ -0,0 +1,60 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/prefill_planner.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(PrefillPlannerTest, PrefersSmallerSignaturesToPadding) {
+  const PrefillPlan plan = PlanPrefill(600, {128, 512, 1024});
+  EXPECT_THAT(plan.signature_sizes, ElementsAre(512, 128));
+  EXPECT_EQ(plan.num_padding_tokens, 40);
+}
+
+TEST(PrefillPlannerTest, PrefersFewerRunsForTheSamePadding) {
+  const PrefillPlan plan = PlanPrefill(1000, {256, 512, 1024});
+  EXPECT_THAT(plan.signature_sizes, ElementsAre(1024));
+  EXPECT_EQ(plan.num_padding_tokens, 24);
+}
+
+TEST(PrefillPlannerTest, ExactFit) {
+  const PrefillPlan plan = PlanPrefill(768, {256, 512});
+  EXPECT_THAT(plan.signature_sizes, ElementsAre(512, 256));
+  EXPECT_EQ(plan.num_padding_tokens, 0);
+}
+
+TEST(PrefillPlannerTest, RepeatsTheLargestSignature) {
+  const PrefillPlan plan = PlanPrefill(1100, {128, 512});
+  EXPECT_THAT(plan.signature_sizes, ElementsAre(512, 512, 128));
+  EXPECT_EQ(plan.num_padding_tokens, 52);
+}
+
+TEST(PrefillPlannerTest, NoSignatures) {
+  const PrefillPlan plan = PlanPrefill(100, {});
+  EXPECT_THAT(plan.signature_sizes, ElementsAre(100));
+  EXPECT_EQ(plan.num_padding_tokens, 0);
+}
+
+TEST(PrefillPlannerTest, NoTokens) {
+  EXPECT_TRUE(PlanPrefill(0, {128}).signature_sizes.empty());
+}
+
+}  // namespace
+}  // namespace litert::lm
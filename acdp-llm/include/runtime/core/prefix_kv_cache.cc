@@ -0,0 +1,198 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/prefix_kv_cache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/hash/hash.h"  // from @com_google_absl
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+
+namespace litert::lm {
+namespace {
+
+// Returns the length of the common prefix of `a` and `b`.
+int CommonPrefixLength(absl::Span<const int> a, absl::Span<const int> b) {
+  const int size = std::min(a.size(), b.size());
+  return std::mismatch(a.begin(), a.begin() + size, b.begin()).first -
+         a.begin();
+}
+
+}  // namespace
+
+// static
+absl::StatusOr<std::unique_ptr<PrefixKvCache>> PrefixKvCache::Create(
+    size_t max_size_bytes, int block_size) {
+  if (block_size <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("block_size must be positive, got ", block_size));
+  }
+  return absl::WrapUnique(new PrefixKvCache(max_size_bytes, block_size));
+}
+
+std::optional<PrefixKvCache::Match> PrefixKvCache::Lookup(
+    absl::Span<const int> token_ids) {
+  absl::MutexLock lock(&mutex_);
+  // Every block-aligned prefix of a cached entry is indexed, so the search
+  // can stop at the first block missing from the index.
+  const std::vector<const Entry*>* candidates = nullptr;
+  uint64_t hash = 0;
+  for (int end = block_size_; end <= token_ids.size(); end += block_size_) {
+    hash = absl::HashOf(
+        hash, token_ids.subspan(end - block_size_, block_size_));
+    auto it = index_.find(hash);
+    if (it == index_.end()) {
+      break;
+    }
+    candidates = &it->second;
+  }
+  if (candidates == nullptr) {
+    ++num_misses_;
+    return std::nullopt;
+  }
+  // The candidates share the matched blocks, but may differ after them.
+  const Entry* best_entry = nullptr;
+  int best_length = 0;
+  for (const Entry* entry : *candidates) {
+    const int length = CommonPrefixLength(entry->token_ids, token_ids);
+    if (length > best_length) {
+      best_entry = entry;
+      best_length = length;
+    }
+  }
+  // Guard against hash collisions.
+  if (best_length < block_size_) {
+    ++num_misses_;
+    return std::nullopt;
+  }
+  ++num_hits_;
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (&*it == best_entry) {
+      entries_.splice(entries_.begin(), entries_, it);
+      break;
+    }
+  }
+  return Match{best_entry->snapshot, best_length};
+}
+
+absl::Status PrefixKvCache::Insert(absl::Span<const int> token_ids,
+                                   std::unique_ptr<KvCacheSnapshot> snapshot) {
+  if (snapshot == nullptr) {
+    return absl::InvalidArgumentError("The snapshot must not be null.");
+  }
+  if (snapshot->GetNumTokens() != token_ids.size()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "The snapshot holds ", snapshot->GetNumTokens(), " tokens, expected ",
+        token_ids.size()));
+  }
+  const size_t size_in_bytes = snapshot->GetSizeInBytes();
+  if (token_ids.size() < block_size_ || size_in_bytes > max_size_bytes_) {
+    return absl::OkStatus();
+  }
+  Entry entry;
+  entry.token_ids.assign(token_ids.begin(), token_ids.end());
+  entry.block_hashes = ComputeBlockHashes(token_ids);
+  entry.snapshot = std::move(snapshot);
+
+  absl::MutexLock lock(&mutex_);
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (it->token_ids == entry.token_ids) {
+      entries_.splice(entries_.begin(), entries_, it);
+      return absl::OkStatus();
+    }
+  }
+  while (!entries_.empty() &&
+         size_in_bytes_ + size_in_bytes > max_size_bytes_) {
+    EvictOldestEntry();
+  }
+  entries_.push_front(std::move(entry));
+  const Entry* inserted = &entries_.front();
+  for (uint64_t block_hash : inserted->block_hashes) {
+    index_[block_hash].push_back(inserted);
+  }
+  size_in_bytes_ += size_in_bytes;
+  return absl::OkStatus();
+}
+
+int PrefixKvCache::GetNumEntries() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+size_t PrefixKvCache::GetSizeInBytes() const {
+  absl::MutexLock lock(&mutex_);
+  return size_in_bytes_;
+}
+
+int64_t PrefixKvCache::GetNumHits() const {
+  absl::MutexLock lock(&mutex_);
+  return num_hits_;
+}
+
+int64_t PrefixKvCache::GetNumMisses() const {
+  absl::MutexLock lock(&mutex_);
+  return num_misses_;
+}
+
+size_t PrefixKvCache::Clear() {
+  absl::MutexLock lock(&mutex_);
+  index_.clear();
+  entries_.clear();
+  return std::exchange(size_in_bytes_, 0);
+}
+
+std::vector<uint64_t> PrefixKvCache::ComputeBlockHashes(
+    absl::Span<const int> token_ids) const {
+  std::vector<uint64_t> block_hashes;
+  block_hashes.reserve(token_ids.size() / block_size_);
+  uint64_t hash = 0;
+  for (int end = block_size_; end <= token_ids.size(); end += block_size_) {
+    hash = absl::HashOf(
+        hash, token_ids.subspan(end - block_size_, block_size_));
+    block_hashes.push_back(hash);
+  }
+  return block_hashes;
+}
+
+void PrefixKvCache::EvictOldestEntry() {
+  const Entry& entry = entries_.back();
+  for (uint64_t block_hash : entry.block_hashes) {
+    auto it = index_.find(block_hash);
+    if (it == index_.end()) {
+      continue;
+    }
+    std::vector<const Entry*>& bucket = it->second;
+    bucket.erase(std::remove(bucket.begin(), bucket.end(), &entry),
+                 bucket.end());
+    if (bucket.empty()) {
+      index_.erase(it);
+    }
+  }
+  size_in_bytes_ -= entry.snapshot->GetSizeInBytes();
+  entries_.pop_back();
+}
+
+}  // namespace litert::lm
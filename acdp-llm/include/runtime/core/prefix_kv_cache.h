@@ -0,0 +1,127 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_PREFIX_KV_CACHE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_PREFIX_KV_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+
+namespace litert::lm {
+
+// An engine-wide cache of kv-cache snapshots keyed by the token ids they hold.
+// Sessions starting with the same prompt prefix, e.g. the system instruction
+// and the tool definitions of a conversation preface, restore the longest
+// cached prefix instead of prefilling it again.
+//
+// The snapshots are indexed by the hashes of their block-aligned token id
+// prefixes, so a lookup costs one hash map probe per block of the prompt. A
+// snapshot is reusable for any prefix of its tokens, so a single snapshot
+// serves all the prompts sharing its first blocks, whatever follows them.
+// The least recently used snapshots are evicted to stay within the memory
+// budget.
+//
+// The class is thread-safe.
+class PrefixKvCache {
+ public:
+  // A reusable prefix of a cached snapshot.
+  struct Match {
+    std::shared_ptr<const KvCacheSnapshot> snapshot;
+    // The number of leading tokens of the snapshot matching the looked up
+    // token ids.
+    int num_tokens = 0;
+  };
+
+  // Creates a cache holding snapshots of up to `max_size_bytes` in total.
+  // Prefixes are matched with a granularity of `block_size` tokens, which is
+  // also the minimum length of a cached prefix.
+  static absl::StatusOr<std::unique_ptr<PrefixKvCache>> Create(
+      size_t max_size_bytes, int block_size = kDefaultBlockSize);
+
+  // Returns the snapshot sharing the longest prefix with `token_ids`, or
+  // std::nullopt if no snapshot shares at least one block with them. The
+  // match never covers more than `token_ids`.
+  std::optional<Match> Lookup(absl::Span<const int> token_ids);
+
+  // Caches `snapshot`, which holds the context made of `token_ids`. Snapshots
+  // shorter than a block or larger than the memory budget are dropped.
+  absl::Status Insert(absl::Span<const int> token_ids,
+                      std::unique_ptr<KvCacheSnapshot> snapshot);
+
+  // Returns the number of cached snapshots.
+  int GetNumEntries() const;
+
+  // Returns the memory used by the cached snapshots.
+  size_t GetSizeInBytes() const;
+
+  // Returns the numbers of lookups which found and did not find a prefix since
+  // the cache was created.
+  int64_t GetNumHits() const;
+  int64_t GetNumMisses() const;
+
+  // Drops all the snapshots, e.g. under memory pressure, and returns the
+  // memory they used. The snapshots still used by the sessions are freed when
+  // they are done with them.
+  size_t Clear();
+
+  static constexpr int kDefaultBlockSize = 32;
+
+ private:
+  struct Entry {
+    std::vector<int> token_ids;
+    // The hashes of the first 1, 2, ... blocks of `token_ids`.
+    std::vector<uint64_t> block_hashes;
+    std::shared_ptr<const KvCacheSnapshot> snapshot;
+  };
+
+  PrefixKvCache(size_t max_size_bytes, int block_size)
+      : max_size_bytes_(max_size_bytes), block_size_(block_size) {}
+
+  // Returns the hashes of the first 1, 2, ... blocks of `token_ids`.
+  std::vector<uint64_t> ComputeBlockHashes(
+      absl::Span<const int> token_ids) const;
+
+  // Evicts the least recently used entry.
+  void EvictOldestEntry() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const size_t max_size_bytes_;
+  const int block_size_;
+
+  mutable absl::Mutex mutex_;
+  // The entries, most recently used first. The list keeps the addresses of
+  // the entries stable.
+  std::list<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  // Maps the hash of a block-aligned prefix to the entries starting with it.
+  absl::flat_hash_map<uint64_t, std::vector<const Entry*>> index_
+      ABSL_GUARDED_BY(mutex_);
+  size_t size_in_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t num_hits_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t num_misses_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_PREFIX_KV_CACHE_H_
@@ -0,0 +1,180 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/prefix_kv_cache.h"
+
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::StatusIs;
+
+constexpr int kBlockSize = 4;
+
+class FakeKvCacheSnapshot : public KvCacheSnapshot {
+ public:
+  FakeKvCacheSnapshot(int num_tokens, size_t size_in_bytes)
+      : num_tokens_(num_tokens), size_in_bytes_(size_in_bytes) {}
+
+  int GetNumTokens() const override { return num_tokens_; }
+  size_t GetSizeInBytes() const override { return size_in_bytes_; }
+  int GetPendingTokenId() const override { return -1; }
+
+ private:
+  const int num_tokens_;
+  const size_t size_in_bytes_;
+};
+
+std::unique_ptr<KvCacheSnapshot> CreateSnapshot(const std::vector<int>& ids,
+                                                size_t size_in_bytes = 100) {
+  return std::make_unique<FakeKvCacheSnapshot>(ids.size(), size_in_bytes);
+}
+
+// Returns the token ids {start, start + 1, ..., start + size - 1}.
+std::vector<int> Range(int start, int size) {
+  std::vector<int> ids(size);
+  std::iota(ids.begin(), ids.end(), start);
+  return ids;
+}
+
+std::vector<int> Concat(std::vector<int> a, const std::vector<int>& b) {
+  a.insert(a.end(), b.begin(), b.end());
+  return a;
+}
+
+TEST(PrefixKvCacheTest, CreateFailsWithInvalidBlockSize) {
+  EXPECT_THAT(PrefixKvCache::Create(/*max_size_bytes=*/1000, /*block_size=*/0),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(PrefixKvCacheTest, InsertFailsWithMismatchedSnapshot) {
+  ASSERT_OK_AND_ASSIGN(auto cache,
+                       PrefixKvCache::Create(/*max_size_bytes=*/1000,
+                                             kBlockSize));
+  EXPECT_THAT(cache->Insert(Range(0, 8), CreateSnapshot(Range(0, 4))),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(PrefixKvCacheTest, LookupReturnsTheLongestCommonPrefix) {
+  ASSERT_OK_AND_ASSIGN(auto cache,
+                       PrefixKvCache::Create(/*max_size_bytes=*/1000,
+                                             kBlockSize));
+  const std::vector<int> preface = Range(0, 10);
+  const std::vector<int> first_prompt = Concat(preface, Range(100, 6));
+  EXPECT_OK(cache->Insert(first_prompt, CreateSnapshot(first_prompt)));
+
+  // Shares the preface, then differs.
+  auto match = cache->Lookup(Concat(preface, Range(200, 6)));
+  ASSERT_TRUE(match.has_value());
+  EXPECT_EQ(match->num_tokens, preface.size());
+  EXPECT_EQ(match->snapshot->GetNumTokens(), first_prompt.size());
+
+  // The match does not exceed the looked up tokens.
+  auto short_match = cache->Lookup(Range(0, 6));
+  ASSERT_TRUE(short_match.has_value());
+  EXPECT_EQ(short_match->num_tokens, 6);
+}
+
+TEST(PrefixKvCacheTest, LookupRequiresAMatchingBlock) {
+  ASSERT_OK_AND_ASSIGN(auto cache,
+                       PrefixKvCache::Create(/*max_size_bytes=*/1000,
+                                             kBlockSize));
+  EXPECT_FALSE(cache->Lookup(Range(0, 8)).has_value());
+  EXPECT_OK(cache->Insert(Range(0, 8), CreateSnapshot(Range(0, 8))));
+  // Shorter than a block.
+  EXPECT_FALSE(cache->Lookup(Range(0, 3)).has_value());
+  // Differs in the first block.
+  EXPECT_FALSE(cache->Lookup(Concat({0, 1, 2, 9}, Range(4, 4))).has_value());
+  EXPECT_TRUE(cache->Lookup(Range(0, 8)).has_value());
+  EXPECT_EQ(cache->GetNumHits(), 1);
+  EXPECT_EQ(cache->GetNumMisses(), 3);
+}
+
+TEST(PrefixKvCacheTest, PicksTheBestCandidateSharingTheBlocks) {
+  ASSERT_OK_AND_ASSIGN(auto cache,
+                       PrefixKvCache::Create(/*max_size_bytes=*/1000,
+                                             kBlockSize));
+  const std::vector<int> a = Concat(Range(0, 4), {7, 7, 7});
+  const std::vector<int> b = Concat(Range(0, 4), {8, 8, 8});
+  EXPECT_OK(cache->Insert(a, CreateSnapshot(a)));
+  EXPECT_OK(cache->Insert(b, CreateSnapshot(b)));
+
+  auto match = cache->Lookup(Concat(Range(0, 4), {7, 7, 9}));
+  ASSERT_TRUE(match.has_value());
+  EXPECT_EQ(match->num_tokens, 6);
+}
+
+TEST(PrefixKvCacheTest, EvictsTheLeastRecentlyUsedSnapshots) {
+  ASSERT_OK_AND_ASSIGN(auto cache,
+                       PrefixKvCache::Create(/*max_size_bytes=*/250,
+                                             kBlockSize));
+  const std::vector<int> a = Range(0, 4);
+  const std::vector<int> b = Range(10, 4);
+  const std::vector<int> c = Range(20, 4);
+  EXPECT_OK(cache->Insert(a, CreateSnapshot(a)));
+  EXPECT_OK(cache->Insert(b, CreateSnapshot(b)));
+  // Use `a`, so that `b` is the least recently used.
+  EXPECT_TRUE(cache->Lookup(a).has_value());
+  EXPECT_OK(cache->Insert(c, CreateSnapshot(c)));
+
+  EXPECT_EQ(cache->GetNumEntries(), 2);
+  EXPECT_EQ(cache->GetSizeInBytes(), 200);
+  EXPECT_TRUE(cache->Lookup(a).has_value());
+  EXPECT_FALSE(cache->Lookup(b).has_value());
+  EXPECT_TRUE(cache->Lookup(c).has_value());
+}
+
+TEST(PrefixKvCacheTest, DropsUncacheableSnapshots) {
+  ASSERT_OK_AND_ASSIGN(auto cache,
+                       PrefixKvCache::Create(/*max_size_bytes=*/250,
+                                             kBlockSize));
+  // Shorter than a block.
+  EXPECT_OK(cache->Insert(Range(0, 3), CreateSnapshot(Range(0, 3))));
+  // Larger than the budget.
+  EXPECT_OK(cache->Insert(Range(0, 4), CreateSnapshot(Range(0, 4), 300)));
+  // Duplicated.
+  EXPECT_OK(cache->Insert(Range(0, 8), CreateSnapshot(Range(0, 8))));
+  EXPECT_OK(cache->Insert(Range(0, 8), CreateSnapshot(Range(0, 8))));
+  EXPECT_EQ(cache->GetNumEntries(), 1);
+  EXPECT_EQ(cache->GetSizeInBytes(), 100);
+}
+
+TEST(PrefixKvCacheTest, ClearDropsAllTheSnapshots) {
+  ASSERT_OK_AND_ASSIGN(auto cache,
+                       PrefixKvCache::Create(/*max_size_bytes=*/250,
+                                             kBlockSize));
+  EXPECT_OK(cache->Insert(Range(0, 4), CreateSnapshot(Range(0, 4))));
+  EXPECT_OK(cache->Insert(Range(10, 4), CreateSnapshot(Range(10, 4))));
+  EXPECT_EQ(cache->Clear(), 200);
+  EXPECT_EQ(cache->GetNumEntries(), 0);
+  EXPECT_EQ(cache->GetSizeInBytes(), 0);
+  EXPECT_FALSE(cache->Lookup(Range(0, 4)).has_value());
+
+  // The cache is usable again.
+  EXPECT_OK(cache->Insert(Range(0, 4), CreateSnapshot(Range(0, 4))));
+  EXPECT_TRUE(cache->Lookup(Range(0, 4)).has_value());
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,95 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/core/priority_task_scheduler.h"
+
+#include <iterator>
+#include <list>
+#include <utility>
+
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+absl::Status PriorityTaskScheduler::Schedule(int priority, absl::Time deadline,
+                                             Task task) {
+  std::list<WaitingTask>::iterator it;
+  {
+    absl::MutexLock lock(&mutex_);
+    it = waiting_tasks_.insert(
+        waiting_tasks_.end(),
+        WaitingTask{priority, deadline, absl::Now(), std::move(task)});
+    ++num_jobs_;
+  }
+  absl::Status status = thread_pool_.Schedule([this]() { RunTasks(); });
+  if (!status.ok()) {
+    absl::MutexLock lock(&mutex_);
+    --num_jobs_;
+    // The running jobs run the task, unless there are none left.
+    if (num_jobs_ == 0) {
+      waiting_tasks_.erase(it);
+      return status;
+    }
+  }
+  return absl::OkStatus();
+}
+
+int PriorityTaskScheduler::GetNumWaitingTasks() const {
+  absl::MutexLock lock(&mutex_);
+  return waiting_tasks_.size();
+}
+
+void PriorityTaskScheduler::RunTasks() {
+  if (thread_affinity_ != nullptr) {
+    if (auto status = thread_affinity_->ApplyOnce(); !status.ok()) {
+      ABSL_LOG(WARNING) << "Failed to bind the worker thread: " << status;
+    }
+  }
+  while (true) {
+    WaitingTask next;
+    absl::Time now;
+    {
+      absl::MutexLock lock(&mutex_);
+      if (waiting_tasks_.empty()) {
+        --num_jobs_;
+        return;
+      }
+      now = absl::Now();
+      auto aged_priority = [&](const WaitingTask& task) {
+        return task.priority +
+               absl::FDivDuration(now - task.schedule_time, aging_interval_);
+      };
+      auto best = waiting_tasks_.begin();
+      double best_priority = aged_priority(*best);
+      for (auto it = std::next(best); it != waiting_tasks_.end(); ++it) {
+        // Strictly higher, so that the ties keep the scheduling order.
+        if (const double priority = aged_priority(*it);
+            priority > best_priority) {
+          best = it;
+          best_priority = priority;
+        }
+      }
+      next = std::move(*best);
+      waiting_tasks_.erase(best);
+    }
+    next.task(/*deadline_exceeded=*/now > next.deadline);
+  }
+}
+
+}  // namespace litert::lm
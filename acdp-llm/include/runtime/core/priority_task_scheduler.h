@@ -0,0 +1,99 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_PRIORITY_TASK_SCHEDULER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_PRIORITY_TASK_SCHEDULER_H_
+
+#include <cstdint>
+#include <list>
+
+#include "absl/base/nullability.h"  // from @com_google_absl
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/framework/threadpool.h"
+#include "runtime/util/thread_affinity.h"
+
+namespace litert::lm {
+
+// Runs the tasks of the sessions of an engine on its worker thread pool in
+// the order of their priority, instead of the order they are scheduled in, so
+// that e.g. a batch evaluation does not delay the interactive requests. A
+// waiting task gains one priority level per aging interval, so that the low
+// priority tasks are delayed but never starved. The tasks of equal priority
+// run in the scheduling order.
+//
+// Every task schedules a job on the pool, which runs the best waiting tasks
+// until there are none left, so the order only matters while the pool is
+// busy. The class is thread-safe.
+class PriorityTaskScheduler {
+ public:
+  // Called with whether the deadline of the task passed before it started,
+  // in which case the task should give up instead of running.
+  using Task = absl::AnyInvocable<void(bool deadline_exceeded)>;
+
+  static constexpr absl::Duration kDefaultAgingInterval = absl::Seconds(1);
+
+  // The tasks run on `thread_pool`, which must outlive the scheduler, and
+  // wait for it to be idle before the scheduler is destroyed.
+  // `aging_interval` must be positive, infinite to disable the aging. The
+  // threads of the pool are bound to `thread_affinity`, if not null, before
+  // they run the first task; it must outlive the scheduler.
+  explicit PriorityTaskScheduler(
+      ThreadPool* absl_nonnull thread_pool,
+      absl::Duration aging_interval = kDefaultAgingInterval,
+      const ThreadAffinity* absl_nullable thread_affinity = nullptr)
+      : thread_pool_(*thread_pool),
+        aging_interval_(aging_interval),
+        thread_affinity_(thread_affinity) {}
+
+  PriorityTaskScheduler(const PriorityTaskScheduler&) = delete;
+  PriorityTaskScheduler& operator=(const PriorityTaskScheduler&) = delete;
+
+  // Schedules `task` with `priority`, the higher the sooner, to start before
+  // `deadline`.
+  absl::Status Schedule(int priority, absl::Time deadline, Task task);
+
+  // Returns the number of tasks waiting to start.
+  int GetNumWaitingTasks() const;
+
+ private:
+  struct WaitingTask {
+    int priority;
+    absl::Time deadline;
+    absl::Time schedule_time;
+    Task task;
+  };
+
+  // Runs the waiting task of the highest aged priority until there are none
+  // left.
+  void RunTasks();
+
+  ThreadPool& thread_pool_;
+  const absl::Duration aging_interval_;
+  const ThreadAffinity* absl_nullable thread_affinity_;
+
+  mutable absl::Mutex mutex_;
+  // In the scheduling order.
+  std::list<WaitingTask> waiting_tasks_ ABSL_GUARDED_BY(mutex_);
+  // The number of jobs scheduled on the pool and not done yet.
+  int num_jobs_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_PRIORITY_TASK_SCHEDULER_H_
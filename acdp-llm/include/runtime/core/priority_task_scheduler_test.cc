@@ -0,0 +1,112 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/priority_task_scheduler.h"
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/synchronization/notification.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/framework/threadpool.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+
+class PriorityTaskSchedulerTest : public ::testing::Test {
+ protected:
+  // Occupies the single thread of the pool until Release(), so that the
+  // tasks scheduled meanwhile wait.
+  void Block(PriorityTaskScheduler& scheduler) {
+    EXPECT_OK(scheduler.Schedule(
+        /*priority=*/0, absl::InfiniteFuture(),
+        [this](bool) { release_.WaitForNotification(); }));
+  }
+  void Release() { release_.Notify(); }
+
+  // Returns a task recording `id` when it runs.
+  PriorityTaskScheduler::Task Record(int id) {
+    return [this, id](bool deadline_exceeded) {
+      absl::MutexLock lock(&mutex_);
+      run_ids_.push_back(id);
+      deadline_exceeded_.push_back(deadline_exceeded);
+    };
+  }
+
+  ThreadPool thread_pool_{/*name_prefix=*/"test", /*max_num_threads=*/1};
+  absl::Notification release_;
+  absl::Mutex mutex_;
+  std::vector<int> run_ids_;
+  std::vector<bool> deadline_exceeded_;
+};
+
+TEST_F(PriorityTaskSchedulerTest, RunsHigherPriorityFirst) {
+  PriorityTaskScheduler scheduler(&thread_pool_, absl::InfiniteDuration());
+  Block(scheduler);
+  EXPECT_OK(scheduler.Schedule(/*priority=*/0, absl::InfiniteFuture(),
+                               Record(1)));
+  EXPECT_OK(scheduler.Schedule(/*priority=*/2, absl::InfiniteFuture(),
+                               Record(2)));
+  EXPECT_OK(scheduler.Schedule(/*priority=*/1, absl::InfiniteFuture(),
+                               Record(3)));
+  EXPECT_OK(scheduler.Schedule(/*priority=*/2, absl::InfiniteFuture(),
+                               Record(4)));
+  Release();
+  EXPECT_OK(thread_pool_.WaitUntilDone(absl::Seconds(10)));
+
+  // The tasks of equal priority keep the scheduling order.
+  EXPECT_THAT(run_ids_, ElementsAre(2, 4, 3, 1));
+  EXPECT_EQ(scheduler.GetNumWaitingTasks(), 0);
+}
+
+TEST_F(PriorityTaskSchedulerTest, AgingPromotesWaitingTasks) {
+  PriorityTaskScheduler scheduler(&thread_pool_, absl::Milliseconds(10));
+  Block(scheduler);
+  EXPECT_OK(scheduler.Schedule(/*priority=*/0, absl::InfiniteFuture(),
+                               Record(1)));
+  // Gains about 10 levels while waiting, more than the next task has.
+  absl::SleepFor(absl::Milliseconds(100));
+  EXPECT_OK(scheduler.Schedule(/*priority=*/2, absl::InfiniteFuture(),
+                               Record(2)));
+  Release();
+  EXPECT_OK(thread_pool_.WaitUntilDone(absl::Seconds(10)));
+
+  EXPECT_THAT(run_ids_, ElementsAre(1, 2));
+}
+
+TEST_F(PriorityTaskSchedulerTest, ReportsPassedDeadlines) {
+  PriorityTaskScheduler scheduler(&thread_pool_);
+  Block(scheduler);
+  EXPECT_OK(scheduler.Schedule(/*priority=*/0,
+                               absl::Now() + absl::Milliseconds(10),
+                               Record(1)));
+  EXPECT_OK(scheduler.Schedule(/*priority=*/0, absl::InfiniteFuture(),
+                               Record(2)));
+  EXPECT_EQ(scheduler.GetNumWaitingTasks(), 2);
+  absl::SleepFor(absl::Milliseconds(50));
+  Release();
+  EXPECT_OK(thread_pool_.WaitUntilDone(absl::Seconds(10)));
+
+  EXPECT_THAT(run_ids_, ElementsAre(1, 2));
+  EXPECT_THAT(deadline_exceeded_, ElementsAre(true, false));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,63 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/prompt_lookup_proposer.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// static
+absl::StatusOr<std::unique_ptr<PromptLookupProposer>>
+PromptLookupProposer::Create(int min_ngram_size, int max_ngram_size) {
+  if (min_ngram_size <= 0 || min_ngram_size > max_ngram_size) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid n-gram sizes: min_ngram_size=", min_ngram_size,
+                     ", max_ngram_size=", max_ngram_size));
+  }
+  return absl::WrapUnique(
+      new PromptLookupProposer(min_ngram_size, max_ngram_size));
+}
+
+absl::StatusOr<std::vector<int>> PromptLookupProposer::ProposeTokens(
+    absl::Span<const int> sequence, int max_num_tokens) {
+  const int size = sequence.size();
+  // Prefer the longest n-gram, which is the most specific match.
+  for (int n = std::min(max_ngram_size_, size - 1); n >= min_ngram_size_;
+       --n) {
+    const absl::Span<const int> suffix = sequence.subspan(size - n);
+    // Scan backwards for the most recent earlier occurrence of the suffix.
+    for (int start = size - n - 1; start >= 0; --start) {
+      if (!std::equal(suffix.begin(), suffix.end(),
+                      sequence.begin() + start)) {
+        continue;
+      }
+      const int begin = start + n;
+      const int end = std::min(size, begin + max_num_tokens);
+      return std::vector<int>(sequence.begin() + begin,
+                              sequence.begin() + end);
+    }
+  }
+  return std::vector<int>();
+}
+
+}  // namespace litert::lm
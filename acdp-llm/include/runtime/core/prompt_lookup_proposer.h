@@ -0,0 +1,52 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_PROMPT_LOOKUP_PROPOSER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_PROMPT_LOOKUP_PROPOSER_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/core/speculative_decoder.h"
+
+namespace litert::lm {
+
+// Proposes draft tokens without a draft model ("prompt lookup decoding"): the
+// last n tokens of the sequence are searched for earlier in the sequence, and
+// the tokens that followed their most recent earlier occurrence are proposed.
+// This works well when the output copies spans of the context, e.g. for
+// summarization, code editing or retrieval augmented generation.
+class PromptLookupProposer : public DraftTokenProposer {
+ public:
+  // Creates a proposer matching n-grams of `max_ngram_size` tokens down to
+  // `min_ngram_size` tokens. Requires 0 < min_ngram_size <= max_ngram_size.
+  static absl::StatusOr<std::unique_ptr<PromptLookupProposer>> Create(
+      int min_ngram_size, int max_ngram_size);
+
+  absl::StatusOr<std::vector<int>> ProposeTokens(
+      absl::Span<const int> sequence, int max_num_tokens) override;
+
+ private:
+  PromptLookupProposer(int min_ngram_size, int max_ngram_size)
+      : min_ngram_size_(min_ngram_size), max_ngram_size_(max_ngram_size) {}
+
+  const int min_ngram_size_;
+  const int max_ngram_size_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_PROMPT_LOOKUP_PROPOSER_H_
@@ -0,0 +1,82 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/prompt_lookup_proposer.h"
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::status::StatusIs;
+
+TEST(PromptLookupProposerTest, CreateFailsWithInvalidNgramSizes) {
+  EXPECT_THAT(PromptLookupProposer::Create(/*min_ngram_size=*/0,
+                                           /*max_ngram_size=*/2),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(PromptLookupProposer::Create(/*min_ngram_size=*/3,
+                                           /*max_ngram_size=*/2),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(PromptLookupProposerTest, ProposesTheContinuationOfTheLastMatch) {
+  ASSERT_OK_AND_ASSIGN(auto proposer,
+                       PromptLookupProposer::Create(/*min_ngram_size=*/1,
+                                                    /*max_ngram_size=*/3));
+  // The suffix {1, 2} last occurred at index 4.
+  const std::vector<int> sequence = {1, 2, 7, 8, 1, 2, 3, 4, 5, 1, 2};
+  ASSERT_OK_AND_ASSIGN(std::vector<int> tokens,
+                       proposer->ProposeTokens(sequence, /*max_num_tokens=*/2));
+  EXPECT_THAT(tokens, ElementsAre(3, 4));
+  // The proposal is cut at the end of the sequence.
+  ASSERT_OK_AND_ASSIGN(tokens,
+                       proposer->ProposeTokens(sequence,
+                                               /*max_num_tokens=*/10));
+  EXPECT_THAT(tokens, ElementsAre(3, 4, 5, 1, 2));
+}
+
+TEST(PromptLookupProposerTest, PrefersLongerNgrams) {
+  ASSERT_OK_AND_ASSIGN(auto proposer,
+                       PromptLookupProposer::Create(/*min_ngram_size=*/1,
+                                                    /*max_ngram_size=*/2));
+  // The unigram {2} last occurred at index 4, but the bigram {1, 2} only at
+  // index 0.
+  const std::vector<int> sequence = {1, 2, 3, 9, 2, 5, 1, 2};
+  ASSERT_OK_AND_ASSIGN(std::vector<int> tokens,
+                       proposer->ProposeTokens(sequence, /*max_num_tokens=*/2));
+  EXPECT_THAT(tokens, ElementsAre(3, 9));
+}
+
+TEST(PromptLookupProposerTest, ProposesNothingWithoutMatch) {
+  ASSERT_OK_AND_ASSIGN(auto proposer,
+                       PromptLookupProposer::Create(/*min_ngram_size=*/2,
+                                                    /*max_ngram_size=*/3));
+  ASSERT_OK_AND_ASSIGN(std::vector<int> tokens,
+                       proposer->ProposeTokens({1, 2, 3, 4, 3},
+                                               /*max_num_tokens=*/4));
+  EXPECT_THAT(tokens, IsEmpty());
+  ASSERT_OK_AND_ASSIGN(tokens,
+                       proposer->ProposeTokens({1}, /*max_num_tokens=*/4));
+  EXPECT_THAT(tokens, IsEmpty());
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,50 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/prompt_token_budget.h"
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+void PromptTokenBudget::RecordImageTokens(int num_image_tokens) {
+  if (num_image_tokens <= 0) {
+    return;
+  }
+  int recorded = num_image_tokens_.load();
+  while ((recorded == 0 || num_image_tokens < recorded) &&
+         !num_image_tokens_.compare_exchange_weak(recorded, num_image_tokens)) {
+  }
+}
+
+int PromptTokenBudget::EstimateNumTokens(int num_text_tokens, int num_images,
+                                         int num_audios) const {
+  return num_text_tokens + num_images * GetNumImageTokens() + num_audios;
+}
+
+absl::Status PromptTokenBudget::Check(int num_text_tokens, int num_images,
+                                      int num_audios) const {
+  const int num_tokens =
+      EstimateNumTokens(num_text_tokens, num_images, num_audios);
+  if (max_num_tokens_ > 0 && num_tokens >= max_num_tokens_) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Input token ids are too long. Exceeding the maximum number of tokens "
+        "allowed: at least ",
+        num_tokens, " >= ", max_num_tokens_));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace litert::lm
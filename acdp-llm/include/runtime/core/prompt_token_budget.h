@@ -0,0 +1,70 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_PROMPT_TOKEN_BUDGET_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_PROMPT_TOKEN_BUDGET_H_
+
+#include <atomic>
+
+#include "absl/status/status.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// Rejects the prompts too long for the context of the executor before their
+// images and audios are encoded, instead of after, so that a doomed request
+// does not take the encoders from the others.
+//
+// The check runs on a lower bound of the number of tokens of the prompt,
+// so it never rejects a prompt the prefill would accept:
+// - a text counts its token ids, known once it is tokenized;
+// - an image counts the tokens of the images encoded before, the vision
+//   encoder giving the same number of tokens to every image of a model;
+// - an audio counts its end token, its number of tokens depending on its
+//   length.
+//
+// The class is thread-safe.
+class PromptTokenBudget {
+ public:
+  // Creates a budget for prompts of less than `max_num_tokens` tokens, the
+  // limit of the prefill. A limit of 0 or less is unknown, and checks none.
+  explicit PromptTokenBudget(int max_num_tokens)
+      : max_num_tokens_(max_num_tokens) {}
+
+  // Records the number of tokens an image was encoded into. The smallest
+  // number recorded is kept.
+  void RecordImageTokens(int num_image_tokens);
+
+  // Returns the number of tokens counted per image, 0 until an image is
+  // encoded.
+  int GetNumImageTokens() const { return num_image_tokens_.load(); }
+
+  // Returns the lower bound of the number of tokens of a prompt made of
+  // `num_text_tokens` text tokens, `num_images` images and `num_audios`
+  // audios.
+  int EstimateNumTokens(int num_text_tokens, int num_images,
+                        int num_audios) const;
+
+  // Returns an InvalidArgumentError if the prompt is known to exceed the
+  // budget, the error the prefill would return.
+  absl::Status Check(int num_text_tokens, int num_images,
+                     int num_audios) const;
+
+ private:
+  const int max_num_tokens_;
+  std::atomic<int> num_image_tokens_ = 0;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_PROMPT_TOKEN_BUDGET_H_
@@ -0,0 +1,56 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/prompt_token_budget.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::StatusIs;
+
+TEST(PromptTokenBudgetTest, CountsTheTextTokensAndTheAudioEndTokens) {
+  PromptTokenBudget budget(/*max_num_tokens=*/10);
+  EXPECT_EQ(budget.EstimateNumTokens(/*num_text_tokens=*/5, /*num_images=*/1,
+                                     /*num_audios=*/2),
+            7);
+  EXPECT_OK(budget.Check(/*num_text_tokens=*/9, /*num_images=*/0,
+                         /*num_audios=*/0));
+  EXPECT_THAT(budget.Check(/*num_text_tokens=*/9, /*num_images=*/0,
+                           /*num_audios=*/1),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(PromptTokenBudgetTest, CountsTheSmallestNumberOfImageTokens) {
+  PromptTokenBudget budget(/*max_num_tokens=*/600);
+  EXPECT_EQ(budget.GetNumImageTokens(), 0);
+  budget.RecordImageTokens(256);
+  budget.RecordImageTokens(300);
+  EXPECT_EQ(budget.GetNumImageTokens(), 256);
+  budget.RecordImageTokens(0);
+  EXPECT_EQ(budget.GetNumImageTokens(), 256);
+
+  EXPECT_OK(budget.Check(/*num_text_tokens=*/80, /*num_images=*/2,
+                         /*num_audios=*/0));
+  EXPECT_THAT(budget.Check(/*num_text_tokens=*/88, /*num_images=*/2,
+                           /*num_audios=*/0),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,110 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/core/reasoning_budget.h"
+
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/status_macros.h"
+
+namespace litert::lm {
+
+absl::StatusOr<std::unique_ptr<ReasoningBudget>> ReasoningBudget::Create(
+    const DecodeConfig::ReasoningBudgetOptions& options,
+    Tokenizer& tokenizer) {
+  ASSIGN_OR_RETURN(std::vector<int> start_token_ids,
+                   tokenizer.TextToTokenIds(options.reasoning_start));
+  ASSIGN_OR_RETURN(std::vector<int> end_token_ids,
+                   tokenizer.TextToTokenIds(options.reasoning_end));
+  return Create(std::move(start_token_ids), std::move(end_token_ids),
+                options.max_num_reasoning_tokens);
+}
+
+absl::StatusOr<std::unique_ptr<ReasoningBudget>> ReasoningBudget::Create(
+    std::vector<int> start_token_ids, std::vector<int> end_token_ids,
+    int max_num_reasoning_tokens) {
+  if (start_token_ids.empty() || end_token_ids.empty()) {
+    return absl::InvalidArgumentError(
+        "The markers of the reasoning must not be empty.");
+  }
+  if (max_num_reasoning_tokens < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid number of reasoning tokens: ",
+                     max_num_reasoning_tokens));
+  }
+  return absl::WrapUnique(new ReasoningBudget(std::move(start_token_ids),
+                                              std::move(end_token_ids),
+                                              max_num_reasoning_tokens));
+}
+
+void ReasoningBudget::Update(int token_id) {
+  ++num_tokens_;
+  switch (phase_) {
+    case Phase::kStart:
+      if (start_token_ids_[num_matched_tokens_] != token_id) {
+        phase_ = Phase::kDone;
+        return;
+      }
+      if (++num_matched_tokens_ == start_token_ids_.size()) {
+        phase_ = Phase::kReasoning;
+        num_matched_tokens_ = 0;
+      }
+      return;
+    case Phase::kReasoning:
+      // The end marker is matched from its start only, its tokens do not
+      // repeat a prefix of it.
+      if (end_token_ids_[num_matched_tokens_] == token_id) {
+        ++num_matched_tokens_;
+      } else {
+        num_reasoning_tokens_ += num_matched_tokens_ + 1;
+        num_matched_tokens_ = end_token_ids_[0] == token_id ? 1 : 0;
+        num_reasoning_tokens_ -= num_matched_tokens_;
+      }
+      if (num_matched_tokens_ == end_token_ids_.size()) {
+        phase_ = Phase::kDone;
+        reasoning_end_ = num_tokens_;
+      }
+      return;
+    case Phase::kDone:
+      return;
+  }
+}
+
+absl::Span<const int> ReasoningBudget::GetForcedTokens() const {
+  if (phase_ != Phase::kReasoning ||
+      num_reasoning_tokens_ < max_num_reasoning_tokens_) {
+    return {};
+  }
+  return absl::MakeConstSpan(end_token_ids_).subspan(num_matched_tokens_);
+}
+
+std::optional<std::pair<int, int>> ReasoningBudget::GetReasoningRange() const {
+  if (!reasoning_end_.has_value()) {
+    return std::nullopt;
+  }
+  return std::make_pair(0, *reasoning_end_);
+}
+
+}  // namespace litert::lm
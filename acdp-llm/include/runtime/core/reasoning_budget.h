@@ -0,0 +1,95 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_REASONING_BUDGET_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_REASONING_BUDGET_H_
+
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/engine/io_types.h"
+
+namespace litert::lm {
+
+// Follows the reasoning of a decode, see DecodeConfig::ReasoningBudgetOptions,
+// through the tokens emitted one by one: the reasoning starts with the start
+// marker as the first tokens of the decode, and ends with the end marker. Once
+// the reasoning has used its budget, the decode loop emits the rest of the end
+// marker, GetForcedTokens(), instead of sampling.
+class ReasoningBudget {
+ public:
+  // Tokenizes the markers of `options` with `tokenizer`.
+  static absl::StatusOr<std::unique_ptr<ReasoningBudget>> Create(
+      const DecodeConfig::ReasoningBudgetOptions& options,
+      Tokenizer& tokenizer);
+
+  // The markers must not be empty.
+  static absl::StatusOr<std::unique_ptr<ReasoningBudget>> Create(
+      std::vector<int> start_token_ids, std::vector<int> end_token_ids,
+      int max_num_reasoning_tokens);
+
+  ReasoningBudget(const ReasoningBudget&) = delete;
+  ReasoningBudget& operator=(const ReasoningBudget&) = delete;
+
+  // Follows the next token emitted by the decode.
+  void Update(int token_id);
+
+  // Returns the tokens the decode must emit next, in order, to end the
+  // reasoning, or none while the reasoning is within its budget or over.
+  absl::Span<const int> GetForcedTokens() const;
+
+  // Returns the number of tokens of the reasoning so far.
+  int GetNumReasoningTokens() const { return num_reasoning_tokens_; }
+
+  // Returns the range of the reasoning in the tokens emitted by the decode,
+  // the markers included, once the reasoning is over.
+  std::optional<std::pair<int, int>> GetReasoningRange() const;
+
+ private:
+  enum class Phase {
+    // Matching the start marker against the first tokens.
+    kStart,
+    kReasoning,
+    // The reasoning is over, or the decode does not start with one.
+    kDone,
+  };
+
+  ReasoningBudget(std::vector<int> start_token_ids,
+                  std::vector<int> end_token_ids, int max_num_reasoning_tokens)
+      : start_token_ids_(std::move(start_token_ids)),
+        end_token_ids_(std::move(end_token_ids)),
+        max_num_reasoning_tokens_(max_num_reasoning_tokens) {}
+
+  const std::vector<int> start_token_ids_;
+  const std::vector<int> end_token_ids_;
+  const int max_num_reasoning_tokens_;
+
+  Phase phase_ = Phase::kStart;
+  int num_tokens_ = 0;
+  int num_reasoning_tokens_ = 0;
+  // The number of tokens of the marker matched by the last tokens.
+  int num_matched_tokens_ = 0;
+  // The end of the reasoning in the emitted tokens, once over.
+  std::optional<int> reasoning_end_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_REASONING_BUDGET_H_
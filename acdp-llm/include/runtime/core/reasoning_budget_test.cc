@@ -0,0 +1,110 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/core/reasoning_budget.h"
+
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::Optional;
+using ::testing::Pair;
+using ::testing::status::StatusIs;
+
+constexpr int kStart = 100;
+constexpr int kEnd1 = 101;
+constexpr int kEnd2 = 102;
+
+TEST(ReasoningBudgetTest, ForcesTheEndMarkerOnceOverBudget) {
+  ASSERT_OK_AND_ASSIGN(auto budget, ReasoningBudget::Create(
+                                        {kStart}, {kEnd1, kEnd2},
+                                        /*max_num_reasoning_tokens=*/3));
+  budget->Update(kStart);
+  budget->Update(1);
+  budget->Update(2);
+  EXPECT_THAT(budget->GetForcedTokens(), IsEmpty());
+  budget->Update(3);
+  EXPECT_EQ(budget->GetNumReasoningTokens(), 3);
+  EXPECT_THAT(budget->GetForcedTokens(), ElementsAre(kEnd1, kEnd2));
+  budget->Update(kEnd1);
+  EXPECT_THAT(budget->GetForcedTokens(), ElementsAre(kEnd2));
+  EXPECT_EQ(budget->GetReasoningRange(), std::nullopt);
+  budget->Update(kEnd2);
+  EXPECT_THAT(budget->GetForcedTokens(), IsEmpty());
+  EXPECT_THAT(budget->GetReasoningRange(), Optional(Pair(0, 6)));
+}
+
+TEST(ReasoningBudgetTest, CompletesAPartialEndMarker) {
+  ASSERT_OK_AND_ASSIGN(auto budget, ReasoningBudget::Create(
+                                        {kStart}, {kEnd1, kEnd2},
+                                        /*max_num_reasoning_tokens=*/2));
+  budget->Update(kStart);
+  budget->Update(1);
+  budget->Update(kEnd1);
+  // Not an end marker after all.
+  budget->Update(1);
+  EXPECT_EQ(budget->GetNumReasoningTokens(), 3);
+  EXPECT_THAT(budget->GetForcedTokens(), ElementsAre(kEnd1, kEnd2));
+
+  ASSERT_OK_AND_ASSIGN(budget, ReasoningBudget::Create(
+                                   {kStart}, {kEnd1, kEnd2},
+                                   /*max_num_reasoning_tokens=*/1));
+  budget->Update(kStart);
+  budget->Update(1);
+  budget->Update(kEnd1);
+  EXPECT_THAT(budget->GetForcedTokens(), ElementsAre(kEnd2));
+}
+
+TEST(ReasoningBudgetTest, FollowsTheReasoningEndedByTheModel) {
+  ASSERT_OK_AND_ASSIGN(auto budget, ReasoningBudget::Create(
+                                        {kStart}, {kEnd1},
+                                        /*max_num_reasoning_tokens=*/10));
+  for (int token_id : {kStart, 1, 2, kEnd1, 3, 4}) {
+    budget->Update(token_id);
+    EXPECT_THAT(budget->GetForcedTokens(), IsEmpty());
+  }
+  EXPECT_EQ(budget->GetNumReasoningTokens(), 2);
+  EXPECT_THAT(budget->GetReasoningRange(), Optional(Pair(0, 4)));
+}
+
+TEST(ReasoningBudgetTest, IgnoresDecodesWithoutReasoning) {
+  ASSERT_OK_AND_ASSIGN(auto budget, ReasoningBudget::Create(
+                                        {kStart}, {kEnd1},
+                                        /*max_num_reasoning_tokens=*/0));
+  for (int token_id : {1, kStart, 2, 3}) {
+    budget->Update(token_id);
+    EXPECT_THAT(budget->GetForcedTokens(), IsEmpty());
+  }
+  EXPECT_EQ(budget->GetReasoningRange(), std::nullopt);
+}
+
+TEST(ReasoningBudgetTest, FailsWithoutMarkers) {
+  EXPECT_THAT(ReasoningBudget::Create({}, {kEnd1}, 10),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ReasoningBudget::Create({kStart}, {kEnd1}, -1),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,79 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/resident_context_pool.h"
+
+#include <cstdint>
+#include <memory>
+
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+
+ResidentContextPool::Context::~Context() { pool_.Release(id_); }
+
+absl::StatusOr<std::unique_ptr<ResidentContextPool>>
+ResidentContextPool::Create(MultiContextLlmExecutor* executor) {
+  if (executor == nullptr) {
+    return absl::InvalidArgumentError("The executor must not be null.");
+  }
+  if (executor->GetMaxNumContexts() < 2) {
+    return absl::InvalidArgumentError(
+        "The executor keeps no context besides the default one.");
+  }
+  return absl::WrapUnique(
+      new ResidentContextPool(*executor, executor->GetMaxNumContexts() - 1));
+}
+
+absl::StatusOr<std::unique_ptr<ResidentContextPool::Context>>
+ResidentContextPool::Acquire() {
+  absl::MutexLock lock(&mutex_);
+  ASSIGN_OR_RETURN(int id, executor_.AllocateContext());
+  return absl::WrapUnique(new Context(*this, id));
+}
+
+int64_t ResidentContextPool::GetNumSwitches() const {
+  absl::MutexLock lock(&mutex_);
+  return num_switches_;
+}
+
+absl::Status ResidentContextPool::Select(int id) {
+  absl::MutexLock lock(&mutex_);
+  if (selected_ == id) {
+    return absl::OkStatus();
+  }
+  RETURN_IF_ERROR(executor_.SelectContext(id));
+  selected_ = id;
+  ++num_switches_;
+  return absl::OkStatus();
+}
+
+void ResidentContextPool::Release(int id) {
+  absl::MutexLock lock(&mutex_);
+  if (auto status = executor_.ReleaseContext(id); !status.ok()) {
+    ABSL_LOG(ERROR) << "Failed to release the context " << id << ": "
+                    << status;
+  }
+  if (selected_ == id) {
+    selected_ = MultiContextLlmExecutor::kDefaultContext;
+  }
+}
+
+}  // namespace litert::lm
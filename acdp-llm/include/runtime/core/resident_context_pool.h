@@ -0,0 +1,108 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_RESIDENT_CONTEXT_POOL_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_RESIDENT_CONTEXT_POOL_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+
+namespace litert::lm {
+
+// ResidentContextPool hands out the contexts of a MultiContextLlmExecutor to
+// the sessions of an engine, so that interleaving the turns of several
+// sessions switches the context the executor targets instead of resetting it
+// and prefilling the context of the next session again.
+//
+// The sessions still run one at a time: every executor call of a session
+// follows a Context::Select(), which only reaches the executor when another
+// context was selected. The sessions beyond the number of contexts share the
+// default context, selected with SelectDefault(), as without the pool.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(auto context, pool->Acquire());
+//   RETURN_IF_ERROR(context->Select());
+//   RETURN_IF_ERROR(executor.Prefill(inputs, params));
+//
+// The class is thread-safe.
+class ResidentContextPool {
+ public:
+  // A context of the executor owned by a single session. Releases the context
+  // on destruction.
+  class Context {
+   public:
+    ~Context();
+
+    Context(const Context&) = delete;
+    Context& operator=(const Context&) = delete;
+
+    // Returns the id of the context in the executor.
+    int id() const { return id_; }
+
+    // Makes the executor target this context.
+    absl::Status Select() { return pool_.Select(id_); }
+
+   private:
+    friend class ResidentContextPool;
+    Context(ResidentContextPool& pool, int id) : pool_(pool), id_(id) {}
+
+    ResidentContextPool& pool_;
+    const int id_;
+  };
+
+  // Creates a pool of the contexts of `executor`, which must outlive the
+  // pool and every context acquired from it.
+  static absl::StatusOr<std::unique_ptr<ResidentContextPool>> Create(
+      MultiContextLlmExecutor* executor);
+
+  // Acquires an empty context. Returns a ResourceExhausted error if all the
+  // contexts are in use.
+  absl::StatusOr<std::unique_ptr<Context>> Acquire();
+
+  // Makes the executor target the default context.
+  absl::Status SelectDefault() {
+    return Select(MultiContextLlmExecutor::kDefaultContext);
+  }
+
+  // Returns the number of contexts the pool hands out, the default context
+  // excluded.
+  int GetMaxNumContexts() const { return max_num_contexts_; }
+
+  // Returns the number of times the executor switched its context.
+  int64_t GetNumSwitches() const;
+
+ private:
+  ResidentContextPool(MultiContextLlmExecutor& executor, int max_num_contexts)
+      : executor_(executor), max_num_contexts_(max_num_contexts) {}
+
+  absl::Status Select(int id);
+  void Release(int id);
+
+  MultiContextLlmExecutor& executor_;
+  const int max_num_contexts_;
+  mutable absl::Mutex mutex_;
+  int selected_ ABSL_GUARDED_BY(mutex_) =
+      MultiContextLlmExecutor::kDefaultContext;
+  int64_t num_switches_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_RESIDENT_CONTEXT_POOL_H_
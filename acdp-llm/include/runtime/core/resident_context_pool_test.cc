@@ -0,0 +1,126 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/resident_context_pool.h"
+
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::status::StatusIs;
+
+// Records the calls of the pool.
+class FakeMultiContextExecutor : public MultiContextLlmExecutor {
+ public:
+  explicit FakeMultiContextExecutor(int max_num_contexts)
+      : in_use_(max_num_contexts, false) {
+    in_use_[kDefaultContext] = true;
+  }
+
+  int GetMaxNumContexts() const override { return in_use_.size(); }
+
+  absl::StatusOr<int> AllocateContext() override {
+    for (int i = 0; i < in_use_.size(); ++i) {
+      if (!in_use_[i]) {
+        in_use_[i] = true;
+        return i;
+      }
+    }
+    return absl::ResourceExhaustedError("All the contexts are in use.");
+  }
+
+  absl::Status ReleaseContext(int context) override {
+    in_use_[context] = false;
+    released.push_back(context);
+    if (selected == context) {
+      selected = kDefaultContext;
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status SelectContext(int context) override {
+    selected = context;
+    selections.push_back(context);
+    return absl::OkStatus();
+  }
+
+  int selected = kDefaultContext;
+  std::vector<int> selections;
+  std::vector<int> released;
+
+ private:
+  std::vector<bool> in_use_;
+};
+
+TEST(ResidentContextPoolTest, RequiresSeveralContexts) {
+  FakeMultiContextExecutor executor(/*max_num_contexts=*/1);
+  EXPECT_THAT(ResidentContextPool::Create(&executor),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ResidentContextPool::Create(nullptr),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ResidentContextPoolTest, HandsOutTheContextsButTheDefaultOne) {
+  FakeMultiContextExecutor executor(/*max_num_contexts=*/3);
+  ASSERT_OK_AND_ASSIGN(auto pool, ResidentContextPool::Create(&executor));
+  EXPECT_EQ(pool->GetMaxNumContexts(), 2);
+  ASSERT_OK_AND_ASSIGN(auto first, pool->Acquire());
+  ASSERT_OK_AND_ASSIGN(auto second, pool->Acquire());
+  EXPECT_EQ(first->id(), 1);
+  EXPECT_EQ(second->id(), 2);
+  EXPECT_THAT(pool->Acquire(),
+              StatusIs(absl::StatusCode::kResourceExhausted));
+
+  first.reset();
+  EXPECT_THAT(executor.released, ElementsAre(1));
+  ASSERT_OK_AND_ASSIGN(auto third, pool->Acquire());
+  EXPECT_EQ(third->id(), 1);
+}
+
+TEST(ResidentContextPoolTest, SwitchesOnlyBetweenDifferentContexts) {
+  FakeMultiContextExecutor executor(/*max_num_contexts=*/3);
+  ASSERT_OK_AND_ASSIGN(auto pool, ResidentContextPool::Create(&executor));
+  ASSERT_OK_AND_ASSIGN(auto first, pool->Acquire());
+  ASSERT_OK_AND_ASSIGN(auto second, pool->Acquire());
+
+  EXPECT_OK(first->Select());
+  EXPECT_OK(first->Select());
+  EXPECT_OK(second->Select());
+  EXPECT_OK(first->Select());
+  // The executor starts on the default context.
+  EXPECT_OK(pool->SelectDefault());
+  EXPECT_OK(pool->SelectDefault());
+  EXPECT_THAT(executor.selections, ElementsAre(1, 2, 1, 0));
+  EXPECT_EQ(pool->GetNumSwitches(), 4);
+
+  // Releasing the selected context selects the default one.
+  EXPECT_OK(second->Select());
+  second.reset();
+  EXPECT_EQ(executor.selected, MultiContextLlmExecutor::kDefaultContext);
+  EXPECT_OK(pool->SelectDefault());
+  EXPECT_THAT(executor.selections, ElementsAre(1, 2, 1, 0, 2));
+}
+
+}  // namespace
+}  // namespace litert::lm
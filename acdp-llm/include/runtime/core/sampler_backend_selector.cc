@@ -0,0 +1,72 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/sampler_backend_selector.h"
+
+#include <optional>
+
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+SamplerBackendSelector::Path SamplerBackendSelector::Select(
+    int num_output_candidates) const {
+  absl::MutexLock lock(&mutex_);
+  auto it = costs_.find(num_output_candidates);
+  if (it == costs_.end()) {
+    return Path::kExecutor;
+  }
+  const Cost& executor = it->second[static_cast<int>(Path::kExecutor)];
+  const Cost& host = it->second[static_cast<int>(Path::kHost)];
+  if (executor.num_steps < kMinMeasuredSteps ||
+      host.num_steps < kMinMeasuredSteps) {
+    // Measures the path with the fewest steps so far.
+    return host.num_steps < executor.num_steps ? Path::kHost
+                                               : Path::kExecutor;
+  }
+  // Compares executor.duration / executor.num_steps with the host one without
+  // dividing.
+  return host.duration * executor.num_steps <
+                 executor.duration * host.num_steps
+             ? Path::kHost
+             : Path::kExecutor;
+}
+
+void SamplerBackendSelector::Record(int num_output_candidates, Path path,
+                                    int num_steps, absl::Duration duration) {
+  if (num_steps <= 0) {
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  Cost& cost = costs_[num_output_candidates][static_cast<int>(path)];
+  cost.num_steps += num_steps;
+  cost.duration += duration;
+}
+
+std::optional<absl::Duration> SamplerBackendSelector::GetTimePerStep(
+    int num_output_candidates, Path path) const {
+  absl::MutexLock lock(&mutex_);
+  auto it = costs_.find(num_output_candidates);
+  if (it == costs_.end()) {
+    return std::nullopt;
+  }
+  const Cost& cost = it->second[static_cast<int>(path)];
+  if (cost.num_steps == 0) {
+    return std::nullopt;
+  }
+  return cost.duration / cost.num_steps;
+}
+
+}  // namespace litert::lm
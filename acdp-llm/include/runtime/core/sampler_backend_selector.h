@@ -0,0 +1,87 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SAMPLER_BACKEND_SELECTOR_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SAMPLER_BACKEND_SELECTOR_H_
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// Picks, for the sessions selecting their sampler backend automatically, the
+// faster of the two ways of sampling the decode steps: inside the executor,
+// with the sampler of its backend, or on the host, with a CPU sampler reading
+// back the logits. Which one is faster depends on the vocabulary size, the
+// number of output candidates and the backend, so the selector measures both
+// on the decodes of the sessions: it alternates them until each ran
+// `kMinMeasuredSteps` decode steps, then picks the one taking the least time
+// per step. The measurements keep accumulating, so that the choice follows
+// the cost when it changes, e.g. under load.
+//
+// The costs are kept per number of output candidates, the sessions of an
+// engine sharing everything else.
+//
+// The class is thread-safe.
+class SamplerBackendSelector {
+ public:
+  enum class Path {
+    // The executor samples the logits with the sampler of its backend.
+    kExecutor,
+    // The session samples the logits with a CPU sampler.
+    kHost,
+  };
+
+  SamplerBackendSelector() = default;
+
+  SamplerBackendSelector(const SamplerBackendSelector&) = delete;
+  SamplerBackendSelector& operator=(const SamplerBackendSelector&) = delete;
+
+  // Returns the path the next decode of `num_output_candidates` candidates
+  // should sample with.
+  Path Select(int num_output_candidates) const;
+
+  // Records that a decode of `num_output_candidates` candidates sampled with
+  // `path` ran `num_steps` decode steps in `duration`. The decodes without a
+  // step are ignored.
+  void Record(int num_output_candidates, Path path, int num_steps,
+              absl::Duration duration);
+
+  // Returns the time per decode step measured for `path`, or std::nullopt if
+  // no decode of `num_output_candidates` candidates sampled with it yet.
+  std::optional<absl::Duration> GetTimePerStep(int num_output_candidates,
+                                               Path path) const;
+
+  static constexpr int kMinMeasuredSteps = 64;
+
+ private:
+  struct Cost {
+    int64_t num_steps = 0;
+    absl::Duration duration;
+  };
+
+  mutable absl::Mutex mutex_;
+  // The costs of the paths, indexed by Path, per number of output candidates.
+  absl::flat_hash_map<int, std::array<Cost, 2>> costs_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SAMPLER_BACKEND_SELECTOR_H_
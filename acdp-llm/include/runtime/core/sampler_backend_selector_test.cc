@@ -0,0 +1,70 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/sampler_backend_selector.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/time/time.h"  // from @com_google_absl
+
+namespace litert::lm {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Optional;
+using Path = SamplerBackendSelector::Path;
+
+constexpr int kSteps = SamplerBackendSelector::kMinMeasuredSteps;
+
+TEST(SamplerBackendSelectorTest, AlternatesUntilBothPathsAreMeasured) {
+  SamplerBackendSelector selector;
+  EXPECT_THAT(selector.Select(/*num_output_candidates=*/1),
+              Eq(Path::kExecutor));
+
+  selector.Record(/*num_output_candidates=*/1, Path::kExecutor, kSteps,
+                  absl::Milliseconds(kSteps));
+  EXPECT_THAT(selector.Select(1), Eq(Path::kHost));
+
+  selector.Record(1, Path::kHost, kSteps / 2, absl::Milliseconds(kSteps));
+  EXPECT_THAT(selector.Select(1), Eq(Path::kHost));
+}
+
+TEST(SamplerBackendSelectorTest, SelectsTheFasterPath) {
+  SamplerBackendSelector selector;
+  selector.Record(1, Path::kExecutor, kSteps, absl::Milliseconds(2 * kSteps));
+  selector.Record(1, Path::kHost, kSteps, absl::Milliseconds(kSteps));
+  EXPECT_THAT(selector.Select(1), Eq(Path::kHost));
+  EXPECT_THAT(selector.GetTimePerStep(1, Path::kExecutor),
+              Optional(absl::Milliseconds(2)));
+
+  // The host sampling gets slower, e.g. with more threads busy.
+  selector.Record(1, Path::kHost, kSteps, absl::Milliseconds(4 * kSteps));
+  EXPECT_THAT(selector.Select(1), Eq(Path::kExecutor));
+}
+
+TEST(SamplerBackendSelectorTest, KeepsTheCostsPerNumberOfCandidates) {
+  SamplerBackendSelector selector;
+  selector.Record(1, Path::kExecutor, kSteps, absl::Milliseconds(kSteps));
+  selector.Record(1, Path::kHost, kSteps, absl::Milliseconds(2 * kSteps));
+  selector.Record(/*num_output_candidates=*/0, Path::kHost, /*num_steps=*/0,
+                  absl::Seconds(1));
+
+  EXPECT_THAT(selector.Select(1), Eq(Path::kExecutor));
+  EXPECT_THAT(selector.Select(/*num_output_candidates=*/4),
+              Eq(Path::kExecutor));
+  EXPECT_THAT(selector.GetTimePerStep(4, Path::kHost), Eq(std::nullopt));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,103 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/sequence_scorer.h"
+
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/core/logits_kernels.h"
+#include "runtime/core/logits_staging_buffer.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+
+absl::StatusOr<std::vector<float>> ScoreTokenSequences(
+    PrefillLogitsLlmExecutor& executor, int pending_token_id,
+    const std::vector<std::vector<int>>& target_token_ids, float temperature,
+    LogitsStagingBuffer* logits_staging_buffer) {
+  ASSIGN_OR_RETURN(
+      std::vector<std::vector<float>> scores,
+      ScoreTokenSequences(executor, pending_token_id, target_token_ids,
+                          absl::MakeConstSpan(&temperature, 1),
+                          logits_staging_buffer));
+  return std::move(scores[0]);
+}
+
+absl::StatusOr<std::vector<std::vector<float>>> ScoreTokenSequences(
+    PrefillLogitsLlmExecutor& executor, int pending_token_id,
+    const std::vector<std::vector<int>>& target_token_ids,
+    absl::Span<const float> temperatures,
+    LogitsStagingBuffer* logits_staging_buffer) {
+  if (temperatures.empty()) {
+    return absl::InvalidArgumentError("No temperature to score with.");
+  }
+  // The logits after the pending token and the target tokens but the last one
+  // predict the target tokens. The empty targets are not run and score 0.
+  std::vector<std::vector<int>> input_token_ids;
+  std::vector<int> input_indices;
+  for (int i = 0; i < target_token_ids.size(); ++i) {
+    const std::vector<int>& target = target_token_ids[i];
+    if (target.empty()) {
+      continue;
+    }
+    std::vector<int>& input = input_token_ids.emplace_back();
+    input.reserve(target.size());
+    input.push_back(pending_token_id);
+    input.insert(input.end(), target.begin(), target.end() - 1);
+    input_indices.push_back(i);
+  }
+  std::vector<std::vector<float>> scores(
+      temperatures.size(), std::vector<float>(target_token_ids.size(), 0.0f));
+  if (input_token_ids.empty()) {
+    return scores;
+  }
+
+  ASSIGN_OR_RETURN(std::vector<litert::TensorBuffer> logits,
+                   executor.PrefillLogits(input_token_ids));
+  if (logits.size() != input_token_ids.size()) {
+    return absl::InternalError(
+        absl::StrCat("Expected the logits of ", input_token_ids.size(),
+                     " sequences, got ", logits.size(), "."));
+  }
+  LogitsStagingBuffer owned_logits_staging_buffer;
+  LogitsStagingBuffer& staging_buffer = logits_staging_buffer != nullptr
+                                            ? *logits_staging_buffer
+                                            : owned_logits_staging_buffer;
+  for (int i = 0; i < logits.size(); ++i) {
+    // Download the data if it is not in host memory.
+    ASSIGN_OR_RETURN(absl::Span<const float> logits_data,
+                     staging_buffer.Stage(logits[i]));
+    const std::vector<int>& target = target_token_ids[input_indices[i]];
+    // Every position is scored as one entry of a batch.
+    for (int t = 0; t < temperatures.size(); ++t) {
+      ASSIGN_OR_RETURN(std::vector<float> log_likelihoods,
+                       LogitsKernels::Get().ComputeLogLikelihoods(
+                           logits_data, target, temperatures[t]));
+      float& score = scores[t][input_indices[i]];
+      for (const float log_likelihood : log_likelihoods) {
+        score += log_likelihood;
+      }
+    }
+  }
+  return scores;
+}
+
+}  // namespace litert::lm
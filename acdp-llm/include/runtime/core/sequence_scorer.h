@@ -0,0 +1,54 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SEQUENCE_SCORER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SEQUENCE_SCORER_H_
+
+#include <vector>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/core/logits_staging_buffer.h"
+
+namespace litert::lm {
+
+// Scores the target token sequences as continuations of the current context
+// of the executor, all of them in a single model invocation, and returns for
+// each target the sum of the log-likelihoods of its tokens. The context is
+// left unchanged, so the targets share the prefix of the context.
+// - executor: The executor computing the logits of every position.
+// - pending_token_id: The last prefilled token, which the executor has not
+//   attended to yet.
+// - target_token_ids: The token ids of each target.
+// - temperature: The temperature to use for softmax calculations.
+// - logits_staging_buffer: Optional host memory reused to download the
+//   logits.
+absl::StatusOr<std::vector<float>> ScoreTokenSequences(
+    PrefillLogitsLlmExecutor& executor, int pending_token_id,
+    const std::vector<std::vector<int>>& target_token_ids, float temperature,
+    LogitsStagingBuffer* logits_staging_buffer = nullptr);
+
+// Same as above, but scores the targets under each of `temperatures` from
+// the logits of the same invocation. Returns the scores of the targets for
+// each temperature, in their order.
+absl::StatusOr<std::vector<std::vector<float>>> ScoreTokenSequences(
+    PrefillLogitsLlmExecutor& executor, int pending_token_id,
+    const std::vector<std::vector<int>>& target_token_ids,
+    absl::Span<const float> temperatures,
+    LogitsStagingBuffer* logits_staging_buffer = nullptr);
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SEQUENCE_SCORER_H_
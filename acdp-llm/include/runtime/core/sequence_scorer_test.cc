@@ -0,0 +1,158 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/sequence_scorer.h"
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/util/convert_tensor_buffer.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::FloatNear;
+using ::testing::status::StatusIs;
+
+constexpr int kVocabSize = 4;
+
+// Predicts token (id + 1) % kVocabSize after each token id, with the logit
+// `logit` and 0 for the other tokens. Records the invocations.
+class FakePrefillLogitsExecutor : public PrefillLogitsLlmExecutor {
+ public:
+  explicit FakePrefillLogitsExecutor(float logit) : logit_(logit) {}
+
+  absl::StatusOr<std::vector<litert::TensorBuffer>> PrefillLogits(
+      absl::Span<const std::vector<int>> token_ids) override {
+    invocations.emplace_back(token_ids.begin(), token_ids.end());
+    std::vector<litert::TensorBuffer> logits;
+    for (const std::vector<int>& sequence : token_ids) {
+      std::vector<float> data(sequence.size() * kVocabSize, 0.0f);
+      for (int i = 0; i < sequence.size(); ++i) {
+        data[i * kVocabSize + (sequence[i] + 1) % kVocabSize] = logit_;
+      }
+      auto buffer = CopyToTensorBuffer<float>(
+          data, {static_cast<int>(sequence.size()), kVocabSize});
+      if (!buffer) {
+        return absl::InternalError("Failed to create the logits.");
+      }
+      logits.push_back(std::move(*buffer));
+    }
+    if (drop_last_logits) {
+      logits.pop_back();
+    }
+    return logits;
+  }
+
+  std::vector<std::vector<std::vector<int>>> invocations;
+  bool drop_last_logits = false;
+
+ private:
+  const float logit_;
+};
+
+TEST(SequenceScorerTest, ScoresAllTargetsInOneInvocation) {
+  FakePrefillLogitsExecutor executor(/*logit=*/0.0f);
+  ASSERT_OK_AND_ASSIGN(
+      std::vector<float> scores,
+      ScoreTokenSequences(executor, /*pending_token_id=*/0,
+                          /*target_token_ids=*/{{1, 2, 3}, {2}},
+                          /*temperature=*/1.0f));
+  // The logits are uniform.
+  const float log_likelihood = std::log(1.0f / kVocabSize);
+  EXPECT_THAT(scores, ElementsAre(FloatNear(3 * log_likelihood, 1e-5),
+                                  FloatNear(log_likelihood, 1e-5)));
+  // The targets follow the pending token, without their last token.
+  EXPECT_THAT(executor.invocations,
+              ElementsAre(ElementsAre(ElementsAre(0, 1, 2), ElementsAre(0))));
+}
+
+TEST(SequenceScorerTest, ScoresTheTokensAtEveryPosition) {
+  FakePrefillLogitsExecutor executor(/*logit=*/100.0f);
+  ASSERT_OK_AND_ASSIGN(
+      std::vector<float> scores,
+      ScoreTokenSequences(executor, /*pending_token_id=*/0,
+                          /*target_token_ids=*/{{1, 2, 3}, {1, 3}},
+                          /*temperature=*/1.0f));
+  // The first target is the predicted one, the second one misses its last
+  // token.
+  EXPECT_THAT(scores, ElementsAre(FloatNear(0.0f, 1e-5),
+                                  FloatNear(-100.0f, 1e-3)));
+}
+
+TEST(SequenceScorerTest, EmptyTargetsScoreZero) {
+  FakePrefillLogitsExecutor executor(/*logit=*/0.0f);
+  ASSERT_OK_AND_ASSIGN(
+      std::vector<float> scores,
+      ScoreTokenSequences(executor, /*pending_token_id=*/0,
+                          /*target_token_ids=*/{{}, {1}},
+                          /*temperature=*/1.0f));
+  EXPECT_THAT(scores, ElementsAre(0.0f, FloatNear(std::log(0.25f), 1e-5)));
+  EXPECT_THAT(executor.invocations,
+              ElementsAre(ElementsAre(ElementsAre(0))));
+
+  ASSERT_OK_AND_ASSIGN(scores, ScoreTokenSequences(
+                                   executor, /*pending_token_id=*/0,
+                                   /*target_token_ids=*/{{}},
+                                   /*temperature=*/1.0f));
+  EXPECT_THAT(scores, ElementsAre(0.0f));
+  // Nothing to run.
+  EXPECT_EQ(executor.invocations.size(), 1);
+}
+
+TEST(SequenceScorerTest, ScoresEveryTemperatureFromOneInvocation) {
+  FakePrefillLogitsExecutor executor(/*logit=*/1.0f);
+  const std::vector<float> temperatures = {1.0f, 2.0f};
+  ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<float>> scores,
+      ScoreTokenSequences(executor, /*pending_token_id=*/0,
+                          /*target_token_ids=*/{{1}, {2}}, temperatures));
+  // The first target is the predicted one.
+  auto log_likelihood = [](float logit, float temperature) {
+    return logit / temperature - std::log(std::exp(1.0f / temperature) + 3);
+  };
+  EXPECT_THAT(scores,
+              ElementsAre(ElementsAre(FloatNear(log_likelihood(1, 1), 1e-5),
+                                      FloatNear(log_likelihood(0, 1), 1e-5)),
+                          ElementsAre(FloatNear(log_likelihood(1, 2), 1e-5),
+                                      FloatNear(log_likelihood(0, 2), 1e-5))));
+  EXPECT_EQ(executor.invocations.size(), 1);
+
+  EXPECT_THAT(ScoreTokenSequences(executor, /*pending_token_id=*/0,
+                                  /*target_token_ids=*/{{1}},
+                                  absl::Span<const float>()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(SequenceScorerTest, FailsWithMissingLogits) {
+  FakePrefillLogitsExecutor executor(/*logit=*/0.0f);
+  executor.drop_last_logits = true;
+  EXPECT_THAT(ScoreTokenSequences(executor, /*pending_token_id=*/0,
+                                  /*target_token_ids=*/{{1}, {2}},
+                                  /*temperature=*/1.0f),
+              StatusIs(absl::StatusCode::kInternal));
+}
+
+}  // namespace
+}  // namespace litert::lm
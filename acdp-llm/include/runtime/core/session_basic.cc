@@ -14,9 +14,12 @@
 
 #include "runtime/core/session_basic.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <future>  // NOLINT
 #include <memory>
 #include <optional>
 #include <string>
@@ -24,6 +27,7 @@
 #include <variant>
 #include <vector>
 
+#include "absl/cleanup/cleanup.h"  // from @com_google_absl
 #include "absl/functional/any_invocable.h"  // from @com_google_absl
 #include "absl/log/absl_log.h"  // from @com_google_absl
 #include "absl/memory/memory.h"  // from @com_google_absl
@@ -32,14 +36,41 @@
 #include "absl/strings/match.h"  // from @com_google_absl
 #include "absl/strings/str_cat.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/synchronization/notification.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
 #include "litert/cc/litert_layout.h"  // from @litert
 #include "litert/cc/litert_macros.h"  // from @litert
 #include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/components/preprocessor/audio_preprocessor.h"
+#include "runtime/components/preprocessor/audio_preprocessor_miniaudio.h"
 #include "runtime/components/sampler.h"
 #include "runtime/components/sampler_factory.h"
 #include "runtime/components/stop_token_detector.h"
 #include "runtime/components/tokenizer.h"
+#include "runtime/core/callback_dispatcher.h"
+#include "runtime/core/context_compactor.h"
+#include "runtime/core/continuous_batching_scheduler.h"
+#include "runtime/core/embedding_cache.h"
+#include "runtime/core/encoder_scheduler.h"
+#include "runtime/core/kv_cache_block_allocator.h"
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/core/logits_processor.h"
+#include "runtime/core/lora_registry.h"
 #include "runtime/core/pipeline.h"
+#include "runtime/core/prefix_kv_cache.h"
+#include "runtime/core/prompt_lookup_proposer.h"
+#include "runtime/core/prompt_token_budget.h"
+#include "runtime/core/reasoning_budget.h"
+#include "runtime/core/session_state_file.h"
+#include "runtime/core/shared_session_resources.h"
+#include "runtime/core/speculative_decoder.h"
+#include "runtime/core/stop_sequence_matcher.h"
+#include "runtime/core/streaming_coalescer.h"
+#include "runtime/core/text_embedder.h"
+#include "runtime/core/token_id_cache.h"
 #include "runtime/engine/engine.h"
 #include "runtime/engine/engine_settings.h"
 #include "runtime/engine/io_types.h"
@@ -53,9 +84,223 @@
 #include "runtime/util/convert_tensor_buffer.h"
 #include "runtime/util/executor_data_util.h"
 #include "runtime/util/status_macros.h"  // IWYU pragma: keep
+#include "runtime/util/tensor_buffer_pool.h"
 #include "runtime/util/tensor_buffer_util.h"
+#include "runtime/util/trace_recorder.h"
 
 namespace litert::lm {
+namespace {
+
+// Returns whether the sampler always picks the most likely token, which is the
+// only sampling that speculative decoding reproduces exactly.
+bool IsGreedySampling(const proto::SamplerParameters& sampler_params) {
+  switch (sampler_params.type()) {
+    case proto::SamplerParameters::GREEDY:
+      return true;
+    case proto::SamplerParameters::TOP_K:
+    case proto::SamplerParameters::TOP_P:
+      return sampler_params.k() == 1;
+    default:
+      return false;
+  }
+}
+
+// Creates the speculative decoder of a session, or returns nullptr if the
+// session can not use speculative decoding.
+absl::StatusOr<std::unique_ptr<SpeculativeDecoder>>
+MaybeCreateSpeculativeDecoder(LlmExecutor& executor,
+                              const SessionConfig& session_config) {
+  // Evicting tokens from the middle of the context would desynchronize the
+  // token sequence tracked by the decoder.
+  if (session_config.GetNumOutputCandidates() != 1 ||
+      !IsGreedySampling(session_config.GetSamplerParams()) ||
+      session_config.GetContextOverflowPolicy() !=
+          ContextOverflowPolicy::kStop) {
+    return nullptr;
+  }
+  auto* main_executor = GetExecutorExtension<SpeculativeLlmExecutor>(executor);
+  if (main_executor == nullptr) {
+    return nullptr;
+  }
+  return SpeculativeDecoder::Create(main_executor);
+}
+
+// Creates the proposer running the draft model of the engine, or returns
+// nullptr if the session does not use it.
+std::unique_ptr<DraftModelProposer> MaybeCreateDraftModelProposer(
+    LlmExecutor* draft_executor, const SessionConfig& session_config) {
+  if (draft_executor == nullptr || session_config.GetNumDraftTokens() == 0) {
+    return nullptr;
+  }
+  auto* speculative_draft_executor =
+      GetExecutorExtension<SpeculativeLlmExecutor>(*draft_executor);
+  if (speculative_draft_executor == nullptr) {
+    ABSL_LOG(WARNING) << "The draft executor does not support speculative "
+                         "decoding, ignored for the session.";
+    return nullptr;
+  }
+  return std::make_unique<DraftModelProposer>(speculative_draft_executor);
+}
+
+// The checkpoint of a SessionBasic.
+struct SessionBasicCheckpoint : public SessionCheckpoint {
+  // The executor the checkpoint was taken from, and its snapshot extension.
+  // nullptr if the kv-cache is only held in `kv_cache_data`.
+  const LlmExecutor* executor = nullptr;
+  KvCacheSnapshotLlmExecutor* snapshot_executor = nullptr;
+  // The file the checkpoint was loaded from, if any. The kv-cache may use it
+  // in place, so it is destroyed last.
+  std::unique_ptr<SessionStateFile> file;
+  std::shared_ptr<const KvCacheSnapshot> kv_cache;
+  // The serialized kv-cache when the checkpoint migrates a session through
+  // host memory, see SessionBasic::MigrateTo().
+  std::string kv_cache_data;
+  int last_prefill_token_id = 0;
+  bool is_first_turn = true;
+  bool has_prefilled = false;
+};
+
+// Creates the sliding window of the context of a session, or returns nullptr
+// if the session stops at the end of the context.
+absl::StatusOr<std::unique_ptr<ContextCompactor>> MaybeCreateContextCompactor(
+    LlmExecutor& executor, const SessionConfig& session_config) {
+  if (session_config.GetContextOverflowPolicy() !=
+      ContextOverflowPolicy::kSlidingWindow) {
+    return nullptr;
+  }
+  auto* eviction_executor =
+      GetExecutorExtension<ContextEvictionLlmExecutor>(executor);
+  if (eviction_executor == nullptr) {
+    return absl::UnimplementedError(
+        "The sliding window context overflow policy requires an executor "
+        "supporting context eviction.");
+  }
+  // The window of the session slides within its own maximum number of
+  // tokens, if any, rather than the one of the engine.
+  int max_num_tokens = session_config.GetMaxNumTokens();
+  if (max_num_tokens == 0) {
+    ASSIGN_OR_RETURN(auto executor_settings, executor.GetExecutorSettings());
+    max_num_tokens = executor_settings.GetMaxNumTokens();
+  }
+  return ContextCompactor::Create(
+      eviction_executor, max_num_tokens,
+      session_config.GetNumContextSinkTokens(),
+      session_config.GetNumContextEvictionTokens());
+}
+
+// Creates the block table backing the context slot of a new session with the
+// paged kv-cache of the executor, or returns nullptr if the kv-cache is not
+// paged. The table grows with the context up to the maximum number of tokens
+// of the session.
+absl::StatusOr<std::unique_ptr<KvCacheBlockTable>> MaybeBindKvCacheBlockTable(
+    LlmExecutor& executor, ContinuousBatchingScheduler::Slot* batching_slot,
+    KvCacheBlockAllocator* allocator, const SessionConfig& session_config) {
+  auto* paged_executor =
+      GetExecutorExtension<PagedKvCacheLlmExecutor>(executor);
+  if (allocator == nullptr || batching_slot == nullptr ||
+      paged_executor == nullptr) {
+    return nullptr;
+  }
+  auto block_table = std::make_unique<KvCacheBlockTable>(
+      allocator, session_config.GetMaxNumTokens());
+  RETURN_IF_ERROR(batching_slot->RunExclusive([&]() {
+    return paged_executor->SetKvCacheBlockTable(block_table.get());
+  }));
+  return block_table;
+}
+
+// Returns the candidate pruning options of the request, or nullptr if the
+// pruning is disabled.
+const DecodeConfig::CandidatePruningOptions* MaybeGetCandidatePruningOptions(
+    const DecodeConfig& decode_config) {
+  const auto& options = decode_config.GetCandidatePruningOptions();
+  return options.has_value() ? &*options : nullptr;
+}
+
+// Creates the logits processor of a decode, or returns nullptr if the decode
+// samples the logits as they are.
+absl::StatusOr<std::unique_ptr<LogitsProcessor>> MaybeCreateLogitsProcessor(
+    const DecodeConfig& decode_config, const SessionConfig& session_config) {
+  const auto& options = decode_config.GetLogitsProcessingOptions();
+  if (!options.has_value()) {
+    return nullptr;
+  }
+  const proto::SamplerParameters& sampler_params =
+      session_config.GetSamplerParams();
+  return LogitsProcessor::Create(
+      *options, session_config.GetNumOutputCandidates(),
+      IsGreedySampling(sampler_params) ? 0.0f : sampler_params.temperature());
+}
+
+// Creates the reasoning budget of a decode, or returns nullptr if the
+// reasoning runs until the model ends it.
+absl::StatusOr<std::unique_ptr<ReasoningBudget>> MaybeCreateReasoningBudget(
+    const DecodeConfig& decode_config, const SessionConfig& session_config,
+    Tokenizer& tokenizer) {
+  const auto& options = decode_config.GetReasoningBudgetOptions();
+  if (!options.has_value()) {
+    return nullptr;
+  }
+  if (session_config.GetNumOutputCandidates() != 1) {
+    return absl::InvalidArgumentError(
+        "The reasoning budget only applies to a single output candidate.");
+  }
+  return ReasoningBudget::Create(*options, tokenizer);
+}
+
+// Leases the buffer of the ids the custom sampling decodes from, all set to
+// `last_token_id`.
+absl::StatusOr<TensorBufferPool::Lease> AcquireDecodedIdsBuffer(
+    TensorBufferPool& pool, int num_candidates, int last_token_id) {
+  std::vector<int> decoded_ids(num_candidates, last_token_id);
+  LITERT_ASSIGN_OR_RETURN(
+      auto decoded_ids_buffer,
+      pool.AcquireAndCopy<int>(decoded_ids, {num_candidates, 1}));
+  return decoded_ids_buffer;
+}
+
+// Returns `checkpoint` as a SessionBasicCheckpoint taken from `executor`.
+absl::StatusOr<const SessionBasicCheckpoint*> GetSessionBasicCheckpoint(
+    const SessionCheckpoint& checkpoint, const LlmExecutor& executor) {
+  const auto* session_checkpoint =
+      dynamic_cast<const SessionBasicCheckpoint*>(&checkpoint);
+  if (session_checkpoint == nullptr ||
+      session_checkpoint->executor != &executor) {
+    return absl::InvalidArgumentError(
+        "The checkpoint was not taken by a session of this engine.");
+  }
+  return session_checkpoint;
+}
+
+// Returns the kv-cache of `checkpoint` as a snapshot of `executor`, copied
+// from the executor of another engine if it was taken there.
+absl::StatusOr<std::shared_ptr<const KvCacheSnapshot>> GetCheckpointKvCache(
+    const SessionBasicCheckpoint& checkpoint, const LlmExecutor& executor,
+    KvCacheSnapshotLlmExecutor& snapshot_executor) {
+  if (checkpoint.executor == &executor) {
+    return checkpoint.kv_cache;
+  }
+  if (checkpoint.executor == nullptr) {
+    // `kv_cache_data` outlives the snapshot, which is only restored.
+    return snapshot_executor.DeserializeKvCache(checkpoint.kv_cache_data);
+  }
+  return snapshot_executor.ImportKvCache(*checkpoint.kv_cache,
+                                         *checkpoint.snapshot_executor);
+}
+
+// Copies the contents, for the callers that keep the ownership of them.
+absl::StatusOr<std::vector<InputData>> CopyContents(
+    const std::vector<InputData>& contents) {
+  std::vector<InputData> contents_copy;
+  contents_copy.reserve(contents.size());
+  for (const auto& content : contents) {
+    ASSIGN_OR_RETURN(auto content_copy, CreateInputDataCopy(content));
+    contents_copy.push_back(std::move(content_copy));
+  }
+  return contents_copy;
+}
+
+}  // namespace
 
 // static
 absl::StatusOr<std::unique_ptr<SessionBasic>> SessionBasic::Create(
@@ -63,20 +308,37 @@ absl::StatusOr<std::unique_ptr<SessionBasic>> SessionBasic::Create(
     VisionExecutor* vision_executor, AudioExecutor* audio_executor,
     const SessionConfig& session_config,
     std::optional<BenchmarkInfo> benchmark_info,
-    ThreadPool* worker_thread_pool) {
+    ThreadPool* worker_thread_pool,
+    const SharedSessionResources& shared_resources) {
   auto sampler_backend = session_config.GetSamplerBackend();
   std::unique_ptr<Sampler> sampler;
   // If use CPU sampling, we create it here; For GPU sampling, we let executor
   // create it internally.
-  if (sampler_backend == Backend::CPU) {
+  if (sampler_backend != Backend::CPU && sampler_backend != Backend::GPU &&
+      sampler_backend != Backend::NPU) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unsupported sampler backend: ", sampler_backend));
+  }
+  // When selecting the sampler backend automatically, the session also has a
+  // CPU sampler to compare with the one of the executor. The batched decode
+  // steps and the beam search only sample inside the executor.
+  const bool auto_select_sampler_backend =
+      sampler_backend != Backend::CPU &&
+      session_config.GetAutoSelectSamplerBackend() &&
+      shared_resources.sampler_backend_selector != nullptr &&
+      shared_resources.batching_scheduler == nullptr &&
+      !session_config.GetUseBeamSearch();
+  if (sampler_backend == Backend::CPU || auto_select_sampler_backend) {
     ASSIGN_OR_RETURN(
         sampler,
-        CreateSampler(sampler_backend, session_config.GetNumOutputCandidates(),
+        CreateSampler(Backend::CPU, session_config.GetNumOutputCandidates(),
                       session_config.GetSamplerParams()));
-  } else if (sampler_backend != Backend::GPU &&
-             sampler_backend != Backend::NPU) {
-    return absl::InvalidArgumentError(
-        absl::StrCat("Unsupported sampler backend: ", sampler_backend));
+  }
+
+  if (session_config.GetUseBeamSearch() &&
+      GetExecutorExtension<BeamSearchLlmExecutor>(*executor) == nullptr) {
+    return absl::UnimplementedError(
+        "Beam search requires an executor supporting candidate reordering.");
   }
 
   if (benchmark_info.has_value()) {
@@ -88,29 +350,764 @@ absl::StatusOr<std::unique_ptr<SessionBasic>> SessionBasic::Create(
     RETURN_IF_ERROR(
         stop_token_detector.AddStopTokenSequence(stop_token_sequence));
   }
-  return absl::WrapUnique(new SessionBasic(
+  ASSIGN_OR_RETURN(std::unique_ptr<StopSequences> stop_sequences,
+                   StopSequences::Create(session_config.GetStopTokenIds(),
+                                         session_config.GetStopStrings()));
+  std::shared_ptr<const LoraRegistry::Adapter> lora_adapter;
+  if (!session_config.GetLoraAdapterId().empty()) {
+    if (shared_resources.lora_registry == nullptr) {
+      return absl::FailedPreconditionError(
+          "The engine does not support LoRA adapters.");
+    }
+    ASSIGN_OR_RETURN(lora_adapter, shared_resources.lora_registry->Acquire(
+                                       session_config.GetLoraAdapterId()));
+  }
+  std::unique_ptr<ContinuousBatchingScheduler::Slot> batching_slot;
+  if (shared_resources.batching_scheduler != nullptr) {
+    ASSIGN_OR_RETURN(batching_slot,
+                     shared_resources.batching_scheduler->AcquireSlot());
+    if (lora_adapter != nullptr) {
+      // The batched decode steps carry the adapter of the slot, so that
+      // sessions with different adapters can share them.
+      batching_slot->SetLoraAdapter(lora_adapter->lora_id());
+    }
+  }
+  std::unique_ptr<ResidentContextPool::Context> resident_context;
+  if (batching_slot == nullptr &&
+      shared_resources.resident_context_pool != nullptr) {
+    auto context = shared_resources.resident_context_pool->Acquire();
+    if (context.ok()) {
+      resident_context = *std::move(context);
+    } else if (absl::IsResourceExhausted(context.status())) {
+      // The sessions beyond the resident contexts share the default one.
+      ABSL_LOG(INFO) << "No resident context left, the session shares the "
+                        "default context: "
+                     << context.status();
+    } else {
+      return context.status();
+    }
+  }
+  ASSIGN_OR_RETURN(std::unique_ptr<ContextCompactor> context_compactor,
+                   MaybeCreateContextCompactor(*executor, session_config));
+  ASSIGN_OR_RETURN(std::unique_ptr<SpeculativeDecoder> speculative_decoder,
+                   MaybeCreateSpeculativeDecoder(*executor, session_config));
+  std::unique_ptr<DraftModelProposer> draft_model_proposer;
+  if (speculative_decoder != nullptr) {
+    draft_model_proposer = MaybeCreateDraftModelProposer(
+        shared_resources.draft_executor, session_config);
+  }
+  // Bound last, so that the executor never refers to the table of a session
+  // which failed to be created.
+  ASSIGN_OR_RETURN(
+      std::unique_ptr<KvCacheBlockTable> kv_cache_block_table,
+      MaybeBindKvCacheBlockTable(*executor, batching_slot.get(),
+                                 shared_resources.kv_cache_block_allocator,
+                                 session_config));
+  auto session = absl::WrapUnique(new SessionBasic(
       executor, tokenizer, vision_executor, audio_executor, std::move(sampler),
-      session_config, benchmark_info, worker_thread_pool, stop_token_detector));
+      session_config, benchmark_info, worker_thread_pool, stop_token_detector,
+      std::move(kv_cache_block_table), std::move(batching_slot),
+      std::move(resident_context), std::move(draft_model_proposer),
+      std::move(speculative_decoder),
+      std::move(context_compactor), std::move(stop_sequences),
+      std::move(lora_adapter), shared_resources));
+  if (!session_config.GetDecodeReplayPath().empty()) {
+    ASSIGN_OR_RETURN(
+        session->replay_recorder_,
+        DecodeReplayRecorder::Create(session_config.GetDecodeReplayPath(),
+                                     session_config));
+  }
+  return session;
 }
 
 SessionBasic::~SessionBasic() {
+  {
+    // The scheduled encodings run on the session, even if their prefill was
+    // never run.
+    absl::MutexLock lock(&encodings_mutex_);
+    encodings_mutex_.Await(absl::Condition(
+        +[](int* num_pending_encodings) { return *num_pending_encodings == 0; },
+        &num_pending_encodings_));
+  }
+  if (shared_resources_.session_registry != nullptr) {
+    shared_resources_.session_registry->Remove(session_registry_id_);
+  }
+  if (shared_resources_.load_counters != nullptr) {
+    shared_resources_.load_counters->num_sessions.fetch_sub(1);
+  }
+  if (kv_cache_block_table_ != nullptr) {
+    auto status = batching_slot_->RunExclusive([this]() {
+      return GetExecutorExtension<PagedKvCacheLlmExecutor>(executor_)
+          ->SetKvCacheBlockTable(nullptr);
+    });
+    if (!status.ok()) {
+      ABSL_LOG(ERROR) << "Failed to unbind the kv-cache blocks: " << status;
+    }
+  }
+  if (batching_slot_ != nullptr) {
+    // Releasing the slot resets its context without touching the contexts of
+    // the other sessions.
+    batching_slot_.reset();
+    return;
+  }
+  if (resident_context_ != nullptr) {
+    // Releasing the context resets it without touching the contexts of the
+    // other sessions.
+    resident_context_.reset();
+    return;
+  }
+  if (shared_resources_.resident_context_pool != nullptr) {
+    if (auto status = shared_resources_.resident_context_pool->SelectDefault();
+        !status.ok()) {
+      ABSL_LOG(ERROR) << "Failed to select the default context: " << status;
+      return;
+    }
+  }
   auto status = executor_.Reset();
   if (!status.ok()) {
     ABSL_LOG(ERROR) << "Failed to reset executor: " << status;
   }
 }
 
+SessionBasic::TaskPriority SessionBasic::GetTaskPriority(
+    const DecodeConfig& decode_config) const {
+  return TaskPriority{
+      decode_config.GetPriority().value_or(session_config_.GetPriority()),
+      std::min(decode_config.GetDeadline(),
+               absl::Now() + session_config_.GetRequestTimeout()),
+      decode_config.GetTimeout().value_or(Engine::kDefaultTimeout)};
+}
+
+absl::Status SessionBasic::ScheduleTask(absl::AnyInvocable<void()> task) {
+  return ScheduleTask(std::move(task),
+                      TaskPriority{session_config_.GetPriority()});
+}
+
+absl::Status SessionBasic::ScheduleTask(absl::AnyInvocable<void()> task,
+                                        const TaskPriority& priority) {
+  if (shared_resources_.session_registry != nullptr &&
+      shared_resources_.session_registry->IsDraining()) {
+    return absl::UnavailableError("The engine is draining.");
+  }
+  // The task is linked to its scheduling in the trace, to show how long it
+  // waited for the worker thread.
+  if (TraceRecorder& recorder = TraceRecorder::GetDefault();
+      recorder.IsRecording()) {
+    const uint64_t flow_id = recorder.NewFlowId();
+    recorder.AddFlowStart("session", "SessionTask", flow_id);
+    task = [task = std::move(task), flow_id]() mutable {
+      ScopedTraceSlice trace("session", "SessionTask");
+      TraceRecorder::GetDefault().AddFlowEnd("session", "SessionTask",
+                                             flow_id);
+      task();
+    };
+  }
+  absl::MutexLock lock(&task_mutex_);
+  pending_tasks_.push_back(PendingTask{std::move(task), priority});
+  if (shared_resources_.load_counters != nullptr) {
+    shared_resources_.load_counters->num_queued_tasks.fetch_add(1);
+  }
+  if (task_running_) {
+    // The running task will pick it up once it is done.
+    return absl::OkStatus();
+  }
+  auto status = ScheduleNextTask();
+  if (!status.ok()) {
+    pending_tasks_.pop_back();
+    if (shared_resources_.load_counters != nullptr) {
+      shared_resources_.load_counters->num_queued_tasks.fetch_sub(1);
+    }
+    return status;
+  }
+  task_running_ = true;
+  return absl::OkStatus();
+}
+
+absl::Status SessionBasic::RunTaskAndWait(absl::AnyInvocable<void()> task) {
+  return RunTaskAndWait(
+      std::move(task), TaskPriority{session_config_.GetPriority()});
+}
+
+absl::Status SessionBasic::RunTaskAndWait(absl::AnyInvocable<void()> task,
+                                          const TaskPriority& priority) {
+  // Shared with the task, which outlives this call if the wait times out
+  // before it starts.
+  struct State {
+    absl::Mutex mutex;
+    bool started ABSL_GUARDED_BY(mutex) = false;
+    bool dropped ABSL_GUARDED_BY(mutex) = false;
+    absl::Notification done;
+  };
+  auto state = std::make_shared<State>();
+  RETURN_IF_ERROR(ScheduleTask(
+      [task = std::move(task), state]() mutable {
+        {
+          absl::MutexLock lock(&state->mutex);
+          if (state->dropped) {
+            state->done.Notify();
+            return;
+          }
+          state->started = true;
+        }
+        task();
+        state->done.Notify();
+      },
+      priority));
+  if (state->done.WaitForNotificationWithTimeout(priority.timeout)) {
+    return absl::OkStatus();
+  }
+  // The tasks queued after this one depend on its outcome.
+  cancelled_.store(true);
+  bool started;
+  {
+    absl::MutexLock lock(&state->mutex);
+    started = state->started;
+    state->dropped = !started;
+  }
+  if (started) {
+    // The running task stops at its next cancellation check.
+    state->done.WaitForNotification();
+  }
+  return absl::DeadlineExceededError(
+      "Timed out waiting for the task of the session.");
+}
+
+absl::Status SessionBasic::ScheduleNextTask() {
+  if (shared_resources_.task_scheduler == nullptr) {
+    return worker_thread_pool_.Schedule([this]() { RunPendingTasks(); });
+  }
+  const TaskPriority& next = pending_tasks_.front().priority;
+  return shared_resources_.task_scheduler->Schedule(
+      next.priority, next.deadline,
+      [this](bool deadline_exceeded) { RunNextTask(deadline_exceeded); });
+}
+
+void SessionBasic::RunPendingTasks() {
+  while (true) {
+    absl::AnyInvocable<void()> task;
+    {
+      absl::MutexLock lock(&task_mutex_);
+      if (pending_tasks_.empty()) {
+        task_running_ = false;
+        return;
+      }
+      task = std::move(pending_tasks_.front().task);
+      pending_tasks_.pop_front();
+    }
+    task();
+    if (shared_resources_.load_counters != nullptr) {
+      shared_resources_.load_counters->num_queued_tasks.fetch_sub(1);
+    }
+  }
+}
+
+void SessionBasic::RunNextTask(bool deadline_exceeded) {
+  absl::AnyInvocable<void()> task;
+  {
+    absl::MutexLock lock(&task_mutex_);
+    task = std::move(pending_tasks_.front().task);
+    pending_tasks_.pop_front();
+  }
+  if (deadline_exceeded) {
+    // The prefill and decode tasks give up on the cancelled flag before
+    // calling the executor, and so do the tasks queued after them, which
+    // depend on their outcome.
+    ABSL_LOG(WARNING) << "The deadline of the task passed before it started, "
+                         "cancelling the session.";
+    cancelled_.store(true);
+  }
+  task();
+  if (shared_resources_.load_counters != nullptr) {
+    shared_resources_.load_counters->num_queued_tasks.fetch_sub(1);
+  }
+  absl::Status status;
+  {
+    absl::MutexLock lock(&task_mutex_);
+    if (pending_tasks_.empty()) {
+      task_running_ = false;
+      return;
+    }
+    status = ScheduleNextTask();
+    if (status.ok()) {
+      return;
+    }
+  }
+  // The tasks already accepted still run, in order.
+  ABSL_LOG(ERROR) << "Failed to schedule the next task of the session, "
+                     "running the queued tasks in place: "
+                  << status;
+  RunPendingTasks();
+}
+
+absl::Status SessionBasic::RunOnExecutor(
+    absl::AnyInvocable<absl::Status()> fn) {
+  if (lora_executor_ != nullptr) {
+    fn = [this, fn = std::move(fn)]() mutable -> absl::Status {
+      RETURN_IF_ERROR(lora_executor_->SelectLoraAdapter(
+          lora_adapter_ != nullptr ? lora_adapter_->lora_id()
+                                   : LoraLlmExecutor::kNoLoraAdapter));
+      return fn();
+    };
+  }
+  if (batching_slot_ != nullptr) {
+    return batching_slot_->RunExclusive(std::move(fn));
+  }
+  RETURN_IF_ERROR(SelectResidentContext());
+  return fn();
+}
+
+absl::Status SessionBasic::SelectResidentContext() {
+  if (resident_context_ != nullptr) {
+    return resident_context_->Select();
+  }
+  if (shared_resources_.resident_context_pool != nullptr) {
+    return shared_resources_.resident_context_pool->SelectDefault();
+  }
+  return absl::OkStatus();
+}
+
+absl::Status SessionBasic::CheckCanDecode() const {
+  if (shared_resources_.engine_role == EngineRole::kPrefill) {
+    return absl::FailedPreconditionError(
+        "The sessions of a prefill engine do not decode. Serialize a "
+        "checkpoint of the session and restore it on a decode engine.");
+  }
+  return absl::OkStatus();
+}
+
+int SessionBasic::GetNumContextTokens() {
+  if (batching_slot_ != nullptr) {
+    return batching_slot_->GetCurrentStep();
+  }
+  if (auto status = SelectResidentContext(); !status.ok()) {
+    ABSL_LOG(ERROR) << "Failed to select the context of the session: "
+                    << status;
+    return 0;
+  }
+  return executor_.GetCurrentStep().value_or(0);
+}
+
+int SessionBasic::StartDecodeTurn() {
+  if (replay_recorder_ != nullptr) {
+    replay_recorder_->StartTurn();
+  }
+  return GetNumContextTokens();
+}
+
+void SessionBasic::EndDecodeTurn(int start_num_tokens,
+                                 const DecodeConfig& decode_config) {
+  if (shared_resources_.load_counters == nullptr &&
+      replay_recorder_ == nullptr) {
+    return;
+  }
+  // The context shrinks when it is compacted during the decode.
+  const int num_steps = std::max(GetNumContextTokens() - start_num_tokens, 0);
+  if (shared_resources_.load_counters != nullptr) {
+    shared_resources_.load_counters->num_decode_steps.fetch_add(num_steps);
+  }
+  if (replay_recorder_ != nullptr) {
+    if (auto status = replay_recorder_->EndDecode(
+            num_steps, decode_config.GetConstraint() != nullptr);
+        !status.ok()) {
+      ABSL_LOG(WARNING) << "Failed to record the decode turn: " << status;
+    }
+  }
+}
+
+bool SessionBasic::UseHostSampling(
+    const LogitsProcessor* logits_processor,
+    const ReasoningBudget* reasoning_budget) const {
+  if (sampler_ == nullptr) {
+    return false;
+  }
+  if (session_config_.GetSamplerBackend() == Backend::CPU) {
+    return true;
+  }
+  // Without the extension, only the host sampling applies the processor.
+  if (logits_processor != nullptr &&
+      GetExecutorExtension<LogitsProcessingLlmExecutor>(executor_) ==
+          nullptr) {
+    return true;
+  }
+  // Likewise, the executor samples the end of the reasoning through a token
+  // bitmask, outside of the batches.
+  if (reasoning_budget != nullptr &&
+      (batching_slot_ != nullptr ||
+       GetExecutorExtension<TokenBitmaskLlmExecutor>(executor_) == nullptr)) {
+    return true;
+  }
+  return shared_resources_.sampler_backend_selector->Select(
+             session_config_.GetNumOutputCandidates()) ==
+         SamplerBackendSelector::Path::kHost;
+}
+
+void SessionBasic::RecordSamplingCost(bool host_sampling,
+                                      int start_num_tokens,
+                                      absl::Time start_time) {
+  if (sampler_ == nullptr ||
+      session_config_.GetSamplerBackend() == Backend::CPU) {
+    return;
+  }
+  // The context shrinks when it is compacted during the decode.
+  const int num_steps = std::max(GetNumContextTokens() - start_num_tokens, 0);
+  shared_resources_.sampler_backend_selector->Record(
+      session_config_.GetNumOutputCandidates(),
+      host_sampling ? SamplerBackendSelector::Path::kHost
+                    : SamplerBackendSelector::Path::kExecutor,
+      num_steps, absl::Now() - start_time);
+}
+
+absl::Status SessionBasic::MaybeStripReasoning(
+    const DecodeConfig& decode_config, const ReasoningBudget* reasoning_budget,
+    int start_num_tokens) {
+  const auto& options = decode_config.GetReasoningBudgetOptions();
+  if (reasoning_budget == nullptr || !options->strip_reasoning) {
+    return absl::OkStatus();
+  }
+  const std::optional<std::pair<int, int>> range =
+      reasoning_budget->GetReasoningRange();
+  if (!range.has_value()) {
+    return absl::OkStatus();
+  }
+  auto* eviction_executor =
+      GetExecutorExtension<ContextEvictionLlmExecutor>(executor_);
+  // The response is complete either way, so the reasoning stays in the
+  // context when it can not be dropped.
+  if (eviction_executor == nullptr) {
+    ABSL_LOG(WARNING) << "The executor does not support evicting tokens, "
+                         "keeping the reasoning in the context.";
+    return absl::OkStatus();
+  }
+  // The sliding window moves the tokens of the decode.
+  if (context_compactor_ != nullptr) {
+    ABSL_LOG(WARNING) << "Keeping the reasoning in the context of a sliding "
+                         "window.";
+    return absl::OkStatus();
+  }
+  // The first decoded token follows the pending token of the prefill.
+  const int start = start_num_tokens + 1 + range->first;
+  const int num_tokens = range->second - range->first;
+  if (start + num_tokens > GetNumContextTokens()) {
+    return absl::OkStatus();
+  }
+  return RunOnExecutor([&]() {
+    return eviction_executor->EvictTokens(start, num_tokens);
+  });
+}
+
+void SessionBasic::DesyncSpeculativeDecoder(absl::string_view reason) {
+  if (speculative_decoder_ == nullptr || !speculative_decoder_in_sync_) {
+    return;
+  }
+  ABSL_LOG(INFO) << "Speculative decoding is paused until the next text "
+                    "prefill: "
+                 << reason;
+  speculative_decoder_in_sync_ = false;
+}
+
+absl::Status SessionBasic::TrackPrefilledTokens(
+    absl::Span<const int> token_ids) {
+  if (speculative_decoder_in_sync_) {
+    speculative_decoder_->AppendPrefilledTokens(token_ids);
+    return absl::OkStatus();
+  }
+  // The draft model has to follow the new sequence from its start.
+  if (draft_model_proposer_ != nullptr) {
+    RETURN_IF_ERROR(RunOnExecutor([&]() {
+      return draft_model_proposer_->OnSequenceTruncated(0);
+    }));
+  }
+  speculative_decoder_->ResetSequence(token_ids);
+  speculative_decoder_in_sync_ = true;
+  return absl::OkStatus();
+}
+
+absl::StatusOr<bool> SessionBasic::MaybeSetDraftTokenProposer(
+    const DecodeConfig& decode_config) {
+  if (speculative_decoder_ == nullptr) {
+    return false;
+  }
+  if (!speculative_decoder_in_sync_) {
+    return false;
+  }
+  if (decode_config.GetConstraint() != nullptr) {
+    DesyncSpeculativeDecoder("constrained decoding");
+    return false;
+  }
+  if (decode_config.GetLogitsProcessingOptions().has_value()) {
+    DesyncSpeculativeDecoder("logits processing");
+    return false;
+  }
+  if (decode_config.GetReasoningBudgetOptions().has_value()) {
+    DesyncSpeculativeDecoder("reasoning budget");
+    return false;
+  }
+  const auto& prompt_lookup_options = decode_config.GetPromptLookupOptions();
+  if (prompt_lookup_options.has_value()) {
+    ASSIGN_OR_RETURN(
+        prompt_lookup_proposer_,
+        PromptLookupProposer::Create(prompt_lookup_options->min_ngram_size,
+                                     prompt_lookup_options->max_ngram_size));
+    RETURN_IF_ERROR(speculative_decoder_->SetDraftTokenProposer(
+        prompt_lookup_proposer_.get(),
+        prompt_lookup_options->max_num_draft_tokens));
+    return true;
+  }
+  if (draft_model_proposer_ != nullptr) {
+    RETURN_IF_ERROR(speculative_decoder_->SetDraftTokenProposer(
+        draft_model_proposer_.get(), session_config_.GetNumDraftTokens()));
+    return true;
+  }
+  DesyncSpeculativeDecoder("non-speculative decode");
+  return false;
+}
+
+absl::StatusOr<std::unique_ptr<SessionCheckpoint>>
+SessionBasic::Checkpoint() {
+  auto* snapshot_executor =
+      GetExecutorExtension<KvCacheSnapshotLlmExecutor>(executor_);
+  if (snapshot_executor == nullptr) {
+    return absl::UnimplementedError(
+        "The executor does not support kv-cache snapshots.");
+  }
+  absl::StatusOr<std::unique_ptr<SessionCheckpoint>> checkpoint;
+  RETURN_IF_ERROR(RunTaskAndWait([this, snapshot_executor, &checkpoint]() {
+    auto status = RunOnExecutor([&]() -> absl::Status {
+      ASSIGN_OR_RETURN(std::unique_ptr<KvCacheSnapshot> kv_cache,
+                       snapshot_executor->SaveKvCache());
+      auto session_checkpoint = std::make_unique<SessionBasicCheckpoint>();
+      session_checkpoint->executor = &executor_;
+      session_checkpoint->snapshot_executor = snapshot_executor;
+      session_checkpoint->kv_cache = std::move(kv_cache);
+      session_checkpoint->last_prefill_token_id = last_prefill_token_id_;
+      session_checkpoint->is_first_turn = is_first_turn_;
+      session_checkpoint->has_prefilled = has_prefilled_;
+      checkpoint = std::move(session_checkpoint);
+      return absl::OkStatus();
+    });
+    if (!status.ok()) {
+      checkpoint = status;
+    }
+  }));
+  return checkpoint;
+}
+
+absl::Status SessionBasic::Restore(const SessionCheckpoint& checkpoint) {
+  absl::Status status;
+  RETURN_IF_ERROR(RunTaskAndWait([this, &checkpoint, &status]() {
+    status = RestoreInternal(checkpoint);
+  }));
+  return status;
+}
+
+absl::Status SessionBasic::RestoreInternal(
+    const SessionCheckpoint& checkpoint) {
+  const auto* session_checkpoint =
+      dynamic_cast<const SessionBasicCheckpoint*>(&checkpoint);
+  if (session_checkpoint == nullptr) {
+    return absl::InvalidArgumentError(
+        "The checkpoint was not taken by a session of this engine.");
+  }
+  auto* snapshot_executor =
+      GetExecutorExtension<KvCacheSnapshotLlmExecutor>(executor_);
+  if (snapshot_executor == nullptr) {
+    return absl::UnimplementedError(
+        "The executor does not support kv-cache snapshots.");
+  }
+  // The draft token proposers can not follow the context back.
+  DesyncSpeculativeDecoder("checkpoint restored");
+  RETURN_IF_ERROR(RunOnExecutor([&]() -> absl::Status {
+    ASSIGN_OR_RETURN(
+        std::shared_ptr<const KvCacheSnapshot> kv_cache_snapshot,
+        GetCheckpointKvCache(*session_checkpoint, executor_,
+                             *snapshot_executor));
+    const KvCacheSnapshot& kv_cache = *kv_cache_snapshot;
+    RETURN_IF_ERROR(
+        snapshot_executor->RestoreKvCache(kv_cache, kv_cache.GetNumTokens()));
+    if (kv_cache.GetPendingTokenId() < 0) {
+      return absl::OkStatus();
+    }
+    // Prefilling the pending token alone makes it pending again.
+    const std::vector<int> pending_token_id = {kv_cache.GetPendingTokenId()};
+    LITERT_ASSIGN_OR_RETURN(auto pending_token_ids,
+                            CopyToTensorBuffer<int>(pending_token_id, {1, 1}));
+    ExecutorInputs inputs;
+    inputs.SetTextData(ExecutorTextData(std::move(pending_token_ids)));
+    std::optional<BenchmarkInfo> unused_benchmark_info;
+    return Prefill(executor_, inputs, /*wait_for_completion=*/true,
+                   unused_benchmark_info, /*cancelled=*/nullptr,
+                   session_config_.GetMaxNumTokens())
+        .status();
+  }));
+  last_prefill_token_id_ = session_checkpoint->last_prefill_token_id;
+  is_first_turn_ = session_checkpoint->is_first_turn;
+  has_prefilled_ = session_checkpoint->has_prefilled;
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::unique_ptr<Engine::Session>> SessionBasic::MigrateTo(
+    const Engine& engine) {
+  ASSIGN_OR_RETURN(std::unique_ptr<SessionCheckpoint> checkpoint,
+                   Checkpoint());
+  ASSIGN_OR_RETURN(std::unique_ptr<Engine::Session> session,
+                   engine.CreateSession(session_config_));
+  absl::Status status = session->Restore(*checkpoint);
+  if (!absl::IsUnimplemented(status)) {
+    RETURN_IF_ERROR(status);
+    return session;
+  }
+  // The executor of `engine` can not copy the kv-cache of this one, so it
+  // goes through host memory, serialized by this session.
+  ABSL_LOG(INFO) << "Migrating the session through host memory: " << status;
+  const auto& session_checkpoint =
+      static_cast<const SessionBasicCheckpoint&>(*checkpoint);
+  auto host_checkpoint = std::make_unique<SessionBasicCheckpoint>();
+  absl::StatusOr<std::string> kv_cache_data;
+  RETURN_IF_ERROR(RunTaskAndWait([&]() {
+    auto status = RunOnExecutor([&]() -> absl::Status {
+      kv_cache_data = session_checkpoint.snapshot_executor->SerializeKvCache(
+          *session_checkpoint.kv_cache);
+      return absl::OkStatus();
+    });
+    if (!status.ok()) {
+      kv_cache_data = status;
+    }
+  }));
+  RETURN_IF_ERROR(kv_cache_data.status());
+  host_checkpoint->kv_cache_data = *std::move(kv_cache_data);
+  host_checkpoint->last_prefill_token_id =
+      session_checkpoint.last_prefill_token_id;
+  host_checkpoint->is_first_turn = session_checkpoint.is_first_turn;
+  host_checkpoint->has_prefilled = session_checkpoint.has_prefilled;
+  RETURN_IF_ERROR(session->Restore(*host_checkpoint));
+  return session;
+}
+
+absl::Status SessionBasic::SerializeCheckpointParts(
+    const SessionCheckpoint& checkpoint, PersistedSessionState& state,
+    std::string& kv_cache_data) {
+  ASSIGN_OR_RETURN(const SessionBasicCheckpoint* session_checkpoint,
+                   GetSessionBasicCheckpoint(checkpoint, executor_));
+  auto* snapshot_executor =
+      GetExecutorExtension<KvCacheSnapshotLlmExecutor>(executor_);
+  if (snapshot_executor == nullptr) {
+    return absl::UnimplementedError(
+        "The executor does not support kv-cache snapshots.");
+  }
+  absl::StatusOr<std::string> serialized_kv_cache;
+  RETURN_IF_ERROR(RunTaskAndWait([&]() {
+    auto status = RunOnExecutor([&]() -> absl::Status {
+      serialized_kv_cache =
+          snapshot_executor->SerializeKvCache(*session_checkpoint->kv_cache);
+      return absl::OkStatus();
+    });
+    if (!status.ok()) {
+      serialized_kv_cache = status;
+    }
+  }));
+  RETURN_IF_ERROR(serialized_kv_cache.status());
+  kv_cache_data = *std::move(serialized_kv_cache);
+  state.last_prefill_token_id = session_checkpoint->last_prefill_token_id;
+  state.is_first_turn = session_checkpoint->is_first_turn;
+  state.has_prefilled = session_checkpoint->has_prefilled;
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::unique_ptr<SessionCheckpoint>>
+SessionBasic::CreateCheckpointFromFile(
+    std::unique_ptr<SessionStateFile> file) {
+  auto* snapshot_executor =
+      GetExecutorExtension<KvCacheSnapshotLlmExecutor>(executor_);
+  if (snapshot_executor == nullptr) {
+    return absl::UnimplementedError(
+        "The executor does not support kv-cache snapshots.");
+  }
+  absl::StatusOr<std::unique_ptr<KvCacheSnapshot>> kv_cache;
+  RETURN_IF_ERROR(RunTaskAndWait([&]() {
+    auto status = RunOnExecutor([&]() -> absl::Status {
+      kv_cache = snapshot_executor->DeserializeKvCache(file->GetKvCacheData());
+      return absl::OkStatus();
+    });
+    if (!status.ok()) {
+      kv_cache = status;
+    }
+  }));
+  RETURN_IF_ERROR(kv_cache.status());
+
+  auto session_checkpoint = std::make_unique<SessionBasicCheckpoint>();
+  session_checkpoint->executor = &executor_;
+  session_checkpoint->snapshot_executor = snapshot_executor;
+  session_checkpoint->kv_cache = *std::move(kv_cache);
+  session_checkpoint->last_prefill_token_id =
+      file->GetState().last_prefill_token_id;
+  session_checkpoint->is_first_turn = file->GetState().is_first_turn;
+  session_checkpoint->has_prefilled = file->GetState().has_prefilled;
+  session_checkpoint->file = std::move(file);
+  return session_checkpoint;
+}
+
+absl::Status SessionBasic::SaveCheckpoint(const SessionCheckpoint& checkpoint,
+                                          absl::string_view path) {
+  PersistedSessionState state;
+  std::string kv_cache_data;
+  RETURN_IF_ERROR(SerializeCheckpointParts(checkpoint, state, kv_cache_data));
+  return SessionStateFile::Write(path, state, kv_cache_data);
+}
+
+absl::StatusOr<std::unique_ptr<SessionCheckpoint>>
+SessionBasic::LoadCheckpoint(absl::string_view path) {
+  ASSIGN_OR_RETURN(std::unique_ptr<SessionStateFile> file,
+                   SessionStateFile::Open(path));
+  return CreateCheckpointFromFile(std::move(file));
+}
+
+absl::StatusOr<std::string> SessionBasic::SerializeCheckpoint(
+    const SessionCheckpoint& checkpoint) {
+  PersistedSessionState state;
+  std::string kv_cache_data;
+  RETURN_IF_ERROR(SerializeCheckpointParts(checkpoint, state, kv_cache_data));
+  return SessionStateFile::Serialize(state, kv_cache_data);
+}
+
+absl::StatusOr<std::unique_ptr<SessionCheckpoint>>
+SessionBasic::DeserializeCheckpoint(std::string data) {
+  ASSIGN_OR_RETURN(std::unique_ptr<SessionStateFile> file,
+                   SessionStateFile::Parse(std::move(data)));
+  return CreateCheckpointFromFile(std::move(file));
+}
+
+absl::StatusOr<std::unique_ptr<Engine::Session>> SessionBasic::Fork() {
+  if (batching_slot_ == nullptr && resident_context_ == nullptr) {
+    return absl::FailedPreconditionError(
+        "Fork requires an executor keeping the contexts of several sessions "
+        "resident. Use Checkpoint() and Restore() instead.");
+  }
+  ASSIGN_OR_RETURN(std::unique_ptr<SessionCheckpoint> checkpoint,
+                   Checkpoint());
+  ASSIGN_OR_RETURN(
+      std::unique_ptr<SessionBasic> session,
+      SessionBasic::Create(&executor_, &tokenizer_, vision_executor_,
+                           audio_executor_, session_config_, benchmark_info_,
+                           &worker_thread_pool_, shared_resources_));
+  RETURN_IF_ERROR(session->Restore(*checkpoint));
+  return session;
+}
+
 absl::StatusOr<std::string> SessionBasic::MaybeGetBosString() {
+  if (bos_string_.has_value()) {
+    return *bos_string_;
+  }
   auto bos_token_id = session_config_.GetStartTokenId();
   std::string bos_string = "";
   if (bos_token_id >= 0) {
     ASSIGN_OR_RETURN(bos_string, tokenizer_.TokenIdsToText({bos_token_id}));
   }
+  bos_string_ = bos_string;
   return bos_string;
 }
 
 absl::StatusOr<std::vector<InputData>> SessionBasic::ApplyPromptTemplates(
-    const std::vector<InputData>& contents) {
+    std::vector<InputData> contents) {
   if (contents.empty()) {
     return std::vector<InputData>();
   }
@@ -121,16 +1118,14 @@ absl::StatusOr<std::vector<InputData>> SessionBasic::ApplyPromptTemplates(
       templated_contents.push_back(InputText(bos_string));
     }
     is_first_turn_ = false;
-    for (int i = 0; i < contents.size(); ++i) {
-      const auto& content = contents[i];
-      ASSIGN_OR_RETURN(auto content_copy, CreateInputDataCopy(content));
-      templated_contents.emplace_back(std::move(content_copy));
+    for (auto& content : contents) {
+      templated_contents.push_back(std::move(content));
     }
     return templated_contents;
   }
 
   for (int i = 0; i < contents.size(); ++i) {
-    const auto& content = contents[i];
+    auto& content = contents[i];
     const bool is_first_chunk = i == 0;
     const bool is_last_chunk = i == contents.size() - 1;
     absl::string_view raw_text = "";
@@ -167,9 +1162,7 @@ absl::StatusOr<std::vector<InputData>> SessionBasic::ApplyPromptTemplates(
       if (is_first_chunk && !turn_prefix.empty()) {
         templated_contents.push_back(InputText(std::move(turn_prefix)));
       }
-      // TODO - b/445254659: Remove all actual copies.
-      ASSIGN_OR_RETURN(auto content_copy, CreateInputDataCopy(content));
-      templated_contents.emplace_back(std::move(content_copy));
+      templated_contents.push_back(std::move(content));
       if (is_last_chunk && !turn_suffix.empty()) {
         templated_contents.push_back(InputText(std::move(turn_suffix)));
       }
@@ -193,10 +1186,66 @@ absl::StatusOr<std::vector<InputData>> SessionBasic::ApplyPromptTemplates(
 // TODO - b/436674053: Modularize the preprocessing logic into a separate
 // preprocessor class, and have unit test for it.
 absl::StatusOr<ExecutorInputs> SessionBasic::ProcessAndCombineContents(
-    const std::vector<InputData>& preprocessed_contents) {
+    const std::vector<InputData>& preprocessed_contents,
+    ScheduledEncodings* scheduled_encodings) {
+  const bool has_scheduled_images =
+      scheduled_encodings != nullptr && !scheduled_encodings->images.empty();
+  const bool has_scheduled_audios =
+      scheduled_encodings != nullptr && !scheduled_encodings->audios.empty();
   std::vector<int> combined_token_ids;
   std::vector<ExecutorVisionData> all_image_data;
   std::vector<ExecutorAudioData> all_audio_data;
+
+  // The vision and audio encoders are independent, so the audio of a turn
+  // mixing both is encoded on the audio encoding thread of the engine while
+  // the images are encoded. Not with the benchmark, which times each encoder
+  // on its own.
+  std::vector<const TensorBuffer*> spectrogram_tensors;
+  bool has_image = false;
+  for (const auto& preprocessed_content : preprocessed_contents) {
+    if (const auto* input_audio =
+            std::get_if<InputAudio>(&preprocessed_content)) {
+      ASSIGN_OR_RETURN(const auto* spectrogram_tensor,
+                       input_audio->GetPreprocessedAudioTensor());
+      spectrogram_tensors.push_back(spectrogram_tensor);
+    } else if (std::holds_alternative<InputImage>(preprocessed_content)) {
+      has_image = true;
+    }
+  }
+  std::future<absl::StatusOr<std::vector<ExecutorAudioData>>> audio_data;
+  // The encoding refers to the spectrograms and the session, so it is waited
+  // for on every return.
+  absl::Cleanup wait_for_audio_data = [&audio_data]() {
+    if (audio_data.valid()) {
+      audio_data.wait();
+    }
+  };
+  if (has_image && !spectrogram_tensors.empty() && !has_scheduled_audios &&
+      !benchmark_info_.has_value() &&
+      shared_resources_.audio_encoding_thread_pool != nullptr) {
+    auto promise = std::make_shared<
+        std::promise<absl::StatusOr<std::vector<ExecutorAudioData>>>>();
+    auto encode_audio = [this, &spectrogram_tensors]()
+        -> absl::StatusOr<std::vector<ExecutorAudioData>> {
+      std::vector<ExecutorAudioData> encoded_audio_data;
+      for (const auto* spectrogram_tensor : spectrogram_tensors) {
+        ASSIGN_OR_RETURN(auto single_audio_data,
+                         EncodeAudio(*spectrogram_tensor));
+        encoded_audio_data.push_back(std::move(single_audio_data));
+      }
+      return encoded_audio_data;
+    };
+    audio_data = promise->get_future();
+    absl::Status status =
+        shared_resources_.audio_encoding_thread_pool->Schedule(
+            [promise, encode_audio]() { promise->set_value(encode_audio()); });
+    if (!status.ok()) {
+      // The audio is encoded after the images instead.
+      audio_data = {};
+    }
+  }
+  std::vector<size_t> audio_token_offsets;
+
   for (const auto& preprocessed_content : preprocessed_contents) {
     if (const auto* input_text =
             std::get_if<InputText>(&preprocessed_content)) {
@@ -219,32 +1268,44 @@ absl::StatusOr<ExecutorInputs> SessionBasic::ProcessAndCombineContents(
             "Image tensor is null in preprocessed_contents.");
       }
       if (benchmark_info_.has_value()) {
-        RETURN_IF_ERROR(benchmark_info_->TimeMarkDelta("vision_executor"));
+        benchmark_info_->TimeMarkDelta(BenchmarkMark::kVisionExecutor);
       }
-      ASSIGN_OR_RETURN(auto single_image_data,
-                       vision_executor_->Encode(*image_tensor));
+      ASSIGN_OR_RETURN(
+          auto single_image_data,
+          has_scheduled_images
+              ? scheduled_encodings->images[all_image_data.size()].get()
+              : EncodeImage(*image_tensor));
       if (benchmark_info_.has_value()) {
-        RETURN_IF_ERROR(benchmark_info_->TimeMarkDelta("vision_executor"));
+        benchmark_info_->TimeMarkDelta(BenchmarkMark::kVisionExecutor);
       }
       ASSIGN_OR_RETURN(auto embeddings_ptr,
                        single_image_data.GetEmbeddingsPtr());
       const auto& dimensions = TensorBufferDims(*embeddings_ptr);
       // The last two dimensions are [..., image_token_num, model_dimension].
       const int image_token_num = dimensions.at(dimensions.size() - 2);
+      if (shared_resources_.prompt_token_budget != nullptr) {
+        shared_resources_.prompt_token_budget->RecordImageTokens(
+            image_token_num);
+      }
       combined_token_ids.insert(combined_token_ids.end(), image_token_num,
                                 ExecutorVisionData::kSpecialToken);
       all_image_data.push_back(std::move(single_image_data));
-    } else if (const auto* input_audio =
-                   std::get_if<InputAudio>(&preprocessed_content)) {
-      ASSIGN_OR_RETURN(const auto* spectrogram_tensor,
-                       input_audio->GetPreprocessedAudioTensor());
+    } else if (std::holds_alternative<InputAudio>(preprocessed_content)) {
+      if (audio_data.valid()) {
+        // Inserted once the audio encoder is joined.
+        audio_token_offsets.push_back(combined_token_ids.size());
+        continue;
+      }
       if (benchmark_info_.has_value()) {
-        RETURN_IF_ERROR(benchmark_info_->TimeMarkDelta("audio_executor"));
+        benchmark_info_->TimeMarkDelta(BenchmarkMark::kAudioExecutor);
       }
-      ASSIGN_OR_RETURN(auto single_audio_data,
-                       audio_executor_->Encode(*spectrogram_tensor));
+      ASSIGN_OR_RETURN(
+          auto single_audio_data,
+          has_scheduled_audios
+              ? scheduled_encodings->audios[all_audio_data.size()].get()
+              : EncodeAudio(*spectrogram_tensors[all_audio_data.size()]));
       if (benchmark_info_.has_value()) {
-        RETURN_IF_ERROR(benchmark_info_->TimeMarkDelta("audio_executor"));
+        benchmark_info_->TimeMarkDelta(BenchmarkMark::kAudioExecutor);
       }
       const int num_audio_tokens = single_audio_data.GetValidTokens();
       all_audio_data.push_back(std::move(single_audio_data));
@@ -253,6 +1314,19 @@ absl::StatusOr<ExecutorInputs> SessionBasic::ProcessAndCombineContents(
       combined_token_ids.push_back(ExecutorAudioData::kEndToken);
     }
   }
+  if (audio_data.valid()) {
+    ASSIGN_OR_RETURN(all_audio_data, audio_data.get());
+    // From the last audio, so that the offsets of the others stay valid.
+    for (int i = static_cast<int>(audio_token_offsets.size()) - 1; i >= 0;
+         --i) {
+      std::vector<int> audio_token_ids(all_audio_data[i].GetValidTokens(),
+                                       ExecutorAudioData::kSpecialToken);
+      audio_token_ids.push_back(ExecutorAudioData::kEndToken);
+      combined_token_ids.insert(
+          combined_token_ids.begin() + audio_token_offsets[i],
+          audio_token_ids.begin(), audio_token_ids.end());
+    }
+  }
 
   if (combined_token_ids.empty()) {
     return absl::InvalidArgumentError(
@@ -279,13 +1353,118 @@ absl::StatusOr<ExecutorInputs> SessionBasic::ProcessAndCombineContents(
   return inputs;
 }
 
-absl::StatusOr<InputText> SessionBasic::StringToProcessedInputText(
-    absl::string_view text) {
-  auto bos_token_id = session_config_.GetStartTokenId();
-  std::string bos_string = "";
-  if (bos_token_id >= 0) {
-    ASSIGN_OR_RETURN(bos_string, tokenizer_.TokenIdsToText({bos_token_id}));
+absl::StatusOr<std::shared_ptr<VisionExecutor>>
+SessionBasic::GetVisionExecutor() {
+  if (lazy_vision_executor_ != nullptr) {
+    return lazy_vision_executor_->Get();
   }
+  if (vision_executor_ == nullptr) {
+    return absl::FailedPreconditionError(
+        "The model has no vision encoder to encode the image.");
+  }
+  // Not owned, the engine keeps it alive.
+  return std::shared_ptr<VisionExecutor>(std::shared_ptr<void>(),
+                                         vision_executor_);
+}
+
+absl::StatusOr<std::shared_ptr<AudioExecutor>>
+SessionBasic::GetAudioExecutor() {
+  if (lazy_audio_executor_ != nullptr) {
+    return lazy_audio_executor_->Get();
+  }
+  if (audio_executor_ == nullptr) {
+    return absl::FailedPreconditionError(
+        "The model has no audio encoder to encode the audio.");
+  }
+  // Not owned, the engine keeps it alive.
+  return std::shared_ptr<AudioExecutor>(std::shared_ptr<void>(),
+                                        audio_executor_);
+}
+
+absl::StatusOr<ExecutorVisionData> SessionBasic::EncodeImage(
+    const TensorBuffer& image_tensor) {
+  ScopedTraceSlice trace("vision", "EncodeImage");
+  if (embedding_cache_ == nullptr) {
+    return RunVisionEncoder(image_tensor);
+  }
+  ASSIGN_OR_RETURN(auto key, EmbeddingCache::ComputeKey(image_tensor));
+  ASSIGN_OR_RETURN(auto cached_data, embedding_cache_->LookupVision(key));
+  if (cached_data.has_value()) {
+    return std::move(*cached_data);
+  }
+  ASSIGN_OR_RETURN(auto image_data, RunVisionEncoder(image_tensor));
+  RETURN_IF_ERROR(embedding_cache_->InsertVision(key, image_data));
+  return image_data;
+}
+
+absl::StatusOr<ExecutorAudioData> SessionBasic::EncodeAudio(
+    const TensorBuffer& spectrogram_tensor) {
+  ScopedTraceSlice trace("audio", "EncodeAudio");
+  // The cache of the session only holds the streamed audio.
+  EmbeddingCache* cache = embedding_cache_;
+  if (cache == nullptr && audio_stream_cache_ != nullptr &&
+      audio_stream_cache_->GetNumEntries() > 0) {
+    cache = audio_stream_cache_.get();
+  }
+  if (cache == nullptr) {
+    return RunAudioEncoder(spectrogram_tensor);
+  }
+  ASSIGN_OR_RETURN(auto key, EmbeddingCache::ComputeKey(spectrogram_tensor));
+  ASSIGN_OR_RETURN(auto cached_data, cache->LookupAudio(key));
+  if (cached_data.has_value()) {
+    return std::move(*cached_data);
+  }
+  ASSIGN_OR_RETURN(auto audio_data, RunAudioEncoder(spectrogram_tensor));
+  if (cache == embedding_cache_) {
+    RETURN_IF_ERROR(embedding_cache_->InsertAudio(key, audio_data));
+  }
+  return audio_data;
+}
+
+absl::StatusOr<ExecutorVisionData> SessionBasic::RunVisionEncoder(
+    const TensorBuffer& image_tensor) {
+  ASSIGN_OR_RETURN(auto vision_executor, GetVisionExecutor());
+  absl::MutexLockMaybe lock(shared_resources_.vision_encoder_mutex);
+  return vision_executor->Encode(image_tensor);
+}
+
+absl::StatusOr<ExecutorAudioData> SessionBasic::RunAudioEncoder(
+    const TensorBuffer& spectrogram_tensor) {
+  ASSIGN_OR_RETURN(auto audio_executor, GetAudioExecutor());
+  absl::MutexLockMaybe lock(shared_resources_.audio_encoder_mutex);
+  return audio_executor->Encode(spectrogram_tensor);
+}
+
+absl::StatusOr<std::unique_ptr<AudioStream>>
+SessionBasic::CreateAudioStream() {
+  if (!HasAudioExecutor()) {
+    return absl::FailedPreconditionError(
+        "The model has no audio encoder to stream the audio to.");
+  }
+  // A preprocessor of its own, which keeps the samples left over by a chunk
+  // for the next one, as long as it is not reset.
+  ASSIGN_OR_RETURN(std::shared_ptr<AudioPreprocessor> audio_preprocessor,
+                   AudioPreprocessorMiniAudio::Create(
+                       AudioPreprocessorConfig::CreateDefaultUsmConfig()));
+  EmbeddingCache* cache = embedding_cache_ != nullptr
+                              ? embedding_cache_
+                              : audio_stream_cache_.get();
+  return std::make_unique<AudioStreamEncoder>(
+      [audio_preprocessor](const InputAudio& audio_chunk) {
+        return audio_preprocessor->Preprocess(audio_chunk);
+      },
+      [this](const TensorBuffer& spectrogram) {
+        return RunAudioEncoder(spectrogram);
+      },
+      [this](absl::AnyInvocable<void()> task) {
+        return ScheduleTask(std::move(task));
+      },
+      *cache);
+}
+
+absl::StatusOr<std::vector<int>> SessionBasic::TextToPrefillTokenIds(
+    absl::string_view text) {
+  ASSIGN_OR_RETURN(std::string bos_string, MaybeGetBosString());
   bool bos_token_found = false;
   if (!bos_string.empty() && absl::StartsWith(text, bos_string)) {
     text = text.substr(bos_string.size());
@@ -297,7 +1476,15 @@ absl::StatusOr<InputText> SessionBasic::StringToProcessedInputText(
     benchmark_prefill_token_count =
         benchmark_info_->GetBenchmarkParams().num_prefill_tokens();
   }
-  ASSIGN_OR_RETURN(std::vector<int> ids, tokenizer_.TextToTokenIds(text));
+  std::vector<int> ids;
+  {
+    ScopedTraceSlice trace("tokenizer", "Tokenize");
+    if (token_id_cache_ != nullptr) {
+      ASSIGN_OR_RETURN(ids, token_id_cache_->TextToTokenIds(tokenizer_, text));
+    } else {
+      ASSIGN_OR_RETURN(ids, tokenizer_.TextToTokenIds(text));
+    }
+  }
   if (benchmark_prefill_token_count > 0) {
     // If benchmark is enabled, we will use the benchmark prefill token
     // count to set the prefill token count.
@@ -305,37 +1492,40 @@ absl::StatusOr<InputText> SessionBasic::StringToProcessedInputText(
   } else if (bos_token_found) {
     ids.insert(ids.begin(), session_config_.GetStartTokenId());
   }
+  return ids;
+}
+
+absl::StatusOr<InputText> SessionBasic::StringToProcessedInputText(
+    absl::string_view text) {
+  ASSIGN_OR_RETURN(std::vector<int> ids, TextToPrefillTokenIds(text));
   ASSIGN_OR_RETURN(auto ids_buffer, tokenizer_.TokenIdsToTensorBuffer(ids));
   return InputText(std::move(ids_buffer));
 }
 
 absl::StatusOr<std::vector<InputData>> SessionBasic::PreprocessContents(
-    const std::vector<InputData>& contents) {
+    std::vector<InputData> contents) {
   std::vector<InputData> preprocessed_contents;
-  for (int i = 0; i < contents.size(); ++i) {
-    const auto& content = contents[i];
-    if (const auto* input_text = std::get_if<InputText>(&content)) {
+  preprocessed_contents.reserve(contents.size());
+  for (auto& content : contents) {
+    if (auto* input_text = std::get_if<InputText>(&content)) {
       if (input_text->IsTensorBuffer()) {
-        ASSIGN_OR_RETURN(auto input_text_copy, input_text->CreateCopy());
-        preprocessed_contents.emplace_back(std::move(input_text_copy));
+        preprocessed_contents.emplace_back(std::move(*input_text));
       } else {
         ASSIGN_OR_RETURN(auto templated_text, input_text->GetRawTextString());
         ASSIGN_OR_RETURN(auto processed_input_text,
                          StringToProcessedInputText(templated_text));
         preprocessed_contents.emplace_back(std::move(processed_input_text));
       }
-    } else if (const auto* input_image = std::get_if<InputImage>(&content)) {
+    } else if (auto* input_image = std::get_if<InputImage>(&content)) {
       if (input_image->IsTensorBuffer()) {
-        ASSIGN_OR_RETURN(auto input_image_copy, input_image->CreateCopy());
-        preprocessed_contents.emplace_back(std::move(input_image_copy));
+        preprocessed_contents.emplace_back(std::move(*input_image));
       } else {
         return absl::InternalError(
             "Image must be preprocessed before being used in SessionBasic.");
       }
-    } else if (const auto* input_audio = std::get_if<InputAudio>(&content)) {
+    } else if (auto* input_audio = std::get_if<InputAudio>(&content)) {
       if (input_audio->IsTensorBuffer()) {
-        ASSIGN_OR_RETURN(auto input_audio_copy, input_audio->CreateCopy());
-        preprocessed_contents.emplace_back(std::move(input_audio_copy));
+        preprocessed_contents.emplace_back(std::move(*input_audio));
       } else {
         return absl::InternalError(
             "Audio must be preprocessed before being used in SessionBasic.");
@@ -345,21 +1535,286 @@ absl::StatusOr<std::vector<InputData>> SessionBasic::PreprocessContents(
   return preprocessed_contents;
 }
 
+absl::Status SessionBasic::CheckPromptTokenBudget(
+    const std::vector<InputData>& preprocessed_contents) const {
+  if (shared_resources_.prompt_token_budget == nullptr) {
+    return absl::OkStatus();
+  }
+  int num_text_tokens = 0;
+  int num_images = 0;
+  int num_audios = 0;
+  for (const auto& preprocessed_content : preprocessed_contents) {
+    if (const auto* input_text =
+            std::get_if<InputText>(&preprocessed_content)) {
+      ASSIGN_OR_RETURN(const auto* token_ids,
+                       input_text->GetPreprocessedTextTensor());
+      if (token_ids != nullptr) {
+        num_text_tokens += TensorBufferDims(*token_ids).back();
+      }
+    } else if (std::holds_alternative<InputImage>(preprocessed_content)) {
+      ++num_images;
+    } else if (std::holds_alternative<InputAudio>(preprocessed_content)) {
+      ++num_audios;
+    }
+  }
+  return shared_resources_.prompt_token_budget->Check(num_text_tokens,
+                                                      num_images, num_audios);
+}
+
+absl::StatusOr<ScheduledEncodings> SessionBasic::ScheduleEncodings(
+    const std::vector<InputData>& preprocessed_contents) {
+  ScheduledEncodings encodings;
+  EncoderScheduler* scheduler = shared_resources_.encoder_scheduler;
+  // The benchmark times each encoder within the prefill.
+  if (scheduler == nullptr || benchmark_info_.has_value()) {
+    return encodings;
+  }
+  // The encodings hold a duplicate of the tensor, the preprocessed contents
+  // may be gone by the time they run.
+  std::vector<TensorBuffer> image_tensors;
+  std::vector<TensorBuffer> spectrogram_tensors;
+  for (const auto& preprocessed_content : preprocessed_contents) {
+    if (const auto* input_image =
+            std::get_if<InputImage>(&preprocessed_content);
+        input_image != nullptr &&
+        scheduler->HasStream(EncoderScheduler::Stream::kVision)) {
+      ASSIGN_OR_RETURN(const auto* image_tensor,
+                       input_image->GetPreprocessedImageTensor());
+      if (image_tensor == nullptr) {
+        return absl::InvalidArgumentError(
+            "Image tensor is null in preprocessed_contents.");
+      }
+      LITERT_ASSIGN_OR_RETURN(auto duplicated, image_tensor->Duplicate());
+      image_tensors.push_back(std::move(duplicated));
+    } else if (const auto* input_audio =
+                   std::get_if<InputAudio>(&preprocessed_content);
+               input_audio != nullptr &&
+               scheduler->HasStream(EncoderScheduler::Stream::kAudio)) {
+      ASSIGN_OR_RETURN(const auto* spectrogram_tensor,
+                       input_audio->GetPreprocessedAudioTensor());
+      LITERT_ASSIGN_OR_RETURN(auto duplicated,
+                              spectrogram_tensor->Duplicate());
+      spectrogram_tensors.push_back(std::move(duplicated));
+    }
+  }
+  {
+    absl::MutexLock lock(&encodings_mutex_);
+    num_pending_encodings_ += image_tensors.size() + spectrogram_tensors.size();
+  }
+  for (TensorBuffer& image_tensor : image_tensors) {
+    encodings.images.push_back(scheduler->Schedule<ExecutorVisionData>(
+        EncoderScheduler::Stream::kVision,
+        [this, image_tensor = std::move(image_tensor)]() {
+          absl::StatusOr<ExecutorVisionData> image_data =
+              EncodeImage(image_tensor);
+          absl::MutexLock lock(&encodings_mutex_);
+          --num_pending_encodings_;
+          return image_data;
+        }));
+  }
+  for (TensorBuffer& spectrogram_tensor : spectrogram_tensors) {
+    encodings.audios.push_back(scheduler->Schedule<ExecutorAudioData>(
+        EncoderScheduler::Stream::kAudio,
+        [this, spectrogram_tensor = std::move(spectrogram_tensor)]() {
+          absl::StatusOr<ExecutorAudioData> audio_data =
+              EncodeAudio(spectrogram_tensor);
+          absl::MutexLock lock(&encodings_mutex_);
+          --num_pending_encodings_;
+          return audio_data;
+        }));
+  }
+  return encodings;
+}
+
 absl::Status SessionBasic::PrefillInternal(
     const std::vector<InputData>& preprocessed_contents,
-    bool wait_for_completion) {
-  ASSIGN_OR_RETURN(ExecutorInputs inputs,
-                   ProcessAndCombineContents(preprocessed_contents));
-
-  // This should be added to the beginning of the next prefill call as will no?
-  // Also, this is not thread safe. More discussion with @ztenghui is needed.
+    bool wait_for_completion, ScheduledEncodings scheduled_encodings) {
+  if (cancelled_.load()) {
+    return absl::CancelledError("Process cancelled.");
+  }
+  if (replay_recorder_ != nullptr) {
+    replay_recorder_->StartTurn();
+  }
   ASSIGN_OR_RETURN(
-      last_prefill_token_id_,
-      Prefill(executor_, inputs, wait_for_completion, benchmark_info_));
+      ExecutorInputs inputs,
+      ProcessAndCombineContents(preprocessed_contents, &scheduled_encodings));
+
+  // The speculative decoder and the prefix cache track the prefilled token
+  // ids, they can not see the multimodal embeddings though.
+  const bool is_text_only =
+      !inputs.GetVisionDataPtr().ok() && !inputs.GetAudioDataPtr().ok();
+  if (!is_text_only) {
+    DesyncSpeculativeDecoder("multimodal prefill");
+  }
+  // Only the first prefill starts from an empty context, which a cached
+  // prefix can replace. Benchmarks measure the full prefill.
+  const bool use_prefix_cache = prefix_kv_cache_ != nullptr && is_text_only &&
+                                !has_prefilled_ && !benchmark_info_.has_value();
+  std::vector<int> prefill_token_ids;
+  if (speculative_decoder_ != nullptr || use_prefix_cache ||
+      replay_recorder_ != nullptr) {
+    ASSIGN_OR_RETURN(auto text_data, inputs.GetTextDataPtr());
+    LITERT_ASSIGN_OR_RETURN(
+        auto token_ids, ReferTensorBufferAsSpan<int>(text_data->GetTokenIds()));
+    prefill_token_ids.assign(token_ids.begin(), token_ids.end());
+  }
+  int num_restored_tokens = 0;
+  if (use_prefix_cache) {
+    RETURN_IF_ERROR(RunOnExecutor([&]() -> absl::Status {
+      ASSIGN_OR_RETURN(num_restored_tokens,
+                       MaybeRestoreCachedPrefix(prefill_token_ids, inputs));
+      return absl::OkStatus();
+    }));
+  }
+
+  if (context_compactor_ != nullptr) {
+    ASSIGN_OR_RETURN(auto text_data, inputs.GetTextDataPtr());
+    LITERT_ASSIGN_OR_RETURN(auto token_ids_type,
+                            text_data->GetTokenIds().TensorType());
+    const int num_tokens = token_ids_type.Layout().Dimensions().back();
+    RETURN_IF_ERROR(RunOnExecutor([&]() -> absl::Status {
+      ASSIGN_OR_RETURN(int current_step, executor_.GetCurrentStep());
+      return context_compactor_->MakeRoom(current_step, num_tokens).status();
+    }));
+  }
+
+  // With continuous batching, long text prompts are prefilled in chunks so
+  // that the decode steps of the other sessions run in between. Benchmarks
+  // measure the prefill as a single turn.
+  const int prefill_chunk_size =
+      batching_slot_ != nullptr && is_text_only && !benchmark_info_.has_value()
+          ? batching_slot_->GetPrefillChunkSize()
+          : 0;
+  if (prefill_chunk_size > 0) {
+    RETURN_IF_ERROR(
+        PrefillInChunks(inputs, prefill_chunk_size, wait_for_completion));
+  } else {
+    // This should be added to the beginning of the next prefill call as will
+    // no? Also, this is not thread safe. More discussion with @ztenghui is
+    // needed.
+    RETURN_IF_ERROR(RunOnExecutor([&]() -> absl::Status {
+      ASSIGN_OR_RETURN(
+          last_prefill_token_id_,
+          Prefill(executor_, inputs, wait_for_completion, benchmark_info_,
+                  &cancelled_, session_config_.GetMaxNumTokens()));
+      return absl::OkStatus();
+    }));
+  }
+  has_prefilled_ = true;
+  if (shared_resources_.load_counters != nullptr) {
+    ASSIGN_OR_RETURN(auto text_data, inputs.GetTextDataPtr());
+    LITERT_ASSIGN_OR_RETURN(auto token_ids_type,
+                            text_data->GetTokenIds().TensorType());
+    shared_resources_.load_counters->num_prefilled_tokens.fetch_add(
+        token_ids_type.Layout().Dimensions().back());
+  }
+
+  if (use_prefix_cache) {
+    RETURN_IF_ERROR(RunOnExecutor([&]() {
+      MaybeCachePrefix(prefill_token_ids, num_restored_tokens);
+      return absl::OkStatus();
+    }));
+  }
+  if (speculative_decoder_ != nullptr && is_text_only) {
+    RETURN_IF_ERROR(TrackPrefilledTokens(prefill_token_ids));
+  }
+  if (replay_recorder_ != nullptr) {
+    if (auto status =
+            replay_recorder_->EndPrefill(prefill_token_ids, !is_text_only);
+        !status.ok()) {
+      ABSL_LOG(WARNING) << "Failed to record the prefill turn: " << status;
+    }
+  }
   return absl::OkStatus();
 }
 
+absl::Status SessionBasic::PrefillInChunks(ExecutorInputs& inputs,
+                                           int chunk_size,
+                                           bool wait_for_completion) {
+  ASSIGN_OR_RETURN(auto text_data, inputs.GetTextDataPtr());
+  LITERT_ASSIGN_OR_RETURN(
+      auto token_ids, ReferTensorBufferAsSpan<int>(text_data->GetTokenIds()));
+  for (int start = 0; start < token_ids.size(); start += chunk_size) {
+    const absl::Span<const int> chunk = token_ids.subspan(start, chunk_size);
+    const int num_chunk_tokens = chunk.size();
+    LITERT_ASSIGN_OR_RETURN(
+        auto chunk_token_ids,
+        CopyToTensorBuffer<int>(chunk, {1, num_chunk_tokens}));
+    ExecutorInputs chunk_inputs;
+    chunk_inputs.SetTextData(ExecutorTextData(std::move(chunk_token_ids)));
+    // All the chunks but the last complete within their exclusive task, so
+    // that they do not delay the decode steps batched after them.
+    const bool is_last_chunk = start + num_chunk_tokens == token_ids.size();
+    RETURN_IF_ERROR(RunOnExecutor([&]() -> absl::Status {
+      ASSIGN_OR_RETURN(
+          last_prefill_token_id_,
+          Prefill(executor_, chunk_inputs,
+                  wait_for_completion || !is_last_chunk, benchmark_info_,
+                  &cancelled_, session_config_.GetMaxNumTokens()));
+      return absl::OkStatus();
+    }));
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<int> SessionBasic::MaybeRestoreCachedPrefix(
+    absl::Span<const int> token_ids, ExecutorInputs& inputs) {
+  auto* snapshot_executor =
+      GetExecutorExtension<KvCacheSnapshotLlmExecutor>(executor_);
+  if (snapshot_executor == nullptr || token_ids.size() < 2) {
+    return 0;
+  }
+  // The last token is left pending by the prefill, so at least one token must
+  // still be prefilled after the restored ones.
+  std::optional<PrefixKvCache::Match> match =
+      prefix_kv_cache_->Lookup(token_ids.first(token_ids.size() - 1));
+  if (!match.has_value()) {
+    return 0;
+  }
+  RETURN_IF_ERROR(
+      snapshot_executor->RestoreKvCache(*match->snapshot, match->num_tokens));
+  const absl::Span<const int> remaining_token_ids =
+      token_ids.subspan(match->num_tokens);
+  const int num_remaining_tokens = remaining_token_ids.size();
+  LITERT_ASSIGN_OR_RETURN(
+      auto remaining_token_ids_buffer,
+      CopyToTensorBuffer<int>(remaining_token_ids, {1, num_remaining_tokens}));
+  inputs.SetTextData(ExecutorTextData(std::move(remaining_token_ids_buffer)));
+  ABSL_LOG(INFO) << "Restored " << match->num_tokens << " of "
+                 << token_ids.size() << " prompt tokens from the prefix cache.";
+  return match->num_tokens;
+}
+
+void SessionBasic::MaybeCachePrefix(absl::Span<const int> token_ids,
+                                    int num_restored_tokens) {
+  auto* snapshot_executor =
+      GetExecutorExtension<KvCacheSnapshotLlmExecutor>(executor_);
+  if (snapshot_executor == nullptr || token_ids.size() < 2) {
+    return;
+  }
+  const absl::Span<const int> attended_token_ids =
+      token_ids.first(token_ids.size() - 1);
+  // Only a new snapshot mostly made of prefilled tokens is worth its memory,
+  // the restored snapshot serves the others.
+  if (2 * num_restored_tokens >= attended_token_ids.size()) {
+    return;
+  }
+  auto snapshot = snapshot_executor->SaveKvCache();
+  absl::Status status =
+      snapshot.ok()
+          ? prefix_kv_cache_->Insert(attended_token_ids, *std::move(snapshot))
+          : snapshot.status();
+  if (!status.ok()) {
+    ABSL_LOG(WARNING) << "Failed to cache the prompt prefix: " << status;
+  }
+}
+
 absl::Status SessionBasic::RunPrefill(const std::vector<InputData>& contents) {
+  ASSIGN_OR_RETURN(auto contents_copy, CopyContents(contents));
+  return RunPrefill(std::move(contents_copy));
+}
+
+absl::Status SessionBasic::RunPrefill(std::vector<InputData>&& contents) {
   if (contents.empty()) {
     return absl::InvalidArgumentError("Input is empty.");
   }
@@ -370,27 +1825,47 @@ absl::Status SessionBasic::RunPrefill(const std::vector<InputData>& contents) {
   std::vector<InputData> preprocessed_contents;
   if (benchmark_info_.has_value() &&
       benchmark_info_->GetBenchmarkParams().num_prefill_tokens() > 0) {
-    ASSIGN_OR_RETURN(preprocessed_contents, PreprocessContents(contents));
+    ASSIGN_OR_RETURN(preprocessed_contents,
+                     PreprocessContents(std::move(contents)));
   } else {
     ASSIGN_OR_RETURN(std::vector<InputData> templated_contents,
-                     ApplyPromptTemplates(contents));
+                     ApplyPromptTemplates(std::move(contents)));
     ASSIGN_OR_RETURN(preprocessed_contents,
-                     PreprocessContents(templated_contents));
+                     PreprocessContents(std::move(templated_contents)));
   }
+  RETURN_IF_ERROR(CheckPromptTokenBudget(preprocessed_contents));
+  ASSIGN_OR_RETURN(ScheduledEncodings encodings,
+                   ScheduleEncodings(preprocessed_contents));
   absl::Status status;
-  RETURN_IF_ERROR(worker_thread_pool_.Schedule(
+  RETURN_IF_ERROR(RunTaskAndWait(
       [this, preprocessed_contents = std::move(preprocessed_contents),
-       &status]() {
+       encodings = std::move(encodings), &status]() mutable {
         status = this->PrefillInternal(preprocessed_contents,
-                                       /*wait_for_completion=*/true);
-      }));
-  RETURN_IF_ERROR(worker_thread_pool_.WaitUntilDone(Engine::kDefaultTimeout));
+                                       /*wait_for_completion=*/true,
+                                       std::move(encodings));
+      },
+      GetTaskPriority(DecodeConfig::CreateDefault())));
   return status;
 }
 
 absl::Status SessionBasic::RunPrefillAsync(
     const std::vector<InputData>& contents,
     absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback) {
+  ASSIGN_OR_RETURN(auto contents_copy, CopyContents(contents));
+  return RunPrefillAsync(std::move(contents_copy), std::move(callback));
+}
+
+absl::Status SessionBasic::RunPrefillAsync(
+    std::vector<InputData>&& contents,
+    absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback) {
+  return RunPrefillAsync(std::move(contents), std::move(callback),
+                         GetTaskPriority(DecodeConfig::CreateDefault()));
+}
+
+absl::Status SessionBasic::RunPrefillAsync(
+    std::vector<InputData>&& contents,
+    absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
+    const TaskPriority& priority) {
   if (contents.empty()) {
     return absl::InvalidArgumentError("Input is empty.");
   }
@@ -401,72 +1876,232 @@ absl::Status SessionBasic::RunPrefillAsync(
   std::vector<InputData> preprocessed_contents;
   if (benchmark_info_.has_value() &&
       benchmark_info_->GetBenchmarkParams().num_prefill_tokens() > 0) {
-    ASSIGN_OR_RETURN(preprocessed_contents, PreprocessContents(contents));
+    ASSIGN_OR_RETURN(preprocessed_contents,
+                     PreprocessContents(std::move(contents)));
   } else {
     ASSIGN_OR_RETURN(std::vector<InputData> templated_contents,
-                     ApplyPromptTemplates(contents));
+                     ApplyPromptTemplates(std::move(contents)));
     ASSIGN_OR_RETURN(preprocessed_contents,
-                     PreprocessContents(templated_contents));
+                     PreprocessContents(std::move(templated_contents)));
   }
-  RETURN_IF_ERROR(worker_thread_pool_.Schedule(
+  RETURN_IF_ERROR(CheckPromptTokenBudget(preprocessed_contents));
+  ASSIGN_OR_RETURN(ScheduledEncodings encodings,
+                   ScheduleEncodings(preprocessed_contents));
+  RETURN_IF_ERROR(ScheduleTask(
       [this, preprocessed_contents = std::move(preprocessed_contents),
+       encodings = std::move(encodings),
        callback = std::move(callback)]() mutable {
         absl::Status status = this->PrefillInternal(
-            preprocessed_contents, /*wait_for_completion=*/false);
+            preprocessed_contents, /*wait_for_completion=*/false,
+            std::move(encodings));
         ABSL_LOG(INFO) << "RunPrefillAsync status: " << status;
         if (!status.ok()) {
           callback(status);
         } else {
           callback(Responses(TaskState::kDone));
         }
-      }));
+      },
+      priority));
   return absl::OkStatus();
 }
 
 absl::StatusOr<Responses> SessionBasic::DecodeInternal(
     const DecodeConfig& decode_config) {
-  if (sampler_ == nullptr) {
-    ASSIGN_OR_RETURN(
-        auto responses,
+  if (session_config_.GetUseBeamSearch()) {
+    return DecodeBeamSearchInternal(decode_config);
+  }
+  ASSIGN_OR_RETURN(bool is_speculative,
+                   MaybeSetDraftTokenProposer(decode_config));
+  ASSIGN_OR_RETURN(std::unique_ptr<LogitsProcessor> logits_processor,
+                   MaybeCreateLogitsProcessor(decode_config, session_config_));
+  if (is_speculative) {
+    absl::StatusOr<Responses> responses;
+    RETURN_IF_ERROR(RunOnExecutor([&]() {
+      responses = DecodeSpeculative(
+          executor_, tokenizer_, stop_token_detector_, *speculative_decoder_,
+          benchmark_info_, &cancelled_, stop_sequences_.get(),
+          session_config_.GetMaxNumTokens());
+      return absl::OkStatus();
+    }));
+    return responses;
+  }
+  ASSIGN_OR_RETURN(
+      std::unique_ptr<ReasoningBudget> reasoning_budget,
+      MaybeCreateReasoningBudget(decode_config, session_config_, tokenizer_));
+  const bool host_sampling =
+      UseHostSampling(logits_processor.get(), reasoning_budget.get());
+  const int start_num_tokens = GetNumContextTokens();
+  const absl::Time start_time = absl::Now();
+  absl::StatusOr<Responses> responses;
+  if (!host_sampling) {
+    responses =
         Decode(executor_, tokenizer_, stop_token_detector_,
                session_config_.GetNumOutputCandidates(),
-               decode_config.GetConstraint(), benchmark_info_, &cancelled_));
-    return responses;
+               decode_config.GetConstraint(), benchmark_info_, &cancelled_,
+               batching_slot_.get(), context_compactor_.get(),
+               stop_sequences_.get(), shared_resources_.token_text_table,
+               logits_processor.get(), reasoning_budget.get(),
+               session_config_.GetMaxNumTokens());
   } else {
     std::vector<int> decoded_ids(session_config_.GetNumOutputCandidates(),
                                  last_prefill_token_id_);
-    auto decoded_ids_buffer = CopyToTensorBuffer<int>(
-        decoded_ids, {session_config_.GetNumOutputCandidates(), 1});
-    ASSIGN_OR_RETURN(auto responses,
-                     DecodeCustomSampling(
-                         executor_, tokenizer_, stop_token_detector_,
-                         session_config_.GetNumOutputCandidates(), *sampler_,
-                         *decoded_ids_buffer, decode_config.GetConstraint(),
-                         benchmark_info_, &cancelled_));
-    return responses;
+    LITERT_ASSIGN_OR_RETURN(
+        auto decoded_ids_buffer,
+        tensor_buffer_pool_.AcquireAndCopy<int>(
+            decoded_ids, {session_config_.GetNumOutputCandidates(), 1}));
+    // The custom sampling loop calls the executor directly, so it can not be
+    // batched with the other sessions.
+    RETURN_IF_ERROR(RunOnExecutor([&]() {
+      responses = DecodeCustomSampling(
+          executor_, tokenizer_, stop_token_detector_,
+          session_config_.GetNumOutputCandidates(), *sampler_,
+          decoded_ids_buffer.Get(), decode_config.GetConstraint(),
+          benchmark_info_, &cancelled_, context_compactor_.get(),
+          stop_sequences_.get(), MaybeGetCandidatePruningOptions(decode_config),
+          shared_resources_.token_text_table, logits_processor.get(),
+          reasoning_budget.get(), session_config_.GetMaxNumTokens());
+      return absl::OkStatus();
+    }));
+  }
+  if (responses.ok()) {
+    RecordSamplingCost(host_sampling, start_num_tokens, start_time);
+    RETURN_IF_ERROR(MaybeStripReasoning(decode_config, reasoning_budget.get(),
+                                        start_num_tokens));
   }
+  return responses;
 }
 
 absl::Status SessionBasic::DecodeInternalStreaming(
     absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
     const DecodeConfig& decode_config) {
-  if (sampler_ == nullptr) {
+  // Hands the responses over to another thread, so that the decode loop does
+  // not wait for the callback. Destroying the dispatcher delivers the
+  // remaining responses before the task completes.
+  std::optional<CallbackDispatcher> callback_dispatcher;
+  if (session_config_.GetPipelinedCallbacks()) {
+    callback_dispatcher.emplace(
+        std::move(callback), session_config_.GetCallbackQueueCapacity(),
+        session_config_.GetCallbackBackpressurePolicy(),
+        [this]() { CancelProcess(); });
+    callback = callback_dispatcher->AsCallback();
+  }
+  // Merges the responses of consecutive steps ahead of the dispatcher, so
+  // that fewer of them are handed over.
+  std::optional<StreamingCoalescer> streaming_coalescer;
+  if (decode_config.GetStreamingCoalescingOptions().has_value()) {
+    streaming_coalescer.emplace(std::move(callback),
+                                *decode_config.GetStreamingCoalescingOptions());
+    callback = streaming_coalescer->AsCallback();
+  }
+  if (session_config_.GetUseBeamSearch()) {
+    // The best hypotheses are only known at the end of the search.
+    absl::StatusOr<Responses> responses =
+        DecodeBeamSearchInternal(decode_config);
+    if (!responses.ok()) {
+      callback(responses.status());
+      return responses.status();
+    }
+    callback(Responses(TaskState::kProcessing, responses->GetTexts(),
+                       responses->GetScores()));
+    callback(Responses(TaskState::kDone));
+    return absl::OkStatus();
+  }
+  // The async callers only wait for the callback, so the errors go there too.
+  absl::StatusOr<bool> is_speculative =
+      MaybeSetDraftTokenProposer(decode_config);
+  if (!is_speculative.ok()) {
+    callback(is_speculative.status());
+    return is_speculative.status();
+  }
+  absl::StatusOr<std::unique_ptr<LogitsProcessor>> logits_processor =
+      MaybeCreateLogitsProcessor(decode_config, session_config_);
+  if (!logits_processor.ok()) {
+    callback(logits_processor.status());
+    return logits_processor.status();
+  }
+  if (*is_speculative) {
+    RETURN_IF_ERROR(RunOnExecutor([&]() {
+      return DecodeSpeculativeStreaming(
+          executor_, tokenizer_, stop_token_detector_, *speculative_decoder_,
+          benchmark_info_, std::move(callback), &cancelled_,
+          stop_sequences_.get(), session_config_.GetMaxNumTokens());
+    }));
+    return absl::OkStatus();
+  }
+  absl::StatusOr<std::unique_ptr<ReasoningBudget>> reasoning_budget =
+      MaybeCreateReasoningBudget(decode_config, session_config_, tokenizer_);
+  if (!reasoning_budget.ok()) {
+    callback(reasoning_budget.status());
+    return reasoning_budget.status();
+  }
+  const bool host_sampling =
+      UseHostSampling(logits_processor->get(), reasoning_budget->get());
+  const int start_num_tokens = GetNumContextTokens();
+  const absl::Time start_time = absl::Now();
+  if (!host_sampling) {
     RETURN_IF_ERROR(DecodeStreaming(
         executor_, tokenizer_, stop_token_detector_,
         session_config_.GetNumOutputCandidates(), decode_config.GetConstraint(),
-        benchmark_info_, std::move(callback), &cancelled_));
+        benchmark_info_, std::move(callback), &cancelled_,
+        batching_slot_.get(), context_compactor_.get(), stop_sequences_.get(),
+        shared_resources_.token_text_table, logits_processor->get(),
+        reasoning_budget->get(), session_config_.GetMaxNumTokens()));
   } else {
-    std::vector<int> decoded_ids(session_config_.GetNumOutputCandidates(),
-                                 last_prefill_token_id_);
-    auto decoded_ids_buffer = CopyToTensorBuffer<int>(
-        decoded_ids, {session_config_.GetNumOutputCandidates(), 1});
-    RETURN_IF_ERROR(DecodeCustomSamplingStreaming(
-        executor_, tokenizer_, stop_token_detector_,
-        session_config_.GetNumOutputCandidates(), *sampler_,
-        *decoded_ids_buffer, decode_config.GetConstraint(), benchmark_info_,
-        std::move(callback), &cancelled_));
+    absl::StatusOr<TensorBufferPool::Lease> decoded_ids_buffer =
+        AcquireDecodedIdsBuffer(tensor_buffer_pool_,
+                                session_config_.GetNumOutputCandidates(),
+                                last_prefill_token_id_);
+    if (!decoded_ids_buffer.ok()) {
+      callback(decoded_ids_buffer.status());
+      return decoded_ids_buffer.status();
+    }
+    RETURN_IF_ERROR(RunOnExecutor([&]() {
+      return DecodeCustomSamplingStreaming(
+          executor_, tokenizer_, stop_token_detector_,
+          session_config_.GetNumOutputCandidates(), *sampler_,
+          decoded_ids_buffer->Get(), decode_config.GetConstraint(),
+          benchmark_info_, std::move(callback), &cancelled_,
+          context_compactor_.get(), stop_sequences_.get(),
+          MaybeGetCandidatePruningOptions(decode_config),
+          shared_resources_.token_text_table, logits_processor->get(),
+          reasoning_budget->get(), session_config_.GetMaxNumTokens());
+    }));
   }
-  return absl::OkStatus();
+  RecordSamplingCost(host_sampling, start_num_tokens, start_time);
+  return MaybeStripReasoning(decode_config, reasoning_budget->get(),
+                             start_num_tokens);
+}
+
+absl::StatusOr<Responses> SessionBasic::DecodeBeamSearchInternal(
+    const DecodeConfig& decode_config) {
+  if (decode_config.GetConstraint() != nullptr) {
+    return absl::InvalidArgumentError(
+        "Beam search does not support constrained decoding.");
+  }
+  if (decode_config.GetLogitsProcessingOptions().has_value()) {
+    return absl::InvalidArgumentError(
+        "Beam search does not support logits processing.");
+  }
+  if (decode_config.GetReasoningBudgetOptions().has_value()) {
+    return absl::InvalidArgumentError(
+        "Beam search does not support the reasoning budget.");
+  }
+  const int beam_width = session_config_.GetNumOutputCandidates();
+  std::vector<int> decoded_ids(beam_width, last_prefill_token_id_);
+  LITERT_ASSIGN_OR_RETURN(
+      auto decoded_ids_buffer,
+      tensor_buffer_pool_.AcquireAndCopy<int>(decoded_ids, {beam_width, 1}));
+  // The beam search calls the executor directly, so it can not be batched
+  // with the other sessions.
+  absl::StatusOr<Responses> responses;
+  RETURN_IF_ERROR(RunOnExecutor([&]() {
+    responses = DecodeBeamSearch(
+        executor_, tokenizer_, *stop_sequences_, beam_width,
+        decoded_ids_buffer.Get(), benchmark_info_, &cancelled_,
+        &logits_staging_buffer_, session_config_.GetMaxNumTokens());
+    return absl::OkStatus();
+  }));
+  return responses;
 }
 
 absl::StatusOr<Responses> SessionBasic::RunDecode() {
@@ -476,16 +2111,19 @@ absl::StatusOr<Responses> SessionBasic::RunDecode() {
 absl::StatusOr<Responses> SessionBasic::RunDecode(
     const DecodeConfig& decode_config) {
   ABSL_LOG(INFO) << "RunDecodeSync";
+  RETURN_IF_ERROR(CheckCanDecode());
   if (cancelled_.load()) {
     // Reset the cancelled flag before processing the next turn.
     cancelled_ = false;
   }
   absl::StatusOr<Responses> responses;
-  RETURN_IF_ERROR(
-      worker_thread_pool_.Schedule([this, &responses, decode_config]() {
+  RETURN_IF_ERROR(RunTaskAndWait(
+      [this, &responses, decode_config]() {
+        const int start_num_tokens = StartDecodeTurn();
         responses = this->DecodeInternal(decode_config);
-      }));
-  RETURN_IF_ERROR(worker_thread_pool_.WaitUntilDone(Engine::kDefaultTimeout));
+        EndDecodeTurn(start_num_tokens, decode_config);
+      },
+      GetTaskPriority(decode_config)));
   return responses;
 }
 
@@ -498,19 +2136,34 @@ absl::Status SessionBasic::RunDecodeAsync(
     absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
     const DecodeConfig& decode_config) {
   ABSL_LOG(INFO) << "RunDecodeAsync";
+  RETURN_IF_ERROR(CheckCanDecode());
   if (cancelled_.load()) {
     // Reset the cancelled flag before processing the next turn.
     cancelled_ = false;
   }
-  return worker_thread_pool_.Schedule(
+  return ScheduleTask(
       [this, callback = std::move(callback), decode_config]() mutable {
+        const int start_num_tokens = StartDecodeTurn();
+        if (replay_recorder_ != nullptr) {
+          callback = [this, callback = std::move(callback)](
+                         absl::StatusOr<Responses> responses) mutable {
+            if (responses.ok() &&
+                responses->GetTaskState() == TaskState::kProcessing) {
+              replay_recorder_->RecordResponse();
+            }
+            callback(std::move(responses));
+          };
+        }
         this->DecodeInternalStreaming(std::move(callback), decode_config)
             .IgnoreError();
-      });
+        EndDecodeTurn(start_num_tokens, decode_config);
+      },
+      GetTaskPriority(decode_config));
 }
 
 absl::StatusOr<Responses> SessionBasic::GenerateContent(
     const std::vector<InputData>& contents) {
+  RETURN_IF_ERROR(CheckCanDecode());
   if (cancelled_.load()) {
     // Reset the cancelled flag before processing the next turn.
     cancelled_ = false;
@@ -521,32 +2174,98 @@ absl::StatusOr<Responses> SessionBasic::GenerateContent(
 
 absl::StatusOr<Responses> SessionBasic::RunTextScoring(
     const std::vector<absl::string_view>& target_text) {
-  // Currently batch scoring is not supported by the models.
-  if (target_text.size() != 1) {
+  // TODO(b/435040163): Handle the temperature. Should it be calculated from
+  // the sampler or the sampler parameters? For now, hardcode it to 1.0f for
+  // testing.
+  const float temperature = 1.0f;
+  ASSIGN_OR_RETURN(std::vector<Responses> responses,
+                   RunTextScoringWithTemperatures(
+                       target_text, absl::MakeConstSpan(&temperature, 1)));
+  return std::move(responses[0]);
+}
+
+absl::StatusOr<std::vector<Responses>>
+SessionBasic::RunTextScoringWithTemperatures(
+    const std::vector<absl::string_view>& target_text,
+    absl::Span<const float> temperatures) {
+  // Without the logits of every position, the targets are decoded as the
+  // candidates of the session.
+  const bool is_batched =
+      GetExecutorExtension<PrefillLogitsLlmExecutor>(executor_) != nullptr;
+  if (!is_batched && target_text.size() != 1) {
     return absl::InvalidArgumentError("Target text size should be 1.");
   }
+  if (target_text.empty()) {
+    return absl::InvalidArgumentError("Target text must not be empty.");
+  }
+  if (temperatures.empty()) {
+    return absl::InvalidArgumentError("Temperatures must not be empty.");
+  }
   std::vector<int> decoded_ids(session_config_.GetNumOutputCandidates(),
                                last_prefill_token_id_);
   // Remove the last token from the decoded ids, since the last prefill token
   // is used as the query during decoding of the model.
-  auto decoded_ids_buffer = CopyToTensorBuffer<int>(
-      decoded_ids, {session_config_.GetNumOutputCandidates(), 1});
-  // TODO(b/435040163): Handle the temperature. Should it be calculated from
-  // the sampler or the sampler parameters? For now, hardcode it to 1.0f for
-  // testing.
-  auto temperature = 1.0f;
-  absl::StatusOr<Responses> score;
+  LITERT_ASSIGN_OR_RETURN(
+      auto decoded_ids_buffer,
+      tensor_buffer_pool_.AcquireAndCopy<int>(
+          decoded_ids, {session_config_.GetNumOutputCandidates(), 1}));
+  absl::StatusOr<std::vector<Responses>> score;
   // Scheduled on the worker thread pool to ensure serialized execution with
   // other engine operations as the function waits for completion.
-  RETURN_IF_ERROR(worker_thread_pool_.Schedule(
-      [this, &score, &target_text, &decoded_ids_buffer, &temperature]() {
-        score = ScoreCustomSampling(executor_, tokenizer_, target_text,
-                                    temperature, *decoded_ids_buffer);
+  RETURN_IF_ERROR(RunTaskAndWait(
+      [this, &score, &target_text, &decoded_ids_buffer, temperatures,
+       is_batched]() {
+        // The batched scoring leaves the context unchanged.
+        if (!is_batched) {
+          DesyncSpeculativeDecoder("scoring");
+        }
+        auto status = RunOnExecutor([&]() {
+          score = ScoreCustomSampling(
+              executor_, tokenizer_, target_text, temperatures,
+              decoded_ids_buffer.Get(), &logits_staging_buffer_,
+              session_config_.GetMaxNumTokens());
+          return absl::OkStatus();
+        });
+        if (!status.ok()) {
+          score = status;
+        }
       }));
-  RETURN_IF_ERROR(worker_thread_pool_.WaitUntilDone(Engine::kDefaultTimeout));
   return score;
 }
 
+absl::StatusOr<std::vector<std::vector<float>>> SessionBasic::EmbedText(
+    const std::vector<absl::string_view>& texts, EmbeddingPooling pooling) {
+  auto* hidden_states_executor =
+      GetExecutorExtension<HiddenStatesLlmExecutor>(executor_);
+  if (hidden_states_executor == nullptr) {
+    return absl::UnimplementedError(
+        "The executor does not return hidden states.");
+  }
+  std::vector<std::vector<int>> token_ids;
+  token_ids.reserve(texts.size());
+  for (absl::string_view text : texts) {
+    ASSIGN_OR_RETURN(std::vector<int> text_token_ids,
+                     tokenizer_.TextToTokenIds(text));
+    token_ids.push_back(std::move(text_token_ids));
+  }
+  absl::StatusOr<std::vector<std::vector<float>>> embeddings;
+  // Scheduled on the worker thread pool to ensure serialized execution with
+  // other engine operations as the function waits for completion.
+  RETURN_IF_ERROR(RunTaskAndWait([this, &embeddings, &token_ids, pooling,
+                                  hidden_states_executor]() {
+    auto status = RunOnExecutor([&]() {
+      embeddings =
+          EmbedTokenSequences(*hidden_states_executor, token_ids, pooling,
+                              &logits_staging_buffer_);
+      return absl::OkStatus();
+    });
+    if (!status.ok()) {
+      embeddings = status;
+    }
+  }));
+  return embeddings;
+}
+
 absl::Status SessionBasic::GenerateContentStream(
     const std::vector<InputData>& contents,
     absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback) {
@@ -558,13 +2277,23 @@ absl::Status SessionBasic::GenerateContentStream(
     const std::vector<InputData>& contents,
     absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
     const DecodeConfig& decode_config) {
+  ASSIGN_OR_RETURN(auto contents_copy, CopyContents(contents));
+  return GenerateContentStream(std::move(contents_copy), std::move(callback),
+                               decode_config);
+}
+
+absl::Status SessionBasic::GenerateContentStream(
+    std::vector<InputData>&& contents,
+    absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
+    const DecodeConfig& decode_config) {
+  RETURN_IF_ERROR(CheckCanDecode());
   if (cancelled_.load()) {
     // Reset the cancelled flag before processing the next turn.
     cancelled_ = false;
   }
 
   RETURN_IF_ERROR(RunPrefillAsync(
-      contents,
+      std::move(contents),
       [this, callback = std::move(callback), decode_config = decode_config](
           absl::StatusOr<Responses> responses) mutable {
         if (!responses.ok()) {
@@ -577,12 +2306,19 @@ absl::Status SessionBasic::GenerateContentStream(
           }
           auto status = RunDecodeAsync(std::move(callback), decode_config);
         }
-      }));
+      },
+      GetTaskPriority(decode_config)));
   return absl::OkStatus();
 }
 
 absl::StatusOr<BenchmarkInfo> SessionBasic::GetBenchmarkInfo() {
   if (benchmark_info_.has_value()) {
+    if (auto* profiled_executor =
+            GetExecutorExtension<ProfiledLlmExecutor>(executor_);
+        profiled_executor != nullptr) {
+      benchmark_info_->SetExecutorInvocationStats(
+          profiled_executor->GetInvocationStats());
+    }
     return benchmark_info_.value();
   }
   return absl::InternalError(
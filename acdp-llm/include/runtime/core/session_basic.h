@@ -16,6 +16,8 @@
 #define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SESSION_BASIC_H_
 
 #include <atomic>
+#include <cstddef>
+#include <deque>
 #include <memory>
 #include <optional>
 #include <string>
@@ -28,9 +30,33 @@
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
 #include "runtime/components/sampler.h"
 #include "runtime/components/stop_token_detector.h"
 #include "runtime/components/tokenizer.h"
+#include "runtime/core/audio_stream_encoder.h"
+#include "runtime/core/context_compactor.h"
+#include "runtime/core/continuous_batching_scheduler.h"
+#include "runtime/core/decode_replay_recorder.h"
+#include "runtime/core/embedding_cache.h"
+#include "runtime/core/encoder_scheduler.h"
+#include "runtime/core/kv_cache_block_allocator.h"
+#include "runtime/core/lazy_executor.h"
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/core/logits_processor.h"
+#include "runtime/core/logits_staging_buffer.h"
+#include "runtime/core/lora_registry.h"
+#include "runtime/core/prefix_kv_cache.h"
+#include "runtime/core/prompt_lookup_proposer.h"
+#include "runtime/core/reasoning_budget.h"
+#include "runtime/core/resident_context_pool.h"
+#include "runtime/core/session_state_file.h"
+#include "runtime/core/shared_session_resources.h"
+#include "runtime/core/speculative_decoder.h"
+#include "runtime/core/stop_sequence_matcher.h"
+#include "runtime/core/token_id_cache.h"
 #include "runtime/engine/engine.h"
 #include "runtime/engine/engine_settings.h"
 #include "runtime/engine/io_types.h"
@@ -40,6 +66,7 @@
 #include "runtime/executor/vision_executor.h"
 #include "runtime/framework/threadpool.h"
 #include "runtime/proto/sampler_params.pb.h"
+#include "runtime/util/tensor_buffer_pool.h"
 
 namespace litert::lm {
 
@@ -57,12 +84,20 @@ class SessionBasic : public Engine::Session {
   // - sampler_params: The sampler parameters used for decoding. Note that if
   //   the sampler_params.type is TYPE_UNSPECIFIED, the sampling logic will be
   //   handled by the LLM Executor.
+  // - shared_resources: The optional engine-level resources. If a batching
+  //   scheduler is provided, the session acquires its own context slot of the
+  //   executor, and its decode steps are batched with the other sessions'.
+  //   Otherwise, if a resident context pool is provided, the session keeps
+  //   its own context of the executor while one is left.
+  //   If a draft executor is provided and both executors support it, the
+  //   unconstrained greedy decodes of the session use speculative decoding.
   static absl::StatusOr<std::unique_ptr<SessionBasic>> Create(
       LlmExecutor* absl_nonnull executor, Tokenizer* absl_nonnull tokenizer,
       VisionExecutor* vision_executor, AudioExecutor* audio_executor,
       const SessionConfig& session_config,
       std::optional<BenchmarkInfo> benchmark_info,
-      ThreadPool* absl_nonnull worker_thread_pool);
+      ThreadPool* absl_nonnull worker_thread_pool,
+      const SharedSessionResources& shared_resources = {});
 
   virtual ~SessionBasic();
 
@@ -75,6 +110,10 @@ class SessionBasic : public Engine::Session {
       const std::vector<InputData>& contents,
       absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
       const DecodeConfig& decode_config) override;
+  absl::Status GenerateContentStream(
+      std::vector<InputData>&& contents,
+      absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
+      const DecodeConfig& decode_config) override;
 
   // Scores the target text after the prefill process is done. This function
   // will only run the decode process to fetch the decode output logits, which
@@ -85,14 +124,33 @@ class SessionBasic : public Engine::Session {
   // - return: This function returns the score associated with the target
   // text after the model has been prefilled. The returned score is the sum of
   // the negative log probability of seeing the target text during decode.
+  // If the executor implements PrefillLogitsLlmExecutor, any number of target
+  // texts are scored against the prefilled context in a single invocation,
+  // and the model memory is left unchanged.
   absl::StatusOr<Responses> RunTextScoring(
       const std::vector<absl::string_view>& target_text) override;
 
+  // Scores with the logits of the same invocations for every temperature.
+  absl::StatusOr<std::vector<Responses>> RunTextScoringWithTemperatures(
+      const std::vector<absl::string_view>& target_text,
+      absl::Span<const float> temperatures) override;
+
+  // Requires an executor implementing HiddenStatesLlmExecutor.
+  absl::StatusOr<std::vector<std::vector<float>>> EmbedText(
+      const std::vector<absl::string_view>& texts,
+      EmbeddingPooling pooling) override;
+
+  // The contents are copied once. Pass them as rvalues to move the tensors
+  // through the preprocessing instead.
   absl::Status RunPrefill(const std::vector<InputData>& contents) override;
+  absl::Status RunPrefill(std::vector<InputData>&& contents) override;
 
   absl::Status RunPrefillAsync(
       const std::vector<InputData>& contents,
       absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback) override;
+  absl::Status RunPrefillAsync(
+      std::vector<InputData>&& contents,
+      absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback) override;
 
   absl::StatusOr<Responses> RunDecode() override;
 
@@ -108,11 +166,12 @@ class SessionBasic : public Engine::Session {
 
   absl::StatusOr<BenchmarkInfo> GetBenchmarkInfo() override;
 
-  // TODO(b/450903294): Add rollback history support for Session and
-  // Conversation.
   void CancelProcess() override {
     ABSL_LOG(INFO) << "SessionBasic::CancelProcess";
-    cancelled_.store(true);
+    if (!cancelled_.exchange(true) &&
+        shared_resources_.load_counters != nullptr) {
+      shared_resources_.load_counters->num_cancellations.fetch_add(1);
+    }
   }
 
   const SessionConfig& GetSessionConfig() const override {
@@ -121,29 +180,70 @@ class SessionBasic : public Engine::Session {
 
   const Tokenizer& GetTokenizer() const override { return tokenizer_; }
 
+  absl::StatusOr<std::vector<int>> TextToPrefillTokenIds(
+      absl::string_view text) override;
+
+  // Requires an executor supporting kv-cache snapshots. Restoring a
+  // checkpoint disables speculative decoding for the rest of the session.
+  absl::StatusOr<std::unique_ptr<SessionCheckpoint>> Checkpoint() override;
+  absl::Status Restore(const SessionCheckpoint& checkpoint) override;
+
+  // Additionally requires the executor to serialize its kv-cache snapshots.
+  // The file is laid out so that the executor can use the memory mapped
+  // kv-cache in place.
+  absl::Status SaveCheckpoint(const SessionCheckpoint& checkpoint,
+                              absl::string_view path) override;
+  absl::StatusOr<std::unique_ptr<SessionCheckpoint>> LoadCheckpoint(
+      absl::string_view path) override;
+  // The serialized checkpoint has the layout of the checkpoint files.
+  absl::StatusOr<std::string> SerializeCheckpoint(
+      const SessionCheckpoint& checkpoint) override;
+  absl::StatusOr<std::unique_ptr<SessionCheckpoint>> DeserializeCheckpoint(
+      std::string data) override;
+
+  // Additionally requires the engine to batch the sessions or to keep their
+  // contexts resident, so that each session owns a context of the executor.
+  // Otherwise the sessions share the single context of the executor, and
+  // Checkpoint() and Restore() must be used instead.
+  absl::StatusOr<std::unique_ptr<Session>> Fork() override;
+
+  // Copies the kv-cache device to device if the executor of `engine` can
+  // import the snapshots of this one, else through SerializeKvCache().
+  absl::StatusOr<std::unique_ptr<Session>> MigrateTo(
+      const Engine& engine) override;
+
+  // Requires an audio encoder. The chunks are encoded by the tasks of the
+  // session, and their embeddings kept by the engine-wide embedding cache if
+  // enabled, by a cache of the session otherwise.
+  absl::StatusOr<std::unique_ptr<AudioStream>> CreateAudioStream() override;
+
   // Util function for applying the prompt templates.
   // input: The input text to apply the prompt templates.
   // is_first_chunk: Whether the input is the first chunk of the turn.
   // is_last_chunk: Whether the input is the last chunk of the turn.
   // The output is the text input after applying the proper prompt templates.
+  // The non-text contents are moved to the output.
   // TODO - b/453312248: This is a temporary solution to add required templates
   // to the input. Should be removed once the prompt templates are properly
   // handled via the conversation layer.
   absl::StatusOr<std::vector<InputData>> ApplyPromptTemplates(
-      const std::vector<InputData>& contents);
+      std::vector<InputData> contents);
 
   // Preprocesses the input contents. This function is used for pre-processing
   // the input contents before sending them to the LLM executor.
-  // Text input will be preprocessed by the tokenizer.
+  // Text input will be preprocessed by the tokenizer, the already
+  // preprocessed tensors are moved to the output.
   absl::StatusOr<std::vector<InputData>> PreprocessContents(
-      const std::vector<InputData>& contents);
+      std::vector<InputData> contents);
 
   // Util function for creating the combined ExecutorInputs from the
-  // preprocessed contents.
+  // preprocessed contents. The images and the audios with an encoding in
+  // `scheduled_encodings` take it instead of being encoded here.
   // TODO - b/436674053: Modulize the preprocessing logic into a separate
   // preprocessor class.
   absl::StatusOr<ExecutorInputs> ProcessAndCombineContents(
-      const std::vector<InputData>& preprocessed_contents);
+      const std::vector<InputData>& preprocessed_contents,
+      ScheduledEncodings* scheduled_encodings = nullptr);
 
  private:
   explicit SessionBasic(LlmExecutor* absl_nonnull executor,
@@ -154,22 +254,235 @@ class SessionBasic : public Engine::Session {
                         const SessionConfig& session_config,
                         std::optional<BenchmarkInfo> benchmark_info,
                         ThreadPool* absl_nonnull worker_thread_pool,
-                        const StopTokenDetector& stop_token_detector)
+                        const StopTokenDetector& stop_token_detector,
+                        std::unique_ptr<KvCacheBlockTable>
+                            kv_cache_block_table,
+                        std::unique_ptr<ContinuousBatchingScheduler::Slot>
+                            batching_slot,
+                        std::unique_ptr<ResidentContextPool::Context>
+                            resident_context,
+                        std::unique_ptr<DraftModelProposer>
+                            draft_model_proposer,
+                        std::unique_ptr<SpeculativeDecoder>
+                            speculative_decoder,
+                        std::unique_ptr<ContextCompactor> context_compactor,
+                        std::unique_ptr<StopSequences> stop_sequences,
+                        std::shared_ptr<const LoraRegistry::Adapter>
+                            lora_adapter,
+                        const SharedSessionResources& shared_resources)
       : executor_(*executor),
         tokenizer_(*tokenizer),
         vision_executor_(vision_executor),
         audio_executor_(audio_executor),
+        lazy_vision_executor_(shared_resources.lazy_vision_executor),
+        lazy_audio_executor_(shared_resources.lazy_audio_executor),
         sampler_(std::move(sampler)),
         session_config_(session_config),
         benchmark_info_(benchmark_info),
         worker_thread_pool_(*worker_thread_pool),
-        stop_token_detector_(stop_token_detector) {}
+        stop_token_detector_(stop_token_detector),
+        kv_cache_block_table_(std::move(kv_cache_block_table)),
+        batching_slot_(std::move(batching_slot)),
+        resident_context_(std::move(resident_context)),
+        draft_model_proposer_(std::move(draft_model_proposer)),
+        speculative_decoder_(std::move(speculative_decoder)),
+        context_compactor_(std::move(context_compactor)),
+        stop_sequences_(std::move(stop_sequences)),
+        shared_resources_(shared_resources),
+        // The cached prefixes hold the kv-cache of the base model.
+        prefix_kv_cache_(lora_adapter == nullptr
+                             ? shared_resources.prefix_kv_cache
+                             : nullptr),
+        token_id_cache_(shared_resources.token_id_cache),
+        embedding_cache_(shared_resources.embedding_cache),
+        lora_executor_(shared_resources.lora_registry != nullptr
+                           ? GetExecutorExtension<LoraLlmExecutor>(*executor)
+                           : nullptr),
+        lora_adapter_(std::move(lora_adapter)) {
+    if (HasAudioExecutor() && embedding_cache_ == nullptr) {
+      // Never fails with a positive size.
+      audio_stream_cache_ =
+          *EmbeddingCache::Create(kAudioStreamCacheMaxSizeBytes);
+    }
+    if (shared_resources_.load_counters != nullptr) {
+      shared_resources_.load_counters->num_sessions.fetch_add(1);
+    }
+    if (shared_resources_.session_registry != nullptr) {
+      session_registry_id_ =
+          shared_resources_.session_registry->Add([this] { CancelProcess(); });
+    }
+  }
+
+  // The memory budget of the embeddings of the streamed audio when the
+  // engine has no embedding cache, about 10 minutes of audio.
+  static constexpr size_t kAudioStreamCacheMaxSizeBytes = 64 * 1024 * 1024;
+
+  // The priority of a task of the session among the tasks of the other
+  // sessions, the time before which it must start, and how long a
+  // synchronous call waits for it to complete.
+  struct TaskPriority {
+    int priority = 0;
+    absl::Time deadline = absl::InfiniteFuture();
+    absl::Duration timeout = Engine::kDefaultTimeout;
+  };
+
+  // Returns the priority of a prefill or decode request: the priority of the
+  // session unless `decode_config` overrides it, the earlier of the deadline
+  // of `decode_config` and the request timeout of the session, and the
+  // timeout of `decode_config`.
+  TaskPriority GetTaskPriority(const DecodeConfig& decode_config) const;
+
+  // Schedules the task on the worker thread pool, through the task scheduler
+  // of the engine if any. The tasks of the session always run one at a time
+  // and in the scheduling order, even if the pool runs the tasks of several
+  // sessions concurrently. A task still waiting at its deadline cancels the
+  // session, like CancelProcess(), before it runs. Without `priority`, the
+  // task runs with the priority of the session and no deadline.
+  absl::Status ScheduleTask(absl::AnyInvocable<void()> task);
+  absl::Status ScheduleTask(absl::AnyInvocable<void()> task,
+                            const TaskPriority& priority);
+
+  // Schedules the task and waits until it is done. Unlike waiting for the
+  // worker thread pool to be idle, this does not wait for the tasks of the
+  // other sessions sharing the pool. Past the timeout of `priority`, a task
+  // not started yet is dropped, and a running one is cancelled and waited
+  // for, since it may refer to the caller's stack, before returning a
+  // DeadlineExceeded error.
+  absl::Status RunTaskAndWait(absl::AnyInvocable<void()> task);
+  absl::Status RunTaskAndWait(absl::AnyInvocable<void()> task,
+                              const TaskPriority& priority);
+
+  // Schedules the job running the first queued task of the session, or all of
+  // them without a task scheduler.
+  absl::Status ScheduleNextTask() ABSL_EXCLUSIVE_LOCKS_REQUIRED(task_mutex_);
+
+  // Runs the queued tasks of the session until the queue is empty.
+  void RunPendingTasks();
+
+  // Runs the first queued task of the session, then schedules the next one
+  // with its own priority.
+  void RunNextTask(bool deadline_exceeded);
+
+  // Same as the public RunPrefillAsync(), with the priority of the request
+  // the prefill is part of.
+  absl::Status RunPrefillAsync(
+      std::vector<InputData>&& contents,
+      absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
+      const TaskPriority& priority);
+
+  // Runs `fn`, which calls the executor directly, with the executor targeting
+  // the context and the LoRA adapter of this session.
+  absl::Status RunOnExecutor(absl::AnyInvocable<absl::Status()> fn);
+
+  // Returns a FailedPrecondition error if the engine only prefills.
+  absl::Status CheckCanDecode() const;
+
+  // Makes the executor target the resident context of the session, or the
+  // default context the sessions without one share. OK without resident
+  // contexts.
+  absl::Status SelectResidentContext();
+
+  // Returns the number of tokens in the context of the session, 0 if the
+  // executor does not report it. Called from the tasks of the session.
+  int GetNumContextTokens();
+
+  // Starts a decode turn, returning the number of tokens in the context.
+  int StartDecodeTurn();
+
+  // Ends the decode turn started with `start_num_tokens` in the context:
+  // adds its decode steps to the load counters of the engine, and records it
+  // if the session records its workload.
+  void EndDecodeTurn(int start_num_tokens, const DecodeConfig& decode_config);
+
+  // Returns whether the next decode samples on the host with `sampler_`
+  // rather than inside the executor. When the session selects its sampler
+  // backend automatically, picks the faster of the two with the sampler
+  // backend selector of the engine, unless `logits_processor` needs the
+  // logits on the host, or the executor can not end the reasoning of
+  // `reasoning_budget`.
+  bool UseHostSampling(const LogitsProcessor* logits_processor,
+                       const ReasoningBudget* reasoning_budget) const;
+
+  // Drops the reasoning followed by `reasoning_budget` from the context if
+  // `decode_config` asks for it, the decode having started with
+  // `start_num_tokens` in the context.
+  absl::Status MaybeStripReasoning(const DecodeConfig& decode_config,
+                                   const ReasoningBudget* reasoning_budget,
+                                   int start_num_tokens);
+
+  // Reports to the sampler backend selector of the engine the cost of a decode
+  // which sampled on the host if `host_sampling`, and started at
+  // `start_time` with `start_num_tokens` in the context. Does nothing when the
+  // session does not select its sampler backend automatically.
+  void RecordSamplingCost(bool host_sampling, int start_num_tokens,
+                          absl::Time start_time);
+
+  // Marks the executor context as updated in a way the speculative decoder
+  // can not track, e.g. by multimodal prefills, non-speculative decodes or
+  // scoring. The decodes are not speculative until the next text prefill
+  // re-syncs the decoder.
+  void DesyncSpeculativeDecoder(absl::string_view reason);
+
+  // Tracks the tokens of a text prefill with the speculative decoder,
+  // restarting its sequence from them if it is out of sync.
+  absl::Status TrackPrefilledTokens(absl::Span<const int> token_ids);
+
+  // Selects the draft token proposer of the decode request: prompt lookup if
+  // requested by `decode_config`, otherwise the draft model of the engine.
+  // Returns whether the request is decoded speculatively; the other requests
+  // leave the speculative decoder out of sync.
+  absl::StatusOr<bool> MaybeSetDraftTokenProposer(
+      const DecodeConfig& decode_config);
+
+  // Restores the longest prefix of `token_ids` cached by an earlier session
+  // into the empty context of the executor and removes it from `inputs`.
+  // Returns the number of restored tokens, 0 if there is no cached prefix.
+  absl::StatusOr<int> MaybeRestoreCachedPrefix(
+      absl::Span<const int> token_ids, ExecutorInputs& inputs);
+
+  // Caches a snapshot of the context after the first prefill of the session,
+  // made of `token_ids` but the pending token, unless most of it was restored
+  // from the cache already.
+  void MaybeCachePrefix(absl::Span<const int> token_ids,
+                        int num_restored_tokens);
+
+  // Restores the checkpoint, on the worker thread.
+  absl::Status RestoreInternal(const SessionCheckpoint& checkpoint);
+
+  // Returns the state and the serialized kv-cache of `checkpoint`, taken by
+  // this session, in `state` and `kv_cache_data`.
+  absl::Status SerializeCheckpointParts(const SessionCheckpoint& checkpoint,
+                                        PersistedSessionState& state,
+                                        std::string& kv_cache_data);
+
+  // Creates a checkpoint of the state and the kv-cache held by `file`.
+  absl::StatusOr<std::unique_ptr<SessionCheckpoint>> CreateCheckpointFromFile(
+      std::unique_ptr<SessionStateFile> file);
+
+  // Prefills the text `inputs` in chunks of up to `chunk_size` tokens, each
+  // run as its own task on the executor, so that the decode steps of the
+  // other sessions can run in between.
+  absl::Status PrefillInChunks(ExecutorInputs& inputs, int chunk_size,
+                               bool wait_for_completion);
 
   // The internal function to prefill the input prompt. It is for convenience to
   // wrap it with lambda function for scheduling.
   absl::Status PrefillInternal(
       const std::vector<InputData>& preprocessed_contents,
-      bool wait_for_completion);
+      bool wait_for_completion, ScheduledEncodings scheduled_encodings = {});
+
+  // Schedules the encodings of the images and the audios of the preprocessed
+  // contents on the streams of the encoder scheduler of the engine, so that
+  // they run while the worker thread is busy with the tasks before the
+  // prefill. Empty without an encoder scheduler.
+  absl::StatusOr<ScheduledEncodings> ScheduleEncodings(
+      const std::vector<InputData>& preprocessed_contents);
+
+  // Returns an error if the preprocessed contents are known to exceed the
+  // prompt token budget of the engine, before their images and audios are
+  // encoded. OK without a budget.
+  absl::Status CheckPromptTokenBudget(
+      const std::vector<InputData>& preprocessed_contents) const;
 
   // The internal functions to decode the input prompt. It is for convenience to
   // wrap it with lambda function for scheduling.
@@ -177,12 +490,38 @@ class SessionBasic : public Engine::Session {
   absl::Status DecodeInternalStreaming(
       absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
       const DecodeConfig& decode_config);
+  // Decodes the output candidates as the beams of a beam search.
+  absl::StatusOr<Responses> DecodeBeamSearchInternal(
+      const DecodeConfig& decode_config);
 
   // The util function to convert the string to processed input text.
   absl::StatusOr<InputText> StringToProcessedInputText(absl::string_view text);
 
+  // Returns the vision or audio executor of the engine, created first if the
+  // engine creates it lazily. It stays alive as long as the returned pointer.
+  absl::StatusOr<std::shared_ptr<VisionExecutor>> GetVisionExecutor();
+  absl::StatusOr<std::shared_ptr<AudioExecutor>> GetAudioExecutor();
+  bool HasAudioExecutor() const {
+    return audio_executor_ != nullptr || lazy_audio_executor_ != nullptr;
+  }
+
+  // Encodes the preprocessed image or audio tensor, or returns the embeddings
+  // cached for the same input.
+  absl::StatusOr<ExecutorVisionData> EncodeImage(
+      const TensorBuffer& image_tensor);
+  absl::StatusOr<ExecutorAudioData> EncodeAudio(
+      const TensorBuffer& spectrogram_tensor);
+
+  // Runs the vision or audio executor on the tensor, one call at a time when
+  // the executor is shared by sessions on concurrent threads.
+  absl::StatusOr<ExecutorVisionData> RunVisionEncoder(
+      const TensorBuffer& image_tensor);
+  absl::StatusOr<ExecutorAudioData> RunAudioEncoder(
+      const TensorBuffer& spectrogram_tensor);
+
   // The util function to get the BOS string if there is a valid BOS token id.
-  // Otherwise, return an empty string.
+  // Otherwise, return an empty string. The string is detokenized once per
+  // session.
   absl::StatusOr<std::string> MaybeGetBosString();
 
   // The executor used for run the LLM for prefill/decode.
@@ -197,7 +536,14 @@ class SessionBasic : public Engine::Session {
   // The audio executor used for run the LLM for prefill/decode.
   AudioExecutor* audio_executor_;
 
-  // The session config used for the session.
+  // The vision and audio executors created on first use, used instead of the
+  // ones above when the engine creates them lazily.
+  LazyExecutor<VisionExecutor>* lazy_vision_executor_;
+  LazyExecutor<AudioExecutor>* lazy_audio_executor_;
+
+  // The CPU sampler of the session, nullptr when the executor samples the
+  // logits. Also set next to the sampler of the executor when the session
+  // selects its sampler backend automatically.
   std::unique_ptr<Sampler> sampler_;
 
   // The session config used for the session.
@@ -224,6 +570,104 @@ class SessionBasic : public Engine::Session {
 
   // An atomic boolean to indicate whether the session is cancelled.
   std::atomic<bool> cancelled_{false};
+
+  // The id of the session in the session registry of the engine, if any.
+  int session_registry_id_ = -1;
+
+  // The paged kv-cache blocks backing the context slot of the session.
+  // nullptr if the executor does not page its kv-cache. Declared before
+  // `batching_slot_` so that the blocks return to the pool after the slot
+  // is released.
+  std::unique_ptr<KvCacheBlockTable> kv_cache_block_table_;
+
+  // The context slot of the session when the engine batches the decode steps
+  // of concurrent sessions. nullptr otherwise.
+  std::unique_ptr<ContinuousBatchingScheduler::Slot> batching_slot_;
+
+  // The context the executor keeps resident for the session when the engine
+  // has resident contexts but no batching. nullptr otherwise, or if the
+  // session shares the default context.
+  std::unique_ptr<ResidentContextPool::Context> resident_context_;
+
+  // Proposes the draft tokens with the draft model of the engine. nullptr if
+  // the engine has no draft model usable by the session.
+  std::unique_ptr<DraftModelProposer> draft_model_proposer_;
+
+  // Proposes the draft tokens from the session context when the decode
+  // request asks for prompt lookup decoding.
+  std::unique_ptr<PromptLookupProposer> prompt_lookup_proposer_;
+
+  // Tracks the context of the main executor for speculative decoding. nullptr
+  // if the session does not use speculative decoding.
+  std::unique_ptr<SpeculativeDecoder> speculative_decoder_;
+  // Whether `speculative_decoder_` tracks all the tokens of the context.
+  bool speculative_decoder_in_sync_ = true;
+
+  // The sliding window keeping the context within the maximum number of
+  // tokens. nullptr if the session stops at the end of the context.
+  std::unique_ptr<ContextCompactor> context_compactor_;
+
+  // The stop token ids and stop strings of the session, matched in a single
+  // pass over the decoded tokens and text.
+  std::unique_ptr<StopSequences> stop_sequences_;
+
+  // Receives the logits downloaded for scoring, reused across the calls.
+  LogitsStagingBuffer logits_staging_buffer_;
+
+  // Recycles the per-turn input buffers of the custom sampling and scoring.
+  TensorBufferPool tensor_buffer_pool_;
+
+  // The engine-level resources the session was created with.
+  const SharedSessionResources shared_resources_;
+
+  // Records the workload of the session to be replayed. nullptr unless the
+  // session config sets a decode replay path.
+  std::unique_ptr<DecodeReplayRecorder> replay_recorder_;
+
+  // The engine-wide cache of prompt prefixes. nullptr if disabled.
+  PrefixKvCache* prefix_kv_cache_;
+
+  // The engine-wide cache of the token ids of the prefilled texts. nullptr if
+  // disabled.
+  TokenIdCache* token_id_cache_;
+
+  // The engine-wide cache of the vision and audio embeddings. nullptr if
+  // disabled.
+  EmbeddingCache* embedding_cache_;
+
+  // The embeddings of the audio streamed into the session, when the engine
+  // has no embedding cache. nullptr without an audio encoder.
+  std::unique_ptr<EmbeddingCache> audio_stream_cache_;
+
+  // The executor switching between the LoRA adapters of the engine, nullptr
+  // if the engine has none. The sessions without an adapter select the base
+  // model.
+  LoraLlmExecutor* lora_executor_;
+
+  // The LoRA adapter selected by the session config, kept loaded for the
+  // lifetime of the session. nullptr for the base model.
+  std::shared_ptr<const LoraRegistry::Adapter> lora_adapter_;
+
+  // The detokenized BOS token, set by the first MaybeGetBosString() call.
+  std::optional<std::string> bos_string_;
+
+  // Whether the executor context of the session holds any token.
+  bool has_prefilled_ = false;
+
+  // The tasks waiting for the previous task of the session to finish, see
+  // ScheduleTask().
+  struct PendingTask {
+    absl::AnyInvocable<void()> task;
+    TaskPriority priority;
+  };
+  absl::Mutex task_mutex_;
+  std::deque<PendingTask> pending_tasks_ ABSL_GUARDED_BY(task_mutex_);
+  bool task_running_ ABSL_GUARDED_BY(task_mutex_) = false;
+
+  // The encodings scheduled by the session that are not done yet, which the
+  // session waits for before it is destroyed.
+  absl::Mutex encodings_mutex_;
+  int num_pending_encodings_ ABSL_GUARDED_BY(encodings_mutex_) = 0;
 };
 
 }  // namespace litert::lm
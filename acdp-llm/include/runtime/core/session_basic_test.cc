@@ -41,6 +41,12 @@
 #include "runtime/components/constrained_decoding/fake_constraint.h"
 #include "runtime/components/sentencepiece_tokenizer.h"
 #include "runtime/components/tokenizer.h"
+#include "runtime/core/encoder_scheduler.h"
+#include "runtime/core/priority_task_scheduler.h"
+#include "runtime/core/prompt_token_budget.h"
+#include "runtime/core/sampler_backend_selector.h"
+#include "runtime/core/session_registry.h"
+#include "runtime/core/shared_session_resources.h"
 #include "runtime/engine/engine_settings.h"
 #include "runtime/engine/io_types.h"
 #include "runtime/executor/audio_executor_settings.h"
@@ -258,6 +264,107 @@ TEST_F(SessionBasicTest, RunPrefill) {
   EXPECT_OK((*session)->RunPrefill(inputs));
 }
 
+TEST_F(SessionBasicTest, RunPrefillOverPromptTokenBudgetIsRejected) {
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.GetMutableSamplerParams() = sampler_params_;
+  session_config.GetMutableStopTokenIds() = {{2294}};
+  session_config.SetStartTokenId(2);
+  session_config.SetSamplerBackend(Backend::CPU);
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CreateFakeLlmExecutor(
+          /*prefill_tokens=*/{{2, 90, 547, 58, 735, 210, 466, 2294}},
+          /*decode_tokens=*/{{224}, {2294}}));
+  // "Hello World!" is 8 tokens long, with the start token.
+  PromptTokenBudget prompt_token_budget(/*max_num_tokens=*/8);
+  SharedSessionResources shared_resources;
+  shared_resources.prompt_token_budget = &prompt_token_budget;
+  ASSERT_OK_AND_ASSIGN(
+      auto session,
+      SessionBasic::Create(executor.get(), tokenizer_.get(),
+                           /*vision_executor=*/nullptr,
+                           /*audio_executor=*/nullptr, session_config,
+                           std::nullopt, worker_thread_pool_.get(),
+                           shared_resources));
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText("Hello World!"));
+  EXPECT_THAT(session->RunPrefill(inputs),
+              testing::status::StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(SessionBasicTest, CheckpointRequiresKvCacheSnapshots) {
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.GetMutableSamplerParams() = sampler_params_;
+  session_config.GetMutableStopTokenIds() = {{2294}};
+  session_config.SetStartTokenId(2);
+  session_config.SetSamplerBackend(Backend::CPU);
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CreateFakeLlmExecutor(
+          /*prefill_tokens=*/{{2, 90, 547, 58, 735, 210, 466, 2294}},
+          /*decode_tokens=*/{{224}, {2294}}));
+  ASSERT_OK_AND_ASSIGN(
+      auto session,
+      SessionBasic::Create(executor.get(), tokenizer_.get(),
+                           /*vision_executor=*/nullptr,
+                           /*audio_executor=*/nullptr, session_config,
+                           std::nullopt, worker_thread_pool_.get()));
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText("Hello World!"));
+  EXPECT_OK(session->RunPrefill(inputs));
+
+  // The fake executor does not implement KvCacheSnapshotLlmExecutor.
+  EXPECT_THAT(session->Checkpoint(),
+              testing::status::StatusIs(absl::StatusCode::kUnimplemented));
+  EXPECT_THAT(session->LoadCheckpoint("/nonexistent/session.state"),
+              testing::status::StatusIs(absl::StatusCode::kUnimplemented));
+  // Without a batching scheduler, the sessions share a single context.
+  EXPECT_THAT(session->Fork(),
+              testing::status::StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST_F(SessionBasicTest, SlidingWindowRequiresContextEviction) {
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.GetMutableSamplerParams() = sampler_params_;
+  session_config.GetMutableStopTokenIds() = {{2294}};
+  session_config.SetStartTokenId(2);
+  session_config.SetSamplerBackend(Backend::CPU);
+  session_config.SetContextOverflowPolicy(
+      ContextOverflowPolicy::kSlidingWindow);
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CreateFakeLlmExecutor(
+          /*prefill_tokens=*/{{2, 90, 547, 58, 735, 210, 466, 2294}},
+          /*decode_tokens=*/{{224}, {2294}}));
+  // The fake executor does not implement ContextEvictionLlmExecutor.
+  EXPECT_THAT(
+      SessionBasic::Create(executor.get(), tokenizer_.get(),
+                           /*vision_executor=*/nullptr,
+                           /*audio_executor=*/nullptr, session_config,
+                           std::nullopt, worker_thread_pool_.get()),
+      testing::status::StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+TEST_F(SessionBasicTest, LoraAdapterRequiresLoraRegistry) {
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.GetMutableSamplerParams() = sampler_params_;
+  session_config.GetMutableStopTokenIds() = {{2294}};
+  session_config.SetStartTokenId(2);
+  session_config.SetSamplerBackend(Backend::CPU);
+  session_config.SetLoraAdapterId("tenant_a");
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CreateFakeLlmExecutor(
+          /*prefill_tokens=*/{{2, 90, 547, 58, 735, 210, 466, 2294}},
+          /*decode_tokens=*/{{224}, {2294}}));
+  EXPECT_THAT(
+      SessionBasic::Create(executor.get(), tokenizer_.get(),
+                           /*vision_executor=*/nullptr,
+                           /*audio_executor=*/nullptr, session_config,
+                           std::nullopt, worker_thread_pool_.get()),
+      testing::status::StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
 TEST_F(SessionBasicTest, RunDecode) {
   const std::vector<std::vector<int>> stop_token_ids = {{2294}};
   SessionConfig session_config = SessionConfig::CreateDefault();
@@ -289,6 +396,114 @@ TEST_F(SessionBasicTest, RunDecode) {
   EXPECT_EQ(responses->GetTexts()[0], " How's it going?");
 }
 
+TEST_F(SessionBasicTest, RunDecodePastDeadlineIsCancelled) {
+  const std::vector<std::vector<int>> stop_token_ids = {{2294}};
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.GetMutableSamplerParams() = sampler_params_;
+  session_config.GetMutableStopTokenIds() = stop_token_ids;
+  session_config.SetStartTokenId(2);
+  session_config.SetSamplerBackend(Backend::CPU);
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CreateFakeLlmExecutor(
+          // "Hello World!"
+          /*prefill_tokens=*/{{2, 90, 547, 58, 735, 210, 466, 2294}},
+          // "How's it going?"
+          /*decode_tokens=*/{
+              {224}, {24}, {8}, {66}, {246}, {18}, {2295}, {2294}}));
+  PriorityTaskScheduler task_scheduler(worker_thread_pool_.get());
+  SharedSessionResources shared_resources;
+  shared_resources.task_scheduler = &task_scheduler;
+  ASSERT_OK_AND_ASSIGN(
+      auto session,
+      SessionBasic::Create(executor.get(), tokenizer_.get(),
+                           /*vision_executor=*/nullptr,
+                           /*audio_executor=*/nullptr, session_config,
+                           std::nullopt, worker_thread_pool_.get(),
+                           shared_resources));
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText("Hello World!"));
+  EXPECT_OK(session->RunPrefill(inputs));
+
+  DecodeConfig decode_config = DecodeConfig::CreateDefault();
+  decode_config.SetDeadline(absl::Now() - absl::Seconds(1));
+  EXPECT_THAT(session->RunDecode(decode_config),
+              testing::status::StatusIs(absl::StatusCode::kCancelled));
+
+  // The next request runs again.
+  EXPECT_OK(session->RunDecode());
+  EXPECT_OK(worker_thread_pool_->WaitUntilDone(absl::Seconds(100)));
+}
+
+TEST_F(SessionBasicTest, DrainingRejectsNewRequests) {
+  const std::vector<std::vector<int>> stop_token_ids = {{2294}};
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.GetMutableSamplerParams() = sampler_params_;
+  session_config.GetMutableStopTokenIds() = stop_token_ids;
+  session_config.SetStartTokenId(2);
+  session_config.SetSamplerBackend(Backend::CPU);
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CreateFakeLlmExecutor(
+          // "Hello World!"
+          /*prefill_tokens=*/{{2, 90, 547, 58, 735, 210, 466, 2294}},
+          // "How's it going?"
+          /*decode_tokens=*/{
+              {224}, {24}, {8}, {66}, {246}, {18}, {2295}, {2294}}));
+  SessionRegistry session_registry;
+  SharedSessionResources shared_resources;
+  shared_resources.session_registry = &session_registry;
+  ASSERT_OK_AND_ASSIGN(
+      auto session,
+      SessionBasic::Create(executor.get(), tokenizer_.get(),
+                           /*vision_executor=*/nullptr,
+                           /*audio_executor=*/nullptr, session_config,
+                           std::nullopt, worker_thread_pool_.get(),
+                           shared_resources));
+  EXPECT_EQ(session_registry.GetNumSessions(), 1);
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText("Hello World!"));
+  EXPECT_OK(session->RunPrefill(inputs));
+
+  session_registry.StartDraining();
+  EXPECT_THAT(session->RunDecode(),
+              testing::status::StatusIs(absl::StatusCode::kUnavailable));
+  EXPECT_OK(worker_thread_pool_->WaitUntilDone(absl::Seconds(100)));
+  session.reset();
+  EXPECT_EQ(session_registry.GetNumSessions(), 0);
+}
+
+TEST_F(SessionBasicTest, RunDecodeWithStopString) {
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.GetMutableSamplerParams() = sampler_params_;
+  session_config.GetMutableStopTokenIds() = {{2294}};
+  // Spans the tokens " go" and "ing".
+  session_config.GetMutableStopStrings() = {"oing"};
+  session_config.SetStartTokenId(2);
+  session_config.SetSamplerBackend(Backend::CPU);
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CreateFakeLlmExecutor(
+          // "Hello World!"
+          /*prefill_tokens=*/{{2, 90, 547, 58, 735, 210, 466, 2294}},
+          // "How's it going?"
+          /*decode_tokens=*/{
+              {224}, {24}, {8}, {66}, {246}, {18}, {2295}, {2294}}));
+  ASSERT_OK_AND_ASSIGN(
+      auto session,
+      SessionBasic::Create(executor.get(), tokenizer_.get(),
+                           /*vision_executor=*/nullptr,
+                           /*audio_executor=*/nullptr, session_config,
+                           std::nullopt, worker_thread_pool_.get()));
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText("Hello World!"));
+  EXPECT_OK(session->RunPrefill(inputs));
+  ASSERT_OK_AND_ASSIGN(auto responses, session->RunDecode());
+  ASSERT_EQ(responses.GetTexts().size(), 1);
+  // The text is cut before the stop string.
+  EXPECT_EQ(responses.GetTexts()[0], " How's it g");
+}
+
 TEST_F(SessionBasicTest, RunDecodeWithMultipleOutputCandidates) {
   const std::vector<std::vector<int>> stop_token_ids = {{2294}};
   SessionConfig session_config = SessionConfig::CreateDefault();
@@ -374,6 +589,52 @@ TEST_F(SessionBasicTest, RunDecodeWithSamplerAndConstrainedDecoding) {
   EXPECT_EQ(responses.GetTexts()[0], " How's it");
 }
 
+TEST_F(SessionBasicTest, RunDecodeWithAutoSelectedSamplerBackend) {
+  const std::vector<std::vector<int>> stop_token_ids = {{2294}};
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.GetMutableSamplerParams() = sampler_params_;
+  session_config.GetMutableStopTokenIds() = stop_token_ids;
+  session_config.SetStartTokenId(2);
+  session_config.SetSamplerBackend(Backend::GPU);
+  session_config.SetAutoSelectSamplerBackend(true);
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CreateFakeLlmExecutor(
+          // "Hello World!"
+          /*prefill_tokens=*/{{2, 90, 547, 58, 735, 210, 466, 2294}},
+          // "How's it going?"
+          /*decode_tokens=*/{
+              {224}, {24}, {8}, {66}, {246}, {18}, {2295}, {2294}}));
+  SamplerBackendSelector sampler_backend_selector;
+  SharedSessionResources shared_resources;
+  shared_resources.sampler_backend_selector = &sampler_backend_selector;
+  ASSERT_OK_AND_ASSIGN(
+      auto session,
+      SessionBasic::Create(executor.get(), tokenizer_.get(),
+                           /*vision_executor=*/nullptr,
+                           /*audio_executor=*/nullptr, session_config,
+                           std::nullopt, worker_thread_pool_.get(),
+                           shared_resources));
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText("Hello World!"));
+  EXPECT_OK(session->RunPrefill(inputs));
+  ASSERT_OK_AND_ASSIGN(auto responses, session->RunDecode());
+  EXPECT_EQ(responses.GetTexts()[0], " How's it going?");
+
+  // The first decode measures the sampler of the executor, the next one the
+  // CPU sampler.
+  EXPECT_NE(sampler_backend_selector.GetTimePerStep(
+                /*num_output_candidates=*/1,
+                SamplerBackendSelector::Path::kExecutor),
+            std::nullopt);
+  EXPECT_EQ(sampler_backend_selector.GetTimePerStep(
+                /*num_output_candidates=*/1,
+                SamplerBackendSelector::Path::kHost),
+            std::nullopt);
+  EXPECT_EQ(sampler_backend_selector.Select(/*num_output_candidates=*/1),
+            SamplerBackendSelector::Path::kHost);
+}
+
 TEST_F(SessionBasicTest, RunDecodeWithConstrainedDecodingNoSampler) {
   // Fake constraint that expects " How's it".
   std::vector<int> expected_token_ids = {2, 224, 24, 8, 66, 0};
@@ -479,6 +740,158 @@ TEST_F(SessionBasicTest, RunDecodeAsync) {
   EXPECT_TRUE(done_decode);
 }
 
+TEST_F(SessionBasicTest, RunDecodeAsyncWithPipelinedCallbacks) {
+  const std::vector<std::vector<int>> stop_token_ids = {{2294}};
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.GetMutableSamplerParams() = sampler_params_;
+  session_config.SetStartTokenId(2);
+  session_config.GetMutableStopTokenIds() = stop_token_ids;
+  session_config.SetSamplerBackend(Backend::CPU);
+  session_config.SetPipelinedCallbacks(true);
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CreateFakeLlmExecutor(
+          // "Hello World!"
+          /*prefill_tokens=*/{{2, 90, 547, 58, 735, 210, 466, 2294}},
+          // "How's it going?"
+          /*decode_tokens=*/{
+              {224}, {24}, {8}, {66}, {246}, {18}, {2295}, {2294}}));
+  auto session = SessionBasic::Create(
+      executor.get(), tokenizer_.get(), /*vision_executor=*/nullptr,
+      /*audio_executor=*/nullptr, session_config, std::nullopt,
+      worker_thread_pool_.get());
+
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText("Hello World!"));
+  EXPECT_OK((*session)->RunPrefill(inputs));
+  absl::Status status;
+  std::vector<std::string> texts;
+  absl::Notification done_decode;
+  // The slow callback runs behind the decode loop, but still sees all the
+  // responses in order.
+  EXPECT_OK((*session)->RunDecodeAsync(CreateStreamingTestCallback(
+      status, texts, done_decode, /*delay_on_next=*/true)));
+  done_decode.WaitForNotification();
+  EXPECT_OK(status);
+  EXPECT_EQ(absl::StrJoin(texts, ""), " How's it going?");
+}
+
+TEST_F(SessionBasicTest, RunDecodeAsyncWithStreamingCoalescing) {
+  const std::vector<std::vector<int>> stop_token_ids = {{2294}};
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.GetMutableSamplerParams() = sampler_params_;
+  session_config.SetStartTokenId(2);
+  session_config.GetMutableStopTokenIds() = stop_token_ids;
+  session_config.SetSamplerBackend(Backend::CPU);
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CreateFakeLlmExecutor(
+          // "Hello World!"
+          /*prefill_tokens=*/{{2, 90, 547, 58, 735, 210, 466, 2294}},
+          // "How's it going?"
+          /*decode_tokens=*/{
+              {224}, {24}, {8}, {66}, {246}, {18}, {2295}, {2294}}));
+  auto session = SessionBasic::Create(
+      executor.get(), tokenizer_.get(), /*vision_executor=*/nullptr,
+      /*audio_executor=*/nullptr, session_config, std::nullopt,
+      worker_thread_pool_.get());
+
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText("Hello World!"));
+  EXPECT_OK((*session)->RunPrefill(inputs));
+  absl::Status status;
+  std::vector<std::string> texts;
+  absl::Notification done_decode;
+  auto decode_config = DecodeConfig::CreateDefault();
+  DecodeConfig::StreamingCoalescingOptions options;
+  options.max_num_steps = 100;
+  decode_config.SetStreamingCoalescingOptions(options);
+  EXPECT_OK((*session)->RunDecodeAsync(
+      CreateStreamingTestCallback(status, texts, done_decode), decode_config));
+  done_decode.WaitForNotification();
+  EXPECT_OK(status);
+  // The first text is delivered right away, the rest with the final
+  // response.
+  EXPECT_THAT(texts, testing::ElementsAre(" How", "'s it going?"));
+}
+
+TEST_F(SessionBasicTest, RunDecodeAsyncWithInvalidLogitsProcessingOptions) {
+  const std::vector<std::vector<int>> stop_token_ids = {{2294}};
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.GetMutableSamplerParams() = sampler_params_;
+  session_config.SetStartTokenId(2);
+  session_config.GetMutableStopTokenIds() = stop_token_ids;
+  session_config.SetSamplerBackend(Backend::CPU);
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CreateFakeLlmExecutor(
+          // "Hello World!"
+          /*prefill_tokens=*/{{2, 90, 547, 58, 735, 210, 466, 2294}},
+          // "How's it going?"
+          /*decode_tokens=*/{
+              {224}, {24}, {8}, {66}, {246}, {18}, {2295}, {2294}}));
+  auto session = SessionBasic::Create(
+      executor.get(), tokenizer_.get(), /*vision_executor=*/nullptr,
+      /*audio_executor=*/nullptr, session_config, std::nullopt,
+      worker_thread_pool_.get());
+
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText("Hello World!"));
+  EXPECT_OK((*session)->RunPrefill(inputs));
+  absl::Status status;
+  std::vector<std::string> texts;
+  absl::Notification done_decode;
+  auto decode_config = DecodeConfig::CreateDefault();
+  DecodeConfig::LogitsProcessingOptions options;
+  options.repetition_penalty = 0.0f;
+  decode_config.SetLogitsProcessingOptions(options);
+  EXPECT_OK((*session)->RunDecodeAsync(
+      CreateStreamingTestCallback(status, texts, done_decode), decode_config));
+  // The callback receives the error, rather than the caller waiting forever.
+  done_decode.WaitForNotification();
+  EXPECT_THAT(status,
+              testing::status::StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(texts, testing::IsEmpty());
+}
+
+TEST_F(SessionBasicTest, RunDecodeAsyncWithInvalidReasoningBudgetOptions) {
+  const std::vector<std::vector<int>> stop_token_ids = {{2294}};
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.GetMutableSamplerParams() = sampler_params_;
+  session_config.SetStartTokenId(2);
+  session_config.GetMutableStopTokenIds() = stop_token_ids;
+  session_config.SetSamplerBackend(Backend::CPU);
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CreateFakeLlmExecutor(
+          // "Hello World!"
+          /*prefill_tokens=*/{{2, 90, 547, 58, 735, 210, 466, 2294}},
+          // "How's it going?"
+          /*decode_tokens=*/{
+              {224}, {24}, {8}, {66}, {246}, {18}, {2295}, {2294}}));
+  auto session = SessionBasic::Create(
+      executor.get(), tokenizer_.get(), /*vision_executor=*/nullptr,
+      /*audio_executor=*/nullptr, session_config, std::nullopt,
+      worker_thread_pool_.get());
+
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText("Hello World!"));
+  EXPECT_OK((*session)->RunPrefill(inputs));
+  absl::Status status;
+  std::vector<std::string> texts;
+  absl::Notification done_decode;
+  auto decode_config = DecodeConfig::CreateDefault();
+  DecodeConfig::ReasoningBudgetOptions options;
+  options.max_num_reasoning_tokens = -1;
+  decode_config.SetReasoningBudgetOptions(options);
+  EXPECT_OK((*session)->RunDecodeAsync(
+      CreateStreamingTestCallback(status, texts, done_decode), decode_config));
+  done_decode.WaitForNotification();
+  EXPECT_THAT(status,
+              testing::status::StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(texts, testing::IsEmpty());
+}
+
 TEST_F(SessionBasicTest, RunDecodeAsyncWithSamplerAndConstrainedDecoding) {
   // Fake constraint that expects " How's it".
   std::vector<int> expected_token_ids = {2, 224, 24, 8, 66, 0};
@@ -823,7 +1236,7 @@ TEST_F(SessionBasicTest, ApplyPromptTemplatesFails) {
   std::vector<InputData> inputs_with_bos;
   inputs_with_bos.emplace_back(InputText("</s>Hello World!"));
   EXPECT_THAT(
-      session->ApplyPromptTemplates(inputs_with_bos),
+      session->ApplyPromptTemplates(std::move(inputs_with_bos)),
       testing::status::StatusIs(absl::StatusCode::kInvalidArgument,
                                 "Input contains bos control token. Control "
                                 "token should not be included in the input."));
@@ -833,7 +1246,7 @@ TEST_F(SessionBasicTest, ApplyPromptTemplatesFails) {
   // handled in ProcessAndCombineContents.
   std::vector<InputData> empty_inputs;
   ASSERT_OK_AND_ASSIGN(auto templated_empty,
-                       session->ApplyPromptTemplates(empty_inputs));
+                       session->ApplyPromptTemplates(std::move(empty_inputs)));
   EXPECT_TRUE(templated_empty.empty());
 }
 
@@ -869,7 +1282,7 @@ TEST_F(SessionBasicTest, ApplyPromptTemplatesWithSingleTextChunk) {
   std::vector<InputData> single_chunk;
   single_chunk.emplace_back(InputText("Hello World!"));
   ASSERT_OK_AND_ASSIGN(auto templated_single,
-                       session->ApplyPromptTemplates(single_chunk));
+                       session->ApplyPromptTemplates(std::move(single_chunk)));
   ASSERT_EQ(templated_single.size(), 1);
   EXPECT_THAT(std::get<InputText>(templated_single[0]).GetRawTextString(),
               testing::status::IsOkAndHolds(
@@ -909,7 +1322,7 @@ TEST_F(SessionBasicTest, ApplyPromptTemplatesDisabled) {
   std::vector<InputData> single_chunk;
   single_chunk.emplace_back(InputText("Hello World!"));
   ASSERT_OK_AND_ASSIGN(auto templated_single,
-                       session->ApplyPromptTemplates(single_chunk));
+                       session->ApplyPromptTemplates(std::move(single_chunk)));
   ASSERT_EQ(templated_single.size(), 2);
   EXPECT_THAT(std::get<InputText>(templated_single[0]).GetRawTextString(),
               testing::status::IsOkAndHolds("</s>"));
@@ -951,7 +1364,7 @@ TEST_F(SessionBasicTest, ApplyPromptTemplatesWithTwoTextChunks) {
   two_chunks.emplace_back(InputText("First"));
   two_chunks.emplace_back(InputText("Second"));
   ASSERT_OK_AND_ASSIGN(auto templated_two,
-                       session->ApplyPromptTemplates(two_chunks));
+                       session->ApplyPromptTemplates(std::move(two_chunks)));
   ASSERT_EQ(templated_two.size(), 2);
   EXPECT_THAT(std::get<InputText>(templated_two[0]).GetRawTextString(),
               testing::status::IsOkAndHolds("</s><test>User\nFirst"));
@@ -994,7 +1407,7 @@ TEST_F(SessionBasicTest, ApplyPromptTemplatesDisabledWithTwoTextChunks) {
   two_chunks.emplace_back(InputText("First"));
   two_chunks.emplace_back(InputText("Second"));
   ASSERT_OK_AND_ASSIGN(auto templated_two,
-                       session->ApplyPromptTemplates(two_chunks));
+                       session->ApplyPromptTemplates(std::move(two_chunks)));
   ASSERT_EQ(templated_two.size(), 3);
   EXPECT_THAT(std::get<InputText>(templated_two[0]).GetRawTextString(),
               testing::status::IsOkAndHolds("</s>"));
@@ -1038,7 +1451,7 @@ TEST_F(SessionBasicTest, ApplyPromptTemplatesWithThreeTextChunks) {
   three_chunks.emplace_back(InputText("Middle"));
   three_chunks.emplace_back(InputText("Last"));
   ASSERT_OK_AND_ASSIGN(auto templated_three,
-                       session->ApplyPromptTemplates(three_chunks));
+                       session->ApplyPromptTemplates(std::move(three_chunks)));
   ASSERT_EQ(templated_three.size(), 3);
   EXPECT_THAT(std::get<InputText>(templated_three[0]).GetRawTextString(),
               testing::status::IsOkAndHolds("</s><test>User\nFirst"));
@@ -1082,7 +1495,7 @@ TEST_F(SessionBasicTest, ApplyPromptTemplatesWithMixedChunksTextAndImage) {
   mixed_chunks.emplace_back(InputImage("123"));
   mixed_chunks.emplace_back(InputText("Text2"));
   ASSERT_OK_AND_ASSIGN(auto templated_mixed,
-                       session->ApplyPromptTemplates(mixed_chunks));
+                       session->ApplyPromptTemplates(std::move(mixed_chunks)));
   ASSERT_EQ(templated_mixed.size(), 3);
   EXPECT_THAT(std::get<InputText>(templated_mixed[0]).GetRawTextString(),
               testing::status::IsOkAndHolds("</s><test>User\nText1"));
@@ -1121,16 +1534,19 @@ TEST_F(SessionBasicTest, ApplyPromptTemplatesWithSubsequentTurn) {
                            /*vision_executor=*/nullptr,
                            /*audio_executor=*/nullptr, session_config,
                            std::nullopt, worker_thread_pool_.get()));
-  std::vector<InputData> single_chunk_again;
-  single_chunk_again.emplace_back(InputText("Another turn"));
+  std::vector<InputData> single_chunk;
+  single_chunk.emplace_back(InputText("Another turn"));
   ASSERT_OK_AND_ASSIGN(auto templated_first_turn,
-                       session->ApplyPromptTemplates(single_chunk_again));
+                       session->ApplyPromptTemplates(std::move(single_chunk)));
   ASSERT_EQ(templated_first_turn.size(), 1);
   EXPECT_THAT(std::get<InputText>(templated_first_turn[0]).GetRawTextString(),
               testing::status::IsOkAndHolds(
                   "</s><test>User\nAnother turn<end>\n<test>Model\n"));
-  ASSERT_OK_AND_ASSIGN(auto templated_again,
-                       session->ApplyPromptTemplates(single_chunk_again));
+  std::vector<InputData> single_chunk_again;
+  single_chunk_again.emplace_back(InputText("Another turn"));
+  ASSERT_OK_AND_ASSIGN(
+      auto templated_again,
+      session->ApplyPromptTemplates(std::move(single_chunk_again)));
   ASSERT_EQ(templated_again.size(), 1);
   EXPECT_THAT(std::get<InputText>(templated_again[0]).GetRawTextString(),
               testing::status::IsOkAndHolds(
@@ -1172,7 +1588,7 @@ TEST_F(SessionBasicTest, ApplyPromptTemplatesWithSingleImageInput) {
   std::vector<InputData> single_image;
   single_image.emplace_back(InputImage("456"));
   ASSERT_OK_AND_ASSIGN(auto templated_image,
-                       session->ApplyPromptTemplates(single_image));
+                       session->ApplyPromptTemplates(std::move(single_image)));
   ASSERT_EQ(templated_image.size(), 3);
   EXPECT_THAT(std::get<InputText>(templated_image[0]).GetRawTextString(),
               testing::status::IsOkAndHolds("</s><test>User\n"));
@@ -1202,7 +1618,7 @@ TEST_F(SessionBasicTest, PreprocessContents) {
   std::vector<InputData> contents;
   contents.emplace_back(InputText("</s>Hello World!"));
   ASSERT_OK_AND_ASSIGN(auto preprocessed_contents,
-                       session->PreprocessContents(contents));
+                       session->PreprocessContents(std::move(contents)));
   ASSERT_EQ(preprocessed_contents.size(), 1);
   ASSERT_TRUE(std::holds_alternative<InputText>(preprocessed_contents[0]));
   const auto& text_data = std::get<InputText>(preprocessed_contents[0]);
@@ -1456,6 +1872,67 @@ TEST_F(SessionBasicTest, ProcessAndCombineContentsTextAndAudioSuccess) {
   EXPECT_OK(session->RunPrefill(inputs));
 }
 
+TEST_F(SessionBasicTest, RunPrefillWithAudioEncodedOnEncoderStream) {
+  const std::vector<std::vector<int>> stop_token_ids = {{2294}};
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  session_config.SetStartTokenId(2);
+  session_config.SetSamplerBackend(Backend::CPU);
+  session_config.GetMutableSamplerParams() = sampler_params_;
+  session_config.GetMutableStopTokenIds() = stop_token_ids;
+  session_config.GetMutablePromptTemplates().mutable_user()->set_prefix(
+      "User:");
+  session_config.GetMutablePromptTemplates().mutable_user()->set_suffix(
+      "[END]");
+  session_config.GetMutablePromptTemplates().mutable_model()->set_prefix(
+      "Model:");
+  session_config.GetMutableLlmModelType().mutable_gemma3n();
+
+  LITERT_ASSERT_OK_AND_ASSIGN(
+      auto env, Environment::Create(std::vector<Environment::Option>()));
+  ASSERT_OK_AND_ASSIGN(
+      auto audio_executor,
+      CreateAudioExecutor(env,
+                          (std::filesystem::path(::testing::SrcDir()) /
+                           std::string(kTestAudioModelPath))
+                              .string(),
+                          /*max_sequence_length=*/0, Backend::CPU));
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CreateFakeLlmExecutor(
+          // "User:Hello World!<start_of_audio>[END]Model:"
+          /*prefill_tokens=*/{{2,    423,  8,   179, 29,  207,  19,
+                               547,  58,   735, 210, 466, 2294, 256000,
+                               -2,   -2,   -2,  -2,  -2,  -4,   433,
+                               2172, 1920, 432, 197, 979, 3076, 29}},
+          // "How's it going?"
+          /*decode_tokens=*/
+          {{224}, {24}, {8}, {66}, {246}, {18}, {2295}, {2294}},
+          /*audio_embedding=*/
+          std::vector<float>(kExpectedAudioEmbedding.begin(),
+                             kExpectedAudioEmbedding.end())));
+  EncoderScheduler encoder_scheduler({EncoderScheduler::Stream::kAudio});
+  SharedSessionResources shared_resources;
+  shared_resources.encoder_scheduler = &encoder_scheduler;
+  ASSERT_OK_AND_ASSIGN(
+      auto session, SessionBasic::Create(
+                        executor.get(), tokenizer_.get(),
+                        /*vision_executor=*/nullptr,
+                        /*audio_executor=*/audio_executor.get(), session_config,
+                        std::nullopt, worker_thread_pool_.get(),
+                        shared_resources));
+
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText("Hello World!<start_of_audio>"));
+  LITERT_ASSERT_OK_AND_ASSIGN(
+      TensorBuffer mel_spectrogram_data,
+      CopyToTensorBuffer<float>(
+          mel_spectrogram_data,
+          {1, kSpectrogramSequenceLength, kSpectrogramFrequencySlots}));
+  InputAudio input_audio(std::move(mel_spectrogram_data));
+  inputs.emplace_back(std::move(input_audio));
+  EXPECT_OK(session->RunPrefill(inputs));
+}
+
 TEST_F(SessionBasicTest, ProcessAndCombineContentsTextAudioTextSuccess) {
   const std::vector<std::vector<int>> stop_token_ids = {{2294}};
   SessionConfig session_config = SessionConfig::CreateDefault();
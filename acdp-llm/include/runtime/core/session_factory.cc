@@ -21,6 +21,7 @@
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "runtime/components/tokenizer.h"
 #include "runtime/core/session_basic.h"
+#include "runtime/core/shared_session_resources.h"
 #include "runtime/engine/engine.h"
 #include "runtime/engine/engine_settings.h"
 #include "runtime/engine/io_types.h"
@@ -38,10 +39,15 @@ absl::StatusOr<std::unique_ptr<Engine::Session>> InitializeSession(
     VisionExecutor* vision_executor, AudioExecutor* audio_executor,
     const SessionConfig& session_config,
     std::optional<BenchmarkInfo> benchmark_info,
-    ThreadPool* absl_nonnull worker_thread_pool) {
-  auto session =
-      SessionBasic::Create(executor, tokenizer, vision_executor, audio_executor,
-                           session_config, benchmark_info, worker_thread_pool);
+    ThreadPool* absl_nonnull worker_thread_pool,
+    const SharedSessionResources& shared_resources) {
+  if (benchmark_info.has_value() &&
+      session_config.GetBenchmarkParams().has_value()) {
+    benchmark_info->SetBenchmarkParams(*session_config.GetBenchmarkParams());
+  }
+  auto session = SessionBasic::Create(
+      executor, tokenizer, vision_executor, audio_executor, session_config,
+      benchmark_info, worker_thread_pool, shared_resources);
   return session;
 }
 
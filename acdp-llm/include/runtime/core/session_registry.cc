@@ -0,0 +1,53 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/session_registry.h"
+
+#include <utility>
+
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+int SessionRegistry::Add(absl::AnyInvocable<void()> cancel) {
+  absl::MutexLock lock(&mutex_);
+  if (draining_.load()) {
+    cancel();
+  }
+  const int id = next_id_++;
+  cancels_.emplace(id, std::move(cancel));
+  return id;
+}
+
+void SessionRegistry::Remove(int id) {
+  absl::MutexLock lock(&mutex_);
+  cancels_.erase(id);
+}
+
+void SessionRegistry::StartDraining() {
+  absl::MutexLock lock(&mutex_);
+  draining_.store(true);
+  // Under the lock, so that no session is destroyed while being cancelled.
+  for (auto& [id, cancel] : cancels_) {
+    cancel();
+  }
+}
+
+int SessionRegistry::GetNumSessions() const {
+  absl::MutexLock lock(&mutex_);
+  return cancels_.size();
+}
+
+}  // namespace litert::lm
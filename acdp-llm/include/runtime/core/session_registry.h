@@ -0,0 +1,67 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SESSION_REGISTRY_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SESSION_REGISTRY_H_
+
+#include <atomic>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// The live sessions of an engine, which the engine cancels when it drains,
+// e.g. before a rolling restart. Once draining, the engine admits neither new
+// sessions nor new tasks of the live ones.
+//
+// The class is thread-safe.
+//
+// Example usage:
+//   // In the session:
+//   const int id = registry->Add([this] { CancelProcess(); });
+//   ...
+//   registry->Remove(id);
+//   // In the engine:
+//   registry->StartDraining();
+class SessionRegistry {
+ public:
+  // Registers a session cancelled by `cancel`, and returns its id. A session
+  // registered while draining is cancelled right away.
+  int Add(absl::AnyInvocable<void()> cancel);
+
+  // Unregisters the session of `id`.
+  void Remove(int id);
+
+  // Stops admitting work and cancels the registered sessions. The running
+  // tasks stop at their next cancellation check.
+  void StartDraining();
+
+  bool IsDraining() const { return draining_.load(); }
+
+  int GetNumSessions() const;
+
+ private:
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<int, absl::AnyInvocable<void()>> cancels_
+      ABSL_GUARDED_BY(mutex_);
+  int next_id_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::atomic<bool> draining_ = false;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SESSION_REGISTRY_H_
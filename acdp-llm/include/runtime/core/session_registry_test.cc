@@ -0,0 +1,49 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/session_registry.h"
+
+#include <gtest/gtest.h>
+
+namespace litert::lm {
+namespace {
+
+TEST(SessionRegistryTest, DrainingCancelsTheRegisteredSessions) {
+  SessionRegistry registry;
+  int num_cancelled_first = 0;
+  int num_cancelled_second = 0;
+  const int first = registry.Add([&] { ++num_cancelled_first; });
+  const int second = registry.Add([&] { ++num_cancelled_second; });
+  EXPECT_NE(first, second);
+  EXPECT_EQ(registry.GetNumSessions(), 2);
+  EXPECT_FALSE(registry.IsDraining());
+
+  registry.Remove(second);
+  registry.StartDraining();
+  EXPECT_TRUE(registry.IsDraining());
+  EXPECT_EQ(num_cancelled_first, 1);
+  EXPECT_EQ(num_cancelled_second, 0);
+  EXPECT_EQ(registry.GetNumSessions(), 1);
+}
+
+TEST(SessionRegistryTest, SessionAddedWhileDrainingIsCancelled) {
+  SessionRegistry registry;
+  registry.StartDraining();
+  int num_cancelled = 0;
+  registry.Add([&] { ++num_cancelled; });
+  EXPECT_EQ(num_cancelled, 1);
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,232 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/session_state_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/util/memory_mapped_file.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+// The layout of the file, in host byte order:
+//   FileHeader
+//   SectionEntry[num_sections]
+//   the sections, each starting at a multiple of kSectionAlignment.
+// Readers skip the sections of unknown types.
+constexpr char kMagic[8] = {'L', 'L', 'M', 'S', 'T', 'A', 'T', 'E'};
+constexpr uint32_t kVersion = 1;
+
+enum SectionType : uint32_t {
+  kSessionStateSection = 1,
+  kKvCacheSection = 2,
+};
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_sections;
+};
+
+struct SectionEntry {
+  uint32_t type;
+  uint32_t reserved;
+  uint64_t offset;
+  uint64_t size;
+};
+
+struct SessionStateRecord {
+  int32_t last_prefill_token_id;
+  uint8_t is_first_turn;
+  uint8_t has_prefilled;
+  uint8_t reserved[2];
+};
+
+uint64_t AlignUp(uint64_t offset) {
+  constexpr uint64_t kAlignment = SessionStateFile::kSectionAlignment;
+  return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+}  // namespace
+
+// static
+void SessionStateFile::WriteTo(std::ostream& os,
+                               const PersistedSessionState& state,
+                               absl::string_view kv_cache_data) {
+  SessionStateRecord record = {};
+  record.last_prefill_token_id = state.last_prefill_token_id;
+  record.is_first_turn = state.is_first_turn;
+  record.has_prefilled = state.has_prefilled;
+  const absl::string_view sections[] = {
+      absl::string_view(reinterpret_cast<const char*>(&record),
+                        sizeof(record)),
+      kv_cache_data,
+  };
+  const SectionType section_types[] = {kSessionStateSection, kKvCacheSection};
+  constexpr int kNumSections = 2;
+
+  FileHeader header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.num_sections = kNumSections;
+  std::vector<SectionEntry> entries(kNumSections);
+  uint64_t offset = sizeof(FileHeader) + sizeof(SectionEntry) * kNumSections;
+  for (int i = 0; i < kNumSections; ++i) {
+    offset = AlignUp(offset);
+    entries[i] = {section_types[i], 0, offset, sections[i].size()};
+    offset += sections[i].size();
+  }
+
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  os.write(reinterpret_cast<const char*>(entries.data()),
+           sizeof(SectionEntry) * entries.size());
+  uint64_t written = sizeof(FileHeader) + sizeof(SectionEntry) * kNumSections;
+  for (int i = 0; i < kNumSections; ++i) {
+    const std::string padding(entries[i].offset - written, '\0');
+    os.write(padding.data(), padding.size());
+    os.write(sections[i].data(), sections[i].size());
+    written = entries[i].offset + entries[i].size;
+  }
+}
+
+// static
+absl::Status SessionStateFile::Write(absl::string_view path,
+                                     const PersistedSessionState& state,
+                                     absl::string_view kv_cache_data) {
+  std::ofstream file{std::string(path), std::ios::binary | std::ios::trunc};
+  if (!file) {
+    return absl::InternalError(absl::StrCat("Failed to open ", path));
+  }
+  WriteTo(file, state, kv_cache_data);
+  file.close();
+  if (!file) {
+    return absl::InternalError(absl::StrCat("Failed to write ", path));
+  }
+  return absl::OkStatus();
+}
+
+// static
+std::string SessionStateFile::Serialize(const PersistedSessionState& state,
+                                        absl::string_view kv_cache_data) {
+  std::ostringstream os;
+  WriteTo(os, state, kv_cache_data);
+  return std::move(os).str();
+}
+
+// static
+absl::StatusOr<std::unique_ptr<SessionStateFile>> SessionStateFile::Open(
+    absl::string_view path) {
+  ASSIGN_OR_RETURN(std::unique_ptr<MemoryMappedFile> file,
+                   MemoryMappedFile::Create(path));
+  return Create(std::move(file));
+}
+
+// static
+absl::StatusOr<std::unique_ptr<SessionStateFile>> SessionStateFile::Create(
+    std::unique_ptr<MemoryMappedFile> file) {
+  PersistedSessionState state;
+  absl::string_view kv_cache_data;
+  RETURN_IF_ERROR(ParseSections(
+      absl::string_view(static_cast<const char*>(file->data()),
+                        file->length()),
+      state, kv_cache_data));
+  return absl::WrapUnique(new SessionStateFile(std::move(file), std::string(),
+                                               state, kv_cache_data));
+}
+
+// static
+absl::StatusOr<std::unique_ptr<SessionStateFile>> SessionStateFile::Parse(
+    std::string data) {
+  auto file = absl::WrapUnique(new SessionStateFile(
+      /*file=*/nullptr, std::move(data), PersistedSessionState(),
+      absl::string_view()));
+  // The sections point into `data_`, which does not move from now on.
+  RETURN_IF_ERROR(
+      ParseSections(file->data_, file->state_, file->kv_cache_data_));
+  return file;
+}
+
+// static
+absl::Status SessionStateFile::ParseSections(
+    absl::string_view contents, PersistedSessionState& state,
+    absl::string_view& kv_cache_data) {
+  const char* data = contents.data();
+  const uint64_t length = contents.size();
+  FileHeader header;
+  if (length < sizeof(header)) {
+    return absl::InvalidArgumentError("Session state file is too short.");
+  }
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    return absl::InvalidArgumentError("Not a session state file.");
+  }
+  if (header.version != kVersion) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Unsupported session state file version: ", header.version));
+  }
+  if (header.num_sections >
+      (length - sizeof(header)) / sizeof(SectionEntry)) {
+    return absl::InvalidArgumentError("Session state file is truncated.");
+  }
+
+  bool has_state = false;
+  bool has_kv_cache_data = false;
+  for (uint32_t i = 0; i < header.num_sections; ++i) {
+    SectionEntry entry;
+    std::memcpy(&entry, data + sizeof(header) + i * sizeof(SectionEntry),
+                sizeof(entry));
+    if (entry.offset > length || entry.size > length - entry.offset) {
+      return absl::InvalidArgumentError("Session state file is truncated.");
+    }
+    const absl::string_view section(data + entry.offset, entry.size);
+    if (entry.type == kSessionStateSection) {
+      SessionStateRecord record;
+      if (section.size() != sizeof(record)) {
+        return absl::InvalidArgumentError("Malformed session state section.");
+      }
+      std::memcpy(&record, section.data(), sizeof(record));
+      state.last_prefill_token_id = record.last_prefill_token_id;
+      state.is_first_turn = record.is_first_turn != 0;
+      state.has_prefilled = record.has_prefilled != 0;
+      has_state = true;
+    } else if (entry.type == kKvCacheSection) {
+      kv_cache_data = section;
+      has_kv_cache_data = true;
+    }
+  }
+  if (!has_state || !has_kv_cache_data) {
+    return absl::InvalidArgumentError(
+        "Session state file misses a required section.");
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,110 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SESSION_STATE_FILE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SESSION_STATE_FILE_H_
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/util/memory_mapped_file.h"
+
+namespace litert::lm {
+
+// The state of a session besides its kv-cache, see SessionStateFile.
+struct PersistedSessionState {
+  int last_prefill_token_id = 0;
+  bool is_first_turn = true;
+  bool has_prefilled = false;
+};
+
+// A file holding the state of a session and the serialized kv-cache of its
+// executor, so that a later process can restore the session without
+// prefilling its context again. The same layout held in memory carries the
+// sessions between the engines of different hosts.
+//
+// Like the .litertlm files, the file starts with a header listing its
+// sections, and every section starts at a multiple of kSectionAlignment. The
+// kv-cache section can therefore be used in place once the file is memory
+// mapped, without copying it.
+class SessionStateFile {
+ public:
+  // Writes `state` and `kv_cache_data`, the kv-cache serialized by the
+  // executor, to `path`. Overwrites the file if it exists.
+  static absl::Status Write(absl::string_view path,
+                            const PersistedSessionState& state,
+                            absl::string_view kv_cache_data);
+
+  // Maps and parses the file at `path`.
+  static absl::StatusOr<std::unique_ptr<SessionStateFile>> Open(
+      absl::string_view path);
+
+  // Parses the contents of a file already in memory.
+  static absl::StatusOr<std::unique_ptr<SessionStateFile>> Create(
+      std::unique_ptr<MemoryMappedFile> file);
+
+  // Returns the contents of the file Write() would write.
+  static std::string Serialize(const PersistedSessionState& state,
+                               absl::string_view kv_cache_data);
+
+  // Parses the output of Serialize(), e.g. received from another host.
+  // Unlike a mapped file, the kv-cache section is not page aligned in memory.
+  static absl::StatusOr<std::unique_ptr<SessionStateFile>> Parse(
+      std::string data);
+
+  SessionStateFile(const SessionStateFile&) = delete;
+  SessionStateFile& operator=(const SessionStateFile&) = delete;
+
+  const PersistedSessionState& GetState() const { return state_; }
+
+  // Returns the serialized kv-cache. The data stays valid for the lifetime of
+  // this object.
+  absl::string_view GetKvCacheData() const { return kv_cache_data_; }
+
+  static constexpr size_t kSectionAlignment = 4096;
+
+ private:
+  SessionStateFile(std::unique_ptr<MemoryMappedFile> file, std::string data,
+                   PersistedSessionState state,
+                   absl::string_view kv_cache_data)
+      : file_(std::move(file)),
+        data_(std::move(data)),
+        state_(state),
+        kv_cache_data_(kv_cache_data) {}
+
+  // Writes the contents of the file to `os`.
+  static void WriteTo(std::ostream& os, const PersistedSessionState& state,
+                      absl::string_view kv_cache_data);
+
+  // Parses `data` into `state` and `kv_cache_data`, which points into it.
+  static absl::Status ParseSections(absl::string_view data,
+                                    PersistedSessionState& state,
+                                    absl::string_view& kv_cache_data);
+
+  // The contents, either mapped or held in memory.
+  std::unique_ptr<MemoryMappedFile> file_;
+  std::string data_;
+  PersistedSessionState state_;
+  absl::string_view kv_cache_data_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SESSION_STATE_FILE_H_
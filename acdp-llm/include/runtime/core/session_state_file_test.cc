@@ -0,0 +1,118 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/session_state_file.h"
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "runtime/util/memory_mapped_file.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::StatusIs;
+
+std::string ReadFile(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+TEST(SessionStateFileTest, WriteAndOpen) {
+  auto path = std::filesystem::path(::testing::TempDir()) / "session.state";
+  PersistedSessionState state;
+  state.last_prefill_token_id = 42;
+  state.is_first_turn = false;
+  state.has_prefilled = true;
+  EXPECT_OK(SessionStateFile::Write(path.string(), state, "kv-cache data"));
+
+  ASSERT_OK_AND_ASSIGN(auto file, SessionStateFile::Open(path.string()));
+  EXPECT_EQ(file->GetState().last_prefill_token_id, 42);
+  EXPECT_FALSE(file->GetState().is_first_turn);
+  EXPECT_TRUE(file->GetState().has_prefilled);
+  EXPECT_EQ(file->GetKvCacheData(), "kv-cache data");
+}
+
+TEST(SessionStateFileTest, KvCacheDataIsAligned) {
+  auto path = std::filesystem::path(::testing::TempDir()) / "session.state";
+  EXPECT_OK(SessionStateFile::Write(path.string(), PersistedSessionState(),
+                                    std::string(10000, 'x')));
+
+  ASSERT_OK_AND_ASSIGN(auto file, SessionStateFile::Open(path.string()));
+  EXPECT_EQ(file->GetKvCacheData(), std::string(10000, 'x'));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(file->GetKvCacheData().data()) %
+                SessionStateFile::kSectionAlignment,
+            0);
+}
+
+TEST(SessionStateFileTest, EmptyKvCacheData) {
+  auto path = std::filesystem::path(::testing::TempDir()) / "session.state";
+  EXPECT_OK(SessionStateFile::Write(path.string(), PersistedSessionState(),
+                                    ""));
+
+  ASSERT_OK_AND_ASSIGN(auto file, SessionStateFile::Open(path.string()));
+  EXPECT_TRUE(file->GetState().is_first_turn);
+  EXPECT_TRUE(file->GetKvCacheData().empty());
+}
+
+TEST(SessionStateFileTest, SerializeMatchesTheWrittenFile) {
+  auto path = std::filesystem::path(::testing::TempDir()) / "session.state";
+  PersistedSessionState state;
+  state.last_prefill_token_id = 7;
+  state.has_prefilled = true;
+  EXPECT_OK(SessionStateFile::Write(path.string(), state, "kv-cache data"));
+  std::string data = SessionStateFile::Serialize(state, "kv-cache data");
+  EXPECT_EQ(data, ReadFile(path));
+
+  ASSERT_OK_AND_ASSIGN(auto file, SessionStateFile::Parse(std::move(data)));
+  EXPECT_EQ(file->GetState().last_prefill_token_id, 7);
+  EXPECT_TRUE(file->GetState().is_first_turn);
+  EXPECT_TRUE(file->GetState().has_prefilled);
+  EXPECT_EQ(file->GetKvCacheData(), "kv-cache data");
+  EXPECT_THAT(SessionStateFile::Parse("not a session state file"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(SessionStateFileTest, RejectsOtherFiles) {
+  ASSERT_OK_AND_ASSIGN(auto file,
+                       InMemoryFile::Create("not a session state file"));
+  EXPECT_THAT(SessionStateFile::Create(std::move(file)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(SessionStateFileTest, RejectsTruncatedFiles) {
+  auto path = std::filesystem::path(::testing::TempDir()) / "session.state";
+  EXPECT_OK(SessionStateFile::Write(path.string(), PersistedSessionState(),
+                                    "kv-cache data"));
+  std::string contents = ReadFile(path);
+  contents.resize(contents.size() - 1);
+
+  ASSERT_OK_AND_ASSIGN(auto file, InMemoryFile::Create(contents));
+  EXPECT_THAT(SessionStateFile::Create(std::move(file)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace litert::lm
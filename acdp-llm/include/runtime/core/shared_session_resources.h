@@ -0,0 +1,130 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SHARED_SESSION_RESOURCES_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SHARED_SESSION_RESOURCES_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/core/continuous_batching_scheduler.h"
+#include "runtime/core/embedding_cache.h"
+#include "runtime/core/encoder_scheduler.h"
+#include "runtime/core/kv_cache_block_allocator.h"
+#include "runtime/core/lazy_executor.h"
+#include "runtime/core/lora_registry.h"
+#include "runtime/core/prefix_kv_cache.h"
+#include "runtime/core/priority_task_scheduler.h"
+#include "runtime/core/prompt_token_budget.h"
+#include "runtime/core/resident_context_pool.h"
+#include "runtime/core/sampler_backend_selector.h"
+#include "runtime/core/session_registry.h"
+#include "runtime/core/token_id_cache.h"
+#include "runtime/core/token_text_table.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/executor/audio_executor.h"
+#include "runtime/executor/llm_executor.h"
+#include "runtime/executor/vision_executor.h"
+#include "runtime/framework/threadpool.h"
+
+namespace litert::lm {
+
+// The load of the sessions of an engine, maintained by the sessions and
+// reported by Engine::GetLoad() and Engine::GetMetrics().
+struct SessionLoadCounters {
+  // The number of sessions alive.
+  std::atomic<int> num_sessions = 0;
+  // The number of tasks scheduled by the sessions and not done yet, including
+  // the running ones.
+  std::atomic<int> num_queued_tasks = 0;
+  // The number of tokens prefilled, not counting the prefixes restored from
+  // the prefix cache.
+  std::atomic<int64_t> num_prefilled_tokens = 0;
+  // The number of decode steps, each decoding one token per output candidate.
+  std::atomic<int64_t> num_decode_steps = 0;
+  // The number of turns cancelled, by the caller, a deadline or the engine
+  // draining.
+  std::atomic<int64_t> num_cancellations = 0;
+};
+
+// Engine-owned resources shared by all the sessions created from the same
+// engine. Every pointer is optional (nullptr when the corresponding feature is
+// not enabled), not owned, and must outlive the sessions.
+struct SharedSessionResources {
+  // Merges the decode steps of the concurrently running sessions into batched
+  // executor calls. When set, every session acquires its own context slot.
+  ContinuousBatchingScheduler* batching_scheduler = nullptr;
+  // The contexts the main executor keeps resident without batching, one per
+  // session while they last. Never set along with the batching scheduler.
+  ResidentContextPool* resident_context_pool = nullptr;
+  // The draft model used for speculative decoding. Like the main executor
+  // without a batching scheduler, it holds the context of a single session at
+  // a time.
+  LlmExecutor* draft_executor = nullptr;
+  // The kv-cache snapshots of the prompt prefixes prefilled by earlier
+  // sessions, which the first prefill of a session restores when it starts
+  // with one of them.
+  PrefixKvCache* prefix_kv_cache = nullptr;
+  // The blocks of the paged kv-cache of the executor. When set together with
+  // the batching scheduler, every session backs its context slot with blocks
+  // taken on demand.
+  KvCacheBlockAllocator* kv_cache_block_allocator = nullptr;
+  // The token ids of the texts prefilled by earlier turns, which the sessions
+  // reuse for the repeated prompt templates and instructions.
+  TokenIdCache* token_id_cache = nullptr;
+  // The texts of the tokens of the tokenizer, which the decode loops look up
+  // instead of decoding every generated token with the tokenizer.
+  const TokenTextTable* token_text_table = nullptr;
+  // The vision and audio embeddings of the inputs encoded by earlier turns.
+  EmbeddingCache* embedding_cache = nullptr;
+  // Runs the vision and audio encodings of the sessions on threads of their
+  // own, concurrently with the main executor, for the encoders placed on
+  // another backend.
+  EncoderScheduler* encoder_scheduler = nullptr;
+  // Encodes the audio of the turns mixing images and audio, while the session
+  // encodes the images, for the audio encoder without a scheduler stream.
+  ThreadPool* audio_encoding_thread_pool = nullptr;
+  // Serialize the calls to the vision and audio executors, which are not
+  // thread-safe, when the sessions encode their inputs from concurrent
+  // threads, i.e. with the batching scheduler.
+  absl::Mutex* vision_encoder_mutex = nullptr;
+  absl::Mutex* audio_encoder_mutex = nullptr;
+  // Rejects the prompts too long for the context of the executor before
+  // their images and audios are encoded.
+  PromptTokenBudget* prompt_token_budget = nullptr;
+  // The vision and audio executors created on their first use, instead of
+  // the ones passed to the sessions, when the engine creates them lazily.
+  LazyExecutor<VisionExecutor>* lazy_vision_executor = nullptr;
+  LazyExecutor<AudioExecutor>* lazy_audio_executor = nullptr;
+  // The LoRA adapters the sessions select with SessionConfig, loaded in the
+  // main executor next to the base model.
+  LoraRegistry* lora_registry = nullptr;
+  // Orders the tasks of the sessions on the worker thread pool by priority.
+  // When not set, the sessions schedule their tasks on the pool directly.
+  PriorityTaskScheduler* task_scheduler = nullptr;
+  // Picks the sampler of the decodes of the sessions selecting their sampler
+  // backend automatically, from the costs they report to it.
+  SamplerBackendSelector* sampler_backend_selector = nullptr;
+  // The counters the sessions report their load to.
+  SessionLoadCounters* load_counters = nullptr;
+  // The live sessions, which the engine cancels when it drains.
+  SessionRegistry* session_registry = nullptr;
+  // The phases of the requests the sessions serve.
+  EngineRole engine_role = EngineRole::kPrefillAndDecode;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SHARED_SESSION_RESOURCES_H_
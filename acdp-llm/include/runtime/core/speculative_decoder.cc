@@ -0,0 +1,194 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/speculative_decoder.h"
+
+#include <memory>
+#include <vector>
+
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+
+DraftModelProposer::~DraftModelProposer() {
+  if (num_fed_tokens_ > 0) {
+    auto status = draft_executor_.RollbackTokens(num_fed_tokens_);
+    if (!status.ok()) {
+      ABSL_LOG(ERROR) << "Failed to reset the draft executor: " << status;
+    }
+  }
+}
+
+absl::StatusOr<std::vector<int>> DraftModelProposer::ProposeTokens(
+    absl::Span<const int> sequence, int max_num_tokens) {
+  std::vector<int> draft_tokens;
+  if (sequence.empty() || max_num_tokens <= 0) {
+    return draft_tokens;
+  }
+  // At least one token must be fed to get a prediction.
+  if (num_fed_tokens_ >= sequence.size()) {
+    RETURN_IF_ERROR(OnSequenceTruncated(sequence.size() - 1));
+  }
+  draft_tokens.reserve(max_num_tokens);
+  // Catch up with the sequence, which yields the first proposal, then propose
+  // the remaining tokens one by one.
+  ASSIGN_OR_RETURN(
+      std::vector<int> predictions,
+      draft_executor_.PredictNextTokens(sequence.subspan(num_fed_tokens_)));
+  num_fed_tokens_ = sequence.size();
+  draft_tokens.push_back(predictions.back());
+  for (int i = 1; i < max_num_tokens; ++i) {
+    const int previous_token = draft_tokens.back();
+    ASSIGN_OR_RETURN(predictions, draft_executor_.PredictNextTokens(
+                                      absl::MakeConstSpan(&previous_token, 1)));
+    ++num_fed_tokens_;
+    draft_tokens.push_back(predictions.back());
+  }
+  return draft_tokens;
+}
+
+absl::Status DraftModelProposer::OnSequenceTruncated(int length) {
+  if (num_fed_tokens_ > length) {
+    RETURN_IF_ERROR(draft_executor_.RollbackTokens(num_fed_tokens_ - length));
+    num_fed_tokens_ = length;
+  }
+  return absl::OkStatus();
+}
+
+// static
+absl::StatusOr<std::unique_ptr<SpeculativeDecoder>> SpeculativeDecoder::Create(
+    SpeculativeLlmExecutor* main_executor) {
+  if (main_executor == nullptr) {
+    return absl::InvalidArgumentError("The main executor must not be null.");
+  }
+  return absl::WrapUnique(new SpeculativeDecoder(main_executor));
+}
+
+absl::Status SpeculativeDecoder::SetDraftTokenProposer(
+    DraftTokenProposer* proposer, int max_num_draft_tokens) {
+  if (max_num_draft_tokens <= 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "max_num_draft_tokens must be positive, got ", max_num_draft_tokens));
+  }
+  proposer_ = proposer;
+  max_num_draft_tokens_ = max_num_draft_tokens;
+  last_step_size_ = 0;
+  return absl::OkStatus();
+}
+
+void SpeculativeDecoder::AppendPrefilledTokens(
+    absl::Span<const int> token_ids) {
+  if (token_ids.empty()) {
+    return;
+  }
+  sequence_.insert(sequence_.end(), token_ids.begin(), token_ids.end());
+  main_length_ = sequence_.size() - 1;
+  last_step_size_ = 0;
+}
+
+void SpeculativeDecoder::ResetSequence(absl::Span<const int> token_ids) {
+  sequence_.clear();
+  main_length_ = 0;
+  last_step_size_ = 0;
+  AppendPrefilledTokens(token_ids);
+}
+
+absl::StatusOr<std::vector<int>> SpeculativeDecoder::Step() {
+  if (proposer_ == nullptr) {
+    return absl::FailedPreconditionError("No draft token proposer is set.");
+  }
+  if (sequence_.empty()) {
+    return absl::FailedPreconditionError(
+        "Speculative decoding requires at least one prefilled token.");
+  }
+  const int base = sequence_.size();
+  ASSIGN_OR_RETURN(std::vector<int> draft_tokens,
+                   proposer_->ProposeTokens(sequence_, max_num_draft_tokens_));
+  if (draft_tokens.size() > max_num_draft_tokens_) {
+    draft_tokens.resize(max_num_draft_tokens_);
+  }
+  const int num_draft_tokens = draft_tokens.size();
+
+  // Verify the proposal with a single invocation of the main model, feeding
+  // the pending token followed by the proposed ones.
+  std::vector<int> verify_tokens;
+  verify_tokens.reserve(num_draft_tokens + 1);
+  verify_tokens.push_back(sequence_.back());
+  verify_tokens.insert(verify_tokens.end(), draft_tokens.begin(),
+                       draft_tokens.end());
+  ASSIGN_OR_RETURN(std::vector<int> main_predictions,
+                   main_executor_.PredictNextTokens(verify_tokens));
+  if (main_predictions.size() != verify_tokens.size()) {
+    return absl::InternalError(absl::StrCat(
+        "Expected ", verify_tokens.size(), " predictions from the main model, "
+        "got ", main_predictions.size()));
+  }
+  int num_accepted = 0;
+  while (num_accepted < num_draft_tokens &&
+         draft_tokens[num_accepted] == main_predictions[num_accepted]) {
+    ++num_accepted;
+  }
+  sequence_.insert(sequence_.end(), draft_tokens.begin(),
+                   draft_tokens.begin() + num_accepted);
+  sequence_.push_back(main_predictions[num_accepted]);
+
+  // The main executor attended to all the proposed tokens. Drop the rejected
+  // ones.
+  main_length_ = base + num_draft_tokens;
+  RETURN_IF_ERROR(TruncateMainContext(base + num_accepted));
+  RETURN_IF_ERROR(proposer_->OnSequenceTruncated(base + num_accepted));
+
+  ++stats_.num_steps;
+  stats_.num_draft_tokens += num_draft_tokens;
+  stats_.num_accepted_draft_tokens += num_accepted;
+  last_step_size_ = num_accepted + 1;
+  return std::vector<int>(sequence_.end() - last_step_size_, sequence_.end());
+}
+
+absl::Status SpeculativeDecoder::DiscardAfter(int num_kept_tokens) {
+  if (num_kept_tokens <= 0 || num_kept_tokens > last_step_size_) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("num_kept_tokens must be in [1, ", last_step_size_,
+                     "], got ", num_kept_tokens));
+  }
+  const int length = sequence_.size() - last_step_size_ + num_kept_tokens;
+  RETURN_IF_ERROR(TruncateMainContext(length - 1));
+  if (proposer_ != nullptr) {
+    RETURN_IF_ERROR(proposer_->OnSequenceTruncated(length));
+  }
+  sequence_.resize(length);
+  last_step_size_ = num_kept_tokens;
+  return absl::OkStatus();
+}
+
+int SpeculativeDecoder::GetPendingTokenId() const {
+  return sequence_.empty() ? -1 : sequence_.back();
+}
+
+absl::Status SpeculativeDecoder::TruncateMainContext(int length) {
+  if (main_length_ > length) {
+    RETURN_IF_ERROR(main_executor_.RollbackTokens(main_length_ - length));
+    main_length_ = length;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,179 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SPECULATIVE_DECODER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SPECULATIVE_DECODER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/base/nullability.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+
+namespace litert::lm {
+
+// Proposes the draft tokens verified by the SpeculativeDecoder.
+class DraftTokenProposer {
+ public:
+  virtual ~DraftTokenProposer() = default;
+
+  // Proposes up to `max_num_tokens` tokens expected to follow `sequence`, the
+  // token sequence of the main executor with its pending token last. May
+  // propose fewer tokens, or none.
+  virtual absl::StatusOr<std::vector<int>> ProposeTokens(
+      absl::Span<const int> sequence, int max_num_tokens) = 0;
+
+  // Notifies that only the first `length` tokens of the sequence of the last
+  // ProposeTokens() call, followed by the proposed tokens, are still part of
+  // the sequence.
+  virtual absl::Status OnSequenceTruncated(int length) {
+    return absl::OkStatus();
+  }
+};
+
+// Proposes the greedy continuation of a small draft model. The draft executor
+// catches up lazily with the sequence, so its context only has to be rolled
+// back when the proposed tokens are rejected.
+class DraftModelProposer : public DraftTokenProposer {
+ public:
+  // The draft executor must start from an empty context, be used exclusively
+  // by this proposer and outlive it. It must use the vocabulary of the main
+  // model.
+  explicit DraftModelProposer(
+      SpeculativeLlmExecutor* absl_nonnull draft_executor)
+      : draft_executor_(*draft_executor) {}
+
+  // Rolls back the tokens fed to the draft executor.
+  ~DraftModelProposer() override;
+
+  absl::StatusOr<std::vector<int>> ProposeTokens(
+      absl::Span<const int> sequence, int max_num_tokens) override;
+
+  absl::Status OnSequenceTruncated(int length) override;
+
+ private:
+  SpeculativeLlmExecutor& draft_executor_;
+  // The number of tokens in the context of the draft executor.
+  int num_fed_tokens_ = 0;
+};
+
+// SpeculativeDecoder implements greedy speculative decoding: every step, a
+// DraftTokenProposer proposes a few tokens, then the main model scores all of
+// them in a single invocation. The longest prefix of the proposal matching
+// the main model's own greedy predictions is accepted, together with the main
+// model's prediction following it, so every step emits between 1 and
+// max_num_draft_tokens + 1 tokens. The output is identical to greedy decoding
+// with the main model alone.
+//
+// The decoder keeps track of the token sequence seen by the main executor and
+// rolls the executor back when the proposed tokens are rejected.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(auto decoder, SpeculativeDecoder::Create(main_executor));
+//   DraftModelProposer proposer(draft_executor);
+//   RETURN_IF_ERROR(decoder->SetDraftTokenProposer(
+//       &proposer, /*max_num_draft_tokens=*/4));
+//   // After prefilling the main executor with `prompt_ids`:
+//   decoder->AppendPrefilledTokens(prompt_ids);
+//   while (...) {
+//     ASSIGN_OR_RETURN(std::vector<int> tokens, decoder->Step());
+//     ...
+//   }
+class SpeculativeDecoder {
+ public:
+  // Counters describing the effectiveness of the proposers.
+  struct Stats {
+    // The number of speculative steps, i.e. main model invocations.
+    int64_t num_steps = 0;
+    // The total number of proposed tokens.
+    int64_t num_draft_tokens = 0;
+    // The total number of proposed tokens accepted by the main model.
+    int64_t num_accepted_draft_tokens = 0;
+  };
+
+  // Creates a decoder on top of the main executor, which must outlive the
+  // decoder.
+  static absl::StatusOr<std::unique_ptr<SpeculativeDecoder>> Create(
+      SpeculativeLlmExecutor* absl_nonnull main_executor);
+
+  SpeculativeDecoder(const SpeculativeDecoder&) = delete;
+  SpeculativeDecoder& operator=(const SpeculativeDecoder&) = delete;
+
+  // Sets the proposer used by the following steps, which must outlive its
+  // use, and the maximum number of tokens it proposes per step.
+  absl::Status SetDraftTokenProposer(
+      DraftTokenProposer* absl_nonnull proposer, int max_num_draft_tokens);
+
+  // Records `token_ids` as prefilled into the main executor through the
+  // regular LlmExecutor API. The last token id is the pending one.
+  void AppendPrefilledTokens(absl::Span<const int> token_ids);
+
+  // Restarts the tracked sequence from `token_ids`, prefilled last into the
+  // main executor, when the executor processed tokens the decoder did not
+  // see, e.g. of a decode which was not speculative. The last token id is the
+  // pending one. The proposers following the sequence must be truncated to
+  // nothing by the caller.
+  void ResetSequence(absl::Span<const int> token_ids);
+
+  // Runs one speculative step and returns the emitted tokens in order. The
+  // last returned token is the new pending token of the main executor.
+  // Requires a proposer and at least one prefilled token.
+  absl::StatusOr<std::vector<int>> Step();
+
+  // Keeps only the first `num_kept_tokens` tokens returned by the last
+  // Step(), e.g. when a stop condition was met in the middle of them. The
+  // last kept token becomes the pending token.
+  absl::Status DiscardAfter(int num_kept_tokens);
+
+  // Returns the pending token of the main executor, i.e. the last emitted or
+  // prefilled token.
+  int GetPendingTokenId() const;
+
+  // Returns the token sequence of the main executor, with the pending token
+  // last.
+  absl::Span<const int> GetSequence() const { return sequence_; }
+
+  int GetMaxNumDraftTokens() const { return max_num_draft_tokens_; }
+
+  const Stats& GetStats() const { return stats_; }
+
+ private:
+  explicit SpeculativeDecoder(SpeculativeLlmExecutor* main_executor)
+      : main_executor_(*main_executor) {}
+
+  // Rolls back the main executor to the first `length` tokens of the
+  // sequence, if it is ahead of them.
+  absl::Status TruncateMainContext(int length);
+
+  SpeculativeLlmExecutor& main_executor_;
+  DraftTokenProposer* proposer_ = nullptr;
+  int max_num_draft_tokens_ = 0;
+
+  // The token sequence of the main executor, with the pending token last.
+  std::vector<int> sequence_;
+  // The number of leading tokens of `sequence_` attended to by the main
+  // executor, i.e. all but the pending one.
+  int main_length_ = 0;
+  // The number of tokens emitted by the last Step().
+  int last_step_size_ = 0;
+  Stats stats_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SPECULATIVE_DECODER_H_
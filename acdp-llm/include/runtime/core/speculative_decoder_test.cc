@@ -0,0 +1,321 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/speculative_decoder.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::status::StatusIs;
+
+// A fake executor predicting `last_token + 1`, except for the tokens listed in
+// `overrides`. Records its context and the number of model invocations.
+class FakeSpeculativeExecutor : public SpeculativeLlmExecutor {
+ public:
+  explicit FakeSpeculativeExecutor(absl::flat_hash_map<int, int> overrides = {})
+      : overrides_(std::move(overrides)) {}
+
+  absl::StatusOr<std::vector<int>> PredictNextTokens(
+      absl::Span<const int> token_ids) override {
+    EXPECT_FALSE(token_ids.empty());
+    ++num_invocations_;
+    std::vector<int> predictions;
+    for (int token_id : token_ids) {
+      context_.push_back(token_id);
+      auto it = overrides_.find(token_id);
+      predictions.push_back(it == overrides_.end() ? token_id + 1
+                                                   : it->second);
+    }
+    return predictions;
+  }
+
+  absl::Status RollbackTokens(int num_tokens) override {
+    if (num_tokens > context_.size()) {
+      return absl::InvalidArgumentError("Rolling back too many tokens.");
+    }
+    context_.resize(context_.size() - num_tokens);
+    return absl::OkStatus();
+  }
+
+  const std::vector<int>& context() const { return context_; }
+  int num_invocations() const { return num_invocations_; }
+
+ private:
+  const absl::flat_hash_map<int, int> overrides_;
+  std::vector<int> context_;
+  int num_invocations_ = 0;
+};
+
+// A proposer returning a fixed proposal and recording its notifications.
+class FixedProposer : public DraftTokenProposer {
+ public:
+  explicit FixedProposer(std::vector<int> proposal)
+      : proposal_(std::move(proposal)) {}
+
+  absl::StatusOr<std::vector<int>> ProposeTokens(
+      absl::Span<const int> sequence, int max_num_tokens) override {
+    return proposal_;
+  }
+
+  absl::Status OnSequenceTruncated(int length) override {
+    truncated_lengths_.push_back(length);
+    return absl::OkStatus();
+  }
+
+  const std::vector<int>& truncated_lengths() const {
+    return truncated_lengths_;
+  }
+
+ private:
+  const std::vector<int> proposal_;
+  std::vector<int> truncated_lengths_;
+};
+
+absl::StatusOr<std::unique_ptr<SpeculativeDecoder>> CreateDecoder(
+    SpeculativeLlmExecutor& main_executor, DraftTokenProposer& proposer,
+    int max_num_draft_tokens) {
+  auto decoder = SpeculativeDecoder::Create(&main_executor);
+  if (!decoder.ok()) {
+    return decoder.status();
+  }
+  absl::Status status =
+      (*decoder)->SetDraftTokenProposer(&proposer, max_num_draft_tokens);
+  if (!status.ok()) {
+    return status;
+  }
+  return decoder;
+}
+
+TEST(SpeculativeDecoderTest, SetDraftTokenProposerFailsWithInvalidArguments) {
+  FakeSpeculativeExecutor main_executor;
+  FixedProposer proposer({});
+  ASSERT_OK_AND_ASSIGN(auto decoder,
+                       SpeculativeDecoder::Create(&main_executor));
+  EXPECT_THAT(decoder->SetDraftTokenProposer(&proposer,
+                                             /*max_num_draft_tokens=*/0),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(SpeculativeDecoderTest, StepFailsWithoutProposerOrPrefilledTokens) {
+  FakeSpeculativeExecutor main_executor;
+  FixedProposer proposer({});
+  ASSERT_OK_AND_ASSIGN(auto decoder,
+                       SpeculativeDecoder::Create(&main_executor));
+  decoder->AppendPrefilledTokens({1});
+  EXPECT_THAT(decoder->Step(),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+
+  ASSERT_OK_AND_ASSIGN(decoder, CreateDecoder(main_executor, proposer,
+                                              /*max_num_draft_tokens=*/2));
+  EXPECT_THAT(decoder->Step(),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST(SpeculativeDecoderTest, AcceptsAllTokensOfAPerfectDraft) {
+  FakeSpeculativeExecutor main_executor;
+  FakeSpeculativeExecutor draft_executor;
+  DraftModelProposer proposer(&draft_executor);
+  ASSERT_OK_AND_ASSIGN(auto decoder, CreateDecoder(main_executor, proposer,
+                                                   /*max_num_draft_tokens=*/3));
+  // The regular prefill attended to all but the pending token.
+  main_executor.PredictNextTokens({1, 2}).IgnoreError();
+  decoder->AppendPrefilledTokens({1, 2, 3});
+
+  ASSERT_OK_AND_ASSIGN(std::vector<int> tokens, decoder->Step());
+  EXPECT_THAT(tokens, ElementsAre(4, 5, 6, 7));
+  EXPECT_THAT(main_executor.context(), ElementsAre(1, 2, 3, 4, 5, 6));
+  EXPECT_THAT(draft_executor.context(), ElementsAre(1, 2, 3, 4, 5));
+  EXPECT_EQ(decoder->GetPendingTokenId(), 7);
+
+  ASSERT_OK_AND_ASSIGN(tokens, decoder->Step());
+  EXPECT_THAT(tokens, ElementsAre(8, 9, 10, 11));
+  EXPECT_THAT(main_executor.context(),
+              ElementsAre(1, 2, 3, 4, 5, 6, 7, 8, 9, 10));
+  // Two main model invocations on top of the prefill for eight tokens.
+  EXPECT_EQ(main_executor.num_invocations(), 3);
+  EXPECT_EQ(decoder->GetStats().num_steps, 2);
+  EXPECT_EQ(decoder->GetStats().num_draft_tokens, 6);
+  EXPECT_EQ(decoder->GetStats().num_accepted_draft_tokens, 6);
+}
+
+TEST(SpeculativeDecoderTest, RollsBackRejectedTokens) {
+  FakeSpeculativeExecutor main_executor;
+  // The draft model diverges after token 5.
+  FakeSpeculativeExecutor draft_executor(
+      /*overrides=*/absl::flat_hash_map<int, int>{{5, 100}});
+  DraftModelProposer proposer(&draft_executor);
+  ASSERT_OK_AND_ASSIGN(auto decoder, CreateDecoder(main_executor, proposer,
+                                                   /*max_num_draft_tokens=*/4));
+  decoder->AppendPrefilledTokens({3});
+
+  // Proposed 4, 5, 100, 101: 4 and 5 are accepted and the main model
+  // corrects 100 into 6.
+  ASSERT_OK_AND_ASSIGN(std::vector<int> tokens, decoder->Step());
+  EXPECT_THAT(tokens, ElementsAre(4, 5, 6));
+  EXPECT_THAT(main_executor.context(), ElementsAre(3, 4, 5));
+  EXPECT_THAT(draft_executor.context(), ElementsAre(3, 4, 5));
+  EXPECT_EQ(decoder->GetStats().num_accepted_draft_tokens, 2);
+
+  // Proposed 7, 8, 9, 10, all accepted.
+  ASSERT_OK_AND_ASSIGN(tokens, decoder->Step());
+  EXPECT_THAT(tokens, ElementsAre(7, 8, 9, 10, 11));
+  EXPECT_THAT(main_executor.context(),
+              ElementsAre(3, 4, 5, 6, 7, 8, 9, 10));
+  EXPECT_THAT(draft_executor.context(), ElementsAre(3, 4, 5, 6, 7, 8, 9));
+}
+
+TEST(SpeculativeDecoderTest, ResetSequenceContinuesFromTheNewPrefill) {
+  FakeSpeculativeExecutor main_executor;
+  FakeSpeculativeExecutor draft_executor;
+  DraftModelProposer proposer(&draft_executor);
+  ASSERT_OK_AND_ASSIGN(auto decoder, CreateDecoder(main_executor, proposer,
+                                                   /*max_num_draft_tokens=*/2));
+  decoder->AppendPrefilledTokens({1});
+  ASSERT_OK_AND_ASSIGN(std::vector<int> tokens, decoder->Step());
+  EXPECT_THAT(tokens, ElementsAre(2, 3, 4));
+
+  // The main executor went on without the decoder, then prefilled 20, 21.
+  ASSERT_OK(proposer.OnSequenceTruncated(0));
+  decoder->ResetSequence({20, 21});
+  EXPECT_THAT(decoder->GetSequence(), ElementsAre(20, 21));
+  EXPECT_EQ(decoder->GetPendingTokenId(), 21);
+
+  ASSERT_OK_AND_ASSIGN(tokens, decoder->Step());
+  EXPECT_THAT(tokens, ElementsAre(22, 23, 24));
+  EXPECT_THAT(draft_executor.context(), ElementsAre(20, 21, 22));
+}
+
+TEST(SpeculativeDecoderTest, MatchesGreedyDecodingOfTheMainModel) {
+  const absl::flat_hash_map<int, int> main_overrides = {
+      {4, 9}, {10, 2}, {6, 1}};
+  FakeSpeculativeExecutor reference(main_overrides);
+  FakeSpeculativeExecutor main_executor(main_overrides);
+  FakeSpeculativeExecutor draft_executor(
+      /*overrides=*/absl::flat_hash_map<int, int>{
+          {4, 9}, {9, 3}, {2, 7}, {6, 1}});
+  DraftModelProposer proposer(&draft_executor);
+  ASSERT_OK_AND_ASSIGN(auto decoder, CreateDecoder(main_executor, proposer,
+                                                   /*max_num_draft_tokens=*/3));
+  decoder->AppendPrefilledTokens({0});
+
+  std::vector<int> expected;
+  int token = 0;
+  for (int i = 0; i < 30; ++i) {
+    ASSERT_OK_AND_ASSIGN(std::vector<int> prediction,
+                         reference.PredictNextTokens({token}));
+    token = prediction.back();
+    expected.push_back(token);
+  }
+  std::vector<int> decoded;
+  while (decoded.size() < expected.size()) {
+    ASSERT_OK_AND_ASSIGN(std::vector<int> tokens, decoder->Step());
+    decoded.insert(decoded.end(), tokens.begin(), tokens.end());
+  }
+  decoded.resize(expected.size());
+  EXPECT_THAT(decoded, ElementsAreArray(expected));
+  EXPECT_LT(main_executor.num_invocations(), expected.size());
+}
+
+TEST(SpeculativeDecoderTest, HandlesShortAndEmptyProposals) {
+  FakeSpeculativeExecutor main_executor;
+  FixedProposer empty_proposer({});
+  ASSERT_OK_AND_ASSIGN(auto decoder,
+                       CreateDecoder(main_executor, empty_proposer,
+                                     /*max_num_draft_tokens=*/4));
+  decoder->AppendPrefilledTokens({1});
+
+  // Without proposal, a step is a regular decode step.
+  ASSERT_OK_AND_ASSIGN(std::vector<int> tokens, decoder->Step());
+  EXPECT_THAT(tokens, ElementsAre(2));
+  EXPECT_THAT(main_executor.context(), ElementsAre(1));
+  EXPECT_THAT(empty_proposer.truncated_lengths(), ElementsAre(1));
+
+  // One of the two proposed tokens is accepted.
+  FixedProposer short_proposer({3, 7});
+  EXPECT_OK(decoder->SetDraftTokenProposer(&short_proposer,
+                                           /*max_num_draft_tokens=*/4));
+  ASSERT_OK_AND_ASSIGN(tokens, decoder->Step());
+  EXPECT_THAT(tokens, ElementsAre(3, 4));
+  EXPECT_THAT(main_executor.context(), ElementsAre(1, 2, 3));
+  EXPECT_THAT(short_proposer.truncated_lengths(), ElementsAre(3));
+  EXPECT_EQ(decoder->GetStats().num_draft_tokens, 2);
+  EXPECT_EQ(decoder->GetStats().num_accepted_draft_tokens, 1);
+}
+
+TEST(SpeculativeDecoderTest, DiscardAfterRollsBackTheDroppedTokens) {
+  FakeSpeculativeExecutor main_executor;
+  FakeSpeculativeExecutor draft_executor;
+  DraftModelProposer proposer(&draft_executor);
+  ASSERT_OK_AND_ASSIGN(auto decoder, CreateDecoder(main_executor, proposer,
+                                                   /*max_num_draft_tokens=*/3));
+  decoder->AppendPrefilledTokens({1});
+  ASSERT_OK_AND_ASSIGN(std::vector<int> tokens, decoder->Step());
+  ASSERT_THAT(tokens, ElementsAre(2, 3, 4, 5));
+
+  EXPECT_THAT(decoder->DiscardAfter(0),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(decoder->DiscardAfter(5),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  // Keep 2 as the new pending token.
+  EXPECT_OK(decoder->DiscardAfter(1));
+  EXPECT_EQ(decoder->GetPendingTokenId(), 2);
+  EXPECT_THAT(decoder->GetSequence(), ElementsAre(1, 2));
+  EXPECT_THAT(main_executor.context(), ElementsAre(1));
+  EXPECT_THAT(draft_executor.context(), ElementsAre(1, 2));
+
+  ASSERT_OK_AND_ASSIGN(tokens, decoder->Step());
+  EXPECT_THAT(tokens, ElementsAre(3, 4, 5, 6));
+}
+
+TEST(DraftModelProposerTest, DestructorResetsTheDraftContext) {
+  FakeSpeculativeExecutor draft_executor;
+  {
+    DraftModelProposer proposer(&draft_executor);
+    ASSERT_OK_AND_ASSIGN(std::vector<int> tokens,
+                         proposer.ProposeTokens({1, 2}, /*max_num_tokens=*/2));
+    EXPECT_THAT(tokens, ElementsAre(3, 4));
+    ASSERT_FALSE(draft_executor.context().empty());
+  }
+  EXPECT_TRUE(draft_executor.context().empty());
+}
+
+TEST(DraftModelProposerTest, ReFeedsTheLastTokenOfAFullyFedSequence) {
+  FakeSpeculativeExecutor draft_executor;
+  DraftModelProposer proposer(&draft_executor);
+  ASSERT_OK(proposer.ProposeTokens({1, 2}, /*max_num_tokens=*/1));
+  EXPECT_THAT(draft_executor.context(), ElementsAre(1, 2));
+
+  ASSERT_OK_AND_ASSIGN(std::vector<int> tokens,
+                       proposer.ProposeTokens({1, 2}, /*max_num_tokens=*/1));
+  EXPECT_THAT(tokens, ElementsAre(3));
+  EXPECT_THAT(draft_executor.context(), ElementsAre(1, 2));
+}
+
+}  // namespace
+}  // namespace litert::lm
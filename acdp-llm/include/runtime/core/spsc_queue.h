@@ -0,0 +1,87 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SPSC_QUEUE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace litert::lm {
+
+// A bounded lock-free queue for exactly one producer thread and one consumer
+// thread. TryPush must only be called by the producer and TryPop by the
+// consumer; IsEmpty and IsFull may be called by either.
+template <typename T>
+class SpscQueue {
+ public:
+  explicit SpscQueue(size_t capacity) : slots_(capacity + 1) {}
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  // Moves the value into the queue and returns true, or leaves it untouched
+  // and returns false if the queue is full.
+  bool TryPush(T& value) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t next_tail = Next(tail);
+    if (next_tail == head_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    slots_[tail].emplace(std::move(value));
+    tail_.store(next_tail, std::memory_order_release);
+    return true;
+  }
+
+  // Returns the oldest value of the queue, or nullopt if it is empty.
+  std::optional<T> TryPop() {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    std::optional<T> value = std::move(slots_[head]);
+    slots_[head].reset();
+    head_.store(Next(head), std::memory_order_release);
+    return value;
+  }
+
+  bool IsEmpty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+  bool IsFull() const {
+    return Next(tail_.load(std::memory_order_acquire)) ==
+           head_.load(std::memory_order_acquire);
+  }
+
+ private:
+  size_t Next(size_t index) const {
+    return index + 1 == slots_.size() ? 0 : index + 1;
+  }
+
+  // One slot is always left empty to tell a full queue from an empty one.
+  std::vector<std::optional<T>> slots_;
+  // The head is written by the consumer and the tail by the producer, so they
+  // are kept on separate cache lines.
+  alignas(64) std::atomic<size_t> head_ = 0;
+  alignas(64) std::atomic<size_t> tail_ = 0;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_SPSC_QUEUE_H_
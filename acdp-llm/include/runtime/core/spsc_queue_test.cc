@@ -0,0 +1,86 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/spsc_queue.h"
+
+#include <memory>
+#include <optional>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace litert::lm {
+namespace {
+
+using ::testing::Optional;
+using ::testing::Pointee;
+
+TEST(SpscQueueTest, PushAndPopInOrder) {
+  SpscQueue<int> queue(/*capacity=*/2);
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_EQ(queue.TryPop(), std::nullopt);
+
+  int value = 1;
+  EXPECT_TRUE(queue.TryPush(value));
+  value = 2;
+  EXPECT_TRUE(queue.TryPush(value));
+  EXPECT_TRUE(queue.IsFull());
+  value = 3;
+  EXPECT_FALSE(queue.TryPush(value));
+
+  EXPECT_THAT(queue.TryPop(), Optional(1));
+  EXPECT_TRUE(queue.TryPush(value));
+  EXPECT_THAT(queue.TryPop(), Optional(2));
+  EXPECT_THAT(queue.TryPop(), Optional(3));
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(SpscQueueTest, FailedPushKeepsTheValue) {
+  SpscQueue<std::unique_ptr<int>> queue(/*capacity=*/1);
+  auto value = std::make_unique<int>(1);
+  EXPECT_TRUE(queue.TryPush(value));
+  EXPECT_EQ(value, nullptr);
+
+  value = std::make_unique<int>(2);
+  EXPECT_FALSE(queue.TryPush(value));
+  EXPECT_THAT(value, Pointee(2));
+  EXPECT_THAT(queue.TryPop(), Optional(Pointee(1)));
+}
+
+TEST(SpscQueueTest, TransfersBetweenThreads) {
+  constexpr int kNumValues = 10000;
+  SpscQueue<int> queue(/*capacity=*/16);
+  std::thread producer([&queue]() {
+    for (int i = 0; i < kNumValues; ++i) {
+      int value = i;
+      while (!queue.TryPush(value)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+  for (int i = 0; i < kNumValues; ++i) {
+    std::optional<int> value;
+    while (!(value = queue.TryPop()).has_value()) {
+      std::this_thread::yield();
+    }
+    ASSERT_EQ(*value, i);
+  }
+  producer.join();
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+}  // namespace
+}  // namespace litert::lm
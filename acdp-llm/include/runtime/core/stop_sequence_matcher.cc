@@ -0,0 +1,194 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/stop_sequence_matcher.h"
+
+#include <algorithm>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+AhoCorasickAutomaton::AhoCorasickAutomaton(
+    const std::vector<std::vector<int>>& patterns)
+    : states_(1) {
+  // Build the trie of the patterns.
+  for (const std::vector<int>& pattern : patterns) {
+    int state = kRootState;
+    for (const int symbol : pattern) {
+      auto [it, inserted] =
+          states_[state].transitions.try_emplace(symbol, states_.size());
+      const int next_state = it->second;
+      if (inserted) {
+        states_.emplace_back();
+        states_.back().depth = states_[state].depth + 1;
+      }
+      state = next_state;
+    }
+    states_[state].match_length =
+        std::max<int>(states_[state].match_length, pattern.size());
+    max_pattern_length_ =
+        std::max<int>(max_pattern_length_, pattern.size());
+  }
+  // Compute the failure links in breadth-first order, so that the links of
+  // the shallower states are known.
+  std::queue<int> states;
+  for (const auto& [symbol, state] : states_[kRootState].transitions) {
+    states.push(state);
+  }
+  while (!states.empty()) {
+    const int state = states.front();
+    states.pop();
+    for (const auto& [symbol, next_state] : states_[state].transitions) {
+      const int failure = Next(states_[state].failure, symbol);
+      states_[next_state].failure = failure;
+      // A pattern ending at the failure state also ends here.
+      states_[next_state].match_length = std::max(
+          states_[next_state].match_length, states_[failure].match_length);
+      states.push(next_state);
+    }
+  }
+}
+
+int AhoCorasickAutomaton::Next(int state, int symbol) const {
+  while (true) {
+    const auto& transitions = states_[state].transitions;
+    if (auto it = transitions.find(symbol); it != transitions.end()) {
+      return it->second;
+    }
+    if (state == kRootState) {
+      return kRootState;
+    }
+    state = states_[state].failure;
+  }
+}
+
+// static
+absl::StatusOr<std::unique_ptr<StopSequences>> StopSequences::Create(
+    const std::vector<std::vector<int>>& stop_token_ids,
+    const std::vector<std::string>& stop_strings) {
+  for (const std::vector<int>& token_ids : stop_token_ids) {
+    if (token_ids.empty()) {
+      return absl::InvalidArgumentError("Stop token ids must not be empty.");
+    }
+  }
+  std::vector<std::vector<int>> stop_bytes;
+  stop_bytes.reserve(stop_strings.size());
+  for (const std::string& stop_string : stop_strings) {
+    if (stop_string.empty()) {
+      return absl::InvalidArgumentError("Stop strings must not be empty.");
+    }
+    stop_bytes.emplace_back(stop_string.begin(), stop_string.end());
+    // Read the bytes as unsigned, like the decoded text.
+    for (int& byte : stop_bytes.back()) {
+      byte = static_cast<unsigned char>(byte);
+    }
+  }
+  return absl::WrapUnique(new StopSequences(stop_token_ids, stop_bytes));
+}
+
+StopSequenceMatcher::StopSequenceMatcher(const StopSequences& stop_sequences,
+                                         int num_output_candidates)
+    : stop_sequences_(stop_sequences), candidates_(num_output_candidates) {
+  const int max_num_tokens =
+      stop_sequences.GetTokenAutomaton().GetMaxPatternLength();
+  for (Candidate& candidate : candidates_) {
+    candidate.token_text_sizes.resize(max_num_tokens);
+  }
+}
+
+absl::string_view StopSequenceMatcher::Process(int candidate_index,
+                                               int token_id,
+                                               absl::string_view text) {
+  Candidate& candidate = candidates_[candidate_index];
+  candidate.released_text.clear();
+  if (candidate.stop_found) {
+    return candidate.released_text;
+  }
+  const AhoCorasickAutomaton& token_automaton =
+      stop_sequences_.GetTokenAutomaton();
+  const AhoCorasickAutomaton& text_automaton =
+      stop_sequences_.GetTextAutomaton();
+
+  candidate.token_state = token_automaton.Next(candidate.token_state, token_id);
+  if (!candidate.token_text_sizes.empty()) {
+    candidate.token_text_sizes[candidate.num_tokens %
+                               candidate.token_text_sizes.size()] =
+        text.size();
+  }
+  ++candidate.num_tokens;
+  candidate.held_text.append(text.data(), text.size());
+
+  // A stop string that ends in the new text releases the text before it.
+  const int text_start = candidate.held_text.size() - text.size();
+  for (int i = 0; i < text.size(); ++i) {
+    candidate.text_state = text_automaton.Next(
+        candidate.text_state, static_cast<unsigned char>(text[i]));
+    const int match_length =
+        text_automaton.GetMatchLength(candidate.text_state);
+    if (match_length > 0) {
+      candidate.stop_found = true;
+      Release(candidate, text_start + i + 1 - match_length);
+      candidate.held_text.clear();
+      return candidate.released_text;
+    }
+  }
+
+  // So does a stop token sequence, with the text of its tokens.
+  const int match_length =
+      token_automaton.GetMatchLength(candidate.token_state);
+  if (match_length > 0) {
+    candidate.stop_found = true;
+    Release(candidate, candidate.held_text.size() -
+                           GetLastTokensTextSize(candidate, match_length));
+    candidate.held_text.clear();
+    return candidate.released_text;
+  }
+
+  // Hold back the text of the partial matches only.
+  const int num_held_bytes = std::max(
+      GetLastTokensTextSize(candidate,
+                            token_automaton.GetDepth(candidate.token_state)),
+      text_automaton.GetDepth(candidate.text_state));
+  Release(candidate, candidate.held_text.size() - num_held_bytes);
+  return candidate.released_text;
+}
+
+int StopSequenceMatcher::GetLastTokensTextSize(const Candidate& candidate,
+                                               int num_tokens) const {
+  const int ring_size = candidate.token_text_sizes.size();
+  num_tokens = std::min({num_tokens, candidate.num_tokens, ring_size});
+  int size = 0;
+  for (int i = 1; i <= num_tokens; ++i) {
+    size += candidate.token_text_sizes[(candidate.num_tokens - i) % ring_size];
+  }
+  return std::min<int>(size, candidate.held_text.size());
+}
+
+void StopSequenceMatcher::Release(Candidate& candidate, int size) const {
+  if (size <= 0) {
+    return;
+  }
+  candidate.released_text.append(candidate.held_text, 0, size);
+  candidate.held_text.erase(0, size);
+}
+
+}  // namespace litert::lm
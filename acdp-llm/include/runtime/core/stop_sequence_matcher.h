@@ -0,0 +1,150 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_STOP_SEQUENCE_MATCHER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_STOP_SEQUENCE_MATCHER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// An Aho-Corasick automaton matching a set of patterns of integer symbols in
+// a single pass over the input, whatever the number of patterns.
+class AhoCorasickAutomaton {
+ public:
+  static constexpr int kRootState = 0;
+
+  // The patterns must not be empty.
+  explicit AhoCorasickAutomaton(const std::vector<std::vector<int>>& patterns);
+
+  // Returns the state after reading `symbol` in `state`. Amortized O(1).
+  int Next(int state, int symbol) const;
+
+  // Returns the length of the longest pattern prefix ending the input read
+  // so far, i.e. the number of trailing symbols that may still turn into a
+  // match.
+  int GetDepth(int state) const { return states_[state].depth; }
+
+  // Returns the length of the longest pattern ending the input read so far,
+  // or 0 if no pattern does.
+  int GetMatchLength(int state) const { return states_[state].match_length; }
+
+  int GetMaxPatternLength() const { return max_pattern_length_; }
+
+ private:
+  struct State {
+    absl::flat_hash_map<int, int> transitions;
+    // The state of the longest proper suffix which is a pattern prefix.
+    int failure = kRootState;
+    int depth = 0;
+    int match_length = 0;
+  };
+
+  std::vector<State> states_;
+  int max_pattern_length_ = 0;
+};
+
+// The stop sequences of a session: sequences of token ids, matched against
+// the sampled tokens, and strings, matched against the decoded text even
+// when they span token boundaries.
+class StopSequences {
+ public:
+  static absl::StatusOr<std::unique_ptr<StopSequences>> Create(
+      const std::vector<std::vector<int>>& stop_token_ids,
+      const std::vector<std::string>& stop_strings);
+
+  StopSequences(const StopSequences&) = delete;
+  StopSequences& operator=(const StopSequences&) = delete;
+
+  const AhoCorasickAutomaton& GetTokenAutomaton() const {
+    return token_automaton_;
+  }
+  const AhoCorasickAutomaton& GetTextAutomaton() const {
+    return text_automaton_;
+  }
+
+ private:
+  StopSequences(const std::vector<std::vector<int>>& stop_token_ids,
+                const std::vector<std::vector<int>>& stop_strings)
+      : token_automaton_(stop_token_ids), text_automaton_(stop_strings) {}
+
+  AhoCorasickAutomaton token_automaton_;
+  // Over the bytes of the stop strings.
+  AhoCorasickAutomaton text_automaton_;
+};
+
+// Tracks the stop sequences in the output of each candidate during a decode.
+// The text that may belong to a stop sequence is held back until the
+// sequence is ruled out, and the text of a found stop sequence is never
+// released. The buffers are reused across the steps, so that matching does
+// not allocate.
+//
+// Example usage:
+//   StopSequenceMatcher matcher(stop_sequences, num_output_candidates);
+//   // After each decoded token:
+//   absl::string_view text = matcher.Process(candidate, token_id, delta);
+//   if (matcher.IsStopFound(candidate)) { ... }
+class StopSequenceMatcher {
+ public:
+  // `stop_sequences` must outlive the matcher.
+  StopSequenceMatcher(const StopSequences& stop_sequences,
+                      int num_output_candidates);
+
+  StopSequenceMatcher(const StopSequenceMatcher&) = delete;
+  StopSequenceMatcher& operator=(const StopSequenceMatcher&) = delete;
+
+  // Processes the next token of the candidate and its text, empty if the
+  // token does not complete a BPE sequence. Returns the text that is safe to
+  // output, valid until the next call for the candidate. Returns an empty
+  // text once a stop sequence has been found.
+  absl::string_view Process(int candidate, int token_id,
+                            absl::string_view text);
+
+  bool IsStopFound(int candidate) const {
+    return candidates_[candidate].stop_found;
+  }
+
+ private:
+  struct Candidate {
+    int token_state = AhoCorasickAutomaton::kRootState;
+    int text_state = AhoCorasickAutomaton::kRootState;
+    bool stop_found = false;
+    // The text not released yet.
+    std::string held_text;
+    // The text released by the last call.
+    std::string released_text;
+    // Ring buffer of the text sizes of the last tokens, enough to cover the
+    // longest token stop sequence.
+    std::vector<int> token_text_sizes;
+    int num_tokens = 0;
+  };
+
+  // Returns the size of the text of the last `num_tokens` tokens.
+  int GetLastTokensTextSize(const Candidate& candidate, int num_tokens) const;
+  // Moves the first `size` bytes of the held text to the released text.
+  void Release(Candidate& candidate, int size) const;
+
+  const StopSequences& stop_sequences_;
+  std::vector<Candidate> candidates_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_STOP_SEQUENCE_MATCHER_H_
@@ -0,0 +1,141 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/stop_sequence_matcher.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::StatusIs;
+
+TEST(AhoCorasickAutomatonTest, MatchesOverlappingPatterns) {
+  const AhoCorasickAutomaton automaton({{1, 2, 3}, {2, 3, 4}, {3}});
+  EXPECT_EQ(automaton.GetMaxPatternLength(), 3);
+  int state = AhoCorasickAutomaton::kRootState;
+  state = automaton.Next(state, 1);
+  EXPECT_EQ(automaton.GetDepth(state), 1);
+  EXPECT_EQ(automaton.GetMatchLength(state), 0);
+  state = automaton.Next(state, 2);
+  EXPECT_EQ(automaton.GetDepth(state), 2);
+  state = automaton.Next(state, 3);
+  EXPECT_EQ(automaton.GetMatchLength(state), 3);
+  // Falls back to the prefix "2 3" of the second pattern.
+  state = automaton.Next(state, 4);
+  EXPECT_EQ(automaton.GetMatchLength(state), 3);
+  state = automaton.Next(state, 5);
+  EXPECT_EQ(automaton.GetDepth(state), 0);
+  EXPECT_EQ(automaton.GetMatchLength(state), 0);
+}
+
+TEST(AhoCorasickAutomatonTest, MatchesPatternsThroughFailureLinks) {
+  const AhoCorasickAutomaton automaton({{1, 2, 3, 4}, {2}});
+  int state = AhoCorasickAutomaton::kRootState;
+  state = automaton.Next(state, 1);
+  state = automaton.Next(state, 2);
+  // "2" ends here, within the prefix of the longer pattern.
+  EXPECT_EQ(automaton.GetMatchLength(state), 1);
+  EXPECT_EQ(automaton.GetDepth(state), 2);
+}
+
+TEST(StopSequencesTest, CreateFailsWithEmptySequences) {
+  EXPECT_THAT(StopSequences::Create({{}}, {}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(StopSequences::Create({}, {""}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+// Processes the tokens and their texts, and returns the released text.
+std::string ProcessAll(StopSequenceMatcher& matcher,
+                       const std::vector<std::pair<int, std::string>>& tokens) {
+  std::string output;
+  for (const auto& [token_id, text] : tokens) {
+    absl::StrAppend(&output, matcher.Process(/*candidate=*/0, token_id, text));
+  }
+  return output;
+}
+
+TEST(StopSequenceMatcherTest, ReleasesTheTextWithoutStops) {
+  ASSERT_OK_AND_ASSIGN(auto stop_sequences,
+                       StopSequences::Create({{100}}, {"</s>"}));
+  StopSequenceMatcher matcher(*stop_sequences, /*num_output_candidates=*/1);
+  EXPECT_EQ(matcher.Process(0, 1, "Hello"), "Hello");
+  EXPECT_EQ(matcher.Process(0, 2, " world"), " world");
+  EXPECT_FALSE(matcher.IsStopFound(0));
+}
+
+TEST(StopSequenceMatcherTest, StopsAtTokenSequences) {
+  ASSERT_OK_AND_ASSIGN(auto stop_sequences,
+                       StopSequences::Create({{7, 8}}, {}));
+  StopSequenceMatcher matcher(*stop_sequences, /*num_output_candidates=*/1);
+  EXPECT_EQ(matcher.Process(0, 1, "a"), "a");
+  // The token may start the stop sequence.
+  EXPECT_EQ(matcher.Process(0, 7, "?"), "");
+  // It does not, so its text is released.
+  EXPECT_EQ(matcher.Process(0, 2, "b"), "?b");
+  EXPECT_EQ(matcher.Process(0, 7, "?"), "");
+  EXPECT_EQ(matcher.Process(0, 8, "!"), "");
+  EXPECT_TRUE(matcher.IsStopFound(0));
+  EXPECT_EQ(matcher.Process(0, 3, "c"), "");
+}
+
+TEST(StopSequenceMatcherTest, StopsAtStringsSpanningTokens) {
+  ASSERT_OK_AND_ASSIGN(auto stop_sequences,
+                       StopSequences::Create({}, {"<end>", "STOP"}));
+  StopSequenceMatcher matcher(*stop_sequences, /*num_output_candidates=*/1);
+  EXPECT_EQ(ProcessAll(matcher, {{1, "one <e"}, {2, "nd"}, {3, "> two"}}),
+            "one ");
+  EXPECT_TRUE(matcher.IsStopFound(0));
+}
+
+TEST(StopSequenceMatcherTest, ReleasesRuledOutPartialStrings) {
+  ASSERT_OK_AND_ASSIGN(auto stop_sequences,
+                       StopSequences::Create({}, {"<end>"}));
+  StopSequenceMatcher matcher(*stop_sequences, /*num_output_candidates=*/1);
+  EXPECT_EQ(matcher.Process(0, 1, "a <e"), "a ");
+  EXPECT_EQ(matcher.Process(0, 2, "x"), "<ex");
+  EXPECT_FALSE(matcher.IsStopFound(0));
+}
+
+TEST(StopSequenceMatcherTest, HoldsBackTheTokensOfIncompleteSequences) {
+  ASSERT_OK_AND_ASSIGN(auto stop_sequences,
+                       StopSequences::Create({{5, 6, 7}}, {}));
+  StopSequenceMatcher matcher(*stop_sequences, /*num_output_candidates=*/1);
+  // The text of a BPE sequence comes with its last token.
+  EXPECT_EQ(ProcessAll(matcher, {{1, "x"}, {5, ""}, {6, "ab"}, {7, ""}}),
+            "x");
+  EXPECT_TRUE(matcher.IsStopFound(0));
+}
+
+TEST(StopSequenceMatcherTest, TracksTheCandidatesIndependently) {
+  ASSERT_OK_AND_ASSIGN(auto stop_sequences,
+                       StopSequences::Create({{9}}, {}));
+  StopSequenceMatcher matcher(*stop_sequences, /*num_output_candidates=*/2);
+  EXPECT_EQ(matcher.Process(0, 9, "!"), "");
+  EXPECT_EQ(matcher.Process(1, 1, "a"), "a");
+  EXPECT_TRUE(matcher.IsStopFound(0));
+  EXPECT_FALSE(matcher.IsStopFound(1));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,140 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/streaming_coalescer.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/ascii.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/io_types.h"
+
+namespace litert::lm {
+namespace {
+
+using Boundary = DecodeConfig::StreamingCoalescingOptions::Boundary;
+
+bool StartsWord(absl::string_view text) {
+  return !text.empty() && absl::ascii_isspace(text.front());
+}
+
+bool EndsWord(absl::string_view text) {
+  return !text.empty() && absl::ascii_isspace(text.back());
+}
+
+bool EndsSentence(absl::string_view text) {
+  if (!text.empty() && text.back() == '\n') {
+    return true;
+  }
+  text = absl::StripTrailingAsciiWhitespace(text);
+  return !text.empty() &&
+         (text.back() == '.' || text.back() == '!' || text.back() == '?');
+}
+
+}  // namespace
+
+void StreamingCoalescer::OnResponses(absl::StatusOr<Responses> responses) {
+  if (!responses.ok() || responses->GetTaskState() != TaskState::kProcessing) {
+    Flush();
+    callback_(std::move(responses));
+    return;
+  }
+  if (!has_delivered_) {
+    has_delivered_ = true;
+    callback_(std::move(responses));
+    return;
+  }
+  // A text starting a new word completes the pending one.
+  if (options_.boundary == Boundary::kWord) {
+    for (const std::string& text : responses->GetTexts()) {
+      if (StartsWord(text)) {
+        Flush();
+        break;
+      }
+    }
+  }
+  const bool should_flush = ShouldFlush(*responses);
+  Append(*std::move(responses));
+  if (should_flush) {
+    Flush();
+  }
+}
+
+StreamingCoalescer::Callback StreamingCoalescer::AsCallback() {
+  return [this](absl::StatusOr<Responses> responses) {
+    OnResponses(std::move(responses));
+  };
+}
+
+void StreamingCoalescer::Append(Responses responses) {
+  if (!pending_responses_.has_value()) {
+    num_pending_steps_ = 1;
+    pending_since_ = absl::Now();
+    num_pending_scores_.assign(responses.GetScores().size(), 1);
+    pending_responses_ = std::move(responses);
+    return;
+  }
+  ++num_pending_steps_;
+  std::vector<std::string>& texts = pending_responses_->GetMutableTexts();
+  for (int i = 0; i < texts.size() && i < responses.GetTexts().size(); ++i) {
+    texts[i] += responses.GetTexts()[i];
+  }
+  std::vector<float>& scores = pending_responses_->GetMutableScores();
+  for (int i = 0; i < scores.size() && i < responses.GetScores().size(); ++i) {
+    scores[i] += responses.GetScores()[i];
+    ++num_pending_scores_[i];
+  }
+}
+
+void StreamingCoalescer::Flush() {
+  if (!pending_responses_.has_value()) {
+    return;
+  }
+  std::vector<float>& scores = pending_responses_->GetMutableScores();
+  for (int i = 0; i < scores.size(); ++i) {
+    scores[i] /= num_pending_scores_[i];
+  }
+  callback_(*std::move(pending_responses_));
+  pending_responses_.reset();
+  num_pending_steps_ = 0;
+}
+
+bool StreamingCoalescer::ShouldFlush(const Responses& responses) const {
+  if (options_.max_num_steps > 0 &&
+      num_pending_steps_ + 1 >= options_.max_num_steps) {
+    return true;
+  }
+  if (options_.max_delay > absl::ZeroDuration() &&
+      pending_responses_.has_value() &&
+      absl::Now() - pending_since_ >= options_.max_delay) {
+    return true;
+  }
+  for (const std::string& text : responses.GetTexts()) {
+    if ((options_.boundary == Boundary::kWord && EndsWord(text)) ||
+        (options_.boundary == Boundary::kSentence && EndsSentence(text))) {
+      return true;
+    }
+  }
+  // Without any condition, every step is delivered on its own.
+  return options_.max_num_steps <= 0 &&
+         options_.max_delay <= absl::ZeroDuration() &&
+         options_.boundary == Boundary::kNone;
+}
+
+}  // namespace litert::lm
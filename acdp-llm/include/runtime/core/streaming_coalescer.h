@@ -0,0 +1,78 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_STREAMING_COALESCER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_STREAMING_COALESCER_H_
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/io_types.h"
+
+namespace litert::lm {
+
+// Merges the streaming responses of consecutive decode steps into a single
+// callback, following DecodeConfig::StreamingCoalescingOptions. The texts of
+// each candidate are concatenated and their scores averaged. The final
+// response and the errors are passed through, after the pending texts.
+//
+// Example usage:
+//   StreamingCoalescer coalescer(std::move(callback), options);
+//   RETURN_IF_ERROR(DecodeStreaming(..., coalescer.AsCallback(), ...));
+class StreamingCoalescer {
+ public:
+  using Callback = absl::AnyInvocable<void(absl::StatusOr<Responses>)>;
+  using Options = DecodeConfig::StreamingCoalescingOptions;
+
+  StreamingCoalescer(Callback callback, const Options& options)
+      : callback_(std::move(callback)), options_(options) {}
+
+  StreamingCoalescer(const StreamingCoalescer&) = delete;
+  StreamingCoalescer& operator=(const StreamingCoalescer&) = delete;
+
+  // Coalesces the responses of a decode step, or passes them through.
+  void OnResponses(absl::StatusOr<Responses> responses);
+
+  // Returns a callback coalescing the responses. It must not outlive the
+  // coalescer.
+  Callback AsCallback();
+
+ private:
+  // Appends the responses of a step to the pending responses.
+  void Append(Responses responses);
+  // Delivers the pending responses, if any.
+  void Flush();
+  // Returns if the pending responses are due, `responses` being the ones
+  // just appended.
+  bool ShouldFlush(const Responses& responses) const;
+
+  Callback callback_;
+  const Options options_;
+
+  // Whether any response was delivered, the first one is never delayed.
+  bool has_delivered_ = false;
+  std::optional<Responses> pending_responses_;
+  int num_pending_steps_ = 0;
+  absl::Time pending_since_;
+  // The number of scores summed up for each candidate.
+  std::vector<int> num_pending_scores_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_STREAMING_COALESCER_H_
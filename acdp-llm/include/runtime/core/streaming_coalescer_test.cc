@@ -0,0 +1,140 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/streaming_coalescer.h"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/io_types.h"
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::FloatEq;
+using Boundary = DecodeConfig::StreamingCoalescingOptions::Boundary;
+
+// Records the texts of the first candidate, "<done>" for the final response
+// and the status code for the errors.
+class Recorder {
+ public:
+  StreamingCoalescer::Callback AsCallback() {
+    return [this](absl::StatusOr<Responses> responses) {
+      if (!responses.ok()) {
+        texts.push_back(absl::StatusCodeToString(responses.status().code()));
+      } else if (responses->GetTaskState() == TaskState::kDone) {
+        texts.push_back("<done>");
+      } else {
+        texts.push_back(responses->GetTexts()[0]);
+        if (!responses->GetScores().empty()) {
+          scores.push_back(responses->GetScores()[0]);
+        }
+      }
+    };
+  }
+
+  std::vector<std::string> texts;
+  std::vector<float> scores;
+};
+
+void Send(StreamingCoalescer& coalescer,
+          const std::vector<std::string>& texts) {
+  for (const std::string& text : texts) {
+    coalescer.OnResponses(Responses(TaskState::kProcessing, {text}));
+  }
+}
+
+TEST(StreamingCoalescerTest, WithoutConditionsDeliversEveryStep) {
+  Recorder recorder;
+  StreamingCoalescer coalescer(recorder.AsCallback(), {});
+  Send(coalescer, {"a", "b", "c"});
+  coalescer.OnResponses(Responses(TaskState::kDone));
+  EXPECT_THAT(recorder.texts, ElementsAre("a", "b", "c", "<done>"));
+}
+
+TEST(StreamingCoalescerTest, DeliversEveryNumSteps) {
+  Recorder recorder;
+  StreamingCoalescer::Options options;
+  options.max_num_steps = 3;
+  StreamingCoalescer coalescer(recorder.AsCallback(), options);
+  Send(coalescer, {"a", "b", "c", "d", "e", "f", "g", "h"});
+  // The first step is not delayed.
+  EXPECT_THAT(recorder.texts, ElementsAre("a", "bcd", "efg"));
+  // The final response delivers the pending texts first.
+  coalescer.OnResponses(Responses(TaskState::kDone));
+  EXPECT_THAT(recorder.texts, ElementsAre("a", "bcd", "efg", "h", "<done>"));
+}
+
+TEST(StreamingCoalescerTest, DeliversAtWordBoundaries) {
+  Recorder recorder;
+  StreamingCoalescer::Options options;
+  options.boundary = Boundary::kWord;
+  StreamingCoalescer coalescer(recorder.AsCallback(), options);
+  Send(coalescer, {" How", "'", "s", " it", " go", "ing", "? "});
+  EXPECT_THAT(recorder.texts, ElementsAre(" How", "'s", " it", " going? "));
+}
+
+TEST(StreamingCoalescerTest, DeliversAtSentenceBoundaries) {
+  Recorder recorder;
+  StreamingCoalescer::Options options;
+  options.boundary = Boundary::kSentence;
+  StreamingCoalescer coalescer(recorder.AsCallback(), options);
+  Send(coalescer, {"Hi", ".", " How", " are", " you", "?", " Fine", "\n"});
+  EXPECT_THAT(recorder.texts, ElementsAre("Hi", ".", " How are you?",
+                                          " Fine\n"));
+}
+
+TEST(StreamingCoalescerTest, DeliversAfterTheMaxDelay) {
+  Recorder recorder;
+  StreamingCoalescer::Options options;
+  options.max_delay = absl::Milliseconds(20);
+  StreamingCoalescer coalescer(recorder.AsCallback(), options);
+  Send(coalescer, {"a", "b", "c"});
+  EXPECT_THAT(recorder.texts, ElementsAre("a"));
+  absl::SleepFor(absl::Milliseconds(30));
+  Send(coalescer, {"d"});
+  EXPECT_THAT(recorder.texts, ElementsAre("a", "bcd"));
+}
+
+TEST(StreamingCoalescerTest, AveragesTheScores) {
+  Recorder recorder;
+  StreamingCoalescer::Options options;
+  options.max_num_steps = 2;
+  StreamingCoalescer coalescer(recorder.AsCallback(), options);
+  coalescer.OnResponses(Responses(TaskState::kProcessing, {"a"}, {-1.0f}));
+  coalescer.OnResponses(Responses(TaskState::kProcessing, {"b"}, {-1.0f}));
+  coalescer.OnResponses(Responses(TaskState::kProcessing, {"c"}, {-3.0f}));
+  EXPECT_THAT(recorder.texts, ElementsAre("a", "bc"));
+  EXPECT_THAT(recorder.scores, ElementsAre(FloatEq(-1.0f), FloatEq(-2.0f)));
+}
+
+TEST(StreamingCoalescerTest, DeliversThePendingTextsBeforeAnError) {
+  Recorder recorder;
+  StreamingCoalescer::Options options;
+  options.max_num_steps = 10;
+  StreamingCoalescer coalescer(recorder.AsCallback(), options);
+  Send(coalescer, {"a", "b", "c"});
+  coalescer.OnResponses(absl::CancelledError("Process cancelled."));
+  EXPECT_THAT(recorder.texts, ElementsAre("a", "bc", "CANCELLED"));
+}
+
+}  // namespace
+}  // namespace litert::lm
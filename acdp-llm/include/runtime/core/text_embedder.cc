@@ -0,0 +1,119 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/text_embedder.h"
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/core/logits_staging_buffer.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+
+absl::StatusOr<std::vector<float>> PoolHiddenStates(
+    absl::Span<const float> hidden_states, int num_tokens,
+    EmbeddingPooling pooling) {
+  if (num_tokens <= 0 || hidden_states.size() % num_tokens != 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid hidden states of ", hidden_states.size(),
+                     " values for ", num_tokens, " tokens."));
+  }
+  const int hidden_size = hidden_states.size() / num_tokens;
+  std::vector<float> embedding(hidden_size, 0.0f);
+  switch (pooling) {
+    case EmbeddingPooling::kLastToken: {
+      absl::Span<const float> last_token =
+          hidden_states.subspan((num_tokens - 1) * hidden_size);
+      embedding.assign(last_token.begin(), last_token.end());
+      break;
+    }
+    case EmbeddingPooling::kMean:
+      for (int token = 0; token < num_tokens; ++token) {
+        const float* hidden_state = &hidden_states[token * hidden_size];
+        for (int i = 0; i < hidden_size; ++i) {
+          embedding[i] += hidden_state[i];
+        }
+      }
+      // The scale cancels out in the normalization below.
+      break;
+  }
+
+  double squared_norm = 0.0;
+  for (const float value : embedding) {
+    squared_norm += static_cast<double>(value) * value;
+  }
+  if (squared_norm > 0.0) {
+    const float scale = 1.0 / std::sqrt(squared_norm);
+    for (float& value : embedding) {
+      value *= scale;
+    }
+  }
+  return embedding;
+}
+
+absl::StatusOr<std::vector<std::vector<float>>> EmbedTokenSequences(
+    HiddenStatesLlmExecutor& executor,
+    const std::vector<std::vector<int>>& token_ids, EmbeddingPooling pooling,
+    LogitsStagingBuffer* staging_buffer) {
+  std::vector<std::vector<float>> embeddings;
+  if (token_ids.empty()) {
+    return embeddings;
+  }
+  for (const std::vector<int>& sequence : token_ids) {
+    if (sequence.empty()) {
+      return absl::InvalidArgumentError("Can not embed an empty sequence.");
+    }
+  }
+
+  ASSIGN_OR_RETURN(std::vector<litert::TensorBuffer> hidden_states,
+                   executor.PrefillHiddenStates(token_ids));
+  if (hidden_states.size() != token_ids.size()) {
+    return absl::InternalError(
+        absl::StrCat("Expected the hidden states of ", token_ids.size(),
+                     " sequences, got ", hidden_states.size(), "."));
+  }
+  LogitsStagingBuffer owned_staging_buffer;
+  LogitsStagingBuffer& staging = staging_buffer != nullptr
+                                     ? *staging_buffer
+                                     : owned_staging_buffer;
+  embeddings.reserve(token_ids.size());
+  for (int i = 0; i < hidden_states.size(); ++i) {
+    // Download the data if it is not in host memory.
+    ASSIGN_OR_RETURN(absl::Span<const float> hidden_states_data,
+                     staging.Stage(hidden_states[i]));
+    if (hidden_states_data.size() !=
+        token_ids[i].size() * executor.GetHiddenSize()) {
+      return absl::InternalError(absl::StrCat(
+          "Expected ", token_ids[i].size(), " hidden states of size ",
+          executor.GetHiddenSize(), ", got ", hidden_states_data.size(),
+          " values."));
+    }
+    ASSIGN_OR_RETURN(std::vector<float> embedding,
+                     PoolHiddenStates(hidden_states_data,
+                                      token_ids[i].size(), pooling));
+    embeddings.push_back(std::move(embedding));
+  }
+  return embeddings;
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,52 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_TEXT_EMBEDDER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_TEXT_EMBEDDER_H_
+
+#include <vector>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/core/logits_staging_buffer.h"
+#include "runtime/engine/io_types.h"
+
+namespace litert::lm {
+
+// Pools the hidden states of the `num_tokens` tokens of a sequence, of shape
+// [num_tokens, hidden_size], into an embedding of hidden_size values,
+// normalized to unit length so that the dot product of two embeddings is
+// their cosine similarity.
+absl::StatusOr<std::vector<float>> PoolHiddenStates(
+    absl::Span<const float> hidden_states, int num_tokens,
+    EmbeddingPooling pooling);
+
+// Embeds the token sequences, all of them in a single model invocation, and
+// returns the embedding of each sequence, see PoolHiddenStates(). The
+// sequences are run independently of each other and of the context of the
+// executor, which is left unchanged.
+// - executor: The executor computing the hidden states of every position.
+// - token_ids: The token ids of each sequence, none of them empty.
+// - pooling: How the hidden states of a sequence are pooled.
+// - staging_buffer: Optional host memory reused to download the hidden
+//   states.
+absl::StatusOr<std::vector<std::vector<float>>> EmbedTokenSequences(
+    HiddenStatesLlmExecutor& executor,
+    const std::vector<std::vector<int>>& token_ids, EmbeddingPooling pooling,
+    LogitsStagingBuffer* staging_buffer = nullptr);
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_TEXT_EMBEDDER_H_
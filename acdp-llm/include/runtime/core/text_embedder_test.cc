@@ -0,0 +1,143 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/text_embedder.h"
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/core/llm_executor_extensions.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/convert_tensor_buffer.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::FloatNear;
+using ::testing::IsEmpty;
+using ::testing::Pointwise;
+using ::testing::status::StatusIs;
+
+constexpr int kHiddenSize = 2;
+
+// Returns the hidden state (id, 1) for each token id. Records the
+// invocations.
+class FakeHiddenStatesExecutor : public HiddenStatesLlmExecutor {
+ public:
+  int GetHiddenSize() const override { return kHiddenSize; }
+
+  absl::StatusOr<std::vector<litert::TensorBuffer>> PrefillHiddenStates(
+      absl::Span<const std::vector<int>> token_ids) override {
+    invocations.emplace_back(token_ids.begin(), token_ids.end());
+    std::vector<litert::TensorBuffer> hidden_states;
+    for (const std::vector<int>& sequence : token_ids) {
+      std::vector<float> data;
+      for (int token_id : sequence) {
+        data.push_back(token_id);
+        data.push_back(1.0f);
+      }
+      auto buffer = CopyToTensorBuffer<float>(
+          data, {static_cast<int>(sequence.size()), kHiddenSize});
+      if (!buffer) {
+        return absl::InternalError("Failed to create the hidden states.");
+      }
+      hidden_states.push_back(std::move(*buffer));
+    }
+    if (drop_last_hidden_states) {
+      hidden_states.pop_back();
+    }
+    return hidden_states;
+  }
+
+  std::vector<std::vector<std::vector<int>>> invocations;
+  bool drop_last_hidden_states = false;
+};
+
+TEST(TextEmbedderTest, PoolsTheLastToken) {
+  const std::vector<float> hidden_states = {1, 2, 3, 4};
+  ASSERT_OK_AND_ASSIGN(
+      std::vector<float> embedding,
+      PoolHiddenStates(hidden_states, /*num_tokens=*/2,
+                       EmbeddingPooling::kLastToken));
+  EXPECT_THAT(embedding, Pointwise(FloatNear(1e-6), {0.6f, 0.8f}));
+}
+
+TEST(TextEmbedderTest, PoolsTheMeanOfTheTokens) {
+  const std::vector<float> hidden_states = {1, 0, 0, 2, 2, 2};
+  ASSERT_OK_AND_ASSIGN(
+      std::vector<float> embedding,
+      PoolHiddenStates(hidden_states, /*num_tokens=*/3,
+                       EmbeddingPooling::kMean));
+  // The mean (1, 4/3) normalized.
+  EXPECT_THAT(embedding, Pointwise(FloatNear(1e-6), {0.6f, 0.8f}));
+}
+
+TEST(TextEmbedderTest, RejectsHiddenStatesNotMatchingTheTokens) {
+  const std::vector<float> hidden_states = {1, 2, 3};
+  EXPECT_THAT(PoolHiddenStates(hidden_states, /*num_tokens=*/2,
+                               EmbeddingPooling::kMean),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(PoolHiddenStates(hidden_states, /*num_tokens=*/0,
+                               EmbeddingPooling::kMean),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(TextEmbedderTest, EmbedsAllSequencesInOneInvocation) {
+  FakeHiddenStatesExecutor executor;
+  ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<float>> embeddings,
+      EmbedTokenSequences(executor, /*token_ids=*/{{5, 0}, {3}, {1, 1, 1}},
+                          EmbeddingPooling::kLastToken));
+  const float sqrt_half = std::sqrt(0.5f);
+  EXPECT_THAT(embeddings,
+              ElementsAre(ElementsAre(0.0f, 1.0f),
+                          Pointwise(FloatNear(1e-6), {0.948683f, 0.316228f}),
+                          Pointwise(FloatNear(1e-6), {sqrt_half, sqrt_half})));
+  EXPECT_THAT(executor.invocations,
+              ElementsAre(ElementsAre(ElementsAre(5, 0), ElementsAre(3),
+                                      ElementsAre(1, 1, 1))));
+}
+
+TEST(TextEmbedderTest, RejectsEmptySequences) {
+  FakeHiddenStatesExecutor executor;
+  EXPECT_THAT(EmbedTokenSequences(executor, /*token_ids=*/{{1}, {}},
+                                  EmbeddingPooling::kMean),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  ASSERT_OK_AND_ASSIGN(auto embeddings,
+                       EmbedTokenSequences(executor, /*token_ids=*/{},
+                                           EmbeddingPooling::kMean));
+  EXPECT_THAT(embeddings, IsEmpty());
+  // Nothing to run.
+  EXPECT_THAT(executor.invocations, IsEmpty());
+}
+
+TEST(TextEmbedderTest, FailsWithMissingHiddenStates) {
+  FakeHiddenStatesExecutor executor;
+  executor.drop_last_hidden_states = true;
+  EXPECT_THAT(EmbedTokenSequences(executor, /*token_ids=*/{{1}, {2}},
+                                  EmbeddingPooling::kLastToken),
+              StatusIs(absl::StatusCode::kInternal));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,89 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/token_id_cache.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/util/status_macros.h"  // IWYU pragma: keep
+
+namespace litert::lm {
+
+TokenIdCache::TokenIdCache(int max_num_entries, int max_text_size)
+    : max_num_entries_(max_num_entries), max_text_size_(max_text_size) {}
+
+absl::StatusOr<std::vector<int>> TokenIdCache::TextToTokenIds(
+    Tokenizer& tokenizer, absl::string_view text) {
+  const bool is_cacheable =
+      max_num_entries_ > 0 && text.size() <= max_text_size_;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (auto it = is_cacheable ? index_.find(text) : index_.end();
+        it != index_.end()) {
+      ++num_hits_;
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return it->second->token_ids;
+    }
+    ++num_misses_;
+  }
+  // Tokenized without the lock, the concurrent misses of the same text insert
+  // it once.
+  ASSIGN_OR_RETURN(std::vector<int> token_ids, tokenizer.TextToTokenIds(text));
+  if (!is_cacheable) {
+    return token_ids;
+  }
+  absl::MutexLock lock(&mutex_);
+  if (index_.contains(text)) {
+    return token_ids;
+  }
+  if (entries_.size() >= max_num_entries_) {
+    index_.erase(entries_.back().text);
+    entries_.pop_back();
+  }
+  entries_.push_front(Entry{std::string(text), token_ids});
+  index_[entries_.front().text] = entries_.begin();
+  return token_ids;
+}
+
+int TokenIdCache::GetNumEntries() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+int64_t TokenIdCache::GetNumHits() const {
+  absl::MutexLock lock(&mutex_);
+  return num_hits_;
+}
+
+int64_t TokenIdCache::GetNumMisses() const {
+  absl::MutexLock lock(&mutex_);
+  return num_misses_;
+}
+
+int TokenIdCache::Clear() {
+  absl::MutexLock lock(&mutex_);
+  const int num_entries = entries_.size();
+  index_.clear();
+  entries_.clear();
+  return num_entries;
+}
+
+}  // namespace litert::lm
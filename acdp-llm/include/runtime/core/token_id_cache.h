@@ -0,0 +1,94 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_TOKEN_ID_CACHE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_TOKEN_ID_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+
+namespace litert::lm {
+
+// An engine-wide cache of the token ids of the texts prefilled by the
+// sessions. The constant parts of the prompts, e.g. the prompt templates
+// around the non-text contents and the repeated system instructions, are
+// tokenized once instead of on every turn. The least recently used entries
+// are evicted to stay within the entry budget.
+//
+// All the lookups must tokenize with the same tokenizer, the cache is keyed by
+// the text alone.
+//
+// The class is thread-safe.
+class TokenIdCache {
+ public:
+  // Creates a cache of up to `max_num_entries` texts. Texts longer than
+  // `max_text_size` bytes, which are unlikely to repeat, are not cached.
+  explicit TokenIdCache(int max_num_entries,
+                        int max_text_size = kDefaultMaxTextSize);
+
+  TokenIdCache(const TokenIdCache&) = delete;
+  TokenIdCache& operator=(const TokenIdCache&) = delete;
+
+  // Returns the token ids of `text`, tokenized with `tokenizer` if it is not
+  // cached.
+  absl::StatusOr<std::vector<int>> TextToTokenIds(Tokenizer& tokenizer,
+                                                  absl::string_view text);
+
+  // Returns the number of cached texts.
+  int GetNumEntries() const;
+
+  // Returns the numbers of texts which were and were not cached when looked
+  // up since the cache was created. The texts too long to be cached are
+  // misses.
+  int64_t GetNumHits() const;
+  int64_t GetNumMisses() const;
+
+  // Drops all the texts, e.g. under memory pressure, and returns their
+  // number.
+  int Clear();
+
+  static constexpr int kDefaultMaxNumEntries = 256;
+  static constexpr int kDefaultMaxTextSize = 4096;
+
+ private:
+  struct Entry {
+    std::string text;
+    std::vector<int> token_ids;
+  };
+
+  const int max_num_entries_;
+  const int max_text_size_;
+
+  mutable absl::Mutex mutex_;
+  // The entries, most recently used first. The list keeps the texts indexed
+  // by `index_` at stable addresses.
+  std::list<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<absl::string_view, std::list<Entry>::iterator> index_
+      ABSL_GUARDED_BY(mutex_);
+  int64_t num_hits_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t num_misses_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_TOKEN_ID_CACHE_H_
@@ -0,0 +1,103 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/token_id_cache.h"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::Return;
+using ::testing::status::StatusIs;
+
+class MockTokenizer : public Tokenizer {
+ public:
+  MOCK_METHOD(absl::StatusOr<std::vector<int>>, TextToTokenIds,
+              (absl::string_view text), (override));
+  MOCK_METHOD(absl::StatusOr<std::string>, TokenIdsToText,
+              (const std::vector<int>& token_ids), (override));
+  MOCK_METHOD(absl::StatusOr<int>, TokenToId, (absl::string_view token),
+              (override));
+  MOCK_METHOD(TokenizerType, GetTokenizerType, (), (const, override));
+};
+
+TEST(TokenIdCacheTest, TokenizesACachedTextOnce) {
+  MockTokenizer tokenizer;
+  EXPECT_CALL(tokenizer, TextToTokenIds(Eq("<start>user\n")))
+      .WillOnce(Return(std::vector<int>{1, 2}));
+  TokenIdCache cache(/*max_num_entries=*/2);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK_AND_ASSIGN(auto token_ids,
+                         cache.TextToTokenIds(tokenizer, "<start>user\n"));
+    EXPECT_THAT(token_ids, ElementsAre(1, 2));
+  }
+  EXPECT_EQ(cache.GetNumEntries(), 1);
+  EXPECT_EQ(cache.GetNumHits(), 2);
+  EXPECT_EQ(cache.GetNumMisses(), 1);
+}
+
+TEST(TokenIdCacheTest, EvictsTheLeastRecentlyUsedText) {
+  MockTokenizer tokenizer;
+  EXPECT_CALL(tokenizer, TextToTokenIds(Eq("a")))
+      .WillOnce(Return(std::vector<int>{1}));
+  EXPECT_CALL(tokenizer, TextToTokenIds(Eq("b")))
+      .Times(2)
+      .WillRepeatedly(Return(std::vector<int>{2}));
+  EXPECT_CALL(tokenizer, TextToTokenIds(Eq("c")))
+      .WillOnce(Return(std::vector<int>{3}));
+  TokenIdCache cache(/*max_num_entries=*/2);
+  EXPECT_OK(cache.TextToTokenIds(tokenizer, "a"));
+  EXPECT_OK(cache.TextToTokenIds(tokenizer, "b"));
+  // Uses "a", so that "b" is evicted by "c".
+  EXPECT_OK(cache.TextToTokenIds(tokenizer, "a"));
+  EXPECT_OK(cache.TextToTokenIds(tokenizer, "c"));
+  EXPECT_OK(cache.TextToTokenIds(tokenizer, "a"));
+  EXPECT_OK(cache.TextToTokenIds(tokenizer, "b"));
+  EXPECT_EQ(cache.GetNumEntries(), 2);
+}
+
+TEST(TokenIdCacheTest, DoesNotCacheLongTextsOrErrors) {
+  MockTokenizer tokenizer;
+  EXPECT_CALL(tokenizer, TextToTokenIds(Eq("long text")))
+      .Times(2)
+      .WillRepeatedly(Return(std::vector<int>{1, 2}));
+  EXPECT_CALL(tokenizer, TextToTokenIds(Eq("bad")))
+      .Times(2)
+      .WillRepeatedly(Return(absl::InternalError("Failed to tokenize.")));
+  TokenIdCache cache(/*max_num_entries=*/2, /*max_text_size=*/4);
+  EXPECT_OK(cache.TextToTokenIds(tokenizer, "long text"));
+  EXPECT_OK(cache.TextToTokenIds(tokenizer, "long text"));
+  EXPECT_THAT(cache.TextToTokenIds(tokenizer, "bad"),
+              StatusIs(absl::StatusCode::kInternal));
+  EXPECT_THAT(cache.TextToTokenIds(tokenizer, "bad"),
+              StatusIs(absl::StatusCode::kInternal));
+  EXPECT_EQ(cache.GetNumEntries(), 0);
+  EXPECT_EQ(cache.GetNumHits(), 0);
+  EXPECT_EQ(cache.GetNumMisses(), 4);
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,202 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/token_text_table.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/util/memory_mapped_file.h"
+#include "runtime/util/model_cache.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+// The SentencePiece meta symbol for a space.
+constexpr absl::string_view kMetaSpace = "▁";
+
+constexpr char kMagic[4] = {'L', 'T', 'T', 'T'};
+constexpr uint32_t kVersion = 1;
+// The magic, the version, the number of tokens and of text bytes.
+constexpr size_t kHeaderSize = 16;
+
+void AppendUint32(uint32_t value, std::string& data) {
+  data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+uint32_t ReadUint32(absl::string_view data, size_t offset) {
+  uint32_t value;
+  std::memcpy(&value, data.data() + offset, sizeof(value));
+  return value;
+}
+
+// Returns the id of the byte-fallback token of `byte`, or -1 if the
+// vocabulary has none. A tokenizer may return its unknown token for the
+// missing pieces, so the token must decode to the byte itself, or to an
+// incomplete sequence for the bytes out of ASCII.
+int GetByteTokenId(Tokenizer& tokenizer, int num_tokens, uint8_t byte) {
+  absl::StatusOr<int> token_id =
+      tokenizer.TokenToId(absl::StrFormat("<0x%02X>", byte));
+  if (!token_id.ok() || *token_id < 0 || *token_id >= num_tokens) {
+    return -1;
+  }
+  absl::StatusOr<std::string> text = tokenizer.TokenIdsToText({*token_id});
+  if (byte >= 0x80 ? Tokenizer::IsIncompleteBpeSequence(text)
+                   : text.ok() && *text == std::string(1, byte)) {
+    return *token_id;
+  }
+  return -1;
+}
+
+}  // namespace
+
+void AppendWithSpaces(absl::string_view text, std::string& output) {
+  for (size_t pos = text.find(kMetaSpace); pos != absl::string_view::npos;
+       pos = text.find(kMetaSpace)) {
+    output.append(text.data(), pos);
+    output.push_back(' ');
+    text.remove_prefix(pos + kMetaSpace.size());
+  }
+  output.append(text.data(), text.size());
+}
+
+absl::StatusOr<std::unique_ptr<TokenTextTable>> TokenTextTable::Build(
+    Tokenizer& tokenizer, int num_tokens) {
+  if (num_tokens <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid number of tokens: ", num_tokens));
+  }
+  std::vector<uint8_t> kinds(num_tokens,
+                             static_cast<uint8_t>(Kind::kFallback));
+  std::vector<int> bytes(num_tokens, -1);
+  for (int byte = 0; byte < 256; ++byte) {
+    const int token_id = GetByteTokenId(tokenizer, num_tokens, byte);
+    if (token_id >= 0) {
+      kinds[token_id] = static_cast<uint8_t>(Kind::kByte);
+      bytes[token_id] = byte;
+    }
+  }
+
+  std::vector<uint32_t> offsets(num_tokens + 1);
+  std::string texts;
+  for (int token_id = 0; token_id < num_tokens; ++token_id) {
+    offsets[token_id] = texts.size();
+    if (kinds[token_id] == static_cast<uint8_t>(Kind::kByte)) {
+      texts.push_back(static_cast<char>(bytes[token_id]));
+      continue;
+    }
+    absl::StatusOr<std::string> text = tokenizer.TokenIdsToText({token_id});
+    if (text.ok()) {
+      AppendWithSpaces(*text, texts);
+      kinds[token_id] = static_cast<uint8_t>(Kind::kText);
+    }
+  }
+  offsets[num_tokens] = texts.size();
+
+  auto table = absl::WrapUnique(new TokenTextTable());
+  std::string& data = table->owned_data_;
+  data.reserve(kHeaderSize + offsets.size() * sizeof(uint32_t) +
+               kinds.size() + texts.size());
+  data.append(kMagic, sizeof(kMagic));
+  AppendUint32(kVersion, data);
+  AppendUint32(num_tokens, data);
+  AppendUint32(texts.size(), data);
+  data.append(reinterpret_cast<const char*>(offsets.data()),
+              offsets.size() * sizeof(uint32_t));
+  data.append(reinterpret_cast<const char*>(kinds.data()), kinds.size());
+  data.append(texts);
+  RETURN_IF_ERROR(table->Init(data));
+  return table;
+}
+
+absl::StatusOr<std::unique_ptr<TokenTextTable>> TokenTextTable::Load(
+    absl::string_view path) {
+  auto table = absl::WrapUnique(new TokenTextTable());
+  ASSIGN_OR_RETURN(table->file_, MemoryMappedFile::Create(path));
+  RETURN_IF_ERROR(table->Init(
+      absl::string_view(static_cast<const char*>(table->file_->data()),
+                        table->file_->length())));
+  return table;
+}
+
+absl::StatusOr<std::unique_ptr<TokenTextTable>> TokenTextTable::LoadOrBuild(
+    Tokenizer& tokenizer, int num_tokens, absl::string_view path) {
+  if (!path.empty()) {
+    absl::StatusOr<std::unique_ptr<TokenTextTable>> table = Load(path);
+    if (table.ok() && (*table)->GetNumTokens() == num_tokens) {
+      return table;
+    }
+  }
+  ASSIGN_OR_RETURN(auto table, Build(tokenizer, num_tokens));
+  if (!path.empty()) {
+    // The table is only built again by the next engines.
+    if (auto status = WriteFileAtomically(path, table->Serialize());
+        !status.ok()) {
+      ABSL_LOG(WARNING) << "Failed to write the token text table to " << path
+                        << ": " << status;
+    }
+  }
+  return table;
+}
+
+absl::Status TokenTextTable::Init(absl::string_view data) {
+  if (data.size() < kHeaderSize ||
+      std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+    return absl::DataLossError("Not a token text table.");
+  }
+  if (ReadUint32(data, 4) != kVersion) {
+    return absl::DataLossError(absl::StrCat(
+        "Unsupported token text table version: ", ReadUint32(data, 4)));
+  }
+  const uint64_t num_tokens = ReadUint32(data, 8);
+  const uint64_t num_text_bytes = ReadUint32(data, 12);
+  const uint64_t offsets_size = (num_tokens + 1) * sizeof(uint32_t);
+  if (data.size() != kHeaderSize + offsets_size + num_tokens + num_text_bytes) {
+    return absl::DataLossError("Truncated token text table.");
+  }
+  data_ = data;
+  offsets_ = absl::MakeConstSpan(
+      reinterpret_cast<const uint32_t*>(data.data() + kHeaderSize),
+      num_tokens + 1);
+  kinds_ = absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(
+                                   data.data() + kHeaderSize + offsets_size),
+                               num_tokens);
+  texts_ = data.substr(kHeaderSize + offsets_size + num_tokens);
+  for (uint64_t i = 0; i < num_tokens; ++i) {
+    if (offsets_[i] > offsets_[i + 1] ||
+        kinds_[i] > static_cast<uint8_t>(Kind::kFallback)) {
+      return absl::DataLossError("Corrupted token text table.");
+    }
+  }
+  if (offsets_[0] != 0 || offsets_[num_tokens] != num_text_bytes) {
+    return absl::DataLossError("Corrupted token text table.");
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace litert::lm
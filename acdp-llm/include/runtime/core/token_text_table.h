@@ -0,0 +1,117 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_TOKEN_TEXT_TABLE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_TOKEN_TEXT_TABLE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/util/memory_mapped_file.h"
+
+namespace litert::lm {
+
+// Appends `text` decoded by a tokenizer to `output`, with the SentencePiece
+// "▁" meta symbols replaced by spaces.
+void AppendWithSpaces(absl::string_view text, std::string& output);
+
+// The UTF-8 bytes of every token of a vocabulary decoded on its own, so that
+// streaming a token is a lookup instead of a call into the tokenizer. The
+// texts have their meta symbols already replaced by spaces, and the
+// byte-fallback tokens ("<0xE2>") map to their single byte, to be assembled
+// into UTF-8 characters by the caller. The tokens which do not decode on
+// their own are left to the tokenizer.
+//
+// The table is built once per tokenizer, and kept in a file mapped by the
+// next engines loading the same model. Its in-memory layout is the file
+// layout:
+//   char magic[4] = "LTTT"; uint32_t version; uint32_t num_tokens;
+//   uint32_t num_text_bytes; uint32_t offsets[num_tokens + 1];
+//   uint8_t kinds[num_tokens]; char texts[num_text_bytes];
+// the text of token i spanning [offsets[i], offsets[i + 1]) of `texts`.
+//
+// The class is immutable, thus thread-safe.
+class TokenTextTable {
+ public:
+  enum class Kind : uint8_t {
+    // The token decodes to a complete text on its own.
+    kText = 0,
+    // A byte-fallback token, its text is a single byte of a UTF-8 character.
+    kByte = 1,
+    // The token must be decoded by the tokenizer, with its neighbors.
+    kFallback = 2,
+  };
+
+  // Decodes the tokens [0, num_tokens) with `tokenizer`.
+  static absl::StatusOr<std::unique_ptr<TokenTextTable>> Build(
+      Tokenizer& tokenizer, int num_tokens);
+
+  // Maps a table written with Serialize().
+  static absl::StatusOr<std::unique_ptr<TokenTextTable>> Load(
+      absl::string_view path);
+
+  // Maps the table at `path` if it holds `num_tokens` tokens, or builds it
+  // and writes it there for the next loads. An empty `path` only builds it.
+  static absl::StatusOr<std::unique_ptr<TokenTextTable>> LoadOrBuild(
+      Tokenizer& tokenizer, int num_tokens, absl::string_view path);
+
+  TokenTextTable(const TokenTextTable&) = delete;
+  TokenTextTable& operator=(const TokenTextTable&) = delete;
+
+  int GetNumTokens() const { return kinds_.size(); }
+
+  // Returns kFallback for the token ids out of the vocabulary.
+  Kind GetKind(int token_id) const {
+    return token_id >= 0 && token_id < kinds_.size()
+               ? static_cast<Kind>(kinds_[token_id])
+               : Kind::kFallback;
+  }
+
+  // Returns the text of a kText or kByte token, empty for the others.
+  absl::string_view GetText(int token_id) const {
+    if (token_id < 0 || token_id >= kinds_.size()) {
+      return absl::string_view();
+    }
+    return texts_.substr(offsets_[token_id],
+                         offsets_[token_id + 1] - offsets_[token_id]);
+  }
+
+  // Returns the table in the layout read by Load().
+  absl::string_view Serialize() const { return data_; }
+
+ private:
+  TokenTextTable() = default;
+
+  // Points the views at `data`, which must outlive the table.
+  absl::Status Init(absl::string_view data);
+
+  // Holds the data of a built table, or maps the one of a loaded table.
+  std::string owned_data_;
+  std::unique_ptr<MemoryMappedFile> file_;
+
+  absl::string_view data_;
+  absl::Span<const uint32_t> offsets_;
+  absl::Span<const uint8_t> kinds_;
+  absl::string_view texts_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_TOKEN_TEXT_TABLE_H_
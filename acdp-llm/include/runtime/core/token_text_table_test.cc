@@ -0,0 +1,133 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/token_text_table.h"
+
+#include <filesystem>  // NOLINT
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/util/model_cache.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::StatusIs;
+
+using Kind = TokenTextTable::Kind;
+
+// A vocabulary of 4 tokens: a word, the byte-fallback tokens of "é" (0xC3
+// 0xA9), and a token only decoding with its neighbors.
+class FakeTokenizer : public Tokenizer {
+ public:
+  absl::StatusOr<std::vector<int>> TextToTokenIds(
+      absl::string_view text) override {
+    return absl::UnimplementedError("Not needed.");
+  }
+
+  absl::StatusOr<int> TokenToId(absl::string_view token) override {
+    if (token == "<0xC3>") {
+      return 1;
+    }
+    if (token == "<0xA9>") {
+      return 2;
+    }
+    // The unknown token, as returned by SentencePiece.
+    return 0;
+  }
+
+  absl::StatusOr<std::string> TokenIdsToText(
+      const std::vector<int>& token_ids) override {
+    ++num_decodes;
+    if (token_ids == std::vector<int>{0}) {
+      return "▁Hello";
+    }
+    if (token_ids == std::vector<int>{1, 2}) {
+      return "é";
+    }
+    if (token_ids == std::vector<int>{3}) {
+      return absl::InternalError("Needs its neighbors.");
+    }
+    return absl::DataLossError("Incomplete BPE sequence");
+  }
+
+  TokenizerType GetTokenizerType() const override {
+    return TokenizerType::kUnspecified;
+  }
+
+  int num_decodes = 0;
+};
+
+TEST(TokenTextTableTest, BuildsTheTextsOfTheTokens) {
+  FakeTokenizer tokenizer;
+  ASSERT_OK_AND_ASSIGN(auto table,
+                       TokenTextTable::Build(tokenizer, /*num_tokens=*/4));
+  EXPECT_EQ(table->GetNumTokens(), 4);
+  EXPECT_EQ(table->GetKind(0), Kind::kText);
+  EXPECT_EQ(table->GetText(0), " Hello");
+  EXPECT_EQ(table->GetKind(1), Kind::kByte);
+  EXPECT_EQ(table->GetText(1), "\xC3");
+  EXPECT_EQ(table->GetKind(2), Kind::kByte);
+  EXPECT_EQ(table->GetText(2), "\xA9");
+  EXPECT_EQ(table->GetKind(3), Kind::kFallback);
+  EXPECT_EQ(table->GetText(3), "");
+  EXPECT_EQ(table->GetKind(4), Kind::kFallback);
+  EXPECT_EQ(table->GetKind(-1), Kind::kFallback);
+}
+
+TEST(TokenTextTableTest, LoadsTheTableWrittenByTheFirstBuild) {
+  const std::string path =
+      (std::filesystem::path(::testing::TempDir()) / "token_text_table.bin")
+          .string();
+  std::filesystem::remove(path);
+  FakeTokenizer tokenizer;
+  ASSERT_OK_AND_ASSIGN(
+      auto built, TokenTextTable::LoadOrBuild(tokenizer, /*num_tokens=*/4,
+                                              path));
+  const int num_build_decodes = tokenizer.num_decodes;
+  EXPECT_GT(num_build_decodes, 0);
+
+  ASSERT_OK_AND_ASSIGN(
+      auto loaded, TokenTextTable::LoadOrBuild(tokenizer, /*num_tokens=*/4,
+                                               path));
+  EXPECT_EQ(tokenizer.num_decodes, num_build_decodes);
+  EXPECT_EQ(loaded->Serialize(), built->Serialize());
+  EXPECT_EQ(loaded->GetText(0), " Hello");
+
+  // A table of another vocabulary size is built again.
+  ASSERT_OK_AND_ASSIGN(
+      auto rebuilt, TokenTextTable::LoadOrBuild(tokenizer, /*num_tokens=*/3,
+                                                path));
+  EXPECT_EQ(rebuilt->GetNumTokens(), 3);
+  EXPECT_GT(tokenizer.num_decodes, num_build_decodes);
+}
+
+TEST(TokenTextTableTest, RejectsCorruptedTables) {
+  const std::string path =
+      (std::filesystem::path(::testing::TempDir()) / "corrupted_table.bin")
+          .string();
+  ASSERT_OK(WriteFileAtomically(path, "LTTT but not a table"));
+  EXPECT_THAT(TokenTextTable::Load(path),
+              StatusIs(absl::StatusCode::kDataLoss));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,100 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/vectorized_image_preprocessor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "litert/c/litert_tensor_buffer_types.h"  // from @litert
+#include "litert/cc/litert_element_type.h"  // from @litert
+#include "litert/cc/litert_layout.h"  // from @litert
+#include "litert/cc/litert_macros.h"  // from @litert
+#include "litert/cc/litert_ranked_tensor_type.h"  // from @litert
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/components/preprocessor/image_preprocessor.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/status_macros.h"  // IWYU pragma: keep
+#include "stb_image.h"  // from @stb
+
+namespace litert::lm {
+
+absl::StatusOr<InputImage> VectorizedImagePreprocessor::Preprocess(
+    const InputImage& input_image, const ImagePreprocessParameter& parameter) {
+  if (input_image.IsTensorBuffer()) {
+    ASSIGN_OR_RETURN(const auto* image_tensor,
+                     input_image.GetPreprocessedImageTensor());
+    LITERT_ASSIGN_OR_RETURN(auto image_tensor_copy, image_tensor->Duplicate());
+    return InputImage(std::move(image_tensor_copy));
+  }
+
+  const Dimensions& target_dimensions = parameter.GetTargetDimensions();
+  if (target_dimensions.size() != 4 || target_dimensions[0] != 1 ||
+      target_dimensions[3] != 3) {
+    return absl::InvalidArgumentError(
+        "The target dimensions must be [1, height, width, 3].");
+  }
+  const int target_height = target_dimensions[1];
+  const int target_width = target_dimensions[2];
+
+  ASSIGN_OR_RETURN(absl::string_view image_bytes,
+                   input_image.GetRawImageBytes());
+  int width = 0;
+  int height = 0;
+  int channels = 0;
+  // Decoded with the channels of the image, which the kernels convert to RGB
+  // while resizing.
+  std::unique_ptr<stbi_uc, void (*)(void*)> decoded_image(
+      stbi_load_from_memory(
+          reinterpret_cast<const stbi_uc*>(image_bytes.data()),
+          image_bytes.size(), &width, &height, &channels,
+          /*desired_channels=*/0),
+      stbi_image_free);
+  if (decoded_image == nullptr) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Failed to decode the image: ", stbi_failure_reason()));
+  }
+
+  const size_t num_pixels =
+      static_cast<size_t>(target_height) * target_width * 3;
+  LITERT_ASSIGN_OR_RETURN(
+      auto image_tensor,
+      TensorBuffer::CreateManaged(
+          kLiteRtTensorBufferTypeHostMemory,
+          ::litert::RankedTensorType(
+              ::litert::ElementType::Float32,
+              ::litert::Layout(Dimensions(target_dimensions))),
+          num_pixels * sizeof(float)));
+  {
+    LITERT_ASSIGN_OR_RETURN(auto image_lock_and_addr,
+                            ::litert::TensorBufferScopedLock::Create(
+                                image_tensor, TensorBuffer::LockMode::kWrite));
+    RETURN_IF_ERROR(kernels_.ResizeAndNormalize(
+        absl::MakeConstSpan(decoded_image.get(),
+                            static_cast<size_t>(height) * width * channels),
+        height, width, channels, target_height, target_width,
+        absl::MakeSpan(static_cast<float*>(image_lock_and_addr.second),
+                       num_pixels)));
+  }
+  return InputImage(std::move(image_tensor));
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,52 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_VECTORIZED_IMAGE_PREPROCESSOR_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_VECTORIZED_IMAGE_PREPROCESSOR_H_
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "runtime/components/preprocessor/image_preprocessor.h"
+#include "runtime/core/image_kernels.h"
+#include "runtime/engine/io_types.h"
+
+namespace litert::lm {
+
+// An ImagePreprocessor decoding the images like StbImagePreprocessor, but
+// resizing and normalizing them with the vectorized ImageKernels, in a single
+// pass from the decoded bytes to the float tensor. Meant for the large images,
+// e.g. screenshots, on the CPUs where the scalar resampling costs about as
+// much as the vision encoder.
+//
+// The resampling filter differs from stb_image_resize's, so the tensors are
+// close to, but not the same as, the ones of StbImagePreprocessor.
+class VectorizedImagePreprocessor : public ImagePreprocessor {
+ public:
+  VectorizedImagePreprocessor() : kernels_(ImageKernels::Get()) {}
+  explicit VectorizedImagePreprocessor(const ImageKernels& kernels)
+      : kernels_(kernels) {}
+
+  // Decodes the image and resizes it to the [1, height, width, 3] target
+  // dimensions of `parameter`. An image already preprocessed into a tensor is
+  // returned as is.
+  absl::StatusOr<InputImage> Preprocess(
+      const InputImage& input_image,
+      const ImagePreprocessParameter& parameter) override;
+
+ private:
+  const ImageKernels& kernels_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_CORE_VECTORIZED_IMAGE_PREPROCESSOR_H_
@@ -0,0 +1,118 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/core/vectorized_image_preprocessor.h"
+
+#include <cmath>
+#include <filesystem>  // NOLINT: Required for path manipulation.
+#include <fstream>
+#include <ios>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "litert/cc/litert_layout.h"  // from @litert
+#include "runtime/components/preprocessor/image_preprocessor.h"
+#include "runtime/components/preprocessor/stb_image_preprocessor.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/convert_tensor_buffer.h"
+#include "runtime/util/tensor_buffer_util.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::status::StatusIs;
+
+constexpr char kImageTestdataDir[] =
+    "litert_lm/runtime/components/preprocessor/testdata/";
+
+std::string ReadImage(absl::string_view file_name) {
+  std::ifstream ifstr(
+      std::filesystem::path(::testing::SrcDir()) / kImageTestdataDir /
+          std::string(file_name),
+      std::ios::binary);
+  std::stringstream contents;
+  contents << ifstr.rdbuf();
+  return contents.str();
+}
+
+TEST(VectorizedImagePreprocessorTest, IsCloseToStbImagePreprocessor) {
+  ImagePreprocessParameter parameter;
+  parameter.SetTargetDimensions(Dimensions({1, 224, 128, 3}));
+  VectorizedImagePreprocessor preprocessor;
+  ASSERT_OK_AND_ASSIGN(
+      InputImage image,
+      preprocessor.Preprocess(InputImage(ReadImage("apple.png")), parameter));
+  StbImagePreprocessor stb_preprocessor;
+  ASSERT_OK_AND_ASSIGN(InputImage expected_image,
+                       stb_preprocessor.Preprocess(
+                           InputImage(ReadImage("apple.png")), parameter));
+
+  ASSERT_OK_AND_ASSIGN(const auto* image_tensor,
+                       image.GetPreprocessedImageTensor());
+  ASSERT_OK_AND_ASSIGN(const auto* expected_image_tensor,
+                       expected_image.GetPreprocessedImageTensor());
+  EXPECT_THAT(TensorBufferDims(*image_tensor), ElementsAre(1, 224, 128, 3));
+  auto pixels = ReferTensorBufferAsSpan<float>(*image_tensor);
+  auto expected_pixels = ReferTensorBufferAsSpan<float>(*expected_image_tensor);
+  ASSERT_TRUE(pixels.HasValue());
+  ASSERT_TRUE(expected_pixels.HasValue());
+  ASSERT_EQ(pixels->size(), expected_pixels->size());
+  double total_difference = 0.0;
+  for (int i = 0; i < pixels->size(); ++i) {
+    total_difference += std::abs((*pixels)[i] - (*expected_pixels)[i]);
+  }
+  // The filters differ, but not the pictures.
+  EXPECT_LT(total_difference / pixels->size(), 0.02);
+}
+
+TEST(VectorizedImagePreprocessorTest, KeepsThePreprocessedImages) {
+  ImagePreprocessParameter parameter;
+  parameter.SetTargetDimensions(Dimensions({1, 2, 2, 3}));
+  VectorizedImagePreprocessor preprocessor;
+  auto tensor = CopyToTensorBuffer<float>({1.0f, 2.0f}, {1, 2});
+  ASSERT_TRUE(tensor.HasValue());
+  ASSERT_OK_AND_ASSIGN(
+      InputImage image,
+      preprocessor.Preprocess(InputImage(std::move(*tensor)), parameter));
+  ASSERT_OK_AND_ASSIGN(const auto* image_tensor,
+                       image.GetPreprocessedImageTensor());
+  EXPECT_THAT(TensorBufferDims(*image_tensor), ElementsAre(1, 2));
+}
+
+TEST(VectorizedImagePreprocessorTest, FailsOnUnsupportedTargetDimensions) {
+  ImagePreprocessParameter parameter;
+  parameter.SetTargetDimensions(Dimensions({1, 3, 224, 224}));
+  VectorizedImagePreprocessor preprocessor;
+  EXPECT_THAT(
+      preprocessor.Preprocess(InputImage(ReadImage("apple.png")), parameter),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(VectorizedImagePreprocessorTest, FailsOnInvalidImages) {
+  ImagePreprocessParameter parameter;
+  parameter.SetTargetDimensions(Dimensions({1, 224, 224, 3}));
+  VectorizedImagePreprocessor preprocessor;
+  EXPECT_THAT(preprocessor.Preprocess(InputImage(std::string("not an image")), parameter),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,111 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/batch_tokenizer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/blocking_counter.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/framework/threadpool.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+
+absl::StatusOr<std::unique_ptr<BatchTokenizer>> BatchTokenizer::Create(
+    Tokenizer& tokenizer, int num_threads) {
+  if (num_threads <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid number of tokenizer threads: ", num_threads));
+  }
+  std::unique_ptr<ThreadPool> thread_pool;
+  if (num_threads > 1) {
+    thread_pool = std::make_unique<ThreadPool>(/*name_prefix=*/"tokenizer",
+                                               /*max_num_threads=*/num_threads);
+  }
+  return absl::WrapUnique(
+      new BatchTokenizer(tokenizer, num_threads, std::move(thread_pool)));
+}
+
+absl::StatusOr<std::vector<std::vector<int>>> BatchTokenizer::TextToTokenIds(
+    absl::Span<const absl::string_view> texts) {
+  std::vector<std::vector<int>> token_ids(texts.size());
+  const size_t num_shards =
+      std::min(texts.size(), static_cast<size_t>(num_threads_));
+  if (thread_pool_ == nullptr || num_shards < 2) {
+    for (size_t i = 0; i < texts.size(); ++i) {
+      ASSIGN_OR_RETURN(token_ids[i], tokenizer_.TextToTokenIds(texts[i]));
+    }
+    return token_ids;
+  }
+
+  // Each shard records its first error, the first one in the order of the
+  // texts is returned.
+  std::vector<absl::Status> statuses(num_shards);
+  absl::BlockingCounter num_pending_shards(num_shards);
+  absl::Status schedule_status;
+  for (size_t shard = 0; shard < num_shards; ++shard) {
+    const size_t begin = texts.size() * shard / num_shards;
+    const size_t end = texts.size() * (shard + 1) / num_shards;
+    auto tokenize_shard = [this, texts, begin, end, &token_ids,
+                           &status = statuses[shard], &num_pending_shards]() {
+      for (size_t i = begin; i < end; ++i) {
+        auto shard_token_ids = tokenizer_.TextToTokenIds(texts[i]);
+        if (!shard_token_ids.ok()) {
+          status = shard_token_ids.status();
+          break;
+        }
+        token_ids[i] = *std::move(shard_token_ids);
+      }
+      num_pending_shards.DecrementCount();
+    };
+    if (schedule_status.ok()) {
+      schedule_status = thread_pool_->Schedule(std::move(tokenize_shard));
+    }
+    // The shards not scheduled are done, the scheduled ones are waited for.
+    if (!schedule_status.ok()) {
+      num_pending_shards.DecrementCount();
+    }
+  }
+  num_pending_shards.Wait();
+  RETURN_IF_ERROR(schedule_status);
+  for (const absl::Status& status : statuses) {
+    RETURN_IF_ERROR(status);
+  }
+  return token_ids;
+}
+
+absl::StatusOr<std::vector<int>> BatchTokenizer::CountTokens(
+    absl::Span<const absl::string_view> texts) {
+  ASSIGN_OR_RETURN(std::vector<std::vector<int>> token_ids,
+                   TextToTokenIds(texts));
+  std::vector<int> num_tokens;
+  num_tokens.reserve(token_ids.size());
+  for (const std::vector<int>& ids : token_ids) {
+    num_tokens.push_back(static_cast<int>(ids.size()));
+  }
+  return num_tokens;
+}
+
+}  // namespace litert::lm
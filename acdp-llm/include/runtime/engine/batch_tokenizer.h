@@ -0,0 +1,77 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_BATCH_TOKENIZER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_BATCH_TOKENIZER_H_
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/framework/threadpool.h"
+
+namespace litert::lm {
+
+// BatchTokenizer tokenizes batches of texts on a pool of threads, without
+// creating a session, e.g. for a router counting the tokens of the prompts
+// of many requests to pick a model and enforce a budget.
+//
+// The texts of a batch are split into one contiguous shard per thread. A
+// batch smaller than two shards is tokenized on the calling thread.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(Tokenizer * tokenizer, engine->GetTokenizer());
+//   ASSIGN_OR_RETURN(auto batch_tokenizer,
+//                    BatchTokenizer::Create(*tokenizer, /*num_threads=*/4));
+//   ASSIGN_OR_RETURN(std::vector<int> num_tokens,
+//                    batch_tokenizer->CountTokens(prompts));
+//
+// The class is thread-safe if the tokenizer is, like the tokenizer of an
+// engine. The tokenizer must outlive the BatchTokenizer.
+class BatchTokenizer {
+ public:
+  // Creates a BatchTokenizer of `tokenizer` with `num_threads` threads.
+  static absl::StatusOr<std::unique_ptr<BatchTokenizer>> Create(
+      Tokenizer& tokenizer, int num_threads);
+
+  // Returns the token ids of each of `texts`, in their order.
+  absl::StatusOr<std::vector<std::vector<int>>> TextToTokenIds(
+      absl::Span<const absl::string_view> texts);
+
+  // Returns the number of tokens of each of `texts`, in their order.
+  absl::StatusOr<std::vector<int>> CountTokens(
+      absl::Span<const absl::string_view> texts);
+
+  int GetNumThreads() const { return num_threads_; }
+
+ private:
+  BatchTokenizer(Tokenizer& tokenizer, int num_threads,
+                 std::unique_ptr<ThreadPool> thread_pool)
+      : tokenizer_(tokenizer),
+        num_threads_(num_threads),
+        thread_pool_(std::move(thread_pool)) {}
+
+  Tokenizer& tokenizer_;
+  const int num_threads_;
+  // Null with a single thread.
+  std::unique_ptr<ThreadPool> thread_pool_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_BATCH_TOKENIZER_H_
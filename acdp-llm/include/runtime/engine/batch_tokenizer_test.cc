@@ -0,0 +1,118 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/batch_tokenizer.h"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/numbers.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_join.h"  // from @com_google_absl
+#include "absl/strings/str_split.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::status::StatusIs;
+
+// Maps each word to its size, and fails on the word "fail".
+class WordTokenizer : public Tokenizer {
+ public:
+  absl::StatusOr<std::vector<int>> TextToTokenIds(
+      absl::string_view text) override {
+    std::vector<int> token_ids;
+    for (absl::string_view word :
+         absl::StrSplit(text, ' ', absl::SkipEmpty())) {
+      if (word == "fail") {
+        return absl::InternalError("Failed to tokenize.");
+      }
+      token_ids.push_back(word.size());
+    }
+    return token_ids;
+  }
+
+  absl::StatusOr<int> TokenToId(absl::string_view token) override {
+    int id;
+    return absl::SimpleAtoi(token, &id) ? id : 0;
+  }
+
+  absl::StatusOr<std::string> TokenIdsToText(
+      const std::vector<int>& token_ids) override {
+    return absl::StrJoin(token_ids, " ");
+  }
+
+  TokenizerType GetTokenizerType() const override {
+    return TokenizerType::kUnspecified;
+  }
+};
+
+TEST(BatchTokenizerTest, RejectsNoThreads) {
+  WordTokenizer tokenizer;
+  EXPECT_THAT(BatchTokenizer::Create(tokenizer, /*num_threads=*/0),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(BatchTokenizerTest, TokenizesOnTheCallingThread) {
+  WordTokenizer tokenizer;
+  ASSERT_OK_AND_ASSIGN(auto batch_tokenizer,
+                       BatchTokenizer::Create(tokenizer, /*num_threads=*/1));
+  ASSERT_OK_AND_ASSIGN(auto token_ids,
+                       batch_tokenizer->TextToTokenIds({"a bb", "", "ccc"}));
+  EXPECT_THAT(token_ids,
+              ElementsAre(ElementsAre(1, 2), IsEmpty(), ElementsAre(3)));
+}
+
+TEST(BatchTokenizerTest, KeepsTheOrderOfTheTextsAcrossThreads) {
+  WordTokenizer tokenizer;
+  ASSERT_OK_AND_ASSIGN(auto batch_tokenizer,
+                       BatchTokenizer::Create(tokenizer, /*num_threads=*/4));
+  std::vector<std::string> texts;
+  for (int i = 0; i < 101; ++i) {
+    texts.push_back(absl::StrCat(std::string(i % 7 + 1, 'a'), " ", i));
+  }
+  std::vector<absl::string_view> text_views(texts.begin(), texts.end());
+  ASSERT_OK_AND_ASSIGN(auto token_ids,
+                       batch_tokenizer->TextToTokenIds(text_views));
+  ASSERT_EQ(token_ids.size(), texts.size());
+  for (int i = 0; i < texts.size(); ++i) {
+    EXPECT_THAT(token_ids[i],
+                ElementsAre(i % 7 + 1, absl::StrCat(i).size()));
+  }
+  ASSERT_OK_AND_ASSIGN(auto num_tokens,
+                       batch_tokenizer->CountTokens(text_views));
+  EXPECT_EQ(num_tokens, std::vector<int>(texts.size(), 2));
+}
+
+TEST(BatchTokenizerTest, ReturnsTheErrorOfAText) {
+  WordTokenizer tokenizer;
+  ASSERT_OK_AND_ASSIGN(auto batch_tokenizer,
+                       BatchTokenizer::Create(tokenizer, /*num_threads=*/2));
+  EXPECT_THAT(batch_tokenizer->CountTokens({"a", "b", "fail", "d"}),
+              StatusIs(absl::StatusCode::kInternal));
+  ASSERT_OK_AND_ASSIGN(auto num_tokens, batch_tokenizer->CountTokens({}));
+  EXPECT_THAT(num_tokens, IsEmpty());
+}
+
+}  // namespace
+}  // namespace litert::lm
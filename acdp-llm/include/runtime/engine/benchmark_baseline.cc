@@ -0,0 +1,190 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/benchmark_baseline.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "nlohmann/json.hpp"  // from @nlohmann_json
+#include "runtime/util/model_cache.h"
+
+namespace litert::lm {
+namespace {
+
+using ::nlohmann::json;
+
+// A metric the regression gate compares.
+struct Metric {
+  absl::string_view name;
+  double BenchmarkMetrics::*value;
+  // Whether a larger value is an improvement, e.g. a throughput.
+  bool higher_is_better;
+};
+
+constexpr Metric kMetrics[] = {
+    {"prefill_tokens_per_sec", &BenchmarkMetrics::prefill_tokens_per_sec,
+     true},
+    {"decode_tokens_per_sec", &BenchmarkMetrics::decode_tokens_per_sec, true},
+    {"time_to_first_token_seconds",
+     &BenchmarkMetrics::time_to_first_token_seconds, false},
+    {"peak_memory_mb", &BenchmarkMetrics::peak_memory_mb, false},
+};
+
+json MetricsToJson(const BenchmarkMetrics& metrics) {
+  json metrics_json = json::object();
+  for (const Metric& metric : kMetrics) {
+    metrics_json[std::string(metric.name)] = metrics.*metric.value;
+  }
+  return metrics_json;
+}
+
+BenchmarkMetrics MetricsFromJson(const json& metrics_json) {
+  BenchmarkMetrics metrics;
+  if (!metrics_json.is_object()) {
+    return metrics;
+  }
+  for (const Metric& metric : kMetrics) {
+    metrics.*metric.value = metrics_json.value(std::string(metric.name), 0.0);
+  }
+  return metrics;
+}
+
+}  // namespace
+
+BenchmarkRunSummary SummarizeBenchmarkRuns(
+    const std::vector<BenchmarkMetrics>& runs) {
+  BenchmarkRunSummary summary;
+  summary.num_runs = runs.size();
+  if (runs.empty()) {
+    return summary;
+  }
+  for (const Metric& metric : kMetrics) {
+    std::vector<double> values;
+    for (const BenchmarkMetrics& run : runs) {
+      values.push_back(run.*metric.value);
+    }
+    std::sort(values.begin(), values.end());
+    const size_t middle = values.size() / 2;
+    const double median = values.size() % 2 == 1
+                              ? values[middle]
+                              : (values[middle - 1] + values[middle]) / 2;
+    summary.median.*metric.value = median;
+    summary.relative_spread.*metric.value =
+        median > 0 ? (values.back() - values.front()) / median : 0;
+  }
+  return summary;
+}
+
+absl::StatusOr<BenchmarkRunSummary> LoadBenchmarkBaseline(
+    absl::string_view path) {
+  std::ifstream file{std::string(path)};
+  if (!file.is_open()) {
+    return absl::NotFoundError(
+        absl::StrCat("The benchmark baseline ", path, " does not exist."));
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  const json baseline_json =
+      json::parse(contents.str(), /*cb=*/nullptr, /*allow_exceptions=*/false);
+  if (!baseline_json.is_object() || !baseline_json.contains("median")) {
+    return absl::DataLossError(
+        absl::StrCat("The benchmark baseline ", path, " is invalid."));
+  }
+  BenchmarkRunSummary summary;
+  summary.num_runs = baseline_json.value("num_runs", 0);
+  summary.median = MetricsFromJson(baseline_json["median"]);
+  if (baseline_json.contains("relative_spread")) {
+    summary.relative_spread =
+        MetricsFromJson(baseline_json["relative_spread"]);
+  }
+  return summary;
+}
+
+absl::Status SaveBenchmarkBaseline(absl::string_view path,
+                                   const BenchmarkRunSummary& summary) {
+  const json baseline_json = {
+      {"num_runs", summary.num_runs},
+      {"median", MetricsToJson(summary.median)},
+      {"relative_spread", MetricsToJson(summary.relative_spread)},
+  };
+  return WriteFileAtomically(path, baseline_json.dump(/*indent=*/2));
+}
+
+std::vector<BenchmarkMetricComparison> CompareBenchmarkToBaseline(
+    const BenchmarkRunSummary& baseline, const BenchmarkRunSummary& current,
+    double threshold) {
+  std::vector<BenchmarkMetricComparison> comparisons;
+  for (const Metric& metric : kMetrics) {
+    const double baseline_value = baseline.median.*metric.value;
+    const double current_value = current.median.*metric.value;
+    if (baseline_value <= 0 || current_value <= 0) {
+      continue;
+    }
+    BenchmarkMetricComparison& comparison = comparisons.emplace_back();
+    comparison.name = std::string(metric.name);
+    comparison.baseline = baseline_value;
+    comparison.current = current_value;
+    const double change = (current_value - baseline_value) / baseline_value;
+    comparison.regression = metric.higher_is_better ? -change : change;
+    comparison.tolerance =
+        threshold + std::max(baseline.relative_spread.*metric.value,
+                             current.relative_spread.*metric.value);
+    comparison.regressed = comparison.regression > comparison.tolerance;
+  }
+  return comparisons;
+}
+
+std::string FormatBenchmarkComparison(
+    const std::vector<BenchmarkMetricComparison>& comparisons) {
+  std::string table =
+      absl::StrFormat("%-30s %14s %14s %10s %10s\n", "metric", "baseline",
+                      "current", "change", "tolerance");
+  for (const BenchmarkMetricComparison& comparison : comparisons) {
+    absl::StrAppendFormat(&table, "%-30s %14.3f %14.3f %+9.1f%% %9.1f%%%s\n",
+                          comparison.name, comparison.baseline,
+                          comparison.current,
+                          (comparison.current / comparison.baseline - 1) * 100,
+                          comparison.tolerance * 100,
+                          comparison.regressed ? "  REGRESSED" : "");
+  }
+  return table;
+}
+
+absl::Status CheckBenchmarkComparison(
+    const std::vector<BenchmarkMetricComparison>& comparisons) {
+  std::string regressed;
+  for (const BenchmarkMetricComparison& comparison : comparisons) {
+    if (comparison.regressed) {
+      absl::StrAppend(&regressed, regressed.empty() ? "" : ", ",
+                      comparison.name);
+    }
+  }
+  if (regressed.empty()) {
+    return absl::OkStatus();
+  }
+  return absl::FailedPreconditionError(absl::StrCat(
+      "The benchmark regressed from the baseline: ", regressed, "\n",
+      FormatBenchmarkComparison(comparisons)));
+}
+
+}  // namespace litert::lm
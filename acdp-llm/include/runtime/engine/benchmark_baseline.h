@@ -0,0 +1,94 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_BENCHMARK_BASELINE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_BENCHMARK_BASELINE_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// The measurements of a benchmark run the regression gate compares. A metric
+// of 0 was not measured and is not compared.
+struct BenchmarkMetrics {
+  double prefill_tokens_per_sec = 0;
+  double decode_tokens_per_sec = 0;
+  double time_to_first_token_seconds = 0;
+  double peak_memory_mb = 0;
+};
+
+// The measurements of repeated runs of the same configuration.
+struct BenchmarkRunSummary {
+  int num_runs = 0;
+  // The median of each metric over the runs.
+  BenchmarkMetrics median;
+  // The spread of each metric over the runs, (max - min) / median, 0 for a
+  // single run.
+  BenchmarkMetrics relative_spread;
+};
+
+// Returns the median and spread of each metric of `runs`.
+BenchmarkRunSummary SummarizeBenchmarkRuns(
+    const std::vector<BenchmarkMetrics>& runs);
+
+// Loads the baseline written by SaveBenchmarkBaseline() from `path`. Returns
+// a NotFoundError if the file does not exist.
+absl::StatusOr<BenchmarkRunSummary> LoadBenchmarkBaseline(
+    absl::string_view path);
+
+// Writes `summary` to `path` as JSON, to be loaded as the baseline of later
+// runs.
+absl::Status SaveBenchmarkBaseline(absl::string_view path,
+                                   const BenchmarkRunSummary& summary);
+
+// The comparison of a metric of a run with its baseline.
+struct BenchmarkMetricComparison {
+  std::string name;
+  double baseline = 0;
+  double current = 0;
+  // The relative change of the metric, positive when it got worse, i.e. a
+  // throughput decreased or a latency or memory increased.
+  double regression = 0;
+  // The largest regression tolerated: the threshold plus the spread of the
+  // runs of the baseline or the current measurements, whichever is larger,
+  // so that the noise of the device does not fail the gate.
+  double tolerance = 0;
+  bool regressed = false;
+};
+
+// Compares the medians of `current` with those of `baseline`, tolerating a
+// relative regression of `threshold`, e.g. 0.05 for 5%, on top of the spread
+// of the runs. The metrics one of them did not measure are left out.
+std::vector<BenchmarkMetricComparison> CompareBenchmarkToBaseline(
+    const BenchmarkRunSummary& baseline, const BenchmarkRunSummary& current,
+    double threshold);
+
+// Returns a table of the comparisons, one line per metric, marking the
+// regressions.
+std::string FormatBenchmarkComparison(
+    const std::vector<BenchmarkMetricComparison>& comparisons);
+
+// Returns a FailedPreconditionError listing the regressed metrics if any of
+// `comparisons` regressed.
+absl::Status CheckBenchmarkComparison(
+    const std::vector<BenchmarkMetricComparison>& comparisons);
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_BENCHMARK_BASELINE_H_
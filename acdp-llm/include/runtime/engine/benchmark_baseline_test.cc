@@ -0,0 +1,144 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/benchmark_baseline.h"
+
+#include <filesystem>  // NOLINT: Required for path manipulation.
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::AllOf;
+using ::testing::DoubleNear;
+using ::testing::ElementsAre;
+using ::testing::Field;
+using ::testing::HasSubstr;
+using ::testing::status::StatusIs;
+
+std::string GetTestPath(absl::string_view name) {
+  return (std::filesystem::path(::testing::TempDir()) / std::string(name))
+      .string();
+}
+
+BenchmarkRunSummary GetSummary(double prefill_tokens_per_sec,
+                               double decode_tokens_per_sec,
+                               double time_to_first_token_seconds,
+                               double peak_memory_mb) {
+  BenchmarkRunSummary summary;
+  summary.num_runs = 1;
+  summary.median = {.prefill_tokens_per_sec = prefill_tokens_per_sec,
+                    .decode_tokens_per_sec = decode_tokens_per_sec,
+                    .time_to_first_token_seconds = time_to_first_token_seconds,
+                    .peak_memory_mb = peak_memory_mb};
+  return summary;
+}
+
+TEST(BenchmarkBaselineTest, SummarizeRunsTakesTheMedianAndSpread) {
+  const BenchmarkRunSummary summary = SummarizeBenchmarkRuns({
+      {.prefill_tokens_per_sec = 90, .decode_tokens_per_sec = 10},
+      {.prefill_tokens_per_sec = 110, .decode_tokens_per_sec = 10},
+      {.prefill_tokens_per_sec = 100, .decode_tokens_per_sec = 10},
+  });
+  EXPECT_EQ(summary.num_runs, 3);
+  EXPECT_EQ(summary.median.prefill_tokens_per_sec, 100);
+  EXPECT_DOUBLE_EQ(summary.relative_spread.prefill_tokens_per_sec, 0.2);
+  EXPECT_EQ(summary.median.decode_tokens_per_sec, 10);
+  EXPECT_EQ(summary.relative_spread.decode_tokens_per_sec, 0);
+  EXPECT_EQ(summary.median.peak_memory_mb, 0);
+}
+
+TEST(BenchmarkBaselineTest, SaveAndLoad) {
+  const std::string path = GetTestPath("baseline.json");
+  BenchmarkRunSummary summary = GetSummary(1000, 20, 0.5, 2048);
+  summary.num_runs = 5;
+  summary.relative_spread.decode_tokens_per_sec = 0.1;
+  ASSERT_OK(SaveBenchmarkBaseline(path, summary));
+
+  auto loaded = LoadBenchmarkBaseline(path);
+  ASSERT_OK(loaded);
+  EXPECT_EQ(loaded->num_runs, 5);
+  EXPECT_EQ(loaded->median.prefill_tokens_per_sec, 1000);
+  EXPECT_EQ(loaded->median.decode_tokens_per_sec, 20);
+  EXPECT_EQ(loaded->median.time_to_first_token_seconds, 0.5);
+  EXPECT_EQ(loaded->median.peak_memory_mb, 2048);
+  EXPECT_EQ(loaded->relative_spread.decode_tokens_per_sec, 0.1);
+}
+
+TEST(BenchmarkBaselineTest, LoadFailsOnMissingOrInvalidFile) {
+  EXPECT_THAT(LoadBenchmarkBaseline(GetTestPath("missing_baseline.json")),
+              StatusIs(absl::StatusCode::kNotFound));
+  const std::string path = GetTestPath("invalid_baseline.json");
+  std::ofstream(path) << "not json";
+  EXPECT_THAT(LoadBenchmarkBaseline(path),
+              StatusIs(absl::StatusCode::kDataLoss));
+}
+
+TEST(BenchmarkBaselineTest, CompareDetectsRegressionsInBothDirections) {
+  const auto comparisons = CompareBenchmarkToBaseline(
+      GetSummary(1000, 20, 0.5, 2048), GetSummary(800, 21, 0.6, 2048),
+      /*threshold=*/0.05);
+  EXPECT_THAT(
+      comparisons,
+      ElementsAre(
+          AllOf(Field(&BenchmarkMetricComparison::name,
+                      "prefill_tokens_per_sec"),
+                Field(&BenchmarkMetricComparison::regression,
+                      DoubleNear(0.2, 1e-9)),
+                Field(&BenchmarkMetricComparison::regressed, true)),
+          AllOf(Field(&BenchmarkMetricComparison::name,
+                      "decode_tokens_per_sec"),
+                Field(&BenchmarkMetricComparison::regressed, false)),
+          AllOf(Field(&BenchmarkMetricComparison::name,
+                      "time_to_first_token_seconds"),
+                Field(&BenchmarkMetricComparison::regressed, true)),
+          AllOf(Field(&BenchmarkMetricComparison::name, "peak_memory_mb"),
+                Field(&BenchmarkMetricComparison::regressed, false))));
+
+  const absl::Status status = CheckBenchmarkComparison(comparisons);
+  EXPECT_THAT(status, StatusIs(absl::StatusCode::kFailedPrecondition));
+  EXPECT_THAT(status.message(),
+              HasSubstr("prefill_tokens_per_sec, time_to_first_token_seconds"));
+  EXPECT_THAT(status.message(), HasSubstr("REGRESSED"));
+}
+
+TEST(BenchmarkBaselineTest, CompareToleratesTheSpreadOfTheRuns) {
+  BenchmarkRunSummary current = GetSummary(900, 20, 0.5, 2048);
+  EXPECT_THAT(CheckBenchmarkComparison(CompareBenchmarkToBaseline(
+                  GetSummary(1000, 20, 0.5, 2048), current,
+                  /*threshold=*/0.05)),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  current.relative_spread.prefill_tokens_per_sec = 0.1;
+  EXPECT_OK(CheckBenchmarkComparison(CompareBenchmarkToBaseline(
+      GetSummary(1000, 20, 0.5, 2048), current, /*threshold=*/0.05)));
+}
+
+TEST(BenchmarkBaselineTest, CompareSkipsTheMetricsNotMeasured) {
+  const auto comparisons = CompareBenchmarkToBaseline(
+      GetSummary(1000, 20, 0.5, 0), GetSummary(1000, 20, 0.5, 4096),
+      /*threshold=*/0.05);
+  EXPECT_EQ(comparisons.size(), 3);
+  EXPECT_OK(CheckBenchmarkComparison(comparisons));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,191 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/benchmark_sweep.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/ascii.h"  // from @com_google_absl
+#include "absl/strings/match.h"  // from @com_google_absl
+#include "absl/strings/numbers.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_split.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "nlohmann/json.hpp"  // from @nlohmann_json
+#include "runtime/util/model_cache.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::nlohmann::json;
+
+absl::StatusOr<std::vector<int>> ParseIntValues(
+    absl::string_view dimension, const std::vector<std::string>& values) {
+  std::vector<int> ints;
+  for (const std::string& value : values) {
+    int parsed;
+    if (!absl::SimpleAtoi(value, &parsed) || parsed < 0) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Invalid value of the benchmark sweep ", dimension, ": ", value));
+    }
+    ints.push_back(parsed);
+  }
+  return ints;
+}
+
+}  // namespace
+
+absl::StatusOr<BenchmarkSweepConfig> ParseBenchmarkSweepConfig(
+    absl::string_view spec, BenchmarkSweepConfig defaults) {
+  BenchmarkSweepConfig config = std::move(defaults);
+  for (absl::string_view entry :
+       absl::StrSplit(spec, ';', absl::SkipWhitespace())) {
+    std::vector<std::string> dimension_and_values =
+        absl::StrSplit(entry, absl::MaxSplits('=', 1));
+    if (dimension_and_values.size() != 2) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Invalid benchmark sweep entry: ", entry));
+    }
+    const std::string dimension(
+        absl::StripAsciiWhitespace(dimension_and_values[0]));
+    std::vector<std::string> values;
+    for (absl::string_view value :
+         absl::StrSplit(dimension_and_values[1], ',', absl::SkipWhitespace())) {
+      values.emplace_back(absl::StripAsciiWhitespace(value));
+    }
+    if (values.empty()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("No values for the benchmark sweep ", dimension));
+    }
+    if (dimension == "backend") {
+      config.backends = std::move(values);
+    } else if (dimension == "num_cpu_threads") {
+      ASSIGN_OR_RETURN(config.num_cpu_threads,
+                       ParseIntValues(dimension, values));
+    } else if (dimension == "prefill_batch_size") {
+      ASSIGN_OR_RETURN(config.prefill_batch_sizes,
+                       ParseIntValues(dimension, values));
+    } else if (dimension == "num_output_candidates") {
+      ASSIGN_OR_RETURN(config.num_output_candidates,
+                       ParseIntValues(dimension, values));
+    } else if (dimension == "prefill_tokens") {
+      ASSIGN_OR_RETURN(config.prefill_tokens,
+                       ParseIntValues(dimension, values));
+    } else if (dimension == "decode_tokens") {
+      ASSIGN_OR_RETURN(config.decode_tokens, ParseIntValues(dimension, values));
+    } else {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unknown benchmark sweep dimension: ", dimension));
+    }
+  }
+  return config;
+}
+
+bool BenchmarkSweepPoint::SharesEngineWith(
+    const BenchmarkSweepPoint& other) const {
+  return backend == other.backend && num_cpu_threads == other.num_cpu_threads &&
+         prefill_batch_size == other.prefill_batch_size &&
+         num_output_candidates == other.num_output_candidates;
+}
+
+std::vector<BenchmarkSweepPoint> GetBenchmarkSweepPoints(
+    const BenchmarkSweepConfig& config) {
+  std::vector<BenchmarkSweepPoint> points;
+  for (const std::string& backend : config.backends) {
+    // The other backends do not take a thread count, measure them once.
+    const std::vector<int> num_cpu_threads =
+        backend == "cpu" ? config.num_cpu_threads : std::vector<int>{0};
+    for (int num_threads : num_cpu_threads) {
+      for (int prefill_batch_size : config.prefill_batch_sizes) {
+        for (int num_candidates : config.num_output_candidates) {
+          for (int prefill_tokens : config.prefill_tokens) {
+            for (int decode_tokens : config.decode_tokens) {
+              points.push_back({.backend = backend,
+                                .num_cpu_threads = num_threads,
+                                .prefill_batch_size = prefill_batch_size,
+                                .num_output_candidates = num_candidates,
+                                .prefill_tokens = prefill_tokens,
+                                .decode_tokens = decode_tokens});
+            }
+          }
+        }
+      }
+    }
+  }
+  return points;
+}
+
+std::string FormatBenchmarkSweepReportJson(
+    const std::vector<BenchmarkSweepResult>& results) {
+  json report = json::array();
+  for (const BenchmarkSweepResult& result : results) {
+    json entry = {
+        {"backend", result.point.backend},
+        {"num_cpu_threads", result.point.num_cpu_threads},
+        {"prefill_batch_size", result.point.prefill_batch_size},
+        {"num_output_candidates", result.point.num_output_candidates},
+        {"prefill_tokens", result.point.prefill_tokens},
+        {"decode_tokens", result.point.decode_tokens},
+    };
+    if (!result.status.ok()) {
+      entry["error"] = result.status.ToString();
+    } else {
+      entry["init_seconds"] = result.init_seconds;
+      entry["time_to_first_token_seconds"] =
+          result.time_to_first_token_seconds;
+      entry["prefill_tokens_per_sec"] = result.prefill_tokens_per_sec;
+      entry["decode_tokens_per_sec"] = result.decode_tokens_per_sec;
+      entry["inter_token_p50_ms"] = result.inter_token_p50_ms;
+      entry["inter_token_p99_ms"] = result.inter_token_p99_ms;
+    }
+    report.push_back(std::move(entry));
+  }
+  return report.dump(/*indent=*/2);
+}
+
+std::string FormatBenchmarkSweepReportCsv(
+    const std::vector<BenchmarkSweepResult>& results) {
+  std::string report =
+      "backend,num_cpu_threads,prefill_batch_size,num_output_candidates,"
+      "prefill_tokens,decode_tokens,status,init_seconds,"
+      "time_to_first_token_seconds,prefill_tokens_per_sec,"
+      "decode_tokens_per_sec,inter_token_p50_ms,inter_token_p99_ms\n";
+  for (const BenchmarkSweepResult& result : results) {
+    absl::StrAppend(
+        &report, result.point.backend, ",", result.point.num_cpu_threads, ",",
+        result.point.prefill_batch_size, ",",
+        result.point.num_output_candidates, ",", result.point.prefill_tokens,
+        ",", result.point.decode_tokens, ",",
+        absl::StatusCodeToString(result.status.code()), ",",
+        result.init_seconds, ",", result.time_to_first_token_seconds, ",",
+        result.prefill_tokens_per_sec, ",", result.decode_tokens_per_sec, ",",
+        result.inter_token_p50_ms, ",", result.inter_token_p99_ms, "\n");
+  }
+  return report;
+}
+
+absl::Status WriteBenchmarkSweepReport(
+    absl::string_view path, const std::vector<BenchmarkSweepResult>& results) {
+  return WriteFileAtomically(
+      path, absl::EndsWith(path, ".csv")
+                ? FormatBenchmarkSweepReportCsv(results)
+                : FormatBenchmarkSweepReportJson(results));
+}
+
+}  // namespace litert::lm
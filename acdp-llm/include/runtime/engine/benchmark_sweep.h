@@ -0,0 +1,99 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_BENCHMARK_SWEEP_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_BENCHMARK_SWEEP_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// The values a benchmark sweep measures the model with, of which it runs
+// every combination.
+struct BenchmarkSweepConfig {
+  std::vector<std::string> backends;
+  // The cpu thread counts, 0 for the default of the executor. Only the cpu
+  // backend sweeps them.
+  std::vector<int> num_cpu_threads;
+  // The maximum numbers of tokens prefilled at once, 0 for the default.
+  std::vector<int> prefill_batch_sizes;
+  std::vector<int> num_output_candidates;
+  std::vector<int> prefill_tokens;
+  std::vector<int> decode_tokens;
+};
+
+// Returns `defaults` with the values of the dimensions listed in `spec`
+// replaced, e.g. "backend=cpu,gpu;prefill_tokens=128,1024;decode_tokens=64".
+// The dimensions are backend, num_cpu_threads, prefill_batch_size,
+// num_output_candidates, prefill_tokens and decode_tokens.
+absl::StatusOr<BenchmarkSweepConfig> ParseBenchmarkSweepConfig(
+    absl::string_view spec, BenchmarkSweepConfig defaults);
+
+// One combination of the values of a benchmark sweep.
+struct BenchmarkSweepPoint {
+  std::string backend;
+  int num_cpu_threads = 0;
+  int prefill_batch_size = 0;
+  int num_output_candidates = 1;
+  int prefill_tokens = 0;
+  int decode_tokens = 0;
+
+  // Whether the points differ only by the numbers of prefill and decode
+  // tokens, which the sessions of an engine can change, so that they are
+  // measured without loading the model again.
+  bool SharesEngineWith(const BenchmarkSweepPoint& other) const;
+};
+
+// Returns the combinations of the values of `config`, those sharing an engine
+// next to each other.
+std::vector<BenchmarkSweepPoint> GetBenchmarkSweepPoints(
+    const BenchmarkSweepConfig& config);
+
+// The measurements of a point of a benchmark sweep.
+struct BenchmarkSweepResult {
+  BenchmarkSweepPoint point;
+  // The error of the point, e.g. a prefill batch size the model does not
+  // support, in which case the measurements are 0.
+  absl::Status status;
+  // The creation time of the engine of the point, shared with the points
+  // before it on the same engine.
+  double init_seconds = 0;
+  double time_to_first_token_seconds = 0;
+  double prefill_tokens_per_sec = 0;
+  double decode_tokens_per_sec = 0;
+  double inter_token_p50_ms = 0;
+  double inter_token_p99_ms = 0;
+};
+
+// Returns the results as a JSON array of objects, one per point.
+std::string FormatBenchmarkSweepReportJson(
+    const std::vector<BenchmarkSweepResult>& results);
+
+// Returns the results as CSV with a header row, one row per point.
+std::string FormatBenchmarkSweepReportCsv(
+    const std::vector<BenchmarkSweepResult>& results);
+
+// Writes the results to `path`, as CSV if it ends with ".csv" and as JSON
+// otherwise.
+absl::Status WriteBenchmarkSweepReport(
+    absl::string_view path, const std::vector<BenchmarkSweepResult>& results);
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_BENCHMARK_SWEEP_H_
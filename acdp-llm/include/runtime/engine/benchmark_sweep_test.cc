@@ -0,0 +1,138 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/benchmark_sweep.h"
+
+#include <algorithm>
+#include <filesystem>  // NOLINT: Required for path manipulation.
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "nlohmann/json.hpp"  // from @nlohmann_json
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::status::StatusIs;
+
+BenchmarkSweepConfig GetDefaults() {
+  return {.backends = {"cpu"},
+          .num_cpu_threads = {0},
+          .prefill_batch_sizes = {0},
+          .num_output_candidates = {1},
+          .prefill_tokens = {128},
+          .decode_tokens = {32}};
+}
+
+TEST(BenchmarkSweepTest, ParseOverridesTheListedDimensions) {
+  auto config = ParseBenchmarkSweepConfig(
+      "backend=cpu,gpu; prefill_tokens=128,1024;num_cpu_threads=4,8",
+      GetDefaults());
+  ASSERT_OK(config);
+  EXPECT_THAT(config->backends, ElementsAre("cpu", "gpu"));
+  EXPECT_THAT(config->num_cpu_threads, ElementsAre(4, 8));
+  EXPECT_THAT(config->prefill_tokens, ElementsAre(128, 1024));
+  EXPECT_THAT(config->decode_tokens, ElementsAre(32));
+  EXPECT_THAT(config->num_output_candidates, ElementsAre(1));
+}
+
+TEST(BenchmarkSweepTest, ParseFailsOnInvalidSpec) {
+  EXPECT_THAT(ParseBenchmarkSweepConfig("batch=1", GetDefaults()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseBenchmarkSweepConfig("prefill_tokens=abc", GetDefaults()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseBenchmarkSweepConfig("decode_tokens", GetDefaults()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseBenchmarkSweepConfig("decode_tokens=", GetDefaults()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(BenchmarkSweepTest, PointsSharingAnEngineAreNextToEachOther) {
+  BenchmarkSweepConfig config = GetDefaults();
+  config.backends = {"cpu", "gpu"};
+  config.num_cpu_threads = {4, 8};
+  config.prefill_tokens = {128, 1024};
+  const std::vector<BenchmarkSweepPoint> points =
+      GetBenchmarkSweepPoints(config);
+  // The gpu backend is measured with one thread count only.
+  ASSERT_EQ(points.size(), 6);
+  int num_engines = 1;
+  for (int i = 1; i < points.size(); ++i) {
+    if (!points[i].SharesEngineWith(points[i - 1])) {
+      ++num_engines;
+    }
+  }
+  EXPECT_EQ(num_engines, 3);
+  EXPECT_EQ(points[0].backend, "cpu");
+  EXPECT_EQ(points[0].num_cpu_threads, 4);
+  EXPECT_EQ(points[1].prefill_tokens, 1024);
+  EXPECT_EQ(points[4].backend, "gpu");
+  EXPECT_EQ(points[4].num_cpu_threads, 0);
+}
+
+TEST(BenchmarkSweepTest, FormatReports) {
+  BenchmarkSweepResult measured;
+  measured.point = {.backend = "cpu", .prefill_tokens = 128,
+                    .decode_tokens = 32};
+  measured.prefill_tokens_per_sec = 500;
+  measured.decode_tokens_per_sec = 20;
+  BenchmarkSweepResult failed;
+  failed.point = {.backend = "gpu", .prefill_batch_size = 4096};
+  failed.status = absl::InvalidArgumentError("unsupported");
+  const std::vector<BenchmarkSweepResult> results = {measured, failed};
+
+  const nlohmann::json json_report =
+      nlohmann::json::parse(FormatBenchmarkSweepReportJson(results));
+  ASSERT_EQ(json_report.size(), 2);
+  EXPECT_EQ(json_report[0]["backend"], "cpu");
+  EXPECT_EQ(json_report[0]["prefill_tokens_per_sec"], 500);
+  EXPECT_FALSE(json_report[0].contains("error"));
+  EXPECT_EQ(json_report[1]["prefill_batch_size"], 4096);
+  EXPECT_THAT(json_report[1]["error"].get<std::string>(),
+              HasSubstr("unsupported"));
+
+  const std::string csv_report = FormatBenchmarkSweepReportCsv(results);
+  EXPECT_EQ(std::count(csv_report.begin(), csv_report.end(), '\n'), 3);
+  EXPECT_THAT(csv_report, HasSubstr("\ncpu,0,0,1,128,32,OK,0,0,500,20,0,0\n"));
+  EXPECT_THAT(csv_report, HasSubstr("\ngpu,0,4096,1,0,0,INVALID_ARGUMENT,"));
+}
+
+TEST(BenchmarkSweepTest, WriteReportPicksTheFormatFromTheExtension) {
+  BenchmarkSweepResult result;
+  result.point.backend = "cpu";
+  const std::string csv_path =
+      (std::filesystem::path(::testing::TempDir()) / "sweep.csv").string();
+  ASSERT_OK(WriteBenchmarkSweepReport(csv_path, {result}));
+  std::stringstream csv_contents;
+  csv_contents << std::ifstream(csv_path).rdbuf();
+  EXPECT_EQ(csv_contents.str(), FormatBenchmarkSweepReportCsv({result}));
+
+  const std::string json_path =
+      (std::filesystem::path(::testing::TempDir()) / "sweep.json").string();
+  ASSERT_OK(WriteBenchmarkSweepReport(json_path, {result}));
+  std::stringstream json_contents;
+  json_contents << std::ifstream(json_path).rdbuf();
+  EXPECT_EQ(json_contents.str(), FormatBenchmarkSweepReportJson({result}));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,161 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/decode_replay.h"
+
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/synchronization/notification.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "litert/cc/litert_macros.h"  // from @litert
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/proto/decode_replay.pb.h"
+#include "runtime/util/convert_tensor_buffer.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+absl::Status ReplayPrefill(Engine::Session& session,
+                           absl::Span<const int> token_ids) {
+  const int num_tokens = token_ids.size();
+  LITERT_ASSIGN_OR_RETURN(auto token_ids_buffer,
+                          CopyToTensorBuffer<int>(token_ids, {1, num_tokens}));
+  std::vector<InputData> contents;
+  contents.emplace_back(InputText(std::move(token_ids_buffer)));
+  return session.RunPrefill(contents);
+}
+
+// Decodes until `max_num_steps` responses are streamed, and returns their
+// number.
+absl::StatusOr<int> ReplayDecode(Engine::Session& session, int max_num_steps) {
+  int num_steps = 0;
+  bool cancelled_at_limit = false;
+  absl::Status status;
+  absl::Notification done;
+  RETURN_IF_ERROR(session.RunDecodeAsync(
+      [&](absl::StatusOr<Responses> responses) {
+        if (!responses.ok()) {
+          if (!(cancelled_at_limit && absl::IsCancelled(responses.status()))) {
+            status = responses.status();
+          }
+          done.Notify();
+          return;
+        }
+        if (responses->GetTaskState() == TaskState::kDone) {
+          done.Notify();
+          return;
+        }
+        if (responses->GetTaskState() != TaskState::kProcessing) {
+          return;
+        }
+        if (++num_steps >= max_num_steps && !cancelled_at_limit) {
+          cancelled_at_limit = true;
+          session.CancelProcess();
+        }
+      }));
+  done.WaitForNotification();
+  RETURN_IF_ERROR(status);
+  return num_steps;
+}
+
+}  // namespace
+
+std::ostream& operator<<(std::ostream& os, const DecodeReplayReport& report) {
+  os << "Decode replay report:" << std::endl;
+  os << absl::StrFormat("  %-4s %-8s %10s %10s %14s %14s", "turn", "type",
+                        "recorded", "replayed", "recorded_ms", "replayed_ms")
+     << std::endl;
+  for (int i = 0; i < report.turns.size(); ++i) {
+    const ReplayedTurn& turn = report.turns[i];
+    os << absl::StrFormat(
+              "  %-4d %-8s %10d %10d %14.2f %14.2f", i,
+              turn.is_prefill ? "prefill" : "decode", turn.recorded_num_tokens,
+              turn.replayed_num_tokens,
+              absl::ToDoubleMilliseconds(turn.recorded_duration),
+              absl::ToDoubleMilliseconds(turn.replayed_duration))
+       << std::endl;
+  }
+  return os;
+}
+
+absl::StatusOr<DecodeReplayReport> ReplayDecodeRecording(
+    const Engine& engine, SessionConfig session_config,
+    const proto::DecodeReplay& recording, bool keep_turn_gaps) {
+  session_config.GetMutableSamplerParams() = recording.sampler_params();
+  session_config.SetNumOutputCandidates(recording.num_output_candidates());
+  session_config.SetUseBeamSearch(recording.use_beam_search());
+  // The recorded token ids already went through the prompt templates.
+  session_config.SetApplyPromptTemplateInSession(false);
+  session_config.SetDecodeReplayPath("");
+  ASSIGN_OR_RETURN(auto session, engine.CreateSession(session_config));
+
+  DecodeReplayReport report;
+  bool is_first_prefill = true;
+  const absl::Time start_time = absl::Now();
+  for (const proto::SessionTurn& recorded_turn : recording.turns()) {
+    if (keep_turn_gaps) {
+      absl::SleepFor(start_time +
+                     absl::Microseconds(recorded_turn.start_time_us()) -
+                     absl::Now());
+    }
+    ReplayedTurn turn;
+    turn.is_prefill = recorded_turn.has_prefill();
+    turn.recorded_duration = absl::Microseconds(recorded_turn.duration_us());
+    const absl::Time turn_start_time = absl::Now();
+    if (turn.is_prefill) {
+      const proto::PrefillTurn& prefill = recorded_turn.prefill();
+      if (prefill.has_multimodal_inputs()) {
+        return absl::UnimplementedError(
+            "The multimodal prefills can not be replayed.");
+      }
+      absl::Span<const int> token_ids = prefill.token_ids();
+      turn.recorded_num_tokens = token_ids.size();
+      // The session prepends the start token to its first prefill again.
+      const int start_token_id = session->GetSessionConfig().GetStartTokenId();
+      if (is_first_prefill && start_token_id >= 0 && !token_ids.empty() &&
+          token_ids.front() == start_token_id) {
+        token_ids.remove_prefix(1);
+      }
+      is_first_prefill = false;
+      RETURN_IF_ERROR(ReplayPrefill(*session, token_ids));
+      turn.replayed_num_tokens = turn.recorded_num_tokens;
+    } else {
+      const proto::DecodeTurn& decode = recorded_turn.decode();
+      if (decode.has_constraint()) {
+        ABSL_LOG(WARNING) << "Replaying a constrained decode unconstrained.";
+      }
+      turn.recorded_num_tokens = decode.num_steps();
+      if (decode.num_steps() > 0) {
+        ASSIGN_OR_RETURN(turn.replayed_num_tokens,
+                         ReplayDecode(*session, decode.num_steps()));
+      }
+    }
+    turn.replayed_duration = absl::Now() - turn_start_time;
+    report.turns.push_back(turn);
+  }
+  return report;
+}
+
+}  // namespace litert::lm
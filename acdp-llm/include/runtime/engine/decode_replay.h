@@ -0,0 +1,66 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_DECODE_REPLAY_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_DECODE_REPLAY_H_
+
+#include <ostream>
+#include <vector>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/proto/decode_replay.pb.h"
+
+namespace litert::lm {
+
+// A turn of a replayed session, measured next to its recording.
+struct ReplayedTurn {
+  bool is_prefill = false;
+  // The number of tokens prefilled, or of decode steps.
+  int recorded_num_tokens = 0;
+  // The number of decode steps streamed by the replay, which stops at the
+  // recorded number of steps, or earlier at a stop token. The prefilled
+  // tokens otherwise.
+  int replayed_num_tokens = 0;
+  absl::Duration recorded_duration;
+  absl::Duration replayed_duration;
+};
+
+// The turns of a replayed session, in their order.
+struct DecodeReplayReport {
+  std::vector<ReplayedTurn> turns;
+};
+std::ostream& operator<<(std::ostream& os, const DecodeReplayReport& report);
+
+// Replays the workload of a session recorded by DecodeReplayRecorder on
+// `engine`, created from the same model as the recorded one, with a session
+// created from `session_config` and the recorded sampler parameters, seed and
+// number of output candidates. The recorded token ids are prefilled as they
+// are, bypassing the prompt templates and the tokenizer, and each decode is
+// cancelled after its recorded number of steps. If `keep_turn_gaps`, every
+// turn starts at its recorded time from the start of the replay, so that the
+// idle time between the turns is replayed too.
+//
+// The constraints of the decodes are not recorded, the constrained decodes
+// are replayed unconstrained. The recordings of multimodal prefills, whose
+// embeddings are not recorded, can not be replayed.
+absl::StatusOr<DecodeReplayReport> ReplayDecodeRecording(
+    const Engine& engine, SessionConfig session_config,
+    const proto::DecodeReplay& recording, bool keep_turn_gaps = true);
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_DECODE_REPLAY_H_
@@ -0,0 +1,155 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/decode_replay.h"
+
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/fake_engine.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/proto/decode_replay.pb.h"
+#include "runtime/util/convert_tensor_buffer.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::status::StatusIs;
+
+// An engine of sessions recording the prefilled token ids, and streaming
+// `num_output_steps` responses per decode until they are cancelled.
+class ReplayEngine : public FakeEngine {
+ public:
+  absl::StatusOr<std::unique_ptr<Session>> CreateSession(
+      const SessionConfig& session_config) const override {
+    EXPECT_FALSE(session_config.GetApplyPromptTemplateInSession());
+    EXPECT_EQ(session_config.GetSamplerParams().seed(), 7);
+    auto session = std::make_unique<testing::NiceMock<MockSession>>();
+    auto cancelled = std::make_shared<bool>(false);
+    ON_CALL(*session, GetSessionConfig)
+        .WillByDefault(testing::ReturnRef(session_config_));
+    ON_CALL(*session, RunPrefill)
+        .WillByDefault([this](const std::vector<InputData>& contents) {
+          for (const InputData& content : contents) {
+            auto token_ids = std::get<InputText>(content)
+                                 .GetPreprocessedTextTensor();
+            EXPECT_OK(token_ids);
+            auto ids = CopyFromTensorBuffer<int>(**token_ids);
+            EXPECT_TRUE(ids.HasValue());
+            prefilled_token_ids.insert(prefilled_token_ids.end(),
+                                       ids->begin(), ids->end());
+          }
+          return absl::OkStatus();
+        });
+    ON_CALL(*session, CancelProcess).WillByDefault([cancelled]() {
+      *cancelled = true;
+    });
+    ON_CALL(*session, RunDecodeAsync(testing::_))
+        .WillByDefault(
+            [this, cancelled](
+                absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback)
+                -> absl::Status {
+              *cancelled = false;
+              for (int i = 0; i < num_output_steps; ++i) {
+                if (*cancelled) {
+                  callback(absl::CancelledError("Cancelled."));
+                  return absl::OkStatus();
+                }
+                callback(Responses(TaskState::kProcessing, {"token"}));
+              }
+              callback(Responses(TaskState::kDone));
+              return absl::OkStatus();
+            });
+    return session;
+  }
+
+  int num_output_steps = 5;
+  mutable std::vector<int> prefilled_token_ids;
+
+ private:
+  SessionConfig session_config_ = [] {
+    SessionConfig config = SessionConfig::CreateDefault();
+    config.SetStartTokenId(2);
+    return config;
+  }();
+};
+
+proto::DecodeReplay CreateRecording() {
+  proto::DecodeReplay recording;
+  recording.mutable_sampler_params()->set_seed(7);
+  recording.set_num_output_candidates(1);
+  proto::SessionTurn* prefill = recording.add_turns();
+  prefill->set_duration_us(1000);
+  for (int token_id : {2, 10, 11, 12}) {
+    prefill->mutable_prefill()->add_token_ids(token_id);
+  }
+  proto::SessionTurn* decode = recording.add_turns();
+  decode->set_start_time_us(1000);
+  decode->set_duration_us(2000);
+  decode->mutable_decode()->set_num_steps(3);
+  return recording;
+}
+
+TEST(DecodeReplayTest, ReplaysTheRecordedTurns) {
+  ReplayEngine engine;
+  ASSERT_OK_AND_ASSIGN(
+      DecodeReplayReport report,
+      ReplayDecodeRecording(engine, SessionConfig::CreateDefault(),
+                            CreateRecording(), /*keep_turn_gaps=*/false));
+  // The start token is prepended by the session again.
+  EXPECT_THAT(engine.prefilled_token_ids, ElementsAre(10, 11, 12));
+  ASSERT_EQ(report.turns.size(), 2);
+  EXPECT_TRUE(report.turns[0].is_prefill);
+  EXPECT_EQ(report.turns[0].recorded_num_tokens, 4);
+  EXPECT_EQ(report.turns[0].recorded_duration, absl::Milliseconds(1));
+  EXPECT_FALSE(report.turns[1].is_prefill);
+  EXPECT_EQ(report.turns[1].recorded_num_tokens, 3);
+  // Cancelled at the recorded number of steps.
+  EXPECT_EQ(report.turns[1].replayed_num_tokens, 3);
+}
+
+TEST(DecodeReplayTest, StopsWithTheSessionBeforeTheRecordedSteps) {
+  ReplayEngine engine;
+  engine.num_output_steps = 2;
+  ASSERT_OK_AND_ASSIGN(
+      DecodeReplayReport report,
+      ReplayDecodeRecording(engine, SessionConfig::CreateDefault(),
+                            CreateRecording(), /*keep_turn_gaps=*/false));
+  ASSERT_EQ(report.turns.size(), 2);
+  EXPECT_EQ(report.turns[1].replayed_num_tokens, 2);
+}
+
+TEST(DecodeReplayTest, FailsOnMultimodalPrefills) {
+  ReplayEngine engine;
+  proto::DecodeReplay recording = CreateRecording();
+  recording.mutable_turns(0)->mutable_prefill()->set_has_multimodal_inputs(
+      true);
+  EXPECT_THAT(ReplayDecodeRecording(engine, SessionConfig::CreateDefault(),
+                                    recording, /*keep_turn_gaps=*/false),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+}  // namespace
+}  // namespace litert::lm
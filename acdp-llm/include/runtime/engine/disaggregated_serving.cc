@@ -0,0 +1,64 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/disaggregated_serving.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+
+absl::StatusOr<std::string> PrefillForDecodeEngine(
+    const Engine& prefill_engine, const SessionConfig& session_config,
+    std::vector<InputData> contents) {
+  if (prefill_engine.GetEngineSettings().GetEngineRole() ==
+      EngineRole::kDecode) {
+    return absl::InvalidArgumentError(
+        "The prompts are prefilled on a prefill engine.");
+  }
+  ASSIGN_OR_RETURN(std::unique_ptr<Engine::Session> session,
+                   prefill_engine.CreateSession(session_config));
+  RETURN_IF_ERROR(session->RunPrefill(std::move(contents)));
+  ASSIGN_OR_RETURN(std::unique_ptr<SessionCheckpoint> checkpoint,
+                   session->Checkpoint());
+  return session->SerializeCheckpoint(*checkpoint);
+}
+
+absl::StatusOr<std::unique_ptr<Engine::Session>> CreateSessionFromPrefill(
+    const Engine& decode_engine, const SessionConfig& session_config,
+    std::string prefilled_context) {
+  if (decode_engine.GetEngineSettings().GetEngineRole() ==
+      EngineRole::kPrefill) {
+    return absl::InvalidArgumentError(
+        "The sessions continue on a decode engine.");
+  }
+  ASSIGN_OR_RETURN(std::unique_ptr<Engine::Session> session,
+                   decode_engine.CreateSession(session_config));
+  ASSIGN_OR_RETURN(
+      std::unique_ptr<SessionCheckpoint> checkpoint,
+      session->DeserializeCheckpoint(std::move(prefilled_context)));
+  RETURN_IF_ERROR(session->Restore(*checkpoint));
+  return session;
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,62 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_DISAGGREGATED_SERVING_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_DISAGGREGATED_SERVING_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/io_types.h"
+
+namespace litert::lm {
+
+// Disaggregated serving runs the compute-bound prefill of the prompts and the
+// memory-bound decode of the responses on different hardware, typically
+// different hosts, see EngineRole. The prefill engine prefills the prompt of
+// a request and serializes the context of its session. The bytes travel to a
+// decode engine of the same model and settings by any transport, where a new
+// session continues from them.
+//
+// Example usage:
+//   // On the prefill host.
+//   ASSIGN_OR_RETURN(std::string prefilled_context,
+//                    PrefillForDecodeEngine(*prefill_engine, session_config,
+//                                           {InputText(prompt)}));
+//   // ... send `prefilled_context` to the decode host ...
+//   ASSIGN_OR_RETURN(auto session,
+//                    CreateSessionFromPrefill(*decode_engine, session_config,
+//                                             std::move(prefilled_context)));
+//   ASSIGN_OR_RETURN(auto responses, session->RunDecode());
+
+// Prefills `contents` in a new session of `prefill_engine` and returns the
+// serialized checkpoint of the session, see
+// Engine::Session::SerializeCheckpoint(). Fails on a decode engine.
+absl::StatusOr<std::string> PrefillForDecodeEngine(
+    const Engine& prefill_engine, const SessionConfig& session_config,
+    std::vector<InputData> contents);
+
+// Creates a session of `decode_engine` continuing from `prefilled_context`,
+// returned by PrefillForDecodeEngine(). Fails on a prefill engine.
+absl::StatusOr<std::unique_ptr<Engine::Session>> CreateSessionFromPrefill(
+    const Engine& decode_engine, const SessionConfig& session_config,
+    std::string prefilled_context);
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_DISAGGREGATED_SERVING_H_
@@ -0,0 +1,128 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/disaggregated_serving.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/fake_engine.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::StatusIs;
+
+// The context of a fake session, serialized as its text.
+struct FakeCheckpoint : public SessionCheckpoint {
+  std::string context;
+};
+
+// An engine of sessions whose context is the text prefilled into them.
+class CheckpointingEngine : public FakeEngine {
+ public:
+  explicit CheckpointingEngine(EngineRole engine_role)
+      : FakeEngine(engine_role) {}
+
+  absl::StatusOr<std::unique_ptr<Session>> CreateSession(
+      const SessionConfig& session_config) const override {
+    auto session = std::make_unique<testing::NiceMock<MockSession>>();
+    auto context = std::make_shared<std::string>();
+    ON_CALL(*session, RunPrefill)
+        .WillByDefault([context](const std::vector<InputData>& contents) {
+          for (const InputData& content : contents) {
+            *context +=
+                std::get<InputText>(content).GetRawTextString().value();
+          }
+          return absl::OkStatus();
+        });
+    ON_CALL(*session, Checkpoint)
+        .WillByDefault(
+            [context]() -> absl::StatusOr<std::unique_ptr<SessionCheckpoint>> {
+              auto checkpoint = std::make_unique<FakeCheckpoint>();
+              checkpoint->context = *context;
+              return checkpoint;
+            });
+    ON_CALL(*session, SerializeCheckpoint)
+        .WillByDefault([](const SessionCheckpoint& checkpoint) {
+          return static_cast<const FakeCheckpoint&>(checkpoint).context;
+        });
+    ON_CALL(*session, DeserializeCheckpoint)
+        .WillByDefault([](std::string data)
+                           -> absl::StatusOr<
+                               std::unique_ptr<SessionCheckpoint>> {
+          auto checkpoint = std::make_unique<FakeCheckpoint>();
+          checkpoint->context = std::move(data);
+          return checkpoint;
+        });
+    ON_CALL(*session, Restore)
+        .WillByDefault([this, context](const SessionCheckpoint& checkpoint) {
+          *context = static_cast<const FakeCheckpoint&>(checkpoint).context;
+          restored_context = *context;
+          return absl::OkStatus();
+        });
+    return session;
+  }
+
+  mutable std::string restored_context;
+};
+
+std::vector<InputData> CreatePrompt() {
+  std::vector<InputData> prompt;
+  prompt.emplace_back(InputText("Summarize the attached report."));
+  return prompt;
+}
+
+TEST(DisaggregatedServingTest, DecodeEngineContinuesFromThePrefill) {
+  CheckpointingEngine prefill_engine(EngineRole::kPrefill);
+  CheckpointingEngine decode_engine(EngineRole::kDecode);
+  ASSERT_OK_AND_ASSIGN(
+      std::string prefilled_context,
+      PrefillForDecodeEngine(prefill_engine, SessionConfig::CreateDefault(),
+                             CreatePrompt()));
+  EXPECT_EQ(prefilled_context, "Summarize the attached report.");
+
+  ASSERT_OK_AND_ASSIGN(
+      auto session,
+      CreateSessionFromPrefill(decode_engine, SessionConfig::CreateDefault(),
+                               std::move(prefilled_context)));
+  EXPECT_NE(session, nullptr);
+  EXPECT_EQ(decode_engine.restored_context, "Summarize the attached report.");
+}
+
+TEST(DisaggregatedServingTest, RejectsTheEnginesOfTheOtherRole) {
+  CheckpointingEngine prefill_engine(EngineRole::kPrefill);
+  CheckpointingEngine decode_engine(EngineRole::kDecode);
+  EXPECT_THAT(PrefillForDecodeEngine(decode_engine,
+                                     SessionConfig::CreateDefault(),
+                                     CreatePrompt()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(CreateSessionFromPrefill(prefill_engine,
+                                       SessionConfig::CreateDefault(), "x"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -15,7 +15,12 @@
 #ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_ENGINE_H_
 #define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_ENGINE_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/functional/any_invocable.h"  // from @com_google_absl
@@ -24,12 +29,139 @@
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
 #include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
 #include "runtime/components/tokenizer.h"
 #include "runtime/engine/engine_settings.h"
 #include "runtime/engine/io_types.h"
 
 namespace litert::lm {
 
+class EngineCreationProgress;
+
+// An opaque snapshot of the state of a session, see
+// Engine::Session::Checkpoint().
+class SessionCheckpoint {
+ public:
+  virtual ~SessionCheckpoint() = default;
+};
+
+// An audio input streamed into a session while it is being recorded, see
+// Engine::Session::CreateAudioStream(). The chunks are preprocessed and
+// encoded as they are pushed, so that only the last one is left to process
+// when the audio ends.
+class AudioStream {
+ public:
+  virtual ~AudioStream() = default;
+
+  // Pushes the next chunk of the audio, either raw audio bytes or a
+  // preprocessed spectrogram of the frames following the previous chunk.
+  virtual absl::Status PushAudio(InputAudio audio_chunk) = 0;
+
+  // Ends the stream and returns the whole audio, to prefill in place of the
+  // streamed audio, e.g. {InputText("..."), std::move(audio), ...}. The
+  // session prefills it with the embeddings encoded while streaming.
+  virtual absl::StatusOr<InputAudio> Finish() = 0;
+};
+
+// A snapshot of the load of an engine, see Engine::GetLoad().
+struct EngineLoad {
+  // The number of sessions alive.
+  int num_sessions = 0;
+  // The number of session tasks (prefills, decodes, ...) scheduled and not
+  // done yet, including the running ones.
+  int num_queued_tasks = 0;
+  // The number of tokens left in the kv-cache shared by the sessions, set if
+  // the engine pages its kv-cache.
+  std::optional<int> num_free_kv_cache_tokens;
+};
+
+// The counters and gauges of an engine since it was created, see
+// Engine::GetMetrics(), cheap enough to be scraped periodically in production.
+struct EngineMetrics {
+  // The lookups of a cache shared by the sessions.
+  struct CacheStats {
+    int64_t num_hits = 0;
+    int64_t num_misses = 0;
+
+    // Returns the fraction of the lookups which hit, 0 without lookups.
+    double GetHitRate() const {
+      const int64_t num_lookups = num_hits + num_misses;
+      return num_lookups > 0 ? static_cast<double>(num_hits) / num_lookups : 0;
+    }
+  };
+
+  // The number of sessions alive.
+  int num_sessions = 0;
+  // The number of session tasks scheduled and not done yet, including the
+  // running ones.
+  int num_queued_tasks = 0;
+  // The number of tokens prefilled, not counting the prefixes restored from
+  // the prefix cache.
+  int64_t num_prefilled_tokens = 0;
+  // The number of decode steps, each decoding one token per output candidate.
+  int64_t num_decode_steps = 0;
+  // The number of turns cancelled, by the caller, a deadline or the engine
+  // draining.
+  int64_t num_cancellations = 0;
+  // The fraction of the kv-cache blocks in use, set if the engine pages its
+  // kv-cache.
+  std::optional<double> kv_cache_utilization;
+  // The caches shared by the sessions, set if enabled.
+  std::optional<CacheStats> prefix_cache;
+  std::optional<CacheStats> embedding_cache;
+  std::optional<CacheStats> token_id_cache;
+};
+
+// What an engine shed to relieve the memory pressure since it was created,
+// see Engine::GetMemorySheddingStats().
+struct MemorySheddingStats {
+  // The number of times the resident memory of the process was found above
+  // EngineSettings::GetMaxResidentMemoryBytes().
+  int num_memory_limit_exceeded = 0;
+  // The number of Engine::NotifyMemoryPressure() calls.
+  int num_memory_pressure_signals = 0;
+  // The memory of the kv-cache snapshots dropped from the prefix cache.
+  size_t prefix_cache_bytes_dropped = 0;
+  // The memory of the vision and audio embeddings dropped from the embedding
+  // cache.
+  size_t embedding_cache_bytes_dropped = 0;
+  // The number of texts dropped from the token id cache.
+  int num_token_id_cache_entries_dropped = 0;
+  // The number of unused vision and audio executors destroyed, to be created
+  // again by the next image or audio.
+  int num_executors_evicted = 0;
+};
+
+// The memory of an engine by component, see Engine::GetMemoryUsage(), e.g. to
+// size the containers serving it or to tell a leak from a cache filling up.
+struct EngineMemoryUsage {
+  // The growth of the resident memory of the process over a phase of the
+  // engine creation.
+  struct CreationPhase {
+    std::string name;
+    int64_t resident_bytes_growth = 0;
+  };
+
+  // The resident memory of the process, 0 where it can not be read.
+  size_t resident_bytes = 0;
+  // The phases of the engine creation in their order: the model mapping, the
+  // tokenizer, each executor, or all of them when created concurrently, the
+  // warm-up and the caches. Empty where the resident memory can not be read.
+  std::vector<CreationPhase> creation_phases;
+  // The kv-cache of the contexts of the executor, 0 if the executor does not
+  // report it.
+  size_t kv_cache_bytes = 0;
+  // The current contents of the caches shared by the sessions.
+  size_t prefix_cache_bytes = 0;
+  size_t embedding_cache_bytes = 0;
+  size_t lora_adapter_bytes = 0;
+  // Whether the vision and audio executors currently exist.
+  bool vision_executor_loaded = false;
+  bool audio_executor_loaded = false;
+  // The number of sessions alive, which hold their contexts and histories.
+  int num_sessions = 0;
+};
+
 // Engine is the interface for the LLM runtime. It is responsible for
 // - Initializing the LLM model and related resources, e.g. tokenizer,
 //   embedder, etc.
@@ -104,6 +236,17 @@ class Engine {
         absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
         const DecodeConfig& decode_config) = 0;
 
+    // Same as above, but takes the ownership of the contents, so that the
+    // image and audio tensors are moved instead of copied.
+    virtual absl::Status GenerateContentStream(
+        std::vector<InputData>&& contents,
+        absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
+        const DecodeConfig& decode_config) {
+      return GenerateContentStream(
+          static_cast<const std::vector<InputData>&>(contents),
+          std::move(callback), decode_config);
+    }
+
     // Scores the target text after the prefill process is done. This function
     // will only run the decode process to fetch the decode output logits, which
     // is used to calculate the target text's score and update the model memory
@@ -116,6 +259,30 @@ class Engine {
     virtual absl::StatusOr<Responses> RunTextScoring(
         const std::vector<absl::string_view>& target_text) = 0;
 
+    // Same as above, but scores the target texts under each of
+    // `temperatures`, from the logits of a single forward pass, e.g. for a
+    // calibration sweep. Returns the responses of each temperature, in their
+    // order, with the score of each target text.
+    virtual absl::StatusOr<std::vector<Responses>>
+    RunTextScoringWithTemperatures(
+        const std::vector<absl::string_view>& target_text,
+        absl::Span<const float> temperatures) {
+      return absl::UnimplementedError("Not implemented.");
+    }
+
+    // Returns an embedding of each of `texts`, pooled from the hidden states
+    // of the last layer of the model over the tokens of the text, e.g. for a
+    // semantic router or cache reusing the weights loaded for generation
+    // instead of a separate embedding model. The texts are run in a single
+    // batched invocation, independently of each other and of the context of
+    // the session, which is left unchanged. The embeddings are normalized to
+    // unit length.
+    virtual absl::StatusOr<std::vector<std::vector<float>>> EmbedText(
+        const std::vector<absl::string_view>& texts,
+        EmbeddingPooling pooling) {
+      return absl::UnimplementedError("Not implemented.");
+    }
+
     // Adds the input prompt/query to the model for starting the prefilling
     // process. Note that the user can break down their prompt/query into
     // multiple chunks and call this function multiple times.
@@ -124,6 +291,12 @@ class Engine {
     // process is done.
     virtual absl::Status RunPrefill(const std::vector<InputData>& contents) = 0;
 
+    // Same as above, but takes the ownership of the contents, so that the
+    // image and audio tensors are moved instead of copied.
+    virtual absl::Status RunPrefill(std::vector<InputData>&& contents) {
+      return RunPrefill(static_cast<const std::vector<InputData>&>(contents));
+    }
+
     // This is a not blocking call and the function will return right away. The
     // processing status will be signaled through the callback.
     virtual absl::Status RunPrefillAsync(
@@ -132,6 +305,16 @@ class Engine {
       return absl::UnimplementedError("Not implemented.");
     }
 
+    // Same as above, but takes the ownership of the contents, so that the
+    // image and audio tensors are moved instead of copied.
+    virtual absl::Status RunPrefillAsync(
+        std::vector<InputData>&& contents,
+        absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback) {
+      return RunPrefillAsync(
+          static_cast<const std::vector<InputData>&>(contents),
+          std::move(callback));
+    }
+
     // Starts the decoding process for the model to predict the response based
     // on the input prompt/query added after using RunPrefill* functions.
     // This is a blocking call and the function will return when the decoding
@@ -177,12 +360,100 @@ class Engine {
 
     // Get the reference to the tokenizer for the session.
     virtual const Tokenizer& GetTokenizer() const = 0;
+
+    // Returns the token ids prefilled for the rendered `text`, e.g. a turn
+    // rendered by a conversation, with its start token. The ids can then be
+    // prefilled as an InputText of a tensor buffer, without tokenizing the
+    // text again.
+    virtual absl::StatusOr<std::vector<int>> TextToPrefillTokenIds(
+        absl::string_view text) {
+      return absl::UnimplementedError("Not implemented.");
+    }
+
+    // Captures the current state of the session, i.e. the processed context
+    // and the state needed to continue from it, without running the model.
+    // The checkpoint can be restored any number of times with Restore(), e.g.
+    // to evaluate several continuations of the same context without
+    // prefilling it again. Waits for the pending tasks of the session.
+    virtual absl::StatusOr<std::unique_ptr<SessionCheckpoint>> Checkpoint() {
+      return absl::UnimplementedError("Checkpoint is not implemented.");
+    }
+
+    // Returns the session to the state captured by `checkpoint`, discarding
+    // everything processed since. The checkpoint must come from a session of
+    // the same engine, or of an engine running the same model with the same
+    // settings whose kv-cache the executor can copy directly, see
+    // MigrateTo().
+    virtual absl::Status Restore(const SessionCheckpoint& checkpoint) {
+      return absl::UnimplementedError("Restore is not implemented.");
+    }
+
+    // Writes `checkpoint`, taken by Checkpoint(), to the file at `path`. A
+    // session of a later process running the same model with the same
+    // settings can read it back with LoadCheckpoint() and restore it without
+    // prefilling the context again.
+    virtual absl::Status SaveCheckpoint(const SessionCheckpoint& checkpoint,
+                                        absl::string_view path) {
+      return absl::UnimplementedError("SaveCheckpoint is not implemented.");
+    }
+
+    // Reads a checkpoint written by SaveCheckpoint(), to be passed to
+    // Restore(). The file is memory mapped and must not change while the
+    // checkpoint exists.
+    virtual absl::StatusOr<std::unique_ptr<SessionCheckpoint>> LoadCheckpoint(
+        absl::string_view path) {
+      return absl::UnimplementedError("LoadCheckpoint is not implemented.");
+    }
+
+    // As SaveCheckpoint() and LoadCheckpoint(), in memory, e.g. to send the
+    // context prefilled by a prefill engine to a decode engine on another
+    // host, see EngineRole.
+    virtual absl::StatusOr<std::string> SerializeCheckpoint(
+        const SessionCheckpoint& checkpoint) {
+      return absl::UnimplementedError(
+          "SerializeCheckpoint is not implemented.");
+    }
+    virtual absl::StatusOr<std::unique_ptr<SessionCheckpoint>>
+    DeserializeCheckpoint(std::string data) {
+      return absl::UnimplementedError(
+          "DeserializeCheckpoint is not implemented.");
+    }
+
+    // Creates a new session of the same engine starting from the current
+    // state of this session. Both sessions continue independently.
+    virtual absl::StatusOr<std::unique_ptr<Session>> Fork() {
+      return absl::UnimplementedError("Fork is not implemented.");
+    }
+
+    // Creates a session of `engine` continuing from the current state of this
+    // session, e.g. to move a long conversation off an engine being drained
+    // or reloaded, or onto a less loaded one, without prefilling it again.
+    // `engine` must run the same model with the same settings. The kv-cache
+    // is copied device to device when the executors support it, through host
+    // memory otherwise. Both sessions stay usable; destroy this one to free
+    // its context. Waits for the pending tasks of the session.
+    virtual absl::StatusOr<std::unique_ptr<Session>> MigrateTo(
+        const Engine& engine) {
+      return absl::UnimplementedError("MigrateTo is not implemented.");
+    }
+
+    // Creates a stream for an audio input of a coming prefill. The stream
+    // must not outlive the session.
+    virtual absl::StatusOr<std::unique_ptr<AudioStream>> CreateAudioStream() {
+      return absl::UnimplementedError(
+          "CreateAudioStream is not implemented.");
+    }
   };
 
   // Method to create Engine. An input prompt can be given as a hint to adjust
   // engine optimized for that prompt.
   static absl::StatusOr<std::unique_ptr<Engine>> CreateEngine(
       EngineSettings settings, absl::string_view input_prompt_as_hint = "");
+  // As above, reporting the phases of the creation to `progress`, which may
+  // cancel it. See EngineCreation to create the engine in the background.
+  static absl::StatusOr<std::unique_ptr<Engine>> CreateEngine(
+      EngineSettings settings, absl::string_view input_prompt_as_hint,
+      EngineCreationProgress* progress);
 
   // Method to create the Session.
   virtual absl::StatusOr<std::unique_ptr<Session>> CreateSession(
@@ -194,9 +465,77 @@ class Engine {
     return absl::UnimplementedError("Not implemented.");
   }
 
+  // Drains the engine, e.g. before a rolling restart: stops admitting new
+  // sessions and new requests of the live ones, which fail with an
+  // Unavailable error, cancels the requests in flight, and waits until the
+  // engine is done with all the tasks. Returns a DeadlineExceeded error if
+  // the timeout is reached first. The engine admits no work after it.
+  virtual absl::Status Drain(absl::Duration timeout) {
+    return absl::UnimplementedError("Not implemented.");
+  }
+
   // Returns the EngineSettings currently used by the engine.
   virtual const EngineSettings& GetEngineSettings() const = 0;
 
+  // Returns the tokenizer of the main model, shared with the sessions, e.g.
+  // to count the tokens of a prompt without creating a session. It can be
+  // called from any thread and is owned by the engine.
+  virtual absl::StatusOr<Tokenizer*> GetTokenizer() const {
+    return absl::UnimplementedError("Not implemented.");
+  }
+
+  // Registers the LoRA adapter of the base model at `file_path` as `id`,
+  // which the sessions select with SessionConfig::SetLoraAdapterId(). The
+  // adapter is loaded by the first session using it.
+  virtual absl::Status RegisterLoraAdapter(absl::string_view id,
+                                           absl::string_view file_path) {
+    return absl::UnimplementedError("Not implemented.");
+  }
+
+  // Unregisters the LoRA adapter of `id`, which no session may be using.
+  virtual absl::Status UnregisterLoraAdapter(absl::string_view id) {
+    return absl::UnimplementedError("Not implemented.");
+  }
+
+  // Returns the current load of the engine, used to place new sessions on
+  // the least loaded engine of an EnginePool.
+  virtual absl::StatusOr<EngineLoad> GetLoad() const {
+    return absl::UnimplementedError("Not implemented.");
+  }
+
+  // Returns the metrics of the engine. Unlike the benchmark, they are always
+  // maintained.
+  virtual absl::StatusOr<EngineMetrics> GetMetrics() const {
+    return absl::UnimplementedError("Not implemented.");
+  }
+
+  // Sheds the caches and the unused vision and audio executors of the engine
+  // right away, e.g. from the memory pressure callback of the OS
+  // (onTrimMemory() on Android, the memory warning on iOS, or a cgroup memory
+  // event), before the process gets killed. The sessions keep working, the
+  // shed resources are recomputed on demand.
+  virtual absl::Status NotifyMemoryPressure() {
+    return absl::UnimplementedError("Not implemented.");
+  }
+
+  // Returns what the engine shed under memory pressure so far.
+  virtual absl::StatusOr<MemorySheddingStats> GetMemorySheddingStats() const {
+    return absl::UnimplementedError("Not implemented.");
+  }
+
+  // Returns the current memory of the engine by component, and the memory
+  // taken by each phase of its creation.
+  virtual absl::StatusOr<EngineMemoryUsage> GetMemoryUsage() const {
+    return absl::UnimplementedError("Not implemented.");
+  }
+
+  // Returns the latency histograms of the decode turns of all the sessions of
+  // the engine, when the benchmark is enabled in the engine settings.
+  virtual absl::StatusOr<DecodeLatencyHistograms> GetDecodeLatencyHistograms()
+      const {
+    return absl::UnimplementedError("Not implemented.");
+  }
+
   // Default timeout duration for the engine/session processes.
   static constexpr absl::Duration kDefaultTimeout = absl::Minutes(10);
 };
@@ -0,0 +1,107 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/engine/engine_creation.h"
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>  // NOLINT: Required for the creation thread.
+#include <utility>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+
+namespace litert::lm {
+
+std::ostream& operator<<(std::ostream& os, EngineCreationPhase phase) {
+  switch (phase) {
+    case EngineCreationPhase::kModelMapping:
+      return os << "MODEL_MAPPING";
+    case EngineCreationPhase::kTokenizer:
+      return os << "TOKENIZER";
+    case EngineCreationPhase::kMainExecutor:
+      return os << "MAIN_EXECUTOR";
+    case EngineCreationPhase::kVisionExecutor:
+      return os << "VISION_EXECUTOR";
+    case EngineCreationPhase::kAudioExecutor:
+      return os << "AUDIO_EXECUTOR";
+    case EngineCreationPhase::kDraftExecutor:
+      return os << "DRAFT_EXECUTOR";
+    case EngineCreationPhase::kWarmUp:
+      return os << "WARM_UP";
+  }
+  return os << "UNKNOWN";
+}
+
+absl::Status EngineCreationProgress::CompletePhase(EngineCreationPhase phase) {
+  absl::MutexLock lock(&mutex_);
+  if (cancelled_) {
+    return absl::CancelledError("The engine creation is cancelled.");
+  }
+  if (callback_) {
+    callback_(phase);
+  }
+  return absl::OkStatus();
+}
+
+std::unique_ptr<EngineCreation> EngineCreation::Start(
+    EngineSettings settings, ProgressCallback progress_callback,
+    DoneCallback done_callback, absl::string_view input_prompt_as_hint) {
+  // Not make_unique, the constructor being private.
+  auto creation = std::unique_ptr<EngineCreation>(
+      new EngineCreation(std::move(progress_callback)));
+  creation->thread_ = std::thread(
+      [creation = creation.get(), settings = std::move(settings),
+       done_callback = std::move(done_callback),
+       input_prompt_as_hint = std::string(input_prompt_as_hint)]() mutable {
+        absl::StatusOr<std::unique_ptr<Engine>> engine = Engine::CreateEngine(
+            std::move(settings), input_prompt_as_hint, &creation->progress_);
+        const absl::Status status = engine.status();
+        {
+          absl::MutexLock lock(&creation->mutex_);
+          creation->engine_ = std::move(engine);
+          creation->done_ = true;
+        }
+        if (done_callback) {
+          done_callback(status);
+        }
+      });
+  return creation;
+}
+
+EngineCreation::~EngineCreation() {
+  Cancel();
+  thread_.join();
+}
+
+bool EngineCreation::IsDone() const {
+  absl::MutexLock lock(&mutex_);
+  return done_;
+}
+
+absl::StatusOr<std::unique_ptr<Engine>> EngineCreation::Wait() {
+  absl::MutexLock lock(&mutex_);
+  mutex_.Await(absl::Condition(&done_));
+  absl::StatusOr<std::unique_ptr<Engine>> engine = std::move(engine_);
+  engine_ = absl::FailedPreconditionError("The engine is already returned.");
+  return engine;
+}
+
+}  // namespace litert::lm
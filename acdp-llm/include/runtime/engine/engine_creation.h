@@ -0,0 +1,142 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_ENGINE_CREATION_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_ENGINE_CREATION_H_
+
+#include <atomic>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>  // NOLINT: Required for the creation thread.
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+
+namespace litert::lm {
+
+// The phases of an engine creation, in the order they complete when the
+// executors are created sequentially. The phases of the executors the model
+// does not have, or of the executors created on first use, are skipped.
+enum class EngineCreationPhase {
+  // The model file is mapped and its sections located.
+  kModelMapping = 0,
+  // The tokenizer is loaded and the settings validated against the model.
+  kTokenizer = 1,
+  // The executors are created, compiling their models.
+  kMainExecutor = 2,
+  kVisionExecutor = 3,
+  kAudioExecutor = 4,
+  kDraftExecutor = 5,
+  // The main executor ran its warm-up, see
+  // EngineSettings::SetNumWarmUpDecodeSteps().
+  kWarmUp = 6,
+};
+std::ostream& operator<<(std::ostream& os, EngineCreationPhase phase);
+
+// Reports the phases of an engine creation as they complete, and lets
+// another thread cancel it. Thread-safe.
+//
+// A cancelled creation stops as its current phase completes, with a
+// Cancelled error: the phase in progress, e.g. a model compilation, can not
+// be interrupted.
+class EngineCreationProgress {
+ public:
+  using Callback = absl::AnyInvocable<void(EngineCreationPhase phase)>;
+
+  explicit EngineCreationProgress(Callback callback = nullptr)
+      : callback_(std::move(callback)) {}
+
+  EngineCreationProgress(const EngineCreationProgress&) = delete;
+  EngineCreationProgress& operator=(const EngineCreationProgress&) = delete;
+
+  void Cancel() { cancelled_ = true; }
+  bool IsCancelled() const { return cancelled_; }
+
+  // Called by the creation when `phase` completes, possibly from the threads
+  // creating the executors concurrently. Calls the callback, never
+  // concurrently, unless cancelled. Returns a Cancelled error if the creation
+  // is cancelled.
+  absl::Status CompletePhase(EngineCreationPhase phase);
+
+ private:
+  std::atomic<bool> cancelled_ = false;
+  absl::Mutex mutex_;
+  Callback callback_ ABSL_GUARDED_BY(mutex_);
+};
+
+// An engine created on a background thread, so that the caller is not
+// blocked for the whole model loading and may cancel it.
+//
+// Example usage:
+//   auto creation = EngineCreation::Start(
+//       std::move(engine_settings),
+//       [](EngineCreationPhase phase) { ABSL_LOG(INFO) << phase; });
+//   // ... serve other requests, or creation->Cancel() ...
+//   ASSIGN_OR_RETURN(std::unique_ptr<Engine> engine, creation->Wait());
+class EngineCreation {
+ public:
+  using ProgressCallback = EngineCreationProgress::Callback;
+  // Called once with the status of the creation when it is done. Wait() then
+  // returns without blocking, the creation must not be destroyed by the
+  // callback.
+  using DoneCallback = absl::AnyInvocable<void(const absl::Status& status)>;
+
+  // Starts creating the engine as Engine::CreateEngine() does. The callbacks
+  // are called on the background threads.
+  static std::unique_ptr<EngineCreation> Start(
+      EngineSettings settings, ProgressCallback progress_callback = nullptr,
+      DoneCallback done_callback = nullptr,
+      absl::string_view input_prompt_as_hint = "");
+
+  // Cancels the creation if not done and waits for it to stop. An engine
+  // created and not returned by Wait() is destroyed.
+  ~EngineCreation();
+
+  EngineCreation(const EngineCreation&) = delete;
+  EngineCreation& operator=(const EngineCreation&) = delete;
+
+  // Requests the cancellation of the creation, see EngineCreationProgress.
+  void Cancel() { progress_.Cancel(); }
+
+  // Returns whether the creation is done, successfully or not.
+  bool IsDone() const;
+
+  // Waits for the creation to be done and returns the engine, or the error
+  // of the creation. The engine is returned once, the later calls fail.
+  absl::StatusOr<std::unique_ptr<Engine>> Wait();
+
+ private:
+  explicit EngineCreation(ProgressCallback progress_callback)
+      : progress_(std::move(progress_callback)) {}
+
+  EngineCreationProgress progress_;
+
+  mutable absl::Mutex mutex_;
+  bool done_ ABSL_GUARDED_BY(mutex_) = false;
+  absl::StatusOr<std::unique_ptr<Engine>> engine_ ABSL_GUARDED_BY(mutex_);
+
+  std::thread thread_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_ENGINE_CREATION_H_
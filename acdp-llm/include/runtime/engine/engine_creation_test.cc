@@ -0,0 +1,111 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/engine/engine_creation.h"
+
+#include <filesystem>  // NOLINT: Required for path manipulation.
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/notification.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/executor/executor_settings_base.h"
+#include "runtime/executor/llm_executor_settings.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::status::StatusIs;
+
+absl::StatusOr<EngineSettings> GetTestEngineSettings() {
+  auto task_path =
+      std::filesystem::path(::testing::SrcDir()) /
+      "litert_lm/runtime/testdata/test_lm_new_metadata.task";
+  ASSIGN_OR_RETURN(auto model_assets, ModelAssets::Create(task_path.string()));
+  ASSIGN_OR_RETURN(auto engine_settings,
+                   EngineSettings::CreateDefault(model_assets, Backend::CPU));
+  engine_settings.GetMutableMainExecutorSettings().SetMaxNumTokens(16);
+  engine_settings.GetMutableMainExecutorSettings().SetCacheDir(":nocache");
+  return engine_settings;
+}
+
+TEST(EngineCreationProgressTest, ReportsThePhasesUntilCancelled) {
+  std::vector<EngineCreationPhase> phases;
+  EngineCreationProgress progress(
+      [&phases](EngineCreationPhase phase) { phases.push_back(phase); });
+  EXPECT_OK(progress.CompletePhase(EngineCreationPhase::kModelMapping));
+  EXPECT_OK(progress.CompletePhase(EngineCreationPhase::kTokenizer));
+  EXPECT_FALSE(progress.IsCancelled());
+
+  progress.Cancel();
+  EXPECT_TRUE(progress.IsCancelled());
+  EXPECT_THAT(progress.CompletePhase(EngineCreationPhase::kMainExecutor),
+              StatusIs(absl::StatusCode::kCancelled));
+  EXPECT_THAT(phases, ElementsAre(EngineCreationPhase::kModelMapping,
+                                  EngineCreationPhase::kTokenizer));
+}
+
+TEST(EngineCreationTest, CreatesTheEngineInTheBackground) {
+  ASSERT_OK_AND_ASSIGN(auto engine_settings, GetTestEngineSettings());
+  std::vector<EngineCreationPhase> phases;
+  absl::Notification done;
+  auto creation = EngineCreation::Start(
+      std::move(engine_settings),
+      [&phases](EngineCreationPhase phase) { phases.push_back(phase); },
+      [&done](const absl::Status& status) {
+        EXPECT_OK(status);
+        done.Notify();
+      });
+  done.WaitForNotification();
+  EXPECT_TRUE(creation->IsDone());
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Engine> engine, creation->Wait());
+  EXPECT_NE(engine, nullptr);
+  EXPECT_THAT(phases, ElementsAre(EngineCreationPhase::kModelMapping,
+                                  EngineCreationPhase::kTokenizer,
+                                  EngineCreationPhase::kMainExecutor));
+  // The engine is returned once.
+  EXPECT_THAT(creation->Wait(),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST(EngineCreationTest, CancelsTheCreation) {
+  ASSERT_OK_AND_ASSIGN(auto engine_settings, GetTestEngineSettings());
+  std::vector<EngineCreationPhase> phases;
+  std::unique_ptr<EngineCreation> creation;
+  absl::Notification started;
+  creation = EngineCreation::Start(
+      std::move(engine_settings),
+      [&](EngineCreationPhase phase) {
+        phases.push_back(phase);
+        // Cancels from the first phase, the creation stops at the next one.
+        started.WaitForNotification();
+        creation->Cancel();
+      });
+  started.Notify();
+  EXPECT_THAT(creation->Wait(), StatusIs(absl::StatusCode::kCancelled));
+  EXPECT_THAT(phases, ElementsAre(EngineCreationPhase::kModelMapping));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,230 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/engine/engine_pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/hash/hash.h"  // from @com_google_absl
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_creation.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+// Returns the rendezvous hashing scores of `prefix` for the engines: the
+// prefix goes to the engines with the highest scores.
+std::vector<size_t> ScoreEngines(absl::string_view prefix, int num_engines) {
+  const size_t prefix_hash = absl::HashOf(prefix);
+  std::vector<size_t> scores(num_engines);
+  for (int i = 0; i < num_engines; ++i) {
+    scores[i] = absl::HashOf(prefix_hash, i);
+  }
+  return scores;
+}
+
+}  // namespace
+
+// static
+absl::StatusOr<std::unique_ptr<EnginePool>> EnginePool::Create(
+    std::vector<std::unique_ptr<Engine>> engines,
+    int max_affinity_load_imbalance) {
+  if (engines.empty()) {
+    return absl::InvalidArgumentError("The pool needs at least one engine.");
+  }
+  for (int i = 0; i < engines.size(); ++i) {
+    if (engines[i] == nullptr) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("The engine ", i, " is null."));
+    }
+    if (auto load = engines[i]->GetLoad(); !load.ok()) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "The engine ", i, " does not report its load: ", load.status()));
+    }
+  }
+  if (max_affinity_load_imbalance < 0) {
+    return absl::InvalidArgumentError(
+        "The max affinity load imbalance must not be negative.");
+  }
+  return absl::WrapUnique(
+      new EnginePool(std::move(engines), max_affinity_load_imbalance));
+}
+
+// static
+absl::StatusOr<std::unique_ptr<EnginePool>> EnginePool::CreateFromSettings(
+    std::vector<EngineSettings> settings, int max_affinity_load_imbalance) {
+  std::vector<std::unique_ptr<EngineCreation>> creations;
+  creations.reserve(settings.size());
+  for (auto& engine_settings : settings) {
+    creations.push_back(EngineCreation::Start(std::move(engine_settings)));
+  }
+  std::vector<std::unique_ptr<Engine>> engines;
+  engines.reserve(creations.size());
+  // On error, the destruction of the remaining creations cancels them.
+  for (auto& creation : creations) {
+    ASSIGN_OR_RETURN(auto engine, creation->Wait());
+    engines.push_back(std::move(engine));
+  }
+  return Create(std::move(engines), max_affinity_load_imbalance);
+}
+
+absl::StatusOr<std::vector<int>> EnginePool::RankEngines() const {
+  const int num_engines = engines_.size();
+  const int first = next_engine_.load() % num_engines;
+  // The sort key of every engine, the smaller the less loaded.
+  std::vector<std::tuple<int, int, int, int>> keys;
+  keys.reserve(num_engines);
+  for (int i = 0; i < num_engines; ++i) {
+    ASSIGN_OR_RETURN(const EngineLoad load, engines_[i]->GetLoad());
+    keys.emplace_back(load.num_queued_tasks, load.num_sessions,
+                      -load.num_free_kv_cache_tokens.value_or(0),
+                      (i - first + num_engines) % num_engines);
+  }
+  std::vector<int> ranking(num_engines);
+  std::iota(ranking.begin(), ranking.end(), 0);
+  std::sort(ranking.begin(), ranking.end(),
+            [&keys](int a, int b) { return keys[a] < keys[b]; });
+  return ranking;
+}
+
+absl::StatusOr<std::vector<int>> EnginePool::RankEnginesForPrefix(
+    absl::string_view prefix) const {
+  const int num_engines = engines_.size();
+  std::vector<int> num_queued_tasks(num_engines);
+  for (int i = 0; i < num_engines; ++i) {
+    ASSIGN_OR_RETURN(const EngineLoad load, engines_[i]->GetLoad());
+    num_queued_tasks[i] = load.num_queued_tasks;
+  }
+  const int max_num_queued_tasks =
+      *std::min_element(num_queued_tasks.begin(), num_queued_tasks.end()) +
+      max_affinity_load_imbalance_;
+  const std::vector<size_t> scores = ScoreEngines(prefix, num_engines);
+  std::vector<int> ranking(num_engines);
+  std::iota(ranking.begin(), ranking.end(), 0);
+  std::sort(ranking.begin(), ranking.end(), [&](int a, int b) {
+    const bool a_overloaded = num_queued_tasks[a] > max_num_queued_tasks;
+    const bool b_overloaded = num_queued_tasks[b] > max_num_queued_tasks;
+    if (a_overloaded != b_overloaded) {
+      return b_overloaded;
+    }
+    if (a_overloaded) {
+      return std::tie(num_queued_tasks[a], scores[b]) <
+             std::tie(num_queued_tasks[b], scores[a]);
+    }
+    return scores[a] > scores[b];
+  });
+  return ranking;
+}
+
+absl::StatusOr<std::unique_ptr<Engine::Session>>
+EnginePool::CreateSessionOnFirst(const std::vector<int>& ranking,
+                                 const SessionConfig& session_config,
+                                 int& engine) const {
+  absl::Status status;
+  for (int i : ranking) {
+    auto session = engines_[i]->CreateSession(session_config);
+    if (session.ok() || !absl::IsResourceExhausted(session.status())) {
+      engine = i;
+      return session;
+    }
+    status = session.status();
+  }
+  return absl::ResourceExhaustedError(absl::StrCat(
+      "None of the ", engines_.size(),
+      " engines can host one more session, last error: ", status));
+}
+
+absl::StatusOr<std::unique_ptr<Engine::Session>> EnginePool::CreateSession(
+    const SessionConfig& session_config) const {
+  ASSIGN_OR_RETURN(const std::vector<int> ranking, RankEngines());
+  next_engine_.fetch_add(1);
+  int engine;
+  return CreateSessionOnFirst(ranking, session_config, engine);
+}
+
+absl::StatusOr<std::unique_ptr<Engine::Session>> EnginePool::CreateSession(
+    const SessionConfig& session_config, absl::string_view prefix) const {
+  ASSIGN_OR_RETURN(const std::vector<int> ranking,
+                   RankEnginesForPrefix(prefix));
+  int engine;
+  ASSIGN_OR_RETURN(auto session,
+                   CreateSessionOnFirst(ranking, session_config, engine));
+  // The engine of the prefix has the highest score, wherever the load placed
+  // it in the ranking.
+  const std::vector<size_t> scores = ScoreEngines(prefix, engines_.size());
+  if (engine != std::max_element(scores.begin(), scores.end()) -
+                    scores.begin()) {
+    num_spillovers_.fetch_add(1);
+  }
+  return session;
+}
+
+std::vector<std::optional<EngineMetrics::CacheStats>>
+EnginePool::GetPrefixCacheStats() const {
+  std::vector<std::optional<EngineMetrics::CacheStats>> stats;
+  stats.reserve(engines_.size());
+  for (const auto& engine : engines_) {
+    auto metrics = engine->GetMetrics();
+    stats.push_back(metrics.ok() ? metrics->prefix_cache : std::nullopt);
+  }
+  return stats;
+}
+
+absl::Status EnginePool::RegisterLoraAdapter(absl::string_view id,
+                                             absl::string_view file_path) {
+  for (int i = 0; i < engines_.size(); ++i) {
+    if (auto status = engines_[i]->RegisterLoraAdapter(id, file_path);
+        !status.ok()) {
+      // Keep the engines consistent.
+      for (int j = 0; j < i; ++j) {
+        engines_[j]->UnregisterLoraAdapter(id).IgnoreError();
+      }
+      return status;
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status EnginePool::UnregisterLoraAdapter(absl::string_view id) {
+  absl::Status status;
+  for (const auto& engine : engines_) {
+    status.Update(engine->UnregisterLoraAdapter(id));
+  }
+  return status;
+}
+
+absl::Status EnginePool::WaitUntilDone(absl::Duration timeout) {
+  for (const auto& engine : engines_) {
+    RETURN_IF_ERROR(engine->WaitUntilDone(timeout));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,147 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_ENGINE_POOL_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_ENGINE_POOL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+
+namespace litert::lm {
+
+// EnginePool owns several engines of the same model, typically each on its
+// own accelerator (several GPUs, or a GPU and an NPU), and places every new
+// session on the least loaded of them, so that a single process can use all
+// the accelerators of a host.
+//
+// The load of an engine is given by Engine::GetLoad(). The sessions are
+// placed on the engine with the fewest queued tasks, then with the fewest
+// sessions, then with the most free kv-cache tokens. The ties are broken in
+// turns, so that an idle pool spreads the sessions over all its engines.
+//
+// The sessions of conversations sharing a prefix (a preface, a system prompt,
+// earlier turns) are better placed on the same engine, whose prefix cache
+// holds the kv-cache of that prefix. CreateSession() with a prefix picks the
+// engine by consistent (rendezvous) hashing of the prefix, so that a prefix
+// keeps its engine as long as the engines are not overloaded, and only the
+// prefixes of a removed engine move. The sessions spill over to the next
+// engines of the prefix when its engine has more than
+// `max_affinity_load_imbalance` queued tasks above the least loaded engine.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(auto pool, EnginePool::CreateFromSettings(
+//                                   {std::move(gpu_settings),
+//                                    std::move(npu_settings)}));
+//   ASSIGN_OR_RETURN(auto session,
+//                    pool->CreateSession(SessionConfig::CreateDefault()));
+//
+// The class is thread-safe.
+class EnginePool {
+ public:
+  static constexpr int kDefaultMaxAffinityLoadImbalance = 4;
+
+  // Creates a pool of `engines`, which must all report their load.
+  static absl::StatusOr<std::unique_ptr<EnginePool>> Create(
+      std::vector<std::unique_ptr<Engine>> engines,
+      int max_affinity_load_imbalance = kDefaultMaxAffinityLoadImbalance);
+
+  // Creates the engines of `settings` concurrently, see EngineCreation, and a
+  // pool of them. Fails if any of the creations fails.
+  static absl::StatusOr<std::unique_ptr<EnginePool>> CreateFromSettings(
+      std::vector<EngineSettings> settings,
+      int max_affinity_load_imbalance = kDefaultMaxAffinityLoadImbalance);
+
+  EnginePool(const EnginePool&) = delete;
+  EnginePool& operator=(const EnginePool&) = delete;
+
+  // Creates a session on the least loaded engine. If the engine can not host
+  // one more session (a ResourceExhausted error, e.g. all the slots of its
+  // batching executor are in use), tries the next least loaded ones.
+  absl::StatusOr<std::unique_ptr<Engine::Session>> CreateSession(
+      const SessionConfig& session_config) const;
+
+  // Creates a session of a conversation starting with `prefix` on the engine
+  // of the prefix, or on the next engines of the prefix if it is overloaded
+  // or full, see the class comment.
+  absl::StatusOr<std::unique_ptr<Engine::Session>> CreateSession(
+      const SessionConfig& session_config, absl::string_view prefix) const;
+
+  // Returns the indices of the engines, from the least to the most loaded.
+  // Used by CreateSession().
+  absl::StatusOr<std::vector<int>> RankEngines() const;
+
+  // Returns the indices of the engines in the order tried for the sessions
+  // starting with `prefix`: the engines not overloaded by their consistent
+  // hash with the prefix, then the overloaded ones from the least to the most
+  // loaded.
+  absl::StatusOr<std::vector<int>> RankEnginesForPrefix(
+      absl::string_view prefix) const;
+
+  // Returns the lookups of the prefix cache of every engine, std::nullopt for
+  // the engines without a prefix cache or not reporting their metrics. The
+  // hit rates tell how well the sessions are placed by their prefixes.
+  std::vector<std::optional<EngineMetrics::CacheStats>> GetPrefixCacheStats()
+      const;
+
+  // Returns the number of sessions with a prefix placed on another engine
+  // than the one of their prefix.
+  int64_t GetNumAffinitySpillovers() const { return num_spillovers_.load(); }
+
+  int GetNumEngines() const { return engines_.size(); }
+  Engine& GetEngine(int index) const { return *engines_[index]; }
+
+  // Registers or unregisters the LoRA adapter on every engine, see
+  // Engine::RegisterLoraAdapter().
+  absl::Status RegisterLoraAdapter(absl::string_view id,
+                                   absl::string_view file_path);
+  absl::Status UnregisterLoraAdapter(absl::string_view id);
+
+  // Waits until all the engines are done with their tasks, within `timeout`
+  // for every engine.
+  absl::Status WaitUntilDone(absl::Duration timeout);
+
+ private:
+  EnginePool(std::vector<std::unique_ptr<Engine>> engines,
+             int max_affinity_load_imbalance)
+      : engines_(std::move(engines)),
+        max_affinity_load_imbalance_(max_affinity_load_imbalance) {}
+
+  // Creates a session on the first engine of `ranking` which is not full.
+  absl::StatusOr<std::unique_ptr<Engine::Session>> CreateSessionOnFirst(
+      const std::vector<int>& ranking, const SessionConfig& session_config,
+      int& engine) const;
+
+  const std::vector<std::unique_ptr<Engine>> engines_;
+  const int max_affinity_load_imbalance_;
+  // The engine preferred among the equally loaded ones, advanced by every
+  // placement.
+  mutable std::atomic<int> next_engine_ = 0;
+  mutable std::atomic<int64_t> num_spillovers_ = 0;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_ENGINE_POOL_H_
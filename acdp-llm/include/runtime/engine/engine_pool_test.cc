@@ -0,0 +1,244 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/engine/engine_pool.h"
+
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/fake_engine.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::status::StatusIs;
+
+// An engine reporting the load set by the test, and counting its sessions.
+class PooledEngine : public FakeEngine {
+ public:
+  absl::StatusOr<std::unique_ptr<Session>> CreateSession(
+      const SessionConfig& session_config) const override {
+    if (!create_session_status.ok()) {
+      return create_session_status;
+    }
+    ++load.num_sessions;
+    return std::make_unique<MockSession>();
+  }
+
+  absl::StatusOr<EngineLoad> GetLoad() const override { return load; }
+
+  absl::StatusOr<EngineMetrics> GetMetrics() const override {
+    if (!metrics.has_value()) {
+      return Engine::GetMetrics();
+    }
+    return *metrics;
+  }
+
+  absl::Status RegisterLoraAdapter(absl::string_view id,
+                                   absl::string_view file_path) override {
+    if (!register_lora_status.ok()) {
+      return register_lora_status;
+    }
+    ++num_lora_adapters;
+    return absl::OkStatus();
+  }
+
+  absl::Status UnregisterLoraAdapter(absl::string_view id) override {
+    --num_lora_adapters;
+    return absl::OkStatus();
+  }
+
+  mutable EngineLoad load;
+  std::optional<EngineMetrics> metrics;
+  absl::Status create_session_status;
+  absl::Status register_lora_status;
+  int num_lora_adapters = 0;
+};
+
+// An engine of the base interface, which does not report its load.
+class EngineWithoutLoad : public PooledEngine {
+ public:
+  absl::StatusOr<EngineLoad> GetLoad() const override {
+    return Engine::GetLoad();
+  }
+};
+
+// Creates a pool of `num_engines` fake engines, returned in `engines`.
+std::unique_ptr<EnginePool> CreatePool(int num_engines,
+                                       std::vector<PooledEngine*>& engines) {
+  std::vector<std::unique_ptr<Engine>> owned_engines;
+  for (int i = 0; i < num_engines; ++i) {
+    auto engine = std::make_unique<PooledEngine>();
+    engines.push_back(engine.get());
+    owned_engines.push_back(std::move(engine));
+  }
+  return *EnginePool::Create(std::move(owned_engines));
+}
+
+TEST(EnginePoolTest, CreateFailsWithoutEngines) {
+  EXPECT_THAT(EnginePool::Create({}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(EnginePoolTest, CreateFailsWithEnginesNotReportingTheirLoad) {
+  std::vector<std::unique_ptr<Engine>> engines;
+  engines.push_back(std::make_unique<PooledEngine>());
+  engines.push_back(std::make_unique<EngineWithoutLoad>());
+  EXPECT_THAT(EnginePool::Create(std::move(engines)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(EnginePoolTest, SpreadsTheSessionsOverIdleEngines) {
+  std::vector<PooledEngine*> engines;
+  auto pool = CreatePool(/*num_engines=*/3, engines);
+  std::vector<std::unique_ptr<Engine::Session>> sessions;
+  for (int i = 0; i < 6; ++i) {
+    ASSERT_OK_AND_ASSIGN(auto session,
+                         pool->CreateSession(SessionConfig::CreateDefault()));
+    sessions.push_back(std::move(session));
+  }
+  for (const PooledEngine* engine : engines) {
+    EXPECT_EQ(engine->load.num_sessions, 2);
+  }
+}
+
+TEST(EnginePoolTest, RanksTheEnginesByLoad) {
+  std::vector<PooledEngine*> engines;
+  auto pool = CreatePool(/*num_engines=*/3, engines);
+  engines[0]->load.num_queued_tasks = 2;
+  engines[1]->load.num_sessions = 1;
+  engines[1]->load.num_free_kv_cache_tokens = 100;
+  engines[2]->load.num_sessions = 1;
+  engines[2]->load.num_free_kv_cache_tokens = 200;
+  ASSERT_OK_AND_ASSIGN(std::vector<int> ranking, pool->RankEngines());
+  EXPECT_THAT(ranking, ElementsAre(2, 1, 0));
+
+  ASSERT_OK_AND_ASSIGN(auto session,
+                       pool->CreateSession(SessionConfig::CreateDefault()));
+  EXPECT_EQ(engines[2]->load.num_sessions, 2);
+}
+
+TEST(EnginePoolTest, CreateSessionSkipsTheFullEngines) {
+  std::vector<PooledEngine*> engines;
+  auto pool = CreatePool(/*num_engines=*/2, engines);
+  engines[0]->create_session_status =
+      absl::ResourceExhaustedError("All the slots are in use.");
+  engines[1]->load.num_queued_tasks = 5;
+  ASSERT_OK_AND_ASSIGN(auto session,
+                       pool->CreateSession(SessionConfig::CreateDefault()));
+  EXPECT_EQ(engines[1]->load.num_sessions, 1);
+
+  engines[1]->create_session_status =
+      absl::ResourceExhaustedError("All the slots are in use.");
+  EXPECT_THAT(pool->CreateSession(SessionConfig::CreateDefault()),
+              StatusIs(absl::StatusCode::kResourceExhausted));
+}
+
+TEST(EnginePoolTest, CreateSessionPropagatesOtherErrors) {
+  std::vector<PooledEngine*> engines;
+  auto pool = CreatePool(/*num_engines=*/2, engines);
+  engines[0]->create_session_status = absl::InvalidArgumentError("Bad.");
+  engines[1]->load.num_queued_tasks = 1;
+  EXPECT_THAT(pool->CreateSession(SessionConfig::CreateDefault()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(engines[1]->load.num_sessions, 0);
+}
+
+TEST(EnginePoolTest, SessionsWithTheSamePrefixShareTheirEngine) {
+  std::vector<PooledEngine*> engines;
+  auto pool = CreatePool(/*num_engines=*/4, engines);
+  ASSERT_OK_AND_ASSIGN(std::vector<int> ranking,
+                       pool->RankEnginesForPrefix("You are a travel agent."));
+  const int prefix_engine = ranking[0];
+  std::vector<std::unique_ptr<Engine::Session>> sessions;
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK_AND_ASSIGN(auto session,
+                         pool->CreateSession(SessionConfig::CreateDefault(),
+                                             "You are a travel agent."));
+    sessions.push_back(std::move(session));
+  }
+  EXPECT_EQ(engines[prefix_engine]->load.num_sessions, 3);
+  EXPECT_EQ(pool->GetNumAffinitySpillovers(), 0);
+}
+
+TEST(EnginePoolTest, SessionsSpillOverFromTheOverloadedEngineOfTheirPrefix) {
+  std::vector<PooledEngine*> engines;
+  auto pool = CreatePool(/*num_engines=*/3, engines);
+  ASSERT_OK_AND_ASSIGN(std::vector<int> ranking,
+                       pool->RankEnginesForPrefix("You are a travel agent."));
+  engines[ranking[0]]->load.num_queued_tasks =
+      EnginePool::kDefaultMaxAffinityLoadImbalance;
+  ASSERT_OK_AND_ASSIGN(auto session,
+                       pool->CreateSession(SessionConfig::CreateDefault(),
+                                           "You are a travel agent."));
+  EXPECT_EQ(engines[ranking[0]]->load.num_sessions, 1);
+
+  engines[ranking[0]]->load.num_queued_tasks =
+      EnginePool::kDefaultMaxAffinityLoadImbalance + 1;
+  ASSERT_OK_AND_ASSIGN(std::vector<int> spillover_ranking,
+                       pool->RankEnginesForPrefix("You are a travel agent."));
+  EXPECT_THAT(spillover_ranking, ElementsAre(ranking[1], ranking[2],
+                                             ranking[0]));
+  ASSERT_OK_AND_ASSIGN(session,
+                       pool->CreateSession(SessionConfig::CreateDefault(),
+                                           "You are a travel agent."));
+  EXPECT_EQ(engines[ranking[1]]->load.num_sessions, 1);
+  EXPECT_EQ(pool->GetNumAffinitySpillovers(), 1);
+}
+
+TEST(EnginePoolTest, GetPrefixCacheStatsOfEveryEngine) {
+  std::vector<PooledEngine*> engines;
+  auto pool = CreatePool(/*num_engines=*/2, engines);
+  engines[0]->metrics.emplace();
+  engines[0]->metrics->prefix_cache =
+      EngineMetrics::CacheStats{.num_hits = 3, .num_misses = 1};
+  std::vector<std::optional<EngineMetrics::CacheStats>> stats =
+      pool->GetPrefixCacheStats();
+  ASSERT_EQ(stats.size(), 2);
+  ASSERT_TRUE(stats[0].has_value());
+  EXPECT_DOUBLE_EQ(stats[0]->GetHitRate(), 0.75);
+  EXPECT_FALSE(stats[1].has_value());
+}
+
+TEST(EnginePoolTest, RegisterLoraAdapterIsAllOrNothing) {
+  std::vector<PooledEngine*> engines;
+  auto pool = CreatePool(/*num_engines=*/2, engines);
+  ASSERT_OK(pool->RegisterLoraAdapter("adapter", "/path/to/adapter"));
+  EXPECT_EQ(engines[0]->num_lora_adapters, 1);
+  EXPECT_EQ(engines[1]->num_lora_adapters, 1);
+
+  engines[1]->register_lora_status = absl::NotFoundError("No file.");
+  EXPECT_THAT(pool->RegisterLoraAdapter("other", "/path/to/other"),
+              StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_EQ(engines[0]->num_lora_adapters, 1);
+
+  ASSERT_OK(pool->UnregisterLoraAdapter("adapter"));
+  EXPECT_EQ(engines[0]->num_lora_adapters, 0);
+}
+
+}  // namespace
+}  // namespace litert::lm
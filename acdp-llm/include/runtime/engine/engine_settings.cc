@@ -14,6 +14,8 @@
 
 #include "runtime/engine/engine_settings.h"
 
+#include <cstddef>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <string>
@@ -25,7 +27,9 @@
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_join.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
 #include "runtime/components/tokenizer.h"
 #include "runtime/executor/audio_executor_settings.h"
 #include "runtime/executor/executor_settings_base.h"
@@ -35,6 +39,7 @@
 #include "runtime/proto/llm_model_type.pb.h"
 #include "runtime/proto/sampler_params.pb.h"
 #include "runtime/proto/token.pb.h"
+#include "runtime/util/metadata_util.h"
 #include "runtime/util/model_type_utils.h"
 #include "runtime/util/status_macros.h"  // IWYU pragma: keep
 
@@ -100,35 +105,7 @@ absl::Status EngineSettings::MaybeUpdateAndValidate(
   }
 
   // Convert the start/stop tokens from string to token ids.
-  for (auto& stop_token : *metadata.mutable_stop_tokens()) {
-    if (stop_token.has_token_str()) {
-      auto stop_token_id = tokenizer.TokenToId(stop_token.token_str());
-      if (stop_token_id.ok()) {
-        stop_token.mutable_token_ids()->mutable_ids()->Add(*stop_token_id);
-      } else {
-        auto stop_token_ids = tokenizer.TextToTokenIds(stop_token.token_str());
-        if (stop_token_ids.ok()) {
-          stop_token.mutable_token_ids()->mutable_ids()->Add(
-              stop_token_ids->begin(), stop_token_ids->end());
-        }
-      }
-    }
-  }
-  if (metadata.start_token().has_token_str()) {
-    auto start_token_id =
-        tokenizer.TokenToId(metadata.start_token().token_str());
-    if (start_token_id.ok()) {
-      metadata.mutable_start_token()->mutable_token_ids()->mutable_ids()->Add(
-          *start_token_id);
-    } else {
-      auto start_token_ids =
-          tokenizer.TextToTokenIds(metadata.start_token().token_str());
-      if (start_token_ids.ok()) {
-        metadata.mutable_start_token()->mutable_token_ids()->mutable_ids()->Add(
-            start_token_ids->begin(), start_token_ids->end());
-      }
-    }
-  }
+  ConvertLlmMetadataTokensToIds(tokenizer, metadata);
 
   int num_prompt_tokens = 0;
   if (!input_prompt_as_hint.empty()) {
@@ -150,6 +127,22 @@ absl::Status EngineSettings::MaybeUpdateAndValidate(
     }
     main_executor_settings_.SetMaxNumTokens(max_num_tokens);
   }
+  if (prefill_chunk_size_ < 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Prefill chunk size must not be negative, got ", prefill_chunk_size_));
+  }
+  if (num_warm_up_decode_steps_ < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The number of warm-up decode steps must not be "
+                     "negative, got ",
+                     num_warm_up_decode_steps_));
+  }
+  // The draft model mirrors the context of the main model.
+  if (draft_executor_settings_.has_value() &&
+      draft_executor_settings_->GetMaxNumTokens() == 0) {
+    draft_executor_settings_->SetMaxNumTokens(
+        main_executor_settings_.GetMaxNumTokens());
+  }
 
   if (num_prompt_tokens > 0) {
     AdvancedSettings advanced_settings;
@@ -237,6 +230,160 @@ EngineSettings::GetMutableAudioExecutorSettings() {
   return audio_executor_settings_;
 }
 
+const std::optional<LlmExecutorSettings>&
+EngineSettings::GetDraftExecutorSettings() const {
+  return draft_executor_settings_;
+}
+
+std::optional<LlmExecutorSettings>&
+EngineSettings::GetMutableDraftExecutorSettings() {
+  return draft_executor_settings_;
+}
+
+size_t EngineSettings::GetPrefixCacheMaxSizeBytes() const {
+  return prefix_cache_max_size_bytes_;
+}
+
+void EngineSettings::SetPrefixCacheMaxSizeBytes(
+    size_t prefix_cache_max_size_bytes) {
+  prefix_cache_max_size_bytes_ = prefix_cache_max_size_bytes;
+}
+
+int EngineSettings::GetTokenIdCacheMaxNumEntries() const {
+  return token_id_cache_max_num_entries_;
+}
+
+void EngineSettings::SetTokenIdCacheMaxNumEntries(
+    int token_id_cache_max_num_entries) {
+  token_id_cache_max_num_entries_ = token_id_cache_max_num_entries;
+}
+
+size_t EngineSettings::GetEmbeddingCacheMaxSizeBytes() const {
+  return embedding_cache_max_size_bytes_;
+}
+
+void EngineSettings::SetEmbeddingCacheMaxSizeBytes(
+    size_t embedding_cache_max_size_bytes) {
+  embedding_cache_max_size_bytes_ = embedding_cache_max_size_bytes;
+}
+
+size_t EngineSettings::GetMaxResidentMemoryBytes() const {
+  return max_resident_memory_bytes_;
+}
+
+void EngineSettings::SetMaxResidentMemoryBytes(
+    size_t max_resident_memory_bytes) {
+  max_resident_memory_bytes_ = max_resident_memory_bytes;
+}
+
+int EngineSettings::GetNumWarmUpDecodeSteps() const {
+  return num_warm_up_decode_steps_;
+}
+
+void EngineSettings::SetNumWarmUpDecodeSteps(int num_warm_up_decode_steps) {
+  num_warm_up_decode_steps_ = num_warm_up_decode_steps;
+}
+
+const std::optional<MappingOptions>& EngineSettings::GetMappingOptions() const {
+  return mapping_options_;
+}
+
+void EngineSettings::SetMappingOptions(const MappingOptions& mapping_options) {
+  mapping_options_ = mapping_options;
+}
+
+const std::optional<ModelVerificationMode>&
+EngineSettings::GetModelVerificationMode() const {
+  return model_verification_mode_;
+}
+
+void EngineSettings::SetModelVerificationMode(
+    ModelVerificationMode model_verification_mode) {
+  model_verification_mode_ = model_verification_mode;
+}
+
+bool EngineSettings::GetParallelExecutorInitialization() const {
+  return parallel_executor_initialization_;
+}
+
+void EngineSettings::SetParallelExecutorInitialization(
+    bool parallel_executor_initialization) {
+  parallel_executor_initialization_ = parallel_executor_initialization;
+}
+
+bool EngineSettings::GetLazyMultimodalExecutors() const {
+  return lazy_multimodal_executors_;
+}
+
+void EngineSettings::SetLazyMultimodalExecutors(
+    bool lazy_multimodal_executors) {
+  lazy_multimodal_executors_ = lazy_multimodal_executors;
+}
+
+absl::Duration EngineSettings::GetMultimodalExecutorIdleTimeout() const {
+  return multimodal_executor_idle_timeout_;
+}
+
+void EngineSettings::SetMultimodalExecutorIdleTimeout(
+    absl::Duration idle_timeout) {
+  multimodal_executor_idle_timeout_ = idle_timeout;
+}
+
+const std::string& EngineSettings::GetCacheDir() const { return cache_dir_; }
+
+void EngineSettings::SetCacheDir(std::string cache_dir) {
+  cache_dir_ = std::move(cache_dir);
+}
+
+const std::string& EngineSettings::GetSharedMemoryCacheName() const {
+  return shared_memory_cache_name_;
+}
+
+void EngineSettings::SetSharedMemoryCacheName(std::string name) {
+  shared_memory_cache_name_ = std::move(name);
+}
+
+size_t EngineSettings::GetLoraAdaptersMaxSizeBytes() const {
+  return lora_adapters_max_size_bytes_;
+}
+
+void EngineSettings::SetLoraAdaptersMaxSizeBytes(
+    size_t lora_adapters_max_size_bytes) {
+  lora_adapters_max_size_bytes_ = lora_adapters_max_size_bytes;
+}
+
+int EngineSettings::GetPrefillChunkSize() const { return prefill_chunk_size_; }
+
+void EngineSettings::SetPrefillChunkSize(int prefill_chunk_size) {
+  prefill_chunk_size_ = prefill_chunk_size;
+}
+
+KvCacheDataType EngineSettings::GetKvCacheDataType() const {
+  return kv_cache_data_type_;
+}
+
+void EngineSettings::SetKvCacheDataType(KvCacheDataType kv_cache_data_type) {
+  kv_cache_data_type_ = kv_cache_data_type;
+}
+
+EngineRole EngineSettings::GetEngineRole() const { return engine_role_; }
+
+void EngineSettings::SetEngineRole(EngineRole engine_role) {
+  engine_role_ = engine_role;
+}
+
+const std::vector<int>& EngineSettings::GetCpuAffinity() const {
+  return cpu_affinity_;
+}
+
+void EngineSettings::SetCpuAffinity(std::vector<int> cpu_affinity) {
+  cpu_affinity_ = std::move(cpu_affinity);
+}
+
+int EngineSettings::GetNumaNode() const { return numa_node_; }
+
+void EngineSettings::SetNumaNode(int numa_node) { numa_node_ = numa_node; }
+
 // Benchmark parameters:
 // Returns true if the benchmark is enabled.
 bool EngineSettings::IsBenchmarkEnabled() const {
@@ -260,9 +407,101 @@ const std::optional<proto::LlmMetadata>& EngineSettings::GetLlmMetadata()
   return metadata_;
 }
 
+std::ostream& operator<<(std::ostream& os, KvCacheDataType data_type) {
+  switch (data_type) {
+    case KvCacheDataType::kFloat:
+      os << "Float";
+      break;
+    case KvCacheDataType::kInt8:
+      os << "Int8";
+      break;
+    case KvCacheDataType::kFp8:
+      os << "Fp8";
+      break;
+  }
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os, EngineRole engine_role) {
+  switch (engine_role) {
+    case EngineRole::kPrefillAndDecode:
+      os << "PrefillAndDecode";
+      break;
+    case EngineRole::kPrefill:
+      os << "Prefill";
+      break;
+    case EngineRole::kDecode:
+      os << "Decode";
+      break;
+  }
+  return os;
+}
+
 std::ostream& operator<<(std::ostream& os, const EngineSettings& settings) {
   os << "EngineSettings: " << std::endl;
   os << "  MainExecutorSettings: " << settings.GetMainExecutorSettings();
+  if (settings.GetDraftExecutorSettings().has_value()) {
+    os << "  DraftExecutorSettings: "
+       << settings.GetDraftExecutorSettings().value();
+  }
+  os << "  PrefillChunkSize: " << settings.GetPrefillChunkSize() << std::endl;
+  if (settings.GetKvCacheDataType() != KvCacheDataType::kFloat) {
+    os << "  KvCacheDataType: " << settings.GetKvCacheDataType() << std::endl;
+  }
+  if (settings.GetEngineRole() != EngineRole::kPrefillAndDecode) {
+    os << "  EngineRole: " << settings.GetEngineRole() << std::endl;
+  }
+  if (!settings.GetCpuAffinity().empty()) {
+    os << "  CpuAffinity: " << absl::StrJoin(settings.GetCpuAffinity(), ",")
+       << std::endl;
+  }
+  if (settings.GetNumaNode() >= 0) {
+    os << "  NumaNode: " << settings.GetNumaNode() << std::endl;
+  }
+  if (settings.GetPrefixCacheMaxSizeBytes() > 0) {
+    os << "  PrefixCacheMaxSizeBytes: " << settings.GetPrefixCacheMaxSizeBytes()
+       << std::endl;
+  }
+  os << "  TokenIdCacheMaxNumEntries: "
+     << settings.GetTokenIdCacheMaxNumEntries() << std::endl;
+  if (settings.GetEmbeddingCacheMaxSizeBytes() > 0) {
+    os << "  EmbeddingCacheMaxSizeBytes: "
+       << settings.GetEmbeddingCacheMaxSizeBytes() << std::endl;
+  }
+  if (settings.GetMaxResidentMemoryBytes() > 0) {
+    os << "  MaxResidentMemoryBytes: " << settings.GetMaxResidentMemoryBytes()
+       << std::endl;
+  }
+  if (settings.GetNumWarmUpDecodeSteps() > 0) {
+    os << "  NumWarmUpDecodeSteps: " << settings.GetNumWarmUpDecodeSteps()
+       << std::endl;
+  }
+  if (settings.GetMappingOptions().has_value()) {
+    os << "  MappingOptions: " << settings.GetMappingOptions().value()
+       << std::endl;
+  }
+  if (settings.GetModelVerificationMode().has_value()) {
+    os << "  ModelVerificationMode: "
+       << settings.GetModelVerificationMode().value() << std::endl;
+  }
+  if (settings.GetParallelExecutorInitialization()) {
+    os << "  ParallelExecutorInitialization: true" << std::endl;
+  }
+  if (settings.GetLazyMultimodalExecutors()) {
+    os << "  LazyMultimodalExecutors: true, idle timeout: "
+       << settings.GetMultimodalExecutorIdleTimeout() << std::endl;
+  }
+  if (!settings.GetCacheDir().empty()) {
+    os << "  CacheDir: " << settings.GetCacheDir() << std::endl;
+  }
+  if (!settings.GetSharedMemoryCacheName().empty()) {
+    os << "  SharedMemoryCacheName: " << settings.GetSharedMemoryCacheName()
+       << std::endl;
+  }
+  if (settings.GetLoraAdaptersMaxSizeBytes() > 0) {
+    os << "  LoraAdaptersMaxSizeBytes: "
+       << settings.GetLoraAdaptersMaxSizeBytes() << std::endl;
+  }
   if (settings.GetLlmMetadata().has_value()) {
     os << "  LlmMetadata: " << settings.GetLlmMetadata().value().DebugString();
   } else {
@@ -295,53 +534,78 @@ SessionConfig SessionConfig::CreateDefault() {
   return config;
 }
 
+std::shared_ptr<const SessionConfigDefaults> SessionConfigDefaults::Create(
+    const EngineSettings& engine_settings) {
+  auto defaults = std::make_shared<SessionConfigDefaults>();
+  defaults->sampler_backend =
+      engine_settings.GetMainExecutorSettings().GetBackend() == Backend::GPU
+          ? Backend::GPU
+          : Backend::CPU;
+  defaults->max_num_tokens =
+      engine_settings.GetMainExecutorSettings().GetMaxNumTokens();
+  if (!engine_settings.GetLlmMetadata().has_value()) {
+    return defaults;
+  }
+  const proto::LlmMetadata& llm_metadata = *engine_settings.GetLlmMetadata();
+  defaults->has_llm_metadata = true;
+  if (llm_metadata.has_sampler_params()) {
+    defaults->sampler_params = llm_metadata.sampler_params();
+  }
+  if (llm_metadata.has_start_token() &&
+      llm_metadata.start_token().token_ids().ids_size() > 0) {
+    if (llm_metadata.start_token().token_ids().ids_size() > 1) {
+      ABSL_LOG(WARNING) << "The start token has more than one token ids: ";
+    }
+    defaults->start_token_id = llm_metadata.start_token().token_ids().ids(0);
+  }
+  for (const auto& stop_token : llm_metadata.stop_tokens()) {
+    if (stop_token.has_token_ids() && stop_token.token_ids().ids_size() > 0) {
+      defaults->stop_token_ids.emplace_back(
+          stop_token.token_ids().ids().begin(),
+          stop_token.token_ids().ids().end());
+    }
+  }
+  if (llm_metadata.has_prompt_templates()) {
+    defaults->prompt_templates = llm_metadata.prompt_templates();
+  }
+  defaults->llm_model_type = llm_metadata.llm_model_type();
+  defaults->jinja_prompt_template = llm_metadata.jinja_prompt_template();
+  return defaults;
+}
+
 absl::Status SessionConfig::MaybeUpdateAndValidate(
     const EngineSettings& engine_settings) {
-  ABSL_LOG(INFO)
-      << "The GetLlmMetadata: "
-      << (engine_settings.GetLlmMetadata().has_value()
-              ? engine_settings.GetLlmMetadata().value().DebugString()
-              : "Not set");
-  if ((stop_token_ids_.empty()) &&
-      !engine_settings.GetLlmMetadata().has_value()) {
+  return MaybeUpdateAndValidate(*SessionConfigDefaults::Create(engine_settings));
+}
+
+absl::Status SessionConfig::MaybeUpdateAndValidate(
+    const SessionConfigDefaults& defaults) {
+  if ((stop_token_ids_.empty()) && !defaults.has_llm_metadata) {
     return absl::InvalidArgumentError(
         "Required: set stop tokens, or provide LlmMetadata.");
   }
 
   // Update the parameters from the engine settings when the LlmMetadata is
   // present.
-  if (engine_settings.GetLlmMetadata().has_value()) {
-    const auto llm_metadata = engine_settings.GetLlmMetadata().value();
+  if (defaults.has_llm_metadata) {
     proto::SamplerParameters& sampler_params = GetMutableSamplerParams();
     // Update the sampler params if the session config does not have a sampler
     // params and the engine settings has a sampler params (probably read from
     // the model file).
     if ((sampler_params.type() == proto::SamplerParameters::TYPE_UNSPECIFIED)) {
-      if (llm_metadata.has_sampler_params()) {
-        sampler_params = engine_settings.GetLlmMetadata()->sampler_params();
+      if (defaults.sampler_params.has_value()) {
+        sampler_params = *defaults.sampler_params;
       }
     }
 
     // Set and validate the start token.
     if (start_token_id_ == -1) {
-      if (llm_metadata.has_start_token()) {
-        if (llm_metadata.start_token().token_ids().ids_size() > 1) {
-          ABSL_LOG(WARNING) << "The start token has more than one token ids: ";
-        }
-        start_token_id_ = llm_metadata.start_token().token_ids().ids(0);
-      }
+      start_token_id_ = defaults.start_token_id;
     }
 
     // Set and validate the stop tokens.
     if (stop_token_ids_.empty()) {
-      for (const auto& stop_token : llm_metadata.stop_tokens()) {
-        if (stop_token.has_token_ids() &&
-            stop_token.token_ids().ids_size() > 0) {
-          std::vector<int> stop_token_ids(stop_token.token_ids().ids().begin(),
-                                          stop_token.token_ids().ids().end());
-          stop_token_ids_.push_back(stop_token_ids);
-        }
-      }
+      stop_token_ids_ = defaults.stop_token_ids;
     }
 
     // Set the prompt template from LlmMetadata, if not provided in
@@ -352,16 +616,16 @@ absl::Status SessionConfig::MaybeUpdateAndValidate(
     //
     // TODO(b/439648399): Remove this logic when LiteRT-LM no longer use
     // template in Session level.
-    if (!prompt_templates_.has_user() && llm_metadata.has_prompt_templates()) {
-      prompt_templates_ = llm_metadata.prompt_templates();
+    if (!prompt_templates_.has_user() && defaults.prompt_templates.has_value()) {
+      prompt_templates_ = *defaults.prompt_templates;
     }
 
     if (llm_model_type_.model_type_case() ==
         proto::LlmModelType::MODEL_TYPE_NOT_SET) {
-      llm_model_type_ = llm_metadata.llm_model_type();
+      llm_model_type_ = defaults.llm_model_type;
     }
     if (jinja_prompt_template_.empty()) {
-      jinja_prompt_template_ = llm_metadata.jinja_prompt_template();
+      jinja_prompt_template_ = defaults.jinja_prompt_template;
     }
   }
 
@@ -377,14 +641,49 @@ absl::Status SessionConfig::MaybeUpdateAndValidate(
         "Number of output candidates need to be at least 1, but got: ",
         num_output_candidates_));
   }
+  if (num_draft_tokens_ < 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Number of draft tokens must not be negative, but got: ",
+        num_draft_tokens_));
+  }
+  if (max_num_tokens_ < 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Maximum number of tokens must not be negative, but got: ",
+        max_num_tokens_));
+  }
+  if (defaults.max_num_tokens > 0) {
+    if (max_num_tokens_ == 0) {
+      max_num_tokens_ = defaults.max_num_tokens;
+    } else if (max_num_tokens_ > defaults.max_num_tokens) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Maximum number of tokens must not exceed the maximum of the "
+          "engine, ",
+          defaults.max_num_tokens, ", but got: ", max_num_tokens_));
+    }
+  }
+  if (num_context_sink_tokens_ < 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Number of context sink tokens must not be negative, but got: ",
+        num_context_sink_tokens_));
+  }
+  if (num_context_eviction_tokens_ < 1) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Number of context eviction tokens need to be at least 1, but got: ",
+        num_context_eviction_tokens_));
+  }
+  if (callback_queue_capacity_ < 1) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Callback queue capacity need to be at least 1, but got: ",
+        callback_queue_capacity_));
+  }
+  if (request_timeout_ <= absl::ZeroDuration()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Request timeout must be positive, but got: ",
+                     absl::FormatDuration(request_timeout_)));
+  }
 
   if (sampler_backend_ == Backend::UNSPECIFIED) {
-    if (engine_settings.GetMainExecutorSettings().GetBackend() ==
-        Backend::GPU) {
-      sampler_backend_ = Backend::GPU;
-    } else {
-      sampler_backend_ = Backend::CPU;
-    }
+    sampler_backend_ = defaults.sampler_backend;
   }
 
   ABSL_LOG(INFO) << "The validated session config: " << *this;
@@ -394,6 +693,33 @@ absl::Status SessionConfig::MaybeUpdateAndValidate(
 SessionConfig::SessionConfig(const proto::SamplerParameters& sampler_params)
     : sampler_params_(sampler_params) {}
 
+std::ostream& operator<<(std::ostream& os, ContextOverflowPolicy policy) {
+  switch (policy) {
+    case ContextOverflowPolicy::kStop:
+      os << "Stop";
+      break;
+    case ContextOverflowPolicy::kSlidingWindow:
+      os << "SlidingWindow";
+      break;
+  }
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os, CallbackBackpressurePolicy policy) {
+  switch (policy) {
+    case CallbackBackpressurePolicy::kBlock:
+      os << "Block";
+      break;
+    case CallbackBackpressurePolicy::kCoalesce:
+      os << "Coalesce";
+      break;
+    case CallbackBackpressurePolicy::kCancel:
+      os << "Cancel";
+      break;
+  }
+  return os;
+}
+
 const proto::SamplerParameters& SessionConfig::GetSamplerParams() const {
   return sampler_params_;
 }
@@ -410,6 +736,14 @@ std::vector<std::vector<int>>& SessionConfig::GetMutableStopTokenIds() {
   return stop_token_ids_;
 }
 
+const std::vector<std::string>& SessionConfig::GetStopStrings() const {
+  return stop_strings_;
+}
+
+std::vector<std::string>& SessionConfig::GetMutableStopStrings() {
+  return stop_strings_;
+}
+
 int SessionConfig::GetStartTokenId() const { return start_token_id_; }
 
 void SessionConfig::SetStartTokenId(int start_token_id) {
@@ -453,13 +787,46 @@ std::ostream& operator<<(std::ostream& os, const SessionConfig& config) {
   os << "  SamplerParams: " << config.GetSamplerParams().DebugString()
      << std::endl;
   os << "  SamplerBackend: " << config.GetSamplerBackend() << std::endl;
+  os << "  AutoSelectSamplerBackend: " << config.GetAutoSelectSamplerBackend()
+     << std::endl;
   os << "  StartTokenId: " << config.GetStartTokenId() << std::endl;
   os << "  StopTokenIds: " << std::endl;
   for (const auto& stop_token_ids : config.GetStopTokenIds()) {
     os << "    " << stop_token_ids << std::endl;
   }
+  os << "  StopStrings: " << std::endl;
+  for (const auto& stop_string : config.GetStopStrings()) {
+    os << "    \"" << stop_string << "\"" << std::endl;
+  }
   os << "  NumOutputCandidates: " << config.GetNumOutputCandidates()
      << std::endl;
+  os << "  NumDraftTokens: " << config.GetNumDraftTokens() << std::endl;
+  os << "  MaxNumTokens: " << config.GetMaxNumTokens() << std::endl;
+  os << "  ContextOverflowPolicy: " << config.GetContextOverflowPolicy()
+     << std::endl;
+  os << "  NumContextSinkTokens: " << config.GetNumContextSinkTokens()
+     << std::endl;
+  os << "  NumContextEvictionTokens: " << config.GetNumContextEvictionTokens()
+     << std::endl;
+  os << "  PipelinedCallbacks: " << config.GetPipelinedCallbacks()
+     << std::endl;
+  os << "  CallbackQueueCapacity: " << config.GetCallbackQueueCapacity()
+     << std::endl;
+  os << "  CallbackBackpressurePolicy: "
+     << config.GetCallbackBackpressurePolicy() << std::endl;
+  os << "  UseBeamSearch: " << config.GetUseBeamSearch() << std::endl;
+  if (!config.GetLoraAdapterId().empty()) {
+    os << "  LoraAdapterId: " << config.GetLoraAdapterId() << std::endl;
+  }
+  os << "  Priority: " << config.GetPriority() << std::endl;
+  os << "  RequestTimeout: " << config.GetRequestTimeout() << std::endl;
+  if (config.GetBenchmarkParams().has_value()) {
+    os << "  BenchmarkParams: "
+       << config.GetBenchmarkParams().value().DebugString();
+  }
+  if (!config.GetDecodeReplayPath().empty()) {
+    os << "  DecodeReplayPath: " << config.GetDecodeReplayPath() << std::endl;
+  }
   os << "  LlmModelType: " << config.GetLlmModelType().DebugString()
      << std::endl;
   os << "  JinjaPromptTemplate: " << config.GetJinjaPromptTemplate()
@@ -476,4 +843,106 @@ void SessionConfig::SetSamplerBackend(Backend sampler_backend) {
   sampler_backend_ = sampler_backend;
 }
 
+bool SessionConfig::GetAutoSelectSamplerBackend() const {
+  return auto_select_sampler_backend_;
+}
+void SessionConfig::SetAutoSelectSamplerBackend(
+    bool auto_select_sampler_backend) {
+  auto_select_sampler_backend_ = auto_select_sampler_backend;
+}
+
+int SessionConfig::GetNumDraftTokens() const { return num_draft_tokens_; }
+void SessionConfig::SetNumDraftTokens(int num_draft_tokens) {
+  num_draft_tokens_ = num_draft_tokens;
+}
+
+int SessionConfig::GetMaxNumTokens() const { return max_num_tokens_; }
+void SessionConfig::SetMaxNumTokens(int max_num_tokens) {
+  max_num_tokens_ = max_num_tokens;
+}
+
+ContextOverflowPolicy SessionConfig::GetContextOverflowPolicy() const {
+  return context_overflow_policy_;
+}
+void SessionConfig::SetContextOverflowPolicy(
+    ContextOverflowPolicy context_overflow_policy) {
+  context_overflow_policy_ = context_overflow_policy;
+}
+
+int SessionConfig::GetNumContextSinkTokens() const {
+  return num_context_sink_tokens_;
+}
+void SessionConfig::SetNumContextSinkTokens(int num_context_sink_tokens) {
+  num_context_sink_tokens_ = num_context_sink_tokens;
+}
+
+int SessionConfig::GetNumContextEvictionTokens() const {
+  return num_context_eviction_tokens_;
+}
+void SessionConfig::SetNumContextEvictionTokens(
+    int num_context_eviction_tokens) {
+  num_context_eviction_tokens_ = num_context_eviction_tokens;
+}
+
+bool SessionConfig::GetPipelinedCallbacks() const {
+  return pipelined_callbacks_;
+}
+void SessionConfig::SetPipelinedCallbacks(bool pipelined_callbacks) {
+  pipelined_callbacks_ = pipelined_callbacks;
+}
+
+int SessionConfig::GetCallbackQueueCapacity() const {
+  return callback_queue_capacity_;
+}
+void SessionConfig::SetCallbackQueueCapacity(int callback_queue_capacity) {
+  callback_queue_capacity_ = callback_queue_capacity;
+}
+
+CallbackBackpressurePolicy SessionConfig::GetCallbackBackpressurePolicy()
+    const {
+  return callback_backpressure_policy_;
+}
+void SessionConfig::SetCallbackBackpressurePolicy(
+    CallbackBackpressurePolicy callback_backpressure_policy) {
+  callback_backpressure_policy_ = callback_backpressure_policy;
+}
+
+bool SessionConfig::GetUseBeamSearch() const { return use_beam_search_; }
+void SessionConfig::SetUseBeamSearch(bool use_beam_search) {
+  use_beam_search_ = use_beam_search;
+}
+
+const std::string& SessionConfig::GetLoraAdapterId() const {
+  return lora_adapter_id_;
+}
+void SessionConfig::SetLoraAdapterId(std::string lora_adapter_id) {
+  lora_adapter_id_ = std::move(lora_adapter_id);
+}
+
+int SessionConfig::GetPriority() const { return priority_; }
+void SessionConfig::SetPriority(int priority) { priority_ = priority; }
+
+absl::Duration SessionConfig::GetRequestTimeout() const {
+  return request_timeout_;
+}
+void SessionConfig::SetRequestTimeout(absl::Duration request_timeout) {
+  request_timeout_ = request_timeout;
+}
+
+const std::optional<proto::BenchmarkParams>& SessionConfig::GetBenchmarkParams()
+    const {
+  return benchmark_params_;
+}
+void SessionConfig::SetBenchmarkParams(
+    const proto::BenchmarkParams& benchmark_params) {
+  benchmark_params_ = benchmark_params;
+}
+
+const std::string& SessionConfig::GetDecodeReplayPath() const {
+  return decode_replay_path_;
+}
+void SessionConfig::SetDecodeReplayPath(std::string decode_replay_path) {
+  decode_replay_path_ = std::move(decode_replay_path);
+}
+
 }  // namespace litert::lm
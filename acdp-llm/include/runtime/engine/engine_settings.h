@@ -15,6 +15,8 @@
 #ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_ENGINE_SETTINGS_H_
 #define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_ENGINE_SETTINGS_H_
 
+#include <cstddef>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <string>
@@ -24,6 +26,7 @@
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
 #include "runtime/components/tokenizer.h"
 #include "runtime/executor/audio_executor_settings.h"
 #include "runtime/executor/executor_settings_base.h"
@@ -32,6 +35,8 @@
 #include "runtime/proto/llm_metadata.pb.h"
 #include "runtime/proto/llm_model_type.pb.h"
 #include "runtime/proto/sampler_params.pb.h"
+#include "runtime/util/memory_mapped_file.h"
+#include "runtime/util/model_verification.h"
 
 namespace litert::lm {
 
@@ -47,6 +52,32 @@ namespace litert::lm {
 // if the field is not set. But the non-mutable getter should return a
 // const reference to the std::optional<T> field.
 
+// The type the kv-cache of the main executor is stored as. The quantized
+// types store the keys and values with a scale per head and token, and halve
+// the memory of a context compared to 16-bit floats, at a small accuracy cost.
+enum class KvCacheDataType {
+  // The activation type of the executor.
+  kFloat,
+  kInt8,
+  // 8-bit floats with a 4-bit exponent and a 3-bit mantissa (E4M3).
+  kFp8,
+};
+std::ostream& operator<<(std::ostream& os, KvCacheDataType data_type);
+
+// The phases of the requests an engine serves. With disaggregated serving,
+// the prompts are prefilled on the compute-bound hardware of prefill engines,
+// and their sessions continue on the memory-bound hardware of decode engines
+// from the checkpoints the prefill engines serialize, see
+// Engine::Session::SerializeCheckpoint().
+enum class EngineRole {
+  kPrefillAndDecode,
+  // The sessions prefill only, and reject the decodes.
+  kPrefill,
+  // The sessions mostly decode, so the engine keeps no prefix cache.
+  kDecode,
+};
+std::ostream& operator<<(std::ostream& os, EngineRole engine_role);
+
 // Settings used for initializing LiteRT LM Engine.
 // This class encapsulates the model-specific settings that are used for
 // initializing the LiteRT LM. These settings are typically fixed for a given
@@ -99,6 +130,149 @@ class EngineSettings {
   // Returns the mutable AudioExecutorSettings for the audio model.
   std::optional<AudioExecutorSettings>& GetMutableAudioExecutorSettings();
 
+  // Returns the LlmExecutorSettings for the draft model used for speculative
+  // decoding.
+  const std::optional<LlmExecutorSettings>& GetDraftExecutorSettings() const;
+  // Returns the mutable LlmExecutorSettings for the draft model. Setting it
+  // enables speculative decoding for the sessions that support it.
+  std::optional<LlmExecutorSettings>& GetMutableDraftExecutorSettings();
+
+  // Prefix cache parameters:
+  // The memory budget of the engine-wide cache of kv-cache snapshots, which
+  // lets new sessions skip the prefill of a prompt prefix already prefilled by
+  // an earlier session, e.g. a shared system instruction. 0 (the default)
+  // disables the cache. Only used if the executor supports kv-cache
+  // snapshots.
+  size_t GetPrefixCacheMaxSizeBytes() const;
+  void SetPrefixCacheMaxSizeBytes(size_t prefix_cache_max_size_bytes);
+
+  // Token id cache parameters:
+  // The maximum number of texts in the engine-wide cache of token ids, which
+  // spares the sessions the tokenization of the repeated prompt templates
+  // and instructions. 0 disables the cache.
+  int GetTokenIdCacheMaxNumEntries() const;
+  void SetTokenIdCacheMaxNumEntries(int token_id_cache_max_num_entries);
+
+  // Embedding cache parameters:
+  // The memory budget of the engine-wide cache of the vision and audio
+  // embeddings, keyed by the content of the preprocessed inputs, so that an
+  // image or audio sent again is not encoded again. 0 disables the cache.
+  size_t GetEmbeddingCacheMaxSizeBytes() const;
+  void SetEmbeddingCacheMaxSizeBytes(size_t embedding_cache_max_size_bytes);
+
+  // Memory governor parameters:
+  // The resident memory of the process above which the engine sheds its
+  // caches and idle executors, e.g. to stay clear of the low memory killer of
+  // a mobile device. 0 (the default) for no limit, in which case the engine
+  // only sheds them on Engine::NotifyMemoryPressure().
+  size_t GetMaxResidentMemoryBytes() const;
+  void SetMaxResidentMemoryBytes(size_t max_resident_memory_bytes);
+
+  // Warm-up parameters:
+  // The number of decode steps of the throwaway run of the main executor at
+  // the engine creation, after a prefill of the prompt hint, so that the
+  // first request does not pay for the lazy initializations of the executor
+  // (delegates, sampler, kernel compilations, first touch of the weights).
+  // The executor is reset afterwards. 0 (the default) disables the warm-up.
+  int GetNumWarmUpDecodeSteps() const;
+  void SetNumWarmUpDecodeSteps(int num_warm_up_decode_steps);
+
+  // Model mapping parameters:
+  // The policies of mapping the model files when the engine is created, e.g.
+  // the prefetch of the weights, huge pages or locking them in memory. Not set
+  // (the default) keeps the process-wide default, which the options replace
+  // for the files mapped from then on, as the mapped files are shared.
+  const std::optional<MappingOptions>& GetMappingOptions() const;
+  void SetMappingOptions(const MappingOptions& mapping_options);
+  // How the sections of the model file are verified when mapped: eagerly,
+  // in a low priority background thread off the engine creation, or only by
+  // the checksums stored in the file. Not set (the default) keeps the
+  // process-wide default of the loaders, kSkipWithChecksum.
+  const std::optional<ModelVerificationMode>& GetModelVerificationMode() const;
+  void SetModelVerificationMode(ModelVerificationMode model_verification_mode);
+
+  // Startup parameters:
+  // Whether the main, vision, audio and draft executors are created
+  // concurrently when the engine is created, each compiling its own model.
+  // Disabled by default, as not all the accelerators compile concurrently.
+  bool GetParallelExecutorInitialization() const;
+  void SetParallelExecutorInitialization(bool parallel_executor_initialization);
+
+  // Lazy multimodal executor parameters:
+  // Whether the vision and audio executors are created on the first image or
+  // audio input rather than with the engine, which spares an engine mostly
+  // serving text their startup time and memory.
+  bool GetLazyMultimodalExecutors() const;
+  void SetLazyMultimodalExecutors(bool lazy_multimodal_executors);
+  // With lazy multimodal executors, the time after which an unused executor
+  // is destroyed, to be created again on the next input. Infinite (the
+  // default) keeps the executors once created.
+  absl::Duration GetMultimodalExecutorIdleTimeout() const;
+  void SetMultimodalExecutorIdleTimeout(absl::Duration idle_timeout);
+
+  // Model cache parameters:
+  // The directory of the artifacts compiled from the models, e.g. the GPU
+  // kernels or the NPU programs, reused by the next engines loading the same
+  // model. Each executor caches in <cache_dir>/<model fingerprint>/<backend>-
+  // <architecture>, where the fingerprint is derived from the model contents,
+  // so that a model file moved or updated in place never reuses the stale
+  // artifacts. Only used by the executors without their own cache directory.
+  // The manifest of the model, its file format and metadata, is kept in
+  // <cache_dir>/<model fingerprint> for all the backends, see ModelManifest.
+  // Empty (the default) keeps the per-executor cache directories.
+  const std::string& GetCacheDir() const;
+  void SetCacheDir(std::string cache_dir);
+
+  // The name of a cache directory in the shared memory of the host, see
+  // GetSharedMemoryCacheDir(), used when the cache directory is empty. The
+  // engines of the processes using the same name share the artifacts
+  // compiled and the weights repacked by the first of them, both on disk and
+  // in memory. Empty (the default) uses no shared memory cache.
+  const std::string& GetSharedMemoryCacheName() const;
+  void SetSharedMemoryCacheName(std::string name);
+
+  // LoRA adapter parameters:
+  // The memory budget of the LoRA adapters kept loaded in the main executor
+  // while no session uses them, the least recently used ones being unloaded
+  // first. 0 (the default) keeps all the adapters loaded once used.
+  size_t GetLoraAdaptersMaxSizeBytes() const;
+  void SetLoraAdaptersMaxSizeBytes(size_t lora_adapters_max_size_bytes);
+
+  // Chunked prefill parameters:
+  // The maximum number of tokens of a prompt prefilled at once when the
+  // engine batches the decode steps of concurrent sessions. The decode steps
+  // of the other sessions run between the chunks of a long prompt, which
+  // bounds their inter-token latency. 0 disables the chunking.
+  int GetPrefillChunkSize() const;
+  void SetPrefillChunkSize(int prefill_chunk_size);
+
+  // KV-cache parameters:
+  // The type the kv-cache of the main executor is stored as, e.g. int8 to fit
+  // more concurrent long sessions on the device. kFloat (the default) keeps
+  // the activation type. The quantized types require an executor
+  // implementing QuantizedKvCacheLlmExecutor.
+  KvCacheDataType GetKvCacheDataType() const;
+  void SetKvCacheDataType(KvCacheDataType kv_cache_data_type);
+
+  // Disaggregated serving parameters:
+  // The phases of the requests the engine serves. kPrefillAndDecode (the
+  // default) serves both.
+  EngineRole GetEngineRole() const;
+  void SetEngineRole(EngineRole engine_role);
+
+  // Thread placement parameters:
+  // The cpus the engine worker threads and the threads of the executors run
+  // on, e.g. the cores of one socket of a multi-socket host. Empty (the
+  // default) for the cpus of the NUMA node if set, any cpu otherwise. Only
+  // supported on Linux.
+  const std::vector<int>& GetCpuAffinity() const;
+  void SetCpuAffinity(std::vector<int> cpu_affinity);
+  // The NUMA node the engine threads allocate their memory from, the model
+  // weights included, so that the inference does not cross the sockets. -1
+  // (the default) keeps the memory policy of the process.
+  int GetNumaNode() const;
+  void SetNumaNode(int numa_node);
+
   // Benchmark parameters:
   // Returns true if the benchmark is enabled.
   bool IsBenchmarkEnabled() const;
@@ -130,6 +304,59 @@ class EngineSettings {
   // Settings for the audio executor.
   std::optional<AudioExecutorSettings> audio_executor_settings_;
 
+  // Settings for the draft executor used for speculative decoding. The draft
+  // model must share the vocabulary of the main model.
+  std::optional<LlmExecutorSettings> draft_executor_settings_;
+
+  // The memory budget of the prefix cache. 0 disables it.
+  size_t prefix_cache_max_size_bytes_ = 0;
+  int token_id_cache_max_num_entries_ = 256;
+
+  // The memory budget of the embedding cache. 0 disables it.
+  size_t embedding_cache_max_size_bytes_ = 0;
+
+  // The resident memory above which the engine sheds its caches. 0 for no
+  // limit.
+  size_t max_resident_memory_bytes_ = 0;
+
+  // The number of decode steps of the warm-up. 0 disables it.
+  int num_warm_up_decode_steps_ = 0;
+
+  // The policies of mapping the model files. Not set keeps the default.
+  std::optional<MappingOptions> mapping_options_;
+  // The verification of the model sections. Not set keeps the default.
+  std::optional<ModelVerificationMode> model_verification_mode_;
+
+  // Whether the executors are created concurrently.
+  bool parallel_executor_initialization_ = false;
+
+  // Whether the vision and audio executors are created on first use, and
+  // destroyed after being unused for the idle timeout.
+  bool lazy_multimodal_executors_ = false;
+  absl::Duration multimodal_executor_idle_timeout_ = absl::InfiniteDuration();
+
+  // The engine-wide cache directory, keyed by the model. Empty disables it.
+  std::string cache_dir_;
+  std::string shared_memory_cache_name_;
+
+  // The memory budget of the unused LoRA adapters. 0 for no limit.
+  size_t lora_adapters_max_size_bytes_ = 0;
+
+  // The maximum number of prompt tokens prefilled at once with continuous
+  // batching. 0 disables the chunking.
+  int prefill_chunk_size_ = 256;
+
+  // The type of the kv-cache of the main executor.
+  KvCacheDataType kv_cache_data_type_ = KvCacheDataType::kFloat;
+
+  // The phases of the requests the engine serves.
+  EngineRole engine_role_ = EngineRole::kPrefillAndDecode;
+
+  // The cpus and the NUMA node of the engine threads. Empty and -1 for no
+  // binding.
+  std::vector<int> cpu_affinity_;
+  int numa_node_ = -1;
+
   // Parameters used to configure the benchmarking process.
   std::optional<proto::BenchmarkParams> benchmark_params_;
 
@@ -139,6 +366,61 @@ class EngineSettings {
 };
 std::ostream& operator<<(std::ostream& os, const EngineSettings& settings);
 
+// What a session does when its context reaches the maximum number of tokens
+// of the executor.
+enum class ContextOverflowPolicy {
+  // Ends the generation with a "Maximum kv-cache size reached" error. The
+  // session must be recreated to continue.
+  kStop,
+  // Keeps the first tokens of the context (the attention sinks, e.g. the
+  // system instruction) and evicts the oldest tokens following them, so that
+  // prefill and decode continue over a sliding window of the most recent
+  // context. Requires an executor implementing ContextEvictionLlmExecutor.
+  kSlidingWindow,
+};
+std::ostream& operator<<(std::ostream& os, ContextOverflowPolicy policy);
+
+// What a session does when its pipelined streaming callback falls too many
+// responses behind the decode loop, e.g. when it writes to a slow network
+// client.
+enum class CallbackBackpressurePolicy {
+  // The decode loop waits for the callback.
+  kBlock,
+  // The decode loop goes on, and the texts of the next steps are merged into
+  // one response until the callback catches up. Each candidate keeps the
+  // score of its latest step.
+  kCoalesce,
+  // The generation is cancelled, and the stream ends with a
+  // ResourceExhausted error after the responses already queued.
+  kCancel,
+};
+std::ostream& operator<<(std::ostream& os, CallbackBackpressurePolicy policy);
+
+// The defaults of the SessionConfig fields, read from the LlmMetadata of
+// validated EngineSettings. The engine reads them once and shares them with
+// its sessions, so that creating a session does not copy the metadata again.
+struct SessionConfigDefaults {
+  // Reads the defaults from `engine_settings`, which must be validated.
+  static std::shared_ptr<const SessionConfigDefaults> Create(
+      const EngineSettings& engine_settings);
+
+  // Whether the engine settings have an LlmMetadata. When false, only the
+  // sampler backend is set.
+  bool has_llm_metadata = false;
+  std::optional<proto::SamplerParameters> sampler_params;
+  // -1 when the metadata has no start token.
+  int start_token_id = -1;
+  std::vector<std::vector<int>> stop_token_ids;
+  std::optional<proto::PromptTemplates> prompt_templates;
+  proto::LlmModelType llm_model_type;
+  std::string jinja_prompt_template;
+  // The sampler backend of the sessions not picking one.
+  Backend sampler_backend = Backend::CPU;
+  // The maximum number of tokens of the main executor, the bound and the
+  // default of the maximum number of tokens of the sessions.
+  int max_num_tokens = 0;
+};
+
 // Configurations used for the session.
 // This class encapsulates the session-specific configurations that are used for
 // creating a LiteRT LM session.
@@ -152,6 +434,9 @@ class SessionConfig {
   // correctly. Returns an error if the validation fails.
   absl::Status MaybeUpdateAndValidate(const EngineSettings& engine_settings);
 
+  // Same as above, with the defaults the engine read from its settings once.
+  absl::Status MaybeUpdateAndValidate(const SessionConfigDefaults& defaults);
+
   // Sampler parameters:
   // Getters for the sampler parameters.
   const proto::SamplerParameters& GetSamplerParams() const;
@@ -162,6 +447,13 @@ class SessionConfig {
   const std::vector<std::vector<int>>& GetStopTokenIds() const;
   std::vector<std::vector<int>>& GetMutableStopTokenIds();
 
+  // Stop strings:
+  // Getters for the stop strings. The decode stops when the output text
+  // contains one of them, even across token boundaries, and the stop string
+  // is not part of the output.
+  const std::vector<std::string>& GetStopStrings() const;
+  std::vector<std::string>& GetMutableStopStrings();
+
   // Set the start token ids.
   int GetStartTokenId() const;
   void SetStartTokenId(int start_token_id);
@@ -175,6 +467,98 @@ class SessionConfig {
   // Getters for the backend of the sampler.
   Backend GetSamplerBackend() const;
   void SetSamplerBackend(Backend sampler_backend);
+  // Getters for whether each decode picks, from their measured costs, the
+  // faster of sampling inside the executor with the sampler backend and
+  // sampling on the host with a CPU sampler. Ignored when the sampler backend
+  // is CPU.
+  bool GetAutoSelectSamplerBackend() const;
+  void SetAutoSelectSamplerBackend(bool auto_select_sampler_backend);
+
+  // Number of draft tokens:
+  // Getters for the number of tokens proposed by the draft model per
+  // speculative decoding step.
+  int GetNumDraftTokens() const;
+  void SetNumDraftTokens(int num_draft_tokens);
+
+  // Maximum number of tokens:
+  // Getters for the maximum number of tokens of the context of the session,
+  // at most the maximum number of tokens of the engine. 0, the default, is
+  // updated to the maximum of the engine. With a paged kv-cache, the context
+  // of the session takes kv-cache blocks as it grows, up to this bound, so
+  // that short sessions leave the pool to more concurrent ones; outgrowing it
+  // fails the request with a ResourceExhausted error, unless the context
+  // overflow policy slides the window within it.
+  int GetMaxNumTokens() const;
+  void SetMaxNumTokens(int max_num_tokens);
+
+  // Context overflow parameters:
+  // Getters for the policy applied when the context is full.
+  ContextOverflowPolicy GetContextOverflowPolicy() const;
+  void SetContextOverflowPolicy(ContextOverflowPolicy context_overflow_policy);
+  // Getters for the number of leading tokens never evicted by
+  // ContextOverflowPolicy::kSlidingWindow.
+  int GetNumContextSinkTokens() const;
+  void SetNumContextSinkTokens(int num_context_sink_tokens);
+  // Getters for the minimum number of tokens evicted at once by
+  // ContextOverflowPolicy::kSlidingWindow. Evicting more tokens than needed
+  // amortizes the cost of an eviction over many decode steps.
+  int GetNumContextEvictionTokens() const;
+  void SetNumContextEvictionTokens(int num_context_eviction_tokens);
+
+  // Pipelined callbacks:
+  // Getters for whether the streaming callbacks are invoked from a separate
+  // thread, so that the next decode step does not wait for them. The
+  // callbacks are still invoked one at a time and in order.
+  bool GetPipelinedCallbacks() const;
+  void SetPipelinedCallbacks(bool pipelined_callbacks);
+  // Getters for the maximum number of responses waiting for a pipelined
+  // callback, and the policy applied when it is reached.
+  int GetCallbackQueueCapacity() const;
+  void SetCallbackQueueCapacity(int callback_queue_capacity);
+  CallbackBackpressurePolicy GetCallbackBackpressurePolicy() const;
+  void SetCallbackBackpressurePolicy(
+      CallbackBackpressurePolicy callback_backpressure_policy);
+
+  // Beam search:
+  // Getters for whether the output candidates are the beams of a beam search
+  // instead of independent samples. The executor must support reordering its
+  // candidates, see BeamSearchLlmExecutor.
+  bool GetUseBeamSearch() const;
+  void SetUseBeamSearch(bool use_beam_search);
+
+  // LoRA adapter:
+  // Getters for the id of the LoRA adapter the session runs with, registered
+  // with Engine::RegisterLoraAdapter(). Empty (the default) runs the base
+  // model.
+  const std::string& GetLoraAdapterId() const;
+  void SetLoraAdapterId(std::string lora_adapter_id);
+
+  // Scheduling parameters:
+  // Getters for the priority of the requests of the session, the higher the
+  // sooner they run when the engine is busy. DecodeConfig can override it per
+  // decode request.
+  int GetPriority() const;
+  void SetPriority(int priority);
+  // Getters for the time a prefill or decode request of the session may wait
+  // to start, after which it is cancelled instead of running. Infinite (the
+  // default) for no limit.
+  absl::Duration GetRequestTimeout() const;
+  void SetRequestTimeout(absl::Duration request_timeout);
+
+  // Benchmark parameters:
+  // Getters for the numbers of prefill and decode tokens the session is
+  // benchmarked with, in place of the ones of the engine, so that a benchmark
+  // sweeps them without reloading the model. Ignored if the engine is not
+  // benchmarked. std::nullopt (the default) keeps the ones of the engine.
+  const std::optional<proto::BenchmarkParams>& GetBenchmarkParams() const;
+  void SetBenchmarkParams(const proto::BenchmarkParams& benchmark_params);
+
+  // Decode replay:
+  // Getters for the file the session records its workload to, rewritten
+  // after every turn, so that it can be replayed offline with
+  // ReplayDecodeRecording(). Empty (the default) records nothing.
+  const std::string& GetDecodeReplayPath() const;
+  void SetDecodeReplayPath(std::string decode_replay_path);
 
   // Prompt templates:
   // Getters for the prompt templates.
@@ -218,6 +602,9 @@ class SessionConfig {
   // dimension is the sequence of token ids that constitutes the stop token.
   std::vector<std::vector<int>> stop_token_ids_;
 
+  // Stop strings for the session, matched against the decoded text.
+  std::vector<std::string> stop_strings_;
+
   // Start token id for the session.
   int start_token_id_ = -1;
 
@@ -239,6 +626,48 @@ class SessionConfig {
   // Backend to use for sampling.
   Backend sampler_backend_ = Backend::UNSPECIFIED;
 
+  // Whether the decodes pick the sampler backend or the CPU sampler from their
+  // measured costs.
+  bool auto_select_sampler_backend_ = false;
+
+  // The number of tokens the draft model proposes per speculative decoding
+  // step. Only used when the engine has a draft model; setting it to 0
+  // disables speculative decoding for the session.
+  int num_draft_tokens_ = 4;
+
+  // The maximum number of tokens of the context of the session, 0 for the
+  // maximum of the engine.
+  int max_num_tokens_ = 0;
+
+  // The policy applied when the context reaches the maximum number of
+  // tokens, and the parameters of the sliding window.
+  ContextOverflowPolicy context_overflow_policy_ = ContextOverflowPolicy::kStop;
+  int num_context_sink_tokens_ = 4;
+  int num_context_eviction_tokens_ = 256;
+
+  // Whether the streaming callbacks are invoked from a separate thread, and
+  // how far they may fall behind.
+  bool pipelined_callbacks_ = false;
+  int callback_queue_capacity_ = 64;
+  CallbackBackpressurePolicy callback_backpressure_policy_ =
+      CallbackBackpressurePolicy::kBlock;
+
+  // Whether the output candidates are the beams of a beam search.
+  bool use_beam_search_ = false;
+
+  // The LoRA adapter of the session. Empty for the base model.
+  std::string lora_adapter_id_;
+
+  // The priority and the wait limit of the requests of the session.
+  int priority_ = 0;
+  absl::Duration request_timeout_ = absl::InfiniteDuration();
+
+  // The benchmark parameters overriding the ones of the engine.
+  std::optional<proto::BenchmarkParams> benchmark_params_;
+
+  // The file the workload of the session is recorded to. Empty for none.
+  std::string decode_replay_path_;
+
   // Whether to apply the deprecated prompt templates in the session.
   // TODO - b/453312248: Remove this field once the prompt templates are
   // removed.
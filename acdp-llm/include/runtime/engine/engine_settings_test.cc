@@ -14,6 +14,7 @@
 
 #include "runtime/engine/engine_settings.h"
 
+#include <memory>
 #include <optional>
 #include <sstream>
 #include <string>
@@ -24,12 +25,16 @@
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
 #include "runtime/components/tokenizer.h"
 #include "runtime/executor/executor_settings_base.h"
+#include "runtime/executor/llm_executor_settings.h"
 #include "runtime/proto/engine.pb.h"
 #include "runtime/proto/llm_metadata.pb.h"
 #include "runtime/proto/llm_model_type.pb.h"
 #include "runtime/proto/token.pb.h"
+#include "runtime/util/memory_mapped_file.h"
+#include "runtime/util/model_verification.h"
 #include "runtime/util/test_utils.h"  // IWYU pragma: keep
 
 namespace litert::lm {
@@ -307,6 +312,230 @@ TEST(EngineSettingsTest, MaybeUpdateAndValidate) {
   EXPECT_OK(IsExpectedLlmMetadata(settings->GetLlmMetadata().value()));
 }
 
+TEST(EngineSettingsTest, DraftExecutorSettingsNotSet) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets, Backend::CPU);
+  EXPECT_OK(settings);
+  EXPECT_FALSE(settings->GetDraftExecutorSettings().has_value());
+}
+
+TEST(EngineSettingsTest, SetAndGetPrefixCacheMaxSizeBytes) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_EQ(settings->GetPrefixCacheMaxSizeBytes(), 0);
+  settings->SetPrefixCacheMaxSizeBytes(256 * 1024 * 1024);
+  EXPECT_EQ(settings->GetPrefixCacheMaxSizeBytes(), 256 * 1024 * 1024);
+}
+
+TEST(EngineSettingsTest, SetAndGetTokenIdCacheMaxNumEntries) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_EQ(settings->GetTokenIdCacheMaxNumEntries(), 256);
+  settings->SetTokenIdCacheMaxNumEntries(0);
+  EXPECT_EQ(settings->GetTokenIdCacheMaxNumEntries(), 0);
+}
+
+TEST(EngineSettingsTest, SetAndGetEmbeddingCacheMaxSizeBytes) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_EQ(settings->GetEmbeddingCacheMaxSizeBytes(), 0);
+  settings->SetEmbeddingCacheMaxSizeBytes(64 * 1024 * 1024);
+  EXPECT_EQ(settings->GetEmbeddingCacheMaxSizeBytes(), 64 * 1024 * 1024);
+}
+
+TEST(EngineSettingsTest, SetAndGetMaxResidentMemoryBytes) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_EQ(settings->GetMaxResidentMemoryBytes(), 0);
+  settings->SetMaxResidentMemoryBytes(2ULL * 1024 * 1024 * 1024);
+  EXPECT_EQ(settings->GetMaxResidentMemoryBytes(), 2ULL * 1024 * 1024 * 1024);
+}
+
+TEST(EngineSettingsTest, SetAndGetNumWarmUpDecodeSteps) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_EQ(settings->GetNumWarmUpDecodeSteps(), 0);
+  settings->SetNumWarmUpDecodeSteps(4);
+  EXPECT_EQ(settings->GetNumWarmUpDecodeSteps(), 4);
+}
+
+TEST(EngineSettingsTest, SetAndGetMappingOptions) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_FALSE(settings->GetMappingOptions().has_value());
+  MappingOptions mapping_options;
+  mapping_options.prefetch = MappingOptions::Prefetch::kPopulate;
+  mapping_options.lock_in_memory = true;
+  settings->SetMappingOptions(mapping_options);
+  ASSERT_TRUE(settings->GetMappingOptions().has_value());
+  EXPECT_EQ(settings->GetMappingOptions()->prefetch,
+            MappingOptions::Prefetch::kPopulate);
+  EXPECT_FALSE(settings->GetMappingOptions()->huge_pages);
+  EXPECT_TRUE(settings->GetMappingOptions()->lock_in_memory);
+}
+
+TEST(EngineSettingsTest, SetAndGetThreadPlacement) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_TRUE(settings->GetCpuAffinity().empty());
+  EXPECT_EQ(settings->GetNumaNode(), -1);
+  settings->SetCpuAffinity({0, 1, 2, 3});
+  settings->SetNumaNode(1);
+  EXPECT_THAT(settings->GetCpuAffinity(), ElementsAre(0, 1, 2, 3));
+  EXPECT_EQ(settings->GetNumaNode(), 1);
+}
+
+TEST(EngineSettingsTest, SetAndGetKvCacheDataType) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_EQ(settings->GetKvCacheDataType(), KvCacheDataType::kFloat);
+  settings->SetKvCacheDataType(KvCacheDataType::kInt8);
+  EXPECT_EQ(settings->GetKvCacheDataType(), KvCacheDataType::kInt8);
+  std::stringstream ss;
+  ss << *settings;
+  EXPECT_THAT(ss.str(), testing::HasSubstr("KvCacheDataType: Int8"));
+}
+
+TEST(EngineSettingsTest, SetAndGetEngineRole) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_EQ(settings->GetEngineRole(), EngineRole::kPrefillAndDecode);
+  settings->SetEngineRole(EngineRole::kPrefill);
+  EXPECT_EQ(settings->GetEngineRole(), EngineRole::kPrefill);
+  std::stringstream ss;
+  ss << *settings;
+  EXPECT_THAT(ss.str(), testing::HasSubstr("EngineRole: Prefill"));
+}
+
+TEST(EngineSettingsTest, SetAndGetModelVerificationMode) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_FALSE(settings->GetModelVerificationMode().has_value());
+  settings->SetModelVerificationMode(ModelVerificationMode::kBackground);
+  EXPECT_EQ(settings->GetModelVerificationMode(),
+            ModelVerificationMode::kBackground);
+}
+
+TEST(EngineSettingsTest, SetAndGetParallelExecutorInitialization) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_FALSE(settings->GetParallelExecutorInitialization());
+  settings->SetParallelExecutorInitialization(true);
+  EXPECT_TRUE(settings->GetParallelExecutorInitialization());
+}
+
+TEST(EngineSettingsTest, SetAndGetLazyMultimodalExecutors) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_FALSE(settings->GetLazyMultimodalExecutors());
+  EXPECT_EQ(settings->GetMultimodalExecutorIdleTimeout(),
+            absl::InfiniteDuration());
+  settings->SetLazyMultimodalExecutors(true);
+  settings->SetMultimodalExecutorIdleTimeout(absl::Minutes(5));
+  EXPECT_TRUE(settings->GetLazyMultimodalExecutors());
+  EXPECT_EQ(settings->GetMultimodalExecutorIdleTimeout(), absl::Minutes(5));
+}
+
+TEST(EngineSettingsTest, SetAndGetLoraAdaptersMaxSizeBytes) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_EQ(settings->GetLoraAdaptersMaxSizeBytes(), 0);
+  settings->SetLoraAdaptersMaxSizeBytes(256 * 1024 * 1024);
+  EXPECT_EQ(settings->GetLoraAdaptersMaxSizeBytes(), 256 * 1024 * 1024);
+}
+
+TEST(EngineSettingsTest, SetAndGetCacheDir) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_EQ(settings->GetCacheDir(), "");
+  settings->SetCacheDir("/tmp/litert_lm_cache");
+  EXPECT_EQ(settings->GetCacheDir(), "/tmp/litert_lm_cache");
+}
+
+TEST(EngineSettingsTest, SetAndGetSharedMemoryCacheName) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_EQ(settings->GetSharedMemoryCacheName(), "");
+  settings->SetSharedMemoryCacheName("gateway");
+  EXPECT_EQ(settings->GetSharedMemoryCacheName(), "gateway");
+}
+
+TEST(EngineSettingsTest, SetAndGetPrefillChunkSize) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  EXPECT_EQ(settings->GetPrefillChunkSize(), 256);
+  settings->SetPrefillChunkSize(0);
+  EXPECT_EQ(settings->GetPrefillChunkSize(), 0);
+}
+
+TEST(EngineSettingsTest, RejectsNegativePrefillChunkSize) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  settings->SetPrefillChunkSize(-1);
+  MockTokenizer tokenizer;
+  EXPECT_THAT(settings->MaybeUpdateAndValidate(tokenizer, nullptr),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(EngineSettingsTest, MaybeUpdateAndValidateSetsDraftMaxNumTokens) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  auto draft_model_assets = ModelAssets::Create("draft_model_path");
+  ASSERT_OK(draft_model_assets);
+  ASSERT_OK_AND_ASSIGN(
+      settings->GetMutableDraftExecutorSettings(),
+      LlmExecutorSettings::CreateDefault(*draft_model_assets, Backend::CPU));
+  settings->GetMutableMainExecutorSettings().SetMaxNumTokens(2048);
+
+  MockTokenizer tokenizer;
+  EXPECT_CALL(tokenizer, TokenIdsToText).WillRepeatedly(Return("fake_text"));
+  EXPECT_CALL(tokenizer, TokenToId).WillRepeatedly(Return(1));
+  EXPECT_CALL(tokenizer, TextToTokenIds)
+      .WillRepeatedly(Return(std::vector<int>{1}));
+  proto::LlmMetadata llm_metadata = CreateLlmMetadata();
+
+  EXPECT_OK(settings->MaybeUpdateAndValidate(tokenizer, &llm_metadata));
+  ASSERT_TRUE(settings->GetDraftExecutorSettings().has_value());
+  EXPECT_EQ(settings->GetDraftExecutorSettings()->GetMaxNumTokens(), 2048);
+}
+
 TEST(EngineSettingsTest, MaybeUpdateAndValidateTokenToIdReturnsError) {
   auto model_assets = ModelAssets::Create("test_model_path_1");
   ASSERT_OK(model_assets);
@@ -390,6 +619,13 @@ TEST(SessionConfigTest, SetAndGetStopTokenIds) {
   EXPECT_THAT(session_config.GetStopTokenIds()[1], ElementsAre(1, 2));
 }
 
+TEST(SessionConfigTest, SetAndGetStopStrings) {
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  EXPECT_TRUE(session_config.GetStopStrings().empty());
+  session_config.GetMutableStopStrings() = {"</s>", "\n\n"};
+  EXPECT_THAT(session_config.GetStopStrings(), ElementsAre("</s>", "\n\n"));
+}
+
 TEST(SessionConfigTest, SetAndGetNumOutputCandidates) {
   SessionConfig session_config = SessionConfig::CreateDefault();
   EXPECT_EQ(session_config.GetNumOutputCandidates(), 1);
@@ -397,6 +633,82 @@ TEST(SessionConfigTest, SetAndGetNumOutputCandidates) {
   EXPECT_EQ(session_config.GetNumOutputCandidates(), 2);
 }
 
+TEST(SessionConfigTest, SetAndGetNumDraftTokens) {
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  EXPECT_EQ(session_config.GetNumDraftTokens(), 4);
+  session_config.SetNumDraftTokens(0);
+  EXPECT_EQ(session_config.GetNumDraftTokens(), 0);
+}
+
+TEST(SessionConfigTest, SetAndGetContextOverflowPolicy) {
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  EXPECT_EQ(session_config.GetContextOverflowPolicy(),
+            ContextOverflowPolicy::kStop);
+  EXPECT_EQ(session_config.GetNumContextSinkTokens(), 4);
+  EXPECT_EQ(session_config.GetNumContextEvictionTokens(), 256);
+  session_config.SetContextOverflowPolicy(
+      ContextOverflowPolicy::kSlidingWindow);
+  session_config.SetNumContextSinkTokens(100);
+  session_config.SetNumContextEvictionTokens(64);
+  EXPECT_EQ(session_config.GetContextOverflowPolicy(),
+            ContextOverflowPolicy::kSlidingWindow);
+  EXPECT_EQ(session_config.GetNumContextSinkTokens(), 100);
+  EXPECT_EQ(session_config.GetNumContextEvictionTokens(), 64);
+}
+
+TEST(SessionConfigTest, SetAndGetPipelinedCallbacks) {
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  EXPECT_FALSE(session_config.GetPipelinedCallbacks());
+  session_config.SetPipelinedCallbacks(true);
+  EXPECT_TRUE(session_config.GetPipelinedCallbacks());
+}
+
+TEST(SessionConfigTest, SetAndGetCallbackBackpressure) {
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  EXPECT_EQ(session_config.GetCallbackQueueCapacity(), 64);
+  EXPECT_EQ(session_config.GetCallbackBackpressurePolicy(),
+            CallbackBackpressurePolicy::kBlock);
+  session_config.SetCallbackQueueCapacity(8);
+  session_config.SetCallbackBackpressurePolicy(
+      CallbackBackpressurePolicy::kCoalesce);
+  EXPECT_EQ(session_config.GetCallbackQueueCapacity(), 8);
+  EXPECT_EQ(session_config.GetCallbackBackpressurePolicy(),
+            CallbackBackpressurePolicy::kCoalesce);
+}
+
+TEST(SessionConfigTest, SetAndGetUseBeamSearch) {
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  EXPECT_FALSE(session_config.GetUseBeamSearch());
+  session_config.SetUseBeamSearch(true);
+  EXPECT_TRUE(session_config.GetUseBeamSearch());
+}
+
+TEST(SessionConfigTest, SetAndGetLoraAdapterId) {
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  EXPECT_EQ(session_config.GetLoraAdapterId(), "");
+  session_config.SetLoraAdapterId("tenant_a");
+  EXPECT_EQ(session_config.GetLoraAdapterId(), "tenant_a");
+}
+
+TEST(SessionConfigTest, SetAndGetDecodeReplayPath) {
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  EXPECT_EQ(session_config.GetDecodeReplayPath(), "");
+  session_config.SetDecodeReplayPath("/tmp/session.replay");
+  EXPECT_EQ(session_config.GetDecodeReplayPath(), "/tmp/session.replay");
+}
+
+TEST(SessionConfigTest, SetAndGetBenchmarkParams) {
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  EXPECT_FALSE(session_config.GetBenchmarkParams().has_value());
+  proto::BenchmarkParams benchmark_params;
+  benchmark_params.set_num_prefill_tokens(256);
+  benchmark_params.set_num_decode_tokens(64);
+  session_config.SetBenchmarkParams(benchmark_params);
+  ASSERT_TRUE(session_config.GetBenchmarkParams().has_value());
+  EXPECT_EQ(session_config.GetBenchmarkParams()->num_prefill_tokens(), 256);
+  EXPECT_EQ(session_config.GetBenchmarkParams()->num_decode_tokens(), 64);
+}
+
 TEST(SessionConfigTest, SetAndGetStartTokenId) {
   SessionConfig session_config = SessionConfig::CreateDefault();
   EXPECT_EQ(session_config.GetStartTokenId(), -1);
@@ -439,6 +751,39 @@ TEST(SessionConfigTest, MaybeUpdateAndValidate) {
             proto::LlmModelType::kGenericModel);
 }
 
+TEST(SessionConfigTest, MaybeUpdateAndValidateWithSessionConfigDefaults) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  MockTokenizer tokenizer;
+  EXPECT_CALL(tokenizer, TokenIdsToText).WillRepeatedly(Return("fake_text"));
+  EXPECT_CALL(tokenizer, TokenToId).WillRepeatedly(Return(1));
+  EXPECT_CALL(tokenizer, TextToTokenIds)
+      .WillRepeatedly(Return(std::vector<int>{1}));
+  proto::LlmMetadata llm_metadata = CreateLlmMetadata();
+  EXPECT_OK(settings->MaybeUpdateAndValidate(tokenizer, &llm_metadata));
+
+  // The defaults read once give the same configs as the engine settings.
+  std::shared_ptr<const SessionConfigDefaults> defaults =
+      SessionConfigDefaults::Create(*settings);
+  EXPECT_TRUE(defaults->has_llm_metadata);
+  auto session_config = SessionConfig::CreateDefault();
+  EXPECT_OK(session_config.MaybeUpdateAndValidate(*defaults));
+  auto expected_session_config = SessionConfig::CreateDefault();
+  EXPECT_OK(expected_session_config.MaybeUpdateAndValidate(*settings));
+  EXPECT_EQ(session_config.GetStartTokenId(),
+            expected_session_config.GetStartTokenId());
+  EXPECT_EQ(session_config.GetStopTokenIds(),
+            expected_session_config.GetStopTokenIds());
+  EXPECT_EQ(session_config.GetSamplerBackend(),
+            expected_session_config.GetSamplerBackend());
+  EXPECT_EQ(session_config.GetJinjaPromptTemplate(),
+            expected_session_config.GetJinjaPromptTemplate());
+  EXPECT_EQ(session_config.GetLlmModelType().model_type_case(),
+            expected_session_config.GetLlmModelType().model_type_case());
+}
+
 TEST(SessionConfigTest, MaybeUpdateAndValidatePickGpuAsSamplerBackend) {
   auto model_assets = ModelAssets::Create("test_model_path_1");
   ASSERT_OK(model_assets);
@@ -488,6 +833,37 @@ TEST(SessionConfigTest, MaybeUpdateAndValidateMaxNumTokens) {
   EXPECT_EQ(settings->GetMainExecutorSettings().GetMaxNumTokens(), 1280);
 }
 
+TEST(SessionConfigTest, MaybeUpdateAndValidateSessionMaxNumTokens) {
+  auto model_assets = ModelAssets::Create("test_model_path_1");
+  ASSERT_OK(model_assets);
+  auto settings = EngineSettings::CreateDefault(*model_assets);
+  EXPECT_OK(settings);
+  MockTokenizer tokenizer;
+  EXPECT_CALL(tokenizer, TokenIdsToText).WillRepeatedly(Return("fake_text"));
+  EXPECT_CALL(tokenizer, TokenToId).WillRepeatedly(Return(1));
+  EXPECT_CALL(tokenizer, TextToTokenIds)
+      .WillRepeatedly(Return(std::vector<int>{1}));
+  proto::LlmMetadata llm_metadata = CreateLlmMetadata();
+  llm_metadata.set_max_num_tokens(1280);
+  EXPECT_OK(settings->MaybeUpdateAndValidate(tokenizer, &llm_metadata));
+
+  // The sessions not setting it take the maximum of the engine.
+  auto session_config = SessionConfig::CreateDefault();
+  EXPECT_EQ(session_config.GetMaxNumTokens(), 0);
+  EXPECT_OK(session_config.MaybeUpdateAndValidate(*settings));
+  EXPECT_EQ(session_config.GetMaxNumTokens(), 1280);
+
+  auto short_session_config = SessionConfig::CreateDefault();
+  short_session_config.SetMaxNumTokens(256);
+  EXPECT_OK(short_session_config.MaybeUpdateAndValidate(*settings));
+  EXPECT_EQ(short_session_config.GetMaxNumTokens(), 256);
+
+  auto long_session_config = SessionConfig::CreateDefault();
+  long_session_config.SetMaxNumTokens(2048);
+  EXPECT_THAT(long_session_config.MaybeUpdateAndValidate(*settings),
+              testing::status::StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 TEST(SessionConfigTest,
      MaybeUpdateAndValidateMaxNumTokensPrefillBatchSizeFromShortInputPrompt) {
   constexpr int kNumInputPromptTokens = 1024;
@@ -700,6 +1076,13 @@ TEST(SessionConfigTest, SetAndGetSamplerBackend) {
   EXPECT_EQ(session_config.GetSamplerBackend(), Backend::GPU);
 }
 
+TEST(SessionConfigTest, SetAndGetAutoSelectSamplerBackend) {
+  SessionConfig session_config = SessionConfig::CreateDefault();
+  EXPECT_FALSE(session_config.GetAutoSelectSamplerBackend());
+  session_config.SetAutoSelectSamplerBackend(true);
+  EXPECT_TRUE(session_config.GetAutoSelectSamplerBackend());
+}
+
 TEST(SessionConfigTest,
      MaybeUpdateAndValidatePromptTemplates_NoSessionTemplate) {
   auto model_assets = ModelAssets::Create("test_model_path_1");
@@ -0,0 +1,311 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/eval_harness.h"
+
+#include <cmath>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/ascii.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "nlohmann/json.hpp"  // from @nlohmann_json
+#include "runtime/components/tokenizer.h"
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+// Scores the targets of the examples, reusing the prefill of their prefix.
+class EvalRunner {
+ public:
+  EvalRunner(const Engine& engine, const SessionConfig& session_config,
+             Tokenizer& tokenizer, EvalReport& report)
+      : engine_(engine),
+        session_config_(session_config),
+        tokenizer_(tokenizer),
+        report_(report) {}
+
+  // Scores `targets`, the continuations of `prefix` of the examples from
+  // `first_index` on.
+  void Score(absl::string_view prefix, const std::vector<std::string>& targets,
+             int first_index) {
+    absl::StatusOr<std::vector<float>> scores = ScoreTargets(prefix, targets);
+    if (!scores.ok()) {
+      ABSL_LOG(WARNING) << "Failed to score the examples from " << first_index
+                        << ": " << scores.status();
+      report_.num_failed_examples += targets.size();
+      // The context of the session is unknown after a failure.
+      session_.reset();
+      return;
+    }
+    for (int i = 0; i < targets.size(); ++i) {
+      EvalExampleScore example_score;
+      example_score.index = first_index + i;
+      example_score.score = (*scores)[i];
+      absl::StatusOr<std::vector<int>> token_ids =
+          tokenizer_.TextToTokenIds(targets[i]);
+      if (token_ids.ok()) {
+        example_score.num_tokens = token_ids->size();
+      } else {
+        ABSL_LOG(WARNING) << "Failed to count the tokens of the example "
+                          << example_score.index << ": " << token_ids.status();
+      }
+      report_.total_score += example_score.score;
+      report_.num_target_tokens += example_score.num_tokens;
+      report_.example_scores.push_back(example_score);
+    }
+  }
+
+ private:
+  absl::StatusOr<std::vector<float>> ScoreTargets(
+      absl::string_view prefix, const std::vector<std::string>& targets) {
+    RETURN_IF_ERROR(PrefillPrefix(prefix));
+    if (targets.size() > 1 && batched_scoring_ != false) {
+      absl::StatusOr<std::vector<float>> scores =
+          RunTextScoring({targets.begin(), targets.end()});
+      // The executors without batched scoring only take a single target,
+      // and reject the batch before touching the context.
+      if (!absl::IsInvalidArgument(scores.status())) {
+        if (scores.ok()) {
+          batched_scoring_ = true;
+        }
+        return scores;
+      }
+      ABSL_LOG(INFO) << "Batched scoring is not supported, scoring the "
+                        "targets one at a time: "
+                     << scores.status();
+      batched_scoring_ = false;
+    }
+    std::vector<float> scores;
+    scores.reserve(targets.size());
+    for (const std::string& target : targets) {
+      RETURN_IF_ERROR(RestorePrefix(prefix));
+      ASSIGN_OR_RETURN(std::vector<float> target_scores,
+                       RunTextScoring({target}));
+      scores.push_back(target_scores[0]);
+      // Unless known to be batched, the scoring appends the target to the
+      // context.
+      context_has_target_ = batched_scoring_ != true;
+    }
+    return scores;
+  }
+
+  absl::StatusOr<std::vector<float>> RunTextScoring(
+      const std::vector<absl::string_view>& targets) {
+    ++report_.num_scoring_calls;
+    ASSIGN_OR_RETURN(Responses responses, session_->RunTextScoring(targets));
+    if (responses.GetScores().size() != targets.size()) {
+      return absl::InternalError(
+          absl::StrCat("Expected ", targets.size(), " scores, got ",
+                       responses.GetScores().size(), "."));
+    }
+    return responses.GetScores();
+  }
+
+  // Prefills `prefix` in a new session, unless it is the prefix of the
+  // current one.
+  absl::Status PrefillPrefix(absl::string_view prefix) {
+    if (session_ != nullptr && prefilled_prefix_ == prefix) {
+      return absl::OkStatus();
+    }
+    session_.reset();
+    prefix_checkpoint_.reset();
+    ASSIGN_OR_RETURN(std::unique_ptr<Engine::Session> session,
+                     engine_.CreateSession(session_config_));
+    std::vector<InputData> contents;
+    contents.emplace_back(InputText(std::string(prefix)));
+    RETURN_IF_ERROR(session->RunPrefill(std::move(contents)));
+    ++report_.num_prefills;
+    session_ = std::move(session);
+    prefilled_prefix_ = std::string(prefix);
+    context_has_target_ = false;
+    return absl::OkStatus();
+  }
+
+  // Returns the context of the session to `prefix` after a target was
+  // scored into it, from a checkpoint if the session supports them, or by
+  // prefilling the prefix again.
+  absl::Status RestorePrefix(absl::string_view prefix) {
+    if (!context_has_target_) {
+      if (prefix_checkpoint_ == nullptr && checkpoints_supported_) {
+        absl::StatusOr<std::unique_ptr<SessionCheckpoint>> checkpoint =
+            session_->Checkpoint();
+        if (checkpoint.ok()) {
+          prefix_checkpoint_ = *std::move(checkpoint);
+        } else {
+          checkpoints_supported_ = false;
+        }
+      }
+      return absl::OkStatus();
+    }
+    if (prefix_checkpoint_ != nullptr) {
+      RETURN_IF_ERROR(session_->Restore(*prefix_checkpoint_));
+      context_has_target_ = false;
+      return absl::OkStatus();
+    }
+    session_.reset();
+    return PrefillPrefix(prefix);
+  }
+
+  const Engine& engine_;
+  const SessionConfig& session_config_;
+  Tokenizer& tokenizer_;
+  EvalReport& report_;
+  std::unique_ptr<Engine::Session> session_;
+  std::string prefilled_prefix_;
+  std::unique_ptr<SessionCheckpoint> prefix_checkpoint_;
+  // Whether the context of the session holds a target after its prefix.
+  bool context_has_target_ = false;
+  bool checkpoints_supported_ = true;
+  // Whether the session scores a batch of targets without changing its
+  // context, unknown until the first batch.
+  std::optional<bool> batched_scoring_;
+};
+
+}  // namespace
+
+absl::StatusOr<EvalExample> ParseEvalExample(absl::string_view line) {
+  nlohmann::ordered_json json =
+      nlohmann::ordered_json::parse(line, /*cb=*/nullptr,
+                                    /*allow_exceptions=*/false);
+  if (!json.is_object() || !json.contains("prefix") ||
+      !json["prefix"].is_string() || !json.contains("target") ||
+      !json["target"].is_string()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Expected an object with the \"prefix\" and \"target\" strings: ",
+        line));
+  }
+  EvalExample example;
+  example.prefix = json["prefix"].get<std::string>();
+  example.target = json["target"].get<std::string>();
+  if (example.prefix.empty() || example.target.empty()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The prefix and the target must not be empty: ", line));
+  }
+  return example;
+}
+
+double EvalReport::GetPerplexity() const {
+  if (num_target_tokens == 0) {
+    return 0;
+  }
+  return std::exp(total_score / num_target_tokens);
+}
+
+double EvalReport::GetExamplesPerSec() const {
+  if (wall_time <= absl::ZeroDuration()) {
+    return 0;
+  }
+  return example_scores.size() / absl::ToDoubleSeconds(wall_time);
+}
+
+double EvalReport::GetTargetTokensPerSec() const {
+  if (wall_time <= absl::ZeroDuration()) {
+    return 0;
+  }
+  return num_target_tokens / absl::ToDoubleSeconds(wall_time);
+}
+
+std::ostream& operator<<(std::ostream& os, const EvalReport& report) {
+  os << "Eval report:" << std::endl;
+  os << "  Examples: " << report.example_scores.size() << " scored, "
+     << report.num_failed_examples << " failed in " << report.wall_time
+     << std::endl;
+  os << "  Perplexity: " << report.GetPerplexity() << " over "
+     << report.num_target_tokens << " target tokens" << std::endl;
+  os << "  Prefills: " << report.num_prefills << ", scoring calls: "
+     << report.num_scoring_calls << std::endl;
+  os << "  Throughput: " << report.GetExamplesPerSec() << " examples/s, "
+     << report.GetTargetTokensPerSec() << " target tokens/s" << std::endl;
+  return os;
+}
+
+void WriteEvalExampleScores(const EvalReport& report, std::ostream& os) {
+  for (const EvalExampleScore& example_score : report.example_scores) {
+    nlohmann::ordered_json json = {
+        {"index", example_score.index},
+        {"score", example_score.score},
+        {"num_tokens", example_score.num_tokens},
+        {"perplexity", example_score.num_tokens > 0
+                           ? std::exp(static_cast<double>(
+                                          example_score.score) /
+                                      example_score.num_tokens)
+                           : 0.0}};
+    os << json.dump() << std::endl;
+  }
+}
+
+absl::StatusOr<EvalReport> RunEvalHarness(const Engine& engine,
+                                          const SessionConfig& session_config,
+                                          std::istream& dataset,
+                                          const EvalHarnessConfig& config) {
+  if (config.max_batch_size < 1) {
+    return absl::InvalidArgumentError("The batch size must be positive.");
+  }
+  ASSIGN_OR_RETURN(Tokenizer * tokenizer, engine.GetTokenizer());
+  EvalReport report;
+  EvalRunner runner(engine, session_config, *tokenizer, report);
+  const absl::Time start_time = absl::Now();
+
+  // The targets of the examples read since the last scoring, all of the
+  // same prefix.
+  std::string prefix;
+  std::vector<std::string> targets;
+  int first_index = 0;
+  int num_examples = 0;
+  std::string line;
+  for (int line_number = 1; std::getline(dataset, line); ++line_number) {
+    if (absl::StripAsciiWhitespace(line).empty()) {
+      continue;
+    }
+    absl::StatusOr<EvalExample> example = ParseEvalExample(line);
+    if (!example.ok()) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Line ", line_number, ": ", example.status().message()));
+    }
+    if (!targets.empty() &&
+        (example->prefix != prefix || targets.size() >= config.max_batch_size)) {
+      runner.Score(prefix, targets, first_index);
+      targets.clear();
+    }
+    if (targets.empty()) {
+      prefix = std::move(example->prefix);
+      first_index = num_examples;
+    }
+    targets.push_back(std::move(example->target));
+    ++num_examples;
+  }
+  if (!targets.empty()) {
+    runner.Score(prefix, targets, first_index);
+  }
+  report.wall_time = absl::Now() - start_time;
+  return report;
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,104 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_EVAL_HARNESS_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_EVAL_HARNESS_H_
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+
+namespace litert::lm {
+
+// An example of an evaluation dataset: the log-likelihood of `target` is
+// scored as the continuation of `prefix`, e.g. a prompt and its reference
+// answer.
+struct EvalExample {
+  std::string prefix;
+  std::string target;
+};
+
+// Parses an example from a line of a dataset in the JSON Lines format, an
+// object with the "prefix" and "target" strings, e.g.
+// {"prefix": "The capital of France is", "target": " Paris."}.
+absl::StatusOr<EvalExample> ParseEvalExample(absl::string_view line);
+
+struct EvalHarnessConfig {
+  // The number of targets of the same prefix scored in one batched call at
+  // most. The executors without batched scoring score them one at a time.
+  int max_batch_size = 16;
+};
+
+// The score of an example: the sum of the negative log probabilities of the
+// tokens of its target, and their number.
+struct EvalExampleScore {
+  // The index of the example in the dataset.
+  int index = 0;
+  float score = 0;
+  int num_tokens = 0;
+};
+
+// The measurements of an evaluation run.
+struct EvalReport {
+  // The scores of the examples scored, in the order of the dataset.
+  std::vector<EvalExampleScore> example_scores;
+  int num_failed_examples = 0;
+  // The number of prefixes prefilled, once per run of examples sharing their
+  // prefix.
+  int num_prefills = 0;
+  // The number of scoring calls, of up to max_batch_size targets each.
+  int num_scoring_calls = 0;
+  double total_score = 0;
+  int64_t num_target_tokens = 0;
+  absl::Duration wall_time;
+
+  // Returns the perplexity over the tokens of all the targets scored.
+  double GetPerplexity() const;
+  double GetExamplesPerSec() const;
+  double GetTargetTokensPerSec() const;
+};
+std::ostream& operator<<(std::ostream& os, const EvalReport& report);
+
+// Writes the scores of the examples of `report` to `os` in the JSON Lines
+// format, one object with the "index", "score", "num_tokens" and
+// "perplexity" of an example per line.
+void WriteEvalExampleScores(const EvalReport& report, std::ostream& os);
+
+// Scores the examples of `dataset`, read line by line in the format of
+// ParseEvalExample(), with sessions of `engine` created with
+// `session_config`, and returns the measurements once they are all scored.
+//
+// The consecutive examples sharing their prefix are scored together: the
+// prefix is prefilled once, and their targets are scored in batches of
+// `config.max_batch_size` from it. Sorting the dataset by prefix thus
+// maximizes the reuse. Without batched scoring, the targets are scored one
+// at a time from a checkpoint of the prefix, see Session::Checkpoint(). The
+// examples failing are counted, not returned as an error, while an invalid
+// line of the dataset fails the run.
+absl::StatusOr<EvalReport> RunEvalHarness(const Engine& engine,
+                                          const SessionConfig& session_config,
+                                          std::istream& dataset,
+                                          const EvalHarnessConfig& config);
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_EVAL_HARNESS_H_
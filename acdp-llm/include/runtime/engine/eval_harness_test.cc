@@ -0,0 +1,216 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/eval_harness.h"
+
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_split.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/fake_engine.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Field;
+using ::testing::status::StatusIs;
+
+// A tokenizer of a token per word.
+class WordTokenizer : public Tokenizer {
+ public:
+  absl::StatusOr<std::vector<int>> TextToTokenIds(
+      absl::string_view text) override {
+    std::vector<absl::string_view> words =
+        absl::StrSplit(text, ' ', absl::SkipEmpty());
+    return std::vector<int>(words.size(), 1);
+  }
+  absl::StatusOr<int> TokenToId(absl::string_view token) override {
+    return 1;
+  }
+  absl::StatusOr<std::string> TokenIdsToText(
+      const std::vector<int>& token_ids) override {
+    return std::string(token_ids.size(), 'a');
+  }
+  TokenizerType GetTokenizerType() const override {
+    return TokenizerType::kUnspecified;
+  }
+};
+
+// An engine of sessions scoring each target with its number of words. Unless
+// `batched_scoring`, the sessions only score a single target at a time.
+class ScoringEngine : public FakeEngine {
+ public:
+  absl::StatusOr<std::unique_ptr<Session>> CreateSession(
+      const SessionConfig& session_config) const override {
+    auto session = std::make_unique<testing::NiceMock<MockSession>>();
+    ON_CALL(*session, RunPrefill)
+        .WillByDefault([this](const std::vector<InputData>& contents) {
+          ++num_prefills;
+          return absl::OkStatus();
+        });
+    ON_CALL(*session, RunTextScoring)
+        .WillByDefault(
+            [this](const std::vector<absl::string_view>& targets)
+                -> absl::StatusOr<Responses> {
+              if (!batched_scoring && targets.size() != 1) {
+                return absl::InvalidArgumentError(
+                    "Target text size should be 1.");
+              }
+              std::vector<float> scores;
+              for (absl::string_view target : targets) {
+                if (target == "fail") {
+                  return absl::InternalError("Failed.");
+                }
+                std::vector<absl::string_view> words =
+                    absl::StrSplit(target, ' ', absl::SkipEmpty());
+                scores.push_back(words.size());
+              }
+              return Responses(TaskState::kDone, {}, std::move(scores));
+            });
+    ON_CALL(*session, Checkpoint)
+        .WillByDefault(
+            []() -> absl::StatusOr<std::unique_ptr<SessionCheckpoint>> {
+              return std::make_unique<SessionCheckpoint>();
+            });
+    ON_CALL(*session, Restore)
+        .WillByDefault([this](const SessionCheckpoint& checkpoint) {
+          ++num_restores;
+          return absl::OkStatus();
+        });
+    return session;
+  }
+
+  absl::StatusOr<Tokenizer*> GetTokenizer() const override {
+    return &tokenizer_;
+  }
+
+  bool batched_scoring = true;
+  mutable int num_prefills = 0;
+  mutable int num_restores = 0;
+
+ private:
+  mutable WordTokenizer tokenizer_;
+};
+
+constexpr absl::string_view kDataset =
+    R"({"prefix": "Q1", "target": "a"}
+{"prefix": "Q1", "target": "a b"}
+{"prefix": "Q1", "target": "a b c"}
+
+{"prefix": "Q2", "target": "a b c d"}
+)";
+
+TEST(EvalHarnessTest, ParseEvalExample) {
+  ASSERT_OK_AND_ASSIGN(EvalExample example,
+                       ParseEvalExample(R"({"prefix": "Q", "target": " A"})"));
+  EXPECT_EQ(example.prefix, "Q");
+  EXPECT_EQ(example.target, " A");
+
+  EXPECT_THAT(ParseEvalExample(R"({"prefix": "Q"})"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseEvalExample(R"({"prefix": "Q", "target": 1})"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseEvalExample(R"({"prefix": "", "target": "A"})"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseEvalExample("not json"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(EvalHarnessTest, ScoresTheTargetsOfAPrefixInBatches) {
+  ScoringEngine engine;
+  std::istringstream dataset{std::string(kDataset)};
+  EvalHarnessConfig config;
+  config.max_batch_size = 2;
+  ASSERT_OK_AND_ASSIGN(EvalReport report,
+                       RunEvalHarness(engine, SessionConfig::CreateDefault(),
+                                      dataset, config));
+  EXPECT_THAT(report.example_scores,
+              ElementsAre(Field(&EvalExampleScore::score, 1),
+                          Field(&EvalExampleScore::score, 2),
+                          Field(&EvalExampleScore::score, 3),
+                          Field(&EvalExampleScore::score, 4)));
+  EXPECT_EQ(report.example_scores[3].index, 3);
+  EXPECT_EQ(report.num_failed_examples, 0);
+  // Q1 is prefilled once for its two batches.
+  EXPECT_EQ(report.num_prefills, 2);
+  EXPECT_EQ(engine.num_prefills, 2);
+  EXPECT_EQ(report.num_scoring_calls, 3);
+  EXPECT_EQ(report.num_target_tokens, 10);
+  EXPECT_DOUBLE_EQ(report.GetPerplexity(), std::exp(1.0));
+  EXPECT_EQ(engine.num_restores, 0);
+}
+
+TEST(EvalHarnessTest, ScoresOneTargetAtATimeFromTheCheckpointOfThePrefix) {
+  ScoringEngine engine;
+  engine.batched_scoring = false;
+  std::istringstream dataset{std::string(kDataset)};
+  ASSERT_OK_AND_ASSIGN(EvalReport report,
+                       RunEvalHarness(engine, SessionConfig::CreateDefault(),
+                                      dataset, EvalHarnessConfig()));
+  EXPECT_EQ(report.example_scores.size(), 4);
+  EXPECT_EQ(report.num_failed_examples, 0);
+  EXPECT_EQ(engine.num_prefills, 2);
+  // The rejected batch, then each target.
+  EXPECT_EQ(report.num_scoring_calls, 5);
+  // Before the second and third targets of Q1.
+  EXPECT_EQ(engine.num_restores, 2);
+  EXPECT_EQ(report.num_target_tokens, 10);
+}
+
+TEST(EvalHarnessTest, CountsTheFailedExamples) {
+  ScoringEngine engine;
+  std::istringstream dataset(
+      R"({"prefix": "Q1", "target": "fail"}
+{"prefix": "Q2", "target": "a b"}
+)");
+  ASSERT_OK_AND_ASSIGN(EvalReport report,
+                       RunEvalHarness(engine, SessionConfig::CreateDefault(),
+                                      dataset, EvalHarnessConfig()));
+  EXPECT_EQ(report.num_failed_examples, 1);
+  ASSERT_EQ(report.example_scores.size(), 1);
+  EXPECT_EQ(report.example_scores[0].index, 1);
+
+  std::ostringstream scores;
+  WriteEvalExampleScores(report, scores);
+  EXPECT_EQ(scores.str(),
+            "{\"index\":1,\"score\":2.0,\"num_tokens\":2,\"perplexity\":"
+            "2.718281828459045}\n");
+}
+
+TEST(EvalHarnessTest, FailsOnAnInvalidLine) {
+  ScoringEngine engine;
+  std::istringstream dataset(R"({"prefix": "Q1", "target": "a"}
+{"prefix": "Q1"}
+)");
+  EXPECT_THAT(RunEvalHarness(engine, SessionConfig::CreateDefault(), dataset,
+                             EvalHarnessConfig()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace litert::lm
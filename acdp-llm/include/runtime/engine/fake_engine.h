@@ -0,0 +1,140 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_FAKE_ENGINE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_FAKE_ENGINE_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/io_types.h"
+
+namespace litert::lm {
+
+// A session whose methods are all mocked. The methods optional in
+// Engine::Session keep their default implementation until set up, except
+// CancelProcess(), which does nothing.
+class MockSession : public Engine::Session {
+ public:
+  MockSession() {
+    ON_CALL(*this, Checkpoint).WillByDefault([this]() {
+      return Session::Checkpoint();
+    });
+    ON_CALL(*this, Restore)
+        .WillByDefault([this](const SessionCheckpoint& checkpoint) {
+          return Session::Restore(checkpoint);
+        });
+    ON_CALL(*this, SerializeCheckpoint)
+        .WillByDefault([this](const SessionCheckpoint& checkpoint) {
+          return Session::SerializeCheckpoint(checkpoint);
+        });
+    ON_CALL(*this, DeserializeCheckpoint)
+        .WillByDefault([this](std::string data) {
+          return Session::DeserializeCheckpoint(std::move(data));
+        });
+    ON_CALL(*this, Fork).WillByDefault([this]() { return Session::Fork(); });
+    ON_CALL(*this, MigrateTo).WillByDefault([this](const Engine& engine) {
+      return Session::MigrateTo(engine);
+    });
+  }
+
+  MOCK_METHOD(absl::StatusOr<Responses>, GenerateContent,
+              (const std::vector<InputData>& contents), (override));
+  MOCK_METHOD(
+      absl::Status, GenerateContentStream,
+      (const std::vector<InputData>& contents,
+       absl::AnyInvocable<void(absl::StatusOr<Responses>)> user_callback),
+      (override));
+  MOCK_METHOD(
+      absl::Status, GenerateContentStream,
+      (const std::vector<InputData>& contents,
+       absl::AnyInvocable<void(absl::StatusOr<Responses>)> user_callback,
+       const DecodeConfig& decode_config),
+      (override));
+  MOCK_METHOD(absl::StatusOr<Responses>, RunTextScoring,
+              (const std::vector<absl::string_view>& target_text), (override));
+  MOCK_METHOD(absl::Status, RunPrefill,
+              (const std::vector<InputData>& contents), (override));
+  MOCK_METHOD(
+      absl::Status, RunPrefillAsync,
+      (const std::vector<InputData>& contents,
+       absl::AnyInvocable<void(absl::StatusOr<Responses>)> user_callback),
+      (override));
+  MOCK_METHOD(absl::StatusOr<Responses>, RunDecode, (), (override));
+  MOCK_METHOD(absl::StatusOr<Responses>, RunDecode,
+              (const DecodeConfig& decode_config), (override));
+  MOCK_METHOD(
+      absl::Status, RunDecodeAsync,
+      (absl::AnyInvocable<void(absl::StatusOr<Responses>)> user_callback),
+      (override));
+  MOCK_METHOD(
+      absl::Status, RunDecodeAsync,
+      (absl::AnyInvocable<void(absl::StatusOr<Responses>)> user_callback,
+       const DecodeConfig& decode_config),
+      (override));
+  MOCK_METHOD(absl::StatusOr<BenchmarkInfo>, GetBenchmarkInfo, (), (override));
+  MOCK_METHOD(void, CancelProcess, (), (override));
+  MOCK_METHOD(const SessionConfig&, GetSessionConfig, (), (const, override));
+  MOCK_METHOD(const Tokenizer&, GetTokenizer, (), (const, override));
+  MOCK_METHOD(absl::StatusOr<std::unique_ptr<SessionCheckpoint>>, Checkpoint,
+              (), (override));
+  MOCK_METHOD(absl::Status, Restore, (const SessionCheckpoint& checkpoint),
+              (override));
+  MOCK_METHOD(absl::StatusOr<std::string>, SerializeCheckpoint,
+              (const SessionCheckpoint& checkpoint), (override));
+  MOCK_METHOD(absl::StatusOr<std::unique_ptr<SessionCheckpoint>>,
+              DeserializeCheckpoint, (std::string data), (override));
+  MOCK_METHOD(absl::StatusOr<std::unique_ptr<Session>>, Fork, (), (override));
+  MOCK_METHOD(absl::StatusOr<std::unique_ptr<Session>>, MigrateTo,
+              (const Engine& engine), (override));
+};
+
+// An engine of the default settings of a fake model, creating mock sessions.
+// The tests derive from it to set up the sessions and the engine methods they
+// exercise.
+class FakeEngine : public Engine {
+ public:
+  explicit FakeEngine(EngineRole engine_role = EngineRole::kPrefillAndDecode)
+      : engine_settings_(*EngineSettings::CreateDefault(
+            *ModelAssets::Create("test_model_path"))) {
+    engine_settings_.SetEngineRole(engine_role);
+  }
+
+  absl::StatusOr<std::unique_ptr<Session>> CreateSession(
+      const SessionConfig& session_config) const override {
+    return std::make_unique<testing::NiceMock<MockSession>>();
+  }
+
+  const EngineSettings& GetEngineSettings() const override {
+    return engine_settings_;
+  }
+
+ private:
+  EngineSettings engine_settings_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_FAKE_ENGINE_H_
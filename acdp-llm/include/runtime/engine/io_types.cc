@@ -14,6 +14,8 @@
 
 #include "runtime/engine/io_types.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
 #include <cstddef>
 #include <cstdint>
 #include <iomanip>
@@ -21,6 +23,7 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <string>
@@ -28,15 +31,18 @@
 #include <variant>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
 #include "absl/log/log.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/str_cat.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
 #include "absl/time/clock.h"  // from @com_google_absl
 #include "absl/time/time.h"  // from @com_google_absl
 #include "litert/cc/litert_macros.h"  // from @litert
 #include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/util/latency_histogram.h"
 
 namespace litert::lm {
 
@@ -167,13 +173,54 @@ std::ostream& operator<<(std::ostream& os, const Responses& responses) {
 BenchmarkTurnData::BenchmarkTurnData(uint64_t tokens, absl::Duration dur)
     : duration(dur), num_tokens(tokens) {}
 
+void DecodeLatencyHistograms::Merge(const DecodeLatencyHistograms& other) {
+  inter_token.Merge(other.inter_token);
+  executor_step.Merge(other.executor_step);
+  callback.Merge(other.callback);
+}
+
+void DecodeLatencyHistograms::Clear() {
+  inter_token.Clear();
+  executor_step.Clear();
+  callback.Clear();
+}
+
+void ExecutorInvocationStats::AddInvocation(absl::Duration dispatch,
+                                            absl::Duration execution,
+                                            absl::Duration buffer_sync) {
+  ++num_invocations;
+  dispatch_time += dispatch;
+  execution_time += execution;
+  buffer_sync_time += buffer_sync;
+}
+
+std::ostream& operator<<(std::ostream& os,
+                         const ExecutorInvocationStats& stats) {
+  os << stats.num_invocations << " invocations, dispatch "
+     << stats.dispatch_time << ", execution " << stats.execution_time
+     << ", buffer sync " << stats.buffer_sync_time;
+  return os;
+}
+
+struct BenchmarkInfo::SharedLatencyHistograms {
+  absl::Mutex mutex;
+  DecodeLatencyHistograms histograms ABSL_GUARDED_BY(mutex);
+};
+
 BenchmarkInfo::BenchmarkInfo(const proto::BenchmarkParams& benchmark_params)
-    : benchmark_params_(benchmark_params) {};
+    : benchmark_params_(benchmark_params),
+      shared_latency_histograms_(
+          std::make_shared<SharedLatencyHistograms>()) {};
 
 const proto::BenchmarkParams& BenchmarkInfo::GetBenchmarkParams() const {
   return benchmark_params_;
 }
 
+void BenchmarkInfo::SetBenchmarkParams(
+    const proto::BenchmarkParams& benchmark_params) {
+  benchmark_params_ = benchmark_params;
+}
+
 absl::Status BenchmarkInfo::TimeInitPhaseStart(const std::string& phase_name) {
   if (start_time_map_.contains(phase_name)) {
     return absl::InternalError(
@@ -192,6 +239,54 @@ absl::Status BenchmarkInfo::TimeInitPhaseEnd(const std::string& phase_name) {
   return absl::OkStatus();
 }
 
+absl::Status BenchmarkInfo::RecordInitPhase(const std::string& phase_name,
+                                            absl::Time start_time,
+                                            absl::Time end_time) {
+  if (start_time_map_.contains(phase_name)) {
+    return absl::InternalError(
+        absl::StrCat("Phase ", phase_name, " already started."));
+  }
+  start_time_map_[phase_name] = start_time;
+  init_phases_[phase_name] = end_time - start_time;
+  return absl::OkStatus();
+}
+
+absl::Duration BenchmarkInfo::GetInitWallTime() const {
+  if (init_phases_.empty()) {
+    return absl::ZeroDuration();
+  }
+  absl::Time start_time = absl::InfiniteFuture();
+  absl::Time end_time = absl::InfinitePast();
+  for (const auto& [phase_name, duration] : init_phases_) {
+    const absl::Time phase_start_time = start_time_map_.at(phase_name);
+    start_time = std::min(start_time, phase_start_time);
+    end_time = std::max(end_time, phase_start_time + duration);
+  }
+  return end_time - start_time;
+}
+
+absl::string_view GetBenchmarkMarkName(BenchmarkMark mark) {
+  switch (mark) {
+    case BenchmarkMark::kExecutorDecode:
+      return "executor_decode";
+    case BenchmarkMark::kExecutorDecodeSpeculative:
+      return "executor_decode_speculative";
+    case BenchmarkMark::kExecutorJumpForward:
+      return "executor_jump_forward";
+    case BenchmarkMark::kSampling:
+      return "sampling";
+    case BenchmarkMark::kExecutorDecodeAndSample:
+      return "executor_decode_and_sample";
+    case BenchmarkMark::kVisionExecutor:
+      return "vision_executor";
+    case BenchmarkMark::kAudioExecutor:
+      return "audio_executor";
+    case BenchmarkMark::kNumMarks:
+      break;
+  }
+  return "unknown";
+}
+
 absl::Status BenchmarkInfo::TimeMarkDelta(const std::string& mark_name) {
   if (mark_time_map_.contains(mark_name)) {
     mark_durations_[mark_name] = absl::Now() - mark_time_map_[mark_name];
@@ -200,9 +295,26 @@ absl::Status BenchmarkInfo::TimeMarkDelta(const std::string& mark_name) {
   return absl::OkStatus();
 }
 
-const std::map<std::string, absl::Duration>& BenchmarkInfo::GetMarkDurations()
-    const {
-  return mark_durations_;
+void BenchmarkInfo::TimeMarkDelta(BenchmarkMark mark) {
+  const auto now = std::chrono::steady_clock::now();
+  const int index = static_cast<int>(mark);
+  if (interned_mark_times_[index].has_value()) {
+    interned_mark_durations_[index] =
+        absl::FromChrono(now - *interned_mark_times_[index]);
+  }
+  interned_mark_times_[index] = now;
+}
+
+std::map<std::string, absl::Duration> BenchmarkInfo::GetMarkDurations() const {
+  std::map<std::string, absl::Duration> mark_durations = mark_durations_;
+  for (int index = 0; index < kNumMarks; ++index) {
+    if (interned_mark_durations_[index].has_value()) {
+      mark_durations.insert_or_assign(
+          std::string(GetBenchmarkMarkName(static_cast<BenchmarkMark>(index))),
+          *interned_mark_durations_[index]);
+    }
+  }
+  return mark_durations;
 }
 
 absl::Status BenchmarkInfo::TimePrefillTurnStart() {
@@ -227,6 +339,38 @@ absl::Status BenchmarkInfo::TimePrefillTurnEnd(uint64_t num_prefill_tokens) {
   return absl::OkStatus();
 }
 
+void BenchmarkInfo::AddPrefillPaddingTokens(uint64_t num_padding_tokens) {
+  prefill_padding_tokens_ += num_padding_tokens;
+}
+
+uint64_t BenchmarkInfo::GetTotalPrefillPaddingTokens() const {
+  return prefill_padding_tokens_;
+}
+
+void BenchmarkInfo::SetKvCacheSizes(uint64_t size_bytes,
+                                    uint64_t float_size_bytes) {
+  kv_cache_size_bytes_ = size_bytes;
+  kv_cache_float_size_bytes_ = float_size_bytes;
+}
+
+uint64_t BenchmarkInfo::GetKvCacheSizeBytes() const {
+  return kv_cache_size_bytes_;
+}
+
+uint64_t BenchmarkInfo::GetKvCacheFloatSizeBytes() const {
+  return kv_cache_float_size_bytes_;
+}
+
+void BenchmarkInfo::SetExecutorInvocationStats(
+    std::map<std::string, ExecutorInvocationStats> stats) {
+  executor_invocation_stats_ = std::move(stats);
+}
+
+const std::map<std::string, ExecutorInvocationStats>&
+BenchmarkInfo::GetExecutorInvocationStats() const {
+  return executor_invocation_stats_;
+}
+
 const BenchmarkTurnData& BenchmarkInfo::GetPrefillTurn(int turn_index) const {
   return prefill_turns_[turn_index];
 }
@@ -250,9 +394,38 @@ absl::Status BenchmarkInfo::TimeDecodeTurnEnd(uint64_t num_decode_tokens) {
   decode_turns_.emplace_back(num_decode_tokens,
                              absl::Now() - start_time_map_[phase_name]);
   decode_turn_index_++;
+  latency_histograms_.Merge(turn_latency_histograms_);
+  {
+    absl::MutexLock lock(&shared_latency_histograms_->mutex);
+    shared_latency_histograms_->histograms.Merge(turn_latency_histograms_);
+  }
+  turn_latency_histograms_.Clear();
   return absl::OkStatus();
 }
 
+void BenchmarkInfo::RecordInterTokenLatency(absl::Duration latency) {
+  turn_latency_histograms_.inter_token.Record(latency);
+}
+
+void BenchmarkInfo::RecordExecutorStepLatency(absl::Duration latency) {
+  turn_latency_histograms_.executor_step.Record(latency);
+}
+
+void BenchmarkInfo::RecordCallbackLatency(absl::Duration latency) {
+  turn_latency_histograms_.callback.Record(latency);
+}
+
+const DecodeLatencyHistograms& BenchmarkInfo::GetDecodeLatencyHistograms()
+    const {
+  return latency_histograms_;
+}
+
+DecodeLatencyHistograms BenchmarkInfo::GetSharedDecodeLatencyHistograms()
+    const {
+  absl::MutexLock lock(&shared_latency_histograms_->mutex);
+  return shared_latency_histograms_->histograms;
+}
+
 const BenchmarkTurnData& BenchmarkInfo::GetDecodeTurn(int turn_index) const {
   return decode_turns_[turn_index];
 }
@@ -343,6 +516,19 @@ std::ostream& operator<<(std::ostream& os, const BenchmarkInfo& info) {
          << absl::ToDoubleMilliseconds(phase.second) << " ms" << std::endl;
     }
     os << "    Total init time: " << total_time << " ms" << std::endl;
+    os << "    Wall-clock init time: "
+       << absl::ToDoubleMilliseconds(info.GetInitWallTime()) << " ms"
+       << std::endl;
+  }
+
+  if (info.GetKvCacheSizeBytes() > 0) {
+    constexpr double kBytesPerMb = 1024.0 * 1024.0;
+    os << "  KV cache per context: " << info.GetKvCacheSizeBytes() / kBytesPerMb
+       << " MB, saving "
+       << (static_cast<double>(info.GetKvCacheFloatSizeBytes()) -
+           static_cast<double>(info.GetKvCacheSizeBytes())) /
+              kBytesPerMb
+       << " MB over float." << std::endl;
   }
 
   os << "--------------------------------------------------" << std::endl;
@@ -361,6 +547,8 @@ std::ostream& operator<<(std::ostream& os, const BenchmarkInfo& info) {
          << info.GetPrefillTokensPerSec(static_cast<int>(i)) << " tokens/sec."
          << std::endl;
     }
+    os << "    Prefill Padding: " << info.GetTotalPrefillPaddingTokens()
+       << " tokens." << std::endl;
   }
 
   os << "--------------------------------------------------" << std::endl;
@@ -378,10 +566,38 @@ std::ostream& operator<<(std::ostream& os, const BenchmarkInfo& info) {
   }
   os << "--------------------------------------------------" << std::endl;
 
-  if (!info.GetMarkDurations().empty()) {
-    os << "  Mark Durations (" << info.GetMarkDurations().size() << "):"
-       << std::endl;
-    for (const auto& [mark_name, duration] : info.GetMarkDurations()) {
+  const DecodeLatencyHistograms& latency_histograms =
+      info.GetDecodeLatencyHistograms();
+  if (latency_histograms.inter_token.GetCount() > 0) {
+    os << "  Decode Step Latencies (p50 / p90 / p99):" << std::endl;
+    for (const auto& [name, histogram] :
+         {std::make_pair("Inter-token", &latency_histograms.inter_token),
+          std::make_pair("Executor step", &latency_histograms.executor_step),
+          std::make_pair("Callback", &latency_histograms.callback)}) {
+      if (histogram->GetCount() == 0) {
+        continue;
+      }
+      os << "    - " << name << ": " << histogram->GetPercentile(50) << " / "
+         << histogram->GetPercentile(90) << " / "
+         << histogram->GetPercentile(99) << std::endl;
+    }
+    os << "--------------------------------------------------" << std::endl;
+  }
+
+  if (!info.GetExecutorInvocationStats().empty()) {
+    os << "  Executor Invocations (" << info.GetExecutorInvocationStats().size()
+       << " signatures):" << std::endl;
+    for (const auto& [signature, stats] : info.GetExecutorInvocationStats()) {
+      os << "    - " << signature << ": " << stats << std::endl;
+    }
+    os << "--------------------------------------------------" << std::endl;
+  }
+
+  const std::map<std::string, absl::Duration> mark_durations =
+      info.GetMarkDurations();
+  if (!mark_durations.empty()) {
+    os << "  Mark Durations (" << mark_durations.size() << "):" << std::endl;
+    for (const auto& [mark_name, duration] : mark_durations) {
       os << "    - " << mark_name << ": " << duration << std::endl;
     }
   }
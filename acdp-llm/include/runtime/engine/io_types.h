@@ -15,8 +15,13 @@
 #ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_IO_TYPES_H_
 #define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_IO_TYPES_H_
 
+#include <array>
+#include <chrono>  // NOLINT(build/c++11)
 #include <cstdint>
+#include <limits>
 #include <map>
+#include <memory>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <utility>
@@ -31,6 +36,7 @@
 #include "litert/cc/litert_tensor_buffer.h"  // from @litert
 #include "runtime/components/constrained_decoding/constraint.h"
 #include "runtime/proto/engine.pb.h"
+#include "runtime/util/latency_histogram.h"
 
 namespace litert::lm {
 
@@ -173,6 +179,13 @@ enum class TaskState {
 };
 std::ostream& operator<<(std::ostream& os, const TaskState& task_state);
 
+// How the hidden states of the tokens of a text are pooled into its
+// embedding, see Engine::Session::EmbedText().
+enum class EmbeddingPooling {
+  kLastToken,  // The hidden state of the last token, for causal models.
+  kMean,       // The mean of the hidden states of all the tokens.
+};
+
 // A container to host the model responses.
 class Responses {
  public:
@@ -220,12 +233,67 @@ struct BenchmarkTurnData {
 };
 std::ostream& operator<<(std::ostream& os, const BenchmarkTurnData& data);
 
+// The marks timed by the runtime on its hot paths, e.g. once or twice per
+// decode step. They are interned, so that timing them takes neither a lookup
+// nor an allocation, see BenchmarkInfo::TimeMarkDelta(BenchmarkMark).
+enum class BenchmarkMark {
+  kExecutorDecode,
+  kExecutorDecodeSpeculative,
+  kExecutorJumpForward,
+  kSampling,
+  kExecutorDecodeAndSample,
+  kVisionExecutor,
+  kAudioExecutor,
+  // Not a mark, the number of marks.
+  kNumMarks,
+};
+// Returns the name of `mark` in BenchmarkInfo::GetMarkDurations(), e.g.
+// "executor_decode".
+absl::string_view GetBenchmarkMarkName(BenchmarkMark mark);
+
+// The latency distributions of the decode steps.
+struct DecodeLatencyHistograms {
+  // The time between two consecutive steps producing text, i.e. the
+  // inter-token latency seen by the streaming callers.
+  LatencyHistogram inter_token;
+  // The time of the executor to decode and sample a step.
+  LatencyHistogram executor_step;
+  // The time spent in the streaming callbacks.
+  LatencyHistogram callback;
+
+  void Merge(const DecodeLatencyHistograms& other);
+  void Clear();
+};
+
+// The cost of the invocations of a signature of an executor, e.g. of the
+// prefill or the decode signature of an NPU model, split between the host and
+// the accelerator, so that the benchmarks show whether the accelerator is
+// compute-bound or waits on the transfers.
+struct ExecutorInvocationStats {
+  uint64_t num_invocations = 0;
+  // The time on the host to hand the invocations over to the accelerator.
+  absl::Duration dispatch_time;
+  // The time of the invocations on the accelerator.
+  absl::Duration execution_time;
+  // The time to synchronize and copy the buffers between the host and the
+  // accelerator around the invocations.
+  absl::Duration buffer_sync_time;
+
+  // Adds the cost of an invocation.
+  void AddInvocation(absl::Duration dispatch, absl::Duration execution,
+                     absl::Duration buffer_sync);
+};
+std::ostream& operator<<(std::ostream& os,
+                         const ExecutorInvocationStats& stats);
+
 // Class to store and manage comprehensive performance benchmark information for
 // LLMs.
 class BenchmarkInfo {
  public:
   explicit BenchmarkInfo(const proto::BenchmarkParams& benchmark_params);
   const proto::BenchmarkParams& GetBenchmarkParams() const;
+  // Replaces the benchmark parameters, e.g. with the ones of a session.
+  void SetBenchmarkParams(const proto::BenchmarkParams& benchmark_params);
 
   // --- Methods to record data ---
   // Time the start and end of a phase in the initialization. The phase name
@@ -233,6 +301,10 @@ class BenchmarkInfo {
   // methods will return an error.
   absl::Status TimeInitPhaseStart(const std::string& phase_name);
   absl::Status TimeInitPhaseEnd(const std::string& phase_name);
+  // Records a phase timed elsewhere, e.g. on another thread, as the phases may
+  // overlap. The same uniqueness applies to the phase name.
+  absl::Status RecordInitPhase(const std::string& phase_name,
+                               absl::Time start_time, absl::Time end_time);
   // Time the start and end of a prefill/decode turn. The num_prefill_tokens
   // should be the number of tokens processed in this turn. The method will
   // return an error if the methods are called out of order (i.e. one end after
@@ -241,6 +313,16 @@ class BenchmarkInfo {
   absl::Status TimePrefillTurnEnd(uint64_t num_prefill_tokens);
   absl::Status TimeDecodeTurnStart();
   absl::Status TimeDecodeTurnEnd(uint64_t num_decode_tokens);
+  // Records the tokens the prefill signatures were padded with in excess of
+  // the prompt, computed in vain.
+  void AddPrefillPaddingTokens(uint64_t num_padding_tokens);
+  // Records the memory of the kv-cache of a context as stored, and as it
+  // would be stored as floats, to report the savings of its quantization.
+  void SetKvCacheSizes(uint64_t size_bytes, uint64_t float_size_bytes);
+  // Records the invocation stats of the executor by signature name, e.g.
+  // "prefill_128" or "decode", see ProfiledLlmExecutor.
+  void SetExecutorInvocationStats(
+      std::map<std::string, ExecutorInvocationStats> stats);
   // Time the duration between two consecutive marks. Useful for profiling the
   // pipeline at a specific point. For example:
   //   RETURN_IF_ERROR(benchmark_info.TimeMarkDelta("sampling"));
@@ -251,15 +333,43 @@ class BenchmarkInfo {
   // TimeMarkDelta("sampling") calls. The duration will be stored / recorded for
   // each unique mark name.
   absl::Status TimeMarkDelta(const std::string& mark_name);
+  // The same for a mark of the runtime, at the cost of a read of the
+  // monotonic clock, so that the marks of the decode loop can stay on.
+  void TimeMarkDelta(BenchmarkMark mark);
+
+  // Records the latencies of a decode step in the histograms of the current
+  // decode turn, which are added to the histograms of the BenchmarkInfo and of
+  // the engine when the turn ends.
+  void RecordInterTokenLatency(absl::Duration latency);
+  void RecordExecutorStepLatency(absl::Duration latency);
+  void RecordCallbackLatency(absl::Duration latency);
 
   // --- Getters for raw data ---
   const std::map<std::string, absl::Duration>& GetInitPhases() const;
-  const std::map<std::string, absl::Duration>& GetMarkDurations() const;
+  // Returns the time from the start of the first init phase to the end of the
+  // last one, which is less than the sum of the phases when they overlap.
+  absl::Duration GetInitWallTime() const;
+  // Returns the last durations of the marks timed twice or more, by name.
+  std::map<std::string, absl::Duration> GetMarkDurations() const;
+  // The kv-cache memory of a context, 0 if not recorded.
+  uint64_t GetKvCacheSizeBytes() const;
+  uint64_t GetKvCacheFloatSizeBytes() const;
+  // The invocation stats of the executor by signature name, empty if not
+  // recorded.
+  const std::map<std::string, ExecutorInvocationStats>&
+  GetExecutorInvocationStats() const;
+  // The latency histograms of the decode turns ended so far.
+  const DecodeLatencyHistograms& GetDecodeLatencyHistograms() const;
+  // The latency histograms of the decode turns ended by this BenchmarkInfo and
+  // by all the BenchmarkInfo copied from it or from its copies, e.g. by all the
+  // sessions of an engine. Thread-safe.
+  DecodeLatencyHistograms GetSharedDecodeLatencyHistograms() const;
 
   // --- Calculated metrics and getters for Prefill ---
   uint64_t GetTotalPrefillTurns() const;
   const BenchmarkTurnData& GetPrefillTurn(int turn_index) const;
   double GetPrefillTokensPerSec(int turn_index) const;
+  uint64_t GetTotalPrefillPaddingTokens() const;
 
   // --- Calculated metrics and getters for Decode ---
   uint64_t GetTotalDecodeTurns() const;
@@ -284,8 +394,26 @@ class BenchmarkInfo {
 
   std::map<std::string, absl::Duration> init_phases_;
   std::map<std::string, absl::Duration> mark_durations_;
+  // The last times, from the monotonic clock, and the last durations of the
+  // interned marks, indexed by mark.
+  static constexpr int kNumMarks = static_cast<int>(BenchmarkMark::kNumMarks);
+  std::array<std::optional<std::chrono::steady_clock::time_point>, kNumMarks>
+      interned_mark_times_;
+  std::array<std::optional<absl::Duration>, kNumMarks>
+      interned_mark_durations_;
   std::vector<BenchmarkTurnData> prefill_turns_;
   std::vector<BenchmarkTurnData> decode_turns_;
+  uint64_t prefill_padding_tokens_ = 0;
+  uint64_t kv_cache_size_bytes_ = 0;
+  uint64_t kv_cache_float_size_bytes_ = 0;
+  std::map<std::string, ExecutorInvocationStats> executor_invocation_stats_;
+
+  // The histograms of the current decode turn, and of the ended ones.
+  DecodeLatencyHistograms turn_latency_histograms_;
+  DecodeLatencyHistograms latency_histograms_;
+  // The histograms shared by the copies.
+  struct SharedLatencyHistograms;
+  std::shared_ptr<SharedLatencyHistograms> shared_latency_histograms_;
 };
 std::ostream& operator<<(std::ostream& os, const BenchmarkInfo& info);
 
@@ -305,10 +433,216 @@ class DecodeConfig {
   // Returns a pointer to the constraint, or nullptr if no constraint is set.
   Constraint* absl_nullable GetConstraint() const { return constraint_; }
 
+  // Options of prompt lookup decoding: a speculative decoding mode which
+  // proposes the draft tokens by matching the last tokens of the sequence
+  // against the earlier context, instead of running a draft model.
+  struct PromptLookupOptions {
+    // The size range of the n-grams matched against the context. Longer
+    // n-grams are tried first.
+    int min_ngram_size = 1;
+    int max_ngram_size = 3;
+    // The maximum number of tokens proposed per decode step.
+    int max_num_draft_tokens = 8;
+  };
+
+  // Enables prompt lookup decoding for the request, or disables it if
+  // `options` is std::nullopt. It only applies to greedy sampling of a single
+  // output candidate without constraint, and takes precedence over the draft
+  // model of the engine, if any.
+  void SetPromptLookupOptions(std::optional<PromptLookupOptions> options) {
+    prompt_lookup_options_ = options;
+  }
+
+  // Returns the prompt lookup options, or std::nullopt if prompt lookup
+  // decoding is disabled.
+  const std::optional<PromptLookupOptions>& GetPromptLookupOptions() const {
+    return prompt_lookup_options_;
+  }
+
+  // Options of the coalescing of streaming responses: the texts decoded in
+  // consecutive steps are delivered in a single callback, which amortizes the
+  // cost of the callback and of what it feeds (FFI, network frames). The first
+  // response of a decode is never delayed. A coalesced response is delivered
+  // as soon as any enabled condition holds, checked whenever a step
+  // completes, and before the final response.
+  struct StreamingCoalescingOptions {
+    // The text boundaries at which the coalesced response is delivered.
+    enum class Boundary {
+      kNone,
+      // Before a text starting with a whitespace, or after a text ending with
+      // one.
+      kWord,
+      // After a text ending a sentence, i.e. with '.', '!', '?' or a newline.
+      kSentence,
+    };
+
+    // Delivers every `max_num_steps` decode steps, 0 for no limit.
+    int max_num_steps = 0;
+    // Delivers once the oldest coalesced text is `max_delay` old, zero for no
+    // limit.
+    absl::Duration max_delay = absl::ZeroDuration();
+    Boundary boundary = Boundary::kNone;
+  };
+
+  // Enables the coalescing of the streaming responses for the request, or
+  // disables it if `options` is std::nullopt. Ignored by the non-streaming
+  // decode.
+  void SetStreamingCoalescingOptions(
+      std::optional<StreamingCoalescingOptions> options) {
+    streaming_coalescing_options_ = options;
+  }
+
+  // Returns the coalescing options, or std::nullopt if every decode step is
+  // delivered on its own.
+  const std::optional<StreamingCoalescingOptions>&
+  GetStreamingCoalescingOptions() const {
+    return streaming_coalescing_options_;
+  }
+
+  // Options of the pruning of the output candidates: the candidates falling
+  // behind the best ones are dropped from the decode, instead of being decoded
+  // to the end and discarded. A pruned candidate keeps the text decoded so
+  // far, with a score of -inf. The executors implementing
+  // CandidateMaskingLlmExecutor also stop computing the pruned and the stopped
+  // candidates. Only applies to the custom sampling of several candidates,
+  // which scores them.
+  struct CandidatePruningOptions {
+    // Prunes the candidates whose score, the average log-probability of their
+    // tokens, is more than `score_margin` below the best score.
+    float score_margin = std::numeric_limits<float>::infinity();
+    // Prunes all but the `max_num_candidates` best candidates, 0 for no
+    // limit.
+    int max_num_candidates = 0;
+    // The number of decode steps before the pruning starts, since the scores
+    // of the first tokens say little about the rest of the candidates.
+    int min_num_decode_steps = 0;
+  };
+
+  // Enables the pruning of the output candidates for the request, or disables
+  // it if `options` is std::nullopt.
+  void SetCandidatePruningOptions(
+      std::optional<CandidatePruningOptions> options) {
+    candidate_pruning_options_ = options;
+  }
+
+  // Returns the pruning options, or std::nullopt if every candidate is decoded
+  // until it stops.
+  const std::optional<CandidatePruningOptions>& GetCandidatePruningOptions()
+      const {
+    return candidate_pruning_options_;
+  }
+
+  // Options of the transformations of the logits before sampling. The
+  // enabled ones are applied together by a LogitsProcessor: the penalties and
+  // the biases only touch the tokens they apply to, and min-p is a single
+  // vectorized pass over the logits. Applied on the device by the executors
+  // sampling there and implementing LogitsProcessingLlmExecutor, otherwise on
+  // the host, which requires the CPU sampler backend.
+  struct LogitsProcessingOptions {
+    // Divides the positive logits and multiplies the negative ones of the
+    // tokens generated so far by `repetition_penalty`, 1 for no penalty.
+    float repetition_penalty = 1.0f;
+    // Subtracts `frequency_penalty` times the number of times a token has been
+    // generated so far from its logit.
+    float frequency_penalty = 0.0f;
+    // Subtracts `presence_penalty` from the logits of the tokens generated at
+    // least once so far.
+    float presence_penalty = 0.0f;
+    // Adds the bias to the logit of its token, at every step.
+    std::map<int, float> logit_bias;
+    // Masks out the tokens whose probability is below `min_p` times the
+    // probability of the most likely token, 0 to keep all the tokens.
+    float min_p = 0.0f;
+  };
+
+  // Enables the processing of the logits for the request, or disables it if
+  // `options` is std::nullopt. Like a constraint, it disables the speculative
+  // decoding for the rest of the session, and is not supported by beam
+  // search.
+  void SetLogitsProcessingOptions(
+      std::optional<LogitsProcessingOptions> options) {
+    logits_processing_options_ = std::move(options);
+  }
+
+  // Returns the logits processing options, or std::nullopt if the logits are
+  // sampled as they are.
+  const std::optional<LogitsProcessingOptions>& GetLogitsProcessingOptions()
+      const {
+    return logits_processing_options_;
+  }
+
+  // Options of the budget of the reasoning of the thinking models, which
+  // write their reasoning between two markers before the response, e.g.
+  // "<think>" and "</think>" for Qwen3. Once the reasoning reaches its budget,
+  // the end marker is inserted into the decoded tokens instead of being
+  // sampled, and the model moves on to the response. Only applies to a single
+  // output candidate.
+  struct ReasoningBudgetOptions {
+    // The number of tokens of the reasoning allowed at most, the markers
+    // excluded.
+    int max_num_reasoning_tokens = 1024;
+    // The markers of the reasoning, tokenized by the session. The reasoning
+    // must start the response, i.e. be the first decoded tokens.
+    std::string reasoning_start = "<think>";
+    std::string reasoning_end = "</think>";
+    // Drops the tokens of the reasoning from the context once the decode is
+    // done, so that the next turns neither attend to them nor keep them in
+    // the kv-cache. Requires an executor implementing
+    // ContextEvictionLlmExecutor, and no sliding window.
+    bool strip_reasoning = false;
+  };
+
+  // Enables the reasoning budget for the request, or disables it if `options`
+  // is std::nullopt. Like a constraint, it disables the speculative decoding
+  // for the rest of the session, and is not supported by beam search.
+  void SetReasoningBudgetOptions(
+      std::optional<ReasoningBudgetOptions> options) {
+    reasoning_budget_options_ = std::move(options);
+  }
+
+  // Returns the reasoning budget options, or std::nullopt if the reasoning
+  // runs until the model ends it.
+  const std::optional<ReasoningBudgetOptions>& GetReasoningBudgetOptions()
+      const {
+    return reasoning_budget_options_;
+  }
+
+  // Sets the priority of the request, overriding the one of the session, or
+  // restores the priority of the session if `priority` is std::nullopt.
+  void SetPriority(std::optional<int> priority) { priority_ = priority; }
+
+  // Returns the priority of the request, or std::nullopt if it runs with the
+  // priority of the session.
+  const std::optional<int>& GetPriority() const { return priority_; }
+
+  // Sets the time before which the request must start, after which it is
+  // cancelled instead of running. The earlier of this deadline and the
+  // request timeout of the session applies.
+  void SetDeadline(absl::Time deadline) { deadline_ = deadline; }
+
+  // Returns the deadline of the request, infinite future for no deadline.
+  absl::Time GetDeadline() const { return deadline_; }
+
+  // Sets how long a synchronous call waits for the request to complete,
+  // after which the request is cancelled and the call returns a
+  // DeadlineExceeded error. Defaults to Engine::kDefaultTimeout.
+  void SetTimeout(std::optional<absl::Duration> timeout) { timeout_ = timeout; }
+
+  // Returns the timeout of the request, or std::nullopt for the default one.
+  const std::optional<absl::Duration>& GetTimeout() const { return timeout_; }
+
  private:
   DecodeConfig() = default;
 
   Constraint* absl_nullable constraint_ = nullptr;
+  std::optional<PromptLookupOptions> prompt_lookup_options_;
+  std::optional<StreamingCoalescingOptions> streaming_coalescing_options_;
+  std::optional<CandidatePruningOptions> candidate_pruning_options_;
+  std::optional<LogitsProcessingOptions> logits_processing_options_;
+  std::optional<ReasoningBudgetOptions> reasoning_budget_options_;
+  std::optional<int> priority_;
+  absl::Time deadline_ = absl::InfiniteFuture();
+  std::optional<absl::Duration> timeout_;
 };
 
 }  // namespace litert::lm
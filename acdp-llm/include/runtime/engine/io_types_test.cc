@@ -16,6 +16,8 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -532,6 +534,25 @@ TEST(BenchmarkInfoTests, AddAndGetInitPhases) {
   EXPECT_GT(phases.at("Model Load"), absl::Milliseconds(100));
 }
 
+TEST(BenchmarkInfoTests, RecordOverlappingInitPhases) {
+  BenchmarkInfo benchmark_info(GetBenchmarkParams());
+  const absl::Time start_time = absl::Now();
+  EXPECT_OK(benchmark_info.RecordInitPhase(
+      "Vision Load", start_time, start_time + absl::Milliseconds(30)));
+  EXPECT_OK(benchmark_info.RecordInitPhase(
+      "Model Load", start_time + absl::Milliseconds(10),
+      start_time + absl::Milliseconds(50)));
+  EXPECT_THAT(benchmark_info.RecordInitPhase("Model Load", start_time,
+                                             start_time),
+              StatusIs(absl::StatusCode::kInternal));
+
+  EXPECT_EQ(benchmark_info.GetInitPhases().at("Vision Load"),
+            absl::Milliseconds(30));
+  EXPECT_EQ(benchmark_info.GetInitPhases().at("Model Load"),
+            absl::Milliseconds(40));
+  EXPECT_EQ(benchmark_info.GetInitWallTime(), absl::Milliseconds(50));
+}
+
 TEST(BenchmarkInfoTests, AddInitPhaseTwice) {
   BenchmarkInfo benchmark_info(GetBenchmarkParams());
   EXPECT_OK(benchmark_info.TimeInitPhaseStart("Model Load"));
@@ -553,6 +574,49 @@ TEST(BenchmarkInfoTests, AddPrefillTurn) {
   EXPECT_EQ(benchmark_info.GetTotalPrefillTurns(), 2);
 }
 
+TEST(BenchmarkInfoTests, AddPrefillPaddingTokens) {
+  BenchmarkInfo benchmark_info(GetBenchmarkParams());
+  EXPECT_EQ(benchmark_info.GetTotalPrefillPaddingTokens(), 0);
+  benchmark_info.AddPrefillPaddingTokens(24);
+  benchmark_info.AddPrefillPaddingTokens(40);
+  EXPECT_EQ(benchmark_info.GetTotalPrefillPaddingTokens(), 64);
+}
+
+TEST(BenchmarkInfoTests, SetKvCacheSizes) {
+  BenchmarkInfo benchmark_info(GetBenchmarkParams());
+  EXPECT_EQ(benchmark_info.GetKvCacheSizeBytes(), 0);
+  benchmark_info.SetKvCacheSizes(64 * 1024 * 1024, 128 * 1024 * 1024);
+  EXPECT_EQ(benchmark_info.GetKvCacheSizeBytes(), 64 * 1024 * 1024);
+  EXPECT_EQ(benchmark_info.GetKvCacheFloatSizeBytes(), 128 * 1024 * 1024);
+  std::stringstream ss;
+  ss << benchmark_info;
+  EXPECT_THAT(ss.str(), testing::HasSubstr(
+                            "KV cache per context: 64.00 MB, saving 64.00 MB"));
+}
+
+TEST(BenchmarkInfoTests, SetExecutorInvocationStats) {
+  BenchmarkInfo benchmark_info(GetBenchmarkParams());
+  EXPECT_TRUE(benchmark_info.GetExecutorInvocationStats().empty());
+  ExecutorInvocationStats decode_stats;
+  decode_stats.AddInvocation(absl::Microseconds(100), absl::Milliseconds(2),
+                             absl::Microseconds(300));
+  decode_stats.AddInvocation(absl::Microseconds(100), absl::Milliseconds(2),
+                             absl::Microseconds(300));
+  benchmark_info.SetExecutorInvocationStats({{"decode", decode_stats}});
+
+  const ExecutorInvocationStats& stats =
+      benchmark_info.GetExecutorInvocationStats().at("decode");
+  EXPECT_EQ(stats.num_invocations, 2);
+  EXPECT_EQ(stats.dispatch_time, absl::Microseconds(200));
+  EXPECT_EQ(stats.execution_time, absl::Milliseconds(4));
+  EXPECT_EQ(stats.buffer_sync_time, absl::Microseconds(600));
+  std::stringstream ss;
+  ss << benchmark_info;
+  EXPECT_THAT(ss.str(),
+              testing::HasSubstr("decode: 2 invocations, dispatch 200us, "
+                                 "execution 4ms, buffer sync 600us"));
+}
+
 TEST(BenchmarkInfoTests, AddPrefillTurnError) {
   BenchmarkInfo benchmark_info(GetBenchmarkParams());
   EXPECT_OK(benchmark_info.TimePrefillTurnStart());
@@ -625,6 +689,62 @@ TEST(BenchmarkInfoTests, AddTwoMarks) {
             absl::Milliseconds(100));
 }
 
+TEST(BenchmarkInfoTests, AddInternedMarks) {
+  BenchmarkInfo benchmark_info(GetBenchmarkParams());
+  benchmark_info.TimeMarkDelta(BenchmarkMark::kSampling);
+  EXPECT_TRUE(benchmark_info.GetMarkDurations().empty());
+  absl::SleepFor(absl::Milliseconds(50));
+  benchmark_info.TimeMarkDelta(BenchmarkMark::kSampling);
+  EXPECT_OK(benchmark_info.TimeMarkDelta("tokenize"));
+  EXPECT_OK(benchmark_info.TimeMarkDelta("tokenize"));
+
+  // The interned marks are reported by name, next to the other marks.
+  const auto mark_durations = benchmark_info.GetMarkDurations();
+  EXPECT_EQ(mark_durations.size(), 2);
+  EXPECT_GT(mark_durations.at("sampling"), absl::Milliseconds(50));
+  EXPECT_LT(mark_durations.at("tokenize"), absl::Milliseconds(50));
+}
+
+TEST(BenchmarkInfoTests, GetBenchmarkMarkName) {
+  EXPECT_EQ(GetBenchmarkMarkName(BenchmarkMark::kExecutorDecode),
+            "executor_decode");
+  EXPECT_EQ(GetBenchmarkMarkName(BenchmarkMark::kExecutorDecodeAndSample),
+            "executor_decode_and_sample");
+  EXPECT_EQ(GetBenchmarkMarkName(BenchmarkMark::kAudioExecutor),
+            "audio_executor");
+}
+
+TEST(BenchmarkInfoTests, RecordDecodeLatencies) {
+  BenchmarkInfo benchmark_info(GetBenchmarkParams());
+  BenchmarkInfo other_benchmark_info = benchmark_info;
+  EXPECT_OK(benchmark_info.TimeDecodeTurnStart());
+  benchmark_info.RecordInterTokenLatency(absl::Milliseconds(10));
+  benchmark_info.RecordInterTokenLatency(absl::Milliseconds(20));
+  benchmark_info.RecordExecutorStepLatency(absl::Milliseconds(8));
+  benchmark_info.RecordCallbackLatency(absl::Microseconds(50));
+  // The latencies are added up when the turn ends.
+  EXPECT_EQ(benchmark_info.GetDecodeLatencyHistograms().inter_token.GetCount(),
+            0);
+  EXPECT_OK(benchmark_info.TimeDecodeTurnEnd(2));
+  const DecodeLatencyHistograms& histograms =
+      benchmark_info.GetDecodeLatencyHistograms();
+  EXPECT_EQ(histograms.inter_token.GetCount(), 2);
+  EXPECT_EQ(histograms.inter_token.GetMax(), absl::Milliseconds(20));
+  EXPECT_EQ(histograms.executor_step.GetCount(), 1);
+  EXPECT_EQ(histograms.callback.GetPercentile(50), absl::Microseconds(50));
+
+  // The copies add up their latencies in the shared histograms.
+  EXPECT_OK(other_benchmark_info.TimeDecodeTurnStart());
+  other_benchmark_info.RecordInterTokenLatency(absl::Milliseconds(30));
+  EXPECT_OK(other_benchmark_info.TimeDecodeTurnEnd(1));
+  EXPECT_EQ(
+      other_benchmark_info.GetDecodeLatencyHistograms().inter_token.GetCount(),
+      1);
+  EXPECT_EQ(
+      benchmark_info.GetSharedDecodeLatencyHistograms().inter_token.GetCount(),
+      3);
+}
+
 TEST(BenchmarkInfoTests, GetTimeToFirstTokenInvalid) {
   BenchmarkInfo benchmark_info(GetBenchmarkParams());
   EXPECT_OK(benchmark_info.TimePrefillTurnStart());
@@ -658,6 +778,7 @@ TEST(BenchmarkInfoTests, OperatorOutputWithData) {
   EXPECT_OK(benchmark_info.TimePrefillTurnEnd(100));
   EXPECT_OK(benchmark_info.TimePrefillTurnStart());
   EXPECT_OK(benchmark_info.TimePrefillTurnEnd(200));
+  benchmark_info.AddPrefillPaddingTokens(56);
 
   EXPECT_OK(benchmark_info.TimeDecodeTurnStart());
   EXPECT_OK(benchmark_info.TimeDecodeTurnEnd(100));
@@ -669,6 +790,7 @@ TEST(BenchmarkInfoTests, OperatorOutputWithData) {
     - Load Model: .* ms
     - Load Tokenizer: .* ms
     Total init time: .* ms
+    Wall-clock init time: .* ms
 --------------------------------------------------
   Time to first token: .* s
 --------------------------------------------------
@@ -677,6 +799,7 @@ TEST(BenchmarkInfoTests, OperatorOutputWithData) {
       Prefill Speed: .* tokens/sec.
     Prefill Turn 2: Processed 200 tokens in .* duration.
       Prefill Speed: .* tokens/sec.
+    Prefill Padding: 56 tokens.
 --------------------------------------------------
   Decode Turns \(Total 1 turns\):
     Decode Turn 1: Processed 100 tokens in .* duration.
@@ -689,6 +812,18 @@ TEST(BenchmarkInfoTests, OperatorOutputWithData) {
 TEST(DecodeConfigTest, CreateDefault) {
   DecodeConfig decode_config = DecodeConfig::CreateDefault();
   EXPECT_EQ(decode_config.GetConstraint(), nullptr);
+  EXPECT_FALSE(decode_config.GetPromptLookupOptions().has_value());
+  EXPECT_FALSE(decode_config.GetStreamingCoalescingOptions().has_value());
+  EXPECT_FALSE(decode_config.GetCandidatePruningOptions().has_value());
+}
+
+TEST(DecodeConfigTest, SetAndGetTimeout) {
+  DecodeConfig decode_config = DecodeConfig::CreateDefault();
+  EXPECT_FALSE(decode_config.GetTimeout().has_value());
+  decode_config.SetTimeout(absl::Seconds(5));
+  EXPECT_EQ(decode_config.GetTimeout(), absl::Seconds(5));
+  decode_config.SetTimeout(std::nullopt);
+  EXPECT_FALSE(decode_config.GetTimeout().has_value());
 }
 
 TEST(DecodeConfigTest, SetAndGetConstraint) {
@@ -698,5 +833,55 @@ TEST(DecodeConfigTest, SetAndGetConstraint) {
   EXPECT_EQ(decode_config.GetConstraint(), &constraint);
 }
 
+TEST(DecodeConfigTest, SetAndGetPromptLookupOptions) {
+  DecodeConfig decode_config = DecodeConfig::CreateDefault();
+  DecodeConfig::PromptLookupOptions options;
+  options.max_ngram_size = 4;
+  options.max_num_draft_tokens = 5;
+  decode_config.SetPromptLookupOptions(options);
+  ASSERT_TRUE(decode_config.GetPromptLookupOptions().has_value());
+  EXPECT_EQ(decode_config.GetPromptLookupOptions()->min_ngram_size, 1);
+  EXPECT_EQ(decode_config.GetPromptLookupOptions()->max_ngram_size, 4);
+  EXPECT_EQ(decode_config.GetPromptLookupOptions()->max_num_draft_tokens, 5);
+
+  decode_config.SetPromptLookupOptions(std::nullopt);
+  EXPECT_FALSE(decode_config.GetPromptLookupOptions().has_value());
+}
+
+TEST(DecodeConfigTest, SetAndGetStreamingCoalescingOptions) {
+  DecodeConfig decode_config = DecodeConfig::CreateDefault();
+  DecodeConfig::StreamingCoalescingOptions options;
+  options.max_num_steps = 8;
+  options.boundary =
+      DecodeConfig::StreamingCoalescingOptions::Boundary::kSentence;
+  decode_config.SetStreamingCoalescingOptions(options);
+  ASSERT_TRUE(decode_config.GetStreamingCoalescingOptions().has_value());
+  EXPECT_EQ(decode_config.GetStreamingCoalescingOptions()->max_num_steps, 8);
+  EXPECT_EQ(decode_config.GetStreamingCoalescingOptions()->max_delay,
+            absl::ZeroDuration());
+  EXPECT_EQ(decode_config.GetStreamingCoalescingOptions()->boundary,
+            DecodeConfig::StreamingCoalescingOptions::Boundary::kSentence);
+
+  decode_config.SetStreamingCoalescingOptions(std::nullopt);
+  EXPECT_FALSE(decode_config.GetStreamingCoalescingOptions().has_value());
+}
+
+TEST(DecodeConfigTest, SetAndGetCandidatePruningOptions) {
+  DecodeConfig decode_config = DecodeConfig::CreateDefault();
+  DecodeConfig::CandidatePruningOptions options;
+  options.max_num_candidates = 2;
+  options.min_num_decode_steps = 16;
+  decode_config.SetCandidatePruningOptions(options);
+  ASSERT_TRUE(decode_config.GetCandidatePruningOptions().has_value());
+  EXPECT_EQ(decode_config.GetCandidatePruningOptions()->score_margin,
+            std::numeric_limits<float>::infinity());
+  EXPECT_EQ(decode_config.GetCandidatePruningOptions()->max_num_candidates, 2);
+  EXPECT_EQ(decode_config.GetCandidatePruningOptions()->min_num_decode_steps,
+            16);
+
+  decode_config.SetCandidatePruningOptions(std::nullopt);
+  EXPECT_FALSE(decode_config.GetCandidatePruningOptions().has_value());
+}
+
 }  // namespace
 }  // namespace litert::lm
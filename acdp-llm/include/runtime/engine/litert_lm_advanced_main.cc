@@ -43,6 +43,7 @@
 #include "runtime/engine/litert_lm_lib.h"
 #include "runtime/engine/shared_flags.h"
 #include "runtime/util/status_macros.h"
+#include "runtime/util/thread_affinity.h"
 
 ABSL_FLAG(std::string, backend, "gpu",
           "Executor backend to use for LLM execution (cpu, gpu, etc.)");
@@ -130,19 +131,34 @@ absl::Status MainHelper(int argc, char** argv) {
            "[--max_num_tokens=<max_num_tokens>] "
            "[--prefill_batch_sizes=<size1>[,<size2>,...]]"
            "[--vision_backend=<cpu|gpu>] [--audio_backend=<cpu|gpu>] "
-           "[--sampler_backend=<cpu|gpu>] [--benchmark] "
+           "[--sampler_backend=<cpu|gpu|auto>] [--benchmark] "
            "[--benchmark_prefill_tokens=<num_prefill_tokens>] "
            "[--benchmark_decode_tokens=<num_decode_tokens>] "
            "[--async=<true|false>] [--force_f32=<true|false] "
            "[--report_peak_memory_footprint] [--multi_turns=<true|false>] "
            "[--num_cpu_threads=<num_cpu_threads>] "
+           "[--cpu_affinity=<cpu_list>] [--numa_node=<numa_node>] "
            "[--gpu_external_tensor_mode=<true|false>] "
            "[--configure_magic_numbers=<true|false>] "
            "[--verify_magic_numbers=<true|false>] "
            "[--clear_kv_cache_before_prefill=<true|false>] "
            "[--num_logits_to_print_after_decode=<num_logits_to_print>]"
            "[--score_target_text=<target_text>]"
-           "[--gpu_madvise_original_shared_tensors=<true|false>]";
+           "[--gpu_madvise_original_shared_tensors=<true|false>]"
+           "[--tuning_profile=<profile_path>] [--autotune]"
+           "[--kv_cache_data_type=<float|int8|fp8>]"
+           "[--max_resident_memory_mb=<max_resident_memory_mb>]"
+           "[--num_warm_up_decode_steps=<num_warm_up_decode_steps>]"
+           "[--trace_file=<trace_file>]"
+           "[--benchmark_sweep=<dimension>=<v1>,<v2>;...] "
+           "[--benchmark_report=<report_path.json|report_path.csv>]"
+           "[--load_test=<key>=<value>;...]"
+           "[--decode_replay=<recording_path>] "
+           "[--replay_decode=<recording_path>] "
+           "[--benchmark_baseline=<baseline_path>] "
+           "[--benchmark_num_runs=<num_runs>] "
+           "[--benchmark_regression_threshold=<threshold>] "
+           "[--update_benchmark_baseline]";
     ABSL_LOG(INFO)
         << "To provide data for multimodality, use [image:/path/to/image.jpg] "
            "or [audio:/path/to/audio.wav] in the input prompt. e.g. \"Describe "
@@ -176,6 +192,10 @@ absl::Status MainHelper(int argc, char** argv) {
   settings.force_f32 = absl::GetFlag(FLAGS_force_f32);
   settings.multi_turns = absl::GetFlag(FLAGS_multi_turns);
   settings.num_cpu_threads = absl::GetFlag(FLAGS_num_cpu_threads);
+  ASSIGN_OR_RETURN(
+      settings.cpu_affinity,
+      litert::lm::ThreadAffinity::ParseCpuList(absl::GetFlag(FLAGS_cpu_affinity)));
+  settings.numa_node = absl::GetFlag(FLAGS_numa_node);
   settings.gpu_external_tensor_mode =
       absl::GetFlag(FLAGS_gpu_external_tensor_mode);
   settings.configure_magic_numbers =
@@ -189,6 +209,25 @@ absl::Status MainHelper(int argc, char** argv) {
   settings.gpu_madvise_original_shared_tensors =
       absl::GetFlag(FLAGS_gpu_madvise_original_shared_tensors);
   settings.disable_cache = absl::GetFlag(FLAGS_disable_cache);
+  settings.kv_cache_data_type = absl::GetFlag(FLAGS_kv_cache_data_type);
+  settings.max_resident_memory_mb =
+      absl::GetFlag(FLAGS_max_resident_memory_mb);
+  settings.num_warm_up_decode_steps =
+      absl::GetFlag(FLAGS_num_warm_up_decode_steps);
+  settings.tuning_profile_path = absl::GetFlag(FLAGS_tuning_profile);
+  settings.autotune = absl::GetFlag(FLAGS_autotune);
+  settings.trace_file = absl::GetFlag(FLAGS_trace_file);
+  settings.benchmark_sweep = absl::GetFlag(FLAGS_benchmark_sweep);
+  settings.benchmark_report_path = absl::GetFlag(FLAGS_benchmark_report);
+  settings.load_test = absl::GetFlag(FLAGS_load_test);
+  settings.decode_replay_path = absl::GetFlag(FLAGS_decode_replay);
+  settings.replay_decode = absl::GetFlag(FLAGS_replay_decode);
+  settings.benchmark_baseline_path = absl::GetFlag(FLAGS_benchmark_baseline);
+  settings.benchmark_num_runs = absl::GetFlag(FLAGS_benchmark_num_runs);
+  settings.benchmark_regression_threshold =
+      absl::GetFlag(FLAGS_benchmark_regression_threshold);
+  settings.update_benchmark_baseline =
+      absl::GetFlag(FLAGS_update_benchmark_baseline);
 
   // Adjust max_num_tokens and prefill_batch_size if not set on benchmark mode.
   if (settings.benchmark && settings.benchmark_prefill_tokens > 0) {
@@ -0,0 +1,117 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// ODML pipeline to evaluate an LLM on a dataset by log-likelihood.
+//
+// The pipeline does the following
+// 1) Read the model file path and the dataset, a JSON Lines file of
+//    {"prefix": ..., "target": ...} objects.
+// 2) Construct the engine with the setting.
+// 3) Score the targets of the dataset, and report the perplexity, the
+//    throughput and optionally the score of each example.
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "absl/base/log_severity.h"  // from @com_google_absl
+#include "absl/flags/flag.h"  // from @com_google_absl
+#include "absl/flags/parse.h"  // from @com_google_absl
+#include "absl/log/absl_check.h"  // from @com_google_absl
+#include "absl/log/globals.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "litert/c/internal/litert_logging.h"  // from @litert
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/eval_harness.h"
+#include "runtime/executor/executor_settings_base.h"
+#include "runtime/util/status_macros.h"
+
+ABSL_FLAG(std::string, backend, "gpu",
+          "Executor backend to use for LLM execution (cpu, gpu, etc.)");
+ABSL_FLAG(std::string, model_path, "", "Model path to use for LLM execution.");
+ABSL_FLAG(std::string, dataset_path, "",
+          "Path to the dataset, a JSON Lines file of {\"prefix\": ..., "
+          "\"target\": ...} objects. The examples sharing their prefix should "
+          "be consecutive to reuse its prefill.");
+ABSL_FLAG(int, max_batch_size, 16,
+          "Number of targets of the same prefix scored in one batch at most.");
+ABSL_FLAG(std::string, scores_path, "",
+          "If set, the score of each example is written to this file in the "
+          "JSON Lines format.");
+
+namespace {
+
+using ::litert::lm::Backend;
+using ::litert::lm::EngineSettings;
+using ::litert::lm::EvalHarnessConfig;
+using ::litert::lm::EvalReport;
+using ::litert::lm::ModelAssets;
+
+absl::Status MainHelper(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  // Overrides the default for FLAGS_minloglevel to error.
+  absl::SetMinLogLevel(absl::LogSeverityAtLeast::kError);
+  LiteRtSetMinLoggerSeverity(LiteRtGetDefaultLogger(), LITERT_SILENT);
+
+  const std::string model_path = absl::GetFlag(FLAGS_model_path);
+  if (model_path.empty()) {
+    return absl::InvalidArgumentError("Model path is empty.");
+  }
+  const std::string dataset_path = absl::GetFlag(FLAGS_dataset_path);
+  std::ifstream dataset(dataset_path);
+  if (!dataset.is_open()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Could not open the dataset ", dataset_path));
+  }
+  ASSIGN_OR_RETURN(ModelAssets model_assets,  // NOLINT
+                   ModelAssets::Create(model_path));
+  ASSIGN_OR_RETURN(Backend backend, litert::lm::GetBackendFromString(
+                                        absl::GetFlag(FLAGS_backend)));
+  ASSIGN_OR_RETURN(
+      EngineSettings engine_settings,
+      EngineSettings::CreateDefault(std::move(model_assets), backend));
+  ASSIGN_OR_RETURN(auto engine, litert::lm::Engine::CreateEngine(
+                                    std::move(engine_settings)));
+
+  EvalHarnessConfig config;
+  config.max_batch_size = absl::GetFlag(FLAGS_max_batch_size);
+  ASSIGN_OR_RETURN(
+      EvalReport report,
+      litert::lm::RunEvalHarness(
+          *engine, litert::lm::SessionConfig::CreateDefault(), dataset,
+          config));
+  std::cout << report;
+
+  const std::string scores_path = absl::GetFlag(FLAGS_scores_path);
+  if (!scores_path.empty()) {
+    std::ofstream scores(scores_path);
+    if (!scores.is_open()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Could not open ", scores_path));
+    }
+    litert::lm::WriteEvalExampleScores(report, scores);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ABSL_CHECK_OK(MainHelper(argc, argv));
+  return 0;
+}
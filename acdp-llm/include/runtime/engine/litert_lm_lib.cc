@@ -23,13 +23,18 @@
 
 #include "runtime/engine/litert_lm_lib.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>  // NOLINT
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <set>
 #include <sstream>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <variant>
 #include <vector>
@@ -46,12 +51,23 @@
 #include "nlohmann/json.hpp"  // from @nlohmann_json
 #include "runtime/conversation/conversation.h"
 #include "runtime/conversation/io_types.h"
+#include "runtime/core/decode_replay_recorder.h"
+#include "runtime/engine/benchmark_baseline.h"
+#include "runtime/engine/benchmark_sweep.h"
+#include "runtime/engine/decode_replay.h"
 #include "runtime/engine/engine.h"
 #include "runtime/engine/engine_settings.h"
 #include "runtime/engine/io_types.h"
+#include "runtime/engine/load_generator.h"
+#include "runtime/engine/tuning_profile.h"
 #include "runtime/executor/executor_settings_base.h"
 #include "runtime/executor/llm_executor_settings.h"
+#include "runtime/proto/decode_replay.pb.h"
+#include "runtime/util/latency_histogram.h"
+#include "runtime/util/model_cache.h"
+#include "runtime/util/scoped_file.h"
 #include "runtime/util/status_macros.h"  // IWYU pragma: keep
+#include "runtime/util/trace_recorder.h"
 #include "re2/re2.h"  // from @com_googlesource_code_re2
 #include "tflite/profiling/memory_info.h"  // from @litert
 #include "tflite/profiling/memory_usage_monitor.h"  // from @litert
@@ -74,14 +90,29 @@ using ::nlohmann::json;
 constexpr int kMemoryCheckIntervalMs = 50;
 // Timeout duration for waiting until the engine is done with all the tasks.
 const absl::Duration kWaitUntilDoneTimeout = absl::Minutes(10);
+// The numbers of tokens of the calibration runs of the autotuning, short
+// enough to keep the tuning within minutes.
+constexpr int kTuningPrefillTokens = 256;
+constexpr int kTuningDecodeTokens = 32;
+// The prefill batch sizes tried by the autotuning.
+constexpr int kTuningPrefillBatchSizes[] = {64, 128, 256, 512, 1024};
+// The sampler backend of the sessions picking, from the measured costs, the
+// faster of the sampler of the executor and a CPU sampler.
+constexpr absl::string_view kAutoSamplerBackend = "auto";
 
 namespace {
 
+// Returns `bytes` in MB, for the memory reports.
+double BytesToMb(int64_t bytes) {
+  return static_cast<double>(bytes) / (1024 * 1024);
+}
+
 // Helper to process the sampler backend string and return a sampler backend
 // if possible. Otherwise, return std::nullopt.
 std::optional<Backend> GetSamplerBackend(const LiteRtLmSettings& settings) {
   const std::string& sampler_backend_str = settings.sampler_backend;
-  if (sampler_backend_str.empty()) {
+  if (sampler_backend_str.empty() ||
+      sampler_backend_str == kAutoSamplerBackend) {
     return std::nullopt;
   }
   const absl::StatusOr<Backend> sampler_backend =
@@ -133,9 +164,22 @@ absl::StatusOr<EngineSettings> CreateEngineSettings(
     engine_settings.GetMutableMainExecutorSettings().SetActivationDataType(
         litert::lm::ActivationDataType::FLOAT32);
   }
+  if (settings.kv_cache_data_type == "int8") {
+    engine_settings.SetKvCacheDataType(KvCacheDataType::kInt8);
+  } else if (settings.kv_cache_data_type == "fp8") {
+    engine_settings.SetKvCacheDataType(KvCacheDataType::kFp8);
+  } else if (settings.kv_cache_data_type != "float") {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Invalid kv-cache data type: ", settings.kv_cache_data_type));
+  }
   if (settings.disable_cache) {
     engine_settings.GetMutableMainExecutorSettings().SetCacheDir(":nocache");
   }
+  engine_settings.SetNumWarmUpDecodeSteps(settings.num_warm_up_decode_steps);
+  if (settings.max_resident_memory_mb > 0) {
+    engine_settings.SetMaxResidentMemoryBytes(
+        static_cast<size_t>(settings.max_resident_memory_mb) * 1024 * 1024);
+  }
   if (backend == Backend::CPU && settings.num_cpu_threads > 0) {
     auto& executor_settings = engine_settings.GetMutableMainExecutorSettings();
     ASSIGN_OR_RETURN(
@@ -144,6 +188,12 @@ absl::StatusOr<EngineSettings> CreateEngineSettings(
     cpu_settings.number_of_threads = settings.num_cpu_threads;
     executor_settings.SetBackendConfig(cpu_settings);
   }
+  if (!settings.cpu_affinity.empty()) {
+    engine_settings.SetCpuAffinity(settings.cpu_affinity);
+  }
+  if (settings.numa_node >= 0) {
+    engine_settings.SetNumaNode(settings.numa_node);
+  }
   if (backend == Backend::GPU) {
     auto& executor_settings = engine_settings.GetMutableMainExecutorSettings();
     ASSIGN_OR_RETURN(
@@ -210,10 +260,13 @@ SessionConfig CreateSessionConfig(const LiteRtLmSettings& settings) {
   // Set the session config.
   auto session_config = litert::lm::SessionConfig::CreateDefault();
   session_config.SetNumOutputCandidates(settings.num_output_candidates);
+  session_config.SetDecodeReplayPath(settings.decode_replay_path);
   const std::optional<Backend> sampler_backend = GetSamplerBackend(settings);
   if (sampler_backend.has_value()) {
     session_config.SetSamplerBackend(*sampler_backend);
   }
+  session_config.SetAutoSelectSamplerBackend(settings.sampler_backend ==
+                                             kAutoSamplerBackend);
   return session_config;
 }
 
@@ -368,6 +421,14 @@ absl::Status RunMultiTurnConversation(const LiteRtLmSettings& settings,
                                       Conversation* conversation) {
   std::string input_prompt;
   std::stringstream captured_output;
+  // The resident memory after the previous turn, to tell the growth of the
+  // conversation over its turns.
+  size_t last_resident_bytes = 0;
+  if (auto usage = engine->GetMemoryUsage();
+      settings.report_peak_memory_footprint && usage.ok()) {
+    last_resident_bytes = usage->resident_bytes;
+  }
+  int num_turns = 0;
   do {
     std::cout << "Please enter the prompt (or press Enter to end): ";
     std::getline(std::cin, input_prompt);
@@ -398,6 +459,18 @@ absl::Status RunMultiTurnConversation(const LiteRtLmSettings& settings,
       RETURN_IF_ERROR(PrintJsonMessage(std::get<JsonMessage>(model_message),
                                        captured_output));
     }
+    ++num_turns;
+    if (settings.report_peak_memory_footprint) {
+      if (auto usage = engine->GetMemoryUsage(); usage.ok()) {
+        const int64_t growth_bytes =
+            static_cast<int64_t>(usage->resident_bytes) -
+            static_cast<int64_t>(last_resident_bytes);
+        ABSL_LOG(INFO) << "Resident memory after turn " << num_turns << ": "
+                       << BytesToMb(usage->resident_bytes) << "MB, "
+                       << BytesToMb(growth_bytes) << "MB over the turn.";
+        last_resident_bytes = usage->resident_bytes;
+      }
+    }
   } while (true);
   CheckExpectedOutput(captured_output.str(), settings);
   return absl::OkStatus();
@@ -409,7 +482,7 @@ void RunScoreText(litert::lm::Engine* llm, litert::lm::Engine::Session* session,
   inputs.emplace_back(InputText(input_prompt));
   std::vector<absl::string_view> target_text_vector;
   target_text_vector.push_back(target_text);
-  ABSL_CHECK_OK(session->RunPrefill(inputs));
+  ABSL_CHECK_OK(session->RunPrefill(std::move(inputs)));
   auto response = session->RunTextScoring(target_text_vector);
   ABSL_CHECK_OK(response);
   if (response->GetScores().empty()) {
@@ -419,9 +492,413 @@ void RunScoreText(litert::lm::Engine* llm, litert::lm::Engine::Session* session,
   }
 }
 
+// Runs a calibration prefill and decode with `num_cpu_threads` and
+// `prefill_batch_sizes`, and returns them with the measured throughputs.
+absl::StatusOr<TunedConfig> MeasureConfig(const LiteRtLmSettings& settings,
+                                          int num_cpu_threads,
+                                          std::set<int> prefill_batch_sizes) {
+  LiteRtLmSettings calibration_settings = settings;
+  calibration_settings.num_cpu_threads = num_cpu_threads;
+  calibration_settings.prefill_batch_sizes = prefill_batch_sizes;
+  calibration_settings.benchmark = true;
+  calibration_settings.benchmark_prefill_tokens = kTuningPrefillTokens;
+  calibration_settings.benchmark_decode_tokens = kTuningDecodeTokens;
+  calibration_settings.multi_turns = false;
+  ASSIGN_OR_RETURN(EngineSettings engine_settings,
+                   CreateEngineSettings(calibration_settings));
+  ASSIGN_OR_RETURN(auto engine, Engine::CreateEngine(std::move(engine_settings),
+                                                     settings.input_prompt));
+  ASSIGN_OR_RETURN(auto session,
+                   engine->CreateSession(CreateSessionConfig(settings)));
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText(settings.input_prompt));
+  RETURN_IF_ERROR(session->RunPrefill(std::move(inputs)));
+  RETURN_IF_ERROR(session->RunDecode().status());
+  ASSIGN_OR_RETURN(auto benchmark_info, session->GetBenchmarkInfo());
+  if (benchmark_info.GetTotalPrefillTurns() == 0 ||
+      benchmark_info.GetTotalDecodeTurns() == 0) {
+    return absl::InternalError("The calibration run was not measured.");
+  }
+
+  TunedConfig config;
+  config.num_cpu_threads = num_cpu_threads;
+  config.prefill_batch_sizes = std::move(prefill_batch_sizes);
+  config.prefill_tokens_per_sec = benchmark_info.GetPrefillTokensPerSec(0);
+  config.decode_tokens_per_sec = benchmark_info.GetDecodeTokensPerSec(0);
+  ABSL_LOG(INFO) << "Calibration with " << num_cpu_threads
+                 << " cpu threads and prefill batch size "
+                 << (config.prefill_batch_sizes.empty()
+                         ? 0
+                         : *config.prefill_batch_sizes.rbegin())
+                 << ": prefill " << config.prefill_tokens_per_sec
+                 << " tokens/s, decode " << config.decode_tokens_per_sec
+                 << " tokens/s";
+  return config;
+}
+
+// Returns the time a calibration run would take with `config`, the lower the
+// better, so that neither the prefill nor the decode throughput alone decides.
+double GetEstimatedSeconds(const TunedConfig& config) {
+  if (config.prefill_tokens_per_sec <= 0 || config.decode_tokens_per_sec <= 0) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return kTuningPrefillTokens / config.prefill_tokens_per_sec +
+         kTuningDecodeTokens / config.decode_tokens_per_sec;
+}
+
+// Measures the candidate cpu thread counts, then the candidate prefill batch
+// sizes with the best thread count, then, on the other backends, a CPU sampler
+// against the sampler of the executor unless the sampler backend is set, and
+// returns the fastest configuration. The candidates failing to run, e.g. a
+// prefill batch size the model does not support, are skipped.
+absl::StatusOr<TunedConfig> Autotune(const LiteRtLmSettings& settings,
+                                     Backend backend) {
+  LiteRtLmSettings tuning_settings = settings;
+  const bool tune_sampler_backend =
+      backend != Backend::CPU &&
+      (settings.sampler_backend.empty() ||
+       settings.sampler_backend == kAutoSamplerBackend);
+  if (tune_sampler_backend) {
+    // Measures the sampler of the executor alone first.
+    tuning_settings.sampler_backend.clear();
+  }
+  std::optional<TunedConfig> best;
+  auto try_config = [&](int num_cpu_threads, std::set<int> prefill_sizes) {
+    absl::StatusOr<TunedConfig> config = MeasureConfig(
+        tuning_settings, num_cpu_threads, std::move(prefill_sizes));
+    if (!config.ok()) {
+      ABSL_LOG(WARNING) << "Skipping the calibration candidate: "
+                        << config.status();
+      return;
+    }
+    if (!best.has_value() ||
+        GetEstimatedSeconds(*config) < GetEstimatedSeconds(*best)) {
+      best = *std::move(config);
+    }
+  };
+
+  if (backend == Backend::CPU) {
+    const int num_cpus =
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::set<int> thread_counts = {num_cpus};
+    for (int num_threads = 1; num_threads < num_cpus; num_threads *= 2) {
+      thread_counts.insert(num_threads);
+    }
+    for (int num_threads : thread_counts) {
+      try_config(num_threads, settings.prefill_batch_sizes);
+    }
+  } else {
+    try_config(/*num_cpu_threads=*/0, settings.prefill_batch_sizes);
+  }
+  if (!best.has_value()) {
+    return absl::InternalError("None of the calibration runs succeeded.");
+  }
+  const int num_cpu_threads = best->num_cpu_threads;
+  for (int prefill_size : kTuningPrefillBatchSizes) {
+    if (settings.max_num_tokens > 0 && prefill_size > settings.max_num_tokens) {
+      continue;
+    }
+    try_config(num_cpu_threads, {prefill_size});
+  }
+  if (tune_sampler_backend) {
+    // Keeps the faster of the two samplers, the prefill being the same.
+    tuning_settings.sampler_backend = "cpu";
+    absl::StatusOr<TunedConfig> config = MeasureConfig(
+        tuning_settings, best->num_cpu_threads, best->prefill_batch_sizes);
+    if (!config.ok()) {
+      ABSL_LOG(WARNING) << "Skipping the calibration of the cpu sampler: "
+                        << config.status();
+    } else if (config->decode_tokens_per_sec > best->decode_tokens_per_sec) {
+      best = *std::move(config);
+      best->sampler_backend = "cpu";
+    } else {
+      best->sampler_backend = settings.backend;
+    }
+  }
+  return *best;
+}
+
+// Returns `settings` with the configuration tuned for the model and backend
+// from the tuning profile, tuning it first if asked to or if the profile does
+// not have it yet with the autotuning on. The values set explicitly in
+// `settings` take precedence over the tuned ones.
+absl::StatusOr<LiteRtLmSettings> ApplyTuningProfile(
+    const LiteRtLmSettings& settings) {
+  ASSIGN_OR_RETURN(Backend backend, GetBackendFromString(settings.backend));
+  ASSIGN_OR_RETURN(auto model_file, ScopedFile::Open(settings.model_path));
+  ASSIGN_OR_RETURN(std::string fingerprint,
+                   ComputeModelFingerprint(model_file));
+  const std::string key = TuningProfile::GetKey(fingerprint, settings.backend);
+  ASSIGN_OR_RETURN(TuningProfile profile,
+                   TuningProfile::Load(settings.tuning_profile_path));
+
+  std::optional<TunedConfig> config;
+  if (settings.autotune) {
+    ABSL_LOG(INFO) << "Autotuning " << key;
+    ASSIGN_OR_RETURN(config, Autotune(settings, backend));
+    profile.Set(key, *config);
+    RETURN_IF_ERROR(profile.Save(settings.tuning_profile_path));
+  } else {
+    config = profile.Find(key);
+    if (!config.has_value()) {
+      ABSL_LOG(INFO) << "No tuned configuration for " << key
+                     << ", run with --autotune to tune it.";
+      return settings;
+    }
+  }
+  ABSL_LOG(INFO) << "Tuned configuration of " << key << ": "
+                 << config->num_cpu_threads << " cpu threads, prefill "
+                 << config->prefill_tokens_per_sec << " tokens/s, decode "
+                 << config->decode_tokens_per_sec << " tokens/s"
+                 << (config->sampler_backend.empty()
+                         ? ""
+                         : ", sampler backend " + config->sampler_backend);
+
+  LiteRtLmSettings tuned_settings = settings;
+  if (tuned_settings.num_cpu_threads == 0) {
+    tuned_settings.num_cpu_threads = config->num_cpu_threads;
+  }
+  if (tuned_settings.prefill_batch_sizes.empty()) {
+    tuned_settings.prefill_batch_sizes = config->prefill_batch_sizes;
+  }
+  // The tuned sampler backend spares the sessions measuring it themselves.
+  if ((tuned_settings.sampler_backend.empty() ||
+       tuned_settings.sampler_backend == kAutoSamplerBackend) &&
+      !config->sampler_backend.empty()) {
+    tuned_settings.sampler_backend = config->sampler_backend;
+  }
+  return tuned_settings;
+}
+
+// Measures the point of `result` with a new session of `engine`, and records
+// the measurements in `result`.
+absl::Status MeasureSweepPoint(const LiteRtLmSettings& settings,
+                               Engine* engine,
+                               BenchmarkSweepResult& result) {
+  SessionConfig session_config = CreateSessionConfig(settings);
+  session_config.SetNumOutputCandidates(result.point.num_output_candidates);
+  proto::BenchmarkParams benchmark_params;
+  benchmark_params.set_num_prefill_tokens(result.point.prefill_tokens);
+  benchmark_params.set_num_decode_tokens(result.point.decode_tokens);
+  session_config.SetBenchmarkParams(benchmark_params);
+  ASSIGN_OR_RETURN(auto session, engine->CreateSession(session_config));
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText(settings.input_prompt));
+  RETURN_IF_ERROR(session->RunPrefill(std::move(inputs)));
+  RETURN_IF_ERROR(session->RunDecode().status());
+  ASSIGN_OR_RETURN(auto benchmark_info, session->GetBenchmarkInfo());
+  if (benchmark_info.GetTotalPrefillTurns() == 0 ||
+      benchmark_info.GetTotalDecodeTurns() == 0) {
+    return absl::InternalError("The benchmark run was not measured.");
+  }
+  result.time_to_first_token_seconds = benchmark_info.GetTimeToFirstToken();
+  result.prefill_tokens_per_sec = benchmark_info.GetPrefillTokensPerSec(0);
+  result.decode_tokens_per_sec = benchmark_info.GetDecodeTokensPerSec(0);
+  const LatencyHistogram& inter_token =
+      benchmark_info.GetDecodeLatencyHistograms().inter_token;
+  result.inter_token_p50_ms =
+      absl::ToDoubleMilliseconds(inter_token.GetPercentile(50));
+  result.inter_token_p99_ms =
+      absl::ToDoubleMilliseconds(inter_token.GetPercentile(99));
+  return absl::OkStatus();
+}
+
+// Measures every combination of the values of `settings.benchmark_sweep` in
+// this process, creating an engine only for the points which do not share the
+// engine of the previous point, and writes the report.
+absl::Status RunBenchmarkSweep(const LiteRtLmSettings& settings) {
+  if (settings.benchmark_report_path.empty()) {
+    return absl::InvalidArgumentError(
+        "The benchmark sweep requires a benchmark report path.");
+  }
+  BenchmarkSweepConfig defaults{
+      .backends = {settings.backend},
+      .num_cpu_threads = {settings.num_cpu_threads},
+      .prefill_batch_sizes = {settings.prefill_batch_sizes.empty()
+                                  ? 0
+                                  : *settings.prefill_batch_sizes.rbegin()},
+      .num_output_candidates = {settings.num_output_candidates},
+      .prefill_tokens = {settings.benchmark_prefill_tokens},
+      .decode_tokens = {settings.benchmark_decode_tokens},
+  };
+  ASSIGN_OR_RETURN(
+      BenchmarkSweepConfig config,
+      ParseBenchmarkSweepConfig(settings.benchmark_sweep, std::move(defaults)));
+  const std::vector<BenchmarkSweepPoint> points =
+      GetBenchmarkSweepPoints(config);
+  ABSL_LOG(INFO) << "Benchmarking " << points.size() << " configurations";
+
+  std::vector<BenchmarkSweepResult> results;
+  std::unique_ptr<Engine> engine;
+  absl::Status engine_status;
+  double init_seconds = 0;
+  // The engines fit the longest run of the sweep unless set otherwise.
+  int max_num_tokens = settings.max_num_tokens;
+  if (max_num_tokens == 0) {
+    max_num_tokens =
+        *std::max_element(config.prefill_tokens.begin(),
+                          config.prefill_tokens.end()) +
+        *std::max_element(config.decode_tokens.begin(),
+                          config.decode_tokens.end());
+  }
+  for (size_t i = 0; i < points.size(); ++i) {
+    const BenchmarkSweepPoint& point = points[i];
+    LiteRtLmSettings point_settings = settings;
+    point_settings.backend = point.backend;
+    point_settings.num_cpu_threads = point.num_cpu_threads;
+    if (point.prefill_batch_size > 0) {
+      point_settings.prefill_batch_sizes = {point.prefill_batch_size};
+    }
+    point_settings.num_output_candidates = point.num_output_candidates;
+    point_settings.benchmark = true;
+    point_settings.benchmark_prefill_tokens = point.prefill_tokens;
+    point_settings.benchmark_decode_tokens = point.decode_tokens;
+    point_settings.multi_turns = false;
+    point_settings.max_num_tokens = max_num_tokens;
+
+    if (i == 0 || !point.SharesEngineWith(points[i - 1])) {
+      // Release the previous engine before loading the model again.
+      engine.reset();
+      const absl::Time start_time = absl::Now();
+      absl::StatusOr<std::unique_ptr<Engine>> new_engine =
+          [&]() -> absl::StatusOr<std::unique_ptr<Engine>> {
+        ASSIGN_OR_RETURN(EngineSettings engine_settings,
+                         CreateEngineSettings(point_settings));
+        return Engine::CreateEngine(std::move(engine_settings),
+                                    settings.input_prompt);
+      }();
+      init_seconds = absl::ToDoubleSeconds(absl::Now() - start_time);
+      engine_status = new_engine.status();
+      if (new_engine.ok()) {
+        engine = *std::move(new_engine);
+      }
+    }
+
+    BenchmarkSweepResult& result = results.emplace_back();
+    result.point = point;
+    result.init_seconds = init_seconds;
+    result.status =
+        engine_status.ok()
+            ? MeasureSweepPoint(point_settings, engine.get(), result)
+            : engine_status;
+    if (!result.status.ok()) {
+      ABSL_LOG(WARNING) << "Benchmark of " << point.backend << " with "
+                        << point.prefill_tokens << " prefill and "
+                        << point.decode_tokens
+                        << " decode tokens failed: " << result.status;
+      continue;
+    }
+    ABSL_LOG(INFO) << "Benchmark of " << point.backend << " with "
+                   << point.num_cpu_threads << " cpu threads, prefill batch "
+                   << point.prefill_batch_size << ", "
+                   << point.num_output_candidates << " candidates, "
+                   << point.prefill_tokens << " prefill and "
+                   << point.decode_tokens << " decode tokens: prefill "
+                   << result.prefill_tokens_per_sec << " tokens/s, decode "
+                   << result.decode_tokens_per_sec << " tokens/s";
+  }
+  engine.reset();
+
+  RETURN_IF_ERROR(
+      WriteBenchmarkSweepReport(settings.benchmark_report_path, results));
+  ABSL_LOG(INFO) << "Wrote the benchmark report to "
+                 << settings.benchmark_report_path;
+  return absl::OkStatus();
+}
+
+// Runs the benchmark of `settings` with a new engine, and returns the
+// throughputs, the time to first token and the peak memory of the process
+// over the run, including the engine creation.
+absl::StatusOr<BenchmarkMetrics> MeasureBenchmarkRun(
+    const LiteRtLmSettings& settings) {
+  tflite::profiling::memory::MemoryUsageMonitor mem_monitor(
+      kMemoryCheckIntervalMs);
+  mem_monitor.Start();
+  ASSIGN_OR_RETURN(EngineSettings engine_settings,
+                   CreateEngineSettings(settings));
+  ASSIGN_OR_RETURN(auto engine, Engine::CreateEngine(std::move(engine_settings),
+                                                     settings.input_prompt));
+  ASSIGN_OR_RETURN(auto session,
+                   engine->CreateSession(CreateSessionConfig(settings)));
+  std::vector<InputData> inputs;
+  inputs.emplace_back(InputText(settings.input_prompt));
+  RETURN_IF_ERROR(session->RunPrefill(std::move(inputs)));
+  RETURN_IF_ERROR(session->RunDecode().status());
+  ASSIGN_OR_RETURN(auto benchmark_info, session->GetBenchmarkInfo());
+  mem_monitor.Stop();
+  if (benchmark_info.GetTotalPrefillTurns() == 0 ||
+      benchmark_info.GetTotalDecodeTurns() == 0) {
+    return absl::InternalError("The benchmark run was not measured.");
+  }
+  return BenchmarkMetrics{
+      .prefill_tokens_per_sec = benchmark_info.GetPrefillTokensPerSec(0),
+      .decode_tokens_per_sec = benchmark_info.GetDecodeTokensPerSec(0),
+      .time_to_first_token_seconds = benchmark_info.GetTimeToFirstToken(),
+      .peak_memory_mb = mem_monitor.GetPeakMemUsageInMB()};
+}
+
+// Runs the benchmark of `settings` several times, and compares the runs with
+// the baseline, failing on a regression, or writes them as the new baseline.
+absl::Status RunBenchmarkRegressionGate(const LiteRtLmSettings& settings) {
+  if (settings.benchmark_num_runs <= 0) {
+    return absl::InvalidArgumentError(
+        "The benchmark regression gate requires at least one run.");
+  }
+  LiteRtLmSettings run_settings = settings;
+  run_settings.benchmark = true;
+  run_settings.multi_turns = false;
+  std::vector<BenchmarkMetrics> runs;
+  for (int i = 0; i < settings.benchmark_num_runs; ++i) {
+    ASSIGN_OR_RETURN(BenchmarkMetrics run, MeasureBenchmarkRun(run_settings));
+    ABSL_LOG(INFO) << "Benchmark run " << i + 1 << "/"
+                   << settings.benchmark_num_runs << ": prefill "
+                   << run.prefill_tokens_per_sec << " tokens/s, decode "
+                   << run.decode_tokens_per_sec << " tokens/s, time to first "
+                   << "token " << run.time_to_first_token_seconds
+                   << "s, peak memory " << run.peak_memory_mb << "MB";
+    runs.push_back(run);
+  }
+  const BenchmarkRunSummary summary = SummarizeBenchmarkRuns(runs);
+
+  if (settings.update_benchmark_baseline) {
+    RETURN_IF_ERROR(
+        SaveBenchmarkBaseline(settings.benchmark_baseline_path, summary));
+    ABSL_LOG(INFO) << "Wrote the benchmark baseline to "
+                   << settings.benchmark_baseline_path;
+    return absl::OkStatus();
+  }
+  ASSIGN_OR_RETURN(BenchmarkRunSummary baseline,
+                   LoadBenchmarkBaseline(settings.benchmark_baseline_path));
+  const std::vector<BenchmarkMetricComparison> comparisons =
+      CompareBenchmarkToBaseline(baseline, summary,
+                                 settings.benchmark_regression_threshold);
+  ABSL_LOG(INFO) << "Benchmark against the baseline "
+                 << settings.benchmark_baseline_path << ":\n"
+                 << FormatBenchmarkComparison(comparisons);
+  return CheckBenchmarkComparison(comparisons);
+}
+
 }  // namespace
 
 absl::Status RunLiteRtLm(const LiteRtLmSettings& settings) {
+  if (settings.autotune && settings.tuning_profile_path.empty()) {
+    return absl::InvalidArgumentError(
+        "The autotuning requires a tuning profile path.");
+  }
+  if (!settings.tuning_profile_path.empty()) {
+    ASSIGN_OR_RETURN(LiteRtLmSettings tuned_settings,
+                     ApplyTuningProfile(settings));
+    // The profile is applied, run with the tuned settings.
+    tuned_settings.autotune = false;
+    tuned_settings.tuning_profile_path.clear();
+    return RunLiteRtLm(tuned_settings);
+  }
+  if (!settings.benchmark_sweep.empty()) {
+    return RunBenchmarkSweep(settings);
+  }
+  if (!settings.benchmark_baseline_path.empty()) {
+    return RunBenchmarkRegressionGate(settings);
+  }
 
   std::unique_ptr<tflite::profiling::memory::MemoryUsageMonitor> mem_monitor;
   if (settings.report_peak_memory_footprint) {
@@ -431,6 +908,10 @@ absl::Status RunLiteRtLm(const LiteRtLmSettings& settings) {
     mem_monitor->Start();
   }
 
+  if (!settings.trace_file.empty()) {
+    TraceRecorder::GetDefault().Start();
+  }
+
   // Get the engine settings and create the engine.
   ASSIGN_OR_RETURN(EngineSettings engine_settings,
                    CreateEngineSettings(settings));
@@ -438,6 +919,15 @@ absl::Status RunLiteRtLm(const LiteRtLmSettings& settings) {
   ASSIGN_OR_RETURN(auto engine,
                    litert::lm::Engine::CreateEngine(std::move(engine_settings),
                                                     settings.input_prompt));
+  if (settings.report_peak_memory_footprint) {
+    if (auto usage = engine->GetMemoryUsage(); usage.ok()) {
+      for (const auto& phase : usage->creation_phases) {
+        ABSL_LOG(INFO) << "Resident memory of the engine creation phase "
+                       << phase.name << ": "
+                       << BytesToMb(phase.resident_bytes_growth) << "MB.";
+      }
+    }
+  }
   // Get the session config.
   const SessionConfig session_config = CreateSessionConfig(settings);
 
@@ -446,7 +936,23 @@ absl::Status RunLiteRtLm(const LiteRtLmSettings& settings) {
   // scoring. Otherwise, we will create a Conversation.
   std::unique_ptr<Engine::Session> session;
   std::unique_ptr<Conversation> conversation;
-  if (settings.score_target_text.has_value() &&
+  if (!settings.load_test.empty()) {
+    ASSIGN_OR_RETURN(
+        LoadGeneratorConfig load_config,
+        ParseLoadGeneratorConfig(settings.load_test, LoadGeneratorConfig()));
+    ABSL_LOG(INFO) << "Running the load test";
+    ASSIGN_OR_RETURN(LoadGeneratorReport report,
+                     RunLoadGenerator(*engine, session_config, load_config));
+    ABSL_LOG(INFO) << report;
+  } else if (!settings.replay_decode.empty()) {
+    ASSIGN_OR_RETURN(proto::DecodeReplay recording,
+                     DecodeReplayRecorder::Load(settings.replay_decode));
+    ABSL_LOG(INFO) << "Replaying " << recording.turns_size() << " turns from "
+                   << settings.replay_decode;
+    ASSIGN_OR_RETURN(DecodeReplayReport report,
+                     ReplayDecodeRecording(*engine, session_config, recording));
+    ABSL_LOG(INFO) << report;
+  } else if (settings.score_target_text.has_value() &&
       !settings.score_target_text->empty()) {
     ABSL_LOG(INFO) << "Creating session";
     ASSIGN_OR_RETURN(auto session, engine->CreateSession(session_config));
@@ -471,7 +977,8 @@ absl::Status RunLiteRtLm(const LiteRtLmSettings& settings) {
     }
   }
 
-  if (settings.benchmark) {
+  if (settings.benchmark && settings.load_test.empty() &&
+      settings.replay_decode.empty()) {
     auto benchmark_info = conversation ? conversation->GetBenchmarkInfo()
                                        : session->GetBenchmarkInfo();
     ABSL_LOG(INFO) << *benchmark_info;
@@ -482,6 +989,14 @@ absl::Status RunLiteRtLm(const LiteRtLmSettings& settings) {
   conversation.reset();
   session.reset();
 
+  if (!settings.trace_file.empty()) {
+    TraceRecorder::GetDefault().Stop();
+    RETURN_IF_ERROR(
+        TraceRecorder::GetDefault().WriteChromeJson(settings.trace_file));
+    ABSL_LOG(INFO) << "Wrote " << TraceRecorder::GetDefault().GetNumEvents()
+                   << " trace events to " << settings.trace_file;
+  }
+
   if (settings.report_peak_memory_footprint) {
     float peak_mem_mb = 0.0f;
     float peak_private_mb = 0.0f;
@@ -494,6 +1009,36 @@ absl::Status RunLiteRtLm(const LiteRtLmSettings& settings) {
     ABSL_LOG(INFO) << "Memory usage: "
                    << tflite::profiling::memory::GetMemoryUsage();
     ABSL_LOG(INFO) << "Peak private footprint: " << peak_private_mb << "MB.";
+    if (auto stats = engine->GetMemorySheddingStats(); stats.ok()) {
+      ABSL_LOG(INFO) << "Memory shedding: "
+                     << stats->num_memory_limit_exceeded
+                     << " times over the limit, "
+                     << stats->num_memory_pressure_signals
+                     << " pressure signals, "
+                     << stats->prefix_cache_bytes_dropped
+                     << " prefix cache bytes, "
+                     << stats->embedding_cache_bytes_dropped
+                     << " embedding cache bytes, "
+                     << stats->num_token_id_cache_entries_dropped
+                     << " token id cache entries and "
+                     << stats->num_executors_evicted
+                     << " executors dropped.";
+    }
+    if (auto usage = engine->GetMemoryUsage(); usage.ok()) {
+      ABSL_LOG(INFO) << "Engine memory: " << BytesToMb(usage->resident_bytes)
+                     << "MB resident, kv-cache "
+                     << BytesToMb(usage->kv_cache_bytes) << "MB, prefix cache "
+                     << BytesToMb(usage->prefix_cache_bytes)
+                     << "MB, embedding cache "
+                     << BytesToMb(usage->embedding_cache_bytes)
+                     << "MB, LoRA adapters "
+                     << BytesToMb(usage->lora_adapter_bytes)
+                     << "MB, vision executor "
+                     << (usage->vision_executor_loaded ? "loaded" : "unloaded")
+                     << ", audio executor "
+                     << (usage->audio_executor_loaded ? "loaded" : "unloaded")
+                     << ".";
+    }
   }
 
   return absl::OkStatus();
@@ -18,6 +18,7 @@
 #include <optional>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/status/status.h"  // from @com_google_absl
 
@@ -43,6 +44,10 @@ struct LiteRtLmSettings {
   bool force_f32 = false;
   bool multi_turns = false;
   int num_cpu_threads = 0;
+  // The cpus and the NUMA node the engine threads are bound to, see
+  // EngineSettings::SetCpuAffinity() and EngineSettings::SetNumaNode().
+  std::vector<int> cpu_affinity;
+  int numa_node = -1;
   // Set external tensor mode false by default since it runs slightly faster
   // during decode as the layout changes optimized for GPU inference is done by
   // GPU, not by CPU.
@@ -54,6 +59,50 @@ struct LiteRtLmSettings {
   std::optional<std::string> score_target_text = std::nullopt;
   bool gpu_madvise_original_shared_tensors = true;
   bool disable_cache = false;
+  // The type the kv-cache is stored as: "float", "int8" or "fp8".
+  std::string kv_cache_data_type = "float";
+  // The resident memory above which the engine sheds its caches and idle
+  // executors. 0 for no limit.
+  int max_resident_memory_mb = 0;
+  // The number of decode steps of the warm-up run at the engine creation,
+  // after a prefill of the input prompt. 0 disables the warm-up.
+  int num_warm_up_decode_steps = 0;
+  // The JSON file of the configurations tuned per model and device, see
+  // TuningProfile. The configuration of the model is applied to the settings
+  // left at their defaults, and tuned first if `autotune` is set.
+  std::string tuning_profile_path;
+  bool autotune = false;
+  // If not empty, the file the execution trace is written to, in the Chrome
+  // JSON trace format.
+  std::string trace_file;
+  // If not empty, the values to benchmark every combination of, see
+  // ParseBenchmarkSweepConfig(), e.g. "backend=cpu;prefill_tokens=128,1024".
+  // The dimensions left out take the values of the settings above. The report
+  // is written to `benchmark_report_path`, as CSV if it ends with ".csv" and as
+  // JSON otherwise.
+  std::string benchmark_sweep;
+  std::string benchmark_report_path;
+  // If not empty, the load to drive the engine with instead of the input
+  // prompt, see ParseLoadGeneratorConfig(), e.g.
+  // "sessions=8;requests=64;arrival_rate=4;prompt_words=32-512".
+  std::string load_test;
+  // If not empty, the file the prefill and decode turns of the session are
+  // recorded to, see SessionConfig::SetDecodeReplayPath().
+  std::string decode_replay_path;
+  // If not empty, a recording written through `decode_replay_path` to replay
+  // against the engine instead of the input prompt, with the same turns,
+  // sampler parameters and gaps between the turns.
+  std::string replay_decode;
+  // If not empty, the baseline results file of the benchmark regression gate.
+  // The benchmark runs `benchmark_num_runs` times, and fails if the median
+  // prefill or decode throughput, time to first token or peak memory regresses
+  // from the baseline by more than `benchmark_regression_threshold` plus the
+  // spread of the runs. With `update_benchmark_baseline`, the runs are written
+  // as the new baseline instead.
+  std::string benchmark_baseline_path;
+  int benchmark_num_runs = 3;
+  double benchmark_regression_threshold = 0.05;
+  bool update_benchmark_baseline = false;
 };
 
 absl::Status RunLiteRtLm(const LiteRtLmSettings& settings);
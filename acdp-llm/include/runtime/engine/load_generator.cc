@@ -0,0 +1,304 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/load_generator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/ascii.h"  // from @com_google_absl
+#include "absl/strings/numbers.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_split.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/synchronization/notification.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/engine/session_pool.h"
+#include "runtime/util/latency_histogram.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+// The words the synthetic prompts are made of.
+constexpr absl::string_view kWords[] = {
+    "the",   "model", "runs",  "on",     "a",      "device", "with",
+    "many",  "small", "tasks", "every",  "second", "and",    "each",
+    "one",   "asks",  "for",   "short",  "answer", "about",  "its",
+    "input", "text",  "while", "others", "wait",   "in",     "line"};
+
+// Returns a prompt of `num_words` words, starting at a different word for
+// each `index`, so that the prompts do not share a prefix beyond the preface.
+std::string CreatePrompt(int num_words, int index) {
+  constexpr int kNumWords = sizeof(kWords) / sizeof(kWords[0]);
+  std::string prompt;
+  for (int i = 0; i < num_words; ++i) {
+    absl::StrAppend(&prompt, i > 0 ? " " : "",
+                    kWords[(index * 7 + i) % kNumWords]);
+  }
+  return prompt;
+}
+
+absl::Status ParseInt(absl::string_view key, absl::string_view value,
+                      int& parsed) {
+  if (!absl::SimpleAtoi(value, &parsed) || parsed < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid value of the load ", key, ": ", value));
+  }
+  return absl::OkStatus();
+}
+
+// The progress of a request, updated by the streaming callback.
+struct RequestState {
+  Engine::Session* session = nullptr;
+  int max_output_steps = 0;
+  absl::Time arrival_time;
+  absl::Time last_response_time;
+  int num_output_steps = 0;
+  bool cancelled_at_limit = false;
+  absl::Duration time_to_first_token;
+  LatencyHistogram inter_token;
+  absl::Status status;
+  absl::Notification done;
+};
+
+void OnResponses(RequestState& state, absl::StatusOr<Responses> responses) {
+  const absl::Time now = absl::Now();
+  if (!responses.ok()) {
+    if (!(state.cancelled_at_limit && absl::IsCancelled(responses.status()))) {
+      state.status = responses.status();
+    }
+    state.done.Notify();
+    return;
+  }
+  if (responses->GetTaskState() == TaskState::kDone) {
+    state.done.Notify();
+    return;
+  }
+  if (responses->GetTaskState() != TaskState::kProcessing) {
+    return;
+  }
+  if (state.num_output_steps == 0) {
+    state.time_to_first_token = now - state.arrival_time;
+  } else {
+    state.inter_token.Record(now - state.last_response_time);
+  }
+  state.last_response_time = now;
+  ++state.num_output_steps;
+  if (state.max_output_steps > 0 &&
+      state.num_output_steps >= state.max_output_steps &&
+      !state.cancelled_at_limit) {
+    state.cancelled_at_limit = true;
+    state.session->CancelProcess();
+  }
+}
+
+}  // namespace
+
+absl::StatusOr<LoadGeneratorConfig> ParseLoadGeneratorConfig(
+    absl::string_view spec, LoadGeneratorConfig defaults) {
+  LoadGeneratorConfig config = std::move(defaults);
+  for (absl::string_view entry :
+       absl::StrSplit(spec, ';', absl::SkipWhitespace())) {
+    std::vector<absl::string_view> key_and_value =
+        absl::StrSplit(entry, absl::MaxSplits('=', 1));
+    if (key_and_value.size() != 2) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Invalid load entry: ", entry));
+    }
+    const absl::string_view key = absl::StripAsciiWhitespace(key_and_value[0]);
+    const absl::string_view value =
+        absl::StripAsciiWhitespace(key_and_value[1]);
+    if (key == "sessions") {
+      RETURN_IF_ERROR(ParseInt(key, value, config.num_sessions));
+    } else if (key == "requests") {
+      RETURN_IF_ERROR(ParseInt(key, value, config.num_requests));
+    } else if (key == "arrival_rate") {
+      if (!absl::SimpleAtod(value, &config.arrival_rate_per_sec) ||
+          config.arrival_rate_per_sec < 0) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Invalid value of the load arrival_rate: ", value));
+      }
+    } else if (key == "prompt_words") {
+      std::vector<absl::string_view> range =
+          absl::StrSplit(value, absl::MaxSplits('-', 1));
+      RETURN_IF_ERROR(ParseInt(key, range[0], config.min_prompt_words));
+      RETURN_IF_ERROR(ParseInt(key, range.back(), config.max_prompt_words));
+    } else if (key == "preface_words") {
+      RETURN_IF_ERROR(ParseInt(key, value, config.shared_preface_words));
+    } else if (key == "max_output_steps") {
+      RETURN_IF_ERROR(ParseInt(key, value, config.max_output_steps));
+    } else if (key == "seed") {
+      int seed;
+      RETURN_IF_ERROR(ParseInt(key, value, seed));
+      config.seed = seed;
+    } else {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unknown load key: ", key));
+    }
+  }
+  if (config.num_sessions <= 0 || config.num_requests <= 0) {
+    return absl::InvalidArgumentError(
+        "The load needs at least one session and one request.");
+  }
+  if (config.min_prompt_words <= 0 ||
+      config.min_prompt_words > config.max_prompt_words) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid range of prompt words: ",
+                     config.min_prompt_words, "-", config.max_prompt_words));
+  }
+  return config;
+}
+
+double LoadGeneratorReport::GetRequestsPerSec() const {
+  const double seconds = absl::ToDoubleSeconds(wall_time);
+  return seconds > 0 ? num_completed_requests / seconds : 0;
+}
+
+double LoadGeneratorReport::GetOutputStepsPerSec() const {
+  const double seconds = absl::ToDoubleSeconds(wall_time);
+  return seconds > 0 ? num_output_steps / seconds : 0;
+}
+
+std::ostream& operator<<(std::ostream& os, const LoadGeneratorReport& report) {
+  os << "Load generator report:" << std::endl;
+  os << "  Requests: " << report.num_completed_requests << " completed, "
+     << report.num_failed_requests << " failed in " << report.wall_time
+     << std::endl;
+  os << "  Throughput: " << report.GetRequestsPerSec() << " requests/s, "
+     << report.GetOutputStepsPerSec() << " output steps/s" << std::endl;
+  auto print_percentiles = [&os](absl::string_view name,
+                                 const LatencyHistogram& histogram) {
+    os << "  " << name << ": p50 " << histogram.GetPercentile(50) << ", p90 "
+       << histogram.GetPercentile(90) << ", p99 "
+       << histogram.GetPercentile(99) << ", max " << histogram.GetMax()
+       << std::endl;
+  };
+  print_percentiles("Time to first token", report.time_to_first_token);
+  print_percentiles("Inter-token latency", report.inter_token);
+  print_percentiles("Request latency", report.request_latency);
+  return os;
+}
+
+std::vector<LoadGeneratorRequest> GetLoadGeneratorRequests(
+    const LoadGeneratorConfig& config) {
+  std::mt19937 generator(config.seed);
+  std::uniform_int_distribution<int> num_words(config.min_prompt_words,
+                                               config.max_prompt_words);
+  std::vector<LoadGeneratorRequest> requests(config.num_requests);
+  double arrival_seconds = 0;
+  for (LoadGeneratorRequest& request : requests) {
+    request.num_prompt_words = num_words(generator);
+    if (config.arrival_rate_per_sec > 0) {
+      request.arrival_time = absl::Seconds(arrival_seconds);
+      arrival_seconds += std::exponential_distribution<double>(
+          config.arrival_rate_per_sec)(generator);
+    }
+  }
+  return requests;
+}
+
+absl::StatusOr<LoadGeneratorReport> RunLoadGenerator(
+    const Engine& engine, const SessionConfig& session_config,
+    const LoadGeneratorConfig& config) {
+  std::vector<InputData> preface;
+  if (config.shared_preface_words > 0) {
+    preface.emplace_back(
+        InputText(CreatePrompt(config.shared_preface_words, /*index=*/0)));
+  }
+  ASSIGN_OR_RETURN(
+      auto pool, SessionPool::Create(engine, session_config,
+                                     config.num_sessions, std::move(preface)));
+  const std::vector<LoadGeneratorRequest> requests =
+      GetLoadGeneratorRequests(config);
+
+  absl::Mutex mutex;
+  LoadGeneratorReport report;
+  std::atomic<int> next_request = 0;
+  const absl::Time start_time = absl::Now();
+  auto serve_requests = [&]() {
+    for (int index = next_request++; index < config.num_requests;
+         index = next_request++) {
+      const LoadGeneratorRequest& request = requests[index];
+      RequestState state;
+      state.max_output_steps = config.max_output_steps;
+      if (config.arrival_rate_per_sec > 0) {
+        state.arrival_time = start_time + request.arrival_time;
+        absl::SleepFor(state.arrival_time - absl::Now());
+      } else {
+        state.arrival_time = absl::Now();
+      }
+
+      absl::StatusOr<SessionPool::PooledSession> session = pool->Checkout();
+      if (session.ok()) {
+        state.session = &**session;
+        std::vector<InputData> contents;
+        contents.emplace_back(
+            InputText(CreatePrompt(request.num_prompt_words, index)));
+        state.status = (*session)->GenerateContentStream(
+            contents, [&state](absl::StatusOr<Responses> responses) {
+              OnResponses(state, std::move(responses));
+            });
+        if (state.status.ok()) {
+          state.done.WaitForNotification();
+        }
+      } else {
+        state.status = session.status();
+      }
+      const absl::Time end_time = absl::Now();
+
+      absl::MutexLock lock(&mutex);
+      if (!state.status.ok()) {
+        ABSL_LOG(WARNING) << "Request " << index
+                          << " failed: " << state.status;
+        ++report.num_failed_requests;
+        continue;
+      }
+      ++report.num_completed_requests;
+      report.num_output_steps += state.num_output_steps;
+      if (state.num_output_steps > 0) {
+        report.time_to_first_token.Record(state.time_to_first_token);
+      }
+      report.inter_token.Merge(state.inter_token);
+      report.request_latency.Record(end_time - state.arrival_time);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < config.num_sessions; ++i) {
+    threads.emplace_back(serve_requests);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  report.wall_time = absl::Now() - start_time;
+  return report;
+}
+
+}  // namespace litert::lm
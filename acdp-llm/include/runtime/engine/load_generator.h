@@ -0,0 +1,103 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_LOAD_GENERATOR_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_LOAD_GENERATOR_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/util/latency_histogram.h"
+
+namespace litert::lm {
+
+// The load the load generator drives an engine with: requests of synthetic
+// prompts served by concurrent sessions, as a gateway would.
+struct LoadGeneratorConfig {
+  // The number of sessions serving the requests concurrently.
+  int num_sessions = 1;
+  // The total number of requests.
+  int num_requests = 1;
+  // The mean rate of the requests in requests per second, arriving as a
+  // Poisson process whether the sessions keep up or not. 0 for a closed loop,
+  // each session sending a request as soon as its previous one completes.
+  double arrival_rate_per_sec = 0;
+  // The range of the number of words of the prompts, drawn uniformly.
+  int min_prompt_words = 64;
+  int max_prompt_words = 64;
+  // The number of words of a preface prefilled in every session before the
+  // requests, e.g. a system prompt shared by all of them. 0 for none.
+  int shared_preface_words = 0;
+  // The number of responses after which a request is cancelled, to bound the
+  // length of the outputs. 0 to let the requests run to their end.
+  int max_output_steps = 0;
+  // The seed of the arrivals and of the prompt lengths, so that the runs to
+  // compare send the same load.
+  uint32_t seed = 0;
+};
+
+// Returns `defaults` with the values listed in `spec` replaced, e.g.
+// "sessions=8;requests=64;arrival_rate=4;prompt_words=32-512". The keys are
+// sessions, requests, arrival_rate, prompt_words (a number or a range),
+// preface_words, max_output_steps and seed.
+absl::StatusOr<LoadGeneratorConfig> ParseLoadGeneratorConfig(
+    absl::string_view spec, LoadGeneratorConfig defaults);
+
+// The measurements of a load generator run.
+struct LoadGeneratorReport {
+  int num_completed_requests = 0;
+  int num_failed_requests = 0;
+  // The time from the first arrival to the completion of the last request.
+  absl::Duration wall_time;
+  int64_t num_output_steps = 0;
+  // The latencies of the completed requests. The time to the first token and
+  // the request latency count from the arrival of the request, so that they
+  // include its wait for a free session.
+  LatencyHistogram time_to_first_token;
+  LatencyHistogram inter_token;
+  LatencyHistogram request_latency;
+
+  double GetRequestsPerSec() const;
+  double GetOutputStepsPerSec() const;
+};
+std::ostream& operator<<(std::ostream& os, const LoadGeneratorReport& report);
+
+// A request of the load: the number of words of its prompt and its arrival
+// time after the start of the run.
+struct LoadGeneratorRequest {
+  int num_prompt_words = 0;
+  absl::Duration arrival_time;
+};
+
+// Returns the requests of `config`, in the order of their arrival.
+std::vector<LoadGeneratorRequest> GetLoadGeneratorRequests(
+    const LoadGeneratorConfig& config);
+
+// Drives `engine` with the load of `config`, with sessions created with
+// `session_config`, and returns the measurements once all the requests are
+// done. The requests failing are counted, not returned as an error.
+absl::StatusOr<LoadGeneratorReport> RunLoadGenerator(
+    const Engine& engine, const SessionConfig& session_config,
+    const LoadGeneratorConfig& config);
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_LOAD_GENERATOR_H_
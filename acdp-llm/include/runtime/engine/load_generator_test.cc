@@ -0,0 +1,208 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/load_generator.h"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/fake_engine.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::StatusIs;
+
+// An engine of sessions streaming `num_output_steps` responses per request
+// from the calling thread, until they are cancelled.
+class StreamingEngine : public FakeEngine {
+ public:
+  absl::StatusOr<std::unique_ptr<Session>> CreateSession(
+      const SessionConfig& session_config) const override {
+    auto session = std::make_unique<testing::NiceMock<MockSession>>();
+    auto cancelled = std::make_shared<bool>(false);
+    ON_CALL(*session, RunPrefill)
+        .WillByDefault([this](const std::vector<InputData>& contents) {
+          num_prefilled_contents += static_cast<int>(contents.size());
+          return absl::OkStatus();
+        });
+    ON_CALL(*session, CancelProcess).WillByDefault([cancelled]() {
+      *cancelled = true;
+    });
+    ON_CALL(*session, GenerateContentStream(testing::_, testing::_))
+        .WillByDefault(
+            [this, cancelled](
+                const std::vector<InputData>& contents,
+                absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback)
+                -> absl::Status {
+              if (fail_requests) {
+                return absl::InternalError("Failed.");
+              }
+              *cancelled = false;
+              for (int i = 0; i < num_output_steps; ++i) {
+                if (*cancelled) {
+                  callback(absl::CancelledError("Cancelled."));
+                  return absl::OkStatus();
+                }
+                callback(Responses(TaskState::kProcessing, {"token"}));
+              }
+              callback(Responses(TaskState::kDone));
+              return absl::OkStatus();
+            });
+    ON_CALL(*session, Checkpoint)
+        .WillByDefault(
+            []() -> absl::StatusOr<std::unique_ptr<SessionCheckpoint>> {
+              return std::make_unique<SessionCheckpoint>();
+            });
+    ON_CALL(*session, Restore)
+        .WillByDefault([](const SessionCheckpoint& checkpoint) {
+          return absl::OkStatus();
+        });
+    return session;
+  }
+
+  int num_output_steps = 5;
+  bool fail_requests = false;
+  mutable std::atomic<int> num_prefilled_contents = 0;
+};
+
+TEST(LoadGeneratorTest, ParseOverridesTheListedKeys) {
+  ASSERT_OK_AND_ASSIGN(
+      LoadGeneratorConfig config,
+      ParseLoadGeneratorConfig(
+          "sessions=8; requests=64;arrival_rate=2.5;prompt_words=32-512",
+          LoadGeneratorConfig()));
+  EXPECT_EQ(config.num_sessions, 8);
+  EXPECT_EQ(config.num_requests, 64);
+  EXPECT_EQ(config.arrival_rate_per_sec, 2.5);
+  EXPECT_EQ(config.min_prompt_words, 32);
+  EXPECT_EQ(config.max_prompt_words, 512);
+  EXPECT_EQ(config.max_output_steps, 0);
+
+  ASSERT_OK_AND_ASSIGN(config, ParseLoadGeneratorConfig(
+                                   "prompt_words=16", LoadGeneratorConfig()));
+  EXPECT_EQ(config.min_prompt_words, 16);
+  EXPECT_EQ(config.max_prompt_words, 16);
+}
+
+TEST(LoadGeneratorTest, ParseFailsOnInvalidSpec) {
+  EXPECT_THAT(ParseLoadGeneratorConfig("users=8", LoadGeneratorConfig()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseLoadGeneratorConfig("sessions=0", LoadGeneratorConfig()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(
+      ParseLoadGeneratorConfig("prompt_words=64-32", LoadGeneratorConfig()),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(
+      ParseLoadGeneratorConfig("arrival_rate=-1", LoadGeneratorConfig()),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(LoadGeneratorTest, RequestsAreReproducible) {
+  LoadGeneratorConfig config;
+  config.num_requests = 100;
+  config.arrival_rate_per_sec = 10;
+  config.min_prompt_words = 8;
+  config.max_prompt_words = 32;
+  config.seed = 42;
+  const std::vector<LoadGeneratorRequest> requests =
+      GetLoadGeneratorRequests(config);
+  ASSERT_EQ(requests.size(), 100);
+  for (int i = 0; i < requests.size(); ++i) {
+    EXPECT_GE(requests[i].num_prompt_words, 8);
+    EXPECT_LE(requests[i].num_prompt_words, 32);
+    if (i > 0) {
+      EXPECT_GE(requests[i].arrival_time, requests[i - 1].arrival_time);
+    }
+  }
+  // 100 arrivals at 10 per second take about 10 seconds.
+  EXPECT_GT(requests.back().arrival_time, absl::Seconds(5));
+  EXPECT_LT(requests.back().arrival_time, absl::Seconds(20));
+
+  const std::vector<LoadGeneratorRequest> same_requests =
+      GetLoadGeneratorRequests(config);
+  EXPECT_EQ(same_requests.back().arrival_time, requests.back().arrival_time);
+  EXPECT_EQ(same_requests.back().num_prompt_words,
+            requests.back().num_prompt_words);
+}
+
+TEST(LoadGeneratorTest, ClosedLoopArrivesImmediately) {
+  LoadGeneratorConfig config;
+  config.num_requests = 4;
+  for (const LoadGeneratorRequest& request : GetLoadGeneratorRequests(config)) {
+    EXPECT_EQ(request.arrival_time, absl::ZeroDuration());
+  }
+}
+
+TEST(LoadGeneratorTest, RunsAllTheRequests) {
+  StreamingEngine engine;
+  LoadGeneratorConfig config;
+  config.num_sessions = 3;
+  config.num_requests = 10;
+  config.shared_preface_words = 16;
+  ASSERT_OK_AND_ASSIGN(
+      LoadGeneratorReport report,
+      RunLoadGenerator(engine, SessionConfig::CreateDefault(), config));
+  EXPECT_EQ(report.num_completed_requests, 10);
+  EXPECT_EQ(report.num_failed_requests, 0);
+  EXPECT_EQ(report.num_output_steps, 50);
+  EXPECT_EQ(report.time_to_first_token.GetCount(), 10);
+  EXPECT_EQ(report.inter_token.GetCount(), 40);
+  EXPECT_EQ(report.request_latency.GetCount(), 10);
+  // The preface is prefilled once per session, not per request.
+  EXPECT_EQ(engine.num_prefilled_contents.load(), 3);
+}
+
+TEST(LoadGeneratorTest, CancelsTheRequestsAtTheOutputLimit) {
+  StreamingEngine engine;
+  LoadGeneratorConfig config;
+  config.num_sessions = 2;
+  config.num_requests = 4;
+  config.max_output_steps = 2;
+  ASSERT_OK_AND_ASSIGN(
+      LoadGeneratorReport report,
+      RunLoadGenerator(engine, SessionConfig::CreateDefault(), config));
+  EXPECT_EQ(report.num_completed_requests, 4);
+  EXPECT_EQ(report.num_failed_requests, 0);
+  EXPECT_EQ(report.num_output_steps, 8);
+}
+
+TEST(LoadGeneratorTest, CountsTheFailedRequests) {
+  StreamingEngine engine;
+  engine.fail_requests = true;
+  LoadGeneratorConfig config;
+  config.num_sessions = 2;
+  config.num_requests = 4;
+  ASSERT_OK_AND_ASSIGN(
+      LoadGeneratorReport report,
+      RunLoadGenerator(engine, SessionConfig::CreateDefault(), config));
+  EXPECT_EQ(report.num_completed_requests, 0);
+  EXPECT_EQ(report.num_failed_requests, 4);
+  EXPECT_EQ(report.request_latency.GetCount(), 0);
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,276 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/engine/reloadable_engine.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_creation.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+// A session of an engine, keeping the engine alive until the session is
+// destroyed.
+class EngineBoundSession : public Engine::Session {
+ public:
+  EngineBoundSession(std::shared_ptr<Engine> engine,
+                     std::unique_ptr<Engine::Session> session)
+      : engine_(std::move(engine)), session_(std::move(session)) {}
+
+  absl::StatusOr<Responses> GenerateContent(
+      const std::vector<InputData>& contents) override {
+    return session_->GenerateContent(contents);
+  }
+  absl::Status GenerateContentStream(
+      const std::vector<InputData>& contents,
+      absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback) override {
+    return session_->GenerateContentStream(contents, std::move(callback));
+  }
+  absl::Status GenerateContentStream(
+      const std::vector<InputData>& contents,
+      absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
+      const DecodeConfig& decode_config) override {
+    return session_->GenerateContentStream(contents, std::move(callback),
+                                           decode_config);
+  }
+  absl::Status GenerateContentStream(
+      std::vector<InputData>&& contents,
+      absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
+      const DecodeConfig& decode_config) override {
+    return session_->GenerateContentStream(
+        std::move(contents), std::move(callback), decode_config);
+  }
+  absl::StatusOr<Responses> RunTextScoring(
+      const std::vector<absl::string_view>& target_text) override {
+    return session_->RunTextScoring(target_text);
+  }
+  absl::StatusOr<std::vector<Responses>> RunTextScoringWithTemperatures(
+      const std::vector<absl::string_view>& target_text,
+      absl::Span<const float> temperatures) override {
+    return session_->RunTextScoringWithTemperatures(target_text,
+                                                    temperatures);
+  }
+  absl::StatusOr<std::vector<std::vector<float>>> EmbedText(
+      const std::vector<absl::string_view>& texts,
+      EmbeddingPooling pooling) override {
+    return session_->EmbedText(texts, pooling);
+  }
+  absl::Status RunPrefill(const std::vector<InputData>& contents) override {
+    return session_->RunPrefill(contents);
+  }
+  absl::Status RunPrefill(std::vector<InputData>&& contents) override {
+    return session_->RunPrefill(std::move(contents));
+  }
+  absl::Status RunPrefillAsync(
+      const std::vector<InputData>& contents,
+      absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback) override {
+    return session_->RunPrefillAsync(contents, std::move(callback));
+  }
+  absl::Status RunPrefillAsync(
+      std::vector<InputData>&& contents,
+      absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback) override {
+    return session_->RunPrefillAsync(std::move(contents), std::move(callback));
+  }
+  absl::StatusOr<Responses> RunDecode() override {
+    return session_->RunDecode();
+  }
+  absl::StatusOr<Responses> RunDecode(
+      const DecodeConfig& decode_config) override {
+    return session_->RunDecode(decode_config);
+  }
+  absl::Status RunDecodeAsync(
+      absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback) override {
+    return session_->RunDecodeAsync(std::move(callback));
+  }
+  absl::Status RunDecodeAsync(
+      absl::AnyInvocable<void(absl::StatusOr<Responses>)> callback,
+      const DecodeConfig& decode_config) override {
+    return session_->RunDecodeAsync(std::move(callback), decode_config);
+  }
+  absl::StatusOr<BenchmarkInfo> GetBenchmarkInfo() override {
+    return session_->GetBenchmarkInfo();
+  }
+  void CancelProcess() override { session_->CancelProcess(); }
+  const SessionConfig& GetSessionConfig() const override {
+    return session_->GetSessionConfig();
+  }
+  const Tokenizer& GetTokenizer() const override {
+    return session_->GetTokenizer();
+  }
+
+  absl::StatusOr<std::vector<int>> TextToPrefillTokenIds(
+      absl::string_view text) override {
+    return session_->TextToPrefillTokenIds(text);
+  }
+  absl::StatusOr<std::unique_ptr<SessionCheckpoint>> Checkpoint() override {
+    return session_->Checkpoint();
+  }
+  absl::Status Restore(const SessionCheckpoint& checkpoint) override {
+    return session_->Restore(checkpoint);
+  }
+  absl::Status SaveCheckpoint(const SessionCheckpoint& checkpoint,
+                              absl::string_view path) override {
+    return session_->SaveCheckpoint(checkpoint, path);
+  }
+  absl::StatusOr<std::unique_ptr<SessionCheckpoint>> LoadCheckpoint(
+      absl::string_view path) override {
+    return session_->LoadCheckpoint(path);
+  }
+  absl::StatusOr<std::string> SerializeCheckpoint(
+      const SessionCheckpoint& checkpoint) override {
+    return session_->SerializeCheckpoint(checkpoint);
+  }
+  absl::StatusOr<std::unique_ptr<SessionCheckpoint>> DeserializeCheckpoint(
+      std::string data) override {
+    return session_->DeserializeCheckpoint(std::move(data));
+  }
+  absl::StatusOr<std::unique_ptr<Session>> Fork() override {
+    ASSIGN_OR_RETURN(auto session, session_->Fork());
+    return std::make_unique<EngineBoundSession>(engine_, std::move(session));
+  }
+  absl::StatusOr<std::unique_ptr<Session>> MigrateTo(
+      const Engine& engine) override {
+    return session_->MigrateTo(engine);
+  }
+  absl::StatusOr<std::unique_ptr<AudioStream>> CreateAudioStream() override {
+    return session_->CreateAudioStream();
+  }
+
+ private:
+  // Declared before `session_`, so that the session is destroyed first.
+  const std::shared_ptr<Engine> engine_;
+  const std::unique_ptr<Engine::Session> session_;
+};
+
+}  // namespace
+
+// static
+absl::StatusOr<std::unique_ptr<ReloadableEngine>> ReloadableEngine::Create(
+    std::unique_ptr<Engine> engine) {
+  if (engine == nullptr) {
+    return absl::InvalidArgumentError("The engine is null.");
+  }
+  return absl::WrapUnique(new ReloadableEngine(std::move(engine)));
+}
+
+// static
+absl::StatusOr<std::unique_ptr<ReloadableEngine>>
+ReloadableEngine::CreateFromSettings(EngineSettings settings) {
+  ASSIGN_OR_RETURN(auto engine,
+                   EngineCreation::Start(std::move(settings))->Wait());
+  return Create(std::move(engine));
+}
+
+absl::StatusOr<std::unique_ptr<Engine::Session>>
+ReloadableEngine::CreateSession(const SessionConfig& session_config) const {
+  std::shared_ptr<Engine> engine = GetEngine();
+  ASSIGN_OR_RETURN(auto session, engine->CreateSession(session_config));
+  return std::make_unique<EngineBoundSession>(std::move(engine),
+                                              std::move(session));
+}
+
+absl::StatusOr<std::unique_ptr<Engine::Session>>
+ReloadableEngine::MigrateSession(Engine::Session& session) const {
+  std::shared_ptr<Engine> engine = GetEngine();
+  ASSIGN_OR_RETURN(auto migrated_session, session.MigrateTo(*engine));
+  return std::make_unique<EngineBoundSession>(std::move(engine),
+                                              std::move(migrated_session));
+}
+
+absl::Status ReloadableEngine::Reload(std::unique_ptr<Engine> engine) {
+  if (engine == nullptr) {
+    return absl::InvalidArgumentError("The engine is null.");
+  }
+  std::shared_ptr<Engine> retired_engine = std::move(engine);
+  {
+    absl::MutexLock lock(&mutex_);
+    engine_.swap(retired_engine);
+    retired_engines_.push_back(retired_engine);
+  }
+  // Destroys the retired engine here if it has no session, out of the lock
+  // as it waits for its tasks.
+  retired_engine.reset();
+  return absl::OkStatus();
+}
+
+absl::Status ReloadableEngine::ReloadFromSettings(EngineSettings settings) {
+  ASSIGN_OR_RETURN(auto engine,
+                   EngineCreation::Start(std::move(settings))->Wait());
+  return Reload(std::move(engine));
+}
+
+std::shared_ptr<Engine> ReloadableEngine::GetEngine() const {
+  absl::MutexLock lock(&mutex_);
+  return engine_;
+}
+
+std::vector<std::shared_ptr<Engine>> ReloadableEngine::LockRetiredEngines()
+    const {
+  std::vector<std::shared_ptr<Engine>> engines;
+  std::vector<std::weak_ptr<Engine>> alive;
+  for (const std::weak_ptr<Engine>& retired_engine : retired_engines_) {
+    if (std::shared_ptr<Engine> engine = retired_engine.lock()) {
+      engines.push_back(std::move(engine));
+      alive.push_back(retired_engine);
+    }
+  }
+  retired_engines_ = std::move(alive);
+  return engines;
+}
+
+int ReloadableEngine::GetNumRetiredEngines() const {
+  std::vector<std::shared_ptr<Engine>> engines;
+  {
+    absl::MutexLock lock(&mutex_);
+    engines = LockRetiredEngines();
+  }
+  return engines.size();
+}
+
+absl::Status ReloadableEngine::DrainRetiredEngines(absl::Duration timeout) {
+  std::vector<std::shared_ptr<Engine>> engines;
+  {
+    absl::MutexLock lock(&mutex_);
+    engines = LockRetiredEngines();
+  }
+  absl::Status status;
+  for (const auto& engine : engines) {
+    status.Update(engine->Drain(timeout));
+  }
+  return status;
+}
+
+absl::Status ReloadableEngine::WaitUntilDone(absl::Duration timeout) {
+  return GetEngine()->WaitUntilDone(timeout);
+}
+
+}  // namespace litert::lm
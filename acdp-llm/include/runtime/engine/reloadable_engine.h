@@ -0,0 +1,120 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_RELOADABLE_ENGINE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_RELOADABLE_ENGINE_H_
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+
+namespace litert::lm {
+
+// ReloadableEngine serves the sessions of an engine that can be replaced,
+// e.g. by the next version of the model, without dropping the sessions in
+// flight and without a window where no engine admits new sessions.
+//
+// Reload() swaps the engine in one step: the new sessions go to the new
+// engine from then on, while the sessions created before keep running on the
+// previous one. A session holds a reference to its engine, so the previous
+// engine is destroyed with the last of its sessions rather than by Reload().
+// DrainRetiredEngines() bounds how long the previous engines keep serving.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(auto engine,
+//                    ReloadableEngine::CreateFromSettings(std::move(v1)));
+//   ASSIGN_OR_RETURN(auto session,
+//                    engine->CreateSession(SessionConfig::CreateDefault()));
+//   // ... serve requests, then roll out the next model ...
+//   RETURN_IF_ERROR(engine->ReloadFromSettings(std::move(v2)));
+//   // Optionally, move the long conversations to the new engine.
+//   ASSIGN_OR_RETURN(session, engine->MigrateSession(*session));
+//
+// The class is thread-safe.
+class ReloadableEngine {
+ public:
+  // Creates a reloadable engine serving `engine` first.
+  static absl::StatusOr<std::unique_ptr<ReloadableEngine>> Create(
+      std::unique_ptr<Engine> engine);
+
+  // Creates the engine of `settings`, see EngineCreation, and a reloadable
+  // engine serving it.
+  static absl::StatusOr<std::unique_ptr<ReloadableEngine>> CreateFromSettings(
+      EngineSettings settings);
+
+  ReloadableEngine(const ReloadableEngine&) = delete;
+  ReloadableEngine& operator=(const ReloadableEngine&) = delete;
+
+  // Creates a session on the current engine. The session keeps the engine
+  // alive, and may outlive the reloadable engine.
+  absl::StatusOr<std::unique_ptr<Engine::Session>> CreateSession(
+      const SessionConfig& session_config) const;
+
+  // Moves `session`, typically of a retired engine, to the current engine
+  // without prefilling its context again, see Engine::Session::MigrateTo().
+  // `session` is left unchanged; destroying it releases its engine sooner.
+  absl::StatusOr<std::unique_ptr<Engine::Session>> MigrateSession(
+      Engine::Session& session) const;
+
+  // Makes `engine` the current engine. The previous one is retired: it
+  // admits no new sessions and is destroyed once its sessions are.
+  absl::Status Reload(std::unique_ptr<Engine> engine);
+
+  // Creates the engine of `settings` while the current engine keeps serving,
+  // then reloads it. The current engine stays if the creation fails. When
+  // both engines load the same files, they share the memory mapped weights
+  // in the page cache.
+  absl::Status ReloadFromSettings(EngineSettings settings);
+
+  // Returns the current engine.
+  std::shared_ptr<Engine> GetEngine() const;
+
+  // Returns the number of retired engines that still have sessions.
+  int GetNumRetiredEngines() const;
+
+  // Drains the retired engines, see Engine::Drain(): their sessions fail
+  // their next requests and the requests in flight are cancelled. Waits
+  // within `timeout` for every engine.
+  absl::Status DrainRetiredEngines(absl::Duration timeout);
+
+  // Waits until the current engine is done with its tasks.
+  absl::Status WaitUntilDone(absl::Duration timeout);
+
+ private:
+  explicit ReloadableEngine(std::shared_ptr<Engine> engine)
+      : engine_(std::move(engine)) {}
+
+  // Returns the retired engines still alive, and forgets the others.
+  std::vector<std::shared_ptr<Engine>> LockRetiredEngines() const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  mutable absl::Mutex mutex_;
+  std::shared_ptr<Engine> engine_ ABSL_GUARDED_BY(mutex_);
+  // The previous engines, kept alive by their sessions only.
+  mutable std::vector<std::weak_ptr<Engine>> retired_engines_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_RELOADABLE_ENGINE_H_
@@ -0,0 +1,164 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/engine/reloadable_engine.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/fake_engine.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::StatusIs;
+
+// The state of a fake engine, which outlives it.
+struct VersionedEngineState {
+  int num_sessions = 0;
+  int num_drains = 0;
+  bool destroyed = false;
+};
+
+// An engine recording its sessions and its destruction in `state`.
+class VersionedEngine : public FakeEngine {
+ public:
+  explicit VersionedEngine(VersionedEngineState& state) : state_(state) {}
+  ~VersionedEngine() override { state_.destroyed = true; }
+
+  absl::StatusOr<std::unique_ptr<Session>> CreateSession(
+      const SessionConfig& session_config) const override {
+    ++state_.num_sessions;
+    auto session = std::make_unique<MockSession>();
+    ON_CALL(*session, Fork()).WillByDefault([]() {
+      return std::make_unique<MockSession>();
+    });
+    ON_CALL(*session, MigrateTo).WillByDefault([](const Engine& engine) {
+      return engine.CreateSession(SessionConfig::CreateDefault());
+    });
+    return session;
+  }
+
+  absl::Status Drain(absl::Duration timeout) override {
+    ++state_.num_drains;
+    return absl::OkStatus();
+  }
+
+ private:
+  VersionedEngineState& state_;
+};
+
+TEST(ReloadableEngineTest, CreateFailsWithoutEngine) {
+  EXPECT_THAT(ReloadableEngine::Create(nullptr),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ReloadableEngineTest, NewSessionsGoToTheReloadedEngine) {
+  VersionedEngineState v1;
+  VersionedEngineState v2;
+  ASSERT_OK_AND_ASSIGN(auto engine, ReloadableEngine::Create(
+                                        std::make_unique<VersionedEngine>(v1)));
+  ASSERT_OK_AND_ASSIGN(auto old_session,
+                       engine->CreateSession(SessionConfig::CreateDefault()));
+  EXPECT_EQ(v1.num_sessions, 1);
+
+  ASSERT_OK(engine->Reload(std::make_unique<VersionedEngine>(v2)));
+  ASSERT_OK_AND_ASSIGN(auto new_session,
+                       engine->CreateSession(SessionConfig::CreateDefault()));
+  EXPECT_EQ(v1.num_sessions, 1);
+  EXPECT_EQ(v2.num_sessions, 1);
+
+  // The session created before the reload keeps its engine.
+  EXPECT_FALSE(v1.destroyed);
+  EXPECT_EQ(engine->GetNumRetiredEngines(), 1);
+  old_session.reset();
+  EXPECT_TRUE(v1.destroyed);
+  EXPECT_EQ(engine->GetNumRetiredEngines(), 0);
+  EXPECT_FALSE(v2.destroyed);
+}
+
+TEST(ReloadableEngineTest, ReloadDestroysTheEngineWithoutSessions) {
+  VersionedEngineState v1;
+  VersionedEngineState v2;
+  ASSERT_OK_AND_ASSIGN(auto engine, ReloadableEngine::Create(
+                                        std::make_unique<VersionedEngine>(v1)));
+  ASSERT_OK(engine->Reload(std::make_unique<VersionedEngine>(v2)));
+  EXPECT_TRUE(v1.destroyed);
+  EXPECT_EQ(engine->GetNumRetiredEngines(), 0);
+  EXPECT_THAT(engine->Reload(nullptr),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ReloadableEngineTest, SessionsOutliveTheReloadableEngine) {
+  VersionedEngineState v1;
+  ASSERT_OK_AND_ASSIGN(auto engine, ReloadableEngine::Create(
+                                        std::make_unique<VersionedEngine>(v1)));
+  ASSERT_OK_AND_ASSIGN(auto session,
+                       engine->CreateSession(SessionConfig::CreateDefault()));
+  ASSERT_OK_AND_ASSIGN(auto forked_session, session->Fork());
+  engine.reset();
+  session.reset();
+  EXPECT_FALSE(v1.destroyed);
+  forked_session.reset();
+  EXPECT_TRUE(v1.destroyed);
+}
+
+TEST(ReloadableEngineTest, MigrateSessionMovesTheSessionToTheCurrentEngine) {
+  VersionedEngineState v1;
+  VersionedEngineState v2;
+  ASSERT_OK_AND_ASSIGN(auto engine, ReloadableEngine::Create(
+                                        std::make_unique<VersionedEngine>(v1)));
+  ASSERT_OK_AND_ASSIGN(auto session,
+                       engine->CreateSession(SessionConfig::CreateDefault()));
+  ASSERT_OK(engine->Reload(std::make_unique<VersionedEngine>(v2)));
+
+  ASSERT_OK_AND_ASSIGN(auto migrated_session,
+                       engine->MigrateSession(*session));
+  EXPECT_EQ(v1.num_sessions, 1);
+  EXPECT_EQ(v2.num_sessions, 1);
+  // The retired engine goes with the session migrated away from it.
+  session.reset();
+  EXPECT_TRUE(v1.destroyed);
+  engine.reset();
+  EXPECT_FALSE(v2.destroyed);
+  migrated_session.reset();
+  EXPECT_TRUE(v2.destroyed);
+}
+
+TEST(ReloadableEngineTest, DrainRetiredEnginesDrainsOnlyTheRetiredOnes) {
+  VersionedEngineState v1;
+  VersionedEngineState v2;
+  ASSERT_OK_AND_ASSIGN(auto engine, ReloadableEngine::Create(
+                                        std::make_unique<VersionedEngine>(v1)));
+  ASSERT_OK_AND_ASSIGN(auto session,
+                       engine->CreateSession(SessionConfig::CreateDefault()));
+  ASSERT_OK(engine->Reload(std::make_unique<VersionedEngine>(v2)));
+  ASSERT_OK(engine->DrainRetiredEngines(absl::Seconds(1)));
+  EXPECT_EQ(v1.num_drains, 1);
+  EXPECT_EQ(v2.num_drains, 0);
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,149 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/engine/session_pool.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/status_macros.h"  // NOLINT
+
+namespace litert::lm {
+
+SessionPool::PooledSession& SessionPool::PooledSession::operator=(
+    PooledSession&& other) {
+  if (this != &other) {
+    if (pool_ != nullptr) {
+      pool_->Return(*this);
+    }
+    pool_ = std::exchange(other.pool_, nullptr);
+    session_ = std::move(other.session_);
+    checkpoint_ = std::move(other.checkpoint_);
+  }
+  return *this;
+}
+
+SessionPool::PooledSession::~PooledSession() {
+  if (pool_ != nullptr) {
+    pool_->Return(*this);
+  }
+}
+
+// static
+absl::StatusOr<std::unique_ptr<SessionPool>> SessionPool::Create(
+    const Engine& engine, const SessionConfig& session_config,
+    int num_sessions, std::vector<InputData> preface) {
+  if (num_sessions <= 0) {
+    return absl::InvalidArgumentError(
+        "The pool needs at least one session.");
+  }
+  auto pool = absl::WrapUnique(new SessionPool(
+      engine, session_config, num_sessions, std::move(preface)));
+  std::vector<PooledSession> sessions;
+  sessions.reserve(num_sessions);
+  for (int i = 0; i < num_sessions; ++i) {
+    ASSIGN_OR_RETURN(PooledSession session, pool->CreateSession());
+    sessions.push_back(std::move(session));
+  }
+  absl::MutexLock lock(&pool->mutex_);
+  pool->ready_sessions_ = std::move(sessions);
+  return pool;
+}
+
+absl::StatusOr<SessionPool::PooledSession> SessionPool::Checkout() {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!ready_sessions_.empty()) {
+      PooledSession session = std::move(ready_sessions_.back());
+      ready_sessions_.pop_back();
+      session.pool_ = this;
+      return session;
+    }
+    ++num_extra_creations_;
+  }
+  ASSIGN_OR_RETURN(PooledSession session, CreateSession());
+  session.pool_ = this;
+  return session;
+}
+
+int SessionPool::GetNumReadySessions() const {
+  absl::MutexLock lock(&mutex_);
+  return ready_sessions_.size();
+}
+
+int SessionPool::GetNumExtraCreations() const {
+  absl::MutexLock lock(&mutex_);
+  return num_extra_creations_;
+}
+
+absl::StatusOr<SessionPool::PooledSession> SessionPool::CreateSession() {
+  ASSIGN_OR_RETURN(std::unique_ptr<Engine::Session> session,
+                   engine_.CreateSession(session_config_));
+  if (!preface_.empty()) {
+    RETURN_IF_ERROR(session->RunPrefill(preface_));
+  }
+  std::unique_ptr<SessionCheckpoint> checkpoint;
+  if (auto session_checkpoint = session->Checkpoint();
+      session_checkpoint.ok()) {
+    checkpoint = *std::move(session_checkpoint);
+  } else if (!absl::IsUnimplemented(session_checkpoint.status())) {
+    return session_checkpoint.status();
+  }
+  // Not returned to the pool until checked out.
+  return PooledSession(/*pool=*/nullptr, std::move(session),
+                       std::move(checkpoint));
+}
+
+void SessionPool::Return(PooledSession& session) {
+  session.pool_ = nullptr;
+  if (GetNumReadySessions() >= num_sessions_) {
+    // The extra sessions are destroyed, as the pool is full.
+    return;
+  }
+  if (session.checkpoint_ != nullptr) {
+    const absl::Status status =
+        session.session_->Restore(*session.checkpoint_);
+    if (status.ok()) {
+      absl::MutexLock lock(&mutex_);
+      ready_sessions_.push_back(std::move(session));
+      return;
+    }
+    ABSL_LOG(WARNING) << "Replacing a session failing to restore: " << status;
+  }
+  // Destroyed first, so that an engine of a single context can host the
+  // replacement.
+  session.session_.reset();
+  session.checkpoint_.reset();
+  auto new_session = CreateSession();
+  if (!new_session.ok()) {
+    ABSL_LOG(WARNING) << "Failed to replace a returned session: "
+                      << new_session.status();
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  ++num_extra_creations_;
+  ready_sessions_.push_back(*std::move(new_session));
+}
+
+}  // namespace litert::lm
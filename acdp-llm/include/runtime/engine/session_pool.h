@@ -0,0 +1,135 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_SESSION_POOL_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_SESSION_POOL_H_
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/io_types.h"
+
+namespace litert::lm {
+
+// SessionPool keeps sessions of an engine ready for use, e.g. for a gateway
+// serving every request with a new session, so that a request neither pays
+// for the session creation nor for the prefill of a preface shared by all
+// the requests (a system prompt, few-shot examples, ...).
+//
+// The sessions are created, and the preface prefilled, up front. A session
+// is checked out of the pool in constant time and returns to it when the
+// checked out handle is destroyed. It is then restored to the checkpoint
+// taken after the preface, see Engine::Session::Checkpoint(), which keeps
+// the kv-cache of the preface instead of resetting the context. With an
+// engine not supporting checkpoints, a returned session is replaced by a new
+// one instead.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(auto pool,
+//                    SessionPool::Create(*engine, session_config,
+//                                        /*num_sessions=*/4,
+//                                        {InputText(system_prompt)}));
+//   ASSIGN_OR_RETURN(SessionPool::PooledSession session, pool->Checkout());
+//   ASSIGN_OR_RETURN(auto responses,
+//                    session->GenerateContent({InputText(request)}));
+//
+// The class is thread-safe. The pool must outlive the engine's sessions
+// checked out of it, and the engine must outlive the pool.
+class SessionPool {
+ public:
+  // A session of the pool in use, returned to the pool when destroyed.
+  class PooledSession {
+   public:
+    PooledSession(PooledSession&& other)
+        : pool_(std::exchange(other.pool_, nullptr)),
+          session_(std::move(other.session_)),
+          checkpoint_(std::move(other.checkpoint_)) {}
+    PooledSession& operator=(PooledSession&& other);
+    ~PooledSession();
+
+    Engine::Session* operator->() const { return session_.get(); }
+    Engine::Session& operator*() const { return *session_; }
+
+   private:
+    friend class SessionPool;
+
+    PooledSession(SessionPool* pool, std::unique_ptr<Engine::Session> session,
+                  std::unique_ptr<SessionCheckpoint> checkpoint)
+        : pool_(pool),
+          session_(std::move(session)),
+          checkpoint_(std::move(checkpoint)) {}
+
+    SessionPool* pool_;
+    std::unique_ptr<Engine::Session> session_;
+    // The state of the session after the preface, nullptr if the engine does
+    // not support checkpoints.
+    std::unique_ptr<SessionCheckpoint> checkpoint_;
+  };
+
+  // Creates a pool of `num_sessions` sessions of `engine` configured with
+  // `session_config`, each with `preface` prefilled.
+  static absl::StatusOr<std::unique_ptr<SessionPool>> Create(
+      const Engine& engine, const SessionConfig& session_config,
+      int num_sessions, std::vector<InputData> preface = {});
+
+  SessionPool(const SessionPool&) = delete;
+  SessionPool& operator=(const SessionPool&) = delete;
+
+  // Checks a ready session out of the pool, or creates one if all of them
+  // are in use.
+  absl::StatusOr<PooledSession> Checkout();
+
+  // Returns the number of ready sessions.
+  int GetNumReadySessions() const;
+
+  // Returns the number of sessions created by Checkout() and by the returns,
+  // i.e. beyond the initial ones, for the logs and the tests.
+  int GetNumExtraCreations() const;
+
+ private:
+  SessionPool(const Engine& engine, const SessionConfig& session_config,
+              int num_sessions, std::vector<InputData> preface)
+      : engine_(engine),
+        session_config_(session_config),
+        num_sessions_(num_sessions),
+        preface_(std::move(preface)) {}
+
+  // Creates a session with the preface prefilled.
+  absl::StatusOr<PooledSession> CreateSession();
+
+  // Restores `session` to the preface, or replaces it, and keeps it if the
+  // pool is not full.
+  void Return(PooledSession& session);
+
+  const Engine& engine_;
+  const SessionConfig session_config_;
+  const int num_sessions_;
+  const std::vector<InputData> preface_;
+
+  mutable absl::Mutex mutex_;
+  // The ready sessions.
+  std::vector<PooledSession> ready_sessions_ ABSL_GUARDED_BY(mutex_);
+  int num_extra_creations_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_SESSION_POOL_H_
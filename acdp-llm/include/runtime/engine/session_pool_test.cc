@@ -0,0 +1,144 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/engine/session_pool.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "runtime/engine/engine.h"
+#include "runtime/engine/engine_settings.h"
+#include "runtime/engine/fake_engine.h"
+#include "runtime/engine/io_types.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::StatusIs;
+
+// An engine of sessions counting their prefills and restorations.
+class CountingEngine : public FakeEngine {
+ public:
+  absl::StatusOr<std::unique_ptr<Session>> CreateSession(
+      const SessionConfig& session_config) const override {
+    ++num_sessions;
+    auto session = std::make_unique<testing::NiceMock<MockSession>>();
+    ON_CALL(*session, RunPrefill)
+        .WillByDefault([this](const std::vector<InputData>& contents) {
+          num_prefilled_contents += contents.size();
+          return absl::OkStatus();
+        });
+    ON_CALL(*session, Checkpoint)
+        .WillByDefault(
+            [this]() -> absl::StatusOr<std::unique_ptr<SessionCheckpoint>> {
+              if (!supports_checkpoints) {
+                return absl::UnimplementedError("Not supported.");
+              }
+              return std::make_unique<SessionCheckpoint>();
+            });
+    ON_CALL(*session, Restore)
+        .WillByDefault([this](const SessionCheckpoint& checkpoint) {
+          ++num_restores;
+          return absl::OkStatus();
+        });
+    return session;
+  }
+
+  bool supports_checkpoints = true;
+  mutable int num_sessions = 0;
+  mutable int num_prefilled_contents = 0;
+  mutable int num_restores = 0;
+};
+
+std::vector<InputData> CreatePreface() {
+  std::vector<InputData> preface;
+  preface.emplace_back(InputText("You are a helpful assistant."));
+  return preface;
+}
+
+TEST(SessionPoolTest, CreateFailsWithoutSessions) {
+  CountingEngine engine;
+  EXPECT_THAT(SessionPool::Create(engine, SessionConfig::CreateDefault(),
+                                  /*num_sessions=*/0),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(SessionPoolTest, PrefillsThePrefaceUpFront) {
+  CountingEngine engine;
+  ASSERT_OK_AND_ASSIGN(
+      auto pool, SessionPool::Create(engine, SessionConfig::CreateDefault(),
+                                     /*num_sessions=*/2, CreatePreface()));
+  EXPECT_EQ(pool->GetNumReadySessions(), 2);
+  EXPECT_EQ(engine.num_sessions, 2);
+  EXPECT_EQ(engine.num_prefilled_contents, 2);
+}
+
+TEST(SessionPoolTest, RestoresTheReturnedSessionsToThePreface) {
+  CountingEngine engine;
+  ASSERT_OK_AND_ASSIGN(
+      auto pool, SessionPool::Create(engine, SessionConfig::CreateDefault(),
+                                     /*num_sessions=*/2, CreatePreface()));
+  {
+    ASSERT_OK_AND_ASSIGN(SessionPool::PooledSession session,
+                         pool->Checkout());
+    EXPECT_EQ(pool->GetNumReadySessions(), 1);
+  }
+  EXPECT_EQ(pool->GetNumReadySessions(), 2);
+  EXPECT_EQ(engine.num_restores, 1);
+  // Neither created nor prefilled again.
+  EXPECT_EQ(engine.num_sessions, 2);
+  EXPECT_EQ(engine.num_prefilled_contents, 2);
+  EXPECT_EQ(pool->GetNumExtraCreations(), 0);
+}
+
+TEST(SessionPoolTest, CreatesSessionsBeyondThePoolOnDemand) {
+  CountingEngine engine;
+  ASSERT_OK_AND_ASSIGN(
+      auto pool, SessionPool::Create(engine, SessionConfig::CreateDefault(),
+                                     /*num_sessions=*/1, CreatePreface()));
+  {
+    ASSERT_OK_AND_ASSIGN(SessionPool::PooledSession first, pool->Checkout());
+    ASSERT_OK_AND_ASSIGN(SessionPool::PooledSession second, pool->Checkout());
+    EXPECT_EQ(pool->GetNumExtraCreations(), 1);
+    EXPECT_EQ(engine.num_prefilled_contents, 2);
+  }
+  // The extra session is not kept.
+  EXPECT_EQ(pool->GetNumReadySessions(), 1);
+}
+
+TEST(SessionPoolTest, ReplacesTheSessionsWithoutCheckpoints) {
+  CountingEngine engine;
+  engine.supports_checkpoints = false;
+  ASSERT_OK_AND_ASSIGN(
+      auto pool, SessionPool::Create(engine, SessionConfig::CreateDefault(),
+                                     /*num_sessions=*/1, CreatePreface()));
+  {
+    ASSERT_OK_AND_ASSIGN(SessionPool::PooledSession session,
+                         pool->Checkout());
+  }
+  EXPECT_EQ(pool->GetNumReadySessions(), 1);
+  EXPECT_EQ(pool->GetNumExtraCreations(), 1);
+  EXPECT_EQ(engine.num_sessions, 2);
+  EXPECT_EQ(engine.num_restores, 0);
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -29,7 +29,10 @@ ABSL_FLAG(std::optional<std::string>, audio_backend, std::nullopt,
 ABSL_FLAG(std::string, sampler_backend, "",
           "Sampler backend to use for LLM execution (cpu, gpu, etc.). If "
           "empty, the sampler backend will be chosen for the best according to "
-          "the main executor, for example, gpu for gpu main executor.");
+          "the main executor, for example, gpu for gpu main executor. If "
+          "auto, the sessions measure the sampler of the main executor against "
+          "a cpu sampler and use the faster one, unless the tuning profile "
+          "has the faster one already.");
 ABSL_FLAG(std::string, expected_output, "",
           "If not empty, the output will be checked against this string. If "
           "the output does not contain the string, the program will exit with "
@@ -67,6 +70,12 @@ ABSL_FLAG(bool, multi_turns, false,
 ABSL_FLAG(int, num_cpu_threads, 0,
           "If greater than 0, the number of CPU threads to use for the LLM "
           "execution with CPU backend.");
+ABSL_FLAG(std::string, cpu_affinity, "",
+          "The cpus the engine and executor threads run on, e.g. 0-15,32-47. "
+          "If empty, the cpus of --numa_node if set, any cpu otherwise.");
+ABSL_FLAG(int, numa_node, -1,
+          "If not negative, the NUMA node the engine threads and the model "
+          "weights are placed on.");
 ABSL_FLAG(bool, gpu_external_tensor_mode, false,
           "If false (by default), the GPU backend will use no external tensor "
           "mode which runs slightly faster during decode. It should be set "
@@ -91,3 +100,63 @@ ABSL_FLAG(bool, gpu_madvise_original_shared_tensors, true,
           "If true, the GPU backend will madvise the original shared tensors "
           "after use.");
 ABSL_FLAG(bool, disable_cache, false, "Disable weight cache.");
+ABSL_FLAG(std::string, kv_cache_data_type, "float",
+          "The type the kv-cache is stored as: float, int8 or fp8. The "
+          "quantized types fit more concurrent long sessions in memory.");
+ABSL_FLAG(int, max_resident_memory_mb, 0,
+          "The resident memory in MB above which the engine drops its caches "
+          "and idle vision and audio executors. 0 for no limit.");
+ABSL_FLAG(int, num_warm_up_decode_steps, 0,
+          "If positive, the engine creation warms the model up with a "
+          "prefill of the input prompt and this number of decode steps, so "
+          "that the first request runs as fast as the next ones.");
+ABSL_FLAG(std::string, tuning_profile, "",
+          "The JSON file of the cpu thread counts and prefill batch sizes "
+          "tuned per model and device. If set, the tuned configuration of the "
+          "model applies to the flags left at their defaults.");
+ABSL_FLAG(bool, autotune, false,
+          "If true, measure the cpu thread counts and prefill batch sizes "
+          "with short calibration runs first, and save the fastest to "
+          "--tuning_profile.");
+ABSL_FLAG(std::string, trace_file, "",
+          "If not empty, record the engine execution and write it to this "
+          "file in the Chrome JSON trace format, which chrome://tracing and "
+          "the Perfetto UI open.");
+ABSL_FLAG(std::string, benchmark_sweep, "",
+          "If not empty, benchmark every combination of the values listed, "
+          "e.g. \"backend=cpu,gpu;num_cpu_threads=4,8;prefill_batch_size=128,"
+          "512;num_output_candidates=1,2;prefill_tokens=128,1024;decode_tokens="
+          "128\", in one process, and write the report to "
+          "--benchmark_report. The dimensions left out take the values of "
+          "their flags.");
+ABSL_FLAG(std::string, load_test, "",
+          "If not empty, drive the engine with concurrent sessions instead of "
+          "the input prompt and report the throughput and latency "
+          "percentiles, e.g. \"sessions=8;requests=64;arrival_rate=4;"
+          "prompt_words=32-512;preface_words=256;max_output_steps=128\". An "
+          "arrival_rate of 0 runs a closed loop.");
+ABSL_FLAG(std::string, decode_replay, "",
+          "If not empty, record the prefill and decode turns of the session, "
+          "their token ids, sampler parameters and timings, to this file for "
+          "--replay_decode.");
+ABSL_FLAG(std::string, replay_decode, "",
+          "If not empty, replay the turns recorded with --decode_replay in "
+          "this file instead of the input prompt, and report the recorded "
+          "and replayed timings of each turn.");
+ABSL_FLAG(std::string, benchmark_report, "",
+          "The file the benchmark sweep report is written to, as CSV if it "
+          "ends with .csv and as JSON otherwise.");
+ABSL_FLAG(std::string, benchmark_baseline, "",
+          "If not empty, run the benchmark --benchmark_num_runs times and fail "
+          "if the prefill or decode throughput, time to first token or peak "
+          "memory regressed from this baseline file by more than "
+          "--benchmark_regression_threshold.");
+ABSL_FLAG(int, benchmark_num_runs, 3,
+          "The number of runs of the benchmark regression gate, of which the "
+          "median is compared and the spread tolerated.");
+ABSL_FLAG(double, benchmark_regression_threshold, 0.05,
+          "The relative regression from the benchmark baseline tolerated, "
+          "e.g. 0.05 for 5%.");
+ABSL_FLAG(bool, update_benchmark_baseline, false,
+          "If true, write the runs of the benchmark regression gate to "
+          "--benchmark_baseline instead of comparing them.");
@@ -40,6 +40,8 @@ ABSL_DECLARE_FLAG(bool, report_peak_memory_footprint);
 ABSL_DECLARE_FLAG(bool, force_f32);
 ABSL_DECLARE_FLAG(bool, multi_turns);
 ABSL_DECLARE_FLAG(int, num_cpu_threads);
+ABSL_DECLARE_FLAG(std::string, cpu_affinity);
+ABSL_DECLARE_FLAG(int, numa_node);
 ABSL_DECLARE_FLAG(bool, gpu_external_tensor_mode);
 ABSL_DECLARE_FLAG(bool, configure_magic_numbers);
 ABSL_DECLARE_FLAG(bool, verify_magic_numbers);
@@ -48,5 +50,20 @@ ABSL_DECLARE_FLAG(int, num_logits_to_print_after_decode);
 ABSL_DECLARE_FLAG(std::string, score_target_text);
 ABSL_DECLARE_FLAG(bool, gpu_madvise_original_shared_tensors);
 ABSL_DECLARE_FLAG(bool, disable_cache);
+ABSL_DECLARE_FLAG(std::string, kv_cache_data_type);
+ABSL_DECLARE_FLAG(int, max_resident_memory_mb);
+ABSL_DECLARE_FLAG(int, num_warm_up_decode_steps);
+ABSL_DECLARE_FLAG(std::string, tuning_profile);
+ABSL_DECLARE_FLAG(bool, autotune);
+ABSL_DECLARE_FLAG(std::string, trace_file);
+ABSL_DECLARE_FLAG(std::string, benchmark_sweep);
+ABSL_DECLARE_FLAG(std::string, benchmark_report);
+ABSL_DECLARE_FLAG(std::string, load_test);
+ABSL_DECLARE_FLAG(std::string, decode_replay);
+ABSL_DECLARE_FLAG(std::string, replay_decode);
+ABSL_DECLARE_FLAG(std::string, benchmark_baseline);
+ABSL_DECLARE_FLAG(int, benchmark_num_runs);
+ABSL_DECLARE_FLAG(double, benchmark_regression_threshold);
+ABSL_DECLARE_FLAG(bool, update_benchmark_baseline);
 
 #endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_SHARED_FLAGS_H_
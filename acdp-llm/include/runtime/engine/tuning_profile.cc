@@ -0,0 +1,103 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/tuning_profile.h"
+
+#include <fstream>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "nlohmann/json.hpp"  // from @nlohmann_json
+#include "runtime/util/model_cache.h"
+
+namespace litert::lm {
+
+using ::nlohmann::json;
+
+// static
+absl::StatusOr<TuningProfile> TuningProfile::Load(absl::string_view path) {
+  TuningProfile profile;
+  std::ifstream file{std::string(path)};
+  if (!file.is_open()) {
+    return profile;
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  const json profile_json =
+      json::parse(contents.str(), /*cb=*/nullptr, /*allow_exceptions=*/false);
+  if (!profile_json.is_object()) {
+    return absl::DataLossError(
+        absl::StrCat("The tuning profile ", path, " is not a JSON object."));
+  }
+  for (const auto& [key, config_json] : profile_json.items()) {
+    if (!config_json.is_object()) {
+      return absl::DataLossError(absl::StrCat(
+          "The tuning profile ", path, " has an invalid entry: ", key));
+    }
+    TunedConfig config;
+    config.num_cpu_threads = config_json.value("num_cpu_threads", 0);
+    config.prefill_batch_sizes =
+        config_json.value("prefill_batch_sizes", std::set<int>());
+    config.sampler_backend =
+        config_json.value("sampler_backend", std::string());
+    config.prefill_tokens_per_sec =
+        config_json.value("prefill_tokens_per_sec", 0.0);
+    config.decode_tokens_per_sec =
+        config_json.value("decode_tokens_per_sec", 0.0);
+    profile.configs_[key] = config;
+  }
+  return profile;
+}
+
+absl::Status TuningProfile::Save(absl::string_view path) const {
+  json profile_json = json::object();
+  for (const auto& [key, config] : configs_) {
+    profile_json[key] = {
+        {"num_cpu_threads", config.num_cpu_threads},
+        {"prefill_batch_sizes", config.prefill_batch_sizes},
+        {"sampler_backend", config.sampler_backend},
+        {"prefill_tokens_per_sec", config.prefill_tokens_per_sec},
+        {"decode_tokens_per_sec", config.decode_tokens_per_sec},
+    };
+  }
+  return WriteFileAtomically(path, profile_json.dump(/*indent=*/2));
+}
+
+// static
+std::string TuningProfile::GetKey(absl::string_view model_fingerprint,
+                                  absl::string_view backend) {
+  return absl::StrCat(model_fingerprint, "/", backend, "-",
+                      GetHostArchitecture(), "-",
+                      std::thread::hardware_concurrency(), "cpus");
+}
+
+std::optional<TunedConfig> TuningProfile::Find(absl::string_view key) const {
+  if (auto it = configs_.find(key); it != configs_.end()) {
+    return it->second;
+  }
+  return std::nullopt;
+}
+
+void TuningProfile::Set(absl::string_view key, const TunedConfig& config) {
+  configs_.insert_or_assign(std::string(key), config);
+}
+
+}  // namespace litert::lm
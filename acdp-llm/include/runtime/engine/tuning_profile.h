@@ -0,0 +1,74 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_TUNING_PROFILE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_TUNING_PROFILE_H_
+
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// The execution parameters measured to run a model the fastest on a device.
+struct TunedConfig {
+  // The number of cpu threads of the executor, 0 for its default.
+  int num_cpu_threads = 0;
+  // The maximum numbers of tokens prefilled at once. Empty for the default.
+  std::set<int> prefill_batch_sizes;
+  // The backend of the sampler measured the fastest, e.g. "cpu" when the
+  // host samples faster than the gpu executor. Empty for the default.
+  std::string sampler_backend;
+  // The throughputs measured with the configuration, for reference.
+  double prefill_tokens_per_sec = 0;
+  double decode_tokens_per_sec = 0;
+};
+
+// The tuned configurations of the models on the devices they were tuned on,
+// persisted as a JSON file, so that the tuning runs once per model and
+// device. A model is identified by its fingerprint, see
+// ComputeModelFingerprint(), so that its copies share the configuration.
+class TuningProfile {
+ public:
+  // Loads the profile at `path`, or returns an empty profile if there is no
+  // file at `path` yet.
+  static absl::StatusOr<TuningProfile> Load(absl::string_view path);
+
+  // Writes the profile to `path`, replacing the previous file atomically.
+  absl::Status Save(absl::string_view path) const;
+
+  // Returns the key of the model of `model_fingerprint` run on `backend` of
+  // this host: the architecture and the number of cpus of the host tell the
+  // machine types apart.
+  static std::string GetKey(absl::string_view model_fingerprint,
+                            absl::string_view backend);
+
+  // Returns the configuration of `key`, or std::nullopt if not tuned yet.
+  std::optional<TunedConfig> Find(absl::string_view key) const;
+
+  // Sets the configuration of `key`, replacing the previous one.
+  void Set(absl::string_view key, const TunedConfig& config);
+
+ private:
+  std::map<std::string, TunedConfig, std::less<>> configs_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_ENGINE_TUNING_PROFILE_H_
@@ -0,0 +1,85 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/engine/tuning_profile.h"
+
+#include <filesystem>  // NOLINT: Required for path manipulation.
+#include <fstream>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::status::StatusIs;
+
+std::string GetTestPath(absl::string_view name) {
+  return (std::filesystem::path(::testing::TempDir()) / std::string(name))
+      .string();
+}
+
+TEST(TuningProfileTest, MissingFileLoadsEmptyProfile) {
+  auto profile = TuningProfile::Load(GetTestPath("missing_profile.json"));
+  ASSERT_OK(profile);
+  EXPECT_EQ(profile->Find("model/cpu"), std::nullopt);
+}
+
+TEST(TuningProfileTest, SaveAndLoad) {
+  const std::string path = GetTestPath("profile.json");
+  TuningProfile profile;
+  TunedConfig config;
+  config.num_cpu_threads = 4;
+  config.prefill_batch_sizes = {128, 512};
+  config.sampler_backend = "cpu";
+  config.prefill_tokens_per_sec = 1000;
+  config.decode_tokens_per_sec = 20;
+  profile.Set("model/cpu", config);
+  config.num_cpu_threads = 8;
+  profile.Set("model/cpu", config);
+  ASSERT_OK(profile.Save(path));
+
+  auto loaded_profile = TuningProfile::Load(path);
+  ASSERT_OK(loaded_profile);
+  auto loaded_config = loaded_profile->Find("model/cpu");
+  ASSERT_TRUE(loaded_config.has_value());
+  EXPECT_EQ(loaded_config->num_cpu_threads, 8);
+  EXPECT_THAT(loaded_config->prefill_batch_sizes, ElementsAre(128, 512));
+  EXPECT_EQ(loaded_config->sampler_backend, "cpu");
+  EXPECT_EQ(loaded_config->prefill_tokens_per_sec, 1000);
+  EXPECT_EQ(loaded_config->decode_tokens_per_sec, 20);
+  EXPECT_EQ(loaded_profile->Find("model/gpu"), std::nullopt);
+}
+
+TEST(TuningProfileTest, LoadFailsOnInvalidFile) {
+  const std::string path = GetTestPath("invalid_profile.json");
+  std::ofstream(path) << "not json";
+  EXPECT_THAT(TuningProfile::Load(path),
+              StatusIs(absl::StatusCode::kDataLoss));
+}
+
+TEST(TuningProfileTest, KeysTellTheModelsAndBackendsApart) {
+  EXPECT_NE(TuningProfile::GetKey("model_1", "cpu"),
+            TuningProfile::GetKey("model_2", "cpu"));
+  EXPECT_NE(TuningProfile::GetKey("model_1", "cpu"),
+            TuningProfile::GetKey("model_1", "gpu"));
+}
+
+}  // namespace
+}  // namespace litert::lm
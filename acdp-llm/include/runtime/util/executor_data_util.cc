@@ -15,6 +15,8 @@
 #include "runtime/util/executor_data_util.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -51,9 +53,9 @@ absl::StatusOr<T> CombineExecutorDataImpl(std::vector<T>& executor_data) {
                    executor_data[0].GetEmbeddingsPtr());
   LITERT_ASSIGN_OR_RETURN(auto first_tensor_type, first_tensor->TensorType());
   auto first_tensor_dims = TensorBufferDims(*first_tensor);
-  int total_token_num = 0;
-  int total_packed_size = 0;
-  std::vector<int> combined_token_num;
+  // 64-bit, so that the many embeddings of a large batch do not overflow.
+  int64_t total_token_num = 0;
+  size_t total_packed_size = 0;
   for (const auto& executor_data : executor_data) {
     ASSIGN_OR_RETURN(const auto* embeddings_ptr,
                      executor_data.GetEmbeddingsPtr());
@@ -62,22 +64,36 @@ absl::StatusOr<T> CombineExecutorDataImpl(std::vector<T>& executor_data) {
       return absl::InvalidArgumentError(
           "The embedding tensor type must have 3 or 4 dimensions.");
     }
-    combined_token_num.push_back(dims[dims.size() - 2]);
-    total_token_num += dims[dims.size() - 2];
+    // The embeddings are concatenated along the token dimension, so all the
+    // other dimensions must match.
+    const int token_dim = dims.size() - 2;
+    if (dims.size() != first_tensor_dims.size() ||
+        dims[0] != first_tensor_dims[0] ||
+        dims.back() != first_tensor_dims.back() ||
+        (dims.size() == 4 && dims[1] != first_tensor_dims[1])) {
+      return absl::InvalidArgumentError(
+          "The embedding tensors must only differ in the number of tokens.");
+    }
+    total_token_num += dims[token_dim];
     LITERT_ASSIGN_OR_RETURN(size_t packed_size, embeddings_ptr->PackedSize());
     total_packed_size += packed_size;
   }
+  if (total_token_num > std::numeric_limits<int>::max()) {
+    return absl::InvalidArgumentError(
+        "The combined embeddings have too many tokens.");
+  }
+  const int combined_token_num = total_token_num;
   Layout combined_layout;
   if constexpr (std::is_same_v<T, ExecutorAudioData>) {
     combined_layout = Layout(Dimensions(
-        {first_tensor_dims[0], total_token_num, first_tensor_dims[2]}));
+        {first_tensor_dims[0], combined_token_num, first_tensor_dims[2]}));
   } else if (first_tensor_dims.size() == 3) {
     combined_layout = Layout(Dimensions(
-        {first_tensor_dims[0], 1, total_token_num, first_tensor_dims[2]}));
+        {first_tensor_dims[0], 1, combined_token_num, first_tensor_dims[2]}));
   } else if (first_tensor_dims.size() == 4) {
     combined_layout =
         Layout(Dimensions({first_tensor_dims[0], first_tensor_dims[1],
-                           total_token_num, first_tensor_dims[3]}));
+                           combined_token_num, first_tensor_dims[3]}));
   }
   ::litert::RankedTensorType combined_tensor_type(
       first_tensor_type.ElementType(), std::move(combined_layout));
@@ -92,10 +108,18 @@ absl::StatusOr<T> CombineExecutorDataImpl(std::vector<T>& executor_data) {
                                                TensorBuffer::LockMode::kWrite));
   char* combined_tensor_buffer_ptr =
       static_cast<char*>(combined_embeddings_lock_and_addr.second);
+  int num_valid_tokens = 0;
   for (int i = 0; i < num_executor_data; ++i) {
+    // Consumes the embeddings, so that each is freed once copied rather than
+    // all of them being held along with the combined tensor buffer.
+    T consumed_data = std::move(executor_data[i]);
+    if constexpr (std::is_same_v<T, ExecutorAudioData>) {
+      num_valid_tokens += consumed_data.GetValidTokens();
+    }
     ASSIGN_OR_RETURN(auto embeddings_ptr,
-                     executor_data[i].GetMutableEmbeddingsPtr());
-    LITERT_ASSIGN_OR_RETURN(auto embeddings_size, embeddings_ptr->PackedSize());
+                     consumed_data.GetMutableEmbeddingsPtr());
+    LITERT_ASSIGN_OR_RETURN(size_t embeddings_size,
+                            embeddings_ptr->PackedSize());
     LITERT_ASSIGN_OR_RETURN(
         auto embeddings_lock_and_addr,
         ::litert::TensorBufferScopedLock::Create(
@@ -108,13 +132,9 @@ absl::StatusOr<T> CombineExecutorDataImpl(std::vector<T>& executor_data) {
     return ExecutorVisionData(std::move(combined_tensor_buffer),
                               /*per_layer_embeddings=*/std::nullopt);
   } else if constexpr (std::is_same_v<T, ExecutorAudioData>) {
-    int num_audio_tokens = 0;
-    for (const auto& executor_data : executor_data) {
-      num_audio_tokens += executor_data.GetValidTokens();
-    }
     return ExecutorAudioData(std::move(combined_tensor_buffer),
                              /*per_layer_embeddings=*/std::nullopt,
-                             num_audio_tokens);
+                             num_valid_tokens);
   } else {
     return absl::InvalidArgumentError("Executor data type is not supported.");
   }
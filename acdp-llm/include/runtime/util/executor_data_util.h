@@ -45,6 +45,9 @@ namespace litert::lm {
 // The output ExecutorVisionData will have TensorBuffer with shape,
 // [batch_size, dim1, num_token_1 + num_token_2 + ... + num_token_n,
 // feature_dim].
+//
+// The embeddings of the elements are consumed, and freed as soon as copied.
+// The elements must only differ in the number of tokens.
 absl::StatusOr<ExecutorVisionData> CombineExecutorVisionData(
     std::vector<ExecutorVisionData>& executor_data);
 
@@ -60,6 +63,9 @@ absl::StatusOr<ExecutorVisionData> CombineExecutorVisionData(
 //  [batch_size, num_token_n, feature_dim].
 // The output ExecutorAudioData will have TensorBuffer with shape,
 // [batch_size, num_token_1 + num_token_2 + ... + num_token_n, feature_dim].
+//
+// The embeddings of the elements are consumed, and freed as soon as copied.
+// The elements must only differ in the number of tokens.
 absl::StatusOr<ExecutorAudioData> CombineExecutorAudioData(
     std::vector<ExecutorAudioData>& executor_data);
 
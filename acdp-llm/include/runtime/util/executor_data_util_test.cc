@@ -211,6 +211,27 @@ TEST(ExecutorDataUtilTest, CombineExecutorAudioDataMultiSuccess) {
                           11.0, 12.0));
 }
 
+TEST(ExecutorDataUtilTest, CombineExecutorAudioDataMismatchedShapesFails) {
+  std::vector<ExecutorAudioData> executor_data;
+
+  ExecutorAudioData executor_audio_data_1;
+  LITERT_ASSERT_OK_AND_ASSIGN(
+      auto audio_buffer_1,
+      CopyToTensorBuffer<float>({1.0, 2.0, 3.0, 4.0}, {1, 2, 2}));
+  executor_audio_data_1.SetEmbeddings(std::move(audio_buffer_1));
+  executor_data.push_back(std::move(executor_audio_data_1));
+
+  ExecutorAudioData executor_audio_data_2;
+  LITERT_ASSERT_OK_AND_ASSIGN(
+      auto audio_buffer_2,
+      CopyToTensorBuffer<float>({5.0, 6.0, 7.0, 8.0}, {1, 1, 4}));
+  executor_audio_data_2.SetEmbeddings(std::move(audio_buffer_2));
+  executor_data.push_back(std::move(executor_audio_data_2));
+
+  EXPECT_THAT(CombineExecutorAudioData(executor_data),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 TEST(ExecutorDataUtilTest, CombineExecutorVisionDataEmptyFails) {
   std::vector<ExecutorVisionData> executor_data;
   EXPECT_THAT(
@@ -0,0 +1,123 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/util/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "absl/numeric/bits.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+
+namespace litert::lm {
+namespace {
+
+// Each power of two above kNumSubBuckets is split into kNumSubBuckets / 2
+// buckets, the latencies below 2 * kNumSubBuckets have a bucket each.
+constexpr int kSubBucketBits = 5;
+constexpr int kNumSubBuckets = 1 << kSubBucketBits;
+constexpr int kNumLinearBuckets = 2 * kNumSubBuckets;
+// The latencies are clamped to 2^kMaxLatencyBits us.
+constexpr int kMaxLatencyBits = 41;
+constexpr int64_t kMaxLatencyUs = (int64_t{1} << kMaxLatencyBits) - 1;
+constexpr int kNumBuckets =
+    kNumLinearBuckets +
+    (kMaxLatencyBits - kSubBucketBits - 1) * kNumSubBuckets;
+
+}  // namespace
+
+// static
+int LatencyHistogram::GetBucket(int64_t latency_us) {
+  if (latency_us < kNumLinearBuckets) {
+    return latency_us;
+  }
+  // The bits below the kSubBucketBits + 1 leading ones are dropped.
+  const int magnitude =
+      absl::bit_width(static_cast<uint64_t>(latency_us)) - 1;
+  const int shift = magnitude - kSubBucketBits;
+  const int sub_bucket = (latency_us >> shift) - kNumSubBuckets;
+  return kNumLinearBuckets + (shift - 1) * kNumSubBuckets + sub_bucket;
+}
+
+// static
+int64_t LatencyHistogram::GetBucketUpperBound(int bucket) {
+  if (bucket < kNumLinearBuckets) {
+    return bucket;
+  }
+  const int shift = (bucket - kNumLinearBuckets) / kNumSubBuckets + 1;
+  const int sub_bucket = (bucket - kNumLinearBuckets) % kNumSubBuckets;
+  return ((int64_t{kNumSubBuckets + sub_bucket + 1}) << shift) - 1;
+}
+
+void LatencyHistogram::Record(absl::Duration latency) {
+  const int64_t latency_us = std::clamp<int64_t>(
+      absl::ToInt64Microseconds(latency), 0, kMaxLatencyUs);
+  if (counts_.empty()) {
+    counts_.resize(kNumBuckets);
+  }
+  ++counts_[GetBucket(latency_us)];
+  ++count_;
+  sum_us_ += latency_us;
+  max_us_ = std::max(max_us_, latency_us);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  if (other.count_ == 0) {
+    return;
+  }
+  if (counts_.empty()) {
+    counts_.resize(kNumBuckets);
+  }
+  for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+    counts_[bucket] += other.counts_[bucket];
+  }
+  count_ += other.count_;
+  sum_us_ += other.sum_us_;
+  max_us_ = std::max(max_us_, other.max_us_);
+}
+
+void LatencyHistogram::Clear() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  count_ = 0;
+  sum_us_ = 0;
+  max_us_ = 0;
+}
+
+absl::Duration LatencyHistogram::GetMean() const {
+  if (count_ == 0) {
+    return absl::ZeroDuration();
+  }
+  return absl::Microseconds(sum_us_) / count_;
+}
+
+absl::Duration LatencyHistogram::GetPercentile(double percentile) const {
+  if (count_ == 0) {
+    return absl::ZeroDuration();
+  }
+  // The rank of the latency at the percentile, from 1.
+  const int64_t rank = std::clamp<int64_t>(
+      static_cast<int64_t>(std::ceil(percentile / 100.0 * count_)), 1, count_);
+  int64_t num_latencies = 0;
+  for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+    num_latencies += counts_[bucket];
+    if (num_latencies >= rank) {
+      return absl::Microseconds(
+          std::min(GetBucketUpperBound(bucket), max_us_));
+    }
+  }
+  return GetMax();
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,74 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_LATENCY_HISTOGRAM_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_LATENCY_HISTOGRAM_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/time/time.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// A histogram of latencies with buckets of bounded relative width, in the
+// manner of HDR histograms: the latencies are exact below 64us, and within
+// 1/32 of their value above, up to about 25 days. Recording a latency is an
+// increment, so that the distributions can be kept on every decode step, and
+// histograms merge, e.g. the ones of the sessions of an engine.
+//
+// Example usage:
+//   LatencyHistogram histogram;
+//   histogram.Record(absl::Milliseconds(12));
+//   absl::Duration p99 = histogram.GetPercentile(99);
+//
+// The class is not thread-safe.
+class LatencyHistogram {
+ public:
+  // Records `latency`, the negative ones as 0.
+  void Record(absl::Duration latency);
+
+  // Adds the latencies recorded by `other`.
+  void Merge(const LatencyHistogram& other);
+
+  // Drops all the latencies.
+  void Clear();
+
+  // Returns the number of latencies recorded.
+  int64_t GetCount() const { return count_; }
+
+  // Returns the mean and the maximum of the latencies, 0 when empty.
+  absl::Duration GetMean() const;
+  absl::Duration GetMax() const { return absl::Microseconds(max_us_); }
+
+  // Returns the latency at `percentile`, in [0, 100], e.g. 99 for the p99.
+  // The latency is the upper bound of its bucket, so it overestimates the
+  // exact percentile by less than 1/32. Returns 0 when empty.
+  absl::Duration GetPercentile(double percentile) const;
+
+ private:
+  // The bucket of `latency_us`, and the largest latency of `bucket`.
+  static int GetBucket(int64_t latency_us);
+  static int64_t GetBucketUpperBound(int bucket);
+
+  // The counts of the buckets, allocated on the first record.
+  std::vector<int64_t> counts_;
+  int64_t count_ = 0;
+  int64_t sum_us_ = 0;
+  int64_t max_us_ = 0;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_LATENCY_HISTOGRAM_H_
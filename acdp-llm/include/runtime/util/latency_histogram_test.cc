@@ -0,0 +1,86 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/util/latency_histogram.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/time/time.h"  // from @com_google_absl
+
+namespace litert::lm {
+namespace {
+
+TEST(LatencyHistogramTest, EmptyHistogram) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.GetCount(), 0);
+  EXPECT_EQ(histogram.GetMean(), absl::ZeroDuration());
+  EXPECT_EQ(histogram.GetMax(), absl::ZeroDuration());
+  EXPECT_EQ(histogram.GetPercentile(50), absl::ZeroDuration());
+}
+
+TEST(LatencyHistogramTest, SmallLatenciesAreExact) {
+  LatencyHistogram histogram;
+  for (int i = 1; i <= 50; ++i) {
+    histogram.Record(absl::Microseconds(i));
+  }
+  EXPECT_EQ(histogram.GetCount(), 50);
+  EXPECT_EQ(histogram.GetPercentile(0), absl::Microseconds(1));
+  EXPECT_EQ(histogram.GetPercentile(50), absl::Microseconds(25));
+  EXPECT_EQ(histogram.GetPercentile(90), absl::Microseconds(45));
+  EXPECT_EQ(histogram.GetPercentile(100), absl::Microseconds(50));
+  EXPECT_EQ(histogram.GetMax(), absl::Microseconds(50));
+}
+
+TEST(LatencyHistogramTest, LargeLatenciesAreWithinTheRelativeError) {
+  LatencyHistogram histogram;
+  for (int i = 1; i <= 1000; ++i) {
+    histogram.Record(absl::Milliseconds(i));
+  }
+  for (double percentile : {50.0, 90.0, 99.0}) {
+    const absl::Duration exact = absl::Milliseconds(percentile * 10);
+    const absl::Duration estimate = histogram.GetPercentile(percentile);
+    EXPECT_GE(estimate, exact);
+    EXPECT_LE(estimate, exact + exact / 32);
+  }
+  EXPECT_EQ(histogram.GetPercentile(100), absl::Milliseconds(1000));
+  EXPECT_EQ(histogram.GetMean(), absl::Microseconds(500500));
+}
+
+TEST(LatencyHistogramTest, ClampsTheOutOfRangeLatencies) {
+  LatencyHistogram histogram;
+  histogram.Record(-absl::Seconds(1));
+  histogram.Record(absl::Hours(24 * 365));
+  EXPECT_EQ(histogram.GetPercentile(0), absl::ZeroDuration());
+  EXPECT_GT(histogram.GetPercentile(100), absl::Hours(24 * 25));
+}
+
+TEST(LatencyHistogramTest, MergeAddsTheLatencies) {
+  LatencyHistogram histogram;
+  LatencyHistogram other;
+  histogram.Record(absl::Microseconds(10));
+  other.Record(absl::Microseconds(20));
+  other.Record(absl::Microseconds(30));
+  histogram.Merge(other);
+  histogram.Merge(LatencyHistogram());
+  EXPECT_EQ(histogram.GetCount(), 3);
+  EXPECT_EQ(histogram.GetPercentile(50), absl::Microseconds(20));
+  EXPECT_EQ(histogram.GetMax(), absl::Microseconds(30));
+
+  histogram.Clear();
+  EXPECT_EQ(histogram.GetCount(), 0);
+  EXPECT_EQ(histogram.GetPercentile(50), absl::ZeroDuration());
+}
+
+}  // namespace
+}  // namespace litert::lm
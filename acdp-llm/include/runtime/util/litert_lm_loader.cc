@@ -15,6 +15,7 @@
 #include "runtime/util/litert_lm_loader.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -24,16 +25,19 @@
 #include <utility>
 #include <vector>
 
-#include "absl/log/absl_check.h"  // from @com_google_absl
 #include "absl/log/absl_log.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/ascii.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
 #include "litert/cc/litert_buffer_ref.h"  // from @litert
 #include "runtime/components/model_resources.h"
 #include "runtime/util/memory_mapped_file.h"
+#include "runtime/util/model_verification.h"
 #include "runtime/util/scoped_file.h"
+#include "runtime/util/status_macros.h"
 #include "schema/core/litertlm_header_schema_generated.h"
 #include "schema/core/litertlm_read.h"
 
@@ -53,14 +57,45 @@ absl::StatusOr<std::unique_ptr<MemoryMappedFile>> CreateMemoryMapFromScopedFile(
 
 constexpr uint64_t kLitertLmHeaderMaxSize = 16 * 1024;
 
+std::atomic<ModelVerificationMode> default_verification_mode =
+    ModelVerificationMode::kSkipWithChecksum;
+
+// Returns the string value of the item of `key` of a section, compared
+// case-insensitively, if any.
+std::optional<std::string> FindStringItem(const schema::SectionObject& section,
+                                          absl::string_view key) {
+  if (section.items() == nullptr) {
+    return std::nullopt;
+  }
+  for (const schema::KeyValuePair* item : *section.items()) {
+    if (item->key() && absl::AsciiStrToLower(item->key()->str()) == key &&
+        item->value_as_StringValue() &&
+        item->value_as_StringValue()->value()) {
+      return item->value_as_StringValue()->value()->str();
+    }
+  }
+  return std::nullopt;
+}
+
 }  // namespace
 
-absl::Status LitertLmLoader::MapSections() {
+// static
+void LitertLmLoader::SetDefaultVerificationMode(ModelVerificationMode mode) {
+  default_verification_mode = mode;
+}
+
+// static
+ModelVerificationMode LitertLmLoader::GetDefaultVerificationMode() {
+  return default_verification_mode;
+}
+
+absl::Status LitertLmLoader::ReadSectionRanges(void* header_data,
+                                               uint64_t header_length,
+                                               uint64_t file_size) {
   schema::LitertlmHeader header;
   // Read the header information.
   absl::Status status = ReadHeaderFromLiteRTLM(
-      memory_mapped_file_->data(),
-      std::min(kLitertLmHeaderMaxSize, memory_mapped_file_->length()), &header);
+      header_data, std::min(kLitertLmHeaderMaxSize, header_length), &header);
   ABSL_LOG(INFO) << "status: " << status;
   ABSL_LOG(INFO) << "major_version: " << header.major_version;
   ABSL_LOG(INFO) << "minor_version: " << header.minor_version;
@@ -70,30 +105,18 @@ absl::Status LitertLmLoader::MapSections() {
     return status;
   }
 
-  // Loop through the sections and map them to the section buffers.
+  // Loop through the sections and record their ranges.
   auto sections = header.metadata->section_metadata()->objects();
   for (size_t i = 0; i < sections->size(); ++i) {
     const schema::SectionObject* section = sections->Get(i);
-    auto items = section->items();
     BufferKey buffer_key(section->data_type());
     // Extract the specific model type from the section items KeyValuePairs.
     if (section->data_type() == schema::AnySectionDataType_TFLiteModel) {
-      bool found_model_type = false;
-      std::string model_type;
-      for (size_t j = 0; j < items->size(); ++j) {
-        auto item = items->Get(j);
-        if (item->key() &&
-            absl::AsciiStrToLower(item->key()->str()) == "model_type" &&
-            item->value()) {
-          found_model_type = true;
-          model_type = *(item->value_as_StringValue()->value());
-          break;
-        }
-      }
-      if (found_model_type) {
-        ABSL_LOG(INFO) << "model_type: " << model_type;
+      if (std::optional<std::string> model_type =
+              FindStringItem(*section, "model_type")) {
+        ABSL_LOG(INFO) << "model_type: " << *model_type;
         buffer_key = BufferKey(section->data_type(),
-                               StringToModelType(model_type).value());
+                               StringToModelType(*model_type).value());
       } else {
         ABSL_LOG(WARNING) << "model_type not found, use kTfLitePrefillDecode";
         // For backward compatibility, we will use the default model type if
@@ -102,9 +125,18 @@ absl::Status LitertLmLoader::MapSections() {
             BufferKey(section->data_type(), ModelType::kTfLitePrefillDecode);
       }
     }
-    section_buffers_[buffer_key] =
-        BufferRef<uint8_t>(static_cast<uint8_t*>(memory_mapped_file_->data()),
-                           section->end_offset(), section->begin_offset());
+    if (section->begin_offset() > section->end_offset() ||
+        section->end_offset() > file_size) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Section ", i, " [", section->begin_offset(), ", ",
+          section->end_offset(), ") is out of the file of size ", file_size));
+    }
+    section_ranges_[buffer_key] = {
+        .begin_offset = section->begin_offset(),
+        .end_offset = section->end_offset(),
+        .uncompressed = FindStringItem(*section, "compression") == "none",
+        .checksum = FindStringItem(*section, kChecksumItemKey),
+    };
     ABSL_LOG(INFO) << "section_index: " << i;
     ABSL_LOG(INFO) << "section_data_type: "
                    << EnumNameAnySectionDataType(section->data_type());
@@ -114,9 +146,64 @@ absl::Status LitertLmLoader::MapSections() {
   return absl::OkStatus();
 }
 
+absl::Status LitertLmLoader::MapSections() {
+  absl::MutexLock lock(&mutex_);
+  for (const auto& [buffer_key, range] : section_ranges_) {
+    BufferRef<uint8_t> section_buffer(
+        static_cast<uint8_t*>(memory_mapped_file_->data()), range.end_offset,
+        range.begin_offset);
+    RETURN_IF_ERROR(VerifySection(buffer_key, range, section_buffer));
+    section_buffers_[buffer_key] = section_buffer;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status LitertLmLoader::VerifySection(const BufferKey& key,
+                                           const SectionRange& range,
+                                           const BufferRef<uint8_t>& buffer) {
+  const bool verify_model =
+      verification_mode_ != ModelVerificationMode::kSkipWithChecksum &&
+      key.data_type == schema::AnySectionDataType_TFLiteModel;
+  if (!verify_model && !range.checksum.has_value()) {
+    return absl::OkStatus();
+  }
+  auto verify = [name = std::string(EnumNameAnySectionDataType(key.data_type)),
+                 checksum = range.checksum, verify_model, buffer]() {
+    if (verify_model) {
+      RETURN_IF_ERROR(VerifyTfLiteModel(name, buffer.Data(), buffer.Size()));
+    }
+    if (checksum.has_value()) {
+      RETURN_IF_ERROR(VerifyChecksum(name, buffer.StrView(), *checksum));
+    }
+    return absl::OkStatus();
+  };
+  if (verification_mode_ == ModelVerificationMode::kEager) {
+    return verify();
+  }
+  background_verifier_.Schedule(std::move(verify));
+  return absl::OkStatus();
+}
+
 absl::Status LitertLmLoader::Initialize() {
   ABSL_LOG(INFO) << "LitertLmLoader::Initialize";
 
+  if (lazy_loading_) {
+    if (!model_file_.IsValid()) {
+      return absl::InvalidArgumentError("Invalid ScopedFile provided.");
+    }
+    // Only the header is mapped, the sections are mapped on their first
+    // access.
+    ASSIGN_OR_RETURN(size_t file_size, ScopedFile::GetSize(model_file_.file()));
+    ASSIGN_OR_RETURN(
+        std::unique_ptr<MemoryMappedFile> header_file,
+        MemoryMappedFile::Create(model_file_.file(), /*offset=*/0,
+                                 std::min(kLitertLmHeaderMaxSize,
+                                          static_cast<uint64_t>(file_size)),
+                                 "header"));
+    return ReadSectionRanges(header_file->data(), header_file->length(),
+                             file_size);
+  }
+
   absl::StatusOr<std::unique_ptr<MemoryMappedFile>> mmap_status =
       CreateMemoryMapFromScopedFile(model_file_);
 
@@ -127,33 +214,118 @@ absl::Status LitertLmLoader::Initialize() {
   } else {
     ABSL_LOG(ERROR) << "Failed to create memory-mapped file: "
                     << mmap_status.status();
+    return mmap_status.status();
   }
 
-  ABSL_CHECK_OK(MapSections());
+  RETURN_IF_ERROR(ReadSectionRanges(memory_mapped_file_->data(),
+                                    memory_mapped_file_->length(),
+                                    memory_mapped_file_->length()));
+  RETURN_IF_ERROR(MapSections());
 
   return absl::OkStatus();
 }
 
+std::optional<litert::BufferRef<uint8_t>> LitertLmLoader::GetSectionBuffer(
+    const BufferKey& key) {
+  absl::MutexLock lock(&mutex_);
+  if (auto it = section_buffers_.find(key); it != section_buffers_.end()) {
+    return it->second;
+  }
+  auto range_it = section_ranges_.find(key);
+  if (!lazy_loading_ || range_it == section_ranges_.end()) {
+    return std::nullopt;
+  }
+  const SectionRange& range = range_it->second;
+  if (range.begin_offset == range.end_offset) {
+    return litert::BufferRef<uint8_t>();
+  }
+  // The mappings start at the aligned offset before the section.
+  const uint64_t map_offset =
+      range.begin_offset -
+      range.begin_offset % MemoryMappedFile::GetOffsetAlignment();
+  auto mapped_file = MemoryMappedFile::Create(
+      model_file_.file(), map_offset, range.end_offset - map_offset,
+      EnumNameAnySectionDataType(key.data_type));
+  if (!mapped_file.ok()) {
+    ABSL_LOG(ERROR) << "Failed to map section "
+                    << EnumNameAnySectionDataType(key.data_type) << ": "
+                    << mapped_file.status();
+    return std::nullopt;
+  }
+  BufferRef<uint8_t> section_buffer(
+      static_cast<uint8_t*>((*mapped_file)->data()),
+      range.end_offset - map_offset, range.begin_offset - map_offset);
+  if (absl::Status status = VerifySection(key, range, section_buffer);
+      !status.ok()) {
+    ABSL_LOG(ERROR) << "Failed to verify section "
+                    << EnumNameAnySectionDataType(key.data_type) << ": "
+                    << status;
+    return std::nullopt;
+  }
+  section_mapped_files_.push_back(std::move(mapped_file).value());
+  section_buffers_.emplace(key, section_buffer);
+  return section_buffer;
+}
+
+std::optional<litert::BufferRef<uint8_t>>
+LitertLmLoader::GetHuggingFaceTokenizerView() {
+  const BufferKey key(schema::AnySectionDataType_HF_Tokenizer_Zlib);
+  auto section_buffer = GetSectionBuffer(key);
+  if (!section_buffer.has_value()) {
+    return std::nullopt;
+  }
+  // The section ranges don't change after Initialize().
+  if (section_ranges_.at(key).uncompressed) {
+    return section_buffer;
+  }
+
+  absl::MutexLock lock(&mutex_);
+  if (hf_tokenizer_data_.empty()) {
+    const auto& section = *section_buffer;
+    auto status = schema::DecompressData(section.Data(), section.Size(),
+                                         &hf_tokenizer_data_);
+    if (!status.ok()) {
+      ABSL_LOG(ERROR) << "Failed to decompress HuggingFace tokenizer data: "
+                      << status;
+      hf_tokenizer_data_.clear();
+      return std::nullopt;
+    }
+  }
+  return litert::BufferRef<uint8_t>(hf_tokenizer_data_.data(),
+                                    hf_tokenizer_data_.size());
+}
+
 std::optional<litert::OwningBufferRef<uint8_t>>
 LitertLmLoader::GetHuggingFaceTokenizer() {
-  auto section_key = BufferKey(schema::AnySectionDataType_HF_Tokenizer_Zlib);
-  if (!section_buffers_.contains(section_key)) {
+  const BufferKey key(schema::AnySectionDataType_HF_Tokenizer_Zlib);
+  auto section_buffer = GetSectionBuffer(key);
+  if (!section_buffer.has_value()) {
     return std::nullopt;
   }
-  const auto& section = section_buffers_[section_key];
-
+  if (section_ranges_.at(key).uncompressed) {
+    return OwningBufferRef<uint8_t>{section_buffer->Data(),
+                                    section_buffer->Size()};
+  }
+  {
+    absl::MutexLock lock(&mutex_);
+    // Copied from the JSON decompressed for the views, if any.
+    if (!hf_tokenizer_data_.empty()) {
+      return OwningBufferRef<uint8_t>{hf_tokenizer_data_.data(),
+                                      hf_tokenizer_data_.size()};
+    }
+  }
+  // Decompressed for the caller only, so that the loader does not keep a
+  // second copy of the JSON.
   std::vector<uint8_t> hf_tokenizer_data;
-  auto status = schema::DecompressData(section.Data(), section.Size(),
-                                       &hf_tokenizer_data);
+  auto status = schema::DecompressData(
+      section_buffer->Data(), section_buffer->Size(), &hf_tokenizer_data);
   if (!status.ok()) {
     ABSL_LOG(ERROR) << "Failed to decompress HuggingFace tokenizer data: "
                     << status;
     return std::nullopt;
   }
-
-  return OwningBufferRef<uint8_t>{
-      static_cast<const uint8_t*>(hf_tokenizer_data.data()),
-      hf_tokenizer_data.size()};
+  return OwningBufferRef<uint8_t>{hf_tokenizer_data.data(),
+                                  hf_tokenizer_data.size()};
 }
 
 }  // namespace litert::lm
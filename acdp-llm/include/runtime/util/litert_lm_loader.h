@@ -24,13 +24,17 @@
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
 #include "absl/log/absl_check.h"  // from @com_google_absl
 #include "absl/log/absl_log.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
 #include "litert/cc/litert_buffer_ref.h"  // from @litert
 #include "runtime/components/model_resources.h"
 #include "runtime/util/memory_mapped_file.h"
+#include "runtime/util/model_verification.h"
 #include "runtime/util/scoped_file.h"
 #include "schema/core/litertlm_header_schema_generated.h"
 
@@ -78,35 +82,63 @@ struct BufferKeyHash {
 
 // A class to load the Litert LM model from the .litertlm file. The loader will
 // read the model header from and map the sections to the section buffers.
+//
+// By default the whole file is mapped when the loader is created. With
+// `lazy_loading`, only the header is read then, and each section is mapped on
+// its first access, so the sections never used, e.g. the models of the unused
+// modalities, are neither mapped nor read. The getters are thread-safe.
+// The file is mapped with the default MappingOptions, which may read it in
+// with parallel reads instead, see MappingOptions::num_read_threads.
+//
+// The TFLite model sections are verified, and the sections with a checksum
+// item have their checksum compared, as the `verification_mode` says. The
+// sections are verified when mapped: with `kEager`, a section failing the
+// verification is not returned.
 class LitertLmLoader {
  public:
   // Creates a LitertLmLoader from the model file. The loader will read the
-  // model header from and map the sections to the section buffers.
-  explicit LitertLmLoader(ScopedFile model_file)
-      : model_file_(std::move(model_file)) {
+  // model header from and map the sections to the section buffers, or only
+  // read the header with `lazy_loading`.
+  explicit LitertLmLoader(
+      ScopedFile model_file, bool lazy_loading = false,
+      ModelVerificationMode verification_mode = GetDefaultVerificationMode())
+      : model_file_(std::move(model_file)),
+        lazy_loading_(lazy_loading),
+        verification_mode_(verification_mode) {
     ABSL_CHECK_OK(Initialize());
   }
 
+  // Sets the verification mode of the loaders created afterwards without an
+  // explicit one, kSkipWithChecksum by default.
+  static void SetDefaultVerificationMode(ModelVerificationMode mode);
+  static ModelVerificationMode GetDefaultVerificationMode();
+
+  // Waits for the background verification of the sections mapped so far and
+  // returns the first failure, if any.
+  absl::Status WaitForVerification() { return background_verifier_.Wait(); }
+
   // Returns the tokenizer section buffer for the SentencePiece tokenizer.
   // If not found, returns std::nullopt.
   std::optional<litert::BufferRef<uint8_t>> GetSentencePieceTokenizer() {
-    auto section_key = BufferKey(schema::AnySectionDataType_SP_Tokenizer);
-    if (!section_buffers_.contains(section_key)) {
-      return std::nullopt;
-    }
-    return section_buffers_[section_key];
+    return GetSectionBuffer(BufferKey(schema::AnySectionDataType_SP_Tokenizer));
   }
 
-  // Returns the tokenizer section buffer for the HuggingFace tokenizer.
-  // If not found, returns std::nullopt.
+  // Returns the JSON of the HuggingFace tokenizer, valid while the loader is
+  // alive. A section stored with the item "compression" set to "none" is
+  // returned in place, without any copy. Otherwise the section is decompressed
+  // once, on the first call. If not found, returns std::nullopt.
+  std::optional<litert::BufferRef<uint8_t>> GetHuggingFaceTokenizerView();
+
+  // Returns a copy of the JSON of the HuggingFace tokenizer. Unlike the view,
+  // a compressed section is decompressed for the caller only, and not kept by
+  // the loader. If not found, returns std::nullopt.
   std::optional<litert::OwningBufferRef<uint8_t>> GetHuggingFaceTokenizer();
 
   // Returns the TFLite model section buffer.
   litert::BufferRef<uint8_t> GetTFLiteModel(ModelType model_type) {
-    if (section_buffers_.contains(
+    if (auto section_buffer = GetSectionBuffer(
             BufferKey(schema::AnySectionDataType_TFLiteModel, model_type))) {
-      return section_buffers_[BufferKey(schema::AnySectionDataType_TFLiteModel,
-                                        model_type)];
+      return *section_buffer;
     }
     ABSL_LOG(WARNING) << "TFLite model type: " << ModelTypeToString(model_type)
                       << " not found. Skipping.";
@@ -115,25 +147,61 @@ class LitertLmLoader {
 
   // Returns the tokenizer section buffer.
   litert::BufferRef<uint8_t> GetLlmMetadata() {
-    return section_buffers_[BufferKey(
-        schema::AnySectionDataType_LlmMetadataProto)];
+    return GetSectionBuffer(
+               BufferKey(schema::AnySectionDataType_LlmMetadataProto))
+        .value_or(litert::BufferRef<uint8_t>());
   }
 
  private:
+  // The byte range of a section in the model file.
+  struct SectionRange {
+    uint64_t begin_offset;
+    uint64_t end_offset;
+    // Whether the section of a compressed data type is stored uncompressed.
+    bool uncompressed = false;
+    // The checksum item of the section, if any.
+    std::optional<std::string> checksum;
+  };
+
   // Initializes the LitertLmLoader. Includes reading the model header and
   // mapping the sections to the section buffers.
   absl::Status Initialize();
+  // Reads the section ranges from the header of `header_data`.
+  absl::Status ReadSectionRanges(void* header_data, uint64_t header_length,
+                                 uint64_t file_size);
   // Maps the sections to the section buffers.
   absl::Status MapSections();
+  // Returns the buffer of the section, mapping it first with `lazy_loading_`.
+  // If not found or not mappable, returns std::nullopt.
+  std::optional<litert::BufferRef<uint8_t>> GetSectionBuffer(
+      const BufferKey& key);
+  // Verifies the section just mapped as `verification_mode_` says, returning
+  // the failure of an eager verification.
+  absl::Status VerifySection(const BufferKey& key, const SectionRange& range,
+                             const litert::BufferRef<uint8_t>& buffer);
   // The model file to be loaded.
   ScopedFile model_file_;
-  // The model_file_ mapped to a MemoryMappedFile.
+  const bool lazy_loading_;
+  const ModelVerificationMode verification_mode_;
+  // The model_file_ mapped to a MemoryMappedFile, unless `lazy_loading_`.
   ::std::unique_ptr<MemoryMappedFile> memory_mapped_file_;
 
   // TODO (b/413793273): Add the extra names to the key to differentiate
   // between the TFLite models.
+  ::std::unordered_map<BufferKey, SectionRange, BufferKeyHash> section_ranges_;
+
+  absl::Mutex mutex_;
   ::std::unordered_map<BufferKey, BufferRef<uint8_t>, BufferKeyHash>
-      section_buffers_;
+      section_buffers_ ABSL_GUARDED_BY(mutex_);
+  // The mappings of the sections mapped on their first access, with
+  // `lazy_loading_`.
+  ::std::vector<::std::unique_ptr<MemoryMappedFile>> section_mapped_files_
+      ABSL_GUARDED_BY(mutex_);
+  // The HuggingFace tokenizer, once decompressed.
+  ::std::vector<uint8_t> hf_tokenizer_data_ ABSL_GUARDED_BY(mutex_);
+
+  // Last, to be destroyed before the mappings it verifies.
+  BackgroundVerifier background_verifier_;
 };
 
 }  // namespace litert::lm
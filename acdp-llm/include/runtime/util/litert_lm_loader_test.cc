@@ -19,6 +19,7 @@
 
 #include <gtest/gtest.h>
 #include "runtime/components/model_resources.h"
+#include "runtime/util/model_verification.h"
 #include "runtime/util/scoped_file.h"
 
 namespace litert::lm {
@@ -51,5 +52,76 @@ TEST(LitertLmLoaderTest, InitializeWithHuggingFaceFile) {
   ASSERT_FALSE(loader.GetSentencePieceTokenizer());
 }
 
+TEST(LitertLmLoaderTest, GetHuggingFaceTokenizerViewDecompressesOnce) {
+  const auto model_path =
+      std::filesystem::path(::testing::SrcDir()) /
+      "litert_lm/runtime/testdata/test_hf_tokenizer.litertlm";
+  auto model_file = ScopedFile::Open(model_path.string());
+  ASSERT_TRUE(model_file.ok());
+  LitertLmLoader loader(std::move(model_file.value()));
+  auto tokenizer = loader.GetHuggingFaceTokenizerView();
+  ASSERT_TRUE(tokenizer.has_value());
+  EXPECT_EQ(tokenizer->StrView(), loader.GetHuggingFaceTokenizer()->StrView());
+  EXPECT_EQ(loader.GetHuggingFaceTokenizerView()->Data(), tokenizer->Data());
+}
+
+TEST(LitertLmLoaderTest, GetHuggingFaceTokenizerBeforeTheView) {
+  const auto model_path =
+      std::filesystem::path(::testing::SrcDir()) /
+      "litert_lm/runtime/testdata/test_hf_tokenizer.litertlm";
+  auto model_file = ScopedFile::Open(model_path.string());
+  ASSERT_TRUE(model_file.ok());
+  LitertLmLoader loader(std::move(model_file.value()));
+  // The copy is decompressed on its own, the view still decompresses the
+  // section.
+  auto tokenizer = loader.GetHuggingFaceTokenizer();
+  ASSERT_TRUE(tokenizer.has_value());
+  EXPECT_EQ(tokenizer->StrView(),
+            loader.GetHuggingFaceTokenizerView()->StrView());
+}
+
+TEST(LitertLmLoaderTest, LazyLoadingMapsTheSameSections) {
+  const auto model_path =
+      std::filesystem::path(::testing::SrcDir()) /
+      "litert_lm/runtime/testdata/test_lm.litertlm";
+  auto model_file = ScopedFile::Open(model_path.string());
+  ASSERT_TRUE(model_file.ok());
+  LitertLmLoader loader(std::move(model_file.value()));
+  auto lazy_model_file = ScopedFile::Open(model_path.string());
+  ASSERT_TRUE(lazy_model_file.ok());
+  LitertLmLoader lazy_loader(std::move(lazy_model_file.value()),
+                             /*lazy_loading=*/true);
+
+  EXPECT_FALSE(lazy_loader.GetHuggingFaceTokenizer());
+  EXPECT_EQ(lazy_loader.GetSentencePieceTokenizer()->StrView(),
+            loader.GetSentencePieceTokenizer()->StrView());
+  EXPECT_EQ(lazy_loader.GetTFLiteModel(ModelType::kTfLitePrefillDecode)
+                .StrView(),
+            loader.GetTFLiteModel(ModelType::kTfLitePrefillDecode).StrView());
+  EXPECT_EQ(lazy_loader.GetLlmMetadata().StrView(),
+            loader.GetLlmMetadata().StrView());
+  // The sections mapped already are reused.
+  EXPECT_EQ(lazy_loader.GetLlmMetadata().Data(),
+            lazy_loader.GetLlmMetadata().Data());
+  EXPECT_EQ(lazy_loader.GetTFLiteModel(ModelType::kTfLiteEmbedder).Size(), 0);
+}
+
+TEST(LitertLmLoaderTest, VerifiesTheModel) {
+  const auto model_path =
+      std::filesystem::path(::testing::SrcDir()) /
+      "litert_lm/runtime/testdata/test_lm.litertlm";
+  for (const ModelVerificationMode mode :
+       {ModelVerificationMode::kEager, ModelVerificationMode::kBackground}) {
+    for (const bool lazy_loading : {false, true}) {
+      auto model_file = ScopedFile::Open(model_path.string());
+      ASSERT_TRUE(model_file.ok());
+      LitertLmLoader loader(std::move(model_file.value()), lazy_loading, mode);
+      EXPECT_GT(loader.GetTFLiteModel(ModelType::kTfLitePrefillDecode).Size(),
+                0);
+      EXPECT_TRUE(loader.WaitForVerification().ok());
+    }
+  }
+}
+
 }  // namespace
 }  // namespace litert::lm
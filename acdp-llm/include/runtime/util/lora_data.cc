@@ -14,21 +14,26 @@
 
 #include "runtime/util/lora_data.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/str_cat.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
 #include "flatbuffers/buffer.h"  // from @flatbuffers
 #include "flatbuffers/vector.h"  // from @flatbuffers
 #include "litert/cc/litert_buffer_ref.h"  // from @litert
-#include "runtime/util/lora_util.h"
+#include "runtime/util/memory_mapped_file.h"
+#include "runtime/util/model_verification.h"
 #include "runtime/util/scoped_file.h"
 #include "runtime/util/status_macros.h"
 #include "tflite/model_builder.h"  // from @litert
@@ -39,11 +44,12 @@ namespace {
 
 constexpr absl::string_view kLoRARank = "lora_rank";
 // The maximum size of the metadata buffer.
-// This is the max length we need to mmap to build the flatbuffer model.
+// This is the max length of the mapping we need to build the flatbuffer model.
 constexpr int kMetadataMaxSize = 1024 * 1024;  // 1MB
 
 absl::StatusOr<std::unique_ptr<tflite::FlatBufferModel>>
-CreateFlatBufferModelFromBuffer(const void* buffer_addr, size_t buffer_size) {
+CreateFlatBufferModelFromBuffer(const void* buffer_addr, size_t buffer_size,
+                                ModelVerificationMode verification_mode) {
   const bool obfuscated = !tflite::ModelBufferHasIdentifier(buffer_addr);
   if (obfuscated) {
     return absl::UnimplementedError(
@@ -51,8 +57,11 @@ CreateFlatBufferModelFromBuffer(const void* buffer_addr, size_t buffer_size) {
         "yet.");
   }
   std::unique_ptr<tflite::FlatBufferModel> model =
-      tflite::FlatBufferModel::VerifyAndBuildFromBuffer(
-          reinterpret_cast<const char*>(buffer_addr), buffer_size);
+      verification_mode == ModelVerificationMode::kSkipWithChecksum
+          ? tflite::FlatBufferModel::BuildFromBuffer(
+                reinterpret_cast<const char*>(buffer_addr), buffer_size)
+          : tflite::FlatBufferModel::VerifyAndBuildFromBuffer(
+                reinterpret_cast<const char*>(buffer_addr), buffer_size);
   RET_CHECK(model) << "Error building tflite model.";
   return model;
 }
@@ -80,6 +89,19 @@ class FlatBufferLoraData : public LoraData {
     return ReadData(buffer->offset(), buffer->size());
   }
 
+  absl::StatusOr<std::vector<std::unique_ptr<BufferRef<uint8_t>>>>
+  ReadTensors(absl::Span<const absl::string_view> names) override {
+    ASSIGN_OR_RETURN(std::vector<const tflite::Buffer*> buffers,
+                     GetBuffers(names));
+    std::vector<std::unique_ptr<BufferRef<uint8_t>>> tensors;
+    tensors.reserve(buffers.size());
+    for (const tflite::Buffer* buffer : buffers) {
+      ASSIGN_OR_RETURN(tensors.emplace_back(),
+                       ReadData(buffer->offset(), buffer->size()));
+    }
+    return tensors;
+  }
+
   bool HasTensor(absl::string_view name) const override {
     return GetBuffer(name) != nullptr;
   }
@@ -127,27 +149,78 @@ class FlatBufferLoraData : public LoraData {
     }
     return nullptr;
   }
+
+  // Returns the buffers of the tensors of `names`, in a single pass over the
+  // tensors of the model.
+  absl::StatusOr<std::vector<const tflite::Buffer*>> GetBuffers(
+      absl::Span<const absl::string_view> names) const {
+    absl::flat_hash_map<absl::string_view, const tflite::Buffer*> name_buffers;
+    for (absl::string_view name : names) {
+      name_buffers.try_emplace(name, nullptr);
+    }
+    const tflite::Model* tflite_model = GetFlatBufferModel()->GetModel();
+    const flatbuffers::Vector<flatbuffers::Offset<tflite::Buffer>>& buffers =
+        *tflite_model->buffers();
+    for (const tflite::SubGraph* subgraph : *tflite_model->subgraphs()) {
+      for (const tflite::Tensor* tfl_tensor : *subgraph->tensors()) {
+        auto it =
+            name_buffers.find(absl::string_view(tfl_tensor->name()->c_str()));
+        // The first tensor of a name wins, as in GetBuffer().
+        if (it == name_buffers.end() || it->second != nullptr ||
+            tfl_tensor->buffer() >= buffers.size()) {
+          continue;
+        }
+        it->second = buffers.Get(tfl_tensor->buffer());
+      }
+    }
+    std::vector<const tflite::Buffer*> result;
+    result.reserve(names.size());
+    for (absl::string_view name : names) {
+      const tflite::Buffer* buffer = name_buffers[name];
+      if (buffer == nullptr) {
+        return absl::NotFoundError(
+            absl::StrCat("No buffer found for tensor: ", name));
+      }
+      result.push_back(buffer);
+    }
+    return result;
+  }
 };
 
-// FlatBufferModel based LoRA data backed by a file.
+// A view of the tensor data in the mapping of a whole LoRA file, which the
+// view keeps alive.
+class SharedMmapBufferRef : public BufferRef<uint8_t> {
+ public:
+  SharedMmapBufferRef(std::shared_ptr<MemoryMappedFile> mapped_file,
+                      uint64_t offset, uint64_t size)
+      : BufferRef<uint8_t>(static_cast<uint8_t*>(mapped_file->data()),
+                           /*end_offset=*/offset + size,
+                           /*start_offset=*/offset),
+        mapped_file_(std::move(mapped_file)) {}
+
+ private:
+  std::shared_ptr<MemoryMappedFile> mapped_file_;
+};
+
+// FlatBufferModel based LoRA data backed by a file, mapped once. The tensors
+// are views of the mapping, so that reading all the tensors of an adapter
+// doesn't map them one by one.
 class FileLoraData : public FlatBufferLoraData {
  public:
   // Constructor for FileLoraData.
   //
   // @param file A shared_ptr to the ScopedFile object representing the LoRA
   // data file.
-  // @param region A unique_ptr to the MemoryMappedFileWithAutoAlignment object
-  // representing the memory mapped region of the FlatBufferModel metadata.
+  // @param mapped_file A shared_ptr to the MemoryMappedFile object mapping
+  // the whole file, shared with the tensors read.
   // @param model A unique_ptr to the FlatBufferModel object representing the
   // LoRA data metadata.
-  explicit FileLoraData(
-      std::shared_ptr<const ScopedFile> file,
-      std::unique_ptr<MemoryMappedFileWithAutoAlignment> region,
-      std::unique_ptr<tflite::FlatBufferModel> model, const std::string& key)
+  explicit FileLoraData(std::shared_ptr<const ScopedFile> file,
+                        std::shared_ptr<MemoryMappedFile> mapped_file,
+                        std::unique_ptr<tflite::FlatBufferModel> model)
       : file_(std::move(file)),
-        region_(std::move(region)),
-        model_(std::move(model)),
-        key_(key) {}
+        mapped_file_(std::move(mapped_file)),
+        model_(std::move(model)) {}
 
   ~FileLoraData() override = default;
 
@@ -158,18 +231,19 @@ class FileLoraData : public FlatBufferLoraData {
 
   absl::StatusOr<std::unique_ptr<BufferRef<uint8_t>>> ReadData(
       uint64_t offset, uint64_t size) override {
-    ASSIGN_OR_RETURN(auto mapped_region,
-                     MemoryMappedFileWithAutoAlignment::Create(
-                         file_->file(), /*offset=*/offset,
-                         /*size=*/size, key_));
-    return std::make_unique<MmapBufferRef<uint8_t>>(std::move(mapped_region));
+    if (offset > mapped_file_->length() ||
+        size > mapped_file_->length() - offset) {
+      return absl::OutOfRangeError(absl::StrCat(
+          "The tensor data [", offset, ", ", offset + size,
+          ") is out of the LoRA file of ", mapped_file_->length(), " bytes."));
+    }
+    return std::make_unique<SharedMmapBufferRef>(mapped_file_, offset, size);
   }
 
  private:
   std::shared_ptr<const ScopedFile> file_;
-  std::unique_ptr<MemoryMappedFileWithAutoAlignment> region_;
+  std::shared_ptr<MemoryMappedFile> mapped_file_;
   std::unique_ptr<tflite::FlatBufferModel> model_;
-  const std::string key_;
 };
 
 // FlatBufferModel based LoRA data backed by a BufferRef.
@@ -206,31 +280,39 @@ class BufferLoraData : public FlatBufferLoraData {
 
 // static
 absl::StatusOr<std::unique_ptr<LoraData>> LoraData::CreateFromFilePath(
-    absl::string_view file_path) {
+    absl::string_view file_path, ModelVerificationMode verification_mode) {
   ASSIGN_OR_RETURN(auto file, ScopedFile::Open(file_path));
-  return CreateFromScopedFile(std::make_shared<ScopedFile>(std::move(file)));
+  return CreateFromScopedFile(std::make_shared<ScopedFile>(std::move(file)),
+                              verification_mode);
 }
 
 // static
 absl::StatusOr<std::unique_ptr<LoraData>> LoraData::CreateFromScopedFile(
-    std::shared_ptr<const ScopedFile> file) {
+    std::shared_ptr<const ScopedFile> file,
+    ModelVerificationMode verification_mode) {
   static std::atomic<uint32_t> next_key{0};
   const std::string key{absl::StrCat("FileLoraData_", next_key.fetch_add(1))};
-  ASSIGN_OR_RETURN(auto mapped_file, MemoryMappedFileWithAutoAlignment::Create(
-                                         file->file(), /*offset=*/0,
-                                         /*size=*/kMetadataMaxSize, key));
-  ASSIGN_OR_RETURN(auto model, CreateFlatBufferModelFromBuffer(
-                                   mapped_file->data(), mapped_file->length()));
+  ASSIGN_OR_RETURN(std::shared_ptr<MemoryMappedFile> mapped_file,
+                   MemoryMappedFile::Create(file->file(), /*offset=*/0,
+                                            /*length=*/0, key));
+  // The metadata comes first, the tensor data after it.
+  ASSIGN_OR_RETURN(
+      auto model,
+      CreateFlatBufferModelFromBuffer(
+          mapped_file->data(),
+          std::min<uint64_t>(mapped_file->length(), kMetadataMaxSize),
+          verification_mode));
   RET_CHECK(model) << "Error building tflite model.";
   return std::make_unique<FileLoraData>(std::move(file), std::move(mapped_file),
-                                        std::move(model), key);
+                                        std::move(model));
 }
 
 // static
 absl::StatusOr<std::unique_ptr<LoraData>> LoraData::CreateFromBuffer(
-    BufferRef<uint8_t> buffer) {
-  ASSIGN_OR_RETURN(auto model, CreateFlatBufferModelFromBuffer(buffer.Data(),
-                                                               buffer.Size()));
+    BufferRef<uint8_t> buffer, ModelVerificationMode verification_mode) {
+  ASSIGN_OR_RETURN(auto model,
+                   CreateFlatBufferModelFromBuffer(
+                       buffer.Data(), buffer.Size(), verification_mode));
   RET_CHECK(model) << "Error building tflite model.";
   return std::make_unique<BufferLoraData>(std::move(buffer), std::move(model));
 }
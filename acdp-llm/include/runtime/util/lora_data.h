@@ -17,10 +17,13 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
 #include "litert/cc/litert_buffer_ref.h"  // from @litert
+#include "runtime/util/model_verification.h"
 #include "runtime/util/scoped_file.h"
 
 namespace litert::lm {
@@ -28,28 +31,38 @@ namespace litert::lm {
 // The class holding LoRA data for LiteRT-LM on CPU.
 // It is responsible for reading data with minimum copy (e.g. with mmap from a
 // file) on CPU. It will provide data as a constant view.
+//
+// The flatbuffer of the LoRA metadata is verified when the instance is
+// created, unless the verification mode is kSkipWithChecksum. The metadata is
+// small and read right away, so kBackground verifies it eagerly as well.
 class LoraData {
  public:
   // Creates a LoraData instance from a file path.
   //
   // @param file_path The path to the file containing the LoRA data.
+  // @param verification_mode How the LoRA metadata is verified.
   // @return A unique_ptr to the LoraData instance, or an error status.
   static absl::StatusOr<std::unique_ptr<LoraData>> CreateFromFilePath(
-      absl::string_view file_path);
+      absl::string_view file_path,
+      ModelVerificationMode verification_mode = ModelVerificationMode::kEager);
   // Creates a LoraData instance from a ScopedFile object.
   //
   // @param file A shared_ptr to the ScopedFile object representing the LoRA
   // data file.
+  // @param verification_mode How the LoRA metadata is verified.
   // @return A unique_ptr to the LoraData instance, or an error status.
   static absl::StatusOr<std::unique_ptr<LoraData>> CreateFromScopedFile(
-      std::shared_ptr<const ScopedFile> file);
+      std::shared_ptr<const ScopedFile> file,
+      ModelVerificationMode verification_mode = ModelVerificationMode::kEager);
 
   // Create a LoraData instance from a BufferRef object.
   //
   // @param buffer A BufferRef object as the holder of the LoRA data.
+  // @param verification_mode How the LoRA metadata is verified.
   // @return A unique_ptr to the LoraData instance, or an error status.
   static absl::StatusOr<std::unique_ptr<LoraData>> CreateFromBuffer(
-      BufferRef<uint8_t> buffer);
+      BufferRef<uint8_t> buffer,
+      ModelVerificationMode verification_mode = ModelVerificationMode::kEager);
 
   // Get the LoRA rank from the model.
   // @return The LoRA rank, or an error status.
@@ -63,6 +76,27 @@ class LoraData {
   virtual absl::StatusOr<std::unique_ptr<BufferRef<uint8_t>>> ReadTensor(
       absl::string_view name) = 0;
 
+  // Returns the tensor data of the tensors with `names`, in the same order,
+  // e.g. all the LoRA weights of a model at once. The data of a file is
+  // mapped once and shared by the tensors.
+  //
+  // @param names The names of the tensors to read.
+  // @return The BufferRef objects containing the tensor data, or an error
+  // status if any tensor is missing.
+  virtual absl::StatusOr<std::vector<std::unique_ptr<BufferRef<uint8_t>>>>
+  ReadTensors(absl::Span<const absl::string_view> names) {
+    std::vector<std::unique_ptr<BufferRef<uint8_t>>> tensors;
+    tensors.reserve(names.size());
+    for (absl::string_view name : names) {
+      auto tensor = ReadTensor(name);
+      if (!tensor.ok()) {
+        return tensor.status();
+      }
+      tensors.push_back(*std::move(tensor));
+    }
+    return tensors;
+  }
+
   // Checks if a tensor with the given name exists in the LoRA data.
   //
   // @param name The name of the tensor to check.
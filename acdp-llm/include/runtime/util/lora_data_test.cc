@@ -14,6 +14,7 @@
 
 #include "runtime/util/lora_data.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>  // NOLINT: Required for path manipulation.
 #include <memory>
@@ -26,9 +27,11 @@
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
 #include "litert/cc/litert_buffer_ref.h"  // from @litert
 #include "runtime/executor/executor_settings_base.h"
 #include "runtime/util/memory_mapped_file.h"
+#include "runtime/util/model_verification.h"
 #include "runtime/util/scoped_file.h"
 #include "runtime/util/status_macros.h"
 #include "runtime/util/test_utils.h"  // IWYU pragma: keep
@@ -126,6 +129,40 @@ TEST_P(LoraDataTest, ReadTensorDataFailsForUnknownTensor) {
               StatusIs(absl::StatusCode::kNotFound));
 }
 
+TEST_P(LoraDataTest, ReadTensorsWorksAsExpected) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<LoraData> lora, CreateLoraData());
+
+  std::vector<std::string> tensor_names;
+  for (int i : {0, 5, 10, 15, 20}) {
+    tensor_names.push_back(
+        absl::StrCat("transformer.layer_", i, ".attn.q.w_prime_left"));
+  }
+  const std::vector<absl::string_view> names(tensor_names.begin(),
+                                             tensor_names.end());
+  ASSERT_OK_AND_ASSIGN(auto tensors, lora->ReadTensors(names));
+  ASSERT_EQ(tensors.size(), names.size());
+  std::vector<std::string> expected_data;
+  for (absl::string_view name : names) {
+    ASSERT_OK_AND_ASSIGN(auto tensor, lora->ReadTensor(name));
+    expected_data.emplace_back(tensor->StrView());
+  }
+  // The tensors stay valid after the LoRA data is destroyed.
+  lora.reset();
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    EXPECT_EQ(tensors[i]->StrView(), expected_data[i])
+        << "for tensor: " << names[i];
+  }
+}
+
+TEST_P(LoraDataTest, ReadTensorsFailsForUnknownTensor) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<LoraData> lora, CreateLoraData());
+
+  EXPECT_THAT(
+      lora->ReadTensors({"transformer.layer_0.attn.q.w_prime_left",
+                         "unknown_tensor"}),
+      StatusIs(absl::StatusCode::kNotFound));
+}
+
 TEST_P(LoraDataTest, HasTensorWorksAsExpected) {
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<LoraData> lora, CreateLoraData());
 
@@ -138,6 +175,21 @@ TEST_P(LoraDataTest, HasTensorWorksAsExpected) {
   EXPECT_FALSE(lora->HasTensor("unknown_tensor"));
 }
 
+TEST(LoraDataWithoutVerificationTest, ReadsTheSameTensors) {
+  ASSERT_OK_AND_ASSIGN(auto lora,
+                       LoraData::CreateFromFilePath(GetLoraFilePath()));
+  ASSERT_OK_AND_ASSIGN(
+      auto unverified_lora,
+      LoraData::CreateFromFilePath(GetLoraFilePath(),
+                                   ModelVerificationMode::kSkipWithChecksum));
+  EXPECT_THAT(unverified_lora->GetLoRARank(), IsOkAndHolds(32));
+  const std::string tensor_name = "transformer.layer_0.attn.q.w_prime_left";
+  ASSERT_OK_AND_ASSIGN(auto tensor, lora->ReadTensor(tensor_name));
+  ASSERT_OK_AND_ASSIGN(auto unverified_tensor,
+                       unverified_lora->ReadTensor(tensor_name));
+  EXPECT_EQ(unverified_tensor->StrView(), tensor->StrView());
+}
+
 INSTANTIATE_TEST_SUITE_P(
     LoraDataTests, LoraDataTest,
     ::testing::Values(LoraLoadType::kFilePath, LoraLoadType::kScopedFile,
@@ -0,0 +1,72 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <ostream>
+
+#include "absl/base/const_init.h"  // from @com_google_absl
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/util/memory_mapped_file.h"
+
+namespace litert::lm {
+namespace {
+
+ABSL_CONST_INIT absl::Mutex default_mapping_options_mutex(absl::kConstInit);
+
+MappingOptions& DefaultMappingOptions()
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(default_mapping_options_mutex) {
+  static MappingOptions* const options = new MappingOptions();
+  return *options;
+}
+
+const char* PrefetchToString(MappingOptions::Prefetch prefetch) {
+  switch (prefetch) {
+    case MappingOptions::Prefetch::kDefault:
+      return "DEFAULT";
+    case MappingOptions::Prefetch::kNone:
+      return "NONE";
+    case MappingOptions::Prefetch::kSequential:
+      return "SEQUENTIAL";
+    case MappingOptions::Prefetch::kWillNeed:
+      return "WILLNEED";
+    case MappingOptions::Prefetch::kPopulate:
+      return "POPULATE";
+  }
+  return "UNKNOWN";
+}
+
+}  // namespace
+
+std::ostream& operator<<(std::ostream& os, const MappingOptions& options) {
+  return os << "MappingOptions(prefetch: " << PrefetchToString(options.prefetch)
+            << ", huge_pages: " << options.huge_pages
+            << ", lock_in_memory: " << options.lock_in_memory
+            << ", numa_node: " << options.numa_node
+            << ", num_read_threads: " << options.num_read_threads << ")";
+}
+
+// static
+void MemoryMappedFile::SetDefaultMappingOptions(
+    const MappingOptions& options) {
+  absl::MutexLock lock(&default_mapping_options_mutex);
+  DefaultMappingOptions() = options;
+}
+
+// static
+MappingOptions MemoryMappedFile::GetDefaultMappingOptions() {
+  absl::MutexLock lock(&default_mapping_options_mutex);
+  return DefaultMappingOptions();
+}
+
+}  // namespace litert::lm
@@ -18,16 +18,67 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <ostream>
 #include <string>
 #include <utility>
 
 #include "absl/memory/memory.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/util/parallel_read.h"
 #include "runtime/util/scoped_file.h"
 
 namespace litert::lm {
 
+// The policies of mapping a read-only file, e.g. the model weights, trading
+// the memory and the load time for fewer page faults later. On Windows, all
+// the prefetch policies but kNone issue PrefetchVirtualMemory, and kPopulate
+// also faults the pages in before Create() returns.
+struct MappingOptions {
+  enum class Prefetch {
+    // MADV_WILLNEED, or MADV_DONTNEED on Apple, where the prefetch loads
+    // pages never used.
+    kDefault,
+    // No advice, the pages are faulted in on their first access.
+    kNone,
+    // MADV_SEQUENTIAL, aggressive read-ahead for files read once in order.
+    kSequential,
+    // MADV_WILLNEED, asynchronous read-ahead of the whole mapping.
+    kWillNeed,
+    // MAP_POPULATE, the mapping is read in before Create() returns.
+    kPopulate,
+  };
+  Prefetch prefetch = Prefetch::kDefault;
+
+  // Backs the mapping with transparent huge pages (MADV_HUGEPAGE), if the
+  // kernel supports them for files, which cuts the TLB misses on the weights.
+  // On Windows, the file is read into a private section of large pages
+  // (SEC_LARGE_PAGES) instead, if the process holds SeLockMemoryPrivilege.
+  bool huge_pages = false;
+
+  // Locks the mapping in memory (mlock), so that its pages are never
+  // evicted. Fails if the mapping exceeds RLIMIT_MEMLOCK.
+  bool lock_in_memory = false;
+
+  // Places the pages of the mapping on the memory of the NUMA node
+  // (mbind(MPOL_PREFERRED), moving the pages already read in), next to the
+  // threads computing with them. Only a hint, ignored outside of Linux. -1
+  // keeps the memory policy of the threads faulting the pages in.
+  int numa_node = -1;
+
+  // Reads the file into anonymous memory with this many parallel reads,
+  // instead of mapping it, e.g. on the network filesystems where the page
+  // faults of a mapping turn into small reads one at a time. The memory is
+  // backed by huge pages with `huge_pages`, and the prefetch does not apply.
+  // 0 maps the file.
+  int num_read_threads = 0;
+
+  // Reports the progress of the reads of `num_read_threads`, if set.
+  ReadProgressCallback read_progress;
+};
+
+std::ostream& operator<<(std::ostream& os, const MappingOptions& options);
+
 // Represents a memory mapped file. All memory will be accessible while this
 // object exists and will be cleaned up when it is destroyed.
 class MemoryMappedFile {
@@ -48,10 +99,23 @@ class MemoryMappedFile {
       absl::string_view path);
   // Creates a MemoryMappedFile object from the platform file handle. This does
   // not take ownership of the passed handle. The `key` passed here is an
-  // optimization when mapping the same file with different offsets.
+  // optimization when mapping the same file with different offsets: the
+  // mappings of the same range of the same file with the same non-empty key
+  // are shared process-wide while in use, e.g. by the engines loading the same
+  // model, so their data must not be modified. A shared mapping keeps the
+  // options of its first creation.
   static absl::StatusOr<std::unique_ptr<MemoryMappedFile>> Create(
       ScopedFile::PlatformFile file, uint64_t offset = 0u, uint64_t length = 0u,
       absl::string_view key = "");
+  // As above, with the given mapping options instead of the default ones.
+  static absl::StatusOr<std::unique_ptr<MemoryMappedFile>> Create(
+      ScopedFile::PlatformFile file, uint64_t offset, uint64_t length,
+      absl::string_view key, const MappingOptions& options);
+
+  // Sets the mapping options of the read-only files mapped from then on
+  // without options, e.g. by the model loaders, process-wide.
+  static void SetDefaultMappingOptions(const MappingOptions& options);
+  static MappingOptions GetDefaultMappingOptions();
 
   // Creates a mutable MemoryMappedFile object, any modification through data()
   // pointer will be carried over to the underlying path.
@@ -14,6 +14,13 @@
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // defined(__linux__)
 
 #include <cerrno>
 #include <cstddef>
@@ -21,11 +28,20 @@
 #include <cstdio>
 #include <cstring>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/log/absl_log.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
 #include "runtime/util/memory_mapped_file.h"
+#include "runtime/util/parallel_read.h"
 #include "runtime/util/scoped_file.h"
 #include "runtime/util/status_macros.h"
 
@@ -84,6 +100,141 @@ class MemoryMappedFilePosix : public MemoryMappedFile {
   void* data_;
 };
 
+// A mapping shared by the MemoryMappedFiles created with the same key.
+class SharedMemoryMappedFile : public MemoryMappedFile {
+ public:
+  explicit SharedMemoryMappedFile(std::shared_ptr<MemoryMappedFile> mapping)
+      : mapping_(std::move(mapping)) {}
+
+  uint64_t length() override { return mapping_->length(); }
+
+  void* data() override { return mapping_->data(); }
+
+ private:
+  std::shared_ptr<MemoryMappedFile> mapping_;
+};
+
+// The process-wide mappings of the files mapped with a key, which are only
+// kept while used.
+struct SharedMappings {
+  absl::Mutex mutex;
+  absl::flat_hash_map<std::string, std::weak_ptr<MemoryMappedFile>> mappings
+      ABSL_GUARDED_BY(mutex);
+};
+
+SharedMappings& GetSharedMappings() {
+  static SharedMappings* const shared_mappings = new SharedMappings();
+  return *shared_mappings;
+}
+
+// Returns the key of the mapping of the range of the file, which identifies
+// the file by its inode and its version by its size and modification time,
+// so that a file replaced in place is mapped again.
+absl::StatusOr<std::string> GetSharedMappingKey(int file, uint64_t offset,
+                                                uint64_t length,
+                                                absl::string_view key) {
+  struct stat file_stat;
+  RET_CHECK_EQ(fstat(file, &file_stat), 0)
+      << "Failed to stat, error: " << strerror(errno);
+  return absl::StrCat(file_stat.st_dev, ":", file_stat.st_ino, ":",
+                      file_stat.st_size, ":", file_stat.st_mtime, ":", offset,
+                      ":", length, ":", key);
+}
+
+// Maps `length` bytes of the file from `offset`, privately, or reads them
+// into anonymous memory with `options.num_read_threads`.
+absl::StatusOr<std::unique_ptr<MemoryMappedFile>> MapFile(
+    int file, uint64_t offset, uint64_t length,
+    const MappingOptions& options) {
+  const bool read_in = options.num_read_threads > 0;
+  int flags = MAP_PRIVATE;
+  MappingOptions::Prefetch prefetch = options.prefetch;
+  if (read_in) {
+    // The huge pages and the NUMA node below apply to the pages faulted in
+    // by the reads.
+    flags |= MAP_ANONYMOUS;
+    prefetch = MappingOptions::Prefetch::kNone;
+  } else if (prefetch == MappingOptions::Prefetch::kPopulate) {
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#else
+    prefetch = MappingOptions::Prefetch::kWillNeed;
+#endif
+  }
+  void* data = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags,
+                    read_in ? -1 : file, read_in ? 0 : offset);
+  RET_CHECK_NE(data, MAP_FAILED) << "Failed to map, error: " << strerror(errno);
+  RET_CHECK_NE(data, nullptr) << "Failed to map.";
+  // Unmaps the file on the errors below.
+  auto mapped_file = std::make_unique<MemoryMappedFilePosix>(length, data);
+
+  switch (prefetch) {
+    case MappingOptions::Prefetch::kDefault:
+#ifdef __APPLE__
+      // Mark it not needed to avoid unnecessary page loading on MacOS or iOS.
+      RET_CHECK_EQ(madvise(data, length, MADV_DONTNEED), 0)
+          << "madvise failed.";
+#else
+      RET_CHECK_EQ(madvise(data, length, MADV_WILLNEED), 0)
+          << "madvise failed.";
+#endif
+      break;
+    case MappingOptions::Prefetch::kSequential:
+      RET_CHECK_EQ(madvise(data, length, MADV_SEQUENTIAL), 0)
+          << "madvise failed.";
+      break;
+    case MappingOptions::Prefetch::kWillNeed:
+      RET_CHECK_EQ(madvise(data, length, MADV_WILLNEED), 0)
+          << "madvise failed.";
+      break;
+    case MappingOptions::Prefetch::kNone:
+    case MappingOptions::Prefetch::kPopulate:
+      break;
+  }
+  if (options.huge_pages) {
+    // Only a hint: the kernels without huge pages for files reject it, and
+    // the mapping works all the same.
+#ifdef MADV_HUGEPAGE
+    if (madvise(data, length, MADV_HUGEPAGE) != 0) {
+      ABSL_LOG(WARNING) << "Huge pages are not available for the mapping: "
+                        << strerror(errno);
+    }
+#else
+    ABSL_LOG(WARNING) << "Huge pages are not supported on this platform.";
+#endif
+  }
+  if (options.numa_node >= 0) {
+    // Only a hint as well: the pages shared with other mappings, or locked,
+    // stay where they are.
+#if defined(__linux__)
+    constexpr int kBitsPerWord = 8 * sizeof(unsigned long);  // NOLINT
+    std::vector<unsigned long> node_mask(  // NOLINT
+        options.numa_node / kBitsPerWord + 1);
+    node_mask.back() |= 1UL << (options.numa_node % kBitsPerWord);
+    // glibc does not wrap mbind, libnuma does.
+    if (syscall(SYS_mbind, data, length, MPOL_PREFERRED, node_mask.data(),
+                node_mask.size() * kBitsPerWord, MPOL_MF_MOVE) != 0) {
+      ABSL_LOG(WARNING) << "Failed to bind the mapping to NUMA node "
+                        << options.numa_node << ": " << strerror(errno);
+    }
+#else
+    ABSL_LOG(WARNING) << "NUMA nodes are not supported on this platform.";
+#endif  // defined(__linux__)
+  }
+  if (read_in) {
+    RETURN_IF_ERROR(ReadFileInParallel(file, offset, length, data,
+                                       options.num_read_threads,
+                                       options.read_progress));
+  }
+  if (options.lock_in_memory && mlock(data, length) != 0) {
+    return absl::ResourceExhaustedError(absl::StrCat(
+        "Failed to lock the mapping of ", length,
+        " bytes in memory, error: ", strerror(errno)));
+  }
+
+  return mapped_file;
+}
+
 }  // namespace
 
 // static
@@ -99,6 +250,13 @@ absl::StatusOr<std::unique_ptr<MemoryMappedFile>> MemoryMappedFile::Create(
 // static
 absl::StatusOr<std::unique_ptr<MemoryMappedFile>> MemoryMappedFile::Create(
     int file, uint64_t offset, uint64_t length, absl::string_view key) {
+  return Create(file, offset, length, key, GetDefaultMappingOptions());
+}
+
+// static
+absl::StatusOr<std::unique_ptr<MemoryMappedFile>> MemoryMappedFile::Create(
+    int file, uint64_t offset, uint64_t length, absl::string_view key,
+    const MappingOptions& options) {
   RET_CHECK_EQ(offset % GetOffsetAlignment(), 0)
       << "Offset must be a multiple of page size : " << offset << ", "
       << GetOffsetAlignment();
@@ -108,19 +266,42 @@ absl::StatusOr<std::unique_ptr<MemoryMappedFile>> MemoryMappedFile::Create(
   if (length == 0) {
     length = file_size - offset;
   }
+  if (key.empty()) {
+    return MapFile(file, offset, length, options);
+  }
 
-  void* data =
-      mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, offset);
-  RET_CHECK_NE(data, MAP_FAILED) << "Failed to map, error: " << strerror(errno);
-  RET_CHECK_NE(data, nullptr) << "Failed to map.";
-#ifdef __APPLE__
-  // Mark it not needed to avoid unnecessary page loading on MacOS or iOS.
-  RET_CHECK_EQ(madvise(data, length, MADV_DONTNEED), 0) << "madvise failed.";
-#else
-  RET_CHECK_EQ(madvise(data, length, MADV_WILLNEED), 0) << "madvise failed.";
-#endif
-
-  return std::make_unique<MemoryMappedFilePosix>(length, data);
+  ASSIGN_OR_RETURN(std::string mapping_key,
+                   GetSharedMappingKey(file, offset, length, key));
+  SharedMappings& shared_mappings = GetSharedMappings();
+  {
+    absl::MutexLock lock(&shared_mappings.mutex);
+    if (auto it = shared_mappings.mappings.find(mapping_key);
+        it != shared_mappings.mappings.end()) {
+      if (std::shared_ptr<MemoryMappedFile> mapping = it->second.lock()) {
+        return std::make_unique<SharedMemoryMappedFile>(std::move(mapping));
+      }
+    }
+  }
+  // Mapping the file may populate it, so it is done without the lock.
+  ASSIGN_OR_RETURN(std::shared_ptr<MemoryMappedFile> mapping,
+                   MapFile(file, offset, length, options));
+  absl::MutexLock lock(&shared_mappings.mutex);
+  // Forget the mappings freed since.
+  absl::erase_if(shared_mappings.mappings, [](const auto& entry) {
+    return entry.second.expired();
+  });
+  auto [it, inserted] =
+      shared_mappings.mappings.try_emplace(mapping_key, mapping);
+  if (!inserted) {
+    // Another caller mapped the same range meanwhile, unless its mapping has
+    // been freed since the expired ones were forgotten.
+    if (std::shared_ptr<MemoryMappedFile> other_mapping = it->second.lock()) {
+      mapping = std::move(other_mapping);
+    } else {
+      it->second = mapping;
+    }
+  }
+  return std::make_unique<SharedMemoryMappedFile>(std::move(mapping));
 }
 
 absl::StatusOr<std::unique_ptr<MemoryMappedFile>>
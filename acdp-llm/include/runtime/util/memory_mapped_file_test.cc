@@ -15,6 +15,7 @@
 #include "runtime/util/memory_mapped_file.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>  // NOLINT: Required for path manipulation.
 #include <fstream>
 #include <ios>
@@ -152,6 +153,101 @@ TEST(MemoryMappedFile, SucceedsMappingLengthAndOffset) {
   }
 }
 
+TEST(MemoryMappedFile, SharesTheMappingsOfTheSameKey) {
+  auto path = std::filesystem::path(::testing::TempDir()) / "shared.txt";
+  WriteFile(path.string(), "foo bar");
+
+  auto scoped_file = *ScopedFile::Open(path.string());
+  auto other_scoped_file = *ScopedFile::Open(path.string());
+  auto file1 = MemoryMappedFile::Create(scoped_file.file(), 0, 0, "key");
+  ASSERT_OK(file1);
+  // The same file opened again shares the mapping.
+  auto file2 = MemoryMappedFile::Create(other_scoped_file.file(), 0, 0, "key");
+  ASSERT_OK(file2);
+  EXPECT_EQ((*file1)->data(), (*file2)->data());
+  CheckContents(**file2, "foo bar");
+  // Not the other ranges or keys, nor without a key.
+  auto file3 = MemoryMappedFile::Create(scoped_file.file(), 0, 3, "key");
+  ASSERT_OK(file3);
+  EXPECT_NE((*file1)->data(), (*file3)->data());
+  CheckContents(**file3, "foo");
+  auto file4 = MemoryMappedFile::Create(scoped_file.file(), 0, 0, "other");
+  ASSERT_OK(file4);
+  EXPECT_NE((*file1)->data(), (*file4)->data());
+  auto file5 = MemoryMappedFile::Create(scoped_file.file());
+  ASSERT_OK(file5);
+  EXPECT_NE((*file1)->data(), (*file5)->data());
+
+  // The mapping outlives the first file sharing it.
+  file1->reset();
+  CheckContents(**file2, "foo bar");
+}
+
+TEST(MemoryMappedFile, SucceedsMappingWithMappingOptions) {
+  auto path = std::filesystem::path(::testing::TempDir()) / "file.txt";
+  WriteFile(path.string(), "foo bar");
+
+  auto scoped_file = *ScopedFile::Open(path.string());
+  for (auto prefetch : {MappingOptions::Prefetch::kDefault,
+                        MappingOptions::Prefetch::kNone,
+                        MappingOptions::Prefetch::kSequential,
+                        MappingOptions::Prefetch::kWillNeed,
+                        MappingOptions::Prefetch::kPopulate}) {
+    MappingOptions options;
+    options.prefetch = prefetch;
+    // The huge pages are only a hint, and a few pages fit any locked memory
+    // limit.
+    options.huge_pages = true;
+    options.lock_in_memory = true;
+    auto file = MemoryMappedFile::Create(scoped_file.file(), /*offset=*/0,
+                                         /*length=*/0, /*key=*/"", options);
+    ASSERT_OK(file);
+    CheckContents(**file, "foo bar");
+  }
+}
+
+TEST(MemoryMappedFile, SucceedsReadingWithMappingOptions) {
+  auto path = std::filesystem::path(::testing::TempDir()) / "file.txt";
+  WriteFile(path.string(), "foo bar");
+
+  auto scoped_file = *ScopedFile::Open(path.string());
+  MappingOptions options;
+  options.num_read_threads = 2;
+  options.huge_pages = true;
+  uint64_t num_read_bytes = 0;
+  options.read_progress = [&](uint64_t num_read, uint64_t num_bytes) {
+    num_read_bytes = num_read;
+  };
+  auto file = MemoryMappedFile::Create(scoped_file.file(), /*offset=*/0,
+                                       /*length=*/0, /*key=*/"", options);
+  ASSERT_OK(file);
+  CheckContents(**file, "foo bar");
+  EXPECT_EQ(num_read_bytes, 7);
+}
+
+TEST(MemoryMappedFile, SetsTheDefaultMappingOptions) {
+  const MappingOptions default_options =
+      MemoryMappedFile::GetDefaultMappingOptions();
+  EXPECT_EQ(default_options.prefetch, MappingOptions::Prefetch::kDefault);
+  EXPECT_FALSE(default_options.huge_pages);
+  EXPECT_FALSE(default_options.lock_in_memory);
+
+  MappingOptions options;
+  options.prefetch = MappingOptions::Prefetch::kNone;
+  options.huge_pages = true;
+  MemoryMappedFile::SetDefaultMappingOptions(options);
+  EXPECT_EQ(MemoryMappedFile::GetDefaultMappingOptions().prefetch,
+            MappingOptions::Prefetch::kNone);
+  EXPECT_TRUE(MemoryMappedFile::GetDefaultMappingOptions().huge_pages);
+
+  auto path = std::filesystem::path(::testing::TempDir()) / "file.txt";
+  WriteFile(path.string(), "foo bar");
+  auto file = MemoryMappedFile::Create(path.string());
+  ASSERT_OK(file);
+  CheckContents(**file, "foo bar");
+  MemoryMappedFile::SetDefaultMappingOptions(default_options);
+}
+
 TEST(MemoryMappedFile, FailsMappingNonExistentFile) {
   auto path = std::filesystem::path(::testing::TempDir()) / "bad.txt";
   ASSERT_FALSE(MemoryMappedFile::Create(path.string()).ok());
@@ -14,16 +14,28 @@
 
 #include <windows.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 
 #include "absl/cleanup/cleanup.h"  // from @com_google_absl
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
 #include "runtime/util/memory_mapped_file.h"
+#include "runtime/util/parallel_read.h"
 #include "runtime/util/scoped_file.h"
 #include "runtime/util/status_macros.h"
 
 namespace litert::lm {
 namespace {
 
+// The mutable mappings are written rather than read, so they are not
+// prefetched.
+constexpr MappingOptions kMutableMappingOptions = {
+    .prefetch = MappingOptions::Prefetch::kNone};
+
 class MemoryMappedFileWin : public MemoryMappedFile {
  public:
   MemoryMappedFileWin(HANDLE hmap, uint64_t length, void* data)
@@ -87,11 +99,103 @@ class MemoryMappedFileWin : public MemoryMappedFile {
   void* data_;
 };
 
-absl::StatusOr<std::unique_ptr<MemoryMappedFile>> CreateImpl(HANDLE hfile,
-                                                             uint64_t offset,
-                                                             uint64_t length,
-                                                             const char* key,
-                                                             bool writable) {
+// Enables SeLockMemoryPrivilege for the process, which the large pages
+// require. Returns false if the account is not granted the privilege.
+bool EnableLockMemoryPrivilege() {
+  static const bool enabled = [] {
+    HANDLE token;
+    if (!::OpenProcessToken(::GetCurrentProcess(),
+                            TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+      return false;
+    }
+    auto close_token = absl::MakeCleanup([token] { ::CloseHandle(token); });
+    TOKEN_PRIVILEGES privileges = {};
+    privileges.PrivilegeCount = 1;
+    privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+    if (!::LookupPrivilegeValueA(nullptr, "SeLockMemoryPrivilege",
+                                 &privileges.Privileges[0].Luid)) {
+      return false;
+    }
+    // Succeeds without enabling the privileges the account is not granted,
+    // which only GetLastError() tells.
+    return ::AdjustTokenPrivileges(token, false, &privileges, 0, nullptr,
+                                   nullptr) &&
+           ::GetLastError() == ERROR_SUCCESS;
+  }();
+  return enabled;
+}
+
+// Reads `length` bytes of the file from `offset` into a private section
+// backed by the paging file, with `options.num_read_threads` parallel reads.
+// With `large_pages`, the section is backed by large pages, which only the
+// sections backed by the paging file can use, and is never paged out.
+absl::StatusOr<std::unique_ptr<MemoryMappedFile>> ReadIntoSection(
+    HANDLE hfile, uint64_t offset, uint64_t length, bool large_pages,
+    const MappingOptions& options) {
+  DWORD protect = PAGE_READWRITE | SEC_COMMIT;
+  DWORD access = FILE_MAP_ALL_ACCESS;
+  ULARGE_INTEGER size = {};
+  size.QuadPart = length;
+  if (large_pages) {
+    const size_t large_page_size = ::GetLargePageMinimum();
+    if (large_page_size == 0) {
+      return absl::UnimplementedError("Large pages are not supported.");
+    }
+    if (!EnableLockMemoryPrivilege()) {
+      return absl::PermissionDeniedError(
+          "Large pages require SeLockMemoryPrivilege.");
+    }
+    protect |= SEC_LARGE_PAGES;
+    access |= FILE_MAP_LARGE_PAGES;
+    size.QuadPart =
+        (length + large_page_size - 1) / large_page_size * large_page_size;
+  }
+  HANDLE hmap = ::CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, protect,
+                                     size.HighPart, size.LowPart, nullptr);
+  if (hmap == NULL) {
+    return absl::ResourceExhaustedError(
+        absl::StrCat("Failed to create a section of ", size.QuadPart,
+                     " bytes, error: ", ::GetLastError()));
+  }
+  auto close_hmap = absl::MakeCleanup([hmap] { ::CloseHandle(hmap); });
+  void* data = ::MapViewOfFile(hmap, access, 0, 0, size.QuadPart);
+  RET_CHECK(data) << "Failed to map the section.";
+  std::move(close_hmap).Cancel();
+  // Unmaps the section on the errors below.
+  auto mapped_file = std::make_unique<MemoryMappedFileWin>(hmap, length, data);
+  RETURN_IF_ERROR(ReadFileInParallel(hfile, offset, length, data,
+                                     std::max(options.num_read_threads, 1),
+                                     options.read_progress));
+  return mapped_file;
+}
+
+// Prefetches the mapping as requested by `prefetch`. Windows has no
+// read-ahead policies, so all but kNone read the whole mapping in the
+// background, and kPopulate also waits for it.
+void PrefetchMapping(void* data, uint64_t length,
+                     MappingOptions::Prefetch prefetch) {
+  if (prefetch == MappingOptions::Prefetch::kNone) {
+    return;
+  }
+  // Only a hint: the mapping works all the same without it.
+  WIN32_MEMORY_RANGE_ENTRY range = {data, static_cast<SIZE_T>(length)};
+  if (!::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0)) {
+    ABSL_LOG(WARNING) << "Failed to prefetch the mapping, error: "
+                      << ::GetLastError();
+  }
+  if (prefetch == MappingOptions::Prefetch::kPopulate) {
+    SYSTEM_INFO sys_info;
+    ::GetSystemInfo(&sys_info);
+    const volatile char* bytes = static_cast<const volatile char*>(data);
+    for (uint64_t i = 0; i < length; i += sys_info.dwPageSize) {
+      (void)bytes[i];
+    }
+  }
+}
+
+absl::StatusOr<std::unique_ptr<MemoryMappedFile>> CreateImpl(
+    HANDLE hfile, uint64_t offset, uint64_t length, const char* key,
+    bool writable, const MappingOptions& options) {
   RET_CHECK_EQ(offset % MemoryMappedFile::GetOffsetAlignment(), 0)
       << "Offset must be a multiple of allocation granularity: " << offset
       << ", " << MemoryMappedFile::GetOffsetAlignment();
@@ -102,6 +206,26 @@ absl::StatusOr<std::unique_ptr<MemoryMappedFile>> CreateImpl(HANDLE hfile,
     length = file_size - offset;
   }
 
+  // The large pages are only a hint as on the other platforms: the file is
+  // read in or mapped as usual without the privilege. The sections read in
+  // are private to the mapping, so they are not shared by `key`.
+  if (options.huge_pages && !writable) {
+    auto large_page_file = ReadIntoSection(hfile, offset, length,
+                                           /*large_pages=*/true, options);
+    if (large_page_file.ok()) {
+      return large_page_file;
+    }
+    ABSL_LOG(WARNING) << "Large pages are not available for the mapping: "
+                      << large_page_file.status();
+  }
+  if (options.num_read_threads > 0 && !writable) {
+    return ReadIntoSection(hfile, offset, length, /*large_pages=*/false,
+                           options);
+  }
+  if (options.numa_node >= 0) {
+    ABSL_LOG(WARNING) << "NUMA nodes are not supported on this platform.";
+  }
+
   DWORD access = FILE_MAP_COPY;
   DWORD protect = PAGE_WRITECOPY;
   if (writable) {
@@ -124,8 +248,16 @@ absl::StatusOr<std::unique_ptr<MemoryMappedFile>> CreateImpl(HANDLE hfile,
   RET_CHECK(mapped_region) << "Failed to map.";
 
   std::move(close_hmap).Cancel();
-
-  return std::make_unique<MemoryMappedFileWin>(hmap, length, mapped_region);
+  // Unmaps the file on the errors below.
+  auto mapped_file =
+      std::make_unique<MemoryMappedFileWin>(hmap, length, mapped_region);
+  PrefetchMapping(mapped_region, length, options.prefetch);
+  if (options.lock_in_memory && !::VirtualLock(mapped_region, length)) {
+    return absl::ResourceExhaustedError(
+        absl::StrCat("Failed to lock the mapping of ", length,
+                     " bytes in memory, error: ", ::GetLastError()));
+  }
+  return mapped_file;
 }
 
 }  // namespace
@@ -141,28 +273,37 @@ size_t MemoryMappedFile::GetOffsetAlignment() {
 absl::StatusOr<std::unique_ptr<MemoryMappedFile>> MemoryMappedFile::Create(
     absl::string_view path) {
   ASSIGN_OR_RETURN(auto scoped_file, ScopedFile::Open(path));
-  return CreateImpl(scoped_file.file(), 0, 0, nullptr, /*writable=*/false);
+  return CreateImpl(scoped_file.file(), 0, 0, nullptr, /*writable=*/false,
+                    GetDefaultMappingOptions());
 }
 
 // static
 absl::StatusOr<std::unique_ptr<MemoryMappedFile>> MemoryMappedFile::Create(
     HANDLE file, uint64_t offset, uint64_t length, absl::string_view key) {
+  return Create(file, offset, length, key, GetDefaultMappingOptions());
+}
+
+// static
+absl::StatusOr<std::unique_ptr<MemoryMappedFile>> MemoryMappedFile::Create(
+    HANDLE file, uint64_t offset, uint64_t length, absl::string_view key,
+    const MappingOptions& options) {
   return CreateImpl(file, offset, length, key.empty() ? nullptr : key.data(),
-                    /*writable=*/false);
+                    /*writable=*/false, options);
 }
 
 // static
 absl::StatusOr<std::unique_ptr<MemoryMappedFile>>
 MemoryMappedFile::CreateMutable(absl::string_view path) {
   ASSIGN_OR_RETURN(auto scoped_file, ScopedFile::OpenWritable(path));
-  return CreateImpl(scoped_file.file(), 0, 0, nullptr, /*writable=*/true);
+  return CreateImpl(scoped_file.file(), 0, 0, nullptr, /*writable=*/true,
+                    kMutableMappingOptions);
 }
 
 absl::StatusOr<std::unique_ptr<MemoryMappedFile>>
 MemoryMappedFile::CreateMutable(HANDLE file, uint64_t offset, uint64_t length,
                                 absl::string_view key) {
   return CreateImpl(file, offset, length, key.empty() ? nullptr : key.data(),
-                    /*writable=*/true);
+                    /*writable=*/true, kMutableMappingOptions);
 }
 
 }  // namespace litert::lm
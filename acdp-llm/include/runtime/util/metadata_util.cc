@@ -15,14 +15,36 @@
 #include "runtime/util/metadata_util.h"
 
 #include <string>
+#include <vector>
 
 #include "absl/log/absl_log.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
 #include "runtime/proto/llm_metadata.pb.h"
+#include "runtime/proto/token.pb.h"
 
 namespace litert::lm {
+namespace {
+
+void ConvertTokenToIds(Tokenizer& tokenizer, proto::TokenUnion& token) {
+  if (!token.has_token_str()) {
+    return;
+  }
+  auto token_id = tokenizer.TokenToId(token.token_str());
+  if (token_id.ok()) {
+    token.mutable_token_ids()->mutable_ids()->Add(*token_id);
+    return;
+  }
+  auto token_ids = tokenizer.TextToTokenIds(token.token_str());
+  if (token_ids.ok()) {
+    token.mutable_token_ids()->mutable_ids()->Add(token_ids->begin(),
+                                                  token_ids->end());
+  }
+}
+
+}  // namespace
 
 absl::StatusOr<proto::LlmMetadata> ExtractOrConvertLlmMetadata(
     absl::string_view string_view) {
@@ -35,4 +57,14 @@ absl::StatusOr<proto::LlmMetadata> ExtractOrConvertLlmMetadata(
   return llm_metadata;
 }
 
+void ConvertLlmMetadataTokensToIds(Tokenizer& tokenizer,
+                                   proto::LlmMetadata& metadata) {
+  for (proto::TokenUnion& stop_token : *metadata.mutable_stop_tokens()) {
+    ConvertTokenToIds(tokenizer, stop_token);
+  }
+  if (metadata.has_start_token()) {
+    ConvertTokenToIds(tokenizer, *metadata.mutable_start_token());
+  }
+}
+
 }  // namespace litert::lm
@@ -17,6 +17,7 @@
 
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/components/tokenizer.h"
 #include "runtime/proto/llm_metadata.pb.h"
 
 namespace litert::lm {
@@ -27,6 +28,13 @@ namespace litert::lm {
 // Returns the LlmMetadata if successful, otherwise returns the error status.
 absl::StatusOr<proto::LlmMetadata> ExtractOrConvertLlmMetadata(
     absl::string_view string_view);
+
+// Converts the start and stop tokens of `metadata` given as strings to their
+// ids with `tokenizer`, as a single token if the tokenizer has one, or as the
+// ids of their text otherwise. The tokens failing to convert are left as is.
+void ConvertLlmMetadataTokensToIds(Tokenizer& tokenizer,
+                                   proto::LlmMetadata& metadata);
+
 }  // namespace litert::lm
 
 #endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_METADATA_UTIL_H_
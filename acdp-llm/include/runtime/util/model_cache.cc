@@ -0,0 +1,167 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/util/model_cache.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>  // NOLINT: Required for path manipulation.
+#include <fstream>
+#include <memory>
+#include <string>
+#include <system_error>  // NOLINT
+
+#include "absl/crc/crc32c.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/util/memory_mapped_file.h"
+#include "runtime/util/scoped_file.h"
+#include "runtime/util/status_macros.h"  // IWYU pragma: keep
+
+namespace litert::lm {
+namespace {
+
+// The files up to kNumSampledBlocks * kSampledBlockSize bytes are hashed
+// whole, the larger ones through that many blocks evenly spread.
+constexpr size_t kNumSampledBlocks = 64;
+constexpr size_t kSampledBlockSize = 64 * 1024;
+
+constexpr absl::string_view kArchitecture =
+#if defined(__aarch64__) || defined(_M_ARM64)
+    "arm64";
+#elif defined(__x86_64__) || defined(_M_X64)
+    "x86_64";
+#elif defined(__arm__) || defined(_M_ARM)
+    "arm";
+#elif defined(__i386__) || defined(_M_IX86)
+    "x86";
+#else
+    "unknown";
+#endif
+
+}  // namespace
+
+absl::StatusOr<std::string> ComputeModelFingerprint(const ScopedFile& file) {
+  ASSIGN_OR_RETURN(size_t size, file.GetSize());
+  if (size == 0) {
+    return absl::InvalidArgumentError("The model file is empty.");
+  }
+  ASSIGN_OR_RETURN(std::unique_ptr<MemoryMappedFile> mapped_file,
+                   MemoryMappedFile::Create(file.file()));
+  const absl::string_view data(
+      reinterpret_cast<const char*>(mapped_file->data()),
+      mapped_file->length());
+  absl::crc32c_t crc{0};
+  if (data.size() <= kNumSampledBlocks * kSampledBlockSize) {
+    crc = absl::ComputeCrc32c(data);
+  } else {
+    // The first and the last blocks always count, the header and the end of
+    // the weights.
+    const uint64_t last_offset = data.size() - kSampledBlockSize;
+    for (size_t i = 0; i < kNumSampledBlocks; ++i) {
+      const size_t offset = last_offset * i / (kNumSampledBlocks - 1);
+      crc = absl::ExtendCrc32c(crc, data.substr(offset, kSampledBlockSize));
+    }
+  }
+  return absl::StrCat(absl::Hex(data.size()), "-",
+                      absl::Hex(static_cast<uint32_t>(crc), absl::kZeroPad8));
+}
+
+absl::string_view GetHostArchitecture() { return kArchitecture; }
+
+absl::StatusOr<std::string> GetModelCacheDir(absl::string_view cache_dir,
+                                             absl::string_view fingerprint,
+                                             absl::string_view backend) {
+  if (cache_dir.empty()) {
+    return absl::InvalidArgumentError("The cache directory is empty.");
+  }
+  const std::filesystem::path model_cache_dir =
+      std::filesystem::path(std::string(cache_dir)) / std::string(fingerprint) /
+      absl::StrCat(backend, "-", kArchitecture);
+  std::error_code error;
+  std::filesystem::create_directories(model_cache_dir, error);
+  if (error) {
+    return absl::InternalError(absl::StrCat("Failed to create ",
+                                            model_cache_dir.string(), ": ",
+                                            error.message()));
+  }
+  return model_cache_dir.string();
+}
+
+absl::StatusOr<std::string> GetSharedMemoryCacheDir(absl::string_view name) {
+  if (name.empty() || name == "." || name == ".." ||
+      name.find('/') != absl::string_view::npos) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid shared memory cache name: ", name));
+  }
+#if defined(__linux__)
+  const std::filesystem::path shared_memory_dir = "/dev/shm";
+  std::error_code error;
+  if (!std::filesystem::is_directory(shared_memory_dir, error)) {
+    return absl::UnimplementedError(
+        "The shared memory filesystem /dev/shm is not available.");
+  }
+  const std::filesystem::path cache_dir =
+      shared_memory_dir / absl::StrCat("litert_lm-", name);
+  std::filesystem::create_directories(cache_dir, error);
+  if (error) {
+    return absl::InternalError(absl::StrCat(
+        "Failed to create ", cache_dir.string(), ": ", error.message()));
+  }
+  return cache_dir.string();
+#else
+  return absl::UnimplementedError(
+      "Shared memory caches are only supported on Linux.");
+#endif  // defined(__linux__)
+}
+
+absl::Status WriteFileAtomically(absl::string_view path,
+                                 absl::string_view contents) {
+  // Unique to the process and the call, as the writers may race.
+  static std::atomic<uint64_t> num_writes = 0;
+  const std::string temporary_path =
+      absl::StrCat(path, ".tmp-", absl::ToUnixNanos(absl::Now()), "-",
+                   num_writes.fetch_add(1));
+  {
+    std::ofstream file{temporary_path, std::ios::binary | std::ios::trunc};
+    if (!file) {
+      return absl::InternalError(
+          absl::StrCat("Failed to open ", temporary_path));
+    }
+    file.write(contents.data(), contents.size());
+    file.close();
+    if (!file) {
+      std::filesystem::remove(temporary_path);
+      return absl::InternalError(
+          absl::StrCat("Failed to write ", temporary_path));
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(temporary_path, std::string(path), error);
+  if (error) {
+    std::filesystem::remove(temporary_path);
+    return absl::InternalError(absl::StrCat("Failed to rename ",
+                                            temporary_path, " to ", path,
+                                            ": ", error.message()));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,59 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_MODEL_CACHE_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_MODEL_CACHE_H_
+
+#include <string>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/util/scoped_file.h"
+
+namespace litert::lm {
+
+// Returns a fingerprint of the contents of the model file, the same for the
+// copies of the model on different machines: its size and the CRC32C of
+// blocks sampled over the whole file, or of the whole file if small.
+absl::StatusOr<std::string> ComputeModelFingerprint(const ScopedFile& file);
+
+// Returns the name of the cpu architecture the runtime is built for, e.g.
+// "arm64" or "x86_64".
+absl::string_view GetHostArchitecture();
+
+// Returns the directory of the artifacts compiled from the model of
+// `fingerprint` for `backend` on this architecture,
+// `<cache_dir>/<fingerprint>/<backend>-<architecture>`, creating it if needed.
+absl::StatusOr<std::string> GetModelCacheDir(absl::string_view cache_dir,
+                                             absl::string_view fingerprint,
+                                             absl::string_view backend);
+
+// Returns the model cache directory named `name` in the shared memory of the
+// host, `/dev/shm/litert_lm-<name>`, creating it if needed. The artifacts
+// cached there, e.g. the weights repacked by the backends, stay in memory and
+// the processes of the host mapping them share their pages, so only the first
+// process loading a model pays for them. Only available on Linux.
+absl::StatusOr<std::string> GetSharedMemoryCacheDir(absl::string_view name);
+
+// Writes `contents` to `path` through a temporary file renamed over it, so
+// that the processes sharing the file see either the previous file or the
+// complete new one, never a partial write.
+absl::Status WriteFileAtomically(absl::string_view path,
+                                 absl::string_view contents);
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_MODEL_CACHE_H_
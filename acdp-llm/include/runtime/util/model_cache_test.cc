@@ -0,0 +1,130 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/util/model_cache.h"
+
+#include <filesystem>  // NOLINT: Required for path manipulation.
+#include <fstream>
+#include <ios>
+#include <sstream>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/match.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "runtime/util/scoped_file.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::StatusIs;
+
+std::string WriteTestFile(absl::string_view name, absl::string_view contents) {
+  const std::filesystem::path path =
+      std::filesystem::path(::testing::TempDir()) / std::string(name);
+  std::ofstream file(path, std::ios::binary);
+  file.write(contents.data(), contents.size());
+  return path.string();
+}
+
+std::string ReadTestFile(absl::string_view path) {
+  std::ifstream file{std::string(path), std::ios::binary};
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+TEST(ModelCacheTest, FingerprintsDependOnTheContents) {
+  const std::string small(1000, 'a');
+  std::string large(10 * 1024 * 1024, 'a');
+  ASSERT_OK_AND_ASSIGN(ScopedFile small_file,
+                       ScopedFile::Open(WriteTestFile("small", small)));
+  ASSERT_OK_AND_ASSIGN(ScopedFile large_file,
+                       ScopedFile::Open(WriteTestFile("large", large)));
+  ASSERT_OK_AND_ASSIGN(ScopedFile same_file,
+                       ScopedFile::Open(WriteTestFile("same", large)));
+  large.back() = 'b';
+  ASSERT_OK_AND_ASSIGN(ScopedFile other_file,
+                       ScopedFile::Open(WriteTestFile("other", large)));
+
+  ASSERT_OK_AND_ASSIGN(std::string small_fingerprint,
+                       ComputeModelFingerprint(small_file));
+  ASSERT_OK_AND_ASSIGN(std::string large_fingerprint,
+                       ComputeModelFingerprint(large_file));
+  ASSERT_OK_AND_ASSIGN(std::string same_fingerprint,
+                       ComputeModelFingerprint(same_file));
+  ASSERT_OK_AND_ASSIGN(std::string other_fingerprint,
+                       ComputeModelFingerprint(other_file));
+  EXPECT_NE(small_fingerprint, large_fingerprint);
+  EXPECT_EQ(large_fingerprint, same_fingerprint);
+  EXPECT_NE(large_fingerprint, other_fingerprint);
+}
+
+TEST(ModelCacheTest, FingerprintFailsOnEmptyFile) {
+  ASSERT_OK_AND_ASSIGN(ScopedFile file,
+                       ScopedFile::Open(WriteTestFile("empty", "")));
+  EXPECT_THAT(ComputeModelFingerprint(file),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ModelCacheTest, GetModelCacheDirCreatesTheDirectory) {
+  const std::string cache_dir =
+      (std::filesystem::path(::testing::TempDir()) / "cache").string();
+  ASSERT_OK_AND_ASSIGN(std::string gpu_dir,
+                       GetModelCacheDir(cache_dir, "1234-abcd", "GPU"));
+  ASSERT_OK_AND_ASSIGN(std::string cpu_dir,
+                       GetModelCacheDir(cache_dir, "1234-abcd", "CPU"));
+  EXPECT_NE(gpu_dir, cpu_dir);
+  EXPECT_TRUE(std::filesystem::is_directory(gpu_dir));
+  EXPECT_TRUE(std::filesystem::is_directory(cpu_dir));
+  EXPECT_EQ(std::filesystem::path(gpu_dir).parent_path(),
+            std::filesystem::path(cache_dir) / "1234-abcd");
+  EXPECT_THAT(GetModelCacheDir("", "1234-abcd", "GPU"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ModelCacheTest, GetSharedMemoryCacheDirRejectsInvalidNames) {
+  for (absl::string_view name : {"", ".", "..", "a/b"}) {
+    EXPECT_THAT(GetSharedMemoryCacheDir(name),
+                StatusIs(absl::StatusCode::kInvalidArgument));
+  }
+}
+
+TEST(ModelCacheTest, WriteFileAtomicallyReplacesTheFile) {
+  const std::string path = WriteTestFile("atomic", "previous contents");
+  ASSERT_OK(WriteFileAtomically(path, "new contents"));
+  EXPECT_EQ(ReadTestFile(path), "new contents");
+  // No temporary file is left behind.
+  int num_files = 0;
+  for (const auto& entry : std::filesystem::directory_iterator(
+           std::filesystem::path(path).parent_path())) {
+    num_files += absl::StartsWith(entry.path().filename().string(), "atomic");
+  }
+  EXPECT_EQ(num_files, 1);
+}
+
+TEST(ModelCacheTest, WriteFileAtomicallyFailsOnMissingDirectory) {
+  const std::string path =
+      (std::filesystem::path(::testing::TempDir()) / "missing" / "file")
+          .string();
+  EXPECT_THAT(WriteFileAtomically(path, "contents"),
+              StatusIs(absl::StatusCode::kInternal));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,161 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/util/model_verification.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <thread>  // NOLINT: Required for the verification thread.
+#include <utility>
+
+#include "absl/crc/crc32c.h"  // from @com_google_absl
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/match.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "flatbuffers/base.h"  // from @flatbuffers
+#include "flatbuffers/verifier.h"  // from @flatbuffers
+#include "tflite/schema/schema_generated.h"  // from @litert
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace litert::lm {
+namespace {
+
+// Lowers the priority of the calling thread, so that the verification only
+// uses the cores left idle by the serving.
+void LowerThreadPriority() {
+#if defined(_WIN32)
+  SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(__linux__)
+  // The nice value of a thread on Linux, unlike POSIX.
+  setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+#endif
+}
+
+}  // namespace
+
+std::ostream& operator<<(std::ostream& os, ModelVerificationMode mode) {
+  switch (mode) {
+    case ModelVerificationMode::kEager:
+      return os << "EAGER";
+    case ModelVerificationMode::kBackground:
+      return os << "BACKGROUND";
+    case ModelVerificationMode::kSkipWithChecksum:
+      return os << "SKIP_WITH_CHECKSUM";
+  }
+  return os << "UNKNOWN";
+}
+
+std::string ComputeChecksum(absl::string_view data) {
+  const uint32_t crc = static_cast<uint32_t>(absl::ComputeCrc32c(data));
+  return absl::StrCat(absl::Hex(crc, absl::kZeroPad8));
+}
+
+absl::Status VerifyChecksum(absl::string_view name, absl::string_view data,
+                            absl::string_view expected_checksum) {
+  const std::string checksum = ComputeChecksum(data);
+  if (!absl::EqualsIgnoreCase(checksum, expected_checksum)) {
+    return absl::DataLossError(
+        absl::StrCat("The checksum of ", name, " is ", checksum,
+                     ", expected ", expected_checksum, "."));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status VerifyTfLiteModel(absl::string_view name, const uint8_t* data,
+                               size_t size) {
+  // The buffers of the models over 2 GB follow the flatbuffer, out of its
+  // verification.
+  flatbuffers::Verifier verifier(
+      data,
+      std::min(size, static_cast<size_t>(FLATBUFFERS_MAX_BUFFER_SIZE - 1)));
+  if (!tflite::VerifyModelBuffer(verifier)) {
+    return absl::DataLossError(
+        absl::StrCat(name, " is not a valid TFLite model."));
+  }
+  return absl::OkStatus();
+}
+
+BackgroundVerifier::~BackgroundVerifier() {
+  std::thread thread;
+  {
+    absl::MutexLock lock(&mutex_);
+    stopping_ = true;
+    verifications_.clear();
+    thread = std::move(thread_);
+  }
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
+
+void BackgroundVerifier::Schedule(
+    absl::AnyInvocable<absl::Status()> verification) {
+  absl::MutexLock lock(&mutex_);
+  verifications_.push_back(std::move(verification));
+  if (!thread_.joinable()) {
+    thread_ = std::thread([this]() { Run(); });
+  }
+}
+
+absl::Status BackgroundVerifier::Wait() {
+  absl::MutexLock lock(&mutex_);
+  auto done = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return verifications_.empty() && !verifying_;
+  };
+  mutex_.Await(absl::Condition(&done));
+  return status_;
+}
+
+void BackgroundVerifier::Run() {
+  LowerThreadPriority();
+  absl::MutexLock lock(&mutex_);
+  auto has_work = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return stopping_ || !verifications_.empty();
+  };
+  while (true) {
+    mutex_.Await(absl::Condition(&has_work));
+    if (stopping_) {
+      return;
+    }
+    absl::AnyInvocable<absl::Status()> verification =
+        std::move(verifications_.front());
+    verifications_.pop_front();
+    verifying_ = true;
+    mutex_.Unlock();
+    absl::Status status = verification();
+    if (!status.ok()) {
+      ABSL_LOG(ERROR) << "Model verification failed: " << status;
+    }
+    mutex_.Lock();
+    verifying_ = false;
+    status_.Update(status);
+  }
+}
+
+}  // namespace litert::lm
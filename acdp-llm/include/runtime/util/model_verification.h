@@ -0,0 +1,107 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_MODEL_VERIFICATION_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_MODEL_VERIFICATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <thread>  // NOLINT: Required for the verification thread.
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/functional/any_invocable.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// When the models loaded from a file are verified, i.e. their flatbuffers
+// checked and their checksums compared.
+enum class ModelVerificationMode {
+  // The models are verified before being used, which delays the loading by a
+  // read of the whole models.
+  kEager = 0,
+  // The models are used right away and verified on a low-priority background
+  // thread, which reports the failures. For the files of a trusted origin,
+  // where the verification only guards against a corruption.
+  kBackground = 1,
+  // The flatbuffers are not verified, only the checksums of the sections
+  // having one are compared, on the background thread.
+  kSkipWithChecksum = 2,
+};
+std::ostream& operator<<(std::ostream& os, ModelVerificationMode mode);
+
+// The key of the section item holding the CRC32C of the section data, as 8
+// hexadecimal digits.
+inline constexpr absl::string_view kChecksumItemKey = "crc32c";
+
+// Returns the CRC32C of `data` formatted as in the checksum items.
+std::string ComputeChecksum(absl::string_view data);
+
+// Returns a DataLoss error if the CRC32C of `data`, of the section `name`,
+// is not `expected_checksum`.
+absl::Status VerifyChecksum(absl::string_view name, absl::string_view data,
+                            absl::string_view expected_checksum);
+
+// Returns a DataLoss error if `data`, of the section `name`, is not a valid
+// TFLite model flatbuffer.
+absl::Status VerifyTfLiteModel(absl::string_view name, const uint8_t* data,
+                               size_t size);
+
+// Runs verifications one after the other on a low-priority thread, started
+// on the first one.
+//
+// Example usage:
+//   BackgroundVerifier verifier;
+//   verifier.Schedule([data]() { return VerifyChecksum(...); });
+//   // ... use the data ...
+//   RETURN_IF_ERROR(verifier.Wait());
+class BackgroundVerifier {
+ public:
+  BackgroundVerifier() = default;
+  // Drops the verifications not started and waits for the one in progress,
+  // so that the data verified may be released afterwards.
+  ~BackgroundVerifier();
+
+  BackgroundVerifier(const BackgroundVerifier&) = delete;
+  BackgroundVerifier& operator=(const BackgroundVerifier&) = delete;
+
+  // Schedules `verification`, logging its failure.
+  void Schedule(absl::AnyInvocable<absl::Status()> verification);
+
+  // Waits for the verifications scheduled so far and returns the first
+  // failure, if any.
+  absl::Status Wait();
+
+ private:
+  void Run();
+
+  absl::Mutex mutex_;
+  std::deque<absl::AnyInvocable<absl::Status()>> verifications_
+      ABSL_GUARDED_BY(mutex_);
+  // Whether a verification is in progress.
+  bool verifying_ ABSL_GUARDED_BY(mutex_) = false;
+  bool stopping_ ABSL_GUARDED_BY(mutex_) = false;
+  absl::Status status_ ABSL_GUARDED_BY(mutex_);
+  std::thread thread_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_MODEL_VERIFICATION_H_
@@ -0,0 +1,104 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/util/model_verification.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/synchronization/notification.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::status::StatusIs;
+
+TEST(ModelVerificationTest, VerifyChecksum) {
+  const std::string checksum = ComputeChecksum("section data");
+  EXPECT_EQ(checksum.size(), 8);
+  EXPECT_OK(VerifyChecksum("section", "section data", checksum));
+  EXPECT_THAT(VerifyChecksum("section", "corrupted data", checksum),
+              StatusIs(absl::StatusCode::kDataLoss));
+}
+
+TEST(ModelVerificationTest, VerifyTfLiteModelFailsOnInvalidModel) {
+  const std::vector<uint8_t> data(64, 0xff);
+  EXPECT_THAT(VerifyTfLiteModel("model", data.data(), data.size()),
+              StatusIs(absl::StatusCode::kDataLoss));
+}
+
+TEST(BackgroundVerifierTest, RunsTheVerificationsInOrder) {
+  BackgroundVerifier verifier;
+  std::vector<int> verified;
+  for (int i = 0; i < 3; ++i) {
+    verifier.Schedule([&verified, i]() {
+      verified.push_back(i);
+      return absl::OkStatus();
+    });
+  }
+  EXPECT_OK(verifier.Wait());
+  EXPECT_THAT(verified, ElementsAre(0, 1, 2));
+}
+
+TEST(BackgroundVerifierTest, ReturnsTheFirstFailure) {
+  BackgroundVerifier verifier;
+  EXPECT_OK(verifier.Wait());
+  verifier.Schedule([]() { return absl::DataLossError("first"); });
+  verifier.Schedule([]() { return absl::InternalError("second"); });
+  EXPECT_THAT(verifier.Wait(), StatusIs(absl::StatusCode::kDataLoss));
+  verifier.Schedule([]() { return absl::OkStatus(); });
+  EXPECT_THAT(verifier.Wait(), StatusIs(absl::StatusCode::kDataLoss));
+}
+
+TEST(BackgroundVerifierTest, DestructionDropsThePendingVerifications) {
+  std::atomic<int> num_verified = 0;
+  absl::Notification started;
+  absl::Notification release;
+  std::thread releaser;
+  {
+    BackgroundVerifier verifier;
+    verifier.Schedule([&]() {
+      started.Notify();
+      release.WaitForNotification();
+      ++num_verified;
+      return absl::OkStatus();
+    });
+    verifier.Schedule([&]() {
+      ++num_verified;
+      return absl::OkStatus();
+    });
+    started.WaitForNotification();
+    // Released after the destructor dropped the second verification.
+    releaser = std::thread([&]() {
+      absl::SleepFor(absl::Milliseconds(50));
+      release.Notify();
+    });
+  }
+  releaser.join();
+  EXPECT_EQ(num_verified, 1);
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,137 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/util/parallel_read.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "runtime/util/scoped_file.h"
+
+namespace litert::lm {
+namespace {
+
+// Reads `length` bytes of `file` from `offset` into `buffer`, without moving
+// a file position shared with the other threads.
+absl::Status ReadChunk(ScopedFile::PlatformFile file, uint64_t offset,
+                       uint64_t length, char* buffer) {
+  while (length > 0) {
+#if defined(_WIN32)
+    OVERLAPPED overlapped = {};
+    ULARGE_INTEGER position = {};
+    position.QuadPart = offset;
+    overlapped.Offset = position.LowPart;
+    overlapped.OffsetHigh = position.HighPart;
+    // ReadFile takes less than 4GB at a time.
+    const DWORD max_num_read =
+        static_cast<DWORD>(std::min<uint64_t>(length, 1u << 30));
+    DWORD num_read = 0;
+    if (!::ReadFile(file, buffer, max_num_read, &num_read, &overlapped)) {
+      return absl::DataLossError(absl::StrCat("Failed to read the file at ",
+                                              offset, ", error: ",
+                                              ::GetLastError()));
+    }
+#else
+    const ssize_t num_read = pread(file, buffer, length, offset);
+    if (num_read < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return absl::DataLossError(absl::StrCat(
+          "Failed to read the file at ", offset, ", error: ", strerror(errno)));
+    }
+#endif
+    if (num_read == 0) {
+      return absl::DataLossError(
+          absl::StrCat("Unexpected end of the file at ", offset));
+    }
+    offset += num_read;
+    buffer += num_read;
+    length -= num_read;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status ReadFileInParallel(ScopedFile::PlatformFile file,
+                                uint64_t offset, uint64_t length,
+                                void* buffer, int num_threads,
+                                const ReadProgressCallback& progress,
+                                uint64_t chunk_size) {
+  if (num_threads <= 0 || chunk_size == 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid parallel read of ", num_threads,
+                     " threads and chunks of ", chunk_size, " bytes."));
+  }
+  const uint64_t num_chunks = (length + chunk_size - 1) / chunk_size;
+  std::atomic<uint64_t> next_chunk = 0;
+  absl::Mutex mutex;
+  // Guarded by `mutex`.
+  absl::Status status;
+  uint64_t num_read_bytes = 0;
+  auto read_chunks = [&]() {
+    for (uint64_t chunk = next_chunk++; chunk < num_chunks;
+         chunk = next_chunk++) {
+      const uint64_t chunk_offset = chunk * chunk_size;
+      const uint64_t chunk_length =
+          std::min(chunk_size, length - chunk_offset);
+      absl::Status chunk_status =
+          ReadChunk(file, offset + chunk_offset, chunk_length,
+                    static_cast<char*>(buffer) + chunk_offset);
+      absl::MutexLock lock(&mutex);
+      if (!chunk_status.ok()) {
+        status.Update(chunk_status);
+        // Let the other threads stop after their current chunk.
+        next_chunk = num_chunks;
+        return;
+      }
+      num_read_bytes += chunk_length;
+      if (progress) {
+        progress(num_read_bytes, length);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  const int num_extra_threads =
+      static_cast<int>(std::min<uint64_t>(num_threads, num_chunks)) - 1;
+  for (int i = 0; i < num_extra_threads; ++i) {
+    threads.emplace_back(read_chunks);
+  }
+  read_chunks();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  absl::MutexLock lock(&mutex);
+  return status;
+}
+
+}  // namespace litert::lm
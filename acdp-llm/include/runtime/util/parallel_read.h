@@ -0,0 +1,50 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_PARALLEL_READ_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_PARALLEL_READ_H_
+
+#include <cstdint>
+#include <functional>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "runtime/util/scoped_file.h"
+
+namespace litert::lm {
+
+// Called as the bytes are read, with the number of bytes read so far and the
+// number of bytes to read. The calls are serialized, but may come from any of
+// the reading threads.
+using ReadProgressCallback =
+    std::function<void(uint64_t num_read_bytes, uint64_t num_bytes)>;
+
+// The size of the reads of ReadFileInParallel. Large enough for the network
+// filesystems to stream each read, small enough to balance the threads.
+inline constexpr uint64_t kParallelReadChunkSize = 8 * 1024 * 1024;
+
+// Reads `length` bytes of `file` from `offset` into `buffer`, with up to
+// `num_threads` positional reads of `chunk_size` bytes in flight. Unlike the
+// page faults of a mapping, which turn into small reads one at a time, this
+// keeps the remote filesystems, e.g. NFS or network block devices, busy.
+// Does not take ownership of `file`.
+absl::Status ReadFileInParallel(ScopedFile::PlatformFile file,
+                                uint64_t offset, uint64_t length,
+                                void* buffer, int num_threads,
+                                const ReadProgressCallback& progress = nullptr,
+                                uint64_t chunk_size = kParallelReadChunkSize);
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_PARALLEL_READ_H_
@@ -0,0 +1,77 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/util/parallel_read.h"
+
+#include <cstdint>
+#include <filesystem>  // NOLINT: Required for path manipulation.
+#include <fstream>
+#include <ios>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "runtime/util/scoped_file.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::status::StatusIs;
+
+std::string WriteTestFile(const std::string& contents) {
+  auto path = std::filesystem::path(::testing::TempDir()) / "parallel.bin";
+  std::ofstream ofstr(path.string(), std::ios::out | std::ios::binary);
+  ofstr << contents;
+  return path.string();
+}
+
+TEST(ParallelReadTest, ReadsTheRangeInChunks) {
+  std::string contents;
+  for (int i = 0; i < 1000; ++i) {
+    contents += static_cast<char>('a' + i % 26);
+  }
+  ASSERT_OK_AND_ASSIGN(auto file, ScopedFile::Open(WriteTestFile(contents)));
+
+  std::string buffer(900, '\0');
+  uint64_t last_num_read_bytes = 0;
+  int num_progress_calls = 0;
+  EXPECT_OK(ReadFileInParallel(
+      file.file(), /*offset=*/100, /*length=*/900, buffer.data(),
+      /*num_threads=*/4,
+      [&](uint64_t num_read_bytes, uint64_t num_bytes) {
+        EXPECT_GT(num_read_bytes, last_num_read_bytes);
+        EXPECT_EQ(num_bytes, 900);
+        last_num_read_bytes = num_read_bytes;
+        ++num_progress_calls;
+      },
+      /*chunk_size=*/64));
+  EXPECT_EQ(buffer, contents.substr(100));
+  EXPECT_EQ(last_num_read_bytes, 900);
+  EXPECT_EQ(num_progress_calls, 15);
+}
+
+TEST(ParallelReadTest, FailsReadingPastTheEnd) {
+  ASSERT_OK_AND_ASSIGN(auto file, ScopedFile::Open(WriteTestFile("foo bar")));
+  std::string buffer(16, '\0');
+  EXPECT_THAT(ReadFileInParallel(file.file(), /*offset=*/0, /*length=*/16,
+                                 buffer.data(), /*num_threads=*/2,
+                                 /*progress=*/nullptr, /*chunk_size=*/4),
+              StatusIs(absl::StatusCode::kDataLoss));
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,187 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/util/task_converter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "flatbuffers/flatbuffer_builder.h"  // from @flatbuffers
+#include "runtime/components/model_resources.h"
+#include "runtime/proto/llm_metadata.pb.h"
+#include "runtime/util/memory_mapped_file.h"
+#include "runtime/util/metadata_util.h"
+#include "runtime/util/model_verification.h"
+#include "runtime/util/status_macros.h"
+#include "runtime/util/zip_utils.h"
+#include "schema/core/litertlm_header.h"
+#include "schema/core/litertlm_header_schema_generated.h"
+
+namespace litert::lm {
+namespace {
+
+constexpr char kMagic[] = "LITERTLM";
+// The magic, the versions and the end offset of the header come before the
+// header itself.
+constexpr uint64_t kHeaderBeginOffset = 32;
+
+struct Section {
+  schema::AnySectionDataType data_type;
+  std::optional<std::string> model_type;
+  absl::string_view data;
+};
+
+uint64_t AlignUp(uint64_t offset) {
+  return (offset + kLitertLmSectionAlignment - 1) /
+         kLitertLmSectionAlignment * kLitertLmSectionAlignment;
+}
+
+// Builds the header of the `sections` laid out from `begin_offset`, one after
+// the other at the section alignment.
+flatbuffers::DetachedBuffer BuildHeader(const std::vector<Section>& sections,
+                                        uint64_t begin_offset) {
+  flatbuffers::FlatBufferBuilder builder;
+  // Writes the offsets even when they are 0, so that the size of the header
+  // doesn't depend on them.
+  builder.ForceDefaults(true);
+  std::vector<flatbuffers::Offset<schema::SectionObject>> objects;
+  uint64_t offset = begin_offset;
+  for (const Section& section : sections) {
+    std::vector<flatbuffers::Offset<schema::KeyValuePair>> items;
+    if (section.model_type.has_value()) {
+      auto value =
+          schema::CreateStringValueDirect(builder, section.model_type->c_str());
+      items.push_back(schema::CreateKeyValuePairDirect(
+          builder, "model_type", schema::VData_StringValue, value.Union()));
+    }
+    // Lets the loaders verify the section without parsing it.
+    auto checksum = schema::CreateStringValueDirect(
+        builder, ComputeChecksum(section.data).c_str());
+    items.push_back(schema::CreateKeyValuePairDirect(
+        builder, std::string(kChecksumItemKey).c_str(),
+        schema::VData_StringValue, checksum.Union()));
+    offset = AlignUp(offset);
+    objects.push_back(schema::CreateSectionObjectDirect(
+        builder, &items, offset, offset + section.data.size(),
+        section.data_type));
+    offset += section.data.size();
+  }
+  std::vector<flatbuffers::Offset<schema::KeyValuePair>> entries;
+  auto system_metadata = schema::CreateSystemMetadataDirect(builder, &entries);
+  auto section_metadata =
+      schema::CreateSectionMetadataDirect(builder, &objects);
+  builder.Finish(schema::CreateLiteRTLMMetaData(builder, system_metadata,
+                                                section_metadata));
+  return builder.Release();
+}
+
+void WriteUint32(std::ofstream& file, uint32_t value) {
+  const char bytes[] = {
+      static_cast<char>(value), static_cast<char>(value >> 8),
+      static_cast<char>(value >> 16), static_cast<char>(value >> 24)};
+  file.write(bytes, sizeof(bytes));
+}
+
+absl::Status WriteLitertLm(absl::string_view path,
+                           const std::vector<Section>& sections) {
+  // The header is built a first time to find where the sections begin.
+  const uint64_t header_size = BuildHeader(sections, 0).size();
+  const uint64_t header_end_offset = kHeaderBeginOffset + header_size;
+  const uint64_t sections_begin_offset = AlignUp(header_end_offset);
+  flatbuffers::DetachedBuffer header =
+      BuildHeader(sections, sections_begin_offset);
+  RET_CHECK_EQ(header.size(), header_size);
+
+  std::ofstream file{std::string(path), std::ios::binary | std::ios::trunc};
+  if (!file) {
+    return absl::InternalError(absl::StrCat("Failed to open ", path));
+  }
+  file.write(kMagic, sizeof(kMagic) - 1);
+  WriteUint32(file, schema::LITERTLM_MAJOR_VERSION);
+  WriteUint32(file, schema::LITERTLM_MINOR_VERSION);
+  WriteUint32(file, schema::LITERTLM_PATCH_VERSION);
+  WriteUint32(file, 0);
+  WriteUint32(file, header_end_offset & 0xffffffff);
+  WriteUint32(file, header_end_offset >> 32);
+  file.write(reinterpret_cast<const char*>(header.data()), header.size());
+  uint64_t written = header_end_offset;
+  for (const Section& section : sections) {
+    const std::string padding(AlignUp(written) - written, '\0');
+    file.write(padding.data(), padding.size());
+    file.write(section.data.data(), section.data.size());
+    written = AlignUp(written) + section.data.size();
+  }
+  file.close();
+  if (!file) {
+    return absl::InternalError(absl::StrCat("Failed to write ", path));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status ConvertTaskToLitertLm(absl::string_view task_path,
+                                   absl::string_view litertlm_path) {
+  ASSIGN_OR_RETURN(std::unique_ptr<MemoryMappedFile> task_file,
+                   MemoryMappedFile::Create(task_path));
+  const absl::string_view task_data(
+      reinterpret_cast<const char*>(task_file->data()), task_file->length());
+  ASSIGN_OR_RETURN(auto files, ExtractFilesfromZipFile(task_data));
+
+  // Keeps the order of the bundle, which is usually the order of use.
+  std::vector<std::pair<std::string, OffsetAndSize>> sorted_files(
+      files.begin(), files.end());
+  std::sort(sorted_files.begin(), sorted_files.end(),
+            [](const auto& a, const auto& b) { return a.second < b.second; });
+
+  std::string llm_metadata;
+  std::vector<Section> sections;
+  for (const auto& [name, location] : sorted_files) {
+    const absl::string_view data =
+        task_data.substr(location.offset, location.size);
+    if (name == "TOKENIZER_MODEL") {
+      sections.push_back({.data_type = schema::AnySectionDataType_SP_Tokenizer,
+                          .data = data});
+    } else if (name == "METADATA") {
+      ASSIGN_OR_RETURN(proto::LlmMetadata metadata,
+                       ExtractOrConvertLlmMetadata(data));
+      llm_metadata = metadata.SerializeAsString();
+      sections.push_back(
+          {.data_type = schema::AnySectionDataType_LlmMetadataProto,
+           .data = llm_metadata});
+    } else if (StringToModelType(name).ok()) {
+      sections.push_back({.data_type = schema::AnySectionDataType_TFLiteModel,
+                          .model_type = name,
+                          .data = data});
+    } else {
+      ABSL_LOG(WARNING) << "Skipping " << name << " of " << task_path;
+    }
+  }
+  return WriteLitertLm(litertlm_path, sections);
+}
+
+}  // namespace litert::lm
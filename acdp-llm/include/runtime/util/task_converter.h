@@ -0,0 +1,44 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_TASK_CONVERTER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_TASK_CONVERTER_H_
+
+#include <cstdint>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// The alignment of the sections written by the converter, a multiple of the
+// page sizes of the supported platforms, so that each section can be mapped
+// in place.
+inline constexpr uint64_t kLitertLmSectionAlignment = 16 * 1024;
+
+// Converts the .task bundle at `task_path` into the .litertlm file at
+// `litertlm_path`, so that the model loads through LitertLmLoader rather than
+// through the zip archive:
+//  - The TF_LITE_* files become TFLite model sections of that model type.
+//  - TOKENIZER_MODEL becomes the SentencePiece tokenizer section.
+//  - METADATA becomes the LlmMetadata section, converted from the legacy
+//    LlmParameters if needed.
+// The other files of the bundle are skipped with a warning.
+absl::Status ConvertTaskToLitertLm(absl::string_view task_path,
+                                   absl::string_view litertlm_path);
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_TASK_CONVERTER_H_
@@ -0,0 +1,58 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "runtime/util/task_converter.h"
+
+#include <filesystem>  // NOLINT: Required for path manipulation.
+#include <utility>
+
+#include <gtest/gtest.h>
+#include "runtime/components/model_resources.h"
+#include "runtime/util/litert_lm_loader.h"
+#include "runtime/util/scoped_file.h"
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+TEST(TaskConverterTest, ConvertTaskToLitertLm) {
+  const auto task_path =
+      std::filesystem::path(::testing::SrcDir()) /
+      "litert_lm/runtime/testdata/test_lm_new_metadata.task";
+  const auto litertlm_path =
+      std::filesystem::path(::testing::TempDir()) / "test_lm.litertlm";
+  ASSERT_OK(
+      ConvertTaskToLitertLm(task_path.string(), litertlm_path.string()));
+
+  auto model_file = ScopedFile::Open(litertlm_path.string());
+  ASSERT_TRUE(model_file.ok());
+  LitertLmLoader loader(std::move(model_file.value()));
+  // The sizes of the files in the .task bundle.
+  EXPECT_EQ(loader.GetTFLiteModel(ModelType::kTfLitePrefillDecode).Size(),
+            27440104);
+  EXPECT_EQ(loader.GetSentencePieceTokenizer()->Size(), 4689072);
+  EXPECT_GT(loader.GetLlmMetadata().Size(), 0);
+  EXPECT_FALSE(loader.GetHuggingFaceTokenizer());
+  // The sections are aligned within the file.
+  EXPECT_EQ(loader.GetTFLiteModel(ModelType::kTfLitePrefillDecode).Offset() %
+                kLitertLmSectionAlignment,
+            0);
+  EXPECT_EQ(loader.GetSentencePieceTokenizer()->Offset() %
+                kLitertLmSectionAlignment,
+            0);
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,51 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Converts a .task bundle into a .litertlm file once, so that the model loads
+// through the sections mapped in place rather than through the zip archive.
+//
+// Example usage:
+//   task_to_litertlm_main --task_path=model.task \
+//     --litertlm_path=model.litertlm
+
+#include <string>
+
+#include "absl/flags/flag.h"  // from @com_google_absl
+#include "absl/flags/parse.h"  // from @com_google_absl
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "runtime/util/task_converter.h"
+
+ABSL_FLAG(std::string, task_path, "", "Path to the .task bundle to convert.");
+ABSL_FLAG(std::string, litertlm_path, "",
+          "Path to the .litertlm file to write.");
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  const std::string task_path = absl::GetFlag(FLAGS_task_path);
+  const std::string litertlm_path = absl::GetFlag(FLAGS_litertlm_path);
+  if (task_path.empty() || litertlm_path.empty()) {
+    ABSL_LOG(ERROR) << "Both --task_path and --litertlm_path are required.";
+    return 1;
+  }
+  absl::Status status =
+      litert::lm::ConvertTaskToLitertLm(task_path, litertlm_path);
+  if (!status.ok()) {
+    ABSL_LOG(ERROR) << "Failed to convert " << task_path << ": " << status;
+    return 1;
+  }
+  ABSL_LOG(INFO) << "Wrote " << litertlm_path;
+  return 0;
+}
@@ -0,0 +1,55 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/util/tensor_buffer_pool.h"
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+
+namespace litert::lm {
+
+int TensorBufferPool::GetNumIdleBuffers() const {
+  absl::MutexLock lock(&mutex_);
+  int num_idle_buffers = 0;
+  for (const auto& [key, buffers] : idle_buffers_) {
+    num_idle_buffers += buffers.size();
+  }
+  return num_idle_buffers;
+}
+
+std::optional<::litert::TensorBuffer> TensorBufferPool::TakeIdle(
+    const Lease::Key& key) {
+  absl::MutexLock lock(&mutex_);
+  auto it = idle_buffers_.find(key);
+  if (it == idle_buffers_.end() || it->second.empty()) {
+    return std::nullopt;
+  }
+  ::litert::TensorBuffer buffer = std::move(it->second.back());
+  it->second.pop_back();
+  return buffer;
+}
+
+void TensorBufferPool::Release(Lease::Key key, ::litert::TensorBuffer buffer) {
+  absl::MutexLock lock(&mutex_);
+  std::vector<::litert::TensorBuffer>& buffers = idle_buffers_[std::move(key)];
+  if (buffers.size() < kMaxIdleBuffersPerShape) {
+    buffers.push_back(std::move(buffer));
+  }
+}
+
+}  // namespace litert::lm
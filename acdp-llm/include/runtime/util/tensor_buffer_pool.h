@@ -0,0 +1,137 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_TENSOR_BUFFER_POOL_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_TENSOR_BUFFER_POOL_H_
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "litert/cc/litert_element_type.h"  // from @litert
+#include "litert/cc/litert_expected.h"  // from @litert
+#include "litert/cc/litert_layout.h"  // from @litert
+#include "litert/cc/litert_macros.h"  // from @litert
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "runtime/util/convert_tensor_buffer.h"
+
+namespace litert::lm {
+
+// A pool of host tensor buffers recycled by element type and dimensions, so
+// that the inputs built on every decode turn or step are not allocated again
+// once the decode loop reaches its steady state.
+//
+// A buffer is leased with Acquire() and goes back to the pool when its lease
+// is destroyed. The pool must outlive its leases, and duplicates of a leased
+// buffer must not outlive the lease. The pool is thread-safe.
+//
+// Example usage:
+//   TensorBufferPool pool;
+//   LITERT_ASSIGN_OR_RETURN(auto token_ids,
+//                           pool.AcquireAndCopy<int>(ids, {1, num_ids}));
+//   litert::TensorBuffer& buffer = token_ids.Get();
+class TensorBufferPool {
+ public:
+  // The maximum number of idle buffers kept for a given element type and
+  // dimensions. The buffers released beyond it are freed.
+  static constexpr int kMaxIdleBuffersPerShape = 4;
+
+  // A buffer leased from the pool, returned to it on destruction.
+  class Lease {
+   public:
+    Lease(Lease&& other)
+        : pool_(std::exchange(other.pool_, nullptr)),
+          key_(std::move(other.key_)),
+          buffer_(std::move(other.buffer_)) {}
+    Lease& operator=(Lease&& other) {
+      if (this != &other) {
+        Return();
+        pool_ = std::exchange(other.pool_, nullptr);
+        key_ = std::move(other.key_);
+        buffer_ = std::move(other.buffer_);
+      }
+      return *this;
+    }
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    ~Lease() { Return(); }
+
+    ::litert::TensorBuffer& Get() { return buffer_; }
+
+   private:
+    friend class TensorBufferPool;
+
+    using Key = std::pair<::litert::ElementType, ::litert::Dimensions>;
+
+    Lease(TensorBufferPool* pool, Key key, ::litert::TensorBuffer buffer)
+        : pool_(pool), key_(std::move(key)), buffer_(std::move(buffer)) {}
+
+    void Return() {
+      if (pool_ != nullptr) {
+        pool_->Release(std::move(key_), std::move(buffer_));
+        pool_ = nullptr;
+      }
+    }
+
+    TensorBufferPool* pool_;
+    Key key_;
+    ::litert::TensorBuffer buffer_;
+  };
+
+  TensorBufferPool() = default;
+  TensorBufferPool(const TensorBufferPool&) = delete;
+  TensorBufferPool& operator=(const TensorBufferPool&) = delete;
+
+  // Leases a host buffer of `dimensions` elements of type T, reusing an idle
+  // one if any. The content of a reused buffer is left as is.
+  template <typename T>
+  ::litert::Expected<Lease> Acquire(::litert::Dimensions dimensions) {
+    Lease::Key key(ElementTypeFor<T>::kType, dimensions);
+    if (std::optional<::litert::TensorBuffer> buffer = TakeIdle(key);
+        buffer.has_value()) {
+      return Lease(this, std::move(key), std::move(*buffer));
+    }
+    LITERT_ASSIGN_OR_RETURN(auto buffer,
+                            CreateTensorBuffer<T>(std::move(dimensions)));
+    return Lease(this, std::move(key), std::move(buffer));
+  }
+
+  // Leases a host buffer like Acquire() and copies `data` into it.
+  template <typename T>
+  ::litert::Expected<Lease> AcquireAndCopy(absl::Span<const T> data,
+                                           ::litert::Dimensions dimensions) {
+    LITERT_ASSIGN_OR_RETURN(auto lease, Acquire<T>(std::move(dimensions)));
+    LITERT_RETURN_IF_ERROR(lease.Get().Write(data));
+    return lease;
+  }
+
+  // Returns the number of idle buffers, of all element types and dimensions.
+  int GetNumIdleBuffers() const;
+
+ private:
+  std::optional<::litert::TensorBuffer> TakeIdle(const Lease::Key& key);
+  void Release(Lease::Key key, ::litert::TensorBuffer buffer);
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<Lease::Key, std::vector<::litert::TensorBuffer>>
+      idle_buffers_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_TENSOR_BUFFER_POOL_H_
@@ -0,0 +1,99 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/util/tensor_buffer_pool.h"
+
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "litert/cc/litert_tensor_buffer.h"  // from @litert
+#include "litert/test/matchers.h"  // from @litert
+#include "runtime/util/convert_tensor_buffer.h"
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(TensorBufferPoolTest, ReusesTheReleasedBuffers) {
+  TensorBufferPool pool;
+  void* address = nullptr;
+  {
+    LITERT_ASSERT_OK_AND_ASSIGN(auto lease, pool.Acquire<int>({2, 1}));
+    LITERT_ASSERT_OK_AND_ASSIGN(auto span,
+                                ReferTensorBufferAsSpan<int>(lease.Get()));
+    address = span.data();
+    EXPECT_EQ(pool.GetNumIdleBuffers(), 0);
+  }
+  EXPECT_EQ(pool.GetNumIdleBuffers(), 1);
+  LITERT_ASSERT_OK_AND_ASSIGN(auto lease, pool.Acquire<int>({2, 1}));
+  LITERT_ASSERT_OK_AND_ASSIGN(auto span,
+                              ReferTensorBufferAsSpan<int>(lease.Get()));
+  EXPECT_EQ(span.data(), address);
+  EXPECT_EQ(pool.GetNumIdleBuffers(), 0);
+}
+
+TEST(TensorBufferPoolTest, KeysTheBuffersByTypeAndDimensions) {
+  TensorBufferPool pool;
+  { LITERT_ASSERT_OK_AND_ASSIGN(auto lease, pool.Acquire<int>({2, 1})); }
+  ASSERT_EQ(pool.GetNumIdleBuffers(), 1);
+  {
+    LITERT_ASSERT_OK_AND_ASSIGN(auto other_dimensions,
+                                pool.Acquire<int>({1, 2}));
+    LITERT_ASSERT_OK_AND_ASSIGN(auto other_type, pool.Acquire<float>({2, 1}));
+    EXPECT_EQ(pool.GetNumIdleBuffers(), 1);
+  }
+  EXPECT_EQ(pool.GetNumIdleBuffers(), 3);
+}
+
+TEST(TensorBufferPoolTest, AcquiresAndCopiesTheData) {
+  TensorBufferPool pool;
+  const std::vector<int> data = {1, 2, 3};
+  LITERT_ASSERT_OK_AND_ASSIGN(
+      auto lease, pool.AcquireAndCopy<int>(data, {1, 3}));
+  LITERT_ASSERT_OK_AND_ASSIGN(auto span,
+                              ReferTensorBufferAsSpan<int>(lease.Get()));
+  EXPECT_THAT(span, ElementsAre(1, 2, 3));
+}
+
+TEST(TensorBufferPoolTest, ReturnsMovedLeasesOnce) {
+  TensorBufferPool pool;
+  {
+    LITERT_ASSERT_OK_AND_ASSIGN(auto lease, pool.Acquire<int>({1, 1}));
+    TensorBufferPool::Lease moved = std::move(lease);
+    LITERT_ASSERT_OK_AND_ASSIGN(auto other, pool.Acquire<int>({1, 1}));
+    // Returns the buffer of `moved` before taking the one of `other`.
+    moved = std::move(other);
+    EXPECT_EQ(pool.GetNumIdleBuffers(), 1);
+  }
+  EXPECT_EQ(pool.GetNumIdleBuffers(), 2);
+}
+
+TEST(TensorBufferPoolTest, BoundsTheIdleBuffers) {
+  TensorBufferPool pool;
+  {
+    std::vector<TensorBufferPool::Lease> leases;
+    for (int i = 0; i < TensorBufferPool::kMaxIdleBuffersPerShape + 2; ++i) {
+      LITERT_ASSERT_OK_AND_ASSIGN(auto lease, pool.Acquire<int>({1, 1}));
+      leases.push_back(std::move(lease));
+    }
+  }
+  EXPECT_EQ(pool.GetNumIdleBuffers(),
+            TensorBufferPool::kMaxIdleBuffersPerShape);
+}
+
+}  // namespace
+}  // namespace litert::lm
@@ -0,0 +1,239 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/util/thread_affinity.h"
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // defined(__linux__)
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_log.h"  // from @com_google_absl
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/numbers.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_split.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/strings/strip.h"  // from @com_google_absl
+#include "runtime/util/status_macros.h"  // IWYU pragma: keep
+
+namespace litert::lm {
+namespace {
+
+#if defined(__linux__)
+// The number of NUMA nodes the memory policies are saved and set for.
+constexpr int kMaxNumNumaNodes = 1024;
+constexpr int kNodeMaskSize = kMaxNumNumaNodes / (8 * sizeof(unsigned long));
+
+using NodeMask = unsigned long[kNodeMaskSize];  // NOLINT(runtime/int)
+
+// glibc wraps neither, they are in libnuma.
+long SetMemPolicy(int mode, const unsigned long* node_mask) {  // NOLINT
+  return syscall(SYS_set_mempolicy, mode, node_mask,
+                 node_mask != nullptr ? kMaxNumNumaNodes : 0);
+}
+
+long GetMemPolicy(int* mode, unsigned long* node_mask) {  // NOLINT
+  return syscall(SYS_get_mempolicy, mode, node_mask, kMaxNumNumaNodes,
+                 nullptr, 0);
+}
+
+absl::Status SetCpus(const cpu_set_t& cpu_set) {
+  if (sched_setaffinity(/*pid=*/0, sizeof(cpu_set), &cpu_set) != 0) {
+    return absl::InternalError(absl::StrCat(
+        "Failed to set the cpu affinity, error: ", strerror(errno)));
+  }
+  return absl::OkStatus();
+}
+#endif  // defined(__linux__)
+
+// The id of the binding last applied by ApplyOnce() on the thread, 0 for
+// none.
+thread_local uint64_t applied_affinity_id = 0;
+
+}  // namespace
+
+// static
+absl::StatusOr<ThreadAffinity> ThreadAffinity::Create(std::vector<int> cpus,
+                                                       int numa_node) {
+  if (cpus.empty()) {
+    if (numa_node < 0) {
+      return absl::InvalidArgumentError(
+          "Either the cpus or the NUMA node must be set.");
+    }
+    ASSIGN_OR_RETURN(cpus, GetNumaNodeCpus(numa_node));
+  }
+#if defined(__linux__)
+  if (numa_node >= kMaxNumNumaNodes) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("NUMA node out of range: ", numa_node));
+  }
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Cpu out of range: ", cpu));
+    }
+  }
+#endif  // defined(__linux__)
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  return ThreadAffinity(std::move(cpus), numa_node);
+}
+
+// static
+absl::StatusOr<std::vector<int>> ThreadAffinity::GetNumaNodeCpus(
+    int numa_node) {
+  const std::string path = absl::StrCat("/sys/devices/system/node/node",
+                                        numa_node, "/cpulist");
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return absl::NotFoundError(
+        absl::StrCat("NUMA node ", numa_node, " not found at ", path));
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return ParseCpuList(contents.str());
+}
+
+// static
+absl::StatusOr<std::vector<int>> ThreadAffinity::ParseCpuList(
+    absl::string_view cpu_list) {
+  std::vector<int> cpus;
+  for (absl::string_view range :
+       absl::StrSplit(absl::StripAsciiWhitespace(cpu_list), ',',
+                      absl::SkipEmpty())) {
+    std::vector<absl::string_view> bounds = absl::StrSplit(range, '-');
+    int first;
+    int last;
+    if (bounds.size() > 2 || !absl::SimpleAtoi(bounds.front(), &first) ||
+        !absl::SimpleAtoi(bounds.back(), &last) || first < 0 ||
+        last < first) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Invalid cpu list: ", cpu_list));
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+ThreadAffinity::ThreadAffinity(std::vector<int> cpus, int numa_node)
+    : cpus_(std::move(cpus)), numa_node_(numa_node) {
+  static std::atomic<uint64_t> next_id = 1;
+  id_ = next_id.fetch_add(1);
+}
+
+absl::Status ThreadAffinity::Apply() const {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus_) {
+    CPU_SET(cpu, &cpu_set);
+  }
+  RETURN_IF_ERROR(SetCpus(cpu_set));
+  if (numa_node_ >= 0) {
+    // Preferred rather than bound, so that the allocations fall back to the
+    // other nodes instead of failing once the node is full.
+    NodeMask node_mask = {};
+    node_mask[numa_node_ / (8 * sizeof(unsigned long))] |=  // NOLINT
+        1UL << (numa_node_ % (8 * sizeof(unsigned long)));   // NOLINT
+    if (SetMemPolicy(MPOL_PREFERRED, node_mask) != 0) {
+      return absl::InternalError(absl::StrCat(
+          "Failed to set the memory policy to NUMA node ", numa_node_,
+          ", error: ", strerror(errno)));
+    }
+  }
+  return absl::OkStatus();
+#else
+  return absl::UnimplementedError(
+      "Thread affinity is only supported on Linux.");
+#endif  // defined(__linux__)
+}
+
+absl::Status ThreadAffinity::ApplyOnce() const {
+  if (applied_affinity_id == id_) {
+    return absl::OkStatus();
+  }
+  RETURN_IF_ERROR(Apply());
+  applied_affinity_id = id_;
+  return absl::OkStatus();
+}
+
+struct ScopedThreadAffinity::SavedState {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  int mem_policy_mode;
+  NodeMask node_mask;
+#endif  // defined(__linux__)
+};
+
+// static
+absl::StatusOr<std::unique_ptr<ScopedThreadAffinity>>
+ScopedThreadAffinity::Create(const ThreadAffinity& affinity) {
+  auto saved_state = std::make_unique<SavedState>();
+#if defined(__linux__)
+  if (sched_getaffinity(/*pid=*/0, sizeof(saved_state->cpu_set),
+                        &saved_state->cpu_set) != 0) {
+    return absl::InternalError(absl::StrCat(
+        "Failed to get the cpu affinity, error: ", strerror(errno)));
+  }
+  if (GetMemPolicy(&saved_state->mem_policy_mode, saved_state->node_mask) !=
+      0) {
+    return absl::InternalError(absl::StrCat(
+        "Failed to get the memory policy, error: ", strerror(errno)));
+  }
+#endif  // defined(__linux__)
+  RETURN_IF_ERROR(affinity.Apply());
+  // ApplyOnce() must apply again after the restoration.
+  applied_affinity_id = 0;
+  return absl::WrapUnique(new ScopedThreadAffinity(std::move(saved_state)));
+}
+
+ScopedThreadAffinity::ScopedThreadAffinity(
+    std::unique_ptr<SavedState> saved_state)
+    : saved_state_(std::move(saved_state)) {}
+
+ScopedThreadAffinity::~ScopedThreadAffinity() {
+#if defined(__linux__)
+  if (auto status = SetCpus(saved_state_->cpu_set); !status.ok()) {
+    ABSL_LOG(ERROR) << "Failed to restore the cpu affinity: " << status;
+  }
+  if (SetMemPolicy(saved_state_->mem_policy_mode,
+                   saved_state_->mem_policy_mode == MPOL_DEFAULT
+                       ? nullptr
+                       : saved_state_->node_mask) != 0) {
+    ABSL_LOG(ERROR) << "Failed to restore the memory policy, error: "
+                    << strerror(errno);
+  }
+#endif  // defined(__linux__)
+}
+
+}  // namespace litert::lm
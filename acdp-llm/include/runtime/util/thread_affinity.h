@@ -0,0 +1,88 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_THREAD_AFFINITY_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_THREAD_AFFINITY_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// The cpus a thread runs on and the NUMA node its memory is allocated from,
+// e.g. to keep the inference on one socket of a multi-socket host, next to
+// the weights. The threads created by a bound thread inherit its binding.
+// Only supported on Linux.
+class ThreadAffinity {
+ public:
+  // Creates the binding to `cpus`, and to the memory of `numa_node` unless it
+  // is negative. Empty `cpus` stands for the cpus of `numa_node`.
+  static absl::StatusOr<ThreadAffinity> Create(std::vector<int> cpus,
+                                               int numa_node);
+
+  // Returns the cpus of `numa_node`, from its sysfs cpu list.
+  static absl::StatusOr<std::vector<int>> GetNumaNodeCpus(int numa_node);
+
+  // Parses a cpu list of the sysfs format, e.g. "0-3,8,10-11".
+  static absl::StatusOr<std::vector<int>> ParseCpuList(
+      absl::string_view cpu_list);
+
+  // Binds the calling thread.
+  absl::Status Apply() const;
+
+  // Binds the calling thread unless this binding is the last one it applied
+  // with ApplyOnce(), which makes it cheap to call before every task of a
+  // thread pool.
+  absl::Status ApplyOnce() const;
+
+  const std::vector<int>& cpus() const { return cpus_; }
+  int numa_node() const { return numa_node_; }
+
+ private:
+  ThreadAffinity(std::vector<int> cpus, int numa_node);
+
+  std::vector<int> cpus_;
+  int numa_node_;
+  // Identifies the binding for ApplyOnce().
+  uint64_t id_;
+};
+
+// Binds the calling thread while in scope, then restores its previous cpus
+// and memory policy.
+class ScopedThreadAffinity {
+ public:
+  static absl::StatusOr<std::unique_ptr<ScopedThreadAffinity>> Create(
+      const ThreadAffinity& affinity);
+
+  ~ScopedThreadAffinity();
+
+  ScopedThreadAffinity(const ScopedThreadAffinity&) = delete;
+  ScopedThreadAffinity& operator=(const ScopedThreadAffinity&) = delete;
+
+ private:
+  struct SavedState;
+
+  explicit ScopedThreadAffinity(std::unique_ptr<SavedState> saved_state);
+
+  std::unique_ptr<SavedState> saved_state_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_THREAD_AFFINITY_H_
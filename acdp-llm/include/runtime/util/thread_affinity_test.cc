@@ -0,0 +1,113 @@
+// Copyright 2024 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/util/thread_affinity.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif  // defined(__linux__)
+
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::status::StatusIs;
+
+TEST(ThreadAffinityTest, ParseCpuList) {
+  EXPECT_THAT(*ThreadAffinity::ParseCpuList("0-3,8,10-11\n"),
+              ElementsAre(0, 1, 2, 3, 8, 10, 11));
+  EXPECT_THAT(*ThreadAffinity::ParseCpuList(""), IsEmpty());
+  EXPECT_THAT(ThreadAffinity::ParseCpuList("3-1"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ThreadAffinity::ParseCpuList("1-2-3"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ThreadAffinity::ParseCpuList("a"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ThreadAffinityTest, CreateRequiresCpusOrNumaNode) {
+  EXPECT_THAT(ThreadAffinity::Create({}, /*numa_node=*/-1),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ThreadAffinity::Create({-1}, /*numa_node=*/-1),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  auto affinity = ThreadAffinity::Create({2, 0, 2}, /*numa_node=*/-1);
+  ASSERT_OK(affinity);
+  EXPECT_THAT(affinity->cpus(), ElementsAre(0, 2));
+  EXPECT_EQ(affinity->numa_node(), -1);
+}
+
+#if defined(__linux__)
+std::vector<int> GetCurrentThreadCpus() {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  EXPECT_EQ(sched_getaffinity(/*pid=*/0, sizeof(cpu_set), &cpu_set), 0);
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &cpu_set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+TEST(ThreadAffinityTest, ScopedAffinityIsInheritedAndRestored) {
+  const std::vector<int> initial_cpus = GetCurrentThreadCpus();
+  ASSERT_FALSE(initial_cpus.empty());
+  auto affinity =
+      ThreadAffinity::Create({initial_cpus.front()}, /*numa_node=*/-1);
+  ASSERT_OK(affinity);
+  {
+    auto scoped_affinity = ScopedThreadAffinity::Create(*affinity);
+    ASSERT_OK(scoped_affinity);
+    EXPECT_THAT(GetCurrentThreadCpus(), ElementsAre(initial_cpus.front()));
+
+    std::vector<int> child_cpus;
+    std::thread child([&]() { child_cpus = GetCurrentThreadCpus(); });
+    child.join();
+    EXPECT_THAT(child_cpus, ElementsAre(initial_cpus.front()));
+  }
+  EXPECT_EQ(GetCurrentThreadCpus(), initial_cpus);
+}
+
+TEST(ThreadAffinityTest, ApplyOnceAppliesAgainAfterAnotherAffinity) {
+  const std::vector<int> initial_cpus = GetCurrentThreadCpus();
+  auto first = ThreadAffinity::Create({initial_cpus.front()}, -1);
+  auto all = ThreadAffinity::Create(initial_cpus, -1);
+  ASSERT_OK(first);
+  ASSERT_OK(all);
+  std::thread thread([&]() {
+    EXPECT_OK(first->ApplyOnce());
+    EXPECT_THAT(GetCurrentThreadCpus(), ElementsAre(initial_cpus.front()));
+    EXPECT_OK(all->ApplyOnce());
+    EXPECT_EQ(GetCurrentThreadCpus(), initial_cpus);
+    EXPECT_OK(first->ApplyOnce());
+    EXPECT_THAT(GetCurrentThreadCpus(), ElementsAre(initial_cpus.front()));
+  });
+  thread.join();
+}
+#endif  // defined(__linux__)
+
+}  // namespace
+}  // namespace litert::lm
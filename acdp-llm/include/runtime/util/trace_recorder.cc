@@ -0,0 +1,166 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/util/trace_recorder.h"
+
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "nlohmann/json.hpp"  // from @nlohmann_json
+
+namespace litert::lm {
+namespace {
+
+// Returns the id of the track of the calling thread, small and stable for the
+// life of the thread.
+uint32_t GetThreadTrackId() {
+  static std::atomic<uint32_t> next_thread_id = 1;
+  thread_local const uint32_t thread_id = next_thread_id.fetch_add(1);
+  return thread_id;
+}
+
+// Returns `time` in the microseconds of the Chrome trace format.
+double ToTraceMicroseconds(std::chrono::nanoseconds time) {
+  return time.count() / 1000.0;
+}
+
+}  // namespace
+
+// static
+TraceRecorder& TraceRecorder::GetDefault() {
+  static TraceRecorder* const recorder = new TraceRecorder();
+  return *recorder;
+}
+
+void TraceRecorder::Start(int max_num_events) {
+  absl::MutexLock lock(&mutex_);
+  start_time_ = std::chrono::steady_clock::now();
+  max_num_events_ = max_num_events;
+  events_.clear();
+  num_dropped_events_ = 0;
+  recording_.store(true);
+}
+
+void TraceRecorder::Stop() { recording_.store(false); }
+
+void TraceRecorder::AddSlice(const char* category, const char* name,
+                             std::chrono::steady_clock::time_point start_time) {
+  const auto end_time = std::chrono::steady_clock::now();
+  AddEvent(Event{.category = category,
+                 .name = name,
+                 .phase = 'X',
+                 .thread_id = GetThreadTrackId(),
+                 .time = start_time.time_since_epoch(),
+                 .duration = end_time - start_time,
+                 .flow_id = 0});
+}
+
+void TraceRecorder::AddFlowStart(const char* category, const char* name,
+                                 uint64_t flow_id) {
+  AddEvent(Event{.category = category,
+                 .name = name,
+                 .phase = 's',
+                 .thread_id = GetThreadTrackId(),
+                 .time = std::chrono::steady_clock::now().time_since_epoch(),
+                 .duration = std::chrono::nanoseconds(0),
+                 .flow_id = flow_id});
+}
+
+void TraceRecorder::AddFlowEnd(const char* category, const char* name,
+                               uint64_t flow_id) {
+  AddEvent(Event{.category = category,
+                 .name = name,
+                 .phase = 'f',
+                 .thread_id = GetThreadTrackId(),
+                 .time = std::chrono::steady_clock::now().time_since_epoch(),
+                 .duration = std::chrono::nanoseconds(0),
+                 .flow_id = flow_id});
+}
+
+void TraceRecorder::AddEvent(const Event& event) {
+  if (!IsRecording()) {
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  if (events_.size() >= max_num_events_) {
+    ++num_dropped_events_;
+    return;
+  }
+  events_.push_back(event);
+  // The times are kept relative to the start of the recording.
+  events_.back().time -= start_time_.time_since_epoch();
+}
+
+int TraceRecorder::GetNumEvents() const {
+  absl::MutexLock lock(&mutex_);
+  return events_.size();
+}
+
+int TraceRecorder::GetNumDroppedEvents() const {
+  absl::MutexLock lock(&mutex_);
+  return num_dropped_events_;
+}
+
+std::string TraceRecorder::ToChromeJson() const {
+  nlohmann::json trace_events = nlohmann::json::array();
+  absl::MutexLock lock(&mutex_);
+  for (const Event& event : events_) {
+    nlohmann::json trace_event = {
+        {"name", event.name},
+        {"cat", event.category},
+        {"ph", std::string(1, event.phase)},
+        {"ts", ToTraceMicroseconds(event.time)},
+        {"pid", 1},
+        {"tid", event.thread_id},
+    };
+    if (event.phase == 'X') {
+      trace_event["dur"] = ToTraceMicroseconds(event.duration);
+    } else {
+      trace_event["id"] = event.flow_id;
+      if (event.phase == 'f') {
+        // Binds the end of the flow to the slice it starts.
+        trace_event["bp"] = "e";
+      }
+    }
+    trace_events.push_back(std::move(trace_event));
+  }
+  return nlohmann::json{{"traceEvents", std::move(trace_events)},
+                        {"displayTimeUnit", "ms"}}
+      .dump();
+}
+
+absl::Status TraceRecorder::WriteChromeJson(absl::string_view path) const {
+  std::ofstream file{std::string(path)};
+  if (!file.is_open()) {
+    return absl::InternalError(
+        absl::StrCat("Failed to open the trace file: ", path));
+  }
+  file << ToChromeJson();
+  file.close();
+  if (file.fail()) {
+    return absl::InternalError(
+        absl::StrCat("Failed to write the trace file: ", path));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace litert::lm
@@ -0,0 +1,146 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_TRACE_RECORDER_H_
+#define THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_TRACE_RECORDER_H_
+
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+
+namespace litert::lm {
+
+// Records the execution of the runtime as trace events, exported in the
+// Chrome JSON trace format, which chrome://tracing and the Perfetto UI open.
+// Each thread is a track, and the tasks of the sessions are linked to the
+// thread that scheduled them by flow arrows, which shows where the time goes
+// between e.g. the prefill and the decode of GenerateContentStream().
+//
+// Recording is off by default, and the trace points then cost a relaxed
+// atomic load. The event names and categories must be string literals, they
+// are not copied.
+//
+// Example usage:
+//   TraceRecorder::GetDefault().Start();
+//   ... run the engine ...
+//   TraceRecorder::GetDefault().Stop();
+//   RETURN_IF_ERROR(TraceRecorder::GetDefault().WriteChromeJson(path));
+//
+// The class is thread-safe.
+class TraceRecorder {
+ public:
+  // Returns the process-wide recorder, used by the trace points.
+  static TraceRecorder& GetDefault();
+
+  // Starts recording, dropping the events of the previous recording. The
+  // events past `max_num_events` are dropped and counted.
+  void Start(int max_num_events = kDefaultMaxNumEvents);
+
+  // Stops recording, the events are kept until the next Start().
+  void Stop();
+
+  bool IsRecording() const {
+    return recording_.load(std::memory_order_relaxed);
+  }
+
+  // Records a slice of the calling thread from `start_time` to now.
+  void AddSlice(const char* category, const char* name,
+                std::chrono::steady_clock::time_point start_time);
+
+  // Records the start, on the calling thread, and the end, on the thread
+  // running the next slice, of the flow of `flow_id`, e.g. of a task from its
+  // scheduling to its run.
+  void AddFlowStart(const char* category, const char* name, uint64_t flow_id);
+  void AddFlowEnd(const char* category, const char* name, uint64_t flow_id);
+
+  // Returns a new flow id.
+  uint64_t NewFlowId() { return next_flow_id_.fetch_add(1); }
+
+  // Returns the number of events recorded, and dropped past the maximum.
+  int GetNumEvents() const;
+  int GetNumDroppedEvents() const;
+
+  // Returns the events in the Chrome JSON trace format.
+  std::string ToChromeJson() const;
+
+  // Writes the events in the Chrome JSON trace format to `path`.
+  absl::Status WriteChromeJson(absl::string_view path) const;
+
+  static constexpr int kDefaultMaxNumEvents = 1 << 20;
+
+ private:
+  struct Event {
+    const char* category;
+    const char* name;
+    // 'X' for a slice, 's' and 'f' for the start and the end of a flow.
+    char phase;
+    uint32_t thread_id;
+    // The time since the start of the recording.
+    std::chrono::nanoseconds time;
+    std::chrono::nanoseconds duration;
+    uint64_t flow_id;
+  };
+
+  void AddEvent(const Event& event);
+
+  std::atomic<bool> recording_ = false;
+  std::atomic<uint64_t> next_flow_id_ = 1;
+  mutable absl::Mutex mutex_;
+  std::chrono::steady_clock::time_point start_time_ ABSL_GUARDED_BY(mutex_);
+  int max_num_events_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::vector<Event> events_ ABSL_GUARDED_BY(mutex_);
+  int num_dropped_events_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+// Records a slice of the calling thread over its scope, when the default
+// recorder is recording.
+//
+// Example usage:
+//   ScopedTraceSlice trace("session", "Prefill");
+class ScopedTraceSlice {
+ public:
+  ScopedTraceSlice(const char* category, const char* name)
+      : category_(category), name_(name) {
+    if (TraceRecorder::GetDefault().IsRecording()) {
+      start_time_ = std::chrono::steady_clock::now();
+      recording_ = true;
+    }
+  }
+
+  ~ScopedTraceSlice() {
+    if (recording_) {
+      TraceRecorder::GetDefault().AddSlice(category_, name_, start_time_);
+    }
+  }
+
+  ScopedTraceSlice(const ScopedTraceSlice&) = delete;
+  ScopedTraceSlice& operator=(const ScopedTraceSlice&) = delete;
+
+ private:
+  const char* category_;
+  const char* name_;
+  bool recording_ = false;
+  std::chrono::steady_clock::time_point start_time_;
+};
+
+}  // namespace litert::lm
+
+#endif  // THIRD_PARTY_ODML_LITERT_LM_RUNTIME_UTIL_TRACE_RECORDER_H_
@@ -0,0 +1,106 @@
+// Copyright 2025 The ODML Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/util/trace_recorder.h"
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "nlohmann/json.hpp"  // from @nlohmann_json
+#include "runtime/util/test_utils.h"  // NOLINT
+
+namespace litert::lm {
+namespace {
+
+using ::testing::Ne;
+using ::testing::SizeIs;
+
+TEST(TraceRecorderTest, RecordsNothingUnlessStarted) {
+  TraceRecorder recorder;
+  recorder.AddSlice("test", "slice", std::chrono::steady_clock::now());
+  EXPECT_EQ(recorder.GetNumEvents(), 0);
+}
+
+TEST(TraceRecorderTest, ExportsTheSlicesAndFlows) {
+  TraceRecorder recorder;
+  recorder.Start();
+  const uint64_t flow_id = recorder.NewFlowId();
+  recorder.AddSlice("test", "schedule", std::chrono::steady_clock::now());
+  recorder.AddFlowStart("test", "task", flow_id);
+  std::thread([&recorder, flow_id]() {
+    recorder.AddFlowEnd("test", "task", flow_id);
+    recorder.AddSlice("test", "run", std::chrono::steady_clock::now());
+  }).join();
+  recorder.Stop();
+  recorder.AddSlice("test", "ignored", std::chrono::steady_clock::now());
+
+  const nlohmann::json trace = nlohmann::json::parse(recorder.ToChromeJson());
+  const nlohmann::json& events = trace["traceEvents"];
+  ASSERT_THAT(events, SizeIs(4));
+  EXPECT_EQ(events[0]["name"], "schedule");
+  EXPECT_EQ(events[0]["ph"], "X");
+  EXPECT_TRUE(events[0].contains("dur"));
+  EXPECT_EQ(events[1]["ph"], "s");
+  EXPECT_EQ(events[1]["id"], flow_id);
+  EXPECT_EQ(events[2]["ph"], "f");
+  EXPECT_EQ(events[2]["bp"], "e");
+  EXPECT_EQ(events[2]["id"], flow_id);
+  // The scheduling and the run are on different thread tracks.
+  EXPECT_EQ(events[1]["tid"], events[0]["tid"]);
+  EXPECT_THAT(events[2]["tid"], Ne(events[1]["tid"]));
+  EXPECT_EQ(events[3]["tid"], events[2]["tid"]);
+}
+
+TEST(TraceRecorderTest, DropsTheEventsPastTheMaximum) {
+  TraceRecorder recorder;
+  recorder.Start(/*max_num_events=*/2);
+  for (int i = 0; i < 5; ++i) {
+    recorder.AddSlice("test", "slice", std::chrono::steady_clock::now());
+  }
+  EXPECT_EQ(recorder.GetNumEvents(), 2);
+  EXPECT_EQ(recorder.GetNumDroppedEvents(), 3);
+  // Starting again drops the previous recording.
+  recorder.Start();
+  EXPECT_EQ(recorder.GetNumEvents(), 0);
+}
+
+TEST(TraceRecorderTest, ScopedTraceSliceRecordsInTheDefaultRecorder) {
+  TraceRecorder& recorder = TraceRecorder::GetDefault();
+  { ScopedTraceSlice trace("test", "not recorded"); }
+  recorder.Start();
+  { ScopedTraceSlice trace("test", "recorded"); }
+  recorder.Stop();
+  EXPECT_EQ(recorder.GetNumEvents(), 1);
+}
+
+TEST(TraceRecorderTest, WriteChromeJson) {
+  TraceRecorder recorder;
+  recorder.Start();
+  recorder.AddSlice("test", "slice", std::chrono::steady_clock::now());
+  const std::string path =
+      std::string(::testing::TempDir()) + "/trace.json";
+  EXPECT_OK(recorder.WriteChromeJson(path));
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  EXPECT_EQ(contents.str(), recorder.ToChromeJson());
+}
+
+}  // namespace
+}  // namespace litert::lm
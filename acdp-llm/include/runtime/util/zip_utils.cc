@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "runtime/util/zip_utils.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <string>
@@ -22,9 +24,11 @@ limitations under the License.
 
 #include "absl/cleanup/cleanup.h"  // from @com_google_absl
 #include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/functional/function_ref.h"  // from @com_google_absl
 #include "absl/log/absl_log.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
 #include "minizip/ioapi.h"  // from @minizip
 #include "minizip/unzip.h"  // from @minizip
@@ -103,10 +107,207 @@ absl::StatusOr<ZipFileInfo> GetCurrentZipFileInfo(const unzFile& zf) {
       .size = file_info.uncompressed_size};
 }
 
+// The signatures and the sizes of the ZIP records, from the APPNOTE.
+constexpr uint32_t kLocalFileHeaderSignature = 0x04034b50;
+constexpr size_t kLocalFileHeaderSize = 30;
+constexpr uint32_t kCentralDirectoryHeaderSignature = 0x02014b50;
+constexpr size_t kCentralDirectoryHeaderSize = 46;
+constexpr uint32_t kEndOfCentralDirectorySignature = 0x06054b50;
+constexpr size_t kEndOfCentralDirectorySize = 22;
+constexpr uint32_t kZip64EndOfCentralDirectoryLocatorSignature = 0x07064b50;
+constexpr size_t kZip64EndOfCentralDirectoryLocatorSize = 20;
+constexpr uint32_t kZip64EndOfCentralDirectorySignature = 0x06064b50;
+constexpr size_t kZip64EndOfCentralDirectorySize = 56;
+constexpr uint16_t kZip64ExtraFieldId = 0x0001;
+constexpr size_t kMaxCommentSize = 0xffff;
+
+// Reads the little-endian integers of the records, after the callers checked
+// the bounds.
+uint16_t ReadUint16(absl::string_view data, size_t offset) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(data.data() + offset);
+  return static_cast<uint16_t>(bytes[0] | bytes[1] << 8);
+}
+
+uint32_t ReadUint32(absl::string_view data, size_t offset) {
+  return ReadUint16(data, offset) |
+         static_cast<uint32_t>(ReadUint16(data, offset + 2)) << 16;
+}
+
+uint64_t ReadUint64(absl::string_view data, size_t offset) {
+  return ReadUint32(data, offset) |
+         static_cast<uint64_t>(ReadUint32(data, offset + 4)) << 32;
+}
+
+absl::Status MalformedZipError(absl::string_view what) {
+  return absl::InvalidArgumentError(
+      absl::StrCat("Malformed zip archive: ", what));
+}
+
+// The location of the central directory.
+struct CentralDirectory {
+  uint64_t num_entries;
+  uint64_t offset;
+};
+
+// Finds the central directory from the end of central directory record, the
+// last one in the archive before its comment, and its ZIP64 counterpart.
+absl::StatusOr<CentralDirectory> FindCentralDirectory(absl::string_view data) {
+  if (data.size() < kEndOfCentralDirectorySize) {
+    return MalformedZipError("too small");
+  }
+  const size_t min_offset =
+      data.size() - kEndOfCentralDirectorySize -
+      std::min(kMaxCommentSize, data.size() - kEndOfCentralDirectorySize);
+  size_t offset = data.size() - kEndOfCentralDirectorySize;
+  while (ReadUint32(data, offset) != kEndOfCentralDirectorySignature) {
+    if (offset == min_offset) {
+      return MalformedZipError("no end of central directory");
+    }
+    --offset;
+  }
+  CentralDirectory central_directory{
+      .num_entries = ReadUint16(data, offset + 10),
+      .offset = ReadUint32(data, offset + 16),
+  };
+  if (central_directory.num_entries != 0xffff &&
+      central_directory.offset != 0xffffffff) {
+    return central_directory;
+  }
+  // The counts and the offsets of the ZIP64 archives are in the ZIP64 end of
+  // central directory record.
+  if (offset < kZip64EndOfCentralDirectoryLocatorSize ||
+      ReadUint32(data, offset - kZip64EndOfCentralDirectoryLocatorSize) !=
+          kZip64EndOfCentralDirectoryLocatorSignature) {
+    return MalformedZipError("no ZIP64 end of central directory locator");
+  }
+  const uint64_t zip64_offset =
+      ReadUint64(data, offset - kZip64EndOfCentralDirectoryLocatorSize + 8);
+  if (data.size() < kZip64EndOfCentralDirectorySize ||
+      zip64_offset > data.size() - kZip64EndOfCentralDirectorySize ||
+      ReadUint32(data, zip64_offset) != kZip64EndOfCentralDirectorySignature) {
+    return MalformedZipError("no ZIP64 end of central directory");
+  }
+  central_directory.num_entries = ReadUint64(data, zip64_offset + 32);
+  central_directory.offset = ReadUint64(data, zip64_offset + 48);
+  return central_directory;
+}
+
+// Replaces the sizes and the offset saturated in a central directory header
+// with their values in its ZIP64 extra field.
+absl::Status ReadZip64ExtraField(absl::string_view extra_field,
+                                 uint64_t& uncompressed_size,
+                                 uint64_t& compressed_size,
+                                 uint64_t& local_header_offset) {
+  size_t offset = 0;
+  while (offset + 4 <= extra_field.size()) {
+    const uint16_t id = ReadUint16(extra_field, offset);
+    const uint16_t size = ReadUint16(extra_field, offset + 2);
+    offset += 4;
+    if (offset + size > extra_field.size()) {
+      break;
+    }
+    if (id == kZip64ExtraFieldId) {
+      // Only the saturated fields are present, in this order.
+      size_t field_offset = offset;
+      for (uint64_t* field :
+           {&uncompressed_size, &compressed_size, &local_header_offset}) {
+        if (*field != 0xffffffff) {
+          continue;
+        }
+        if (field_offset + 8 > offset + size) {
+          return MalformedZipError("truncated ZIP64 extra field");
+        }
+        *field = ReadUint64(extra_field, field_offset);
+        field_offset += 8;
+      }
+      return absl::OkStatus();
+    }
+    offset += size;
+  }
+  if (uncompressed_size == 0xffffffff || compressed_size == 0xffffffff ||
+      local_header_offset == 0xffffffff) {
+    return MalformedZipError("no ZIP64 extra field");
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
+absl::Status ForEachFileInZipFile(
+    absl::string_view data,
+    absl::FunctionRef<void(absl::string_view name, OffsetAndSize location)>
+        callback) {
+  ASSIGN_OR_RETURN(CentralDirectory central_directory,
+                   FindCentralDirectory(data));
+  uint64_t offset = central_directory.offset;
+  for (uint64_t i = 0; i < central_directory.num_entries; ++i) {
+    if (offset > data.size() ||
+        data.size() - offset < kCentralDirectoryHeaderSize ||
+        ReadUint32(data, offset) != kCentralDirectoryHeaderSignature) {
+      return MalformedZipError("bad central directory header");
+    }
+    const uint16_t method = ReadUint16(data, offset + 10);
+    uint64_t compressed_size = ReadUint32(data, offset + 20);
+    uint64_t uncompressed_size = ReadUint32(data, offset + 24);
+    const uint16_t name_size = ReadUint16(data, offset + 28);
+    const uint16_t extra_field_size = ReadUint16(data, offset + 30);
+    const uint16_t comment_size = ReadUint16(data, offset + 32);
+    uint64_t local_header_offset = ReadUint32(data, offset + 42);
+    const uint64_t header_size = kCentralDirectoryHeaderSize + name_size +
+                                 extra_field_size + comment_size;
+    if (data.size() - offset < header_size) {
+      return MalformedZipError("truncated central directory header");
+    }
+    const absl::string_view name =
+        data.substr(offset + kCentralDirectoryHeaderSize, name_size);
+    RETURN_IF_ERROR(ReadZip64ExtraField(
+        data.substr(offset + kCentralDirectoryHeaderSize + name_size,
+                    extra_field_size),
+        uncompressed_size, compressed_size, local_header_offset));
+    if (method != Z_NO_COMPRESSION) {
+      return absl::UnknownError("Expected uncompressed zip archive.");
+    }
+
+    // The contents follow the local header, whose variable fields may differ
+    // from the ones of the central directory.
+    if (local_header_offset > data.size() ||
+        data.size() - local_header_offset < kLocalFileHeaderSize ||
+        ReadUint32(data, local_header_offset) != kLocalFileHeaderSignature) {
+      return MalformedZipError("bad local file header");
+    }
+    const uint64_t contents_offset =
+        local_header_offset + kLocalFileHeaderSize +
+        ReadUint16(data, local_header_offset + 26) +
+        ReadUint16(data, local_header_offset + 28);
+    if (contents_offset > data.size() ||
+        data.size() - contents_offset < uncompressed_size) {
+      return MalformedZipError("truncated file contents");
+    }
+    callback(name, OffsetAndSize{
+                       .offset = static_cast<size_t>(contents_offset),
+                       .size = static_cast<size_t>(uncompressed_size),
+                   });
+    offset += header_size;
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<absl::flat_hash_map<std::string, OffsetAndSize>>
 ExtractFilesfromZipFile(absl::string_view data) {
+  {
+    absl::flat_hash_map<std::string, OffsetAndSize> files;
+    absl::Status status =
+        ForEachFileInZipFile(data, [&](absl::string_view name,
+                                       OffsetAndSize location) {
+          files.insert_or_assign(name, location);
+        });
+    if (status.ok()) {
+      return files;
+    }
+    // Minizip reads a few more archives, or reports their errors.
+    ABSL_LOG(WARNING) << "Falling back to minizip: " << status;
+  }
+
   // Create in-memory read-only zip file.
   ZipReadOnlyMemFile mem_file = ZipReadOnlyMemFile(data);
   // Open zip.
@@ -20,6 +20,8 @@ limitations under the License.
 #include <string>
 
 #include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/functional/function_ref.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
 #include "absl/status/statusor.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
 #include "runtime/util/external_file.pb.h"
@@ -33,6 +35,16 @@ struct OffsetAndSize {
   size_t size;
 };
 
+// Calls `callback` with the name and the location of each file of the zip
+// file `data`, in the order of its central directory, which is parsed in a
+// single pass without copying the names. The names are only valid while `data`
+// is alive. Returns an error for ZIP archives it can't read, and for entries
+// that are compressed, because the contents must be usable in place.
+absl::Status ForEachFileInZipFile(
+    absl::string_view data,
+    absl::FunctionRef<void(absl::string_view name, OffsetAndSize location)>
+        callback);
+
 // Extract files from the zip file `data`.
 // Return a map with the filename as key and pointers to the file contents
 // as value. The map does not own the file contents, and the pointers returned
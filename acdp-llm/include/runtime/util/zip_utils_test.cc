@@ -14,10 +14,15 @@
 
 #include "runtime/util/zip_utils.h"
 
+#include <cstdint>
 #include <filesystem>  // NOLINT: Required for path manipulation.
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/status/status.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
 #include "runtime/util/memory_mapped_file.h"
 #include "runtime/util/test_utils.h"  // NOLINT
@@ -26,8 +31,109 @@ namespace litert::lm {
 
 namespace {
 
+using ::testing::ElementsAre;
 using ::testing::Pair;
 using ::testing::UnorderedElementsAre;
+using ::testing::status::StatusIs;
+
+void AppendUint16(std::string& data, uint16_t value) {
+  data.push_back(static_cast<char>(value & 0xff));
+  data.push_back(static_cast<char>(value >> 8));
+}
+
+void AppendUint32(std::string& data, uint32_t value) {
+  AppendUint16(data, value & 0xffff);
+  AppendUint16(data, value >> 16);
+}
+
+// Writes a zip archive of the `files`, which are stored with the compression
+// `method` as is. The local headers get an extra field that the central
+// directory doesn't have, like the ones of the aligned archives.
+std::string CreateZipFile(
+    const std::vector<std::pair<std::string, std::string>>& files,
+    uint16_t method = 0) {
+  std::string data;
+  std::string central_directory;
+  for (const auto& [name, contents] : files) {
+    const uint32_t local_header_offset = data.size();
+    const std::string extra_field(3, '\0');
+    AppendUint32(data, 0x04034b50);
+    AppendUint16(data, 10);  // Version needed to extract.
+    AppendUint16(data, 0);   // Flags.
+    AppendUint16(data, method);
+    AppendUint32(data, 0);   // Modification time and date.
+    AppendUint32(data, 0);   // CRC-32, unchecked.
+    AppendUint32(data, contents.size());
+    AppendUint32(data, contents.size());
+    AppendUint16(data, name.size());
+    AppendUint16(data, extra_field.size());
+    data += name;
+    data += extra_field;
+    data += contents;
+
+    AppendUint32(central_directory, 0x02014b50);
+    AppendUint16(central_directory, 10);  // Version made by.
+    AppendUint16(central_directory, 10);  // Version needed to extract.
+    AppendUint16(central_directory, 0);   // Flags.
+    AppendUint16(central_directory, method);
+    AppendUint32(central_directory, 0);   // Modification time and date.
+    AppendUint32(central_directory, 0);   // CRC-32, unchecked.
+    AppendUint32(central_directory, contents.size());
+    AppendUint32(central_directory, contents.size());
+    AppendUint16(central_directory, name.size());
+    AppendUint16(central_directory, 0);   // Extra field length.
+    AppendUint16(central_directory, 0);   // Comment length.
+    AppendUint16(central_directory, 0);   // Disk number.
+    AppendUint16(central_directory, 0);   // Internal attributes.
+    AppendUint32(central_directory, 0);   // External attributes.
+    AppendUint32(central_directory, local_header_offset);
+    central_directory += name;
+  }
+  const uint32_t central_directory_offset = data.size();
+  data += central_directory;
+  AppendUint32(data, 0x06054b50);
+  AppendUint16(data, 0);  // Disk number.
+  AppendUint16(data, 0);  // Disk of the central directory.
+  AppendUint16(data, files.size());
+  AppendUint16(data, files.size());
+  AppendUint32(data, central_directory.size());
+  AppendUint32(data, central_directory_offset);
+  const std::string comment = "comment";
+  AppendUint16(data, comment.size());
+  data += comment;
+  return data;
+}
+
+TEST(ZipUtilsTest, ForEachFileInZipFile) {
+  const std::string data =
+      CreateZipFile({{"METADATA", "metadata"}, {"TOKENIZER_MODEL", "model"}});
+
+  std::vector<std::pair<std::string, std::string>> files;
+  ASSERT_OK(ForEachFileInZipFile(
+      data, [&](absl::string_view name, OffsetAndSize location) {
+        files.emplace_back(name, data.substr(location.offset, location.size));
+      }));
+
+  EXPECT_THAT(files, ElementsAre(Pair("METADATA", "metadata"),
+                                 Pair("TOKENIZER_MODEL", "model")));
+}
+
+TEST(ZipUtilsTest, ForEachFileInZipFileFailsOnCompressedFiles) {
+  const std::string data =
+      CreateZipFile({{"METADATA", "metadata"}}, /*method=*/8);
+
+  EXPECT_THAT(
+      ForEachFileInZipFile(data, [](absl::string_view, OffsetAndSize) {}),
+      StatusIs(absl::StatusCode::kUnknown));
+}
+
+TEST(ZipUtilsTest, ForEachFileInZipFileFailsOnTruncatedFiles) {
+  const std::string data = CreateZipFile({{"METADATA", "metadata"}});
+
+  EXPECT_THAT(ForEachFileInZipFile(absl::string_view(data).substr(10),
+                                   [](absl::string_view, OffsetAndSize) {}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
 
 TEST(ZipUtilsTest, ExtractFilesFromZipFile) {
   const auto model_path =
@@ -34,7 +34,12 @@ pub use database::{
 pub use dspy_predictor::DSpyToolPredictor;
 pub use dspy_signatures::{OptimizedPrompt, RoutingDecision, ToolPrediction};
 pub use error::{LlmError, LlmResult};
-pub use litert_wrapper::{LiteRTBackend, LiteRTEngine, LiteRTSession, ResponseFormat};
+pub use litert_wrapper::{
+    CacheStats, Completion, CreationPhase, EngineMetrics, LiteRTBackend, LiteRTBatchTokenizer,
+    LiteRTCompletionQueue, LiteRTEngine, LiteRTEngineCreation, LiteRTEngineSettings, LiteRTSession,
+    LiteRTSessionConfig, ResponseBuffer, ResponseFormat, StreamBackpressure, StreamEvent,
+    Submission,
+};
 pub use lm_provider::{LiteRTConfig, LiteRTLM};
 pub use session_management::{SessionManager, SessionPrediction, SessionPredictionContext};
 // Note: Signature types are private due to #[Signature] macro from dspy-rs
@@ -25,6 +25,14 @@ enum LiteRtLmBackendFFI {
     Gpu = 1,
 }
 
+#[repr(C)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq)]
+enum LiteRtLmStreamBackpressureFFI {
+    Block = 0,
+    Coalesce = 1,
+    Cancel = 2,
+}
+
 #[repr(C)]
 #[derive(Debug, Copy, Clone, PartialEq, Eq)]
 #[allow(dead_code)]
@@ -35,10 +43,34 @@ enum LiteRtLmStatusFFI {
     ErrorNotInitialized = -3,
     ErrorModelLoadFailed = -4,
     ErrorGenerationFailed = -5,
+    ErrorCancelled = -6,
 }
 
 type LiteRtLmEnginePtr = *mut std::ffi::c_void;
 type LiteRtLmConversationPtr = *mut std::ffi::c_void;
+type LiteRtLmEngineCreationPtr = *mut std::ffi::c_void;
+type LiteRtLmCompletionQueuePtr = *mut std::ffi::c_void;
+type LiteRtLmEngineSettingsPtr = *mut std::ffi::c_void;
+type LiteRtLmSessionConfigPtr = *mut std::ffi::c_void;
+type LiteRtLmTokenizerPtr = *mut std::ffi::c_void;
+
+/// Progress callback of an asynchronous engine creation: user data, phase
+/// (LiteRtLmCreationPhase) and status.
+#[cfg(litert_dynamic)]
+type LiteRtLmCreationCallback =
+    Option<unsafe extern "C" fn(user_data: *mut std::ffi::c_void, phase: c_int, status: c_int)>;
+
+/// Callback of a streamed response: user data, chunk, is_final and error
+/// message.
+#[cfg(litert_dynamic)]
+type LiteRtLmMessageStreamCallback = Option<
+    unsafe extern "C" fn(
+        user_data: *mut std::ffi::c_void,
+        chunk: *const c_char,
+        is_final: c_int,
+        error_message: *const c_char,
+    ),
+>;
 
 // Benchmark FFI types
 #[repr(C)]
@@ -60,17 +92,173 @@ struct LiteRtLmBenchmarkInfoFFI {
     last_decode_token_count: u64,
 }
 
+// Shared buffer FFI type
+#[cfg(litert_dynamic)]
+#[repr(C)]
+struct LiteRtLmBufferFFI {
+    data: *const c_char,
+    size: usize,
+    owner: *mut std::ffi::c_void,
+    retain: Option<unsafe extern "C" fn(owner: *mut std::ffi::c_void)>,
+    release: Option<unsafe extern "C" fn(owner: *mut std::ffi::c_void)>,
+}
+
+// Completion queue FFI type
+#[cfg(litert_dynamic)]
+#[repr(C)]
+struct LiteRtLmCompletionFFI {
+    tag: u64,
+    chunk: LiteRtLmBufferFFI,
+    is_final: i32,
+    status: i32,
+    error_message: *mut c_char,
+}
+
+// Batch submission FFI type
+#[cfg(litert_dynamic)]
+#[repr(C)]
+struct LiteRtLmSubmissionFFI {
+    conversation: LiteRtLmConversationPtr,
+    role: *const c_char,
+    content: *const c_char,
+    tag: u64,
+}
+
+// Engine metrics FFI type
+#[repr(C)]
+#[derive(Debug, Copy, Clone, Default)]
+struct LiteRtLmMetricsFFI {
+    num_sessions: i32,
+    num_queued_tasks: i32,
+    num_prefilled_tokens: i64,
+    num_decode_steps: i64,
+    num_cancellations: i64,
+    kv_cache_utilization: f64,
+    prefix_cache_hits: i64,
+    prefix_cache_misses: i64,
+    embedding_cache_hits: i64,
+    embedding_cache_misses: i64,
+    token_id_cache_hits: i64,
+    token_id_cache_misses: i64,
+}
+
 #[cfg(litert_dynamic)]
 #[link(name = "litert_lm_rust_api")]
 extern "C" {
+    fn LiteRtLmEngineSettings_Create(
+        model_path: *const c_char,
+        backend: LiteRtLmBackendFFI,
+        out_settings: *mut LiteRtLmEngineSettingsPtr,
+    ) -> c_int;
+
+    fn LiteRtLmEngineSettings_Destroy(settings: LiteRtLmEngineSettingsPtr);
+
+    fn LiteRtLmEngineSettings_SetMaxNumTokens(
+        settings: LiteRtLmEngineSettingsPtr,
+        max_num_tokens: c_int,
+    );
+
+    fn LiteRtLmEngineSettings_SetPrefillBatchSizes(
+        settings: LiteRtLmEngineSettingsPtr,
+        prefill_batch_sizes: *const i32,
+        num_prefill_batch_sizes: c_int,
+    ) -> c_int;
+
+    fn LiteRtLmEngineSettings_SetNumCpuThreads(
+        settings: LiteRtLmEngineSettingsPtr,
+        num_cpu_threads: c_int,
+    ) -> c_int;
+
+    fn LiteRtLmEngineSettings_SetGpuExternalTensorMode(
+        settings: LiteRtLmEngineSettingsPtr,
+        external_tensor_mode: c_int,
+    ) -> c_int;
+
+    fn LiteRtLmEngineSettings_SetCacheDir(
+        settings: LiteRtLmEngineSettingsPtr,
+        cache_dir: *const c_char,
+    );
+
+    fn LiteRtLmEngineSettings_SetSamplerBackend(
+        settings: LiteRtLmEngineSettingsPtr,
+        sampler_backend: LiteRtLmBackendFFI,
+    );
+
+    fn LiteRtLmEngineSettings_SetNumOutputCandidates(
+        settings: LiteRtLmEngineSettingsPtr,
+        num_output_candidates: c_int,
+    );
+
+    fn LiteRtLmEngineSettings_EnableBenchmark(
+        settings: LiteRtLmEngineSettingsPtr,
+        num_prefill_tokens: c_int,
+        num_decode_tokens: c_int,
+    );
+
+    fn LiteRtLmSessionConfig_Create(out_config: *mut LiteRtLmSessionConfigPtr) -> c_int;
+
+    fn LiteRtLmSessionConfig_Destroy(config: LiteRtLmSessionConfigPtr);
+
+    fn LiteRtLmSessionConfig_SetNumOutputCandidates(
+        config: LiteRtLmSessionConfigPtr,
+        num_output_candidates: c_int,
+    );
+
+    fn LiteRtLmSessionConfig_SetSamplerBackend(
+        config: LiteRtLmSessionConfigPtr,
+        sampler_backend: LiteRtLmBackendFFI,
+    );
+
+    fn LiteRtLmSessionConfig_SetPriority(config: LiteRtLmSessionConfigPtr, priority: c_int);
+
+    fn LiteRtLmSessionConfig_SetStreamBackpressure(
+        config: LiteRtLmSessionConfigPtr,
+        max_pending_chunks: c_int,
+        backpressure: LiteRtLmStreamBackpressureFFI,
+    );
+
     fn LiteRtLmEngine_Create(
         model_path: *const c_char,
         backend: LiteRtLmBackendFFI,
         out_engine: *mut LiteRtLmEnginePtr,
     ) -> c_int;
 
+    fn LiteRtLmEngine_CreateWithSettings(
+        settings: LiteRtLmEngineSettingsPtr,
+        out_engine: *mut LiteRtLmEnginePtr,
+    ) -> c_int;
+
     fn LiteRtLmEngine_Destroy(engine: LiteRtLmEnginePtr);
 
+    fn LiteRtLmEngine_GetMetrics(
+        engine: LiteRtLmEnginePtr,
+        out_metrics: *mut LiteRtLmMetricsFFI,
+    ) -> c_int;
+
+    fn LiteRtLmEngine_CreateAsync(
+        model_path: *const c_char,
+        backend: LiteRtLmBackendFFI,
+        callback: LiteRtLmCreationCallback,
+        user_data: *mut std::ffi::c_void,
+        out_creation: *mut LiteRtLmEngineCreationPtr,
+    ) -> c_int;
+
+    fn LiteRtLmEngine_CreateAsyncWithSettings(
+        settings: LiteRtLmEngineSettingsPtr,
+        callback: LiteRtLmCreationCallback,
+        user_data: *mut std::ffi::c_void,
+        out_creation: *mut LiteRtLmEngineCreationPtr,
+    ) -> c_int;
+
+    fn LiteRtLmEngineCreation_Cancel(creation: LiteRtLmEngineCreationPtr);
+
+    fn LiteRtLmEngineCreation_Wait(
+        creation: LiteRtLmEngineCreationPtr,
+        out_engine: *mut LiteRtLmEnginePtr,
+    ) -> c_int;
+
+    fn LiteRtLmEngineCreation_Destroy(creation: LiteRtLmEngineCreationPtr);
+
     fn LiteRtLmConversation_Create(
         engine: LiteRtLmEnginePtr,
         out_conversation: *mut LiteRtLmConversationPtr,
@@ -82,6 +270,13 @@ extern "C" {
         out_conversation: *mut LiteRtLmConversationPtr,
     ) -> c_int;
 
+    fn LiteRtLmConversation_CreateWithConfig(
+        engine: LiteRtLmEnginePtr,
+        session_config: LiteRtLmSessionConfigPtr,
+        system_instruction: *const c_char,
+        out_conversation: *mut LiteRtLmConversationPtr,
+    ) -> c_int;
+
     fn LiteRtLmConversation_SendMessage(
         conversation: LiteRtLmConversationPtr,
         role: *const c_char,
@@ -89,10 +284,119 @@ extern "C" {
         out_response: *mut *mut c_char,
     ) -> c_int;
 
+    fn LiteRtLmConversation_SendMessageBuffer(
+        conversation: LiteRtLmConversationPtr,
+        role: *const c_char,
+        content: *const c_char,
+        out_response: *mut LiteRtLmBufferFFI,
+    ) -> c_int;
+
+    fn LiteRtLmConversation_SendMessageStream(
+        conversation: LiteRtLmConversationPtr,
+        role: *const c_char,
+        content: *const c_char,
+        callback: LiteRtLmMessageStreamCallback,
+        user_data: *mut std::ffi::c_void,
+    ) -> c_int;
+
+    fn LiteRtLmConversation_SubmitMessage(
+        conversation: LiteRtLmConversationPtr,
+        role: *const c_char,
+        content: *const c_char,
+        queue: LiteRtLmCompletionQueuePtr,
+        tag: u64,
+    ) -> c_int;
+
+    fn LiteRtLmConversation_TokenizeMessage(
+        conversation: LiteRtLmConversationPtr,
+        role: *const c_char,
+        content: *const c_char,
+        out_token_ids: *mut *mut i32,
+        out_num_tokens: *mut c_int,
+    ) -> c_int;
+
+    fn LiteRtLmConversation_SendTokenizedMessage(
+        conversation: LiteRtLmConversationPtr,
+        role: *const c_char,
+        content: *const c_char,
+        token_ids: *const i32,
+        num_tokens: c_int,
+        out_response: *mut *mut c_char,
+    ) -> c_int;
+
+    fn LiteRtLmConversation_SubmitTokenizedMessage(
+        conversation: LiteRtLmConversationPtr,
+        role: *const c_char,
+        content: *const c_char,
+        token_ids: *const i32,
+        num_tokens: c_int,
+        queue: LiteRtLmCompletionQueuePtr,
+        tag: u64,
+    ) -> c_int;
+
+    fn LiteRtLmConversation_SubmitMessages(
+        submissions: *const LiteRtLmSubmissionFFI,
+        num_submissions: c_int,
+        queue: LiteRtLmCompletionQueuePtr,
+        out_statuses: *mut c_int,
+    ) -> c_int;
+
+    fn LiteRtLmConversation_Cancel(conversation: LiteRtLmConversationPtr);
+
     fn LiteRtLmConversation_Destroy(conversation: LiteRtLmConversationPtr);
 
+    fn LiteRtLmCompletionQueue_Create(out_queue: *mut LiteRtLmCompletionQueuePtr) -> c_int;
+
+    fn LiteRtLmCompletionQueue_GetFd(queue: LiteRtLmCompletionQueuePtr) -> c_int;
+
+    fn LiteRtLmCompletionQueue_Poll(
+        queue: LiteRtLmCompletionQueuePtr,
+        out_completions: *mut LiteRtLmCompletionFFI,
+        max_completions: c_int,
+    ) -> c_int;
+
+    fn LiteRtLmCompletionQueue_Destroy(queue: LiteRtLmCompletionQueuePtr);
+
+    fn LiteRtLmEngine_TextToTokenIds(
+        engine: LiteRtLmEnginePtr,
+        text: *const c_char,
+        out_token_ids: *mut *mut i32,
+        out_num_tokens: *mut c_int,
+    ) -> c_int;
+
+    fn LiteRtLmEngine_CountTokens(
+        engine: LiteRtLmEnginePtr,
+        text: *const c_char,
+        out_num_tokens: *mut c_int,
+    ) -> c_int;
+
+    fn LiteRtLmTokenizer_Create(
+        engine: LiteRtLmEnginePtr,
+        num_threads: c_int,
+        out_tokenizer: *mut LiteRtLmTokenizerPtr,
+    ) -> c_int;
+
+    fn LiteRtLmTokenizer_TextToTokenIds(
+        tokenizer: LiteRtLmTokenizerPtr,
+        texts: *const *const c_char,
+        num_texts: c_int,
+        out_token_ids: *mut *mut i32,
+        out_offsets: *mut i64,
+    ) -> c_int;
+
+    fn LiteRtLmTokenizer_CountTokens(
+        tokenizer: LiteRtLmTokenizerPtr,
+        texts: *const *const c_char,
+        num_texts: c_int,
+        out_num_tokens: *mut i32,
+    ) -> c_int;
+
+    fn LiteRtLmTokenizer_Destroy(tokenizer: LiteRtLmTokenizerPtr);
+
     fn LiteRtLm_FreeString(s: *mut c_char);
 
+    fn LiteRtLm_FreeTokenIds(token_ids: *mut i32);
+
     fn LiteRtLm_GetLastError() -> *const c_char;
 
     fn LiteRtLmConversation_GetBenchmarkInfo(
@@ -125,6 +429,27 @@ impl LiteRTBackend {
     }
 }
 
+/// What a streamed response does when its consumer falls behind
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum StreamBackpressure {
+    /// Pause the decoding until the consumer catches up
+    Block,
+    /// Keep decoding and merge the chunks until the consumer catches up
+    Coalesce,
+    /// Cancel the response, which ends with an error
+    Cancel,
+}
+
+impl StreamBackpressure {
+    fn to_ffi(self) -> LiteRtLmStreamBackpressureFFI {
+        match self {
+            StreamBackpressure::Block => LiteRtLmStreamBackpressureFFI::Block,
+            StreamBackpressure::Coalesce => LiteRtLmStreamBackpressureFFI::Coalesce,
+            StreamBackpressure::Cancel => LiteRtLmStreamBackpressureFFI::Cancel,
+        }
+    }
+}
+
 /// Benchmark data for a single turn (prefill or decode)
 #[derive(Debug, Clone, Serialize, Deserialize)]
 pub struct TurnBenchmark {
@@ -251,21 +576,110 @@ impl BenchmarkInfo {
     }
 }
 
-/// LiteRT-LM Engine
+/// Lookups of a cache shared by the sessions of an engine
+#[derive(Debug, Clone, Copy, Default, Serialize, Deserialize)]
+pub struct CacheStats {
+    pub hits: u64,
+    pub misses: u64,
+}
+
+impl CacheStats {
+    /// Get the fraction of the lookups which hit, 0 without lookups
+    pub fn hit_rate(&self) -> f64 {
+        let lookups = self.hits + self.misses;
+        if lookups == 0 {
+            return 0.0;
+        }
+        self.hits as f64 / lookups as f64
+    }
+}
+
+/// Counters and gauges of an engine since it was created
 ///
-/// The Engine loads a model and manages its lifecycle.
-/// Create sessions (conversations) from the engine.
-pub struct LiteRTEngine {
+/// Unlike [`BenchmarkInfo`], they are always maintained, and cheap enough to
+/// be scraped periodically.
+#[derive(Debug, Clone, Default, Serialize, Deserialize)]
+pub struct EngineMetrics {
+    /// Sessions alive
+    pub active_sessions: u32,
+
+    /// Session tasks scheduled and not done yet, including the running ones
+    pub queued_tasks: u32,
+
+    /// Tokens prefilled, not counting the prefixes restored from the cache
+    pub prefilled_tokens: u64,
+
+    /// Decode steps, each decoding one token per output candidate
+    pub decode_steps: u64,
+
+    /// Turns cancelled
+    pub cancellations: u64,
+
+    /// Fraction of the kv-cache in use, if the engine pages its kv-cache
+    pub kv_cache_utilization: Option<f64>,
+
+    /// Caches shared by the sessions, all zero when disabled
+    pub prefix_cache: CacheStats,
+    pub embedding_cache: CacheStats,
+    pub token_id_cache: CacheStats,
+}
+
+impl EngineMetrics {
+    fn from_ffi(ffi: &LiteRtLmMetricsFFI) -> Self {
+        let count = |value: i64| value.max(0) as u64;
+        EngineMetrics {
+            active_sessions: ffi.num_sessions.max(0) as u32,
+            queued_tasks: ffi.num_queued_tasks.max(0) as u32,
+            prefilled_tokens: count(ffi.num_prefilled_tokens),
+            decode_steps: count(ffi.num_decode_steps),
+            cancellations: count(ffi.num_cancellations),
+            kv_cache_utilization: (ffi.kv_cache_utilization >= 0.0)
+                .then_some(ffi.kv_cache_utilization),
+            prefix_cache: CacheStats {
+                hits: count(ffi.prefix_cache_hits),
+                misses: count(ffi.prefix_cache_misses),
+            },
+            embedding_cache: CacheStats {
+                hits: count(ffi.embedding_cache_hits),
+                misses: count(ffi.embedding_cache_misses),
+            },
+            token_id_cache: CacheStats {
+                hits: count(ffi.token_id_cache_hits),
+                misses: count(ffi.token_id_cache_misses),
+            },
+        }
+    }
+}
+
+#[cfg(litert_dynamic)]
+fn to_c_int(name: &str, value: u32) -> LlmResult<c_int> {
+    c_int::try_from(value)
+        .map_err(|_| LlmError::BindingError(format!("Invalid {}: {}", name, value)))
+}
+
+/// Settings of a LiteRT-LM Engine
+///
+/// Starts from the defaults of [`LiteRTEngine::new`], which each setter
+/// overrides. The settings are copied when an engine is created, so that they
+/// can be reused for several engines.
+///
+/// ```ignore
+/// let settings = LiteRTEngineSettings::new("model.litertlm", LiteRTBackend::Cpu)?
+///     .max_num_tokens(4096)?
+///     .num_cpu_threads(4)?;
+/// let engine = LiteRTEngine::with_settings(&settings)?;
+/// ```
+pub struct LiteRTEngineSettings {
     #[cfg(litert_dynamic)]
-    ptr: LiteRtLmEnginePtr,
+    ptr: LiteRtLmEngineSettingsPtr,
 }
 
-// Safety: Engine can be sent between threads
-unsafe impl Send for LiteRTEngine {}
-unsafe impl Sync for LiteRTEngine {}
+// Safety: The settings are only mutated through `self`
+unsafe impl Send for LiteRTEngineSettings {}
+unsafe impl Sync for LiteRTEngineSettings {}
 
-impl LiteRTEngine {
-    /// Create a new Engine from a model file
+impl LiteRTEngineSettings {
+    /// Create the default settings of a model file
     ///
     /// # Arguments
     ///
@@ -277,13 +691,17 @@ impl LiteRTEngine {
             let model_path_cstr = CString::new(model_path)
                 .map_err(|e| LlmError::BindingError(format!("Invalid model path: {}", e)))?;
 
-            let mut engine_ptr: LiteRtLmEnginePtr = std::ptr::null_mut();
+            let mut settings_ptr: LiteRtLmEngineSettingsPtr = std::ptr::null_mut();
 
             let status = unsafe {
-                LiteRtLmEngine_Create(model_path_cstr.as_ptr(), backend.to_ffi(), &mut engine_ptr)
+                LiteRtLmEngineSettings_Create(
+                    model_path_cstr.as_ptr(),
+                    backend.to_ffi(),
+                    &mut settings_ptr,
+                )
             };
 
-            if status != 0 || engine_ptr.is_null() {
+            if status != 0 || settings_ptr.is_null() {
                 let err = unsafe {
                     let err_ptr = LiteRtLm_GetLastError();
                     if err_ptr.is_null() {
@@ -295,7 +713,7 @@ impl LiteRTEngine {
                 return Err(LlmError::BindingError(err));
             }
 
-            Ok(LiteRTEngine { ptr: engine_ptr })
+            Ok(LiteRTEngineSettings { ptr: settings_ptr })
         }
 
         #[cfg(litert_stub)]
@@ -308,92 +726,1520 @@ impl LiteRTEngine {
         }
     }
 
-    /// Create a new conversation
-    ///
-    /// Conversations maintain conversation state and can generate responses.
-    pub fn create_conversation(&self) -> LlmResult<LiteRTConversation> {
-        self.create_conversation_with_system(None)
+    #[cfg(litert_dynamic)]
+    fn check(self, status: c_int) -> LlmResult<Self> {
+        if status != 0 {
+            let err = unsafe {
+                let err_ptr = LiteRtLm_GetLastError();
+                if err_ptr.is_null() {
+                    "Unknown error".to_string()
+                } else {
+                    CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                }
+            };
+            return Err(LlmError::BindingError(err));
+        }
+        Ok(self)
     }
 
-    /// Create a new conversation with system instruction
-    ///
-    /// # Arguments
-    ///
-    /// * `system_instruction` - Optional system instruction to set conversation context
-    pub fn create_conversation_with_system(
-        &self,
-        system_instruction: Option<&str>,
-    ) -> LlmResult<LiteRTConversation> {
+    /// Set the maximum number of tokens of the context, prompt and response
+    pub fn max_num_tokens(self, max_num_tokens: u32) -> LlmResult<Self> {
         #[cfg(litert_dynamic)]
-        {
-            let mut conversation_ptr: LiteRtLmConversationPtr = std::ptr::null_mut();
+        unsafe {
+            LiteRtLmEngineSettings_SetMaxNumTokens(
+                self.ptr,
+                to_c_int("max_num_tokens", max_num_tokens)?,
+            );
+        }
+        #[cfg(litert_stub)]
+        let _ = max_num_tokens;
+        Ok(self)
+    }
 
-            let status = if let Some(system) = system_instruction {
-                let system_cstr = CString::new(system).map_err(|e| {
-                    LlmError::BindingError(format!("Invalid system instruction: {}", e))
-                })?;
-                unsafe {
-                    LiteRtLmConversation_CreateWithSystem(
-                        self.ptr,
-                        system_cstr.as_ptr(),
-                        &mut conversation_ptr,
-                    )
-                }
-            } else {
-                unsafe { LiteRtLmConversation_Create(self.ptr, &mut conversation_ptr) }
+    /// Set the batch sizes the prefill is compiled for
+    pub fn prefill_batch_sizes(self, prefill_batch_sizes: &[u32]) -> LlmResult<Self> {
+        #[cfg(litert_dynamic)]
+        {
+            let sizes = prefill_batch_sizes
+                .iter()
+                .map(|&size| to_c_int("prefill batch size", size))
+                .collect::<LlmResult<Vec<i32>>>()?;
+            let status = unsafe {
+                LiteRtLmEngineSettings_SetPrefillBatchSizes(
+                    self.ptr,
+                    sizes.as_ptr(),
+                    sizes.len() as c_int,
+                )
             };
-
-            if status != 0 || conversation_ptr.is_null() {
-                let err = unsafe {
-                    let err_ptr = LiteRtLm_GetLastError();
-                    if err_ptr.is_null() {
-                        "Unknown error".to_string()
-                    } else {
-                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
-                    }
-                };
-                return Err(LlmError::BindingError(err));
-            }
-
-            Ok(LiteRTConversation {
-                ptr: conversation_ptr,
-            })
+            self.check(status)
         }
 
         #[cfg(litert_stub)]
         {
-            let _ = system_instruction;
-            Err(LlmError::BindingError(
-                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
-                    .to_string(),
-            ))
+            let _ = prefill_batch_sizes;
+            Ok(self)
         }
     }
 
-    /// Create a new session (conversation) - DEPRECATED, use create_conversation instead
+    /// Set the number of threads of the CPU backend
     ///
-    /// Sessions maintain conversation state and can generate responses.
-    #[deprecated(since = "0.1.0", note = "Use create_conversation instead")]
-    pub fn create_session(&self) -> LlmResult<LiteRTConversation> {
-        self.create_conversation()
-    }
-}
+    /// Fails if the backend is not the CPU.
+    pub fn num_cpu_threads(self, num_cpu_threads: u32) -> LlmResult<Self> {
+        #[cfg(litert_dynamic)]
+        {
+            let num_cpu_threads = to_c_int("num_cpu_threads", num_cpu_threads)?;
+            let status =
+                unsafe { LiteRtLmEngineSettings_SetNumCpuThreads(self.ptr, num_cpu_threads) };
+            self.check(status)
+        }
 
-#[cfg(litert_dynamic)]
-impl Drop for LiteRTEngine {
-    fn drop(&mut self) {
-        unsafe {
-            LiteRtLmEngine_Destroy(self.ptr);
+        #[cfg(litert_stub)]
+        {
+            let _ = num_cpu_threads;
+            Ok(self)
         }
     }
-}
-
-#[cfg(litert_stub)]
-impl Drop for LiteRTEngine {
-    fn drop(&mut self) {}
-}
 
-/// LiteRT-LM Conversation
+    /// Set whether the GPU backend uses external tensors
+    ///
+    /// Fails if the backend is not the GPU.
+    pub fn gpu_external_tensor_mode(self, external_tensor_mode: bool) -> LlmResult<Self> {
+        #[cfg(litert_dynamic)]
+        {
+            let status = unsafe {
+                LiteRtLmEngineSettings_SetGpuExternalTensorMode(
+                    self.ptr,
+                    external_tensor_mode as c_int,
+                )
+            };
+            self.check(status)
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = external_tensor_mode;
+            Ok(self)
+        }
+    }
+
+    /// Set the directory the compiled models are cached in
+    ///
+    /// `":nocache"` disables the cache.
+    pub fn cache_dir(self, cache_dir: &str) -> LlmResult<Self> {
+        #[cfg(litert_dynamic)]
+        {
+            let cache_dir_cstr = CString::new(cache_dir)
+                .map_err(|e| LlmError::BindingError(format!("Invalid cache dir: {}", e)))?;
+            unsafe {
+                LiteRtLmEngineSettings_SetCacheDir(self.ptr, cache_dir_cstr.as_ptr());
+            }
+        }
+        #[cfg(litert_stub)]
+        let _ = cache_dir;
+        Ok(self)
+    }
+
+    /// Set the backend of the sampler
+    pub fn sampler_backend(self, sampler_backend: LiteRTBackend) -> Self {
+        #[cfg(litert_dynamic)]
+        unsafe {
+            LiteRtLmEngineSettings_SetSamplerBackend(self.ptr, sampler_backend.to_ffi());
+        }
+        #[cfg(litert_stub)]
+        let _ = sampler_backend;
+        self
+    }
+
+    /// Set the number of candidates the model is compiled to output
+    pub fn num_output_candidates(self, num_output_candidates: u32) -> LlmResult<Self> {
+        #[cfg(litert_dynamic)]
+        unsafe {
+            LiteRtLmEngineSettings_SetNumOutputCandidates(
+                self.ptr,
+                to_c_int("num_output_candidates", num_output_candidates)?,
+            );
+        }
+        #[cfg(litert_stub)]
+        let _ = num_output_candidates;
+        Ok(self)
+    }
+
+    /// Enable the benchmark of the engine
+    ///
+    /// A non-zero token count replaces the prompt, or the response, by that
+    /// many synthetic tokens.
+    pub fn benchmark(self, num_prefill_tokens: u32, num_decode_tokens: u32) -> LlmResult<Self> {
+        #[cfg(litert_dynamic)]
+        unsafe {
+            LiteRtLmEngineSettings_EnableBenchmark(
+                self.ptr,
+                to_c_int("num_prefill_tokens", num_prefill_tokens)?,
+                to_c_int("num_decode_tokens", num_decode_tokens)?,
+            );
+        }
+        #[cfg(litert_stub)]
+        let _ = (num_prefill_tokens, num_decode_tokens);
+        Ok(self)
+    }
+}
+
+#[cfg(litert_dynamic)]
+impl Drop for LiteRTEngineSettings {
+    fn drop(&mut self) {
+        unsafe {
+            LiteRtLmEngineSettings_Destroy(self.ptr);
+        }
+    }
+}
+
+/// Configuration of the session of a conversation
+///
+/// Starts from the defaults of [`LiteRTEngine::create_conversation`], which
+/// each setter overrides. The configuration is copied when a conversation is
+/// created, so that it can be reused for several conversations.
+pub struct LiteRTSessionConfig {
+    #[cfg(litert_dynamic)]
+    ptr: LiteRtLmSessionConfigPtr,
+}
+
+// Safety: The configuration is only mutated through `self`
+unsafe impl Send for LiteRTSessionConfig {}
+unsafe impl Sync for LiteRTSessionConfig {}
+
+impl LiteRTSessionConfig {
+    /// Create the default configuration
+    pub fn new() -> LlmResult<Self> {
+        #[cfg(litert_dynamic)]
+        {
+            let mut config_ptr: LiteRtLmSessionConfigPtr = std::ptr::null_mut();
+
+            let status = unsafe { LiteRtLmSessionConfig_Create(&mut config_ptr) };
+
+            if status != 0 || config_ptr.is_null() {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(LiteRTSessionConfig { ptr: config_ptr })
+        }
+
+        #[cfg(litert_stub)]
+        {
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Set the number of candidates to output
+    ///
+    /// At most the number of candidates the engine is compiled for.
+    pub fn num_output_candidates(self, num_output_candidates: u32) -> LlmResult<Self> {
+        #[cfg(litert_dynamic)]
+        unsafe {
+            LiteRtLmSessionConfig_SetNumOutputCandidates(
+                self.ptr,
+                to_c_int("num_output_candidates", num_output_candidates)?,
+            );
+        }
+        #[cfg(litert_stub)]
+        let _ = num_output_candidates;
+        Ok(self)
+    }
+
+    /// Set the backend of the sampler
+    pub fn sampler_backend(self, sampler_backend: LiteRTBackend) -> Self {
+        #[cfg(litert_dynamic)]
+        unsafe {
+            LiteRtLmSessionConfig_SetSamplerBackend(self.ptr, sampler_backend.to_ffi());
+        }
+        #[cfg(litert_stub)]
+        let _ = sampler_backend;
+        self
+    }
+
+    /// Set the priority of the session, higher is scheduled first
+    pub fn priority(self, priority: i32) -> Self {
+        #[cfg(litert_dynamic)]
+        unsafe {
+            LiteRtLmSessionConfig_SetPriority(self.ptr, priority);
+        }
+        #[cfg(litert_stub)]
+        let _ = priority;
+        self
+    }
+
+    /// Bound the chunks of a streamed response waiting for its consumer
+    ///
+    /// The chunks are then delivered from a thread of their own, so that a
+    /// slow consumer, e.g. a network client, does not stall the decoding of
+    /// the other sessions. `backpressure` applies once `max_pending_chunks`
+    /// chunks are waiting.
+    pub fn stream_backpressure(
+        self,
+        max_pending_chunks: u32,
+        backpressure: StreamBackpressure,
+    ) -> LlmResult<Self> {
+        if max_pending_chunks == 0 {
+            return Err(LlmError::BindingError(
+                "max_pending_chunks must be at least 1".to_string(),
+            ));
+        }
+        #[cfg(litert_dynamic)]
+        unsafe {
+            LiteRtLmSessionConfig_SetStreamBackpressure(
+                self.ptr,
+                to_c_int("max_pending_chunks", max_pending_chunks)?,
+                backpressure.to_ffi(),
+            );
+        }
+        #[cfg(litert_stub)]
+        let _ = (max_pending_chunks, backpressure);
+        Ok(self)
+    }
+}
+
+#[cfg(litert_dynamic)]
+impl Drop for LiteRTSessionConfig {
+    fn drop(&mut self) {
+        unsafe {
+            LiteRtLmSessionConfig_Destroy(self.ptr);
+        }
+    }
+}
+
+/// LiteRT-LM Engine
+///
+/// The Engine loads a model and manages its lifecycle.
+/// Create sessions (conversations) from the engine.
+pub struct LiteRTEngine {
+    #[cfg(litert_dynamic)]
+    ptr: LiteRtLmEnginePtr,
+}
+
+// Safety: Engine can be sent between threads
+unsafe impl Send for LiteRTEngine {}
+unsafe impl Sync for LiteRTEngine {}
+
+impl LiteRTEngine {
+    /// Create a new Engine from a model file
+    ///
+    /// # Arguments
+    ///
+    /// * `model_path` - Path to the .litertlm model file
+    /// * `backend` - Backend to use (Cpu or Gpu)
+    pub fn new(model_path: &str, backend: LiteRTBackend) -> LlmResult<Self> {
+        #[cfg(litert_dynamic)]
+        {
+            let model_path_cstr = CString::new(model_path)
+                .map_err(|e| LlmError::BindingError(format!("Invalid model path: {}", e)))?;
+
+            let mut engine_ptr: LiteRtLmEnginePtr = std::ptr::null_mut();
+
+            let status = unsafe {
+                LiteRtLmEngine_Create(model_path_cstr.as_ptr(), backend.to_ffi(), &mut engine_ptr)
+            };
+
+            if status != 0 || engine_ptr.is_null() {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(LiteRTEngine { ptr: engine_ptr })
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = (model_path, backend);
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Create a new Engine from its settings
+    pub fn with_settings(settings: &LiteRTEngineSettings) -> LlmResult<Self> {
+        #[cfg(litert_dynamic)]
+        {
+            let mut engine_ptr: LiteRtLmEnginePtr = std::ptr::null_mut();
+
+            let status =
+                unsafe { LiteRtLmEngine_CreateWithSettings(settings.ptr, &mut engine_ptr) };
+
+            if status != 0 || engine_ptr.is_null() {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(LiteRTEngine { ptr: engine_ptr })
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = settings;
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Start creating a new Engine from a model file on a background thread
+    ///
+    /// Returns immediately, so that the caller is not blocked while a large
+    /// model is loading. The engine is returned by
+    /// [`LiteRTEngineCreation::wait`], which does not block once
+    /// `on_progress` got [`CreationPhase::Done`].
+    ///
+    /// # Arguments
+    ///
+    /// * `model_path` - Path to the .litertlm model file
+    /// * `backend` - Backend to use (Cpu or Gpu)
+    /// * `on_progress` - Called on a background thread as each phase of the
+    ///   creation completes, and with [`CreationPhase::Done`] and whether the
+    ///   creation succeeded once it is done
+    pub fn create_async<F>(
+        model_path: &str,
+        backend: LiteRTBackend,
+        on_progress: F,
+    ) -> LlmResult<LiteRTEngineCreation>
+    where
+        F: Fn(CreationPhase, bool) + Send + Sync + 'static,
+    {
+        #[cfg(litert_dynamic)]
+        {
+            let model_path_cstr = CString::new(model_path)
+                .map_err(|e| LlmError::BindingError(format!("Invalid model path: {}", e)))?;
+
+            // Double boxed, so that the callback data is a thin pointer.
+            let on_progress: Box<ProgressCallback> = Box::new(Box::new(on_progress));
+            let mut creation_ptr: LiteRtLmEngineCreationPtr = std::ptr::null_mut();
+
+            let status = unsafe {
+                LiteRtLmEngine_CreateAsync(
+                    model_path_cstr.as_ptr(),
+                    backend.to_ffi(),
+                    Some(creation_progress_trampoline),
+                    &*on_progress as *const ProgressCallback as *mut std::ffi::c_void,
+                    &mut creation_ptr,
+                )
+            };
+
+            if status != 0 || creation_ptr.is_null() {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(LiteRTEngineCreation {
+                ptr: creation_ptr,
+                _on_progress: on_progress,
+            })
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = (model_path, backend, on_progress);
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Start creating a new Engine from its settings on a background thread
+    ///
+    /// See [`LiteRTEngine::create_async`].
+    pub fn create_async_with_settings<F>(
+        settings: &LiteRTEngineSettings,
+        on_progress: F,
+    ) -> LlmResult<LiteRTEngineCreation>
+    where
+        F: Fn(CreationPhase, bool) + Send + Sync + 'static,
+    {
+        #[cfg(litert_dynamic)]
+        {
+            // Double boxed, so that the callback data is a thin pointer.
+            let on_progress: Box<ProgressCallback> = Box::new(Box::new(on_progress));
+            let mut creation_ptr: LiteRtLmEngineCreationPtr = std::ptr::null_mut();
+
+            let status = unsafe {
+                LiteRtLmEngine_CreateAsyncWithSettings(
+                    settings.ptr,
+                    Some(creation_progress_trampoline),
+                    &*on_progress as *const ProgressCallback as *mut std::ffi::c_void,
+                    &mut creation_ptr,
+                )
+            };
+
+            if status != 0 || creation_ptr.is_null() {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(LiteRTEngineCreation {
+                ptr: creation_ptr,
+                _on_progress: on_progress,
+            })
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = (settings, on_progress);
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Create a new conversation
+    ///
+    /// Conversations maintain conversation state and can generate responses.
+    pub fn create_conversation(&self) -> LlmResult<LiteRTConversation> {
+        self.create_conversation_with_system(None)
+    }
+
+    /// Create a new conversation with system instruction
+    ///
+    /// # Arguments
+    ///
+    /// * `system_instruction` - Optional system instruction to set conversation context
+    pub fn create_conversation_with_system(
+        &self,
+        system_instruction: Option<&str>,
+    ) -> LlmResult<LiteRTConversation> {
+        #[cfg(litert_dynamic)]
+        {
+            let mut conversation_ptr: LiteRtLmConversationPtr = std::ptr::null_mut();
+
+            let status = if let Some(system) = system_instruction {
+                let system_cstr = CString::new(system).map_err(|e| {
+                    LlmError::BindingError(format!("Invalid system instruction: {}", e))
+                })?;
+                unsafe {
+                    LiteRtLmConversation_CreateWithSystem(
+                        self.ptr,
+                        system_cstr.as_ptr(),
+                        &mut conversation_ptr,
+                    )
+                }
+            } else {
+                unsafe { LiteRtLmConversation_Create(self.ptr, &mut conversation_ptr) }
+            };
+
+            if status != 0 || conversation_ptr.is_null() {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(LiteRTConversation {
+                ptr: conversation_ptr,
+            })
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = system_instruction;
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Create a new conversation with a session configuration
+    ///
+    /// # Arguments
+    ///
+    /// * `config` - Configuration of the session of the conversation
+    /// * `system_instruction` - Optional system instruction to set conversation context
+    pub fn create_conversation_with_config(
+        &self,
+        config: &LiteRTSessionConfig,
+        system_instruction: Option<&str>,
+    ) -> LlmResult<LiteRTConversation> {
+        #[cfg(litert_dynamic)]
+        {
+            let system_cstr = system_instruction
+                .map(CString::new)
+                .transpose()
+                .map_err(|e| {
+                    LlmError::BindingError(format!("Invalid system instruction: {}", e))
+                })?;
+            let mut conversation_ptr: LiteRtLmConversationPtr = std::ptr::null_mut();
+
+            let status = unsafe {
+                LiteRtLmConversation_CreateWithConfig(
+                    self.ptr,
+                    config.ptr,
+                    system_cstr
+                        .as_ref()
+                        .map_or(std::ptr::null(), |system| system.as_ptr()),
+                    &mut conversation_ptr,
+                )
+            };
+
+            if status != 0 || conversation_ptr.is_null() {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(LiteRTConversation {
+                ptr: conversation_ptr,
+            })
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = (config, system_instruction);
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Get the metrics of the engine
+    ///
+    /// Cheap enough to be called periodically, e.g. by a metrics exporter.
+    pub fn metrics(&self) -> LlmResult<EngineMetrics> {
+        #[cfg(litert_dynamic)]
+        {
+            let mut metrics = LiteRtLmMetricsFFI::default();
+
+            let status = unsafe { LiteRtLmEngine_GetMetrics(self.ptr, &mut metrics) };
+
+            if status != 0 {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Failed to get engine metrics".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(EngineMetrics::from_ffi(&metrics))
+        }
+
+        #[cfg(litert_stub)]
+        {
+            Ok(EngineMetrics::from_ffi(&LiteRtLmMetricsFFI {
+                kv_cache_utilization: -1.0,
+                ..Default::default()
+            }))
+        }
+    }
+
+    /// Tokenize a text with the tokenizer of the model, without creating a
+    /// conversation
+    pub fn tokenize(&self, text: &str) -> LlmResult<Vec<i32>> {
+        #[cfg(litert_dynamic)]
+        {
+            let text_cstr = CString::new(text)
+                .map_err(|e| LlmError::BindingError(format!("Invalid text: {}", e)))?;
+            let mut token_ids_ptr: *mut i32 = std::ptr::null_mut();
+            let mut num_tokens: c_int = 0;
+
+            let status = unsafe {
+                LiteRtLmEngine_TextToTokenIds(
+                    self.ptr,
+                    text_cstr.as_ptr(),
+                    &mut token_ids_ptr,
+                    &mut num_tokens,
+                )
+            };
+
+            if status != 0 {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(unsafe { take_token_ids(token_ids_ptr, num_tokens as usize) })
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = text;
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Count the tokens of a text with the tokenizer of the model, without
+    /// creating a conversation
+    pub fn count_tokens(&self, text: &str) -> LlmResult<usize> {
+        #[cfg(litert_dynamic)]
+        {
+            let text_cstr = CString::new(text)
+                .map_err(|e| LlmError::BindingError(format!("Invalid text: {}", e)))?;
+            let mut num_tokens: c_int = 0;
+
+            let status = unsafe {
+                LiteRtLmEngine_CountTokens(self.ptr, text_cstr.as_ptr(), &mut num_tokens)
+            };
+
+            if status != 0 {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(num_tokens as usize)
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = text;
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Create a new session (conversation) - DEPRECATED, use create_conversation instead
+    ///
+    /// Sessions maintain conversation state and can generate responses.
+    #[deprecated(since = "0.1.0", note = "Use create_conversation instead")]
+    pub fn create_session(&self) -> LlmResult<LiteRTConversation> {
+        self.create_conversation()
+    }
+}
+
+#[cfg(litert_dynamic)]
+impl Drop for LiteRTEngine {
+    fn drop(&mut self) {
+        unsafe {
+            LiteRtLmEngine_Destroy(self.ptr);
+        }
+    }
+}
+
+#[cfg(litert_stub)]
+impl Drop for LiteRTEngine {
+    fn drop(&mut self) {}
+}
+
+// Takes over token ids allocated by the library.
+#[cfg(litert_dynamic)]
+unsafe fn take_token_ids(token_ids_ptr: *mut i32, num_tokens: usize) -> Vec<i32> {
+    if token_ids_ptr.is_null() {
+        return Vec::new();
+    }
+    let token_ids = std::slice::from_raw_parts(token_ids_ptr, num_tokens).to_vec();
+    LiteRtLm_FreeTokenIds(token_ids_ptr);
+    token_ids
+}
+
+// Holds the texts of a batch for the duration of a call.
+#[cfg(litert_dynamic)]
+struct TextBatch {
+    texts: Vec<CString>,
+    ptrs: Vec<*const c_char>,
+}
+
+#[cfg(litert_dynamic)]
+impl TextBatch {
+    fn new(texts: &[&str]) -> LlmResult<Self> {
+        let texts = texts
+            .iter()
+            .map(|text| {
+                CString::new(*text)
+                    .map_err(|e| LlmError::BindingError(format!("Invalid text: {}", e)))
+            })
+            .collect::<LlmResult<Vec<_>>>()?;
+        let ptrs = texts.iter().map(|text| text.as_ptr()).collect();
+        Ok(TextBatch { texts, ptrs })
+    }
+
+    fn len(&self) -> c_int {
+        self.texts.len() as c_int
+    }
+}
+
+/// Tokenizer of batches of texts, running on its own threads
+///
+/// Tokenizes the prompts of many requests without creating conversations,
+/// e.g. for a router counting their tokens to pick a model and enforce a
+/// budget. The texts of a batch are split across the threads.
+pub struct LiteRTBatchTokenizer {
+    #[cfg(litert_dynamic)]
+    ptr: LiteRtLmTokenizerPtr,
+    // The tokenizer belongs to the engine.
+    _engine: std::sync::Arc<LiteRTEngine>,
+}
+
+// Safety: The tokenizer of the engine is shared by its sessions, and can be
+// called from any thread
+unsafe impl Send for LiteRTBatchTokenizer {}
+unsafe impl Sync for LiteRTBatchTokenizer {}
+
+impl LiteRTBatchTokenizer {
+    /// Create a tokenizer of batches from the tokenizer of an engine
+    ///
+    /// # Arguments
+    ///
+    /// * `engine` - Engine whose tokenizer is used
+    /// * `num_threads` - Number of threads tokenizing a batch
+    pub fn new(engine: std::sync::Arc<LiteRTEngine>, num_threads: usize) -> LlmResult<Self> {
+        #[cfg(litert_dynamic)]
+        {
+            let num_threads = c_int::try_from(num_threads).map_err(|_| {
+                LlmError::BindingError(format!("Invalid num_threads: {}", num_threads))
+            })?;
+            let mut tokenizer_ptr: LiteRtLmTokenizerPtr = std::ptr::null_mut();
+
+            let status =
+                unsafe { LiteRtLmTokenizer_Create(engine.ptr, num_threads, &mut tokenizer_ptr) };
+
+            if status != 0 || tokenizer_ptr.is_null() {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(LiteRTBatchTokenizer {
+                ptr: tokenizer_ptr,
+                _engine: engine,
+            })
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = (engine, num_threads);
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Tokenize a batch of texts, returning the token ids of each text
+    pub fn tokenize(&self, texts: &[&str]) -> LlmResult<Vec<Vec<i32>>> {
+        #[cfg(litert_dynamic)]
+        {
+            let batch = TextBatch::new(texts)?;
+            let mut token_ids_ptr: *mut i32 = std::ptr::null_mut();
+            let mut offsets: Vec<i64> = vec![0; texts.len() + 1];
+
+            let status = unsafe {
+                LiteRtLmTokenizer_TextToTokenIds(
+                    self.ptr,
+                    batch.ptrs.as_ptr(),
+                    batch.len(),
+                    &mut token_ids_ptr,
+                    offsets.as_mut_ptr(),
+                )
+            };
+
+            if status != 0 {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            let token_ids = unsafe { take_token_ids(token_ids_ptr, offsets[texts.len()] as usize) };
+            Ok(offsets
+                .windows(2)
+                .map(|range| token_ids[range[0] as usize..range[1] as usize].to_vec())
+                .collect())
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = texts;
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Count the tokens of each text of a batch
+    pub fn count_tokens(&self, texts: &[&str]) -> LlmResult<Vec<usize>> {
+        #[cfg(litert_dynamic)]
+        {
+            let batch = TextBatch::new(texts)?;
+            let mut num_tokens: Vec<i32> = vec![0; texts.len()];
+
+            let status = unsafe {
+                LiteRtLmTokenizer_CountTokens(
+                    self.ptr,
+                    batch.ptrs.as_ptr(),
+                    batch.len(),
+                    num_tokens.as_mut_ptr(),
+                )
+            };
+
+            if status != 0 {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(num_tokens.into_iter().map(|count| count as usize).collect())
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = texts;
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+}
+
+#[cfg(litert_dynamic)]
+impl Drop for LiteRTBatchTokenizer {
+    fn drop(&mut self) {
+        unsafe {
+            LiteRtLmTokenizer_Destroy(self.ptr);
+        }
+    }
+}
+
+/// Phase of an asynchronous engine creation, see [`LiteRTEngine::create_async`]
+///
+/// The phases of the executors the model does not have are skipped.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum CreationPhase {
+    /// The model file is mapped
+    ModelMapping,
+    /// The tokenizer is loaded
+    Tokenizer,
+    /// The main model is compiled
+    MainExecutor,
+    /// The vision model is compiled
+    VisionExecutor,
+    /// The audio model is compiled
+    AudioExecutor,
+    /// The draft model is compiled
+    DraftExecutor,
+    /// The creation is done, successfully or not
+    Done,
+}
+
+impl CreationPhase {
+    #[cfg(litert_dynamic)]
+    fn from_ffi(phase: c_int) -> Option<Self> {
+        match phase {
+            0 => Some(CreationPhase::ModelMapping),
+            1 => Some(CreationPhase::Tokenizer),
+            2 => Some(CreationPhase::MainExecutor),
+            3 => Some(CreationPhase::VisionExecutor),
+            4 => Some(CreationPhase::AudioExecutor),
+            5 => Some(CreationPhase::DraftExecutor),
+            6 => Some(CreationPhase::Done),
+            _ => None,
+        }
+    }
+}
+
+#[cfg(litert_dynamic)]
+type ProgressCallback = Box<dyn Fn(CreationPhase, bool) + Send + Sync>;
+
+#[cfg(litert_dynamic)]
+unsafe extern "C" fn creation_progress_trampoline(
+    user_data: *mut std::ffi::c_void,
+    phase: c_int,
+    status: c_int,
+) {
+    if let Some(phase) = CreationPhase::from_ffi(phase) {
+        let on_progress = &*(user_data as *const ProgressCallback);
+        // Never unwind across the FFI boundary.
+        let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+            on_progress(phase, status == 0)
+        }));
+    }
+}
+
+/// LiteRT-LM Engine being created on a background thread
+///
+/// Dropping it cancels the creation if not done, and waits for it to stop.
+pub struct LiteRTEngineCreation {
+    #[cfg(litert_dynamic)]
+    ptr: LiteRtLmEngineCreationPtr,
+    // Called by the creation until it is destroyed.
+    #[cfg(litert_dynamic)]
+    _on_progress: Box<ProgressCallback>,
+}
+
+// Safety: The creation can be cancelled and waited from any thread
+unsafe impl Send for LiteRTEngineCreation {}
+unsafe impl Sync for LiteRTEngineCreation {}
+
+impl LiteRTEngineCreation {
+    /// Request the cancellation of the creation
+    ///
+    /// The creation stops when its current phase, e.g. a model compilation,
+    /// completes. [`LiteRTEngineCreation::wait`] then returns an error.
+    pub fn cancel(&self) {
+        #[cfg(litert_dynamic)]
+        unsafe {
+            LiteRtLmEngineCreation_Cancel(self.ptr);
+        }
+    }
+
+    /// Wait for the creation to be done and return the engine
+    ///
+    /// Blocks until the creation is done: call it after `on_progress` got
+    /// [`CreationPhase::Done`], or from a blocking task. The engine is
+    /// returned once.
+    pub fn wait(&self) -> LlmResult<LiteRTEngine> {
+        #[cfg(litert_dynamic)]
+        {
+            let mut engine_ptr: LiteRtLmEnginePtr = std::ptr::null_mut();
+
+            let status = unsafe { LiteRtLmEngineCreation_Wait(self.ptr, &mut engine_ptr) };
+
+            if status != 0 || engine_ptr.is_null() {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(LiteRTEngine { ptr: engine_ptr })
+        }
+
+        #[cfg(litert_stub)]
+        {
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+}
+
+#[cfg(litert_dynamic)]
+impl Drop for LiteRTEngineCreation {
+    fn drop(&mut self) {
+        // Destroyed before the callback it calls.
+        unsafe {
+            LiteRtLmEngineCreation_Destroy(self.ptr);
+        }
+    }
+}
+
+/// Event of a response streamed by [`LiteRTConversation::send_message_stream`]
+#[derive(Debug)]
+pub enum StreamEvent {
+    /// The text generated since the previous chunk
+    Chunk(String),
+    /// The response is complete
+    Done,
+    /// The generation failed or was cancelled, the response ends
+    Error(LlmError),
+}
+
+#[cfg(litert_dynamic)]
+type StreamCallback = Box<dyn FnMut(StreamEvent) + Send>;
+
+#[cfg(litert_dynamic)]
+unsafe extern "C" fn message_stream_trampoline(
+    user_data: *mut std::ffi::c_void,
+    chunk: *const c_char,
+    is_final: c_int,
+    error_message: *const c_char,
+) {
+    let on_event = &mut *(user_data as *mut StreamCallback);
+    let event = if !error_message.is_null() {
+        StreamEvent::Error(LlmError::BindingError(
+            CStr::from_ptr(error_message).to_string_lossy().into_owned(),
+        ))
+    } else if is_final != 0 {
+        StreamEvent::Done
+    } else {
+        StreamEvent::Chunk(CStr::from_ptr(chunk).to_string_lossy().into_owned())
+    };
+    // Never unwind across the FFI boundary.
+    let _ = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| on_event(event)));
+    if is_final != 0 {
+        // Not called after the final event.
+        drop(Box::from_raw(user_data as *mut StreamCallback));
+    }
+}
+
+/// Bytes of a response, pointing into the storage of the engine instead of
+/// being copied
+///
+/// Cloning shares the storage, which is freed with the last clone.
+pub struct ResponseBuffer {
+    #[cfg(litert_dynamic)]
+    buffer: LiteRtLmBufferFFI,
+}
+
+// Safety: The bytes are immutable and their reference count is atomic
+unsafe impl Send for ResponseBuffer {}
+unsafe impl Sync for ResponseBuffer {}
+
+impl ResponseBuffer {
+    /// The bytes of the response
+    pub fn as_bytes(&self) -> &[u8] {
+        #[cfg(litert_dynamic)]
+        {
+            if self.buffer.data.is_null() {
+                return &[];
+            }
+            unsafe { std::slice::from_raw_parts(self.buffer.data as *const u8, self.buffer.size) }
+        }
+
+        #[cfg(litert_stub)]
+        {
+            &[]
+        }
+    }
+
+    /// The text of the response, without a copy
+    pub fn as_str(&self) -> LlmResult<&str> {
+        std::str::from_utf8(self.as_bytes())
+            .map_err(|e| LlmError::BindingError(format!("Invalid UTF-8 in response: {}", e)))
+    }
+
+    pub fn len(&self) -> usize {
+        self.as_bytes().len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.as_bytes().is_empty()
+    }
+}
+
+impl std::ops::Deref for ResponseBuffer {
+    type Target = [u8];
+
+    fn deref(&self) -> &[u8] {
+        self.as_bytes()
+    }
+}
+
+impl AsRef<[u8]> for ResponseBuffer {
+    fn as_ref(&self) -> &[u8] {
+        self.as_bytes()
+    }
+}
+
+impl std::fmt::Debug for ResponseBuffer {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_tuple("ResponseBuffer")
+            .field(&String::from_utf8_lossy(self.as_bytes()))
+            .finish()
+    }
+}
+
+impl Clone for ResponseBuffer {
+    fn clone(&self) -> Self {
+        #[cfg(litert_dynamic)]
+        {
+            if let Some(retain) = self.buffer.retain {
+                unsafe { retain(self.buffer.owner) };
+            }
+            ResponseBuffer {
+                buffer: LiteRtLmBufferFFI {
+                    data: self.buffer.data,
+                    size: self.buffer.size,
+                    owner: self.buffer.owner,
+                    retain: self.buffer.retain,
+                    release: self.buffer.release,
+                },
+            }
+        }
+
+        #[cfg(litert_stub)]
+        {
+            ResponseBuffer {}
+        }
+    }
+}
+
+#[cfg(litert_dynamic)]
+impl Drop for ResponseBuffer {
+    fn drop(&mut self) {
+        if let Some(release) = self.buffer.release {
+            unsafe { release(self.buffer.owner) };
+        }
+    }
+}
+
+/// Completion of a response submitted with [`LiteRTConversation::submit_message`]
+#[derive(Debug)]
+pub struct Completion {
+    /// The tag the response was submitted with
+    pub tag: u64,
+    /// The text generated since the previous completion of the response
+    pub chunk: Option<ResponseBuffer>,
+    /// Whether this is the last completion of the response
+    pub is_final: bool,
+    /// The error of the response, on its last completion
+    pub error: Option<LlmError>,
+}
+
+impl Completion {
+    // Takes over the chunk and the error message of the completion.
+    #[cfg(litert_dynamic)]
+    unsafe fn from_ffi(completion: LiteRtLmCompletionFFI) -> Self {
+        let take_string = |s: *mut c_char| {
+            if s.is_null() {
+                None
+            } else {
+                let string = CStr::from_ptr(s).to_string_lossy().into_owned();
+                LiteRtLm_FreeString(s);
+                Some(string)
+            }
+        };
+        let chunk = ResponseBuffer {
+            buffer: completion.chunk,
+        };
+        Completion {
+            tag: completion.tag,
+            chunk: (!chunk.is_empty()).then_some(chunk),
+            is_final: completion.is_final != 0,
+            error: take_string(completion.error_message).map(LlmError::BindingError),
+        }
+    }
+}
+
+/// Message submitted by [`LiteRTCompletionQueue::submit_messages`]
+#[derive(Debug, Clone, Copy)]
+pub struct Submission<'a> {
+    /// The conversation the message is sent to
+    pub conversation: &'a LiteRTConversation,
+    /// Message role ("user", "model", "system")
+    pub role: &'a str,
+    /// Message content
+    pub content: &'a str,
+    /// Tag of the completions of the response
+    pub tag: u64,
+}
+
+/// Queue of the completions of the responses submitted with
+/// [`LiteRTConversation::submit_message`]
+///
+/// The engine threads push the completions without locks and without running
+/// any Rust code, and the queue is awaited through the tokio reactor, so that
+/// no runtime thread blocks on a generation.
+pub struct LiteRTCompletionQueue {
+    #[cfg(litert_dynamic)]
+    ptr: LiteRtLmCompletionQueuePtr,
+    // Readable while there may be completions to poll. Deregistered before the
+    // queue closes it.
+    #[cfg(litert_dynamic)]
+    fd: Option<tokio::io::unix::AsyncFd<std::os::unix::io::RawFd>>,
+    // The queue must not be polled concurrently. Only taken by the pollers,
+    // never by the engine threads.
+    #[cfg(litert_dynamic)]
+    poll_lock: std::sync::Mutex<()>,
+}
+
+// Safety: The completions are pushed without locks from any thread, and the
+// polls are serialized
+unsafe impl Send for LiteRTCompletionQueue {}
+unsafe impl Sync for LiteRTCompletionQueue {}
+
+impl LiteRTCompletionQueue {
+    /// The maximum number of completions returned by one poll
+    pub const MAX_COMPLETIONS_PER_POLL: usize = 64;
+
+    /// Create a completion queue
+    ///
+    /// Must be called from a tokio runtime, whose reactor then polls it.
+    pub fn new() -> LlmResult<Self> {
+        #[cfg(litert_dynamic)]
+        {
+            if tokio::runtime::Handle::try_current().is_err() {
+                return Err(LlmError::ConfigError(
+                    "A completion queue must be created from a tokio runtime".to_string(),
+                ));
+            }
+
+            let mut queue_ptr: LiteRtLmCompletionQueuePtr = std::ptr::null_mut();
+
+            let status = unsafe { LiteRtLmCompletionQueue_Create(&mut queue_ptr) };
+
+            if status != 0 || queue_ptr.is_null() {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            let fd = unsafe { LiteRtLmCompletionQueue_GetFd(queue_ptr) };
+            match tokio::io::unix::AsyncFd::new(fd) {
+                Ok(fd) => Ok(LiteRTCompletionQueue {
+                    ptr: queue_ptr,
+                    fd: Some(fd),
+                    poll_lock: std::sync::Mutex::new(()),
+                }),
+                Err(e) => {
+                    unsafe { LiteRtLmCompletionQueue_Destroy(queue_ptr) };
+                    Err(LlmError::RuntimeError(format!(
+                        "Failed to register the completion queue: {}",
+                        e
+                    )))
+                }
+            }
+        }
+
+        #[cfg(litert_stub)]
+        {
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Send messages to several conversations at once and push their
+    /// responses to this queue
+    ///
+    /// The messages are all enqueued before this returns, so that the engine
+    /// sees them together, see [`LiteRTConversation::submit_message`]. Returns
+    /// whether each message was sent, nothing is pushed for the others.
+    pub fn submit_messages(&self, submissions: &[Submission<'_>]) -> Vec<LlmResult<()>> {
+        #[cfg(litert_dynamic)]
+        {
+            let mut results: Vec<LlmResult<()>> = Vec::with_capacity(submissions.len());
+            let mut strings = Vec::with_capacity(submissions.len());
+            let mut indices = Vec::with_capacity(submissions.len());
+            for (index, submission) in submissions.iter().enumerate() {
+                let role = CString::new(submission.role)
+                    .map_err(|e| LlmError::BindingError(format!("Invalid role: {}", e)));
+                let content = CString::new(submission.content)
+                    .map_err(|e| LlmError::BindingError(format!("Invalid content: {}", e)));
+                match (role, content) {
+                    (Ok(role), Ok(content)) => {
+                        strings.push((role, content));
+                        indices.push(index);
+                        results.push(Ok(()));
+                    }
+                    (Err(e), _) | (_, Err(e)) => results.push(Err(e)),
+                }
+            }
+            if indices.is_empty() {
+                return results;
+            }
+
+            let ffi_submissions: Vec<LiteRtLmSubmissionFFI> = indices
+                .iter()
+                .zip(&strings)
+                .map(|(&index, (role, content))| LiteRtLmSubmissionFFI {
+                    conversation: submissions[index].conversation.ptr,
+                    role: role.as_ptr(),
+                    content: content.as_ptr(),
+                    tag: submissions[index].tag,
+                })
+                .collect();
+            let mut statuses: Vec<c_int> = vec![0; ffi_submissions.len()];
+
+            let status = unsafe {
+                LiteRtLmConversation_SubmitMessages(
+                    ffi_submissions.as_ptr(),
+                    ffi_submissions.len() as c_int,
+                    self.ptr,
+                    statuses.as_mut_ptr(),
+                )
+            };
+
+            if status != 0 {
+                for (&index, &status) in indices.iter().zip(&statuses) {
+                    if status != 0 {
+                        results[index] = Err(LlmError::BindingError(format!(
+                            "Failed to submit message {} (status {})",
+                            index, status
+                        )));
+                    }
+                }
+            }
+
+            results
+        }
+
+        #[cfg(litert_stub)]
+        {
+            submissions
+                .iter()
+                .map(|_| {
+                    Err(LlmError::BindingError(
+                        "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                            .to_string(),
+                    ))
+                })
+                .collect()
+        }
+    }
+
+    /// Poll the completions without blocking, in their order
+    pub fn poll(&self) -> Vec<Completion> {
+        #[cfg(litert_dynamic)]
+        {
+            let _lock = self
+                .poll_lock
+                .lock()
+                .unwrap_or_else(|poisoned| poisoned.into_inner());
+            let mut completions: Vec<LiteRtLmCompletionFFI> =
+                Vec::with_capacity(Self::MAX_COMPLETIONS_PER_POLL);
+            let num_completions = unsafe {
+                LiteRtLmCompletionQueue_Poll(
+                    self.ptr,
+                    completions.as_mut_ptr(),
+                    Self::MAX_COMPLETIONS_PER_POLL as c_int,
+                )
+            };
+            if num_completions <= 0 {
+                return Vec::new();
+            }
+            unsafe { completions.set_len(num_completions as usize) };
+            completions
+                .into_iter()
+                .map(|completion| unsafe { Completion::from_ffi(completion) })
+                .collect()
+        }
+
+        #[cfg(litert_stub)]
+        {
+            Vec::new()
+        }
+    }
+
+    /// Wait for completions and return them, in their order
+    pub async fn next_batch(&self) -> LlmResult<Vec<Completion>> {
+        #[cfg(litert_dynamic)]
+        {
+            let fd = self.fd.as_ref().expect("registered until dropped");
+            loop {
+                let mut guard = fd.readable().await.map_err(|e| {
+                    LlmError::RuntimeError(format!("Failed to wait for completions: {}", e))
+                })?;
+                let completions = self.poll();
+                if !completions.is_empty() {
+                    return Ok(completions);
+                }
+                // Readable again once a completion is pushed.
+                guard.clear_ready();
+            }
+        }
+
+        #[cfg(litert_stub)]
+        {
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+}
+
+#[cfg(litert_dynamic)]
+impl Drop for LiteRTCompletionQueue {
+    fn drop(&mut self) {
+        self.fd.take();
+        unsafe {
+            LiteRtLmCompletionQueue_Destroy(self.ptr);
+        }
+    }
+}
+
+/// LiteRT-LM Conversation
 ///
 /// A conversation represents a stateful chat context with the model.
 /// Uses LiteRT-LM's Conversation API with proper Jinja template formatting.
@@ -402,13 +2248,75 @@ pub struct LiteRTConversation {
     ptr: LiteRtLmConversationPtr,
 }
 
-// Safety: Conversations can be moved between threads and shared
-// The underlying C++ conversation is thread-safe
-unsafe impl Send for LiteRTConversation {}
-unsafe impl Sync for LiteRTConversation {}
+// Safety: Conversations can be moved between threads and shared
+// The underlying C++ conversation is thread-safe
+unsafe impl Send for LiteRTConversation {}
+unsafe impl Sync for LiteRTConversation {}
+
+impl LiteRTConversation {
+    /// Send a message with a specific role and get a response
+    ///
+    /// # Arguments
+    ///
+    /// * `role` - Message role ("user", "model", "system")
+    /// * `content` - Message content
+    ///
+    /// # Returns
+    ///
+    /// The model's response text
+    pub fn send_message(&self, role: &str, content: &str) -> LlmResult<String> {
+        #[cfg(litert_dynamic)]
+        {
+            let role_cstr = CString::new(role)
+                .map_err(|e| LlmError::BindingError(format!("Invalid role: {}", e)))?;
+            let content_cstr = CString::new(content)
+                .map_err(|e| LlmError::BindingError(format!("Invalid content: {}", e)))?;
+
+            let mut response_ptr: *mut c_char = std::ptr::null_mut();
+
+            let status = unsafe {
+                LiteRtLmConversation_SendMessage(
+                    self.ptr,
+                    role_cstr.as_ptr(),
+                    content_cstr.as_ptr(),
+                    &mut response_ptr,
+                )
+            };
+
+            if status != 0 || response_ptr.is_null() {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            let response = unsafe {
+                let response_cstr = CStr::from_ptr(response_ptr);
+                let response_string = response_cstr.to_string_lossy().into_owned();
+                LiteRtLm_FreeString(response_ptr);
+                response_string
+            };
 
-impl LiteRTConversation {
-    /// Send a message with a specific role and get a response
+            Ok(response)
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = (role, content);
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Send a message with a specific role and get the response without
+    /// copying it
     ///
     /// # Arguments
     ///
@@ -417,22 +2325,278 @@ impl LiteRTConversation {
     ///
     /// # Returns
     ///
-    /// The model's response text
-    pub fn send_message(&self, role: &str, content: &str) -> LlmResult<String> {
+    /// The model's response text, in the storage of the engine
+    pub fn send_message_buffer(&self, role: &str, content: &str) -> LlmResult<ResponseBuffer> {
+        #[cfg(litert_dynamic)]
+        {
+            let role_cstr = CString::new(role)
+                .map_err(|e| LlmError::BindingError(format!("Invalid role: {}", e)))?;
+            let content_cstr = CString::new(content)
+                .map_err(|e| LlmError::BindingError(format!("Invalid content: {}", e)))?;
+
+            let mut buffer = LiteRtLmBufferFFI {
+                data: std::ptr::null(),
+                size: 0,
+                owner: std::ptr::null_mut(),
+                retain: None,
+                release: None,
+            };
+
+            let status = unsafe {
+                LiteRtLmConversation_SendMessageBuffer(
+                    self.ptr,
+                    role_cstr.as_ptr(),
+                    content_cstr.as_ptr(),
+                    &mut buffer,
+                )
+            };
+
+            if status != 0 {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(ResponseBuffer { buffer })
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = (role, content);
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Send a message with a specific role and stream the response
+    ///
+    /// Returns once the message is sent. `on_event` is then called on a
+    /// background thread with each [`StreamEvent::Chunk`] of the response as
+    /// it is generated, and last with [`StreamEvent::Done`] or
+    /// [`StreamEvent::Error`]. The conversation must not be dropped before
+    /// that last event.
+    ///
+    /// # Arguments
+    ///
+    /// * `role` - Message role ("user", "model", "system")
+    /// * `content` - Message content
+    /// * `on_event` - Callback receiving the response
+    pub fn send_message_stream<F>(&self, role: &str, content: &str, on_event: F) -> LlmResult<()>
+    where
+        F: FnMut(StreamEvent) + Send + 'static,
+    {
+        #[cfg(litert_dynamic)]
+        {
+            let role_cstr = CString::new(role)
+                .map_err(|e| LlmError::BindingError(format!("Invalid role: {}", e)))?;
+            let content_cstr = CString::new(content)
+                .map_err(|e| LlmError::BindingError(format!("Invalid content: {}", e)))?;
+
+            // Freed by the trampoline after the final event.
+            let on_event: Box<StreamCallback> = Box::new(Box::new(on_event));
+            let user_data = Box::into_raw(on_event) as *mut std::ffi::c_void;
+
+            let status = unsafe {
+                LiteRtLmConversation_SendMessageStream(
+                    self.ptr,
+                    role_cstr.as_ptr(),
+                    content_cstr.as_ptr(),
+                    Some(message_stream_trampoline),
+                    user_data,
+                )
+            };
+
+            if status != 0 {
+                let err = unsafe {
+                    // The callback is never called then.
+                    drop(Box::from_raw(user_data as *mut StreamCallback));
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(())
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = (role, content, on_event);
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Send a user message and stream the response (convenience method)
+    ///
+    /// See [`LiteRTConversation::send_message_stream`].
+    pub fn send_user_message_stream<F>(&self, content: &str, on_event: F) -> LlmResult<()>
+    where
+        F: FnMut(StreamEvent) + Send + 'static,
+    {
+        self.send_message_stream("user", content, on_event)
+    }
+
+    /// Send a message with a specific role and push the response to a
+    /// completion queue
+    ///
+    /// Returns once the message is sent. The completions of the response, all
+    /// tagged with `tag`, are then pushed to `queue` as the response is
+    /// generated, the last one with `is_final` set. Unlike
+    /// [`LiteRTConversation::send_message_stream`], no Rust code runs on the
+    /// engine threads. The conversation and the queue must not be dropped
+    /// before the last completion is polled.
+    ///
+    /// # Arguments
+    ///
+    /// * `role` - Message role ("user", "model", "system")
+    /// * `content` - Message content
+    /// * `queue` - Completion queue receiving the response
+    /// * `tag` - Tag of the completions of the response
+    pub fn submit_message(
+        &self,
+        role: &str,
+        content: &str,
+        queue: &LiteRTCompletionQueue,
+        tag: u64,
+    ) -> LlmResult<()> {
+        #[cfg(litert_dynamic)]
+        {
+            let role_cstr = CString::new(role)
+                .map_err(|e| LlmError::BindingError(format!("Invalid role: {}", e)))?;
+            let content_cstr = CString::new(content)
+                .map_err(|e| LlmError::BindingError(format!("Invalid content: {}", e)))?;
+
+            let status = unsafe {
+                LiteRtLmConversation_SubmitMessage(
+                    self.ptr,
+                    role_cstr.as_ptr(),
+                    content_cstr.as_ptr(),
+                    queue.ptr,
+                    tag,
+                )
+            };
+
+            if status != 0 {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(())
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = (role, content, queue, tag);
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Render and tokenize a message as the next message of the conversation,
+    /// without sending it
+    ///
+    /// The token ids can then be sent with
+    /// [`LiteRTConversation::send_tokenized_message`] or
+    /// [`LiteRTConversation::submit_tokenized_message`], as long as the history
+    /// does not change, so that the message is tokenized once.
+    pub fn tokenize_message(&self, role: &str, content: &str) -> LlmResult<Vec<i32>> {
+        #[cfg(litert_dynamic)]
+        {
+            let role_cstr = CString::new(role)
+                .map_err(|e| LlmError::BindingError(format!("Invalid role: {}", e)))?;
+            let content_cstr = CString::new(content)
+                .map_err(|e| LlmError::BindingError(format!("Invalid content: {}", e)))?;
+            let mut token_ids_ptr: *mut i32 = std::ptr::null_mut();
+            let mut num_tokens: c_int = 0;
+
+            let status = unsafe {
+                LiteRtLmConversation_TokenizeMessage(
+                    self.ptr,
+                    role_cstr.as_ptr(),
+                    content_cstr.as_ptr(),
+                    &mut token_ids_ptr,
+                    &mut num_tokens,
+                )
+            };
+
+            if status != 0 {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(unsafe { take_token_ids(token_ids_ptr, num_tokens as usize) })
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = (role, content);
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Send a message tokenized by [`LiteRTConversation::tokenize_message`] and
+    /// get a response
+    ///
+    /// The token ids are prefilled as they are, `content` is only added to the
+    /// history.
+    pub fn send_tokenized_message(
+        &self,
+        role: &str,
+        content: &str,
+        token_ids: &[i32],
+    ) -> LlmResult<String> {
         #[cfg(litert_dynamic)]
         {
             let role_cstr = CString::new(role)
                 .map_err(|e| LlmError::BindingError(format!("Invalid role: {}", e)))?;
             let content_cstr = CString::new(content)
                 .map_err(|e| LlmError::BindingError(format!("Invalid content: {}", e)))?;
+            let num_tokens = c_int::try_from(token_ids.len())
+                .map_err(|_| LlmError::BindingError("Too many token ids".to_string()))?;
 
             let mut response_ptr: *mut c_char = std::ptr::null_mut();
 
             let status = unsafe {
-                LiteRtLmConversation_SendMessage(
+                LiteRtLmConversation_SendTokenizedMessage(
                     self.ptr,
                     role_cstr.as_ptr(),
                     content_cstr.as_ptr(),
+                    token_ids.as_ptr(),
+                    num_tokens,
                     &mut response_ptr,
                 )
             };
@@ -461,7 +2625,63 @@ impl LiteRTConversation {
 
         #[cfg(litert_stub)]
         {
-            let _ = (role, content);
+            let _ = (role, content, token_ids);
+            Err(LlmError::BindingError(
+                "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
+                    .to_string(),
+            ))
+        }
+    }
+
+    /// Send a message tokenized by [`LiteRTConversation::tokenize_message`] and
+    /// push its response to `queue`, see [`LiteRTConversation::submit_message`]
+    pub fn submit_tokenized_message(
+        &self,
+        role: &str,
+        content: &str,
+        token_ids: &[i32],
+        queue: &LiteRTCompletionQueue,
+        tag: u64,
+    ) -> LlmResult<()> {
+        #[cfg(litert_dynamic)]
+        {
+            let role_cstr = CString::new(role)
+                .map_err(|e| LlmError::BindingError(format!("Invalid role: {}", e)))?;
+            let content_cstr = CString::new(content)
+                .map_err(|e| LlmError::BindingError(format!("Invalid content: {}", e)))?;
+            let num_tokens = c_int::try_from(token_ids.len())
+                .map_err(|_| LlmError::BindingError("Too many token ids".to_string()))?;
+
+            let status = unsafe {
+                LiteRtLmConversation_SubmitTokenizedMessage(
+                    self.ptr,
+                    role_cstr.as_ptr(),
+                    content_cstr.as_ptr(),
+                    token_ids.as_ptr(),
+                    num_tokens,
+                    queue.ptr,
+                    tag,
+                )
+            };
+
+            if status != 0 {
+                let err = unsafe {
+                    let err_ptr = LiteRtLm_GetLastError();
+                    if err_ptr.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
+                    }
+                };
+                return Err(LlmError::BindingError(err));
+            }
+
+            Ok(())
+        }
+
+        #[cfg(litert_stub)]
+        {
+            let _ = (role, content, token_ids, queue, tag);
             Err(LlmError::BindingError(
                 "LiteRT runtime is not available on this build; set LITERT_LM_PATH to enable it."
                     .to_string(),
@@ -469,6 +2689,16 @@ impl LiteRTConversation {
         }
     }
 
+    /// Cancel the response being generated
+    ///
+    /// A streamed or submitted response then ends with an error.
+    pub fn cancel(&self) {
+        #[cfg(litert_dynamic)]
+        unsafe {
+            LiteRtLmConversation_Cancel(self.ptr);
+        }
+    }
+
     /// Send a user message and get a response (convenience method)
     ///
     /// # Arguments
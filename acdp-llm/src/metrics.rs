@@ -4,11 +4,12 @@ use crate::database::MetricsDatabase;
 #[allow(unused_imports)]
 use crate::error::LlmError as _;
 use crate::error::LlmResult;
-use metrics::counter;
+use crate::litert_wrapper::{CacheStats, EngineMetrics, LiteRTEngine};
+use metrics::{counter, gauge};
 #[allow(unused_imports)]
-use metrics::{gauge as _, histogram as _};
+use metrics::histogram as _;
 use std::sync::Arc;
-use std::time::Instant;
+use std::time::{Duration, Instant};
 
 /// Metrics collector for LLM operations
 pub struct LlmMetricsCollector {
@@ -120,6 +121,48 @@ impl LlmMetricsCollector {
     }
 }
 
+/// Publish the metrics of an engine as gauges and counters
+///
+/// They are exposed by the recorder the application installed, e.g. the
+/// Prometheus exporter, and do not require the benchmark mode.
+pub fn record_engine_metrics(metrics: &EngineMetrics) {
+    gauge!("litert_engine_active_sessions").set(metrics.active_sessions as f64);
+    gauge!("litert_engine_queued_tasks").set(metrics.queued_tasks as f64);
+    counter!("litert_engine_prefilled_tokens_total").absolute(metrics.prefilled_tokens);
+    counter!("litert_engine_decode_steps_total").absolute(metrics.decode_steps);
+    counter!("litert_engine_cancellations_total").absolute(metrics.cancellations);
+    if let Some(utilization) = metrics.kv_cache_utilization {
+        gauge!("litert_engine_kv_cache_utilization").set(utilization);
+    }
+    record_cache_stats("prefix", &metrics.prefix_cache);
+    record_cache_stats("embedding", &metrics.embedding_cache);
+    record_cache_stats("token_id", &metrics.token_id_cache);
+}
+
+fn record_cache_stats(cache: &'static str, stats: &CacheStats) {
+    counter!("litert_engine_cache_hits_total", "cache" => cache).absolute(stats.hits);
+    counter!("litert_engine_cache_misses_total", "cache" => cache).absolute(stats.misses);
+    gauge!("litert_engine_cache_hit_rate", "cache" => cache).set(stats.hit_rate());
+}
+
+/// Publish the metrics of an engine every `interval`, until the returned task
+/// is aborted
+pub fn spawn_engine_metrics_exporter(
+    engine: Arc<LiteRTEngine>,
+    interval: Duration,
+) -> tokio::task::JoinHandle<()> {
+    tokio::spawn(async move {
+        let mut ticker = tokio::time::interval(interval);
+        loop {
+            ticker.tick().await;
+            match engine.metrics() {
+                Ok(metrics) => record_engine_metrics(&metrics),
+                Err(e) => tracing::debug!("Failed to read the engine metrics: {}", e),
+            }
+        }
+    })
+}
+
 /// Performance metrics summary
 #[derive(Debug, Clone)]
 pub struct PerformanceSummary {
@@ -159,4 +202,16 @@ mod tests {
         // Test would require actual database setup
         assert!(true);
     }
+
+    #[test]
+    fn test_cache_hit_rate() {
+        assert_eq!(CacheStats::default().hit_rate(), 0.0);
+        let stats = CacheStats { hits: 3, misses: 1 };
+        assert_eq!(stats.hit_rate(), 0.75);
+        // Without a recorder installed, publishing is a no-op.
+        record_engine_metrics(&EngineMetrics {
+            prefix_cache: stats,
+            ..Default::default()
+        });
+    }
 }
@@ -259,10 +259,10 @@ impl LlmService {
             .ok_or_else(|| LlmError::ConfigError("No model engine available".to_string()))?;
 
         // Spin up a new conversation per request.
-        let conversation = engine.create_conversation()?;
+        let conversation = Arc::new(engine.create_conversation()?);
 
         // Kick off streaming.
-        let mut stream = generate_streaming(&conversation, &request.prompt).await?;
+        let mut stream = generate_streaming(conversation.clone(), &request.prompt).await?;
         let (tx, rx) = mpsc::channel(128);
         let events_tx = self.events_tx.clone();
         let request_metadata = request.metadata();
@@ -274,7 +274,23 @@ impl LlmService {
             let mut combined_text = String::new();
 
             // Stream tokens forward.
-            while let Some(token) = stream.next().await {
+            loop {
+                let token = tokio::select! {
+                    token = stream.next() => token,
+                    // The consumer went away: dropping the stream cancels the
+                    // generation, rather than decoding up to max tokens.
+                    _ = tx.closed() => return,
+                };
+                let Some(token) = token else {
+                    break;
+                };
+                let token = match token {
+                    Ok(token) => token,
+                    Err(err) => {
+                        warn!("Generation failed: {}", err);
+                        break;
+                    }
+                };
                 if first_token_at.is_none() {
                     first_token_at = Some(Instant::now());
                 }
@@ -1,61 +1,117 @@
 //! Streaming support for LiteRT-LM
 
-#[allow(unused_imports)]
-use crate::error::LlmError as _;
 use crate::error::LlmResult;
-use crate::litert_wrapper::LiteRTSession;
-#[allow(unused_imports)]
-use std::sync::Arc as _;
-use tokio::sync::mpsc;
+use crate::litert_wrapper::{LiteRTCompletionQueue, LiteRTSession};
+use std::collections::VecDeque;
+use std::sync::Arc;
+
+/// A response being generated into its own completion queue
+struct Generation {
+    queue: LiteRTCompletionQueue,
+    conversation: Arc<LiteRTSession>,
+}
+
+impl Generation {
+    /// Wait for the last completion, after which the conversation and the
+    /// queue can be dropped
+    async fn finish(self) {
+        loop {
+            match self.queue.next_batch().await {
+                Ok(completions) => {
+                    if completions.iter().any(|completion| completion.is_final) {
+                        return;
+                    }
+                }
+                Err(_) => return self.finish_blocking(),
+            }
+        }
+    }
+
+    fn finish_blocking(self) {
+        while !self
+            .queue
+            .poll()
+            .iter()
+            .any(|completion| completion.is_final)
+        {
+            std::thread::sleep(std::time::Duration::from_millis(1));
+        }
+    }
+}
 
 /// Stream of tokens from LLM generation
+///
+/// Dropping it before the end of the generation cancels the generation.
 pub struct TokenStream {
-    receiver: mpsc::Receiver<String>,
+    // Kept until the last completion.
+    generation: Option<Generation>,
+    pending: VecDeque<LlmResult<String>>,
 }
 
 impl TokenStream {
-    pub fn new(receiver: mpsc::Receiver<String>) -> Self {
-        Self { receiver }
+    /// Get the next token from the stream
+    ///
+    /// Returns `None` once the generation is complete, after an error if it
+    /// failed.
+    pub async fn next(&mut self) -> Option<LlmResult<String>> {
+        loop {
+            if let Some(token) = self.pending.pop_front() {
+                return Some(token);
+            }
+            let generation = self.generation.as_ref()?;
+            let completions = match generation.queue.next_batch().await {
+                Ok(completions) => completions,
+                Err(err) => return Some(Err(err)),
+            };
+            for completion in completions {
+                if let Some(chunk) = completion.chunk {
+                    // The one copy of the chunk, out of the engine storage.
+                    self.pending
+                        .push_back(Ok(String::from_utf8_lossy(&chunk).into_owned()));
+                }
+                if let Some(err) = completion.error {
+                    self.pending.push_back(Err(err));
+                }
+                if completion.is_final {
+                    self.generation = None;
+                }
+            }
+        }
     }
+}
 
-    /// Get the next token from the stream
-    pub async fn next(&mut self) -> Option<String> {
-        self.receiver.recv().await
+impl Drop for TokenStream {
+    fn drop(&mut self) {
+        let Some(generation) = self.generation.take() else {
+            return;
+        };
+        // The conversation is generating until the last completion.
+        generation.conversation.cancel();
+        match tokio::runtime::Handle::try_current() {
+            Ok(handle) => {
+                handle.spawn(generation.finish());
+            }
+            Err(_) => generation.finish_blocking(),
+        }
     }
 }
 
-/// Generate content with streaming (optimized word-by-word)
+/// Generate content with streaming
+///
+/// The tokens are pushed by the engine threads to a completion queue as they
+/// are generated, and awaited through the tokio reactor.
 pub async fn generate_streaming(
-    conversation: &LiteRTSession,
+    conversation: Arc<LiteRTSession>,
     prompt: &str,
 ) -> LlmResult<TokenStream> {
-    // Create a channel for streaming tokens
-    let (tx, rx) = mpsc::channel(100);
-
-    // LiteRT doesn't currently expose a streaming API in the bindings
-    // Until litert_lm_session_generate_content_stream is available,
-    // we use word-by-word streaming for better UX than char-by-char
-    let response = conversation.send_user_message(prompt)?;
-
-    // Stream word-by-word for smoother experience
-    tokio::spawn(async move {
-        let words: Vec<&str> = response.split_whitespace().collect();
-
-        for (i, word) in words.iter().enumerate() {
-            let mut token = word.to_string();
-            // Add space after word (except last)
-            if i < words.len() - 1 {
-                token.push(' ');
-            }
-
-            if tx.send(token).await.is_err() {
-                break;
-            }
-
-            // Faster streaming - 5ms per word feels natural
-            tokio::time::sleep(tokio::time::Duration::from_millis(5)).await;
-        }
-    });
+    let queue = LiteRTCompletionQueue::new()?;
+    conversation.submit_message("user", prompt, &queue, /* tag= */ 0)?;
 
-    Ok(TokenStream::new(rx))
+    Ok(TokenStream {
+        generation: Some(Generation {
+            queue,
+            conversation,
+        }),
+        pending: VecDeque::new(),
+    })
 }